@@ -26,9 +26,14 @@ public:
             return 0;
 
         size_t nread = 0;
-        if (bytes.size() >= 1) {
+        // Whole bytes that were read ahead by the little-endian reads come first.
+        while (nread < bytes.size() && m_bit_count >= 8) {
+            bytes[nread++] = static_cast<u8>(m_bit_buffer);
+            discard_bits(8);
+        }
+        if (nread < bytes.size()) {
             if (m_next_byte.has_value()) {
-                bytes[0] = m_next_byte.value();
+                bytes[nread] = m_next_byte.value();
                 m_next_byte.clear();
 
                 ++nread;
@@ -48,10 +53,14 @@ public:
         return true;
     }
 
-    bool unreliable_eof() const override { return !m_next_byte.has_value() && m_stream.unreliable_eof(); }
+    bool unreliable_eof() const override { return m_bit_count < 8 && !m_next_byte.has_value() && m_stream.unreliable_eof(); }
 
     bool discard_or_error(size_t count) override
     {
+        while (count >= 1 && m_bit_count >= 8) {
+            discard_bits(8);
+            --count;
+        }
         if (count >= 1) {
             if (m_next_byte.has_value()) {
                 m_next_byte.clear();
@@ -64,29 +73,45 @@ public:
 
     u64 read_bits(size_t count)
     {
-        u64 result = 0;
+        if (count > 32) {
+            auto low = read_bits(32);
+            return low | (read_bits(count - 32) << 32);
+        }
 
-        size_t nread = 0;
-        while (nread < count) {
-            if (m_stream.has_any_error()) {
-                set_fatal_error();
-                return 0;
-            }
+        if (m_bit_count < count && !read_ahead((count - m_bit_count + 7) / 8))
+            return 0;
 
-            if (m_next_byte.has_value()) {
-                const auto bit = (m_next_byte.value() >> m_bit_offset) & 1;
-                result |= bit << nread;
-                ++nread;
+        auto result = m_bit_buffer & ((1ull << count) - 1);
+        discard_bits(count);
+        return result;
+    }
 
-                if (m_bit_offset++ == 7)
-                    m_next_byte.clear();
-            } else {
-                m_stream >> m_next_byte;
-                m_bit_offset = 0;
-            }
+    // For decoding prefix codes with little-endian bit order: peek_bits() returns the bits that have been read ahead
+    // (in the lowest peekable_bit_count() bits, the others being zero), read_ahead() makes more of them available,
+    // and discard_bits() consumes them. Only bytes that are asked for are taken from the underlying stream.
+    u64 peek_bits() const { return m_bit_buffer; }
+    size_t peekable_bit_count() const { return m_bit_count; }
+
+    bool read_ahead(size_t byte_count = 1)
+    {
+        VERIFY(m_bit_count + byte_count * 8 <= 64);
+        u8 bytes[8];
+        if (m_stream.has_any_error() || !m_stream.read_or_error({ bytes, byte_count })) {
+            set_fatal_error();
+            return false;
         }
+        for (size_t i = 0; i < byte_count; ++i) {
+            m_bit_buffer |= static_cast<u64>(bytes[i]) << m_bit_count;
+            m_bit_count += 8;
+        }
+        return true;
+    }
 
-        return result;
+    void discard_bits(size_t count)
+    {
+        VERIFY(count <= m_bit_count);
+        m_bit_buffer = count == 64 ? 0 : m_bit_buffer >> count;
+        m_bit_count -= count;
     }
 
     u64 read_bits_big_endian(size_t count)
@@ -133,6 +158,7 @@ public:
     {
         if (m_next_byte.has_value())
             m_next_byte.clear();
+        discard_bits(m_bit_count % 8);
     }
 
     bool handle_any_error() override
@@ -142,8 +168,12 @@ public:
     }
 
 private:
+    // The big-endian reads go through m_next_byte, and the little-endian ones through m_bit_buffer (lowest bit first);
+    // a stream is only ever read one way.
     Optional<u8> m_next_byte;
     size_t m_bit_offset { 0 };
+    u64 m_bit_buffer { 0 };
+    size_t m_bit_count { 0 };
     InputStream& m_stream;
 };
 
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 #include <AK/kmalloc.h>
@@ -78,6 +79,9 @@ public:
                 kfree_sized((void*)chunk, m_chunk_size);
             }
         });
+        m_head_chunk = 0;
+        m_current_chunk = 0;
+        m_byte_offset_into_current_chunk = 0;
     }
 
 protected:
@@ -192,10 +196,72 @@ public:
     }
 };
 
+// An arena for objects of any type: they're all destroyed at once (in reverse order of allocation) and their memory
+// is released chunk by chunk. Only objects that need their destructor run leave a record of themselves behind.
+template<bool use_mmap = false, size_t chunk_size = use_mmap ? 4 * MiB : 4 * KiB>
+class ArenaAllocator : protected BumpAllocator<use_mmap, chunk_size> {
+    AK_MAKE_NONCOPYABLE(ArenaAllocator);
+    AK_MAKE_NONMOVABLE(ArenaAllocator);
+
+    using Allocator = BumpAllocator<use_mmap, chunk_size>;
+
+public:
+    ArenaAllocator() = default;
+    ~ArenaAllocator()
+    {
+        deallocate_all();
+    }
+
+    template<typename T, typename... Args>
+    T* allocate(Args&&... args)
+    {
+        if constexpr (!IsTriviallyDestructible<T>) {
+            auto* record = (DestructorRecord*)Allocator::allocate(sizeof(DestructorRecord), alignof(DestructorRecord));
+            if (!record)
+                return nullptr;
+            auto* ptr = (T*)Allocator::allocate(sizeof(T), alignof(T));
+            if (!ptr)
+                return nullptr;
+            new (ptr) T { forward<Args>(args)... };
+            *record = { m_last_destructor_record, [](void* object) { static_cast<T*>(object)->~T(); }, ptr };
+            m_last_destructor_record = record;
+            return ptr;
+        } else {
+            auto* ptr = (T*)Allocator::allocate(sizeof(T), alignof(T));
+            if (!ptr)
+                return nullptr;
+            return new (ptr) T { forward<Args>(args)... };
+        }
+    }
+
+    void deallocate_all()
+    {
+        destroy_all();
+        Allocator::deallocate_all();
+    }
+
+private:
+    struct DestructorRecord {
+        DestructorRecord* previous;
+        void (*destroy)(void*);
+        void* object;
+    };
+
+    void destroy_all()
+    {
+        for (auto* record = m_last_destructor_record; record; record = record->previous)
+            record->destroy(record->object);
+        m_last_destructor_record = nullptr;
+    }
+
+    DestructorRecord* m_last_destructor_record { nullptr };
+};
+
 template<bool use_mmap, size_t size>
 inline Atomic<FlatPtr> BumpAllocator<use_mmap, size>::s_unused_allocation_cache { 0 };
 
 }
 
+using AK::ArenaAllocator;
 using AK::BumpAllocator;
 using AK::UniformBumpAllocator;
@@ -11,8 +11,6 @@
 
 namespace AK {
 
-// FIXME: There are a lot of raw loops here, that's not necessary an issue but it
-//        has to be verified that the optimizer is able to insert memcpy instead.
 template<size_t Capacity>
 class CircularDuplexStream : public AK::DuplexStream {
 public:
@@ -20,9 +18,13 @@ public:
     {
         const auto nwritten = min(bytes.size(), Capacity - m_queue.size());
 
-        for (size_t idx = 0; idx < nwritten; ++idx)
-            m_queue.enqueue(bytes[idx]);
+        // The free space may wrap around the end of the storage.
+        const auto tail = (m_queue.head_index() + m_queue.size()) % Capacity;
+        const auto first_part = min(nwritten, Capacity - tail);
+        __builtin_memcpy(m_queue.m_storage + tail, bytes.data(), first_part);
+        __builtin_memcpy(m_queue.m_storage, bytes.data() + first_part, nwritten - first_part);
 
+        m_queue.m_size += nwritten;
         m_total_written += nwritten;
         return nwritten;
     }
@@ -46,9 +48,13 @@ public:
 
         const auto nread = min(bytes.size(), m_queue.size());
 
-        for (size_t idx = 0; idx < nread; ++idx)
-            bytes[idx] = m_queue.dequeue();
+        const auto head = m_queue.head_index();
+        const auto first_part = min(nread, Capacity - head);
+        __builtin_memcpy(bytes.data(), m_queue.m_storage + head, first_part);
+        __builtin_memcpy(bytes.data() + first_part, m_queue.m_storage, nread - first_part);
 
+        m_queue.m_head = (head + nread) % Capacity;
+        m_queue.m_size -= nread;
         return nread;
     }
 
@@ -87,14 +93,45 @@ public:
             return false;
         }
 
-        for (size_t idx = 0; idx < count; ++idx)
-            m_queue.dequeue();
+        m_queue.m_head = (m_queue.head_index() + count) % Capacity;
+        m_queue.m_size -= count;
+        return true;
+    }
 
+    // Appends `count` bytes that start `seekback` bytes before the end of what has been written, like an LZ77 back-reference.
+    // The two may overlap, in which case the bytes that are being appended repeat.
+    bool write_from_seekback(size_t seekback, size_t count)
+    {
+        if (seekback == 0 || seekback > Capacity || seekback > m_total_written || count > Capacity - m_queue.size()) {
+            set_recoverable_error();
+            return false;
+        }
+
+        auto* storage = m_queue.m_storage;
+        const auto destination = (m_queue.head_index() + m_queue.size()) % Capacity;
+        const auto source = (destination + Capacity - seekback) % Capacity;
+        if (source + count <= Capacity && destination + count <= Capacity) {
+            if (source + count <= destination || destination + count <= source) {
+                __builtin_memcpy(storage + destination, storage + source, count);
+            } else {
+                // Copying forwards never reads a byte before it has been written, even when the copy overlaps itself.
+                for (size_t idx = 0; idx < count; ++idx)
+                    storage[destination + idx] = storage[source + idx];
+            }
+        } else {
+            for (size_t idx = 0; idx < count; ++idx)
+                storage[(destination + idx) % Capacity] = storage[(source + idx) % Capacity];
+        }
+
+        m_queue.m_size += count;
+        m_total_written += count;
         return true;
     }
 
     bool unreliable_eof() const override { return eof(); }
     bool eof() const { return m_queue.size() == 0; }
+    // How many bytes have been written but not read yet.
+    size_t size() const { return m_queue.size(); }
 
     size_t remaining_contiguous_space() const
     {
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Assertions.h>
+#include <AK/NumericLimits.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A Bloom filter that keys can be removed from again, at the cost of a counter per bucket.
+// The keys are expected to be hashes already; every key sets two buckets, picked from its low and high bits.
+//
+// may_contain() never returns false for a key that has been added (and not removed), but does return true
+// for some keys that haven't been. Counters that overflow stay at their maximum forever, which keeps that promise.
+template<typename CounterType = u8, size_t key_bits = 12>
+class CountingBloomFilter {
+public:
+    static_assert(key_bits > 0 && key_bits <= 16);
+    static constexpr size_t bucket_count = 1u << key_bits;
+
+    void increment(u32 key)
+    {
+        increment_bucket(first_bucket(key));
+        increment_bucket(second_bucket(key));
+    }
+
+    void decrement(u32 key)
+    {
+        decrement_bucket(first_bucket(key));
+        decrement_bucket(second_bucket(key));
+    }
+
+    bool may_contain(u32 key) const
+    {
+        return m_buckets[first_bucket(key)] != 0 && m_buckets[second_bucket(key)] != 0;
+    }
+
+    void clear() { m_buckets.fill(0); }
+
+private:
+    static constexpr u32 key_mask = bucket_count - 1;
+
+    static constexpr size_t first_bucket(u32 key) { return key & key_mask; }
+    static constexpr size_t second_bucket(u32 key) { return (key >> 16) & key_mask; }
+
+    void increment_bucket(size_t bucket)
+    {
+        if (m_buckets[bucket] != NumericLimits<CounterType>::max())
+            ++m_buckets[bucket];
+    }
+
+    void decrement_bucket(size_t bucket)
+    {
+        // A saturated counter has lost track of how many keys it holds, so it can't be decremented anymore.
+        if (m_buckets[bucket] != NumericLimits<CounterType>::max()) {
+            VERIFY(m_buckets[bucket] != 0);
+            --m_buckets[bucket];
+        }
+    }
+
+    Array<CounterType, bucket_count> m_buckets {};
+};
+
+}
+
+using AK::CountingBloomFilter;
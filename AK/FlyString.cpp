@@ -4,13 +4,16 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/FlyString.h>
-#include <AK/HashTable.h>
+#include <AK/IntegralMath.h>
 #include <AK/Optional.h>
 #include <AK/Singleton.h>
 #include <AK/String.h>
 #include <AK/StringUtils.h>
 #include <AK/StringView.h>
+#include <AK/SwissHashTable.h>
 
 namespace AK {
 
@@ -24,16 +27,59 @@ struct FlyStringImplTraits : public Traits<StringImpl*> {
     }
 };
 
-static Singleton<HashTable<StringImpl*, FlyStringImplTraits>> s_table;
+// The interned StringImpls are spread over a number of shards by their hash, each with a table and a lock of its own,
+// so threads interning different strings rarely wait for each other.
+static constexpr size_t fly_impl_shard_count = 16;
 
-static HashTable<StringImpl*, FlyStringImplTraits>& fly_impls()
+struct alignas(64) FlyImplShard {
+    Atomic<bool> locked { false };
+    SwissHashTable<StringImpl*, FlyStringImplTraits> impls;
+};
+
+class FlyImplShardLocker {
+    AK_MAKE_NONCOPYABLE(FlyImplShardLocker);
+    AK_MAKE_NONMOVABLE(FlyImplShardLocker);
+
+public:
+    explicit FlyImplShardLocker(FlyImplShard& shard)
+        : m_shard(shard)
+    {
+        // NOTE: The lock is only ever held for a single table operation, spinning is cheaper than going to sleep.
+        while (m_shard.locked.exchange(true, AK::MemoryOrder::memory_order_acquire)) {
+            while (m_shard.locked.load(AK::MemoryOrder::memory_order_relaxed)) {
+#if ARCH(I386) || ARCH(X86_64)
+                __builtin_ia32_pause();
+#endif
+            }
+        }
+    }
+
+    ~FlyImplShardLocker()
+    {
+        m_shard.locked.store(false, AK::MemoryOrder::memory_order_release);
+    }
+
+private:
+    FlyImplShard& m_shard;
+};
+
+static Singleton<Array<FlyImplShard, fly_impl_shard_count>> s_shards;
+
+static FlyImplShard& fly_impl_shard_for(unsigned hash)
 {
-    return *s_table;
+    // NOTE: SwissHashTable looks at the low bits of the hash, so the shard is picked by the high ones.
+    static_assert(is_power_of_two(fly_impl_shard_count));
+    return (*s_shards)[hash >> (32 - AK::log2(fly_impl_shard_count))];
 }
 
 void FlyString::did_destroy_impl(Badge<StringImpl>, StringImpl& impl)
 {
-    fly_impls().remove(&impl);
+    auto& shard = fly_impl_shard_for(impl.hash());
+    FlyImplShardLocker locker(shard);
+    // NOTE: Another thread may have interned an equal string in the meantime, that one has to stay.
+    auto it = shard.impls.find(&impl);
+    if (it != shard.impls.end() && *it == &impl)
+        shard.impls.remove(it);
 }
 
 FlyString::FlyString(const String& string)
@@ -44,33 +90,38 @@ FlyString::FlyString(const String& string)
         m_impl = string.impl();
         return;
     }
-    auto it = fly_impls().find(const_cast<StringImpl*>(string.impl()));
-    if (it == fly_impls().end()) {
-        fly_impls().set(const_cast<StringImpl*>(string.impl()));
-        string.impl()->set_fly({}, true);
-        m_impl = string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
+    auto& impl = const_cast<StringImpl&>(*string.impl());
+    auto& shard = fly_impl_shard_for(impl.hash());
+    FlyImplShardLocker locker(shard);
+    auto it = shard.impls.find(&impl);
+    if (it != shard.impls.end() && (*it)->try_ref_fly({})) {
+        m_impl = adopt_ref(**it);
+        return;
     }
+    // NOTE: This replaces an equal StringImpl that is being destroyed, if there is one.
+    impl.set_fly({}, true);
+    shard.impls.set(&impl);
+    m_impl = impl;
 }
 
 FlyString::FlyString(StringView string)
 {
     if (string.is_null())
         return;
-    auto it = fly_impls().find(string.hash(), [&](auto& candidate) {
+    auto hash = string.hash();
+    auto& shard = fly_impl_shard_for(hash);
+    FlyImplShardLocker locker(shard);
+    auto it = shard.impls.find(hash, [&](auto& candidate) {
         return string == candidate;
     });
-    if (it == fly_impls().end()) {
-        auto new_string = string.to_string();
-        fly_impls().set(new_string.impl());
-        new_string.impl()->set_fly({}, true);
-        m_impl = new_string.impl();
-    } else {
-        VERIFY((*it)->is_fly());
-        m_impl = *it;
+    if (it != shard.impls.end() && (*it)->try_ref_fly({})) {
+        m_impl = adopt_ref(**it);
+        return;
     }
+    auto new_string = string.to_string();
+    new_string.impl()->set_fly({}, true);
+    shard.impls.set(new_string.impl());
+    m_impl = new_string.impl();
 }
 
 template<typename T>
@@ -79,12 +79,19 @@ class HashTable;
 template<typename T, typename TraitsForT = Traits<T>>
 using OrderedHashTable = HashTable<T, TraitsForT, true>;
 
-template<typename K, typename V, typename KeyTraits = Traits<K>, bool IsOrdered = false>
+// NOTE: SwissHashTable only exists in an unordered flavor, IsOrdered makes it interchangeable with HashTable.
+template<typename T, typename TraitsForT = Traits<T>, bool IsOrdered = false>
+class SwissHashTable;
+
+template<typename K, typename V, typename KeyTraits = Traits<K>, bool IsOrdered = false, template<typename, typename, bool> typename TableType = HashTable>
 class HashMap;
 
 template<typename K, typename V, typename KeyTraits = Traits<K>>
 using OrderedHashMap = HashMap<K, V, KeyTraits, true>;
 
+template<typename K, typename V, typename KeyTraits = Traits<K>>
+using SwissHashMap = HashMap<K, V, KeyTraits, false, SwissHashTable>;
+
 template<typename T>
 class Badge;
 
@@ -179,6 +186,8 @@ using AK::String;
 using AK::StringBuilder;
 using AK::StringImpl;
 using AK::StringView;
+using AK::SwissHashMap;
+using AK::SwissHashTable;
 using AK::Time;
 using AK::Traits;
 using AK::URL;
@@ -13,7 +13,7 @@
 
 namespace AK {
 
-template<typename K, typename V, typename KeyTraits, bool IsOrdered>
+template<typename K, typename V, typename KeyTraits, bool IsOrdered, template<typename, typename, bool> typename TableType>
 class HashMap {
 private:
     struct Entry {
@@ -84,7 +84,7 @@ public:
         });
     }
 
-    using HashTableType = HashTable<Entry, EntryTraits, IsOrdered>;
+    using HashTableType = TableType<Entry, EntryTraits, IsOrdered>;
     using IteratorType = typename HashTableType::Iterator;
     using ConstIteratorType = typename HashTableType::ConstIterator;
 
@@ -0,0 +1,349 @@
+/*
+ * Copyright (c) 2018-2020, Andreas Kling <kling@serenityos.org>
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/CharacterTypes.h>
+#include <AK/JsonPullParser.h>
+#include <math.h>
+
+#ifdef __SSE2__
+#    include <AK/SIMD.h>
+#endif
+
+namespace AK {
+
+constexpr bool is_space(int ch)
+{
+    return ch == '\t' || ch == '\n' || ch == '\r' || ch == ' ';
+}
+
+// Returns the index of the first '"', '\\' or control character at or after `index`, or the length of the input if there is none.
+static size_t find_special_string_character(StringView input, size_t index)
+{
+    auto const* characters = input.characters_without_null_termination();
+
+#ifdef __SSE2__
+    auto const quote = SIMD::c8x16 {} + '"';
+    auto const backslash = SIMD::c8x16 {} + '\\';
+    auto const zero = SIMD::c8x16 {};
+    auto const space = SIMD::c8x16 {} + ' ';
+    for (; input.length() - index >= 16; index += 16) {
+        SIMD::c8x16 block;
+        __builtin_memcpy(&block, characters + index, sizeof(block));
+        // NOTE: The comparisons are signed, so bytes >= 0x80 don't count as control characters.
+        auto special = (block == quote) | (block == backslash) | ((block >= zero) & (block < space));
+        if (auto mask = static_cast<u32>(__builtin_ia32_pmovmskb128(bit_cast<SIMD::c8x16>(special))))
+            return index + count_trailing_zeroes(mask);
+    }
+#endif
+
+    for (; index < input.length(); ++index) {
+        char ch = characters[index];
+        if (ch == '"' || ch == '\\' || is_ascii_c0_control(ch))
+            break;
+    }
+    return index;
+}
+
+ErrorOr<void> JsonPullParser::consume_and_unescape_string()
+{
+    if (!consume_specific('"'))
+        return Error::from_string_literal("JsonParser: Expected '\"'"sv);
+
+    // Strings without escape sequences (that is, most of them) are handed out straight from the input.
+    size_t start = m_index;
+    m_index = find_special_string_character(m_input, m_index);
+    if (next_is('"')) {
+        m_string = m_input.substring_view(start, m_index - start);
+        ignore();
+        return {};
+    }
+
+    m_string_buffer.clear();
+    m_string_buffer.append(m_input.substring_view(start, m_index - start));
+
+    for (;;) {
+        if (is_eof())
+            break;
+        char ch = peek();
+        if (ch == '"')
+            break;
+        if (ch != '\\')
+            return Error::from_string_literal("JsonParser: Error while parsing string"sv);
+        ignore();
+        if (is_eof())
+            return Error::from_string_literal("JsonParser: Error while parsing string"sv);
+
+        switch (consume()) {
+        case '"':
+            m_string_buffer.append('"');
+            break;
+        case '\\':
+            m_string_buffer.append('\\');
+            break;
+        case '/':
+            m_string_buffer.append('/');
+            break;
+        case 'n':
+            m_string_buffer.append('\n');
+            break;
+        case 'r':
+            m_string_buffer.append('\r');
+            break;
+        case 't':
+            m_string_buffer.append('\t');
+            break;
+        case 'b':
+            m_string_buffer.append('\b');
+            break;
+        case 'f':
+            m_string_buffer.append('\f');
+            break;
+        case 'u': {
+            if (tell_remaining() < 4)
+                return Error::from_string_literal("JsonParser: EOF while parsing Unicode escape"sv);
+
+            auto code_point = AK::StringUtils::convert_to_uint_from_hex(consume(4));
+            if (!code_point.has_value())
+                return Error::from_string_literal("JsonParser: Error while parsing Unicode escape"sv);
+            m_string_buffer.append_code_point(code_point.value());
+            break;
+        }
+        default:
+            return Error::from_string_literal("JsonParser: Error while parsing string"sv);
+        }
+
+        auto end_of_plain_run = find_special_string_character(m_input, m_index);
+        m_string_buffer.append(m_input.substring_view(m_index, end_of_plain_run - m_index));
+        m_index = end_of_plain_run;
+    }
+    if (!consume_specific('"'))
+        return Error::from_string_literal("JsonParser: Expected '\"'"sv);
+
+    m_string = m_string_buffer.string_view();
+    return {};
+}
+
+ErrorOr<void> JsonPullParser::consume_number()
+{
+    size_t start = m_index;
+    size_t whole_length = 0;
+    size_t fraction_length = 0;
+
+    bool is_double = false;
+    bool all_zero = true;
+    for (;;) {
+        char ch = peek();
+        if (ch == '.') {
+            if (is_double)
+                return Error::from_string_literal("JsonParser: Multiple '.' in number"sv);
+
+            is_double = true;
+            ++m_index;
+            continue;
+        }
+        if (ch == '-' || (ch >= '0' && ch <= '9')) {
+            if (ch != '-' && ch != '0')
+                all_zero = false;
+
+            if (is_double) {
+                if (ch == '-')
+                    return Error::from_string_literal("JsonParser: Error while parsing number"sv);
+
+                ++fraction_length;
+            } else {
+                if (whole_length > 0) {
+                    if (m_input[start] == '0')
+                        return Error::from_string_literal("JsonParser: Error while parsing number"sv);
+                }
+
+                if (whole_length > 1) {
+                    if (m_input[start] == '-' && m_input[start + 1] == '0')
+                        return Error::from_string_literal("JsonParser: Error while parsing number"sv);
+                }
+
+                ++whole_length;
+            }
+            ++m_index;
+            continue;
+        }
+        break;
+    }
+
+    auto number_string = m_input.substring_view(start, whole_length);
+
+#ifndef KERNEL
+    // Check for negative zero which needs to be forced to be represented with a double
+    if (number_string.starts_with('-') && all_zero) {
+        m_number = JsonValue(-0.0);
+        return {};
+    }
+
+    if (is_double) {
+        // FIXME: This logic looks shaky.
+        int whole = 0;
+        auto to_signed_result = number_string.to_uint();
+        if (to_signed_result.has_value()) {
+            whole = to_signed_result.value();
+        } else {
+            auto number = number_string.to_int();
+            if (!number.has_value())
+                return Error::from_string_literal("JsonParser: Error while parsing number"sv);
+            whole = number.value();
+        }
+
+        auto fraction_string = m_input.substring_view(start + whole_length + 1, fraction_length);
+        auto fraction_string_uint = fraction_string.to_uint<u64>();
+        if (!fraction_string_uint.has_value())
+            return Error::from_string_literal("JsonParser: Error while parsing number"sv);
+        auto fraction = static_cast<double>(fraction_string_uint.value());
+        double sign = (whole < 0) ? -1 : 1;
+
+        auto divider = pow(10.0, static_cast<double>(fraction_length));
+        m_number = JsonValue((double)whole + sign * (fraction / divider));
+    } else {
+#endif
+        auto to_unsigned_result = number_string.to_uint<u64>();
+        if (to_unsigned_result.has_value()) {
+            auto number = *to_unsigned_result;
+            if (number <= NumericLimits<u32>::max())
+                m_number = JsonValue((u32)number);
+            else
+                m_number = JsonValue(number);
+        } else {
+            auto number = number_string.to_int<i64>();
+            if (!number.has_value())
+                return Error::from_string_literal("JsonParser: Error while parsing number"sv);
+            if (number.value() <= NumericLimits<i32>::max()) {
+                m_number = JsonValue((i32)number.value());
+            } else {
+                m_number = JsonValue(number.value());
+            }
+        }
+#ifndef KERNEL
+    }
+#endif
+
+    return {};
+}
+
+JsonPullParser::Token JsonPullParser::finish_value(Token token)
+{
+    m_state = m_containers.is_empty() ? State::Done : State::ExpectingCommaOrEnd;
+    return token;
+}
+
+ErrorOr<JsonPullParser::Token> JsonPullParser::read_value()
+{
+    switch (peek()) {
+    case '{':
+        ignore();
+        m_containers.append(Container::Object);
+        m_state = State::ExpectingFirstMember;
+        return Token::ObjectStart;
+    case '[':
+        ignore();
+        m_containers.append(Container::Array);
+        m_state = State::ExpectingFirstMember;
+        return Token::ArrayStart;
+    case '"':
+        TRY(consume_and_unescape_string());
+        return finish_value(Token::String);
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        TRY(consume_number());
+        return finish_value(Token::Number);
+    case 'f':
+        if (!consume_specific("false"))
+            return Error::from_string_literal("JsonParser: Expected 'false'"sv);
+        return finish_value(Token::False);
+    case 't':
+        if (!consume_specific("true"))
+            return Error::from_string_literal("JsonParser: Expected 'true'"sv);
+        return finish_value(Token::True);
+    case 'n':
+        if (!consume_specific("null"))
+            return Error::from_string_literal("JsonParser: Expected 'null'"sv);
+        return finish_value(Token::Null);
+    }
+
+    return Error::from_string_literal("JsonParser: Unexpected character"sv);
+}
+
+ErrorOr<JsonPullParser::Token> JsonPullParser::read_member()
+{
+    if (m_containers.last() == Container::Array)
+        return read_value();
+
+    TRY(consume_and_unescape_string());
+    ignore_while(is_space);
+    if (!consume_specific(':'))
+        return Error::from_string_literal("JsonParser: Expected ':'"sv);
+    m_state = State::ExpectingValue;
+    return Token::Key;
+}
+
+ErrorOr<JsonPullParser::Token> JsonPullParser::read_container_end()
+{
+    ignore();
+    auto container = m_containers.take_last();
+    return finish_value(container == Container::Object ? Token::ObjectEnd : Token::ArrayEnd);
+}
+
+ErrorOr<JsonPullParser::Token> JsonPullParser::next()
+{
+    ignore_while(is_space);
+
+    switch (m_state) {
+    case State::ExpectingValue:
+        return read_value();
+    case State::ExpectingFirstMember: {
+        char closing_character = m_containers.last() == Container::Object ? '}' : ']';
+        if (peek() == closing_character)
+            return read_container_end();
+        return read_member();
+    }
+    case State::ExpectingCommaOrEnd: {
+        bool is_object = m_containers.last() == Container::Object;
+        char closing_character = is_object ? '}' : ']';
+        if (peek() == closing_character)
+            return read_container_end();
+        if (!consume_specific(','))
+            return Error::from_string_literal("JsonParser: Expected ','"sv);
+        ignore_while(is_space);
+        if (peek() == closing_character)
+            return Error::from_string_literal(is_object ? "JsonParser: Unexpected '}'"sv : "JsonParser: Unexpected ']'"sv);
+        return read_member();
+    }
+    case State::Done:
+        if (!is_eof())
+            return Error::from_string_literal("JsonParser: Didn't consume all input"sv);
+        return Token::End;
+    }
+
+    VERIFY_NOT_REACHED();
+}
+
+ErrorOr<void> JsonPullParser::skip_value()
+{
+    auto starting_depth = depth();
+    do {
+        TRY(next());
+    } while (depth() > starting_depth);
+    return {};
+}
+
+}
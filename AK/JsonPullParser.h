@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/GenericLexer.h>
+#include <AK/JsonValue.h>
+#include <AK/StringBuilder.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// Reads JSON one token at a time instead of building a JsonValue tree, so callers can pick out
+// the parts they care about and skip the rest. It accepts exactly the same documents as JsonParser.
+//
+// Usage:
+//     JsonPullParser parser(input);
+//     for (auto token = TRY(parser.next()); token != JsonPullParser::Token::End; token = TRY(parser.next())) {
+//         if (token == JsonPullParser::Token::Key && parser.string() == "name"sv) ...
+//     }
+class JsonPullParser : private GenericLexer {
+public:
+    enum class Token : u8 {
+        ObjectStart,
+        ObjectEnd,
+        ArrayStart,
+        ArrayEnd,
+        // A property name; the next token starts the property's value.
+        Key,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        // The top-level value has been read completely.
+        End,
+    };
+
+    explicit JsonPullParser(StringView input)
+        : GenericLexer(input)
+    {
+    }
+
+    ErrorOr<Token> next();
+
+    // Reads past the next value, including everything nested in it.
+    ErrorOr<void> skip_value();
+
+    // The unescaped text of the last Key or String token. This points into the input when the string
+    // has no escape sequences and into a buffer that's reused for later strings otherwise, so it is
+    // only valid until the next call to next().
+    StringView string() const { return m_string; }
+
+    // The value of the last Number token.
+    JsonValue const& number() const { return m_number; }
+
+    // The number of objects and arrays that are currently open.
+    size_t depth() const { return m_containers.size(); }
+
+private:
+    enum class Container : u8 {
+        Object,
+        Array,
+    };
+
+    enum class State : u8 {
+        ExpectingValue,
+        ExpectingFirstMember,
+        ExpectingCommaOrEnd,
+        Done,
+    };
+
+    ErrorOr<Token> read_value();
+    ErrorOr<Token> read_member();
+    ErrorOr<Token> read_container_end();
+    Token finish_value(Token);
+
+    ErrorOr<void> consume_and_unescape_string();
+    ErrorOr<void> consume_number();
+
+    Vector<Container, 32> m_containers;
+    State m_state { State::ExpectingValue };
+    StringView m_string;
+    StringBuilder m_string_buffer;
+    JsonValue m_number;
+};
+
+}
+
+using AK::JsonPullParser;
@@ -8,13 +8,61 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 
+#ifdef __SSE2__
+#    include <AK/SIMD.h>
+#endif
+
 namespace AK {
 
 namespace Detail {
+
+#ifdef __SSE2__
+// Bit N of the result is set if byte N of the block at `data` equals `byte`.
+ALWAYS_INLINE u32 compare_block_with_byte(const u8* data, SIMD::c8x16 byte)
+{
+    SIMD::c8x16 block;
+    __builtin_memcpy(&block, data, sizeof(block));
+    return static_cast<u32>(__builtin_ia32_pmovmskb128(block == byte));
+}
+#endif
+
+inline const u8* find_byte(const u8* haystack, size_t haystack_length, u8 needle)
+{
+    auto const* end = haystack + haystack_length;
+    auto const* ptr = haystack;
+
+#ifdef __SSE2__
+    auto needle_vector = SIMD::c8x16 {} + static_cast<char>(needle);
+    for (; end - ptr >= 16; ptr += 16) {
+        if (auto mask = compare_block_with_byte(ptr, needle_vector))
+            return ptr + count_trailing_zeroes(mask);
+    }
+#else
+    // Test a machine word at a time: a byte of `word ^ pattern` is zero exactly where the needle is.
+    constexpr FlatPtr low_bits = explode_byte(0x01);
+    constexpr FlatPtr high_bits = explode_byte(0x80);
+    FlatPtr const pattern = explode_byte(needle);
+    for (; end - ptr >= static_cast<ptrdiff_t>(sizeof(FlatPtr)); ptr += sizeof(FlatPtr)) {
+        FlatPtr word;
+        __builtin_memcpy(&word, ptr, sizeof(word));
+        word ^= pattern;
+        if ((word - low_bits) & ~word & high_bits)
+            break;
+    }
+#endif
+
+    for (; ptr < end; ++ptr) {
+        if (*ptr == needle)
+            return ptr;
+    }
+    return nullptr;
+}
+
 constexpr const void* bitap_bitwise(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
 {
     VERIFY(needle_length < 32);
@@ -28,13 +76,13 @@ constexpr const void* bitap_bitwise(const void* haystack, size_t haystack_length
         needle_mask[i] = 0xffffffff;
 
     for (size_t i = 0; i < needle_length; ++i)
-        needle_mask[((const u8*)needle)[i]] &= ~(0x00000001 << i);
+        needle_mask[((const u8*)needle)[i]] &= ~(static_cast<u64>(1) << i);
 
     for (size_t i = 0; i < haystack_length; ++i) {
         lookup |= needle_mask[((const u8*)haystack)[i]];
         lookup <<= 1;
 
-        if (0 == (lookup & (0x00000001 << needle_length)))
+        if (0 == (lookup & (static_cast<u64>(1) << needle_length)))
             return ((const u8*)haystack) + i - needle_length + 1;
     }
 
@@ -100,6 +148,71 @@ inline Optional<size_t> memmem(const HaystackIterT& haystack_begin, const Haysta
     return {};
 }
 
+// Finds the first occurrence of `needle`, unlike memchr() this returns an offset.
+inline Optional<size_t> memchr_optional(const void* haystack, size_t haystack_length, u8 needle)
+{
+    auto const* ptr = Detail::find_byte(static_cast<const u8*>(haystack), haystack_length, needle);
+    if (ptr)
+        return static_cast<size_t>(ptr - static_cast<const u8*>(haystack));
+    return {};
+}
+
+namespace Detail {
+
+// Searches for candidates by the first and the last byte of the needle a block at a time, and only compares the
+// bytes in between where both match. Periodic needles in periodic haystacks can make most candidates fail, so once
+// too many comparisons were in vain, the rest of the haystack is left to `fallback`, which stays linear.
+template<typename Fallback>
+inline Optional<size_t> memmem_by_first_and_last_byte(const u8* haystack, size_t haystack_length, const u8* needle, size_t needle_length, Fallback fallback)
+{
+    VERIFY(needle_length >= 2 && needle_length <= haystack_length);
+
+    size_t const last_candidate = haystack_length - needle_length;
+    size_t failed_comparisons = 0;
+    auto matches_at = [&](size_t offset) {
+        if (__builtin_memcmp(haystack + offset + 1, needle + 1, needle_length - 2) == 0)
+            return true;
+        ++failed_comparisons;
+        return false;
+    };
+    auto gave_up_at = [&](size_t offset) {
+        return failed_comparisons > 16 + offset / 8;
+    };
+
+    size_t offset = 0;
+#ifdef __SSE2__
+    auto first_byte = SIMD::c8x16 {} + static_cast<char>(needle[0]);
+    auto last_byte = SIMD::c8x16 {} + static_cast<char>(needle[needle_length - 1]);
+    for (; offset + 16 <= last_candidate + 1; offset += 16) {
+        auto mask = compare_block_with_byte(haystack + offset, first_byte) & compare_block_with_byte(haystack + offset + needle_length - 1, last_byte);
+        for (; mask; mask &= mask - 1) {
+            auto candidate = offset + count_trailing_zeroes(mask);
+            if (matches_at(candidate))
+                return candidate;
+        }
+        if (gave_up_at(offset))
+            return fallback(offset);
+    }
+#endif
+
+    while (offset <= last_candidate) {
+        auto const* ptr = find_byte(haystack + offset, last_candidate - offset + 1, needle[0]);
+        if (!ptr)
+            return {};
+        offset = ptr - haystack;
+        if (haystack[offset + needle_length - 1] != needle[needle_length - 1])
+            ++failed_comparisons;
+        else if (matches_at(offset))
+            return offset;
+        if (gave_up_at(offset))
+            return fallback(offset);
+        ++offset;
+    }
+    return {};
+}
+
+}
+
 inline Optional<size_t> memmem_optional(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
 {
     if (needle_length == 0)
@@ -114,16 +227,28 @@ inline Optional<size_t> memmem_optional(const void* haystack, size_t haystack_le
         return {};
     }
 
-    if (needle_length < 32) {
-        auto const* ptr = Detail::bitap_bitwise(haystack, haystack_length, needle, needle_length);
-        if (ptr)
-            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
-        return {};
-    }
+    if (needle_length == 1)
+        return memchr_optional(haystack, haystack_length, *(const u8*)needle);
+
+    auto linear_search = [&](size_t offset) -> Optional<size_t> {
+        auto const* remaining_haystack = (const u8*)haystack + offset;
+        size_t remaining_length = haystack_length - offset;
+        Optional<size_t> result;
+        if (needle_length < 32) {
+            auto const* ptr = Detail::bitap_bitwise(remaining_haystack, remaining_length, needle, needle_length);
+            if (ptr)
+                result = static_cast<size_t>((FlatPtr)ptr - (FlatPtr)remaining_haystack);
+        } else {
+            // Fallback to KMP.
+            Array<Span<const u8>, 1> spans { Span<const u8> { remaining_haystack, remaining_length } };
+            result = memmem(spans.begin(), spans.end(), { (const u8*)needle, needle_length });
+        }
+        if (result.has_value())
+            return *result + offset;
+        return result;
+    };
 
-    // Fallback to KMP.
-    Array<Span<const u8>, 1> spans { Span<const u8> { (const u8*)haystack, haystack_length } };
-    return memmem(spans.begin(), spans.end(), { (const u8*)needle, needle_length });
+    return Detail::memmem_by_first_and_last_byte((const u8*)haystack, haystack_length, (const u8*)needle, needle_length, linear_search);
 }
 
 inline const void* memmem(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
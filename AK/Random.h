@@ -29,7 +29,14 @@ inline void fill_with_random([[maybe_unused]] void* buffer, [[maybe_unused]] siz
     arc4random_buf(buffer, length);
 #elif defined(OSS_FUZZ)
 #elif defined(__unix__) or defined(AK_OS_MACOS)
-    [[maybe_unused]] int rc = getentropy(buffer, length);
+    // getentropy() fails outright for more than 256 bytes, so we have to go in chunks.
+    auto* bytes = static_cast<u8*>(buffer);
+    while (length > 0) {
+        auto chunk_size = length < 256 ? length : 256;
+        [[maybe_unused]] int rc = getentropy(bytes, chunk_size);
+        bytes += chunk_size;
+        length -= chunk_size;
+    }
 #endif
 }
 
@@ -116,13 +116,15 @@ void StringBuilder::clear()
 
 ErrorOr<void> StringBuilder::try_append_code_point(u32 code_point)
 {
-    auto nwritten = AK::UnicodeUtils::code_point_to_utf8(code_point, [this](char c) { append(c); });
-    if (nwritten < 0) {
-        TRY(try_append(0xef));
-        TRY(try_append(0xbf));
-        TRY(try_append(0xbd));
-    }
-    return {};
+    if (code_point < 0x80)
+        return try_append(static_cast<char>(code_point));
+
+    char encoded[4];
+    size_t encoded_length = 0;
+    auto nwritten = AK::UnicodeUtils::code_point_to_utf8(code_point, [&](char c) { encoded[encoded_length++] = c; });
+    if (nwritten < 0)
+        return try_append("\xef\xbf\xbd"sv);
+    return try_append(StringView { encoded, encoded_length });
 }
 
 void StringBuilder::append_code_point(u32 code_point)
@@ -133,6 +135,8 @@ void StringBuilder::append_code_point(u32 code_point)
 #ifndef KERNEL
 ErrorOr<void> StringBuilder::try_append(Utf16View const& utf16_view)
 {
+    // NOTE: Every code unit takes at least one byte, and it's exactly one for ASCII.
+    TRY(will_append(utf16_view.length_in_code_units()));
     for (size_t i = 0; i < utf16_view.length_in_code_units();) {
         auto code_point = utf16_view.code_point_at(i);
         TRY(try_append_code_point(code_point));
@@ -150,6 +154,7 @@ void StringBuilder::append(Utf16View const& utf16_view)
 
 ErrorOr<void> StringBuilder::try_append(Utf32View const& utf32_view)
 {
+    TRY(will_append(utf32_view.length()));
     for (size_t i = 0; i < utf32_view.length(); ++i) {
         auto code_point = utf32_view.code_points()[i];
         TRY(try_append_code_point(code_point));
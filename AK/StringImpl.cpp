@@ -4,12 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/CharacterTypes.h>
 #include <AK/FlyString.h>
 #include <AK/HashTable.h>
 #include <AK/Memory.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringHash.h>
+#include <AK/String.h>
 #include <AK/StringImpl.h>
 #include <AK/kmalloc.h>
 
@@ -26,6 +29,33 @@ StringImpl& StringImpl::the_empty_stringimpl()
     return *s_the_empty_stringimpl;
 }
 
+static Array<Atomic<StringImpl*>, 128> s_single_ascii_character_stringimpls;
+
+StringImpl& StringImpl::the_single_ascii_character_stringimpl(char ch)
+{
+    VERIFY(is_ascii(ch));
+    auto& slot_for_character = s_single_ascii_character_stringimpls[static_cast<u8>(ch)];
+    if (auto* impl = slot_for_character.load(AK::MemoryOrder::memory_order_acquire))
+        return *impl;
+
+    // NOTE: Like the empty StringImpl, these hold a reference of their own that is never dropped. They're interned right
+    //       away (which also makes their reference count atomic, as they end up being used on any thread), so that
+    //       a FlyString of some other StringImpl with the same character finds this one.
+    char* buffer;
+    auto new_impl = create_uninitialized(1, buffer);
+    buffer[0] = ch;
+    FlyString fly_string { String { move(new_impl) } };
+    auto* impl = const_cast<StringImpl*>(fly_string.impl());
+    impl->ref();
+
+    StringImpl* expected = nullptr;
+    if (slot_for_character.compare_exchange_strong(expected, impl, AK::MemoryOrder::memory_order_acq_rel))
+        return *impl;
+    // Another thread got there first.
+    impl->unref();
+    return *expected;
+}
+
 StringImpl::StringImpl(ConstructWithInlineBufferTag, size_t length)
     : m_length(length)
 {
@@ -66,6 +96,9 @@ RefPtr<StringImpl> StringImpl::create(const char* cstring, size_t length, Should
     if (!length)
         return the_empty_stringimpl();
 
+    if (length == 1 && is_ascii(cstring[0]))
+        return the_single_ascii_character_stringimpl(cstring[0]);
+
     char* buffer;
     auto new_stringimpl = create_uninitialized(length, buffer);
     memcpy(buffer, cstring, length * sizeof(char));
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -40,6 +41,8 @@ public:
     }
 
     static StringImpl& the_empty_stringimpl();
+    // Single ASCII characters come up often enough (separators, punctuation, digits) that they all share one StringImpl each.
+    static StringImpl& the_single_ascii_character_stringimpl(char);
 
     ~StringImpl();
 
@@ -80,6 +83,40 @@ public:
     bool is_fly() const { return m_fly; }
     void set_fly(Badge<FlyString>, bool fly) const { m_fly = fly; }
 
+    // NOTE: Fly StringImpls are shared between threads through the FlyString table, so their reference count is
+    //       atomic. Every other StringImpl belongs to one thread at a time and gets away with plain arithmetic.
+    ALWAYS_INLINE void ref() const
+    {
+        if (m_fly) [[unlikely]] {
+            atomic_fetch_add(&m_ref_count, static_cast<RefCountType>(1), memory_order_relaxed);
+            return;
+        }
+        RefCounted::ref();
+    }
+
+    ALWAYS_INLINE bool unref() const
+    {
+        if (m_fly) [[unlikely]] {
+            bool is_last_reference = atomic_fetch_sub(&m_ref_count, static_cast<RefCountType>(1), memory_order_acq_rel) == 1;
+            if (is_last_reference)
+                delete this;
+            return is_last_reference;
+        }
+        return RefCounted::unref();
+    }
+
+    // Takes a reference unless the last one is already gone, which lets the FlyString table skip StringImpls that are being destroyed.
+    [[nodiscard]] bool try_ref_fly(Badge<FlyString>) const
+    {
+        VERIFY(m_fly);
+        auto ref_count = atomic_load(&m_ref_count, memory_order_relaxed);
+        do {
+            if (ref_count == 0)
+                return false;
+        } while (!atomic_compare_exchange_strong(&m_ref_count, ref_count, ref_count + 1, memory_order_relaxed));
+        return true;
+    }
+
 private:
     enum ConstructTheEmptyStringImplTag {
         ConstructTheEmptyStringImpl
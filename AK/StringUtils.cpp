@@ -358,11 +358,8 @@ Optional<size_t> find(StringView haystack, char needle, size_t start)
 {
     if (start >= haystack.length())
         return {};
-    for (size_t i = start; i < haystack.length(); ++i) {
-        if (haystack[i] == needle)
-            return i;
-    }
-    return {};
+    auto index = AK::memchr_optional(haystack.characters_without_null_termination() + start, haystack.length() - start, needle);
+    return index.has_value() ? (*index + start) : index;
 }
 
 Optional<size_t> find(StringView haystack, StringView needle, size_t start)
@@ -130,11 +130,7 @@ bool StringView::matches(StringView mask, CaseSensitivity case_sensitivity) cons
 
 bool StringView::contains(char needle) const
 {
-    for (char current : *this) {
-        if (current == needle)
-            return true;
-    }
-    return false;
+    return find(needle).has_value();
 }
 
 bool StringView::contains(StringView needle, CaseSensitivity case_sensitivity) const
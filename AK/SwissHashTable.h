@@ -0,0 +1,535 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/HashTable.h>
+#include <AK/Optional.h>
+
+#ifdef __SSE2__
+#    include <AK/SIMD.h>
+#endif
+
+namespace AK {
+
+namespace Detail {
+
+struct SwissHashTableControl {
+    static constexpr size_t group_size = 16;
+
+    static constexpr u8 empty = 0x80;
+    static constexpr u8 deleted = 0xfe;
+
+    // Full slots have the high bit clear, empty and deleted ones have it set.
+    static constexpr bool is_full(u8 control) { return !(control & 0x80); }
+
+    static constexpr u8 h2(unsigned hash) { return hash & 0x7f; }
+    static constexpr size_t h1(unsigned hash) { return hash >> 7; }
+
+    // Bit N of the result is set if control byte N in the group equals `value`.
+    static ALWAYS_INLINE u32 match(u8 const* group, u8 value)
+    {
+#ifdef __SSE2__
+        SIMD::c8x16 controls;
+        __builtin_memcpy(&controls, group, sizeof(controls));
+        return static_cast<u32>(__builtin_ia32_pmovmskb128(controls == (SIMD::c8x16 {} + static_cast<char>(value))));
+#else
+        u32 mask = 0;
+        for (size_t i = 0; i < group_size; ++i)
+            mask |= static_cast<u32>(group[i] == value) << i;
+        return mask;
+#endif
+    }
+
+    static ALWAYS_INLINE u32 match_empty(u8 const* group) { return match(group, empty); }
+
+    static ALWAYS_INLINE u32 match_empty_or_deleted(u8 const* group)
+    {
+#ifdef __SSE2__
+        SIMD::c8x16 controls;
+        __builtin_memcpy(&controls, group, sizeof(controls));
+        return static_cast<u32>(__builtin_ia32_pmovmskb128(controls));
+#else
+        u32 mask = 0;
+        for (size_t i = 0; i < group_size; ++i)
+            mask |= static_cast<u32>(!is_full(group[i])) << i;
+        return mask;
+#endif
+    }
+};
+
+}
+
+template<typename SwissHashTableType, typename T>
+class SwissHashTableIterator {
+    friend SwissHashTableType;
+
+public:
+    bool operator==(SwissHashTableIterator const& other) const { return m_slot == other.m_slot; }
+    bool operator!=(SwissHashTableIterator const& other) const { return m_slot != other.m_slot; }
+    T& operator*() { return *m_slot; }
+    T* operator->() { return m_slot; }
+    void operator++() { skip_to_next(); }
+
+private:
+    void skip_to_next()
+    {
+        if (!m_slot)
+            return;
+        do {
+            ++m_control;
+            ++m_slot;
+        } while (m_control != m_control_end && !Detail::SwissHashTableControl::is_full(*m_control));
+        if (m_control == m_control_end)
+            m_slot = nullptr;
+    }
+
+    SwissHashTableIterator(u8 const* control, u8 const* control_end, T* slot)
+        : m_control(control)
+        , m_control_end(control_end)
+        , m_slot(slot)
+    {
+    }
+
+    u8 const* m_control { nullptr };
+    u8 const* m_control_end { nullptr };
+    T* m_slot { nullptr };
+};
+
+// SwissHashTable keeps one control byte per slot in an array of its own, apart from the slots.
+// A control byte is either empty, deleted, or holds 7 bits of the hash of the value in its slot.
+// Lookups compare a whole group of control bytes at once and only touch the slots whose control
+// byte matches, so the slots themselves are rarely read in vain.
+//
+// It offers the same interface as an unordered HashTable, so any user can switch over by type.
+template<typename T, typename TraitsForT, bool IsOrdered>
+class SwissHashTable {
+    static_assert(!IsOrdered, "SwissHashTable doesn't keep the insertion order, use an OrderedHashTable instead");
+
+    using Control = Detail::SwissHashTableControl;
+    static constexpr size_t group_size = Control::group_size;
+
+public:
+    SwissHashTable() = default;
+    explicit SwissHashTable(size_t capacity) { rehash(capacity); }
+
+    ~SwissHashTable()
+    {
+        if (!m_control)
+            return;
+
+        if constexpr (!Detail::IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Control::is_full(m_control[i]))
+                    m_slots[i].~T();
+            }
+        }
+
+        kfree_sized(m_control, size_in_bytes(m_capacity));
+    }
+
+    SwissHashTable(SwissHashTable const& other)
+    {
+        rehash(other.capacity());
+        for (auto& it : other)
+            set(it);
+    }
+
+    SwissHashTable& operator=(SwissHashTable const& other)
+    {
+        SwissHashTable temporary(other);
+        swap(*this, temporary);
+        return *this;
+    }
+
+    SwissHashTable(SwissHashTable&& other) noexcept
+        : m_control(other.m_control)
+        , m_slots(other.m_slots)
+        , m_size(other.m_size)
+        , m_capacity(other.m_capacity)
+        , m_deleted_count(other.m_deleted_count)
+    {
+        other.m_control = nullptr;
+        other.m_slots = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+        other.m_deleted_count = 0;
+    }
+
+    SwissHashTable& operator=(SwissHashTable&& other) noexcept
+    {
+        SwissHashTable temporary { move(other) };
+        swap(*this, temporary);
+        return *this;
+    }
+
+    friend void swap(SwissHashTable& a, SwissHashTable& b) noexcept
+    {
+        swap(a.m_control, b.m_control);
+        swap(a.m_slots, b.m_slots);
+        swap(a.m_size, b.m_size);
+        swap(a.m_capacity, b.m_capacity);
+        swap(a.m_deleted_count, b.m_deleted_count);
+    }
+
+    [[nodiscard]] bool is_empty() const { return m_size == 0; }
+    [[nodiscard]] size_t size() const { return m_size; }
+    [[nodiscard]] size_t capacity() const { return m_capacity; }
+
+    template<typename U, size_t N>
+    ErrorOr<void> try_set_from(U (&from_array)[N])
+    {
+        for (size_t i = 0; i < N; ++i)
+            TRY(try_set(from_array[i]));
+        return {};
+    }
+    template<typename U, size_t N>
+    void set_from(U (&from_array)[N])
+    {
+        MUST(try_set_from(from_array));
+    }
+
+    void ensure_capacity(size_t capacity)
+    {
+        MUST(try_ensure_capacity(capacity));
+    }
+
+    ErrorOr<void> try_ensure_capacity(size_t capacity)
+    {
+        VERIFY(capacity >= size());
+        if (capacity <= max_used_slot_count(m_capacity) - m_deleted_count)
+            return {};
+        return try_rehash(capacity);
+    }
+
+    [[nodiscard]] bool contains(T const& value) const
+    {
+        return find(value) != end();
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] bool contains(K const& value) const
+    {
+        return find(value) != end();
+    }
+
+    using Iterator = SwissHashTableIterator<SwissHashTable, T>;
+    using ConstIterator = SwissHashTableIterator<SwissHashTable const, T const>;
+
+    [[nodiscard]] Iterator begin() { return iterator_for(first_full_index()); }
+    [[nodiscard]] Iterator end() { return Iterator(nullptr, nullptr, nullptr); }
+    [[nodiscard]] ConstIterator begin() const { return iterator_for(first_full_index()); }
+    [[nodiscard]] ConstIterator end() const { return ConstIterator(nullptr, nullptr, nullptr); }
+
+    void clear()
+    {
+        *this = SwissHashTable();
+    }
+    void clear_with_capacity()
+    {
+        if (!m_control)
+            return;
+        if constexpr (!Detail::IsTriviallyDestructible<T>) {
+            for (size_t i = 0; i < m_capacity; ++i) {
+                if (Control::is_full(m_control[i]))
+                    m_slots[i].~T();
+            }
+        }
+        __builtin_memset(m_control, Control::empty, m_capacity);
+        m_size = 0;
+        m_deleted_count = 0;
+    }
+
+    template<typename U = T>
+    ErrorOr<HashSetResult> try_set(U&& value, HashSetExistingEntryBehavior existing_entry_behavior = HashSetExistingEntryBehavior::Replace)
+    {
+        if (should_grow())
+            TRY(try_grow());
+
+        auto hash = TraitsForT::hash(value);
+        auto index = find_index(hash, [&](auto& other) { return TraitsForT::equals(other, value); });
+        if (index.has_value()) {
+            if (existing_entry_behavior == HashSetExistingEntryBehavior::Keep)
+                return HashSetResult::KeptExistingEntry;
+            m_slots[*index] = forward<U>(value);
+            return HashSetResult::ReplacedExistingEntry;
+        }
+
+        auto free_index = find_free_index(hash);
+        new (&m_slots[free_index]) T(forward<U>(value));
+        if (m_control[free_index] == Control::deleted)
+            --m_deleted_count;
+        m_control[free_index] = Control::h2(hash);
+        ++m_size;
+        return HashSetResult::InsertedNewEntry;
+    }
+    template<typename U = T>
+    HashSetResult set(U&& value, HashSetExistingEntryBehavior existing_entry_behaviour = HashSetExistingEntryBehavior::Replace)
+    {
+        return MUST(try_set(forward<U>(value), existing_entry_behaviour));
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] Iterator find(unsigned hash, TUnaryPredicate predicate)
+    {
+        return iterator_for(find_index(hash, move(predicate)));
+    }
+
+    [[nodiscard]] Iterator find(T const& value)
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    template<typename TUnaryPredicate>
+    [[nodiscard]] ConstIterator find(unsigned hash, TUnaryPredicate predicate) const
+    {
+        return iterator_for(find_index(hash, move(predicate)));
+    }
+
+    [[nodiscard]] ConstIterator find(T const& value) const
+    {
+        return find(TraitsForT::hash(value), [&](auto& other) { return TraitsForT::equals(value, other); });
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value)
+    {
+        return find(Traits<K>::hash(value), [&](auto& other) { return Traits<T>::equals(other, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] Iterator find(K const& value, TUnaryPredicate predicate)
+    {
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value) const
+    {
+        return find(Traits<K>::hash(value), [&](auto& other) { return Traits<T>::equals(other, value); });
+    }
+
+    template<Concepts::HashCompatible<T> K, typename TUnaryPredicate>
+    requires(IsSame<TraitsForT, Traits<T>>) [[nodiscard]] ConstIterator find(K const& value, TUnaryPredicate predicate) const
+    {
+        return find(Traits<K>::hash(value), move(predicate));
+    }
+
+    bool remove(T const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    template<Concepts::HashCompatible<T> K>
+    requires(IsSame<TraitsForT, Traits<T>>) bool remove(K const& value)
+    {
+        auto it = find(value);
+        if (it != end()) {
+            remove(it);
+            return true;
+        }
+        return false;
+    }
+
+    void remove(Iterator iterator)
+    {
+        VERIFY(iterator.m_slot);
+        size_t index = iterator.m_slot - m_slots;
+        VERIFY(index < m_capacity);
+        VERIFY(Control::is_full(m_control[index]));
+
+        delete_slot(index);
+        --m_size;
+
+        shrink_if_needed();
+    }
+
+    template<typename TUnaryPredicate>
+    bool remove_all_matching(TUnaryPredicate predicate)
+    {
+        size_t removed_count = 0;
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (Control::is_full(m_control[i]) && predicate(m_slots[i])) {
+                delete_slot(i);
+                ++removed_count;
+            }
+        }
+        m_size -= removed_count;
+        shrink_if_needed();
+        return removed_count;
+    }
+
+private:
+    // NOTE: The table is kept at most 7/8 full (counting deleted slots), so every probe sequence ends in an empty slot.
+    [[nodiscard]] static constexpr size_t max_used_slot_count(size_t capacity) { return capacity - capacity / 8; }
+
+    [[nodiscard]] static constexpr size_t slots_offset(size_t capacity)
+    {
+        return align_up_to(capacity, alignof(T));
+    }
+
+    [[nodiscard]] static constexpr size_t size_in_bytes(size_t capacity)
+    {
+        return slots_offset(capacity) + sizeof(T) * capacity;
+    }
+
+    [[nodiscard]] size_t group_mask() const { return m_capacity / group_size - 1; }
+
+    // NOTE: The probe sequence moves ahead by 1, 2, 3... groups, which visits every group once since the group count is a power of two.
+    template<typename TUnaryPredicate>
+    [[nodiscard]] Optional<size_t> find_index(unsigned hash, TUnaryPredicate predicate) const
+    {
+        if (is_empty())
+            return {};
+
+        auto h2 = Control::h2(hash);
+        auto group_mask = this->group_mask();
+        size_t group_index = Control::h1(hash) & group_mask;
+        for (size_t step = 1;; ++step) {
+            auto group_start = group_index * group_size;
+            auto const* group = m_control + group_start;
+            for (auto mask = Control::match(group, h2); mask; mask &= mask - 1) {
+                auto index = group_start + count_trailing_zeroes(mask);
+                if (predicate(m_slots[index]))
+                    return index;
+            }
+            if (Control::match_empty(group))
+                return {};
+            group_index = (group_index + step) & group_mask;
+        }
+    }
+
+    [[nodiscard]] size_t find_free_index(unsigned hash) const
+    {
+        auto group_mask = this->group_mask();
+        size_t group_index = Control::h1(hash) & group_mask;
+        for (size_t step = 1;; ++step) {
+            auto group_start = group_index * group_size;
+            if (auto mask = Control::match_empty_or_deleted(m_control + group_start))
+                return group_start + count_trailing_zeroes(mask);
+            group_index = (group_index + step) & group_mask;
+        }
+    }
+
+    [[nodiscard]] bool should_grow() const { return m_size + m_deleted_count + 1 > max_used_slot_count(m_capacity); }
+
+    ErrorOr<void> try_grow()
+    {
+        // If it's mostly deleted slots that fill the table, getting rid of them is enough.
+        if (m_size * 2 < max_used_slot_count(m_capacity))
+            return try_rehash(m_capacity);
+        return try_rehash(m_capacity * 2);
+    }
+
+    // Makes room for at least `minimum_size` values.
+    ErrorOr<void> try_rehash(size_t minimum_size)
+    {
+        size_t new_capacity = group_size;
+        while (max_used_slot_count(new_capacity) < max(minimum_size, m_size + 1))
+            new_capacity *= 2;
+
+        auto* new_control = static_cast<u8*>(kmalloc(size_in_bytes(new_capacity)));
+        if (!new_control)
+            return Error::from_errno(ENOMEM);
+        __builtin_memset(new_control, Control::empty, new_capacity);
+
+        auto* old_control = m_control;
+        auto* old_slots = m_slots;
+        auto old_capacity = m_capacity;
+
+        m_control = new_control;
+        m_slots = reinterpret_cast<T*>(new_control + slots_offset(new_capacity));
+        m_capacity = new_capacity;
+        m_deleted_count = 0;
+
+        if (!old_control)
+            return {};
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!Control::is_full(old_control[i]))
+                continue;
+            auto hash = TraitsForT::hash(old_slots[i]);
+            auto index = find_free_index(hash);
+            new (&m_slots[index]) T(move(old_slots[i]));
+            m_control[index] = Control::h2(hash);
+            old_slots[i].~T();
+        }
+
+        kfree_sized(old_control, size_in_bytes(old_capacity));
+        return {};
+    }
+    void rehash(size_t minimum_size)
+    {
+        MUST(try_rehash(minimum_size));
+    }
+
+    void shrink_if_needed()
+    {
+        // Shrink if less than 20% of slots are used, but never going below 16.
+        // These limits are totally arbitrary and can probably be improved.
+        bool should_shrink = m_size * 5 < m_capacity && m_capacity > 16;
+        if (!should_shrink)
+            return;
+
+        // NOTE: We ignore memory allocation failure here, since we can continue
+        //       just fine with an oversized table.
+        (void)try_rehash(m_size * 2);
+    }
+
+    void delete_slot(size_t index)
+    {
+        m_slots[index].~T();
+
+        // If the group still has an empty slot, no probe sequence ever went past it, so the slot can become empty again.
+        auto const* group = m_control + (index & ~(group_size - 1));
+        if (Control::match_empty(group)) {
+            m_control[index] = Control::empty;
+        } else {
+            m_control[index] = Control::deleted;
+            ++m_deleted_count;
+        }
+    }
+
+    [[nodiscard]] Optional<size_t> first_full_index() const
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (Control::is_full(m_control[i]))
+                return i;
+        }
+        return {};
+    }
+
+    [[nodiscard]] Iterator iterator_for(Optional<size_t> index)
+    {
+        if (!index.has_value())
+            return end();
+        return Iterator(m_control + *index, m_control + m_capacity, m_slots + *index);
+    }
+
+    [[nodiscard]] ConstIterator iterator_for(Optional<size_t> index) const
+    {
+        if (!index.has_value())
+            return end();
+        return ConstIterator(m_control + *index, m_control + m_capacity, m_slots + *index);
+    }
+
+    u8* m_control { nullptr };
+    T* m_slots { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    size_t m_deleted_count { 0 };
+};
+
+}
+
+using AK::SwissHashMap;
+using AK::SwissHashTable;
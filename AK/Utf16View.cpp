@@ -21,7 +21,7 @@ static constexpr u32 replacement_code_point = 0xfffd;
 static constexpr u32 first_supplementary_plane_code_point = 0x10000;
 
 template<typename UtfViewType>
-static Vector<u16, 1> to_utf16_impl(UtfViewType const& view) requires(IsSame<UtfViewType, Utf8View> || IsSame<UtfViewType, Utf32View>)
+static Vector<u16, 1> to_utf16_impl(UtfViewType const& view) requires(IsSame<UtfViewType, Utf32View>)
 {
     Vector<u16, 1> utf16_data;
     utf16_data.ensure_capacity(view.length());
@@ -34,12 +34,30 @@ static Vector<u16, 1> to_utf16_impl(UtfViewType const& view) requires(IsSame<Utf
 
 Vector<u16, 1> utf8_to_utf16(StringView utf8_view)
 {
-    return to_utf16_impl(Utf8View { utf8_view });
+    return utf8_to_utf16(Utf8View { utf8_view });
 }
 
 Vector<u16, 1> utf8_to_utf16(Utf8View const& utf8_view)
 {
-    return to_utf16_impl(utf8_view);
+    Vector<u16, 1> utf16_data;
+    // Every code unit comes from at least one byte, so this is enough room without having to count the code points first.
+    utf16_data.ensure_capacity(utf8_view.byte_length());
+
+    auto remaining = utf8_view;
+    while (!remaining.is_empty()) {
+        auto ascii_length = remaining.ascii_prefix_length();
+        for (size_t i = 0; i < ascii_length; ++i)
+            utf16_data.unchecked_append(remaining.bytes()[i]);
+        if (ascii_length == remaining.byte_length())
+            break;
+
+        remaining = remaining.substring_view(ascii_length);
+        auto iterator = remaining.begin();
+        code_point_to_utf16(utf16_data, *iterator);
+        remaining = remaining.substring_view(iterator.underlying_code_point_length_in_bytes());
+    }
+
+    return utf16_data;
 }
 
 Vector<u16, 1> utf32_to_utf16(Utf32View const& utf32_view)
@@ -6,11 +6,57 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/BuiltinWrappers.h>
 #include <AK/Format.h>
 #include <AK/Utf8View.h>
 
+#ifdef __SSE2__
+#    include <AK/SIMD.h>
+#endif
+
 namespace AK {
 
+static size_t ascii_prefix_length_of(u8 const* data, size_t length)
+{
+    auto const* ptr = data;
+    auto const* end = data + length;
+
+#ifdef __SSE2__
+    // pmovmskb gathers the high bit of every byte, so a block is all ASCII exactly when its mask is zero.
+    auto load_block = [](u8 const* block_ptr) {
+        SIMD::c8x16 block;
+        __builtin_memcpy(&block, block_ptr, sizeof(block));
+        return block;
+    };
+    for (; end - ptr >= 64; ptr += 64) {
+        auto combined = load_block(ptr) | load_block(ptr + 16) | load_block(ptr + 32) | load_block(ptr + 48);
+        if (__builtin_ia32_pmovmskb128(combined) != 0)
+            break;
+    }
+    for (; end - ptr >= 16; ptr += 16) {
+        if (auto mask = static_cast<u32>(__builtin_ia32_pmovmskb128(load_block(ptr))))
+            return ptr - data + count_trailing_zeroes(mask);
+    }
+#else
+    constexpr FlatPtr high_bits = explode_byte(0x80);
+    for (; end - ptr >= static_cast<ptrdiff_t>(sizeof(FlatPtr)); ptr += sizeof(FlatPtr)) {
+        FlatPtr word;
+        __builtin_memcpy(&word, ptr, sizeof(word));
+        if (word & high_bits)
+            break;
+    }
+#endif
+
+    while (ptr < end && *ptr < 0x80)
+        ++ptr;
+    return ptr - data;
+}
+
+size_t Utf8View::ascii_prefix_length() const
+{
+    return ascii_prefix_length_of(begin_ptr(), byte_length());
+}
+
 Utf8CodePointIterator Utf8View::iterator_at_byte_offset(size_t byte_offset) const
 {
     size_t current_offset = 0;
@@ -99,22 +145,31 @@ static inline bool decode_first_byte(
 bool Utf8View::validate(size_t& valid_bytes) const
 {
     valid_bytes = 0;
-    for (auto ptr = begin_ptr(); ptr < end_ptr(); ptr++) {
-        size_t code_point_length_in_bytes;
-        u32 value;
-        bool first_byte_makes_sense = decode_first_byte(*ptr, code_point_length_in_bytes, value);
-        if (!first_byte_makes_sense)
-            return false;
-
-        for (size_t i = 1; i < code_point_length_in_bytes; i++) {
-            ptr++;
-            if (ptr >= end_ptr())
+    auto const* ptr = begin_ptr();
+    while (ptr < end_ptr()) {
+        // Most text is ASCII, so skip over it a block at a time before looking at individual code points.
+        auto ascii_length = ascii_prefix_length_of(ptr, end_ptr() - ptr);
+        ptr += ascii_length;
+        valid_bytes += ascii_length;
+
+        // Then validate multi-byte code points one by one until we run into ASCII again.
+        while (ptr < end_ptr() && *ptr >= 0x80) {
+            size_t code_point_length_in_bytes;
+            u32 value;
+            bool first_byte_makes_sense = decode_first_byte(*ptr, code_point_length_in_bytes, value);
+            if (!first_byte_makes_sense)
                 return false;
-            if (*ptr >> 6 != 2)
+
+            if (code_point_length_in_bytes > static_cast<size_t>(end_ptr() - ptr))
                 return false;
-        }
+            for (size_t i = 1; i < code_point_length_in_bytes; i++) {
+                if (ptr[i] >> 6 != 2)
+                    return false;
+            }
 
-        valid_bytes += code_point_length_in_bytes;
+            ptr += code_point_length_in_bytes;
+            valid_bytes += code_point_length_in_bytes;
+        }
     }
 
     return true;
@@ -123,7 +178,13 @@ bool Utf8View::validate(size_t& valid_bytes) const
 size_t Utf8View::calculate_length() const
 {
     size_t length = 0;
-    for ([[maybe_unused]] auto code_point : *this) {
+    for (auto iterator = begin(); !iterator.done(); ++iterator) {
+        auto ascii_length = ascii_prefix_length_of(iterator.m_ptr, iterator.m_length);
+        iterator.m_ptr += ascii_length;
+        iterator.m_length -= ascii_length;
+        length += ascii_length;
+        if (iterator.done())
+            break;
         ++length;
     }
     return length;
@@ -188,7 +249,7 @@ Utf8View Utf8View::trim(const Utf8View& characters, TrimMode mode) const
     return substring_view(substring_start, substring_length);
 }
 
-Utf8CodePointIterator& Utf8CodePointIterator::operator++()
+Utf8CodePointIterator& Utf8CodePointIterator::advance_past_multibyte_code_point()
 {
     VERIFY(m_length > 0);
 
@@ -234,7 +295,7 @@ ReadonlyBytes Utf8CodePointIterator::underlying_code_point_bytes() const
     return { m_ptr, underlying_code_point_length_in_bytes() };
 }
 
-u32 Utf8CodePointIterator::operator*() const
+u32 Utf8CodePointIterator::decode_multibyte_code_point() const
 {
     VERIFY(m_length > 0);
 
@@ -24,8 +24,23 @@ public:
 
     bool operator==(Utf8CodePointIterator const&) const = default;
     bool operator!=(Utf8CodePointIterator const&) const = default;
-    Utf8CodePointIterator& operator++();
-    u32 operator*() const;
+    Utf8CodePointIterator& operator++()
+    {
+        if (m_length > 0 && *m_ptr < 0x80) {
+            ++m_ptr;
+            --m_length;
+            return *this;
+        }
+        return advance_past_multibyte_code_point();
+    }
+
+    u32 operator*() const
+    {
+        if (m_length > 0 && *m_ptr < 0x80)
+            return *m_ptr;
+        return decode_multibyte_code_point();
+    }
+
     // NOTE: This returns {} if the peek is at or past EOF.
     Optional<u32> peek(size_t offset = 0) const;
 
@@ -50,6 +65,10 @@ private:
     {
     }
 
+    // NOTE: ASCII is handled inline above, these deal with everything else (including being done).
+    Utf8CodePointIterator& advance_past_multibyte_code_point();
+    u32 decode_multibyte_code_point() const;
+
     u8 const* m_ptr { nullptr };
     size_t m_length { 0 };
 };
@@ -102,6 +121,9 @@ public:
         return byte_offset_of(it);
     }
 
+    // Returns the number of bytes before the first non-ASCII byte.
+    size_t ascii_prefix_length() const;
+
     bool validate(size_t& valid_bytes) const;
     bool validate() const
     {
@@ -49,14 +49,21 @@ extern "C" {
 #define FUTEX_REQUEUE 3
 #define FUTEX_CMP_REQUEUE 4
 #define FUTEX_WAKE_OP 5
+#define FUTEX_LOCK_PI 6
+#define FUTEX_UNLOCK_PI 7
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
 
+#define FUTEX_PRIVATE_FLAG (1 << 7)
 #define FUTEX_CLOCK_REALTIME (1 << 8)
-#define FUTEX_CMD_MASK ~(FUTEX_CLOCK_REALTIME)
+#define FUTEX_CMD_MASK ~(FUTEX_PRIVATE_FLAG | FUTEX_CLOCK_REALTIME)
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+// The value of a priority inheritance futex is the tid of its owner, with FUTEX_WAITERS set once somebody has to be woken.
+#define FUTEX_WAITERS 0x80000000
+#define FUTEX_TID_MASK 0x3fffffff
+
 #ifdef __cplusplus
 }
 #endif
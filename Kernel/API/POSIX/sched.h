@@ -16,6 +16,18 @@ struct sched_param {
     int sched_priority;
 };
 
+#define SCHED_FIFO 0
+#define SCHED_RR 1
+#define SCHED_OTHER 2
+#define SCHED_BATCH 3
+
+// NOTE: Thread affinity is a 32-bit mask in the kernel, so that's as many processors as a set can hold.
+#define CPU_SETSIZE 32
+
+typedef struct {
+    uint32_t __bits;
+} cpu_set_t;
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,11 @@ enum {
     PERF_EVENT_SYSCALL = 16384,
     PERF_EVENT_SIGNPOST = 32768,
     PERF_EVENT_READ = 65536,
+    PERF_EVENT_CYCLES = 131072,
+    PERF_EVENT_INSTRUCTIONS = 262144,
+    PERF_EVENT_CACHE_MISSES = 524288,
+    PERF_EVENT_BRANCH_MISSES = 1048576,
+    PERF_EVENT_TRACEPOINT = 2097152,
 };
 
 #define PERF_EVENT_MASK_ALL (~0ull)
@@ -43,6 +48,26 @@ enum {
 #define THREAD_PRIORITY_HIGH 50
 #define THREAD_PRIORITY_MAX 99
 
+enum {
+    IO_REQUEST_READ = 1,
+    IO_REQUEST_WRITE = 2,
+    IO_REQUEST_PREAD = 3,
+    IO_REQUEST_FSYNC = 4,
+};
+
+// NOTE: io_submit() fills in the result of each request, which is what the matching
+//       system call would have returned, or a negated errno value on failure.
+struct io_request {
+    int opcode;
+    int fd;
+    void* buffer;
+    size_t size;
+    off_t offset;
+    ssize_t result;
+};
+
+#define IO_SUBMIT_MAX_REQUESTS 1024
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// The layout of /proc/all_binary, which has the same contents as /proc/all.
+// It starts with a header, followed by one record for every process, each of
+// them followed by the records of its threads. Every record starts with its type
+// and total size (including the strings trailing it), so readers can skip records
+// they don't know about. Strings are not null-terminated.
+
+#define PROCESS_STATISTICS_VERSION 1
+
+struct [[gnu::packed]] ProcessStatisticsHeader {
+    u32 version;
+    u32 reserved;
+    u64 total_time;
+    u64 total_time_kernel;
+};
+
+enum class ProcessStatisticsRecordType : u32 {
+    Process = 1,
+    Thread = 2,
+};
+
+struct [[gnu::packed]] ProcessStatisticsRecordHeader {
+    ProcessStatisticsRecordType type;
+    u32 size;
+};
+
+struct [[gnu::packed]] ProcessStatisticsProcessRecord {
+    ProcessStatisticsRecordHeader header;
+    i32 pid;
+    i32 pgid;
+    i32 pgp;
+    i32 sid;
+    u32 uid;
+    u32 gid;
+    i32 ppid;
+    u32 nfds;
+    u8 kernel;
+    u8 dumpable;
+    u64 amount_virtual;
+    u64 amount_resident;
+    u64 amount_dirty_private;
+    u64 amount_clean_inode;
+    u64 amount_shared;
+    u64 amount_purgeable_volatile;
+    u64 amount_purgeable_nonvolatile;
+    u16 name_length;
+    u16 executable_length;
+    u16 tty_length;
+    u16 pledge_length;
+    u16 veil_length;
+    // Followed by the name, executable, tty, pledge and veil strings.
+};
+
+struct [[gnu::packed]] ProcessStatisticsThreadRecord {
+    ProcessStatisticsRecordHeader header;
+    i32 tid;
+    u32 times_scheduled;
+    u64 time_user;
+    u64 time_kernel;
+    u32 cpu;
+    u32 priority;
+    u64 syscall_count;
+    u64 inode_faults;
+    u64 zero_faults;
+    u64 cow_faults;
+    u64 file_read_bytes;
+    u64 file_write_bytes;
+    u64 unix_socket_read_bytes;
+    u64 unix_socket_write_bytes;
+    u64 ipv4_socket_read_bytes;
+    u64 ipv4_socket_write_bytes;
+    u16 name_length;
+    u16 state_length;
+    // Followed by the name and state strings.
+};
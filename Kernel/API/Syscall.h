@@ -13,6 +13,7 @@
 constexpr int syscall_vector = 0x82;
 
 extern "C" {
+struct epoll_event;
 struct pollfd;
 struct timeval;
 struct timespec;
@@ -56,6 +57,7 @@ enum class NeedsBigProcessLock {
     S(clock_settime, NeedsBigProcessLock::Yes)              \
     S(close, NeedsBigProcessLock::Yes)                      \
     S(connect, NeedsBigProcessLock::Yes)                    \
+    S(copy_file_range, NeedsBigProcessLock::Yes)            \
     S(create_inode_watcher, NeedsBigProcessLock::Yes)       \
     S(create_thread, NeedsBigProcessLock::Yes)              \
     S(dbgputstr, NeedsBigProcessLock::No)                   \
@@ -64,6 +66,9 @@ enum class NeedsBigProcessLock {
     S(dump_backtrace, NeedsBigProcessLock::No)              \
     S(dup2, NeedsBigProcessLock::No)                        \
     S(emuctl, NeedsBigProcessLock::No)                      \
+    S(epoll_create, NeedsBigProcessLock::Yes)               \
+    S(epoll_ctl, NeedsBigProcessLock::Yes)                  \
+    S(epoll_wait, NeedsBigProcessLock::Yes)                 \
     S(execve, NeedsBigProcessLock::Yes)                     \
     S(exit, NeedsBigProcessLock::Yes)                       \
     S(exit_thread, NeedsBigProcessLock::Yes)                \
@@ -76,7 +81,7 @@ enum class NeedsBigProcessLock {
     S(fstatvfs, NeedsBigProcessLock::No)                    \
     S(fsync, NeedsBigProcessLock::No)                       \
     S(ftruncate, NeedsBigProcessLock::No)                   \
-    S(futex, NeedsBigProcessLock::Yes)                      \
+    S(futex, NeedsBigProcessLock::No)                       \
     S(get_dir_entries, NeedsBigProcessLock::Yes)            \
     S(get_process_name, NeedsBigProcessLock::Yes)           \
     S(get_stack_bounds, NeedsBigProcessLock::No)            \
@@ -104,6 +109,7 @@ enum class NeedsBigProcessLock {
     S(getuid, NeedsBigProcessLock::Yes)                     \
     S(inode_watcher_add_watch, NeedsBigProcessLock::Yes)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::Yes) \
+    S(io_submit, NeedsBigProcessLock::Yes)                  \
     S(ioctl, NeedsBigProcessLock::Yes)                      \
     S(join_thread, NeedsBigProcessLock::Yes)                \
     S(kill, NeedsBigProcessLock::Yes)                       \
@@ -145,9 +151,14 @@ enum class NeedsBigProcessLock {
     S(recvmsg, NeedsBigProcessLock::Yes)                    \
     S(rename, NeedsBigProcessLock::Yes)                     \
     S(rmdir, NeedsBigProcessLock::Yes)                      \
+    S(sched_getaffinity, NeedsBigProcessLock::Yes)          \
     S(sched_getparam, NeedsBigProcessLock::Yes)             \
+    S(sched_getscheduler, NeedsBigProcessLock::Yes)         \
+    S(sched_setaffinity, NeedsBigProcessLock::Yes)          \
     S(sched_setparam, NeedsBigProcessLock::Yes)             \
+    S(sched_setscheduler, NeedsBigProcessLock::Yes)         \
     S(sendfd, NeedsBigProcessLock::Yes)                     \
+    S(sendfile, NeedsBigProcessLock::Yes)                   \
     S(sendmsg, NeedsBigProcessLock::Yes)                    \
     S(set_coredump_metadata, NeedsBigProcessLock::Yes)      \
     S(set_mmap_name, NeedsBigProcessLock::Yes)              \
@@ -267,6 +278,21 @@ struct SC_poll_params {
     const u32* sigmask;
 };
 
+struct SC_epoll_ctl_params {
+    int epfd;
+    int op;
+    int fd;
+    const struct epoll_event* event;
+};
+
+struct SC_epoll_wait_params {
+    int epfd;
+    struct epoll_event* events;
+    int maxevents;
+    const struct timespec* timeout;
+    const u32* sigmask;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -475,6 +501,15 @@ struct SC_statvfs_params {
     struct statvfs* buf;
 };
 
+struct SC_copy_file_range_params {
+    int in_fd;
+    int64_t* in_offset;
+    int out_fd;
+    int64_t* out_offset;
+    size_t count;
+    unsigned flags;
+};
+
 struct SC_chmod_params {
     int dirfd;
     StringArgument path;
@@ -21,9 +21,22 @@ inline bool time_page_supports(clockid_t clock_id)
     return clock_id == CLOCK_REALTIME_COARSE || clock_id == CLOCK_MONOTONIC_COARSE;
 }
 
+// These clocks can be extrapolated from their coarse counterpart with the TSC, if the time page allows it.
+inline bool time_page_can_extrapolate(clockid_t clock_id)
+{
+    return clock_id == CLOCK_REALTIME || clock_id == CLOCK_MONOTONIC;
+}
+
 struct TimePage {
     volatile u32 update1;
     struct timespec clocks[CLOCK_ID_COUNT];
+    // NOTE: Userspace may only read the TSC if tsc_multiplier isn't 0. The time passed since the coarse
+    //       clocks were updated is then ((tsc - tsc_at_update) * tsc_multiplier) >> tsc_shift nanoseconds,
+    //       capped at max_extrapolation_ns so that it doesn't run past the next update.
+    u64 tsc_at_update;
+    u32 tsc_multiplier;
+    u32 tsc_shift;
+    u32 max_extrapolation_ns;
     volatile u32 update2;
 };
 
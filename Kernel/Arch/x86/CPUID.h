@@ -59,6 +59,9 @@ enum class CPUFeature : u32 {
     LM = (1 << 24),
     HYPERVISOR = (1 << 25),
     PAT = (1 << 26),
+    PCID = (1 << 27),
+    ERMS = (1 << 28),
+    FSRM = (1 << 29),
 };
 
 }
@@ -95,6 +95,7 @@ public:
         UserSupervisor = 1 << 2,
         WriteThrough = 1 << 3,
         CacheDisabled = 1 << 4,
+        Accessed = 1 << 5,
         PAT = 1 << 7,
         Global = 1 << 8,
         NoExecute = 0x8000000000000000ULL,
@@ -115,6 +116,9 @@ public:
     bool is_cache_disabled() const { return (raw() & CacheDisabled) == CacheDisabled; }
     void set_cache_disabled(bool b) { set_bit(CacheDisabled, b); }
 
+    bool is_accessed() const { return (raw() & Accessed) == Accessed; }
+    void set_accessed(bool b) { set_bit(Accessed, b); }
+
     bool is_global() const { return (raw() & Global) == Global; }
     void set_global(bool b) { set_bit(Global, b); }
 
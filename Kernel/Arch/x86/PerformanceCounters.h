@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/API/POSIX/serenity.h>
+
+#include <AK/Platform.h>
+VALIDATE_IS_X86()
+
+namespace Kernel {
+
+struct RegisterState;
+
+// Samples PERF_EVENT_CYCLES and friends with the general-purpose counters of
+// the architectural performance monitoring unit (CPUID leaf 0xA). Each counter
+// raises a performance monitoring interrupt after a fixed number of events.
+class PerformanceCounters {
+public:
+    static constexpr u64 event_mask = PERF_EVENT_CYCLES | PERF_EVENT_INSTRUCTIONS | PERF_EVENT_CACHE_MISSES | PERF_EVENT_BRANCH_MISSES;
+
+    // The subset of event_mask this CPU can count.
+    static u64 available_event_mask();
+
+    // Calls are counted like the profile timer, the counters keep running
+    // until every enable() has been matched by a disable().
+    static bool enable(u64 requested_event_mask);
+    static void disable();
+
+    static void handle_overflow(RegisterState const&);
+};
+
+}
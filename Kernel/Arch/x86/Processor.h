@@ -94,6 +94,18 @@ class Processor {
 
     Atomic<ProcessorMessageEntry*> m_message_queue;
 
+    // Past this many pages, flushing all user translations beats invalidating them one by one.
+    static constexpr size_t full_tlb_flush_threshold = 32;
+
+    // The page directory this processor has loaded, see activate_page_directory().
+    Atomic<FlatPtr> m_active_cr3;
+#if ARCH(X86_64)
+    // The page directories whose translations may still be tagged with PCID index + 1 in our TLB.
+    static constexpr size_t pcid_count = 8;
+    Atomic<FlatPtr> m_pcid_cr3[pcid_count];
+    size_t m_next_pcid_index;
+#endif
+
     bool m_invoke_scheduler_async;
     bool m_scheduler_initialized;
     bool m_in_scheduler;
@@ -118,6 +130,11 @@ class Processor {
     static void smp_broadcast_message(ProcessorMessage& msg);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
     static void smp_broadcast_halt();
+    static void smp_multicast_flush_tlb(u32 cpu_mask, Memory::PageDirectory const*, VirtualAddress, size_t);
+
+    void flush_page_directory_tlb_local(FlatPtr cr3, VirtualAddress, size_t page_count);
+    void drop_cached_pcid(FlatPtr cr3);
+    void drop_all_cached_pcids();
 
     void deferred_call_pool_init();
     void deferred_call_execute_pending();
@@ -180,6 +197,13 @@ public:
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
 
+    // Loads the page directory at cr3 on the current processor, this must be used instead of write_cr3()
+    // so that TLB flushes know which processors to target. Interrupts need to be disabled.
+    static void activate_page_directory(FlatPtr cr3);
+    static FlatPtr active_page_directory() { return current().m_active_cr3.load(AK::MemoryOrder::memory_order_relaxed); }
+    // Makes sure no processor holds on to translations of a page directory that is going away.
+    static void forget_page_directory(FlatPtr cr3);
+
     Descriptor& get_gdt_entry(u16 selector);
     void flush_gdt();
     const DescriptorTablePointer& get_gdtr();
@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <Kernel/Arch/x86/CPUID.h>
+#include <Kernel/Arch/x86/MSR.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
+#include <Kernel/Arch/x86/Processor.h>
+#include <Kernel/Interrupts/APIC.h>
+#include <Kernel/PerformanceManager.h>
+
+#define MSR_IA32_PMC0 0xc1
+#define MSR_IA32_PERFEVTSEL0 0x186
+#define MSR_IA32_PERF_GLOBAL_STATUS 0x38e
+#define MSR_IA32_PERF_GLOBAL_CTRL 0x38f
+#define MSR_IA32_PERF_GLOBAL_OVF_CTRL 0x390
+
+#define PERFEVTSEL_USR (1 << 16)
+#define PERFEVTSEL_OS (1 << 17)
+#define PERFEVTSEL_INT (1 << 20)
+#define PERFEVTSEL_EN (1 << 22)
+
+namespace Kernel {
+
+struct CounterEvent {
+    u32 type;
+    u8 event_select;
+    u8 unit_mask;
+    u8 unavailable_bit; // In CPUID.0AH:EBX
+    u32 period;
+
+    u32 event_select_bits() const { return event_select | (unit_mask << 8); }
+};
+
+// NOTE: Periods have to stay below 2^31, writes to the counters only take the low 32 bits and sign-extend them.
+static constexpr CounterEvent s_counter_events[] = {
+    { PERF_EVENT_CYCLES, 0x3c, 0x00, 0, 2'000'000 },
+    { PERF_EVENT_INSTRUCTIONS, 0xc0, 0x00, 1, 2'000'000 },
+    { PERF_EVENT_CACHE_MISSES, 0x2e, 0x41, 4, 10'000 },
+    { PERF_EVENT_BRANCH_MISSES, 0xc5, 0x00, 6, 10'000 },
+};
+
+static Atomic<u64> s_active_event_mask;
+static Atomic<u32> s_enable_count;
+
+struct PerformanceMonitoringInfo {
+    u8 version { 0 };
+    u8 counter_count { 0 };
+    u32 unavailable_events { 0 };
+};
+
+static PerformanceMonitoringInfo performance_monitoring_info()
+{
+    if (CPUID(0).eax() < 0xa)
+        return {};
+    CPUID id(0xa);
+    return {
+        .version = static_cast<u8>(id.eax() & 0xff),
+        .counter_count = static_cast<u8>((id.eax() >> 8) & 0xff),
+        .unavailable_events = id.ebx(),
+    };
+}
+
+u64 PerformanceCounters::available_event_mask()
+{
+    auto info = performance_monitoring_info();
+    // NOTE: We rely on the global control and status MSRs, which came with version 2.
+    if (info.version < 2 || info.counter_count == 0)
+        return 0;
+    u64 mask = 0;
+    for (auto& event : s_counter_events) {
+        if (!(info.unavailable_events & (1u << event.unavailable_bit)))
+            mask |= event.type;
+    }
+    return mask;
+}
+
+static void program_current_processor()
+{
+    auto info = performance_monitoring_info();
+    auto active_event_mask = s_active_event_mask.load(AK::MemoryOrder::memory_order_acquire);
+
+    MSR global_ctrl(MSR_IA32_PERF_GLOBAL_CTRL);
+    global_ctrl.set(0);
+
+    u64 enabled_counters = 0;
+    u32 counter = 0;
+    for (auto& event : s_counter_events) {
+        if (counter == info.counter_count)
+            break;
+        if (!(active_event_mask & event.type))
+            continue;
+        MSR(MSR_IA32_PERFEVTSEL0 + counter).set(event.event_select_bits() | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_INT | PERFEVTSEL_EN);
+        MSR(MSR_IA32_PMC0 + counter).set(-static_cast<i64>(event.period));
+        enabled_counters |= 1ull << counter;
+        ++counter;
+    }
+    for (; counter < min<u32>(info.counter_count, array_size(s_counter_events)); ++counter)
+        MSR(MSR_IA32_PERFEVTSEL0 + counter).set(0);
+
+    MSR status(MSR_IA32_PERF_GLOBAL_STATUS);
+    MSR(MSR_IA32_PERF_GLOBAL_OVF_CTRL).set(status.get());
+
+    APIC::the().set_performance_counter_interrupt_masked(enabled_counters == 0);
+    global_ctrl.set(enabled_counters);
+}
+
+static void program_all_processors()
+{
+    // NOTE: Every processor programs itself from s_active_event_mask when it gets to the message,
+    //       so it doesn't matter in which order the messages of back-to-back updates are handled.
+    ScopedCritical critical;
+    auto current_id = Processor::current_id();
+    for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+        if (cpu != current_id)
+            Processor::smp_unicast(cpu, [] { program_current_processor(); }, true);
+    }
+    program_current_processor();
+}
+
+bool PerformanceCounters::enable(u64 requested_event_mask)
+{
+    requested_event_mask &= event_mask;
+    auto available = available_event_mask();
+    if ((requested_event_mask & available) != requested_event_mask)
+        return false;
+
+    s_enable_count.fetch_add(1);
+    auto previous_event_mask = s_active_event_mask.fetch_or(requested_event_mask, AK::MemoryOrder::memory_order_acq_rel);
+    if ((previous_event_mask | requested_event_mask) == previous_event_mask)
+        return true;
+    program_all_processors();
+    return true;
+}
+
+void PerformanceCounters::disable()
+{
+    if (s_enable_count.fetch_sub(1) != 1)
+        return;
+    if (s_active_event_mask.exchange(0, AK::MemoryOrder::memory_order_acq_rel) == 0)
+        return;
+    program_all_processors();
+}
+
+void PerformanceCounters::handle_overflow(RegisterState const& regs)
+{
+    MSR status(MSR_IA32_PERF_GLOBAL_STATUS);
+    auto overflowed_counters = status.get() & ((1ull << performance_monitoring_info().counter_count) - 1);
+
+    auto* current_thread = Thread::current();
+    bool record_samples = current_thread && current_thread != Processor::idle_thread();
+
+    for (u32 counter = 0; counter < 64; ++counter) {
+        if (!(overflowed_counters & (1ull << counter)))
+            continue;
+        auto event_select_bits = MSR(MSR_IA32_PERFEVTSEL0 + counter).get() & 0xffff;
+        for (auto& event : s_counter_events) {
+            if (event.event_select_bits() != event_select_bits)
+                continue;
+            MSR(MSR_IA32_PMC0 + counter).set(-static_cast<i64>(event.period));
+            if (record_samples)
+                PerformanceManager::add_hardware_counter_event(*current_thread, regs, event.type, event.period);
+            break;
+        }
+    }
+    MSR(MSR_IA32_PERF_GLOBAL_OVF_CTRL).set(overflowed_counters);
+
+    // NOTE: Delivering the interrupt masks the LVT entry again.
+    APIC::the().set_performance_counter_interrupt_masked(s_active_event_mask.load(AK::MemoryOrder::memory_order_relaxed) == 0);
+}
+
+}
@@ -95,6 +95,8 @@ UNMAP_AFTER_INIT void Processor::cpu_detect()
         set_feature(CPUFeature::SSE3);
     if (processor_info.ecx() & (1 << 9))
         set_feature(CPUFeature::SSSE3);
+    if (processor_info.ecx() & (1 << 17))
+        set_feature(CPUFeature::PCID);
     if (processor_info.ecx() & (1 << 19))
         set_feature(CPUFeature::SSE4_1);
     if (processor_info.ecx() & (1 << 20))
@@ -185,6 +187,10 @@ UNMAP_AFTER_INIT void Processor::cpu_detect()
         set_feature(CPUFeature::UMIP);
     if (extended_features.ebx() & (1 << 18))
         set_feature(CPUFeature::RDSEED);
+    if (extended_features.ebx() & (1 << 9))
+        set_feature(CPUFeature::ERMS);
+    if (extended_features.edx() & (1 << 4))
+        set_feature(CPUFeature::FSRM);
 }
 
 UNMAP_AFTER_INIT void Processor::cpu_setup()
@@ -240,6 +246,14 @@ UNMAP_AFTER_INIT void Processor::cpu_setup()
         write_cr4(read_cr4() | 0x800);
     }
 
+#if ARCH(X86_64)
+    if (has_feature(CPUFeature::PCID)) {
+        // Turn on CR4.PCIDE, this is only allowed while running with PCID 0, which we still are at this point.
+        VERIFY((read_cr3() & 0xfff) == 0);
+        write_cr4(read_cr4() | 0x20000);
+    }
+#endif
+
     if (has_feature(CPUFeature::TSC)) {
         write_cr4(read_cr4() | 0x4);
     }
@@ -347,6 +361,12 @@ NonnullOwnPtr<KString> Processor::features_string() const
             // a warning if a new feature is forgotten to be added here
         case CPUFeature::PAT:
             return "pat"sv;
+        case CPUFeature::PCID:
+            return "pcid"sv;
+        case CPUFeature::ERMS:
+            return "erms"sv;
+        case CPUFeature::FSRM:
+            return "fsrm"sv;
         }
         // Shouldn't ever happen
         return "???"sv;
@@ -763,6 +783,13 @@ void Processor::check_invoke_scheduler()
 
 void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 {
+    // User mappings are never global, so for larger ranges it's cheaper to drop all of them at once
+    // than to invalidate them one page at a time.
+    if (page_count > full_tlb_flush_threshold && Memory::is_user_address(vaddr)) {
+        flush_entire_tlb_local();
+        return;
+    }
+
     auto ptr = vaddr.as_ptr();
     while (page_count > 0) {
         // clang-format off
@@ -778,10 +805,113 @@ void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 
 void Processor::flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!Memory::is_user_address(vaddr) || Process::current().thread_count() > 1))
-        smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
+    if (!Memory::is_user_address(vaddr)) {
+        // Kernel mappings are shared by all page directories, so every processor has to flush them.
+        if (s_smp_enabled) {
+            smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
+        } else {
+            flush_tlb_local(vaddr, page_count);
+            current().drop_all_cached_pcids();
+        }
+        return;
+    }
+
+    ScopedCritical critical;
+    auto& current_processor = Processor::current();
+    auto cr3 = page_directory->cr3();
+
+    // Only the processors that have this page directory loaded right now can be using its translations,
+    // the others either flushed them when they switched away or still have them tagged with a PCID.
+    // NOTE: Our page table changes have to be visible before we look at what the others have loaded,
+    //       and a cached PCID has to be dropped before we check, activate_page_directory() does the
+    //       opposite. This way, either we send an IPI or the other processor flushes the PCID itself.
+    AK::atomic_thread_fence(AK::MemoryOrder::memory_order_seq_cst);
+    u32 cpu_mask = 0;
+    if (s_smp_enabled) {
+        for_each(
+            [&](Processor& processor) {
+                if (&processor == &current_processor)
+                    return;
+                processor.drop_cached_pcid(cr3);
+                if (processor.m_active_cr3.load(AK::MemoryOrder::memory_order_seq_cst) == cr3)
+                    cpu_mask |= 1u << processor.id();
+            });
+    }
+
+    if (cpu_mask)
+        smp_multicast_flush_tlb(cpu_mask, page_directory, vaddr, page_count);
     else
+        current_processor.flush_page_directory_tlb_local(cr3, vaddr, page_count);
+}
+
+void Processor::flush_page_directory_tlb_local(FlatPtr cr3, VirtualAddress vaddr, size_t page_count)
+{
+    VERIFY(&Processor::current() == this);
+    if (m_active_cr3.load(AK::MemoryOrder::memory_order_relaxed) == cr3) {
         flush_tlb_local(vaddr, page_count);
+        return;
+    }
+    // We don't have this page directory loaded, but we may still have its translations tagged with a PCID.
+    // Forget about it instead, switching back to it will then start from a clean slate.
+    drop_cached_pcid(cr3);
+}
+
+void Processor::drop_cached_pcid([[maybe_unused]] FlatPtr cr3)
+{
+#if ARCH(X86_64)
+    for (auto& cached_cr3 : m_pcid_cr3) {
+        auto expected = cr3;
+        (void)cached_cr3.compare_exchange_strong(expected, 0, AK::MemoryOrder::memory_order_seq_cst);
+    }
+#endif
+}
+
+void Processor::drop_all_cached_pcids()
+{
+#if ARCH(X86_64)
+    // INVLPG only takes care of the current PCID (and global translations),
+    // so kernel mappings may still linger under all the others.
+    VERIFY(&Processor::current() == this);
+    for (auto& cached_cr3 : m_pcid_cr3)
+        cached_cr3.store(0, AK::MemoryOrder::memory_order_seq_cst);
+#endif
+}
+
+void Processor::activate_page_directory(FlatPtr cr3)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    auto& processor = Processor::current();
+    // NOTE: This has to be visible before we look at our cached PCIDs, see flush_tlb().
+    processor.m_active_cr3.store(cr3, AK::MemoryOrder::memory_order_seq_cst);
+
+#if ARCH(X86_64)
+    if (processor.has_feature(CPUFeature::PCID)) {
+        for (size_t i = 0; i < pcid_count; ++i) {
+            if (processor.m_pcid_cr3[i].load(AK::MemoryOrder::memory_order_seq_cst) == cr3) {
+                // Bit 63 tells the CPU to keep what it has cached for this PCID.
+                write_cr3(cr3 | (i + 1) | (1ull << 63));
+                return;
+            }
+        }
+        // PCID 0 stays with the boot page directory, so this lands on 1 through pcid_count.
+        auto index = processor.m_next_pcid_index++ % pcid_count;
+        processor.m_pcid_cr3[index].store(cr3, AK::MemoryOrder::memory_order_seq_cst);
+        // This also flushes whatever the previous user of this PCID left behind.
+        write_cr3(cr3 | (index + 1));
+        return;
+    }
+#endif
+
+    write_cr3(cr3);
+}
+
+void Processor::forget_page_directory(FlatPtr cr3)
+{
+    // A new page directory may end up with the same physical address, which must not pick up stale translations.
+    for_each(
+        [&](Processor& processor) {
+            processor.drop_cached_pcid(cr3);
+        });
 }
 
 void Processor::smp_return_to_pool(ProcessorMessage& msg)
@@ -944,13 +1074,12 @@ bool Processor::smp_process_pending_messages()
                 if (Memory::is_user_address(VirtualAddress(msg->flush_tlb.ptr))) {
                     // We assume that we don't cross into kernel land!
                     VERIFY(Memory::is_user_range(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count * PAGE_SIZE));
-                    if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
-                        // This processor isn't using this page directory right now, we can ignore this request
-                        dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", current_id(), msg->flush_tlb.page_count, VirtualAddress(msg->flush_tlb.ptr));
-                        break;
-                    }
+                    // NOTE: We may have switched to another page directory since this was sent.
+                    flush_page_directory_tlb_local(msg->flush_tlb.page_directory->cr3(), VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count);
+                    break;
                 }
                 flush_tlb_local(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count);
+                drop_all_cached_pcids();
                 break;
             }
 
@@ -1089,6 +1218,37 @@ void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_direct
     smp_broadcast_message(msg);
     // While the other processors handle this request, we'll flush ours
     flush_tlb_local(vaddr, page_count);
+    if (!Memory::is_user_address(vaddr))
+        Processor::current().drop_all_cached_pcids();
+    // Now wait until everybody is done as well
+    smp_broadcast_wait_sync(msg);
+}
+
+void Processor::smp_multicast_flush_tlb(u32 cpu_mask, Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
+{
+    auto& current_processor = Processor::current();
+    VERIFY(!(cpu_mask & (1u << current_processor.id())));
+
+    auto& msg = smp_get_from_pool();
+    msg.async = false;
+    msg.type = ProcessorMessage::FlushTlb;
+    msg.flush_tlb.page_directory = page_directory;
+    msg.flush_tlb.ptr = vaddr.as_ptr();
+    msg.flush_tlb.page_count = page_count;
+    msg.refs.store(popcount(cpu_mask), AK::MemoryOrder::memory_order_release);
+
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Multicast message {} to cpus: {:#x}", current_processor.id(), VirtualAddress(&msg), cpu_mask);
+
+    for_each(
+        [&](Processor& processor) {
+            if (!(cpu_mask & (1u << processor.id())))
+                return;
+            if (processor.smp_enqueue_message(msg))
+                APIC::the().send_ipi(processor.id());
+        });
+
+    // While the other processors handle this request, we'll flush ours
+    current_processor.flush_page_directory_tlb_local(page_directory->cr3(), vaddr, page_count);
     // Now wait until everybody is done as well
     smp_broadcast_wait_sync(msg);
 }
@@ -1375,7 +1535,7 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
 #endif
 
     if (from_regs.cr3 != to_regs.cr3)
-        write_cr3(to_regs.cr3);
+        Processor::activate_page_directory(to_regs.cr3);
 
     to_thread->set_cpu(processor.id());
 
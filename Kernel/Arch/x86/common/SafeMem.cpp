@@ -52,6 +52,9 @@ ALWAYS_INLINE bool validate_canonical_address(size_t address)
 #endif
 }
 
+// Below this, the startup cost of REP MOVSB outweighs its advantage without FSRM.
+static constexpr size_t rep_movsb_threshold = 128;
+
 CODE_SECTION(".text.safemem")
 NEVER_INLINE bool safe_memcpy(void* dest_ptr, const void* src_ptr, size_t n, void*& fault_at)
 {
@@ -67,8 +70,12 @@ NEVER_INLINE bool safe_memcpy(void* dest_ptr, const void* src_ptr, size_t n, voi
         return false;
     }
     size_t remainder;
+    // With enhanced (or fast short) REP MOVSB the processor picks the best way to copy by itself,
+    // regardless of alignment, so the byte-wise copy below is the fastest way to do all of it.
+    auto& processor = Processor::current();
+    bool prefer_rep_movsb = processor.has_feature(CPUFeature::FSRM) || (processor.has_feature(CPUFeature::ERMS) && n >= rep_movsb_threshold);
     // FIXME: Support starting at an unaligned address.
-    if (!(dest & 0x3) && !(src & 0x3) && n >= 12) {
+    if (!prefer_rep_movsb && !(dest & 0x3) && !(src & 0x3) && n >= 12) {
         size_t size_ts = n / sizeof(size_t);
         asm volatile(
             ".globl safe_memcpy_ins_1 \n"
@@ -39,6 +39,14 @@ UNMAP_AFTER_INIT void detect()
             // This should have been initialized by the graphics subsystem
             break;
         }
+        case PCI::DeviceID::VirtIOBlockDevice: {
+            // This should have been initialized by the storage subsystem
+            break;
+        }
+        case PCI::DeviceID::VirtIONetAdapter: {
+            // This should have been initialized by the networking subsystem
+            break;
+        }
         default:
             dbgln_if(VIRTIO_DEBUG, "VirtIO: Unknown VirtIO device with ID: {}", device_identifier.hardware_id().device_id);
             break;
@@ -419,23 +427,38 @@ bool Device::handle_irq(const RegisterState&)
     }
     if (isr_type & QUEUE_INTERRUPT) {
         dbgln_if(VIRTIO_DEBUG, "{}: VirtIO Queue interrupt!", class_name());
+        // NOTE: All queues share the interrupt, so any number of them may have new data by now.
+        bool handled_queue_update = false;
         for (size_t i = 0; i < m_queues.size(); i++) {
             if (get_queue(i).new_data_available()) {
                 handle_queue_update(i);
-                return true;
+                handled_queue_update = true;
             }
         }
-        dbgln_if(VIRTIO_DEBUG, "{}: Got queue interrupt but all queues are up to date!", class_name());
+        if (!handled_queue_update)
+            dbgln_if(VIRTIO_DEBUG, "{}: Got queue interrupt but all queues are up to date!", class_name());
     }
     return true;
 }
 
 void Device::supply_chain_and_notify(u16 queue_index, QueueChain& chain)
+{
+    supply_chain(queue_index, chain);
+    notify_queue_if_needed(queue_index);
+}
+
+void Device::supply_chain(u16 queue_index, QueueChain& chain)
 {
     auto& queue = get_queue(queue_index);
     VERIFY(&chain.queue() == &queue);
     VERIFY(queue.lock().is_locked());
     chain.submit_to_queue();
+}
+
+void Device::notify_queue_if_needed(u16 queue_index)
+{
+    auto& queue = get_queue(queue_index);
+    VERIFY(queue.lock().is_locked());
     if (queue.should_notify())
         notify_queue(queue_index);
 }
@@ -33,6 +33,7 @@ public:
     ~Queue();
 
     u16 notify_offset() const { return m_notify_offset; }
+    u16 size() const { return m_queue_size; }
 
     void enable_interrupts();
     void disable_interrupts();
@@ -152,6 +153,12 @@ public:
     [[nodiscard]] Queue& queue() const { return m_queue; }
     [[nodiscard]] bool is_empty() const { return m_chain_length == 0; }
     [[nodiscard]] size_t length() const { return m_chain_length; }
+    // The first descriptor of a chain identifies it, both while it's being built and once the device has used it.
+    [[nodiscard]] u16 start_of_chain_index() const
+    {
+        VERIFY(m_start_of_chain_index.has_value());
+        return m_start_of_chain_index.value();
+    }
     bool add_buffer_to_chain(PhysicalAddress buffer_start, size_t buffer_length, BufferType buffer_type);
     void submit_to_queue();
     void release_buffer_slots_to_queue();
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringView.h>
+#include <Kernel/ByteRingBuffer.h>
+
+namespace Kernel {
+
+ErrorOr<NonnullOwnPtr<ByteRingBuffer>> ByteRingBuffer::try_create(size_t capacity)
+{
+    VERIFY(capacity >= minimum_capacity && capacity <= maximum_capacity);
+    auto storage = TRY(KBuffer::try_create_with_size(capacity, Memory::Region::Access::ReadWrite, "ByteRingBuffer"));
+    return adopt_nonnull_own_or_enomem(new (nothrow) ByteRingBuffer(capacity, move(storage)));
+}
+
+ByteRingBuffer::ByteRingBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage)
+    : m_storage(move(storage))
+    , m_capacity(capacity)
+{
+}
+
+size_t ByteRingBuffer::immediately_readable() const
+{
+    // NOTE: The read position has to be loaded first, reading can't get past what had been written by then.
+    auto read_position = m_read_position.load(AK::MemoryOrder::memory_order_acquire);
+    auto write_position = m_write_position.load(AK::MemoryOrder::memory_order_acquire);
+    return min(write_position - read_position, capacity());
+}
+
+ErrorOr<size_t> ByteRingBuffer::write(const UserOrKernelBuffer& data, size_t size)
+{
+    if (!size)
+        return 0;
+    MutexLocker locker(m_write_lock);
+    auto write_position = m_write_position.load(AK::MemoryOrder::memory_order_relaxed);
+    auto read_position = m_read_position.load(AK::MemoryOrder::memory_order_acquire);
+    size_t capacity = this->capacity();
+    size_t bytes_to_write = min<u64>(size, capacity - (write_position - read_position));
+    if (bytes_to_write == 0)
+        return 0;
+
+    size_t offset = write_position % capacity;
+    size_t bytes_until_end = min(bytes_to_write, capacity - offset);
+    TRY(data.read(m_storage->data() + offset, bytes_until_end));
+    if (bytes_until_end < bytes_to_write)
+        TRY(data.read(m_storage->data(), bytes_until_end, bytes_to_write - bytes_until_end));
+
+    m_write_position.store(write_position + bytes_to_write, AK::MemoryOrder::memory_order_release);
+    if (m_unblock_callback)
+        m_unblock_callback();
+    return bytes_to_write;
+}
+
+ErrorOr<size_t> ByteRingBuffer::read_impl(UserOrKernelBuffer& data, size_t size, bool advance_read_position)
+{
+    if (size == 0)
+        return 0;
+    auto read_position = m_read_position.load(AK::MemoryOrder::memory_order_relaxed);
+    auto write_position = m_write_position.load(AK::MemoryOrder::memory_order_acquire);
+    size_t nread = min<u64>(size, write_position - read_position);
+    if (nread == 0)
+        return 0;
+
+    size_t capacity = this->capacity();
+    size_t offset = read_position % capacity;
+    size_t bytes_until_end = min(nread, capacity - offset);
+    TRY(data.write(m_storage->data() + offset, bytes_until_end));
+    if (bytes_until_end < nread)
+        TRY(data.write(m_storage->data(), bytes_until_end, nread - bytes_until_end));
+
+    if (!advance_read_position)
+        return nread;
+    m_read_position.store(read_position + nread, AK::MemoryOrder::memory_order_release);
+    if (m_unblock_callback)
+        m_unblock_callback();
+    return nread;
+}
+
+ErrorOr<size_t> ByteRingBuffer::read(UserOrKernelBuffer& data, size_t size)
+{
+    MutexLocker locker(m_read_lock);
+    return read_impl(data, size, true);
+}
+
+ErrorOr<size_t> ByteRingBuffer::peek(UserOrKernelBuffer& data, size_t size)
+{
+    MutexLocker locker(m_read_lock);
+    return read_impl(data, size, false);
+}
+
+ErrorOr<void> ByteRingBuffer::try_resize(size_t new_capacity)
+{
+    MutexLocker write_locker(m_write_lock);
+    MutexLocker read_locker(m_read_lock);
+
+    auto read_position = m_read_position.load(AK::MemoryOrder::memory_order_relaxed);
+    auto write_position = m_write_position.load(AK::MemoryOrder::memory_order_relaxed);
+    size_t used = write_position - read_position;
+    new_capacity = max(clamp(new_capacity, minimum_capacity, maximum_capacity), used);
+    size_t old_capacity = capacity();
+    if (new_capacity == old_capacity)
+        return {};
+
+    auto new_storage = TRY(KBuffer::try_create_with_size(new_capacity, Memory::Region::Access::ReadWrite, "ByteRingBuffer"));
+    // NOTE: The positions stay as they are, so every byte moves to where its position maps to in the new storage.
+    for (u64 position = read_position; position < write_position;) {
+        size_t old_offset = position % old_capacity;
+        size_t new_offset = position % new_capacity;
+        size_t chunk_size = min(min<u64>(write_position - position, old_capacity - old_offset), new_capacity - new_offset);
+        memcpy(new_storage->data() + new_offset, m_storage->data() + old_offset, chunk_size);
+        position += chunk_size;
+    }
+
+    m_storage = move(new_storage);
+    m_capacity.store(new_capacity, AK::MemoryOrder::memory_order_release);
+    if (m_unblock_callback)
+        m_unblock_callback();
+    return {};
+}
+
+}
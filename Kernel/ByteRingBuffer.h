@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Types.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+// A ring buffer of bytes with one side writing into it and one side reading out of it.
+// Writers only serialize against other writers and readers only against other readers,
+// the two sides hand data to each other through the atomic read and write positions.
+class ByteRingBuffer {
+public:
+    static constexpr size_t default_capacity = 64 * KiB;
+    static constexpr size_t minimum_capacity = 4 * KiB;
+    static constexpr size_t maximum_capacity = 4 * MiB;
+
+    static ErrorOr<NonnullOwnPtr<ByteRingBuffer>> try_create(size_t capacity = default_capacity);
+
+    ErrorOr<size_t> write(const UserOrKernelBuffer&, size_t);
+    ErrorOr<size_t> write(const u8* data, size_t size)
+    {
+        return write(UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data)), size);
+    }
+    ErrorOr<size_t> read(UserOrKernelBuffer&, size_t);
+    ErrorOr<size_t> read(u8* data, size_t size)
+    {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        return read(buffer, size);
+    }
+    ErrorOr<size_t> peek(UserOrKernelBuffer&, size_t);
+    ErrorOr<size_t> peek(u8* data, size_t size)
+    {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+        return peek(buffer, size);
+    }
+
+    // Waits for both sides to be done and moves the buffered data over to new storage.
+    // The new capacity is clamped to the supported range, but never below what's currently buffered.
+    ErrorOr<void> try_resize(size_t capacity);
+
+    bool is_empty() const { return immediately_readable() == 0; }
+
+    size_t capacity() const { return m_capacity.load(AK::MemoryOrder::memory_order_relaxed); }
+    size_t space_for_writing() const { return capacity() - immediately_readable(); }
+    size_t immediately_readable() const;
+
+    void set_unblock_callback(Function<void()> callback)
+    {
+        VERIFY(!m_unblock_callback);
+        m_unblock_callback = move(callback);
+    }
+
+private:
+    ByteRingBuffer(size_t capacity, NonnullOwnPtr<KBuffer> storage);
+
+    ErrorOr<size_t> read_impl(UserOrKernelBuffer&, size_t, bool advance_read_position);
+
+    NonnullOwnPtr<KBuffer> m_storage;
+    Function<void()> m_unblock_callback;
+
+    // NOTE: These only ever grow, a byte at position P lives at P % capacity in the storage.
+    Atomic<u64> m_read_position { 0 };
+    Atomic<u64> m_write_position { 0 };
+    Atomic<size_t> m_capacity { 0 };
+
+    // NOTE: try_resize() takes both, always the write lock first.
+    Mutex m_write_lock { "ByteRingBuffer write" };
+    Mutex m_read_lock { "ByteRingBuffer read" };
+};
+
+}
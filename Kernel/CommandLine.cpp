@@ -162,6 +162,11 @@ UNMAP_AFTER_INIT bool CommandLine::is_legacy_time_enabled() const
     return lookup("time"sv).value_or("modern"sv) == "legacy"sv;
 }
 
+UNMAP_AFTER_INIT bool CommandLine::is_userspace_tsc_enabled() const
+{
+    return lookup("userspace_tsc"sv).value_or("off"sv) == "on"sv;
+}
+
 bool CommandLine::is_pc_speaker_enabled() const
 {
     auto value = lookup("pcspeaker"sv).value_or("off"sv);
@@ -299,6 +304,37 @@ NonnullOwnPtrVector<KString> CommandLine::userspace_init_args() const
     return args;
 }
 
+static Optional<size_t> parse_ring_size(StringView key, Optional<StringView> value)
+{
+    if (!value.has_value())
+        return {};
+    auto ring_size = value->to_uint();
+    if (!ring_size.has_value() || ring_size.value() == 0)
+        PANIC("Invalid {} value: {}", key, value.value());
+    return ring_size.value();
+}
+
+UNMAP_AFTER_INIT Optional<size_t> CommandLine::network_rx_ring_size() const
+{
+    return parse_ring_size("net_rx_ring_size"sv, lookup("net_rx_ring_size"sv));
+}
+
+UNMAP_AFTER_INIT Optional<size_t> CommandLine::network_tx_ring_size() const
+{
+    return parse_ring_size("net_tx_ring_size"sv, lookup("net_tx_ring_size"sv));
+}
+
+UNMAP_AFTER_INIT Optional<u32> CommandLine::profile_timer_frequency() const
+{
+    auto value = lookup("profile_frequency"sv);
+    if (!value.has_value())
+        return {};
+    auto frequency = value->to_uint();
+    if (!frequency.has_value() || frequency.value() == 0)
+        PANIC("Invalid profile_frequency value: {}", value.value());
+    return frequency.value();
+}
+
 UNMAP_AFTER_INIT size_t CommandLine::switch_to_tty() const
 {
     const auto default_tty = lookup("switch_to_tty"sv).value_or("1"sv);
@@ -308,4 +344,25 @@ UNMAP_AFTER_INIT size_t CommandLine::switch_to_tty() const
     }
     PANIC("Invalid default tty value: {}", default_tty);
 }
+
+UNMAP_AFTER_INIT u32 CommandLine::isolated_processors() const
+{
+    // A comma separated list of processor ids and ranges of them, e.g. "isolcpus=2,4-7".
+    auto value = lookup("isolcpus"sv);
+    if (!value.has_value())
+        return 0;
+    u32 mask = 0;
+    for (auto part : value->split_view(',')) {
+        auto range = part.split_view('-');
+        if (range.size() < 1 || range.size() > 2)
+            PANIC("Invalid isolcpus value: {}", value.value());
+        auto first = range.first().to_uint();
+        auto last = range.last().to_uint();
+        if (!first.has_value() || !last.has_value() || first.value() > last.value() || last.value() >= sizeof(mask) * 8)
+            PANIC("Invalid isolcpus value: {}", value.value());
+        for (auto id = first.value(); id <= last.value(); id++)
+            mask |= 1u << id;
+    }
+    return mask;
+}
 }
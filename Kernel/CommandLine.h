@@ -73,6 +73,7 @@ public:
     [[nodiscard]] PCIAccessLevel pci_access_level() const;
     [[nodiscard]] bool is_pci_disabled() const;
     [[nodiscard]] bool is_legacy_time_enabled() const;
+    [[nodiscard]] bool is_userspace_tsc_enabled() const;
     [[nodiscard]] bool is_pc_speaker_enabled() const;
     [[nodiscard]] FrameBufferDevices are_framebuffer_devices_enabled() const;
     [[nodiscard]] bool is_force_pio() const;
@@ -90,7 +91,11 @@ public:
     [[nodiscard]] NonnullOwnPtrVector<KString> userspace_init_args() const;
     [[nodiscard]] StringView root_device() const;
     [[nodiscard]] bool is_nvme_polling_enabled() const;
+    [[nodiscard]] Optional<size_t> network_rx_ring_size() const;
+    [[nodiscard]] Optional<size_t> network_tx_ring_size() const;
+    [[nodiscard]] Optional<u32> profile_timer_frequency() const;
     [[nodiscard]] size_t switch_to_tty() const;
+    [[nodiscard]] u32 isolated_processors() const;
 
 private:
     CommandLine(StringView);
@@ -45,18 +45,6 @@ Coredump::Coredump(NonnullRefPtr<Process> process, NonnullRefPtr<OpenFileDescrip
     : m_process(move(process))
     , m_description(move(description))
 {
-    m_num_program_headers = 0;
-    for ([[maybe_unused]] auto& region : m_process->address_space().regions()) {
-#if !INCLUDE_USERSPACE_HEAP_MEMORY_IN_COREDUMPS
-        if (looks_like_userspace_heap_region(*region))
-            continue;
-#endif
-
-        if (region->access() == Memory::Region::Access::None)
-            continue;
-        ++m_num_program_headers;
-    }
-    ++m_num_program_headers; // +1 for NOTE segment
 }
 
 ErrorOr<NonnullRefPtr<OpenFileDescription>> Coredump::try_create_target_file(Process const& process, StringView output_path)
@@ -76,6 +64,74 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> Coredump::try_create_target_file(Pro
         UidAndGid { process.uid(), process.gid() }));
 }
 
+static bool page_is_all_zeroes(u8 const* page)
+{
+    auto const* words = reinterpret_cast<FlatPtr const*>(page);
+    for (size_t i = 0; i < PAGE_SIZE / sizeof(FlatPtr); ++i) {
+        if (words[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+ErrorOr<void> Coredump::collect_segments()
+{
+    // Both the ELF header and the notes only have 16 bits for program header numbers, and we need one for the notes.
+    static constexpr size_t max_segment_count = NumericLimits<u16>::max() - 1;
+
+    alignas(FlatPtr) u8 page_buffer[PAGE_SIZE];
+
+    for (auto& region : m_process->address_space().regions()) {
+        VERIFY(!region->is_kernel());
+
+#if !INCLUDE_USERSPACE_HEAP_MEMORY_IN_COREDUMPS
+        if (looks_like_userspace_heap_region(*region))
+            continue;
+#endif
+
+        if (region->access() == Memory::Region::Access::None)
+            continue;
+
+        // If we crashed in the middle of mapping in Regions, they do not have a page directory yet, and will crash on a remap() call
+        if (!region->is_mapped())
+            continue;
+
+        region->set_readable(true);
+        region->remap();
+
+        Segment* current_segment = nullptr;
+        for (size_t i = 0; i < region->page_count(); i++) {
+            auto const* page = region->physical_page(i);
+            // Pages that were never touched read as zeroes, so there's no need to look at them.
+            bool should_skip = !page || page->is_shared_zero_page() || page->is_lazy_committed_page();
+            if (!should_skip) {
+                TRY(copy_from_user(page_buffer, region->vaddr().offset(i * PAGE_SIZE).as_ptr(), PAGE_SIZE));
+                should_skip = page_is_all_zeroes(page_buffer);
+            }
+            if (should_skip) {
+                current_segment = nullptr;
+                continue;
+            }
+
+            if (!current_segment && m_segments.size() == max_segment_count) {
+                // We ran out of program headers, so we have to keep the zeroes in between this page and the region's last segment.
+                if (m_segments.is_empty() || m_segments.last().region != region.ptr())
+                    return EOVERFLOW;
+                current_segment = &m_segments.last();
+                current_segment->page_count = i - current_segment->first_page;
+            }
+            if (!current_segment) {
+                TRY(m_segments.try_append({ region.ptr(), i, 0 }));
+                current_segment = &m_segments.last();
+            }
+            ++current_segment->page_count;
+        }
+    }
+
+    m_num_program_headers = m_segments.size() + 1; // +1 for NOTE segment
+    return {};
+}
+
 ErrorOr<void> Coredump::write_elf_header()
 {
     ElfW(Ehdr) elf_file_header;
@@ -124,36 +180,29 @@ ErrorOr<void> Coredump::write_elf_header()
 ErrorOr<void> Coredump::write_program_headers(size_t notes_size)
 {
     size_t offset = sizeof(ElfW(Ehdr)) + m_num_program_headers * sizeof(ElfW(Phdr));
-    for (auto& region : m_process->address_space().regions()) {
-
-#if !INCLUDE_USERSPACE_HEAP_MEMORY_IN_COREDUMPS
-        if (looks_like_userspace_heap_region(*region))
-            continue;
-#endif
-
-        if (region->access() == Memory::Region::Access::None)
-            continue;
+    for (auto& segment : m_segments) {
+        auto& region = *segment.region;
 
         ElfW(Phdr) phdr {};
 
         phdr.p_type = PT_LOAD;
         phdr.p_offset = offset;
-        phdr.p_vaddr = region->vaddr().get();
+        phdr.p_vaddr = region.vaddr().offset(segment.first_page * PAGE_SIZE).get();
         phdr.p_paddr = 0;
 
-        phdr.p_filesz = region->page_count() * PAGE_SIZE;
-        phdr.p_memsz = region->page_count() * PAGE_SIZE;
+        phdr.p_filesz = segment.page_count * PAGE_SIZE;
+        phdr.p_memsz = segment.page_count * PAGE_SIZE;
         phdr.p_align = 0;
 
-        phdr.p_flags = region->is_readable() ? PF_R : 0;
-        if (region->is_writable())
+        phdr.p_flags = region.is_readable() ? PF_R : 0;
+        if (region.is_writable())
             phdr.p_flags |= PF_W;
-        if (region->is_executable())
+        if (region.is_executable())
             phdr.p_flags |= PF_X;
 
         offset += phdr.p_filesz;
 
-        [[maybe_unused]] auto rc = m_description->write(UserOrKernelBuffer::for_kernel_buffer(reinterpret_cast<uint8_t*>(&phdr)), sizeof(ElfW(Phdr)));
+        TRY(m_description->write(UserOrKernelBuffer::for_kernel_buffer(reinterpret_cast<uint8_t*>(&phdr)), sizeof(ElfW(Phdr))));
     }
 
     ElfW(Phdr) notes_pheader {};
@@ -173,36 +222,9 @@ ErrorOr<void> Coredump::write_program_headers(size_t notes_size)
 
 ErrorOr<void> Coredump::write_regions()
 {
-    u8 zero_buffer[PAGE_SIZE] = {};
-
-    for (auto& region : m_process->address_space().regions()) {
-        VERIFY(!region->is_kernel());
-
-#if !INCLUDE_USERSPACE_HEAP_MEMORY_IN_COREDUMPS
-        if (looks_like_userspace_heap_region(*region))
-            continue;
-#endif
-
-        if (region->access() == Memory::Region::Access::None)
-            continue;
-
-        // If we crashed in the middle of mapping in Regions, they do not have a page directory yet, and will crash on a remap() call
-        if (!region->is_mapped())
-            continue;
-
-        region->set_readable(true);
-        region->remap();
-
-        for (size_t i = 0; i < region->page_count(); i++) {
-            auto const* page = region->physical_page(i);
-            auto src_buffer = [&]() -> ErrorOr<UserOrKernelBuffer> {
-                if (page)
-                    return UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region->vaddr().as_ptr() + (i * PAGE_SIZE))), PAGE_SIZE);
-                // If the current page is not backed by a physical page, we zero it in the coredump file.
-                return UserOrKernelBuffer::for_kernel_buffer(zero_buffer);
-            }();
-            TRY(m_description->write(src_buffer.value(), PAGE_SIZE));
-        }
+    for (auto& segment : m_segments) {
+        auto segment_data = UserOrKernelBuffer::for_user_buffer(segment.region->vaddr().offset(segment.first_page * PAGE_SIZE).as_ptr(), segment.page_count * PAGE_SIZE);
+        TRY(m_description->write(segment_data.value(), segment.page_count * PAGE_SIZE));
     }
     return {};
 }
@@ -263,7 +285,7 @@ ErrorOr<void> Coredump::create_notes_threads_data(auto& builder) const
 
 ErrorOr<void> Coredump::create_notes_regions_data(auto& builder) const
 {
-    size_t region_index = 0;
+    size_t segment_index = 0;
     for (auto const& region : m_process->address_space().regions()) {
 
 #if !INCLUDE_USERSPACE_HEAP_MEMORY_IN_COREDUMPS
@@ -279,7 +301,10 @@ ErrorOr<void> Coredump::create_notes_regions_data(auto& builder) const
 
         info.region_start = region->vaddr().get();
         info.region_end = region->vaddr().offset(region->size()).get();
-        info.program_header_index = region_index++;
+        // The region's pages are in the segments starting at this index (if any), up until the first one outside of the region.
+        info.program_header_index = segment_index;
+        while (segment_index < m_segments.size() && m_segments[segment_index].region == region.ptr())
+            ++segment_index;
 
         TRY(builder.append_bytes(ReadonlyBytes { (void*)&info, sizeof(info) }));
 
@@ -330,6 +355,8 @@ ErrorOr<void> Coredump::write()
     SpinlockLocker lock(m_process->address_space().get_lock());
     ScopedAddressSpaceSwitcher switcher(m_process);
 
+    TRY(collect_segments());
+
     auto builder = TRY(KBufferBuilder::try_create());
     TRY(create_notes_segment_data(builder));
     TRY(write_elf_header());
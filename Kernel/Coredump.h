@@ -9,6 +9,7 @@
 
 #include <AK/NonnullRefPtr.h>
 #include <AK/OwnPtr.h>
+#include <AK/Vector.h>
 #include <Kernel/Forward.h>
 
 namespace Kernel {
@@ -24,6 +25,16 @@ private:
     Coredump(NonnullRefPtr<Process>, NonnullRefPtr<OpenFileDescription>);
     static ErrorOr<NonnullRefPtr<OpenFileDescription>> try_create_target_file(Process const&, StringView output_path);
 
+    // A run of pages from one region that ends up in the coredump as its own PT_LOAD segment.
+    // Pages that were never touched or only contain zeroes are left out, and read back as zeroes.
+    struct Segment {
+        Memory::Region* region { nullptr };
+        size_t first_page { 0 };
+        size_t page_count { 0 };
+    };
+
+    ErrorOr<void> collect_segments();
+
     ErrorOr<void> write_elf_header();
     ErrorOr<void> write_program_headers(size_t notes_size);
     ErrorOr<void> write_regions();
@@ -37,6 +48,7 @@ private:
 
     NonnullRefPtr<Process> m_process;
     NonnullRefPtr<OpenFileDescription> m_description;
+    Vector<Segment> m_segments;
     size_t m_num_program_headers { 0 };
 };
 
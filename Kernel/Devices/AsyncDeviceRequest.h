@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <AK/Badge.h>
 #include <AK/IntrusiveList.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/Time.h>
 #include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
 #include <Kernel/Process.h>
 #include <Kernel/Thread.h>
@@ -52,10 +55,20 @@ public:
         Thread::BlockResult m_wait_result;
     };
 
+    // The part of the device a request operates on, used to order the device's queued requests.
+    struct DeviceRange {
+        u64 start { 0 };
+        u64 end { 0 };
+    };
+
     virtual ~AsyncDeviceRequest();
 
     virtual StringView name() const = 0;
     virtual void start() = 0;
+    virtual Optional<DeviceRange> device_range() const { return {}; }
+
+    Time queued_at() const { return m_queued_at; }
+    void set_queued_at(Badge<Device>, Time time) { m_queued_at = time; }
 
     void add_sub_request(NonnullRefPtr<AsyncDeviceRequest>);
 
@@ -150,6 +163,7 @@ private:
     WaitQueue m_queue;
     NonnullRefPtr<Process> m_process;
     void* m_private { nullptr };
+    Time m_queued_at;
     mutable Spinlock m_lock;
 };
 
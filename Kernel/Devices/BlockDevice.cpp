@@ -5,6 +5,7 @@
  */
 
 #include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Tracepoint.h>
 
 namespace Kernel {
 
@@ -21,6 +22,7 @@ AsyncBlockDeviceRequest::AsyncBlockDeviceRequest(Device& block_device, RequestTy
 
 void AsyncBlockDeviceRequest::start()
 {
+    TRACE(block_io, request, m_block_index, m_block_count);
     m_block_device.start_request(*this);
 }
 
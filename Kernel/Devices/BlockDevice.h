@@ -31,6 +31,7 @@ public:
     size_t buffer_size() const { return m_buffer_size; }
 
     virtual void start() override;
+    virtual Optional<DeviceRange> device_range() const override { return DeviceRange { m_block_index, m_block_index + m_block_count }; }
     virtual StringView name() const override
     {
         switch (m_request_type) {
@@ -10,6 +10,7 @@
 #include <Kernel/FileSystem/InodeMetadata.h>
 #include <Kernel/FileSystem/SysFS.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -153,16 +154,95 @@ ErrorOr<NonnullOwnPtr<KString>> Device::pseudo_path(const OpenFileDescription&)
 
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest& completed_request)
 {
-    SpinlockLocker lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
-        next_request->do_start(move(lock));
+    {
+        SpinlockLocker lock(m_requests_lock);
+        VERIFY(m_started_request_count > 0);
+        // Started requests don't necessarily complete in the order they were started in.
+        auto it = m_requests.begin();
+        for (; it != m_requests.end(); ++it) {
+            if ((*it).ptr() == &completed_request)
+                break;
+        }
+        VERIFY(it != m_requests.end());
+        m_requests.remove(it);
+        --m_started_request_count;
     }
 
+    start_queued_requests();
     evaluate_block_conditions();
 }
 
+void Device::queue_request(AsyncDeviceRequest& request)
+{
+    {
+        SpinlockLocker lock(m_requests_lock);
+        request.set_queued_at({}, TimeManagement::the().monotonic_time());
+        m_queued_requests.append(request);
+    }
+    start_queued_requests();
+}
+
+void Device::plug_requests()
+{
+    SpinlockLocker lock(m_requests_lock);
+    ++m_plug_count;
+}
+
+void Device::unplug_requests()
+{
+    {
+        SpinlockLocker lock(m_requests_lock);
+        VERIFY(m_plug_count > 0);
+        --m_plug_count;
+    }
+    start_queued_requests();
+}
+
+void Device::start_queued_requests()
+{
+    for (;;) {
+        SpinlockLocker lock(m_requests_lock);
+        auto request = take_next_queued_request();
+        if (!request)
+            return;
+        // NOTE: m_requests keeps the request alive until it has completed.
+        request->do_start(move(lock));
+    }
+}
+
+RefPtr<AsyncDeviceRequest> Device::take_next_queued_request()
+{
+    VERIFY(m_requests_lock.is_locked());
+    if (m_plug_count > 0 || m_queued_requests.is_empty() || m_started_request_count >= max_concurrent_requests())
+        return {};
+
+    // Requests are started in one sweep across the device (C-SCAN), as long as none of them has passed its deadline.
+    // Requests without a position are started in the order they were queued in.
+    auto next = m_queued_requests.begin();
+    auto oldest_range = (*next)->device_range();
+    auto waited_for = TimeManagement::the().monotonic_time() - (*next)->queued_at();
+    if (oldest_range.has_value() && waited_for.to_milliseconds() < request_deadline_ms) {
+        auto lowest = m_queued_requests.end();
+        auto next_in_sweep = m_queued_requests.end();
+        for (auto it = m_queued_requests.begin(); it != m_queued_requests.end(); ++it) {
+            auto range = (*it)->device_range();
+            if (!range.has_value())
+                continue;
+            if (lowest == m_queued_requests.end() || range->start < (*lowest)->device_range()->start)
+                lowest = it;
+            if (range->start >= m_elevator_position && (next_in_sweep == m_queued_requests.end() || range->start < (*next_in_sweep)->device_range()->start))
+                next_in_sweep = it;
+        }
+        next = next_in_sweep != m_queued_requests.end() ? next_in_sweep : lowest;
+    }
+
+    RefPtr<AsyncDeviceRequest> request = *next;
+    m_queued_requests.remove(next);
+    if (auto range = request->device_range(); range.has_value())
+        m_elevator_position = range->end;
+    m_requests.append(request);
+    ++m_started_request_count;
+    return request;
+}
+
 }
@@ -18,6 +18,7 @@
 #include <AK/Error.h>
 #include <AK/Function.h>
 #include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
 #include <AK/RefPtr.h>
 #include <Kernel/Devices/AsyncDeviceRequest.h>
 #include <Kernel/FileSystem/DeviceFileTypes.h>
@@ -50,20 +51,40 @@ public:
     virtual void after_inserting();
     void process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest&);
 
+    // Most devices work on one request at a time, devices with hardware queues can have several in flight.
+    virtual size_t max_concurrent_requests() const { return 1; }
+
     template<typename AsyncRequestType, typename... Args>
     ErrorOr<NonnullRefPtr<AsyncRequestType>> try_make_request(Args&&... args)
     {
         auto request = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
-        SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
-        m_requests.append(request);
-        if (was_empty)
-            request->do_start(move(lock));
+        queue_request(request);
         return request;
     }
 
+    // While a device is plugged, new requests are only queued up. Once it's unplugged again they are
+    // started in elevator order, so a batch of requests reaches the driver sorted by its position on the device.
+    class RequestPlug {
+        AK_MAKE_NONCOPYABLE(RequestPlug);
+        AK_MAKE_NONMOVABLE(RequestPlug);
+
+    public:
+        explicit RequestPlug(Device& device)
+            : m_device(device)
+        {
+            m_device.plug_requests();
+        }
+        ~RequestPlug() { m_device.unplug_requests(); }
+
+    private:
+        Device& m_device;
+    };
+
 protected:
     Device(MajorNumber major, MinorNumber minor);
+
+    // Queued requests that have been waiting for longer than this are started before anything else.
+    static constexpr i64 request_deadline_ms = 250;
     void set_uid(UserID uid) { m_uid = uid; }
     void set_gid(GroupID gid) { m_gid = gid; }
 
@@ -73,10 +94,22 @@ private:
     UserID m_uid { 0 };
     GroupID m_gid { 0 };
 
+    void queue_request(AsyncDeviceRequest&);
+    void plug_requests();
+    void unplug_requests();
+    void start_queued_requests();
+    RefPtr<AsyncDeviceRequest> take_next_queued_request();
+
     State m_state { State::Normal };
 
     Spinlock m_requests_lock;
+    // NOTE: m_requests holds the requests that have been started, m_queued_requests the ones waiting for their turn (oldest first).
     DoublyLinkedList<RefPtr<AsyncDeviceRequest>> m_requests;
+    DoublyLinkedList<RefPtr<AsyncDeviceRequest>> m_queued_requests;
+    size_t m_started_request_count { 0 };
+    size_t m_plug_count { 0 };
+    // Where the last started request ended, the elevator continues from there.
+    u64 m_elevator_position { 0 };
     RefPtr<SysFSDeviceComponent> m_sysfs_component;
 };
 
@@ -4,53 +4,109 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FixedArray.h>
 #include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/QuickSort.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Process.h>
+#include <Kernel/Tasks/WritebackTask.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
 struct CacheEntry {
+    enum class Queue : u8 {
+        Free,
+        Recent,
+        Frequent,
+    };
+
     IntrusiveListNode<CacheEntry> list_node;
+    IntrusiveListNode<CacheEntry> dirty_list_node;
     BlockBasedFileSystem::BlockIndex block_index { 0 };
     u8* data { nullptr };
+    u64 dirtied_at_ms { 0 };
+    Queue queue { Queue::Free };
     bool has_data { false };
+    bool was_read_ahead { false };
+};
+
+struct CacheChunk {
+    NonnullOwnPtr<KBuffer> block_data;
+    FixedArray<CacheEntry> entries;
 };
 
+// The DiskCache is a 2Q cache: blocks that have only been touched once live in the
+// "recent" FIFO, and are only promoted to the "frequent" LRU once they are touched
+// again. A long sequential scan therefore only churns through the recent queue and
+// can't flush out the working set. Blocks evicted from the recent queue are kept
+// around as "ghosts" (without their data) for a while, so that a block that comes
+// back soon after goes straight into the frequent queue.
+//
+// The cache grows in chunks of ChunkEntryCount blocks while there is plenty of free
+// physical memory around, and gives chunks back when free memory becomes scarce.
 class DiskCache {
 public:
-    static constexpr size_t EntryCount = 10000;
-    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> cached_block_data, NonnullOwnPtr<KBuffer> entries_buffer)
+    static constexpr size_t ChunkEntryCount = 1024;
+    static constexpr size_t MinimumEntryCount = ChunkEntryCount;
+    static constexpr size_t MaximumEntryCount = 256 * ChunkEntryCount;
+    // The cache may use up to 1/FreeMemoryFraction of uncommitted physical memory.
+    static constexpr size_t FreeMemoryFraction = 4;
+    static constexpr size_t ResizeCheckInterval = 256;
+    // The staging buffer is shared by read-ahead and by flushing runs of adjacent dirty blocks,
+    // both of which only ever happen with the cache locked.
+    static constexpr size_t StagingBufferBlockCount = 32;
+    static constexpr size_t MaximumReadAheadBlockCount = StagingBufferBlockCount;
+    static constexpr size_t MaximumFlushRunBlockCount = StagingBufferBlockCount;
+    // Dirty blocks are written back in the background once they're older than this, or once they make up
+    // more than the background percentage of the cache. Writers only have to help out once the dirty
+    // blocks cross the throttle percentage.
+    static constexpr u64 DirtyExpireMilliseconds = 1000;
+    static constexpr size_t DirtyBackgroundPercent = 10;
+    static constexpr size_t DirtyThrottlePercent = 40;
+
+    explicit DiskCache(BlockBasedFileSystem& fs, NonnullOwnPtr<KBuffer> staging_buffer)
         : m_fs(fs)
-        , m_cached_block_data(move(cached_block_data))
-        , m_entries(move(entries_buffer))
+        , m_staging_buffer(move(staging_buffer))
     {
-        for (size_t i = 0; i < EntryCount; ++i) {
-            entries()[i].data = m_cached_block_data->data() + i * m_fs.block_size();
-            m_clean_list.append(entries()[i]);
-        }
     }
 
-    ~DiskCache() = default;
-
-    bool is_dirty() const { return !m_dirty_list.is_empty(); }
-    bool entry_is_dirty(CacheEntry const& entry) const { return m_dirty_list.contains(entry); }
-
-    void mark_all_clean()
+    ~DiskCache()
     {
-        while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
+        for (auto& chunk : m_chunks) {
+            for (auto& entry : chunk.entries) {
+                entry.list_node.remove();
+                entry.dirty_list_node.remove();
+            }
+        }
     }
 
+    bool is_dirty() const { return !m_dirty_list.is_empty(); }
+    bool entry_is_dirty(CacheEntry const& entry) const { return entry.dirty_list_node.is_in_list(); }
+    size_t dirty_count() const { return m_dirty_count; }
+    size_t dirty_background_limit() const { return capacity() * DirtyBackgroundPercent / 100; }
+    size_t dirty_throttle_limit() const { return capacity() * DirtyThrottlePercent / 100; }
+
     void mark_dirty(CacheEntry& entry)
     {
+        // Only the write that dirtied a block counts for its age, rewriting it doesn't postpone its writeback.
+        // This keeps the dirty list ordered from the most recently to the least recently dirtied block.
+        if (entry_is_dirty(entry))
+            return;
+        entry.dirtied_at_ms = TimeManagement::the().uptime_ms();
         m_dirty_list.prepend(entry);
+        ++m_dirty_count;
     }
 
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        if (!entry_is_dirty(entry))
+            return;
+        entry.dirty_list_node.remove();
+        --m_dirty_count;
     }
 
     CacheEntry* get(BlockBasedFileSystem::BlockIndex block_index) const
@@ -65,10 +121,26 @@ public:
 
     ErrorOr<CacheEntry*> ensure(BlockBasedFileSystem::BlockIndex block_index) const
     {
-        if (auto* entry = get(block_index))
+        if (auto* entry = get(block_index)) {
+            ++m_statistics.hits;
+            touch(*entry);
+            if (entry->was_read_ahead) {
+                ++m_statistics.read_ahead_hits;
+                entry->was_read_ahead = false;
+            }
             return entry;
+        }
+
+        ++m_statistics.misses;
+        if (++m_misses_since_resize_check >= ResizeCheckInterval) {
+            m_misses_since_resize_check = 0;
+            try_shrink_if_needed();
+        }
 
-        if (m_clean_list.is_empty()) {
+        auto* new_entry = take_free_entry();
+        if (!new_entry)
+            new_entry = evict_entry();
+        if (!new_entry) {
             // Not a single clean entry! Flush writes and try again.
             // NOTE: We want to make sure we only call FileBackedFileSystem flush here,
             //       not some FileBackedFileSystem subclass flush!
@@ -76,36 +148,290 @@ public:
             return ensure(block_index);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
+        TRY(m_hash.try_set(block_index, new_entry));
+        new_entry->block_index = block_index;
+        new_entry->has_data = false;
+        new_entry->was_read_ahead = false;
+
+        if (m_ghosts.remove(block_index)) {
+            ++m_statistics.ghost_hits;
+            move_to_queue(*new_entry, CacheEntry::Queue::Frequent);
+        } else {
+            move_to_queue(*new_entry, CacheEntry::Queue::Recent);
+        }
+        return new_entry;
+    }
+
+    // Keeps track of the blocks being read, and returns how many blocks should be
+    // read ahead of the current one.
+    size_t note_read_and_compute_read_ahead(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        bool is_sequential = m_last_read_block_index.has_value() && block_index.value() == m_last_read_block_index->value() + 1;
+        m_last_read_block_index = block_index;
+        if (!is_sequential) {
+            m_read_ahead_window = 0;
+            m_read_ahead_next_block_index = 0;
+            return 0;
+        }
+        // Only read ahead once we've caught up with the previously read-ahead blocks.
+        if (block_index.value() < m_read_ahead_next_block_index)
+            return 0;
+        m_read_ahead_window = clamp(m_read_ahead_window * 2, 4u, MaximumReadAheadBlockCount);
+        m_read_ahead_window = min(m_read_ahead_window, capacity() / 8);
+        m_read_ahead_next_block_index = block_index.value() + 1 + m_read_ahead_window;
+        return m_read_ahead_window;
+    }
+
+    u8* staging_buffer() { return m_staging_buffer->data(); }
+
+    // Puts a block that is about to be read ahead into the recent queue. Nobody has asked for it yet,
+    // so unlike ensure() this doesn't count a miss, doesn't consume a ghost and doesn't advance the
+    // resize check. Read-ahead is only best effort, so this gives up instead of flushing writes when
+    // there is no clean entry to reuse. Returns nullptr if the block is already cached.
+    CacheEntry* try_insert_read_ahead(BlockBasedFileSystem::BlockIndex block_index) const
+    {
+        if (get(block_index))
+            return nullptr;
+
+        auto* new_entry = take_free_entry();
+        if (!new_entry)
+            new_entry = evict_entry();
+        if (!new_entry)
+            return nullptr;
 
-        m_hash.remove(new_entry.block_index);
-        TRY(m_hash.try_set(block_index, &new_entry));
+        if (m_hash.try_set(block_index, new_entry).is_error()) {
+            m_free_list.prepend(*new_entry);
+            return nullptr;
+        }
+        new_entry->block_index = block_index;
+        new_entry->has_data = false;
+        new_entry->was_read_ahead = true;
+        move_to_queue(*new_entry, CacheEntry::Queue::Recent);
+        ++m_statistics.read_ahead_blocks;
+        return new_entry;
+    }
 
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+    size_t capacity() const { return m_chunks.size() * ChunkEntryCount; }
 
-        return &new_entry;
+    BlockBasedFileSystem::CacheStatistics statistics() const
+    {
+        auto statistics = m_statistics;
+        statistics.capacity = capacity();
+        statistics.recent_count = m_recent_count;
+        statistics.frequent_count = m_frequent_count;
+        statistics.ghost_count = m_ghosts.size();
+        statistics.dirty_count = m_dirty_count;
+        return statistics;
     }
 
-    const CacheEntry* entries() const { return (const CacheEntry*)m_entries->data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries->data(); }
+    BlockBasedFileSystem::CacheStatistics& mutable_statistics() { return m_statistics; }
+
+    CacheEntry* oldest_dirty_entry() { return m_dirty_list.last(); }
 
     template<typename Callback>
-    void for_each_dirty_entry(Callback callback)
+    void for_each_dirty_entry_oldest_first(Callback callback)
     {
-        for (auto& entry : m_dirty_list)
-            callback(entry);
+        for (auto it = m_dirty_list.rbegin(); it != m_dirty_list.rend(); ++it) {
+            if (callback(*it) == IterationDecision::Break)
+                return;
+        }
     }
 
 private:
+    class GhostList {
+    public:
+        bool remove(BlockBasedFileSystem::BlockIndex block_index)
+        {
+            return m_sequence_numbers.remove(block_index);
+        }
+
+        void add(BlockBasedFileSystem::BlockIndex block_index, size_t max_size)
+        {
+            auto sequence_number = m_next_sequence_number++;
+            if (m_sequence_numbers.try_set(block_index, sequence_number).is_error())
+                return;
+            if (m_queue.try_append({ block_index, sequence_number }).is_error()) {
+                m_sequence_numbers.remove(block_index);
+                return;
+            }
+            while (m_sequence_numbers.size() > max_size && m_queue_head < m_queue.size())
+                pop_oldest();
+            // Compact the queue once the consumed prefix makes up most of it.
+            if (m_queue_head > 0 && m_queue_head >= m_queue.size() / 2) {
+                m_queue.remove(0, m_queue_head);
+                m_queue_head = 0;
+            }
+        }
+
+        size_t size() const { return m_sequence_numbers.size(); }
+
+    private:
+        struct Ghost {
+            BlockBasedFileSystem::BlockIndex block_index;
+            u64 sequence_number { 0 };
+        };
+
+        void pop_oldest()
+        {
+            auto& ghost = m_queue[m_queue_head++];
+            // The block may have been resurrected (and evicted again) since it was queued,
+            // in which case a newer queue entry is responsible for it.
+            auto it = m_sequence_numbers.find(ghost.block_index);
+            if (it != m_sequence_numbers.end() && it->value == ghost.sequence_number)
+                m_sequence_numbers.remove(it);
+        }
+
+        HashMap<BlockBasedFileSystem::BlockIndex, u64> m_sequence_numbers;
+        Vector<Ghost> m_queue;
+        size_t m_queue_head { 0 };
+        u64 m_next_sequence_number { 0 };
+    };
+
+    void move_to_queue(CacheEntry& entry, CacheEntry::Queue queue) const
+    {
+        switch (entry.queue) {
+        case CacheEntry::Queue::Recent:
+            --m_recent_count;
+            break;
+        case CacheEntry::Queue::Frequent:
+            --m_frequent_count;
+            break;
+        case CacheEntry::Queue::Free:
+            break;
+        }
+        entry.queue = queue;
+        switch (queue) {
+        case CacheEntry::Queue::Recent:
+            ++m_recent_count;
+            m_recent_list.prepend(entry);
+            break;
+        case CacheEntry::Queue::Frequent:
+            ++m_frequent_count;
+            m_frequent_list.prepend(entry);
+            break;
+        case CacheEntry::Queue::Free:
+            m_free_list.prepend(entry);
+            break;
+        }
+    }
+
+    void touch(CacheEntry& entry) const
+    {
+        // Read-ahead blocks are only speculatively in the cache, so their first real
+        // use doesn't count as the "second touch" that promotes them.
+        if (entry.queue == CacheEntry::Queue::Recent && entry.was_read_ahead)
+            return;
+        move_to_queue(entry, CacheEntry::Queue::Frequent);
+    }
+
+    CacheEntry* take_free_entry() const
+    {
+        if (m_free_list.is_empty() && capacity() < target_capacity())
+            (void)try_grow();
+        auto* entry = m_free_list.first();
+        if (entry)
+            entry->list_node.remove();
+        return entry;
+    }
+
+    template<typename List>
+    static CacheEntry* last_clean_entry(List& list)
+    {
+        for (auto it = list.rbegin(); it != list.rend(); ++it) {
+            if (!it->dirty_list_node.is_in_list())
+                return &*it;
+        }
+        return nullptr;
+    }
+
+    CacheEntry* evict_entry() const
+    {
+        // Prefer evicting from the recent queue while it's larger than its target share.
+        auto recent_target = max(capacity() / 4, 1u);
+        CacheEntry* victim = nullptr;
+        if (m_recent_count > recent_target)
+            victim = last_clean_entry(m_recent_list);
+        if (!victim)
+            victim = last_clean_entry(m_frequent_list);
+        if (!victim)
+            victim = last_clean_entry(m_recent_list);
+        if (!victim)
+            return nullptr;
+
+        ++m_statistics.evictions;
+        if (victim->queue == CacheEntry::Queue::Recent)
+            m_ghosts.add(victim->block_index, capacity() / 2);
+        m_hash.remove(victim->block_index);
+        move_to_queue(*victim, CacheEntry::Queue::Free);
+        victim->list_node.remove();
+        return victim;
+    }
+
+    size_t target_capacity() const
+    {
+        auto memory_info = MM.get_system_memory_info();
+        auto available_bytes = (memory_info.user_physical_pages_uncommitted * PAGE_SIZE) / FreeMemoryFraction;
+        // Count the memory we are already using as available to us.
+        available_bytes += capacity() * m_fs.block_size();
+        auto target = available_bytes / m_fs.block_size();
+        return clamp(target, MinimumEntryCount, MaximumEntryCount);
+    }
+
+    ErrorOr<void> try_grow() const
+    {
+        if (capacity() >= MaximumEntryCount)
+            return ENOMEM;
+        auto block_data = TRY(KBuffer::try_create_with_size(ChunkEntryCount * m_fs.block_size()));
+        auto entries = TRY(FixedArray<CacheEntry>::try_create(ChunkEntryCount));
+        auto chunk = TRY(adopt_nonnull_own_or_enomem(new (nothrow) CacheChunk { move(block_data), move(entries) }));
+        for (size_t i = 0; i < ChunkEntryCount; ++i) {
+            auto& entry = chunk->entries[i];
+            entry.data = chunk->block_data->data() + i * m_fs.block_size();
+            m_free_list.append(entry);
+        }
+        TRY(m_chunks.try_append(move(chunk)));
+        dbgln_if(BBFS_DEBUG, "{}: Grew disk cache to {} blocks", m_fs.class_name(), capacity());
+        return {};
+    }
+
+    void try_shrink_if_needed() const
+    {
+        if (m_chunks.size() <= 1 || capacity() <= target_capacity() + ChunkEntryCount)
+            return;
+
+        auto& chunk = m_chunks.last();
+        for (auto& entry : chunk.entries) {
+            if (entry.dirty_list_node.is_in_list())
+                return;
+        }
+        for (auto& entry : chunk.entries) {
+            if (entry.queue != CacheEntry::Queue::Free)
+                m_hash.remove(entry.block_index);
+            move_to_queue(entry, CacheEntry::Queue::Free);
+            entry.list_node.remove();
+        }
+        m_chunks.remove(m_chunks.size() - 1);
+        dbgln_if(BBFS_DEBUG, "{}: Shrunk disk cache to {} blocks", m_fs.class_name(), capacity());
+    }
+
     BlockBasedFileSystem& m_fs;
     mutable HashMap<BlockBasedFileSystem::BlockIndex, CacheEntry*> m_hash;
-    mutable IntrusiveList<&CacheEntry::list_node> m_clean_list;
-    mutable IntrusiveList<&CacheEntry::list_node> m_dirty_list;
-    NonnullOwnPtr<KBuffer> m_cached_block_data;
-    NonnullOwnPtr<KBuffer> m_entries;
+    mutable IntrusiveList<&CacheEntry::list_node> m_free_list;
+    mutable IntrusiveList<&CacheEntry::list_node> m_recent_list;
+    mutable IntrusiveList<&CacheEntry::list_node> m_frequent_list;
+    mutable IntrusiveList<&CacheEntry::dirty_list_node> m_dirty_list;
+    size_t m_dirty_count { 0 };
+    mutable size_t m_recent_count { 0 };
+    mutable size_t m_frequent_count { 0 };
+    mutable GhostList m_ghosts;
+    mutable NonnullOwnPtrVector<CacheChunk> m_chunks;
+    mutable size_t m_misses_since_resize_check { 0 };
+    mutable BlockBasedFileSystem::CacheStatistics m_statistics;
+
+    NonnullOwnPtr<KBuffer> m_staging_buffer;
+    mutable Optional<BlockBasedFileSystem::BlockIndex> m_last_read_block_index;
+    mutable u64 m_read_ahead_next_block_index { 0 };
+    mutable size_t m_read_ahead_window { 0 };
 };
 
 BlockBasedFileSystem::BlockBasedFileSystem(OpenFileDescription& file_description)
@@ -121,9 +447,8 @@ BlockBasedFileSystem::~BlockBasedFileSystem()
 ErrorOr<void> BlockBasedFileSystem::initialize()
 {
     VERIFY(block_size() != 0);
-    auto cached_block_data = TRY(KBuffer::try_create_with_size(DiskCache::EntryCount * block_size()));
-    auto entries_data = TRY(KBuffer::try_create_with_size(DiskCache::EntryCount * sizeof(CacheEntry)));
-    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(cached_block_data), move(entries_data))));
+    auto staging_buffer = TRY(KBuffer::try_create_with_size(DiskCache::StagingBufferBlockCount * block_size()));
+    auto disk_cache = TRY(adopt_nonnull_own_or_enomem(new (nothrow) DiskCache(*this, move(staging_buffer))));
 
     m_cache.with_exclusive([&](auto& cache) {
         cache = move(disk_cache);
@@ -131,6 +456,13 @@ ErrorOr<void> BlockBasedFileSystem::initialize()
     return {};
 }
 
+BlockBasedFileSystem::CacheStatistics BlockBasedFileSystem::cache_statistics() const
+{
+    return m_cache.with_exclusive([&](auto& cache) {
+        return cache->statistics();
+    });
+}
+
 ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, const UserOrKernelBuffer& data, size_t count, u64 offset, bool allow_cache)
 {
     VERIFY(m_logical_block_size);
@@ -144,7 +476,10 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, const UserOrKe
 
     TRY(data.read(buffered_data.bytes()));
 
-    return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+    size_t dirty_count = 0;
+    size_t dirty_background_limit = 0;
+    size_t dirty_throttle_limit = 0;
+    TRY(m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
         if (!allow_cache) {
             flush_specific_block_if_needed(index);
             u64 base_offset = index.value() * block_size() + offset;
@@ -154,16 +489,32 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, const UserOrKe
         }
 
         auto entry = TRY(cache->ensure(index));
-        if (count < block_size()) {
+        if (count < block_size() && !entry->has_data) {
             // Fill the cache first.
-            TRY(read_block(index, nullptr, block_size()));
+            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry->data);
+            auto nread = TRY(file_description().read(entry_data_buffer, index.value() * block_size(), block_size()));
+            VERIFY(nread == block_size());
         }
         memcpy(entry->data + offset, buffered_data.data(), count);
 
         cache->mark_dirty(*entry);
         entry->has_data = true;
+
+        dirty_count = cache->dirty_count();
+        dirty_background_limit = cache->dirty_background_limit();
+        dirty_throttle_limit = cache->dirty_throttle_limit();
+        if (dirty_count >= dirty_throttle_limit)
+            ++cache->mutable_statistics().throttled_writes;
         return {};
-    });
+    }));
+
+    if (allow_cache && dirty_count >= dirty_throttle_limit) {
+        // The background writeback isn't keeping up, so the writer has to pay for a run of its own.
+        write_back(DiskCache::MaximumFlushRunBlockCount, NumericLimits<u64>::max());
+    } else if (allow_cache && dirty_count >= dirty_background_limit) {
+        WritebackTask::wake();
+    }
+    return {};
 }
 
 ErrorOr<void> BlockBasedFileSystem::raw_read(BlockIndex index, UserOrKernelBuffer& buffer)
@@ -235,12 +586,48 @@ ErrorOr<void> BlockBasedFileSystem::read_block(BlockIndex index, UserOrKernelBuf
             VERIFY(nread == block_size());
             entry->has_data = true;
         }
-        if (buffer)
+        if (buffer) {
             TRY(buffer->write(entry->data + offset, count));
+            if (auto read_ahead_count = cache->note_read_and_compute_read_ahead(index); read_ahead_count > 0)
+                read_ahead(*cache, BlockIndex { index.value() + 1 }, read_ahead_count);
+        }
         return {};
     });
 }
 
+void BlockBasedFileSystem::read_ahead(DiskCache& cache, BlockIndex first_index, size_t count) const
+{
+    VERIFY(count <= DiskCache::MaximumReadAheadBlockCount);
+
+    // Skip over the blocks that are already cached, and read the uncached
+    // run that follows in a single request.
+    while (count > 0 && cache.get(first_index)) {
+        first_index = BlockIndex { first_index.value() + 1 };
+        --count;
+    }
+    size_t run_length = 0;
+    while (run_length < count && !cache.get(BlockIndex { first_index.value() + run_length }))
+        ++run_length;
+    if (run_length == 0)
+        return;
+
+    auto read_ahead_buffer = UserOrKernelBuffer::for_kernel_buffer(cache.staging_buffer());
+    auto nread_or_error = file_description().read(read_ahead_buffer, first_index.value() * block_size(), run_length * block_size());
+    if (nread_or_error.is_error())
+        return;
+    // We may have run into the end of the device.
+    auto blocks_read = nread_or_error.value() / block_size();
+    dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::read_ahead {}, count={}", first_index, blocks_read);
+
+    for (size_t i = 0; i < blocks_read; ++i) {
+        auto* entry = cache.try_insert_read_ahead(BlockIndex { first_index.value() + i });
+        if (!entry)
+            continue;
+        memcpy(entry->data, cache.staging_buffer() + i * block_size(), block_size());
+        entry->has_data = true;
+    }
+}
+
 ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     VERIFY(m_logical_block_size);
@@ -248,6 +635,14 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, block_size(), 0, allow_cache);
+    if (!allow_cache) {
+        // Write back whatever is dirty in the cache first, then read the whole run from the device at once.
+        for (unsigned i = 0; i < count; ++i)
+            const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(BlockIndex { index.value() + i });
+        auto nread = TRY(file_description().read(buffer, index.value() * block_size(), count * block_size()));
+        VERIFY(nread == count * block_size());
+        return {};
+    }
     auto out = buffer;
     for (unsigned i = 0; i < count; ++i) {
         TRY(read_block(BlockIndex { index.value() + i }, &out, block_size(), 0, allow_cache));
@@ -273,21 +668,126 @@ void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
     });
 }
 
-void BlockBasedFileSystem::flush_writes_impl()
+size_t BlockBasedFileSystem::write_back_run(DiskCache& cache, Span<BlockIndex const> block_indices)
 {
-    size_t count = 0;
-    m_cache.with_exclusive([&](auto& cache) {
-        if (!cache->is_dirty())
+    // The blocks were collected without holding the cache lock, so some of them may have been
+    // written back by someone else in the meantime. Those are skipped, which can split the run.
+    size_t written = 0;
+    size_t staged_count = 0;
+    BlockIndex first_staged_index;
+    auto write_staged = [&] {
+        if (staged_count == 0)
             return;
-        cache->for_each_dirty_entry([&](CacheEntry& entry) {
-            auto base_offset = entry.block_index.value() * block_size();
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(base_offset, entry_data_buffer, block_size());
-            ++count;
+        auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(cache.staging_buffer());
+        [[maybe_unused]] auto rc = file_description().write(first_staged_index.value() * block_size(), data_buffer, staged_count * block_size());
+        for (size_t i = 0; i < staged_count; ++i)
+            cache.mark_clean(*cache.get(BlockIndex { first_staged_index.value() + i }));
+        written += staged_count;
+        staged_count = 0;
+    };
+
+    for (auto block_index : block_indices) {
+        auto* entry = cache.get(block_index);
+        if (!entry || !cache.entry_is_dirty(*entry)) {
+            write_staged();
+            continue;
+        }
+        if (staged_count == 0)
+            first_staged_index = block_index;
+        memcpy(cache.staging_buffer() + staged_count * block_size(), entry->data, block_size());
+        ++staged_count;
+    }
+    write_staged();
+    return written;
+}
+
+size_t BlockBasedFileSystem::write_back(size_t max_count, u64 dirtied_before_ms)
+{
+    // The dirty blocks are written out sorted by their index, so that runs of adjacent
+    // blocks can go out as a single write. The cache is only locked for one run at a time,
+    // so readers and writers never wait for more than a single write to finish.
+    Vector<BlockIndex> block_indices;
+    bool have_block_indices = m_cache.with_exclusive([&](auto& cache) {
+        if (block_indices.try_ensure_capacity(min(max_count, cache->dirty_count())).is_error())
+            return false;
+        cache->for_each_dirty_entry_oldest_first([&](CacheEntry& entry) {
+            if (block_indices.size() >= max_count || entry.dirtied_at_ms > dirtied_before_ms)
+                return IterationDecision::Break;
+            block_indices.unchecked_append(entry.block_index);
+            return IterationDecision::Continue;
         });
-        cache->mark_all_clean();
-        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+        return true;
     });
+
+    size_t written = 0;
+    if (!have_block_indices) {
+        // If we can't keep track of the blocks, they are written out one by one, oldest first.
+        while (written < max_count) {
+            auto written_now = m_cache.with_exclusive([&](auto& cache) -> size_t {
+                auto* entry = cache->oldest_dirty_entry();
+                if (!entry || entry->dirtied_at_ms > dirtied_before_ms)
+                    return 0;
+                auto block_index = entry->block_index;
+                return write_back_run(*cache, { &block_index, 1 });
+            });
+            if (written_now == 0)
+                break;
+            written += written_now;
+        }
+    }
+
+    quick_sort(block_indices);
+    for (size_t i = 0; i < block_indices.size();) {
+        auto first_index = block_indices[i];
+        size_t run_length = 1;
+        while (i + run_length < block_indices.size()
+            && run_length < DiskCache::MaximumFlushRunBlockCount
+            && block_indices[i + run_length].value() == first_index.value() + run_length)
+            ++run_length;
+
+        written += m_cache.with_exclusive([&](auto& cache) {
+            return write_back_run(*cache, block_indices.span().slice(i, run_length));
+        });
+        i += run_length;
+    }
+
+    if (written) {
+        m_cache.with_exclusive([&](auto& cache) {
+            cache->mutable_statistics().written_back_blocks += written;
+        });
+    }
+    return written;
+}
+
+void BlockBasedFileSystem::flush_writes_impl()
+{
+    auto count = write_back(NumericLimits<size_t>::max(), NumericLimits<u64>::max());
+    if (count)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+}
+
+void BlockBasedFileSystem::write_back_dirty_data()
+{
+    auto is_dirty = m_cache.with_exclusive([&](auto& cache) { return cache->is_dirty(); });
+    if (!is_dirty)
+        return;
+
+    auto now = TimeManagement::the().uptime_ms();
+    if (now >= DiskCache::DirtyExpireMilliseconds)
+        write_back(NumericLimits<size_t>::max(), now - DiskCache::DirtyExpireMilliseconds);
+
+    // Keep going with the oldest blocks until we're back below the background limit.
+    for (;;) {
+        auto excess_count = m_cache.with_exclusive([&](auto& cache) -> size_t {
+            auto dirty_count = cache->dirty_count();
+            auto dirty_background_limit = cache->dirty_background_limit();
+            return dirty_count > dirty_background_limit ? dirty_count - dirty_background_limit : 0;
+        });
+        if (excess_count == 0)
+            break;
+        if (write_back(min(excess_count, DiskCache::MaximumFlushRunBlockCount * 8), NumericLimits<u64>::max()) == 0)
+            break;
+    }
 }
 
 void BlockBasedFileSystem::flush_writes()
@@ -21,8 +21,26 @@ public:
     u64 logical_block_size() const { return m_logical_block_size; };
 
     virtual void flush_writes() override;
+    virtual void write_back_dirty_data() override;
     void flush_writes_impl();
 
+    struct CacheStatistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 ghost_hits { 0 };
+        u64 evictions { 0 };
+        u64 read_ahead_blocks { 0 };
+        u64 read_ahead_hits { 0 };
+        size_t capacity { 0 };
+        size_t recent_count { 0 };
+        size_t frequent_count { 0 };
+        size_t ghost_count { 0 };
+        size_t dirty_count { 0 };
+        u64 written_back_blocks { 0 };
+        u64 throttled_writes { 0 };
+    };
+    CacheStatistics cache_statistics() const;
+
 protected:
     explicit BlockBasedFileSystem(OpenFileDescription&);
 
@@ -41,8 +59,13 @@ protected:
     u64 m_logical_block_size { 512 };
 
 private:
+    virtual bool is_block_based() const override { return true; }
+
     DiskCache& cache() const;
     void flush_specific_block_if_needed(BlockIndex index);
+    void read_ahead(DiskCache&, BlockIndex first_index, size_t count) const;
+    size_t write_back(size_t max_count, u64 dirtied_before_ms);
+    size_t write_back_run(DiskCache&, Span<BlockIndex const>);
 
     mutable MutexProtected<OwnPtr<DiskCache>> m_cache;
 };
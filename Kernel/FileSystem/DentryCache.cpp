@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/API/POSIX/errno.h>
+#include <Kernel/FileSystem/DentryCache.h>
+
+namespace Kernel {
+
+static Singleton<DentryCache> s_the;
+
+DentryCache& DentryCache::the()
+{
+    return *s_the;
+}
+
+ErrorOr<NonnullRefPtr<Inode>> DentryCache::lookup(Inode& directory, StringView name)
+{
+    if (!directory.fs().supports_watchers())
+        return directory.lookup(name);
+
+    u64 generation = 0;
+    auto cached_entry = m_state.with_exclusive([&](auto& state) -> Optional<RefPtr<Inode>> {
+        generation = state.generation;
+        auto directory_it = state.directories.find(directory.identifier());
+        if (directory_it == state.directories.end())
+            return {};
+        auto& cached_directory = *directory_it->value;
+        if (cached_directory.inode.unsafe_ptr() != &directory) {
+            state.entry_count -= cached_directory.entries.size();
+            state.directories.remove(directory_it);
+            return {};
+        }
+        auto it = cached_directory.entries.find(name);
+        if (it == cached_directory.entries.end())
+            return {};
+        if (it->value.is_negative)
+            return RefPtr<Inode> {};
+        auto inode = it->value.inode.strong_ref();
+        if (!inode) {
+            --state.entry_count;
+            cached_directory.entries.remove(it);
+            return {};
+        }
+        return inode;
+    });
+
+    if (cached_entry.has_value()) {
+        if (!cached_entry.value())
+            return ENOENT;
+        return cached_entry.release_value().release_nonnull();
+    }
+
+    auto child_or_error = directory.lookup(name);
+    if (child_or_error.is_error() && child_or_error.error().code() != ENOENT)
+        return child_or_error;
+
+    m_state.with_exclusive([&](auto& state) {
+        if (state.generation != generation)
+            return;
+        RefPtr<Inode> child;
+        if (!child_or_error.is_error())
+            child = child_or_error.value();
+        // NOTE: The cache is only ever a shortcut, failing to add to it is not a failure of the lookup.
+        (void)try_add(state, directory, name, child.ptr());
+    });
+
+    return child_or_error;
+}
+
+ErrorOr<void> DentryCache::try_add(State& state, Inode& directory, StringView name, Inode* child)
+{
+    Entry entry;
+    if (child)
+        entry.inode = TRY(child->try_make_weak_ptr<Inode>());
+    else
+        entry.is_negative = true;
+
+    if (state.entry_count >= max_entry_count) {
+        state.directories.clear();
+        state.entry_count = 0;
+    }
+
+    auto directory_it = state.directories.find(directory.identifier());
+    if (directory_it == state.directories.end()) {
+        auto cached_directory = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Directory));
+        cached_directory->inode = TRY(directory.try_make_weak_ptr<Inode>());
+        TRY(state.directories.try_set(directory.identifier(), move(cached_directory)));
+        directory_it = state.directories.find(directory.identifier());
+    }
+
+    auto entry_name = TRY(KString::try_create(name));
+    auto result = TRY(directory_it->value->entries.try_set(move(entry_name), move(entry)));
+    if (result == AK::HashSetResult::InsertedNewEntry)
+        ++state.entry_count;
+    return {};
+}
+
+void DentryCache::invalidate(Inode& directory, StringView name)
+{
+    m_state.with_exclusive([&](auto& state) {
+        ++state.generation;
+        auto directory_it = state.directories.find(directory.identifier());
+        if (directory_it == state.directories.end())
+            return;
+        if (directory_it->value->entries.remove(name))
+            --state.entry_count;
+    });
+}
+
+void DentryCache::invalidate_directory(Inode& directory)
+{
+    m_state.with_exclusive([&](auto& state) {
+        ++state.generation;
+        auto directory_it = state.directories.find(directory.identifier());
+        if (directory_it == state.directories.end())
+            return;
+        state.entry_count -= directory_it->value->entries.size();
+        state.directories.remove(directory_it);
+    });
+}
+
+}
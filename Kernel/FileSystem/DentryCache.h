@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/WeakPtr.h>
+#include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/KString.h>
+#include <Kernel/Locking/MutexProtected.h>
+
+namespace Kernel {
+
+// Remembers what a name in a directory resolved to, including names that don't exist.
+// Only directories on file systems that report every change to their children through
+// the InodeWatcher events are cached, as those events are what keeps the cache up to date.
+class DentryCache {
+public:
+    static DentryCache& the();
+
+    ErrorOr<NonnullRefPtr<Inode>> lookup(Inode& directory, StringView name);
+
+    void invalidate(Inode& directory, StringView name);
+    void invalidate_directory(Inode& directory);
+
+private:
+    static constexpr size_t max_entry_count = 16384;
+
+    struct Entry {
+        // A null pointer with is_negative unset means the inode went away, which is the same as not having an entry.
+        WeakPtr<Inode> inode;
+        bool is_negative { false };
+    };
+
+    struct Directory {
+        // NOTE: Inode indices get reused once an inode is gone, so every lookup checks that this is still the same directory.
+        WeakPtr<Inode> inode;
+        HashMap<NonnullOwnPtr<KString>, Entry> entries;
+    };
+
+    struct State {
+        HashMap<InodeIdentifier, NonnullOwnPtr<Directory>> directories;
+        size_t entry_count { 0 };
+        // Bumped on every invalidation, so a lookup that raced with a change to the directory doesn't cache a stale result.
+        u64 generation { 0 };
+    };
+
+    // A null child records that the name doesn't exist.
+    ErrorOr<void> try_add(State&, Inode& directory, StringView name, Inode* child);
+
+    MutexProtected<State> m_state;
+};
+
+}
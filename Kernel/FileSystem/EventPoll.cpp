@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+static BlockFlags block_flags_for_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::None;
+    if (events & EPOLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & EPOLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & EPOLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & EPOLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    return block_flags;
+}
+
+static u32 events_for_block_flags(BlockFlags block_flags)
+{
+    u32 events = 0;
+    if (has_flag(block_flags, BlockFlags::Read))
+        events |= EPOLLIN;
+    if (has_flag(block_flags, BlockFlags::Write))
+        events |= EPOLLOUT;
+    if (has_flag(block_flags, BlockFlags::ReadPriority))
+        events |= EPOLLPRI;
+    if (has_flag(block_flags, BlockFlags::WritePriority))
+        events |= EPOLLWRBAND;
+    return events;
+}
+
+ErrorOr<NonnullRefPtr<EventPoll>> EventPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EventPoll);
+}
+
+EventPoll::~EventPoll()
+{
+    (void)close();
+}
+
+EventPoll::Entry::Entry(EventPoll& event_poll, int fd, NonnullRefPtr<OpenFileDescription> description, epoll_event const& event)
+    : event_poll(event_poll)
+    , fd(fd)
+    , description(move(description))
+    , watcher(*this)
+    , events(event.events)
+    , data(event.data)
+{
+}
+
+bool EventPoll::Watcher::unblock_if_conditions_are_met(bool, void*)
+{
+    // NOTE: We never want to be removed from the description's blocker set,
+    //       we only take note of the state change and stay registered.
+    m_entry.event_poll.entry_did_change_state(m_entry);
+    return false;
+}
+
+void EventPoll::entry_did_change_state(Entry& entry)
+{
+    BlockFlags block_flags;
+    {
+        SpinlockLocker locker(m_ready_lock);
+        if (entry.is_disabled || entry.ready_list_node.is_in_list())
+            return;
+        block_flags = block_flags_for_events(entry.events);
+    }
+
+    if (entry.description->should_unblock(block_flags) == BlockFlags::None)
+        return;
+
+    {
+        SpinlockLocker locker(m_ready_lock);
+        if (entry.is_disabled || entry.ready_list_node.is_in_list())
+            return;
+        m_ready_entries.append(entry);
+    }
+    evaluate_block_conditions();
+}
+
+bool EventPoll::can_read(const OpenFileDescription&, u64) const
+{
+    SpinlockLocker locker(m_ready_lock);
+    return !m_ready_entries.is_empty();
+}
+
+ErrorOr<void> EventPoll::close()
+{
+    MutexLocker locker(m_lock);
+    for (auto& it : m_entries)
+        detach_entry(*it.value);
+    m_entries.clear();
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventPoll::pseudo_path(const OpenFileDescription&) const
+{
+    return KString::formatted("EventPoll:({})", m_entries.size());
+}
+
+ErrorOr<void> EventPoll::add(int fd, NonnullRefPtr<OpenFileDescription> description, epoll_event const& event)
+{
+    // NOTE: Nesting interest sets would let watchers of one EventPoll evaluate
+    //       the block conditions of another while holding its blocker set lock.
+    if (description->is_event_poll())
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (m_entries.contains(fd))
+        return EEXIST;
+
+    auto entry = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Entry(*this, fd, move(description), event)));
+    auto& entry_ref = *entry;
+    TRY(m_entries.try_set(fd, move(entry)));
+
+    // Adding the watcher evaluates the description right away, so an entry
+    // that is already ready ends up on the ready list before we return.
+    bool was_added = entry_ref.description->blocker_set().add_blocker(entry_ref.watcher, &entry_ref);
+    VERIFY(was_added);
+    return {};
+}
+
+ErrorOr<void> EventPoll::modify(int fd, epoll_event const& event)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+
+    auto& entry = *it->value;
+    {
+        SpinlockLocker ready_locker(m_ready_lock);
+        entry.events = event.events;
+        entry.data = event.data;
+        entry.is_disabled = false;
+        if (entry.ready_list_node.is_in_list())
+            m_ready_entries.remove(entry);
+    }
+    entry_did_change_state(entry);
+    return {};
+}
+
+ErrorOr<void> EventPoll::remove(int fd)
+{
+    MutexLocker locker(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+
+    auto entry = move(it->value);
+    m_entries.remove(it);
+    detach_entry(*entry);
+    return {};
+}
+
+void EventPoll::detach_entry(Entry& entry)
+{
+    VERIFY(m_lock.is_locked());
+    // Once the watcher is gone from the blocker set, nobody can put the entry
+    // back on the ready list.
+    entry.description->blocker_set().remove_blocker(entry.watcher);
+
+    SpinlockLocker locker(m_ready_lock);
+    if (entry.ready_list_node.is_in_list())
+        m_ready_entries.remove(entry);
+}
+
+size_t EventPoll::collect_ready_events(Span<epoll_event> events)
+{
+    // NOTE: Holding m_lock keeps entries from being removed while we look at
+    //       them with m_ready_lock released.
+    MutexLocker locker(m_lock);
+
+    // Level-triggered entries go back on the ready list once we're done, so
+    // they are reported again for as long as they stay ready.
+    IntrusiveList<&Entry::ready_list_node> still_ready_entries;
+    size_t event_count = 0;
+
+    while (event_count < events.size()) {
+        Entry* entry;
+        u32 entry_events;
+        epoll_data_t entry_data;
+        {
+            SpinlockLocker ready_locker(m_ready_lock);
+            if (m_ready_entries.is_empty())
+                break;
+            entry = m_ready_entries.take_first();
+            entry_events = entry->events;
+            entry_data = entry->data;
+        }
+
+        // The entry may have gone stale since it was queued (e.g. someone
+        // already drained it), in which case the next state change queues it
+        // again.
+        auto ready_flags = entry->description->should_unblock(block_flags_for_events(entry_events));
+        if (ready_flags == BlockFlags::None)
+            continue;
+
+        events[event_count++] = { events_for_block_flags(ready_flags), entry_data };
+
+        SpinlockLocker ready_locker(m_ready_lock);
+        if (entry_events & EPOLLONESHOT)
+            entry->is_disabled = true;
+        else if (!(entry_events & EPOLLET) && !entry->ready_list_node.is_in_list())
+            still_ready_entries.append(*entry);
+    }
+
+    SpinlockLocker ready_locker(m_ready_lock);
+    while (!still_ready_entries.is_empty())
+        m_ready_entries.append(*still_ready_entries.take_first());
+    return event_count;
+}
+
+}
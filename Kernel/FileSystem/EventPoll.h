@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <Kernel/API/POSIX/sys/epoll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+
+namespace Kernel {
+
+// EventPoll is a persistent interest set of file descriptions. Instead of
+// re-registering every description on each wait like poll() and select() do,
+// every entry keeps a FileBlocker attached to its description's blocker set.
+// When the description's block conditions are re-evaluated, the entry puts
+// itself on the ready list, so waiting only ever looks at entries that
+// actually changed state.
+//
+// NOTE: Entries hold a reference to their description until they are removed
+//       with EPOLL_CTL_DEL (or the EventPoll goes away), closing the fd alone
+//       does not remove them.
+class EventPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EventPoll>> try_create();
+    virtual ~EventPoll() override;
+
+    virtual bool can_read(const OpenFileDescription&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(const OpenFileDescription&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, const UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual ErrorOr<void> close() override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(const OpenFileDescription&) const override;
+    virtual StringView class_name() const override { return "EventPoll"sv; }
+    virtual bool is_event_poll() const override { return true; }
+
+    ErrorOr<void> add(int fd, NonnullRefPtr<OpenFileDescription>, epoll_event const&);
+    ErrorOr<void> modify(int fd, epoll_event const&);
+    ErrorOr<void> remove(int fd);
+
+    // Fills `events` with up to events.size() ready entries without blocking.
+    size_t collect_ready_events(Span<epoll_event> events);
+
+private:
+    EventPoll() = default;
+
+    class Entry;
+
+    class Watcher final : public Thread::FileBlocker {
+    public:
+        explicit Watcher(Entry& entry)
+            : m_entry(entry)
+        {
+        }
+
+        virtual StringView state_string() const override { return "EventPoll"sv; }
+        virtual bool unblock_if_conditions_are_met(bool, void*) override;
+        virtual void will_unblock_immediately_without_blocking(UnblockImmediatelyReason) override { }
+
+    private:
+        Entry& m_entry;
+    };
+
+    class Entry {
+    public:
+        Entry(EventPoll&, int fd, NonnullRefPtr<OpenFileDescription>, epoll_event const&);
+
+        EventPoll& event_poll;
+        int const fd;
+        NonnullRefPtr<OpenFileDescription> description;
+        Watcher watcher;
+
+        // These are protected by the EventPoll's m_ready_lock.
+        u32 events { 0 };
+        epoll_data_t data {};
+        bool is_disabled { false };
+        IntrusiveListNode<Entry> ready_list_node;
+    };
+
+    void entry_did_change_state(Entry&);
+    void detach_entry(Entry&);
+
+    mutable Mutex m_lock { "EventPoll" };
+    HashMap<int, NonnullOwnPtr<Entry>> m_entries;
+
+    mutable Spinlock m_ready_lock;
+    IntrusiveList<&Entry::ready_list_node> m_ready_entries;
+};
+
+}
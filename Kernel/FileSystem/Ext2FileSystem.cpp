@@ -15,6 +15,7 @@
 #include <Kernel/FileSystem/Ext2FileSystem.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/FileSystem/ext2_fs.h>
+#include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Process.h>
 #include <Kernel/UnixTypes.h>
 
@@ -709,6 +710,9 @@ Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
 
 Ext2FSInode::~Ext2FSInode()
 {
+    // Alas, we have nowhere to propagate any errors that occur here.
+    (void)discard_preallocated_blocks();
+
     if (m_raw_inode.i_links_count == 0) {
         // Alas, we have nowhere to propagate any errors that occur here.
         (void)fs().free_inode(*this);
@@ -754,13 +758,6 @@ ErrorOr<void> Ext2FSInode::flush_metadata()
     MutexLocker locker(m_inode_lock);
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::flush_metadata(): Flushing inode", identifier());
     TRY(fs().write_ext2_inode(index(), m_raw_inode));
-    if (is_directory()) {
-        // Unless we're about to go away permanently, invalidate the lookup cache.
-        if (m_raw_inode.i_links_count != 0) {
-            // FIXME: This invalidation is way too hardcore. It's sad to throw away the whole cache.
-            m_lookup_cache.clear();
-        }
-    }
     set_metadata_dirty(false);
     return {};
 }
@@ -801,6 +798,17 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FS::get_inode(InodeIdentifier inode) const
 }
 
 ErrorOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    bool allow_cache = !description || !description->is_direct();
+    return read_bytes_impl(offset, count, buffer, allow_cache);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_for_page_cache(off_t offset, size_t count, UserOrKernelBuffer& buffer) const
+{
+    return read_bytes_impl(offset, count, buffer, false);
+}
+
+ErrorOr<size_t> Ext2FSInode::read_bytes_impl(off_t offset, size_t count, UserOrKernelBuffer& buffer, bool allow_cache) const
 {
     MutexLocker inode_locker(m_inode_lock);
     VERIFY(offset >= 0);
@@ -827,8 +835,6 @@ ErrorOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKernel
         return EIO;
     }
 
-    bool allow_cache = !description || !description->is_direct();
-
     const int block_size = fs().block_size();
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
@@ -851,6 +857,20 @@ ErrorOr<size_t> Ext2FSInode::read_bytes(off_t offset, size_t count, UserOrKernel
         if (block_index.value() == 0) {
             // This is a hole, act as if it's filled with zeroes.
             TRY(buffer_offset.memset(0, num_bytes_to_copy));
+        } else if (!allow_cache && offset_into_block == 0 && num_bytes_to_copy == (size_t)block_size) {
+            // Without the cache every read goes to the device, so read as many whole blocks that
+            // are next to each other on disk as we can in one go.
+            size_t run_length = 1;
+            while (bi.value() + run_length <= last_block_logical_index.value()
+                && (size_t)remaining_count >= (run_length + 1) * block_size
+                && m_block_list[bi.value() + run_length].value() == block_index.value() + run_length)
+                ++run_length;
+            if (auto result = fs().read_blocks(block_index, run_length, buffer_offset, false); result.is_error()) {
+                dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read {} blocks at {} (index {})", identifier(), run_length, block_index.value(), bi);
+                return result.release_error();
+            }
+            num_bytes_to_copy = run_length * block_size;
+            bi = bi.value() + run_length - 1;
         } else {
             if (auto result = fs().read_block(block_index, &buffer_offset, num_bytes_to_copy, offset_into_block, allow_cache); result.is_error()) {
                 dmesgln("Ext2FSInode[{}]::read_bytes(): Failed to read block {} (index {})", identifier(), block_index.value(), bi);
@@ -884,7 +904,7 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
 
     if (blocks_needed_after > blocks_needed_before) {
         auto additional_blocks_needed = blocks_needed_after - blocks_needed_before;
-        if (additional_blocks_needed > fs().super_block().s_free_blocks_count)
+        if (additional_blocks_needed > fs().super_block().s_free_blocks_count + m_preallocation_count)
             return ENOSPC;
     }
 
@@ -892,9 +912,30 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         m_block_list = TRY(compute_block_list());
 
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before));
-        TRY(m_block_list.try_extend(move(blocks)));
+        TRY(m_block_list.try_ensure_capacity(blocks_needed_after));
+        auto additional_blocks_needed = blocks_needed_after - blocks_needed_before;
+
+        // Continue with the blocks we already reserved behind the end of the file the last time it grew.
+        auto blocks_from_preallocation = min<u64>(additional_blocks_needed, m_preallocation_count);
+        for (size_t i = 0; i < blocks_from_preallocation; ++i)
+            m_block_list.unchecked_append(m_preallocation_start.value() + i);
+        m_preallocation_start = m_preallocation_start.value() + blocks_from_preallocation;
+        m_preallocation_count -= blocks_from_preallocation;
+        additional_blocks_needed -= blocks_from_preallocation;
+
+        if (additional_blocks_needed) {
+            auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), additional_blocks_needed, next_block_goal()));
+            TRY(m_block_list.try_extend(move(blocks)));
+        }
+
+        // Reserve a window of blocks behind the new end of the file, so the next append lands right after it
+        // instead of wherever the next free block in the group happens to be.
+        if (m_preallocation_count == 0 && Kernel::is_regular_file(m_raw_inode.i_mode)) {
+            m_preallocation_start = next_block_goal();
+            m_preallocation_count = TRY(fs().allocate_contiguous_blocks_at(m_preallocation_start, preallocation_window_size));
+        }
     } else if (blocks_needed_after < blocks_needed_before) {
+        TRY(discard_preallocated_blocks());
         if constexpr (EXT2_VERY_DEBUG) {
             dbgln("Ext2FSInode[{}]::resize(): Shrinking inode, old block list is {} entries:", identifier(), m_block_list.size());
             for (auto block_index : m_block_list) {
@@ -934,9 +975,38 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         }
     }
 
+    if (auto shared_vmobject = this->shared_vmobject())
+        shared_vmobject->did_resize(old_size, new_size);
+
+    return {};
+}
+
+BlockBasedFileSystem::BlockIndex Ext2FSInode::next_block_goal() const
+{
+    if (m_block_list.is_empty() || !m_block_list.last().value())
+        return 0;
+    return m_block_list.last().value() + 1;
+}
+
+ErrorOr<void> Ext2FSInode::discard_preallocated_blocks()
+{
+    while (m_preallocation_count) {
+        TRY(fs().set_block_allocation_state(m_preallocation_start.value() + m_preallocation_count - 1, false));
+        --m_preallocation_count;
+    }
     return {};
 }
 
+void Ext2FSInode::detach(OpenFileDescription& description)
+{
+    if (!description.is_writable())
+        return;
+    MutexLocker locker(m_inode_lock);
+    // NOTE: Once the file isn't written to anymore, the reserved blocks are better off back in the free pool.
+    //       Alas, we have nowhere to propagate any errors that occur here.
+    (void)discard_preallocated_blocks();
+}
+
 ErrorOr<size_t> Ext2FSInode::write_bytes(off_t offset, size_t count, const UserOrKernelBuffer& data, OpenFileDescription* description)
 {
     VERIFY(offset >= 0);
@@ -1035,6 +1105,13 @@ Ext2FS::FeaturesReadOnly Ext2FS::get_features_readonly() const
 }
 
 ErrorOr<void> Ext2FSInode::traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)> callback) const
+{
+    return traverse_directory_entries([&](auto& entry, u64) -> ErrorOr<void> {
+        return callback({ { entry.name, entry.name_len }, { fsid(), entry.inode }, entry.file_type });
+    });
+}
+
+ErrorOr<void> Ext2FSInode::traverse_directory_entries(Function<ErrorOr<void>(ext2_dir_entry_2 const&, u64 offset)> callback) const
 {
     VERIFY(is_directory());
 
@@ -1054,9 +1131,11 @@ ErrorOr<void> Ext2FSInode::traverse_as_directory(Function<ErrorOr<void>(FileSyst
         auto* entries_end = reinterpret_cast<ext2_dir_entry_2*>(buffer + block_size);
         while (entry < entries_end) {
             if (entry->inode != 0) {
-                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::traverse_as_directory(): inode {}, name_len: {}, rec_len: {}, file_type: {}, name: {}", identifier(), entry->inode, entry->name_len, entry->rec_len, entry->file_type, StringView(entry->name, entry->name_len));
-                TRY(callback({ { entry->name, entry->name_len }, { fsid(), entry->inode }, entry->file_type }));
+                dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::traverse_directory_entries(): inode {}, name_len: {}, rec_len: {}, file_type: {}, name: {}", identifier(), entry->inode, entry->name_len, entry->rec_len, entry->file_type, StringView(entry->name, entry->name_len));
+                TRY(callback(*entry, offset + ((u8*)entry - buffer)));
             }
+            if (entry->rec_len == 0)
+                return EIO;
             entry = (ext2_dir_entry_2*)((char*)entry + entry->rec_len);
         }
     }
@@ -1116,11 +1195,99 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(stream.data());
     auto nwritten = TRY(write_bytes(0, stream.size(), buffer, nullptr));
     set_metadata_dirty(true);
+    // NOTE: Every entry may have moved, so the offsets in the lookup cache are meaningless now.
+    m_lookup_cache.clear();
     if (nwritten != directory_data.size())
         return EIO;
     return {};
 }
 
+ErrorOr<u64> Ext2FSInode::insert_directory_entry(InodeIndex inode_index, StringView name, u8 file_type)
+{
+    MutexLocker locker(m_inode_lock);
+    VERIFY(name.length() <= EXT2_NAME_LEN);
+
+    u8 buffer[max_block_size];
+    auto buf = UserOrKernelBuffer::for_kernel_buffer(buffer);
+    auto block_size = fs().block_size();
+    auto file_size = size();
+    u16 record_length_needed = EXT2_DIR_REC_LEN(name.length());
+
+    auto write_entry = [&](size_t offset_in_block, u16 record_length) {
+        auto* entry = reinterpret_cast<ext2_dir_entry_2*>(buffer + offset_in_block);
+        entry->inode = inode_index.value();
+        entry->rec_len = record_length;
+        entry->name_len = name.length();
+        entry->file_type = file_type;
+        memcpy(entry->name, name.characters_without_null_termination(), name.length());
+    };
+
+    // The new entry goes into the slack of the last block if it fits, which only means reading and writing that block.
+    if (file_size >= block_size) {
+        auto block_offset = file_size - block_size;
+        TRY(read_bytes(block_offset, block_size, buf, nullptr));
+
+        size_t offset_in_block = 0;
+        while (offset_in_block < block_size) {
+            auto* entry = reinterpret_cast<ext2_dir_entry_2*>(buffer + offset_in_block);
+            if (entry->rec_len == 0)
+                return EIO;
+            u16 record_length_used = entry->inode != 0 ? EXT2_DIR_REC_LEN(entry->name_len) : 0;
+            if (entry->rec_len - record_length_used >= record_length_needed) {
+                u16 record_length = entry->rec_len - record_length_used;
+                if (record_length_used != 0)
+                    entry->rec_len = record_length_used;
+                write_entry(offset_in_block + record_length_used, record_length);
+                TRY(write_bytes(block_offset, block_size, buf, nullptr));
+                return block_offset + offset_in_block + record_length_used;
+            }
+            offset_in_block += entry->rec_len;
+        }
+    }
+
+    // Otherwise, the directory grows by a block that holds just the new entry.
+    memset(buffer, 0, block_size);
+    write_entry(0, block_size);
+    TRY(write_bytes(file_size, block_size, buf, nullptr));
+    return file_size;
+}
+
+ErrorOr<void> Ext2FSInode::remove_directory_entry(u64 offset, InodeIndex inode_index)
+{
+    MutexLocker locker(m_inode_lock);
+
+    u8 buffer[max_block_size];
+    auto buf = UserOrKernelBuffer::for_kernel_buffer(buffer);
+    auto block_size = fs().block_size();
+    auto block_offset = offset - offset % block_size;
+    size_t offset_in_block = offset - block_offset;
+    TRY(read_bytes(block_offset, block_size, buf, nullptr));
+
+    ext2_dir_entry_2* previous_entry = nullptr;
+    size_t current_offset = 0;
+    while (current_offset < offset_in_block) {
+        previous_entry = reinterpret_cast<ext2_dir_entry_2*>(buffer + current_offset);
+        if (previous_entry->rec_len == 0)
+            return EIO;
+        current_offset += previous_entry->rec_len;
+    }
+
+    auto* entry = reinterpret_cast<ext2_dir_entry_2*>(buffer + offset_in_block);
+    if (current_offset != offset_in_block || entry->inode != inode_index.value()) {
+        dbgln("Ext2FSInode[{}]::remove_directory_entry(): No entry for inode {} at offset {}", identifier(), inode_index, offset);
+        return EIO;
+    }
+
+    // The previous entry swallows the removed one, unless it was the first in its block, which then just becomes unused.
+    if (previous_entry)
+        previous_entry->rec_len += entry->rec_len;
+    else
+        entry->inode = 0;
+
+    TRY(write_bytes(block_offset, block_size, buf, nullptr));
+    return {};
+}
+
 ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, UserID uid, GroupID gid)
 {
     if (::is_directory(mode))
@@ -1138,25 +1305,17 @@ ErrorOr<void> Ext2FSInode::add_child(Inode& child, StringView name, mode_t mode)
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::add_child(): Adding inode {} with name '{}' and mode {:o} to directory {}", identifier(), child.index(), name, mode, index());
 
-    Vector<Ext2FSDirectoryEntry> entries;
-    TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
-        if (name == entry.name)
-            return EEXIST;
-        auto entry_name = TRY(KString::try_create(entry.name));
-        TRY(entries.try_append({ move(entry_name), entry.inode.index(), entry.file_type }));
-        return {};
-    }));
-
-    TRY(child.increment_link_count());
-
-    auto entry_name = TRY(KString::try_create(name));
-    TRY(entries.try_empend(move(entry_name), child.index(), to_ext2_file_type(mode)));
-
-    TRY(write_directory(entries));
     TRY(populate_lookup_cache());
+    if (m_lookup_cache.find(name) != m_lookup_cache.end())
+        return EEXIST;
 
     auto cache_entry_name = TRY(KString::try_create(name));
-    TRY(m_lookup_cache.try_set(move(cache_entry_name), child.index()));
+    TRY(m_lookup_cache.try_ensure_capacity(m_lookup_cache.size() + 1));
+
+    TRY(child.increment_link_count());
+
+    auto offset = TRY(insert_directory_entry(child.index(), name, to_ext2_file_type(mode)));
+    m_lookup_cache.set(move(cache_entry_name), { child.index(), offset });
     did_add_child(child.identifier(), name);
     return {};
 }
@@ -1172,20 +1331,11 @@ ErrorOr<void> Ext2FSInode::remove_child(StringView name)
     auto it = m_lookup_cache.find(name);
     if (it == m_lookup_cache.end())
         return ENOENT;
-    auto child_inode_index = (*it).value;
+    auto child_inode_index = (*it).value.inode_index;
 
     InodeIdentifier child_id { fsid(), child_inode_index };
 
-    Vector<Ext2FSDirectoryEntry> entries;
-    TRY(traverse_as_directory([&](auto& entry) -> ErrorOr<void> {
-        if (name != entry.name) {
-            auto entry_name = TRY(KString::try_create(entry.name));
-            TRY(entries.try_append({ move(entry_name), entry.inode.index(), entry.file_type }));
-        }
-        return {};
-    }));
-
-    TRY(write_directory(entries));
+    TRY(remove_directory_entry((*it).value.offset, child_inode_index));
 
     m_lookup_cache.remove(it);
 
@@ -1225,9 +1375,36 @@ ErrorOr<void> Ext2FS::write_ext2_inode(InodeIndex inode, ext2_inode const& e2ino
     return write_block(block_index, buffer, inode_size(), offset);
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> ErrorOr<Vector<BlockIndex>>
+auto Ext2FS::allocate_contiguous_blocks_at(BlockIndex goal, size_t max_count) -> ErrorOr<size_t>
+{
+    MutexLocker locker(m_lock);
+    if (goal < first_block_index() || goal.value() >= super_block().s_blocks_count)
+        return 0;
+
+    auto group_index = group_index_from_block_index(goal);
+    auto const& bgd = group_descriptor(group_index);
+    if (!bgd.bg_free_blocks_count)
+        return 0;
+
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_per_group());
+    size_t first_bit_index = (goal.value() - first_block_index().value()) - ((group_index.value() - 1) * blocks_per_group());
+
+    size_t count = 0;
+    while (count < max_count && first_bit_index + count < blocks_per_group() && goal.value() + count < super_block().s_blocks_count) {
+        if (block_bitmap.get(first_bit_index + count))
+            break;
+        TRY(set_block_allocation_state(goal.value() + count, true));
+        ++count;
+    }
+
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_contiguous_blocks_at(goal: {}, max count: {}): allocated {}", goal, max_count, count);
+    return count;
+}
+
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal) -> ErrorOr<Vector<BlockIndex>>
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, goal {})", preferred_group_index, count, goal);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -1235,6 +1412,17 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     TRY(blocks.try_ensure_capacity(count));
 
     MutexLocker locker(m_lock);
+
+    // Extending the caller's last block keeps the file in one piece on disk, only fall back to searching for free space after that.
+    if (goal.value()) {
+        auto contiguous_count = TRY(allocate_contiguous_blocks_at(goal, count));
+        for (size_t i = 0; i < contiguous_count; ++i)
+            blocks.unchecked_append(goal.value() + i);
+        if (blocks.size() == count)
+            return blocks;
+        preferred_group_index = group_index_from_block_index(goal);
+    }
+
     auto group_index = preferred_group_index;
 
     if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
@@ -1509,11 +1697,11 @@ ErrorOr<void> Ext2FSInode::populate_lookup_cache() const
     MutexLocker locker(m_inode_lock);
     if (!m_lookup_cache.is_empty())
         return {};
-    HashMap<NonnullOwnPtr<KString>, InodeIndex> children;
+    HashMap<NonnullOwnPtr<KString>, LookupCacheEntry> children;
 
-    TRY(traverse_as_directory([&children](auto& entry) -> ErrorOr<void> {
-        auto entry_name = TRY(KString::try_create(entry.name));
-        TRY(children.try_set(move(entry_name), entry.inode.index()));
+    TRY(traverse_directory_entries([&children](auto& entry, u64 offset) -> ErrorOr<void> {
+        auto entry_name = TRY(KString::try_create(StringView { entry.name, entry.name_len }));
+        TRY(children.try_set(move(entry_name), { entry.inode, offset }));
         return {};
     }));
 
@@ -1536,7 +1724,7 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::lookup(StringView name)
             dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]:lookup(): '{}' not found", identifier(), name);
             return ENOENT;
         }
-        inode_index = it->value;
+        inode_index = it->value.inode_index;
     }
 
     return fs().get_inode({ fsid(), inode_index });
@@ -36,6 +36,7 @@ public:
 private:
     // ^Inode
     virtual ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
+    virtual ErrorOr<size_t> read_bytes_for_page_cache(off_t, size_t, UserOrKernelBuffer& buffer) const override;
     virtual InodeMetadata metadata() const override;
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const override;
     virtual ErrorOr<NonnullRefPtr<Inode>> lookup(StringView name) override;
@@ -53,9 +54,14 @@ private:
     virtual ErrorOr<void> chown(UserID, GroupID) override;
     virtual ErrorOr<void> truncate(u64) override;
     virtual ErrorOr<int> get_block_address(int) override;
+    virtual void detach(OpenFileDescription&) override;
 
     ErrorOr<void> write_directory(Vector<Ext2FSDirectoryEntry>&);
+    ErrorOr<void> traverse_directory_entries(Function<ErrorOr<void>(ext2_dir_entry_2 const&, u64 offset)>) const;
+    ErrorOr<u64> insert_directory_entry(InodeIndex, StringView name, u8 file_type);
+    ErrorOr<void> remove_directory_entry(u64 offset, InodeIndex);
     ErrorOr<void> populate_lookup_cache() const;
+    ErrorOr<size_t> read_bytes_impl(off_t, size_t, UserOrKernelBuffer& buffer, bool allow_cache) const;
     ErrorOr<void> resize(u64);
     ErrorOr<void> write_indirect_block(BlockBasedFileSystem::BlockIndex, Span<BlockBasedFileSystem::BlockIndex>);
     ErrorOr<void> grow_doubly_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
@@ -63,6 +69,8 @@ private:
     ErrorOr<void> grow_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, Span<BlockBasedFileSystem::BlockIndex>, Vector<BlockBasedFileSystem::BlockIndex>&, unsigned&);
     ErrorOr<void> shrink_triply_indirect_block(BlockBasedFileSystem::BlockIndex, size_t, size_t, unsigned&);
     ErrorOr<void> flush_block_list();
+    BlockBasedFileSystem::BlockIndex next_block_goal() const;
+    ErrorOr<void> discard_preallocated_blocks();
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_with_meta_blocks() const;
     ErrorOr<Vector<BlockBasedFileSystem::BlockIndex>> compute_block_list_impl(bool include_block_list_blocks) const;
@@ -72,8 +80,21 @@ private:
     const Ext2FS& fs() const;
     Ext2FSInode(Ext2FS&, InodeIndex);
 
+    // Number of blocks reserved behind the end of a regular file whenever it grows.
+    static constexpr size_t preallocation_window_size = 8;
+
     mutable Vector<BlockBasedFileSystem::BlockIndex> m_block_list;
-    mutable HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
+
+    // Blocks directly following the last block of the file which are marked as used in the bitmap,
+    // but are not part of the block list yet.
+    BlockBasedFileSystem::BlockIndex m_preallocation_start { 0 };
+    size_t m_preallocation_count { 0 };
+    struct LookupCacheEntry {
+        InodeIndex inode_index;
+        // Entries are edited in place, so this stays valid until the entry itself is removed.
+        u64 offset { 0 };
+    };
+    mutable HashMap<NonnullOwnPtr<KString>, LookupCacheEntry> m_lookup_cache;
     ext2_inode m_raw_inode {};
 };
 
@@ -133,7 +154,8 @@ private:
 
     BlockIndex first_block_index() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal = 0);
+    ErrorOr<size_t> allocate_contiguous_blocks_at(BlockIndex goal, size_t max_count);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
 
@@ -18,7 +18,7 @@ static Atomic<int> s_next_fifo_id = 1;
 
 ErrorOr<NonnullRefPtr<FIFO>> FIFO::try_create(UserID uid)
 {
-    auto buffer = TRY(DoubleBuffer::try_create());
+    auto buffer = TRY(ByteRingBuffer::try_create());
     return adopt_nonnull_ref_or_enomem(new (nothrow) FIFO(uid, move(buffer)));
 }
 
@@ -59,7 +59,7 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> FIFO::open_direction_blocking(FIFO::
     return description;
 }
 
-FIFO::FIFO(UserID uid, NonnullOwnPtr<DoubleBuffer> buffer)
+FIFO::FIFO(UserID uid, NonnullOwnPtr<ByteRingBuffer> buffer)
     : m_buffer(move(buffer))
     , m_uid(uid)
 {
@@ -64,6 +64,19 @@ void FileSystem::sync()
         fs.flush_writes();
 }
 
+void FileSystem::write_back_all()
+{
+    NonnullRefPtrVector<FileSystem, 32> file_systems;
+    {
+        InterruptDisabler disabler;
+        for (auto& it : all_file_systems())
+            file_systems.append(*it.value);
+    }
+
+    for (auto& fs : file_systems)
+        fs.write_back_dirty_data();
+}
+
 void FileSystem::lock_all()
 {
     for (auto& it : all_file_systems()) {
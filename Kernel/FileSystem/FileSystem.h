@@ -29,6 +29,7 @@ public:
     FileSystemID fsid() const { return m_fsid; }
     static FileSystem* from_fsid(FileSystemID);
     static void sync();
+    static void write_back_all();
     static void lock_all();
 
     virtual ErrorOr<void> initialize() = 0;
@@ -54,11 +55,14 @@ public:
     };
 
     virtual void flush_writes() { }
+    // Called periodically, and whenever a file system asks for it, to write out some of its dirty data without stalling anyone.
+    virtual void write_back_dirty_data() { }
 
     u64 block_size() const { return m_block_size; }
     size_t fragment_size() const { return m_fragment_size; }
 
     virtual bool is_file_backed() const { return false; }
+    virtual bool is_block_based() const { return false; }
 
     // Converts file types that are used internally by the filesystem to DT_* types
     virtual u8 internal_file_type_to_directory_entry_type(const DirectoryEntryView& entry) const { return entry.file_type; }
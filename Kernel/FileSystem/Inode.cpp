@@ -10,6 +10,7 @@
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DentryCache.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -213,6 +214,8 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
 
 void Inode::did_add_child(InodeIdentifier, StringView name)
 {
+    DentryCache::the().invalidate(*this, name);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
     });
@@ -220,6 +223,8 @@ void Inode::did_add_child(InodeIdentifier, StringView name)
 
 void Inode::did_remove_child(InodeIdentifier, StringView name)
 {
+    DentryCache::the().invalidate(*this, name);
+
     if (name == "." || name == "..") {
         // These are just aliases and are not interesting to userspace.
         return;
@@ -239,6 +244,8 @@ void Inode::did_modify_contents()
 
 void Inode::did_delete_self()
 {
+    DentryCache::the().invalidate_directory(*this);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::Deleted);
     });
@@ -259,6 +266,11 @@ ErrorOr<void> Inode::prepare_to_write_data()
     return {};
 }
 
+ErrorOr<RefPtr<Memory::PhysicalPage>> Inode::shareable_physical_page(size_t)
+{
+    VERIFY_NOT_REACHED();
+}
+
 RefPtr<Memory::SharedInodeVMObject> Inode::shared_vmobject() const
 {
     MutexLocker locker(m_inode_lock);
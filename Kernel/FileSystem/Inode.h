@@ -52,6 +52,9 @@ public:
     virtual void detach(OpenFileDescription&) { }
     virtual void did_seek(OpenFileDescription&, off_t) { }
     virtual ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
+    // Reads on behalf of the page cache (see SharedInodeVMObject), which keeps the data in memory itself.
+    // File systems with a cache of their own can skip it here, so that the data isn't cached twice.
+    virtual ErrorOr<size_t> read_bytes_for_page_cache(off_t offset, size_t count, UserOrKernelBuffer& buffer) const { return read_bytes(offset, count, buffer, nullptr); }
     virtual ErrorOr<void> traverse_as_directory(Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)>) const = 0;
     virtual ErrorOr<NonnullRefPtr<Inode>> lookup(StringView name) = 0;
     virtual ErrorOr<size_t> write_bytes(off_t, size_t, const UserOrKernelBuffer& data, OpenFileDescription*) = 0;
@@ -84,6 +87,12 @@ public:
     ErrorOr<void> set_shared_vmobject(Memory::SharedInodeVMObject&);
     RefPtr<Memory::SharedInodeVMObject> shared_vmobject() const;
 
+    // Inodes of in-memory file systems keep their contents in physical pages, which shared mappings
+    // use directly instead of reading the contents into pages of their own.
+    virtual bool has_shareable_physical_pages() const { return false; }
+    // Returns null for pages past the end of the file.
+    virtual ErrorOr<RefPtr<Memory::PhysicalPage>> shareable_physical_page(size_t page_index);
+
     static void sync_all();
     void sync();
 
@@ -31,7 +31,13 @@ ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, Us
     if (Checked<off_t>::addition_would_overflow(offset, count))
         return EOVERFLOW;
 
-    auto nread = TRY(m_inode->read_bytes(offset, count, buffer, &description));
+    size_t nread = 0;
+    if (should_use_page_cache(description)) {
+        auto page_cache = TRY(this->page_cache());
+        nread = TRY(page_cache->read_bytes(offset, count, buffer));
+    } else {
+        nread = TRY(m_inode->read_bytes(offset, count, buffer, &description));
+    }
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
         evaluate_block_conditions();
@@ -46,6 +52,8 @@ ErrorOr<size_t> InodeFile::write(OpenFileDescription& description, u64 offset, c
 
     auto nwritten = TRY(m_inode->write_bytes(offset, count, data, &description));
     if (nwritten > 0) {
+        if (auto shared_vmobject = m_inode->shared_vmobject())
+            TRY(shared_vmobject->did_write_bytes(offset, nwritten, data));
         auto mtime_result = m_inode->set_mtime(kgettimeofday().to_truncated_seconds());
         Thread::current()->did_file_write(nwritten);
         evaluate_block_conditions();
@@ -55,6 +63,25 @@ ErrorOr<size_t> InodeFile::write(OpenFileDescription& description, u64 offset, c
     return nwritten;
 }
 
+bool InodeFile::should_use_page_cache(OpenFileDescription const& description) const
+{
+    // O_DIRECT reads should hit the disk, and inodes of in-memory file systems
+    // already keep their data in memory.
+    if (description.is_direct())
+        return false;
+    if (!m_inode->fs().is_block_based())
+        return false;
+    return m_inode->metadata().is_regular_file();
+}
+
+ErrorOr<NonnullRefPtr<Memory::SharedInodeVMObject>> InodeFile::page_cache()
+{
+    MutexLocker locker(m_page_cache_lock);
+    if (!m_page_cache)
+        m_page_cache = TRY(Memory::SharedInodeVMObject::try_create_with_inode(*m_inode));
+    return *m_page_cache;
+}
+
 ErrorOr<void> InodeFile::ioctl(OpenFileDescription& description, unsigned request, Userspace<void*> arg)
 {
     switch (request) {
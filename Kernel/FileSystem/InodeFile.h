@@ -7,6 +7,8 @@
 #pragma once
 
 #include <Kernel/FileSystem/File.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/SharedInodeVMObject.h>
 
 namespace Kernel {
 
@@ -50,7 +52,16 @@ public:
 
 private:
     explicit InodeFile(NonnullRefPtr<Inode>&&);
+
+    bool should_use_page_cache(OpenFileDescription const&) const;
+    ErrorOr<NonnullRefPtr<Memory::SharedInodeVMObject>> page_cache();
+
     NonnullRefPtr<Inode> m_inode;
+
+    // Holding on to the inode's shared VMObject keeps the pages we read through it
+    // cached for as long as the file is open.
+    Mutex m_page_cache_lock { "InodeFile page cache" };
+    RefPtr<Memory::SharedInodeVMObject> m_page_cache;
 };
 
 }
@@ -201,7 +201,7 @@ ErrorOr<void> Plan9FS::initialize()
     ensure_thread();
 
     Message version_message { *this, Message::Type::Tversion };
-    version_message << (u32)m_max_message_size << "9P2000.L";
+    version_message << (u32)max_message_size_to_negotiate << "9P2000.L";
 
     TRY(post_message_and_wait_for_a_reply(version_message));
 
@@ -323,7 +323,7 @@ StringView Plan9FS::Message::Decoder::read_data()
 }
 
 Plan9FS::Message::Message(Plan9FS& fs, Type type)
-    : m_builder(KBufferBuilder::try_create().release_value()) // FIXME: Don't assume KBufferBuilder allocation success.
+    : m_builder(KBufferBuilder::try_create(4 * KiB).release_value()) // FIXME: Don't assume KBufferBuilder allocation success.
     , m_tag(fs.allocate_tag())
     , m_type(type)
     , m_have_been_built(false)
@@ -409,10 +409,10 @@ bool Plan9FS::Blocker::unblock(u16 tag)
         SpinlockLocker lock(m_lock);
         if (m_did_unblock)
             return false;
-        m_did_unblock = true;
-
+        // With several requests in flight, other replies may arrive before ours.
         if (m_completion->tag != tag)
             return false;
+        m_did_unblock = true;
         if (!m_completion->result.is_error())
             m_message = move(*m_completion->message);
     }
@@ -584,10 +584,21 @@ ErrorOr<void> Plan9FS::post_message_and_explicitly_ignore_reply(Message& message
 
 ErrorOr<void> Plan9FS::post_message_and_wait_for_a_reply(Message& message)
 {
-    auto request_type = message.type();
-    auto tag = message.tag();
-    auto completion = adopt_ref(*new ReceiveCompletion(tag));
+    auto completion = TRY(post_message_expecting_reply(message));
+    return wait_for_reply(message, move(completion));
+}
+
+ErrorOr<NonnullRefPtr<Plan9FS::ReceiveCompletion>> Plan9FS::post_message_expecting_reply(Message& message)
+{
+    auto completion = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) ReceiveCompletion(message.tag())));
     TRY(post_message(message, completion));
+    return completion;
+}
+
+ErrorOr<void> Plan9FS::wait_for_reply(Message& message, NonnullRefPtr<ReceiveCompletion> completion)
+{
+    // The message is still the request we sent until the reply replaces it.
+    auto request_type = message.type();
     if (Thread::current()->block<Plan9FS::Blocker>({}, *this, message, completion).was_interrupted())
         return EINTR;
 
@@ -724,37 +735,117 @@ ErrorOr<size_t> Plan9FSInode::read_bytes(off_t offset, size_t size, UserOrKernel
 {
     TRY(const_cast<Plan9FSInode&>(*this).ensure_open_for_mode(O_RDONLY));
 
-    size = fs().adjust_buffer_size(size);
-
-    Plan9FS::Message message { fs(), Plan9FS::Message::Type::Treadlink };
-    StringView data;
-
     // Try readlink first.
-    bool readlink_succeeded = false;
     if (fs().m_remote_protocol_version >= Plan9FS::ProtocolVersion::v9P2000L && offset == 0) {
+        Plan9FS::Message message { fs(), Plan9FS::Message::Type::Treadlink };
         message << fid();
         if (auto result = fs().post_message_and_wait_for_a_reply(message); !result.is_error()) {
-            readlink_succeeded = true;
+            StringView data;
             message >> data;
+            // Guard against the server returning more data than requested.
+            size_t nread = min(data.length(), fs().adjust_buffer_size(size));
+            TRY(buffer.write(data.characters_without_null_termination(), nread));
+            return nread;
         }
     }
 
-    if (!readlink_succeeded) {
-        message = Plan9FS::Message { fs(), Plan9FS::Message::Type::Tread };
-        message << fid() << (u64)offset << (u32)size;
-        TRY(fs().post_message_and_wait_for_a_reply(message));
-        data = message.read_data();
+    MutexLocker locker(m_readahead_lock);
+
+    // The file might be changed on the host behind our back, so we only ever hand out readahead data
+    // to the sequential read that it was fetched for.
+    bool is_sequential = static_cast<u64>(offset) == m_next_sequential_offset;
+    if (!is_sequential)
+        m_readahead_buffer = nullptr;
+
+    size_t nread = 0;
+    if (m_readahead_buffer && static_cast<u64>(offset) >= m_readahead_offset && static_cast<u64>(offset) < m_readahead_offset + m_readahead_buffer->size()) {
+        auto offset_in_readahead = static_cast<u64>(offset) - m_readahead_offset;
+        nread = min(size, m_readahead_buffer->size() - offset_in_readahead);
+        TRY(buffer.write(m_readahead_buffer->data() + offset_in_readahead, nread));
     }
 
-    // Guard against the server returning more data than requested.
-    size_t nread = min(data.length(), size);
-    TRY(buffer.write(data.characters_without_null_termination(), nread));
+    if (nread < size) {
+        auto fetch_offset = offset + nread;
+        auto remaining = size - nread;
+        if (!is_sequential || remaining >= readahead_size) {
+            // Random reads (and big enough sequential ones) don't need a detour through the readahead buffer.
+            nread += TRY(read_pipelined(fetch_offset, remaining, buffer, nread));
+        } else {
+            auto readahead_buffer = TRY(KBuffer::try_create_with_size(readahead_size, Memory::Region::Access::ReadWrite, "Plan9FS readahead"sv));
+            auto readahead_buffer_data = UserOrKernelBuffer::for_kernel_buffer(readahead_buffer->data());
+            auto nfetched = TRY(read_pipelined(fetch_offset, readahead_size, readahead_buffer_data, 0));
+            readahead_buffer->set_size(nfetched);
+            auto ncopied = min(remaining, nfetched);
+            TRY(buffer.write(readahead_buffer->data(), nread, ncopied));
+            nread += ncopied;
+            m_readahead_buffer = move(readahead_buffer);
+            m_readahead_offset = fetch_offset;
+        }
+    }
+
+    m_next_sequential_offset = offset + nread;
+    return nread;
+}
+
+ErrorOr<size_t> Plan9FSInode::read_pipelined(u64 offset, size_t size, UserOrKernelBuffer& buffer, size_t buffer_offset) const
+{
+    struct ReadInFlight {
+        NonnullOwnPtr<Plan9FS::Message> message;
+        NonnullRefPtr<Plan9FS::ReceiveCompletion> completion;
+        u64 offset;
+        u32 size;
+    };
+    Vector<ReadInFlight, max_reads_in_flight> reads_in_flight;
+
+    auto size_per_read = fs().adjust_buffer_size(size);
+    u64 next_offset_to_request = offset;
+    size_t nread = 0;
+    while (true) {
+        while (reads_in_flight.size() < max_reads_in_flight && next_offset_to_request < offset + size) {
+            auto read_size = static_cast<u32>(min(size_per_read, offset + size - next_offset_to_request));
+            auto message = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Plan9FS::Message { fs(), Plan9FS::Message::Type::Tread }));
+            *message << fid() << next_offset_to_request << read_size;
+            auto completion_or_error = fs().post_message_expecting_reply(*message);
+            if (completion_or_error.is_error()) {
+                if (reads_in_flight.is_empty() && nread == 0)
+                    return completion_or_error.release_error();
+                break;
+            }
+            TRY(reads_in_flight.try_append({ move(message), completion_or_error.release_value(), next_offset_to_request, read_size }));
+            next_offset_to_request += read_size;
+        }
+        if (reads_in_flight.is_empty())
+            break;
+
+        // Replies for reads we don't wait for anymore are dropped once they arrive.
+        auto read = reads_in_flight.take_first();
+        if (auto result = fs().wait_for_reply(*read.message, read.completion); result.is_error()) {
+            if (nread == 0)
+                return result.release_error();
+            break;
+        }
+        auto data = read.message->read_data();
+        // Guard against the server returning more data than requested.
+        auto nbytes = min(data.length(), static_cast<size_t>(read.size));
+        TRY(buffer.write(data.characters_without_null_termination(), buffer_offset + nread, nbytes));
+        nread += nbytes;
+        // A short read means we've reached the end of the file.
+        if (nbytes < read.size)
+            break;
+    }
     return nread;
 }
 
+void Plan9FSInode::discard_readahead()
+{
+    MutexLocker locker(m_readahead_lock);
+    m_readahead_buffer = nullptr;
+}
+
 ErrorOr<size_t> Plan9FSInode::write_bytes(off_t offset, size_t size, const UserOrKernelBuffer& data, OpenFileDescription*)
 {
     TRY(ensure_open_for_mode(O_WRONLY));
+    discard_readahead();
     size = fs().adjust_buffer_size(size);
 
     auto data_copy = TRY(data.try_copy_into_kstring(size)); // FIXME: this seems ugly
@@ -936,6 +1027,7 @@ ErrorOr<void> Plan9FSInode::chown(UserID, GroupID)
 
 ErrorOr<void> Plan9FSInode::truncate(u64 new_size)
 {
+    discard_readahead();
     if (fs().m_remote_protocol_version >= Plan9FS::ProtocolVersion::v9P2000L) {
         Plan9FS::Message message { fs(), Plan9FS::Message::Type::Tsetattr };
         SetAttrMask valid = SetAttrMask::Size;
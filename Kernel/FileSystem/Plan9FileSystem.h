@@ -121,6 +121,10 @@ private:
     ErrorOr<void> read_and_dispatch_one_message();
     ErrorOr<void> post_message_and_wait_for_a_reply(Message&);
     ErrorOr<void> post_message_and_explicitly_ignore_reply(Message&);
+    // These let a thread have several requests in flight at once: post them all, then wait for each
+    // reply (in any order). The message gets replaced by the reply, like with post_message_and_wait_for_a_reply().
+    ErrorOr<NonnullRefPtr<ReceiveCompletion>> post_message_expecting_reply(Message&);
+    ErrorOr<void> wait_for_reply(Message&, NonnullRefPtr<ReceiveCompletion>);
 
     ProtocolVersion parse_protocol_version(StringView) const;
     size_t adjust_buffer_size(size_t size) const;
@@ -133,7 +137,9 @@ private:
     Atomic<u32> m_next_fid { 1 };
 
     ProtocolVersion m_remote_protocol_version { ProtocolVersion::v9P2000 };
-    size_t m_max_message_size { 4 * KiB };
+    // We ask for this much, the server may settle for less in its Rversion.
+    static constexpr size_t max_message_size_to_negotiate = 128 * KiB;
+    size_t m_max_message_size { max_message_size_to_negotiate };
 
     Mutex m_send_lock { "Plan9FS send" };
     Plan9FSBlockerSet m_completion_blocker;
@@ -208,6 +214,19 @@ private:
     int m_open_mode { 0 };
     ErrorOr<void> ensure_open_for_mode(int mode);
 
+    // Reads that need more than one message keep this many Tread requests in flight at once.
+    static constexpr size_t max_reads_in_flight = 8;
+    // Sequential reads fetch at least this much, and keep what wasn't asked for around for the next read.
+    static constexpr size_t readahead_size = 512 * KiB;
+
+    ErrorOr<size_t> read_pipelined(u64 offset, size_t size, UserOrKernelBuffer&, size_t buffer_offset) const;
+    void discard_readahead();
+
+    mutable Mutex m_readahead_lock { "Plan9FSInode readahead" };
+    mutable OwnPtr<KBuffer> m_readahead_buffer;
+    mutable u64 m_readahead_offset { 0 };
+    mutable u64 m_next_sequential_offset { 0 };
+
     Plan9FS& fs() { return reinterpret_cast<Plan9FS&>(Inode::fs()); }
     Plan9FS& fs() const
     {
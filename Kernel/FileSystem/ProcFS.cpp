@@ -509,6 +509,13 @@ ErrorOr<size_t> ProcFSProcessPropertyInode::read_bytes(off_t offset, size_t coun
 
     MutexLocker locker(m_refresh_lock);
 
+    if (is_generated_as_records()) {
+        auto& records_data = static_cast<ProcFSRecordsData&>(*description->data());
+        return procfs_read_records(records_data, offset, count, buffer, [this](KBufferBuilder& builder, u64& cursor) {
+            return try_to_acquire_records(builder, cursor);
+        });
+    }
+
     auto& typed_cached_data = static_cast<ProcFSInodeData&>(*description->data());
     auto& data_buffer = typed_cached_data.buffer;
 
@@ -559,8 +566,12 @@ ErrorOr<void> ProcFSProcessPropertyInode::try_to_acquire_data(Process& process,
         return process.procfs_get_current_work_directory_link(builder);
     case SegmentedProcFSIndex::MainProcessProperty::PerformanceEvents:
         return process.procfs_get_perf_events(builder);
-    case SegmentedProcFSIndex::MainProcessProperty::VirtualMemoryStats:
-        return process.procfs_get_virtual_memory_stats(builder);
+    case SegmentedProcFSIndex::MainProcessProperty::VirtualMemoryStats: {
+        u64 cursor = 0;
+        while (TRY(process.procfs_get_virtual_memory_stats(builder, cursor)))
+            ;
+        return {};
+    }
     case SegmentedProcFSIndex::MainProcessProperty::TTYLink:
         return process.procfs_get_tty_link(builder);
     default:
@@ -568,6 +579,25 @@ ErrorOr<void> ProcFSProcessPropertyInode::try_to_acquire_data(Process& process,
     }
 }
 
+bool ProcFSProcessPropertyInode::is_generated_as_records() const
+{
+    return m_parent_sub_directory_type == SegmentedProcFSIndex::ProcessSubDirectory::Reserved
+        && m_possible_data.property_type == SegmentedProcFSIndex::MainProcessProperty::VirtualMemoryStats;
+}
+
+ErrorOr<bool> ProcFSProcessPropertyInode::try_to_acquire_records(KBufferBuilder& builder, u64& cursor) const
+{
+    // Every chunk is generated separately, so check again that the process may still be inspected.
+    auto process = Process::from_pid(associated_pid());
+    if (!process)
+        return Error::from_errno(ESRCH);
+    MutexLocker ptrace_locker(process->ptrace_lock());
+    if (!process->is_dumpable())
+        return EPERM;
+    VERIFY(is_generated_as_records());
+    return process->procfs_get_virtual_memory_stats(builder, cursor);
+}
+
 ErrorOr<void> ProcFSProcessPropertyInode::refresh_data(OpenFileDescription& description)
 {
     // For process-specific inodes, hold the process's ptrace lock across refresh
@@ -586,6 +616,16 @@ ErrorOr<void> ProcFSProcessPropertyInode::refresh_data(OpenFileDescription& desc
     };
     MutexLocker locker(m_refresh_lock);
     auto& cached_data = description.data();
+    if (is_generated_as_records()) {
+        // The records are generated while they are read, this only starts over from the first one.
+        if (!cached_data) {
+            cached_data = adopt_own_if_nonnull(new (nothrow) ProcFSRecordsData);
+            if (!cached_data)
+                return ENOMEM;
+        }
+        static_cast<ProcFSRecordsData&>(*cached_data).reset();
+        return {};
+    }
     if (!cached_data) {
         cached_data = adopt_own_if_nonnull(new (nothrow) ProcFSInodeData);
         if (!cached_data)
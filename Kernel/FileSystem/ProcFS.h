@@ -187,6 +187,8 @@ private:
 
     ErrorOr<void> refresh_data(OpenFileDescription& description);
     ErrorOr<void> try_to_acquire_data(Process& process, KBufferBuilder& builder) const;
+    bool is_generated_as_records() const;
+    ErrorOr<bool> try_to_acquire_records(KBufferBuilder& builder, u64& cursor) const;
 
     const SegmentedProcFSIndex::ProcessSubDirectory m_parent_sub_directory_type;
     union {
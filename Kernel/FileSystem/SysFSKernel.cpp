@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/SysFSKernel.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tracepoint.h>
+
+namespace Kernel {
+
+ErrorOr<void> SysFSKernelInformation::refresh_data(OpenFileDescription& description) const
+{
+    MutexLocker lock(m_refresh_lock);
+    auto& cached_data = description.data();
+    if (!cached_data)
+        cached_data = TRY(adopt_nonnull_own_or_enomem(new (nothrow) SysFSInodeData));
+    auto builder = TRY(KBufferBuilder::try_create());
+    TRY(const_cast<SysFSKernelInformation&>(*this).try_generate(builder));
+    auto& typed_cached_data = static_cast<SysFSInodeData&>(*cached_data);
+    typed_cached_data.buffer = builder.build();
+    if (!typed_cached_data.buffer)
+        return ENOMEM;
+    return {};
+}
+
+ErrorOr<size_t> SysFSKernelInformation::read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    dbgln_if(PROCFS_DEBUG, "SysFSKernelInformation @ {}: read_bytes offset: {} count: {}", name(), offset, count);
+
+    VERIFY(offset >= 0);
+    VERIFY(buffer.user_or_kernel_ptr());
+
+    if (!description)
+        return Error::from_errno(EIO);
+
+    MutexLocker locker(m_refresh_lock);
+
+    if (!description->data()) {
+        dbgln("SysFSKernelInformation: Do not have cached data!");
+        return Error::from_errno(EIO);
+    }
+
+    auto& typed_cached_data = static_cast<SysFSInodeData&>(*description->data());
+    auto& data_buffer = typed_cached_data.buffer;
+
+    if (!data_buffer || (size_t)offset >= data_buffer->size())
+        return 0;
+
+    ssize_t nread = min(static_cast<off_t>(data_buffer->size() - offset), static_cast<off_t>(count));
+    TRY(buffer.write(data_buffer->data() + offset, nread));
+    return nread;
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSBlockCacheStatistics> SysFSBlockCacheStatistics::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSBlockCacheStatistics).release_nonnull();
+}
+
+ErrorOr<void> SysFSBlockCacheStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    TRY(VirtualFileSystem::the().for_each_mount([&array](auto& mount) -> ErrorOr<void> {
+        auto& fs = mount.guest_fs();
+        if (!fs.is_block_based())
+            return {};
+        auto statistics = static_cast<BlockBasedFileSystem const&>(fs).cache_statistics();
+        auto fs_object = TRY(array.add_object());
+        TRY(fs_object.add("class_name", fs.class_name()));
+        auto mount_point = TRY(mount.absolute_path());
+        TRY(fs_object.add("mount_point", mount_point->view()));
+        TRY(fs_object.add("block_size", static_cast<u64>(fs.block_size())));
+        TRY(fs_object.add("hits", statistics.hits));
+        TRY(fs_object.add("misses", statistics.misses));
+        TRY(fs_object.add("ghost_hits", statistics.ghost_hits));
+        TRY(fs_object.add("evictions", statistics.evictions));
+        TRY(fs_object.add("read_ahead_blocks", statistics.read_ahead_blocks));
+        TRY(fs_object.add("read_ahead_hits", statistics.read_ahead_hits));
+        TRY(fs_object.add("capacity", statistics.capacity));
+        TRY(fs_object.add("recent_blocks", statistics.recent_count));
+        TRY(fs_object.add("frequent_blocks", statistics.frequent_count));
+        TRY(fs_object.add("ghost_blocks", statistics.ghost_count));
+        TRY(fs_object.add("dirty_blocks", statistics.dirty_count));
+        TRY(fs_object.add("written_back_blocks", statistics.written_back_blocks));
+        TRY(fs_object.add("throttled_writes", statistics.throttled_writes));
+        TRY(fs_object.finish());
+        return {};
+    }));
+    TRY(array.finish());
+    return {};
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSMemoryStatistics> SysFSMemoryStatistics::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSMemoryStatistics).release_nonnull();
+}
+
+ErrorOr<void> SysFSMemoryStatistics::try_generate(KBufferBuilder& builder)
+{
+    kmalloc_stats stats;
+    get_kmalloc_stats(stats);
+    kmalloc_slabheap_stats slabheap_stats[KMALLOC_SLABHEAP_COUNT];
+    get_kmalloc_slabheap_stats(slabheap_stats);
+
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("kmalloc_allocated", stats.bytes_allocated));
+    TRY(json.add("kmalloc_available", stats.bytes_free));
+    TRY(json.add("kmalloc_call_count", stats.kmalloc_call_count));
+    TRY(json.add("kfree_call_count", stats.kfree_call_count));
+    auto slabheaps_array = TRY(json.add_array("slabheaps"));
+    for (auto const& slabheap : slabheap_stats) {
+        auto slabheap_object = TRY(slabheaps_array.add_object());
+        TRY(slabheap_object.add("slab_size", slabheap.slab_size));
+        TRY(slabheap_object.add("usable_blocks", slabheap.usable_block_count));
+        TRY(slabheap_object.add("full_blocks", slabheap.full_block_count));
+        TRY(slabheap_object.add("allocated", slabheap.bytes_allocated));
+        TRY(slabheap_object.add("available", slabheap.bytes_free));
+        TRY(slabheap_object.add("cached_slabs", slabheap.cached_slab_count));
+        TRY(slabheap_object.add("allocation_count", slabheap.allocation_count));
+        TRY(slabheap_object.add("free_count", slabheap.free_count));
+        TRY(slabheap_object.add("magazine_refill_count", slabheap.magazine_refill_count));
+        TRY(slabheap_object.add("magazine_flush_count", slabheap.magazine_flush_count));
+        TRY(slabheap_object.finish());
+    }
+    TRY(slabheaps_array.finish());
+    TRY(json.finish());
+    return {};
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSTracepoints> SysFSTracepoints::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSTracepoints).release_nonnull();
+}
+
+mode_t SysFSTracepoints::permissions() const
+{
+    return S_IRUSR | S_IRGRP | S_IROTH | S_IWUSR;
+}
+
+ErrorOr<void> SysFSTracepoints::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    for (size_t i = 0; i < tracepoint_count; ++i) {
+        auto id = static_cast<TracepointID>(i);
+        auto& info = Tracepoints::info(id);
+        auto tracepoint_object = TRY(array.add_object());
+        TRY(tracepoint_object.add("subsystem", info.subsystem));
+        TRY(tracepoint_object.add("name", info.name));
+        TRY(tracepoint_object.add("enabled", Tracepoints::is_enabled(id)));
+        auto hits_array = TRY(tracepoint_object.add_array("hits"));
+        for (u32 cpu = 0; cpu < Processor::count(); ++cpu)
+            TRY(hits_array.add(Tracepoints::hit_count(id, cpu)));
+        TRY(hits_array.finish());
+        TRY(tracepoint_object.finish());
+    }
+    TRY(array.finish());
+    return {};
+}
+
+ErrorOr<void> SysFSTracepoints::truncate(u64 size)
+{
+    // NOTE: There is nothing stored in here, so truncating to zero is fine (and lets shells redirect into it).
+    if (size != 0)
+        return EPERM;
+    return {};
+}
+
+ErrorOr<size_t> SysFSTracepoints::write_bytes(off_t offset, size_t count, UserOrKernelBuffer const& data, OpenFileDescription*)
+{
+    if (offset != 0)
+        return EINVAL;
+    char buffer[256];
+    if (count > sizeof(buffer))
+        return EINVAL;
+    TRY(data.read(buffer, count));
+
+    // NOTE: Validate everything before toggling anything, so a bad line doesn't leave a partial update behind.
+    auto for_each_request = [&](auto callback) -> ErrorOr<void> {
+        ErrorOr<void> result {};
+        StringView { buffer, count }.for_each_split_view('\n', false, [&](StringView line) {
+            if (result.is_error())
+                return;
+            auto separator = line.find(' ');
+            if (!separator.has_value()) {
+                result = EINVAL;
+                return;
+            }
+            auto selector = line.substring_view(0, separator.value());
+            auto value = line.substring_view(separator.value() + 1);
+            if (value != "0"sv && value != "1"sv) {
+                result = EINVAL;
+                return;
+            }
+            bool enabled = value == "1"sv;
+            if (selector == "all"sv) {
+                for (size_t i = 0; i < tracepoint_count; ++i)
+                    callback(static_cast<TracepointID>(i), enabled);
+                return;
+            }
+            auto name_separator = selector.find(':');
+            if (!name_separator.has_value()) {
+                result = EINVAL;
+                return;
+            }
+            auto id = Tracepoints::find(selector.substring_view(0, name_separator.value()), selector.substring_view(name_separator.value() + 1));
+            if (!id.has_value()) {
+                result = ENOENT;
+                return;
+            }
+            callback(id.value(), enabled);
+        });
+        return result;
+    };
+
+    TRY(for_each_request([](TracepointID, bool) {}));
+    MUST(for_each_request([](TracepointID id, bool enabled) { Tracepoints::set_enabled(id, enabled); }));
+    return count;
+}
+
+UNMAP_AFTER_INIT void KernelSysFSDirectory::initialize()
+{
+    auto kernel_directory = adopt_ref_if_nonnull(new (nothrow) KernelSysFSDirectory()).release_nonnull();
+    SysFSComponentRegistry::the().register_new_component(kernel_directory);
+}
+
+UNMAP_AFTER_INIT KernelSysFSDirectory::KernelSysFSDirectory()
+    : SysFSDirectory(SysFSComponentRegistry::the().root_directory())
+{
+    m_components.append(SysFSBlockCacheStatistics::must_create());
+    m_components.append(SysFSMemoryStatistics::must_create());
+    m_components.append(SysFSTracepoints::must_create());
+}
+
+}
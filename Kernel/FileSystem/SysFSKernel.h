@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/FileSystem/SysFS.h>
+#include <Kernel/KBufferBuilder.h>
+#include <Kernel/Locking/Mutex.h>
+
+namespace Kernel {
+
+class SysFSKernelInformation : public SysFSComponent {
+public:
+    virtual ErrorOr<size_t> read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription*) const override;
+
+protected:
+    SysFSKernelInformation() = default;
+    virtual ErrorOr<void> try_generate(KBufferBuilder&) = 0;
+
+private:
+    virtual ErrorOr<void> refresh_data(OpenFileDescription&) const override;
+
+    mutable Mutex m_refresh_lock;
+};
+
+class SysFSBlockCacheStatistics final : public SysFSKernelInformation {
+public:
+    virtual StringView name() const override { return "block_cache"sv; }
+    static NonnullRefPtr<SysFSBlockCacheStatistics> must_create();
+
+private:
+    SysFSBlockCacheStatistics() = default;
+    virtual ErrorOr<void> try_generate(KBufferBuilder&) override;
+};
+
+class SysFSMemoryStatistics final : public SysFSKernelInformation {
+public:
+    virtual StringView name() const override { return "memstat"sv; }
+    static NonnullRefPtr<SysFSMemoryStatistics> must_create();
+
+private:
+    SysFSMemoryStatistics() = default;
+    virtual ErrorOr<void> try_generate(KBufferBuilder&) override;
+};
+
+// Reading gives every tracepoint with its per-processor hit counts,
+// writing lines of "<subsystem>:<name> <0|1>" (or "all <0|1>") toggles them.
+class SysFSTracepoints final : public SysFSKernelInformation {
+public:
+    virtual StringView name() const override { return "tracepoints"sv; }
+    static NonnullRefPtr<SysFSTracepoints> must_create();
+
+    virtual mode_t permissions() const override;
+    virtual ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const&, OpenFileDescription*) override;
+    virtual ErrorOr<void> truncate(u64) override;
+    virtual ErrorOr<void> set_mtime(time_t) override { return {}; }
+
+private:
+    SysFSTracepoints() = default;
+    virtual ErrorOr<void> try_generate(KBufferBuilder&) override;
+};
+
+class KernelSysFSDirectory final : public SysFSDirectory {
+public:
+    virtual StringView name() const override { return "kernel"sv; }
+    static void initialize();
+
+private:
+    KernelSysFSDirectory();
+};
+
+}
@@ -5,6 +5,8 @@
  */
 
 #include <Kernel/FileSystem/TmpFS.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Process.h>
 #include <LibC/limits.h>
 
@@ -100,17 +102,32 @@ ErrorOr<size_t> TmpFSInode::read_bytes(off_t offset, size_t size, UserOrKernelBu
     VERIFY(!is_directory());
     VERIFY(offset >= 0);
 
-    if (!m_content)
-        return 0;
-
     if (offset >= m_metadata.size)
         return 0;
 
     if (static_cast<off_t>(size) > m_metadata.size - offset)
         size = m_metadata.size - offset;
 
-    TRY(buffer.write(m_content->data() + offset, size));
-    return size;
+    u8 page_buffer[PAGE_SIZE];
+    size_t nread = 0;
+    while (nread < size) {
+        auto position = offset + nread;
+        auto page_index = position / PAGE_SIZE;
+        auto offset_in_page = position % PAGE_SIZE;
+        auto nbytes = min(PAGE_SIZE - offset_in_page, size - nread);
+
+        RefPtr<Memory::PhysicalPage> physical_page;
+        if (page_index < m_pages.size())
+            physical_page = m_pages[page_index];
+        if (physical_page) {
+            MM.copy_physical_page(*physical_page, page_buffer);
+            TRY(buffer.write(page_buffer + offset_in_page, nread, nbytes));
+        } else {
+            TRY(buffer.memset(0, nread, nbytes));
+        }
+        nread += nbytes;
+    }
+    return nread;
 }
 
 ErrorOr<size_t> TmpFSInode::write_bytes(off_t offset, size_t size, const UserOrKernelBuffer& buffer, OpenFileDescription*)
@@ -129,33 +146,94 @@ ErrorOr<size_t> TmpFSInode::write_bytes(off_t offset, size_t size, const UserOrK
     if (static_cast<u64>(new_size) > (NumericLimits<size_t>::max() / 2)) // on 32-bit, size_t might be 32 bits while off_t is 64 bits
         return ENOMEM;                                                   // we won't be able to resize to this capacity
 
+    if (new_size > old_size)
+        zero_page_tail(old_size);
+
+    u8 page_buffer[PAGE_SIZE];
+    size_t nwritten = 0;
+    while (nwritten < size) {
+        auto position = offset + nwritten;
+        auto page_index = position / PAGE_SIZE;
+        auto offset_in_page = position % PAGE_SIZE;
+        auto nbytes = min(PAGE_SIZE - offset_in_page, size - nwritten);
+
+        auto physical_page = TRY(ensure_page(page_index, new_size));
+        if (nbytes < PAGE_SIZE)
+            MM.copy_physical_page(*physical_page, page_buffer);
+        TRY(buffer.read(page_buffer + offset_in_page, nwritten, nbytes));
+        MM.copy_to_physical_page(*physical_page, page_buffer);
+        nwritten += nbytes;
+    }
+
     if (new_size > old_size) {
-        if (m_content && static_cast<off_t>(m_content->capacity()) >= new_size) {
-            m_content->set_size(new_size);
-        } else {
-            // Grow the content buffer 2x the new size to accommodate repeating write() calls.
-            // Note that we're not actually committing physical memory to the buffer
-            // until it's needed. We only grow VM here.
-
-            // FIXME: Fix this so that no memcpy() is necessary, and we can just grow the
-            //        KBuffer and it will add physical pages as needed while keeping the
-            //        existing ones.
-            auto tmp = TRY(KBuffer::try_create_with_size(new_size * 2));
-            tmp->set_size(new_size);
-            if (m_content)
-                memcpy(tmp->data(), m_content->data(), old_size);
-            m_content = move(tmp);
-        }
         m_metadata.size = new_size;
         set_metadata_dirty(true);
     }
 
-    TRY(buffer.read(m_content->data() + offset, size)); // TODO: partial reads?
-
     did_modify_contents();
     return size;
 }
 
+ErrorOr<NonnullRefPtr<Memory::PhysicalPage>> TmpFSInode::ensure_page(size_t page_index, off_t file_size)
+{
+    VERIFY(m_inode_lock.is_locked());
+    if (page_index >= m_pages.size())
+        TRY(m_pages.try_resize(page_index + 1));
+    if (auto& physical_page = m_pages[page_index])
+        return *physical_page;
+
+    if (static_cast<u64>(file_size) >= Memory::huge_page_size)
+        try_allocate_huge_page(page_index);
+    if (!m_pages[page_index])
+        m_pages[page_index] = TRY(MM.allocate_user_physical_page(Memory::MemoryManager::ShouldZeroFill::Yes));
+    return *m_pages[page_index];
+}
+
+// Large files get whole huge pages at once where they can, so that shared mappings of them
+// can be mapped with huge pages as well, see Region::try_handle_huge_inode_fault().
+void TmpFSInode::try_allocate_huge_page(size_t page_index)
+{
+    auto first_page_index = page_index - (page_index % Memory::pages_per_huge_page);
+    auto end_page_index = first_page_index + Memory::pages_per_huge_page;
+    for (auto i = first_page_index; i < min(end_page_index, m_pages.size()); ++i) {
+        if (m_pages[i])
+            return;
+    }
+
+    auto physical_pages = MM.allocate_user_physical_huge_page();
+    if (physical_pages.is_empty())
+        return;
+    if (end_page_index > m_pages.size() && m_pages.try_resize(end_page_index).is_error())
+        return;
+    for (size_t i = 0; i < Memory::pages_per_huge_page; ++i)
+        m_pages[first_page_index + i] = physical_pages.ptr_at(i);
+}
+
+// Shared mappings can write past the end of the file in its last page, that data must not show up
+// when the file grows again.
+void TmpFSInode::zero_page_tail(off_t file_size)
+{
+    auto page_index = file_size / PAGE_SIZE;
+    auto offset_in_page = file_size % PAGE_SIZE;
+    if (offset_in_page == 0 || static_cast<size_t>(page_index) >= m_pages.size() || !m_pages[page_index])
+        return;
+
+    u8 page_buffer[PAGE_SIZE];
+    MM.copy_physical_page(*m_pages[page_index], page_buffer);
+    memset(page_buffer + offset_in_page, 0, PAGE_SIZE - offset_in_page);
+    MM.copy_to_physical_page(*m_pages[page_index], page_buffer);
+}
+
+ErrorOr<RefPtr<Memory::PhysicalPage>> TmpFSInode::shareable_physical_page(size_t page_index)
+{
+    MutexLocker locker(m_inode_lock);
+    VERIFY(m_metadata.is_regular_file());
+    if (page_index >= ceil_div(static_cast<u64>(m_metadata.size), static_cast<u64>(PAGE_SIZE)))
+        return nullptr;
+    // The mapping might get written to, so holes need a page of their own now.
+    return RefPtr<Memory::PhysicalPage> { TRY(ensure_page(page_index, m_metadata.size)) };
+}
+
 ErrorOr<NonnullRefPtr<Inode>> TmpFSInode::lookup(StringView name)
 {
     MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
@@ -289,24 +367,24 @@ ErrorOr<void> TmpFSInode::truncate(u64 size)
     MutexLocker locker(m_inode_lock);
     VERIFY(!is_directory());
 
-    if (size == 0)
-        m_content.clear();
-    else if (!m_content) {
-        m_content = TRY(KBuffer::try_create_with_size(size));
-    } else if (static_cast<size_t>(size) < m_content->capacity()) {
-        size_t prev_size = m_metadata.size;
-        m_content->set_size(size);
-        if (prev_size < static_cast<size_t>(size))
-            memset(m_content->data() + prev_size, 0, size - prev_size);
-    } else {
-        size_t prev_size = m_metadata.size;
-        auto tmp = TRY(KBuffer::try_create_with_size(size));
-        memcpy(tmp->data(), m_content->data(), prev_size);
-        m_content = move(tmp);
-    }
+    if (static_cast<u64>(size) > (NumericLimits<size_t>::max() / 2))
+        return ENOMEM;
+
+    // Growing the file leaves a hole, which doesn't need any pages yet.
+    auto page_count = ceil_div(static_cast<size_t>(size), static_cast<size_t>(PAGE_SIZE));
+    if (page_count < m_pages.size())
+        m_pages.shrink(page_count);
+    zero_page_tail(min(static_cast<off_t>(size), m_metadata.size));
 
+    auto old_size = m_metadata.size;
     m_metadata.size = size;
     set_metadata_dirty(true);
+
+    // Shared mappings must let go of the pages we just dropped, otherwise they would keep using them
+    // while writes after the file grows again go to new pages. This happens with the inode locked,
+    // so that no page fault can pick up one of the dropped pages in the meantime.
+    if (auto shared_vmobject = this->shared_vmobject())
+        shared_vmobject->did_resize(old_size, size);
     return {};
 }
 
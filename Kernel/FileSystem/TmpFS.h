@@ -8,7 +8,7 @@
 
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
-#include <Kernel/KBuffer.h>
+#include <Kernel/Memory/PhysicalPage.h>
 
 namespace Kernel {
 
@@ -62,6 +62,8 @@ public:
     virtual ErrorOr<void> set_atime(time_t) override;
     virtual ErrorOr<void> set_ctime(time_t) override;
     virtual ErrorOr<void> set_mtime(time_t) override;
+    virtual bool has_shareable_physical_pages() const override { return m_metadata.is_regular_file(); }
+    virtual ErrorOr<RefPtr<Memory::PhysicalPage>> shareable_physical_page(size_t page_index) override;
 
 private:
     TmpFSInode(TmpFS& fs, const InodeMetadata& metadata, WeakPtr<TmpFSInode> parent);
@@ -77,10 +79,17 @@ private:
 
     Child* find_child_by_name(StringView);
 
+    ErrorOr<NonnullRefPtr<Memory::PhysicalPage>> ensure_page(size_t page_index, off_t file_size);
+    void try_allocate_huge_page(size_t page_index);
+    void zero_page_tail(off_t file_size);
+
     InodeMetadata m_metadata;
     WeakPtr<TmpFSInode> m_parent;
 
-    OwnPtr<KBuffer> m_content;
+    // The contents of a regular file live in physical pages, which shared mappings of the file use directly.
+    // Pages that haven't been written to yet are null and read as zeroes. Large files may have whole huge
+    // pages allocated past their end, so there can be more pages than the file size needs.
+    Vector<RefPtr<Memory::PhysicalPage>> m_pages;
 
     Child::List m_children;
 };
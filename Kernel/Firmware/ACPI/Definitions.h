@@ -304,6 +304,62 @@ struct [[gnu::packed]] MADT {
     MADTEntryHeader entries[];
 };
 
+// https://uefi.org/specs/ACPI/6.4/05_ACPI_Software_Programming_Model/ACPI_Software_Programming_Model.html#static-resource-affinity-table-srat
+enum class SRATEntryType {
+    ProcessorLocalAPICAffinity = 0x0,
+    MemoryAffinity = 0x1,
+    ProcessorLocalX2APICAffinity = 0x2,
+};
+
+struct [[gnu::packed]] SRATEntryHeader {
+    u8 type;
+    u8 length;
+};
+
+namespace SRATEntries {
+
+// https://uefi.org/specs/ACPI/6.4/05_ACPI_Software_Programming_Model/ACPI_Software_Programming_Model.html#processor-local-apic-sapic-affinity-structure
+struct [[gnu::packed]] ProcessorLocalAPICAffinity {
+    SRATEntryHeader h;
+    u8 proximity_domain_low;
+    u8 apic_id;
+    u32 flags;
+    u8 local_sapic_eid;
+    u8 proximity_domain_high[3];
+    u32 clock_domain;
+};
+
+// https://uefi.org/specs/ACPI/6.4/05_ACPI_Software_Programming_Model/ACPI_Software_Programming_Model.html#memory-affinity-structure
+struct [[gnu::packed]] MemoryAffinity {
+    SRATEntryHeader h;
+    u32 proximity_domain;
+    u16 reserved1;
+    u64 base_address;
+    u64 length;
+    u32 reserved2;
+    u32 flags;
+    u64 reserved3;
+};
+
+// https://uefi.org/specs/ACPI/6.4/05_ACPI_Software_Programming_Model/ACPI_Software_Programming_Model.html#processor-local-x2apic-affinity-structure
+struct [[gnu::packed]] ProcessorLocalX2APICAffinity {
+    SRATEntryHeader h;
+    u16 reserved1;
+    u32 proximity_domain;
+    u32 x2apic_id;
+    u32 flags;
+    u32 clock_domain;
+    u32 reserved2;
+};
+}
+
+struct [[gnu::packed]] SRAT {
+    SDTHeader h;
+    u32 reserved1;
+    u64 reserved2;
+    SRATEntryHeader entries[];
+};
+
 struct [[gnu::packed]] AMLTable {
     SDTHeader h;
     char aml_code[];
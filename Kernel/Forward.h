@@ -12,6 +12,7 @@
 namespace Kernel {
 
 class BlockDevice;
+class ByteRingBuffer;
 class CharacterDevice;
 class Coredump;
 class Custody;
@@ -22,7 +23,7 @@ class DevTmpFSPtsDirectoryInode;
 class DevTmpFSRootDirectoryInode;
 class Device;
 class DiskCache;
-class DoubleBuffer;
+class EventPoll;
 class File;
 class OpenFileDescription;
 class FileSystem;
@@ -7,6 +7,7 @@
 #include <AK/JsonObjectSerializer.h>
 #include <AK/Try.h>
 #include <AK/UBSanitizer.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <Kernel/Arch/x86/InterruptDisabler.h>
 #include <Kernel/Arch/x86/ProcessorInfo.h>
 #include <Kernel/Bus/PCI/API.h>
@@ -67,6 +68,14 @@ private:
             TRY(obj.add("link_speed", adapter.link_speed()));
             TRY(obj.add("link_full_duplex", adapter.link_full_duplex()));
             TRY(obj.add("mtu", adapter.mtu()));
+            TRY(obj.add("tx_checksum_offload", has_flag(adapter.offloads(), NetworkOffload::TXChecksum)));
+            TRY(obj.add("rx_checksum_offload", has_flag(adapter.offloads(), NetworkOffload::RXChecksum)));
+            TRY(obj.add("segmentation_offload", has_flag(adapter.offloads(), NetworkOffload::TCPSegmentation)));
+            if (auto pool = adapter.packet_buffer_pool()) {
+                TRY(obj.add("packet_buffers", pool->buffer_count()));
+                TRY(obj.add("packet_buffers_free", pool->free_buffer_count()));
+                TRY(obj.add("packet_buffer_fallback_allocations", pool->fallback_allocations()));
+            }
             TRY(obj.finish());
             return {};
         }));
@@ -100,16 +109,25 @@ private:
     }
 };
 
-class ProcFSTCP final : public ProcFSGlobalInformation {
+class ProcFSTCP final : public ProcFSGlobalRecordsInformation {
 public:
     static NonnullRefPtr<ProcFSTCP> must_create();
 
 private:
     ProcFSTCP();
-    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    virtual ErrorOr<bool> try_generate_records(KBufferBuilder& builder, u64& cursor) override
     {
-        auto array = TRY(JsonArraySerializer<>::try_create(builder));
-        TRY(TCPSocket::try_for_each([&array](auto& socket) -> ErrorOr<void> {
+        auto array = TRY(ProcFSJsonArrayChunk::try_create(builder, cursor == 0));
+        auto first_record = cursor;
+        u64 index = 0;
+        bool has_more_records = false;
+        TRY(TCPSocket::try_for_each([&](auto& socket) -> ErrorOr<void> {
+            if (index++ < first_record || has_more_records)
+                return {};
+            if (array.is_full()) {
+                has_more_records = true;
+                return {};
+            }
             auto obj = TRY(array.add_object());
             auto local_address = socket.local_address().to_string().release_value_but_fixme_should_propagate_errors();
             TRY(obj.add("local_address", local_address->view()));
@@ -124,29 +142,48 @@ private:
             TRY(obj.add("bytes_in", socket.bytes_in()));
             TRY(obj.add("packets_out", socket.packets_out()));
             TRY(obj.add("bytes_out", socket.bytes_out()));
+            TRY(obj.add("congestion_window", socket.congestion_window()));
+            TRY(obj.add("slow_start_threshold", socket.slow_start_threshold()));
+            TRY(obj.add("send_window_size", socket.send_window_size()));
+            TRY(obj.add("send_mss", socket.send_mss()));
+            TRY(obj.add("smoothed_rtt_us", socket.smoothed_rtt().to_microseconds()));
+            TRY(obj.add("retransmit_timeout_ms", socket.retransmit_timeout().to_milliseconds()));
+            TRY(obj.add("window_scaling", socket.is_window_scaling_enabled()));
+            TRY(obj.add("sack_permitted", socket.is_sack_permitted()));
+            TRY(obj.add("retransmitted_packets", socket.retransmitted_packets()));
             if (Process::current().is_superuser() || Process::current().uid() == socket.origin_uid()) {
                 TRY(obj.add("origin_pid", socket.origin_pid().value()));
                 TRY(obj.add("origin_uid", socket.origin_uid().value()));
                 TRY(obj.add("origin_gid", socket.origin_gid().value()));
             }
             TRY(obj.finish());
+            ++cursor;
             return {};
         }));
-        TRY(array.finish());
-        return {};
+        TRY(array.finish(has_more_records));
+        return has_more_records;
     }
 };
 
-class ProcFSLocalNet final : public ProcFSGlobalInformation {
+class ProcFSLocalNet final : public ProcFSGlobalRecordsInformation {
 public:
     static NonnullRefPtr<ProcFSLocalNet> must_create();
 
 private:
     ProcFSLocalNet();
-    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    virtual ErrorOr<bool> try_generate_records(KBufferBuilder& builder, u64& cursor) override
     {
-        auto array = TRY(JsonArraySerializer<>::try_create(builder));
-        TRY(LocalSocket::try_for_each([&array](auto& socket) -> ErrorOr<void> {
+        auto array = TRY(ProcFSJsonArrayChunk::try_create(builder, cursor == 0));
+        auto first_record = cursor;
+        u64 index = 0;
+        bool has_more_records = false;
+        TRY(LocalSocket::try_for_each([&](auto& socket) -> ErrorOr<void> {
+            if (index++ < first_record || has_more_records)
+                return {};
+            if (array.is_full()) {
+                has_more_records = true;
+                return {};
+            }
             auto obj = TRY(array.add_object());
             TRY(obj.add("path", socket.socket_path()));
             TRY(obj.add("origin_pid", socket.origin_pid().value()));
@@ -156,23 +193,33 @@ private:
             TRY(obj.add("acceptor_uid", socket.acceptor_uid().value()));
             TRY(obj.add("acceptor_gid", socket.acceptor_gid().value()));
             TRY(obj.finish());
+            ++cursor;
             return {};
         }));
-        TRY(array.finish());
-        return {};
+        TRY(array.finish(has_more_records));
+        return has_more_records;
     }
 };
 
-class ProcFSUDP final : public ProcFSGlobalInformation {
+class ProcFSUDP final : public ProcFSGlobalRecordsInformation {
 public:
     static NonnullRefPtr<ProcFSUDP> must_create();
 
 private:
     ProcFSUDP();
-    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    virtual ErrorOr<bool> try_generate_records(KBufferBuilder& builder, u64& cursor) override
     {
-        auto array = TRY(JsonArraySerializer<>::try_create(builder));
-        TRY(UDPSocket::try_for_each([&array](auto& socket) -> ErrorOr<void> {
+        auto array = TRY(ProcFSJsonArrayChunk::try_create(builder, cursor == 0));
+        auto first_record = cursor;
+        u64 index = 0;
+        bool has_more_records = false;
+        TRY(UDPSocket::try_for_each([&](auto& socket) -> ErrorOr<void> {
+            if (index++ < first_record || has_more_records)
+                return {};
+            if (array.is_full()) {
+                has_more_records = true;
+                return {};
+            }
             auto obj = TRY(array.add_object());
             auto local_address = socket.local_address().to_string().release_value_but_fixme_should_propagate_errors();
             TRY(obj.add("local_address", local_address->view()));
@@ -186,10 +233,11 @@ private:
                 TRY(obj.add("origin_gid", socket.origin_gid().value()));
             }
             TRY(obj.finish());
+            ++cursor;
             return {};
         }));
-        TRY(array.finish());
-        return {};
+        TRY(array.finish(has_more_records));
+        return has_more_records;
     }
 };
 
@@ -250,15 +298,15 @@ UNMAP_AFTER_INIT ProcFSARP::ProcFSARP()
 {
 }
 UNMAP_AFTER_INIT ProcFSTCP::ProcFSTCP()
-    : ProcFSGlobalInformation("tcp"sv)
+    : ProcFSGlobalRecordsInformation("tcp"sv)
 {
 }
 UNMAP_AFTER_INIT ProcFSLocalNet::ProcFSLocalNet()
-    : ProcFSGlobalInformation("local"sv)
+    : ProcFSGlobalRecordsInformation("local"sv)
 {
 }
 UNMAP_AFTER_INIT ProcFSUDP::ProcFSUDP()
-    : ProcFSGlobalInformation("udp"sv)
+    : ProcFSGlobalRecordsInformation("udp"sv)
 {
 }
 UNMAP_AFTER_INIT ProcFSNetworkDirectory::ProcFSNetworkDirectory(const ProcFSRootDirectory& parent_directory)
@@ -417,6 +465,12 @@ private:
         TRY(json.add("user_physical_uncommitted", system_memory.user_physical_pages_uncommitted));
         TRY(json.add("super_physical_allocated", system_memory.super_physical_pages_used));
         TRY(json.add("super_physical_available", system_memory.super_physical_pages - system_memory.super_physical_pages_used));
+        TRY(json.add("user_physical_reclaimed", system_memory.user_physical_pages_reclaimed));
+        TRY(json.add("huge_pages_mapped", system_memory.huge_pages_mapped));
+        TRY(json.add("huge_pages_allocated", system_memory.huge_pages_allocated));
+        TRY(json.add("huge_page_allocation_failures", system_memory.huge_page_allocation_failures));
+        TRY(json.add("user_physical_zeroed", system_memory.user_physical_pages_zeroed));
+        TRY(json.add("zeroed_page_pool_hits", system_memory.zeroed_page_pool_hits));
         TRY(json.add("kmalloc_call_count", stats.kmalloc_call_count));
         TRY(json.add("kfree_call_count", stats.kfree_call_count));
         TRY(json.finish());
@@ -563,6 +617,143 @@ private:
         return {};
     }
 };
+
+// The same information as /proc/all, but as fixed-size binary records that are cheap to
+// generate and parse. Unlike /proc/all this doesn't hold the scheduler lock while generating,
+// the per-thread counters are read as they are and the times come from per-processor totals.
+class ProcFSOverallProcessesBinary final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSOverallProcessesBinary> must_create();
+
+private:
+    ProcFSOverallProcessesBinary();
+
+    template<typename Record, typename... Strings>
+    static ErrorOr<void> append_record(KBufferBuilder& builder, Record& record, Strings... strings)
+    {
+        Array<StringView, sizeof...(Strings)> all_strings { strings... };
+        record.header.size = sizeof(Record);
+        for (auto string : all_strings)
+            record.header.size += string.length();
+        TRY(builder.append_bytes({ &record, sizeof(Record) }));
+        for (auto string : all_strings)
+            TRY(builder.append_bytes(string.bytes()));
+        return {};
+    }
+
+    static StringView truncated(StringView string)
+    {
+        return string.substring_view(0, min(string.length(), NumericLimits<u16>::max()));
+    }
+
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    {
+        auto total_time_scheduled = Scheduler::get_total_time_scheduled();
+        ProcessStatisticsHeader header {
+            .version = PROCESS_STATISTICS_VERSION,
+            .reserved = 0,
+            .total_time = total_time_scheduled.total,
+            .total_time_kernel = total_time_scheduled.total_kernel,
+        };
+        TRY(builder.append_bytes({ &header, sizeof(header) }));
+
+        auto build_thread = [&](Thread const& thread) -> ErrorOr<void> {
+            ProcessStatisticsThreadRecord record {};
+            record.header.type = ProcessStatisticsRecordType::Thread;
+            record.tid = thread.tid().value();
+            record.times_scheduled = thread.times_scheduled();
+            record.time_user = thread.time_in_user();
+            record.time_kernel = thread.time_in_kernel();
+            record.cpu = thread.cpu();
+            record.priority = thread.priority();
+            record.syscall_count = thread.syscall_count();
+            record.inode_faults = thread.inode_faults();
+            record.zero_faults = thread.zero_faults();
+            record.cow_faults = thread.cow_faults();
+            record.file_read_bytes = thread.file_read_bytes();
+            record.file_write_bytes = thread.file_write_bytes();
+            record.unix_socket_read_bytes = thread.unix_socket_read_bytes();
+            record.unix_socket_write_bytes = thread.unix_socket_write_bytes();
+            record.ipv4_socket_read_bytes = thread.ipv4_socket_read_bytes();
+            record.ipv4_socket_write_bytes = thread.ipv4_socket_write_bytes();
+
+            // NOTE: The thread's lock is only needed to keep its name alive while we copy it.
+            SpinlockLocker locker(thread.get_lock());
+            auto name = truncated(thread.name());
+            auto state = thread.state_string();
+            record.name_length = name.length();
+            record.state_length = state.length();
+            return append_record(builder, record, name, state);
+        };
+
+        auto build_process = [&](Process const& process) -> ErrorOr<void> {
+            StringBuilder pledge_builder;
+            StringView veil;
+            if (process.is_user_process()) {
+#define __ENUMERATE_PLEDGE_PROMISE(promise)    \
+    if (process.has_promised(Pledge::promise)) \
+        TRY(pledge_builder.try_append(#promise " "));
+                ENUMERATE_PLEDGE_PROMISES
+#undef __ENUMERATE_PLEDGE_PROMISE
+
+                switch (process.veil_state()) {
+                case VeilState::None:
+                    veil = "None"sv;
+                    break;
+                case VeilState::Dropped:
+                    veil = "Dropped"sv;
+                    break;
+                case VeilState::Locked:
+                    veil = "Locked"sv;
+                    break;
+                }
+            }
+
+            OwnPtr<KString> executable;
+            if (process.executable())
+                executable = TRY(process.executable()->try_serialize_absolute_path());
+            auto name = truncated(process.name());
+            auto executable_path = truncated(executable ? executable->view() : ""sv);
+            auto tty = truncated(process.tty() ? process.tty()->tty_name().view() : "notty"sv);
+
+            ProcessStatisticsProcessRecord record {};
+            record.header.type = ProcessStatisticsRecordType::Process;
+            record.pid = process.pid().value();
+            record.pgid = process.tty() ? process.tty()->pgid().value() : 0;
+            record.pgp = process.pgid().value();
+            record.sid = process.sid().value();
+            record.uid = process.uid().value();
+            record.gid = process.gid().value();
+            record.ppid = process.ppid().value();
+            record.nfds = process.fds().with_shared([](auto& fds) { return fds.open_count(); });
+            record.kernel = process.is_kernel_process();
+            record.dumpable = process.is_dumpable();
+            record.amount_virtual = process.address_space().amount_virtual();
+            record.amount_resident = process.address_space().amount_resident();
+            record.amount_dirty_private = process.address_space().amount_dirty_private();
+            record.amount_clean_inode = TRY(process.address_space().amount_clean_inode());
+            record.amount_shared = process.address_space().amount_shared();
+            record.amount_purgeable_volatile = process.address_space().amount_purgeable_volatile();
+            record.amount_purgeable_nonvolatile = process.address_space().amount_purgeable_nonvolatile();
+            record.name_length = name.length();
+            record.executable_length = executable_path.length();
+            record.tty_length = tty.length();
+            record.pledge_length = pledge_builder.length();
+            record.veil_length = veil.length();
+            TRY(append_record(builder, record, name, executable_path, tty, pledge_builder.string_view(), veil));
+
+            return process.try_for_each_thread([&](Thread const& thread) { return build_thread(thread); });
+        };
+
+        TRY(build_process(*Scheduler::colonel()));
+        return Process::all_instances().with([&](auto& processes) -> ErrorOr<void> {
+            for (auto& process : processes)
+                TRY(build_process(process));
+            return {};
+        });
+    }
+};
+
 class ProcFSCPUInformation final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSCPUInformation> must_create();
@@ -605,6 +796,51 @@ private:
         return {};
     }
 };
+class ProcFSSchedulerLoad final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSSchedulerLoad> must_create();
+
+private:
+    ProcFSSchedulerLoad();
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    {
+        auto array = TRY(JsonArraySerializer<>::try_create(builder));
+        TRY(Scheduler::try_for_each_processor_load([&](ProcessorSchedulingLoad const& load) -> ErrorOr<void> {
+            auto obj = TRY(array.add_object());
+            TRY(obj.add("processor", load.processor_id));
+            TRY(obj.add("runnable_threads", load.runnable_threads));
+            TRY(obj.add("pulled_threads", load.pulled_threads));
+            TRY(obj.add("stolen_threads", load.stolen_threads));
+            TRY(obj.add("idle_time", Processor::by_id(load.processor_id).time_spent_idle()));
+            TRY(obj.finish());
+            return {};
+        }));
+        TRY(array.finish());
+        return {};
+    }
+};
+class ProcFSMutexContention final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSMutexContention> must_create();
+
+private:
+    ProcFSMutexContention();
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    {
+        auto statistics = TRY(Mutex::contention_statistics());
+        auto array = TRY(JsonArraySerializer<>::try_create(builder));
+        for (auto& lock_statistics : statistics) {
+            auto obj = TRY(array.add_object());
+            TRY(obj.add("name", lock_statistics.name));
+            TRY(obj.add("contended", lock_statistics.contended_count));
+            TRY(obj.add("acquired_by_spinning", lock_statistics.acquired_by_spinning_count));
+            TRY(obj.add("blocked", lock_statistics.blocked_count));
+            TRY(obj.finish());
+        }
+        TRY(array.finish());
+        return {};
+    }
+};
 class ProcFSDmesg final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSDmesg> must_create();
@@ -790,6 +1026,25 @@ private:
     }
 };
 
+class ProcFSProfileStream final : public ProcFSGlobalInformation {
+public:
+    static NonnullRefPtr<ProcFSProfileStream> must_create();
+
+    virtual mode_t required_mode() const override { return 0400; }
+
+private:
+    ProcFSProfileStream();
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override
+    {
+        // NOTE: Every open hands out what was profiled since the previous one and drops it from the
+        //       buffer, so /proc/profile only has what no reader of this has picked up yet.
+        if (!g_global_perf_events)
+            return ENOENT;
+        TRY(g_global_perf_events->drain_to_json(builder));
+        return {};
+    }
+};
+
 class ProcFSKernelBase final : public ProcFSGlobalInformation {
 public:
     static NonnullRefPtr<ProcFSKernelBase> must_create();
@@ -827,10 +1082,22 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSOverallProcesses> ProcFSOverallProcesses::m
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSOverallProcesses).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSOverallProcessesBinary> ProcFSOverallProcessesBinary::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSOverallProcessesBinary).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSCPUInformation> ProcFSCPUInformation::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSCPUInformation).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSSchedulerLoad> ProcFSSchedulerLoad::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSSchedulerLoad).release_nonnull();
+}
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSMutexContention> ProcFSMutexContention::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSMutexContention).release_nonnull();
+}
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSDmesg> ProcFSDmesg::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSDmesg).release_nonnull();
@@ -867,6 +1134,10 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSProfile> ProcFSProfile::must_create()
 {
     return adopt_ref_if_nonnull(new (nothrow) ProcFSProfile).release_nonnull();
 }
+UNMAP_AFTER_INIT NonnullRefPtr<ProcFSProfileStream> ProcFSProfileStream::must_create()
+{
+    return adopt_ref_if_nonnull(new (nothrow) ProcFSProfileStream).release_nonnull();
+}
 
 UNMAP_AFTER_INIT NonnullRefPtr<ProcFSKernelBase> ProcFSKernelBase::must_create()
 {
@@ -893,10 +1164,22 @@ UNMAP_AFTER_INIT ProcFSOverallProcesses::ProcFSOverallProcesses()
     : ProcFSGlobalInformation("all"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSOverallProcessesBinary::ProcFSOverallProcessesBinary()
+    : ProcFSGlobalInformation("all_binary"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSCPUInformation::ProcFSCPUInformation()
     : ProcFSGlobalInformation("cpuinfo"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSSchedulerLoad::ProcFSSchedulerLoad()
+    : ProcFSGlobalInformation("scheduler"sv)
+{
+}
+UNMAP_AFTER_INIT ProcFSMutexContention::ProcFSMutexContention()
+    : ProcFSGlobalInformation("mutex_contention"sv)
+{
+}
 UNMAP_AFTER_INIT ProcFSDmesg::ProcFSDmesg()
     : ProcFSGlobalInformation("dmesg"sv)
 {
@@ -933,6 +1216,10 @@ UNMAP_AFTER_INIT ProcFSProfile::ProcFSProfile()
     : ProcFSGlobalInformation("profile"sv)
 {
 }
+UNMAP_AFTER_INIT ProcFSProfileStream::ProcFSProfileStream()
+    : ProcFSGlobalInformation("profile_stream"sv)
+{
+}
 
 UNMAP_AFTER_INIT ProcFSKernelBase::ProcFSKernelBase()
     : ProcFSGlobalInformation("kernel_base"sv)
@@ -966,7 +1253,10 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSRootDirectory> ProcFSRootDirectory::must_cr
     directory->m_components.append(ProcFSMemoryStatus::must_create());
     directory->m_components.append(ProcFSSystemStatistics::must_create());
     directory->m_components.append(ProcFSOverallProcesses::must_create());
+    directory->m_components.append(ProcFSOverallProcessesBinary::must_create());
     directory->m_components.append(ProcFSCPUInformation::must_create());
+    directory->m_components.append(ProcFSSchedulerLoad::must_create());
+    directory->m_components.append(ProcFSMutexContention::must_create());
     directory->m_components.append(ProcFSDmesg::must_create());
     directory->m_components.append(ProcFSInterrupts::must_create());
     directory->m_components.append(ProcFSKeymap::must_create());
@@ -975,6 +1265,7 @@ UNMAP_AFTER_INIT NonnullRefPtr<ProcFSRootDirectory> ProcFSRootDirectory::must_cr
     directory->m_components.append(ProcFSCommandLine::must_create());
     directory->m_components.append(ProcFSSystemMode::must_create());
     directory->m_components.append(ProcFSProfile::must_create());
+    directory->m_components.append(ProcFSProfileStream::must_create());
     directory->m_components.append(ProcFSKernelBase::must_create());
 
     directory->m_components.append(ProcFSNetworkDirectory::must_create(*directory));
@@ -27,7 +27,8 @@ ErrorOr<size_t> FramebufferDevice::buffer_length(size_t head) const
     // so if we happen to accidentally have a value different than 0, assert.
     VERIFY(head == 0);
     SpinlockLocker locker(m_resolution_lock);
-    return display_info().rect.width * display_info().rect.height * 4;
+    // Both buffers are mapped, so that WindowServer can flip between them.
+    return display_info().rect.width * display_info().rect.height * 4 * 2;
 }
 ErrorOr<size_t> FramebufferDevice::pitch(size_t head) const
 {
@@ -62,7 +63,10 @@ ErrorOr<size_t> FramebufferDevice::vertical_offset(size_t head) const
     // We take care to verify this at the GenericFramebufferDevice::ioctl method
     // so if we happen to accidentally have a value different than 0, assert.
     VERIFY(head == 0);
-    return 0;
+    if (m_last_set_buffer_index.load() == 0)
+        return 0;
+    SpinlockLocker locker(m_resolution_lock);
+    return display_info().rect.height;
 }
 ErrorOr<bool> FramebufferDevice::vertical_offsetted(size_t head) const
 {
@@ -70,7 +74,7 @@ ErrorOr<bool> FramebufferDevice::vertical_offsetted(size_t head) const
     // We take care to verify this at the GenericFramebufferDevice::ioctl method
     // so if we happen to accidentally have a value different than 0, assert.
     VERIFY(head == 0);
-    return false;
+    return m_last_set_buffer_index.load() != 0;
 }
 
 ErrorOr<void> FramebufferDevice::set_head_resolution(size_t head, size_t width, size_t height, size_t)
@@ -95,9 +99,18 @@ ErrorOr<void> FramebufferDevice::set_head_resolution(size_t head, size_t width,
     TRY(create_framebuffer());
     return {};
 }
-ErrorOr<void> FramebufferDevice::set_head_buffer(size_t, bool)
+ErrorOr<void> FramebufferDevice::set_head_buffer(size_t head, bool second_buffer)
 {
-    return Error::from_errno(ENOTSUP);
+    // Note: This FramebufferDevice class doesn't support multihead setup.
+    // We take care to verify this at the GenericFramebufferDevice::ioctl method
+    // so if we happen to accidentally have a value different than 0, assert.
+    VERIFY(head == 0);
+    int buffer_index = second_buffer ? 1 : 0;
+    m_last_set_buffer_index.store(buffer_index);
+    // While a console is shown, the flip takes effect once writes are activated again.
+    if (m_are_writes_active)
+        set_buffer(buffer_index);
+    return {};
 }
 ErrorOr<void> FramebufferDevice::flush_head_buffer(size_t)
 {
@@ -174,7 +187,7 @@ ErrorOr<void> FramebufferDevice::create_framebuffer()
     auto& info = display_info();
     m_buffer_size = calculate_framebuffer_size(info.rect.width, info.rect.height);
     auto region_name = TRY(KString::formatted("VirtGPU FrameBuffer #{}", m_scanout.value()));
-    m_framebuffer = TRY(MM.allocate_kernel_region(m_buffer_size * 2, region_name->view(), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+    m_framebuffer = TRY(MM.allocate_kernel_region(TRY(Memory::page_round_up(m_buffer_size * 2)), region_name->view(), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
     auto write_sink_page = TRY(MM.allocate_user_physical_page(Memory::MemoryManager::ShouldZeroFill::No));
     auto num_needed_pages = m_framebuffer->vmobject().page_count();
 
@@ -37,10 +37,10 @@ public:
     size_t height() const { return display_info().rect.height; }
     size_t pitch() const { return display_info().rect.width * 4; }
 
+    // The back buffer directly follows the front buffer, which is where WindowServer expects it to be when flipping.
     static size_t calculate_framebuffer_size(size_t width, size_t height)
     {
-        // VirtIO resources can only map on page boundaries!
-        return Memory::page_round_up(sizeof(u32) * width * height).value();
+        return sizeof(u32) * width * height;
     }
 
     u8* framebuffer_data();
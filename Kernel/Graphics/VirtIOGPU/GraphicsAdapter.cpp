@@ -300,10 +300,11 @@ void GraphicsAdapter::ensure_backing_storage(ResourceID resource_id, Memory::Reg
 {
     VERIFY(m_operation_lock.is_locked());
 
-    VERIFY(buffer_offset % PAGE_SIZE == 0);
-    VERIFY(buffer_length % PAGE_SIZE == 0);
+    // The buffer doesn't have to start or end on a page boundary, as memory entries may cover parts of pages.
+    VERIFY(buffer_length > 0);
     auto first_page_index = buffer_offset / PAGE_SIZE;
-    size_t num_mem_regions = buffer_length / PAGE_SIZE;
+    auto last_page_index = (buffer_offset + buffer_length - 1) / PAGE_SIZE;
+    size_t num_mem_regions = last_page_index - first_page_index + 1;
 
     auto writer = create_scratchspace_writer();
     auto& request = writer.append_structure<Protocol::ResourceAttachBacking>();
@@ -313,9 +314,12 @@ void GraphicsAdapter::ensure_backing_storage(ResourceID resource_id, Memory::Reg
     request.resource_id = resource_id.value();
     request.num_entries = num_mem_regions;
     for (size_t i = 0; i < num_mem_regions; ++i) {
+        auto page_offset = (first_page_index + i) * PAGE_SIZE;
+        auto entry_start = max(page_offset, buffer_offset);
+        auto entry_end = min(page_offset + PAGE_SIZE, buffer_offset + buffer_length);
         auto& memory_entry = writer.append_structure<Protocol::MemoryEntry>();
-        memory_entry.address = region.physical_page(first_page_index + i)->paddr().get();
-        memory_entry.length = PAGE_SIZE;
+        memory_entry.address = region.physical_page(first_page_index + i)->paddr().offset(entry_start - page_offset).get();
+        memory_entry.length = entry_end - entry_start;
     }
 
     auto& response = writer.append_structure<Protocol::ControlHeader>();
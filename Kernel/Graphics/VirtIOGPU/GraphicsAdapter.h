@@ -95,7 +95,7 @@ private:
     virtual void disable_consoles() override;
 
     virtual bool modesetting_capable() const override { return false; }
-    virtual bool double_framebuffering_capable() const override { return false; }
+    virtual bool double_framebuffering_capable() const override { return true; }
 
     virtual bool try_to_set_resolution(size_t, size_t, size_t) override { return false; }
     virtual bool set_y_offset(size_t, size_t) override { return false; }
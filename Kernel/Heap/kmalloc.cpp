@@ -6,6 +6,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/Types.h>
+#include <Kernel/Arch/x86/InterruptDisabler.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
@@ -120,6 +121,21 @@ public:
     size_t slab_size() const { return m_slab_size; }
 
     void* allocate()
+    {
+        auto* ptr = take_slab();
+        memset(ptr, KMALLOC_SCRUB_BYTE, m_slab_size);
+        return ptr;
+    }
+
+    void deallocate(void* ptr)
+    {
+        memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
+        return_slab(ptr);
+    }
+
+    // NOTE: These don't scrub the slab, which lets the processor magazines move
+    //       slabs between themselves and the slabheap without touching their contents.
+    void* take_slab()
     {
         if (m_usable_blocks.is_empty()) {
             // FIXME: This allocation wastes `block_size` bytes due to the implementation of kmalloc_aligned().
@@ -136,15 +152,11 @@ public:
         auto* ptr = block->allocate();
         if (block->is_full())
             m_full_blocks.append(*block);
-
-        memset(ptr, KMALLOC_SCRUB_BYTE, m_slab_size);
         return ptr;
     }
 
-    void deallocate(void* ptr)
+    void return_slab(void* ptr)
     {
-        memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
-
         auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
@@ -168,6 +180,9 @@ public:
         return total;
     }
 
+    size_t usable_block_count() const { return m_usable_blocks.size_slow(); }
+    size_t full_block_count() const { return m_full_blocks.size_slow(); }
+
     bool try_purge()
     {
         bool did_purge = false;
@@ -388,7 +403,7 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    KmallocSlabheap slabheaps[KMALLOC_SLABHEAP_COUNT] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -396,11 +411,35 @@ struct KmallocGlobalData {
 READONLY_AFTER_INIT static KmallocGlobalData* g_kmalloc_global;
 alignas(KmallocGlobalData) static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalData)];
 
-static size_t g_kmalloc_call_count;
-static size_t g_kfree_call_count;
-static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// Every processor keeps a magazine of free slabs in front of each slabheap, so that most
+// small allocations and frees never have to take the global kmalloc lock. A magazine is
+// only ever touched by its own processor with interrupts disabled, and is refilled from
+// (or flushed back to) its slabheap in batches while holding the lock.
+static constexpr size_t KMALLOC_MAGAZINE_CAPACITY = 32;
+static constexpr size_t KMALLOC_MAGAZINE_BATCH_SIZE = KMALLOC_MAGAZINE_CAPACITY / 2;
+
+struct KmallocMagazine {
+    size_t slab_count { 0 };
+    void* slabs[KMALLOC_MAGAZINE_CAPACITY];
+
+    size_t allocation_count { 0 };
+    size_t free_count { 0 };
+    size_t refill_count { 0 };
+    size_t flush_count { 0 };
+};
+
+struct KmallocProcessorData {
+    KmallocMagazine magazines[KMALLOC_SLABHEAP_COUNT];
+
+    size_t kmalloc_call_count { 0 };
+    size_t kfree_call_count { 0 };
+    size_t nested_kfree_calls { 0 };
+};
+
+static Array<KmallocProcessorData*, ProcessorContainer {}.size()> s_processor_data;
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
@@ -423,18 +462,82 @@ UNMAP_AFTER_INIT void kmalloc_init()
     s_lock.initialize();
 }
 
+// NOTE: This must be called with interrupts disabled, so that we stay on the current processor.
+static KmallocProcessorData& kmalloc_processor_data()
+{
+    auto cpu = Processor::current_id();
+    VERIFY(cpu < s_processor_data.size());
+    if (!s_processor_data[cpu]) [[unlikely]] {
+        SpinlockLocker lock(s_lock);
+        s_processor_data[cpu] = new (g_kmalloc_global->allocate(sizeof(KmallocProcessorData))) KmallocProcessorData;
+    }
+    return *s_processor_data[cpu];
+}
+
+static size_t kmalloc_slabheap_index(size_t size)
+{
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        if (size <= g_kmalloc_global->slabheaps[i].slab_size())
+            return i;
+    }
+    return KMALLOC_SLABHEAP_COUNT;
+}
+
+static void* kmalloc_from_magazine(KmallocMagazine& magazine, KmallocSlabheap& slabheap)
+{
+    if (magazine.slab_count == 0) {
+        SpinlockLocker lock(s_lock);
+        VERIFY(!g_kmalloc_global->expansion_in_progress);
+        while (magazine.slab_count < KMALLOC_MAGAZINE_BATCH_SIZE)
+            magazine.slabs[magazine.slab_count++] = slabheap.take_slab();
+        ++magazine.refill_count;
+    }
+
+    ++magazine.allocation_count;
+    auto* ptr = magazine.slabs[--magazine.slab_count];
+    memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+    return ptr;
+}
+
+static void kfree_to_magazine(KmallocMagazine& magazine, KmallocSlabheap& slabheap, void* ptr)
+{
+    memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+
+    if (magazine.slab_count == KMALLOC_MAGAZINE_CAPACITY) {
+        SpinlockLocker lock(s_lock);
+        VERIFY(!g_kmalloc_global->expansion_in_progress);
+        while (magazine.slab_count > KMALLOC_MAGAZINE_CAPACITY - KMALLOC_MAGAZINE_BATCH_SIZE)
+            slabheap.return_slab(magazine.slabs[--magazine.slab_count]);
+        ++magazine.flush_count;
+    }
+
+    ++magazine.free_count;
+    magazine.slabs[magazine.slab_count++] = ptr;
+}
+
 void* kmalloc(size_t size)
 {
     kmalloc_verify_nospinlock_held();
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
 
-    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
-        dbgln("kmalloc({})", size);
-        Kernel::dump_backtrace();
-    }
+    void* ptr = nullptr;
+    {
+        InterruptDisabler disabler;
+        auto& processor_data = kmalloc_processor_data();
+        ++processor_data.kmalloc_call_count;
+
+        if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available) {
+            SpinlockLocker lock(s_lock);
+            dbgln("kmalloc({})", size);
+            Kernel::dump_backtrace();
+        }
 
-    void* ptr = g_kmalloc_global->allocate(size);
+        if (auto slabheap_index = kmalloc_slabheap_index(size); slabheap_index < KMALLOC_SLABHEAP_COUNT) {
+            ptr = kmalloc_from_magazine(processor_data.magazines[slabheap_index], g_kmalloc_global->slabheaps[slabheap_index]);
+        } else {
+            SpinlockLocker lock(s_lock);
+            ptr = g_kmalloc_global->allocate(size);
+        }
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -469,11 +572,12 @@ void kfree_sized(void* ptr, size_t size)
     VERIFY(size > 0);
 
     kmalloc_verify_nospinlock_held();
-    SpinlockLocker lock(s_lock);
-    ++g_kfree_call_count;
-    ++g_nested_kfree_calls;
+    InterruptDisabler disabler;
+    auto& processor_data = kmalloc_processor_data();
+    ++processor_data.kfree_call_count;
+    ++processor_data.nested_kfree_calls;
 
-    if (g_nested_kfree_calls == 1) {
+    if (processor_data.nested_kfree_calls == 1) {
         Thread* current_thread = Thread::current();
         if (!current_thread)
             current_thread = Processor::idle_thread();
@@ -483,8 +587,14 @@ void kfree_sized(void* ptr, size_t size)
         }
     }
 
-    g_kmalloc_global->deallocate(ptr, size);
-    --g_nested_kfree_calls;
+    if (auto slabheap_index = kmalloc_slabheap_index(size); slabheap_index < KMALLOC_SLABHEAP_COUNT) {
+        VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+        kfree_to_magazine(processor_data.magazines[slabheap_index], g_kmalloc_global->slabheaps[slabheap_index], ptr);
+    } else {
+        SpinlockLocker lock(s_lock);
+        g_kmalloc_global->deallocate(ptr, size);
+    }
+    --processor_data.nested_kfree_calls;
 }
 
 size_t kmalloc_good_size(size_t size)
@@ -576,11 +686,50 @@ void operator delete[](void* ptr, size_t size) noexcept
     return kfree_sized(ptr, size);
 }
 
+// NOTE: The magazines of other processors are read without synchronization, so the
+//       totals below may be slightly off, which is fine for statistics.
 void get_kmalloc_stats(kmalloc_stats& stats)
 {
     SpinlockLocker lock(s_lock);
     stats.bytes_allocated = g_kmalloc_global->allocated_bytes();
     stats.bytes_free = g_kmalloc_global->free_bytes();
-    stats.kmalloc_call_count = g_kmalloc_call_count;
-    stats.kfree_call_count = g_kfree_call_count;
+    stats.kmalloc_call_count = 0;
+    stats.kfree_call_count = 0;
+    for (auto const* processor_data : s_processor_data) {
+        if (!processor_data)
+            continue;
+        stats.kmalloc_call_count += processor_data->kmalloc_call_count;
+        stats.kfree_call_count += processor_data->kfree_call_count;
+        for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+            // Slabs sitting in a magazine are free as far as the callers of kmalloc are concerned.
+            auto cached_bytes = processor_data->magazines[i].slab_count * g_kmalloc_global->slabheaps[i].slab_size();
+            stats.bytes_allocated -= cached_bytes;
+            stats.bytes_free += cached_bytes;
+        }
+    }
+}
+
+void get_kmalloc_slabheap_stats(kmalloc_slabheap_stats (&stats)[KMALLOC_SLABHEAP_COUNT])
+{
+    SpinlockLocker lock(s_lock);
+    for (size_t i = 0; i < KMALLOC_SLABHEAP_COUNT; ++i) {
+        auto const& slabheap = g_kmalloc_global->slabheaps[i];
+        auto& slabheap_stats = stats[i];
+        slabheap_stats = {};
+        slabheap_stats.slab_size = slabheap.slab_size();
+        slabheap_stats.usable_block_count = slabheap.usable_block_count();
+        slabheap_stats.full_block_count = slabheap.full_block_count();
+        slabheap_stats.bytes_allocated = slabheap.allocated_bytes();
+        slabheap_stats.bytes_free = slabheap.free_bytes();
+        for (auto const* processor_data : s_processor_data) {
+            if (!processor_data)
+                continue;
+            auto const& magazine = processor_data->magazines[i];
+            slabheap_stats.cached_slab_count += magazine.slab_count;
+            slabheap_stats.allocation_count += magazine.allocation_count;
+            slabheap_stats.free_count += magazine.free_count;
+            slabheap_stats.magazine_refill_count += magazine.refill_count;
+            slabheap_stats.magazine_flush_count += magazine.flush_count;
+        }
+    }
 }
@@ -50,6 +50,22 @@ struct kmalloc_stats {
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
+static constexpr size_t KMALLOC_SLABHEAP_COUNT = 6;
+
+struct kmalloc_slabheap_stats {
+    size_t slab_size;
+    size_t usable_block_count;
+    size_t full_block_count;
+    size_t bytes_allocated;
+    size_t bytes_free;
+    size_t cached_slab_count;
+    size_t allocation_count;
+    size_t free_count;
+    size_t magazine_refill_count;
+    size_t magazine_flush_count;
+};
+void get_kmalloc_slabheap_stats(kmalloc_slabheap_stats (&)[KMALLOC_SLABHEAP_COUNT]);
+
 extern bool g_dump_kmalloc_stacks;
 
 inline void* operator new(size_t, void* p) { return p; }
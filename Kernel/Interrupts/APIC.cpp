@@ -10,6 +10,7 @@
 #include <AK/Types.h>
 #include <Kernel/Arch/x86/IO.h>
 #include <Kernel/Arch/x86/MSR.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/Arch/x86/ProcessorInfo.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Firmware/ACPI/Parser.h>
@@ -25,6 +26,7 @@
 #include <Kernel/Thread.h>
 #include <Kernel/Time/APICTimer.h>
 
+#define IRQ_APIC_PMI (0xfb - IRQ_VECTOR_BASE)
 #define IRQ_APIC_TIMER (0xfc - IRQ_VECTOR_BASE)
 #define IRQ_APIC_IPI (0xfd - IRQ_VECTOR_BASE)
 #define IRQ_APIC_ERR (0xfe - IRQ_VECTOR_BASE)
@@ -121,6 +123,37 @@ public:
 private:
 };
 
+class APICPerformanceCounterInterruptHandler final : public GenericInterruptHandler {
+public:
+    explicit APICPerformanceCounterInterruptHandler(u8 interrupt_vector)
+        : GenericInterruptHandler(interrupt_vector, true)
+    {
+    }
+    virtual ~APICPerformanceCounterInterruptHandler()
+    {
+    }
+
+    static void initialize(u8 interrupt_number)
+    {
+        auto* handler = new APICPerformanceCounterInterruptHandler(interrupt_number);
+        handler->register_interrupt_handler();
+    }
+
+    virtual bool handle_interrupt(const RegisterState&) override;
+
+    virtual bool eoi() override;
+
+    virtual HandlerType type() const override { return HandlerType::IRQHandler; }
+    virtual StringView purpose() const override { return "Performance Counter Overflow Handler"sv; }
+    virtual StringView controller() const override { return nullptr; }
+
+    virtual size_t sharing_devices_count() const override { return 0; }
+    virtual bool is_shared_handler() const override { return false; }
+    virtual bool is_sharing_with_others() const override { return false; }
+
+private:
+};
+
 bool APIC::initialized()
 {
     return s_apic.is_initialized();
@@ -507,6 +540,8 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
 
         // register IPI interrupt vector
         APICIPIInterruptHandler::initialize(IRQ_APIC_IPI);
+
+        APICPerformanceCounterInterruptHandler::initialize(IRQ_APIC_PMI);
     }
 
     if (!m_is_x2) {
@@ -669,6 +704,23 @@ bool APICIPIInterruptHandler::eoi()
     return true;
 }
 
+void APIC::set_performance_counter_interrupt_masked(bool masked)
+{
+    write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(IRQ_APIC_PMI + IRQ_VECTOR_BASE, 0) | (masked ? APIC_LVT_MASKED : 0));
+}
+
+bool APICPerformanceCounterInterruptHandler::handle_interrupt(const RegisterState& regs)
+{
+    PerformanceCounters::handle_overflow(regs);
+    return true;
+}
+
+bool APICPerformanceCounterInterruptHandler::eoi()
+{
+    APIC::the().eoi();
+    return true;
+}
+
 bool APICErrInterruptHandler::handle_interrupt(const RegisterState&)
 {
     dbgln("APIC: SMP error on CPU #{}", Processor::current_id());
@@ -47,6 +47,8 @@ public:
     u32 get_timer_current_count();
     u32 get_timer_divisor();
 
+    void set_performance_counter_interrupt_masked(bool);
+
 private:
     struct ICRReg {
         enum DeliveryMode {
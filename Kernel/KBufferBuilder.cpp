@@ -49,9 +49,9 @@ OwnPtr<KBuffer> KBufferBuilder::build()
     return move(m_buffer);
 }
 
-ErrorOr<KBufferBuilder> KBufferBuilder::try_create()
+ErrorOr<KBufferBuilder> KBufferBuilder::try_create(size_t initial_capacity)
 {
-    auto buffer = TRY(KBuffer::try_create_with_size(4 * MiB, Memory::Region::Access::ReadWrite));
+    auto buffer = TRY(KBuffer::try_create_with_size(initial_capacity, Memory::Region::Access::ReadWrite));
     return KBufferBuilder { move(buffer) };
 }
 
@@ -19,7 +19,7 @@ class KBufferBuilder {
 public:
     using OutputType = KBuffer;
 
-    static ErrorOr<KBufferBuilder> try_create();
+    static ErrorOr<KBufferBuilder> try_create(size_t initial_capacity = 4 * MiB);
 
     KBufferBuilder(KBufferBuilder&&) = default;
     KBufferBuilder& operator=(KBufferBuilder&&) = default;
@@ -45,6 +45,8 @@ public:
     bool flush();
     OwnPtr<KBuffer> build();
 
+    size_t length() const { return m_size; }
+
     ReadonlyBytes bytes() const
     {
         if (!m_buffer)
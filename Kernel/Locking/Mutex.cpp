@@ -10,10 +10,87 @@
 #include <Kernel/Locking/LockLocation.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Scheduler.h>
 #include <Kernel/Thread.h>
 
 namespace Kernel {
 
+// How often a contending thread checks on a running holder before giving up and blocking.
+static constexpr size_t max_spin_count = 4096;
+
+static constexpr size_t contention_statistics_slot_count = 128;
+static Spinlock s_contention_statistics_lock;
+static Mutex::ContentionStatistics s_contention_statistics[contention_statistics_slot_count];
+
+static void note_contention(StringView name, bool acquired_by_spinning)
+{
+    SpinlockLocker locker(s_contention_statistics_lock);
+    // NOTE: Once the table is full, the lock names that don't fit are simply not tracked.
+    auto start_index = name.hash() % contention_statistics_slot_count;
+    for (size_t i = 0; i < contention_statistics_slot_count; ++i) {
+        auto& slot = s_contention_statistics[(start_index + i) % contention_statistics_slot_count];
+        if (slot.contended_count != 0 && slot.name != name)
+            continue;
+        slot.name = name;
+        ++slot.contended_count;
+        if (acquired_by_spinning)
+            ++slot.acquired_by_spinning_count;
+        else
+            ++slot.blocked_count;
+        return;
+    }
+}
+
+ErrorOr<Vector<Mutex::ContentionStatistics>> Mutex::contention_statistics()
+{
+    Vector<ContentionStatistics> statistics;
+    TRY(statistics.try_ensure_capacity(contention_statistics_slot_count));
+    SpinlockLocker locker(s_contention_statistics_lock);
+    for (auto& slot : s_contention_statistics) {
+        if (slot.contended_count != 0)
+            statistics.unchecked_append(slot);
+    }
+    return statistics;
+}
+
+bool Mutex::is_contended_for(Thread const& current_thread, Mode mode) const
+{
+    VERIFY(m_lock.is_locked());
+    if (m_mode == Mode::Exclusive)
+        return m_holder != &current_thread;
+    return m_mode == Mode::Shared && mode == Mode::Exclusive;
+}
+
+void Mutex::spin_while_holder_is_running(Thread& current_thread, SpinlockLocker<Spinlock>& lock)
+{
+    // A holder that is running on another processor is likely to release the lock before we'd even be done
+    // blocking, so briefly spinning saves us both context switches. This only works when we know who is holding
+    // the lock, which we only do for exclusive locks.
+    if (Processor::count() < 2)
+        return;
+
+    size_t spin_count = 0;
+    while (spin_count < max_spin_count) {
+        if (m_mode != Mode::Exclusive || !m_holder || m_holder == &current_thread)
+            return;
+        RefPtr<Thread> holder = m_holder;
+        if (holder->state() != Thread::State::Running || holder->cpu() == Processor::current_id())
+            return;
+
+        auto release_count = m_release_count.load(AK::MemoryOrder::memory_order_acquire);
+        lock.unlock();
+        while (spin_count < max_spin_count
+            && m_release_count.load(AK::MemoryOrder::memory_order_acquire) == release_count
+            && holder->state() == Thread::State::Running) {
+            Processor::wait_check();
+            ++spin_count;
+        }
+        // NOTE: Let go of the holder before taking m_lock again, this may well have been the last reference to it.
+        holder = nullptr;
+        lock.lock();
+    }
+}
+
 void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
 {
     // NOTE: This may be called from an interrupt handler (not an IRQ handler)
@@ -25,6 +102,11 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     auto* current_thread = Thread::current();
 
     SpinlockLocker lock(m_lock);
+    if (is_contended_for(*current_thread, mode)) {
+        spin_while_holder_is_running(*current_thread, lock);
+        note_contention(m_name, !is_contended_for(*current_thread, mode));
+    }
+
     bool did_block = false;
     Mode current_mode = m_mode;
     switch (current_mode) {
@@ -197,7 +279,10 @@ void Mutex::unlock()
     if (m_times_locked == 0) {
         VERIFY(current_mode == Mode::Exclusive ? !m_holder : m_shared_holders == 0);
 
+        if (current_mode == Mode::Exclusive)
+            take_back_lent_priority(*current_thread);
         m_mode = Mode::Unlocked;
+        m_release_count.fetch_add(1, AK::MemoryOrder::memory_order_release);
         unblock_waiters(current_mode);
     }
 }
@@ -210,6 +295,8 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock>& l
     VERIFY(!blocked_thread_list.contains(current_thread));
     blocked_thread_list.append(current_thread);
 
+    lend_priority_to_holder(current_thread);
+
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waiting...", this, m_name);
     current_thread.block(*this, lock, requested_locks);
     dbgln_if(LOCK_TRACE_DEBUG, "Mutex::lock @ {} ({}) waited", this, m_name);
@@ -218,6 +305,25 @@ void Mutex::block(Thread& current_thread, Mode mode, SpinlockLocker<Spinlock>& l
     blocked_thread_list.remove(current_thread);
 }
 
+void Mutex::lend_priority_to_holder(Thread const& waiter)
+{
+    // Priority inheritance: Don't let a real-time thread wait for a less important holder that keeps getting preempted.
+    // NOTE: We only know who is holding exclusive locks, and the priority is not passed further along a chain of locks.
+    VERIFY(m_lock.is_locked());
+    if (m_mode != Mode::Exclusive || !m_holder)
+        return;
+    auto priority = waiter.effective_realtime_priority();
+    if (priority > m_holder->effective_realtime_priority())
+        Scheduler::set_inherited_realtime_priority(*m_holder, priority);
+}
+
+void Mutex::take_back_lent_priority(Thread& thread)
+{
+    // FIXME: A thread holding more than one contended lock loses the priority lent to it for the others here as well.
+    if (thread.inherited_realtime_priority() != 0)
+        Scheduler::set_inherited_realtime_priority(thread, 0);
+}
+
 void Mutex::unblock_waiters(Mode previous_mode)
 {
     VERIFY(m_times_locked == 0);
@@ -242,10 +348,20 @@ void Mutex::unblock_waiters(Mode previous_mode)
         return true;
     };
     auto unblock_exclusive = [&]() {
-        if (auto* next_exclusive_thread = m_blocked_threads_list_exclusive.first()) {
+        // Real-time threads go first, in the order of their priority.
+        Thread* next_exclusive_thread = nullptr;
+        for (auto& thread : m_blocked_threads_list_exclusive) {
+            if (!next_exclusive_thread || thread.effective_realtime_priority() > next_exclusive_thread->effective_realtime_priority())
+                next_exclusive_thread = &thread;
+        }
+        if (next_exclusive_thread) {
             m_mode = Mode::Exclusive;
             m_times_locked = next_exclusive_thread->unblock_from_mutex(*this);
             m_holder = next_exclusive_thread;
+            for (auto& thread : m_blocked_threads_list_exclusive)
+                lend_priority_to_holder(thread);
+            for (auto& thread : m_blocked_threads_list_shared)
+                lend_priority_to_holder(thread);
             return true;
         }
         return false;
@@ -279,11 +395,13 @@ auto Mutex::force_unlock_exclusive_if_locked(u32& lock_count_to_restore) -> Mode
 #if LOCK_DEBUG
         m_holder->holding_lock(*this, -(int)m_times_locked, {});
 #endif
+        take_back_lent_priority(*current_thread);
         m_holder = nullptr;
         VERIFY(m_times_locked > 0);
         lock_count_to_restore = m_times_locked;
         m_times_locked = 0;
         m_mode = Mode::Unlocked;
+        m_release_count.fetch_add(1, AK::MemoryOrder::memory_order_release);
         unblock_waiters(Mode::Exclusive);
         break;
     }
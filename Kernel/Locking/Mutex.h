@@ -11,6 +11,7 @@
 #include <AK/Atomic.h>
 #include <AK/HashMap.h>
 #include <AK/Types.h>
+#include <AK/Vector.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/LockLocation.h>
 #include <Kernel/Locking/LockMode.h>
@@ -55,6 +56,15 @@ public:
 
     [[nodiscard]] StringView name() const { return m_name; }
 
+    // Contention is tracked per lock name, which all instances of a kind of lock (like every Inode's lock) share.
+    struct ContentionStatistics {
+        StringView name;
+        u64 contended_count { 0 };
+        u64 acquired_by_spinning_count { 0 };
+        u64 blocked_count { 0 };
+    };
+    static ErrorOr<Vector<ContentionStatistics>> contention_statistics();
+
     static StringView mode_to_string(Mode mode)
     {
         switch (mode) {
@@ -79,7 +89,11 @@ private:
     }
 
     void block(Thread&, Mode, SpinlockLocker<Spinlock>&, u32);
+    bool is_contended_for(Thread const&, Mode) const;
+    void spin_while_holder_is_running(Thread&, SpinlockLocker<Spinlock>&);
     void unblock_waiters(Mode);
+    void lend_priority_to_holder(Thread const& waiter);
+    static void take_back_lent_priority(Thread&);
 
     StringView m_name;
     Mode m_mode { Mode::Unlocked };
@@ -101,6 +115,9 @@ private:
 
     mutable Spinlock m_lock;
 
+    // Bumped every time the lock is released, so spinning threads can watch for that without taking m_lock.
+    Atomic<u32> m_release_count { 0 };
+
 #if LOCK_SHARED_UPGRADE_DEBUG
     HashMap<Thread*, u32> m_shared_holders_map;
 #endif
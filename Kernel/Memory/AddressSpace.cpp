@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/AddressSpace.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
@@ -61,8 +62,14 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         // with the exact same start address, but don't deallocate it yet.
         auto region = take_region(*old_region);
 
+        // The new region(s) map the same pages as before, so a single flush of the old range
+        // once we're done (or bail out) is enough.
+        ScopeGuard flush_guard([&] {
+            flush_tlb(region->range());
+        });
+
         // We manually unmap the old region here, specifying that we *don't* want the VM deallocated.
-        region->unmap(Region::ShouldDeallocateVirtualRange::No);
+        region->unmap(Region::ShouldDeallocateVirtualRange::No, ShouldFlushTLB::No);
 
         auto new_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
 
@@ -73,7 +80,7 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         for (auto* new_region : new_regions) {
             // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
             // leaves the caller in an undefined state.
-            TRY(new_region->map(page_directory()));
+            TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
         }
 
         PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -95,10 +102,27 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
 
     Vector<Region*, 2> new_regions;
 
+    // Rather than flushing the TLB for every region on its own, we flush everything they covered at once
+    // when we're done (or bail out). Until then, the old regions have to be kept around, otherwise their
+    // physical pages could be reused while another processor may still have them in its TLB.
+    Vector<NonnullOwnPtr<Region>> unmapped_regions;
+    TRY(unmapped_regions.try_ensure_capacity(regions.size()));
+    auto flush_base = regions.first()->vaddr();
+    auto flush_end = regions.first()->range().end();
+    for (auto* region : regions) {
+        flush_base = min(flush_base, region->vaddr());
+        flush_end = max(flush_end, region->range().end());
+    }
+    ScopeGuard flush_guard([&] {
+        flush_tlb({ flush_base, (flush_end - flush_base).get() });
+    });
+
     for (auto* old_region : regions) {
         // If it's a full match we can remove the entire old region.
         if (old_region->range().intersect(range_to_unmap).size() == old_region->size()) {
-            deallocate_region(*old_region);
+            auto region = take_region(*old_region);
+            region->unmap(Region::ShouldDeallocateVirtualRange::Yes, ShouldFlushTLB::No);
+            unmapped_regions.unchecked_append(move(region));
             continue;
         }
 
@@ -107,10 +131,11 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         auto region = take_region(*old_region);
 
         // We manually unmap the old region here, specifying that we *don't* want the VM deallocated.
-        region->unmap(Region::ShouldDeallocateVirtualRange::No);
+        region->unmap(Region::ShouldDeallocateVirtualRange::No, ShouldFlushTLB::No);
+        unmapped_regions.unchecked_append(move(region));
 
         // Otherwise, split the regions and collect them for future mapping.
-        auto split_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
+        auto split_regions = TRY(try_split_region_around_range(*unmapped_regions.last(), range_to_unmap));
         TRY(new_regions.try_extend(split_regions));
     }
 
@@ -121,7 +146,7 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
     for (auto* new_region : new_regions) {
         // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
         // leaves the caller in an undefined state.
-        TRY(new_region->map(page_directory()));
+        TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
     }
 
     PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -129,6 +154,11 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
     return {};
 }
 
+void AddressSpace::flush_tlb(VirtualRange const& range)
+{
+    MemoryManager::flush_tlb(m_page_directory.ptr(), range.base(), range.size() / PAGE_SIZE);
+}
+
 ErrorOr<VirtualRange> AddressSpace::try_allocate_range(VirtualAddress vaddr, size_t size, size_t alignment)
 {
     vaddr.mask(PAGE_MASK);
@@ -149,6 +179,7 @@ ErrorOr<Region*> AddressSpace::try_allocate_split_region(Region const& source_re
     new_region->set_syscall_region(source_region.is_syscall_region());
     new_region->set_mmap(source_region.is_mmap());
     new_region->set_stack(source_region.is_stack());
+    new_region->set_access_pattern(source_region.access_pattern());
     size_t page_offset_in_source_region = (offset_in_vmobject - source_region.offset_in_vmobject()) / PAGE_SIZE;
     for (size_t i = 0; i < new_region->page_count(); ++i) {
         if (source_region.should_cow(page_offset_in_source_region + i))
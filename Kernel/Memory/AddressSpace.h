@@ -35,6 +35,9 @@ public:
 
     ErrorOr<void> unmap_mmap_range(VirtualAddress, size_t);
 
+    // For callers that unmap or remap several regions with ShouldFlushTLB::No and flush once at the end.
+    void flush_tlb(VirtualRange const&);
+
     ErrorOr<VirtualRange> try_allocate_range(VirtualAddress, size_t, size_t alignment = PAGE_SIZE);
 
     ErrorOr<Region*> allocate_region_with_vmobject(VirtualRange const&, NonnullRefPtr<VMObject>, size_t offset_in_vmobject, StringView name, int prot, bool shared);
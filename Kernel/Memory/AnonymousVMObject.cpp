@@ -258,6 +258,11 @@ NonnullRefPtr<PhysicalPage> AnonymousVMObject::allocate_committed_page(Badge<Reg
     return m_unused_committed_pages->take_one();
 }
 
+NonnullRefPtrVector<PhysicalPage> AnonymousVMObject::allocate_committed_huge_page(Badge<Region>)
+{
+    return m_unused_committed_pages->take_huge_page();
+}
+
 ErrorOr<void> AnonymousVMObject::ensure_cow_map()
 {
     if (m_cow_map.is_null())
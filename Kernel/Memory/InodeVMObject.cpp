@@ -9,6 +9,8 @@
 
 namespace Kernel::Memory {
 
+static Atomic<u64> s_use_counter;
+
 InodeVMObject::InodeVMObject(Inode& inode, FixedArray<RefPtr<PhysicalPage>>&& new_physical_pages, Bitmap dirty_pages)
     : VMObject(move(new_physical_pages))
     , m_inode(inode)
@@ -50,12 +52,25 @@ size_t InodeVMObject::amount_dirty() const
     return count * PAGE_SIZE;
 }
 
+bool InodeVMObject::shares_inode_pages() const
+{
+    return is_shared_inode() && m_inode->has_shareable_physical_pages();
+}
+
 int InodeVMObject::release_all_clean_pages()
 {
+    return release_clean_pages(0, page_count());
+}
+
+int InodeVMObject::release_clean_pages(size_t first_page_index, size_t page_count)
+{
+    VERIFY(first_page_index + page_count <= this->page_count());
+    if (shares_inode_pages())
+        return 0;
     SpinlockLocker locker(m_lock);
 
     int count = 0;
-    for (size_t i = 0; i < page_count(); ++i) {
+    for (size_t i = first_page_index; i < first_page_index + page_count; ++i) {
         if (!m_dirty_pages.get(i) && m_physical_pages[i]) {
             m_physical_pages[i] = nullptr;
             ++count;
@@ -89,4 +104,30 @@ u32 InodeVMObject::executable_mappings() const
     return count;
 }
 
+void InodeVMObject::mark_used()
+{
+    m_last_used.store(s_use_counter.fetch_add(1, AK::MemoryOrder::memory_order_relaxed) + 1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+size_t InodeVMObject::readahead_page_count_for_fault(size_t page_index, Region::AccessPattern access_pattern)
+{
+    VERIFY(m_lock.is_locked_by_current_processor());
+    switch (access_pattern) {
+    case Region::AccessPattern::Random:
+        return 1;
+    case Region::AccessPattern::Sequential:
+        m_readahead_page_count = maximum_readahead_page_count;
+        break;
+    case Region::AccessPattern::Normal:
+        if (page_index == m_readahead_end && m_readahead_page_count != 0)
+            m_readahead_page_count = min(m_readahead_page_count * 2, maximum_readahead_page_count);
+        else
+            m_readahead_page_count = minimum_readahead_page_count;
+        break;
+    }
+    auto page_count = min(m_readahead_page_count, this->page_count() - page_index);
+    m_readahead_end = page_index + page_count;
+    return page_count;
+}
+
 }
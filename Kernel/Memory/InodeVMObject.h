@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Bitmap.h>
 #include <Kernel/Memory/VMObject.h>
 #include <Kernel/UnixTypes.h>
@@ -23,10 +24,27 @@ public:
     size_t amount_clean() const;
 
     int release_all_clean_pages();
+    // Forgets the clean pages in the given range, so that they're read in again from the inode the next time they're needed.
+    int release_clean_pages(size_t first_page_index, size_t page_count);
+
+    bool is_page_dirty(size_t page_index) const { return m_dirty_pages.get(page_index); }
+
+    // Whether our pages are the ones the inode keeps its contents in, see Inode::shareable_physical_page().
+    // Those can't be released or reclaimed, and there's nothing to write back.
+    bool shares_inode_pages() const;
+
+    // Page reclaim goes after the objects that have been faulted on least recently first.
+    u64 last_used() const { return m_last_used.load(AK::MemoryOrder::memory_order_relaxed); }
+    void mark_used();
 
     u32 writable_mappings() const;
     u32 executable_mappings() const;
 
+    // Decides how many pages an inode fault at the given page index should read in.
+    // The window grows while faults keep landing right where the previous read ended; regions that are
+    // known to be read sequentially start out with the biggest window, and randomly accessed ones get none.
+    size_t readahead_page_count_for_fault(size_t page_index, Region::AccessPattern);
+
 protected:
     explicit InodeVMObject(Inode&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
     explicit InodeVMObject(InodeVMObject const&, FixedArray<RefPtr<PhysicalPage>>&&, Bitmap dirty_pages);
@@ -39,6 +57,15 @@ protected:
 
     NonnullRefPtr<Inode> m_inode;
     Bitmap m_dirty_pages;
+
+private:
+    static constexpr size_t minimum_readahead_page_count = 4;
+    static constexpr size_t maximum_readahead_page_count = 32;
+
+    size_t m_readahead_page_count { 0 };
+    size_t m_readahead_end { 0 };
+
+    Atomic<u64> m_last_used { 0 };
 };
 
 }
@@ -6,23 +6,29 @@
 
 #include <AK/Assertions.h>
 #include <AK/Memory.h>
+#include <AK/QuickSort.h>
 #include <AK/StringView.h>
+#include <Kernel/Arch/x86/CPUID.h>
 #include <Kernel/Arch/x86/PageFault.h>
 #include <Kernel/BootInfo.h>
 #include <Kernel/CMOS.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/Firmware/ACPI/Definitions.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/InodeVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/PageDirectory.h>
 #include <Kernel/Memory/PhysicalRegion.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
+#include <Kernel/Memory/TypedMapping.h>
 #include <Kernel/Multiboot.h>
 #include <Kernel/Panic.h>
 #include <Kernel/Process.h>
 #include <Kernel/Sections.h>
 #include <Kernel/StdLib.h>
+#include <Kernel/Tracepoint.h>
 
 extern u8 start_of_kernel_image[];
 extern u8 end_of_kernel_image[];
@@ -77,7 +83,7 @@ UNMAP_AFTER_INIT MemoryManager::MemoryManager()
 
     SpinlockLocker lock(s_mm_lock);
     parse_memory_map();
-    write_cr3(kernel_page_directory().cr3());
+    Processor::activate_page_directory(kernel_page_directory().cr3());
     protect_kernel_image();
 
     // We're temporarily "committing" to two pages that we need to allocate below
@@ -92,6 +98,9 @@ UNMAP_AFTER_INIT MemoryManager::MemoryManager()
     // By using a tag we don't have to query the VMObject for every page
     // whether it was committed or not
     m_lazy_committed_page = committed_pages.take_one();
+
+    // NOTE: The zeroed page pool is filled with the MM lock held, so it must never have to grow.
+    MUST(m_zeroed_pages.try_ensure_capacity(zeroed_page_pool_size));
 }
 
 UNMAP_AFTER_INIT MemoryManager::~MemoryManager()
@@ -554,6 +563,7 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+    VERIFY(!pde.is_huge());
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -569,9 +579,10 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
-    if (pde.is_present())
+    if (pde.is_present() && !pde.is_huge())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
+    bool was_huge = pde.is_present();
     bool did_purge = false;
     auto page_table_or_error = allocate_user_physical_page(ShouldZeroFill::Yes, &did_purge);
     if (page_table_or_error.is_error()) {
@@ -586,8 +597,33 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
         pd = quickmap_pd(page_directory, page_directory_table_index);
         VERIFY(&pde == &pd[page_directory_index]); // Sanity check
 
-        VERIFY(!pde.is_present()); // Should have not changed
+        if (!was_huge) {
+            VERIFY(!pde.is_present()); // Should have not changed
+        } else if (pde.is_present() && !pde.is_huge()) {
+            // Purging split the huge page for us, so we can use that page table instead.
+            return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
+        }
+    }
+
+    bool is_splitting_huge_page = pde.is_present();
+    if (is_splitting_huge_page) {
+        // We're about to map a single page inside a huge page, so split it up into a page table
+        // that maps the same physical memory with the same permissions.
+        auto huge_page_base = pde.page_table_base();
+        auto* page_table_entries = quickmap_pt(page_table->paddr());
+        for (size_t i = 0; i < pages_per_huge_page; ++i) {
+            auto& pte = page_table_entries[i];
+            pte.set_physical_page_base(huge_page_base + i * PAGE_SIZE);
+            pte.set_cache_disabled(pde.is_cache_disabled());
+            pte.set_writable(pde.is_writable());
+            pte.set_execute_disabled(pde.is_execute_disabled());
+            pte.set_user_allowed(pde.is_user_allowed());
+            pte.set_present(true);
+        }
+        pde.clear();
+        --m_system_memory_info.huge_pages_mapped;
     }
+
     pde.set_page_table_base(page_table->paddr().get());
     pde.set_user_allowed(true);
     pde.set_present(true);
@@ -597,10 +633,13 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
     // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
     (void)page_table.leak_ref();
 
+    if (is_splitting_huge_page)
+        flush_tlb(&page_directory, VirtualAddress(vaddr.get() & ~(huge_page_size - 1)), pages_per_huge_page);
+
     return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 }
 
-void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress vaddr, IsLastPTERelease is_last_pte_release)
+bool MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress vaddr, IsLastPTERelease is_last_pte_release)
 {
     VERIFY_INTERRUPTS_DISABLED();
     VERIFY(s_mm_lock.is_locked_by_current_processor());
@@ -611,7 +650,12 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
-    if (pde.is_present()) {
+    if (pde.is_present() && pde.is_huge()) {
+        // NOTE: Huge pages are only ever mapped for regions covering all of them,
+        //       so releasing any part of one means the whole huge page goes away.
+        pde.clear();
+        --m_system_memory_info.huge_pages_mapped;
+    } else if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
         pte.clear();
@@ -629,9 +673,40 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
             if (all_clear) {
                 get_physical_page_entry(PhysicalAddress { pde.page_table_base() }).allocated.physical_page.unref();
                 pde.clear();
+                return true;
             }
         }
     }
+    return false;
+}
+
+PageDirectoryEntry& MemoryManager::ensure_huge_pde(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(s_mm_lock.is_locked_by_current_processor());
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY((vaddr.get() % huge_page_size) == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (pde.is_present() && pde.is_huge())
+        return pde;
+
+    if (pde.is_present()) {
+        // The caller is replacing every page in this page table, so we don't need it anymore.
+        get_physical_page_entry(PhysicalAddress { pde.page_table_base() }).allocated.physical_page.unref();
+        pde.clear();
+    }
+    ++m_system_memory_info.huge_pages_mapped;
+    return pde;
+}
+
+static UNMAP_AFTER_INIT u32 current_initial_apic_id()
+{
+    // The SRAT table identifies processors by their APIC ID, which the kernel doesn't otherwise keep track of.
+    return CPUID(1).ebx() >> 24;
 }
 
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
@@ -641,9 +716,91 @@ UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
     if (cpu == 0) {
         new MemoryManager;
         kmalloc_enable_expand();
+    } else {
+        // NOTE: The application processors are started after the NUMA nodes have been assigned.
+        get_data().m_numa_node = MM.m_numa_node_by_apic_id.get(current_initial_apic_id()).value_or(0);
     }
 }
 
+UNMAP_AFTER_INIT void MemoryManager::initialize_numa_nodes()
+{
+    auto rsdp = ACPI::StaticParsing::find_rsdp();
+    if (!rsdp.has_value())
+        return;
+    auto srat_address = ACPI::StaticParsing::find_table(rsdp.value(), "SRAT"sv);
+    if (!srat_address.has_value())
+        return;
+    auto srat_or_error = map_typed<ACPI::Structures::SRAT>(srat_address.value());
+    if (srat_or_error.is_error()) {
+        dmesgln("MM: Failed to map SRAT table");
+        return;
+    }
+    auto srat = srat_or_error.release_value();
+
+    // Proximity domains can be sparse, so we hand out our own dense node numbers in the order we see them.
+    HashMap<u32, u32> node_by_proximity_domain;
+    auto node_for_proximity_domain = [&](u32 proximity_domain) {
+        return node_by_proximity_domain.ensure(proximity_domain, [&] { return static_cast<u32>(node_by_proximity_domain.size()); });
+    };
+
+    size_t entries_length = srat->h.length - sizeof(ACPI::Structures::SRAT);
+    auto const* entry = srat->entries;
+    while (entries_length >= sizeof(ACPI::Structures::SRATEntryHeader)) {
+        size_t entry_length = entry->length;
+        if (entry_length == 0 || entry_length > entries_length)
+            break;
+        if (entry->type == (u8)ACPI::Structures::SRATEntryType::ProcessorLocalAPICAffinity) {
+            auto* apic_entry = (ACPI::Structures::SRATEntries::ProcessorLocalAPICAffinity const*)entry;
+            if (apic_entry->flags & 1) {
+                u32 proximity_domain = apic_entry->proximity_domain_low | (apic_entry->proximity_domain_high[0] << 8) | (apic_entry->proximity_domain_high[1] << 16) | (apic_entry->proximity_domain_high[2] << 24);
+                m_numa_node_by_apic_id.set(apic_entry->apic_id, node_for_proximity_domain(proximity_domain));
+            }
+        } else if (entry->type == (u8)ACPI::Structures::SRATEntryType::ProcessorLocalX2APICAffinity) {
+            auto* x2apic_entry = (ACPI::Structures::SRATEntries::ProcessorLocalX2APICAffinity const*)entry;
+            if (x2apic_entry->flags & 1)
+                m_numa_node_by_apic_id.set(x2apic_entry->x2apic_id, node_for_proximity_domain(x2apic_entry->proximity_domain));
+        } else if (entry->type == (u8)ACPI::Structures::SRATEntryType::MemoryAffinity) {
+            auto* memory_entry = (ACPI::Structures::SRATEntries::MemoryAffinity const*)entry;
+            if (memory_entry->flags & 1) {
+                auto node = node_for_proximity_domain(memory_entry->proximity_domain);
+                auto lower = PhysicalAddress(memory_entry->base_address);
+                auto upper = lower.offset(memory_entry->length);
+                // FIXME: Split physical regions that span more than one node, for now they belong to the node of their first page.
+                for (auto& region : m_user_physical_regions) {
+                    if (region.lower() >= lower && region.lower() < upper)
+                        region.set_numa_node(node);
+                }
+            }
+        }
+        entry = (ACPI::Structures::SRATEntryHeader const*)(VirtualAddress(entry).offset(entry_length).get());
+        entries_length -= entry_length;
+    }
+
+    m_numa_node_count = max(node_by_proximity_domain.size(), (size_t)1);
+    get_data().m_numa_node = m_numa_node_by_apic_id.get(current_initial_apic_id()).value_or(0);
+    dmesgln("MM: Found {} NUMA node(s)", m_numa_node_count);
+}
+
+RefPtr<PhysicalPage> MemoryManager::take_free_page_from_user_physical_regions()
+{
+    VERIFY(s_mm_lock.is_locked_by_current_processor());
+    // Prefer memory that is attached to the node of the allocating processor, remote memory is slower to access.
+    if (m_numa_node_count > 1) {
+        auto local_node = current_numa_node();
+        for (auto& region : m_user_physical_regions) {
+            if (region.numa_node() != local_node)
+                continue;
+            if (auto page = region.take_free_page())
+                return page;
+        }
+    }
+    for (auto& region : m_user_physical_regions) {
+        if (auto page = region.take_free_page())
+            return page;
+    }
+    return {};
+}
+
 Region* MemoryManager::kernel_region_from_vaddr(VirtualAddress vaddr)
 {
     if (is_user_address(vaddr))
@@ -711,7 +868,7 @@ Region* MemoryManager::find_region_from_vaddr(VirtualAddress vaddr)
 {
     if (auto* region = kernel_region_from_vaddr(vaddr))
         return region;
-    auto page_directory = PageDirectory::find_by_cr3(read_cr3());
+    auto page_directory = PageDirectory::find_by_cr3(Processor::active_page_directory());
     if (!page_directory)
         return nullptr;
     VERIFY(page_directory->address_space());
@@ -744,6 +901,7 @@ PageFaultResponse MemoryManager::handle_page_fault(PageFault const& fault)
         return PageFaultResponse::ShouldCrash;
     }
     dbgln_if(PAGE_FAULT_DEBUG, "MM: CPU[{}] handle_page_fault({:#04x}) at {}", Processor::current_id(), fault.code(), fault.vaddr());
+    TRACE(memory, page_fault, fault.vaddr().get(), fault.code());
     auto* region = find_region_from_vaddr(fault.vaddr());
     if (!region) {
         return PageFaultResponse::ShouldCrash;
@@ -876,7 +1034,91 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
     --m_system_memory_info.super_physical_pages_used;
 }
 
-RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed)
+size_t MemoryManager::page_reclaim_deficit()
+{
+    SpinlockLocker lock(s_mm_lock);
+    auto low_watermark = max<size_t>(m_system_memory_info.user_physical_pages / 64, 256);
+    auto high_watermark = low_watermark * 2;
+    auto free_pages = m_system_memory_info.user_physical_pages_uncommitted;
+    if (free_pages >= low_watermark)
+        return 0;
+    return high_watermark - free_pages;
+}
+
+size_t MemoryManager::reclaim_clean_inode_pages(size_t page_count)
+{
+    VERIFY(!s_mm_lock.is_locked_by_current_processor());
+
+    Vector<NonnullRefPtr<InodeVMObject>> vmobjects;
+    for_each_vmobject([&](auto& vmobject) {
+        if (!vmobject.is_inode())
+            return IterationDecision::Continue;
+        if (vmobjects.try_append(static_cast<InodeVMObject&>(vmobject)).is_error())
+            return IterationDecision::Break;
+        return IterationDecision::Continue;
+    });
+
+    // Go through the least recently used objects first.
+    quick_sort(vmobjects, [](auto& a, auto& b) { return a->last_used() < b->last_used(); });
+
+    size_t reclaimed_page_count = 0;
+    for (auto& vmobject : vmobjects) {
+        if (reclaimed_page_count >= page_count)
+            break;
+        reclaimed_page_count += reclaim_clean_pages(*vmobject, page_count - reclaimed_page_count);
+    }
+
+    if (reclaimed_page_count) {
+        SpinlockLocker lock(s_mm_lock);
+        m_system_memory_info.user_physical_pages_reclaimed += reclaimed_page_count;
+    }
+    return reclaimed_page_count;
+}
+
+size_t MemoryManager::reclaim_clean_pages(InodeVMObject& vmobject, size_t page_count)
+{
+    // Dropping our references to pages the inode keeps anyway wouldn't free anything.
+    if (vmobject.shares_inode_pages())
+        return 0;
+
+    SpinlockLocker locker(vmobject.m_lock);
+
+    // A page that has been written to through a mapping may not match the inode anymore,
+    // and we don't track that per page, so leave any object that was ever mapped writable alone.
+    bool has_been_writable = false;
+    vmobject.for_each_region([&](auto& region) {
+        if (region.is_writable() || region.has_been_writable())
+            has_been_writable = true;
+    });
+    if (has_been_writable)
+        return 0;
+
+    auto physical_pages = vmobject.physical_pages();
+    size_t reclaimed_page_count = 0;
+    for (size_t i = 0; i < physical_pages.size() && reclaimed_page_count < page_count; ++i) {
+        if (!physical_pages[i] || vmobject.is_page_dirty(i))
+            continue;
+
+        // Give pages that have been accessed since we last looked at them a second chance.
+        bool was_accessed = false;
+        vmobject.for_each_region([&](auto& region) {
+            auto page_index = i;
+            if (region.translate_vmobject_page(page_index) && region.test_and_clear_page_accessed(page_index))
+                was_accessed = true;
+        });
+        if (was_accessed)
+            continue;
+
+        vmobject.for_each_region([&](auto& region) {
+            region.unmap_vmobject_page(i);
+        });
+        physical_pages[i] = nullptr;
+        ++reclaimed_page_count;
+    }
+    return reclaimed_page_count;
+}
+
+RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed, ShouldZeroFill should_zero_fill)
 {
     VERIFY(s_mm_lock.is_locked());
     RefPtr<PhysicalPage> page;
@@ -890,33 +1132,78 @@ RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed)
             return {};
         m_system_memory_info.user_physical_pages_uncommitted--;
     }
-    for (auto& region : m_user_physical_regions) {
-        page = region.take_free_page();
-        if (!page.is_null()) {
-            ++m_system_memory_info.user_physical_pages_used;
-            break;
-        }
+
+    auto take_zeroed_page = [&]() -> RefPtr<PhysicalPage> {
+        if (m_zeroed_pages.is_empty())
+            return {};
+        --m_system_memory_info.user_physical_pages_zeroed;
+        return m_zeroed_pages.take_last();
+    };
+
+    // Save the zeroed pages for the allocations that actually want them, unless there's nothing else left.
+    bool is_zeroed = false;
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        page = take_zeroed_page();
+        is_zeroed = !page.is_null();
+        if (is_zeroed)
+            ++m_system_memory_info.zeroed_page_pool_hits;
+    }
+    if (page.is_null())
+        page = take_free_page_from_user_physical_regions();
+    if (page.is_null()) {
+        page = take_zeroed_page();
+        is_zeroed = !page.is_null();
     }
     VERIFY(!committed || !page.is_null());
+    if (page.is_null())
+        return {};
+
+    ++m_system_memory_info.user_physical_pages_used;
+    if (should_zero_fill == ShouldZeroFill::Yes && !is_zeroed) {
+        auto* ptr = quickmap_page(*page);
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
     return page;
 }
 
-NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
+size_t MemoryManager::refill_zeroed_page_pool(size_t page_count)
 {
-    SpinlockLocker lock(s_mm_lock);
-    auto page = find_free_user_physical_page(true);
-    if (should_zero_fill == ShouldZeroFill::Yes) {
+    size_t refilled_page_count = 0;
+    while (refilled_page_count < page_count) {
+        // NOTE: Take the lock for one page at a time, so we don't hold up allocations for long.
+        SpinlockLocker lock(s_mm_lock);
+        if (m_zeroed_pages.size() >= zeroed_page_pool_size)
+            break;
+        // Don't bother zeroing ahead while memory is tight, whatever is left is needed right away anyway.
+        if (page_reclaim_deficit() != 0)
+            break;
+
+        auto page = take_free_page_from_user_physical_regions();
+        if (page.is_null())
+            break;
+
         auto* ptr = quickmap_page(*page);
         memset(ptr, 0, PAGE_SIZE);
         unquickmap_page();
+
+        m_zeroed_pages.unchecked_append(page.release_nonnull());
+        ++m_system_memory_info.user_physical_pages_zeroed;
+        ++refilled_page_count;
     }
-    return page.release_nonnull();
+    return refilled_page_count;
+}
+
+NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill should_zero_fill)
+{
+    SpinlockLocker lock(s_mm_lock);
+    return find_free_user_physical_page(true, should_zero_fill).release_nonnull();
 }
 
 ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_user_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
     SpinlockLocker lock(s_mm_lock);
-    auto page = find_free_user_physical_page(false);
+    auto page = find_free_user_physical_page(false, should_zero_fill);
     bool purged_pages = false;
 
     if (!page) {
@@ -930,7 +1217,7 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_user_physical_page(
                 return IterationDecision::Continue;
             if (auto purged_page_count = anonymous_vmobject.purge()) {
                 dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                page = find_free_user_physical_page(false);
+                page = find_free_user_physical_page(false, should_zero_fill);
                 purged_pages = true;
                 VERIFY(page);
                 return IterationDecision::Break;
@@ -943,15 +1230,58 @@ ErrorOr<NonnullRefPtr<PhysicalPage>> MemoryManager::allocate_user_physical_page(
         }
     }
 
-    if (should_zero_fill == ShouldZeroFill::Yes) {
-        auto* ptr = quickmap_page(*page);
+    if (did_purge)
+        *did_purge = purged_pages;
+    return page.release_nonnull();
+}
+
+NonnullRefPtrVector<PhysicalPage> MemoryManager::find_free_user_physical_huge_page(bool committed)
+{
+    VERIFY(s_mm_lock.is_locked());
+    if (committed) {
+        VERIFY(m_system_memory_info.user_physical_pages_committed >= pages_per_huge_page);
+    } else if (m_system_memory_info.user_physical_pages_uncommitted < pages_per_huge_page) {
+        ++m_system_memory_info.huge_page_allocation_failures;
+        return {};
+    }
+
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    for (auto& region : m_user_physical_regions) {
+        physical_pages = region.take_contiguous_free_pages(pages_per_huge_page);
+        if (!physical_pages.is_empty())
+            break;
+    }
+    if (physical_pages.is_empty()) {
+        ++m_system_memory_info.huge_page_allocation_failures;
+        return {};
+    }
+    VERIFY((physical_pages.first().paddr().get() % huge_page_size) == 0);
+
+    if (committed)
+        m_system_memory_info.user_physical_pages_committed -= pages_per_huge_page;
+    else
+        m_system_memory_info.user_physical_pages_uncommitted -= pages_per_huge_page;
+    m_system_memory_info.user_physical_pages_used += pages_per_huge_page;
+    ++m_system_memory_info.huge_pages_allocated;
+
+    for (auto& page : physical_pages) {
+        auto* ptr = quickmap_page(page);
         memset(ptr, 0, PAGE_SIZE);
         unquickmap_page();
     }
+    return physical_pages;
+}
 
-    if (did_purge)
-        *did_purge = purged_pages;
-    return page.release_nonnull();
+NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_committed_user_physical_huge_page(Badge<CommittedPhysicalPageSet>)
+{
+    SpinlockLocker lock(s_mm_lock);
+    return find_free_user_physical_huge_page(true);
+}
+
+NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_user_physical_huge_page()
+{
+    SpinlockLocker lock(s_mm_lock);
+    return find_free_user_physical_huge_page(false);
 }
 
 ErrorOr<NonnullRefPtrVector<PhysicalPage>> MemoryManager::allocate_contiguous_user_physical_pages(size_t size)
@@ -1025,7 +1355,7 @@ void MemoryManager::enter_address_space(AddressSpace& space)
     SpinlockLocker lock(s_mm_lock);
 
     current_thread->regs().cr3 = space.page_directory().cr3();
-    write_cr3(space.page_directory().cr3());
+    Processor::activate_page_directory(space.page_directory().cr3());
 }
 
 void MemoryManager::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
@@ -1049,6 +1379,8 @@ PageDirectoryEntry* MemoryManager::quickmap_pd(PageDirectory& directory, size_t
         pte.set_present(true);
         pte.set_writable(true);
         pte.set_user_allowed(false);
+        // NOTE: This is global so flushing it also covers translations cached under other PCIDs.
+        pte.set_global(true);
         // Because we must continue to hold the MM lock while we use this
         // mapping, it is sufficient to only flush on the current CPU. Other
         // CPUs trying to use this API must wait on the MM lock anyway
@@ -1074,6 +1406,8 @@ PageTableEntry* MemoryManager::quickmap_pt(PhysicalAddress pt_paddr)
         pte.set_present(true);
         pte.set_writable(true);
         pte.set_user_allowed(false);
+        // NOTE: This is global so flushing it also covers translations cached under other PCIDs.
+        pte.set_global(true);
         // Because we must continue to hold the MM lock while we use this
         // mapping, it is sufficient to only flush on the current CPU. Other
         // CPUs trying to use this API must wait on the MM lock anyway
@@ -1105,6 +1439,8 @@ u8* MemoryManager::quickmap_page(PhysicalAddress const& physical_address)
         pte.set_present(true);
         pte.set_writable(true);
         pte.set_user_allowed(false);
+        // NOTE: This is global so flushing it also covers translations cached under other PCIDs.
+        pte.set_global(true);
         flush_tlb_local(vaddr);
     }
     return vaddr.as_ptr();
@@ -1206,6 +1542,16 @@ NonnullRefPtr<PhysicalPage> CommittedPhysicalPageSet::take_one()
     return MM.allocate_committed_user_physical_page({}, MemoryManager::ShouldZeroFill::Yes);
 }
 
+NonnullRefPtrVector<PhysicalPage> CommittedPhysicalPageSet::take_huge_page()
+{
+    if (m_page_count < pages_per_huge_page)
+        return {};
+    auto physical_pages = MM.allocate_committed_user_physical_huge_page({});
+    if (!physical_pages.is_empty())
+        m_page_count -= pages_per_huge_page;
+    return physical_pages;
+}
+
 void CommittedPhysicalPageSet::uncommit_one()
 {
     VERIFY(m_page_count > 0);
@@ -1221,4 +1567,21 @@ void MemoryManager::copy_physical_page(PhysicalPage& physical_page, u8 page_buff
     unquickmap_page();
 }
 
+void MemoryManager::copy_to_physical_page(PhysicalPage& physical_page, u8 const page_buffer[PAGE_SIZE])
+{
+    SpinlockLocker locker(s_mm_lock);
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memcpy(quickmapped_page, page_buffer, PAGE_SIZE);
+    unquickmap_page();
+}
+
+void MemoryManager::copy_to_physical_page(PhysicalPage& physical_page, size_t offset_in_page, ReadonlyBytes bytes)
+{
+    VERIFY(offset_in_page + bytes.size() <= PAGE_SIZE);
+    SpinlockLocker locker(s_mm_lock);
+    auto* quickmapped_page = quickmap_page(physical_page);
+    memcpy(quickmapped_page + offset_in_page, bytes.data(), bytes.size());
+    unquickmap_page();
+}
+
 }
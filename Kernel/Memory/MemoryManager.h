@@ -8,6 +8,7 @@
 
 #include <AK/Badge.h>
 #include <AK/Concepts.h>
+#include <AK/HashMap.h>
 #include <AK/HashTable.h>
 #include <AK/IntrusiveRedBlackTree.h>
 #include <AK/NonnullOwnPtrVector.h>
@@ -35,6 +36,10 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return ((FlatPtr)(x)) & ~(PAGE_SIZE - 1);
 }
 
+// Large anonymous regions are backed by huge pages where possible, see Region::try_handle_huge_zero_fault().
+static constexpr size_t huge_page_size = 2 * MiB;
+static constexpr size_t pages_per_huge_page = huge_page_size / PAGE_SIZE;
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - physical_to_virtual_offset;
@@ -92,6 +97,8 @@ struct MemoryManagerData {
 
     PhysicalAddress m_last_quickmap_pd;
     PhysicalAddress m_last_quickmap_pt;
+
+    u32 m_numa_node { 0 };
 };
 
 // NOLINTNEXTLINE(readability-redundant-declaration) FIXME: Why do we declare this here *and* in Thread.h?
@@ -123,6 +130,9 @@ public:
     [[nodiscard]] NonnullRefPtr<PhysicalPage> take_one();
     void uncommit_one();
 
+    // Returns an empty vector if there's no contiguous huge page available right now.
+    [[nodiscard]] NonnullRefPtrVector<PhysicalPage> take_huge_page();
+
     void operator=(CommittedPhysicalPageSet&&) = delete;
 
 private:
@@ -130,6 +140,7 @@ private:
 };
 
 class MemoryManager {
+    friend class AddressSpace;
     friend class PageDirectory;
     friend class AnonymousVMObject;
     friend class Region;
@@ -142,6 +153,11 @@ public:
 
     static void initialize(u32 cpu);
 
+    // Assigns the physical memory and the processors to NUMA nodes, as described by the ACPI SRAT table.
+    void initialize_numa_nodes();
+    size_t numa_node_count() const { return m_numa_node_count; }
+    static u32 current_numa_node() { return get_data().m_numa_node; }
+
     static inline MemoryManagerData& get_data()
     {
         return ProcessorSpecific<MemoryManagerData>::get();
@@ -172,6 +188,8 @@ public:
 
     NonnullRefPtr<PhysicalPage> allocate_committed_user_physical_page(Badge<CommittedPhysicalPageSet>, ShouldZeroFill = ShouldZeroFill::Yes);
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
+    NonnullRefPtrVector<PhysicalPage> allocate_committed_user_physical_huge_page(Badge<CommittedPhysicalPageSet>);
+    NonnullRefPtrVector<PhysicalPage> allocate_user_physical_huge_page();
     ErrorOr<NonnullRefPtr<PhysicalPage>> allocate_supervisor_physical_page();
     ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_contiguous_supervisor_physical_pages(size_t size);
     ErrorOr<NonnullRefPtrVector<PhysicalPage>> allocate_contiguous_user_physical_pages(size_t size);
@@ -194,6 +212,12 @@ public:
         PhysicalSize user_physical_pages_uncommitted { 0 };
         PhysicalSize super_physical_pages { 0 };
         PhysicalSize super_physical_pages_used { 0 };
+        PhysicalSize user_physical_pages_reclaimed { 0 };
+        PhysicalSize huge_pages_mapped { 0 };
+        PhysicalSize huge_pages_allocated { 0 };
+        PhysicalSize huge_page_allocation_failures { 0 };
+        PhysicalSize user_physical_pages_zeroed { 0 };
+        PhysicalSize zeroed_page_pool_hits { 0 };
     };
 
     SystemMemoryInfo get_system_memory_info()
@@ -202,6 +226,16 @@ public:
         return m_system_memory_info;
     }
 
+    // Background page reclaim (see PageReclaimTask) starts once the free user pages drop below a low
+    // watermark, and keeps dropping clean inode pages until they're back above a high watermark.
+    size_t page_reclaim_deficit();
+    size_t reclaim_clean_inode_pages(size_t page_count);
+
+    // Free pages zeroed ahead of time (see PageZeroingTask), so zero-filled allocations don't have to wait
+    // for it. They still count as free, any allocation can take them once nothing else is left.
+    static constexpr size_t zeroed_page_pool_size = 1024;
+    size_t refill_zeroed_page_pool(size_t page_count);
+
     template<IteratorFunction<VMObject&> Callback>
     static void for_each_vmobject(Callback callback)
     {
@@ -241,6 +275,8 @@ public:
     PhysicalAddress get_physical_address(PhysicalPage const&);
 
     void copy_physical_page(PhysicalPage&, u8 page_buffer[PAGE_SIZE]);
+    void copy_to_physical_page(PhysicalPage&, u8 const page_buffer[PAGE_SIZE]);
+    void copy_to_physical_page(PhysicalPage&, size_t offset_in_page, ReadonlyBytes);
 
     IterationDecision for_each_physical_memory_range(Function<IterationDecision(PhysicalMemoryRange const&)>);
 
@@ -263,7 +299,10 @@ private:
 
     static Region* find_region_from_vaddr(VirtualAddress);
 
-    RefPtr<PhysicalPage> find_free_user_physical_page(bool);
+    RefPtr<PhysicalPage> take_free_page_from_user_physical_regions();
+    RefPtr<PhysicalPage> find_free_user_physical_page(bool, ShouldZeroFill);
+    size_t reclaim_clean_pages(InodeVMObject&, size_t page_count);
+    NonnullRefPtrVector<PhysicalPage> find_free_user_physical_huge_page(bool);
 
     ALWAYS_INLINE u8* quickmap_page(PhysicalPage& page)
     {
@@ -277,11 +316,13 @@ private:
 
     PageTableEntry* pte(PageDirectory&, VirtualAddress);
     PageTableEntry* ensure_pte(PageDirectory&, VirtualAddress);
+    PageDirectoryEntry& ensure_huge_pde(PageDirectory&, VirtualAddress);
     enum class IsLastPTERelease {
         Yes,
         No
     };
-    void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
+    // Returns whether this also released the page table, which may still be cached by the CPU.
+    bool release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
     RefPtr<PageDirectory> m_kernel_page_directory;
 
@@ -291,6 +332,7 @@ private:
     SystemMemoryInfo m_system_memory_info;
 
     NonnullOwnPtrVector<PhysicalRegion> m_user_physical_regions;
+    Vector<NonnullRefPtr<PhysicalPage>> m_zeroed_pages;
     OwnPtr<PhysicalRegion> m_super_physical_region;
     OwnPtr<PhysicalRegion> m_physical_pages_region;
     PhysicalPageEntry* m_physical_page_entries { nullptr };
@@ -301,6 +343,9 @@ private:
     Vector<UsedMemoryRange> m_used_memory_ranges;
     Vector<PhysicalMemoryRange> m_physical_memory_ranges;
     Vector<ContiguousReservedMemoryRange> m_reserved_memory_ranges;
+
+    size_t m_numa_node_count { 1 };
+    HashMap<u32, u32> m_numa_node_by_apic_id;
 };
 
 inline bool is_user_address(VirtualAddress vaddr)
@@ -147,6 +147,7 @@ PageDirectory::~PageDirectory()
     if (is_cr3_initialized()) {
         SpinlockLocker lock(s_mm_lock);
         cr3_map().remove(cr3());
+        Processor::forget_page_directory(cr3());
     }
 }
 
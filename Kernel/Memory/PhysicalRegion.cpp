@@ -27,6 +27,11 @@ static constexpr u32 next_power_of_two(u32 value)
     return value;
 }
 
+static constexpr u32 previous_power_of_two(u32 value)
+{
+    return next_power_of_two(value + 1) / 2;
+}
+
 PhysicalRegion::~PhysicalRegion()
 {
 }
@@ -59,7 +64,22 @@ void PhysicalRegion::initialize_zones()
         return zone_count;
     };
 
-    // First make 16 MiB zones (with 4096 pages each)
+    // Carve the unaligned head of the region into smaller zones, so that the large zones start on a
+    // huge page boundary. Blocks handed out by a zone are aligned within it, so this guarantees that
+    // huge page sized allocations from the large zones are physically aligned as well.
+    while (remaining_pages > 0 && (base_address.get() % huge_page_size) != 0) {
+        size_t pages_per_zone = min<size_t>(1u << count_trailing_zeroes(base_address.get() / PAGE_SIZE), previous_power_of_two(remaining_pages));
+        m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, pages_per_zone)).release_value_but_fixme_should_propagate_errors());
+        base_address = base_address.offset(pages_per_zone * PAGE_SIZE);
+        m_usable_zones.append(m_zones.last());
+        remaining_pages -= pages_per_zone;
+        ++m_leading_zones;
+    }
+    if (m_leading_zones)
+        dmesgln(" * {}x PhysicalZone (leading) @ {:016x}-{:016x}", m_leading_zones, m_lower.get(), base_address.get() - 1);
+    m_aligned_lower = base_address;
+
+    // Then make 16 MiB zones (with 4096 pages each)
     m_large_zones = make_zones(large_zone_size);
 
     // Then divide any remaining space into 1 MiB zones (with 256 pages each)
@@ -125,14 +145,20 @@ RefPtr<PhysicalPage> PhysicalRegion::take_free_page()
 
 void PhysicalRegion::return_page(PhysicalAddress paddr)
 {
-    auto large_zone_base = lower().get();
-    auto small_zone_base = lower().get() + (m_large_zones * large_zone_size);
+    auto large_zone_base = m_aligned_lower.get();
+    auto small_zone_base = large_zone_base + (m_large_zones * large_zone_size);
 
     size_t zone_index;
-    if (paddr.get() < small_zone_base)
-        zone_index = (paddr.get() - large_zone_base) / large_zone_size;
-    else
-        zone_index = m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
+    if (paddr.get() < large_zone_base) {
+        zone_index = 0;
+        while (!m_zones[zone_index].contains(paddr))
+            ++zone_index;
+        VERIFY(zone_index < m_leading_zones);
+    } else if (paddr.get() < small_zone_base) {
+        zone_index = m_leading_zones + (paddr.get() - large_zone_base) / large_zone_size;
+    } else {
+        zone_index = m_leading_zones + m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
+    }
 
     auto& zone = m_zones[zone_index];
     VERIFY(zone.contains(paddr));
@@ -31,6 +31,10 @@ public:
     unsigned size() const { return m_pages; }
     bool contains(PhysicalAddress paddr) const { return paddr >= m_lower && paddr < m_upper; }
 
+    // The NUMA node (ACPI proximity domain) this memory is attached to, 0 unless the firmware tells us otherwise.
+    u32 numa_node() const { return m_numa_node; }
+    void set_numa_node(u32 numa_node) { m_numa_node = numa_node; }
+
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(unsigned);
 
     RefPtr<PhysicalPage> take_free_page();
@@ -45,14 +49,19 @@ private:
 
     NonnullOwnPtrVector<PhysicalZone> m_zones;
 
+    size_t m_leading_zones { 0 };
     size_t m_large_zones { 0 };
 
+    // The first address after the leading zones, where the large zones begin.
+    PhysicalAddress m_aligned_lower;
+
     PhysicalZone::List m_usable_zones;
     PhysicalZone::List m_full_zones;
 
     PhysicalAddress m_lower;
     PhysicalAddress m_upper;
     unsigned m_pages { 0 };
+    u32 m_numa_node { 0 };
 };
 
 }
@@ -86,6 +86,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
         region->set_mmap(m_mmap);
         region->set_shared(m_shared);
         region->set_syscall_region(is_syscall_region());
+        region->set_access_pattern(m_access_pattern);
         return region;
     }
 
@@ -113,6 +114,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap);
+    clone_region->set_access_pattern(m_access_pattern);
     return clone_region;
 }
 
@@ -221,6 +223,47 @@ bool Region::map_individual_page_impl(size_t page_index)
     return true;
 }
 
+bool Region::can_map_huge_page(size_t page_index) const
+{
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    if ((page_vaddr.get() % huge_page_size) != 0 || page_index + pages_per_huge_page > page_count())
+        return false;
+    if (!is_user() || is_write_combine() || (!is_readable() && !is_writable()))
+        return false;
+    if (!vmobject().is_anonymous() && !(vmobject().is_inode() && static_cast<InodeVMObject const&>(vmobject()).shares_inode_pages()))
+        return false;
+
+    auto const* first_page = physical_page(page_index);
+    if (!first_page || (first_page->paddr().get() % huge_page_size) != 0)
+        return false;
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        auto const* page = physical_page(page_index + i);
+        if (!page || page->paddr() != first_page->paddr().offset(i * PAGE_SIZE) || should_cow(page_index + i))
+            return false;
+    }
+    return true;
+}
+
+void Region::map_huge_page_impl(size_t page_index)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+    VERIFY(s_mm_lock.is_locked_by_current_processor());
+
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    bool user_allowed = page_vaddr.get() >= USER_RANGE_BASE && is_user_address(page_vaddr);
+
+    auto& pde = MM.ensure_huge_pde(*m_page_directory, page_vaddr);
+    pde.clear();
+    pde.set_page_table_base(physical_page(page_index)->paddr().get());
+    pde.set_huge(true);
+    pde.set_cache_disabled(!m_cacheable);
+    pde.set_writable(is_writable());
+    if (Processor::current().has_feature(CPUFeature::NX))
+        pde.set_execute_disabled(!is_executable());
+    pde.set_user_allowed(user_allowed);
+    pde.set_present(true);
+}
+
 bool Region::do_remap_vmobject_page(size_t page_index, bool with_flush)
 {
     if (!m_page_directory)
@@ -236,6 +279,34 @@ bool Region::do_remap_vmobject_page(size_t page_index, bool with_flush)
     return success;
 }
 
+bool Region::test_and_clear_page_accessed(size_t page_index)
+{
+    if (!m_page_directory)
+        return false;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    SpinlockLocker lock(s_mm_lock);
+    auto* pte = MM.pte(*m_page_directory, vaddr_from_page_index(page_index));
+    if (!pte || !pte->is_present() || !pte->is_accessed())
+        return false;
+    // NOTE: We don't flush the TLB here, so a page that stays cached in it may look unused on the next pass.
+    //       Reclaiming it anyway only costs a soft fault, which is a lot cheaper than a shootdown per page.
+    pte->set_accessed(false);
+    return true;
+}
+
+void Region::unmap_vmobject_page(size_t page_index)
+{
+    if (!m_page_directory || !translate_vmobject_page(page_index))
+        return;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    SpinlockLocker lock(s_mm_lock);
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    if (auto* pte = MM.pte(*m_page_directory, page_vaddr); pte && pte->is_present()) {
+        pte->clear();
+        MemoryManager::flush_tlb(m_page_directory, page_vaddr);
+    }
+}
+
 bool Region::remap_vmobject_page(size_t page_index, bool with_flush)
 {
     auto& vmobject = this->vmobject();
@@ -262,11 +333,15 @@ void Region::unmap_with_locks_held(ShouldDeallocateVirtualRange deallocate_range
     if (!m_page_directory)
         return;
     size_t count = page_count();
+    bool released_page_table = false;
     for (size_t i = 0; i < count; ++i) {
         auto vaddr = vaddr_from_page_index(i);
-        MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
+        if (MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No))
+            released_page_table = true;
     }
-    if (should_flush_tlb == ShouldFlushTLB::Yes)
+    // NOTE: Callers batching their flushes keep our pages alive until then, but a released page table
+    //       may be reused as soon as we drop the MM lock, so that can't wait.
+    if (should_flush_tlb == ShouldFlushTLB::Yes || released_page_table)
         MemoryManager::flush_tlb(m_page_directory, vaddr(), page_count());
     if (deallocate_range == ShouldDeallocateVirtualRange::Yes) {
         m_page_directory->range_allocator().deallocate(range());
@@ -294,6 +369,11 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (can_map_huge_page(page_index)) {
+            map_huge_page_impl(page_index);
+            page_index += pages_per_huge_page;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -307,10 +387,10 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     return ENOMEM;
 }
 
-void Region::remap()
+void Region::remap(ShouldFlushTLB should_flush_tlb)
 {
     VERIFY(m_page_directory);
-    auto result = map(*m_page_directory);
+    auto result = map(*m_page_directory, should_flush_tlb);
     if (result.is_error())
         TODO();
 }
@@ -358,6 +438,10 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
         }
 
         auto& page_slot = physical_page_slot(page_index_in_region);
+        if (page_slot.is_null()) {
+            dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
+            return PageFaultResponse::ShouldCrash;
+        }
         if (page_slot->is_lazy_committed_page()) {
             auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
             VERIFY(m_vmobject->is_anonymous());
@@ -366,8 +450,13 @@ PageFaultResponse Region::handle_fault(PageFault const& fault)
                 return PageFaultResponse::OutOfMemory;
             return PageFaultResponse::Continue;
         }
-        dbgln("BUG! Unexpected NP fault at {}", fault.vaddr());
-        return PageFaultResponse::ShouldCrash;
+        // Regions cloned by fork() start out without any page table mappings, their pages are mapped in
+        // as they're touched. A write to a COW page faults once more after this and gets its own copy then.
+        dbgln_if(PAGE_FAULT_DEBUG, "NP(lazy) fault in Region({})[{}] at {}", this, page_index_in_region, fault.vaddr());
+        SpinlockLocker locker(vmobject().m_lock);
+        if (!do_remap_vmobject_page(translate_to_vmobject_page(page_index_in_region), false))
+            return PageFaultResponse::OutOfMemory;
+        return PageFaultResponse::Continue;
     }
     VERIFY(fault.type() == PageFault::Type::ProtectionViolation);
     if (fault.access() == PageFault::Access::Write && is_writable() && should_cow(page_index_in_region)) {
@@ -404,6 +493,9 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (auto response = try_handle_huge_zero_fault(page_index_in_region); response.has_value())
+        return response.release_value();
+
     if (page_slot->is_lazy_committed_page()) {
         VERIFY(m_vmobject->is_anonymous());
         page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page({});
@@ -425,6 +517,63 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
     return PageFaultResponse::Continue;
 }
 
+Optional<PageFaultResponse> Region::try_handle_huge_zero_fault(size_t page_index_in_region)
+{
+    VERIFY(vmobject().m_lock.is_locked_by_current_processor());
+
+    if (!is_user() || !is_writable() || is_write_combine() || !m_page_directory)
+        return {};
+    auto huge_page_vaddr = VirtualAddress(vaddr_from_page_index(page_index_in_region).get() & ~(huge_page_size - 1));
+    if (huge_page_vaddr < vaddr() || !contains(VirtualRange { huge_page_vaddr, huge_page_size }))
+        return {};
+    auto first_page_index = page_index_from_address(huge_page_vaddr);
+
+    // Don't pull pages into a huge page that another region might be looking at.
+    size_t region_count = 0;
+    vmobject().for_each_region([&](auto&) { ++region_count; });
+    if (region_count != 1)
+        return {};
+
+    // All of the pages need to be untouched, and either committed or not all at once.
+    auto const* first_page = physical_page(first_page_index);
+    if (!first_page)
+        return {};
+    bool committed = first_page->is_lazy_committed_page();
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        auto const* page = physical_page(first_page_index + i);
+        if (!page || (committed ? !page->is_lazy_committed_page() : !page->is_shared_zero_page()))
+            return {};
+    }
+
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    if (committed)
+        physical_pages = static_cast<AnonymousVMObject&>(vmobject()).allocate_committed_huge_page({});
+    else
+        physical_pages = MM.allocate_user_physical_huge_page();
+    if (physical_pages.is_empty())
+        return {};
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED HUGE {}", physical_pages.first().paddr());
+
+    for (size_t i = 0; i < pages_per_huge_page; ++i)
+        physical_page_slot(first_page_index + i) = physical_pages.ptr_at(i);
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    SpinlockLocker lock(s_mm_lock);
+    if (can_map_huge_page(first_page_index)) {
+        map_huge_page_impl(first_page_index);
+    } else {
+        // The pages are still marked for COW from a fork, map them one by one and let them fault again.
+        for (size_t i = 0; i < pages_per_huge_page; ++i) {
+            if (!map_individual_page_impl(first_page_index + i)) {
+                dmesgln("MM: handle_zero_fault was unable to allocate a page table to map {}", vaddr_from_page_index(first_page_index + i));
+                return PageFaultResponse::OutOfMemory;
+            }
+        }
+    }
+    MemoryManager::flush_tlb(m_page_directory, huge_page_vaddr, pages_per_huge_page);
+    return PageFaultResponse::Continue;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -450,72 +599,225 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region)
     VERIFY(!g_scheduler_lock.is_locked_by_current_processor());
 
     auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    inode_vmobject.mark_used();
 
     auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
     auto& vmobject_physical_page_entry = inode_vmobject.physical_pages()[page_index_in_vmobject];
 
+    size_t readahead_page_count = 0;
     {
         SpinlockLocker locker(inode_vmobject.m_lock);
         if (!vmobject_physical_page_entry.is_null()) {
             dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else before reading, remapping.");
             if (!remap_vmobject_page(page_index_in_vmobject))
                 return PageFaultResponse::OutOfMemory;
+            map_cached_pages_around(page_index_in_region);
             return PageFaultResponse::Continue;
         }
+
+        // Read in the run of missing pages starting at the faulting one, as far as the readahead window goes.
+        auto readahead_window = inode_vmobject.readahead_page_count_for_fault(page_index_in_vmobject, m_access_pattern);
+        while (readahead_page_count < readahead_window && inode_vmobject.physical_pages()[page_index_in_vmobject + readahead_page_count].is_null())
+            ++readahead_page_count;
     }
 
-    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}", name(), page_index_in_region);
+    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}, reading {} pages", name(), page_index_in_region, readahead_page_count);
 
     auto current_thread = Thread::current();
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
-    auto& inode = inode_vmobject.inode();
-
-    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
-    auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
+    if (auto response = try_handle_huge_inode_fault(page_index_in_region); response.has_value())
+        return response.release_value();
 
+    auto result = read_in_inode_pages(page_index_in_vmobject, readahead_page_count);
     if (result.is_error()) {
-        dmesgln("handle_inode_fault: Error ({}) while reading from inode", result.error());
+        if (result.error().code() == ENOMEM)
+            return PageFaultResponse::OutOfMemory;
         return PageFaultResponse::ShouldCrash;
     }
 
-    auto nread = result.value();
-    if (nread < PAGE_SIZE) {
-        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
-        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+    SpinlockLocker locker(inode_vmobject.m_lock);
+    if (!remap_vmobject_page(page_index_in_vmobject))
+        return PageFaultResponse::OutOfMemory;
+    map_cached_pages_around(page_index_in_region);
+
+    return PageFaultResponse::Continue;
+}
+
+Optional<PageFaultResponse> Region::try_handle_huge_inode_fault(size_t page_index_in_region)
+{
+    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    if (!is_user() || is_write_combine() || !m_page_directory || !inode_vmobject.shares_inode_pages())
+        return {};
+    auto huge_page_vaddr = VirtualAddress(vaddr_from_page_index(page_index_in_region).get() & ~(huge_page_size - 1));
+    if (huge_page_vaddr < vaddr() || !contains(VirtualRange { huge_page_vaddr, huge_page_size }))
+        return {};
+    auto first_page_index = page_index_from_address(huge_page_vaddr);
+    auto first_page_index_in_vmobject = translate_to_vmobject_page(first_page_index);
+
+    // Only take the pages if the inode has a whole huge page there, we stop at the first one that
+    // doesn't fit so that we don't fill in any more holes of the file than the fault needs.
+    auto& inode = inode_vmobject.inode();
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    for (size_t i = 0; i < pages_per_huge_page; ++i) {
+        auto physical_page_or_error = inode.shareable_physical_page(first_page_index_in_vmobject + i);
+        if (physical_page_or_error.is_error())
+            return {};
+        auto physical_page = physical_page_or_error.release_value();
+        if (!physical_page)
+            return {};
+        if (i == 0 && (physical_page->paddr().get() % huge_page_size) != 0)
+            return {};
+        if (i > 0 && physical_page->paddr() != physical_pages.first().paddr().offset(i * PAGE_SIZE))
+            return {};
+        if (physical_pages.try_append(physical_page.release_nonnull()).is_error())
+            return {};
     }
 
     SpinlockLocker locker(inode_vmobject.m_lock);
+    for (size_t i = 0; i < pages_per_huge_page; ++i)
+        inode_vmobject.physical_pages()[first_page_index_in_vmobject + i] = physical_pages.ptr_at(i);
 
-    if (!vmobject_physical_page_entry.is_null()) {
-        // Someone else faulted in this page while we were reading from the inode.
-        // No harm done (other than some duplicate work), remap the page here and return.
-        dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
-        if (!remap_vmobject_page(page_index_in_vmobject))
-            return PageFaultResponse::OutOfMemory;
-        return PageFaultResponse::Continue;
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    SpinlockLocker lock(s_mm_lock);
+    if (!can_map_huge_page(first_page_index))
+        return {};
+    dbgln_if(PAGE_FAULT_DEBUG, "Inode fault in {} page index: {}, mapping huge page {}", name(), page_index_in_region, physical_pages.first().paddr());
+    map_huge_page_impl(first_page_index);
+    MemoryManager::flush_tlb(m_page_directory, huge_page_vaddr, pages_per_huge_page);
+    return PageFaultResponse::Continue;
+}
+
+ErrorOr<size_t> Region::read_in_inode_pages(size_t page_index_in_vmobject, size_t page_count)
+{
+    VERIFY(page_count > 0);
+    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+
+    if (inode_vmobject.shares_inode_pages()) {
+        // The inode keeps its contents in physical pages, so there's nothing to read, we just use those.
+        auto& inode = inode_vmobject.inode();
+        NonnullRefPtrVector<PhysicalPage> physical_pages;
+        for (size_t i = 0; i < page_count; ++i) {
+            auto physical_page = TRY(inode.shareable_physical_page(page_index_in_vmobject + i));
+            if (!physical_page)
+                break;
+            TRY(physical_pages.try_append(physical_page.release_nonnull()));
+        }
+        // Past the end of the file, we fall back to reading in (zeroed) pages of our own.
+        if (!physical_pages.is_empty()) {
+            SpinlockLocker locker(inode_vmobject.m_lock);
+            for (size_t i = 0; i < physical_pages.size(); ++i)
+                inode_vmobject.physical_pages()[page_index_in_vmobject + i] = physical_pages.ptr_at(i);
+            return physical_pages.size();
+        }
     }
 
-    auto vmobject_physical_page_or_error = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No);
-    if (vmobject_physical_page_or_error.is_error()) {
-        dmesgln("MM: handle_inode_fault was unable to allocate a physical page");
-        return PageFaultResponse::OutOfMemory;
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    for (size_t i = 0; i < page_count; ++i) {
+        auto physical_page_or_error = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No);
+        if (physical_page_or_error.is_error())
+            break;
+        if (physical_pages.try_append(physical_page_or_error.release_value()).is_error())
+            break;
     }
-    vmobject_physical_page_entry = vmobject_physical_page_or_error.release_value();
+    if (physical_pages.is_empty()) {
+        dmesgln("MM: read_in_inode_pages was unable to allocate a physical page");
+        return ENOMEM;
+    }
+    page_count = physical_pages.size();
 
+    // Read straight into the new pages through a temporary kernel mapping.
     {
-        SpinlockLocker mm_locker(s_mm_lock);
-        u8* dest_ptr = MM.quickmap_page(*vmobject_physical_page_entry);
-        memcpy(dest_ptr, page_buffer, PAGE_SIZE);
-        MM.unquickmap_page();
+        auto buffer_vmobject = TRY(AnonymousVMObject::try_create_with_physical_pages(physical_pages.span()));
+        auto buffer_region = TRY(MM.allocate_kernel_region_with_vmobject(move(buffer_vmobject), page_count * PAGE_SIZE, "Inode fault readahead"sv, Region::Access::ReadWrite));
+
+        auto& inode = inode_vmobject.inode();
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(buffer_region->vaddr().as_ptr());
+        // Pages of shared objects are the page cache for read() as well, so they don't need to go through the file system's cache.
+        auto result = inode_vmobject.is_shared_inode()
+            ? inode.read_bytes_for_page_cache(page_index_in_vmobject * PAGE_SIZE, page_count * PAGE_SIZE, buffer)
+            : inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, page_count * PAGE_SIZE, buffer, nullptr);
+
+        if (result.is_error()) {
+            dmesgln("read_in_inode_pages: Error ({}) while reading from inode", result.error());
+            // NOTE: Make sure that this isn't mistaken for running out of memory.
+            if (result.error().code() == ENOMEM)
+                return EIO;
+            return result.release_error();
+        }
+
+        auto nread = result.value();
+        if (nread < page_count * PAGE_SIZE) {
+            // If we read less than we asked for, zero out the rest to avoid leaking uninitialized data.
+            memset(buffer_region->vaddr().as_ptr() + nread, 0, page_count * PAGE_SIZE - nread);
+        }
     }
 
-    if (!remap_vmobject_page(page_index_in_vmobject))
-        return PageFaultResponse::OutOfMemory;
+    SpinlockLocker locker(inode_vmobject.m_lock);
 
-    return PageFaultResponse::Continue;
+    for (size_t i = 0; i < page_count; ++i) {
+        // If someone else faulted in a page while we were reading from the inode, keep theirs.
+        // No harm done (other than some duplicate work).
+        auto& entry = inode_vmobject.physical_pages()[page_index_in_vmobject + i];
+        if (entry.is_null())
+            entry = physical_pages.ptr_at(i);
+    }
+
+    return page_count;
+}
+
+ErrorOr<void> Region::prefetch_inode_pages(size_t first_page_index, size_t page_count)
+{
+    VERIFY(vmobject().is_inode());
+    VERIFY(first_page_index + page_count <= this->page_count());
+
+    // Read in batches as big as the readahead window gets, so the temporary mappings stay small.
+    static constexpr size_t maximum_batch_page_count = 32;
+
+    auto& inode_vmobject = static_cast<InodeVMObject&>(vmobject());
+    inode_vmobject.mark_used();
+
+    auto end_page_index = first_page_index + page_count;
+    for (auto page_index = first_page_index; page_index < end_page_index;) {
+        auto page_index_in_vmobject = translate_to_vmobject_page(page_index);
+        size_t missing_page_count = 0;
+        {
+            SpinlockLocker locker(inode_vmobject.m_lock);
+            while (page_index + missing_page_count < end_page_index
+                && missing_page_count < maximum_batch_page_count
+                && inode_vmobject.physical_pages()[page_index_in_vmobject + missing_page_count].is_null())
+                ++missing_page_count;
+        }
+
+        auto mapped_page_count = missing_page_count > 0 ? TRY(read_in_inode_pages(page_index_in_vmobject, missing_page_count)) : 1;
+        for (size_t i = 0; i < mapped_page_count; ++i) {
+            if (!remap_vmobject_page(page_index_in_vmobject + i))
+                return ENOMEM;
+        }
+        page_index += mapped_page_count;
+    }
+    return {};
+}
+
+void Region::map_cached_pages_around(size_t page_index_in_region)
+{
+    if (!m_page_directory || (!is_readable() && !is_writable()))
+        return;
+
+    auto first_page_index = page_index_in_region & ~(fault_around_page_count - 1);
+    auto end_page_index = min(first_page_index + fault_around_page_count, page_count());
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    SpinlockLocker lock(s_mm_lock);
+    for (size_t page_index = first_page_index; page_index < end_page_index; ++page_index) {
+        if (page_index == page_index_in_region || !physical_page(page_index))
+            continue;
+        // NOTE: These pages were either not mapped at all or are being mapped to the same physical page again,
+        //       so there's nothing stale in any TLB that we'd need to flush.
+        if (!map_individual_page_impl(page_index))
+            break;
+    }
 }
 
 }
@@ -52,6 +52,13 @@ public:
         Yes,
     };
 
+    // How the region is going to be accessed, as told by madvise(). Inode faults use this to decide how far to read ahead.
+    enum class AccessPattern : u8 {
+        Normal,
+        Sequential,
+        Random,
+    };
+
     static ErrorOr<NonnullOwnPtr<Region>> try_create_user_accessible(VirtualRange const&, NonnullRefPtr<VMObject>, size_t offset_in_vmobject, OwnPtr<KString> name, Region::Access access, Cacheable, bool shared);
     static ErrorOr<NonnullOwnPtr<Region>> try_create_kernel_only(VirtualRange const&, NonnullRefPtr<VMObject>, size_t offset_in_vmobject, OwnPtr<KString> name, Region::Access access, Cacheable = Cacheable::Yes);
 
@@ -91,6 +98,12 @@ public:
     [[nodiscard]] bool is_write_combine() const { return m_write_combine; }
     ErrorOr<void> set_write_combine(bool);
 
+    [[nodiscard]] AccessPattern access_pattern() const { return m_access_pattern; }
+    void set_access_pattern(AccessPattern pattern) { m_access_pattern = pattern; }
+
+    // Reads in those of the given pages that the backing inode doesn't have in memory yet, and maps them.
+    ErrorOr<void> prefetch_inode_pages(size_t first_page_index, size_t page_count);
+
     [[nodiscard]] bool is_user() const { return !is_kernel(); }
     [[nodiscard]] bool is_kernel() const { return vaddr().get() < USER_RANGE_BASE || vaddr().get() >= kernel_mapping_base; }
 
@@ -186,7 +199,7 @@ public:
     void unmap(ShouldDeallocateVirtualRange, ShouldFlushTLB = ShouldFlushTLB::Yes);
     void unmap_with_locks_held(ShouldDeallocateVirtualRange, ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock>& pd_locker, SpinlockLocker<RecursiveSpinlock>& mm_locker);
 
-    void remap();
+    void remap(ShouldFlushTLB = ShouldFlushTLB::Yes);
 
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
@@ -196,11 +209,18 @@ public:
     void set_syscall_region(bool b) { m_syscall_region = b; }
 
 private:
+    // How many neighboring, already cached pages an inode fault maps in along with the faulting one.
+    static constexpr size_t fault_around_page_count = 16;
+
     Region(VirtualRange const&, NonnullRefPtr<VMObject>, size_t offset_in_vmobject, OwnPtr<KString>, Region::Access access, Cacheable, bool shared);
 
     [[nodiscard]] bool remap_vmobject_page(size_t page_index, bool with_flush = true);
     [[nodiscard]] bool do_remap_vmobject_page(size_t page_index, bool with_flush = true);
 
+    // Used by page reclaim. Note that the first one takes an index into the region, the second one an index into the VMObject.
+    [[nodiscard]] bool test_and_clear_page_accessed(size_t page_index);
+    void unmap_vmobject_page(size_t page_index);
+
     void set_access_bit(Access access, bool b)
     {
         if (b)
@@ -211,9 +231,17 @@ private:
 
     [[nodiscard]] PageFaultResponse handle_cow_fault(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index);
+    // Reads up to page_count pages of the backing inode into the VMObject, starting at the given page index into it.
+    // Returns how many pages were read, which is less than asked for when physical memory is tight.
+    ErrorOr<size_t> read_in_inode_pages(size_t page_index_in_vmobject, size_t page_count);
+    void map_cached_pages_around(size_t page_index);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index);
+    [[nodiscard]] Optional<PageFaultResponse> try_handle_huge_zero_fault(size_t page_index);
+    [[nodiscard]] Optional<PageFaultResponse> try_handle_huge_inode_fault(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
+    [[nodiscard]] bool can_map_huge_page(size_t page_index) const;
+    void map_huge_page_impl(size_t page_index);
 
     RefPtr<PageDirectory> m_page_directory;
     VirtualRange m_range;
@@ -221,6 +249,7 @@ private:
     NonnullRefPtr<VMObject> m_vmobject;
     OwnPtr<KString> m_name;
     u8 m_access { Region::None };
+    AccessPattern m_access_pattern { AccessPattern::Normal };
     bool m_shared : 1 { false };
     bool m_cacheable : 1 { false };
     bool m_stack : 1 { false };
@@ -13,7 +13,7 @@ namespace Kernel {
 ScopedAddressSpaceSwitcher::ScopedAddressSpaceSwitcher(Process& process)
 {
     VERIFY(Thread::current() != nullptr);
-    m_previous_cr3 = read_cr3();
+    m_previous_cr3 = Processor::active_page_directory();
     Memory::MemoryManager::enter_process_address_space(process);
 }
 
@@ -21,7 +21,7 @@ ScopedAddressSpaceSwitcher::~ScopedAddressSpaceSwitcher()
 {
     InterruptDisabler disabler;
     Thread::current()->regs().cr3 = m_previous_cr3;
-    write_cr3(m_previous_cr3);
+    Processor::activate_page_directory(m_previous_cr3);
 }
 
 }
@@ -6,6 +6,7 @@
 
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 
 namespace Kernel::Memory {
@@ -41,6 +42,9 @@ SharedInodeVMObject::SharedInodeVMObject(SharedInodeVMObject const& other, Fixed
 
 ErrorOr<void> SharedInodeVMObject::sync(off_t offset_in_pages, size_t pages)
 {
+    if (shares_inode_pages())
+        return {};
+
     SpinlockLocker locker(m_lock);
 
     size_t highest_page_to_flush = min(page_count(), offset_in_pages + pages);
@@ -59,4 +63,153 @@ ErrorOr<void> SharedInodeVMObject::sync(off_t offset_in_pages, size_t pages)
     return {};
 }
 
+ErrorOr<void> SharedInodeVMObject::fill_page(size_t page_index, u8 page_buffer[PAGE_SIZE])
+{
+    u64 generation;
+    {
+        SpinlockLocker locker(m_lock);
+        generation = m_page_cache_generation;
+    }
+
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+    auto nread = TRY(m_inode->read_bytes_for_page_cache(page_index * PAGE_SIZE, PAGE_SIZE, buffer));
+    if (nread < PAGE_SIZE) {
+        // If we read less than a page, zero out the rest to avoid leaking uninitialized data.
+        memset(page_buffer + nread, 0, PAGE_SIZE - nread);
+    }
+
+    auto new_page = TRY(MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No));
+    MM.copy_to_physical_page(*new_page, page_buffer);
+
+    SpinlockLocker locker(m_lock);
+    auto& page_slot = m_physical_pages[page_index];
+    if (!page_slot) {
+        // The inode was written to or resized while we were reading from it, so what we read may
+        // already be stale. It's still a valid result for this read, but we can't cache it.
+        if (generation != m_page_cache_generation)
+            return {};
+        page_slot = move(new_page);
+        return {};
+    }
+    // Someone else faulted in this page while we were reading from the inode.
+    // Their copy may already be mapped (and modified), so that's the one we use.
+    RefPtr<PhysicalPage> existing_page = page_slot;
+    locker.unlock();
+    MM.copy_physical_page(*existing_page, page_buffer);
+    return {};
+}
+
+ErrorOr<size_t> SharedInodeVMObject::read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer)
+{
+    VERIFY(offset >= 0);
+    auto inode_size = m_inode->size();
+    if (static_cast<u64>(offset) >= inode_size)
+        return 0;
+    count = min(count, inode_size - offset);
+
+    u8 page_buffer[PAGE_SIZE];
+    size_t nread = 0;
+    while (nread < count) {
+        auto position = offset + nread;
+        auto page_index = position / PAGE_SIZE;
+        auto offset_in_page = position % PAGE_SIZE;
+
+        if (page_index >= page_count()) {
+            // The inode has grown since we were created, we don't cache these pages.
+            auto remaining_buffer = buffer.offset(nread);
+            nread += TRY(m_inode->read_bytes(position, count - nread, remaining_buffer, nullptr));
+            break;
+        }
+
+        RefPtr<PhysicalPage> physical_page;
+        {
+            SpinlockLocker locker(m_lock);
+            physical_page = m_physical_pages[page_index];
+        }
+        if (physical_page)
+            MM.copy_physical_page(*physical_page, page_buffer);
+        else
+            TRY(fill_page(page_index, page_buffer));
+
+        auto nbytes = min(PAGE_SIZE - offset_in_page, count - nread);
+        TRY(buffer.write(page_buffer + offset_in_page, nread, nbytes));
+        nread += nbytes;
+    }
+    return nread;
+}
+
+ErrorOr<void> SharedInodeVMObject::did_write_bytes(off_t offset, size_t count, UserOrKernelBuffer const& data)
+{
+    VERIFY(offset >= 0);
+
+    // The data has already been written to the inode, we just need to make sure that
+    // the pages we have in memory don't go stale.
+    if (shares_inode_pages())
+        return {};
+    {
+        SpinlockLocker locker(m_lock);
+        ++m_page_cache_generation;
+    }
+
+    // Only the bytes that were written are copied into the pages, so that concurrent
+    // writes to other parts of the same page don't undo each other.
+    u8 data_buffer[PAGE_SIZE];
+    size_t nupdated = 0;
+    while (nupdated < count) {
+        auto position = offset + nupdated;
+        auto page_index = position / PAGE_SIZE;
+        auto offset_in_page = position % PAGE_SIZE;
+        if (page_index >= page_count())
+            break;
+        auto nbytes = min(PAGE_SIZE - offset_in_page, count - nupdated);
+
+        RefPtr<PhysicalPage> physical_page;
+        {
+            SpinlockLocker locker(m_lock);
+            physical_page = m_physical_pages[page_index];
+        }
+        if (physical_page) {
+            TRY(data.read(data_buffer, nupdated, nbytes));
+            MM.copy_to_physical_page(*physical_page, offset_in_page, { data_buffer, nbytes });
+        }
+        nupdated += nbytes;
+    }
+    return {};
+}
+
+void SharedInodeVMObject::did_resize(u64 old_size, u64 new_size)
+{
+    SpinlockLocker locker(m_lock);
+    ++m_page_cache_generation;
+
+    // Pages past the new end of the file are dropped, they are read in (or faulted in) again
+    // if the file grows back.
+    bool dropped_pages = false;
+    for (size_t page_index = ceil_div(new_size, static_cast<u64>(PAGE_SIZE)); page_index < page_count(); ++page_index) {
+        if (!m_physical_pages[page_index])
+            continue;
+        m_physical_pages[page_index] = nullptr;
+        m_dirty_pages.set(page_index, false);
+        dropped_pages = true;
+    }
+
+    // Whatever is in the last page past the old end of the file (shared mappings can write there)
+    // must not show up as file data. Inodes that share their pages with us take care of that themselves.
+    auto end_of_data = min(old_size, new_size);
+    auto last_page_index = end_of_data / PAGE_SIZE;
+    auto offset_in_page = end_of_data % PAGE_SIZE;
+    if (!shares_inode_pages() && offset_in_page != 0 && last_page_index < page_count() && m_physical_pages[last_page_index]) {
+        u8 page_buffer[PAGE_SIZE];
+        MM.copy_physical_page(*m_physical_pages[last_page_index], page_buffer);
+        memset(page_buffer + offset_in_page, 0, PAGE_SIZE - offset_in_page);
+        MM.copy_to_physical_page(*m_physical_pages[last_page_index], page_buffer);
+    }
+
+    if (dropped_pages) {
+        for_each_region([](auto& region) {
+            region.remap();
+        });
+    }
+}
+
 }
@@ -20,6 +20,13 @@ public:
 
     ErrorOr<void> sync(off_t offset_in_pages = 0, size_t pages = -1);
 
+    // These let read() and write() go through the same physical pages that back
+    // shared mappings of the inode, so that file data is only cached once.
+    ErrorOr<size_t> read_bytes(off_t offset, size_t count, UserOrKernelBuffer&);
+    ErrorOr<void> did_write_bytes(off_t offset, size_t count, UserOrKernelBuffer const&);
+    // Called by the inode whenever its size changes, so that we don't hold on to pages past its end.
+    void did_resize(u64 old_size, u64 new_size);
+
 private:
     virtual bool is_shared_inode() const override { return true; }
 
@@ -28,6 +35,12 @@ private:
 
     virtual StringView class_name() const override { return "SharedInodeVMObject"sv; }
 
+    ErrorOr<void> fill_page(size_t page_index, u8 page_buffer[PAGE_SIZE]);
+
+    // Bumped (with m_lock held) whenever the inode's contents change behind our back, so that
+    // fill_page() doesn't cache a page it read before the change.
+    u64 m_page_cache_generation { 0 };
+
     SharedInodeVMObject& operator=(SharedInodeVMObject const&) = delete;
 };
 
@@ -35,9 +35,9 @@ MutexProtected<IPv4Socket::List>& IPv4Socket::all_sockets()
     return *s_all_sockets;
 }
 
-ErrorOr<NonnullOwnPtr<DoubleBuffer>> IPv4Socket::try_create_receive_buffer()
+ErrorOr<NonnullOwnPtr<ByteRingBuffer>> IPv4Socket::try_create_receive_buffer()
 {
-    return DoubleBuffer::try_create(256 * KiB);
+    return ByteRingBuffer::try_create(256 * KiB);
 }
 
 ErrorOr<NonnullRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
@@ -57,7 +57,7 @@ ErrorOr<NonnullRefPtr<Socket>> IPv4Socket::create(int type, int protocol)
     return EINVAL;
 }
 
-IPv4Socket::IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer)
+IPv4Socket::IPv4Socket(int type, int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer)
     : Socket(AF_INET, type, protocol)
     , m_receive_buffer(move(receive_buffer))
     , m_scratch_buffer(move(optional_scratch_buffer))
@@ -231,12 +231,9 @@ ErrorOr<size_t> IPv4Socket::sendto(OpenFileDescription&, const UserOrKernelBuffe
             return set_so_error(ENOMEM);
         routing_decision.adapter->fill_in_ipv4_header(*packet, local_address(), routing_decision.next_hop,
             m_peer_address, (IPv4Protocol)protocol(), data_length, m_type_of_service, m_ttl);
-        if (auto result = data.read(packet->buffer->data() + ipv4_payload_offset, data_length); result.is_error()) {
-            routing_decision.adapter->release_packet_buffer(*packet);
+        if (auto result = data.read(packet->buffer->data() + ipv4_payload_offset, data_length); result.is_error())
             return set_so_error(result.release_error());
-        }
         routing_decision.adapter->send_packet(packet->bytes());
-        routing_decision.adapter->release_packet_buffer(*packet);
         return data_length;
     }
 
@@ -278,8 +275,10 @@ ErrorOr<size_t> IPv4Socket::receive_byte_buffered(OpenFileDescription& descripti
     else
         nreceived_or_error = m_receive_buffer->read(buffer, buffer_length);
 
-    if (!nreceived_or_error.is_error() && nreceived_or_error.value() > 0 && !(flags & MSG_PEEK))
+    if (!nreceived_or_error.is_error() && nreceived_or_error.value() > 0 && !(flags & MSG_PEEK)) {
         Thread::current()->did_ipv4_socket_read(nreceived_or_error.value());
+        protocol_did_read_from_receive_buffer();
+    }
 
     set_can_read(!m_receive_buffer->is_empty());
     return nreceived_or_error;
@@ -312,7 +311,7 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
             dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom without blocking {} bytes, packets in queue: {}",
                 this,
-                packet->data->size(),
+                packet->data.size(),
                 m_receive_queue.size());
         }
     }
@@ -349,12 +348,12 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
 
         dbgln_if(IPV4_SOCKET_DEBUG, "IPv4Socket({}): recvfrom with blocking {} bytes, packets in queue: {}",
             this,
-            packet->data->size(),
+            packet->data.size(),
             m_receive_queue.size());
     }
-    VERIFY(packet->data);
+    VERIFY(packet->frame);
 
-    packet_timestamp = packet->timestamp;
+    packet_timestamp = packet->frame->timestamp;
 
     if (addr) {
         dbgln_if(IPV4_SOCKET_DEBUG, "Incoming packet is from: {}:{}", packet->peer_address, packet->peer_port);
@@ -372,12 +371,12 @@ ErrorOr<size_t> IPv4Socket::receive_packet_buffered(OpenFileDescription& descrip
     }
 
     if (type() == SOCK_RAW) {
-        size_t bytes_written = min(packet->data->size(), buffer_length);
-        SOCKET_TRY(buffer.write(packet->data->data(), bytes_written));
+        size_t bytes_written = min(packet->data.size(), buffer_length);
+        SOCKET_TRY(buffer.write(packet->data.data(), bytes_written));
         return bytes_written;
     }
 
-    return protocol_receive(packet->data->bytes(), buffer, buffer_length, flags);
+    return protocol_receive(packet->data, buffer, buffer_length, flags);
 }
 
 ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKernelBuffer& buffer, size_t buffer_length, int flags, Userspace<sockaddr*> user_addr, Userspace<socklen_t*> user_addr_length, Time& packet_timestamp)
@@ -413,7 +412,7 @@ ErrorOr<size_t> IPv4Socket::recvfrom(OpenFileDescription& description, UserOrKer
     return total_nreceived;
 }
 
-bool IPv4Socket::did_receive(const IPv4Address& source_address, u16 source_port, ReadonlyBytes packet, const Time& packet_timestamp)
+bool IPv4Socket::did_receive(const IPv4Address& source_address, u16 source_port, ReadonlyBytes packet, PacketWithTimestamp& frame)
 {
     MutexLocker locker(mutex());
 
@@ -444,12 +443,8 @@ bool IPv4Socket::did_receive(const IPv4Address& source_address, u16 source_port,
             dbgln("IPv4Socket({}): did_receive refusing packet since queue is full.", this);
             return false;
         }
-        auto data_or_error = KBuffer::try_create_with_bytes(packet);
-        if (data_or_error.is_error()) {
-            dbgln("IPv4Socket: did_receive unable to allocate storage for incoming packet.");
-            return false;
-        }
-        m_receive_queue.append({ source_address, source_port, packet_timestamp, data_or_error.release_value() });
+        VERIFY(packet.data() >= frame.buffer->data() && packet.data() + packet.size() <= frame.buffer->data() + frame.buffer->size());
+        m_receive_queue.append({ source_address, source_port, frame, packet });
         set_can_read(true);
     }
     m_bytes_received += packet_size;
@@ -500,10 +495,14 @@ ErrorOr<NonnullOwnPtr<KString>> IPv4Socket::pseudo_path(const OpenFileDescriptio
     return KString::try_create(builder.string_view());
 }
 
-ErrorOr<void> IPv4Socket::setsockopt(int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+ErrorOr<void> IPv4Socket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
 {
+    // NOTE: Only sockets that buffer bytes have a receive buffer we can resize, there's no send buffer at all.
+    if (level == SOL_SOCKET && option == SO_RCVBUF && m_receive_buffer)
+        return set_buffer_size_option(*m_receive_buffer, user_value, user_value_size);
+
     if (level != IPPROTO_IP)
-        return Socket::setsockopt(level, option, user_value, user_value_size);
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
 
     MutexLocker locker(mutex());
 
@@ -568,6 +567,12 @@ ErrorOr<void> IPv4Socket::setsockopt(int level, int option, Userspace<const void
 
 ErrorOr<void> IPv4Socket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
 {
+    if (level == SOL_SOCKET && option == SO_RCVBUF && m_receive_buffer) {
+        socklen_t size;
+        TRY(copy_from_user(&size, value_size.unsafe_userspace_ptr()));
+        return get_buffer_size_option(*m_receive_buffer, value, value_size, size);
+    }
+
     if (level != IPPROTO_IP)
         return Socket::getsockopt(description, level, option, value, value_size);
 
@@ -785,7 +790,7 @@ ErrorOr<void> IPv4Socket::ioctl(OpenFileDescription&, unsigned request, Userspac
             readable = static_cast<int>(m_receive_buffer->immediately_readable());
         } else {
             if (m_receive_queue.size() != 0u) {
-                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data->bytes())));
+                readable = static_cast<int>(TRY(protocol_size(m_receive_queue.first().data)));
             }
         }
 
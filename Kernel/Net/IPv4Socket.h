@@ -8,11 +8,12 @@
 
 #include <AK/HashMap.h>
 #include <AK/SinglyLinkedListWithCount.h>
-#include <Kernel/DoubleBuffer.h>
+#include <Kernel/ByteRingBuffer.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/IPv4SocketTuple.h>
+#include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/Socket.h>
 
 namespace Kernel {
@@ -41,12 +42,13 @@ public:
     virtual bool can_write(const OpenFileDescription&, u64) const override;
     virtual ErrorOr<size_t> sendto(OpenFileDescription&, const UserOrKernelBuffer&, size_t, int, Userspace<const sockaddr*>, socklen_t) override;
     virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&) override;
-    virtual ErrorOr<void> setsockopt(int level, int option, Userspace<const void*>, socklen_t) override;
+    virtual ErrorOr<void> setsockopt(OpenFileDescription&, int level, int option, Userspace<const void*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
 
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
 
-    bool did_receive(const IPv4Address& peer_address, u16 peer_port, ReadonlyBytes, const Time&);
+    // The packet has to point into the frame, which datagram sockets keep around until the packet is read.
+    bool did_receive(const IPv4Address& peer_address, u16 peer_port, ReadonlyBytes packet, PacketWithTimestamp& frame);
 
     const IPv4Address& local_address() const { return m_local_address; }
     u16 local_port() const { return m_local_port; }
@@ -73,7 +75,7 @@ public:
     BufferMode buffer_mode() const { return m_buffer_mode; }
 
 protected:
-    IPv4Socket(int type, int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer);
+    IPv4Socket(int type, int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer, OwnPtr<KBuffer> optional_scratch_buffer);
     virtual StringView class_name() const override { return "IPv4Socket"sv; }
 
     PortAllocationResult allocate_local_port_if_needed();
@@ -86,14 +88,16 @@ protected:
     virtual ErrorOr<u16> protocol_allocate_local_port() { return ENOPROTOOPT; }
     virtual ErrorOr<size_t> protocol_size(ReadonlyBytes /* raw_ipv4_packet */) { return ENOTIMPL; }
     virtual bool protocol_is_disconnected() const { return false; }
+    virtual void protocol_did_read_from_receive_buffer() { }
 
     virtual void shut_down_for_reading() override;
 
     void set_local_address(IPv4Address address) { m_local_address = address; }
     void set_peer_address(IPv4Address address) { m_peer_address = address; }
 
-    static ErrorOr<NonnullOwnPtr<DoubleBuffer>> try_create_receive_buffer();
+    static ErrorOr<NonnullOwnPtr<ByteRingBuffer>> try_create_receive_buffer();
     void drop_receive_buffer();
+    size_t receive_buffer_space() const { return m_receive_buffer ? m_receive_buffer->space_for_writing() : 0; }
 
 private:
     virtual bool is_ipv4() const override { return true; }
@@ -112,13 +116,13 @@ private:
     struct ReceivedPacket {
         IPv4Address peer_address;
         u16 peer_port;
-        Time timestamp;
-        OwnPtr<KBuffer> data;
+        RefPtr<PacketWithTimestamp> frame;
+        ReadonlyBytes data;
     };
 
     SinglyLinkedListWithCount<ReceivedPacket> m_receive_queue;
 
-    OwnPtr<DoubleBuffer> m_receive_buffer;
+    OwnPtr<ByteRingBuffer> m_receive_buffer;
 
     u16 m_local_port { 0 };
     u16 m_peer_port { 0 };
@@ -7,7 +7,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
-#include <Kernel/DoubleBuffer.h>
+#include <Kernel/ByteRingBuffer.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/KString.h>
 #include <Kernel/Locking/Mutex.h>
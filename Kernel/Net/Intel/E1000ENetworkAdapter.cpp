@@ -229,6 +229,7 @@ UNMAP_AFTER_INIT bool E1000ENetworkAdapter::initialize()
     initialize_tx_descriptors();
 
     setup_link();
+    setup_offloads();
     setup_interrupts();
     return true;
 }
@@ -7,10 +7,13 @@
 #include <AK/MACAddress.h>
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/IDs.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Net/Intel/E1000NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Sections.h>
+#include <Kernel/WorkQueue.h>
 
 namespace Kernel {
 
@@ -39,6 +42,7 @@ namespace Kernel {
 #define REG_RADV 0x282C             // RX Int. Absolute Delay Timer
 #define REG_RSRPD 0x2C00            // RX Small Packet Detect Interrupt
 #define REG_TIPG 0x0410             // Transmit Inter Packet Gap
+#define REG_RXCSUM 0x5000           // RX Checksum Control
 #define ECTRL_SLU 0x40              // set link up
 #define RCTL_EN (1 << 1)            // Receiver Enable
 #define RCTL_SBP (1 << 2)           // Store Bad Packets
@@ -81,6 +85,27 @@ namespace Kernel {
 #define CMD_VLE (1 << 6)  // VLAN Packet Enable
 #define CMD_IDE (1 << 7)  // Interrupt Delay Enable
 
+// Extended (context and data) Transmit Descriptors
+
+#define DTYP_DATA (1 << 4)  // Data descriptor, in the same byte as the upper bits of the length
+#define DCMD_TSE (1 << 2)   // TCP Segmentation Enable
+#define DCMD_DEXT (1 << 5)  // Descriptor Extension
+#define TUCMD_TCP (1 << 0)  // Packet is TCP
+#define TUCMD_IP (1 << 1)   // Packet is IPv4
+#define TUCMD_TSE (1 << 2)  // TCP Segmentation Enable
+#define TUCMD_DEXT (1 << 5) // Descriptor Extension
+#define POPTS_IXSM (1 << 0) // Insert IP Checksum
+#define POPTS_TXSM (1 << 1) // Insert TCP/UDP Checksum
+
+// RX Checksum Control and Receive Descriptors
+
+#define RXCSUM_IPOFLD (1 << 8) // IP Checksum Offload Enable
+#define RXCSUM_TUOFLD (1 << 9) // TCP/UDP Checksum Offload Enable
+#define RDESC_STA_DD (1 << 0)  // Descriptor Done
+#define RDESC_STA_IXSM (1 << 2) // Ignore Checksum Indication
+#define RDESC_ERR_TCPE (1 << 5) // TCP/UDP Checksum Error
+#define RDESC_ERR_IPE (1 << 6)  // IP Checksum Error
+
 // TCTL Register
 
 #define TCTL_EN (1 << 1)      // Transmit Enable
@@ -121,6 +146,14 @@ namespace Kernel {
 #define INTERRUPT_TXD_LOW (1 << 15)
 #define INTERRUPT_SRPD (1 << 16)
 
+#define RX_INTERRUPTS (INTERRUPT_RXT0 | INTERRUPT_RXO)
+
+// The interrupt throttling register holds the minimum interval between two interrupts, in 256ns increments.
+static constexpr u32 interrupt_throttling_for_rate(u32 interrupts_per_second)
+{
+    return 1'000'000'000 / 256 / interrupts_per_second;
+}
+
 // https://www.intel.com/content/dam/doc/manual/pci-pci-x-family-gbe-controllers-software-dev-manual.pdf Section 5.2
 UNMAP_AFTER_INIT static bool is_valid_device_id(u16 device_id)
 {
@@ -186,12 +219,27 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_link()
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_interrupts()
 {
-    out32(REG_INTERRUPT_RATE, 6000); // Interrupt rate of 1.536 milliseconds
-    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0 | INTERRUPT_RXO);
+    apply_interrupt_moderation();
+    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_TXDW | RX_INTERRUPTS);
     in32(REG_INTERRUPT_CAUSE_READ);
     enable_irq();
 }
 
+UNMAP_AFTER_INIT void E1000NetworkAdapter::setup_offloads()
+{
+    out32(REG_RXCSUM, in32(REG_RXCSUM) | RXCSUM_IPOFLD | RXCSUM_TUOFLD);
+
+    auto offloads = NetworkOffload::TXChecksum | NetworkOffload::RXChecksum;
+    // A packet for segmentation goes into the TX ring in one piece, next to its context descriptor and
+    // the descriptor that has to stay free. It can be as large as the IPv4 total length allows.
+    constexpr size_t max_segmentation_frame_size = sizeof(EthernetFrameHeader) + NumericLimits<u16>::max();
+    if ((m_number_of_tx_descriptors - 2) * tx_buffer_size >= max_segmentation_frame_size)
+        offloads |= NetworkOffload::TCPSegmentation;
+    else
+        dmesgln("E1000: TX ring of {} descriptors is too small for segmentation offload", m_number_of_tx_descriptors);
+    set_offloads(offloads);
+}
+
 UNMAP_AFTER_INIT bool E1000NetworkAdapter::initialize()
 {
     dmesgln("E1000: Found @ {}", pci_address());
@@ -220,6 +268,7 @@ UNMAP_AFTER_INIT bool E1000NetworkAdapter::initialize()
     initialize_tx_descriptors();
 
     setup_link();
+    setup_offloads();
     setup_interrupts();
 
     m_link_up = ((in32(REG_STATUS) & STATUS_LU) != 0);
@@ -231,8 +280,10 @@ UNMAP_AFTER_INIT E1000NetworkAdapter::E1000NetworkAdapter(PCI::Address address,
     : NetworkAdapter(move(interface_name))
     , PCI::Device(address)
     , IRQHandler(irq)
-    , m_rx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(e1000_rx_desc) * number_of_rx_descriptors).release_value_but_fixme_should_propagate_errors(), "E1000 RX Descriptors", Memory::Region::Access::ReadWrite).release_value())
-    , m_tx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(e1000_tx_desc) * number_of_tx_descriptors).release_value_but_fixme_should_propagate_errors(), "E1000 TX Descriptors", Memory::Region::Access::ReadWrite).release_value())
+    , m_number_of_rx_descriptors(ring_size(kernel_command_line().network_rx_ring_size(), default_number_of_rx_descriptors, max_number_of_descriptors, descriptor_granularity))
+    , m_number_of_tx_descriptors(ring_size(kernel_command_line().network_tx_ring_size(), default_number_of_tx_descriptors, max_number_of_descriptors, descriptor_granularity))
+    , m_rx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(e1000_rx_desc) * m_number_of_rx_descriptors).release_value_but_fixme_should_propagate_errors(), "E1000 RX Descriptors", Memory::Region::Access::ReadWrite).release_value())
+    , m_tx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(e1000_tx_desc) * m_number_of_tx_descriptors).release_value_but_fixme_should_propagate_errors(), "E1000 TX Descriptors", Memory::Region::Access::ReadWrite).release_value())
 {
 }
 
@@ -261,8 +312,8 @@ bool E1000NetworkAdapter::handle_irq(const RegisterState&)
     if (status & INTERRUPT_RXO) {
         dbgln_if(E1000_DEBUG, "E1000: RX buffer overrun");
     }
-    if (status & INTERRUPT_RXT0) {
-        receive();
+    if (status & RX_INTERRUPTS) {
+        schedule_receive_poll();
     }
 
     m_wait_queue.wake_all();
@@ -322,12 +373,12 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::read_mac_address()
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_rx_descriptors()
 {
-    auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
-    constexpr auto rx_buffer_size = 8192;
+    auto* rx_descriptors = (e1000_rx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
     constexpr auto rx_buffer_page_count = rx_buffer_size / PAGE_SIZE;
 
-    m_rx_buffer_region = MM.allocate_contiguous_kernel_region(rx_buffer_size * number_of_rx_descriptors, "E1000 RX buffers", Memory::Region::Access::ReadWrite).release_value();
-    for (size_t i = 0; i < number_of_rx_descriptors; ++i) {
+    m_rx_buffer_region = MM.allocate_contiguous_kernel_region(rx_buffer_size * m_number_of_rx_descriptors, "E1000 RX buffers", Memory::Region::Access::ReadWrite).release_value();
+    m_rx_buffers.resize(m_number_of_rx_descriptors);
+    for (size_t i = 0; i < m_number_of_rx_descriptors; ++i) {
         auto& descriptor = rx_descriptors[i];
         m_rx_buffers[i] = m_rx_buffer_region->vaddr().as_ptr() + rx_buffer_size * i;
         descriptor.addr = m_rx_buffer_region->physical_page(rx_buffer_page_count * i)->paddr().get();
@@ -336,9 +387,9 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_rx_descriptors()
 
     out32(REG_RXDESCLO, m_rx_descriptors_region->physical_page(0)->paddr().get());
     out32(REG_RXDESCHI, 0);
-    out32(REG_RXDESCLEN, number_of_rx_descriptors * sizeof(e1000_rx_desc));
+    out32(REG_RXDESCLEN, m_number_of_rx_descriptors * sizeof(e1000_rx_desc));
     out32(REG_RXDESCHEAD, 0);
-    out32(REG_RXDESCTAIL, number_of_rx_descriptors - 1);
+    out32(REG_RXDESCTAIL, m_number_of_rx_descriptors - 1);
 
     out32(REG_RCTRL, RCTL_EN | RCTL_SBP | RCTL_UPE | RCTL_MPE | RCTL_LBM_NONE | RTCL_RDMTS_HALF | RCTL_BAM | RCTL_SECRC | RCTL_BSIZE_8192);
 }
@@ -347,20 +398,19 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
 {
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
 
-    constexpr auto tx_buffer_size = 8192;
-    constexpr auto tx_buffer_page_count = tx_buffer_size / PAGE_SIZE;
-    m_tx_buffer_region = MM.allocate_contiguous_kernel_region(tx_buffer_size * number_of_tx_descriptors, "E1000 TX buffers", Memory::Region::Access::ReadWrite).release_value();
+    m_tx_buffer_region = MM.allocate_contiguous_kernel_region(tx_buffer_size * m_number_of_tx_descriptors, "E1000 TX buffers", Memory::Region::Access::ReadWrite).release_value();
+    m_tx_buffers.resize(m_number_of_tx_descriptors);
 
-    for (size_t i = 0; i < number_of_tx_descriptors; ++i) {
+    for (size_t i = 0; i < m_number_of_tx_descriptors; ++i) {
         auto& descriptor = tx_descriptors[i];
         m_tx_buffers[i] = m_tx_buffer_region->vaddr().as_ptr() + tx_buffer_size * i;
-        descriptor.addr = m_tx_buffer_region->physical_page(tx_buffer_page_count * i)->paddr().get();
+        descriptor.addr = tx_buffer_physical_address(i);
         descriptor.cmd = 0;
     }
 
     out32(REG_TXDESCLO, m_tx_descriptors_region->physical_page(0)->paddr().get());
     out32(REG_TXDESCHI, 0);
-    out32(REG_TXDESCLEN, number_of_tx_descriptors * sizeof(e1000_tx_desc));
+    out32(REG_TXDESCLEN, m_number_of_tx_descriptors * sizeof(e1000_tx_desc));
     out32(REG_TXDESCHEAD, 0);
     out32(REG_TXDESCTAIL, 0);
 
@@ -425,51 +475,182 @@ u32 E1000NetworkAdapter::in32(u16 address)
     return m_io_base.offset(address).in<u32>();
 }
 
+u64 E1000NetworkAdapter::tx_buffer_physical_address(size_t index) const
+{
+    constexpr auto tx_buffer_page_count = tx_buffer_size / PAGE_SIZE;
+    return m_tx_buffer_region->physical_page(tx_buffer_page_count * index)->paddr().get();
+}
+
 void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
 {
+    VERIFY(payload.size() <= tx_buffer_size);
+    send_frame(payload, {});
+}
+
+void E1000NetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, TransmitOffload const& offload)
+{
+    send_frame(payload, offload);
+}
+
+void E1000NetworkAdapter::send_frame(ReadonlyBytes payload, TransmitOffload const& offload)
+{
+    MutexLocker locker(m_tx_lock);
     disable_irq();
-    size_t tx_current = in32(REG_TXDESCTAIL) % number_of_tx_descriptors;
+    size_t tx_current = in32(REG_TXDESCTAIL) % m_number_of_tx_descriptors;
     dbgln_if(E1000_DEBUG, "E1000: Sending packet ({} bytes)", payload.size());
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
-    auto& descriptor = tx_descriptors[tx_current];
-    VERIFY(payload.size() <= 8192);
-    auto* vptr = (void*)m_tx_buffers[tx_current];
-    memcpy(vptr, payload.data(), payload.size());
-    descriptor.length = payload.size();
-    descriptor.status = 0;
-    descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
-    dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
-    tx_current = (tx_current + 1) % number_of_tx_descriptors;
+
+    bool is_segmenting = offload.segmentation_mss != 0;
+    u8 packet_options = 0;
+    if (!offload.is_empty()) {
+        // The offloads are described by a context descriptor in front of the data descriptors.
+        constexpr u8 ipv4_header_offset = sizeof(EthernetFrameHeader);
+        constexpr u8 tcp_header_offset = ipv4_header_offset + sizeof(IPv4Packet);
+        VERIFY(payload.size() >= tcp_header_offset + sizeof(TCPPacket));
+        auto& tcp_packet = *(TCPPacket const*)(payload.data() + tcp_header_offset);
+        u8 header_size = tcp_header_offset + tcp_packet.header_size();
+
+        auto& context = *(e1000_tx_context_desc*)&tx_descriptors[tx_current];
+        context.ipcss = ipv4_header_offset;
+        context.ipcso = ipv4_header_offset + 10;
+        context.ipcse = tcp_header_offset - 1;
+        context.tucss = tcp_header_offset;
+        context.tucso = tcp_header_offset + 16;
+        context.tucse = 0;
+        u32 command = TUCMD_DEXT | TUCMD_IP | TUCMD_TCP | (is_segmenting ? TUCMD_TSE : 0);
+        u32 payload_length = is_segmenting ? payload.size() - header_size : 0;
+        context.paylen_and_command = payload_length | command << 24;
+        context.status = 0;
+        context.hdrlen = header_size;
+        context.mss = offload.segmentation_mss;
+        tx_current = (tx_current + 1) % m_number_of_tx_descriptors;
+
+        packet_options = POPTS_TXSM;
+        // Every segment gets its own IPv4 header, and with that its own checksum.
+        if (is_segmenting)
+            packet_options |= POPTS_IXSM;
+    }
+
+    VERIFY(payload.size() <= (m_number_of_tx_descriptors - 2) * tx_buffer_size);
+    e1000_tx_desc* last_descriptor = nullptr;
+    size_t offset = 0;
+    do {
+        auto& descriptor = tx_descriptors[tx_current];
+        auto chunk_size = min(payload.size() - offset, tx_buffer_size);
+        memcpy(m_tx_buffers[tx_current], payload.offset(offset), chunk_size);
+        offset += chunk_size;
+
+        // NOTE: This may have been used as a context descriptor before.
+        descriptor.addr = tx_buffer_physical_address(tx_current);
+        descriptor.length = chunk_size;
+        descriptor.status = 0;
+        descriptor.special = 0;
+        u8 command = CMD_IFCS;
+        if (offset == payload.size())
+            command |= CMD_EOP | CMD_RS;
+        if (!offload.is_empty()) {
+            descriptor.cso = DTYP_DATA;
+            descriptor.css = packet_options;
+            command |= DCMD_DEXT | (is_segmenting ? DCMD_TSE : 0);
+        } else {
+            descriptor.cso = 0;
+            descriptor.css = 0;
+        }
+        descriptor.cmd = command;
+        last_descriptor = &descriptor;
+        dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
+        tx_current = (tx_current + 1) % m_number_of_tx_descriptors;
+    } while (offset < payload.size());
+
     cli();
     enable_irq();
     out32(REG_TXDESCTAIL, tx_current);
     for (;;) {
-        if (descriptor.status) {
+        if (last_descriptor->status) {
             sti();
             break;
         }
         m_wait_queue.wait_forever("E1000NetworkAdapter");
     }
-    dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
+    dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)last_descriptor->status);
 }
 
-void E1000NetworkAdapter::receive()
+size_t E1000NetworkAdapter::receive(size_t budget)
 {
-    auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
-    u32 rx_current;
-    for (;;) {
-        rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
-        rx_current = (rx_current + 1) % number_of_rx_descriptors;
-        if (!(rx_descriptors[rx_current].status & 1))
+    auto* rx_descriptors = (e1000_rx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
+    size_t frames_received = 0;
+    while (frames_received < budget) {
+        u32 rx_current = in32(REG_RXDESCTAIL) % m_number_of_rx_descriptors;
+        rx_current = (rx_current + 1) % m_number_of_rx_descriptors;
+        auto& descriptor = rx_descriptors[rx_current];
+        if (!(descriptor.status & RDESC_STA_DD))
             break;
         auto* buffer = m_rx_buffers[rx_current];
-        u16 length = rx_descriptors[rx_current].length;
-        VERIFY(length <= 8192);
-        dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
-        did_receive({ buffer, length });
-        rx_descriptors[rx_current].status = 0;
+        u16 length = descriptor.length;
+        VERIFY(length <= rx_buffer_size);
+        if (!(descriptor.status & RDESC_STA_IXSM) && (descriptor.errors & (RDESC_ERR_IPE | RDESC_ERR_TCPE))) {
+            dbgln_if(E1000_DEBUG, "E1000: Dropping packet with bad checksum, errors={:#02x}", (u8)descriptor.errors);
+        } else {
+            dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
+            did_receive({ buffer, length });
+        }
+        descriptor.status = 0;
         out32(REG_RXDESCTAIL, rx_current);
+        ++frames_received;
+    }
+    return frames_received;
+}
+
+void E1000NetworkAdapter::schedule_receive_poll()
+{
+    if (m_rx_poll_scheduled.exchange(true))
+        return;
+    out32(REG_INTERRUPT_MASK_CLEAR, RX_INTERRUPTS);
+    g_io_work->queue([this]() {
+        poll_receive();
+    });
+}
+
+void E1000NetworkAdapter::poll_receive()
+{
+    auto frames_received = receive(rx_poll_budget);
+    if (update_interrupt_moderation(frames_received))
+        apply_interrupt_moderation();
+
+    if (frames_received == rx_poll_budget) {
+        // There's more where that came from, but let the rest of the work queue have a go first.
+        g_io_work->queue([this]() {
+            poll_receive();
+        });
+        return;
+    }
+
+    m_rx_poll_scheduled = false;
+    out32(REG_INTERRUPT_MASK_SET, RX_INTERRUPTS);
+
+    // NOTE: Another interrupt may have cleared the cause of an RX interrupt while it was masked,
+    //       in which case unmasking it won't fire it, and the frame would sit in the ring.
+    auto* rx_descriptors = (e1000_rx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
+    auto rx_next = (in32(REG_RXDESCTAIL) + 1) % m_number_of_rx_descriptors;
+    if (rx_descriptors[rx_next].status & RDESC_STA_DD)
+        schedule_receive_poll();
+}
+
+void E1000NetworkAdapter::apply_interrupt_moderation()
+{
+    u32 interrupts_per_second = 0;
+    switch (interrupt_moderation()) {
+    case InterruptModeration::LowestLatency:
+        interrupts_per_second = 70000;
+        break;
+    case InterruptModeration::LowLatency:
+        interrupts_per_second = 20000;
+        break;
+    case InterruptModeration::Bulk:
+        interrupts_per_second = 4000;
+        break;
     }
+    out32(REG_INTERRUPT_RATE, interrupt_throttling_for_rate(interrupts_per_second));
 }
 
 i32 E1000NetworkAdapter::link_speed()
@@ -6,11 +6,13 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/OwnPtr.h>
 #include <Kernel/Arch/x86/IO.h>
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/Bus/PCI/Device.h>
 #include <Kernel/Interrupts/IRQHandler.h>
+#include <Kernel/Locking/Mutex.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Random.h>
 
@@ -27,6 +29,7 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffload const&) override;
     virtual bool link_up() override { return m_link_up; };
     virtual i32 link_speed() override;
     virtual bool link_full_duplex() override;
@@ -36,6 +39,7 @@ public:
 protected:
     void setup_interrupts();
     void setup_link();
+    void setup_offloads();
 
     E1000NetworkAdapter(PCI::Address, u8 irq, NonnullOwnPtr<KString>);
     virtual bool handle_irq(const RegisterState&) override;
@@ -60,6 +64,24 @@ protected:
         volatile uint16_t special { 0 };
     };
 
+    // The layout of a TX descriptor with DEXT set in its command, but not in its data type.
+    struct [[gnu::packed]] e1000_tx_context_desc {
+        volatile uint8_t ipcss { 0 };
+        volatile uint8_t ipcso { 0 };
+        volatile uint16_t ipcse { 0 };
+        volatile uint8_t tucss { 0 };
+        volatile uint8_t tucso { 0 };
+        volatile uint16_t tucse { 0 };
+        volatile uint32_t paylen_and_command { 0 };
+        volatile uint8_t status { 0 };
+        volatile uint8_t hdrlen { 0 };
+        volatile uint16_t mss { 0 };
+    };
+    static_assert(sizeof(e1000_tx_context_desc) == sizeof(e1000_tx_desc));
+
+    void send_frame(ReadonlyBytes, TransmitOffload const&);
+    u64 tx_buffer_physical_address(size_t index) const;
+
     virtual void detect_eeprom();
     virtual u32 read_eeprom(u8 address);
     void read_mac_address();
@@ -77,25 +99,37 @@ protected:
     u16 in16(u16 address);
     u32 in32(u16 address);
 
-    void receive();
-
-    static constexpr size_t number_of_rx_descriptors = 256;
-    static constexpr size_t number_of_tx_descriptors = 256;
-
+    size_t receive(size_t budget);
+    void schedule_receive_poll();
+    void poll_receive();
+    void apply_interrupt_moderation();
+
+    static constexpr size_t default_number_of_rx_descriptors = 256;
+    static constexpr size_t default_number_of_tx_descriptors = 256;
+    // NOTE: The ring sizes have to be a multiple of 128 bytes, i.e. 8 descriptors.
+    static constexpr size_t max_number_of_descriptors = 4096;
+    static constexpr size_t descriptor_granularity = 8;
+    static constexpr size_t rx_buffer_size = 8192;
+    static constexpr size_t tx_buffer_size = 8192;
+
+    size_t m_number_of_rx_descriptors { 0 };
+    size_t m_number_of_tx_descriptors { 0 };
     IOAddress m_io_base;
     VirtualAddress m_mmio_base;
     OwnPtr<Memory::Region> m_rx_descriptors_region;
     OwnPtr<Memory::Region> m_tx_descriptors_region;
     OwnPtr<Memory::Region> m_rx_buffer_region;
     OwnPtr<Memory::Region> m_tx_buffer_region;
-    Array<void*, number_of_rx_descriptors> m_rx_buffers;
-    Array<void*, number_of_tx_descriptors> m_tx_buffers;
+    Vector<void*> m_rx_buffers;
+    Vector<void*> m_tx_buffers;
     OwnPtr<Memory::Region> m_mmio_region;
     bool m_has_eeprom { false };
     bool m_use_mmio { false };
     bool m_link_up { false };
+    Atomic<bool> m_rx_poll_scheduled { false };
     EntropySource m_entropy_source;
 
     WaitQueue m_wait_queue;
+    Mutex m_tx_lock { "E1000NetworkAdapter TX" };
 };
 }
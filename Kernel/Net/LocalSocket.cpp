@@ -45,8 +45,8 @@ ErrorOr<void> LocalSocket::try_for_each(Function<ErrorOr<void>(const LocalSocket
 
 ErrorOr<NonnullRefPtr<LocalSocket>> LocalSocket::try_create(int type)
 {
-    auto client_buffer = TRY(DoubleBuffer::try_create());
-    auto server_buffer = TRY(DoubleBuffer::try_create());
+    auto client_buffer = TRY(ByteRingBuffer::try_create());
+    auto server_buffer = TRY(ByteRingBuffer::try_create());
     return adopt_nonnull_ref_or_enomem(new (nothrow) LocalSocket(type, move(client_buffer), move(server_buffer)));
 }
 
@@ -67,7 +67,7 @@ ErrorOr<SocketPair> LocalSocket::try_create_connected_pair(int type)
     return SocketPair { move(description1), move(description2) };
 }
 
-LocalSocket::LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer)
+LocalSocket::LocalSocket(int type, NonnullOwnPtr<ByteRingBuffer> client_buffer, NonnullOwnPtr<ByteRingBuffer> server_buffer)
     : Socket(AF_LOCAL, type, 0)
     , m_for_client(move(client_buffer))
     , m_for_server(move(server_buffer))
@@ -313,7 +313,7 @@ ErrorOr<size_t> LocalSocket::sendto(OpenFileDescription& description, const User
     return nwritten_or_error;
 }
 
-DoubleBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
+ByteRingBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
 {
     auto role = this->role(description);
     if (role == Role::Accepted)
@@ -323,7 +323,7 @@ DoubleBuffer* LocalSocket::receive_buffer_for(OpenFileDescription& description)
     return nullptr;
 }
 
-DoubleBuffer* LocalSocket::send_buffer_for(OpenFileDescription& description)
+ByteRingBuffer* LocalSocket::send_buffer_for(OpenFileDescription& description)
 {
     auto role = this->role(description);
     if (role == Role::Connected)
@@ -391,6 +391,26 @@ ErrorOr<NonnullOwnPtr<KString>> LocalSocket::pseudo_path(const OpenFileDescripti
     return KString::try_create(builder.string_view());
 }
 
+ByteRingBuffer* LocalSocket::buffer_for_option(OpenFileDescription& description, int option)
+{
+    // NOTE: A socket that hasn't connected yet is going to be the connect side, so we already know its buffers.
+    auto role = this->role(description);
+    if (role == Role::None || role == Role::Connecting)
+        return option == SO_SNDBUF ? m_for_server.ptr() : m_for_client.ptr();
+    return option == SO_SNDBUF ? send_buffer_for(description) : receive_buffer_for(description);
+}
+
+ErrorOr<void> LocalSocket::setsockopt(OpenFileDescription& description, int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+{
+    if (level != SOL_SOCKET || (option != SO_SNDBUF && option != SO_RCVBUF))
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
+
+    auto* buffer = buffer_for_option(description, option);
+    if (!buffer)
+        return ENOTCONN;
+    return set_buffer_size_option(*buffer, user_value, user_value_size);
+}
+
 ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
 {
     if (level != SOL_SOCKET)
@@ -403,9 +423,12 @@ ErrorOr<void> LocalSocket::getsockopt(OpenFileDescription& description, int leve
 
     switch (option) {
     case SO_SNDBUF:
-        return ENOTSUP;
-    case SO_RCVBUF:
-        return ENOTSUP;
+    case SO_RCVBUF: {
+        auto* buffer = buffer_for_option(description, option);
+        if (!buffer)
+            return ENOTCONN;
+        return get_buffer_size_option(*buffer, value, value_size, size);
+    }
     case SO_PEERCRED: {
         if (size < sizeof(ucred))
             return EINVAL;
@@ -7,7 +7,7 @@
 #pragma once
 
 #include <AK/IntrusiveList.h>
-#include <Kernel/DoubleBuffer.h>
+#include <Kernel/ByteRingBuffer.h>
 #include <Kernel/Net/Socket.h>
 
 namespace Kernel {
@@ -47,18 +47,20 @@ public:
     virtual bool can_write(const OpenFileDescription&, u64) const override;
     virtual ErrorOr<size_t> sendto(OpenFileDescription&, const UserOrKernelBuffer&, size_t, int, Userspace<const sockaddr*>, socklen_t) override;
     virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&) override;
+    virtual ErrorOr<void> setsockopt(OpenFileDescription&, int level, int option, Userspace<const void*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
     virtual ErrorOr<void> chown(OpenFileDescription&, UserID, GroupID) override;
     virtual ErrorOr<void> chmod(OpenFileDescription&, mode_t) override;
 
 private:
-    explicit LocalSocket(int type, NonnullOwnPtr<DoubleBuffer> client_buffer, NonnullOwnPtr<DoubleBuffer> server_buffer);
+    explicit LocalSocket(int type, NonnullOwnPtr<ByteRingBuffer> client_buffer, NonnullOwnPtr<ByteRingBuffer> server_buffer);
     virtual StringView class_name() const override { return "LocalSocket"sv; }
     virtual bool is_local() const override { return true; }
     bool has_attached_peer(const OpenFileDescription&) const;
-    DoubleBuffer* receive_buffer_for(OpenFileDescription&);
-    DoubleBuffer* send_buffer_for(OpenFileDescription&);
+    ByteRingBuffer* receive_buffer_for(OpenFileDescription&);
+    ByteRingBuffer* send_buffer_for(OpenFileDescription&);
+    ByteRingBuffer* buffer_for_option(OpenFileDescription&, int option);
     NonnullRefPtrVector<OpenFileDescription>& sendfd_queue_for(const OpenFileDescription&);
     NonnullRefPtrVector<OpenFileDescription>& recvfd_queue_for(const OpenFileDescription&);
 
@@ -97,8 +99,8 @@ private:
     bool m_accept_side_fd_open { false };
     OwnPtr<KString> m_path;
 
-    NonnullOwnPtr<DoubleBuffer> m_for_client;
-    NonnullOwnPtr<DoubleBuffer> m_for_server;
+    NonnullOwnPtr<ByteRingBuffer> m_for_client;
+    NonnullOwnPtr<ByteRingBuffer> m_for_server;
 
     NonnullRefPtrVector<OpenFileDescription> m_fds_for_client;
     NonnullRefPtrVector<OpenFileDescription> m_fds_for_server;
@@ -4,7 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <Kernel/Arch/x86/InterruptDisabler.h>
+#include <AK/HashFunctions.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
@@ -23,11 +23,17 @@ NetworkAdapter::~NetworkAdapter()
 {
 }
 
-void NetworkAdapter::send_packet(ReadonlyBytes packet)
+void NetworkAdapter::send_packet(ReadonlyBytes packet, TransmitOffload const& offload)
 {
     m_packets_out++;
     m_bytes_out += packet.size();
-    send_raw(packet);
+    if (offload.is_empty()) {
+        send_raw(packet);
+        return;
+    }
+    VERIFY(!offload.compute_tcp_checksum || has_flag(m_offloads, NetworkOffload::TXChecksum));
+    VERIFY(offload.segmentation_mss == 0 || has_flag(m_offloads, NetworkOffload::TCPSegmentation));
+    send_raw_with_offload(packet, offload);
 }
 
 void NetworkAdapter::send(const MACAddress& destination, const ARPPacket& packet)
@@ -71,15 +77,51 @@ void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Addres
     ipv4.set_checksum(ipv4.compute_checksum());
 }
 
+void NetworkAdapter::set_rx_queue_count(size_t count)
+{
+    VERIFY(count >= 1 && count <= max_rx_queues);
+    SpinlockLocker locker(m_packet_queue_lock);
+    // NOTE: Packets already queued stay where they are, which is fine as long as we only ever add queues.
+    VERIFY(count >= m_rx_queue_count);
+    m_rx_queue_count = count;
+}
+
+size_t NetworkAdapter::rx_queue_for_frame(ReadonlyBytes frame) const
+{
+    if (m_rx_queue_count == 1)
+        return 0;
+
+    // Anything that isn't IPv4 (ARP in particular) is rare enough to always go to the first queue.
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return 0;
+    auto& eth = *(EthernetFrameHeader const*)frame.data();
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+
+    auto& ipv4_packet = *(IPv4Packet const*)eth.payload();
+    u32 hash = pair_int_hash(ipv4_packet.source().to_u32(), ipv4_packet.destination().to_u32());
+    auto protocol = static_cast<IPv4Protocol>(ipv4_packet.protocol());
+    bool has_ports = protocol == IPv4Protocol::TCP || protocol == IPv4Protocol::UDP;
+    if (has_ports && !ipv4_packet.is_a_fragment() && frame.size() >= sizeof(EthernetFrameHeader) + sizeof(IPv4Packet) + sizeof(u32)) {
+        // Both TCP and UDP start out with the source and destination ports.
+        u32 ports;
+        memcpy(&ports, ipv4_packet.payload(), sizeof(ports));
+        hash = pair_int_hash(hash, ports);
+    }
+    return hash % m_rx_queue_count;
+}
+
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
 {
-    InterruptDisabler disabler;
     m_packets_in++;
     m_bytes_in += payload.size();
 
-    if (m_packet_queue_size == max_packet_buffers) {
-        // FIXME: Keep track of the number of dropped packets
-        return;
+    {
+        SpinlockLocker locker(m_packet_queue_lock);
+        if (m_packet_queue_size == max_packet_buffers) {
+            // FIXME: Keep track of the number of dropped packets
+            return;
+        }
     }
 
     auto packet = acquire_packet_buffer(payload.size());
@@ -90,65 +132,163 @@ void NetworkAdapter::did_receive(ReadonlyBytes payload)
 
     memcpy(packet->buffer->data(), payload.data(), payload.size());
 
-    m_packet_queue.append(*packet);
-    m_packet_queue_size++;
+    auto rx_queue = rx_queue_for_frame(payload);
+    {
+        SpinlockLocker locker(m_packet_queue_lock);
+        m_packet_queues[rx_queue].append(*packet);
+        m_packet_queue_size++;
+    }
 
     if (on_receive)
-        on_receive();
+        on_receive(rx_queue);
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
+bool NetworkAdapter::has_queued_packets(size_t rx_queue) const
 {
-    InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
+    SpinlockLocker locker(m_packet_queue_lock);
+    return !m_packet_queues[rx_queue].is_empty();
+}
+
+RefPtr<PacketWithTimestamp> NetworkAdapter::dequeue_packet(size_t rx_queue)
+{
+    SpinlockLocker locker(m_packet_queue_lock);
+    if (m_packet_queues[rx_queue].is_empty())
+        return {};
     m_packet_queue_size--;
-    packet_timestamp = packet_with_timestamp->timestamp;
-    auto& packet_buffer = packet_with_timestamp->buffer;
-    size_t packet_size = packet_buffer->size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet_buffer->data(), packet_size);
-    release_packet_buffer(*packet_with_timestamp);
-    return packet_size;
+    return m_packet_queues[rx_queue].take_first();
 }
 
-RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
+ErrorOr<void> NetworkAdapter::initialize_packet_buffer_pool()
 {
-    InterruptDisabler disabler;
-    if (m_unused_packets.is_empty()) {
-        auto buffer_or_error = KBuffer::try_create_with_size(size, Memory::Region::Access::ReadWrite, "Packet Buffer", AllocationStrategy::AllocateNow);
-        if (buffer_or_error.is_error())
-            return {};
-        auto buffer = buffer_or_error.release_value();
-        auto packet = adopt_ref_if_nonnull(new (nothrow) PacketWithTimestamp { move(buffer), kgettimeofday() });
-        if (!packet)
-            return {};
-        packet->buffer->set_size(size);
-        return packet;
-    }
+    VERIFY(!m_packet_buffer_pool);
+    auto buffer_size = TRY(Memory::page_round_up(layer3_payload_offset() + mtu()));
+    m_packet_buffer_pool = TRY(PacketBufferPool::try_create(buffer_size, max(packet_buffer_pool_bytes / buffer_size, 1ul)));
+    return {};
+}
 
-    auto packet = m_unused_packets.take_first();
-    if (packet->buffer->capacity() >= size) {
-        packet->timestamp = kgettimeofday();
-        packet->buffer->set_size(size);
-        return packet;
-    }
+RefPtr<PacketWithTimestamp> NetworkAdapter::acquire_packet_buffer(size_t size)
+{
+    if (m_packet_buffer_pool)
+        return m_packet_buffer_pool->acquire(size);
+    return PacketWithTimestamp::try_create(size);
+}
 
+RefPtr<PacketWithTimestamp> PacketWithTimestamp::try_create(size_t size)
+{
     auto buffer_or_error = KBuffer::try_create_with_size(size, Memory::Region::Access::ReadWrite, "Packet Buffer", AllocationStrategy::AllocateNow);
     if (buffer_or_error.is_error())
         return {};
-    packet = adopt_ref_if_nonnull(new (nothrow) PacketWithTimestamp { buffer_or_error.release_value(), kgettimeofday() });
+    auto* packet = new (nothrow) PacketWithTimestamp(buffer_or_error.release_value());
     if (!packet)
         return {};
+    packet->timestamp = kgettimeofday();
+    return RefPtr { *packet };
+}
+
+void PacketWithTimestamp::unref() const
+{
+    auto old_ref_count = m_ref_count.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel);
+    VERIFY(old_ref_count > 0);
+    if (old_ref_count != 1)
+        return;
+    if (m_pool) {
+        m_pool->release(*this);
+        return;
+    }
+    delete this;
+}
+
+ErrorOr<NonnullRefPtr<PacketBufferPool>> PacketBufferPool::try_create(size_t buffer_size, size_t buffer_count)
+{
+    auto pool = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) PacketBufferPool(buffer_size)));
+    for (size_t i = 0; i < buffer_count; ++i) {
+        auto buffer = TRY(KBuffer::try_create_with_size(buffer_size, Memory::Region::Access::ReadWrite, "Packet Buffer", AllocationStrategy::AllocateNow));
+        auto* packet = new (nothrow) PacketWithTimestamp(move(buffer));
+        if (!packet)
+            return ENOMEM;
+        pool->m_free_buffers.append(*packet);
+        pool->m_buffer_count++;
+    }
+    return pool;
+}
+
+PacketBufferPool::~PacketBufferPool()
+{
+    // NOTE: Every buffer that is still in use keeps us alive, so they're all in the free list now.
+    VERIFY(m_free_buffers.size_slow() == m_buffer_count);
+    while (!m_free_buffers.is_empty())
+        delete m_free_buffers.take_first();
+}
+
+size_t PacketBufferPool::free_buffer_count() const
+{
+    SpinlockLocker locker(m_lock);
+    return m_free_buffers.size_slow();
+}
+
+RefPtr<PacketWithTimestamp> PacketBufferPool::acquire(size_t size)
+{
+    PacketWithTimestamp* packet = nullptr;
+    if (size <= m_buffer_size) {
+        SpinlockLocker locker(m_lock);
+        if (!m_free_buffers.is_empty())
+            packet = m_free_buffers.take_first();
+    }
+
+    if (!packet) {
+        m_fallback_allocations.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        return PacketWithTimestamp::try_create(size);
+    }
+
+    packet->m_pool = this;
+    packet->timestamp = kgettimeofday();
     packet->buffer->set_size(size);
-    return packet;
+    return RefPtr { *packet };
 }
 
-void NetworkAdapter::release_packet_buffer(PacketWithTimestamp& packet)
+void PacketBufferPool::release(PacketWithTimestamp const& packet)
 {
-    InterruptDisabler disabler;
-    m_unused_packets.append(packet);
+    // NOTE: The packet may hold the last reference to us, so we have to be done with ourselves
+    //       before we let go of it.
+    auto pool = move(packet.m_pool);
+    VERIFY(pool.ptr() == this);
+    SpinlockLocker locker(m_lock);
+    m_free_buffers.append(const_cast<PacketWithTimestamp&>(packet));
+}
+
+size_t NetworkAdapter::ring_size(Optional<size_t> requested_size, size_t default_size, size_t max_size, size_t granularity) const
+{
+    VERIFY(default_size <= max_size && default_size % granularity == 0);
+    if (!requested_size.has_value())
+        return default_size;
+    auto size = clamp(requested_size.value(), granularity, max_size);
+    size -= size % granularity;
+    if (size != requested_size.value())
+        dmesgln("{}: Using a ring size of {} instead of the requested {}", name(), size, requested_size.value());
+    return size;
+}
+
+bool NetworkAdapter::update_interrupt_moderation(size_t frames_received)
+{
+    auto previous_interrupt_moderation = m_interrupt_moderation;
+    // We only ever move one step at a time, so that a single burst doesn't throw us from one extreme to the other.
+    switch (m_interrupt_moderation) {
+    case InterruptModeration::LowestLatency:
+        if (frames_received > 4)
+            m_interrupt_moderation = InterruptModeration::LowLatency;
+        break;
+    case InterruptModeration::LowLatency:
+        if (frames_received <= 2)
+            m_interrupt_moderation = InterruptModeration::LowestLatency;
+        else if (frames_received >= rx_poll_budget / 2)
+            m_interrupt_moderation = InterruptModeration::Bulk;
+        break;
+    case InterruptModeration::Bulk:
+        if (frames_received < rx_poll_budget / 8)
+            m_interrupt_moderation = InterruptModeration::LowLatency;
+        break;
+    }
+    return m_interrupt_moderation != previous_interrupt_moderation;
 }
 
 void NetworkAdapter::set_ipv4_address(const IPv4Address& address)
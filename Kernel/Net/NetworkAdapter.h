@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/MACAddress.h>
@@ -16,6 +19,7 @@
 #include <Kernel/Bus/PCI/Definitions.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/Net/ARP.h>
+#include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/ICMP.h>
 #include <Kernel/Net/IPv4.h>
@@ -27,18 +31,95 @@ class NetworkAdapter;
 
 using NetworkByteBuffer = AK::Detail::ByteBuffer<1500>;
 
-struct PacketWithTimestamp : public RefCounted<PacketWithTimestamp> {
-    PacketWithTimestamp(NonnullOwnPtr<KBuffer> buffer, Time timestamp)
-        : buffer(move(buffer))
-        , timestamp(timestamp)
-    {
-    }
+// Work that an adapter can take off the CPU's hands.
+enum class NetworkOffload : u8 {
+    None = 0,
+    // The adapter computes the TCP checksum of outgoing IPv4 packets.
+    TXChecksum = 1 << 0,
+    // The adapter verifies the checksums of incoming IPv4 packets and drops the ones that are wrong.
+    RXChecksum = 1 << 1,
+    // The adapter splits outgoing TCP segments larger than the MSS into MSS-sized ones by itself.
+    TCPSegmentation = 1 << 2,
+};
+
+AK_ENUM_BITWISE_OPERATORS(NetworkOffload);
+
+// What an outgoing packet needs the adapter to do with it before it goes out.
+struct TransmitOffload {
+    // The checksum field already holds the checksum of the pseudo-header. When segmenting, its length is left out.
+    bool compute_tcp_checksum { false };
+    // For segments that have to be cut into frames with this many bytes of payload, 0 otherwise.
+    u16 segmentation_mss { 0 };
+
+    bool is_empty() const { return !compute_tcp_checksum && segmentation_mss == 0; }
+};
+
+class PacketBufferPool;
+
+// A packet buffer that goes back to the pool it came from once the last reference to it is gone,
+// so that it can be handed from the driver to a socket (and back) without being copied or freed.
+class PacketWithTimestamp {
+    AK_MAKE_NONCOPYABLE(PacketWithTimestamp);
+    AK_MAKE_NONMOVABLE(PacketWithTimestamp);
+
+public:
+    // Allocates a packet buffer that doesn't belong to any pool.
+    static RefPtr<PacketWithTimestamp> try_create(size_t size);
+
+    void ref() const { m_ref_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed); }
+    void unref() const;
 
     ReadonlyBytes bytes() { return buffer->bytes(); }
 
     NonnullOwnPtr<KBuffer> buffer;
     Time timestamp;
     IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
+
+private:
+    friend class PacketBufferPool;
+
+    explicit PacketWithTimestamp(NonnullOwnPtr<KBuffer> buffer)
+        : buffer(move(buffer))
+    {
+    }
+
+    mutable Atomic<u32> m_ref_count { 0 };
+    // NOTE: This is only set while the packet is in use, so that the free list doesn't keep its pool alive.
+    mutable RefPtr<PacketBufferPool> m_pool;
+    mutable IntrusiveListNode<PacketWithTimestamp> m_free_list_node;
+};
+
+// A fixed number of preallocated packet buffers of one size. When it runs dry, or for packets
+// that don't fit, buffers are allocated (and later freed) on demand instead.
+class PacketBufferPool : public RefCounted<PacketBufferPool> {
+public:
+    static ErrorOr<NonnullRefPtr<PacketBufferPool>> try_create(size_t buffer_size, size_t buffer_count);
+    ~PacketBufferPool();
+
+    RefPtr<PacketWithTimestamp> acquire(size_t size);
+
+    size_t buffer_size() const { return m_buffer_size; }
+    size_t buffer_count() const { return m_buffer_count; }
+    size_t free_buffer_count() const;
+    u32 fallback_allocations() const { return m_fallback_allocations.load(AK::MemoryOrder::memory_order_relaxed); }
+
+private:
+    friend class PacketWithTimestamp;
+
+    explicit PacketBufferPool(size_t buffer_size)
+        : m_buffer_size(buffer_size)
+    {
+    }
+
+    void release(PacketWithTimestamp const&);
+
+    using FreeList = IntrusiveList<&PacketWithTimestamp::m_free_list_node>;
+
+    size_t const m_buffer_size;
+    size_t m_buffer_count { 0 };
+    mutable Spinlock m_lock;
+    FreeList m_free_buffers;
+    Atomic<u32> m_fallback_allocations { 0 };
 };
 
 class NetworkAdapter : public RefCounted<NetworkAdapter>
@@ -71,9 +152,15 @@ public:
     void send(const MACAddress&, const ARPPacket&);
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, IPv4Protocol, size_t, u8 type_of_service, u8 ttl);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp);
+    // Received packets are spread across RX queues by flow, so that the queues can be processed
+    // in parallel while the packets of any one connection are still handled in order.
+    static constexpr size_t max_rx_queues = 8;
+    size_t rx_queue_count() const { return m_rx_queue_count; }
+    void set_rx_queue_count(size_t);
+
+    RefPtr<PacketWithTimestamp> dequeue_packet(size_t rx_queue);
 
-    bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
+    bool has_queued_packets(size_t rx_queue) const;
 
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
@@ -83,21 +170,47 @@ public:
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
 
+    // Packet buffers go back to the adapter's pool by themselves once the last reference to them is dropped.
     RefPtr<PacketWithTimestamp> acquire_packet_buffer(size_t);
-    void release_packet_buffer(PacketWithTimestamp&);
+    ErrorOr<void> initialize_packet_buffer_pool();
+    RefPtr<PacketBufferPool> packet_buffer_pool() const { return m_packet_buffer_pool; }
 
     constexpr size_t layer3_payload_offset() const { return sizeof(EthernetFrameHeader); }
     constexpr size_t ipv4_payload_offset() const { return layer3_payload_offset() + sizeof(IPv4Packet); }
 
-    Function<void()> on_receive;
+    Function<void(size_t rx_queue)> on_receive;
 
-    void send_packet(ReadonlyBytes);
+    NetworkOffload offloads() const { return m_offloads; }
+
+    void send_packet(ReadonlyBytes, TransmitOffload const& = {});
 
 protected:
     NetworkAdapter(NonnullOwnPtr<KString>);
     void set_mac_address(const MACAddress& mac_address) { m_mac_address = mac_address; }
     void did_receive(ReadonlyBytes);
     virtual void send_raw(ReadonlyBytes) = 0;
+    // Only called for offloads that the adapter has advertised with set_offloads().
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffload const&) { VERIFY_NOT_REACHED(); }
+    void set_offloads(NetworkOffload offloads) { m_offloads = offloads; }
+
+    // Returns the ring size requested on the kernel command line (if any), adjusted to a multiple
+    // of `granularity` that is at most `max_size`.
+    size_t ring_size(Optional<size_t> requested_size, size_t default_size, size_t max_size, size_t granularity = 1) const;
+
+    // Drivers that support it receive in NAPI style: an RX interrupt masks further RX interrupts
+    // and schedules a poll of the RX ring, which handles at most rx_poll_budget frames per round
+    // and only unmasks the interrupt again once the ring has run dry.
+    static constexpr size_t rx_poll_budget = 64;
+
+    enum class InterruptModeration {
+        LowestLatency,
+        LowLatency,
+        Bulk,
+    };
+    InterruptModeration interrupt_moderation() const { return m_interrupt_moderation; }
+    // Picks how aggressively the hardware should coalesce interrupts, based on how many frames the last
+    // poll round saw. Returns whether the driver needs to reprogram its hardware.
+    bool update_interrupt_moderation(size_t frames_received);
 
 private:
     MACAddress m_mac_address;
@@ -107,18 +220,27 @@ private:
 
     // FIXME: Make this configurable
     static constexpr size_t max_packet_buffers = 1024;
+    // How much memory each adapter sets aside for its packet buffer pool.
+    static constexpr size_t packet_buffer_pool_bytes = 1 * MiB;
 
     using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
 
-    PacketList m_packet_queue;
+    size_t rx_queue_for_frame(ReadonlyBytes) const;
+
+    // NOTE: This protects the RX queues.
+    mutable Spinlock m_packet_queue_lock;
+    Array<PacketList, max_rx_queues> m_packet_queues;
     size_t m_packet_queue_size { 0 };
-    PacketList m_unused_packets;
+    size_t m_rx_queue_count { 1 };
+    RefPtr<PacketBufferPool> m_packet_buffer_pool;
     NonnullOwnPtr<KString> m_name;
     u32 m_packets_in { 0 };
     u32 m_bytes_in { 0 };
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
+    NetworkOffload m_offloads { NetworkOffload::None };
+    InterruptModeration m_interrupt_moderation { InterruptModeration::LowLatency };
 };
 
 }
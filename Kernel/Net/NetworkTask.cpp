@@ -26,41 +26,42 @@
 namespace Kernel {
 
 static void handle_arp(EthernetFrameHeader const&, size_t frame_size);
-static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, Time const& packet_timestamp);
-static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, Time const& packet_timestamp);
-static void handle_udp(IPv4Packet const&, Time const& packet_timestamp);
-static void handle_tcp(IPv4Packet const&, Time const& packet_timestamp);
+static void handle_ipv4(EthernetFrameHeader const&, size_t frame_size, PacketWithTimestamp& frame);
+static void handle_icmp(EthernetFrameHeader const&, IPv4Packet const&, PacketWithTimestamp& frame);
+static void handle_udp(IPv4Packet const&, PacketWithTimestamp& frame);
+static void handle_tcp(IPv4Packet const&, PacketWithTimestamp& frame);
 static void send_delayed_tcp_ack(RefPtr<TCPSocket> socket);
 static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter);
 static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
-static Thread* network_task = nullptr;
-static HashTable<RefPtr<TCPSocket>>* delayed_ack_sockets;
+// Every RX queue of every adapter is served by one of these. Since packets of the same flow always
+// end up in the same queue, they are still handled in order, one after the other.
+struct NetworkWorker {
+    explicit NetworkWorker(size_t rx_queue)
+        : rx_queue(rx_queue)
+    {
+    }
+
+    size_t rx_queue { 0 };
+    Thread* thread { nullptr };
+    WaitQueue packet_wait_queue;
+};
+
+static Array<NetworkWorker*, NetworkAdapter::max_rx_queues> s_workers;
+static size_t s_worker_count = 0;
+static MutexProtected<HashTable<RefPtr<TCPSocket>>>* delayed_ack_sockets;
 
 [[noreturn]] static void NetworkTask_main(void*);
 
 void NetworkTask::spawn()
 {
-    RefPtr<Thread> thread;
-    auto name = KString::try_create("NetworkTask");
-    if (name.is_error())
-        TODO();
-    (void)Process::create_kernel_process(thread, name.release_value(), NetworkTask_main, nullptr);
-    network_task = thread;
-}
+    delayed_ack_sockets = new MutexProtected<HashTable<RefPtr<TCPSocket>>>;
 
-bool NetworkTask::is_current()
-{
-    return Thread::current() == network_task;
-}
+    size_t worker_count = min(static_cast<size_t>(Processor::count()), NetworkAdapter::max_rx_queues);
+    for (size_t i = 0; i < worker_count; ++i)
+        s_workers[i] = new NetworkWorker(i);
 
-void NetworkTask_main(void*)
-{
-    delayed_ack_sockets = new HashTable<RefPtr<TCPSocket>>;
-
-    WaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -70,49 +71,69 @@ void NetworkTask_main(void*)
             adapter.set_ipv4_gateway({ 0, 0, 0, 0 });
         }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
+        adapter.set_rx_queue_count(worker_count);
+        adapter.on_receive = [](size_t rx_queue) {
+            s_workers[rx_queue]->packet_wait_queue.wake_all();
         };
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
-        size_t packet_size = 0;
+    for (size_t i = 0; i < worker_count; ++i) {
+        RefPtr<Thread> thread;
+        auto name = i == 0 ? KString::try_create("NetworkTask"sv) : KString::formatted("NetworkTask #{}", i);
+        if (name.is_error())
+            TODO();
+        (void)Process::create_kernel_process(thread, name.release_value(), NetworkTask_main, s_workers[i]);
+        s_workers[i]->thread = thread;
+    }
+    s_worker_count = worker_count;
+}
+
+bool NetworkTask::is_current()
+{
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        if (s_workers[i]->thread == current_thread)
+            return true;
+    }
+    return false;
+}
+
+void NetworkTask_main(void* worker_ptr)
+{
+    auto& worker = *static_cast<NetworkWorker*>(worker_ptr);
+
+    // NOTE: Packets are handled right in the buffer they were received into, which sockets
+    //       can hold on to instead of copying the packet out of it.
+    auto dequeue_packet = [&worker]() -> RefPtr<PacketWithTimestamp> {
+        RefPtr<PacketWithTimestamp> packet;
         NetworkingManagement::the().for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
+            if (packet || !adapter.has_queued_packets(worker.rx_queue))
                 return;
-            packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
+            packet = adapter.dequeue_packet(worker.rx_queue);
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} queue {} ({} bytes)", adapter.name(), worker.rx_queue, packet ? packet->buffer->size() : 0);
         });
-        return packet_size;
+        return packet;
     };
 
-    size_t buffer_size = 64 * KiB;
-    auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer", Memory::Region::Access::ReadWrite);
-    if (region_or_error.is_error())
-        TODO();
-    auto buffer_region = region_or_error.release_value();
-    auto buffer = (u8*)buffer_region->vaddr().get();
-    Time packet_timestamp;
-
     for (;;) {
-        flush_delayed_tcp_acks();
-        retransmit_tcp_packets();
-        size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
-        if (!packet_size) {
+        // NOTE: The timers are only run by the first worker, there's nothing to gain from contending for them.
+        if (worker.rx_queue == 0) {
+            flush_delayed_tcp_acks();
+            retransmit_tcp_packets();
+        }
+        auto packet = dequeue_packet();
+        if (!packet) {
             auto timeout_time = Time::from_milliseconds(500);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask");
+            [[maybe_unused]] auto result = worker.packet_wait_queue.wait_on(timeout, "NetworkTask");
             continue;
         }
+        size_t packet_size = packet->buffer->size();
         if (packet_size < sizeof(EthernetFrameHeader)) {
             dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
             continue;
         }
-        auto& eth = *(EthernetFrameHeader const*)buffer;
+        auto& eth = *(EthernetFrameHeader const*)packet->buffer->data();
         dbgln_if(ETHERNET_DEBUG, "NetworkTask: From {} to {}, ether_type={:#04x}, packet_size={}", eth.source().to_string(), eth.destination().to_string(), eth.ether_type(), packet_size);
 
         switch (eth.ether_type()) {
@@ -120,7 +141,7 @@ void NetworkTask_main(void*)
             handle_arp(eth, packet_size);
             break;
         case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
+            handle_ipv4(eth, packet_size, *packet);
             break;
         case EtherType::IPv6:
             // ignore
@@ -179,7 +200,7 @@ void handle_arp(EthernetFrameHeader const& eth, size_t frame_size)
     }
 }
 
-void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, Time const& packet_timestamp)
+void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, PacketWithTimestamp& frame)
 {
     constexpr size_t minimum_ipv4_frame_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
     if (frame_size < minimum_ipv4_frame_size) {
@@ -212,18 +233,18 @@ void handle_ipv4(EthernetFrameHeader const& eth, size_t frame_size, Time const&
 
     switch ((IPv4Protocol)packet.protocol()) {
     case IPv4Protocol::ICMP:
-        return handle_icmp(eth, packet, packet_timestamp);
+        return handle_icmp(eth, packet, frame);
     case IPv4Protocol::UDP:
-        return handle_udp(packet, packet_timestamp);
+        return handle_udp(packet, frame);
     case IPv4Protocol::TCP:
-        return handle_tcp(packet, packet_timestamp);
+        return handle_tcp(packet, frame);
     default:
         dbgln_if(IPV4_DEBUG, "handle_ipv4: Unhandled protocol {:#02x}", packet.protocol());
         break;
     }
 }
 
-void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
+void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet, PacketWithTimestamp& frame)
 {
     auto& icmp_header = *static_cast<ICMPHeader const*>(ipv4_packet.payload());
     dbgln_if(ICMP_DEBUG, "handle_icmp: source={}, destination={}, type={:#02x}, code={:#02x}", ipv4_packet.source().to_string(), ipv4_packet.destination().to_string(), icmp_header.type(), icmp_header.code());
@@ -237,7 +258,7 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
             }
         });
         for (auto& socket : icmp_sockets)
-            socket.did_receive(ipv4_packet.source(), 0, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+            socket.did_receive(ipv4_packet.source(), 0, { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame);
     }
 
     auto adapter = NetworkingManagement::the().from_ipv4_address(ipv4_packet.destination());
@@ -270,11 +291,10 @@ void handle_icmp(EthernetFrameHeader const& eth, IPv4Packet const& ipv4_packet,
         response.header.set_checksum(internet_checksum(&response, icmp_packet_size));
         // FIXME: What is the right TTL value here? Is 64 ok? Should we use the same TTL as the echo request?
         adapter->send_packet(packet->bytes());
-        adapter->release_packet_buffer(*packet);
     }
 }
 
-void handle_udp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
+void handle_udp(IPv4Packet const& ipv4_packet, PacketWithTimestamp& frame)
 {
     if (ipv4_packet.payload_size() < sizeof(UDPPacket)) {
         dbgln("handle_udp: Packet too small ({}, need {})", ipv4_packet.payload_size(), sizeof(UDPPacket));
@@ -299,7 +319,7 @@ void handle_udp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
     auto& destination = ipv4_packet.destination();
 
     if (destination == IPv4Address(255, 255, 255, 255) || NetworkingManagement::the().from_ipv4_address(destination) || socket->multicast_memberships().contains_slow(destination))
-        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+        socket->did_receive(ipv4_packet.source(), udp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame);
 }
 
 void send_delayed_tcp_ack(RefPtr<TCPSocket> socket)
@@ -310,13 +330,21 @@ void send_delayed_tcp_ack(RefPtr<TCPSocket> socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    delayed_ack_sockets->with_exclusive([&](auto& sockets) {
+        sockets.set(move(socket));
+    });
 }
 
 void flush_delayed_tcp_acks()
 {
+    // NOTE: The sockets are taken out of the table before we lock them, since
+    //       send_delayed_tcp_ack() locks the table with a socket already locked.
+    auto sockets = delayed_ack_sockets->with_exclusive([](auto& sockets) {
+        return move(sockets);
+    });
+
     Vector<RefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(socket));
@@ -325,13 +353,13 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
-        if (remaining_sockets.size() > 0)
-            dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
+    if (remaining_sockets.is_empty())
+        return;
+    dbgln_if(TCP_DEBUG, "flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
+    delayed_ack_sockets->with_exclusive([&](auto& sockets) {
         for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
-    }
+            sockets.set(move(socket));
+    });
 }
 
 void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter)
@@ -365,10 +393,9 @@ void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, Re
     rst_packet.set_checksum(TCPSocket::compute_tcp_checksum(ipv4_packet.source(), ipv4_packet.destination(), rst_packet, 0));
 
     routing_decision.adapter->send_packet(packet->bytes());
-    routing_decision.adapter->release_packet_buffer(*packet);
 }
 
-void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
+void handle_tcp(IPv4Packet const& ipv4_packet, PacketWithTimestamp& frame)
 {
     if (ipv4_packet.payload_size() < sizeof(TCPPacket)) {
         dbgln("handle_tcp: IPv4 payload is too small to be a TCP packet ({}, need {})", ipv4_packet.payload_size(), sizeof(TCPPacket));
@@ -381,6 +408,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
     size_t maximum_tcp_header_size = 15 * sizeof(u32);
     if (tcp_packet.header_size() < minimum_tcp_header_size || tcp_packet.header_size() > maximum_tcp_header_size) {
         dbgln("handle_tcp: TCP packet header has invalid size {}", tcp_packet.header_size());
+        return;
     }
 
     if (ipv4_packet.payload_size() < tcp_packet.header_size()) {
@@ -459,6 +487,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->receive_syn_options(tcp_packet);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             return;
@@ -472,11 +501,13 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->receive_syn_options(tcp_packet);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->receive_syn_options(tcp_packet);
             (void)socket->send_ack(true);
             socket->set_state(TCPSocket::State::Established);
             socket->set_setup_state(Socket::SetupState::Completed);
@@ -633,7 +664,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
 
         if (tcp_packet.has_fin()) {
             if (payload_size != 0)
-                socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp);
+                socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame);
 
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
             send_delayed_tcp_ack(socket);
@@ -643,7 +674,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, Time const& packet_timestamp)
         }
 
         if (payload_size) {
-            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, packet_timestamp)) {
+            if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), { &ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size() }, frame)) {
                 socket->set_ack_number(tcp_packet.sequence_number() + payload_size);
                 dbgln_if(TCP_DEBUG, "Got packet with ack_no={}, seq_no={}, payload_size={}, acking it with new ack_no={}, seq_no={}",
                     tcp_packet.ack_number(), tcp_packet.sequence_number(), payload_size, socket->ack_number(), socket->sequence_number());
@@ -18,6 +18,7 @@
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/Realtek/RTL8139NetworkAdapter.h>
 #include <Kernel/Net/Realtek/RTL8168NetworkAdapter.h>
+#include <Kernel/Net/VirtIO/VirtIONetworkAdapter.h>
 #include <Kernel/Sections.h>
 
 namespace Kernel {
@@ -106,9 +107,18 @@ UNMAP_AFTER_INIT RefPtr<NetworkAdapter> NetworkingManagement::determine_network_
         return candidate;
     if (auto candidate = NE2000NetworkAdapter::try_to_initialize(device_identifier); !candidate.is_null())
         return candidate;
+    if (auto candidate = VirtIONetworkAdapter::try_to_initialize(device_identifier); !candidate.is_null())
+        return candidate;
     return {};
 }
 
+static void initialize_packet_buffer_pool(NetworkAdapter& adapter)
+{
+    // NOTE: Without a pool, every packet buffer is allocated on demand, which works but is slower.
+    if (auto result = adapter.initialize_packet_buffer_pool(); result.is_error())
+        dmesgln("{}: Failed to preallocate packet buffers: {}", adapter.name(), result.error());
+}
+
 bool NetworkingManagement::initialize()
 {
     if (!kernel_command_line().is_physical_networking_disabled() && !PCI::Access::is_disabled()) {
@@ -116,12 +126,15 @@ bool NetworkingManagement::initialize()
             // Note: PCI class 2 is the class of Network devices
             if (device_identifier.class_code().value() != 0x02)
                 return;
-            if (auto adapter = determine_network_device(device_identifier); !adapter.is_null())
+            if (auto adapter = determine_network_device(device_identifier); !adapter.is_null()) {
+                initialize_packet_buffer_pool(*adapter);
                 m_adapters.with([&](auto& adapters) { adapters.append(adapter.release_nonnull()); });
+            }
         }));
     }
     auto loopback = LoopbackAdapter::try_create();
     VERIFY(loopback);
+    initialize_packet_buffer_pool(*loopback);
     m_adapters.with([&](auto& adapters) { adapters.append(*loopback); });
     m_loopback_adapter = loopback;
     return true;
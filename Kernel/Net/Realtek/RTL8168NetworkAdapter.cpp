@@ -7,10 +7,12 @@
 #include <AK/MACAddress.h>
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/IDs.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/Realtek/RTL8168NetworkAdapter.h>
 #include <Kernel/Sections.h>
+#include <Kernel/WorkQueue.h>
 
 namespace Kernel {
 
@@ -82,6 +84,8 @@ namespace Kernel {
 #define INT_RX_FIFO_OVERFLOW 0x40
 #define INT_SYS_ERR 0x8000
 
+#define RX_INTERRUPTS (INT_RXOK | INT_RX_OVERFLOW | INT_RX_FIFO_OVERFLOW)
+
 #define CFG9346_NONE 0x00
 #define CFG9346_EEM0 0x40
 #define CFG9346_EEM1 0x80
@@ -246,8 +250,10 @@ UNMAP_AFTER_INIT RTL8168NetworkAdapter::RTL8168NetworkAdapter(PCI::Address addre
     , PCI::Device(address)
     , IRQHandler(irq)
     , m_io_base(PCI::get_BAR0(pci_address()) & ~1)
-    , m_rx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(TXDescriptor) * (number_of_rx_descriptors + 1)).release_value_but_fixme_should_propagate_errors(), "RTL8168 RX", Memory::Region::Access::ReadWrite).release_value())
-    , m_tx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(RXDescriptor) * (number_of_tx_descriptors + 1)).release_value_but_fixme_should_propagate_errors(), "RTL8168 TX", Memory::Region::Access::ReadWrite).release_value())
+    , m_number_of_rx_descriptors(ring_size(kernel_command_line().network_rx_ring_size(), default_number_of_rx_descriptors, max_number_of_descriptors))
+    , m_number_of_tx_descriptors(ring_size(kernel_command_line().network_tx_ring_size(), default_number_of_tx_descriptors, max_number_of_descriptors))
+    , m_rx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(TXDescriptor) * (m_number_of_rx_descriptors + 1)).release_value_but_fixme_should_propagate_errors(), "RTL8168 RX", Memory::Region::Access::ReadWrite).release_value())
+    , m_tx_descriptors_region(MM.allocate_contiguous_kernel_region(Memory::page_round_up(sizeof(RXDescriptor) * (m_number_of_tx_descriptors + 1)).release_value_but_fixme_should_propagate_errors(), "RTL8168 TX", Memory::Region::Access::ReadWrite).release_value())
 {
     dmesgln("RTL8168: Found @ {}", pci_address());
     dmesgln("RTL8168: I/O port base: {}", m_io_base);
@@ -397,7 +403,8 @@ void RTL8168NetworkAdapter::startup()
         enabled_interrupts |= INT_RX_FIFO_OVERFLOW;
         enabled_interrupts &= ~INT_RX_OVERFLOW;
     }
-    out16(REG_IMR, enabled_interrupts);
+    m_interrupt_mask = enabled_interrupts;
+    out16(REG_IMR, m_interrupt_mask);
 
     // update link status
     m_link_up = (in8(REG_PHYSTATUS) & PHY_LINK_STATUS) != 0;
@@ -806,8 +813,8 @@ void RTL8168NetworkAdapter::start_hardware()
     cplus_command |= 0x1;
     out16(REG_CPLUS_COMMAND, cplus_command);
 
-    // setup interrupt moderation, magic from vendor (Linux Driver uses 0x5151, *BSD Driver uses 0x5100, RTL Driver use 0x5f51???)
-    out16(REG_INT_MOD, 0x5151);
+    // setup interrupt moderation
+    apply_interrupt_moderation();
 
     // point to tx descriptors
     out64(REG_TXADDR, m_tx_descriptors_region->physical_page(0)->paddr().get());
@@ -1093,7 +1100,7 @@ void RTL8168NetworkAdapter::set_phy_speed()
 UNMAP_AFTER_INIT void RTL8168NetworkAdapter::initialize_rx_descriptors()
 {
     auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
-    for (size_t i = 0; i < number_of_rx_descriptors; ++i) {
+    for (size_t i = 0; i < m_number_of_rx_descriptors; ++i) {
         auto& descriptor = rx_descriptors[i];
         auto region = MM.allocate_contiguous_kernel_region(Memory::page_round_up(RX_BUFFER_SIZE).release_value_but_fixme_should_propagate_errors(), "RTL8168 RX buffer", Memory::Region::Access::ReadWrite).release_value();
         memset(region->vaddr().as_ptr(), 0, region->size()); // MM already zeros out newly allocated pages, but we do it again in case that ever changes
@@ -1105,13 +1112,13 @@ UNMAP_AFTER_INIT void RTL8168NetworkAdapter::initialize_rx_descriptors()
         descriptor.buffer_address_low = physical_address & 0xFFFFFFFF;
         descriptor.buffer_address_high = (u64)physical_address >> 32; // cast to prevent shift count >= with of type warnings in 32 bit systems
     }
-    rx_descriptors[number_of_rx_descriptors - 1].flags = rx_descriptors[number_of_rx_descriptors - 1].flags | RXDescriptor::EndOfRing;
+    rx_descriptors[m_number_of_rx_descriptors - 1].flags = rx_descriptors[m_number_of_rx_descriptors - 1].flags | RXDescriptor::EndOfRing;
 }
 
 UNMAP_AFTER_INIT void RTL8168NetworkAdapter::initialize_tx_descriptors()
 {
     auto* tx_descriptors = (TXDescriptor*)m_tx_descriptors_region->vaddr().as_ptr();
-    for (size_t i = 0; i < number_of_tx_descriptors; ++i) {
+    for (size_t i = 0; i < m_number_of_tx_descriptors; ++i) {
         auto& descriptor = tx_descriptors[i];
         auto region = MM.allocate_contiguous_kernel_region(Memory::page_round_up(TX_BUFFER_SIZE).release_value_but_fixme_should_propagate_errors(), "RTL8168 TX buffer", Memory::Region::Access::ReadWrite).release_value();
         memset(region->vaddr().as_ptr(), 0, region->size()); // MM already zeros out newly allocated pages, but we do it again in case that ever changes
@@ -1122,7 +1129,7 @@ UNMAP_AFTER_INIT void RTL8168NetworkAdapter::initialize_tx_descriptors()
         descriptor.buffer_address_low = physical_address & 0xFFFFFFFF;
         descriptor.buffer_address_high = (u64)physical_address >> 32;
     }
-    tx_descriptors[number_of_tx_descriptors - 1].flags = tx_descriptors[number_of_tx_descriptors - 1].flags | TXDescriptor::EndOfRing;
+    tx_descriptors[m_number_of_tx_descriptors - 1].flags = tx_descriptors[m_number_of_tx_descriptors - 1].flags | TXDescriptor::EndOfRing;
 }
 
 UNMAP_AFTER_INIT RTL8168NetworkAdapter::~RTL8168NetworkAdapter()
@@ -1140,13 +1147,14 @@ bool RTL8168NetworkAdapter::handle_irq(const RegisterState&)
 
         dbgln_if(RTL8168_DEBUG, "RTL8168: handle_irq status={:#04x}", status);
 
-        if ((status & (INT_RXOK | INT_RXERR | INT_TXOK | INT_TXERR | INT_RX_OVERFLOW | INT_LINK_CHANGE | INT_RX_FIFO_OVERFLOW | INT_SYS_ERR)) == 0)
+        // NOTE: The RX bits keep getting set while we're polling with them masked, don't spin on them.
+        if ((status & m_interrupt_mask) == 0)
             break;
 
         was_handled = true;
         if (status & INT_RXOK) {
             dbgln_if(RTL8168_DEBUG, "RTL8168: RX ready");
-            receive();
+            schedule_receive_poll();
         }
         if (status & INT_RXERR) {
             dbgln_if(RTL8168_DEBUG, "RTL8168: RX error - invalid packet");
@@ -1160,7 +1168,7 @@ bool RTL8168NetworkAdapter::handle_irq(const RegisterState&)
         }
         if (status & INT_RX_OVERFLOW) {
             dmesgln("RTL8168: RX descriptor unavailable (packet lost)");
-            receive();
+            schedule_receive_poll();
         }
         if (status & INT_LINK_CHANGE) {
             m_link_up = (in8(REG_PHYSTATUS) & PHY_LINK_STATUS) != 0;
@@ -1168,7 +1176,7 @@ bool RTL8168NetworkAdapter::handle_irq(const RegisterState&)
         }
         if (status & INT_RX_FIFO_OVERFLOW) {
             dmesgln("RTL8168: RX FIFO overflow");
-            receive();
+            schedule_receive_poll();
         }
         if (status & INT_SYS_ERR) {
             dmesgln("RTL8168: Fatal system error");
@@ -1177,6 +1185,57 @@ bool RTL8168NetworkAdapter::handle_irq(const RegisterState&)
     return was_handled;
 }
 
+void RTL8168NetworkAdapter::schedule_receive_poll()
+{
+    if (m_rx_poll_scheduled.exchange(true))
+        return;
+    out16(REG_IMR, m_interrupt_mask & ~RX_INTERRUPTS);
+    g_io_work->queue([this]() {
+        poll_receive();
+    });
+}
+
+void RTL8168NetworkAdapter::poll_receive()
+{
+    auto frames_received = receive(rx_poll_budget);
+    if (update_interrupt_moderation(frames_received))
+        apply_interrupt_moderation();
+
+    if (frames_received == rx_poll_budget) {
+        // There's more where that came from, but let the rest of the work queue have a go first.
+        g_io_work->queue([this]() {
+            poll_receive();
+        });
+        return;
+    }
+
+    m_rx_poll_scheduled = false;
+    out16(REG_IMR, m_interrupt_mask);
+
+    // NOTE: The status bits of anything that arrived while we were masked were already acknowledged
+    //       by handle_irq(), so unmasking won't raise an interrupt for them.
+    auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
+    if ((rx_descriptors[m_rx_free_index].flags & RXDescriptor::Ownership) == 0)
+        schedule_receive_poll();
+}
+
+void RTL8168NetworkAdapter::apply_interrupt_moderation()
+{
+    // NOTE: The layout of this register isn't documented, these are magic values from the vendor drivers
+    //       (Linux uses 0x5151, *BSD uses 0x5100, the RTL driver uses 0x5f51).
+    switch (interrupt_moderation()) {
+    case InterruptModeration::LowestLatency:
+        out16(REG_INT_MOD, 0);
+        break;
+    case InterruptModeration::LowLatency:
+        out16(REG_INT_MOD, 0x5151);
+        break;
+    case InterruptModeration::Bulk:
+        out16(REG_INT_MOD, 0x5f51);
+        break;
+    }
+}
+
 void RTL8168NetworkAdapter::reset()
 {
     out8(REG_COMMAND, COMMAND_RESET);
@@ -1215,7 +1274,7 @@ void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
     dbgln_if(RTL8168_DEBUG, "RTL8168: Chose descriptor {}", m_tx_free_index);
     memcpy(m_tx_buffers_regions[m_tx_free_index].vaddr().as_ptr(), payload.data(), payload.size());
 
-    m_tx_free_index = (m_tx_free_index + 1) % number_of_tx_descriptors;
+    m_tx_free_index = (m_tx_free_index + 1) % m_number_of_tx_descriptors;
 
     free_descriptor.frame_length = payload.size() & 0x3FFF;
     free_descriptor.flags = free_descriptor.flags | TXDescriptor::Ownership;
@@ -1223,17 +1282,16 @@ void RTL8168NetworkAdapter::send_raw(ReadonlyBytes payload)
     out8(REG_TXSTART, TXSTART_START); // FIXME: this shouldn't be done so often, we should look into doing this using the watchdog timer
 }
 
-void RTL8168NetworkAdapter::receive()
+size_t RTL8168NetworkAdapter::receive(size_t budget)
 {
     auto* rx_descriptors = (RXDescriptor*)m_rx_descriptors_region->vaddr().as_ptr();
-    for (u16 i = 0; i < number_of_rx_descriptors; ++i) {
-        auto descriptor_index = (m_rx_free_index + i) % number_of_rx_descriptors;
+    size_t frames_received = 0;
+    for (; frames_received < budget; ++frames_received) {
+        auto descriptor_index = m_rx_free_index;
         auto& descriptor = rx_descriptors[descriptor_index];
 
-        if ((descriptor.flags & RXDescriptor::Ownership) != 0) {
-            m_rx_free_index = descriptor_index;
+        if ((descriptor.flags & RXDescriptor::Ownership) != 0)
             break;
-        }
 
         u16 flags = descriptor.flags;
         u16 length = descriptor.buffer_size & 0x3FFF;
@@ -1252,10 +1310,12 @@ void RTL8168NetworkAdapter::receive()
 
         descriptor.buffer_size = RX_BUFFER_SIZE;
         flags = RXDescriptor::Ownership;
-        if (descriptor_index == number_of_rx_descriptors - 1)
+        if (descriptor_index == m_number_of_rx_descriptors - 1)
             flags |= RXDescriptor::EndOfRing;
         descriptor.flags = flags; // let the NIC know it can use this descriptor again
+        m_rx_free_index = (m_rx_free_index + 1) % m_number_of_rx_descriptors;
     }
+    return frames_received;
 }
 
 void RTL8168NetworkAdapter::out8(u16 address, u8 data)
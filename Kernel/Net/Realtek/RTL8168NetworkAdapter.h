@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <Kernel/Arch/x86/IO.h>
@@ -34,9 +35,11 @@ public:
     virtual StringView purpose() const override { return class_name(); }
 
 private:
-    // FIXME: should this be increased? (maximum allowed here is 1024) - memory usage vs packet loss chance tradeoff
-    static const size_t number_of_rx_descriptors = 64;
-    static const size_t number_of_tx_descriptors = 16;
+    // NOTE: These can be changed with the net_rx_ring_size and net_tx_ring_size boot parameters,
+    //       trading memory usage for a lower chance of packet loss.
+    static const size_t default_number_of_rx_descriptors = 64;
+    static const size_t default_number_of_tx_descriptors = 16;
+    static const size_t max_number_of_descriptors = 1024;
 
     RTL8168NetworkAdapter(PCI::Address, u8 irq, NonnullOwnPtr<KString>);
 
@@ -149,7 +152,10 @@ private:
     void initialize_rx_descriptors();
     void initialize_tx_descriptors();
 
-    void receive();
+    size_t receive(size_t budget);
+    void schedule_receive_poll();
+    void poll_receive();
+    void apply_interrupt_moderation();
 
     void out8(u16 address, u8 data);
     void out16(u16 address, u16 data);
@@ -201,6 +207,8 @@ private:
     bool m_version_uncertain { true };
     IOAddress m_io_base;
     u32 m_ocp_base_address { 0 };
+    size_t m_number_of_rx_descriptors { 0 };
+    size_t m_number_of_tx_descriptors { 0 };
     OwnPtr<Memory::Region> m_rx_descriptors_region;
     NonnullOwnPtrVector<Memory::Region> m_rx_buffers_regions;
     u16 m_rx_free_index { 0 };
@@ -208,6 +216,8 @@ private:
     NonnullOwnPtrVector<Memory::Region> m_tx_buffers_regions;
     u16 m_tx_free_index { 0 };
     bool m_link_up { false };
+    u16 m_interrupt_mask { 0 };
+    Atomic<bool> m_rx_poll_scheduled { false };
     EntropySource m_entropy_source;
     WaitQueue m_wait_queue;
 };
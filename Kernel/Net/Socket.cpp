@@ -6,6 +6,7 @@
 
 #include <AK/StringView.h>
 #include <Kernel/API/POSIX/errno.h>
+#include <Kernel/ByteRingBuffer.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/Net/IPv4Socket.h>
@@ -76,7 +77,7 @@ ErrorOr<void> Socket::queue_connection_from(NonnullRefPtr<Socket> peer)
     return {};
 }
 
-ErrorOr<void> Socket::setsockopt(int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+ErrorOr<void> Socket::setsockopt(OpenFileDescription&, int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
 {
     MutexLocker locker(mutex());
 
@@ -133,6 +134,26 @@ ErrorOr<void> Socket::setsockopt(int level, int option, Userspace<const void*> u
     }
 }
 
+ErrorOr<void> Socket::set_buffer_size_option(ByteRingBuffer& buffer, Userspace<const void*> user_value, socklen_t user_value_size)
+{
+    if (user_value_size != sizeof(int))
+        return EINVAL;
+    auto value = TRY(copy_typed_from_user(static_ptr_cast<int const*>(user_value)));
+    if (value <= 0)
+        return EINVAL;
+    return buffer.try_resize(value);
+}
+
+ErrorOr<void> Socket::get_buffer_size_option(ByteRingBuffer const& buffer, Userspace<void*> value, Userspace<socklen_t*> value_size, socklen_t size)
+{
+    if (size < sizeof(int))
+        return EINVAL;
+    int capacity = buffer.capacity();
+    TRY(copy_to_user(static_ptr_cast<int*>(value), &capacity));
+    size = sizeof(int);
+    return copy_to_user(value_size, &size);
+}
+
 ErrorOr<void> Socket::getsockopt(OpenFileDescription&, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
 {
     MutexLocker locker(mutex());
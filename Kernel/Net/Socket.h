@@ -88,7 +88,7 @@ public:
     virtual ErrorOr<size_t> sendto(OpenFileDescription&, const UserOrKernelBuffer&, size_t, int flags, Userspace<const sockaddr*>, socklen_t) = 0;
     virtual ErrorOr<size_t> recvfrom(OpenFileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&) = 0;
 
-    virtual ErrorOr<void> setsockopt(int level, int option, Userspace<const void*>, socklen_t);
+    virtual ErrorOr<void> setsockopt(OpenFileDescription&, int level, int option, Userspace<const void*>, socklen_t);
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>);
 
     ProcessID origin_pid() const { return m_origin.pid; }
@@ -123,6 +123,10 @@ protected:
     size_t backlog() const { return m_backlog; }
     void set_backlog(size_t backlog) { m_backlog = backlog; }
 
+    // SO_SNDBUF and SO_RCVBUF for sockets with a ByteRingBuffer behind them, the value is an int.
+    static ErrorOr<void> set_buffer_size_option(ByteRingBuffer&, Userspace<const void*>, socklen_t);
+    static ErrorOr<void> get_buffer_size_option(ByteRingBuffer const&, Userspace<void*>, Userspace<socklen_t*>, socklen_t);
+
     virtual StringView class_name() const override { return "Socket"sv; }
 
     virtual void shut_down_for_reading() { }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Span.h>
 #include <AK/StdLibExtras.h>
 #include <Kernel/Net/IPv4.h>
 
@@ -22,6 +23,15 @@ struct TCPFlags {
     };
 };
 
+enum class TCPOptionKind : u8 {
+    End = 0,
+    NOP = 1,
+    MSS = 2,
+    WindowScale = 3,
+    SACKPermitted = 4,
+    SACK = 5,
+};
+
 class [[gnu::packed]] TCPOptionMSS {
 public:
     TCPOptionMSS(u16 value)
@@ -39,6 +49,42 @@ private:
 
 static_assert(AssertSize<TCPOptionMSS, 4>());
 
+// RFC 7323: The window field of every non-SYN segment is shifted left by this many bits.
+class [[gnu::packed]] TCPOptionWindowScale {
+public:
+    TCPOptionWindowScale(u8 shift_count)
+        : m_shift_count(shift_count)
+    {
+    }
+
+    u8 shift_count() const { return m_shift_count; }
+
+private:
+    u8 m_option_kind { to_underlying(TCPOptionKind::WindowScale) };
+    u8 m_option_length { sizeof(TCPOptionWindowScale) };
+    u8 m_shift_count { 0 };
+};
+
+static_assert(AssertSize<TCPOptionWindowScale, 3>());
+
+// RFC 2018: Sent in a SYN to say that SACK options may be sent to us once the connection is open.
+class [[gnu::packed]] TCPOptionSACKPermitted {
+private:
+    u8 m_option_kind { to_underlying(TCPOptionKind::SACKPermitted) };
+    u8 m_option_length { sizeof(TCPOptionSACKPermitted) };
+};
+
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+
+// RFC 2018: The SACK option carries a list of these, each describing a block of data the peer has
+// already received beyond the cumulative ACK. The right edge is the sequence number right after the block.
+struct [[gnu::packed]] TCPSACKBlock {
+    NetworkOrdered<u32> left_edge;
+    NetworkOrdered<u32> right_edge;
+};
+
+static_assert(AssertSize<TCPSACKBlock, 8>());
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
@@ -78,6 +124,13 @@ public:
     u16 urgent() const { return m_urgent; }
     void set_urgent(u16 urgent) { m_urgent = urgent; }
 
+    ReadonlyBytes options() const
+    {
+        if (header_size() <= sizeof(TCPPacket))
+            return {};
+        return { ((const u8*)this) + sizeof(TCPPacket), header_size() - sizeof(TCPPacket) };
+    }
+
     const void* payload() const { return ((const u8*)this) + header_size(); }
     void* payload() { return ((u8*)this) + header_size(); }
 
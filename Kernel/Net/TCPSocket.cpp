@@ -19,9 +19,58 @@
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Process.h>
 #include <Kernel/Random.h>
+#include <Kernel/Tracepoint.h>
 
 namespace Kernel {
 
+// Sequence numbers wrap around, so they can only be compared relative to each other.
+static bool sequence_number_is_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
+static bool sequence_number_is_at_or_before(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) <= 0;
+}
+
+static u16 mss_for_adapter(NetworkAdapter const& adapter)
+{
+    return adapter.mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+}
+
+// RFC 6928
+static u32 initial_congestion_window(u16 mss)
+{
+    return min(10u * mss, max(2u * mss, 14600u));
+}
+
+// The largest window the peer can advertise with window scaling (RFC 7323).
+static constexpr u32 maximum_congestion_window = 65535u << 14;
+
+template<typename Callback>
+static void for_each_tcp_option(TCPPacket const& packet, Callback callback)
+{
+    auto options = packet.options();
+    size_t offset = 0;
+    while (offset < options.size()) {
+        auto kind = static_cast<TCPOptionKind>(options[offset]);
+        if (kind == TCPOptionKind::End)
+            return;
+        if (kind == TCPOptionKind::NOP) {
+            ++offset;
+            continue;
+        }
+        if (offset + 1 >= options.size())
+            return;
+        u8 length = options[offset + 1];
+        if (length < 2 || offset + length > options.size())
+            return;
+        callback(kind, options.slice(offset + 2, length - 2));
+        offset += length;
+    }
+}
+
 void TCPSocket::for_each(Function<void(const TCPSocket&)> callback)
 {
     sockets_by_tuple().for_each_shared([&](const auto& it) {
@@ -162,10 +211,11 @@ void TCPSocket::release_for_accept(RefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(*socket);
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
 {
     m_last_retransmit_time = kgettimeofday();
+    m_congestion_window = initial_congestion_window(m_send_mss);
 }
 
 TCPSocket::~TCPSocket()
@@ -175,7 +225,7 @@ TCPSocket::~TCPSocket()
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
 
-ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer)
 {
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size(65536));
@@ -205,8 +255,16 @@ ErrorOr<size_t> TCPSocket::protocol_send(const UserOrKernelBuffer& data, size_t
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-    data_length = min(data_length, mss);
+    size_t mss = min(mss_for_adapter(*routing_decision.adapter), m_send_mss);
+    // With segmentation offload, the adapter cuts a large packet up into MSS-sized segments for us.
+    if (has_flag(routing_decision.adapter->offloads(), NetworkOffload::TCPSegmentation))
+        data_length = min(data_length, max_segmentation_offload_size);
+    else
+        data_length = min(data_length, mss);
+    // NOTE: can_write() only lets us get here with room in the window, but if someone raced us
+    //       to it we still send a single segment rather than fail a blocking write.
+    if (auto window = available_send_window(); window > 0)
+        data_length = min(data_length, window);
     TRY(send_tcp_packet(TCPFlags::PUSH | TCPFlags::ACK, &data, data_length, &routing_decision));
     return data_length;
 }
@@ -226,8 +284,28 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* pa
 
     auto ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
 
-    const bool has_mss_option = flags == TCPFlags::SYN;
-    const size_t options_size = has_mss_option ? sizeof(TCPOptionMSS) : 0;
+    // Our own SYN offers window scaling and SACK, a SYN|ACK only agrees to what the peer offered.
+    const bool is_syn = flags & TCPFlags::SYN;
+    const bool is_initial_syn = is_syn && !(flags & TCPFlags::ACK);
+    const bool has_window_scale_option = is_syn && (is_initial_syn || m_window_scaling_enabled);
+    const bool has_sack_permitted_option = is_syn && (is_initial_syn || m_sack_permitted);
+
+    // Every option is padded with NOPs to a multiple of 4 bytes.
+    u8 options[sizeof(TCPOptionMSS) + 1 + sizeof(TCPOptionWindowScale) + 2 + sizeof(TCPOptionSACKPermitted)];
+    size_t options_size = 0;
+    auto append_option = [&](auto const& option, size_t padding) {
+        memset(options + options_size, to_underlying(TCPOptionKind::NOP), padding);
+        memcpy(options + options_size + padding, &option, sizeof(option));
+        options_size += padding + sizeof(option);
+    };
+    if (is_syn)
+        append_option(TCPOptionMSS { mss_for_adapter(*routing_decision.adapter) }, 0);
+    if (has_window_scale_option)
+        append_option(TCPOptionWindowScale { receive_window_scale }, 1);
+    if (has_sack_permitted_option)
+        append_option(TCPOptionSACKPermitted {}, 2);
+    VERIFY(options_size % sizeof(u32) == 0);
+
     const size_t tcp_header_size = sizeof(TCPPacket) + options_size;
     const size_t buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -241,16 +319,14 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* pa
     VERIFY(local_port());
     tcp_packet.set_source_port(local_port());
     tcp_packet.set_destination_port(peer_port());
-    tcp_packet.set_window_size(NumericLimits<u16>::max());
+    tcp_packet.set_window_size(receive_window_for_packet(flags));
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
 
     if (payload) {
-        if (auto result = payload->read(tcp_packet.payload(), payload_size); result.is_error()) {
-            routing_decision.adapter->release_packet_buffer(*packet);
+        if (auto result = payload->read(tcp_packet.payload(), payload_size); result.is_error())
             return set_so_error(result.release_error());
-        }
     }
 
     if (flags & TCPFlags::ACK) {
@@ -259,33 +335,48 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* pa
         tcp_packet.set_ack_number(m_ack_number);
     }
 
+    auto sequence_number = m_sequence_number;
     if (flags & TCPFlags::SYN) {
         ++m_sequence_number;
     } else {
         m_sequence_number += payload_size;
     }
 
-    if (has_mss_option) {
-        u16 mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
-        TCPOptionMSS mss_option { mss };
-        VERIFY(packet->buffer->size() >= ipv4_payload_offset + sizeof(TCPPacket) + sizeof(mss_option));
-        memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), &mss_option, sizeof(mss_option));
+    if (options_size > 0) {
+        VERIFY(packet->buffer->size() >= ipv4_payload_offset + sizeof(TCPPacket) + options_size);
+        memcpy(packet->buffer->data() + ipv4_payload_offset + sizeof(TCPPacket), options, options_size);
+    }
+
+    TransmitOffload offload;
+    auto offloads = routing_decision.adapter->offloads();
+    if (has_flag(offloads, NetworkOffload::TXChecksum))
+        offload.compute_tcp_checksum = true;
+    if (auto mss = min(mss_for_adapter(*routing_decision.adapter), m_send_mss); payload_size > mss) {
+        VERIFY(has_flag(offloads, NetworkOffload::TCPSegmentation));
+        offload.segmentation_mss = mss;
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    // NOTE: The adapter expects the checksum field to be primed with the pseudo header's sum,
+    //       which for segmentation offload leaves out the length since every segment has its own.
+    if (offload.compute_tcp_checksum)
+        tcp_packet.set_checksum(compute_tcp_pseudo_header_checksum(local_address(), peer_address(), offload.segmentation_mss ? 0 : tcp_header_size + payload_size));
+    else
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
 
-    routing_decision.adapter->send_packet(packet->bytes());
+    routing_decision.adapter->send_packet(packet->bytes(), offload);
 
     m_packets_out++;
     m_bytes_out += buffer_size;
     if (tcp_packet.has_syn() || payload_size > 0) {
+        auto now = kgettimeofday();
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            unacked_packets.packets.append({ m_sequence_number, move(packet), ipv4_payload_offset, *routing_decision.adapter });
+            // RFC 6298: The retransmission timer starts with the first packet that needs it.
+            if (unacked_packets.packets.is_empty())
+                m_last_retransmit_time = now;
+            unacked_packets.packets.append({ sequence_number, m_sequence_number, move(packet), ipv4_payload_offset, *routing_decision.adapter, now, offload });
             unacked_packets.size += payload_size;
             enqueue_for_retransmit();
         });
-    } else {
-        routing_decision.adapter->release_packet_buffer(*packet);
     }
 
     return {};
@@ -293,46 +384,248 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* pa
 
 void TCPSocket::receive_tcp_packet(const TCPPacket& packet, u16 size)
 {
+    TRACE(tcp, receive, local_port(), size);
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
+        // RFC 7323: The window in a SYN segment is never scaled.
+        auto previous_send_window_size = m_send_window_size;
+        m_send_window_size = packet.window_size() << (packet.has_syn() ? 0 : m_send_window_scale);
+
+        if (m_sack_permitted)
+            process_sack_blocks(packet);
+
+        auto now = kgettimeofday();
         int removed = 0;
+        u32 bytes_acked = 0;
+        Optional<Time> rtt_sample;
+        bool is_duplicate_ack = false;
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            if (!unacked_packets.packets.is_empty() && unacked_packets.packets.first().sequence_number == ack_number) {
+                // RFC 5681: An ACK that doesn't move anything forward while data is outstanding.
+                is_duplicate_ack = size == packet.header_size() && !packet.has_syn() && !packet.has_fin()
+                    && m_send_window_size == previous_send_window_size;
+            }
+
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
                 dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
 
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
-                } else {
+                if (!sequence_number_is_at_or_before(packet.ack_number, ack_number))
                     break;
-                }
+
+                TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+                auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
+                unacked_packets.size -= payload_size;
+                bytes_acked += packet.ack_number - packet.sequence_number;
+                // RFC 6298 (Karn's algorithm): An ACK for a retransmitted packet could be for any of its copies.
+                if (packet.tx_counter == 0)
+                    rtt_sample = now - packet.sent_time;
+                unacked_packets.packets.take_first();
+                removed++;
             }
 
-            if (unacked_packets.packets.is_empty()) {
+            if (removed > 0) {
                 m_retransmit_attempts = 0;
-                dequeue_for_retransmit();
+                m_last_retransmit_time = now;
             }
 
+            if (unacked_packets.packets.is_empty())
+                dequeue_for_retransmit();
+
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
+
+        if (rtt_sample.has_value())
+            update_rtt_estimate(rtt_sample.value());
+
+        if (bytes_acked > 0)
+            did_receive_new_ack(ack_number, bytes_acked);
+        else if (is_duplicate_ack)
+            did_receive_duplicate_ack();
+
+        if (removed > 0 || m_send_window_size != previous_send_window_size)
+            evaluate_block_conditions();
     }
 
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
+void TCPSocket::receive_syn_options(const TCPPacket& packet)
+{
+    VERIFY(packet.has_syn());
+
+    Optional<u16> mss;
+    Optional<u8> window_scale;
+    bool sack_permitted = false;
+    for_each_tcp_option(packet, [&](TCPOptionKind kind, ReadonlyBytes data) {
+        switch (kind) {
+        case TCPOptionKind::MSS:
+            if (data.size() == sizeof(u16))
+                mss = data[0] << 8 | data[1];
+            break;
+        case TCPOptionKind::WindowScale:
+            // RFC 7323: Shift counts above 14 must be treated as 14.
+            if (data.size() == sizeof(u8))
+                window_scale = min(data[0], 14);
+            break;
+        case TCPOptionKind::SACKPermitted:
+            sack_permitted = true;
+            break;
+        default:
+            break;
+        }
+    });
+
+    // NOTE: Our own SYN always offers both, so whether they're enabled is up to the peer's SYN.
+    m_window_scaling_enabled = window_scale.has_value();
+    m_send_window_scale = window_scale.value_or(0);
+    m_sack_permitted = sack_permitted;
+
+    m_send_mss = mss.value_or(default_send_mss);
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (!routing_decision.is_zero())
+        m_send_mss = min(m_send_mss, mss_for_adapter(*routing_decision.adapter));
+    m_congestion_window = initial_congestion_window(m_send_mss);
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) SYN options: mss={}, window_scale={}, sack_permitted={}", this, m_send_mss, m_send_window_scale, m_sack_permitted);
+}
+
+void TCPSocket::process_sack_blocks(const TCPPacket& packet)
+{
+    for_each_tcp_option(packet, [&](TCPOptionKind kind, ReadonlyBytes data) {
+        if (kind != TCPOptionKind::SACK)
+            return;
+        m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            for (size_t offset = 0; offset + sizeof(TCPSACKBlock) <= data.size(); offset += sizeof(TCPSACKBlock)) {
+                auto const& block = *reinterpret_cast<TCPSACKBlock const*>(data.offset(offset));
+                for (auto& unacked_packet : unacked_packets.packets) {
+                    if (!sequence_number_is_before(unacked_packet.sequence_number, block.left_edge)
+                        && sequence_number_is_at_or_before(unacked_packet.ack_number, block.right_edge))
+                        unacked_packet.is_sacked = true;
+                }
+            }
+        });
+    });
+}
+
+void TCPSocket::update_rtt_estimate(Time sample)
+{
+    // RFC 6298, section 2
+    i64 rtt = sample.to_microseconds();
+    i64 smoothed_rtt = m_smoothed_rtt.to_microseconds();
+    i64 rtt_variance = m_rtt_variance.to_microseconds();
+    if (!m_has_rtt_sample) {
+        smoothed_rtt = rtt;
+        rtt_variance = rtt / 2;
+        m_has_rtt_sample = true;
+    } else {
+        auto deviation = smoothed_rtt > rtt ? smoothed_rtt - rtt : rtt - smoothed_rtt;
+        rtt_variance = (3 * rtt_variance + deviation) / 4;
+        smoothed_rtt = (7 * smoothed_rtt + rtt) / 8;
+    }
+    m_smoothed_rtt = Time::from_microseconds(smoothed_rtt);
+    m_rtt_variance = Time::from_microseconds(rtt_variance);
+
+    auto retransmit_timeout = Time::from_microseconds(smoothed_rtt + 4 * rtt_variance);
+    m_retransmit_timeout = clamp(retransmit_timeout, minimum_retransmit_timeout, maximum_retransmit_timeout);
+}
+
+void TCPSocket::did_receive_new_ack(u32 ack_number, u32 bytes_acked)
+{
+    m_duplicate_acks_received = 0;
+
+    if (m_is_in_fast_recovery) {
+        if (sequence_number_is_before(ack_number, m_recovery_point)) {
+            // RFC 6582: A partial ACK means the packet right after it was lost too. We deflate the window
+            // by what got acknowledged, so that only about ssthresh bytes stay in flight.
+            retransmit_first_unacked_packet();
+            m_congestion_window -= min(m_congestion_window, bytes_acked);
+            if (bytes_acked >= m_send_mss)
+                m_congestion_window += m_send_mss;
+            return;
+        }
+        m_congestion_window = m_slow_start_threshold;
+        m_is_in_fast_recovery = false;
+        return;
+    }
+
+    // RFC 5681, section 3.1
+    if (m_congestion_window < m_slow_start_threshold)
+        m_congestion_window += min(bytes_acked, static_cast<u32>(m_send_mss));
+    else
+        m_congestion_window += max(1u, static_cast<u32>(m_send_mss) * m_send_mss / m_congestion_window);
+    m_congestion_window = min(m_congestion_window, maximum_congestion_window);
+}
+
+void TCPSocket::did_receive_duplicate_ack()
+{
+    ++m_duplicate_acks_received;
+
+    if (m_is_in_fast_recovery) {
+        // Every duplicate ACK means another packet has left the network.
+        m_congestion_window = min(m_congestion_window + m_send_mss, maximum_congestion_window);
+        return;
+    }
+
+    if (m_duplicate_acks_received != duplicate_acks_for_fast_retransmit)
+        return;
+
+    // RFC 5681, section 3.2 and RFC 6582, section 3.2
+    auto bytes_in_flight = m_unacked_packets.with_shared([](auto& unacked_packets) { return unacked_packets.size; });
+    m_slow_start_threshold = max(bytes_in_flight / 2, 2u * m_send_mss);
+    m_recovery_point = m_sequence_number;
+    m_is_in_fast_recovery = true;
+    retransmit_first_unacked_packet();
+    m_congestion_window = m_slow_start_threshold + duplicate_acks_for_fast_retransmit * m_send_mss;
+}
+
+void TCPSocket::did_time_out()
+{
+    // RFC 5681, section 3.1: Start over with slow start after a retransmission timeout.
+    auto bytes_in_flight = m_unacked_packets.with_shared([](auto& unacked_packets) { return unacked_packets.size; });
+    m_slow_start_threshold = max(bytes_in_flight / 2, 2u * m_send_mss);
+    m_congestion_window = m_send_mss;
+    m_is_in_fast_recovery = false;
+    m_duplicate_acks_received = 0;
+}
+
+u16 TCPSocket::receive_window_for_packet(u16 flags)
+{
+    size_t window = receive_buffer_space();
+    // RFC 7323: The window in a SYN segment is never scaled.
+    u8 scale = (flags & TCPFlags::SYN) || !m_window_scaling_enabled ? 0 : receive_window_scale;
+    u16 scaled_window = min(window >> scale, NumericLimits<u16>::max());
+    m_last_advertised_window = static_cast<u32>(scaled_window) << scale;
+    return scaled_window;
+}
+
+u32 TCPSocket::available_send_window() const
+{
+    auto window = min(m_send_window_size, m_congestion_window);
+    auto bytes_in_flight = m_unacked_packets.with_shared([](auto& unacked_packets) { return unacked_packets.size; });
+    // NOTE: With nothing in flight, we always let one segment through. If the peer has closed its window,
+    //       that segment doubles as the window probe that gets us told when it opens up again.
+    if (bytes_in_flight == 0)
+        return max(window, static_cast<u32>(m_send_mss));
+    return window > bytes_in_flight ? window - bytes_in_flight : 0;
+}
+
+void TCPSocket::protocol_did_read_from_receive_buffer()
+{
+    if (m_state != State::Established)
+        return;
+
+    // If our window was nearly closed, the peer is holding off until it hears that we've made room.
+    if (m_last_advertised_window >= 2u * m_send_mss || receive_buffer_space() < 2u * m_send_mss)
+        return;
+    [[maybe_unused]] auto result = send_ack(true);
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -349,7 +642,7 @@ bool TCPSocket::should_delay_next_ack() const
     return true;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket& packet, u16 payload_size)
+static u32 pseudo_header_sum(const IPv4Address& source, const IPv4Address& destination, u16 tcp_length)
 {
     struct [[gnu::packed]] PseudoHeader {
         IPv4Address source;
@@ -359,7 +652,7 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, c
         NetworkOrdered<u16> payload_size;
     };
 
-    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, packet.header_size() + payload_size };
+    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, tcp_length };
 
     u32 checksum = 0;
     auto raw_pseudo_header = bit_cast<u16*>(&pseudo_header);
@@ -368,6 +661,17 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, c
         if (checksum > 0xffff)
             checksum = (checksum >> 16) + (checksum & 0xffff);
     }
+    return checksum;
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_pseudo_header_checksum(const IPv4Address& source, const IPv4Address& destination, u16 tcp_length)
+{
+    return pseudo_header_sum(source, destination, tcp_length);
+}
+
+NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket& packet, u16 payload_size)
+{
+    u32 checksum = pseudo_header_sum(source, destination, packet.header_size() + payload_size);
     auto raw_packet = bit_cast<u16*>(&packet);
     for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
         checksum += AK::convert_between_host_and_network_endian(raw_packet[i]);
@@ -562,17 +866,18 @@ void TCPSocket::retransmit_packets()
 
     // RFC6298 says we should have at least one second between retransmits. According to
     // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
+    auto retransmit_interval = m_retransmit_timeout;
     for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+        retransmit_interval = min(retransmit_interval + retransmit_interval, maximum_retransmit_timeout);
 
-    if (m_last_retransmit_time > now - Time::from_seconds(retransmit_interval))
+    if (m_last_retransmit_time > now - retransmit_interval)
         return;
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
     m_last_retransmit_time = now;
     ++m_retransmit_attempts;
+    TRACE(tcp, retransmit, local_port(), m_retransmit_attempts);
 
     if (m_retransmit_attempts > maximum_retransmits) {
         set_state(TCPSocket::State::Closed);
@@ -581,48 +886,81 @@ void TCPSocket::retransmit_packets()
         return;
     }
 
+    did_time_out();
+
     auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
     if (routing_decision.is_zero())
         return;
 
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
         for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
-
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+            // The peer already has these, it just can't acknowledge them until the holes before them are filled.
+            if (packet.is_sacked)
+                continue;
+            retransmit_packet(packet, routing_decision);
+        }
+    });
+}
 
-            auto packet_buffer = packet.buffer->bytes();
+void TCPSocket::retransmit_first_unacked_packet()
+{
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (routing_decision.is_zero())
+        return;
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        for (auto& packet : unacked_packets.packets) {
+            if (packet.is_sacked)
+                continue;
+            retransmit_packet(packet, routing_decision);
+            return;
         }
     });
 }
 
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision& routing_decision)
+{
+    packet.tx_counter++;
+    m_retransmitted_packets++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    if (!packet.offload.is_empty() && routing_decision.adapter != packet.adapter) {
+        // FIXME: Add support for this. The packet's checksum (and size) relies
+        // on the offloads of the adapter that it was first sent through.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        IPv4Protocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer, packet.offload);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+}
+
 bool TCPSocket::can_write(const OpenFileDescription& file_description, u64 size) const
 {
     if (!IPv4Socket::can_write(file_description, size))
@@ -631,11 +969,6 @@ bool TCPSocket::can_write(const OpenFileDescription& file_description, u64 size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
-    return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
-    });
+    return available_send_window() > 0;
 }
 }
@@ -9,7 +9,9 @@
 #include <AK/Error.h>
 #include <AK/Function.h>
 #include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
 #include <AK/SinglyLinkedList.h>
+#include <AK/Time.h>
 #include <AK/WeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
 #include <Kernel/Net/IPv4Socket.h>
@@ -20,7 +22,7 @@ class TCPSocket final : public IPv4Socket {
 public:
     static void for_each(Function<void(const TCPSocket&)>);
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(const TCPSocket&)>);
-    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullRefPtr<TCPSocket>> try_create(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer);
     virtual ~TCPSocket() override;
 
     virtual bool unref() const override;
@@ -134,6 +136,16 @@ public:
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
 
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 send_window_size() const { return m_send_window_size; }
+    u16 send_mss() const { return m_send_mss; }
+    Time smoothed_rtt() const { return m_smoothed_rtt; }
+    Time retransmit_timeout() const { return m_retransmit_timeout; }
+    bool is_window_scaling_enabled() const { return m_window_scaling_enabled; }
+    bool is_sack_permitted() const { return m_sack_permitted; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
+
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
@@ -142,6 +154,7 @@ public:
     ErrorOr<void> send_ack(bool allow_duplicate = false);
     ErrorOr<void> send_tcp_packet(u16 flags, const UserOrKernelBuffer* = nullptr, size_t = 0, RoutingDecision* = nullptr);
     void receive_tcp_packet(const TCPPacket&, u16 size);
+    void receive_syn_options(const TCPPacket&);
 
     bool should_delay_next_ack() const;
 
@@ -163,12 +176,14 @@ public:
     virtual bool can_write(const OpenFileDescription&, u64) const override;
 
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
+    // The folded (but not inverted) sum of the pseudo header, which checksum offload expects to find in the checksum field.
+    static NetworkOrdered<u16> compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length);
 
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
@@ -181,10 +196,23 @@ private:
     virtual bool protocol_is_disconnected() const override;
     virtual ErrorOr<void> protocol_bind() override;
     virtual ErrorOr<void> protocol_listen(bool did_allocate_port) override;
+    virtual void protocol_did_read_from_receive_buffer() override;
 
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
 
+    u16 receive_window_for_packet(u16 flags);
+    u32 available_send_window() const;
+
+    struct OutgoingPacket;
+    void retransmit_packet(OutgoingPacket&, RoutingDecision&);
+    void retransmit_first_unacked_packet();
+    void process_sack_blocks(const TCPPacket&);
+    void update_rtt_estimate(Time sample);
+    void did_receive_new_ack(u32 ack_number, u32 bytes_acked);
+    void did_receive_duplicate_ack();
+    void did_time_out();
+
     WeakPtr<TCPSocket> m_originator;
     HashMap<IPv4SocketTuple, NonnullRefPtr<TCPSocket>> m_pending_release_for_accept;
     Direction m_direction { Direction::Unspecified };
@@ -199,11 +227,15 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        u32 sequence_number { 0 };
         u32 ack_number { 0 };
         RefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
         WeakPtr<NetworkAdapter> adapter;
+        Time sent_time;
+        TransmitOffload offload;
         int tx_counter { 0 };
+        bool is_sacked { false };
     };
 
     struct UnackedPackets {
@@ -223,9 +255,42 @@ private:
     Time m_last_retransmit_time;
     u32 m_retransmit_attempts { 0 };
 
-    // FIXME: Parse window size TCP option from the peer
+    // RFC 6298: The retransmission timer is driven by a smoothed estimate of the round-trip time.
+    static constexpr Time minimum_retransmit_timeout = Time::from_seconds(1);
+    static constexpr Time maximum_retransmit_timeout = Time::from_seconds(60);
+    bool m_has_rtt_sample { false };
+    Time m_smoothed_rtt;
+    Time m_rtt_variance;
+    Time m_retransmit_timeout { minimum_retransmit_timeout };
+    u32 m_retransmitted_packets { 0 };
+
+    // RFC 7323: Our receive buffer is 256 KiB, which takes a shift of 2 to advertise in full.
+    static constexpr u8 receive_window_scale = 2;
+    bool m_window_scaling_enabled { false };
+    u8 m_send_window_scale { 0 };
+    u32 m_last_advertised_window { 0 };
+
+    // RFC 2018: Whether the peer may tell us about data it got out of order. We don't generate
+    //           SACK options ourselves, since out-of-order segments are dropped on the receiving side.
+    bool m_sack_permitted { false };
+
+    // RFC 9293: Without an MSS option from the peer, we must assume 536 bytes.
+    static constexpr u16 default_send_mss = 536;
+    // Keeps a segmentation offload packet, with its headers, within the IPv4 total length.
+    static constexpr size_t max_segmentation_offload_size = 60 * KiB;
+    u16 m_send_mss { default_send_mss };
+
+    // The window the peer has advertised, already scaled.
     u32 m_send_window_size { 64 * KiB };
 
+    // NewReno congestion control (RFC 5681 and RFC 6582), all in bytes.
+    static constexpr u32 duplicate_acks_for_fast_retransmit = 3;
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+    u32 m_duplicate_acks_received { 0 };
+    bool m_is_in_fast_recovery { false };
+    u32 m_recovery_point { 0 };
+
     IntrusiveListNode<TCPSocket> m_retransmit_list_node;
 
 public:
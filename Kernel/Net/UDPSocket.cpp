@@ -48,7 +48,7 @@ RefPtr<UDPSocket> UDPSocket::from_port(u16 port)
     });
 }
 
-UDPSocket::UDPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+UDPSocket::UDPSocket(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer)
     : IPv4Socket(SOCK_DGRAM, protocol, move(receive_buffer), {})
 {
 }
@@ -60,7 +60,7 @@ UDPSocket::~UDPSocket()
     });
 }
 
-ErrorOr<NonnullRefPtr<UDPSocket>> UDPSocket::try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer)
+ErrorOr<NonnullRefPtr<UDPSocket>> UDPSocket::try_create(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer)
 {
     return adopt_nonnull_ref_or_enomem(new (nothrow) UDPSocket(protocol, move(receive_buffer)));
 }
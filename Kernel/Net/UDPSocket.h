@@ -14,7 +14,7 @@ namespace Kernel {
 
 class UDPSocket final : public IPv4Socket {
 public:
-    static ErrorOr<NonnullRefPtr<UDPSocket>> try_create(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    static ErrorOr<NonnullRefPtr<UDPSocket>> try_create(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer);
     virtual ~UDPSocket() override;
 
     static RefPtr<UDPSocket> from_port(u16);
@@ -22,7 +22,7 @@ public:
     static ErrorOr<void> try_for_each(Function<ErrorOr<void>(const UDPSocket&)>);
 
 private:
-    explicit UDPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer);
+    explicit UDPSocket(int protocol, NonnullOwnPtr<ByteRingBuffer> receive_buffer);
     virtual StringView class_name() const override { return "UDPSocket"sv; }
     static MutexProtected<HashMap<u16, UDPSocket*>>& sockets_by_port();
 
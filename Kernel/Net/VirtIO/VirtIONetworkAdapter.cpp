@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <Kernel/Bus/PCI/IDs.h>
+#include <Kernel/CommandLine.h>
+#include <Kernel/Debug.h>
+#include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/VirtIO/VirtIONetworkAdapter.h>
+#include <Kernel/Sections.h>
+#include <Kernel/WorkQueue.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT RefPtr<VirtIONetworkAdapter> VirtIONetworkAdapter::try_to_initialize(PCI::DeviceIdentifier const& pci_device_identifier)
+{
+    if (pci_device_identifier.hardware_id().vendor_id != PCI::VendorID::VirtIO || pci_device_identifier.hardware_id().device_id != PCI::DeviceID::VirtIONetAdapter)
+        return {};
+    if (kernel_command_line().disable_virtio())
+        return {};
+    // FIXME: Better propagate errors here
+    auto interface_name_or_error = NetworkingManagement::generate_interface_name_from_pci_address(pci_device_identifier);
+    if (interface_name_or_error.is_error())
+        return {};
+    auto adapter = adopt_ref_if_nonnull(new (nothrow) VirtIONetworkAdapter(pci_device_identifier, interface_name_or_error.release_value()));
+    if (!adapter)
+        return {};
+    if (auto result = adapter->initialize_network_device(); result.is_error()) {
+        dmesgln("VirtIONetworkAdapter: Failed to initialize: {}", result.error());
+        return {};
+    }
+    return adapter;
+}
+
+UNMAP_AFTER_INIT VirtIONetworkAdapter::VirtIONetworkAdapter(PCI::DeviceIdentifier const& pci_device_identifier, NonnullOwnPtr<KString> interface_name)
+    : NetworkAdapter(move(interface_name))
+    , VirtIO::Device(pci_device_identifier)
+{
+}
+
+UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_network_device()
+{
+    VirtIO::Device::initialize();
+    auto const* cfg = get_config(VirtIO::ConfigurationType::Device);
+    if (!cfg)
+        return ENODEV;
+
+    bool success = negotiate_features([&](u64 supported_features) {
+        u64 negotiated = 0;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_MAC))
+            negotiated |= VIRTIO_NET_F_MAC;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_STATUS))
+            negotiated |= VIRTIO_NET_F_STATUS;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CSUM)) {
+            negotiated |= VIRTIO_NET_F_CSUM;
+            // NOTE: Segmentation offload is only allowed together with checksum offload.
+            if (is_feature_set(supported_features, VIRTIO_NET_F_HOST_TSO4))
+                negotiated |= VIRTIO_NET_F_HOST_TSO4;
+        }
+        return negotiated;
+    });
+    if (!success)
+        return EIO;
+    if (!is_feature_accepted(VIRTIO_NET_F_MAC)) {
+        dbgln("VirtIONetworkAdapter: Device doesn't have a MAC address");
+        return ENOTSUP;
+    }
+
+    MACAddress mac_address;
+    read_config_atomic([&]() {
+        for (size_t i = 0; i < 6; ++i)
+            mac_address[i] = config_read8(*cfg, VIRTIO_NET_CONFIG_MAC + i);
+    });
+    set_mac_address(mac_address);
+
+    if (!setup_queues(2))
+        return EIO;
+
+    // Segmentation offload needs much bigger transmit buffers, without them we just go without it.
+    bool use_segmentation = is_feature_accepted(VIRTIO_NET_F_HOST_TSO4);
+    if (use_segmentation) {
+        if (auto result = initialize_transmit_buffers(true); result.is_error()) {
+            dmesgln("VirtIONetworkAdapter: Failed to allocate buffers for segmentation offload: {}", result.error());
+            use_segmentation = false;
+        }
+    }
+    if (!use_segmentation)
+        TRY(initialize_transmit_buffers(false));
+    TRY(initialize_receive_buffers());
+
+    auto offloads = NetworkOffload::None;
+    if (is_feature_accepted(VIRTIO_NET_F_CSUM))
+        offloads |= NetworkOffload::TXChecksum;
+    if (use_segmentation)
+        offloads |= NetworkOffload::TCPSegmentation;
+    set_offloads(offloads);
+
+    finish_init();
+    update_link_status();
+
+    {
+        auto& queue = get_queue(RECEIVEQ);
+        SpinlockLocker lock(queue.lock());
+        for (size_t slot = 0; slot < m_rx_buffer_pages.size(); ++slot)
+            supply_receive_buffer(slot);
+        notify_queue_if_needed(RECEIVEQ);
+    }
+
+    dmesgln("VirtIONetworkAdapter: MAC address: {}, {} receive and {} transmit buffers", mac_address.to_string(), m_rx_buffer_pages.size(), m_tx_buffers.size());
+    return {};
+}
+
+UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_receive_buffers()
+{
+    auto& queue = get_queue(RECEIVEQ);
+    size_t buffer_count = min<size_t>(ring_size(kernel_command_line().network_rx_ring_size(), default_rx_buffer_count, max_rx_buffer_count), queue.size());
+    m_rx_buffers_region = TRY(MM.allocate_dma_buffer_pages(buffer_count * PAGE_SIZE, "VirtIONetworkAdapter RX buffers"sv, Memory::Region::Access::ReadWrite, m_rx_buffer_pages));
+    TRY(m_rx_slot_for_descriptor.try_resize(queue.size()));
+    return {};
+}
+
+UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_transmit_buffers(bool for_segmentation)
+{
+    auto& queue = get_queue(TRANSMITQ);
+    size_t buffer_count = min<size_t>(ring_size(kernel_command_line().network_tx_ring_size(), default_tx_buffer_count, max_tx_buffer_count), queue.size());
+    size_t buffer_size = for_segmentation ? TRY(Memory::page_round_up(sizeof(PacketHeader) + segmentation_tx_buffer_size)) : PAGE_SIZE;
+
+    NonnullOwnPtrVector<Memory::Region> buffers;
+    TRY(buffers.try_ensure_capacity(buffer_count));
+    for (size_t i = 0; i < buffer_count; ++i)
+        buffers.unchecked_append(TRY(MM.allocate_contiguous_kernel_region(buffer_size, "VirtIONetworkAdapter TX buffer"sv, Memory::Region::Access::ReadWrite)));
+
+    Vector<u16> free_slots;
+    TRY(free_slots.try_ensure_capacity(buffer_count));
+    for (size_t slot = buffer_count; slot > 0; --slot)
+        free_slots.unchecked_append(slot - 1);
+    TRY(m_tx_slot_for_descriptor.try_resize(queue.size()));
+
+    m_tx_buffers = move(buffers);
+    m_tx_free_slots = move(free_slots);
+    m_tx_buffer_size = buffer_size;
+    return {};
+}
+
+void VirtIONetworkAdapter::update_link_status()
+{
+    if (!is_feature_accepted(VIRTIO_NET_F_STATUS))
+        return;
+    auto const* cfg = get_config(VirtIO::ConfigurationType::Device);
+    u16 status = 0;
+    read_config_atomic([&]() {
+        status = config_read16(*cfg, VIRTIO_NET_CONFIG_STATUS);
+    });
+    m_link_up = status & VIRTIO_NET_S_LINK_UP;
+}
+
+bool VirtIONetworkAdapter::handle_device_config_change()
+{
+    update_link_status();
+    dmesgln("VirtIONetworkAdapter: Link is {}", m_link_up ? "up"sv : "down"sv);
+    return true;
+}
+
+void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
+{
+    if (queue_index == RECEIVEQ) {
+        schedule_receive_poll();
+        return;
+    }
+    VERIFY(queue_index == TRANSMITQ);
+    {
+        SpinlockLocker lock(get_queue(TRANSMITQ).lock());
+        reclaim_transmit_buffers();
+    }
+    m_tx_wait_queue.wake_all();
+}
+
+void VirtIONetworkAdapter::supply_receive_buffer(u16 slot)
+{
+    auto& queue = get_queue(RECEIVEQ);
+    VERIFY(queue.lock().is_locked());
+    VirtIO::QueueChain chain(queue);
+    // NOTE: There are never more receive buffers than descriptors.
+    bool did_add_buffer = chain.add_buffer_to_chain(m_rx_buffer_pages[slot].paddr(), PAGE_SIZE, VirtIO::BufferType::DeviceWritable);
+    VERIFY(did_add_buffer);
+    m_rx_slot_for_descriptor[chain.start_of_chain_index()] = slot;
+    supply_chain(RECEIVEQ, chain);
+}
+
+void VirtIONetworkAdapter::schedule_receive_poll()
+{
+    if (m_rx_poll_scheduled.exchange(true))
+        return;
+    get_queue(RECEIVEQ).disable_interrupts();
+    g_io_work->queue([this]() {
+        poll_receive();
+    });
+}
+
+void VirtIONetworkAdapter::poll_receive()
+{
+    struct ReceivedBuffer {
+        u16 slot;
+        size_t length;
+    };
+    Vector<ReceivedBuffer, rx_poll_budget> received_buffers;
+
+    auto& queue = get_queue(RECEIVEQ);
+    {
+        SpinlockLocker lock(queue.lock());
+        size_t used;
+        while (received_buffers.size() < rx_poll_budget) {
+            auto chain = queue.pop_used_buffer_chain(used);
+            if (chain.is_empty())
+                break;
+            received_buffers.unchecked_append({ m_rx_slot_for_descriptor[chain.start_of_chain_index()], used });
+            chain.release_buffer_slots_to_queue();
+        }
+    }
+
+    // NOTE: The buffers only go back to the device once we're done with them, so we don't have to hold the lock meanwhile.
+    for (auto& buffer : received_buffers) {
+        if (buffer.length <= sizeof(PacketHeader) || buffer.length > PAGE_SIZE) {
+            dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: Dropping received buffer with bad length {}", buffer.length);
+            continue;
+        }
+        auto* data = m_rx_buffers_region->vaddr().offset(buffer.slot * PAGE_SIZE).as_ptr();
+        did_receive({ data + sizeof(PacketHeader), buffer.length - sizeof(PacketHeader) });
+    }
+
+    {
+        SpinlockLocker lock(queue.lock());
+        for (auto& buffer : received_buffers)
+            supply_receive_buffer(buffer.slot);
+        if (!received_buffers.is_empty())
+            notify_queue_if_needed(RECEIVEQ);
+    }
+
+    if (received_buffers.size() == rx_poll_budget) {
+        // There's more where that came from, but let the rest of the work queue have a go first.
+        g_io_work->queue([this]() {
+            poll_receive();
+        });
+        return;
+    }
+
+    m_rx_poll_scheduled = false;
+    queue.enable_interrupts();
+    // NOTE: A frame may have come in after we last looked and before interrupts were enabled again.
+    if (queue.new_data_available())
+        schedule_receive_poll();
+}
+
+void VirtIONetworkAdapter::reclaim_transmit_buffers()
+{
+    auto& queue = get_queue(TRANSMITQ);
+    VERIFY(queue.lock().is_locked());
+    size_t used;
+    for (auto chain = queue.pop_used_buffer_chain(used); !chain.is_empty(); chain = queue.pop_used_buffer_chain(used)) {
+        m_tx_free_slots.unchecked_append(m_tx_slot_for_descriptor[chain.start_of_chain_index()]);
+        chain.release_buffer_slots_to_queue();
+    }
+}
+
+void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    send_frame(payload, {});
+}
+
+void VirtIONetworkAdapter::send_raw_with_offload(ReadonlyBytes payload, TransmitOffload const& offload)
+{
+    send_frame(payload, offload);
+}
+
+void VirtIONetworkAdapter::send_frame(ReadonlyBytes payload, TransmitOffload const& offload)
+{
+    if (sizeof(PacketHeader) + payload.size() > m_tx_buffer_size) {
+        dbgln("VirtIONetworkAdapter: Dropping outgoing frame of {} bytes, it doesn't fit in a transmit buffer", payload.size());
+        return;
+    }
+
+    auto& queue = get_queue(TRANSMITQ);
+    u16 slot = 0;
+    for (;;) {
+        {
+            SpinlockLocker lock(queue.lock());
+            reclaim_transmit_buffers();
+            if (!m_tx_free_slots.is_empty()) {
+                slot = m_tx_free_slots.take_last();
+                break;
+            }
+        }
+        m_tx_wait_queue.wait_forever("VirtIONetworkAdapter"sv);
+    }
+
+    // NOTE: The slot is ours until we hand it to the device, so we can fill it in without holding the lock.
+    auto& buffer = m_tx_buffers[slot];
+    auto& header = *reinterpret_cast<PacketHeader*>(buffer.vaddr().as_ptr());
+    header = {};
+    header.gso_type = VIRTIO_NET_HDR_GSO_NONE;
+    if (!offload.is_empty()) {
+        constexpr u16 tcp_header_offset = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
+        VERIFY(payload.size() >= tcp_header_offset + sizeof(TCPPacket));
+        // NOTE: The device fills in the checksum from checksum_start onwards, starting from the pseudo-header checksum we left in there.
+        header.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+        header.checksum_start = AK::convert_between_host_and_little_endian<u16>(tcp_header_offset);
+        header.checksum_offset = AK::convert_between_host_and_little_endian<u16>(16);
+        if (offload.segmentation_mss != 0) {
+            auto& tcp_packet = *(TCPPacket const*)(payload.data() + tcp_header_offset);
+            header.gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+            header.gso_size = AK::convert_between_host_and_little_endian<u16>(offload.segmentation_mss);
+            header.header_length = AK::convert_between_host_and_little_endian<u16>(tcp_header_offset + tcp_packet.header_size());
+        }
+    }
+    memcpy(buffer.vaddr().offset(sizeof(PacketHeader)).as_ptr(), payload.data(), payload.size());
+
+    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: Sending packet ({} bytes) from slot {}", payload.size(), slot);
+    SpinlockLocker lock(queue.lock());
+    VirtIO::QueueChain chain(queue);
+    // NOTE: There are never more transmit buffers than descriptors.
+    bool did_add_buffer = chain.add_buffer_to_chain(buffer.physical_page(0)->paddr(), sizeof(PacketHeader) + payload.size(), VirtIO::BufferType::DeviceReadable);
+    VERIFY(did_add_buffer);
+    m_tx_slot_for_descriptor[chain.start_of_chain_index()] = slot;
+    supply_chain_and_notify(TRANSMITQ, chain);
+}
+
+}
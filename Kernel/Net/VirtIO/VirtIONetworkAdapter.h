@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Vector.h>
+#include <Kernel/Bus/VirtIO/Device.h>
+#include <Kernel/Net/NetworkAdapter.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+#define VIRTIO_NET_F_CSUM (1 << 0)
+#define VIRTIO_NET_F_GUEST_CSUM (1 << 1)
+#define VIRTIO_NET_F_MTU (1 << 3)
+#define VIRTIO_NET_F_MAC (1 << 5)
+#define VIRTIO_NET_F_HOST_TSO4 (1 << 11)
+#define VIRTIO_NET_F_MRG_RXBUF (1 << 15)
+#define VIRTIO_NET_F_STATUS (1 << 16)
+
+// virtio_net_config
+#define VIRTIO_NET_CONFIG_MAC 0x0
+#define VIRTIO_NET_CONFIG_STATUS 0x6
+
+#define VIRTIO_NET_S_LINK_UP (1 << 0)
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM (1 << 0)
+#define VIRTIO_NET_HDR_GSO_NONE 0
+#define VIRTIO_NET_HDR_GSO_TCPV4 1
+
+class VirtIONetworkAdapter final
+    : public NetworkAdapter
+    , public VirtIO::Device {
+public:
+    static RefPtr<VirtIONetworkAdapter> try_to_initialize(PCI::DeviceIdentifier const&);
+
+    virtual ~VirtIONetworkAdapter() override = default;
+
+    virtual void send_raw(ReadonlyBytes) override;
+    virtual bool link_up() override { return m_link_up; }
+    virtual bool link_full_duplex() override { return true; }
+
+    virtual StringView purpose() const override { return class_name(); }
+    virtual StringView class_name() const override { return "VirtIONetworkAdapter"sv; }
+
+private:
+    constexpr static u16 RECEIVEQ = 0;
+    constexpr static u16 TRANSMITQ = 1;
+
+    static constexpr size_t default_rx_buffer_count = 256;
+    static constexpr size_t max_rx_buffer_count = 1024;
+    static constexpr size_t default_tx_buffer_count = 32;
+    static constexpr size_t max_tx_buffer_count = 256;
+    // Big enough for the largest packet we hand the device for segmentation.
+    static constexpr size_t segmentation_tx_buffer_size = 64 * KiB;
+
+    struct [[gnu::packed]] PacketHeader {
+        u8 flags;
+        u8 gso_type;
+        u16 header_length;
+        u16 gso_size;
+        u16 checksum_start;
+        u16 checksum_offset;
+        u16 buffer_count;
+    };
+
+    VirtIONetworkAdapter(PCI::DeviceIdentifier const&, NonnullOwnPtr<KString>);
+    ErrorOr<void> initialize_network_device();
+    ErrorOr<void> initialize_receive_buffers();
+    ErrorOr<void> initialize_transmit_buffers(bool for_segmentation);
+
+    virtual void send_raw_with_offload(ReadonlyBytes, TransmitOffload const&) override;
+    void send_frame(ReadonlyBytes, TransmitOffload const&);
+    void reclaim_transmit_buffers();
+
+    virtual bool handle_device_config_change() override;
+    virtual void handle_queue_update(u16 queue_index) override;
+
+    void update_link_status();
+    void supply_receive_buffer(u16 slot);
+    void schedule_receive_poll();
+    void poll_receive();
+
+    // NOTE: Each receive buffer is a single page, the packet header is followed by the frame.
+    OwnPtr<Memory::Region> m_rx_buffers_region;
+    NonnullRefPtrVector<Memory::PhysicalPage> m_rx_buffer_pages;
+    Vector<u16> m_rx_slot_for_descriptor;
+    Atomic<bool> m_rx_poll_scheduled { false };
+
+    // NOTE: The state of the transmit buffers is protected by the lock of the transmit queue.
+    NonnullOwnPtrVector<Memory::Region> m_tx_buffers;
+    Vector<u16> m_tx_free_slots;
+    Vector<u16> m_tx_slot_for_descriptor;
+    size_t m_tx_buffer_size { 0 };
+    WaitQueue m_tx_wait_queue;
+
+    bool m_link_up { true };
+};
+
+}
@@ -14,6 +14,7 @@
 #include <Kernel/KBufferBuilder.h>
 #include <Kernel/PerformanceEventBuffer.h>
 #include <Kernel/Process.h>
+#include <Kernel/Tracepoint.h>
 
 namespace Kernel {
 
@@ -172,6 +173,19 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
         event.data.read.start_timestamp = arg5;
         event.data.read.success = !arg6.is_error();
         break;
+    case PERF_EVENT_CYCLES:
+    case PERF_EVENT_INSTRUCTIONS:
+    case PERF_EVENT_CACHE_MISSES:
+    case PERF_EVENT_BRANCH_MISSES:
+        event.data.hardware_counter.period = arg1;
+        break;
+    case PERF_EVENT_TRACEPOINT:
+        if (arg4 >= tracepoint_count)
+            return EINVAL;
+        event.data.tracepoint.id = arg4;
+        event.data.tracepoint.arg1 = arg1;
+        event.data.tracepoint.arg2 = arg2;
+        break;
     default:
         return EINVAL;
     }
@@ -183,6 +197,10 @@ ErrorOr<void> PerformanceEventBuffer::append_with_ip_and_bp(ProcessID pid, Threa
     event.pid = pid.value();
     event.tid = tid.value();
     event.timestamp = TimeManagement::the().uptime_ms();
+
+    SpinlockLocker locker(m_lock);
+    if (m_count >= capacity())
+        return ENOBUFS;
     at(m_count++) = event;
     return {};
 }
@@ -195,7 +213,7 @@ PerformanceEvent& PerformanceEventBuffer::at(size_t index)
 }
 
 template<typename Serializer>
-ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
+ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object, Span<PerformanceEvent const> events) const
 {
     {
         auto strings = TRY(object.add_array("strings"));
@@ -216,11 +234,10 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
     bool show_kernel_addresses = Process::current().is_superuser();
     auto array = TRY(object.add_array("events"));
     bool seen_first_sample = false;
-    for (size_t i = 0; i < m_count; ++i) {
-        auto const& event = at(i);
+    for (auto const& event : events) {
 
         if (!show_kernel_addresses) {
-            if (event.type == PERF_EVENT_KMALLOC || event.type == PERF_EVENT_KFREE)
+            if (event.type == PERF_EVENT_KMALLOC || event.type == PERF_EVENT_KFREE || event.type == PERF_EVENT_TRACEPOINT)
                 continue;
         }
 
@@ -302,6 +319,31 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
             TRY(event_object.add("start_timestamp"sv, event.data.read.start_timestamp));
             TRY(event_object.add("success"sv, event.data.read.success));
             break;
+        case PERF_EVENT_CYCLES:
+            TRY(event_object.add("type", "cycles"));
+            TRY(event_object.add("period"sv, event.data.hardware_counter.period));
+            break;
+        case PERF_EVENT_INSTRUCTIONS:
+            TRY(event_object.add("type", "instructions"));
+            TRY(event_object.add("period"sv, event.data.hardware_counter.period));
+            break;
+        case PERF_EVENT_CACHE_MISSES:
+            TRY(event_object.add("type", "cache_misses"));
+            TRY(event_object.add("period"sv, event.data.hardware_counter.period));
+            break;
+        case PERF_EVENT_BRANCH_MISSES:
+            TRY(event_object.add("type", "branch_misses"));
+            TRY(event_object.add("period"sv, event.data.hardware_counter.period));
+            break;
+        case PERF_EVENT_TRACEPOINT: {
+            auto& info = Tracepoints::info(static_cast<TracepointID>(event.data.tracepoint.id));
+            TRY(event_object.add("type", "tracepoint"));
+            TRY(event_object.add("subsystem"sv, info.subsystem));
+            TRY(event_object.add("name"sv, info.name));
+            TRY(event_object.add("arg1"sv, event.data.tracepoint.arg1));
+            TRY(event_object.add("arg2"sv, event.data.tracepoint.arg2));
+            break;
+        }
         }
         TRY(event_object.add("pid", event.pid));
         TRY(event_object.add("tid", event.tid));
@@ -326,8 +368,32 @@ ErrorOr<void> PerformanceEventBuffer::to_json_impl(Serializer& object) const
 
 ErrorOr<void> PerformanceEventBuffer::to_json(KBufferBuilder& builder) const
 {
+    size_t count;
+    {
+        SpinlockLocker locker(m_lock);
+        count = m_count;
+    }
+    auto object = TRY(JsonObjectSerializer<>::try_create(builder));
+    return to_json_impl(object, { reinterpret_cast<PerformanceEvent const*>(m_buffer->data()), count });
+}
+
+ErrorOr<void> PerformanceEventBuffer::drain_to_json(KBufferBuilder& builder)
+{
+    // Copy the events out, so they aren't held up by serializing them.
+    // Whatever gets appended in the meantime is left for the next drain.
+    auto drained = TRY(KBuffer::try_create_with_size(max<size_t>(count(), 1) * sizeof(PerformanceEvent), Memory::Region::Access::ReadWrite, "Drained performance events", AllocationStrategy::AllocateNow));
+    size_t drained_count;
+    {
+        SpinlockLocker locker(m_lock);
+        drained_count = min(m_count, drained->size() / sizeof(PerformanceEvent));
+        auto* events = reinterpret_cast<PerformanceEvent*>(m_buffer->data());
+        memcpy(drained->data(), events, drained_count * sizeof(PerformanceEvent));
+        memmove(events, events + drained_count, (m_count - drained_count) * sizeof(PerformanceEvent));
+        m_count -= drained_count;
+    }
+
     auto object = TRY(JsonObjectSerializer<>::try_create(builder));
-    return to_json_impl(object);
+    return to_json_impl(object, { reinterpret_cast<PerformanceEvent const*>(drained->data()), drained_count });
 }
 
 OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size_t buffer_size)
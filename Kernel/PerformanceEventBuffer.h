@@ -7,7 +7,9 @@
 #pragma once
 
 #include <AK/Error.h>
+#include <AK/Span.h>
 #include <Kernel/KBuffer.h>
+#include <Kernel/Locking/Spinlock.h>
 
 namespace Kernel {
 
@@ -76,6 +78,16 @@ struct [[gnu::packed]] ReadPerformanceEvent {
     bool success;
 };
 
+struct [[gnu::packed]] HardwareCounterPerformanceEvent {
+    u32 period;
+};
+
+struct [[gnu::packed]] TracepointPerformanceEvent {
+    u32 id;
+    FlatPtr arg1;
+    FlatPtr arg2;
+};
+
 struct [[gnu::packed]] PerformanceEvent {
     u32 type { 0 };
     u8 stack_size { 0 };
@@ -96,6 +108,8 @@ struct [[gnu::packed]] PerformanceEvent {
         KFreePerformanceEvent kfree;
         SignpostPerformanceEvent signpost;
         ReadPerformanceEvent read;
+        HardwareCounterPerformanceEvent hardware_counter;
+        TracepointPerformanceEvent tracepoint;
     } data;
     static constexpr size_t max_stack_frame_count = 64;
     FlatPtr stack[max_stack_frame_count];
@@ -118,6 +132,7 @@ public:
 
     void clear()
     {
+        SpinlockLocker locker(m_lock);
         m_count = 0;
     }
 
@@ -130,6 +145,10 @@ public:
 
     ErrorOr<void> to_json(KBufferBuilder&) const;
 
+    // Serializes the events appended since the last drain and drops them from the buffer,
+    // so a reader that keeps draining it can profile for as long as it likes.
+    ErrorOr<void> drain_to_json(KBufferBuilder&);
+
     ErrorOr<void> add_process(const Process&, ProcessEventType event_type);
 
     ErrorOr<FlatPtr> register_string(NonnullOwnPtr<KString>);
@@ -138,10 +157,12 @@ private:
     explicit PerformanceEventBuffer(NonnullOwnPtr<KBuffer>);
 
     template<typename Serializer>
-    ErrorOr<void> to_json_impl(Serializer&) const;
+    ErrorOr<void> to_json_impl(Serializer&, Span<PerformanceEvent const>) const;
 
     PerformanceEvent& at(size_t index);
 
+    // NOTE: Events are appended from every processor, m_lock guards m_count and the events themselves.
+    mutable Spinlock m_lock;
     size_t m_count { 0 };
     NonnullOwnPtr<KBuffer> m_buffer;
 
@@ -66,6 +66,25 @@ public:
         }
     }
 
+    inline static void add_hardware_counter_event(Thread& current_thread, const RegisterState& regs, u32 type, u32 period)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append_with_ip_and_bp(
+                current_thread.pid(), current_thread.tid(), regs, type, 0, period, 0, nullptr);
+        }
+    }
+
+    inline static void add_tracepoint_event(Thread& current_thread, u32 tracepoint_id, FlatPtr arg1, FlatPtr arg2)
+    {
+        if (current_thread.is_profiling_suppressed())
+            return;
+        if (auto* event_buffer = current_thread.process().current_perf_events_buffer()) {
+            [[maybe_unused]] auto rc = event_buffer->append(PERF_EVENT_TRACEPOINT, arg1, arg2, nullptr, &current_thread, tracepoint_id);
+        }
+    }
+
     inline static void add_mmap_perf_event(Process& current_process, Memory::Region const& region)
     {
         if (auto* event_buffer = current_process.current_perf_events_buffer()) {
@@ -165,7 +184,7 @@ public:
     {
         static Time last_wakeup;
         auto now = kgettimeofday();
-        constexpr auto ideal_interval = Time::from_microseconds(1000'000 / OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE);
+        auto ideal_interval = Time::from_microseconds(1000'000 / TimeManagement::the().profile_timer_frequency());
         auto expected_wakeup = last_wakeup + ideal_interval;
         auto delay = (now > expected_wakeup) ? now - expected_wakeup : Time::from_microseconds(0);
         last_wakeup = now;
@@ -10,6 +10,7 @@
 #include <AK/Types.h>
 #include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/x86/InterruptDisabler.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/Coredump.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/DeviceManagement.h>
@@ -627,6 +628,7 @@ void Process::finalize()
             if (result.is_error())
                 critical_dmesgln("Failed to write perfcore: {}", result.error());
             TimeManagement::the().disable_profile_timer();
+            PerformanceCounters::disable();
         }
     }
 
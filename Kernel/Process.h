@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/Concepts.h>
 #include <AK/HashMap.h>
 #include <AK/IntrusiveList.h>
@@ -314,6 +315,9 @@ public:
     ErrorOr<FlatPtr> sys$msync(Userspace<void*>, size_t, int flags);
     ErrorOr<FlatPtr> sys$purge(int mode);
     ErrorOr<FlatPtr> sys$poll(Userspace<const Syscall::SC_poll_params*>);
+    ErrorOr<FlatPtr> sys$epoll_create(int flags);
+    ErrorOr<FlatPtr> sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*>);
+    ErrorOr<FlatPtr> sys$epoll_wait(Userspace<const Syscall::SC_epoll_wait_params*>);
     ErrorOr<FlatPtr> sys$get_dir_entries(int fd, Userspace<void*>, size_t);
     ErrorOr<FlatPtr> sys$getcwd(Userspace<char*>, size_t);
     ErrorOr<FlatPtr> sys$chdir(Userspace<const char*>, size_t);
@@ -351,6 +355,7 @@ public:
     ErrorOr<FlatPtr> sys$access(Userspace<const char*> pathname, size_t path_length, int mode);
     ErrorOr<FlatPtr> sys$fcntl(int fd, int cmd, u32 extra_arg);
     ErrorOr<FlatPtr> sys$ioctl(int fd, unsigned request, FlatPtr arg);
+    ErrorOr<FlatPtr> sys$io_submit(Userspace<struct io_request*>, size_t count);
     ErrorOr<FlatPtr> sys$mkdir(Userspace<const char*> pathname, size_t path_length, mode_t mode);
     ErrorOr<FlatPtr> sys$times(Userspace<tms*>);
     ErrorOr<FlatPtr> sys$utime(Userspace<const char*> pathname, size_t path_length, Userspace<const struct utimbuf*>);
@@ -380,6 +385,10 @@ public:
     ErrorOr<FlatPtr> sys$socketpair(Userspace<const Syscall::SC_socketpair_params*>);
     ErrorOr<FlatPtr> sys$sched_setparam(pid_t pid, Userspace<const struct sched_param*>);
     ErrorOr<FlatPtr> sys$sched_getparam(pid_t pid, Userspace<struct sched_param*>);
+    ErrorOr<FlatPtr> sys$sched_setaffinity(pid_t pid, size_t cpusetsize, Userspace<cpu_set_t const*>);
+    ErrorOr<FlatPtr> sys$sched_getaffinity(pid_t pid, size_t cpusetsize, Userspace<cpu_set_t*>);
+    ErrorOr<FlatPtr> sys$sched_setscheduler(pid_t pid, int policy, Userspace<const struct sched_param*>);
+    ErrorOr<FlatPtr> sys$sched_getscheduler(pid_t pid);
     ErrorOr<FlatPtr> sys$create_thread(void* (*)(void*), Userspace<const Syscall::SC_create_thread_params*>);
     [[noreturn]] void sys$exit_thread(Userspace<void*>, Userspace<void*>, size_t);
     ErrorOr<FlatPtr> sys$join_thread(pid_t tid, Userspace<void**> exit_value);
@@ -404,6 +413,8 @@ public:
     ErrorOr<FlatPtr> sys$get_stack_bounds(Userspace<FlatPtr*> stack_base, Userspace<size_t*> stack_size);
     ErrorOr<FlatPtr> sys$ptrace(Userspace<const Syscall::SC_ptrace_params*>);
     ErrorOr<FlatPtr> sys$sendfd(int sockfd, int fd);
+    ErrorOr<FlatPtr> sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> offset, size_t count);
+    ErrorOr<FlatPtr> sys$copy_file_range(Userspace<Syscall::SC_copy_file_range_params const*>);
     ErrorOr<FlatPtr> sys$recvfd(int sockfd, int options);
     ErrorOr<FlatPtr> sys$sysconf(int name);
     ErrorOr<FlatPtr> sys$disown(ProcessID);
@@ -547,6 +558,8 @@ private:
 
     ErrorOr<void> do_exec(NonnullRefPtr<OpenFileDescription> main_program_description, NonnullOwnPtrVector<KString> arguments, NonnullOwnPtrVector<KString> environment, RefPtr<OpenFileDescription> interpreter_description, Thread*& new_main_thread, u32& prev_flags, const ElfW(Ehdr) & main_program_header);
     ErrorOr<FlatPtr> do_write(OpenFileDescription&, const UserOrKernelBuffer&, size_t);
+    // Used by sendfile() and copy_file_range(). `write` gets each chunk along with how much was copied before it.
+    ErrorOr<size_t> do_copy_through_kernel_buffer(OpenFileDescription& in_description, off_t in_offset, size_t count, StringView buffer_name, Function<ErrorOr<size_t>(UserOrKernelBuffer const&, size_t ncopied, size_t size)> write);
 
     ErrorOr<FlatPtr> do_statvfs(FileSystem const& path, Custody const*, statvfs* buf);
 
@@ -576,7 +589,7 @@ public:
     ErrorOr<void> procfs_get_perf_events(KBufferBuilder& builder) const;
     ErrorOr<void> procfs_get_unveil_stats(KBufferBuilder& builder) const;
     ErrorOr<void> procfs_get_pledge_stats(KBufferBuilder& builder) const;
-    ErrorOr<void> procfs_get_virtual_memory_stats(KBufferBuilder& builder) const;
+    ErrorOr<bool> procfs_get_virtual_memory_stats(KBufferBuilder& builder, u64& cursor) const;
     ErrorOr<void> procfs_get_binary_link(KBufferBuilder& builder) const;
     ErrorOr<void> procfs_get_current_work_directory_link(KBufferBuilder& builder) const;
     mode_t binary_link_required_mode() const;
@@ -817,8 +830,15 @@ private:
 
     OwnPtr<PerformanceEventBuffer> m_perf_event_buffer;
 
-    FutexQueues m_futex_queues;
-    Spinlock m_futex_lock;
+    // NOTE: Futexes are keyed by their address in this process, hashed into buckets that are
+    //       locked separately so that threads waiting on unrelated futexes don't contend.
+    struct FutexBucket {
+        Spinlock lock;
+        FutexQueues queues;
+    };
+    static constexpr size_t futex_bucket_count = 32;
+    FutexBucket& futex_bucket_for(FlatPtr user_address);
+    Array<FutexBucket, futex_bucket_count> m_futex_buckets;
 
     // This member is used in the implementation of ptrace's PT_TRACEME flag.
     // If it is set to true, the process will stop at the next execve syscall
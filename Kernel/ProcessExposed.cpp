@@ -153,6 +153,88 @@ ErrorOr<void> ProcFSGlobalInformation::refresh_data(OpenFileDescription& descrip
     return {};
 }
 
+ErrorOr<size_t> procfs_read_records(ProcFSRecordsData& data, off_t offset, size_t count, UserOrKernelBuffer& buffer, ProcFSRecordsGenerator const& generate)
+{
+    // Records can only be generated front to back, so reading an earlier part starts over.
+    if (offset < data.chunk_offset)
+        data.reset();
+
+    while (!data.chunk || offset >= data.chunk_offset + static_cast<off_t>(data.chunk->size())) {
+        if (!data.has_more_records)
+            return 0;
+        if (data.chunk)
+            data.chunk_offset += data.chunk->size();
+        auto builder = TRY(KBufferBuilder::try_create(2 * procfs_records_chunk_size));
+        data.has_more_records = TRY(generate(builder, data.cursor));
+        data.chunk = builder.build();
+        if (!data.chunk)
+            return ENOMEM;
+    }
+
+    auto offset_in_chunk = static_cast<size_t>(offset - data.chunk_offset);
+    auto nread = min(data.chunk->size() - offset_in_chunk, count);
+    TRY(buffer.write(data.chunk->data() + offset_in_chunk, nread));
+    return nread;
+}
+
+ErrorOr<ProcFSJsonArrayChunk> ProcFSJsonArrayChunk::try_create(KBufferBuilder& builder, bool is_first_chunk)
+{
+    if (is_first_chunk)
+        TRY(builder.append('['));
+    return ProcFSJsonArrayChunk { builder, is_first_chunk };
+}
+
+ErrorOr<JsonObjectSerializer<KBufferBuilder>> ProcFSJsonArrayChunk::add_object()
+{
+    if (m_needs_comma)
+        TRY(m_builder.append(','));
+    m_needs_comma = true;
+    return JsonObjectSerializer<KBufferBuilder>::try_create(m_builder);
+}
+
+ErrorOr<void> ProcFSJsonArrayChunk::finish(bool has_more_records)
+{
+    if (!has_more_records)
+        TRY(m_builder.append(']'));
+    return {};
+}
+
+ErrorOr<size_t> ProcFSGlobalRecordsInformation::read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const
+{
+    dbgln_if(PROCFS_DEBUG, "ProcFSGlobalRecordsInformation @ {}: read_bytes offset: {} count: {}", name(), offset, count);
+
+    VERIFY(offset >= 0);
+    VERIFY(buffer.user_or_kernel_ptr());
+
+    if (!description)
+        return Error::from_errno(EIO);
+
+    MutexLocker locker(m_refresh_lock);
+
+    if (!description->data()) {
+        dbgln("ProcFSGlobalRecordsInformation: Do not have cached data!");
+        return Error::from_errno(EIO);
+    }
+
+    auto& records_data = static_cast<ProcFSRecordsData&>(*description->data());
+    return procfs_read_records(records_data, offset, count, buffer, [this](KBufferBuilder& builder, u64& cursor) {
+        return const_cast<ProcFSGlobalRecordsInformation&>(*this).try_generate_records(builder, cursor);
+    });
+}
+
+ErrorOr<void> ProcFSGlobalRecordsInformation::refresh_data(OpenFileDescription& description) const
+{
+    MutexLocker lock(m_refresh_lock);
+    auto& cached_data = description.data();
+    if (!cached_data) {
+        cached_data = adopt_own_if_nonnull(new (nothrow) ProcFSRecordsData);
+        if (!cached_data)
+            return ENOMEM;
+    }
+    static_cast<ProcFSRecordsData&>(*cached_data).reset();
+    return {};
+}
+
 ErrorOr<void> ProcFSSystemBoolean::try_generate(KBufferBuilder& builder)
 {
     return builder.appendff("{}\n", static_cast<int>(value()));
@@ -8,6 +8,7 @@
 
 #include <AK/Error.h>
 #include <AK/Function.h>
+#include <AK/JsonObjectSerializer.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
 #include <AK/Types.h>
@@ -161,6 +162,56 @@ struct ProcFSInodeData : public OpenFileDescriptionData {
     OwnPtr<KBuffer> buffer;
 };
 
+// Files made of many records are generated a chunk at a time while they are read, instead of
+// all at once when they are opened. Reading moves forward through the chunks, and going back to
+// an earlier offset starts over from the first record, like seq_file in Linux does.
+// Note that the records in different chunks may reflect different states of the system.
+struct ProcFSRecordsData : public OpenFileDescriptionData {
+    OwnPtr<KBuffer> chunk;
+    off_t chunk_offset { 0 };
+    // Where the next chunk continues. Its meaning is up to the generator, zero means the first record.
+    u64 cursor { 0 };
+    bool has_more_records { true };
+
+    void reset()
+    {
+        chunk = nullptr;
+        chunk_offset = 0;
+        cursor = 0;
+        has_more_records = true;
+    }
+};
+
+// Generators append at least one record (if there are any left) following the cursor, and stop once
+// they have appended about procfs_records_chunk_size bytes. They advance the cursor past the records
+// they appended, and return whether there are more records left.
+static constexpr size_t procfs_records_chunk_size = 16 * KiB;
+using ProcFSRecordsGenerator = Function<ErrorOr<bool>(KBufferBuilder&, u64& cursor)>;
+ErrorOr<size_t> procfs_read_records(ProcFSRecordsData&, off_t offset, size_t count, UserOrKernelBuffer&, ProcFSRecordsGenerator const&);
+
+// Writes the part of a JSON array of objects that belongs into one chunk.
+class ProcFSJsonArrayChunk {
+public:
+    static ErrorOr<ProcFSJsonArrayChunk> try_create(KBufferBuilder&, bool is_first_chunk);
+
+    bool is_full() const { return m_builder.length() - m_start_length >= procfs_records_chunk_size; }
+
+    ErrorOr<JsonObjectSerializer<KBufferBuilder>> add_object();
+    ErrorOr<void> finish(bool has_more_records);
+
+private:
+    ProcFSJsonArrayChunk(KBufferBuilder& builder, bool is_first_chunk)
+        : m_builder(builder)
+        , m_start_length(builder.length())
+        , m_needs_comma(!is_first_chunk)
+    {
+    }
+
+    KBufferBuilder& m_builder;
+    size_t m_start_length { 0 };
+    bool m_needs_comma { false };
+};
+
 class ProcFSGlobalInformation : public ProcFSExposedComponent {
 public:
     virtual ~ProcFSGlobalInformation() override {};
@@ -180,6 +231,25 @@ protected:
     mutable Mutex m_refresh_lock;
 };
 
+class ProcFSGlobalRecordsInformation : public ProcFSExposedComponent {
+public:
+    virtual ~ProcFSGlobalRecordsInformation() override {};
+
+    virtual ErrorOr<size_t> read_bytes(off_t offset, size_t count, UserOrKernelBuffer& buffer, OpenFileDescription* description) const override;
+
+    virtual mode_t required_mode() const override { return 0444; }
+
+protected:
+    explicit ProcFSGlobalRecordsInformation(StringView name)
+        : ProcFSExposedComponent(name)
+    {
+    }
+    virtual ErrorOr<void> refresh_data(OpenFileDescription&) const override;
+    virtual ErrorOr<bool> try_generate_records(KBufferBuilder&, u64& cursor) = 0;
+
+    mutable Mutex m_refresh_lock;
+};
+
 class ProcFSSystemBoolean : public ProcFSGlobalInformation {
 public:
     virtual bool value() const = 0;
@@ -228,14 +228,22 @@ ErrorOr<void> Process::procfs_get_fds_stats(KBufferBuilder& builder) const
     });
 }
 
-ErrorOr<void> Process::procfs_get_virtual_memory_stats(KBufferBuilder& builder) const
+// The cursor is the end address of the last region in the previous chunk, so the address space lock
+// only has to be held while generating one chunk, and regions can come and go in between.
+ErrorOr<bool> Process::procfs_get_virtual_memory_stats(KBufferBuilder& builder, u64& cursor) const
 {
-    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    auto array = TRY(ProcFSJsonArrayChunk::try_create(builder, cursor == 0));
+    bool has_more_records = false;
     {
         SpinlockLocker lock(address_space().get_lock());
-        for (auto const& region : address_space().regions()) {
+        for (auto it = address_space().regions().find_smallest_not_below_iterator(cursor); !it.is_end(); ++it) {
+            auto const& region = *it;
             if (!region->is_user() && !Process::current().is_superuser())
                 continue;
+            if (array.is_full()) {
+                has_more_records = true;
+                break;
+            }
             auto region_object = TRY(array.add_object());
             TRY(region_object.add("readable", region->is_readable()));
             TRY(region_object.add("writable", region->is_writable()));
@@ -268,10 +276,11 @@ ErrorOr<void> Process::procfs_get_virtual_memory_stats(KBufferBuilder& builder)
             }
             TRY(region_object.add("pagemap", pagemap_builder.string_view()));
             TRY(region_object.finish());
+            cursor = region->vaddr().get() + region->size();
         }
     }
-    TRY(array.finish());
-    return {};
+    TRY(array.finish(has_more_records));
+    return has_more_records;
 }
 
 ErrorOr<void> Process::procfs_get_current_work_directory_link(KBufferBuilder& builder) const
@@ -5,11 +5,13 @@
  */
 
 #include <AK/BuiltinWrappers.h>
+#include <AK/Optional.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Arch/x86/InterruptDisabler.h>
 #include <Kernel/Arch/x86/TrapFrame.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Panic.h>
 #include <Kernel/PerformanceManager.h>
@@ -18,6 +20,7 @@
 #include <Kernel/Scheduler.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Tracepoint.h>
 #include <Kernel/kstdio.h>
 
 // Remove this once SMP is stable and can be enabled by default
@@ -32,13 +35,31 @@ static u32 time_slice_for(const Thread& thread)
     // One time slice unit == 4ms (assuming 250 ticks/second)
     if (thread.is_idle_thread())
         return 1;
+    // Only SCHED_RR threads of the same priority take turns, so they get a longer time slice.
+    if (thread.scheduling_policy() == SCHED_RR && thread.realtime_priority() != 0)
+        return 25;
     return 2;
 }
 
+// Whether `next` gets to take over the processor from `current`. Real-time threads are only preempted by threads
+// with a higher real-time priority, SCHED_RR threads also take turns with the ones of the same priority.
+static bool is_preempted_by(Thread const& current, Thread const& next)
+{
+    auto current_priority = current.effective_realtime_priority();
+    auto next_priority = next.effective_realtime_priority();
+    if (current_priority == 0)
+        return true;
+    if (current.scheduling_policy() == SCHED_RR && current.realtime_priority() == current_priority)
+        return next_priority >= current_priority;
+    return next_priority > current_priority;
+}
+
 READONLY_AFTER_INIT Thread* g_finalizer;
 READONLY_AFTER_INIT WaitQueue* g_finalizer_wait_queue;
 Atomic<bool> g_finalizer_has_work { false };
 READONLY_AFTER_INIT static Process* s_colonel_process;
+// Processors that only run threads which were explicitly pinned to them, see the isolcpus boot parameter.
+READONLY_AFTER_INIT static u32 s_isolated_processors;
 
 struct ThreadReadyQueue {
     IntrusiveList<&Thread::m_ready_queue_node> thread_list;
@@ -48,11 +69,58 @@ struct ThreadReadyQueues {
     u32 mask {};
     static constexpr size_t count = sizeof(mask) * 8;
     Array<ThreadReadyQueue, count> queues;
+
+    Thread* find_runnable_thread(u32 affinity_mask)
+    {
+        auto priority_mask = mask;
+        while (priority_mask != 0) {
+            auto priority = bit_scan_forward(priority_mask);
+            VERIFY(priority > 0);
+            auto& ready_queue = queues[--priority];
+            for (auto& thread : ready_queue.thread_list) {
+                VERIFY(thread.m_runnable_priority == (int)priority);
+                if (thread.is_active())
+                    continue;
+                if (!(Scheduler::effective_affinity(thread) & affinity_mask))
+                    continue;
+                return &thread;
+            }
+            priority_mask &= ~(1u << priority);
+        }
+        return nullptr;
+    }
+
+    void remove(Thread& thread)
+    {
+        auto priority = thread.m_runnable_priority;
+        VERIFY(priority >= 0);
+        VERIFY(mask & (1u << priority));
+        auto& ready_queue = queues[priority];
+        thread.m_runnable_priority = -1;
+        ready_queue.thread_list.remove(thread);
+        if (ready_queue.thread_list.is_empty())
+            mask &= ~(1u << priority);
+    }
 };
 
-static Singleton<SpinlockProtected<ThreadReadyQueues>> g_ready_queues;
+// Every processor owns a set of ready queues, so that picking the next thread
+// usually only needs to look at the queues of the current processor. Idle
+// processors steal work from the busiest processor instead.
+// NOTE: The ready queues are protected by g_scheduler_lock, only the counters may be read without it.
+// NOTE: Thread affinity is a u32 bitmask, so this is an upper bound on the processor count.
+static constexpr size_t max_processor_count = sizeof(u32) * 8;
+
+struct ProcessorReadyQueues {
+    ThreadReadyQueues ready_queues;
+    Atomic<u32> runnable_thread_count { 0 };
+    Atomic<u64> pulled_thread_count { 0 };
+    Atomic<u64> stolen_thread_count { 0 };
+    // NOTE: Time is accounted to the processor that ran the thread, the totals are the sums over all processors.
+    Atomic<u64> time_scheduled { 0 };
+    Atomic<u64> time_scheduled_kernel { 0 };
+};
 
-static SpinlockProtected<TotalTimeScheduled> g_total_time_scheduled;
+static Singleton<Array<ProcessorReadyQueues, max_processor_count>> g_ready_queues;
 
 // The Scheduler::current_time function provides a current time for scheduling purposes,
 // which may not necessarily relate to wall time
@@ -60,108 +128,162 @@ u64 (*Scheduler::current_time)();
 
 static void dump_thread_list(bool = false);
 
-static inline u32 thread_priority_to_priority_index(u32 thread_priority)
+// The first ready queues are reserved for real-time threads, so they are always picked before all others.
+static constexpr u32 realtime_priority_bucket_count = 16;
+
+static inline u32 thread_priority_to_priority_index(Thread const& thread)
 {
+    if (auto realtime_priority = thread.effective_realtime_priority(); realtime_priority != 0) {
+        VERIFY(realtime_priority >= THREAD_REALTIME_PRIORITY_MIN && realtime_priority <= THREAD_REALTIME_PRIORITY_MAX);
+        constexpr u32 realtime_priority_count = THREAD_REALTIME_PRIORITY_MAX - THREAD_REALTIME_PRIORITY_MIN + 1;
+        return (THREAD_REALTIME_PRIORITY_MAX - realtime_priority) * realtime_priority_bucket_count / realtime_priority_count;
+    }
+
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
     // to a index into g_ready_queues where 0 is the highest priority bucket
+    auto thread_priority = thread.priority();
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
-    auto priority_bucket = ((thread_priority_count - (thread_priority - THREAD_PRIORITY_MIN)) / thread_priority_count) * (ThreadReadyQueues::count - 1);
+    auto priority_bucket = realtime_priority_bucket_count + ((thread_priority_count - (thread_priority - THREAD_PRIORITY_MIN)) / thread_priority_count) * (ThreadReadyQueues::count - realtime_priority_bucket_count - 1);
     VERIFY(priority_bucket < ThreadReadyQueues::count);
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static Thread* try_take_runnable_thread_from(u32 processor_id, u32 affinity_mask)
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    auto& processor_queues = (*g_ready_queues)[processor_id];
+    if (processor_queues.runnable_thread_count.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+        return nullptr;
+    auto* thread = processor_queues.ready_queues.find_runnable_thread(affinity_mask);
+    if (!thread)
+        return nullptr;
+    processor_queues.ready_queues.remove(*thread);
+    processor_queues.runnable_thread_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    // Mark it as active because we are using this thread. This is similar
+    // to comparing it with Processor::current_thread, but when there are
+    // multiple processors there's no easy way to check whether the thread
+    // is actually still needed. This prevents accidental finalization when
+    // a thread is no longer in Running state, but running on another core.
+
+    // We need to mark it active here so that this thread won't be
+    // scheduled on another core if it were to be queued before actually
+    // switching to it.
+    // FIXME: Figure out a better way maybe?
+    thread->set_active(true);
+    return thread;
+}
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
-                return thread;
-            }
-            priority_mask &= ~(1u << priority);
+static Thread* try_steal_runnable_thread(u32 processor_id)
+{
+    auto affinity_mask = 1u << processor_id;
+    auto processor_count = Processor::count();
+
+    // Look at the busiest processor first, it is the most likely one to have
+    // a thread that we are allowed to run.
+    u32 busiest_processor_id = processor_id;
+    u32 busiest_load = 0;
+    for (u32 id = 0; id < processor_count; id++) {
+        if (id == processor_id)
+            continue;
+        auto load = (*g_ready_queues)[id].runnable_thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (load > busiest_load) {
+            busiest_processor_id = id;
+            busiest_load = load;
         }
-        return *Processor::idle_thread();
-    });
+    }
+    if (busiest_load == 0)
+        return nullptr;
+
+    auto* thread = try_take_runnable_thread_from(busiest_processor_id, affinity_mask);
+    for (u32 i = 1; !thread && i < processor_count; i++) {
+        auto id = (processor_id + i) % processor_count;
+        if (id != busiest_processor_id)
+            thread = try_take_runnable_thread_from(id, affinity_mask);
+    }
+    if (thread) {
+        (*g_ready_queues)[processor_id].stolen_thread_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {}", processor_id, *thread);
+    }
+    return thread;
 }
 
-Thread* Scheduler::peek_next_runnable_thread()
+Thread& Scheduler::pull_next_runnable_thread()
 {
-    auto affinity_mask = 1u << Processor::current_id();
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    auto processor_id = Processor::current_id();
 
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
+    auto* thread = try_take_runnable_thread_from(processor_id, 1u << processor_id);
+    if (!thread)
+        thread = try_steal_runnable_thread(processor_id);
+    if (!thread)
+        return *Processor::idle_thread();
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
-    });
+    (*g_ready_queues)[processor_id].pulled_thread_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    return *thread;
+}
+
+Thread* Scheduler::peek_next_runnable_thread()
+{
+    SpinlockLocker lock(g_scheduler_lock);
+    auto processor_id = Processor::current_id();
+    auto affinity_mask = 1u << processor_id;
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled, either on our own queues or on another processor's.
+    for (u32 i = 0; i < Processor::count(); i++) {
+        auto& processor_queues = (*g_ready_queues)[(processor_id + i) % Processor::count()];
+        if (processor_queues.runnable_thread_count.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+            continue;
+        if (auto* thread = processor_queues.ready_queues.find_runnable_thread(affinity_mask))
+            return thread;
+    }
+    return nullptr;
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
 {
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
-            VERIFY(!thread.m_ready_queue_node.is_in_list());
-            return false;
-        }
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
 
-        if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
-            return false;
+    if (check_affinity && !(effective_affinity(thread) & (1u << Processor::current_id())))
+        return false;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
-        return true;
-    });
+    auto& processor_queues = (*g_ready_queues)[thread.m_ready_queue_processor];
+    processor_queues.ready_queues.remove(thread);
+    processor_queues.runnable_thread_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+    return true;
+}
+
+static u32 select_ready_queue_processor(Thread const& thread)
+{
+    auto processor_count = Processor::count();
+    auto affinity = Scheduler::effective_affinity(thread);
+
+    // Prefer the processor the thread last ran on, its caches are still warm.
+    auto last_processor_id = thread.cpu();
+    if (last_processor_id < processor_count && (affinity & (1u << last_processor_id)))
+        return last_processor_id;
+
+    u32 selected_processor_id = last_processor_id < processor_count ? last_processor_id : 0;
+    Optional<u32> lowest_load;
+    for (u32 id = 0; id < processor_count; id++) {
+        if (!(affinity & (1u << id)))
+            continue;
+        auto load = (*g_ready_queues)[id].runnable_thread_count.load(AK::MemoryOrder::memory_order_relaxed);
+        if (!lowest_load.has_value() || load < lowest_load.value()) {
+            selected_processor_id = id;
+            lowest_load = load;
+        }
+    }
+    return selected_processor_id;
 }
 
 void Scheduler::enqueue_runnable_thread(Thread& thread)
@@ -169,18 +291,109 @@ void Scheduler::enqueue_runnable_thread(Thread& thread)
     VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
-
-    g_ready_queues->with([&](auto& ready_queues) {
-        VERIFY(thread.m_runnable_priority < 0);
-        thread.m_runnable_priority = (int)priority;
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        auto& ready_queue = ready_queues.queues[priority];
-        bool was_empty = ready_queue.thread_list.is_empty();
+    auto priority = thread_priority_to_priority_index(thread);
+    auto processor_id = select_ready_queue_processor(thread);
+
+    auto& processor_queues = (*g_ready_queues)[processor_id];
+    VERIFY(thread.m_runnable_priority < 0);
+    thread.m_runnable_priority = (int)priority;
+    thread.m_ready_queue_processor = processor_id;
+    VERIFY(!thread.m_ready_queue_node.is_in_list());
+    auto& ready_queue = processor_queues.ready_queues.queues[priority];
+    bool was_empty = ready_queue.thread_list.is_empty();
+    // Several real-time priorities share a queue, keep it ordered by them. Threads of the same priority run in FIFO order.
+    Thread* insert_before = nullptr;
+    if (auto realtime_priority = thread.effective_realtime_priority(); realtime_priority != 0) {
+        for (auto& queued_thread : ready_queue.thread_list) {
+            if (queued_thread.effective_realtime_priority() < realtime_priority) {
+                insert_before = &queued_thread;
+                break;
+            }
+        }
+    }
+    if (insert_before)
+        ready_queue.thread_list.insert_before(*insert_before, thread);
+    else
         ready_queue.thread_list.append(thread);
-        if (was_empty)
-            ready_queues.mask |= (1u << priority);
-    });
+    if (was_empty)
+        processor_queues.ready_queues.mask |= (1u << priority);
+    processor_queues.runnable_thread_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
+    // Don't make a real-time thread that just woke up wait for the time slice of a less important thread to end.
+    auto* current_thread = Thread::current();
+    if (thread.is_realtime() && processor_id == Processor::current_id() && current_thread && current_thread != &thread
+        && !Processor::current_in_scheduler() && is_preempted_by(*current_thread, thread)) {
+        Processor::current().invoke_scheduler_async();
+    }
+}
+
+void Scheduler::set_thread_scheduling_policy(Thread& thread, int policy, u32 realtime_priority)
+{
+    VERIFY(policy == SCHED_FIFO || policy == SCHED_RR || realtime_priority == 0);
+    SpinlockLocker lock(g_scheduler_lock);
+    // A runnable thread has to move to the ready queue for its new priority.
+    bool was_queued = thread.m_runnable_priority >= 0 && dequeue_runnable_thread(thread);
+    thread.m_scheduling_policy = policy;
+    thread.m_realtime_priority = realtime_priority;
+    if (was_queued)
+        enqueue_runnable_thread(thread);
+}
+
+void Scheduler::set_inherited_realtime_priority(Thread& thread, u32 realtime_priority)
+{
+    SpinlockLocker lock(g_scheduler_lock);
+    if (thread.m_inherited_realtime_priority == realtime_priority)
+        return;
+    dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: {} inherits real-time priority {}", Processor::current_id(), thread, realtime_priority);
+    bool was_queued = thread.m_runnable_priority >= 0 && dequeue_runnable_thread(thread);
+    thread.m_inherited_realtime_priority = realtime_priority;
+    if (was_queued)
+        enqueue_runnable_thread(thread);
+}
+
+u32 Scheduler::effective_affinity(Thread const& thread)
+{
+    auto affinity = thread.affinity();
+    if (affinity == THREAD_AFFINITY_DEFAULT)
+        return ~s_isolated_processors;
+    return affinity;
+}
+
+u32 Scheduler::online_processors()
+{
+    auto processor_count = Processor::count();
+    if (processor_count >= max_processor_count)
+        return NumericLimits<u32>::max();
+    return (1u << processor_count) - 1;
+}
+
+void Scheduler::set_thread_affinity(Thread& thread, u32 affinity)
+{
+    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
+    thread.set_affinity(affinity);
+
+    // Move a runnable thread over to the ready queues of a processor it is still allowed to run on.
+    if (thread.m_runnable_priority >= 0 && dequeue_runnable_thread(thread))
+        enqueue_runnable_thread(thread);
+
+    // A running thread is moved once it gets preempted, see timer_tick(). We don't want to wait for that if it's us.
+    if (&thread == Thread::current() && !(effective_affinity(thread) & (1u << Processor::current_id())))
+        Processor::current().invoke_scheduler_async();
+}
+
+ErrorOr<void> Scheduler::try_for_each_processor_load(Function<ErrorOr<void>(ProcessorSchedulingLoad const&)> callback)
+{
+    for (u32 id = 0; id < Processor::count(); id++) {
+        auto& processor_queues = (*g_ready_queues)[id];
+        ProcessorSchedulingLoad load {
+            .processor_id = id,
+            .runnable_threads = processor_queues.runnable_thread_count.load(AK::MemoryOrder::memory_order_relaxed),
+            .pulled_threads = processor_queues.pulled_thread_count.load(AK::MemoryOrder::memory_order_relaxed),
+            .stolen_threads = processor_queues.stolen_thread_count.load(AK::MemoryOrder::memory_order_relaxed),
+        };
+        TRY(callback(load));
+    }
+    return {};
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -297,6 +510,7 @@ void Scheduler::context_switch(Thread* thread)
     thread->set_state(Thread::State::Running);
 
     PerformanceManager::add_context_switch_perf_event(*from_thread, *thread);
+    TRACE(scheduler, context_switch, from_thread->tid().value(), thread->tid().value());
 
     proc.switch_context(from_thread, thread);
 
@@ -397,6 +611,15 @@ UNMAP_AFTER_INIT void Scheduler::initialize()
         current_time = current_time_monotonic;
     }
 
+    s_isolated_processors = kernel_command_line().isolated_processors();
+    if (s_isolated_processors & 1u) {
+        // The boot processor runs everything until the other processors are up, so it can't be isolated.
+        dmesgln("Scheduler: Processor 0 can't be isolated, ignoring it in isolcpus");
+        s_isolated_processors &= ~1u;
+    }
+    if (s_isolated_processors != 0)
+        dmesgln("Scheduler: Isolated processors: {:#08x}", s_isolated_processors);
+
     RefPtr<Thread> idle_thread;
     g_finalizer_wait_queue = new WaitQueue;
 
@@ -431,11 +654,10 @@ UNMAP_AFTER_INIT Thread* Scheduler::create_ap_idle_thread(u32 cpu)
 
 void Scheduler::add_time_scheduled(u64 time_to_add, bool is_kernel)
 {
-    g_total_time_scheduled.with([&](auto& total_time_scheduled) {
-        total_time_scheduled.total += time_to_add;
-        if (is_kernel)
-            total_time_scheduled.total_kernel += time_to_add;
-    });
+    auto& processor_queues = (*g_ready_queues)[Processor::current_id()];
+    processor_queues.time_scheduled.fetch_add(time_to_add, AK::MemoryOrder::memory_order_relaxed);
+    if (is_kernel)
+        processor_queues.time_scheduled_kernel.fetch_add(time_to_add, AK::MemoryOrder::memory_order_relaxed);
 }
 
 void Scheduler::timer_tick(const RegisterState& regs)
@@ -474,10 +696,12 @@ void Scheduler::timer_tick(const RegisterState& regs)
     if (current_thread->tick())
         return;
 
-    if (!current_thread->is_idle_thread() && !peek_next_runnable_thread()) {
-        // If no other thread is ready to be scheduled we don't need to
-        // switch to the idle thread. Just give the current thread another
-        // time slice and let it run!
+    bool is_allowed_on_this_processor = effective_affinity(*current_thread) & (1u << Processor::current_id());
+    auto* next_thread = peek_next_runnable_thread();
+    if (!current_thread->is_idle_thread() && is_allowed_on_this_processor && (!next_thread || !is_preempted_by(*current_thread, *next_thread))) {
+        // If no other thread is ready to be scheduled (or none that may
+        // preempt a real-time thread) we don't need to switch. Just give
+        // the current thread another time slice and let it run!
         current_thread->set_ticks_left(time_slice_for(*current_thread));
         current_thread->did_schedule();
         dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: No other threads ready, give {} another timeslice", Processor::current_id(), *current_thread);
@@ -541,7 +765,13 @@ bool Scheduler::is_initialized()
 
 TotalTimeScheduled Scheduler::get_total_time_scheduled()
 {
-    return g_total_time_scheduled.with([&](auto& total_time_scheduled) { return total_time_scheduled; });
+    TotalTimeScheduled total_time_scheduled;
+    for (u32 id = 0; id < Processor::count(); id++) {
+        auto& processor_queues = (*g_ready_queues)[id];
+        total_time_scheduled.total += processor_queues.time_scheduled.load(AK::MemoryOrder::memory_order_relaxed);
+        total_time_scheduled.total_kernel += processor_queues.time_scheduled_kernel.load(AK::MemoryOrder::memory_order_relaxed);
+    }
+    return total_time_scheduled;
 }
 
 void dump_thread_list(bool with_stack_traces)
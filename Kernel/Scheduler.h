@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Assertions.h>
+#include <AK/Error.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Types.h>
@@ -29,6 +30,13 @@ struct TotalTimeScheduled {
     u64 total_kernel { 0 };
 };
 
+struct ProcessorSchedulingLoad {
+    u32 processor_id { 0 };
+    u32 runnable_threads { 0 };
+    u64 pulled_threads { 0 };
+    u64 stolen_threads { 0 };
+};
+
 class Scheduler {
 public:
     static void initialize();
@@ -51,9 +59,17 @@ public:
     static Thread* peek_next_runnable_thread();
     static bool dequeue_runnable_thread(Thread&, bool = false);
     static void enqueue_runnable_thread(Thread&);
+    // The processors a thread may run on, threads that didn't ask for a specific affinity stay off the isolated processors.
+    static u32 effective_affinity(Thread const&);
+    static u32 online_processors();
+    static void set_thread_affinity(Thread&, u32 affinity);
+    static void set_thread_scheduling_policy(Thread&, int policy, u32 realtime_priority);
+    // Lends a real-time priority to a thread holding a lock that a higher priority thread is waiting on, 0 takes it back.
+    static void set_inherited_realtime_priority(Thread&, u32 realtime_priority);
     static void dump_scheduler_state(bool = false);
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
+    static ErrorOr<void> try_for_each_processor_load(Function<ErrorOr<void>(ProcessorSchedulingLoad const&)>);
     static void add_time_scheduled(u64, bool);
     static u64 (*current_time)();
 };
@@ -8,9 +8,10 @@
 // please look at Documentation/Kernel/AHCILocking.md
 
 #include <AK/Atomic.h>
+#include <AK/BuiltinWrappers.h>
+#include <AK/NumericLimits.h>
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/MemoryManager.h>
-#include <Kernel/Memory/ScatterGatherList.h>
 #include <Kernel/Memory/TypedMapping.h>
 #include <Kernel/Storage/ATA/AHCIPort.h>
 #include <Kernel/Storage/ATA/ATA.h>
@@ -39,12 +40,9 @@ AHCIPort::AHCIPort(const AHCIPortHandler& handler, volatile AHCI::PortRegisters&
 
     m_fis_receive_page = MM.allocate_supervisor_physical_page().release_value_but_fixme_should_propagate_errors();
 
-    for (size_t index = 0; index < 1; index++) {
-        m_dma_buffers.append(MM.allocate_supervisor_physical_page().release_value_but_fixme_should_propagate_errors());
-    }
-    for (size_t index = 0; index < 1; index++) {
-        m_command_table_pages.append(MM.allocate_supervisor_physical_page().release_value_but_fixme_should_propagate_errors());
-    }
+    // Every command slot the HBA has gets its own command table page, so commands can be prepared while others are in flight.
+    auto command_tables_size = m_parent_handler->hba_capabilities().max_command_list_entries_count * PAGE_SIZE;
+    m_command_table_region = MM.allocate_dma_buffer_pages(command_tables_size, "AHCI Port Command Tables", Memory::Region::Access::ReadWrite, m_command_table_pages).release_value_but_fixme_should_propagate_errors();
 
     m_command_list_region = MM.allocate_dma_buffer_page("AHCI Port Command List", Memory::Region::Access::ReadWrite, m_command_list_page).release_value_but_fixme_should_propagate_errors();
 
@@ -97,38 +95,20 @@ void AHCIPort::handle_interrupt()
         });
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
-        m_wait_for_completion = false;
-
-        // Now schedule reading/writing the buffer as soon as we leave the irq handler.
+    // A command is done once the HBA cleared its bit in PxCI and, for queued commands, the device cleared it in PxSACT.
+    u32 completed_command_slots = 0;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        completed_command_slots = m_issued_command_slots & ~(m_port_registers.ci | m_port_registers.sact);
+        m_issued_command_slots &= ~completed_command_slots;
+    }
+    if (completed_command_slots != 0) {
+        // Now schedule reading/writing the buffers as soon as we leave the irq handler.
         // This is important so that we can safely access the buffers, which could
         // trigger page faults
-        if (!m_current_request) {
-            dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
-        } else {
-            g_io_work->queue([this]() {
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
-                MutexLocker locker(m_lock);
-                VERIFY(m_current_request);
-                VERIFY(m_current_scatter_list);
-                if (!m_connected_device) {
-                    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                    complete_current_request(AsyncDeviceRequest::Failure);
-                    return;
-                }
-                if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
-                    if (auto result = m_current_request->write_to_buffer(m_current_request->buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * m_current_request->block_count()); result.is_error()) {
-                        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
-                        m_current_scatter_list = nullptr;
-                        complete_current_request(AsyncDeviceRequest::MemoryFault);
-                        return;
-                    }
-                }
-                m_current_scatter_list = nullptr;
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                complete_current_request(AsyncDeviceRequest::Success);
-            });
-        }
+        g_io_work->queue([this, completed_command_slots]() {
+            complete_command_slots(completed_command_slots);
+        });
     }
 
     m_interrupt_status.clear();
@@ -142,12 +122,19 @@ bool AHCIPort::is_interrupts_enabled() const
 void AHCIPort::recover_from_fatal_error()
 {
     MutexLocker locker(m_lock);
-    SpinlockLocker lock(m_hard_lock);
-    dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_handler->hba_controller()->pci_address(), representative_port_index());
-    dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_handler->hba_controller()->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
-    stop_command_list_processing();
-    stop_fis_receiving();
-    m_interrupt_enable.clear();
+    FinishedRequests finished_requests;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_handler->hba_controller()->pci_address(), representative_port_index());
+        dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_handler->hba_controller()->pci_address(), representative_port_index(), (u32)m_port_registers.serr);
+        stop_command_list_processing();
+        stop_fis_receiving();
+        m_interrupt_enable.clear();
+        m_issued_command_slots = 0;
+    }
+    fail_all_requests(finished_requests);
+    locker.unlock();
+    complete_finished_requests(finished_requests);
 }
 
 void AHCIPort::eject()
@@ -226,26 +213,35 @@ void AHCIPort::eject()
 bool AHCIPort::reset()
 {
     MutexLocker locker(m_lock);
-    SpinlockLocker lock(m_hard_lock);
-
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Resetting", representative_port_index());
-
-    if (m_disabled_by_firmware) {
-        dmesgln("AHCI Port {}: Disabled by firmware ", representative_port_index());
-        return false;
-    }
-    full_memory_barrier();
-    m_interrupt_enable.clear();
-    m_interrupt_status.clear();
-    full_memory_barrier();
-    start_fis_receiving();
-    full_memory_barrier();
-    clear_sata_error_register();
-    full_memory_barrier();
-    if (!initiate_sata_reset()) {
-        return false;
-    }
-    return initialize();
+    // Whatever was in flight doesn't survive the reset.
+    FinishedRequests finished_requests;
+    fail_all_requests(finished_requests);
+    auto success = [&]() {
+        SpinlockLocker lock(m_hard_lock);
+        m_issued_command_slots = 0;
+
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Resetting", representative_port_index());
+
+        if (m_disabled_by_firmware) {
+            dmesgln("AHCI Port {}: Disabled by firmware ", representative_port_index());
+            return false;
+        }
+        full_memory_barrier();
+        m_interrupt_enable.clear();
+        m_interrupt_status.clear();
+        full_memory_barrier();
+        start_fis_receiving();
+        full_memory_barrier();
+        clear_sata_error_register();
+        full_memory_barrier();
+        if (!initiate_sata_reset()) {
+            return false;
+        }
+        return initialize();
+    }();
+    locker.unlock();
+    complete_finished_requests(finished_requests);
+    return success;
 }
 
 bool AHCIPort::initialize_without_reset()
@@ -309,9 +305,25 @@ bool AHCIPort::initialize()
 
         dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size);
 
+        // Native Command Queuing needs both the HBA and the device to support it.
+        size_t command_slot_count = 1;
+        m_native_command_queuing = m_parent_handler->hba_capabilities().native_command_queuing_supported && (identify_block->serial_ata_capabilities & (1 << 8));
+        if (m_native_command_queuing) {
+            size_t device_queue_depth = (identify_block->queue_depth & 0x1f) + 1;
+            command_slot_count = min(device_queue_depth, m_parent_handler->hba_capabilities().max_command_list_entries_count);
+        }
+        if (!allocate_command_slots(command_slot_count)) {
+            dmesgln("AHCI Port {}: Failed to allocate DMA buffers for {} command slots, not using command queuing", representative_port_index(), command_slot_count);
+            m_native_command_queuing = false;
+            if (!allocate_command_slots(1))
+                return false;
+        }
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Native command queuing {}, {} command slots", representative_port_index(), m_native_command_queuing ? "enabled" : "disabled", m_command_slot_count);
+
         // FIXME: We don't support ATAPI devices yet, so for now we don't "create" them
         if (!is_atapi_attached()) {
             m_connected_device = ATADiskDevice::create(m_parent_handler->hba_controller(), { m_port_index, 0 }, 0, logical_sector_size, max_addressable_sector);
+            m_connected_device->set_max_concurrent_requests(m_command_slot_count + max_pending_requests);
         } else {
             dbgln("AHCI Port {}: Ignoring ATAPI devices for now as we don't currently support them.", representative_port_index());
         }
@@ -434,67 +446,155 @@ void AHCIPort::set_sleep_state() const
     m_port_registers.cmd = (m_port_registers.cmd & 0x0ffffff) | (0b1000 << 28);
 }
 
-size_t AHCIPort::calculate_descriptors_count(size_t block_count) const
+bool AHCIPort::allocate_command_slots(size_t count)
 {
-    VERIFY(m_connected_device);
-    size_t needed_dma_regions_count = Memory::page_round_up((block_count * m_connected_device->block_size())).value() / PAGE_SIZE;
-    VERIFY(needed_dma_regions_count <= m_dma_buffers.size());
-    return needed_dma_regions_count;
+    VERIFY(m_lock.is_locked());
+    VERIFY(count > 0 && count <= m_command_table_pages.size());
+    // NOTE: Nothing can be in flight while we're (re-)initializing the port.
+    VERIFY(m_issued_command_slots == 0);
+    if (!m_dma_region || m_command_slot_count != count) {
+        NonnullRefPtrVector<Memory::PhysicalPage> dma_buffers;
+        auto dma_region_or_error = MM.allocate_dma_buffer_pages(count * max_pages_per_command * PAGE_SIZE, "AHCI Port DMA Buffers", Memory::Region::Access::ReadWrite, dma_buffers);
+        if (dma_region_or_error.is_error())
+            return false;
+        m_dma_region = dma_region_or_error.release_value();
+        m_dma_buffers = move(dma_buffers);
+    }
+    m_command_slot_count = count;
+    m_free_command_slots = count == 32 ? NumericLimits<u32>::max() : (1u << count) - 1;
+    return true;
 }
 
-Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request)
+void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 {
-    VERIFY(m_lock.is_locked());
+    MutexLocker locker(m_lock);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
     VERIFY(request.block_count() > 0);
 
-    NonnullRefPtrVector<Memory::PhysicalPage> allocated_dma_regions;
-    for (size_t index = 0; index < calculate_descriptors_count(request.block_count()); index++) {
-        allocated_dma_regions.append(m_dma_buffers.at(index));
+    if (!m_connected_device || !is_operable()) {
+        locker.unlock();
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
     }
+    // NOTE: We never hand out more requests to the block layer than we can keep track of here.
+    VERIFY(request.block_count() * m_connected_device->block_size() <= max_pages_per_command * PAGE_SIZE);
+    m_pending_requests.append(request);
 
-    m_current_scatter_list = Memory::ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size());
-    if (!m_current_scatter_list)
-        return AsyncDeviceRequest::Failure;
-    if (request.request_type() == AsyncBlockDeviceRequest::Write) {
-        if (auto result = request.read_from_buffer(request.buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count()); result.is_error()) {
-            return AsyncDeviceRequest::MemoryFault;
+    FinishedRequests finished_requests;
+    start_pending_requests(finished_requests);
+    locker.unlock();
+    complete_finished_requests(finished_requests);
+}
+
+void AHCIPort::start_pending_requests(FinishedRequests& finished_requests)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(m_connected_device);
+    auto block_size = m_connected_device->block_size();
+
+    while (!m_pending_requests.is_empty() && m_free_command_slots != 0) {
+        u8 command_slot = count_trailing_zeroes(m_free_command_slots);
+        auto& command = m_command_slots[command_slot];
+        VERIFY(command.requests.is_empty());
+        auto dma_buffer = command_slot_dma_buffer(command_slot);
+
+        auto first_request = m_pending_requests.take_first();
+        if (first_request->request_type() == AsyncBlockDeviceRequest::Write) {
+            if (auto result = first_request->read_from_buffer(first_request->buffer(), dma_buffer.as_ptr(), block_size * first_request->block_count()); result.is_error()) {
+                finished_requests.append({ move(first_request), AsyncDeviceRequest::MemoryFault });
+                continue;
+            }
+        }
+        command.direction = first_request->request_type();
+        command.lba = first_request->block_index();
+        command.block_count = first_request->block_count();
+        command.requests.append(move(first_request));
+
+        // Merge the requests that continue right where this command ends, as long as they fit into the slot's DMA buffer.
+        while (!m_pending_requests.is_empty()) {
+            auto& next_request = m_pending_requests.first();
+            if (next_request->request_type() != command.direction || next_request->block_index() != command.lba + command.block_count)
+                break;
+            if ((command.block_count + next_request->block_count()) * block_size > max_pages_per_command * PAGE_SIZE)
+                break;
+            if (command.direction == AsyncBlockDeviceRequest::Write) {
+                auto* destination = dma_buffer.offset(command.block_count * block_size).as_ptr();
+                if (auto result = next_request->read_from_buffer(next_request->buffer(), destination, block_size * next_request->block_count()); result.is_error()) {
+                    finished_requests.append({ m_pending_requests.take_first(), AsyncDeviceRequest::MemoryFault });
+                    break;
+                }
+            }
+            if (command.requests.try_append(next_request).is_error())
+                break;
+            command.block_count += next_request->block_count();
+            m_pending_requests.remove(0);
+        }
+
+        m_free_command_slots &= ~(1u << command_slot);
+        if (!access_device(command_slot)) {
+            dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
+            for (auto& request : command.requests)
+                finished_requests.append({ request, AsyncDeviceRequest::Failure });
+            command.requests.clear();
+            m_free_command_slots |= 1u << command_slot;
         }
     }
-    return {};
 }
 
-void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
+void AHCIPort::complete_command_slots(u32 command_slots)
 {
     MutexLocker locker(m_lock);
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
-    VERIFY(!m_current_request);
-    VERIFY(!m_current_scatter_list);
-
-    m_current_request = request;
-
-    auto result = prepare_and_set_scatter_list(request);
-    if (result.has_value()) {
-        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
-        locker.unlock();
-        complete_current_request(result.value());
-        return;
+    FinishedRequests finished_requests;
+    for (u8 command_slot = 0; command_slot < m_command_slot_count; ++command_slot) {
+        if (!(command_slots & (1u << command_slot)))
+            continue;
+        auto& command = m_command_slots[command_slot];
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled in command slot {}", representative_port_index(), command_slot);
+        size_t offset = 0;
+        for (auto& request : command.requests) {
+            if (!m_connected_device) {
+                finished_requests.append({ request, AsyncDeviceRequest::Failure });
+                continue;
+            }
+            auto size = m_connected_device->block_size() * request->block_count();
+            auto result = AsyncDeviceRequest::Success;
+            if (request->request_type() == AsyncBlockDeviceRequest::Read) {
+                if (request->write_to_buffer(request->buffer(), command_slot_dma_buffer(command_slot).offset(offset).as_ptr(), size).is_error()) {
+                    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
+                    result = AsyncDeviceRequest::MemoryFault;
+                }
+            }
+            offset += size;
+            finished_requests.append({ request, result });
+        }
+        command.requests.clear();
+        m_free_command_slots |= 1u << command_slot;
     }
+    if (m_connected_device && is_operable())
+        start_pending_requests(finished_requests);
+    locker.unlock();
+    complete_finished_requests(finished_requests);
+}
 
-    auto success = access_device(request.request_type(), request.block_index(), request.block_count());
-    if (!success) {
-        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
-        locker.unlock();
-        complete_current_request(AsyncDeviceRequest::Failure);
-        return;
+void AHCIPort::fail_all_requests(FinishedRequests& finished_requests)
+{
+    VERIFY(m_lock.is_locked());
+    for (u8 command_slot = 0; command_slot < m_command_slot_count; ++command_slot) {
+        auto& command = m_command_slots[command_slot];
+        for (auto& request : command.requests)
+            finished_requests.append({ request, AsyncDeviceRequest::Failure });
+        command.requests.clear();
     }
+    while (!m_pending_requests.is_empty())
+        finished_requests.append({ m_pending_requests.take_first(), AsyncDeviceRequest::Failure });
+    m_free_command_slots = m_command_slot_count == 32 ? NumericLimits<u32>::max() : (1u << m_command_slot_count) - 1;
 }
 
-void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
+void AHCIPort::complete_finished_requests(FinishedRequests& finished_requests)
 {
-    VERIFY(m_current_request);
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    current_request->complete(result);
+    for (auto& finished_request : finished_requests)
+        finished_request.request->complete(finished_request.result);
+    finished_requests.clear();
 }
 
 bool AHCIPort::spin_until_ready() const
@@ -513,59 +613,54 @@ bool AHCIPort::spin_until_ready() const
     return true;
 }
 
-bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
+bool AHCIPort::access_device(u8 command_slot)
 {
     VERIFY(m_connected_device);
     VERIFY(is_operable());
     VERIFY(m_lock.is_locked());
-    VERIFY(m_current_scatter_list);
     SpinlockLocker lock(m_hard_lock);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count);
-    if (!spin_until_ready())
+    auto& command = m_command_slots[command_slot];
+    auto direction = command.direction;
+    auto lba = command.lba;
+    auto block_count = command.block_count;
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} in command slot {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, command_slot);
+    // NOTE: Queued commands are issued while others are still in flight, the HBA takes care of their ordering.
+    if (m_issued_command_slots == 0 && !spin_until_ready())
         return false;
 
-    auto unused_command_header = try_to_find_unused_command_header();
-    VERIFY(unused_command_header.has_value());
+    size_t data_transfer_count = block_count * m_connected_device->block_size();
+    size_t descriptors_count = Memory::page_round_up(data_transfer_count).value() / PAGE_SIZE;
+    VERIFY(descriptors_count <= max_pages_per_command);
+
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
-    command_list_entries[unused_command_header.value()].ctbau = 0;
-    command_list_entries[unused_command_header.value()].prdbc = 0;
-    command_list_entries[unused_command_header.value()].prdtl = m_current_scatter_list->scatters_count();
+    command_list_entries[command_slot].ctba = m_command_table_pages[command_slot].paddr().get();
+    command_list_entries[command_slot].ctbau = 0;
+    command_list_entries[command_slot].prdbc = 0;
+    command_list_entries[command_slot].prdtl = descriptors_count;
 
     // Note: we must set the correct Dword count in this register. Real hardware
     // AHCI controllers do care about this field! QEMU doesn't care if we don't
     // set the correct CFL field in this register, real hardware will set an
     // handshake error bit in PxSERR register if CFL is incorrect.
-    command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
-
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[unused_command_header.value()].ctba, (u32)command_list_entries[unused_command_header.value()].ctbau, (u32)command_list_entries[unused_command_header.value()].prdbc, (u16)command_list_entries[unused_command_header.value()].prdtl, (u16)command_list_entries[unused_command_header.value()].attributes);
-
-    auto command_table_region = MM.allocate_kernel_region(m_command_table_pages[unused_command_header.value()].paddr().page_base(), Memory::page_round_up(sizeof(AHCI::CommandTable)).value(), "AHCI Command Table", Memory::Region::Access::ReadWrite, Memory::Region::Cacheable::No).release_value();
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    // The prefetch bit must not be set for queued commands.
+    command_list_entries[command_slot].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | (m_native_command_queuing ? 0 : AHCI::CommandHeaderAttributes::P) | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Allocated command table at {}", representative_port_index(), command_table_region->vaddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[command_slot].ctba, (u32)command_list_entries[command_slot].ctbau, (u32)command_list_entries[command_slot].prdbc, (u16)command_list_entries[command_slot].prdtl, (u16)command_list_entries[command_slot].attributes);
 
+    auto& command_table = *(volatile AHCI::CommandTable*)m_command_table_region->vaddr().offset(command_slot * PAGE_SIZE).as_ptr();
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
 
-    size_t scatter_entry_index = 0;
-    size_t data_transfer_count = (block_count * m_connected_device->block_size());
-    for (auto scatter_page : m_current_scatter_list->vmobject().physical_pages()) {
-        VERIFY(data_transfer_count != 0);
-        VERIFY(scatter_page);
-        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page->paddr());
+    for (size_t scatter_entry_index = 0; scatter_entry_index < descriptors_count; ++scatter_entry_index) {
+        auto& scatter_page = m_dma_buffers[command_slot * max_pages_per_command + scatter_entry_index];
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page.paddr());
         command_table.descriptors[scatter_entry_index].base_high = 0;
-        command_table.descriptors[scatter_entry_index].base_low = scatter_page->paddr().get();
-        if (data_transfer_count <= PAGE_SIZE) {
-            command_table.descriptors[scatter_entry_index].byte_count = data_transfer_count - 1;
-            data_transfer_count = 0;
-        } else {
-            command_table.descriptors[scatter_entry_index].byte_count = PAGE_SIZE - 1;
-            data_transfer_count -= PAGE_SIZE;
-        }
-        scatter_entry_index++;
+        command_table.descriptors[scatter_entry_index].base_low = scatter_page.paddr().get();
+        auto byte_count = min(data_transfer_count, PAGE_SIZE);
+        command_table.descriptors[scatter_entry_index].byte_count = byte_count - 1;
+        data_transfer_count -= byte_count;
     }
-    command_table.descriptors[scatter_entry_index].byte_count = (PAGE_SIZE - 1) | (1 << 31);
+    VERIFY(data_transfer_count == 0);
 
     memset(const_cast<u8*>(command_table.atapi_command), 0, 32);
 
@@ -574,6 +669,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_native_command_queuing) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -592,17 +692,22 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
-
-    // The below loop waits until the port is no longer busy before issuing a new command
-    if (!spin_until_ready())
-        return false;
+    if (m_native_command_queuing) {
+        // Queued commands carry the sector count in the features field and their tag in the count field.
+        fis.features_low = block_count & 0xff;
+        fis.features_high = (block_count >> 8) & 0xff;
+        fis.count = command_slot << 3;
+    } else {
+        fis.count = block_count;
+    }
 
     full_memory_barrier();
-    mark_command_header_ready_to_process(unused_command_header.value());
+    if (m_native_command_queuing)
+        m_port_registers.sact = 1 << command_slot;
+    mark_command_header_ready_to_process(command_slot);
     full_memory_barrier();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[0].paddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} in command slot {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, command_slot);
     return true;
 }
 
@@ -723,13 +828,13 @@ void AHCIPort::start_command_list_processing() const
     m_port_registers.cmd = m_port_registers.cmd | 1;
 }
 
-void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index) const
+void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(m_hard_lock.is_locked());
     VERIFY(is_operable());
-    VERIFY(!m_wait_for_completion);
-    m_wait_for_completion = true;
+    VERIFY(!(m_issued_command_slots & (1 << command_header_index)));
+    m_issued_command_slots |= 1 << command_header_index;
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Marking command header at index {} as ready to process.", representative_port_index(), command_header_index);
     m_port_registers.ci = 1 << command_header_index;
 }
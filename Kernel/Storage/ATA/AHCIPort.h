@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Vector.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
 #include <Kernel/Devices/Device.h>
@@ -16,7 +18,6 @@
 #include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/PhysicalPage.h>
-#include <Kernel/Memory/ScatterGatherList.h>
 #include <Kernel/PhysicalAddress.h>
 #include <Kernel/Random.h>
 #include <Kernel/Sections.h>
@@ -37,6 +38,12 @@ class AHCIPort
     friend class AHCIController;
 
 public:
+    // Requests that wait for a free command slot get merged with the ones directly following them on disk,
+    // into a single transfer of up to this many pages.
+    static constexpr size_t max_pages_per_command = 8;
+    // How many requests may wait for a free command slot, on top of the ones that are in flight.
+    static constexpr size_t max_pending_requests = 32;
+
     UNMAP_AFTER_INIT static NonnullRefPtr<AHCIPort> create(const AHCIPortHandler&, volatile AHCI::PortRegisters&, u32 port_index);
 
     u32 port_index() const { return m_port_index; }
@@ -70,11 +77,28 @@ private:
     ALWAYS_INLINE void spin_up() const;
     ALWAYS_INLINE void power_on() const;
 
+    struct CommandSlot {
+        Vector<NonnullRefPtr<AsyncBlockDeviceRequest>, 4> requests;
+        AsyncBlockDeviceRequest::RequestType direction { AsyncBlockDeviceRequest::Read };
+        u64 lba { 0 };
+        u16 block_count { 0 };
+    };
+
+    struct FinishedRequest {
+        NonnullRefPtr<AsyncBlockDeviceRequest> request;
+        AsyncDeviceRequest::RequestResult result;
+    };
+    // NOTE: Requests are only completed once m_lock has been released, as completing one can start the next one.
+    using FinishedRequests = Vector<FinishedRequest, 32>;
+
     void start_request(AsyncBlockDeviceRequest&);
-    void complete_current_request(AsyncDeviceRequest::RequestResult);
-    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
-    size_t calculate_descriptors_count(size_t block_count) const;
-    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request);
+    void start_pending_requests(FinishedRequests&);
+    void complete_command_slots(u32 command_slots);
+    void fail_all_requests(FinishedRequests&);
+    static void complete_finished_requests(FinishedRequests&);
+    bool access_device(u8 command_slot);
+    bool allocate_command_slots(size_t count);
+    VirtualAddress command_slot_dma_buffer(u8 command_slot) const { return m_dma_region->vaddr().offset(command_slot * max_pages_per_command * PAGE_SIZE); }
 
     ALWAYS_INLINE bool is_interrupts_enabled() const;
 
@@ -83,7 +107,7 @@ private:
     bool identify_device();
 
     ALWAYS_INLINE void start_command_list_processing() const;
-    ALWAYS_INLINE void mark_command_header_ready_to_process(u8 command_header_index) const;
+    ALWAYS_INLINE void mark_command_header_ready_to_process(u8 command_header_index);
     ALWAYS_INLINE void stop_command_list_processing() const;
 
     ALWAYS_INLINE void start_fis_receiving() const;
@@ -103,14 +127,22 @@ private:
     // Data members
 
     EntropySource m_entropy_source;
-    RefPtr<AsyncBlockDeviceRequest> m_current_request;
     Spinlock m_hard_lock;
     Mutex m_lock { "AHCIPort" };
 
-    mutable bool m_wait_for_completion { false };
+    // NOTE: Each command slot comes with max_pages_per_command pages of m_dma_region.
+    Array<CommandSlot, 32> m_command_slots;
+    size_t m_command_slot_count { 0 };
+    u32 m_free_command_slots { 0 };
+    // Accessed from the interrupt handler, so this one is protected by m_hard_lock.
+    u32 m_issued_command_slots { 0 };
+    bool m_native_command_queuing { false };
+    Vector<NonnullRefPtr<AsyncBlockDeviceRequest>> m_pending_requests;
 
     NonnullRefPtrVector<Memory::PhysicalPage> m_dma_buffers;
+    OwnPtr<Memory::Region> m_dma_region;
     NonnullRefPtrVector<Memory::PhysicalPage> m_command_table_pages;
+    OwnPtr<Memory::Region> m_command_table_region;
     RefPtr<Memory::PhysicalPage> m_command_list_page;
     OwnPtr<Memory::Region> m_command_list_region;
     RefPtr<Memory::PhysicalPage> m_fis_receive_page;
@@ -122,7 +154,6 @@ private:
     AHCI::PortInterruptStatusBitField m_interrupt_status;
     AHCI::PortInterruptEnableBitField m_interrupt_enable;
 
-    RefPtr<Memory::ScatterGatherList> m_current_scatter_list;
     bool m_disabled_by_firmware { false };
 };
 }
@@ -32,6 +32,10 @@ public:
     // ^BlockDevice
     virtual void start_request(AsyncBlockDeviceRequest&) override;
 
+    // ^Device
+    virtual size_t max_concurrent_requests() const override { return m_max_concurrent_requests; }
+    void set_max_concurrent_requests(size_t count) { m_max_concurrent_requests = count; }
+
     u16 ata_capabilites() const { return m_capabilities; }
     const Address& ata_address() const { return m_ata_address; }
 
@@ -41,6 +45,7 @@ protected:
     WeakPtr<ATAController> m_controller;
     const Address m_ata_address;
     const u16 m_capabilities;
+    size_t m_max_concurrent_requests { 1 };
 };
 
 }
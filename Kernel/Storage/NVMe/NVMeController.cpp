@@ -37,8 +37,6 @@ UNMAP_AFTER_INIT NVMeController::NVMeController(const PCI::DeviceIdentifier& dev
 
 UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
 {
-    // Nr of queues = one queue per core
-    auto nr_of_queues = Processor::count();
     auto irq = is_queue_polled ? Optional<u8> {} : m_pci_device_id.interrupt_line().value();
 
     PCI::enable_memory_space(m_pci_device_id.address());
@@ -58,10 +56,13 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::initialize(bool is_queue_polled)
     TRY(create_admin_queue(irq));
     VERIFY(m_admin_queue_ready == true);
 
-    VERIFY(IO_QUEUE_SIZE < MQES(caps));
-    dbgln_if(NVME_DEBUG, "NVMe: IO queue depth is: {}", IO_QUEUE_SIZE);
+    m_io_queue_depth = min(IO_QUEUE_SIZE, MQES(caps));
+    dbgln_if(NVME_DEBUG, "NVMe: IO queue depth is: {}", m_io_queue_depth);
+
+    // Ideally we get one queue per core, but the controller may not have that many.
+    auto nr_of_queues = request_number_of_io_queues(Processor::count());
+    dbgln_if(NVME_DEBUG, "NVMe: Using {} IO queues", nr_of_queues);
 
-    // Create an IO queue per core
     for (u32 cpuid = 0; cpuid < nr_of_queues; ++cpuid) {
         // qid is zero is used for admin queue
         TRY(create_io_queue(cpuid + 1, irq));
@@ -149,6 +150,21 @@ UNMAP_AFTER_INIT u32 NVMeController::get_admin_q_dept()
     return q_depth;
 }
 
+UNMAP_AFTER_INIT u32 NVMeController::request_number_of_io_queues(u32 nr_of_queues)
+{
+    NVMeSubmission sub {};
+    u32 result = 0;
+    sub.op = OP_ADMIN_SET_FEATURES;
+    sub.generic.cdw10 = AK::convert_between_host_and_little_endian<u32>(FEATURE_NUMBER_OF_QUEUES);
+    sub.generic.cdw11 = AK::convert_between_host_and_little_endian(NUMBER_OF_QUEUES(nr_of_queues, nr_of_queues));
+    if (auto status = m_admin_queue->submit_sync_sqe(sub, &result); status) {
+        dmesgln("NVMe: Failed to set the number of IO queues (status {:#x}), using a single queue", status);
+        return 1;
+    }
+    // The controller may allocate fewer (or more) queues than we asked for.
+    return min(nr_of_queues, min(NSQA(result), NCQA(result)));
+}
+
 UNMAP_AFTER_INIT ErrorOr<void> NVMeController::identify_and_init_namespaces()
 {
 
@@ -303,8 +319,8 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, Optional<
     NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_pages;
     OwnPtr<Memory::Region> sq_dma_region;
     NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_pages;
-    auto cq_size = round_up_to_power_of_two(CQ_SIZE(IO_QUEUE_SIZE), 4096);
-    auto sq_size = round_up_to_power_of_two(SQ_SIZE(IO_QUEUE_SIZE), 4096);
+    auto cq_size = round_up_to_power_of_two(CQ_SIZE(m_io_queue_depth), 4096);
+    auto sq_size = round_up_to_power_of_two(SQ_SIZE(m_io_queue_depth), 4096);
 
     {
         auto buffer = TRY(MM.allocate_dma_buffer_pages(cq_size, "IO CQ queue", Memory::Region::Access::ReadWrite, cq_dma_pages));
@@ -326,7 +342,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, Optional<
         sub.create_cq.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(cq_dma_pages.first().paddr().as_ptr()));
         sub.create_cq.cqid = qid;
         // The queue size is 0 based
-        sub.create_cq.qsize = AK::convert_between_host_and_little_endian(IO_QUEUE_SIZE - 1);
+        sub.create_cq.qsize = AK::convert_between_host_and_little_endian<u16>(m_io_queue_depth - 1);
         auto flags = irq.has_value() ? QUEUE_IRQ_ENABLED : QUEUE_IRQ_DISABLED;
         flags |= QUEUE_PHY_CONTIGUOUS;
         // TODO: Eventually move to MSI.
@@ -341,7 +357,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, Optional<
         sub.create_sq.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(sq_dma_pages.first().paddr().as_ptr()));
         sub.create_sq.sqid = qid;
         // The queue size is 0 based
-        sub.create_sq.qsize = AK::convert_between_host_and_little_endian(IO_QUEUE_SIZE - 1);
+        sub.create_sq.qsize = AK::convert_between_host_and_little_endian<u16>(m_io_queue_depth - 1);
         auto flags = QUEUE_PHY_CONTIGUOUS;
         sub.create_sq.cqid = qid;
         sub.create_sq.sq_flags = AK::convert_between_host_and_little_endian(flags);
@@ -351,7 +367,7 @@ UNMAP_AFTER_INIT ErrorOr<void> NVMeController::create_io_queue(u8 qid, Optional<
     auto queue_doorbell_offset = REG_SQ0TDBL_START + ((2 * qid) * (4 << m_dbl_stride));
     auto doorbell_regs = TRY(Memory::map_typed_writable<volatile DoorbellRegister>(PhysicalAddress(m_bar + queue_doorbell_offset)));
 
-    m_queues.append(TRY(NVMeQueue::try_create(qid, irq, IO_QUEUE_SIZE, move(cq_dma_region), cq_dma_pages, move(sq_dma_region), sq_dma_pages, move(doorbell_regs))));
+    m_queues.append(TRY(NVMeQueue::try_create(qid, irq, m_io_queue_depth, move(cq_dma_region), cq_dma_pages, move(sq_dma_region), sq_dma_pages, move(doorbell_regs))));
     dbgln_if(NVME_DEBUG, "NVMe: Created IO Queue with QID{}", m_queues.size());
     return {};
 }
@@ -56,6 +56,7 @@ public:
     void set_admin_queue_ready_flag() { m_admin_queue_ready = true; };
 
 private:
+    u32 request_number_of_io_queues(u32 nr_of_queues);
     ErrorOr<void> identify_and_init_namespaces();
     Tuple<u64, u8> get_ns_features(IdentifyNamespace& identify_data_struct);
     ErrorOr<void> create_admin_queue(Optional<u8> irq);
@@ -75,6 +76,7 @@ private:
     bool m_admin_queue_ready { false };
     size_t m_device_count {};
     AK::Time m_ready_timeout;
+    u32 m_io_queue_depth { 0 };
     u32 m_bar;
     u8 m_dbl_stride;
     static Atomic<u8> controller_id;
@@ -45,7 +45,7 @@ static constexpr u8 CAP_DBL_SHIFT = 32;
 static constexpr u8 CAP_DBL_MASK = 0xf;
 static constexpr u8 CAP_TO_SHIFT = 24;
 static constexpr u64 CAP_TO_MASK = 0xff << CAP_TO_SHIFT;
-static constexpr u16 MQES(u64 cap)
+static constexpr u32 MQES(u64 cap)
 {
     return (cap & 0xffff) + 1;
 }
@@ -79,11 +79,11 @@ static constexpr u16 ASQ_SIZE(u32 x)
 }
 static constexpr u8 CQ_WIDTH = 4; // CQ is 16 bytes(2^4) in size.
 static constexpr u8 SQ_WIDTH = 6; // SQ size is 64 bytes(2^6) in size.
-static constexpr u16 CQ_SIZE(u16 q_depth)
+static constexpr u32 CQ_SIZE(u32 q_depth)
 {
     return q_depth << CQ_WIDTH;
 }
-static constexpr u16 SQ_SIZE(u16 q_depth)
+static constexpr u32 SQ_SIZE(u32 q_depth)
 {
     return q_depth << SQ_WIDTH;
 }
@@ -97,7 +97,10 @@ static constexpr u16 CQ_STATUS_FIELD(u16 x)
     return (x & CQ_STATUS_FIELD_MASK) >> 1;
 }
 
-static constexpr u16 IO_QUEUE_SIZE = 64; // TODO:Need to be configurable
+// The IO queues are made as deep as the controller allows (CAP.MQES), up to this many entries.
+static constexpr u32 IO_QUEUE_SIZE = 1024;
+// Every IO command in flight needs a page of DMA memory, so they are limited separately from the queue depth.
+static constexpr u32 IO_QUEUE_MAX_REQUESTS_IN_FLIGHT = 128;
 
 // IDENTIFY
 static constexpr u16 NVMe_IDENTIFY_SIZE = 4096;
@@ -114,8 +117,25 @@ enum AdminCommandOpCode {
     OP_ADMIN_CREATE_COMPLETION_QUEUE = 0x5,
     OP_ADMIN_CREATE_SUBMISSION_QUEUE = 0x1,
     OP_ADMIN_IDENTIFY = 0x6,
+    OP_ADMIN_SET_FEATURES = 0x9,
 };
 
+// FEATURE IDENTIFIERS
+static constexpr u8 FEATURE_NUMBER_OF_QUEUES = 0x7;
+// Both the requested and the allocated number of queues are 0 based
+static constexpr u32 NUMBER_OF_QUEUES(u16 nr_of_submission_queues, u16 nr_of_completion_queues)
+{
+    return ((nr_of_completion_queues - 1) << 16) | (nr_of_submission_queues - 1);
+}
+static constexpr u32 NSQA(u32 x)
+{
+    return (x & 0xffff) + 1;
+}
+static constexpr u32 NCQA(u32 x)
+{
+    return (x >> 16) + 1;
+}
+
 // IO opcodes
 enum IOCommandOpcode {
     OP_NVME_WRITE = 0x1,
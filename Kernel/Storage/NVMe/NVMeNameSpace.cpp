@@ -29,16 +29,21 @@ UNMAP_AFTER_INIT NVMeNameSpace::NVMeNameSpace(NonnullRefPtrVector<NVMeQueue> que
 
 void NVMeNameSpace::start_request(AsyncBlockDeviceRequest& request)
 {
-    auto index = Processor::current_id();
+    // NOTE: There may be fewer queues than processors if the controller couldn't give us one for each.
+    auto index = Processor::current_id() % m_queues.size();
     auto& queue = m_queues.at(index);
     // TODO: For now we support only IO transfers of size PAGE_SIZE (Going along with the current constraint in the block layer)
     // Eventually remove this constraint by using the PRP2 field in the submission struct and remove block layer constraint for NVMe driver.
     VERIFY(request.block_count() <= (PAGE_SIZE / block_size()));
 
-    if (request.request_type() == AsyncBlockDeviceRequest::Read) {
-        queue.read(request, m_nsid, request.block_index(), request.block_count());
-    } else {
-        queue.write(request, m_nsid, request.block_index(), request.block_count());
-    }
+    queue.submit_request(request, m_nsid);
+}
+
+size_t NVMeNameSpace::max_concurrent_requests() const
+{
+    size_t request_slot_count = 0;
+    for (auto& queue : m_queues)
+        request_slot_count += queue.request_slot_count();
+    return request_slot_count;
 }
 }
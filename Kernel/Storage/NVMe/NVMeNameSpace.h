@@ -27,6 +27,7 @@ public:
 
     CommandSet command_set() const override { return CommandSet::NVMe; };
     void start_request(AsyncBlockDeviceRequest& request) override;
+    size_t max_concurrent_requests() const override;
 
 private:
     u16 m_nsid;
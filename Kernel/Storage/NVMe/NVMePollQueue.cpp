@@ -10,35 +10,32 @@
 #include "NVMeDefinitions.h"
 
 namespace Kernel {
-UNMAP_AFTER_INIT NVMePollQueue::NVMePollQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
-    : NVMeQueue(move(rw_dma_region), rw_dma_page, qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))
+UNMAP_AFTER_INIT NVMePollQueue::NVMePollQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
+    : NVMeQueue(move(rw_dma_region), move(rw_dma_pages), qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))
 {
 }
 
 void NVMePollQueue::submit_sqe(NVMeSubmission& sub)
 {
     NVMeQueue::submit_sqe(sub);
-    SpinlockLocker lock_cq(m_cq_lock);
-    while (!process_cq()) {
-        IO::delay(1);
+    Optional<Completion> completion;
+    {
+        SpinlockLocker lock_cq(m_cq_lock);
+        while (!process_cq()) {
+            IO::delay(1);
+        }
+        completion = exchange(m_completion, {});
     }
+    // NOTE: Finishing the request may start the next one, so it has to happen without holding the CQ lock.
+    if (completion.has_value())
+        finish_request(completion->slot, completion->status);
 }
 
-void NVMePollQueue::complete_current_request(u16 status)
+void NVMePollQueue::complete_request(u16 slot, u16 status)
 {
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    if (status) {
-        current_request->complete(AsyncBlockDeviceRequest::Failure);
-        return;
-    }
-    if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-        if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), 512 * current_request->block_count()); result.is_error()) {
-            current_request->complete(AsyncDeviceRequest::MemoryFault);
-            return;
-        }
-    }
-    current_request->complete(AsyncDeviceRequest::Success);
-    return;
+    VERIFY(m_cq_lock.is_locked());
+    // There's only ever one command in flight, so this is the one we've been spinning for.
+    VERIFY(!m_completion.has_value());
+    m_completion = Completion { slot, status };
 }
 }
@@ -16,19 +16,25 @@ namespace Kernel {
 ErrorOr<NonnullRefPtr<NVMeQueue>> NVMeQueue::try_create(u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
 {
     // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalPage> rw_dma_page;
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page));
-    if (!irq.has_value()) {
-        auto queue = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) NVMePollQueue(move(rw_dma_region), *rw_dma_page, qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
-        return queue;
-    }
-    auto queue = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) NVMeInterruptQueue(move(rw_dma_region), *rw_dma_page, qid, irq.value(), q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
-    return queue;
+    // A polled queue spins until its command completes, so it never has more than one in flight.
+    // Otherwise we can have as many commands in flight as fit into the queue at once (minus the one entry that tells a full queue apart from an empty one).
+    size_t request_slot_count = 1;
+    if (qid != 0 && irq.has_value())
+        request_slot_count = min<size_t>(q_depth - 1, IO_QUEUE_MAX_REQUESTS_IN_FLIGHT);
+    NonnullRefPtrVector<Memory::PhysicalPage> rw_dma_pages;
+    auto rw_dma_region = TRY(MM.allocate_dma_buffer_pages(request_slot_count * PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_pages));
+    RefPtr<NVMeQueue> queue;
+    if (!irq.has_value())
+        queue = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) NVMePollQueue(move(rw_dma_region), move(rw_dma_pages), qid, q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
+    else
+        queue = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) NVMeInterruptQueue(move(rw_dma_region), move(rw_dma_pages), qid, irq.value(), q_depth, move(cq_dma_region), cq_dma_page, move(sq_dma_region), sq_dma_page, move(db_regs))));
+    TRY(queue->initialize_request_slots());
+    return queue.release_nonnull();
 }
 
-UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
-    : m_current_request(nullptr)
-    , m_rw_dma_region(move(rw_dma_region))
+UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs)
+    : m_rw_dma_region(move(rw_dma_region))
+    , m_rw_dma_pages(move(rw_dma_pages))
     , m_qid(qid)
     , m_admin_queue(qid == 0)
     , m_qdepth(q_depth)
@@ -37,13 +43,23 @@ UNMAP_AFTER_INIT NVMeQueue::NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_regio
     , m_sq_dma_region(move(sq_dma_region))
     , m_sq_dma_page(sq_dma_page)
     , m_db_regs(move(db_regs))
-    , m_rw_dma_page(rw_dma_page)
 
 {
     m_sqe_array = { reinterpret_cast<NVMeSubmission*>(m_sq_dma_region->vaddr().as_ptr()), m_qdepth };
     m_cqe_array = { reinterpret_cast<NVMeCompletion*>(m_cq_dma_region->vaddr().as_ptr()), m_qdepth };
 }
 
+UNMAP_AFTER_INIT ErrorOr<void> NVMeQueue::initialize_request_slots()
+{
+    auto slot_count = m_rw_dma_pages.size();
+    TRY(m_requests.try_resize(slot_count));
+    TRY(m_free_request_slots.try_ensure_capacity(slot_count));
+    // Hand out the lowest slots first.
+    for (size_t slot = slot_count; slot > 0; --slot)
+        m_free_request_slots.unchecked_append(slot - 1);
+    return {};
+}
+
 bool NVMeQueue::cqe_available()
 {
     return PHASE_TAG(m_cqe_array[m_cq_head].status) == m_cq_valid_phase;
@@ -63,6 +79,7 @@ void NVMeQueue::update_cqe_head()
 
 u32 NVMeQueue::process_cq()
 {
+    VERIFY(m_cq_lock.is_locked());
     u32 nr_of_processed_cqes = 0;
     while (cqe_available()) {
         u16 status;
@@ -74,13 +91,8 @@ u32 NVMeQueue::process_cq()
         // TODO: We don't use AsyncBlockDevice requests for admin queue as it is only applicable for a block device (NVMe namespace)
         //  But admin commands precedes namespace creation. Unify requests to avoid special conditions
         if (m_admin_queue == false) {
-            // As the block layer calls are now sync (as we wait on each requests),
-            // everything is operated on a single request similar to BMIDE driver.
-            // TODO: Remove this constraint eventually.
-            VERIFY(cmdid == m_prev_sq_tail);
-            if (m_current_request) {
-                complete_current_request(status);
-            }
+            VERIFY(cmdid < m_requests.size());
+            complete_request(cmdid, status);
         }
         update_cqe_head();
     }
@@ -93,9 +105,9 @@ u32 NVMeQueue::process_cq()
 void NVMeQueue::submit_sqe(NVMeSubmission& sub)
 {
     SpinlockLocker lock(m_sq_lock);
-    // For now let's use sq tail as a unique command id.
-    sub.cmdid = m_sq_tail;
-    m_prev_sq_tail = m_sq_tail;
+    // IO commands are identified by their request slot, admin commands simply use the sq tail.
+    if (m_admin_queue)
+        sub.cmdid = m_sq_tail;
 
     memcpy(&m_sqe_array[m_sq_tail], &sub, sizeof(NVMeSubmission));
     {
@@ -111,15 +123,16 @@ void NVMeQueue::submit_sqe(NVMeSubmission& sub)
     update_sq_doorbell();
 }
 
-u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
+u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub, u32* command_specific_result)
 {
+    VERIFY(m_admin_queue);
     // For now let's use sq tail as a unique command id.
     u16 cqe_cid;
     u16 cid = m_sq_tail;
+    int index;
 
     submit_sqe(sub);
     do {
-        int index;
         {
             SpinlockLocker lock(m_cq_lock);
             index = m_cq_head - 1;
@@ -130,46 +143,92 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
         IO::delay(1);
     } while (cid != cqe_cid);
 
-    auto status = CQ_STATUS_FIELD(m_cqe_array[m_cq_head].status);
+    if (command_specific_result)
+        *command_specific_result = m_cqe_array[index].cmd_spec;
+    auto status = CQ_STATUS_FIELD(m_cqe_array[index].status);
     return status;
 }
 
-void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::submit_request(AsyncBlockDeviceRequest& request, u16 nsid)
+{
+    SpinlockLocker lock(m_request_lock);
+    if (m_free_request_slots.is_empty()) {
+        // All slots are busy (e.g. several namespaces share this queue), the request gets started once one frees up.
+        if (m_pending_requests.try_append({ request, nsid }).is_error()) {
+            lock.unlock();
+            request.complete(AsyncDeviceRequest::Failure);
+        }
+        return;
+    }
+    auto slot = m_free_request_slots.take_last();
+    m_requests[slot] = request;
+    lock.unlock();
+    start_request_in_slot(slot, request, nsid);
+}
+
+void NVMeQueue::start_request_in_slot(u16 slot, AsyncBlockDeviceRequest& request, u16 nsid)
 {
     NVMeSubmission sub {};
-    SpinlockLocker m_lock(m_request_lock);
-    m_current_request = request;
+    auto* slot_buffer = m_rw_dma_region->vaddr().offset(slot * PAGE_SIZE).as_ptr();
 
-    sub.op = OP_NVME_READ;
+    if (request.request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
+        sub.op = OP_NVME_READ;
+    } else {
+        sub.op = OP_NVME_WRITE;
+        if (auto result = request.read_from_buffer(request.buffer(), slot_buffer, 512 * request.block_count()); result.is_error()) {
+            {
+                SpinlockLocker lock(m_request_lock);
+                m_requests[slot].clear();
+            }
+            release_request_slot(slot);
+            request.complete(AsyncDeviceRequest::MemoryFault);
+            return;
+        }
+    }
+    sub.cmdid = slot;
     sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
+    sub.rw.slba = AK::convert_between_host_and_little_endian(request.block_index());
     // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
+    sub.rw.length = AK::convert_between_host_and_little_endian((request.block_count() - 1) & 0xFFFF);
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_pages[slot].paddr().as_ptr()));
 
     full_memory_barrier();
     submit_sqe(sub);
 }
 
-void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::finish_request(u16 slot, u16 status)
 {
-    NVMeSubmission sub {};
-    SpinlockLocker m_lock(m_request_lock);
-    m_current_request = request;
+    RefPtr<AsyncBlockDeviceRequest> request;
+    {
+        SpinlockLocker lock(m_request_lock);
+        request = move(m_requests[slot]);
+    }
+    VERIFY(request);
+
+    auto result = AsyncDeviceRequest::Success;
+    if (status) {
+        result = AsyncDeviceRequest::Failure;
+    } else if (request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
+        auto* slot_buffer = m_rw_dma_region->vaddr().offset(slot * PAGE_SIZE).as_ptr();
+        if (auto copy_result = request->write_to_buffer(request->buffer(), slot_buffer, 512 * request->block_count()); copy_result.is_error())
+            result = AsyncDeviceRequest::MemoryFault;
+    }
+    // NOTE: The slot's buffer has been copied out of by now, so it can be reused before the request is completed.
+    release_request_slot(slot);
+    request->complete(result);
+}
 
-    if (auto result = m_current_request->read_from_buffer(m_current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), 512 * m_current_request->block_count()); result.is_error()) {
-        complete_current_request(AsyncDeviceRequest::MemoryFault);
+void NVMeQueue::release_request_slot(u16 slot)
+{
+    SpinlockLocker lock(m_request_lock);
+    if (m_pending_requests.is_empty()) {
+        m_free_request_slots.unchecked_append(slot);
         return;
     }
-    sub.op = OP_NVME_WRITE;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-
-    full_memory_barrier();
-    submit_sqe(sub);
+    auto pending = m_pending_requests.take_first();
+    m_requests[slot] = pending.request;
+    lock.unlock();
+    start_request_in_slot(slot, pending.request, pending.nsid);
 }
 
 UNMAP_AFTER_INIT NVMeQueue::~NVMeQueue()
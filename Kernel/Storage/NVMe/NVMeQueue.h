@@ -12,6 +12,7 @@
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
 #include <AK/Types.h>
+#include <AK/Vector.h>
 #include <Kernel/Bus/PCI/Device.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Locking/Spinlock.h>
@@ -31,24 +32,34 @@ class NVMeQueue : public RefCounted<NVMeQueue> {
 public:
     static ErrorOr<NonnullRefPtr<NVMeQueue>> try_create(u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs);
     bool is_admin_queue() { return m_admin_queue; };
-    u16 submit_sync_sqe(NVMeSubmission&);
-    void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
+    u16 submit_sync_sqe(NVMeSubmission&, u32* command_specific_result = nullptr);
+    void submit_request(AsyncBlockDeviceRequest& request, u16 nsid);
+    size_t request_slot_count() const { return m_requests.size(); }
     virtual void submit_sqe(NVMeSubmission&);
     virtual ~NVMeQueue();
 
 protected:
     u32 process_cq();
+    void finish_request(u16 slot, u16 status);
     void update_sq_doorbell()
     {
         m_db_regs->sq_tail = m_sq_tail;
     }
-    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs);
+    NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> rw_dma_pages, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> cq_dma_page, OwnPtr<Memory::Region> sq_dma_region, NonnullRefPtrVector<Memory::PhysicalPage> sq_dma_page, Memory::TypedMapping<volatile DoorbellRegister> db_regs);
 
 private:
+    struct PendingRequest {
+        NonnullRefPtr<AsyncBlockDeviceRequest> request;
+        u16 nsid;
+    };
+
+    ErrorOr<void> initialize_request_slots();
+    void start_request_in_slot(u16 slot, AsyncBlockDeviceRequest& request, u16 nsid);
+    void release_request_slot(u16 slot);
     bool cqe_available();
     void update_cqe_head();
-    virtual void complete_current_request(u16 status) = 0;
+    // Called with the CQ lock held for every completed IO command, slot is its command identifier.
+    virtual void complete_request(u16 slot, u16 status) = 0;
     void update_cq_doorbell()
     {
         m_db_regs->cq_head = m_cq_head;
@@ -56,15 +67,20 @@ private:
 
 protected:
     Spinlock m_cq_lock { LockRank::Interrupts };
-    RefPtr<AsyncBlockDeviceRequest> m_current_request;
-    NonnullOwnPtr<Memory::Region> m_rw_dma_region;
-    Spinlock m_request_lock;
 
 private:
+    // NOTE: Every IO command in flight owns one request slot, which comes with a page of the RW DMA region.
+    //       The command identifier of an IO command is the index of its slot.
+    Spinlock m_request_lock;
+    Vector<RefPtr<AsyncBlockDeviceRequest>> m_requests;
+    Vector<u16> m_free_request_slots;
+    Vector<PendingRequest> m_pending_requests;
+    NonnullOwnPtr<Memory::Region> m_rw_dma_region;
+    NonnullRefPtrVector<Memory::PhysicalPage> m_rw_dma_pages;
+
     u16 m_qid {};
     u8 m_cq_valid_phase { 1 };
     u16 m_sq_tail {};
-    u16 m_prev_sq_tail {};
     u16 m_cq_head {};
     bool m_admin_queue { false };
     u32 m_qdepth {};
@@ -76,6 +92,5 @@ private:
     NonnullRefPtrVector<Memory::PhysicalPage> m_sq_dma_page;
     Span<NVMeCompletion> m_cqe_array;
     Memory::TypedMapping<volatile DoorbellRegister> m_db_regs;
-    NonnullRefPtr<Memory::PhysicalPage> m_rw_dma_page;
 };
 }
@@ -27,36 +27,65 @@ StringView StorageDevice::class_name() const
     return "StorageDevice"sv;
 }
 
+ErrorOr<void> StorageDevice::transfer_whole_blocks(AsyncBlockDeviceRequest::RequestType request_type, u64 index, size_t block_count, const UserOrKernelBuffer& buffer)
+{
+    // PATAChannel will chuck a wobbly if a single request is larger than PAGE_SIZE,
+    // because it uses a single page for its DMA buffer. The requests of a batch are
+    // queued up while the device is plugged, so they still reach the driver back to back.
+    size_t blocks_done = 0;
+    while (blocks_done < block_count) {
+        Vector<NonnullRefPtr<AsyncBlockDeviceRequest>, max_requests_per_batch> requests;
+        ErrorOr<void> result {};
+        {
+            RequestPlug plug(*this);
+            while (blocks_done < block_count && requests.size() < max_requests_per_batch) {
+                size_t blocks = min(block_count - blocks_done, m_blocks_per_page);
+                auto request_or_error = try_make_request<AsyncBlockDeviceRequest>(request_type, index + blocks_done, blocks, buffer.offset(blocks_done * block_size()), blocks * block_size());
+                if (request_or_error.is_error()) {
+                    result = request_or_error.release_error();
+                    break;
+                }
+                requests.unchecked_append(request_or_error.release_value());
+                blocks_done += blocks;
+            }
+        }
+
+        // NOTE: Every request that was started still refers to the buffer, so we can't bail out until all of them are done.
+        for (auto& request : requests) {
+            auto request_result = request->wait();
+            if (result.is_error())
+                continue;
+            if (request_result.wait_result().was_interrupted()) {
+                result = Error::from_errno(EINTR);
+                continue;
+            }
+            switch (request_result.request_result()) {
+            case AsyncDeviceRequest::Failure:
+            case AsyncDeviceRequest::Cancelled:
+                result = Error::from_errno(EIO);
+                break;
+            case AsyncDeviceRequest::MemoryFault:
+                result = Error::from_errno(EFAULT);
+                break;
+            default:
+                break;
+            }
+        }
+        TRY(result);
+    }
+    return {};
+}
+
 ErrorOr<size_t> StorageDevice::read(OpenFileDescription&, u64 offset, UserOrKernelBuffer& outbuf, size_t len)
 {
     u64 index = offset >> block_size_log();
     size_t whole_blocks = len >> block_size_log();
     size_t remaining = len - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to read more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
-        remaining = 0;
-    }
-
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::read() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
-    if (whole_blocks > 0) {
-        auto read_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf, whole_blocks * block_size()));
-        auto result = read_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
-    }
+    if (whole_blocks > 0)
+        TRY(transfer_whole_blocks(AsyncBlockDeviceRequest::Read, index, whole_blocks, outbuf));
 
     off_t pos = whole_blocks * block_size();
 
@@ -95,13 +124,6 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, const Use
     size_t whole_blocks = len >> block_size_log();
     size_t remaining = len - (whole_blocks << block_size_log());
 
-    // PATAChannel will chuck a wobbly if we try to write more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= m_blocks_per_page) {
-        whole_blocks = m_blocks_per_page;
-        remaining = 0;
-    }
-
     // We try to allocate the temporary block buffer for partial writes *before* we start any full block writes,
     // to try and prevent partial writes
     Optional<ByteBuffer> partial_write_block;
@@ -110,21 +132,8 @@ ErrorOr<size_t> StorageDevice::write(OpenFileDescription&, u64 offset, const Use
 
     dbgln_if(STORAGE_DEVICE_DEBUG, "StorageDevice::write() index={}, whole_blocks={}, remaining={}", index, whole_blocks, remaining);
 
-    if (whole_blocks > 0) {
-        auto write_request = TRY(try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf, whole_blocks * block_size()));
-        auto result = write_request->wait();
-        if (result.wait_result().was_interrupted())
-            return EINTR;
-        switch (result.request_result()) {
-        case AsyncDeviceRequest::Failure:
-        case AsyncDeviceRequest::Cancelled:
-            return EIO;
-        case AsyncDeviceRequest::MemoryFault:
-            return EFAULT;
-        default:
-            break;
-        }
-    }
+    if (whole_blocks > 0)
+        TRY(transfer_whole_blocks(AsyncBlockDeviceRequest::Write, index, whole_blocks, inbuf));
 
     off_t pos = whole_blocks * block_size();
 
@@ -31,6 +31,7 @@ public:
         SCSI,
         ATA,
         NVMe,
+        VirtIO,
     };
 
 public:
@@ -61,6 +62,11 @@ protected:
     virtual StringView class_name() const override;
 
 private:
+    // The most requests that are queued up at once for a single read() or write().
+    static constexpr size_t max_requests_per_batch = 32;
+
+    ErrorOr<void> transfer_whole_blocks(AsyncBlockDeviceRequest::RequestType, u64 index, size_t block_count, const UserOrKernelBuffer&);
+
     mutable IntrusiveListNode<StorageDevice, RefPtr<StorageDevice>> m_list_node;
     NonnullRefPtrVector<DiskPartition> m_partitions;
 
@@ -12,10 +12,12 @@
 #include <Kernel/Bus/PCI/API.h>
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/Bus/PCI/Controller/VolumeManagementDevice.h>
+#include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/CommandLine.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/Ext2FileSystem.h>
 #include <Kernel/Panic.h>
+#include <Kernel/Process.h>
 #include <Kernel/Storage/ATA/AHCIController.h>
 #include <Kernel/Storage/ATA/ISAIDEController.h>
 #include <Kernel/Storage/ATA/PCIIDEController.h>
@@ -25,6 +27,8 @@
 #include <Kernel/Storage/Partition/MBRPartitionTable.h>
 #include <Kernel/Storage/RamdiskController.h>
 #include <Kernel/Storage/StorageManagement.h>
+#include <Kernel/Storage/VirtIO/VirtIOBlockController.h>
+#include <Kernel/WaitQueue.h>
 
 namespace Kernel {
 
@@ -77,6 +81,18 @@ UNMAP_AFTER_INIT void StorageManagement::enumerate_pci_controllers(bool force_pi
                 }
             }
 
+            if (device_identifier.hardware_id().vendor_id == PCI::VendorID::VirtIO) {
+                if (device_identifier.hardware_id().device_id == PCI::DeviceID::VirtIOBlockDevice && !kernel_command_line().disable_virtio()) {
+                    auto controller = VirtIOBlockController::try_initialize(device_identifier);
+                    if (controller.is_error()) {
+                        dmesgln("Unable to initialize VirtIO block device: {}", controller.error());
+                    } else {
+                        m_controllers.append(controller.release_value());
+                    }
+                }
+                return;
+            }
+
             auto subclass_code = static_cast<SubclassID>(device_identifier.subclass_code().value());
             if (subclass_code == SubclassID::IDEController && kernel_command_line().is_ide_enabled()) {
                 m_controllers.append(PCIIDEController::initialize(device_identifier, force_pio));
@@ -152,9 +168,38 @@ UNMAP_AFTER_INIT OwnPtr<PartitionTable> StorageManagement::try_to_initialize_par
 UNMAP_AFTER_INIT void StorageManagement::enumerate_disk_partitions()
 {
     VERIFY(!m_storage_devices.is_empty());
+
+    // Reading a partition table means waiting on the device, so every device gets a thread of its own to read its table.
+    // The partitions are only added afterwards, in device order, as their minor numbers depend on it.
+    Vector<StorageDevice&> devices;
+    for (auto& device : m_storage_devices)
+        devices.append(device);
+    Vector<OwnPtr<PartitionTable>> partition_tables;
+    partition_tables.resize(devices.size());
+
+    // NOTE: These are static so that they outlive this function for as long as a probe thread is still waking us up.
+    static Atomic<size_t> s_remaining_probe_count;
+    static WaitQueue s_probes_done;
+    s_remaining_probe_count = devices.size();
+
+    auto probe_device = [&](size_t index) {
+        partition_tables[index] = try_to_initialize_partition_table(devices[index]);
+        if (--s_remaining_probe_count == 0)
+            s_probes_done.wake_all();
+    };
+    for (size_t i = 0; i < devices.size(); ++i) {
+        RefPtr<Thread> probe_thread;
+        auto name = KString::formatted("Partition probe #{}", i);
+        if (name.is_error() || !Process::create_kernel_process(probe_thread, name.release_value(), [&probe_device, i] { probe_device(i); }))
+            probe_device(i);
+    }
+    while (s_remaining_probe_count.load() != 0)
+        s_probes_done.wait_forever("StorageManagement"sv);
+
     size_t device_index = 0;
-    for (auto& device : m_storage_devices) {
-        auto partition_table = try_to_initialize_partition_table(device);
+    for (size_t i = 0; i < devices.size(); ++i) {
+        auto& device = devices[i];
+        auto& partition_table = partition_tables[i];
         if (!partition_table)
             continue;
         for (size_t partition_index = 0; partition_index < partition_table->partitions_count(); partition_index++) {
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <Kernel/Arch/x86/Processor.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Storage/VirtIO/VirtIOBlockController.h>
+#include <Kernel/Storage/VirtIO/VirtIOBlockDevice.h>
+#include <Kernel/WorkQueue.h>
+
+namespace Kernel {
+
+// NOTE: The device always counts in sectors of this size, no matter what its block size is.
+static constexpr size_t virtio_blk_sector_size = 512;
+
+UNMAP_AFTER_INIT ErrorOr<NonnullRefPtr<VirtIOBlockController>> VirtIOBlockController::try_initialize(PCI::DeviceIdentifier const& device_identifier)
+{
+    auto controller = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) VirtIOBlockController(device_identifier)));
+    TRY(controller->initialize_block_device());
+    return controller;
+}
+
+UNMAP_AFTER_INIT VirtIOBlockController::VirtIOBlockController(PCI::DeviceIdentifier const& device_identifier)
+    : StorageController()
+    , VirtIO::Device(device_identifier)
+{
+}
+
+UNMAP_AFTER_INIT ErrorOr<void> VirtIOBlockController::initialize_block_device()
+{
+    VirtIO::Device::initialize();
+    auto const* cfg = get_config(VirtIO::ConfigurationType::Device);
+    if (!cfg)
+        return ENODEV;
+
+    bool success = negotiate_features([&](u64 supported_features) {
+        u64 negotiated = 0;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_BLK_SIZE))
+            negotiated |= VIRTIO_BLK_F_BLK_SIZE;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_RO))
+            negotiated |= VIRTIO_BLK_F_RO;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_MQ))
+            negotiated |= VIRTIO_BLK_F_MQ;
+        return negotiated;
+    });
+    if (!success)
+        return EIO;
+
+    u64 capacity = 0;
+    u16 queue_count = 1;
+    read_config_atomic([&]() {
+        capacity = config_read32(*cfg, VIRTIO_BLK_CONFIG_CAPACITY) | (u64)config_read32(*cfg, VIRTIO_BLK_CONFIG_CAPACITY + 4) << 32;
+        if (is_feature_accepted(VIRTIO_BLK_F_BLK_SIZE))
+            m_block_size = config_read32(*cfg, VIRTIO_BLK_CONFIG_BLK_SIZE);
+        if (is_feature_accepted(VIRTIO_BLK_F_MQ))
+            queue_count = config_read16(*cfg, VIRTIO_BLK_CONFIG_NUM_QUEUES);
+    });
+    m_read_only = is_feature_accepted(VIRTIO_BLK_F_RO);
+
+    if (m_block_size < virtio_blk_sector_size || m_block_size > PAGE_SIZE || !is_power_of_two(m_block_size)) {
+        dbgln("VirtIOBlockController: Unsupported block size {}", m_block_size);
+        return ENOTSUP;
+    }
+
+    // One queue per processor is all we can make use of.
+    queue_count = clamp<u16>(queue_count, 1, Processor::count());
+    if (!setup_queues(queue_count))
+        return EIO;
+    TRY(m_request_queues.try_resize(queue_count));
+    for (u16 queue_index = 0; queue_index < queue_count; ++queue_index)
+        TRY(initialize_request_queue(queue_index));
+    finish_init();
+
+    u64 block_count = capacity / (m_block_size / virtio_blk_sector_size);
+    m_device = TRY(VirtIOBlockDevice::try_create(*this, m_block_size, block_count));
+    dmesgln("VirtIOBlockController: {} blocks of {} bytes, {} request queues{}", block_count, m_block_size, queue_count, m_read_only ? " (read-only)"sv : ""sv);
+    return {};
+}
+
+UNMAP_AFTER_INIT ErrorOr<void> VirtIOBlockController::initialize_request_queue(u16 queue_index)
+{
+    auto& queue = get_queue(queue_index);
+    auto& request_queue = m_request_queues[queue_index];
+    size_t slot_count = min<size_t>(queue.size() / descriptors_per_request, max_requests_per_queue);
+    if (slot_count == 0)
+        return ENOSPC;
+
+    auto control_region_size = TRY(Memory::page_round_up(slot_count * sizeof(RequestSlotControl)));
+    request_queue.control_region = TRY(MM.allocate_dma_buffer_pages(control_region_size, "VirtIO Block Request Control"sv, Memory::Region::Access::ReadWrite, request_queue.control_pages));
+    request_queue.data_region = TRY(MM.allocate_dma_buffer_pages(slot_count * PAGE_SIZE, "VirtIO Block Request Data"sv, Memory::Region::Access::ReadWrite, request_queue.data_pages));
+    TRY(request_queue.requests.try_resize(slot_count));
+    TRY(request_queue.slot_for_descriptor.try_resize(queue.size()));
+    TRY(request_queue.free_slots.try_ensure_capacity(slot_count));
+    for (size_t slot = slot_count; slot > 0; --slot)
+        request_queue.free_slots.unchecked_append(slot - 1);
+    return {};
+}
+
+RefPtr<StorageDevice> VirtIOBlockController::device(u32 index) const
+{
+    if (index != 0)
+        return {};
+    return m_device;
+}
+
+size_t VirtIOBlockController::devices_count() const
+{
+    return m_device ? 1 : 0;
+}
+
+bool VirtIOBlockController::reset()
+{
+    TODO();
+}
+
+bool VirtIOBlockController::shutdown()
+{
+    TODO();
+}
+
+void VirtIOBlockController::complete_current_request(AsyncDeviceRequest::RequestResult)
+{
+    VERIFY_NOT_REACHED();
+}
+
+size_t VirtIOBlockController::request_slot_count() const
+{
+    size_t slot_count = 0;
+    for (auto& request_queue : m_request_queues)
+        slot_count += request_queue.requests.size();
+    return slot_count;
+}
+
+auto VirtIOBlockController::slot_control(RequestQueue& request_queue, u16 slot) -> RequestSlotControl&
+{
+    return reinterpret_cast<RequestSlotControl*>(request_queue.control_region->vaddr().as_ptr())[slot];
+}
+
+PhysicalAddress VirtIOBlockController::slot_control_address(RequestQueue& request_queue, u16 slot) const
+{
+    return request_queue.control_pages.first().paddr().offset(slot * sizeof(RequestSlotControl));
+}
+
+void VirtIOBlockController::start_request(Badge<VirtIOBlockDevice>, AsyncBlockDeviceRequest& request)
+{
+    // NOTE: The block layer never hands us more than a page at a time.
+    VERIFY(request.block_count() * m_block_size <= PAGE_SIZE);
+    if (m_read_only && request.request_type() == AsyncBlockDeviceRequest::RequestType::Write) {
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+
+    // Start out with this processor's queue, but take whichever has room. The device never starts
+    // more requests than there are slots in total, so one of them is bound to have a free slot.
+    size_t first_queue_index = Processor::current_id() % m_request_queues.size();
+    for (size_t i = 0; i < m_request_queues.size(); ++i) {
+        u16 queue_index = (first_queue_index + i) % m_request_queues.size();
+        auto& request_queue = m_request_queues[queue_index];
+        Optional<u16> slot;
+        {
+            SpinlockLocker lock(get_queue(queue_index).lock());
+            if (!request_queue.free_slots.is_empty()) {
+                slot = request_queue.free_slots.take_last();
+                request_queue.requests[slot.value()] = request;
+            }
+        }
+        if (slot.has_value()) {
+            submit_request_in_slot(queue_index, slot.value(), request);
+            return;
+        }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void VirtIOBlockController::submit_request_in_slot(u16 queue_index, u16 slot, AsyncBlockDeviceRequest& request)
+{
+    auto& request_queue = m_request_queues[queue_index];
+    size_t size = request.block_count() * m_block_size;
+    bool is_write = request.request_type() == AsyncBlockDeviceRequest::RequestType::Write;
+
+    if (is_write) {
+        auto* slot_buffer = request_queue.data_region->vaddr().offset(slot * PAGE_SIZE).as_ptr();
+        if (auto result = request.read_from_buffer(request.buffer(), slot_buffer, size); result.is_error()) {
+            {
+                SpinlockLocker lock(get_queue(queue_index).lock());
+                request_queue.requests[slot].clear();
+            }
+            release_request_slot(queue_index, slot);
+            request.complete(AsyncDeviceRequest::MemoryFault);
+            return;
+        }
+    }
+
+    auto& control = slot_control(request_queue, slot);
+    control.header.type = AK::convert_between_host_and_little_endian<u32>(is_write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN);
+    control.header.reserved = 0;
+    control.header.sector = AK::convert_between_host_and_little_endian<u64>(request.block_index() * (m_block_size / virtio_blk_sector_size));
+    control.status = 0xff;
+
+    auto& queue = get_queue(queue_index);
+    SpinlockLocker lock(queue.lock());
+    VirtIO::QueueChain chain(queue);
+    auto control_address = slot_control_address(request_queue, slot);
+    // NOTE: A queue has enough descriptors for all of its slots, so none of these can fail.
+    //       The status byte directly follows the header.
+    bool did_add_buffers = chain.add_buffer_to_chain(control_address, sizeof(RequestHeader), VirtIO::BufferType::DeviceReadable)
+        && chain.add_buffer_to_chain(request_queue.data_pages[slot].paddr(), size, is_write ? VirtIO::BufferType::DeviceReadable : VirtIO::BufferType::DeviceWritable)
+        && chain.add_buffer_to_chain(control_address.offset(sizeof(RequestHeader)), sizeof(u8), VirtIO::BufferType::DeviceWritable);
+    VERIFY(did_add_buffers);
+    request_queue.slot_for_descriptor[chain.start_of_chain_index()] = slot;
+    supply_chain_and_notify(queue_index, chain);
+}
+
+bool VirtIOBlockController::handle_device_config_change()
+{
+    // NOTE: We don't support resizing the disk while it's in use, there's nothing else to react to.
+    dbgln_if(VIRTIO_DEBUG, "VirtIOBlockController: Ignoring device config change");
+    return true;
+}
+
+void VirtIOBlockController::handle_queue_update(u16 queue_index)
+{
+    auto& queue = get_queue(queue_index);
+    auto& request_queue = m_request_queues[queue_index];
+    SpinlockLocker lock(queue.lock());
+    size_t used;
+    for (auto chain = queue.pop_used_buffer_chain(used); !chain.is_empty(); chain = queue.pop_used_buffer_chain(used)) {
+        u16 slot = request_queue.slot_for_descriptor[chain.start_of_chain_index()];
+        chain.release_buffer_slots_to_queue();
+        u8 status = slot_control(request_queue, slot).status;
+        // NOTE: The data may have to be copied out to userspace, which we can't do from the interrupt handler.
+        g_io_work->queue([this, queue_index, slot, status]() {
+            finish_request(queue_index, slot, status);
+        });
+    }
+}
+
+void VirtIOBlockController::finish_request(u16 queue_index, u16 slot, u8 status)
+{
+    auto& request_queue = m_request_queues[queue_index];
+    RefPtr<AsyncBlockDeviceRequest> request;
+    {
+        SpinlockLocker lock(get_queue(queue_index).lock());
+        request = move(request_queue.requests[slot]);
+    }
+    VERIFY(request);
+
+    auto result = AsyncDeviceRequest::Success;
+    if (status != VIRTIO_BLK_S_OK) {
+        dbgln_if(VIRTIO_DEBUG, "VirtIOBlockController: Request for block {} failed with status {}", request->block_index(), status);
+        result = AsyncDeviceRequest::Failure;
+    } else if (request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
+        auto* slot_buffer = request_queue.data_region->vaddr().offset(slot * PAGE_SIZE).as_ptr();
+        if (auto copy_result = request->write_to_buffer(request->buffer(), slot_buffer, request->block_count() * m_block_size); copy_result.is_error())
+            result = AsyncDeviceRequest::MemoryFault;
+    }
+    // NOTE: The slot's buffer has been copied out of by now, so it can be reused before the request is completed.
+    release_request_slot(queue_index, slot);
+    request->complete(result);
+}
+
+void VirtIOBlockController::release_request_slot(u16 queue_index, u16 slot)
+{
+    SpinlockLocker lock(get_queue(queue_index).lock());
+    m_request_queues[queue_index].free_slots.unchecked_append(slot);
+}
+
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/RefPtr.h>
+#include <AK/Vector.h>
+#include <Kernel/Bus/VirtIO/Device.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Storage/StorageController.h>
+
+namespace Kernel {
+
+#define VIRTIO_BLK_F_SIZE_MAX (1 << 1)
+#define VIRTIO_BLK_F_SEG_MAX (1 << 2)
+#define VIRTIO_BLK_F_GEOMETRY (1 << 4)
+#define VIRTIO_BLK_F_RO (1 << 5)
+#define VIRTIO_BLK_F_BLK_SIZE (1 << 6)
+#define VIRTIO_BLK_F_FLUSH (1 << 9)
+#define VIRTIO_BLK_F_TOPOLOGY (1 << 10)
+#define VIRTIO_BLK_F_CONFIG_WCE (1 << 11)
+#define VIRTIO_BLK_F_MQ (1 << 12)
+
+// virtio_blk_config
+#define VIRTIO_BLK_CONFIG_CAPACITY 0x0
+#define VIRTIO_BLK_CONFIG_BLK_SIZE 0x14
+#define VIRTIO_BLK_CONFIG_NUM_QUEUES 0x22
+
+#define VIRTIO_BLK_T_IN 0
+#define VIRTIO_BLK_T_OUT 1
+
+#define VIRTIO_BLK_S_OK 0
+#define VIRTIO_BLK_S_IOERR 1
+#define VIRTIO_BLK_S_UNSUPP 2
+
+class VirtIOBlockDevice;
+
+// A virtio-blk device exposes a single disk, but may give us a request queue for every processor.
+class VirtIOBlockController final
+    : public StorageController
+    , public VirtIO::Device {
+public:
+    static ErrorOr<NonnullRefPtr<VirtIOBlockController>> try_initialize(PCI::DeviceIdentifier const&);
+    virtual ~VirtIOBlockController() override = default;
+
+    virtual StringView purpose() const override { return class_name(); }
+
+    // ^StorageController
+    virtual RefPtr<StorageDevice> device(u32 index) const override;
+    virtual size_t devices_count() const override;
+
+    void start_request(Badge<VirtIOBlockDevice>, AsyncBlockDeviceRequest&);
+    size_t request_slot_count() const;
+
+protected:
+    // ^StorageController
+    virtual bool reset() override;
+    virtual bool shutdown() override;
+    virtual void complete_current_request(AsyncDeviceRequest::RequestResult) override;
+
+private:
+    // The requests of a queue are described by a header, a page of data and a status byte, each in its own descriptor.
+    static constexpr size_t descriptors_per_request = 3;
+    static constexpr size_t max_requests_per_queue = 64;
+
+    struct [[gnu::packed]] RequestHeader {
+        u32 type;
+        u32 reserved;
+        u64 sector;
+    };
+
+    // Every request slot of a queue has its own header and status, and its own page to bounce the data through.
+    struct RequestSlotControl {
+        RequestHeader header;
+        u8 status;
+        u8 padding[15];
+    };
+    static_assert(sizeof(RequestSlotControl) == 32);
+
+    struct RequestQueue {
+        OwnPtr<Memory::Region> control_region;
+        NonnullRefPtrVector<Memory::PhysicalPage> control_pages;
+        OwnPtr<Memory::Region> data_region;
+        NonnullRefPtrVector<Memory::PhysicalPage> data_pages;
+        Vector<RefPtr<AsyncBlockDeviceRequest>> requests;
+        Vector<u16> free_slots;
+        // NOTE: The device hands a request back by the first descriptor of its chain.
+        Vector<u16> slot_for_descriptor;
+    };
+
+    explicit VirtIOBlockController(PCI::DeviceIdentifier const&);
+    ErrorOr<void> initialize_block_device();
+    ErrorOr<void> initialize_request_queue(u16 queue_index);
+
+    virtual StringView class_name() const override { return "VirtIOBlockController"sv; }
+    virtual bool handle_device_config_change() override;
+    virtual void handle_queue_update(u16 queue_index) override;
+
+    RequestSlotControl& slot_control(RequestQueue&, u16 slot);
+    PhysicalAddress slot_control_address(RequestQueue&, u16 slot) const;
+    void submit_request_in_slot(u16 queue_index, u16 slot, AsyncBlockDeviceRequest&);
+    void finish_request(u16 queue_index, u16 slot, u8 status);
+    void release_request_slot(u16 queue_index, u16 slot);
+
+    // NOTE: The state of a request queue is protected by the lock of its VirtIO queue.
+    Vector<RequestQueue> m_request_queues;
+    RefPtr<VirtIOBlockDevice> m_device;
+    size_t m_block_size { 512 };
+    bool m_read_only { false };
+};
+
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Devices/DeviceManagement.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Storage/StorageManagement.h>
+#include <Kernel/Storage/VirtIO/VirtIOBlockController.h>
+#include <Kernel/Storage/VirtIO/VirtIOBlockDevice.h>
+
+namespace Kernel {
+
+static Atomic<u8> s_device_index;
+
+UNMAP_AFTER_INIT ErrorOr<NonnullRefPtr<VirtIOBlockDevice>> VirtIOBlockDevice::try_create(VirtIOBlockController& controller, size_t block_size, u64 max_addressable_block)
+{
+    auto minor_number = StorageManagement::generate_storage_minor_number();
+    auto major_number = StorageManagement::storage_type_major_number();
+    auto device_name = TRY(KString::formatted("vd{:c}", 'a' + s_device_index.fetch_add(1)));
+    return DeviceManagement::try_create_device<VirtIOBlockDevice>(controller, major_number, minor_number, block_size, max_addressable_block, move(device_name));
+}
+
+UNMAP_AFTER_INIT VirtIOBlockDevice::VirtIOBlockDevice(VirtIOBlockController& controller, MajorNumber major_number, MinorNumber minor_number, size_t block_size, u64 max_addressable_block, NonnullOwnPtr<KString> device_name)
+    : StorageDevice(major_number, minor_number, block_size, max_addressable_block, move(device_name))
+    , m_controller(controller)
+{
+}
+
+void VirtIOBlockDevice::start_request(AsyncBlockDeviceRequest& request)
+{
+    m_controller->start_request({}, request);
+}
+
+size_t VirtIOBlockDevice::max_concurrent_requests() const
+{
+    return m_controller->request_slot_count();
+}
+
+}
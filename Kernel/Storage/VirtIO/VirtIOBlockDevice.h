@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullRefPtr.h>
+#include <Kernel/Storage/StorageDevice.h>
+
+namespace Kernel {
+
+class VirtIOBlockController;
+
+class VirtIOBlockDevice final : public StorageDevice {
+    friend class DeviceManagement;
+
+public:
+    static ErrorOr<NonnullRefPtr<VirtIOBlockDevice>> try_create(VirtIOBlockController&, size_t block_size, u64 max_addressable_block);
+    virtual ~VirtIOBlockDevice() override = default;
+
+    // ^StorageDevice
+    virtual CommandSet command_set() const override { return CommandSet::VirtIO; }
+
+    // ^BlockDevice
+    virtual void start_request(AsyncBlockDeviceRequest&) override;
+
+    // ^Device
+    virtual size_t max_concurrent_requests() const override;
+
+private:
+    VirtIOBlockDevice(VirtIOBlockController&, MajorNumber, MinorNumber, size_t block_size, u64 max_addressable_block, NonnullOwnPtr<KString> device_name);
+
+    // ^DiskDevice
+    virtual StringView class_name() const override { return "VirtIOBlockDevice"sv; }
+
+    NonnullRefPtr<VirtIOBlockController> m_controller;
+};
+
+}
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+static ErrorOr<off_t> copy_offset_from_user(off_t* user_offset, OpenFileDescription& description)
+{
+    if (!user_offset)
+        return description.offset();
+    off_t offset;
+    TRY(copy_from_user(&offset, user_offset));
+    if (offset < 0)
+        return EINVAL;
+    return offset;
+}
+
+ErrorOr<FlatPtr> Process::sys$copy_file_range(Userspace<Syscall::SC_copy_file_range_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    // NOTE: No flags are defined yet, but they are reserved for future use (just like on Linux).
+    if (params.flags != 0)
+        return EINVAL;
+    if (params.count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(params.in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    auto out_description = TRY(open_file_description(params.out_fd));
+    if (!out_description->is_writable() || out_description->should_append())
+        return EBADF;
+
+    // NOTE: Both ends have to be regular files, as we read and write at explicit offsets.
+    //       Either end may live on any file system; the copy goes through the inodes' own read and write paths.
+    if (!in_description->inode() || !out_description->inode())
+        return EINVAL;
+    if (in_description->metadata().is_directory() || out_description->metadata().is_directory())
+        return EISDIR;
+    if (!in_description->metadata().is_regular_file() || !out_description->metadata().is_regular_file())
+        return EINVAL;
+
+    auto in_offset = TRY(copy_offset_from_user(params.in_offset, *in_description));
+    auto out_offset = TRY(copy_offset_from_user(params.out_offset, *out_description));
+    if (Checked<off_t>::addition_would_overflow(in_offset, params.count) || Checked<off_t>::addition_would_overflow(out_offset, params.count))
+        return EOVERFLOW;
+
+    // Copying a range of a file onto an overlapping range of the same file is not allowed.
+    if (in_description->inode() == out_description->inode()) {
+        auto count = static_cast<off_t>(params.count);
+        if (in_offset < out_offset + count && out_offset < in_offset + count)
+            return EINVAL;
+    }
+
+    dbgln_if(IO_DEBUG, "sys$copy_file_range({}, {}, {}, {}, {})", params.in_fd, in_offset, params.out_fd, out_offset, params.count);
+
+    if (params.count == 0)
+        return 0;
+
+    auto total_ncopied = TRY(do_copy_through_kernel_buffer(*in_description, in_offset, params.count, "copy_file_range"sv, [&](auto& data, size_t ncopied, size_t size) {
+        return out_description->write(out_offset + ncopied, data, size);
+    }));
+
+    in_offset += total_ncopied;
+    out_offset += total_ncopied;
+    if (params.in_offset)
+        TRY(copy_to_user(params.in_offset, &in_offset));
+    else
+        TRY(in_description->seek(in_offset, SEEK_SET));
+    if (params.out_offset)
+        TRY(copy_to_user(params.out_offset, &out_offset));
+    else
+        TRY(out_description->seek(out_offset, SEEK_SET));
+    return total_ncopied;
+}
+
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$epoll_create(int flags)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EPOLL_CLOEXEC)
+        return EINVAL;
+
+    auto fd_allocation = TRY(allocate_fd());
+    auto event_poll = TRY(EventPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(event_poll)));
+
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        fds[fd_allocation.fd].set(move(description));
+
+        if (flags & EPOLL_CLOEXEC)
+            fds[fd_allocation.fd].set_flags(fds[fd_allocation.fd].flags() | FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto epoll_description = TRY(open_file_description(params.epfd));
+    auto* event_poll = epoll_description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    if (params.op == EPOLL_CTL_DEL) {
+        TRY(event_poll->remove(params.fd));
+        return 0;
+    }
+
+    if (params.op != EPOLL_CTL_ADD && params.op != EPOLL_CTL_MOD)
+        return EINVAL;
+
+    epoll_event event {};
+    TRY(copy_from_user(&event, params.event));
+
+    if (params.op == EPOLL_CTL_MOD) {
+        TRY(event_poll->modify(params.fd, event));
+        return 0;
+    }
+
+    auto description = TRY(open_file_description(params.fd));
+    TRY(event_poll->add(params.fd, move(description), event));
+    return 0;
+}
+
+ErrorOr<FlatPtr> Process::sys$epoll_wait(Userspace<const Syscall::SC_epoll_wait_params*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::stdio));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.maxevents <= 0)
+        return EINVAL;
+
+    auto epoll_description = TRY(open_file_description(params.epfd));
+    auto* event_poll = epoll_description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    // NOTE: The timeout is turned into an absolute deadline once, so that
+    //       spurious wakeups below don't extend the total time we wait.
+    Thread::BlockTimeout timeout;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    sigset_t sigmask = {};
+    if (params.sigmask)
+        TRY(copy_from_user(&sigmask, params.sigmask));
+
+    // There can't be more ready entries than there are open descriptions.
+    size_t max_event_count = min(static_cast<size_t>(params.maxevents), OpenFileDescriptions::max_open());
+    Vector<epoll_event> events;
+    TRY(events.try_resize(max_event_count));
+
+    auto* current_thread = Thread::current();
+
+    u32 previous_signal_mask = 0;
+    if (params.sigmask)
+        previous_signal_mask = current_thread->update_signal_mask(sigmask);
+    ScopeGuard rollback_signal_mask([&]() {
+        if (params.sigmask)
+            current_thread->update_signal_mask(previous_signal_mask);
+    });
+
+    Thread::SelectBlocker::FDVector fds_info;
+    TRY(fds_info.try_append({ epoll_description, Thread::FileBlocker::BlockFlags::Read }));
+
+    size_t event_count = 0;
+    for (;;) {
+        event_count = event_poll->collect_ready_events(events.span());
+        if (event_count > 0)
+            break;
+
+        dbgln_if(POLL_SELECT_DEBUG, "epoll_wait: waiting on fd {}, timeout={}", params.epfd, params.timeout);
+
+        auto block_result = current_thread->block<Thread::SelectBlocker>(timeout, fds_info);
+        if (block_result.was_interrupted())
+            return EINTR;
+        if (block_result == Thread::BlockResult::InterruptedByTimeout) {
+            event_count = event_poll->collect_ready_events(events.span());
+            break;
+        }
+    }
+
+    if (event_count > 0)
+        TRY(copy_to_user(params.events, events.data(), event_count * sizeof(epoll_event)));
+    return event_count;
+}
+
+}
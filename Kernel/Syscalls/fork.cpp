@@ -6,6 +6,7 @@
 
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/Region.h>
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
@@ -111,7 +112,12 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
         for (auto& region : address_space().regions()) {
             dbgln_if(FORK_DEBUG, "fork: cloning Region({}) '{}' @ {}", region, region->name(), region->vaddr());
             auto region_clone = TRY(region->try_clone());
-            TRY(region_clone->map(child->address_space().page_directory(), Memory::ShouldFlushTLB::No));
+            {
+                // The child's pages are mapped in as it touches them. Most children exec() soon after,
+                // so populating their page tables up front would be time proportional to our RSS spent for nothing.
+                SpinlockLocker mm_locker(Memory::s_mm_lock);
+                region_clone->set_page_directory(child->address_space().page_directory());
+            }
             auto* child_region = TRY(child->address_space().add_region(move(region_clone)));
 
             if (region == m_master_tls_region.unsafe_ptr())
@@ -125,6 +131,7 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
 
     SpinlockLocker lock(g_scheduler_lock);
     child_first_thread->set_affinity(Thread::current()->affinity());
+    Scheduler::set_thread_scheduling_policy(*child_first_thread, Thread::current()->scheduling_policy(), Thread::current()->realtime_priority());
     child_first_thread->set_state(Thread::State::Runnable);
 
     auto child_pid = child->pid().value();
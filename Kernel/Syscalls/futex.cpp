@@ -4,40 +4,50 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/HashFunctions.h>
 #include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
 
 namespace Kernel {
 
+Process::FutexBucket& Process::futex_bucket_for(FlatPtr user_address)
+{
+    return m_futex_buckets[ptr_hash(user_address) % futex_bucket_count];
+}
+
 void Process::clear_futex_queues_on_exec()
 {
-    SpinlockLocker lock(m_futex_lock);
-    for (auto& it : m_futex_queues) {
-        bool did_wake_all;
-        it.value->wake_all(did_wake_all);
-        VERIFY(did_wake_all); // No one should be left behind...
+    for (auto& bucket : m_futex_buckets) {
+        SpinlockLocker lock(bucket.lock);
+        for (auto& it : bucket.queues) {
+            bool did_wake_all;
+            it.value->wake_all(did_wake_all);
+            VERIFY(did_wake_all); // No one should be left behind...
+        }
+        bucket.queues.clear();
     }
-    m_futex_queues.clear();
 }
 
 ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     auto params = TRY(copy_typed_from_user(user_params));
 
     Thread::BlockTimeout timeout;
     u32 cmd = params.futex_op & FUTEX_CMD_MASK;
 
     bool use_realtime_clock = (params.futex_op & FUTEX_CLOCK_REALTIME) != 0;
-    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET) {
+    if (use_realtime_clock && cmd != FUTEX_WAIT && cmd != FUTEX_WAIT_BITSET && cmd != FUTEX_LOCK_PI) {
         return ENOSYS;
     }
 
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
+    case FUTEX_LOCK_PI:
     case FUTEX_REQUEUE:
     case FUTEX_CMP_REQUEUE: {
         if (params.timeout) {
@@ -56,26 +66,30 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> u
     }
     }
 
-    auto find_futex_queue = [&](FlatPtr user_address, bool create_if_not_found, bool* did_create = nullptr) -> RefPtr<FutexQueue> {
+    // NOTE: FUTEX_PRIVATE_FLAG is accepted but doesn't change anything, futexes are never shared
+    //       between processes and are always keyed by their address in this process.
+    // NOTE: These all expect the lock of the bucket for user_address to be held.
+    auto find_futex_queue = [&](FutexBucket& bucket, FlatPtr user_address, bool create_if_not_found, bool* did_create = nullptr) -> RefPtr<FutexQueue> {
         VERIFY(!create_if_not_found || did_create != nullptr);
-        auto* queues = &m_futex_queues;
-        auto it = m_futex_queues.find(user_address);
-        if (it != m_futex_queues.end())
+        VERIFY(bucket.lock.is_locked());
+        auto it = bucket.queues.find(user_address);
+        if (it != bucket.queues.end())
             return it->value;
         if (create_if_not_found) {
             *did_create = true;
             auto futex_queue = adopt_ref(*new FutexQueue);
-            auto result = queues->set(user_address, futex_queue);
+            auto result = bucket.queues.set(user_address, futex_queue);
             VERIFY(result == AK::HashSetResult::InsertedNewEntry);
             return futex_queue;
         }
         return {};
     };
 
-    auto remove_futex_queue = [&](FlatPtr user_address) {
-        if (auto it = m_futex_queues.find(user_address); it != m_futex_queues.end()) {
+    auto remove_futex_queue = [&](FutexBucket& bucket, FlatPtr user_address) {
+        VERIFY(bucket.lock.is_locked());
+        if (auto it = bucket.queues.find(user_address); it != bucket.queues.end()) {
             if (it->value->try_remove()) {
-                m_futex_queues.remove(it);
+                bucket.queues.remove(it);
             }
         }
     };
@@ -83,15 +97,16 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> u
     auto do_wake = [&](FlatPtr user_address, u32 count, Optional<u32> bitmask) -> int {
         if (count == 0)
             return 0;
-        SpinlockLocker locker(m_futex_lock);
-        auto futex_queue = find_futex_queue(user_address, false);
+        auto& bucket = futex_bucket_for(user_address);
+        SpinlockLocker locker(bucket.lock);
+        auto futex_queue = find_futex_queue(bucket, user_address, false);
         if (!futex_queue)
             return 0;
         bool is_empty;
         u32 woke_count = futex_queue->wake_n(count, bitmask, is_empty);
         if (is_empty) {
             // If there are no more waiters, we want to get rid of the futex!
-            remove_futex_queue(user_address);
+            remove_futex_queue(bucket, user_address);
         }
         return (int)woke_count;
     };
@@ -99,22 +114,23 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> u
     auto user_address = FlatPtr(params.userspace_address);
     auto user_address2 = FlatPtr(params.userspace_address2);
 
-    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+    auto do_wait_for_value = [&](u32 expected_value, u32 bitset) -> ErrorOr<Thread::BlockResult> {
+        auto& bucket = futex_bucket_for(user_address);
         bool did_create;
         RefPtr<FutexQueue> futex_queue;
         do {
             auto user_value = user_atomic_load_relaxed(params.userspace_address);
             if (!user_value.has_value())
                 return EFAULT;
-            if (user_value.value() != params.val) {
-                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
+            if (user_value.value() != expected_value) {
+                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, expected_value);
                 return EAGAIN;
             }
             atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
 
-            SpinlockLocker locker(m_futex_lock);
+            SpinlockLocker locker(bucket.lock);
             did_create = false;
-            futex_queue = find_futex_queue(user_address, true, &did_create);
+            futex_queue = find_futex_queue(bucket, user_address, true, &did_create);
             VERIFY(futex_queue);
             // We need to try again if we didn't create this queue and the existing queue
             // was removed before we were able to queue an imminent wait.
@@ -125,17 +141,99 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> u
 
         Thread::BlockResult block_result = futex_queue->wait_on(timeout, bitset);
 
-        SpinlockLocker locker(m_futex_lock);
+        SpinlockLocker locker(bucket.lock);
         if (futex_queue->is_empty_and_no_imminent_waits()) {
             // If there are no more waiters, we want to get rid of the futex!
-            remove_futex_queue(user_address);
+            remove_futex_queue(bucket, user_address);
         }
+        return block_result;
+    };
+
+    auto do_wait = [&](u32 bitset) -> ErrorOr<FlatPtr> {
+        auto block_result = TRY(do_wait_for_value(params.val, bitset));
         if (block_result == Thread::BlockResult::InterruptedByTimeout) {
             return ETIMEDOUT;
         }
         return 0;
     };
 
+    // Priority inheritance futexes: While a thread waits on one, its owner runs with the real-time priority of the waiter.
+    auto do_lock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value() & FUTEX_TID_MASK;
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+            if (owner_tid == tid)
+                return EDEADLK;
+
+            if (owner_tid == 0) {
+                // NOTE: We can't tell whether anybody else is still waiting, so the next unlock always goes through the kernel.
+                u32 expected = value;
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, tid | FUTEX_WAITERS);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (did_exchange.value()) {
+                    atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                    return 0;
+                }
+                continue;
+            }
+
+            if (!(value & FUTEX_WAITERS)) {
+                u32 expected = value;
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, expected, value | FUTEX_WAITERS);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (!did_exchange.value())
+                    continue;
+                value |= FUTEX_WAITERS;
+            }
+
+            if (auto priority = current_thread->effective_realtime_priority(); priority != 0) {
+                auto owner = Thread::from_tid(owner_tid);
+                if (owner && &owner->process() == this && priority > owner->effective_realtime_priority())
+                    Scheduler::set_inherited_realtime_priority(*owner, priority);
+            }
+
+            auto block_result = do_wait_for_value(value, 0);
+            if (block_result.is_error()) {
+                if (block_result.error().code() == EAGAIN)
+                    continue;
+                return block_result.release_error();
+            }
+            if (block_result.value() == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.value().was_interrupted())
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> ErrorOr<FlatPtr> {
+        auto* current_thread = Thread::current();
+        u32 tid = current_thread->tid().value() & FUTEX_TID_MASK;
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != tid)
+            return EPERM;
+
+        // FIXME: A thread holding more than one contended futex loses the priority lent to it for the others here as well.
+        if (current_thread->inherited_realtime_priority() != 0)
+            Scheduler::set_inherited_realtime_priority(*current_thread, 0);
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        if (!user_atomic_store_relaxed(params.userspace_address, 0))
+            return EFAULT;
+        // Wake everybody, the scheduler lets the most important waiter run (and take the lock) first.
+        // The others wait again, and lend their priority to the new owner.
+        do_wake(user_address, NumericLimits<u32>::max(), {});
+        return 0;
+    };
+
     auto do_requeue = [&](Optional<u32> val3) -> ErrorOr<FlatPtr> {
         auto user_value = user_atomic_load_relaxed(params.userspace_address);
         if (!user_value.has_value())
@@ -145,8 +243,17 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> u
         atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
 
         int woken_or_requeued = 0;
-        SpinlockLocker locker(m_futex_lock);
-        if (auto futex_queue = find_futex_queue(user_address, false)) {
+        auto& bucket = futex_bucket_for(user_address);
+        auto& target_bucket = futex_bucket_for(user_address2);
+        // NOTE: When both buckets are needed they are always locked in the same order,
+        //       so that two requeues going in opposite directions can't deadlock.
+        auto* first_bucket = &bucket < &target_bucket ? &bucket : &target_bucket;
+        auto* second_bucket = &bucket < &target_bucket ? &target_bucket : &bucket;
+        SpinlockLocker locker(first_bucket->lock);
+        Optional<SpinlockLocker<Spinlock>> second_locker;
+        if (second_bucket != first_bucket)
+            second_locker.emplace(second_bucket->lock);
+        if (auto futex_queue = find_futex_queue(bucket, user_address, false)) {
             RefPtr<FutexQueue> target_futex_queue;
             bool is_empty, is_target_empty;
             woken_or_requeued = futex_queue->wake_n_requeue(
@@ -154,14 +261,15 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> u
                     // NOTE: futex_queue's lock is being held while this callback is called
                     // The reason we're doing this in a callback is that we don't want to always
                     // create a target queue, only if we actually have anything to move to it!
-                    target_futex_queue = find_futex_queue(user_address2, true);
+                    bool did_create_target = false;
+                    target_futex_queue = find_futex_queue(target_bucket, user_address2, true, &did_create_target);
                     return target_futex_queue.ptr();
                 },
                 params.val2, is_empty, is_target_empty);
             if (is_empty)
-                remove_futex_queue(user_address);
+                remove_futex_queue(bucket, user_address);
             if (is_target_empty && target_futex_queue)
-                remove_futex_queue(user_address2);
+                remove_futex_queue(target_bucket, user_address2);
         }
         return woken_or_requeued;
     };
@@ -235,6 +343,12 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> u
         return result;
     }
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi();
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_REQUEUE:
         return do_requeue({});
 
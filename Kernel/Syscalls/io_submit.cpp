@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <Kernel/API/POSIX/serenity.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$io_submit(Userspace<struct io_request*> user_requests, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::stdio));
+    if (count == 0)
+        return 0;
+    if (count > IO_SUBMIT_MAX_REQUESTS)
+        return EINVAL;
+
+    Vector<io_request, 16> requests;
+    TRY(requests.try_resize(count));
+    TRY(copy_n_from_user(requests.data(), Userspace<io_request const*>(user_requests.ptr()), count));
+
+    auto perform_request = [&](io_request& request) -> ErrorOr<FlatPtr> {
+        switch (request.opcode) {
+        case IO_REQUEST_READ:
+            return sys$read(request.fd, Userspace<u8*>((FlatPtr)request.buffer), request.size);
+        case IO_REQUEST_WRITE:
+            return sys$write(request.fd, Userspace<u8 const*>((FlatPtr)request.buffer), request.size);
+        case IO_REQUEST_PREAD: {
+            // NOTE: sys$pread() wants the offset from userspace, so point it at the request's own copy.
+            auto* user_request = user_requests.unsafe_userspace_ptr() + (&request - requests.data());
+            return sys$pread(request.fd, Userspace<u8*>((FlatPtr)request.buffer), request.size, Userspace<off_t const*>((FlatPtr)&user_request->offset));
+        }
+        case IO_REQUEST_FSYNC: {
+            auto description = TRY(open_file_description(request.fd));
+            TRY(description->sync());
+            return 0;
+        }
+        default:
+            return EINVAL;
+        }
+    };
+
+    // The requests are performed in order. If one gets interrupted by a signal, the
+    // remaining ones are left alone so that userspace can resubmit them afterwards.
+    size_t completed_count = 0;
+    for (auto& request : requests) {
+        auto result = perform_request(request);
+        if (result.is_error() && result.error().code() == EINTR)
+            break;
+        request.result = result.is_error() ? -result.error().code() : static_cast<ssize_t>(result.value());
+        ++completed_count;
+    }
+
+    if (completed_count == 0)
+        return EINTR;
+    TRY(try_copy_n_to_user(user_requests, requests.data(), completed_count));
+    return completed_count;
+}
+
+}
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
 #include <Kernel/Arch/SmapDisabler.h>
 #include <Kernel/Arch/x86/MSR.h>
 #include <Kernel/Arch/x86/SafeMem.h>
@@ -303,8 +304,13 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
         // with the exact same start address, but do not deallocate it yet
         auto region = address_space().take_region(*old_region);
 
+        // Flush the old range once the new regions are in place (or we bail out), instead of for every region.
+        ScopeGuard flush_guard([&] {
+            address_space().flush_tlb(region->range());
+        });
+
         // Unmap the old region here, specifying that we *don't* want the VM deallocated.
-        region->unmap(Memory::Region::ShouldDeallocateVirtualRange::No);
+        region->unmap(Memory::Region::ShouldDeallocateVirtualRange::No, Memory::ShouldFlushTLB::No);
 
         // This vector is the region(s) adjacent to our range.
         // We need to allocate a new region for the range we wanted to change permission bits on.
@@ -318,9 +324,9 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
 
         // Map the new regions using our page directory (they were just allocated and don't have one).
         for (auto* adjacent_region : adjacent_regions) {
-            TRY(adjacent_region->map(address_space().page_directory()));
+            TRY(adjacent_region->map(address_space().page_directory(), Memory::ShouldFlushTLB::No));
         }
-        TRY(new_region->map(address_space().page_directory()));
+        TRY(new_region->map(address_space().page_directory(), Memory::ShouldFlushTLB::No));
         return 0;
     }
 
@@ -342,6 +348,18 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
         if (full_size_found != range_to_mprotect.size())
             return ENOMEM;
 
+        // Flush everything we touched at once when we're done (or bail out), instead of for every region.
+        // NOTE: The regions we carve up keep their pages alive until then, the new regions map the same ones.
+        auto flush_base = regions.first()->vaddr();
+        auto flush_end = regions.first()->range().end();
+        for (auto const* region : regions) {
+            flush_base = min(flush_base, region->vaddr());
+            flush_end = max(flush_end, region->range().end());
+        }
+        ScopeGuard flush_guard([&] {
+            address_space().flush_tlb({ flush_base, (flush_end - flush_base).get() });
+        });
+
         // Finally, iterate over each region, either updating its access flags if the range covers it wholly,
         // or carving out a new subregion with the appropriate access flags set.
         for (auto* old_region : regions) {
@@ -355,7 +373,7 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
                 old_region->set_writable(prot & PROT_WRITE);
                 old_region->set_executable(prot & PROT_EXEC);
 
-                old_region->remap();
+                old_region->remap(Memory::ShouldFlushTLB::No);
                 continue;
             }
             // Remove the old region from our regions tree, since were going to add another region
@@ -363,7 +381,7 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
             auto region = address_space().take_region(*old_region);
 
             // Unmap the old region here, specifying that we *don't* want the VM deallocated.
-            region->unmap(Memory::Region::ShouldDeallocateVirtualRange::No);
+            region->unmap(Memory::Region::ShouldDeallocateVirtualRange::No, Memory::ShouldFlushTLB::No);
 
             // This vector is the region(s) adjacent to our range.
             // We need to allocate a new region for the range we wanted to change permission bits on.
@@ -382,9 +400,9 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
 
             // Map the new region using our page directory (they were just allocated and don't have one) if any.
             if (adjacent_regions.size())
-                TRY(adjacent_regions[0]->map(address_space().page_directory()));
+                TRY(adjacent_regions[0]->map(address_space().page_directory(), Memory::ShouldFlushTLB::No));
 
-            TRY(new_region->map(address_space().page_directory()));
+            TRY(new_region->map(address_space().page_directory(), Memory::ShouldFlushTLB::No));
         }
 
         return 0;
@@ -406,12 +424,12 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
     if (!is_user_range(range_to_madvise))
         return EFAULT;
 
-    auto* region = address_space().find_region_from_range(range_to_madvise);
-    if (!region)
-        return EINVAL;
-    if (!region->is_mmap())
-        return EPERM;
     if (advice == MADV_SET_VOLATILE || advice == MADV_SET_NONVOLATILE) {
+        auto* region = address_space().find_region_from_range(range_to_madvise);
+        if (!region)
+            return EINVAL;
+        if (!region->is_mmap())
+            return EPERM;
         if (!region->vmobject().is_anonymous())
             return EINVAL;
         auto& vmobject = static_cast<Memory::AnonymousVMObject&>(region->vmobject());
@@ -421,6 +439,44 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
         TRY(vmobject.set_volatile(advice == MADV_SET_VOLATILE, was_purged));
         return was_purged ? 1 : 0;
     }
+
+    // The access hints can be given for any part of a region, but only ever apply to whole regions.
+    auto* region = address_space().find_region_containing(range_to_madvise);
+    if (!region)
+        return EINVAL;
+    if (!region->is_mmap())
+        return EPERM;
+
+    auto first_page_index = (range_to_madvise.base().get() - region->vaddr().get()) / PAGE_SIZE;
+    auto page_count = range_to_madvise.size() / PAGE_SIZE;
+
+    switch (advice) {
+    case MADV_NORMAL:
+        region->set_access_pattern(Memory::Region::AccessPattern::Normal);
+        return 0;
+    case MADV_SEQUENTIAL:
+        region->set_access_pattern(Memory::Region::AccessPattern::Sequential);
+        return 0;
+    case MADV_RANDOM:
+        region->set_access_pattern(Memory::Region::AccessPattern::Random);
+        return 0;
+    case MADV_WILLNEED:
+        // Anonymous memory has nothing to read in ahead of time.
+        if (region->vmobject().is_inode())
+            TRY(region->prefetch_inode_pages(first_page_index, page_count));
+        return 0;
+    case MADV_DONTNEED: {
+        if (region->vmobject().is_anonymous())
+            return EINVAL;
+        // NOTE: The pages of private file mappings may have been copied on write, so they're left alone.
+        //       Clean pages of shared ones can always be read back in from the inode.
+        if (region->vmobject().is_shared_inode()) {
+            auto& vmobject = static_cast<Memory::InodeVMObject&>(region->vmobject());
+            vmobject.release_clean_pages(region->translate_to_vmobject_page(first_page_index), page_count);
+        }
+        return 0;
+    }
+    }
     return EINVAL;
 }
 
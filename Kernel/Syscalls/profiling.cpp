@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/Coredump.h>
 #include <Kernel/PerformanceManager.h>
 #include <Kernel/Process.h>
@@ -43,6 +44,10 @@ ErrorOr<FlatPtr> Process::sys$profiling_enable(pid_t pid, Userspace<u64 const*>
         SpinlockLocker lock(g_profiling_lock);
         if (!TimeManagement::the().enable_profile_timer())
             return ENOTSUP;
+        if (!PerformanceCounters::enable(event_mask)) {
+            TimeManagement::the().disable_profile_timer();
+            return ENOTSUP;
+        }
         g_profiling_all_threads = true;
         PerformanceManager::add_process_created_event(*Scheduler::colonel());
         Process::for_each([](auto& process) {
@@ -72,6 +77,11 @@ ErrorOr<FlatPtr> Process::sys$profiling_enable(pid_t pid, Userspace<u64 const*>
         process->set_profiling(false);
         return ENOTSUP;
     }
+    if (!PerformanceCounters::enable(event_mask)) {
+        TimeManagement::the().disable_profile_timer();
+        process->set_profiling(false);
+        return ENOTSUP;
+    }
     return 0;
 }
 
@@ -86,6 +96,7 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
         ScopedCritical critical;
         if (!TimeManagement::the().disable_profile_timer())
             return ENOTSUP;
+        PerformanceCounters::disable();
         g_profiling_all_threads = false;
         return 0;
     }
@@ -101,6 +112,7 @@ ErrorOr<FlatPtr> Process::sys$profiling_disable(pid_t pid)
     // FIXME: If we enabled the profile timer and it's not supported, how do we disable it now?
     if (!TimeManagement::the().disable_profile_timer())
         return ENOTSUP;
+    PerformanceCounters::disable();
     process->set_profiling(false);
     return 0;
 }
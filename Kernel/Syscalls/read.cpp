@@ -38,6 +38,10 @@ static ErrorOr<void> check_blocked_read(OpenFileDescription* description)
     return {};
 }
 
+// Vectored reads up to this size go through a single bounce buffer, so the file
+// only sees one read and the data is scattered into the iovecs afterwards.
+static constexpr size_t readv_bounce_buffer_limit = 64 * KiB;
+
 ErrorOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov, int iov_count)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
@@ -60,13 +64,52 @@ ErrorOr<FlatPtr> Process::sys$readv(int fd, Userspace<const struct iovec*> iov,
     }
 
     auto description = TRY(open_readable_file_description(fds(), fd));
+    if (total_length == 0)
+        return 0;
 
-    int nread = 0;
-    for (auto& vec : vecs) {
+    if (vecs.size() > 1 && total_length <= readv_bounce_buffer_limit) {
+        // Catch bad iovecs before consuming any data from the file.
+        for (auto& vec : vecs) {
+            if (vec.iov_len != 0)
+                TRY(UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len));
+        }
+        auto bounce_buffer = TRY(ByteBuffer::create_uninitialized(total_length));
         TRY(check_blocked_read(description));
+        auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(bounce_buffer.data());
+        auto nread = TRY(description->read(kernel_buffer, total_length));
+        size_t nscattered = 0;
+        for (auto& vec : vecs) {
+            if (nscattered == nread)
+                break;
+            auto size = min(vec.iov_len, nread - nscattered);
+            if (size == 0)
+                continue;
+            auto buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, size));
+            TRY(buffer.write(bounce_buffer.data() + nscattered, size));
+            nscattered += size;
+        }
+        return nread;
+    }
+
+    size_t nread = 0;
+    for (auto& vec : vecs) {
+        if (vec.iov_len == 0)
+            continue;
+        // NOTE: Only the first read may block, once we have some data we return it.
+        if (nread == 0)
+            TRY(check_blocked_read(description));
+        else if (!description->can_read())
+            break;
         auto buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len));
-        auto nread_here = TRY(description->read(buffer, vec.iov_len));
-        nread += nread_here;
+        auto result = description->read(buffer, vec.iov_len);
+        if (result.is_error()) {
+            if (nread == 0)
+                return result.release_error();
+            break;
+        }
+        nread += result.value();
+        if (result.value() < vec.iov_len)
+            break;
     }
 
     return nread;
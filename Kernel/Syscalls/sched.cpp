@@ -23,9 +23,6 @@ ErrorOr<FlatPtr> Process::sys$sched_setparam(int pid, Userspace<const struct sch
     TRY(require_promise(Pledge::proc));
     auto param = TRY(copy_typed_from_user(user_param));
 
-    if (param.sched_priority < THREAD_PRIORITY_MIN || param.sched_priority > THREAD_PRIORITY_MAX)
-        return EINVAL;
-
     auto* peer = Thread::current();
     SpinlockLocker lock(g_scheduler_lock);
     if (pid != 0)
@@ -37,6 +34,17 @@ ErrorOr<FlatPtr> Process::sys$sched_setparam(int pid, Userspace<const struct sch
     if (!is_superuser() && euid() != peer->process().uid() && uid() != peer->process().uid())
         return EPERM;
 
+    // For real-time threads, this changes the real-time priority.
+    if (peer->realtime_priority() != 0) {
+        if (param.sched_priority < THREAD_REALTIME_PRIORITY_MIN || param.sched_priority > THREAD_REALTIME_PRIORITY_MAX)
+            return EINVAL;
+        Scheduler::set_thread_scheduling_policy(*peer, peer->scheduling_policy(), (u32)param.sched_priority);
+        return 0;
+    }
+
+    if (param.sched_priority < THREAD_PRIORITY_MIN || param.sched_priority > THREAD_PRIORITY_MAX)
+        return EINVAL;
+
     peer->set_priority((u32)param.sched_priority);
     return 0;
 }
@@ -61,7 +69,7 @@ ErrorOr<FlatPtr> Process::sys$sched_getparam(pid_t pid, Userspace<struct sched_p
         if (!is_superuser() && euid() != peer->process().uid() && uid() != peer->process().uid())
             return EPERM;
 
-        priority = (int)peer->priority();
+        priority = peer->realtime_priority() != 0 ? (int)peer->realtime_priority() : (int)peer->priority();
     }
 
     struct sched_param param {
@@ -72,4 +80,130 @@ ErrorOr<FlatPtr> Process::sys$sched_getparam(pid_t pid, Userspace<struct sched_p
     return 0;
 }
 
+ErrorOr<FlatPtr> Process::sys$sched_setaffinity(pid_t pid, size_t cpusetsize, Userspace<cpu_set_t const*> user_mask)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::proc));
+    if (cpusetsize < sizeof(cpu_set_t))
+        return EINVAL;
+    auto mask = TRY(copy_typed_from_user(user_mask));
+
+    // Bits for processors we don't have are ignored, but at least one of them has to be able to run the thread.
+    auto affinity = mask.__bits & Scheduler::online_processors();
+    if (affinity == 0)
+        return EINVAL;
+
+    auto* peer = Thread::current();
+    SpinlockLocker lock(g_scheduler_lock);
+    if (pid != 0) {
+        // FIXME: PID/TID BUG
+        // The entire process is supposed to be affected.
+        peer = Thread::from_tid(pid);
+    }
+
+    if (!peer)
+        return ESRCH;
+
+    if (!is_superuser() && euid() != peer->process().uid() && uid() != peer->process().uid())
+        return EPERM;
+
+    // Keep the "any processor" affinity for threads that are allowed to run everywhere, so they stay away from isolated processors.
+    if (affinity == Scheduler::online_processors())
+        affinity = THREAD_AFFINITY_DEFAULT;
+    Scheduler::set_thread_affinity(*peer, affinity);
+    return 0;
+}
+
+ErrorOr<FlatPtr> Process::sys$sched_getaffinity(pid_t pid, size_t cpusetsize, Userspace<cpu_set_t*> user_mask)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::proc));
+    if (cpusetsize < sizeof(cpu_set_t))
+        return EINVAL;
+    cpu_set_t mask {};
+    {
+        auto* peer = Thread::current();
+        SpinlockLocker lock(g_scheduler_lock);
+        if (pid != 0) {
+            // FIXME: PID/TID BUG
+            // The entire process is supposed to be affected.
+            peer = Thread::from_tid(pid);
+        }
+
+        if (!peer)
+            return ESRCH;
+
+        if (!is_superuser() && euid() != peer->process().uid() && uid() != peer->process().uid())
+            return EPERM;
+
+        mask.__bits = Scheduler::effective_affinity(*peer) & Scheduler::online_processors();
+    }
+
+    TRY(copy_to_user(user_mask, &mask));
+    return sizeof(cpu_set_t);
+}
+
+ErrorOr<FlatPtr> Process::sys$sched_setscheduler(pid_t pid, int policy, Userspace<const struct sched_param*> user_param)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::proc));
+    auto param = TRY(copy_typed_from_user(user_param));
+
+    bool is_realtime_policy = policy == SCHED_FIFO || policy == SCHED_RR;
+    if (!is_realtime_policy && policy != SCHED_OTHER && policy != SCHED_BATCH)
+        return EINVAL;
+    if (is_realtime_policy && (param.sched_priority < THREAD_REALTIME_PRIORITY_MIN || param.sched_priority > THREAD_REALTIME_PRIORITY_MAX))
+        return EINVAL;
+    if (!is_realtime_policy && param.sched_priority != 0 && (param.sched_priority < THREAD_PRIORITY_MIN || param.sched_priority > THREAD_PRIORITY_MAX))
+        return EINVAL;
+
+    // Real-time threads can starve everybody else, so only the superuser gets to create them.
+    if (is_realtime_policy && !is_superuser())
+        return EPERM;
+
+    auto* peer = Thread::current();
+    SpinlockLocker lock(g_scheduler_lock);
+    if (pid != 0) {
+        // FIXME: PID/TID BUG
+        // The entire process is supposed to be affected.
+        peer = Thread::from_tid(pid);
+    }
+
+    if (!peer)
+        return ESRCH;
+
+    if (!is_superuser() && euid() != peer->process().uid() && uid() != peer->process().uid())
+        return EPERM;
+
+    if (is_realtime_policy) {
+        Scheduler::set_thread_scheduling_policy(*peer, policy, (u32)param.sched_priority);
+    } else {
+        Scheduler::set_thread_scheduling_policy(*peer, policy, 0);
+        if (param.sched_priority != 0)
+            peer->set_priority((u32)param.sched_priority);
+    }
+    return 0;
+}
+
+ErrorOr<FlatPtr> Process::sys$sched_getscheduler(pid_t pid)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::proc));
+    auto* peer = Thread::current();
+    SpinlockLocker lock(g_scheduler_lock);
+    if (pid != 0) {
+        // FIXME: PID/TID BUG
+        // The entire process is supposed to be affected.
+        peer = Thread::from_tid(pid);
+    }
+
+    if (!peer)
+        return ESRCH;
+
+    if (!is_superuser() && euid() != peer->process().uid() && uid() != peer->process().uid())
+        return EPERM;
+
+    return peer->scheduling_policy();
+}
+
 }
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// The data is staged through a kernel buffer of this size at most, so that it
+// never has to be copied out to (and back in from) userspace.
+static constexpr size_t kernel_buffer_chunk_size = 64 * KiB;
+
+ErrorOr<size_t> Process::do_copy_through_kernel_buffer(OpenFileDescription& in_description, off_t in_offset, size_t count, StringView buffer_name, Function<ErrorOr<size_t>(UserOrKernelBuffer const&, size_t ncopied, size_t size)> write)
+{
+    auto buffer = TRY(KBuffer::try_create_with_size(min(count, kernel_buffer_chunk_size), Memory::Region::Access::ReadWrite, buffer_name));
+    auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer->data());
+
+    size_t total_ncopied = 0;
+    auto result = [&]() -> ErrorOr<void> {
+        while (total_ncopied < count) {
+            auto nread = TRY(in_description.read(kernel_buffer, in_offset + total_ncopied, min(count - total_ncopied, buffer->size())));
+            if (nread == 0)
+                break;
+            auto nwritten = TRY(write(kernel_buffer, total_ncopied, nread));
+            total_ncopied += nwritten;
+            // The destination doesn't want more right now (e.g. a non-blocking socket whose send buffer is full).
+            if (nwritten < nread)
+                break;
+        }
+        return {};
+    }();
+
+    // Whatever was copied before an error still counts.
+    if (result.is_error() && total_ncopied == 0)
+        return result.release_error();
+    return total_ncopied;
+}
+
+ErrorOr<FlatPtr> Process::sys$sendfile(int out_fd, int in_fd, Userspace<off_t*> user_offset, size_t count)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
+    TRY(require_promise(Pledge::stdio));
+    if (count == 0)
+        return 0;
+    if (count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    // NOTE: Only regular files can always be read from without blocking, which
+    //       lets us keep the read and write sides in lockstep below.
+    if (!in_description->inode() || !in_description->metadata().is_regular_file())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t offset;
+    if (user_offset) {
+        TRY(copy_from_user(&offset, user_offset));
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    dbgln_if(IO_DEBUG, "sys$sendfile({}, {}, {}, {})", out_fd, in_fd, offset, count);
+
+    auto total_nsent = TRY(do_copy_through_kernel_buffer(*in_description, offset, count, "sendfile"sv, [&](auto& data, size_t, size_t size) -> ErrorOr<size_t> {
+        return do_write(*out_description, data, size);
+    }));
+
+    offset += total_nsent;
+    if (user_offset)
+        TRY(copy_to_user(user_offset, &offset));
+    else
+        TRY(in_description->seek(offset, SEEK_SET));
+    return total_nsent;
+}
+
+}
@@ -68,6 +68,7 @@ ErrorOr<FlatPtr> Process::sys$create_thread(void* (*entry)(void*), Userspace<con
 
     SpinlockLocker lock(g_scheduler_lock);
     thread->set_priority(requested_thread_priority);
+    Scheduler::set_thread_scheduling_policy(*thread, Thread::current()->scheduling_policy(), Thread::current()->realtime_priority());
     thread->set_state(Thread::State::Runnable);
     return thread->tid().value();
 }
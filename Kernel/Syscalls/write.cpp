@@ -11,6 +11,10 @@
 
 namespace Kernel {
 
+// Vectored writes up to this size are gathered into a single bounce buffer first,
+// so the file sees one write (and e.g. a socket sends a single packet) for all iovecs.
+static constexpr size_t writev_bounce_buffer_limit = 64 * KiB;
+
 ErrorOr<FlatPtr> Process::sys$writev(int fd, Userspace<const struct iovec*> iov, int iov_count)
 {
     VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this)
@@ -35,6 +39,22 @@ ErrorOr<FlatPtr> Process::sys$writev(int fd, Userspace<const struct iovec*> iov,
     auto description = TRY(open_file_description(fd));
     if (!description->is_writable())
         return EBADF;
+    if (total_length == 0)
+        return 0;
+
+    if (vecs.size() > 1 && total_length <= writev_bounce_buffer_limit) {
+        auto bounce_buffer = TRY(ByteBuffer::create_uninitialized(total_length));
+        size_t ngathered = 0;
+        for (auto& vec : vecs) {
+            if (vec.iov_len == 0)
+                continue;
+            auto buffer = TRY(UserOrKernelBuffer::for_user_buffer((u8*)vec.iov_base, vec.iov_len));
+            TRY(buffer.read(bounce_buffer.data() + ngathered, vec.iov_len));
+            ngathered += vec.iov_len;
+        }
+        auto kernel_buffer = UserOrKernelBuffer::for_kernel_buffer(bounce_buffer.data());
+        return do_write(*description, kernel_buffer, total_length);
+    }
 
     int nwritten = 0;
     for (auto& vec : vecs) {
@@ -21,7 +21,7 @@ ErrorOr<NonnullRefPtr<MasterPTY>> MasterPTY::try_create(unsigned int index)
     auto pts_name = TRY(KString::formatted("/dev/pts/{}", index));
     auto tty_name = TRY(pts_name->try_clone());
 
-    auto buffer = TRY(DoubleBuffer::try_create());
+    auto buffer = TRY(ByteRingBuffer::try_create());
     auto master_pty = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) MasterPTY(index, move(buffer), move(pts_name))));
     auto slave_pty = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) SlavePTY(*master_pty, index, move(tty_name))));
     master_pty->m_slave = slave_pty;
@@ -30,7 +30,7 @@ ErrorOr<NonnullRefPtr<MasterPTY>> MasterPTY::try_create(unsigned int index)
     return master_pty;
 }
 
-MasterPTY::MasterPTY(unsigned index, NonnullOwnPtr<DoubleBuffer> buffer, NonnullOwnPtr<KString> pts_name)
+MasterPTY::MasterPTY(unsigned index, NonnullOwnPtr<ByteRingBuffer> buffer, NonnullOwnPtr<KString> pts_name)
     : CharacterDevice(200, index)
     , m_index(index)
     , m_buffer(move(buffer))
@@ -7,8 +7,8 @@
 #pragma once
 
 #include <AK/Badge.h>
+#include <Kernel/ByteRingBuffer.h>
 #include <Kernel/Devices/CharacterDevice.h>
-#include <Kernel/DoubleBuffer.h>
 
 namespace Kernel {
 
@@ -29,7 +29,7 @@ public:
     virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(const OpenFileDescription&) const override;
 
 private:
-    explicit MasterPTY(unsigned index, NonnullOwnPtr<DoubleBuffer> buffer, NonnullOwnPtr<KString> pts_name);
+    explicit MasterPTY(unsigned index, NonnullOwnPtr<ByteRingBuffer> buffer, NonnullOwnPtr<KString> pts_name);
     // ^CharacterDevice
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
     virtual ErrorOr<size_t> write(OpenFileDescription&, u64, const UserOrKernelBuffer&, size_t) override;
@@ -43,7 +43,7 @@ private:
     RefPtr<SlavePTY> m_slave;
     unsigned m_index;
     bool m_closed { false };
-    NonnullOwnPtr<DoubleBuffer> m_buffer;
+    NonnullOwnPtr<ByteRingBuffer> m_buffer;
     NonnullOwnPtr<KString> m_pts_name;
 };
 
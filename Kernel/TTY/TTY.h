@@ -8,8 +8,8 @@
 
 #include <AK/CircularDeque.h>
 #include <AK/WeakPtr.h>
+#include <Kernel/ByteRingBuffer.h>
 #include <Kernel/Devices/CharacterDevice.h>
-#include <Kernel/DoubleBuffer.h>
 #include <Kernel/ProcessGroup.h>
 #include <Kernel/UnixTypes.h>
 
@@ -0,0 +1,38 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PageReclaimTask.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// Cap the work done per pass so we keep rechecking the watermarks while memory is being freed elsewhere.
+static constexpr size_t max_pages_reclaimed_per_pass = 1024;
+
+UNMAP_AFTER_INIT void PageReclaimTask::spawn()
+{
+    RefPtr<Thread> reclaim_thread;
+    (void)Process::create_kernel_process(reclaim_thread, KString::must_create("PageReclaimTask"), [] {
+        Thread::current()->set_priority(THREAD_PRIORITY_LOW);
+        for (;;) {
+            auto deficit = MM.page_reclaim_deficit();
+            if (deficit == 0) {
+                (void)Thread::current()->sleep(Time::from_milliseconds(250));
+                continue;
+            }
+            // The first pass over recently used pages only clears their accessed bits, so an empty
+            // pass is worth retrying right away. If that doesn't help either, there's nothing to take.
+            if (MM.reclaim_clean_inode_pages(min(deficit, max_pages_reclaimed_per_pass)) == 0
+                && MM.reclaim_clean_inode_pages(min(deficit, max_pages_reclaimed_per_pass)) == 0)
+                (void)Thread::current()->sleep(Time::from_seconds(1));
+        }
+    });
+}
+
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// Zero pages in small batches, so we yield to anything else that wants to run in between.
+static constexpr size_t pages_zeroed_per_batch = 32;
+
+UNMAP_AFTER_INIT void PageZeroingTask::spawn()
+{
+    RefPtr<Thread> zeroing_thread;
+    (void)Process::create_kernel_process(zeroing_thread, KString::must_create("PageZeroingTask"), [] {
+        Thread::current()->set_priority(THREAD_PRIORITY_MIN);
+        for (;;) {
+            if (MM.refill_zeroed_page_pool(pages_zeroed_per_batch) == pages_zeroed_per_batch) {
+                Scheduler::yield();
+                continue;
+            }
+            // The pool is full, or there's no memory to spare right now.
+            (void)Thread::current()->sleep(Time::from_milliseconds(100));
+        }
+    });
+}
+
+}
@@ -19,7 +19,9 @@ UNMAP_AFTER_INIT void SyncTask::spawn()
         dbgln("SyncTask is running");
         for (;;) {
             VirtualFileSystem::sync();
-            (void)Thread::current()->sleep(Time::from_seconds(1));
+            // NOTE: File data doesn't wait for this, the WritebackTask writes it out as it ages.
+            //       This mostly gets the file systems to put their metadata into the disk cache.
+            (void)Thread::current()->sleep(Time::from_seconds(5));
         }
     });
 }
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/FileSystem.h>
+#include <Kernel/Process.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/WritebackTask.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+static WaitQueue* s_writeback_wait_queue;
+
+UNMAP_AFTER_INIT void WritebackTask::spawn()
+{
+    s_writeback_wait_queue = new WaitQueue;
+    RefPtr<Thread> writeback_thread;
+    (void)Process::create_kernel_process(writeback_thread, KString::must_create("WritebackTask"), [] {
+        for (;;) {
+            FileSystem::write_back_all();
+            // Wake up often enough that nothing stays dirty for much longer than the expiry time.
+            auto timeout_time = Time::from_milliseconds(250);
+            auto timeout = Thread::BlockTimeout { false, &timeout_time };
+            [[maybe_unused]] auto result = s_writeback_wait_queue->wait_on(timeout, "WritebackTask");
+        }
+    });
+}
+
+void WritebackTask::wake()
+{
+    if (s_writeback_wait_queue)
+        s_writeback_wait_queue->wake_one();
+}
+
+}
@@ -56,6 +56,10 @@ struct ThreadSpecificData {
 #define THREAD_PRIORITY_HIGH 50
 #define THREAD_PRIORITY_MAX 99
 
+// Priorities of the SCHED_FIFO and SCHED_RR policies, real-time threads always run before all others.
+#define THREAD_REALTIME_PRIORITY_MIN 1
+#define THREAD_REALTIME_PRIORITY_MAX 99
+
 #define THREAD_AFFINITY_DEFAULT 0xffffffff
 
 struct ThreadRegisters {
@@ -145,6 +149,7 @@ class Thread
     friend class Process;
     friend class Scheduler;
     friend struct ThreadReadyQueue;
+    friend struct ThreadReadyQueues;
 
 public:
     inline static Thread* current()
@@ -164,6 +169,14 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    int scheduling_policy() const { return m_scheduling_policy; }
+    u32 realtime_priority() const { return m_realtime_priority; }
+    u32 inherited_realtime_priority() const { return m_inherited_realtime_priority; }
+    // The real-time priority the thread is scheduled with, including the one lent to it by higher priority
+    // threads waiting on a lock it holds (priority inheritance). 0 for threads that aren't real-time.
+    u32 effective_realtime_priority() const { return max(m_realtime_priority, m_inherited_realtime_priority); }
+    bool is_realtime() const { return effective_realtime_priority() != 0; }
+
     void detach()
     {
         SpinlockLocker lock(m_lock);
@@ -1027,8 +1040,8 @@ public:
     static constexpr u32 default_kernel_stack_size = 65536;
     static constexpr u32 default_userspace_stack_size = 1 * MiB;
 
-    u64 time_in_user() const { return m_total_time_scheduled_user; }
-    u64 time_in_kernel() const { return m_total_time_scheduled_kernel; }
+    u64 time_in_user() const { return m_total_time_scheduled_user.load(AK::MemoryOrder::memory_order_relaxed); }
+    u64 time_in_kernel() const { return m_total_time_scheduled_kernel.load(AK::MemoryOrder::memory_order_relaxed); }
 
     enum class PreviousMode : u8 {
         KernelMode = 0,
@@ -1128,6 +1141,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_ready_queue_processor { 0 };
 
     friend class WaitQueue;
 
@@ -1203,8 +1217,9 @@ private:
     Atomic<u32> m_cpu { 0 };
     u32 m_cpu_affinity { THREAD_AFFINITY_DEFAULT };
     Optional<u64> m_last_time_scheduled;
-    u64 m_total_time_scheduled_user { 0 };
-    u64 m_total_time_scheduled_kernel { 0 };
+    // NOTE: Only the processor running the thread adds to these, readers don't need to take any lock.
+    Atomic<u64> m_total_time_scheduled_user { 0 };
+    Atomic<u64> m_total_time_scheduled_kernel { 0 };
     u32 m_ticks_left { 0 };
     u32 m_times_scheduled { 0 };
     u32 m_ticks_in_user { 0 };
@@ -1263,6 +1278,9 @@ private:
     State m_state { Thread::State::Invalid };
     NonnullOwnPtr<KString> m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    int m_scheduling_policy { SCHED_OTHER };
+    u32 m_realtime_priority { 0 };
+    u32 m_inherited_realtime_priority { 0 };
 
     State m_stop_state { Thread::State::Invalid };
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Singleton.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Time.h>
@@ -159,6 +160,11 @@ UNMAP_AFTER_INIT void TimeManagement::initialize(u32 cpu)
             apic_timer->enable_local_timer();
         }
     }
+
+    if (s_the->m_time_page_tsc_enabled) {
+        // Clear CR4.TSD, so that userspace can read the TSC on this processor.
+        write_cr4(read_cr4() & ~0x4);
+    }
 }
 
 void TimeManagement::set_system_timer(HardwareTimerBase& timer)
@@ -184,6 +190,7 @@ UNMAP_AFTER_INIT TimeManagement::TimeManagement()
     : m_time_page_region(MM.allocate_kernel_region(PAGE_SIZE, "Time page"sv, Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow).release_value_but_fixme_should_propagate_errors())
 {
     bool probe_non_legacy_hardware_timers = !(kernel_command_line().is_legacy_time_enabled());
+    m_profile_timer_frequency = kernel_command_line().profile_timer_frequency().value_or(OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE);
     if (ACPI::is_enabled()) {
         if (!ACPI::Parser::the()->x86_specific_flags().cmos_rtc_not_present) {
             RTC::initialize();
@@ -203,6 +210,16 @@ UNMAP_AFTER_INIT TimeManagement::TimeManagement()
     } else if (!probe_and_set_legacy_hardware_timers()) {
         VERIFY_NOT_REACHED();
     }
+
+    if (kernel_command_line().is_userspace_tsc_enabled()) {
+        auto& processor = Processor::current();
+        if (processor.has_feature(CPUFeature::CONSTANT_TSC) && processor.has_feature(CPUFeature::NONSTOP_TSC)) {
+            dmesgln("Time: Allowing userspace to read the TSC");
+            m_time_page_tsc_enabled = true;
+        } else {
+            dmesgln("Time: Not allowing userspace to read the TSC, it doesn't run at a constant rate");
+        }
+    }
 }
 
 Time TimeManagement::now()
@@ -420,7 +437,7 @@ bool TimeManagement::enable_profile_timer()
     if (!m_profile_timer)
         return false;
     if (m_profile_enable_count.fetch_add(1) == 0)
-        return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE));
+        return m_profile_timer->try_to_set_frequency(m_profile_timer->calculate_nearest_possible_frequency(m_profile_timer_frequency));
     return true;
 }
 
@@ -439,9 +456,48 @@ void TimeManagement::update_time_page()
     u32 update_iteration = AK::atomic_fetch_add(&page.update2, 1u, AK::MemoryOrder::memory_order_acquire);
     page.clocks[CLOCK_REALTIME_COARSE] = m_epoch_time;
     page.clocks[CLOCK_MONOTONIC_COARSE] = monotonic_time(TimePrecision::Coarse).to_timespec();
+    if (m_time_page_tsc_enabled)
+        calibrate_time_page_tsc(page);
     AK::atomic_store(&page.update1, update_iteration + 1u, AK::MemoryOrder::memory_order_release);
 }
 
+void TimeManagement::calibrate_time_page_tsc(TimePage& page)
+{
+    static constexpr i64 calibration_nanoseconds = 2'000'000'000;
+
+    auto tsc = read_tsc();
+    auto now = monotonic_time(TimePrecision::Precise);
+
+    if (m_tsc_calibration_start_time.is_zero()) {
+        m_tsc_calibration_start = tsc;
+        m_tsc_calibration_start_time = now;
+    } else if (!m_time_page_tsc_calibrated) {
+        auto elapsed_nanoseconds = static_cast<u64>((now - m_tsc_calibration_start_time).to_nanoseconds());
+        auto elapsed_tsc = tsc - m_tsc_calibration_start;
+        if (elapsed_nanoseconds >= calibration_nanoseconds && elapsed_tsc != 0) {
+            // Pick the largest shift that keeps the multiplier within 32 bits for a precise conversion.
+            u32 shift = min(32, count_leading_zeroes(elapsed_nanoseconds));
+            u64 multiplier = (elapsed_nanoseconds << shift) / elapsed_tsc;
+            while (multiplier > NumericLimits<u32>::max()) {
+                --shift;
+                multiplier >>= 1;
+            }
+            if (multiplier != 0) {
+                page.tsc_multiplier = multiplier;
+                page.tsc_shift = shift;
+            }
+            m_time_page_tsc_calibrated = true;
+        }
+    }
+
+    // NOTE: The coarse clocks move by (about) the time between two updates, so userspace isn't
+    //       allowed to extrapolate for quite that long. That keeps the clocks monotonic at updates.
+    auto time_since_last_update = static_cast<u64>((now - m_last_time_page_update_time).to_nanoseconds());
+    m_last_time_page_update_time = now;
+    page.max_extrapolation_ns = min<u64>(time_since_last_update - time_since_last_update / 100, NumericLimits<u32>::max());
+    page.tsc_at_update = tsc;
+}
+
 TimePage& TimeManagement::time_page()
 {
     return *static_cast<TimePage*>((void*)m_time_page_region->vaddr().as_ptr());
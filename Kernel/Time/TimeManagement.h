@@ -60,6 +60,7 @@ public:
 
     bool enable_profile_timer();
     bool disable_profile_timer();
+    u32 profile_timer_frequency() const { return m_profile_timer_frequency; }
 
     u64 uptime_ms() const;
     static Time now();
@@ -78,6 +79,7 @@ public:
 private:
     TimePage& time_page();
     void update_time_page();
+    void calibrate_time_page_tsc(TimePage&);
 
     bool probe_and_set_legacy_hardware_timers();
     bool probe_and_set_non_legacy_hardware_timers();
@@ -107,8 +109,17 @@ private:
 
     Atomic<u32> m_profile_enable_count { 0 };
     RefPtr<HardwareTimerBase> m_profile_timer;
+    u32 m_profile_timer_frequency { OPTIMAL_PROFILE_TICKS_PER_SECOND_RATE };
 
     NonnullOwnPtr<Memory::Region> m_time_page_region;
+
+    // NOTE: The TSC is only handed out through the time page once it has been measured against
+    //       the monotonic clock for a while, these are only accessed by the BSP in update_time_page().
+    bool m_time_page_tsc_enabled { false };
+    bool m_time_page_tsc_calibrated { false };
+    u64 m_tsc_calibration_start { 0 };
+    Time m_tsc_calibration_start_time;
+    Time m_last_time_page_update_time;
 };
 
 }
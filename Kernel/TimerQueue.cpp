@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Scheduler.h>
@@ -53,6 +54,131 @@ TimerQueue& TimerQueue::the()
 UNMAP_AFTER_INIT TimerQueue::TimerQueue()
 {
     m_ticks_per_second = TimeManagement::the().ticks_per_second();
+    m_timer_queue_monotonic.current_tick = max<i64>(TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE).to_truncated_milliseconds(), 0);
+    m_timer_queue_realtime.current_tick = max<i64>(TimeManagement::the().current_time(CLOCK_REALTIME_COARSE).to_truncated_milliseconds(), 0);
+}
+
+u64 TimerQueue::tick_for_expiration(Time const& expires)
+{
+    // NOTE: This rounds up, so a timer's slot can only become due once the timer itself has expired.
+    return max<i64>(expires.to_milliseconds(), 0);
+}
+
+void TimerQueue::insert_into_wheel(Queue& queue, Timer& timer, u64 tick)
+{
+    VERIFY(g_timerqueue_lock.is_locked());
+
+    auto current_tick = queue.current_tick;
+    if (tick < current_tick)
+        tick = current_tick;
+
+    for (u8 level = 0; level < wheel_level_count; ++level) {
+        auto shift = level * wheel_slot_bits;
+        if ((tick >> shift) - (current_tick >> shift) >= wheel_slot_count)
+            continue;
+        u8 slot = (tick >> shift) & (wheel_slot_count - 1);
+        queue.slots[level][slot].append(timer);
+        queue.occupied_slots[level] |= 1ull << slot;
+        timer.m_wheel_level = level;
+        timer.m_wheel_slot = slot;
+        return;
+    }
+
+    queue.overflow.append(timer);
+    queue.overflow_first_tick = min(queue.overflow_first_tick, tick);
+    timer.m_wheel_level = overflow_level;
+}
+
+void TimerQueue::remove_from_wheel(Queue& queue, Timer& timer)
+{
+    VERIFY(g_timerqueue_lock.is_locked());
+    VERIFY(timer.m_wheel_level != not_in_wheel);
+
+    if (timer.m_wheel_level == overflow_level) {
+        // NOTE: overflow_first_tick is left as it is, that only makes the next look at the overflow list come early.
+        queue.overflow.remove(timer);
+    } else {
+        auto& slot = queue.slots[timer.m_wheel_level][timer.m_wheel_slot];
+        slot.remove(timer);
+        if (slot.is_empty())
+            queue.occupied_slots[timer.m_wheel_level] &= ~(1ull << timer.m_wheel_slot);
+    }
+    timer.m_wheel_level = not_in_wheel;
+}
+
+auto TimerQueue::first_due_slot(Queue const& queue, u64 now_tick) const -> Optional<DueSlot>
+{
+    Optional<DueSlot> first_due;
+    for (u8 level = 0; level < wheel_level_count; ++level) {
+        auto occupied = queue.occupied_slots[level];
+        if (occupied == 0)
+            continue;
+        // Every occupied slot lies less than a full turn of its level ahead of current_tick,
+        // so rotating the bitmap to start at the current slot gives the distance to the next one.
+        auto shift = level * wheel_slot_bits;
+        auto current_slot = (queue.current_tick >> shift) & (wheel_slot_count - 1);
+        if (current_slot != 0)
+            occupied = (occupied >> current_slot) | (occupied << (wheel_slot_count - current_slot));
+        auto slot_offset = count_trailing_zeroes(occupied);
+        u64 start_tick = ((queue.current_tick >> shift) + slot_offset) << shift;
+        if (start_tick > now_tick || (first_due.has_value() && first_due->start_tick <= start_tick))
+            continue;
+        first_due = DueSlot { level, static_cast<u8>((current_slot + slot_offset) & (wheel_slot_count - 1)), start_tick };
+    }
+
+    if (!queue.overflow.is_empty()) {
+        // The overflow list has to be looked at once its first timer fits onto the last level.
+        constexpr u64 overflow_range = (wheel_slot_count - 2) << ((wheel_level_count - 1) * wheel_slot_bits);
+        u64 start_tick = queue.overflow_first_tick > overflow_range ? queue.overflow_first_tick - overflow_range : 0;
+        if (start_tick <= now_tick && (!first_due.has_value() || first_due->start_tick > start_tick))
+            first_due = DueSlot { overflow_level, 0, start_tick };
+    }
+    return first_due;
+}
+
+void TimerQueue::requeue_overflow(Queue& queue)
+{
+    VERIFY(g_timerqueue_lock.is_locked());
+
+    Timer::List timers;
+    while (auto* timer = queue.overflow.first()) {
+        queue.overflow.remove(*timer);
+        timers.append(*timer);
+    }
+    queue.overflow_first_tick = NumericLimits<u64>::max();
+    while (auto* timer = timers.first()) {
+        timers.remove(*timer);
+        insert_into_wheel(queue, *timer, tick_for_expiration(timer->m_expires));
+    }
+}
+
+void TimerQueue::rebuild_wheel(Queue& queue, u64 now_tick)
+{
+    VERIFY(g_timerqueue_lock.is_locked());
+
+    // The clock went backwards, so the slots no longer line up with current_tick.
+    // This only ever happens to the realtime queue and is rare enough to just start over.
+    Timer::List timers;
+    for (u8 level = 0; level < wheel_level_count; ++level) {
+        for (auto& slot : queue.slots[level]) {
+            while (auto* timer = slot.first()) {
+                slot.remove(*timer);
+                timers.append(*timer);
+            }
+        }
+        queue.occupied_slots[level] = 0;
+    }
+    while (auto* timer = queue.overflow.first()) {
+        queue.overflow.remove(*timer);
+        timers.append(*timer);
+    }
+    queue.overflow_first_tick = NumericLimits<u64>::max();
+
+    queue.current_tick = now_tick;
+    while (auto* timer = timers.first()) {
+        timers.remove(*timer);
+        insert_into_wheel(queue, *timer, tick_for_expiration(timer->m_expires));
+    }
 }
 
 bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t clock_id, const Time& deadline, Function<void()>&& callback)
@@ -86,33 +212,13 @@ TimerId TimerQueue::add_timer(NonnullRefPtr<Timer>&& timer)
 
 void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
 {
-    Time timer_expiration = timer->m_expires;
-
     timer->clear_cancelled();
     timer->clear_callback_finished();
     timer->set_in_use();
 
     auto& queue = queue_for_timer(*timer);
-    if (queue.list.is_empty()) {
-        queue.list.append(timer.leak_ref());
-        queue.next_timer_due = timer_expiration;
-    } else {
-        Timer* following_timer = nullptr;
-        for (auto& t : queue.list) {
-            if (t.m_expires > timer_expiration) {
-                following_timer = &t;
-                break;
-            }
-        }
-        if (following_timer) {
-            bool next_timer_needs_update = queue.list.first() == following_timer;
-            queue.list.insert_before(*following_timer, timer.leak_ref());
-            if (next_timer_needs_update)
-                queue.next_timer_due = timer_expiration;
-        } else {
-            queue.list.append(timer.leak_ref());
-        }
-    }
+    auto tick = tick_for_expiration(timer->m_expires);
+    insert_into_wheel(queue, timer.leak_ref(), tick);
 }
 
 bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
@@ -133,7 +239,7 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
         timer.clear_in_use();
 
         SpinlockLocker lock(g_timerqueue_lock);
-        if (timer_queue.list.contains(timer)) {
+        if (timer.m_wheel_level != not_in_wheel) {
             // The timer has not fired, remove it
             VERIFY(timer.ref_count() > 1);
             remove_timer_locked(timer_queue, timer);
@@ -160,14 +266,11 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
 
 void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
 {
-    bool was_next_timer = (queue.list.first() == &timer);
-    queue.list.remove(timer);
+    remove_from_wheel(queue, timer);
     auto now = timer.now(false);
     if (timer.m_expires > now)
         timer.m_remaining = timer.m_expires - now;
 
-    if (was_next_timer)
-        update_next_timer_due(queue);
     // Whenever we remove a timer that was still queued (but hasn't been
     // fired) we added a reference to it. So, when removing it from the
     // queue we need to drop that reference.
@@ -178,17 +281,34 @@ void TimerQueue::fire()
 {
     SpinlockLocker lock(g_timerqueue_lock);
 
-    auto fire_timers = [&](Queue& queue) {
-        auto* timer = queue.list.first();
-        VERIFY(timer);
-        VERIFY(queue.next_timer_due == timer->m_expires);
+    auto fire_timers = [&](Queue& queue, clockid_t clock_id) {
+        u64 now_tick = max<i64>(TimeManagement::the().current_time(clock_id).to_truncated_milliseconds(), 0);
+        if (now_tick < queue.current_tick)
+            rebuild_wheel(queue, now_tick);
 
-        while (timer && timer->now(true) > timer->m_expires) {
-            queue.list.remove(*timer);
+        for (;;) {
+            auto due_slot = first_due_slot(queue, now_tick);
+            if (!due_slot.has_value())
+                break;
+            queue.current_tick = max(queue.current_tick, due_slot->start_tick);
 
-            m_timers_executing.append(*timer);
+            if (due_slot->level == overflow_level) {
+                requeue_overflow(queue);
+                continue;
+            }
+
+            auto* timer = queue.slots[due_slot->level][due_slot->slot].first();
+            VERIFY(timer);
+            remove_from_wheel(queue, *timer);
 
-            update_next_timer_due(queue);
+            if (!(timer->now(true) > timer->m_expires)) {
+                // Either the timer only comes due in a later slot of a lower level,
+                // or it expires later within this very millisecond.
+                insert_into_wheel(queue, *timer, max(tick_for_expiration(timer->m_expires), now_tick + 1));
+                continue;
+            }
+
+            m_timers_executing.append(*timer);
 
             lock.unlock();
 
@@ -209,24 +329,13 @@ void TimerQueue::fire()
             });
 
             lock.lock();
-            timer = queue.list.first();
         }
-    };
-
-    if (!m_timer_queue_monotonic.list.is_empty())
-        fire_timers(m_timer_queue_monotonic);
-    if (!m_timer_queue_realtime.list.is_empty())
-        fire_timers(m_timer_queue_realtime);
-}
 
-void TimerQueue::update_next_timer_due(Queue& queue)
-{
-    VERIFY(g_timerqueue_lock.is_locked());
+        queue.current_tick = max(queue.current_tick, now_tick);
+    };
 
-    if (auto* next_timer = queue.list.first())
-        queue.next_timer_due = next_timer->m_expires;
-    else
-        queue.next_timer_due = {};
+    fire_timers(m_timer_queue_monotonic, CLOCK_MONOTONIC_COARSE);
+    fire_timers(m_timer_queue_realtime, CLOCK_REALTIME_COARSE);
 }
 
 }
@@ -9,6 +9,7 @@
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Time.h>
@@ -47,14 +48,10 @@ private:
     Atomic<bool> m_callback_finished { false };
     Atomic<bool> m_in_use { false };
 
-    bool operator<(const Timer& rhs) const
-    {
-        return m_expires < rhs.m_expires;
-    }
-    bool operator>(const Timer& rhs) const
-    {
-        return m_expires > rhs.m_expires;
-    }
+    // NOTE: Where the timer sits in its queue's wheel, only valid while it is pending.
+    u8 m_wheel_level { 0 };
+    u8 m_wheel_slot { 0 };
+
     bool operator==(const Timer& rhs) const
     {
         return m_id == rhs.m_id;
@@ -93,12 +90,36 @@ public:
     void fire();
 
 private:
+    static constexpr size_t wheel_level_count = 6;
+    static constexpr size_t wheel_slot_bits = 6;
+    static constexpr size_t wheel_slot_count = 1 << wheel_slot_bits;
+    static constexpr u8 overflow_level = wheel_level_count;
+    static constexpr u8 not_in_wheel = 0xff;
+
+    // Pending timers are kept in a hierarchical timer wheel with a granularity of a millisecond.
+    // A slot on level N spans 64^N milliseconds, so the six levels reach about two years ahead
+    // of current_tick. Timers further out wait in the overflow list until they come in range.
+    // Adding and cancelling a timer is O(1), a timer moves down a level whenever its slot is due.
     struct Queue {
-        Timer::List list;
-        Time next_timer_due {};
+        Timer::List slots[wheel_level_count][wheel_slot_count];
+        u64 occupied_slots[wheel_level_count] {};
+        Timer::List overflow;
+        u64 overflow_first_tick { NumericLimits<u64>::max() };
+        u64 current_tick { 0 };
+    };
+    struct DueSlot {
+        u8 level;
+        u8 slot;
+        u64 start_tick;
     };
+
+    static u64 tick_for_expiration(Time const&);
+    void insert_into_wheel(Queue&, Timer&, u64 tick);
+    void remove_from_wheel(Queue&, Timer&);
+    Optional<DueSlot> first_due_slot(Queue const&, u64 now_tick) const;
+    void requeue_overflow(Queue&);
+    void rebuild_wheel(Queue&, u64 now_tick);
     void remove_timer_locked(Queue&, Timer&);
-    void update_next_timer_due(Queue&);
     void add_timer_locked(NonnullRefPtr<Timer>);
 
     Queue& queue_for_timer(Timer& timer)
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/PerformanceManager.h>
+#include <Kernel/Tracepoint.h>
+
+namespace Kernel {
+
+Atomic<bool, AK::MemoryOrder::memory_order_relaxed> g_tracepoint_enabled[tracepoint_count];
+
+static constexpr TracepointInfo s_tracepoint_infos[] = {
+#define __ENUMERATE_TRACEPOINT(subsystem, name) { #subsystem ""sv, #name ""sv },
+    ENUMERATE_TRACEPOINTS(__ENUMERATE_TRACEPOINT)
+#undef __ENUMERATE_TRACEPOINT
+};
+
+// NOTE: Each processor only ever bumps its own counters, so they get a cache line of their own.
+struct alignas(64) ProcessorTracepointCounters {
+    u64 hits[tracepoint_count];
+};
+
+static ProcessorTracepointCounters s_counters[ProcessorContainer {}.size()];
+
+TracepointInfo const& Tracepoints::info(TracepointID id)
+{
+    VERIFY(to_underlying(id) < tracepoint_count);
+    return s_tracepoint_infos[to_underlying(id)];
+}
+
+Optional<TracepointID> Tracepoints::find(StringView subsystem, StringView name)
+{
+    for (size_t i = 0; i < tracepoint_count; ++i) {
+        if (s_tracepoint_infos[i].subsystem == subsystem && s_tracepoint_infos[i].name == name)
+            return static_cast<TracepointID>(i);
+    }
+    return {};
+}
+
+void Tracepoints::hit(TracepointID id, FlatPtr arg1, FlatPtr arg2)
+{
+    // NOTE: We might be moved to another processor after reading the id, so this has to be atomic all the same.
+    AK::atomic_fetch_add(&s_counters[Processor::current_id()].hits[to_underlying(id)], static_cast<u64>(1), AK::MemoryOrder::memory_order_relaxed);
+
+    if (auto* current_thread = Thread::current())
+        PerformanceManager::add_tracepoint_event(*current_thread, to_underlying(id), arg1, arg2);
+}
+
+u64 Tracepoints::hit_count(TracepointID id, u32 cpu)
+{
+    return AK::atomic_load(&s_counters[cpu].hits[to_underlying(id)], AK::MemoryOrder::memory_order_relaxed);
+}
+
+}
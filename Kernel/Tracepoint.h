@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Every static tracepoint in the kernel, as (subsystem, name).
+#define ENUMERATE_TRACEPOINTS(T) \
+    T(scheduler, context_switch) \
+    T(memory, page_fault)        \
+    T(block_io, request)         \
+    T(tcp, receive)              \
+    T(tcp, retransmit)
+
+enum class TracepointID : u32 {
+#define __ENUMERATE_TRACEPOINT(subsystem, name) subsystem##_##name,
+    ENUMERATE_TRACEPOINTS(__ENUMERATE_TRACEPOINT)
+#undef __ENUMERATE_TRACEPOINT
+        __Count
+};
+
+static constexpr size_t tracepoint_count = to_underlying(TracepointID::__Count);
+
+struct TracepointInfo {
+    StringView subsystem;
+    StringView name;
+};
+
+extern Atomic<bool, AK::MemoryOrder::memory_order_relaxed> g_tracepoint_enabled[tracepoint_count];
+
+class Tracepoints {
+public:
+    static TracepointInfo const& info(TracepointID);
+    static Optional<TracepointID> find(StringView subsystem, StringView name);
+
+    static bool is_enabled(TracepointID id) { return g_tracepoint_enabled[to_underlying(id)]; }
+    static void set_enabled(TracepointID id, bool enabled) { g_tracepoint_enabled[to_underlying(id)] = enabled; }
+
+    // Bumps the current processor's counter and, if the current process is being profiled
+    // with PERF_EVENT_TRACEPOINT, records the hit in its performance event buffer.
+    static void hit(TracepointID, FlatPtr arg1, FlatPtr arg2);
+
+    static u64 hit_count(TracepointID, u32 cpu);
+};
+
+// A disabled tracepoint costs a single predictable branch on a flag, the arguments aren't evaluated.
+#define TRACE(subsystem, name, arg1, arg2)                                                                           \
+    do {                                                                                                             \
+        if (::Kernel::Tracepoints::is_enabled(::Kernel::TracepointID::subsystem##_##name)) [[unlikely]]              \
+            ::Kernel::Tracepoints::hit(::Kernel::TracepointID::subsystem##_##name, (FlatPtr)(arg1), (FlatPtr)(arg2)); \
+    } while (0)
+
+}
@@ -28,6 +28,7 @@
 #include <Kernel/Devices/ZeroDevice.h>
 #include <Kernel/FileSystem/Ext2FileSystem.h>
 #include <Kernel/FileSystem/SysFS.h>
+#include <Kernel/FileSystem/SysFSKernel.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/Firmware/ACPI/Initialize.h>
 #include <Kernel/Firmware/ACPI/Parser.h>
@@ -57,7 +58,10 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/PageReclaimTask.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
 #include <Kernel/Tasks/SyncTask.h>
+#include <Kernel/Tasks/WritebackTask.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/WorkQueue.h>
 #include <Kernel/kstdio.h>
@@ -221,6 +225,7 @@ extern "C" [[noreturn]] UNMAP_AFTER_INIT void init(BootInfo const& boot_info)
 
     InterruptManagement::initialize();
     ACPI::initialize();
+    MM.initialize_numa_nodes();
 
     // Initialize TimeManagement before using randomness!
     TimeManagement::initialize(0);
@@ -321,7 +326,10 @@ void init_stage2(void*)
     ConsoleManagement::the().initialize();
 
     SyncTask::spawn();
+    WritebackTask::spawn();
     FinalizerTask::spawn();
+    PageReclaimTask::spawn();
+    PageZeroingTask::spawn();
 
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
 
@@ -329,6 +337,7 @@ void init_stage2(void*)
         USB::USBManagement::initialize();
     }
     FirmwareSysFSDirectory::initialize();
+    KernelSysFSDirectory::initialize();
 
     if (!PCI::Access::is_disabled()) {
         VirtIO::detect();
@@ -8,4 +8,5 @@ serenity_option(ENABLE_ADDRESS_SANITIZER OFF CACHE BOOL "Enable address sanitize
 serenity_option(ENABLE_MEMORY_SANITIZER OFF CACHE BOOL "Enable memory sanitizer testing in gcc/clang")
 serenity_option(ENABLE_FUZZER_SANITIZER OFF CACHE BOOL "Enable fuzzer sanitizer testing in clang")
 serenity_option(BUILD_LAGOM OFF CACHE BOOL "Build parts of the system targeting the host OS for fuzzing/testing")
+serenity_option(BUILD_LAGOM_FUZZER_BENCHMARKS OFF CACHE BOOL "Build benchmarks that replay fuzz corpora through the fuzzers (requires BUILD_LAGOM)")
 serenity_option(ENABLE_LAGOM_CCACHE ON CACHE BOOL "Enable ccache for Lagom builds")
@@ -14,7 +14,8 @@ extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
     if (!zip_file.has_value())
         return 0;
 
-    zip_file->for_each_member([](auto&) {
+    zip_file->for_each_member([](auto& member) {
+        (void)member.decompress([](ReadonlyBytes) -> ErrorOr<void> { return {}; });
         return IterationDecision::Continue;
     });
 
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+// This is linked together with a fuzzer into a Benchmark* executable (see CMakeLists.txt). Instead of fuzzing, it replays
+// a corpus through the fuzzer's entry point and reports how fast that went, and how much it allocated along the way.
+
+#include <AK/Atomic.h>
+#include <AK/JsonObject.h>
+#include <AK/NumberFormat.h>
+#include <AK/QuickSort.h>
+#include <AK/Statistics.h>
+#include <AK/Time.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibMain/Main.h>
+#include <new>
+#include <stdlib.h>
+
+extern "C" int LLVMFuzzerTestOneInput(u8 const* data, size_t size);
+
+// Every allocation made through operator new is counted, which covers all of our containers and smart pointers.
+// Some parsers run code on other threads, hence the atomics.
+static Atomic<u64, AK::memory_order_relaxed> s_allocation_count;
+static Atomic<u64, AK::memory_order_relaxed> s_allocated_bytes;
+
+static void* counted_malloc(size_t size)
+{
+    s_allocation_count++;
+    s_allocated_bytes += size;
+    return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(size_t size)
+{
+    auto* ptr = counted_malloc(size);
+    VERIFY(ptr);
+    return ptr;
+}
+
+void* operator new[](size_t size)
+{
+    auto* ptr = counted_malloc(size);
+    VERIFY(ptr);
+    return ptr;
+}
+
+void* operator new(size_t size, std::nothrow_t const&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new[](size_t size, std::nothrow_t const&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+static ErrorOr<void> collect_inputs(String const& path, Vector<String>& input_paths)
+{
+    if (!Core::File::is_directory(path)) {
+        input_paths.append(path);
+        return {};
+    }
+
+    Core::DirIterator iterator(path, Core::DirIterator::SkipDots);
+    if (iterator.has_error())
+        return Error::from_errno(iterator.error());
+    while (iterator.has_next()) {
+        auto entry = iterator.next_full_path();
+        if (Core::File::is_directory(entry))
+            TRY(collect_inputs(entry, input_paths));
+        else
+            input_paths.append(entry);
+    }
+    return {};
+}
+
+static u64 run_all_inputs_once(Vector<ByteBuffer> const& inputs)
+{
+    auto start_time = Time::now_monotonic();
+    for (auto const& input : inputs)
+        (void)LLVMFuzzerTestOneInput(input.data(), input.size());
+    return static_cast<u64>((Time::now_monotonic() - start_time).to_microseconds());
+}
+
+static double to_ms(double microseconds)
+{
+    return microseconds / 1000.0;
+}
+
+static double change_in_percent(double before, double after)
+{
+    return before > 0 ? (after - before) / before * 100.0 : 0.0;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> paths;
+    int iterations = 10;
+    int warmup_iterations = 1;
+    String output_path;
+    String baseline_path;
+    double threshold_percent = 5.0;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Replay a fuzz corpus through " FUZZER_NAME " and report its throughput and allocations.");
+    args_parser.add_option(iterations, "Number of measured passes over the corpus (default: 10)", "iterations", 'n', "count");
+    args_parser.add_option(warmup_iterations, "Number of unmeasured passes before measuring (default: 1)", "warmup", 'w', "count");
+    args_parser.add_option(output_path, "Add the results to this JSON file, for use as a later baseline", "output", 'o', "path");
+    args_parser.add_option(baseline_path, "Compare the results against this JSON file", "baseline", 'c', "path");
+    args_parser.add_option(threshold_percent, "Change in percent of the median time or of the allocations that counts as a regression (default: 5)", "threshold", 't', "percent");
+    args_parser.add_positional_argument(paths, "Corpus files, or directories containing them", "paths");
+    args_parser.parse(arguments);
+
+    if (iterations <= 0) {
+        warnln("Need at least one measured iteration");
+        return 1;
+    }
+
+    Vector<String> input_paths;
+    for (auto& path : paths)
+        TRY(collect_inputs(path, input_paths));
+    quick_sort(input_paths);
+
+    // Everything is read up front, so that the measured passes don't include any I/O.
+    Vector<ByteBuffer> inputs;
+    u64 total_size = 0;
+    for (auto& input_path : input_paths) {
+        auto file = TRY(Core::File::open(input_path, Core::OpenMode::ReadOnly));
+        auto input = file->read_all();
+        total_size += input.size();
+        inputs.append(move(input));
+    }
+    if (inputs.is_empty()) {
+        warnln("No inputs found");
+        return 1;
+    }
+
+    for (int i = 0; i < warmup_iterations; ++i)
+        (void)run_all_inputs_once(inputs);
+
+    // The parsers are deterministic, so one pass is enough to count the allocations.
+    auto allocation_count_before = s_allocation_count.load();
+    auto allocated_bytes_before = s_allocated_bytes.load();
+    AK::Statistics<u64> pass_times_us;
+    pass_times_us.add(run_all_inputs_once(inputs));
+    u64 allocation_count = s_allocation_count.load() - allocation_count_before;
+    u64 allocated_bytes = s_allocated_bytes.load() - allocated_bytes_before;
+
+    for (int i = 1; i < iterations; ++i)
+        pass_times_us.add(run_all_inputs_once(inputs));
+
+    auto median_us = static_cast<double>(pass_times_us.median());
+    auto bytes_per_second = median_us > 0 ? static_cast<double>(total_size) / median_us * 1'000'000.0 : 0.0;
+    auto inputs_per_second = median_us > 0 ? static_cast<double>(inputs.size()) / median_us * 1'000'000.0 : 0.0;
+
+    outln("{}: {} inputs, {}", FUZZER_NAME, inputs.size(), human_readable_size(total_size));
+    outln("  time per pass (ms): min {:.2}, median {:.2}, mean {:.2}, stddev {:.2}", to_ms(pass_times_us.min()), to_ms(median_us), to_ms(pass_times_us.average()), to_ms(pass_times_us.standard_deviation()));
+    outln("  throughput: {}/s, {:.1} inputs/s", human_readable_size(static_cast<u64>(bytes_per_second)), inputs_per_second);
+    outln("  allocations: {:.1} per input, {} per pass", static_cast<double>(allocation_count) / inputs.size(), human_readable_size(allocated_bytes));
+
+    bool regressed = false;
+    if (!baseline_path.is_empty()) {
+        auto baseline_file = TRY(Core::File::open(baseline_path, Core::OpenMode::ReadOnly));
+        auto baseline_json = TRY(JsonValue::from_string(baseline_file->read_all()));
+        auto const* entry = baseline_json.is_object() ? baseline_json.as_object().get_ptr(FUZZER_NAME) : nullptr;
+        if (!entry || !entry->is_object()) {
+            outln("  no baseline for {} in {}", FUZZER_NAME, baseline_path);
+        } else {
+            auto const& baseline = entry->as_object();
+            if (baseline.get("inputs"sv).to_u64() != inputs.size() || baseline.get("bytes"sv).to_u64() != total_size)
+                warnln("  the baseline was taken with a different corpus, so this comparison is meaningless");
+
+            auto time_change = change_in_percent(baseline.get("median_us"sv).to_double(), median_us);
+            auto allocations_change = change_in_percent(baseline.get("allocations"sv).to_double(), static_cast<double>(allocation_count));
+            outln("  compared to baseline: time {:+.1}%, allocations {:+.1}%", time_change, allocations_change);
+            if (time_change > threshold_percent || allocations_change > threshold_percent) {
+                warnln("{} regressed by more than {}%", FUZZER_NAME, threshold_percent);
+                regressed = true;
+            }
+        }
+    }
+
+    if (!output_path.is_empty()) {
+        // The benchmarks of all the fuzzers can share one results file.
+        JsonObject output;
+        if (Core::File::exists(output_path)) {
+            auto existing_file = TRY(Core::File::open(output_path, Core::OpenMode::ReadOnly));
+            auto existing_json = TRY(JsonValue::from_string(existing_file->read_all()));
+            if (existing_json.is_object())
+                output = existing_json.as_object();
+        }
+
+        JsonObject entry;
+        entry.set("inputs", inputs.size());
+        entry.set("bytes", total_size);
+        entry.set("iterations", pass_times_us.size());
+        entry.set("min_us", pass_times_us.min());
+        entry.set("median_us", pass_times_us.median());
+        entry.set("bytes_per_second", bytes_per_second);
+        entry.set("allocations", allocation_count);
+        entry.set("allocated_bytes", allocated_bytes);
+        output.set(FUZZER_NAME, move(entry));
+
+        auto output_file = TRY(Core::File::open(output_path, Core::OpenMode::WriteOnly | Core::OpenMode::Truncate));
+        if (!output_file->write(output.to_string()))
+            return Error::from_string_literal("Failed to write results"sv);
+    }
+
+    return regressed ? 1 : 0;
+}
@@ -613,10 +613,48 @@ public:
 )~~~");
             };
 
+            auto do_implement_proxy_with_reply = [&](String const& name, Vector<Parameter> const& parameters) {
+                message_generator.set("message.pascal_name", pascal_case(message.name));
+                message_generator.set("message.response_type", message_name(endpoint.name, message.name, true));
+                message_generator.set("handler_name", name);
+                message_generator.append(R"~~~(
+    NonnullRefPtr<Core::Promise<NonnullOwnPtr<@message.response_type@>>> async_@handler_name@_with_reply()~~~");
+
+                for (size_t i = 0; i < parameters.size(); ++i) {
+                    auto& parameter = parameters[i];
+                    auto argument_generator = message_generator.fork();
+                    argument_generator.set("argument.type", parameter.type);
+                    argument_generator.set("argument.name", parameter.name);
+                    argument_generator.append("@argument.type@ @argument.name@");
+                    if (i != parameters.size() - 1)
+                        argument_generator.append(", ");
+                }
+
+                message_generator.append(R"~~~() {
+        return m_connection.template post_message_with_reply<Messages::@endpoint.name@::@message.pascal_name@>()~~~");
+
+                for (size_t i = 0; i < parameters.size(); ++i) {
+                    auto& parameter = parameters[i];
+                    auto argument_generator = message_generator.fork();
+                    argument_generator.set("argument.name", parameter.name);
+                    if (is_primitive_type(parameters[i].type))
+                        argument_generator.append("@argument.name@");
+                    else
+                        argument_generator.append("move(@argument.name@)");
+                    if (i != parameters.size() - 1)
+                        argument_generator.append(", ");
+                }
+
+                message_generator.append(R"~~~();
+    }
+)~~~");
+            };
+
             do_implement_proxy(message.name, message.inputs, message.is_synchronous, false);
             if (message.is_synchronous) {
                 do_implement_proxy(message.name, message.inputs, false, false);
                 do_implement_proxy(message.name, message.inputs, true, true);
+                do_implement_proxy_with_reply(message.name, message.inputs);
             }
         }
 
@@ -10,6 +10,7 @@
 #include <AK/SourceGenerator.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <AK/Time.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/Stream.h>
@@ -92,10 +93,18 @@ template<>
 struct AK::Formatter<TimeZoneOffset> : Formatter<FormatString> {
     ErrorOr<void> format(FormatBuilder& builder, TimeZoneOffset const& time_zone_offset)
     {
+        // The end of each offset is stored as seconds since the epoch, so lookups don't have to convert it at runtime.
+        // FIXME: This does not take last_weekday, after_weekday, or before_weekday into account.
+        i64 until = 0;
+        if (time_zone_offset.until.has_value()) {
+            auto const& date_time = *time_zone_offset.until;
+            until = AK::Time::from_timestamp(date_time.year, date_time.month.value_or(1), date_time.day.value_or(1), date_time.hour.value_or(0), date_time.minute.value_or(0), date_time.second.value_or(0), 0).to_seconds();
+        }
+
         return Formatter<FormatString>::format(builder,
             "{{ {}, {}, {}, {}, {}, {}, {} }}",
             time_zone_offset.offset,
-            time_zone_offset.until.value_or({}),
+            until,
             time_zone_offset.until.has_value(),
             time_zone_offset.dst_rule_index.value_or(-1),
             time_zone_offset.dst_offset,
@@ -503,7 +512,7 @@ struct DateTime {
 struct TimeZoneOffset {
     i64 offset { 0 };
 
-    DateTime until {};
+    i64 until { 0 };
     bool has_until { false };
 
     i32 dst_rule { -1 };
@@ -658,17 +667,27 @@ static Offset get_active_dst_offset(TimeZoneOffset const& time_zone_offset, AK::
 static TimeZoneOffset const& find_time_zone_offset(TimeZone time_zone, AK::Time time)
 {
     auto const& time_zone_offsets = s_time_zone_offsets[to_underlying(time_zone)];
+    VERIFY(!time_zone_offsets.is_empty());
 
-    size_t index = 0;
-    for (; index < time_zone_offsets.size(); ++index) {
-        auto const& time_zone_offset = time_zone_offsets[index];
+    auto ends_after = [&](auto const& time_zone_offset) {
+        return !time_zone_offset.has_until || (AK::Time::from_seconds(time_zone_offset.until) > time);
+    };
 
-        if (!time_zone_offset.has_until || (time_zone_offset.until.time_since_epoch() > time))
-            break;
+    // The offsets are in chronological order and only the last one has no end, so binary search for the first offset
+    // which ends after the given time.
+    size_t low = 0;
+    size_t high = time_zone_offsets.size() - 1;
+
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+
+        if (ends_after(time_zone_offsets[middle]))
+            high = middle;
+        else
+            low = middle + 1;
     }
 
-    VERIFY(index < time_zone_offsets.size());
-    return time_zone_offsets[index];
+    return time_zone_offsets[low];
 }
 
 Optional<Offset> get_time_zone_offset(TimeZone time_zone, AK::Time time)
@@ -10,6 +10,7 @@
 #include <AK/CharacterTypes.h>
 #include <AK/Find.h>
 #include <AK/HashMap.h>
+#include <AK/NumericLimits.h>
 #include <AK/Optional.h>
 #include <AK/QuickSort.h>
 #include <AK/SourceGenerator.h>
@@ -716,6 +717,100 @@ struct SpecialCasing {
     return {};
 }
 
+// Code point properties are looked up in two-stage tables. The code point space is split into blocks of
+// code_point_table_block_size code points; stage 1 maps each block to one of the unique blocks in stage 2, and
+// stage 2 maps each code point to one of the unique sets of properties that code points have.
+static constexpr u32 max_code_point = 0x10ffff;
+static constexpr u32 code_point_table_block_size = 256;
+
+struct CodePointTables {
+    Vector<u16> stage1;
+    Vector<u16> stage2;
+    Vector<u64> property_sets;
+    size_t words_per_property_set { 0 };
+};
+
+static CodePointTables build_code_point_tables(PropList const& property_list, Vector<String> const& property_names)
+{
+    struct Boundary {
+        u32 code_point { 0 };
+        size_t property { 0 };
+        bool is_start { false };
+    };
+
+    Vector<Boundary> boundaries;
+    for (size_t property = 0; property < property_names.size(); ++property) {
+        for (auto const& range : property_list.find(property_names[property])->value) {
+            boundaries.append({ range.first, property, true });
+            boundaries.append({ range.last + 1, property, false });
+        }
+    }
+    quick_sort(boundaries, [](auto const& boundary1, auto const& boundary2) { return boundary1.code_point < boundary2.code_point; });
+
+    CodePointTables tables;
+    tables.words_per_property_set = max<size_t>((property_names.size() + 63) / 64, 1);
+
+    HashMap<Vector<u64>, u16> property_set_indices;
+    Vector<u32> active_ranges;
+    active_ranges.resize(property_names.size());
+    Vector<u64> property_set;
+    property_set.resize(tables.words_per_property_set);
+
+    auto ensure_property_set = [&]() -> u16 {
+        if (auto index = property_set_indices.get(property_set); index.has_value())
+            return *index;
+
+        auto index = property_set_indices.size();
+        VERIFY(index <= NumericLimits<u16>::max());
+        property_set_indices.set(property_set, index);
+        tables.property_sets.extend(property_set);
+        return index;
+    };
+
+    HashMap<Vector<u16>, u16> block_indices;
+    Vector<u16> block;
+    block.ensure_capacity(code_point_table_block_size);
+
+    size_t next_boundary = 0;
+    u16 current_property_set = ensure_property_set();
+
+    for (u32 code_point = 0; code_point <= max_code_point; ++code_point) {
+        if ((next_boundary < boundaries.size()) && (boundaries[next_boundary].code_point == code_point)) {
+            for (; (next_boundary < boundaries.size()) && (boundaries[next_boundary].code_point == code_point); ++next_boundary) {
+                auto const& boundary = boundaries[next_boundary];
+                if (boundary.is_start)
+                    ++active_ranges[boundary.property];
+                else
+                    --active_ranges[boundary.property];
+            }
+
+            for (auto& word : property_set)
+                word = 0;
+            for (size_t property = 0; property < active_ranges.size(); ++property) {
+                if (active_ranges[property] != 0)
+                    property_set[property / 64] |= 1ull << (property % 64);
+            }
+            current_property_set = ensure_property_set();
+        }
+
+        block.append(current_property_set);
+        if (block.size() < code_point_table_block_size)
+            continue;
+
+        auto block_index = block_indices.get(block);
+        if (!block_index.has_value()) {
+            block_index = block_indices.size();
+            block_indices.set(block, *block_index);
+            tables.stage2.extend(block);
+        }
+
+        tables.stage1.append(*block_index);
+        block.clear_with_capacity();
+    }
+
+    return tables;
+}
+
 static ErrorOr<void> generate_unicode_data_implementation(Core::Stream::BufferedFile& file, UnicodeData const& unicode_data)
 {
     StringBuilder builder;
@@ -875,26 +970,25 @@ struct CodePointRangeComparator {
 
 )~~~");
 
-    auto append_code_point_range_list = [&](String name, Vector<CodePointRange> const& ranges) {
+    auto append_integer_list = [&](StringView name, StringView type, auto const& values) {
         generator.set("name", name);
-        generator.set("size", String::number(ranges.size()));
+        generator.set("type", type);
+        generator.set("size", String::number(values.size()));
         generator.append(R"~~~(
-static constexpr Array<CodePointRange, @size@> @name@ { {
+static constexpr Array<@type@, @size@> @name@ { {
     )~~~");
 
-        constexpr size_t max_ranges_per_row = 20;
-        size_t ranges_in_current_row = 0;
+        constexpr size_t max_values_per_row = 32;
+        size_t values_in_current_row = 0;
 
-        for (auto const& range : ranges) {
-            if (ranges_in_current_row++ > 0)
+        for (auto value : values) {
+            if (values_in_current_row++ > 0)
                 generator.append(" ");
 
-            generator.set("first", String::formatted("{:#x}", range.first));
-            generator.set("last", String::formatted("{:#x}", range.last));
-            generator.append("{ @first@, @last@ },");
+            generator.append(String::formatted("{:#x},", value));
 
-            if (ranges_in_current_row == max_ranges_per_row) {
-                ranges_in_current_row = 0;
+            if (values_in_current_row == max_values_per_row) {
+                values_in_current_row = 0;
                 generator.append("\n    ");
             }
         }
@@ -904,39 +998,40 @@ static constexpr Array<CodePointRange, @size@> @name@ { {
 )~~~");
     };
 
-    auto append_prop_list = [&](StringView collection_name, StringView property_format, PropList const& property_list) {
-        for (auto const& property : property_list) {
-            auto name = String::formatted(property_format, property.key);
-            append_code_point_range_list(move(name), property.value);
-        }
-
+    // These tables only hold integers, so they need no relocations and can be shared by every process that maps them.
+    auto append_property_tables = [&](StringView collection_name, PropList const& property_list) {
         auto property_names = property_list.keys();
         quick_sort(property_names);
 
-        generator.set("name", collection_name);
-        generator.set("size", String::number(property_names.size()));
-        generator.append(R"~~~(
-static constexpr Array<Span<CodePointRange const>, @size@> @name@ { {)~~~");
+        auto tables = build_code_point_tables(property_list, property_names);
+        auto property_set_count = tables.property_sets.size() / tables.words_per_property_set;
 
-        for (auto const& property_name : property_names) {
-            generator.set("name", String::formatted(property_format, property_name));
-            generator.append(R"~~~(
-    @name@.span(),)~~~");
-        }
+        append_integer_list(String::formatted("{}_stage1", collection_name), "u16"sv, tables.stage1);
+        append_integer_list(String::formatted("{}_stage2", collection_name), property_set_count <= 256 ? "u8"sv : "u16"sv, tables.stage2);
+        append_integer_list(String::formatted("{}_property_sets", collection_name), "u64"sv, tables.property_sets);
 
+        generator.set("name", collection_name);
+        generator.set("words_per_property_set", String::number(tables.words_per_property_set));
         generator.append(R"~~~(
-} };
+static constexpr size_t @name@_words_per_property_set = @words_per_property_set@;
 )~~~");
     };
 
-    append_prop_list("s_general_categories"sv, "s_general_category_{}"sv, unicode_data.general_categories);
-    append_prop_list("s_properties"sv, "s_property_{}"sv, unicode_data.prop_list);
-    append_prop_list("s_scripts"sv, "s_script_{}"sv, unicode_data.script_list);
-    append_prop_list("s_script_extensions"sv, "s_script_extension_{}"sv, unicode_data.script_extensions);
-    append_prop_list("s_blocks"sv, "s_block_{}"sv, unicode_data.block_list);
-    append_prop_list("s_grapheme_break_properties"sv, "s_grapheme_break_property_{}"sv, unicode_data.grapheme_break_props);
-    append_prop_list("s_word_break_properties"sv, "s_word_break_property_{}"sv, unicode_data.word_break_props);
-    append_prop_list("s_sentence_break_properties"sv, "s_sentence_break_property_{}"sv, unicode_data.sentence_break_props);
+    generator.set("block_size", String::number(code_point_table_block_size));
+    generator.set("max_code_point", String::formatted("{:#x}", max_code_point));
+    generator.append(R"~~~(
+static constexpr u32 code_point_table_block_size = @block_size@;
+static constexpr u32 max_code_point = @max_code_point@;
+)~~~");
+
+    append_property_tables("s_general_categories"sv, unicode_data.general_categories);
+    append_property_tables("s_properties"sv, unicode_data.prop_list);
+    append_property_tables("s_scripts"sv, unicode_data.script_list);
+    append_property_tables("s_script_extensions"sv, unicode_data.script_extensions);
+    append_property_tables("s_blocks"sv, unicode_data.block_list);
+    append_property_tables("s_grapheme_break_properties"sv, unicode_data.grapheme_break_props);
+    append_property_tables("s_word_break_properties"sv, unicode_data.word_break_props);
+    append_property_tables("s_sentence_break_properties"sv, unicode_data.sentence_break_props);
 
     generator.append(R"~~~(
 struct BlockNameComparator : public CodePointRangeComparator {
@@ -1062,11 +1157,15 @@ Optional<StringView> code_point_abbreviation(u32 code_point)
         generator.append(R"~~~(
 bool code_point_has_@enum_snake@(u32 code_point, @enum_title@ @enum_snake@)
 {
+    if (code_point > max_code_point)
+        return false;
+
     auto index = static_cast<@enum_title@UnderlyingType>(@enum_snake@);
-    auto const& ranges = @collection_name@.at(index);
+    auto block_index = @collection_name@_stage1[code_point / code_point_table_block_size];
+    auto property_set = @collection_name@_stage2[block_index * code_point_table_block_size + code_point % code_point_table_block_size];
 
-    auto const* range = binary_search(ranges, code_point, nullptr, CodePointRangeComparator {});
-    return range != nullptr;
+    auto word = @collection_name@_property_sets[property_set * @collection_name@_words_per_property_set + index / 64];
+    return (word >> (index % 64)) & 1;
 }
 )~~~");
     };
@@ -1691,7 +1691,14 @@ namespace Web::Bindings {
 void @wrapper_class@::initialize(JS::GlobalObject& global_object)
 {
     @wrapper_base_class@::initialize(global_object);
-}
+)~~~");
+
+    if (interface.extended_attributes.contains("CustomGet") || interface.is_legacy_platform_object()) {
+        generator.append(R"~~~(    set_may_interfere_with_property_lookup_caching();
+)~~~");
+    }
+
+    generator.append(R"~~~(}
 
 @wrapper_class@::~@wrapper_class@()
 {
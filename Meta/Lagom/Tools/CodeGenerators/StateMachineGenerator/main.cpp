@@ -340,6 +340,8 @@ public:
     {
     }
 
+    bool is_in_initial_state() const { return m_state == State::@initial_state@; }
+
     void advance(u8 byte)
     {
         auto next_state = lookup_state_transition(byte);
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/BumpAllocator.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+struct DestructionTracker {
+    Vector<int>& destroyed;
+    int id { 0 };
+
+    ~DestructionTracker() { destroyed.append(id); }
+};
+
+TEST_CASE(arena_allocates_aligned_objects)
+{
+    ArenaAllocator<> arena;
+    auto* a = arena.allocate<u8>(static_cast<u8>(1));
+    auto* b = arena.allocate<u64>(static_cast<u64>(2));
+    auto* c = arena.allocate<String>("three");
+    EXPECT_EQ(*a, 1);
+    EXPECT_EQ(*b, 2u);
+    EXPECT_EQ(*c, "three");
+    EXPECT_EQ(reinterpret_cast<FlatPtr>(b) % alignof(u64), 0u);
+    EXPECT_EQ(reinterpret_cast<FlatPtr>(c) % alignof(String), 0u);
+}
+
+TEST_CASE(arena_destroys_in_reverse_order)
+{
+    Vector<int> destroyed;
+    {
+        ArenaAllocator<> arena;
+        for (int i = 0; i < 1000; ++i)
+            EXPECT(arena.allocate<DestructionTracker>(destroyed, i));
+        EXPECT(destroyed.is_empty());
+    }
+    EXPECT_EQ(destroyed.size(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(destroyed[i], 999 - i);
+}
+
+TEST_CASE(arena_can_be_reused)
+{
+    Vector<int> destroyed;
+    ArenaAllocator<> arena;
+    arena.allocate<DestructionTracker>(destroyed, 1);
+    arena.deallocate_all();
+    EXPECT_EQ(destroyed.size(), 1u);
+
+    arena.allocate<DestructionTracker>(destroyed, 2);
+    auto* value = arena.allocate<int>(42);
+    EXPECT_EQ(*value, 42);
+    arena.deallocate_all();
+    EXPECT_EQ(destroyed.size(), 2u);
+    EXPECT_EQ(destroyed[1], 2);
+}
+
+BENCHMARK_CASE(arena_allocate_objects)
+{
+    for (size_t round = 0; round < 100; ++round) {
+        ArenaAllocator<false, 64 * KiB> arena;
+        for (size_t i = 0; i < 10000; ++i)
+            EXPECT(arena.allocate<Vector<int>>());
+    }
+}
+
+BENCHMARK_CASE(heap_allocate_objects)
+{
+    for (size_t round = 0; round < 100; ++round) {
+        Vector<NonnullOwnPtr<Vector<int>>> objects;
+        for (size_t i = 0; i < 10000; ++i)
+            objects.append(make<Vector<int>>());
+    }
+}
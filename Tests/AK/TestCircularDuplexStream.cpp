@@ -61,3 +61,31 @@ TEST_CASE(overwritting_is_well_defined)
 
     EXPECT(stream.eof());
 }
+
+TEST_CASE(write_from_seekback)
+{
+    constexpr size_t capacity = 16;
+
+    CircularDuplexStream<capacity> stream;
+    EXPECT(!stream.write_from_seekback(1, 1));
+    EXPECT(stream.handle_any_error());
+
+    stream << static_cast<u8>('a') << static_cast<u8>('b') << static_cast<u8>('c');
+    EXPECT(stream.write_from_seekback(3, 3));
+    // Overlapping the bytes being written repeats them.
+    EXPECT(stream.write_from_seekback(2, 5));
+
+    Array<u8, 11> buffer;
+    stream >> buffer;
+    EXPECT_EQ(StringView { buffer.span() }, "abcabcbcbcb"sv);
+
+    // Now the bytes being written wrap around the end of the storage, and then so do the ones they're copied from.
+    EXPECT(stream.write_from_seekback(8, 10));
+    Array<u8, 10> wrapped;
+    stream >> wrapped;
+    EXPECT_EQ(StringView { wrapped.span() }, "abcbcbcbab"sv);
+
+    EXPECT(!stream.write_from_seekback(capacity + 1, 1));
+    EXPECT(stream.handle_any_error());
+    EXPECT(stream.eof());
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/CountingBloomFilter.h>
+#include <AK/StringView.h>
+
+TEST_CASE(empty)
+{
+    CountingBloomFilter filter;
+    EXPECT(!filter.may_contain(0x12345678));
+    EXPECT(!filter.may_contain("foo"sv.hash()));
+}
+
+TEST_CASE(increment_and_decrement)
+{
+    CountingBloomFilter filter;
+    auto foo = "foo"sv.hash();
+    auto bar = "bar"sv.hash();
+
+    filter.increment(foo);
+    EXPECT(filter.may_contain(foo));
+
+    filter.increment(foo);
+    filter.increment(bar);
+    filter.decrement(foo);
+    EXPECT(filter.may_contain(foo));
+    EXPECT(filter.may_contain(bar));
+
+    filter.decrement(foo);
+    filter.decrement(bar);
+    EXPECT(!filter.may_contain(foo));
+    EXPECT(!filter.may_contain(bar));
+}
+
+TEST_CASE(saturated_counters_stay_set)
+{
+    CountingBloomFilter<u8, 4> filter;
+    for (size_t i = 0; i < 300; ++i)
+        filter.increment(0x00010001);
+    for (size_t i = 0; i < 300; ++i)
+        filter.decrement(0x00010001);
+    EXPECT(filter.may_contain(0x00010001));
+
+    filter.clear();
+    EXPECT(!filter.may_contain(0x00010001));
+}
+
+TEST_CASE(no_false_negatives)
+{
+    CountingBloomFilter filter;
+    for (u32 i = 0; i < 256; ++i)
+        filter.increment(int_hash(i));
+    for (u32 i = 0; i < 256; ++i)
+        EXPECT(filter.may_contain(int_hash(i)));
+}
@@ -9,6 +9,7 @@
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 
 TEST_CASE(construct)
 {
@@ -201,3 +202,32 @@ TEST_CASE(basic_contains)
     EXPECT_EQ(map.remove(1), true);
     EXPECT_EQ(map.contains(1), false);
 }
+
+BENCHMARK_CASE(hashmap_set_and_get_ints)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 100000; ++i)
+        map.set(i * 31, i);
+
+    int sum = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 100000; ++i)
+            sum += map.get(i * 31).value_or(0);
+    }
+    Test::do_not_optimize(sum);
+    EXPECT_EQ(map.size(), 100000u);
+}
+
+BENCHMARK_CASE(hashmap_set_and_remove_strings)
+{
+    Vector<String> keys;
+    for (int i = 0; i < 20000; ++i)
+        keys.append(String::formatted("key {}", i));
+
+    HashMap<String, int> map;
+    for (size_t i = 0; i < keys.size(); ++i)
+        map.set(keys[i], static_cast<int>(i));
+    for (auto const& key : keys)
+        EXPECT(map.remove(key));
+    EXPECT(map.is_empty());
+}
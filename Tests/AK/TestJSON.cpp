@@ -8,6 +8,7 @@
 
 #include <AK/HashMap.h>
 #include <AK/JsonObject.h>
+#include <AK/JsonPullParser.h>
 #include <AK/JsonValue.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -134,3 +135,141 @@ TEST_CASE(json_parse_long_decimals)
     auto value = JsonValue::from_string("1644452550.6489999294281");
     EXPECT_EQ(value.value().as_double(), 1644452550.6489999294281);
 }
+
+TEST_CASE(json_pull_parser_tokens)
+{
+    using Token = JsonPullParser::Token;
+    JsonPullParser parser(R"( {"a": [1, -2.5, "x\ny"], "b": {}, "c": true, "d": false, "e": null} )"sv);
+
+    auto expect_token = [&](Token expected) {
+        auto token = parser.next();
+        EXPECT(!token.is_error());
+        EXPECT(token.value() == expected);
+    };
+
+    expect_token(Token::ObjectStart);
+    expect_token(Token::Key);
+    EXPECT_EQ(parser.string(), "a"sv);
+    expect_token(Token::ArrayStart);
+    EXPECT_EQ(parser.depth(), 2u);
+    expect_token(Token::Number);
+    EXPECT_EQ(parser.number().as_u32(), 1u);
+    expect_token(Token::Number);
+    EXPECT_EQ(parser.number().as_double(), -2.5);
+    expect_token(Token::String);
+    EXPECT_EQ(parser.string(), "x\ny"sv);
+    expect_token(Token::ArrayEnd);
+    expect_token(Token::Key);
+    EXPECT_EQ(parser.string(), "b"sv);
+    expect_token(Token::ObjectStart);
+    expect_token(Token::ObjectEnd);
+    expect_token(Token::Key);
+    expect_token(Token::True);
+    expect_token(Token::Key);
+    expect_token(Token::False);
+    expect_token(Token::Key);
+    EXPECT_EQ(parser.string(), "e"sv);
+    expect_token(Token::Null);
+    expect_token(Token::ObjectEnd);
+    EXPECT_EQ(parser.depth(), 0u);
+    expect_token(Token::End);
+    expect_token(Token::End);
+}
+
+TEST_CASE(json_pull_parser_strings_point_into_input)
+{
+    auto input = R"(["plain", "esc\"aped"])"sv;
+    JsonPullParser parser(input);
+    EXPECT(parser.next().value() == JsonPullParser::Token::ArrayStart);
+    EXPECT(parser.next().value() == JsonPullParser::Token::String);
+    EXPECT_EQ(parser.string(), "plain"sv);
+    EXPECT_EQ(parser.string().characters_without_null_termination(), input.characters_without_null_termination() + 2);
+    EXPECT(parser.next().value() == JsonPullParser::Token::String);
+    EXPECT_EQ(parser.string(), "esc\"aped"sv);
+}
+
+TEST_CASE(json_pull_parser_skip_value)
+{
+    JsonPullParser parser(R"({"skipped": {"deep": [[1], {"x": "y"}]}, "wanted": 42, "last": [1, 2]})"sv);
+    Optional<u32> wanted;
+    EXPECT(parser.next().value() == JsonPullParser::Token::ObjectStart);
+    for (;;) {
+        auto token = parser.next().release_value();
+        if (token == JsonPullParser::Token::ObjectEnd)
+            break;
+        EXPECT(token == JsonPullParser::Token::Key);
+        if (parser.string() != "wanted"sv) {
+            EXPECT(!parser.skip_value().is_error());
+            continue;
+        }
+        EXPECT(parser.next().value() == JsonPullParser::Token::Number);
+        wanted = parser.number().as_u32();
+    }
+    EXPECT_EQ(wanted, 42u);
+    EXPECT(parser.next().value() == JsonPullParser::Token::End);
+}
+
+TEST_CASE(json_parse_long_strings)
+{
+    // Long enough for the block-at-a-time string scanning to find the special characters.
+    auto plain = String::repeated('a', 40);
+    auto json = JsonValue::from_string(String::formatted(R"(["{}", "{}\t{}\u00e9{}"])", plain, plain, plain, plain));
+    EXPECT(!json.is_error());
+    EXPECT_EQ(json.value().as_array().at(0).as_string(), plain);
+    EXPECT_EQ(json.value().as_array().at(1).as_string(), String::formatted("{}\t{}\u00e9{}", plain, plain, plain));
+
+    EXPECT(JsonValue::from_string(String::formatted("\"{}\n{}\"", plain, plain)).is_error());
+    EXPECT(JsonValue::from_string(String::formatted("\"{}", plain)).is_error());
+}
+
+TEST_CASE(json_parse_malformed)
+{
+    auto malformed = Array {
+        "{"sv, "["sv, "[1,]"sv, "{\"a\":1,}"sv, "{\"a\" 1}"sv, "{1: 2}"sv, "[1 2]"sv, "01"sv, "1.2.3"sv,
+        "\"\\x\""sv, "\"\\u12\""sv, "tru"sv, "[] []"sv, "\"abc"sv, "1."sv
+    };
+    for (auto input : malformed)
+        EXPECT(JsonValue::from_string(input).is_error());
+}
+
+static String make_benchmark_json()
+{
+    StringBuilder builder;
+    builder.append('[');
+    for (size_t i = 0; i < 10000; ++i) {
+        if (i != 0)
+            builder.append(',');
+        builder.appendff(R"({{"pid": {}, "name": "process_{}", "executable": "/usr/bin/process_{}", "threads": [{{"tid": {}, "state": "Running"}}]}})", i, i, i, i);
+    }
+    builder.append(']');
+    return builder.to_string();
+}
+
+BENCHMARK_CASE(json_parse_tree)
+{
+    auto json = make_benchmark_json();
+    u64 sum = 0;
+    for (size_t i = 0; i < 10; ++i) {
+        auto value = JsonValue::from_string(json).release_value();
+        value.as_array().for_each([&](auto& process) {
+            sum += process.as_object().get("pid").to_u32();
+        });
+    }
+    EXPECT_EQ(sum, 10u * 9999 * 10000 / 2);
+}
+
+BENCHMARK_CASE(json_parse_pull)
+{
+    auto json = make_benchmark_json();
+    u64 sum = 0;
+    for (size_t i = 0; i < 10; ++i) {
+        JsonPullParser parser(json);
+        for (auto token = parser.next().release_value(); token != JsonPullParser::Token::End; token = parser.next().release_value()) {
+            if (token == JsonPullParser::Token::Key && parser.depth() == 2 && parser.string() == "pid"sv) {
+                EXPECT(parser.next().value() == JsonPullParser::Token::Number);
+                sum += parser.number().to_u32();
+            }
+        }
+    }
+    EXPECT_EQ(sum, 10u * 9999 * 10000 / 2);
+}
@@ -9,6 +9,7 @@
 #include <AK/MemMem.h>
 #include <AK/Memory.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 
 TEST_CASE(bitap)
 {
@@ -69,6 +70,77 @@ TEST_CASE(kmp_two_chunks)
     EXPECT(!result_3.has_value());
 }
 
+static Optional<size_t> naive_memmem(Span<u8 const> haystack, Span<u8 const> needle)
+{
+    if (needle.size() > haystack.size())
+        return {};
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (__builtin_memcmp(haystack.data() + i, needle.data(), needle.size()) == 0)
+            return i;
+    }
+    return {};
+}
+
+TEST_CASE(memchr_optional)
+{
+    // Make sure the needle is found at every position relative to the block size, and not found past the end.
+    Vector<u8> haystack;
+    haystack.resize(100);
+    for (size_t length = 0; length < haystack.size(); ++length) {
+        for (size_t position = 0; position < haystack.size(); ++position) {
+            haystack.span().fill(0);
+            haystack[position] = 1;
+            auto result = AK::memchr_optional(haystack.data(), length, 1);
+            if (position < length)
+                EXPECT_EQ(result.value_or(9999), position);
+            else
+                EXPECT(!result.has_value());
+        }
+    }
+}
+
+TEST_CASE(memmem_matches_naive_search)
+{
+    // A small alphabet makes partial matches (and thus rejected candidates) common.
+    Vector<u8> haystack;
+    u32 state = 1;
+    for (size_t i = 0; i < 1000; ++i) {
+        state = state * 1103515245 + 12345;
+        haystack.append((state >> 16) % 3);
+    }
+
+    for (size_t needle_length = 1; needle_length < 40; ++needle_length) {
+        for (size_t start = 0; start + needle_length <= haystack.size(); start += 37) {
+            auto needle = haystack.span().slice(start, needle_length);
+            auto expected = naive_memmem(haystack, needle);
+            EXPECT_EQ(AK::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size()), expected);
+        }
+        Vector<u8> missing_needle;
+        missing_needle.resize(needle_length);
+        missing_needle.span().fill(3);
+        EXPECT(!AK::memmem_optional(haystack.data(), haystack.size(), missing_needle.data(), missing_needle.size()).has_value());
+    }
+}
+
+TEST_CASE(memmem_periodic_haystack)
+{
+    Vector<u8> haystack;
+    haystack.resize(4096);
+    haystack.span().fill('a');
+    haystack.last() = 'b';
+
+    for (size_t needle_length : { 2, 3, 16, 31, 32, 33, 100 }) {
+        Vector<u8> needle;
+        needle.resize(needle_length);
+        needle.span().fill('a');
+        needle.last() = 'b';
+        EXPECT_EQ(AK::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size()).value_or(0), haystack.size() - needle_length);
+
+        needle.last() = 'c';
+        EXPECT(!AK::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size()).has_value());
+    }
+}
+
 TEST_CASE(timing_safe_compare)
 {
     String data_set = "abcdefghijklmnopqrstuvwxyz123456789";
@@ -77,3 +149,46 @@ TEST_CASE(timing_safe_compare)
     String reversed = data_set.reverse();
     EXPECT_EQ(false, AK::timing_safe_compare(data_set.characters(), reversed.characters(), reversed.length()));
 }
+
+static Vector<u8> make_text_haystack(size_t size)
+{
+    Vector<u8> haystack;
+    haystack.ensure_capacity(size);
+    constexpr StringView text = "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod tempor incididunt ut labore.\n"sv;
+    while (haystack.size() < size)
+        haystack.append(text[haystack.size() % text.length()]);
+    return haystack;
+}
+
+BENCHMARK_CASE(memchr_optional_large)
+{
+    auto haystack = make_text_haystack(1 * MiB);
+    for (size_t i = 0; i < 1000; ++i)
+        EXPECT(!AK::memchr_optional(haystack.data(), haystack.size(), '#').has_value());
+}
+
+BENCHMARK_CASE(memmem_optional_short_needle)
+{
+    auto haystack = make_text_haystack(1 * MiB);
+    auto needle = "tempor incididunt ut laborum"sv;
+    for (size_t i = 0; i < 1000; ++i)
+        EXPECT(!AK::memmem_optional(haystack.data(), haystack.size(), needle.characters_without_null_termination(), needle.length()).has_value());
+}
+
+BENCHMARK_CASE(memmem_optional_long_needle)
+{
+    auto haystack = make_text_haystack(1 * MiB);
+    auto needle = "consectetur adipiscing elit, sed do eiusmod tempor incididunt ut laborum"sv;
+    for (size_t i = 0; i < 1000; ++i)
+        EXPECT(!AK::memmem_optional(haystack.data(), haystack.size(), needle.characters_without_null_termination(), needle.length()).has_value());
+}
+
+BENCHMARK_CASE(memmem_optional_periodic)
+{
+    Vector<u8> haystack;
+    haystack.resize(1 * MiB);
+    haystack.span().fill('a');
+    Array<u8, 8> needle { 'a', 'a', 'a', 'a', 'a', 'a', 'a', 'b' };
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(!AK::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size()).has_value());
+}
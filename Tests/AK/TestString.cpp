@@ -162,6 +162,50 @@ TEST_CASE(flystring)
     }
 }
 
+TEST_CASE(flystring_of_single_ascii_character)
+{
+    {
+        FlyString shared = String("q");
+        FlyString lowercased = String("Q").to_lowercase();
+        EXPECT_EQ(shared.impl(), lowercased.impl());
+        EXPECT_EQ(shared, lowercased);
+    }
+
+    {
+        // This time, the other StringImpl gets interned before the shared one for this character exists.
+        FlyString lowercased = String("W").to_lowercase();
+        FlyString repeated = String::repeated('w', 1);
+        FlyString shared = String("w");
+        EXPECT_EQ(shared.impl(), lowercased.impl());
+        EXPECT_EQ(shared.impl(), repeated.impl());
+    }
+}
+
+TEST_CASE(single_ascii_character_strings_are_shared)
+{
+    String a = "x";
+    String b = StringView { "xyz" }.substring_view(0, 1);
+    EXPECT_EQ(a.impl(), b.impl());
+    EXPECT_EQ(a, "x");
+    EXPECT_EQ(a.length(), 1u);
+    EXPECT_EQ(a.characters()[1], '\0');
+
+    String non_ascii = "\xff";
+    EXPECT_EQ(non_ascii.length(), 1u);
+    EXPECT_NE(non_ascii.impl(), String("\xff").impl());
+}
+
+TEST_CASE(builder_append_code_points)
+{
+    StringBuilder builder;
+    builder.append_code_point('a');
+    builder.append_code_point(0xe9);
+    builder.append_code_point(0x20ac);
+    builder.append_code_point(0x1f600);
+    builder.append_code_point(0x110000);
+    EXPECT_EQ(builder.to_string(), "a\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\xef\xbf\xbd");
+}
+
 TEST_CASE(replace)
 {
     String test_string = "Well, hello Friends!";
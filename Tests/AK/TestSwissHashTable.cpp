@@ -0,0 +1,261 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/HashMap.h>
+#include <AK/String.h>
+#include <AK/SwissHashTable.h>
+#include <AK/Vector.h>
+
+TEST_CASE(construct)
+{
+    using IntTable = SwissHashTable<int>;
+    EXPECT(IntTable().is_empty());
+    EXPECT_EQ(IntTable().size(), 0u);
+    EXPECT(IntTable().begin() == IntTable().end());
+    EXPECT(!IntTable().contains(1));
+}
+
+TEST_CASE(basic_move)
+{
+    SwissHashTable<int> foo;
+    foo.set(1);
+    EXPECT_EQ(foo.size(), 1u);
+    auto bar = move(foo);
+    EXPECT_EQ(bar.size(), 1u);
+    EXPECT_EQ(foo.size(), 0u);
+    foo = move(bar);
+    EXPECT_EQ(bar.size(), 0u);
+    EXPECT_EQ(foo.size(), 1u);
+    EXPECT(foo.contains(1));
+}
+
+TEST_CASE(copy)
+{
+    SwissHashTable<String> strings;
+    strings.set("One");
+    strings.set("Two");
+    auto copy = strings;
+    copy.set("Three");
+    EXPECT_EQ(strings.size(), 2u);
+    EXPECT_EQ(copy.size(), 3u);
+    EXPECT(copy.contains("One"sv));
+    EXPECT(copy.contains("Two"sv));
+    EXPECT(!strings.contains("Three"sv));
+}
+
+TEST_CASE(set_results)
+{
+    SwissHashTable<String> strings;
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(strings.set("One"), AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(strings.set("One", AK::HashSetExistingEntryBehavior::Keep), AK::HashSetResult::KeptExistingEntry);
+    EXPECT_EQ(strings.size(), 1u);
+}
+
+TEST_CASE(many_values)
+{
+    SwissHashTable<int> table;
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(table.set(i), AK::HashSetResult::InsertedNewEntry);
+    EXPECT_EQ(table.size(), 10000u);
+
+    size_t iterated = 0;
+    int sum = 0;
+    for (auto value : table) {
+        ++iterated;
+        sum += value;
+    }
+    EXPECT_EQ(iterated, 10000u);
+    EXPECT_EQ(sum, 9999 * 10000 / 2);
+
+    for (int i = 0; i < 10000; i += 2)
+        EXPECT(table.remove(i));
+    EXPECT_EQ(table.size(), 5000u);
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(table.contains(i), i % 2 == 1);
+}
+
+TEST_CASE(reuse_deleted_slots)
+{
+    // Churning through values without growing must keep finding every value that's still in the table.
+    SwissHashTable<int> table;
+    for (int i = 0; i < 100; ++i)
+        table.set(i);
+    for (int round = 1; round < 100; ++round) {
+        for (int i = 0; i < 100; ++i) {
+            EXPECT(table.remove((round - 1) * 100 + i));
+            table.set(round * 100 + i);
+        }
+        EXPECT_EQ(table.size(), 100u);
+    }
+    for (int i = 0; i < 100; ++i)
+        EXPECT(table.contains(9900 + i));
+    EXPECT(table.capacity() < 1024u);
+}
+
+TEST_CASE(remove_while_iterating)
+{
+    SwissHashTable<int> table;
+    for (int i = 0; i < 10; ++i)
+        table.set(i);
+
+    for (auto it = table.begin(); it != table.end();) {
+        auto current = it;
+        ++it;
+        if (*current % 2 == 0)
+            table.remove(current);
+    }
+    EXPECT_EQ(table.size(), 5u);
+}
+
+TEST_CASE(remove_all_matching)
+{
+    SwissHashTable<int> table;
+    for (int i = 0; i < 1000; ++i)
+        table.set(i);
+
+    EXPECT(table.remove_all_matching([](int value) { return value >= 10; }));
+    EXPECT_EQ(table.size(), 10u);
+    EXPECT(!table.remove_all_matching([](int) { return false; }));
+    for (int i = 0; i < 10; ++i)
+        EXPECT(table.contains(i));
+
+    EXPECT(table.remove_all_matching([](int) { return true; }));
+    EXPECT(table.is_empty());
+    EXPECT(table.begin() == table.end());
+}
+
+TEST_CASE(clear_with_capacity)
+{
+    SwissHashTable<String> table;
+    for (int i = 0; i < 100; ++i)
+        table.set(String::number(i));
+    auto capacity = table.capacity();
+    table.clear_with_capacity();
+    EXPECT(table.is_empty());
+    EXPECT_EQ(table.capacity(), capacity);
+    EXPECT(!table.contains("1"sv));
+    table.set("1");
+    EXPECT(table.contains("1"sv));
+}
+
+TEST_CASE(ensure_capacity)
+{
+    SwissHashTable<int> table;
+    table.ensure_capacity(1000);
+    auto capacity = table.capacity();
+    for (int i = 0; i < 1000; ++i)
+        table.set(i);
+    EXPECT_EQ(table.capacity(), capacity);
+}
+
+TEST_CASE(colliding_hashes)
+{
+    struct CollidingTraits : public GenericTraits<int> {
+        static unsigned hash(int value) { return value % 3; }
+    };
+
+    SwissHashTable<int, CollidingTraits> table;
+    for (int i = 0; i < 200; ++i)
+        table.set(i);
+    for (int i = 0; i < 200; i += 3)
+        EXPECT(table.remove(i));
+    for (int i = 0; i < 200; ++i)
+        EXPECT_EQ(table.contains(i), i % 3 != 0);
+}
+
+TEST_CASE(hash_map)
+{
+    SwissHashMap<String, int> map;
+    map.set("one", 1);
+    map.set("two", 2);
+    map.ensure("three", [] { return 3; });
+    EXPECT_EQ(map.size(), 3u);
+    EXPECT_EQ(map.get("two"sv).value(), 2);
+    EXPECT_EQ(map.get("three").value(), 3);
+    EXPECT(!map.get("four").has_value());
+    EXPECT(map.remove("one"));
+    EXPECT(!map.contains("one"));
+}
+
+static constexpr size_t benchmark_value_count = 100'000;
+
+template<typename Table>
+static void benchmark_insert()
+{
+    for (size_t round = 0; round < 10; ++round) {
+        Table table;
+        for (size_t i = 0; i < benchmark_value_count; ++i)
+            table.set(i);
+        EXPECT_EQ(table.size(), benchmark_value_count);
+    }
+}
+
+template<typename Table>
+static void benchmark_lookup()
+{
+    Table table;
+    for (size_t i = 0; i < benchmark_value_count; ++i)
+        table.set(i * 2);
+
+    size_t found = 0;
+    for (size_t round = 0; round < 10; ++round) {
+        for (size_t i = 0; i < benchmark_value_count * 2; ++i)
+            found += table.contains(i);
+    }
+    EXPECT_EQ(found, benchmark_value_count * 10);
+}
+
+template<typename Map>
+static void benchmark_string_lookup()
+{
+    Vector<String> keys;
+    for (size_t i = 0; i < benchmark_value_count / 10; ++i)
+        keys.append(String::formatted("property_{}", i));
+
+    Map map;
+    for (size_t i = 0; i < keys.size(); ++i)
+        map.set(keys[i], i);
+
+    size_t sum = 0;
+    for (size_t round = 0; round < 50; ++round) {
+        for (auto& key : keys)
+            sum += map.get(key).value();
+    }
+    EXPECT_EQ(sum, 50 * (keys.size() - 1) * keys.size() / 2);
+}
+
+BENCHMARK_CASE(insert_hash_table)
+{
+    benchmark_insert<HashTable<size_t>>();
+}
+
+BENCHMARK_CASE(insert_swiss_hash_table)
+{
+    benchmark_insert<SwissHashTable<size_t>>();
+}
+
+BENCHMARK_CASE(lookup_hash_table)
+{
+    benchmark_lookup<HashTable<size_t>>();
+}
+
+BENCHMARK_CASE(lookup_swiss_hash_table)
+{
+    benchmark_lookup<SwissHashTable<size_t>>();
+}
+
+BENCHMARK_CASE(string_lookup_hash_map)
+{
+    benchmark_string_lookup<HashMap<String, size_t>>();
+}
+
+BENCHMARK_CASE(string_lookup_swiss_hash_map)
+{
+    benchmark_string_lookup<SwissHashMap<String, size_t>>();
+}
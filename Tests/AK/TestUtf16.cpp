@@ -11,6 +11,8 @@
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <AK/Utf16View.h>
+#include <AK/Utf8View.h>
+#include <AK/Vector.h>
 
 TEST_CASE(decode_ascii)
 {
@@ -50,6 +52,26 @@ TEST_CASE(decode_utf8)
     EXPECT_EQ(i, expected.size());
 }
 
+TEST_CASE(decode_long_utf8)
+{
+    // The ASCII runs are long enough to go through the block-at-a-time fast path.
+    auto ascii = String::repeated('x', 70);
+    auto utf8 = String::formatted("{}Привет 😀{}\xff{}", ascii, ascii, ascii);
+    auto string = AK::utf8_to_utf16(utf8);
+    Utf16View view { string };
+
+    Vector<u32> expected;
+    for (auto code_point : Utf8View(utf8))
+        expected.append(code_point);
+
+    EXPECT_EQ(view.length_in_code_points(), expected.size());
+    EXPECT_EQ(view.length_in_code_units(), expected.size() + 1);
+    size_t i = 0;
+    for (u32 code_point : view)
+        EXPECT_EQ(code_point, expected[i++]);
+    EXPECT_EQ(i, expected.size());
+}
+
 TEST_CASE(encode_utf8)
 {
     {
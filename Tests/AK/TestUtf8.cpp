@@ -7,6 +7,7 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/ByteBuffer.h>
+#include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
@@ -72,6 +73,32 @@ TEST_CASE(validate_invalid_ut8)
     EXPECT(valid_bytes == 0);
 }
 
+TEST_CASE(validate_long_strings)
+{
+    // Put the interesting bytes at every position relative to the 16- and 64-byte blocks of the ASCII fast path.
+    for (size_t prefix_length = 0; prefix_length < 80; ++prefix_length) {
+        auto prefix = String::repeated('a', prefix_length);
+
+        auto valid = String::formatted("{}Привет 😀{}", prefix, prefix);
+        size_t valid_bytes;
+        EXPECT(Utf8View(valid).validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, valid.length());
+        EXPECT_EQ(Utf8View(valid).length(), prefix_length * 2 + 8);
+        EXPECT_EQ(Utf8View(prefix).ascii_prefix_length(), prefix_length);
+        EXPECT_EQ(Utf8View(valid).ascii_prefix_length(), prefix_length);
+
+        auto invalid = String::formatted("{}\xd0\x9f\xd0{}", prefix, prefix);
+        EXPECT(!Utf8View(invalid).validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, prefix_length + 2);
+        EXPECT_EQ(Utf8View(invalid).length(), prefix_length * 2 + 2);
+
+        auto truncated = String::formatted("{}\xf0\x9f\x98", prefix);
+        EXPECT(!Utf8View(truncated).validate(valid_bytes));
+        EXPECT_EQ(valid_bytes, prefix_length);
+        EXPECT_EQ(Utf8View(truncated).length(), prefix_length + 3);
+    }
+}
+
 TEST_CASE(iterate_utf8)
 {
     Utf8View view("Some weird characters \u00A9\u266A\uA755"sv);
@@ -217,3 +244,32 @@ TEST_CASE(trim)
         EXPECT_EQ(view.trim(whitespace, TrimMode::Right).as_string(), "\u180E");
     }
 }
+
+static String make_benchmark_text(StringView chunk)
+{
+    StringBuilder builder;
+    while (builder.length() < 1 * MiB)
+        builder.append(chunk);
+    return builder.to_string();
+}
+
+BENCHMARK_CASE(validate_ascii)
+{
+    auto text = make_benchmark_text("The quick brown fox jumps over the lazy dog. "sv);
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(Utf8View(text).validate());
+}
+
+BENCHMARK_CASE(validate_mixed)
+{
+    auto text = make_benchmark_text("The quick brown fox, Привет мир, こんにちは世界! "sv);
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT(Utf8View(text).validate());
+}
+
+BENCHMARK_CASE(length_ascii)
+{
+    auto text = make_benchmark_text("The quick brown fox jumps over the lazy dog. "sv);
+    for (size_t i = 0; i < 100; ++i)
+        EXPECT_EQ(Utf8View(text).length(), text.length());
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+static int create_test_file(char const* contents)
+{
+    char path[] = "/tmp/copy_file_range.XXXXXX";
+    int fd = mkstemp(path);
+    VERIFY(fd >= 0);
+    unlink(path);
+    auto length = strlen(contents);
+    VERIFY(write(fd, contents, length) == static_cast<ssize_t>(length));
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+static String read_test_file(int fd)
+{
+    char buffer[64] {};
+    auto nread = pread(fd, buffer, sizeof(buffer), 0);
+    VERIFY(nread >= 0);
+    return String(buffer, nread);
+}
+
+TEST_CASE(copy_file_range_with_offsets)
+{
+    int in_fd = create_test_file("Hello friends!");
+    int out_fd = create_test_file("Goodbye pals!");
+
+    off_t in_offset = 6;
+    off_t out_offset = 8;
+    EXPECT_EQ(copy_file_range(in_fd, &in_offset, out_fd, &out_offset, 7, 0), 7);
+    EXPECT_EQ(in_offset, 13);
+    EXPECT_EQ(out_offset, 15);
+    // The file offsets are left alone when explicit offsets are given.
+    EXPECT_EQ(lseek(in_fd, 0, SEEK_CUR), 0);
+    EXPECT_EQ(lseek(out_fd, 0, SEEK_CUR), 0);
+    EXPECT_EQ(read_test_file(out_fd), "Goodbye friends"sv);
+
+    // Copying from past the end of the file copies nothing.
+    in_offset = 100;
+    EXPECT_EQ(copy_file_range(in_fd, &in_offset, out_fd, &out_offset, 7, 0), 0);
+
+    close(in_fd);
+    close(out_fd);
+}
+
+TEST_CASE(copy_file_range_advances_file_offsets)
+{
+    int in_fd = create_test_file("Hello friends!");
+    int out_fd = create_test_file("");
+
+    EXPECT_EQ(copy_file_range(in_fd, nullptr, out_fd, nullptr, 5, 0), 5);
+    EXPECT_EQ(lseek(in_fd, 0, SEEK_CUR), 5);
+    EXPECT_EQ(lseek(out_fd, 0, SEEK_CUR), 5);
+    EXPECT_EQ(copy_file_range(in_fd, nullptr, out_fd, nullptr, 100, 0), 9);
+    EXPECT_EQ(copy_file_range(in_fd, nullptr, out_fd, nullptr, 100, 0), 0);
+    EXPECT_EQ(read_test_file(out_fd), "Hello friends!"sv);
+
+    close(in_fd);
+    close(out_fd);
+}
+
+TEST_CASE(copy_file_range_within_a_file)
+{
+    int fd = create_test_file("abcdef");
+
+    off_t in_offset = 0;
+    off_t out_offset = 3;
+    EXPECT_EQ(copy_file_range(fd, &in_offset, fd, &out_offset, 3, 0), 3);
+    EXPECT_EQ(read_test_file(fd), "abcabc"sv);
+
+    // Overlapping ranges are not allowed.
+    in_offset = 0;
+    out_offset = 2;
+    EXPECT_EQ(copy_file_range(fd, &in_offset, fd, &out_offset, 3, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(fd);
+}
+
+TEST_CASE(copy_file_range_needs_regular_files)
+{
+    int file_fd = create_test_file("Hello friends!");
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    EXPECT_EQ(copy_file_range(file_fd, nullptr, pipe_fds[1], nullptr, 5, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    EXPECT_EQ(copy_file_range(file_fd, nullptr, file_fd, nullptr, 5, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(file_fd);
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static int add_to_epoll(int epoll_fd, int fd, u32 events)
+{
+    epoll_event event {};
+    event.events = events;
+    event.data.fd = fd;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event);
+}
+
+TEST_CASE(level_triggered_stays_ready)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    EXPECT(epoll_fd >= 0);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(add_to_epoll(epoll_fd, pipe_fds[0], EPOLLIN), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    EXPECT_EQ(write(pipe_fds[1], "xx", 2), 2);
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+        EXPECT_EQ(events[0].data.fd, pipe_fds[0]);
+        EXPECT(events[0].events & EPOLLIN);
+    }
+
+    char buffer[2];
+    EXPECT_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), 2);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(edge_triggered_reports_once)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(add_to_epoll(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLET), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(oneshot_is_rearmed_by_modify)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(add_to_epoll(epoll_fd, pipe_fds[0], EPOLLIN | EPOLLONESHOT), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 0);
+
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLONESHOT;
+    event.data.fd = pipe_fds[0];
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_MOD, pipe_fds[0], &event), 0);
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 0), 1);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(wait_blocks_until_timeout)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+    EXPECT_EQ(add_to_epoll(epoll_fd, pipe_fds[0], EPOLLIN), 0);
+
+    epoll_event events[4];
+    EXPECT_EQ(epoll_wait(epoll_fd, events, 4, 50), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
+
+TEST_CASE(ctl_errors)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    EXPECT_EQ(add_to_epoll(epoll_fd, pipe_fds[0], EPOLLIN), 0);
+    EXPECT_EQ(add_to_epoll(epoll_fd, pipe_fds[0], EPOLLIN), -1);
+    EXPECT_EQ(errno, EEXIST);
+
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), 0);
+    EXPECT_EQ(epoll_ctl(epoll_fd, EPOLL_CTL_DEL, pipe_fds[0], nullptr), -1);
+    EXPECT_EQ(errno, ENOENT);
+
+    EXPECT_EQ(add_to_epoll(epoll_fd, epoll_fd, EPOLLIN), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(epoll_fd);
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/sendfile.h>
+#include <unistd.h>
+
+static int create_test_file(char const* contents)
+{
+    char path[] = "/tmp/sendfile.XXXXXX";
+    int fd = mkstemp(path);
+    VERIFY(fd >= 0);
+    unlink(path);
+    auto length = strlen(contents);
+    VERIFY(write(fd, contents, length) == static_cast<ssize_t>(length));
+    VERIFY(lseek(fd, 0, SEEK_SET) == 0);
+    return fd;
+}
+
+TEST_CASE(sendfile_with_offset)
+{
+    int file_fd = create_test_file("Hello friends!");
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    off_t offset = 6;
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, &offset, 7), 7);
+    EXPECT_EQ(offset, 13);
+    // The file offset is left alone when an explicit offset is given.
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), 0);
+
+    char buffer[16] {};
+    EXPECT_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), 7);
+    EXPECT_EQ(StringView(buffer, 7), "friends"sv);
+
+    // Reading past the end of the file sends nothing.
+    offset = 100;
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, &offset, 7), 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(file_fd);
+}
+
+TEST_CASE(sendfile_advances_file_offset)
+{
+    int file_fd = create_test_file("Hello friends!");
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 5), 5);
+    EXPECT_EQ(lseek(file_fd, 0, SEEK_CUR), 5);
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 100), 9);
+    EXPECT_EQ(sendfile(pipe_fds[1], file_fd, nullptr, 100), 0);
+
+    char buffer[32] {};
+    EXPECT_EQ(read(pipe_fds[0], buffer, sizeof(buffer)), 14);
+    EXPECT_EQ(StringView(buffer, 14), "Hello friends!"sv);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    close(file_fd);
+}
+
+TEST_CASE(sendfile_needs_a_regular_file)
+{
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    EXPECT_EQ(write(pipe_fds[1], "x", 1), 1);
+    EXPECT_EQ(sendfile(pipe_fds[1], pipe_fds[0], nullptr, 1), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/MemoryStream.h>
+#include <AK/Random.h>
+#include <LibArchive/Zip.h>
+#include <LibCrypto/Checksum/CRC32.h>
+
+// Text that compresses well, followed by random bytes that don't.
+static ByteBuffer make_contents(size_t size)
+{
+    ByteBuffer contents;
+    while (contents.size() < size / 2)
+        contents.append("All work and no play makes Jack a dull boy. "sv.bytes());
+    auto text_size = contents.size();
+    contents.resize(size);
+    fill_with_random(contents.data() + text_size, size - text_size);
+    return contents;
+}
+
+static ByteBuffer decompress(Archive::ZipMember const& member)
+{
+    ByteBuffer output;
+    auto result = member.decompress([&](ReadonlyBytes bytes) -> ErrorOr<void> {
+        output.append(bytes);
+        return {};
+    });
+    EXPECT(!result.is_error());
+    return output;
+}
+
+TEST_CASE(streamed_members_round_trip)
+{
+    auto small_contents = make_contents(1000);
+    auto large_contents = make_contents(300 * KiB);
+
+    DuplexMemoryStream archive_stream;
+    Archive::ZipOutputStream zip_stream { archive_stream };
+    zip_stream.add_member({
+        .name = "small",
+        .compressed_data = small_contents,
+        .compression_method = Archive::ZipCompressionMethod::Store,
+        .uncompressed_size = static_cast<u32>(small_contents.size()),
+        .crc32 = Crypto::Checksum::CRC32 { small_contents }.digest(),
+        .is_directory = false,
+    });
+    InputMemoryStream deflated_input { large_contents };
+    auto deflated_size = zip_stream.add_member_from_stream("deflated", deflated_input, Archive::ZipCompressionMethod::Deflate);
+    EXPECT(!deflated_size.is_error());
+    EXPECT(deflated_size.value() < large_contents.size());
+    InputMemoryStream stored_input { large_contents };
+    auto stored_size = zip_stream.add_member_from_stream("stored", stored_input, Archive::ZipCompressionMethod::Store);
+    EXPECT(!stored_size.is_error());
+    EXPECT_EQ(stored_size.value(), large_contents.size());
+    zip_stream.finish();
+
+    auto archive = archive_stream.copy_into_contiguous_buffer();
+    auto zip = Archive::Zip::try_create(archive);
+    EXPECT(zip.has_value());
+
+    Vector<String> names;
+    zip->for_each_member([&](auto& member) {
+        names.append(member.name);
+        auto contents = decompress(member);
+        if (member.name == "small")
+            EXPECT(contents == small_contents);
+        else
+            EXPECT(contents == large_contents);
+        return IterationDecision::Continue;
+    });
+    EXPECT_EQ(names.size(), 3u);
+    EXPECT_EQ(names[0], "small");
+    EXPECT_EQ(names[1], "deflated");
+    EXPECT_EQ(names[2], "stored");
+}
+
+TEST_CASE(stored_members_are_not_copied)
+{
+    auto contents = make_contents(200 * KiB);
+
+    DuplexMemoryStream archive_stream;
+    Archive::ZipOutputStream zip_stream { archive_stream };
+    InputMemoryStream input { contents };
+    EXPECT(!zip_stream.add_member_from_stream("stored", input, Archive::ZipCompressionMethod::Store).is_error());
+    zip_stream.finish();
+
+    auto archive = archive_stream.copy_into_contiguous_buffer();
+    auto zip = Archive::Zip::try_create(archive);
+    EXPECT(zip.has_value());
+    zip->for_each_member([&](auto& member) {
+        size_t offset = 0;
+        auto result = member.decompress([&](ReadonlyBytes bytes) -> ErrorOr<void> {
+            EXPECT(bytes.data() == member.compressed_data.data() + offset);
+            offset += bytes.size();
+            return {};
+        });
+        EXPECT(!result.is_error());
+        EXPECT_EQ(offset, contents.size());
+        return IterationDecision::Continue;
+    });
+}
+
+TEST_CASE(corrupted_member_is_detected)
+{
+    auto contents = make_contents(10 * KiB);
+
+    for (auto compression_method : Array { Archive::ZipCompressionMethod::Store, Archive::ZipCompressionMethod::Deflate }) {
+        DuplexMemoryStream archive_stream;
+        Archive::ZipOutputStream zip_stream { archive_stream };
+        InputMemoryStream input { contents };
+        EXPECT(!zip_stream.add_member_from_stream("member", input, compression_method).is_error());
+        zip_stream.finish();
+
+        auto archive = archive_stream.copy_into_contiguous_buffer();
+        auto zip = Archive::Zip::try_create(archive);
+        EXPECT(zip.has_value());
+        zip->for_each_member([&](auto& member) {
+            // Flip a bit in the part that doesn't compress, where deflate just stores the data.
+            auto& byte = const_cast<u8&>(member.compressed_data[member.compressed_data.size() - 100]);
+            byte ^= 1;
+            auto result = member.decompress([](ReadonlyBytes) -> ErrorOr<void> { return {}; });
+            EXPECT(result.is_error());
+            return IterationDecision::Continue;
+        });
+    }
+}
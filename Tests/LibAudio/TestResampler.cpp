@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Math.h>
+#include <AK/Vector.h>
+#include <LibAudio/Resampler.h>
+
+static Vector<Audio::Sample> make_sine(u32 sample_rate, double frequency, size_t count)
+{
+    Vector<Audio::Sample> samples;
+    for (size_t i = 0; i < count; ++i) {
+        double value = 0.5 * AK::sin(2 * AK::Pi<double> * frequency * i / sample_rate);
+        samples.append({ value, -value });
+    }
+    return samples;
+}
+
+// The largest difference from a sine of the given frequency, ignoring the start and end where the filter runs into silence.
+static double distance_from_sine(Vector<Audio::Sample> const& samples, u32 sample_rate, double frequency)
+{
+    auto expected = make_sine(sample_rate, frequency, samples.size());
+    double distance = 0;
+    for (size_t i = 100; i + 100 < samples.size(); ++i) {
+        distance = max(distance, AK::fabs(samples[i].left - expected[i].left));
+        distance = max(distance, AK::fabs(samples[i].right - expected[i].right));
+    }
+    return distance;
+}
+
+static void expect_resampled_sine(u32 source, u32 target)
+{
+    Audio::PolyphaseResampler resampler(source, target);
+    Vector<Audio::Sample> resampled;
+    EXPECT(!resampler.resample(make_sine(source, 1000, source / 10).span(), resampled).is_error());
+    // All but the last half of a filter length has come out.
+    auto expected_size = static_cast<double>(source / 10 - resampler.tap_count() / 2) * target / source;
+    EXPECT(AK::fabs(resampled.size() - expected_size) <= 2);
+    EXPECT(distance_from_sine(resampled, target, 1000) < 0.01);
+}
+
+TEST_CASE(upsample_sine)
+{
+    expect_resampled_sine(44100, 48000);
+    expect_resampled_sine(22050, 48000);
+    expect_resampled_sine(8000, 44100);
+}
+
+TEST_CASE(downsample_sine)
+{
+    expect_resampled_sine(48000, 44100);
+    expect_resampled_sine(96000, 44100);
+    expect_resampled_sine(44100, 8000);
+}
+
+TEST_CASE(same_rate_is_unchanged)
+{
+    Audio::PolyphaseResampler resampler(44100, 44100);
+    auto input = make_sine(44100, 1000, 4410);
+    Vector<Audio::Sample> resampled;
+    EXPECT(!resampler.resample(input.span(), resampled).is_error());
+    EXPECT(resampled.size() <= input.size());
+    for (size_t i = 0; i < resampled.size(); ++i) {
+        EXPECT(AK::fabs(resampled[i].left - input[i].left) < 1e-6);
+        EXPECT(AK::fabs(resampled[i].right - input[i].right) < 1e-6);
+    }
+}
+
+TEST_CASE(chunks_resample_like_the_whole)
+{
+    auto input = make_sine(44100, 1000, 4410);
+
+    Audio::PolyphaseResampler whole_resampler(44100, 48000);
+    Vector<Audio::Sample> whole;
+    EXPECT(!whole_resampler.resample(input.span(), whole).is_error());
+
+    Audio::PolyphaseResampler chunked_resampler(44100, 48000);
+    Vector<Audio::Sample> chunked;
+    for (size_t offset = 0; offset < input.size(); offset += 7)
+        EXPECT(!chunked_resampler.resample(input.span().slice(offset, min<size_t>(7, input.size() - offset)), chunked).is_error());
+
+    EXPECT_EQ(chunked.size(), whole.size());
+    for (size_t i = 0; i < whole.size(); ++i) {
+        EXPECT_EQ(chunked[i].left, whole[i].left);
+        EXPECT_EQ(chunked[i].right, whole[i].right);
+    }
+}
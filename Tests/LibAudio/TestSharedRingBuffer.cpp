@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <LibAudio/SharedRingBuffer.h>
+
+static Array<Audio::Sample, 48> make_samples(double offset)
+{
+    Array<Audio::Sample, 48> samples;
+    for (size_t i = 0; i < samples.size(); ++i)
+        samples[i] = Audio::Sample { offset + i, -(offset + i) };
+    return samples;
+}
+
+TEST_CASE(read_what_was_written_across_the_end)
+{
+    auto ring_buffer = MUST(Audio::SharedRingBuffer::create(64));
+    EXPECT_EQ(ring_buffer.available_to_write(), 64u);
+
+    // Each round ends up somewhere else in the buffer, so most of them wrap around its end.
+    for (size_t round = 0; round < 10; ++round) {
+        auto written = make_samples(round * 100);
+        EXPECT_EQ(ring_buffer.write(written.span()), written.size());
+        EXPECT_EQ(ring_buffer.available_to_read(), written.size());
+
+        Array<Audio::Sample, 48> read;
+        EXPECT_EQ(ring_buffer.read(read.span()), read.size());
+        for (size_t i = 0; i < read.size(); ++i) {
+            EXPECT_EQ(read[i].left, written[i].left);
+            EXPECT_EQ(read[i].right, written[i].right);
+        }
+        EXPECT_EQ(ring_buffer.available_to_read(), 0u);
+    }
+}
+
+TEST_CASE(write_only_what_fits)
+{
+    auto ring_buffer = MUST(Audio::SharedRingBuffer::create(64));
+    auto samples = make_samples(0);
+    EXPECT_EQ(ring_buffer.write(samples.span()), 48u);
+    EXPECT_EQ(ring_buffer.write(samples.span()), 16u);
+    EXPECT_EQ(ring_buffer.available_to_write(), 0u);
+
+    Array<Audio::Sample, 32> read;
+    EXPECT_EQ(ring_buffer.read(read.span()), 32u);
+    EXPECT_EQ(ring_buffer.available_to_write(), 32u);
+
+    ring_buffer.discard_all();
+    EXPECT_EQ(ring_buffer.available_to_read(), 0u);
+    EXPECT_EQ(ring_buffer.read(read.span()), 0u);
+}
+
+TEST_CASE(both_sides_share_the_samples)
+{
+    auto producer = MUST(Audio::SharedRingBuffer::create(64));
+    auto consumer = MUST(Audio::SharedRingBuffer::create_from_anonymous_buffer(producer.anonymous_buffer()));
+    EXPECT_EQ(consumer.capacity(), 64u);
+
+    auto samples = make_samples(7);
+    producer.write(samples.span());
+    Array<Audio::Sample, 48> read;
+    EXPECT_EQ(consumer.read(read.span()), 48u);
+    EXPECT_EQ(read[47].left, 54.0);
+    EXPECT_EQ(producer.available_to_write(), 64u);
+}
+
+TEST_CASE(invalid_ring_buffers)
+{
+    EXPECT(Audio::SharedRingBuffer::create(0).is_error());
+    EXPECT(Audio::SharedRingBuffer::create(100).is_error());
+
+    // A capacity that the anonymous buffer is too small for.
+    auto buffer = MUST(Core::AnonymousBuffer::create_with_size(4096));
+    buffer.data<u32>()[2] = 1024;
+    EXPECT(Audio::SharedRingBuffer::create_from_anonymous_buffer(buffer).is_error());
+    buffer.data<u32>()[2] = 100;
+    EXPECT(Audio::SharedRingBuffer::create_from_anonymous_buffer(buffer).is_error());
+    buffer.data<u32>()[2] = 128;
+    EXPECT(!Audio::SharedRingBuffer::create_from_anonymous_buffer(buffer).is_error());
+}
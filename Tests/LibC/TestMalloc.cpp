@@ -6,9 +6,12 @@
 
 #include <LibTest/TestCase.h>
 
+#include <AK/Array.h>
 #include <LibC/mallocdefs.h>
 #include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
+#include <string.h>
 
 TEST_CASE(malloc_limits)
 {
@@ -38,3 +41,60 @@ TEST_CASE(malloc_limits)
         return Test::Crash::Failure::DidNotCrash;
     });
 }
+
+static constexpr size_t allocations_per_thread = 4096;
+
+static void* allocate_and_free_chunks(void*)
+{
+    Array<void*, 64> live_chunks {};
+    for (size_t i = 0; i < allocations_per_thread; ++i) {
+        auto& slot = live_chunks[i % live_chunks.size()];
+        free(slot);
+        auto size = size_classes[i % num_size_classes];
+        slot = malloc(size);
+        EXPECT(slot);
+        EXPECT(malloc_size(slot) >= size);
+        memset(slot, 0x42, size);
+    }
+    for (auto* chunk : live_chunks)
+        free(chunk);
+    return nullptr;
+}
+
+TEST_CASE(malloc_from_many_threads)
+{
+    Array<pthread_t, 8> threads {};
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, allocate_and_free_chunks, nullptr), 0);
+    for (auto thread : threads)
+        EXPECT_EQ(pthread_join(thread, nullptr), 0);
+}
+
+static void* free_chunks(void* argument)
+{
+    auto& chunks = *static_cast<Array<void*, allocations_per_thread>*>(argument);
+    for (auto* chunk : chunks)
+        free(chunk);
+    return nullptr;
+}
+
+TEST_CASE(free_from_another_thread)
+{
+    Array<void*, allocations_per_thread> chunks {};
+    for (auto& chunk : chunks) {
+        chunk = malloc(32);
+        EXPECT(chunk);
+    }
+
+    pthread_t thread;
+    EXPECT_EQ(pthread_create(&thread, nullptr, free_chunks, &chunks), 0);
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+
+    // The chunks freed by the other thread were handed back to the global heap when it exited.
+    for (auto& chunk : chunks) {
+        chunk = malloc(32);
+        EXPECT(chunk);
+    }
+    for (auto* chunk : chunks)
+        free(chunk);
+}
@@ -54,6 +54,48 @@ TEST_CASE(canonical_code_complex)
         EXPECT_EQ(huffman.read_symbol(bit_stream), output[idx]);
 }
 
+TEST_CASE(canonical_code_long_codes)
+{
+    // Code lengths of 1, 2, ..., 14, 15 and 15, which make for a complete code that needs every bit of the lookup tables.
+    Array<u8, 16> code {};
+    for (size_t i = 0; i < code.size(); ++i)
+        code[i] = min(i + 1, 15u);
+
+    const auto huffman = Compress::CanonicalCode::from_bytes(code).value();
+    const Array<u32, 10> symbols { 15, 0, 14, 9, 8, 1, 15, 10, 13, 2 };
+
+    DuplexMemoryStream encoded;
+    {
+        OutputBitStream bit_stream { encoded };
+        for (auto symbol : symbols)
+            huffman.write_symbol(bit_stream, symbol);
+        bit_stream.align_to_byte_boundary();
+    }
+    // Something to come after the codes, which reading them mustn't touch.
+    encoded << static_cast<u8>(0x42);
+
+    auto buffer = encoded.copy_into_contiguous_buffer();
+    auto memory_stream = InputMemoryStream { buffer };
+    auto bit_stream = InputBitStream { memory_stream };
+    for (auto symbol : symbols)
+        EXPECT_EQ(huffman.read_symbol(bit_stream), symbol);
+    EXPECT_EQ(memory_stream.remaining(), 1u);
+}
+
+TEST_CASE(canonical_code_single_symbol)
+{
+    const Array<u8, 4> code { 0, 0, 1, 0 };
+    const Array<u8, 1> input { 0b10 };
+
+    const auto huffman = Compress::CanonicalCode::from_bytes(code).value();
+    auto memory_stream = InputMemoryStream { input };
+    auto bit_stream = InputBitStream { memory_stream };
+
+    EXPECT_EQ(huffman.read_symbol(bit_stream), 2u);
+    // The only code is a single zero bit, so a one bit isn't a valid code.
+    EXPECT_EQ(huffman.read_symbol(bit_stream), UINT32_MAX);
+}
+
 TEST_CASE(deflate_decompress_compressed_block)
 {
     const Array<u8, 28> compressed {
@@ -147,6 +189,26 @@ TEST_CASE(deflate_round_trip_compress_large)
     EXPECT(uncompressed.value() == original);
 }
 
+TEST_CASE(deflate_round_trip_repetitive_large)
+{
+    // Lots of back references, which overlap themselves and wrap around the end of the window.
+    auto original = ByteBuffer::create_uninitialized(256 * KiB).release_value();
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "abcab"[i % 5] + (i / 1000) % 7;
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::GOOD);
+    EXPECT(compressed.has_value());
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(deflate_decompress_back_reference_too_far_back)
+{
+    // A fixed block with a length 3 back reference at distance 1, before there's any output.
+    const Array<u8, 3> compressed { 0x03, 0x02, 0x00 };
+    EXPECT(!Compress::DeflateDecompressor::decompress_all(compressed).has_value());
+}
+
 TEST_CASE(deflate_compress_literals)
 {
     // This byte array is known to not produce any back references with our lz77 implementation even at the highest compression settings
@@ -154,3 +216,56 @@ TEST_CASE(deflate_compress_literals)
     auto compressed = Compress::DeflateCompressor::compress_all(test, Compress::DeflateCompressor::CompressionLevel::GOOD);
     EXPECT(compressed.has_value());
 }
+
+TEST_CASE(deflate_compress_without_final_block)
+{
+    // Two streams that don't end in a final block can be followed by one that does, and decompress as a whole.
+    Array<u8, 3000> original;
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = (i % 100) * (i / 1000);
+
+    DuplexMemoryStream output_stream;
+    for (size_t start = 0; start < original.size(); start += 1000) {
+        Compress::DeflateCompressor deflate_stream { output_stream };
+        deflate_stream.set_dictionary(original.span().trim(start));
+        deflate_stream.write_or_error(original.span().slice(start, 1000));
+        deflate_stream.final_flush(start + 1000 == original.size() ? Compress::DeflateCompressor::MarkFinalBlock::Yes : Compress::DeflateCompressor::MarkFinalBlock::No);
+    }
+
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(output_stream.copy_into_contiguous_buffer());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value().bytes() == original.span());
+}
+
+static ByteBuffer create_text_like_buffer(size_t size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(size).release_value();
+    constexpr StringView words[] = { "deflate "sv, "benchmark "sv, "the "sv, "of "sv, "compression "sv, "and "sv, "window "sv, "\n"sv };
+    size_t offset = 0;
+    for (size_t i = 0; offset < size; ++i) {
+        auto word = words[(i * 7 + i / 5) % array_size(words)];
+        auto length = min(word.length(), size - offset);
+        memcpy(buffer.data() + offset, word.characters_without_null_termination(), length);
+        offset += length;
+    }
+    return buffer;
+}
+
+BENCHMARK_CASE(deflate_compress_text)
+{
+    auto original = create_text_like_buffer(1 * MiB);
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::GOOD);
+    EXPECT(compressed.has_value());
+    Test::do_not_optimize(compressed);
+}
+
+BENCHMARK_CASE(deflate_decompress_text)
+{
+    auto original = create_text_like_buffer(1 * MiB);
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST).release_value();
+    for (int i = 0; i < 10; ++i) {
+        auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed);
+        EXPECT(uncompressed.has_value());
+        Test::do_not_optimize(uncompressed);
+    }
+}
@@ -7,6 +7,7 @@
 #include <LibTest/TestCase.h>
 
 #include <AK/Array.h>
+#include <AK/MemoryStream.h>
 #include <AK/Random.h>
 #include <LibCompress/Gzip.h>
 
@@ -95,3 +96,55 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.has_value());
     EXPECT(uncompressed.value() == original);
 }
+
+TEST_CASE(gzip_parallel_round_trip)
+{
+    // Text that repeats across chunks, so that back references into the previous chunk are worth it, followed by random bytes.
+    auto original = ByteBuffer::create_uninitialized(5 * Compress::DeflateCompressor::parallel_chunk_size + 1000).release_value();
+    auto random_start = Compress::DeflateCompressor::parallel_chunk_size * 4;
+    for (size_t i = 0; i < random_start; ++i)
+        original[i] = "The quick brown fox jumps over the lazy dog. "[(i * 7 / 5) % 45];
+    fill_with_random(original.offset_pointer(random_start), original.size() - random_start);
+
+    auto compressed = Compress::GzipCompressor::parallel_compress_all(original, 4);
+    EXPECT(compressed.has_value());
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+
+    // Compressing in chunks mustn't cost much compared to compressing all at once.
+    auto compressed_all_at_once = Compress::GzipCompressor::compress_all(original);
+    EXPECT(compressed.value().size() <= compressed_all_at_once.value().size() + 1024);
+}
+
+TEST_CASE(gzip_parallel_streaming_round_trip)
+{
+    auto original = ByteBuffer::create_uninitialized(20 * Compress::DeflateCompressor::parallel_chunk_size + 1000).release_value();
+    for (size_t i = 0; i < original.size(); ++i)
+        original[i] = "The quick brown fox jumps over the lazy dog. "[(i * 7 / 5) % 45];
+    fill_with_random(original.offset_pointer(original.size() / 2), 4096);
+
+    DuplexMemoryStream output_stream;
+    Compress::ParallelGzipCompressor gzip_stream { output_stream };
+    // Writes of odd sizes, so that they straddle chunks and batches.
+    for (size_t offset = 0; offset < original.size(); offset += 12345)
+        EXPECT(gzip_stream.write_or_error(original.bytes().slice(offset, min<size_t>(12345, original.size() - offset))));
+    gzip_stream.finish();
+    EXPECT(!gzip_stream.handle_any_error());
+
+    auto compressed = output_stream.copy_into_contiguous_buffer();
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed);
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(gzip_parallel_streaming_empty)
+{
+    DuplexMemoryStream output_stream;
+    Compress::ParallelGzipCompressor gzip_stream { output_stream };
+    gzip_stream.finish();
+
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(output_stream.copy_into_contiguous_buffer());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value().is_empty());
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
+#include <LibTest/TestCase.h>
+#include <unistd.h>
+
+static ByteBuffer read_whole_file(StringView path)
+{
+    auto file = Core::Stream::File::open(path, Core::Stream::OpenMode::Read).release_value();
+    auto buffer = ByteBuffer::create_uninitialized(file->size().release_value()).release_value();
+    EXPECT(file->read_or_error(buffer));
+    return buffer;
+}
+
+TEST_CASE(map_with_access_pattern)
+{
+    auto expected = read_whole_file("/usr/Tests/LibCore/10kb.txt"sv);
+
+    for (auto access_pattern : { Core::MappedFile::AccessPattern::Normal, Core::MappedFile::AccessPattern::Sequential, Core::MappedFile::AccessPattern::Random }) {
+        auto maybe_file = Core::MappedFile::map("/usr/Tests/LibCore/10kb.txt", access_pattern);
+        EXPECT(!maybe_file.is_error());
+        auto file = maybe_file.release_value();
+        EXPECT_EQ(file->bytes(), expected.bytes());
+    }
+}
+
+TEST_CASE(will_need_and_dont_need)
+{
+    auto expected = read_whole_file("/usr/Tests/LibCore/10kb.txt"sv);
+    auto file = Core::MappedFile::map("/usr/Tests/LibCore/10kb.txt").release_value();
+
+    EXPECT(!file->will_need(0, file->size()).is_error());
+    // Offsets don't have to be page-aligned.
+    EXPECT(!file->will_need(1234, 4321).is_error());
+    EXPECT(!file->dont_need(100, file->size() - 100).is_error());
+    EXPECT(!file->dont_need(0, 0).is_error());
+
+    // Anything past the end of the file is an error.
+    EXPECT_EQ(file->will_need(file->size(), 1).error().code(), EINVAL);
+    EXPECT_EQ(file->dont_need(1, file->size()).error().code(), EINVAL);
+
+    // Pages that were given up are read in again.
+    EXPECT_EQ(file->bytes(), expected.bytes());
+}
+
+TEST_CASE(mapped_file_window)
+{
+    auto expected = read_whole_file("/usr/Tests/LibCore/10kb.txt"sv);
+
+    auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto maybe_file = Core::MappedFileWindow::open("/usr/Tests/LibCore/10kb.txt", page_size);
+    EXPECT(!maybe_file.is_error());
+    auto file = maybe_file.release_value();
+    EXPECT_EQ(file->size(), expected.size());
+
+    ByteBuffer contents;
+    size_t window_count = 0;
+    for (size_t offset = 0; offset < file->size();) {
+        auto bytes = file->bytes_at(offset).release_value();
+        EXPECT(!bytes.is_empty());
+        EXPECT(bytes.size() <= page_size);
+        contents.append(bytes);
+        offset += bytes.size();
+        ++window_count;
+    }
+    EXPECT_EQ(contents.bytes(), expected.bytes());
+    EXPECT_EQ(window_count, ceil_div(expected.size(), page_size));
+
+    // Going back to an earlier window, and into the middle of it, works too.
+    auto bytes = file->bytes_at(10).release_value();
+    EXPECT_EQ(bytes.size(), min(page_size, expected.size()) - 10);
+    EXPECT_EQ(bytes, expected.bytes().slice(10, bytes.size()));
+
+    EXPECT(file->bytes_at(file->size()).release_value().is_empty());
+    EXPECT_EQ(file->bytes_at(file->size() + 1).error().code(), EINVAL);
+
+    // Window sizes are rounded up to whole pages.
+    auto small_window_file = Core::MappedFileWindow::open("/usr/Tests/LibCore/10kb.txt", 1).release_value();
+    EXPECT_EQ(small_window_file->bytes_at(0).release_value().size(), min(page_size, expected.size()));
+}
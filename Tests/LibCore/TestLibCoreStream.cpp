@@ -147,6 +147,27 @@ TEST_CASE(file_truncate)
     EXPECT_EQ(file->size().release_value(), 42);
 }
 
+TEST_CASE(file_write_entire_buffers)
+{
+    auto maybe_file = Core::Stream::File::open("/tmp/file-write-entire-buffers-test.txt", Core::Stream::OpenMode::ReadWrite | Core::Stream::OpenMode::Truncate);
+    EXPECT(!maybe_file.is_error());
+    auto file = maybe_file.release_value();
+
+    Array<ReadonlyBytes, 4> buffers {
+        "Well "sv.bytes(),
+        ReadonlyBytes {},
+        "hello "sv.bytes(),
+        "friends!"sv.bytes(),
+    };
+    EXPECT(!file->write_entire_buffers(buffers).is_error());
+    EXPECT_EQ(file->size().release_value(), 19);
+
+    auto buffer = ByteBuffer::create_uninitialized(19).release_value();
+    EXPECT(!file->seek(0, Core::Stream::SeekMode::SetPosition).is_error());
+    EXPECT(file->read_or_error(buffer));
+    EXPECT_EQ(StringView { buffer.bytes() }, "Well hello friends!"sv);
+}
+
 // TCPSocket tests
 
 TEST_CASE(should_error_when_connection_fails)
@@ -506,3 +527,88 @@ TEST_CASE(buffered_tcp_socket_read)
     StringView second_received_line { receive_buffer.data(), maybe_second_nread.value() };
     EXPECT_EQ(second_received_line, second_line);
 }
+
+// Buffered writer tests
+
+TEST_CASE(buffered_writer_small_writes)
+{
+    auto maybe_file = Core::Stream::File::open("/tmp/buffered-writer-small-writes-test.txt", Core::Stream::OpenMode::ReadWrite | Core::Stream::OpenMode::Truncate);
+    EXPECT(!maybe_file.is_error());
+    auto maybe_writer = Core::Stream::BufferedWriter<Core::Stream::File>::create(maybe_file.release_value(), 64);
+    EXPECT(!maybe_writer.is_error());
+    auto writer = maybe_writer.release_value();
+
+    StringBuilder expected;
+    for (size_t i = 0; i < 100; ++i) {
+        auto line = String::formatted("Line {}\n", i);
+        EXPECT(!writer->write_entire_buffer(line.bytes()).is_error());
+        expected.append(line);
+        // Nothing goes to the file until the buffer fills up.
+        EXPECT(writer->buffered_data_size() <= writer->buffer_size());
+    }
+
+    EXPECT(!writer->flush().is_error());
+    EXPECT_EQ(writer->buffered_data_size(), 0ul);
+
+    auto& file = writer->stream();
+    EXPECT_EQ(file.size().release_value(), static_cast<off_t>(expected.length()));
+    auto buffer = ByteBuffer::create_uninitialized(expected.length()).release_value();
+    EXPECT(!file.seek(0, Core::Stream::SeekMode::SetPosition).is_error());
+    EXPECT(file.read_or_error(buffer));
+    EXPECT_EQ(StringView { buffer.bytes() }, expected.string_view());
+}
+
+TEST_CASE(buffered_writer_large_writes)
+{
+    auto maybe_file = Core::Stream::File::open("/tmp/buffered-writer-large-writes-test.txt", Core::Stream::OpenMode::ReadWrite | Core::Stream::OpenMode::Truncate);
+    EXPECT(!maybe_file.is_error());
+    auto maybe_writer = Core::Stream::BufferedWriter<Core::Stream::File>::create(maybe_file.release_value(), 64);
+    EXPECT(!maybe_writer.is_error());
+    auto writer = maybe_writer.release_value();
+
+    auto large_data = ByteBuffer::create_uninitialized(1000).release_value();
+    for (size_t i = 0; i < large_data.size(); ++i)
+        large_data[i] = 'a' + i % 26;
+
+    // Writes that don't fit go out right away, along with whatever was buffered before them.
+    EXPECT(!writer->write_entire_buffer("Start:"sv.bytes()).is_error());
+    EXPECT_EQ(writer->buffered_data_size(), 6ul);
+    EXPECT(!writer->write_entire_buffer(large_data).is_error());
+    EXPECT_EQ(writer->buffered_data_size(), 0ul);
+    EXPECT_EQ(writer->stream().size().release_value(), 1006);
+
+    Array<ReadonlyBytes, 3> buffers { ":"sv.bytes(), large_data.bytes(), ":End"sv.bytes() };
+    EXPECT(!writer->write_entire_buffers(buffers).is_error());
+    writer->close();
+
+    auto maybe_reopened_file = Core::Stream::File::open("/tmp/buffered-writer-large-writes-test.txt", Core::Stream::OpenMode::Read);
+    EXPECT(!maybe_reopened_file.is_error());
+    auto file = maybe_reopened_file.release_value();
+    EXPECT_EQ(file->size().release_value(), 2011);
+
+    StringBuilder expected;
+    expected.append("Start:"sv);
+    expected.append(StringView { large_data.bytes() });
+    expected.append(':');
+    expected.append(StringView { large_data.bytes() });
+    expected.append(":End"sv);
+    auto buffer = ByteBuffer::create_uninitialized(expected.length()).release_value();
+    EXPECT(file->read_or_error(buffer));
+    EXPECT_EQ(StringView { buffer.bytes() }, expected.string_view());
+}
+
+TEST_CASE(buffered_writer_flushes_before_reading)
+{
+    auto maybe_file = Core::Stream::File::open("/tmp/buffered-writer-read-test.txt", Core::Stream::OpenMode::ReadWrite | Core::Stream::OpenMode::Truncate);
+    EXPECT(!maybe_file.is_error());
+    auto writer = Core::Stream::BufferedWriter<Core::Stream::File>::create(maybe_file.release_value()).release_value();
+
+    EXPECT(!writer->write_entire_buffer("Well hello friends!"sv.bytes()).is_error());
+    EXPECT_EQ(writer->buffered_data_size(), 19ul);
+
+    // Reading at the end of the file gives nothing back, but the buffer has to be written out first.
+    auto buffer = ByteBuffer::create_uninitialized(4).release_value();
+    EXPECT_EQ(writer->read(buffer).release_value(), 0ul);
+    EXPECT_EQ(writer->buffered_data_size(), 0ul);
+    EXPECT_EQ(writer->stream().size().release_value(), 19);
+}
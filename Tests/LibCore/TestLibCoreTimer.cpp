@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Timer.h>
+#include <LibTest/TestCase.h>
+
+TEST_CASE(timers_fire_in_order)
+{
+    Core::EventLoop event_loop;
+    Vector<int> fired;
+    Vector<NonnullRefPtr<Core::Timer>> timers;
+    for (int interval : { 30, 10, 50, 20, 40 }) {
+        timers.append(Core::Timer::create_single_shot(interval, [&, interval] {
+            fired.append(interval);
+            if (fired.size() == 5)
+                event_loop.quit(0);
+        }));
+        timers.last()->start();
+    }
+
+    event_loop.exec();
+    EXPECT_EQ(fired, (Vector<int> { 10, 20, 30, 40, 50 }));
+}
+
+TEST_CASE(stopped_timer_does_not_fire)
+{
+    Core::EventLoop event_loop;
+    bool stopped_timer_fired = false;
+    auto stopped_timer = Core::Timer::create_single_shot(10, [&] { stopped_timer_fired = true; });
+    auto quit_timer = Core::Timer::create_single_shot(50, [&] { event_loop.quit(0); });
+    stopped_timer->start();
+    quit_timer->start();
+    // Stop the timer while it sits in the middle of the queue.
+    auto other_timer = Core::Timer::create_single_shot(20, [] {});
+    other_timer->start();
+    stopped_timer->stop();
+
+    event_loop.exec();
+    EXPECT(!stopped_timer_fired);
+}
+
+TEST_CASE(repeating_timer_with_slack)
+{
+    Core::EventLoop event_loop;
+    int fire_count = 0;
+    auto start_time = Time::now_monotonic();
+    auto timer = Core::Timer::create_repeating(5, [&] {
+        if (++fire_count == 3)
+            event_loop.quit(0);
+    });
+    timer->set_slack(20);
+    timer->start();
+
+    event_loop.exec();
+    EXPECT_EQ(fire_count, 3);
+    // The slack may delay the timer, but never make it fire early.
+    EXPECT((Time::now_monotonic() - start_time).to_milliseconds() >= 15);
+    EXPECT_EQ(event_loop.statistics().fired_timers, 3u);
+}
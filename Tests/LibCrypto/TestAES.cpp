@@ -454,3 +454,91 @@ TEST_CASE(test_AES_GCM_128bit_decrypt_multiple_blocks_with_aad)
     EXPECT(memcmp(result_pt, out.data(), out.size()) == 0);
     EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
 }
+
+static ByteBuffer make_test_data(size_t size)
+{
+    auto data = ByteBuffer::create_uninitialized(size).release_value();
+    for (size_t i = 0; i < size; ++i)
+        data[i] = static_cast<u8>(i * 7 + 3);
+    return data;
+}
+
+TEST_CASE(test_AES_CTR_many_blocks_match_single_blocks)
+{
+    // A counter that carries over into its upper half partway through.
+    u8 ivec[] {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xfe
+    };
+    auto in = make_test_data(1000);
+
+    Crypto::Cipher::AESCipher::CTRMode cipher("WellHelloFriendsWellHelloFriends"_b, 256, Crypto::Cipher::Intent::Encryption);
+    auto out = ByteBuffer::create_zeroed(in.size()).release_value();
+    auto out_span = out.bytes();
+    cipher.encrypt(in, out_span, AS_BB(ivec));
+
+    auto expected = ByteBuffer::create_zeroed(in.size()).release_value();
+    auto counter = ByteBuffer::copy(AS_BB(ivec)).release_value();
+    auto counter_span = counter.bytes();
+    Crypto::Cipher::AESCipher aes("WellHelloFriendsWellHelloFriends"_b, 256, Crypto::Cipher::Intent::Encryption);
+    for (size_t offset = 0; offset < in.size(); offset += 16) {
+        Crypto::Cipher::AESCipherBlock block { counter.data(), counter.size() };
+        aes.encrypt_block(block, block);
+        for (size_t i = 0; i < 16 && offset + i < in.size(); ++i)
+            expected[offset + i] = in[offset + i] ^ block.bytes()[i];
+        Crypto::Cipher::IncrementInplace {}(counter_span);
+    }
+
+    EXPECT(out.bytes() == expected.bytes());
+}
+
+TEST_CASE(test_AES_CBC_many_blocks_round_trip)
+{
+    auto in = make_test_data(1000);
+    auto iv = ByteBuffer::copy("Initialisation V"_b).release_value();
+
+    Crypto::Cipher::AESCipher::CBCMode encryptor("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    auto encrypted = encryptor.create_aligned_buffer(in.size()).release_value();
+    auto encrypted_span = encrypted.bytes();
+    encryptor.encrypt(in, encrypted_span, iv);
+
+    Crypto::Cipher::AESCipher::CBCMode decryptor("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Decryption);
+    auto decrypted = decryptor.create_aligned_buffer(encrypted_span.size()).release_value();
+    auto decrypted_span = decrypted.bytes();
+    decryptor.decrypt(encrypted_span, decrypted_span, iv);
+
+    EXPECT(decrypted_span == in.bytes());
+}
+
+BENCHMARK_CASE(aes_ctr_128bit_encrypt_1MiB)
+{
+    auto in = make_test_data(1 * MiB);
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    Crypto::Cipher::AESCipher::CTRMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    for (size_t i = 0; i < 16; ++i) {
+        auto out_span = out.bytes();
+        cipher.encrypt(in, out_span, "\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01"_b);
+    }
+}
+
+BENCHMARK_CASE(aes_cbc_256bit_decrypt_1MiB)
+{
+    auto in = make_test_data(1 * MiB);
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    Crypto::Cipher::AESCipher::CBCMode cipher("WellHelloFriendsWellHelloFriends"_b, 256, Crypto::Cipher::Intent::Decryption);
+    for (size_t i = 0; i < 16; ++i) {
+        auto out_span = out.bytes();
+        cipher.decrypt(in, out_span, "Initialisation V"_b);
+    }
+}
+
+BENCHMARK_CASE(aes_gcm_128bit_encrypt_1MiB)
+{
+    auto in = make_test_data(1 * MiB);
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    auto tag = ByteBuffer::create_uninitialized(16).release_value();
+    Crypto::Cipher::AESCipher::GCMMode cipher("WellHelloFriends"_b, 128, Crypto::Cipher::Intent::Encryption);
+    for (size_t i = 0; i < 16; ++i) {
+        auto out_span = out.bytes();
+        cipher.encrypt(in, out_span, "\xca\xfe\xba\xbe\xfa\xce\xdb\xad\xde\xca\xf8\x88\x00\x00\x00\x00"_b, "\xde\xad\xbe\xef\xfa\xaf\x11\xcc"_b, tag);
+    }
+}
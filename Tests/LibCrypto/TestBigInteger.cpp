@@ -232,6 +232,51 @@ TEST_CASE(test_unsigned_bigint_division_combined_test)
     EXPECT_EQ(div_result.quotient.multiplied_by(num2).plus(div_result.remainder), num1);
 }
 
+TEST_CASE(test_unsigned_bigint_karatsuba_multiplication)
+{
+    // Large enough for Karatsuba multiplication, of different sizes so that the longer one is split up.
+    auto num1 = bigint_fibonacci(3000);
+    auto num2 = bigint_fibonacci(5000);
+    struct {
+        Crypto::UnsignedBigInteger left;
+        Crypto::UnsignedBigInteger right;
+    } multiplication_tests[] = {
+        { num1, num1 },
+        { num1, num2 },
+        { num2, num1 },
+        { num2, num2 },
+    };
+
+    for (auto& test_case : multiplication_tests) {
+        // Compare against multiplying by one word at a time.
+        Crypto::UnsignedBigInteger expected_result;
+        for (size_t i = 0; i < test_case.right.length(); ++i)
+            expected_result = expected_result.plus(test_case.left.multiplied_by(test_case.right.words()[i]).shift_left(i * Crypto::UnsignedBigInteger::BITS_IN_WORD));
+        EXPECT_EQ(test_case.left.multiplied_by(test_case.right), expected_result);
+    }
+}
+
+TEST_CASE(test_unsigned_bigint_division_with_big_numbers_after_multiplication)
+{
+    auto num1 = bigint_fibonacci(3000);
+    auto num2 = bigint_fibonacci(5000);
+    auto num3 = bigint_fibonacci(100);
+    auto result = num2.multiplied_by(num1).plus(num3).divided_by(num1);
+    EXPECT_EQ(result.quotient, num2);
+    EXPECT_EQ(result.remainder, num3);
+}
+
+TEST_CASE(test_unsigned_bigint_division_with_quotient_word_guessed_too_large)
+{
+    // The first guess of the quotient is one too large, which is only found out after subtracting.
+    Crypto::UnsignedBigInteger num1(Vector<u32, Crypto::STARTING_WORD_SIZE> { 0, 0, 0x80000000, 0x7fffffff });
+    Crypto::UnsignedBigInteger num2(Vector<u32, Crypto::STARTING_WORD_SIZE> { 1, 0, 0x80000000 });
+    auto result = num1.divided_by(num2);
+    EXPECT_EQ(result.quotient, Crypto::UnsignedBigInteger(0xfffffffe));
+    EXPECT_EQ(result.remainder, Crypto::UnsignedBigInteger(Vector<u32, Crypto::STARTING_WORD_SIZE> { 2, 0xffffffff, 0x7fffffff }));
+    EXPECT_EQ(result.quotient.multiplied_by(num2).plus(result.remainder), num1);
+}
+
 TEST_CASE(test_unsigned_bigint_base10_from_string)
 {
     auto result = Crypto::UnsignedBigInteger::from_base(10, "57195071295721390579057195715793");
@@ -330,6 +375,28 @@ TEST_CASE(test_bigint_modular_power_extra_tests)
     }
 }
 
+static Crypto::UnsignedBigInteger mersenne_prime_2203()
+{
+    return Crypto::UnsignedBigInteger(1).shift_left(2203).minus(1);
+}
+
+TEST_CASE(test_bigint_large_modular_power_fermat)
+{
+    // a^(p - 1) = 1 (mod p) for any prime p, here a Mersenne prime with a few more bits than a 2048-bit RSA modulus.
+    auto prime = mersenne_prime_2203();
+    auto exponent = prime.minus(1);
+    for (Crypto::UnsignedBigInteger::Word base : { 2, 3, 65537 })
+        EXPECT_EQ(Crypto::NumberTheory::ModularPower(base, exponent, prime), 1);
+}
+
+BENCHMARK_CASE(benchmark_bigint_large_modular_power)
+{
+    auto prime = mersenne_prime_2203();
+    auto base = bigint_fibonacci(3000);
+    for (size_t i = 0; i < 10; ++i)
+        EXPECT_EQ(Crypto::NumberTheory::ModularPower(base, prime.minus(1), prime), 1);
+}
+
 TEST_CASE(test_bigint_primality_test)
 {
     struct {
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <LibCrypto/Authentication/Poly1305.h>
+#include <LibCrypto/Cipher/ChaCha20.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
+#include <LibTest/TestCase.h>
+#include <cstring>
+
+static ReadonlyBytes operator""_b(const char* string, size_t length)
+{
+    return ReadonlyBytes(string, length);
+}
+
+static auto const sunscreen = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip for the future, sunscreen would be it."_b;
+
+// RFC 8439 section 2.4.2
+TEST_CASE(test_ChaCha20_encrypt)
+{
+    u8 key[32];
+    for (size_t i = 0; i < sizeof(key); ++i)
+        key[i] = i;
+    u8 nonce[] { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a, 0x00, 0x00, 0x00, 0x00 };
+    u8 result[] {
+        0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81,
+        0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b,
+        0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+        0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8,
+        0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e,
+        0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+        0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42,
+        0x87, 0x4d
+    };
+
+    // Feeding it the input in pieces must not make a difference.
+    auto out = ByteBuffer::create_zeroed(sunscreen.size()).release_value();
+    Crypto::Cipher::ChaCha20 chacha({ key, sizeof(key) }, { nonce, sizeof(nonce) }, 1);
+    chacha.process(sunscreen.trim(10), out.bytes());
+    chacha.process(sunscreen.slice(10, 70), out.bytes().slice(10));
+    chacha.process(sunscreen.slice(80), out.bytes().slice(80));
+    EXPECT_EQ(out.size(), sizeof(result));
+    EXPECT(memcmp(result, out.data(), sizeof(result)) == 0);
+}
+
+// RFC 8439 section 2.5.2
+TEST_CASE(test_Poly1305_tag)
+{
+    u8 key[] {
+        0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8,
+        0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b
+    };
+    u8 result[] { 0xa8, 0x06, 0x1d, 0xc1, 0x30, 0x51, 0x36, 0xc6, 0xc2, 0x2b, 0x8b, 0xaf, 0x0c, 0x01, 0x27, 0xa9 };
+    Crypto::Authentication::Poly1305 poly1305({ key, sizeof(key) });
+    poly1305.update("Cryptographic Forum"_b);
+    poly1305.update(" Research Group"_b);
+    auto tag = poly1305.digest();
+    EXPECT(memcmp(result, tag.data(), sizeof(result)) == 0);
+}
+
+// RFC 8439 appendix A.3, test vector 6: h ends up just above 2^130 - 5.
+TEST_CASE(test_Poly1305_tag_with_final_reduction)
+{
+    u8 key[32] {};
+    key[0] = 2;
+    u8 message[16];
+    memset(message, 0xff, sizeof(message));
+    u8 result[16] { 0x03 };
+    Crypto::Authentication::Poly1305 poly1305({ key, sizeof(key) });
+    poly1305.update({ message, sizeof(message) });
+    auto tag = poly1305.digest();
+    EXPECT(memcmp(result, tag.data(), sizeof(result)) == 0);
+}
+
+TEST_CASE(test_Poly1305_tag_with_all_bits_set)
+{
+    u8 key[32];
+    memset(key, 0xff, sizeof(key));
+    u8 message[100];
+    memset(message, 0xff, sizeof(message));
+    u8 result[] { 0xb9, 0x9c, 0x03, 0x0d, 0x7c, 0xe9, 0x39, 0xbb, 0x66, 0x07, 0x39, 0x3e, 0x68, 0x65, 0x6f, 0x22 };
+    Crypto::Authentication::Poly1305 poly1305({ key, sizeof(key) });
+    poly1305.update({ message, sizeof(message) });
+    auto tag = poly1305.digest();
+    EXPECT(memcmp(result, tag.data(), sizeof(result)) == 0);
+}
+
+// RFC 8439 section 2.8.2
+static u8 aead_key[32] {
+    0x80, 0x81, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8a, 0x8b, 0x8c, 0x8d, 0x8e, 0x8f,
+    0x90, 0x91, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9a, 0x9b, 0x9c, 0x9d, 0x9e, 0x9f
+};
+static u8 aead_nonce[12] { 0x07, 0x00, 0x00, 0x00, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47 };
+static u8 aead_aad[12] { 0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7 };
+static u8 aead_ciphertext[114] {
+    0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb, 0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2,
+    0xa4, 0xad, 0xed, 0x51, 0x29, 0x6e, 0x08, 0xfe, 0xa9, 0xe2, 0xb5, 0xa7, 0x36, 0xee, 0x62, 0xd6,
+    0x3d, 0xbe, 0xa4, 0x5e, 0x8c, 0xa9, 0x67, 0x12, 0x82, 0xfa, 0xfb, 0x69, 0xda, 0x92, 0x72, 0x8b,
+    0x1a, 0x71, 0xde, 0x0a, 0x9e, 0x06, 0x0b, 0x29, 0x05, 0xd6, 0xa5, 0xb6, 0x7e, 0xcd, 0x3b, 0x36,
+    0x92, 0xdd, 0xbd, 0x7f, 0x2d, 0x77, 0x8b, 0x8c, 0x98, 0x03, 0xae, 0xe3, 0x28, 0x09, 0x1b, 0x58,
+    0xfa, 0xb3, 0x24, 0xe4, 0xfa, 0xd6, 0x75, 0x94, 0x55, 0x85, 0x80, 0x8b, 0x48, 0x31, 0xd7, 0xbc,
+    0x3f, 0xf4, 0xde, 0xf0, 0x8e, 0x4b, 0x7a, 0x9d, 0xe5, 0x76, 0xd2, 0x65, 0x86, 0xce, 0xc6, 0x4b,
+    0x61, 0x16
+};
+static u8 aead_tag[16] { 0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a, 0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91 };
+
+TEST_CASE(test_ChaCha20Poly1305_encrypt)
+{
+    Crypto::Cipher::ChaCha20Poly1305 aead({ aead_key, sizeof(aead_key) });
+    auto out = ByteBuffer::create_zeroed(sunscreen.size()).release_value();
+    u8 tag[16];
+    aead.encrypt(sunscreen, out, { aead_nonce, sizeof(aead_nonce) }, { aead_aad, sizeof(aead_aad) }, { tag, sizeof(tag) });
+    EXPECT(memcmp(aead_ciphertext, out.data(), sizeof(aead_ciphertext)) == 0);
+    EXPECT(memcmp(aead_tag, tag, sizeof(aead_tag)) == 0);
+}
+
+TEST_CASE(test_ChaCha20Poly1305_decrypt)
+{
+    Crypto::Cipher::ChaCha20Poly1305 aead({ aead_key, sizeof(aead_key) });
+    auto out = ByteBuffer::create_zeroed(sizeof(aead_ciphertext)).release_value();
+    auto consistency = aead.decrypt({ aead_ciphertext, sizeof(aead_ciphertext) }, out, { aead_nonce, sizeof(aead_nonce) }, { aead_aad, sizeof(aead_aad) }, { aead_tag, sizeof(aead_tag) });
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Consistent);
+    EXPECT(out.bytes() == sunscreen);
+}
+
+TEST_CASE(test_ChaCha20Poly1305_decrypt_with_wrong_aad)
+{
+    Crypto::Cipher::ChaCha20Poly1305 aead({ aead_key, sizeof(aead_key) });
+    auto out = ByteBuffer::create_zeroed(sizeof(aead_ciphertext)).release_value();
+    auto consistency = aead.decrypt({ aead_ciphertext, sizeof(aead_ciphertext) }, out, { aead_nonce, sizeof(aead_nonce) }, { aead_aad, sizeof(aead_aad) - 1 }, { aead_tag, sizeof(aead_tag) });
+    EXPECT_EQ(consistency, Crypto::VerificationConsistency::Inconsistent);
+}
+
+BENCHMARK_CASE(chacha20_poly1305_encrypt_1MiB)
+{
+    auto in = ByteBuffer::create_zeroed(1 * MiB).release_value();
+    auto out = ByteBuffer::create_uninitialized(in.size()).release_value();
+    u8 tag[16];
+    Crypto::Cipher::ChaCha20Poly1305 aead({ aead_key, sizeof(aead_key) });
+    for (size_t i = 0; i < 16; ++i)
+        aead.encrypt(in, out, { aead_nonce, sizeof(aead_nonce) }, { aead_aad, sizeof(aead_aad) }, { tag, sizeof(tag) });
+}
@@ -4,6 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Random.h>
 #include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibTest/TestCase.h>
@@ -33,3 +36,111 @@ TEST_CASE(test_crc32)
     do_test(String("The quick brown fox jumps over the lazy dog").bytes(), 0x414FA339);
     do_test(String("various CRC algorithms input data").bytes(), 0x9BD366AE);
 }
+
+// The long input tests check against known digests, so their input has to be the same every time.
+static ByteBuffer make_xorshift_bytes(size_t size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(size).release_value();
+    u32 state = 2463534242;
+    for (size_t i = 0; i < size; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        buffer[i] = static_cast<u8>(state);
+    }
+    return buffer;
+}
+
+static ByteBuffer make_random_bytes(size_t size)
+{
+    auto buffer = ByteBuffer::create_uninitialized(size).release_value();
+    fill_with_random(buffer.data(), size);
+    return buffer;
+}
+
+static u32 adler32_a_byte_at_a_time(ReadonlyBytes input)
+{
+    u32 a = 1, b = 0;
+    for (auto byte : input) {
+        a = (a + byte) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+static u32 crc32_a_bit_at_a_time(ReadonlyBytes input)
+{
+    u32 state = ~0u;
+    for (auto byte : input) {
+        state ^= byte;
+        for (auto i = 0; i < 8; ++i)
+            state = (state >> 1) ^ ((state & 1) ? 0xEDB88320 : 0);
+    }
+    return ~state;
+}
+
+TEST_CASE(test_adler32_long_input)
+{
+    auto input = make_xorshift_bytes(100000);
+    EXPECT_EQ(Crypto::Checksum::Adler32(input).digest(), 0x66f35868u);
+
+    // All bytes being 0xff makes the sums grow as fast as they can between reductions.
+    auto all_ones = ByteBuffer::create_uninitialized(1 * MiB).release_value();
+    all_ones.bytes().fill(0xff);
+    EXPECT_EQ(Crypto::Checksum::Adler32(all_ones).digest(), 0x8e88ef11u);
+}
+
+TEST_CASE(test_crc32_long_input)
+{
+    auto input = make_xorshift_bytes(100000);
+    EXPECT_EQ(Crypto::Checksum::CRC32(input).digest(), 0x41e61cd9u);
+
+    auto all_ones = ByteBuffer::create_uninitialized(1 * MiB).release_value();
+    all_ones.bytes().fill(0xff);
+    EXPECT_EQ(Crypto::Checksum::CRC32(all_ones).digest(), 0x956bac74u);
+}
+
+// Every length and alignment around the block sizes of the faster code paths, which have to agree with the simplest one.
+TEST_CASE(test_checksums_of_every_length_and_alignment)
+{
+    auto input = make_random_bytes(600);
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t length = 0; offset + length <= input.size(); ++length) {
+            auto bytes = input.bytes().slice(offset, length);
+            EXPECT_EQ(Crypto::Checksum::Adler32(bytes).digest(), adler32_a_byte_at_a_time(bytes));
+            EXPECT_EQ(Crypto::Checksum::CRC32(bytes).digest(), crc32_a_bit_at_a_time(bytes));
+        }
+    }
+}
+
+TEST_CASE(test_checksums_in_pieces)
+{
+    auto input = make_random_bytes(20000);
+    auto expected_adler32 = Crypto::Checksum::Adler32(input).digest();
+    auto expected_crc32 = Crypto::Checksum::CRC32(input).digest();
+    for (size_t piece_size : Array<size_t, 6> { 1, 7, 33, 100, 5552, 7000 }) {
+        Crypto::Checksum::Adler32 adler32;
+        Crypto::Checksum::CRC32 crc32;
+        for (size_t offset = 0; offset < input.size(); offset += piece_size) {
+            auto piece = input.bytes().slice(offset, min(piece_size, input.size() - offset));
+            adler32.update(piece);
+            crc32.update(piece);
+        }
+        EXPECT_EQ(adler32.digest(), expected_adler32);
+        EXPECT_EQ(crc32.digest(), expected_crc32);
+    }
+}
+
+BENCHMARK_CASE(benchmark_adler32)
+{
+    auto input = make_random_bytes(16 * MiB);
+    for (auto i = 0; i < 8; ++i)
+        (void)Crypto::Checksum::Adler32(input).digest();
+}
+
+BENCHMARK_CASE(benchmark_crc32)
+{
+    auto input = make_random_bytes(16 * MiB);
+    for (auto i = 0; i < 8; ++i)
+        (void)Crypto::Checksum::CRC32(input).digest();
+}
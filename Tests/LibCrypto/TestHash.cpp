@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <LibCrypto/Authentication/GHash.h>
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/Hash/MD5.h>
@@ -142,6 +143,40 @@ TEST_CASE(test_SHA1_hash_successive_updates)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
 }
 
+// Feeds the hash a million 'a's in pieces of different sizes, some of them smaller than a block and some bigger.
+template<typename HashType>
+static typename HashType::DigestType hash_a_million_as()
+{
+    auto data = ByteBuffer::create_uninitialized(1000000).release_value();
+    data.bytes().fill('a');
+    HashType hasher;
+    size_t offset = 0;
+    for (size_t piece = 1; offset < data.size(); piece = piece * 3 + 1) {
+        auto size = min(piece % 1000, data.size() - offset);
+        hasher.update(data.data() + offset, size);
+        offset += size;
+    }
+    return hasher.digest();
+}
+
+TEST_CASE(test_SHA1_hash_two_blocks)
+{
+    u8 result[] {
+        0x84, 0x98, 0x3e, 0x44, 0x1c, 0x3b, 0xd2, 0x6e, 0xba, 0xae, 0x4a, 0xa1, 0xf9, 0x51, 0x29, 0xe5, 0xe5, 0x46, 0x70, 0xf1
+    };
+    auto digest = Crypto::Hash::SHA1::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA1_hash_a_million_as)
+{
+    u8 result[] {
+        0x34, 0xaa, 0x97, 0x3c, 0xd4, 0xc4, 0xda, 0xa4, 0xf6, 0x1e, 0xeb, 0x2b, 0xdb, 0xad, 0x27, 0x31, 0x65, 0x34, 0x01, 0x6f
+    };
+    auto digest = hash_a_million_as<Crypto::Hash::SHA1>();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA1::digest_size()) == 0);
+}
+
 TEST_CASE(test_SHA256_name)
 {
     Crypto::Hash::SHA256 sha;
@@ -166,6 +201,45 @@ TEST_CASE(test_SHA256_hash_empty_string)
     EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
 }
 
+TEST_CASE(test_SHA256_hash_two_blocks)
+{
+    u8 result[] {
+        0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+        0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1
+    };
+    auto digest = Crypto::Hash::SHA256::hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_a_million_as)
+{
+    u8 result[] {
+        0xcd, 0xc7, 0x6e, 0x5c, 0x99, 0x14, 0xfb, 0x92, 0x81, 0xa1, 0xc7, 0xe2, 0x84, 0xd7, 0x3e, 0x67,
+        0xf1, 0x80, 0x9a, 0x48, 0xa4, 0x97, 0x20, 0x0e, 0x04, 0x6d, 0x39, 0xcc, 0xc7, 0x11, 0x2c, 0xd0
+    };
+    auto digest = hash_a_million_as<Crypto::Hash::SHA256>();
+    EXPECT(memcmp(result, digest.data, Crypto::Hash::SHA256::digest_size()) == 0);
+}
+
+TEST_CASE(test_SHA256_hash_many)
+{
+    // One message of every length up to a few blocks, so that the messages don't all end at once.
+    auto data = ByteBuffer::create_uninitialized(200).release_value();
+    for (size_t i = 0; i < data.size(); ++i)
+        data[i] = static_cast<u8>(i * 13 + 5);
+    Vector<ReadonlyBytes> messages;
+    for (size_t size = 0; size <= data.size(); ++size)
+        messages.append(data.bytes().trim(size));
+
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto expected = Crypto::Hash::SHA256::hash(messages[i].data(), messages[i].size());
+        EXPECT(memcmp(expected.data, digests[i].data, Crypto::Hash::SHA256::digest_size()) == 0);
+    }
+}
+
 TEST_CASE(test_SHA384_name)
 {
     Crypto::Hash::SHA384 sha;
@@ -230,3 +304,83 @@ TEST_CASE(test_ghash_galois_field_multiply2)
     Crypto::Authentication::galois_multiply(z, x, y);
     EXPECT(memcmp(result, z, 4 * sizeof(u32)) == 0);
 }
+
+// GHASH as described in NIST SP 800-38D, one block at a time.
+static void reference_ghash(u32 const (&key)[4], ReadonlyBytes aad, ReadonlyBytes cipher, u8 (&tag)[16])
+{
+    u32 y[4] { 0, 0, 0, 0 };
+    auto process = [&](ReadonlyBytes data) {
+        for (size_t offset = 0; offset < data.size(); offset += 16) {
+            u8 block[16] {};
+            memcpy(block, data.offset(offset), min<size_t>(16, data.size() - offset));
+            for (size_t i = 0; i < 4; ++i)
+                y[i] ^= AK::convert_between_host_and_big_endian(*reinterpret_cast<u32 const*>(block + i * 4));
+            u32 product[4];
+            Crypto::Authentication::galois_multiply(product, key, y);
+            memcpy(y, product, sizeof(y));
+        }
+    };
+    process(aad);
+    process(cipher);
+    u64 aad_bits = aad.size() * 8;
+    u64 cipher_bits = cipher.size() * 8;
+    y[0] ^= aad_bits >> 32;
+    y[1] ^= aad_bits & 0xffffffff;
+    y[2] ^= cipher_bits >> 32;
+    y[3] ^= cipher_bits & 0xffffffff;
+    u32 product[4];
+    Crypto::Authentication::galois_multiply(product, key, y);
+    for (size_t i = 0; i < 4; ++i) {
+        auto word = AK::convert_between_host_and_big_endian(product[i]);
+        memcpy(tag + i * 4, &word, 4);
+    }
+}
+
+TEST_CASE(test_ghash_matches_block_by_block_reference)
+{
+    u8 key[16] { 0x66, 0xe9, 0x4b, 0xd4, 0xef, 0x8a, 0x2c, 0x3b, 0x88, 0x4c, 0xfa, 0x59, 0xca, 0x34, 0x2b, 0x2e };
+    u32 key_words[4];
+    for (size_t i = 0; i < 4; ++i)
+        key_words[i] = AK::convert_between_host_and_big_endian(*reinterpret_cast<u32 const*>(key + i * 4));
+
+    u8 data[100];
+    for (size_t i = 0; i < sizeof(data); ++i)
+        data[i] = static_cast<u8>(i * 13 + 5);
+
+    Crypto::Authentication::GHash ghash({ key, sizeof(key) });
+    for (size_t aad_size : Array<size_t, 5> { 0, 1, 16, 20, 33 }) {
+        for (size_t cipher_size = 0; cipher_size + aad_size <= sizeof(data); cipher_size += 7) {
+            ReadonlyBytes aad { data, aad_size };
+            ReadonlyBytes cipher { data + aad_size, cipher_size };
+            u8 expected[16];
+            reference_ghash(key_words, aad, cipher, expected);
+            auto tag = ghash.process(aad, cipher);
+            EXPECT(memcmp(tag.data, expected, sizeof(expected)) == 0);
+        }
+    }
+}
+
+BENCHMARK_CASE(sha1_hash_16MiB)
+{
+    auto data = ByteBuffer::create_zeroed(16 * MiB).release_value();
+    auto digest = Crypto::Hash::SHA1::hash(data);
+    EXPECT(digest.data[0] != 0 || digest.data[1] != 0);
+}
+
+BENCHMARK_CASE(sha256_hash_16MiB)
+{
+    auto data = ByteBuffer::create_zeroed(16 * MiB).release_value();
+    auto digest = Crypto::Hash::SHA256::hash(data);
+    EXPECT(digest.data[0] != 0 || digest.data[1] != 0);
+}
+
+BENCHMARK_CASE(sha256_hash_many_4096_messages_of_4KiB)
+{
+    auto data = ByteBuffer::create_zeroed(16 * MiB).release_value();
+    Vector<ReadonlyBytes> messages;
+    for (size_t offset = 0; offset < data.size(); offset += 4 * KiB)
+        messages.append(data.bytes().slice(offset, 4 * KiB));
+    Vector<Crypto::Hash::SHA256::DigestType> digests;
+    digests.resize(messages.size());
+    Crypto::Hash::SHA256::hash_many(messages, digests);
+}
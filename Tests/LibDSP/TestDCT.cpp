@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/Math.h>
+#include <AK/Random.h>
+#include <LibDSP/DCT.h>
+#include <LibDSP/MDCT.h>
+
+template<size_t N>
+static Array<double, N> make_input()
+{
+    Array<double, N> input;
+    for (auto& value : input)
+        value = static_cast<double>(get_random<u32>()) / NumericLimits<u32>::max() * 2 - 1;
+    return input;
+}
+
+template<size_t N>
+static void expect_dct_matches_definition()
+{
+    auto input = make_input<N>();
+    auto output = input;
+    LibDSP::DCT<N> dct;
+    dct.transform(output);
+    for (size_t k = 0; k < N; k++) {
+        double expected = 0;
+        for (size_t n = 0; n < N; n++)
+            expected += input[n] * AK::cos(AK::Pi<double> / N * (n + 0.5) * k);
+        EXPECT_APPROXIMATE(output[k], expected);
+    }
+}
+
+template<size_t N>
+static void expect_mdct_matches_definition()
+{
+    auto input = make_input<N / 2>();
+    Array<double, N> output;
+    LibDSP::MDCT<N> mdct;
+    mdct.transform(input, output);
+    for (size_t n = 0; n < N; n++) {
+        double expected = 0;
+        for (size_t k = 0; k < N / 2; k++)
+            expected += input[k] * AK::cos(AK::Pi<double> / (2 * N) * (2 * n + 1 + N / 2.0) * (2 * k + 1));
+        EXPECT_APPROXIMATE(output[n], expected);
+    }
+}
+
+TEST_CASE(dct)
+{
+    expect_dct_matches_definition<1>();
+    expect_dct_matches_definition<7>();
+    expect_dct_matches_definition<18>();
+    expect_dct_matches_definition<32>();
+    expect_dct_matches_definition<64>();
+}
+
+TEST_CASE(mdct)
+{
+    expect_mdct_matches_definition<12>();
+    expect_mdct_matches_definition<36>();
+    expect_mdct_matches_definition<64>();
+}
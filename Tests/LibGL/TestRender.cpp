@@ -58,3 +58,96 @@ TEST_CASE(simple_triangle)
         close(fd);
     }
 }
+
+static void draw_rect(float left, float top, float right, float bottom, float depth)
+{
+    glVertex3f(left, bottom, depth);
+    glVertex3f(right, bottom, depth);
+    glVertex3f(right, top, depth);
+    glVertex3f(left, bottom, depth);
+    glVertex3f(right, top, depth);
+    glVertex3f(left, top, depth);
+}
+
+TEST_CASE(depth_tested_rects_across_tiles)
+{
+    // Large enough to be split into tiles, with a size that doesn't divide into them evenly.
+    auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { 301, 203 }));
+    auto context = GL::create_context(*bitmap);
+
+    GL::make_context_current(context);
+
+    glEnable(GL_DEPTH_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClearDepth(1.0);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    glBegin(GL_TRIANGLES);
+    glColor3f(1, 0, 0);
+    draw_rect(-1, 1, 1, -1, 0.5f);
+    glColor3f(0, 1, 0);
+    draw_rect(-1, 1, 0, -1, -0.5f);
+    // This one is behind the others, so it mustn't show up anywhere.
+    glColor3f(0, 0, 1);
+    draw_rect(-1, 1, 1, -1, 0.9f);
+    glEnd();
+
+    context->present();
+
+    EXPECT_EQ(glGetError(), 0u);
+    for (int y = 0; y < bitmap->height(); y += 10) {
+        EXPECT_EQ(bitmap->get_pixel(0, y), Gfx::Color(Gfx::Color::Green));
+        EXPECT_EQ(bitmap->get_pixel(140, y), Gfx::Color(Gfx::Color::Green));
+        EXPECT_EQ(bitmap->get_pixel(160, y), Gfx::Color(Gfx::Color::Red));
+        EXPECT_EQ(bitmap->get_pixel(300, y), Gfx::Color(Gfx::Color::Red));
+    }
+}
+
+TEST_CASE(indexed_quads_from_buffer_objects)
+{
+    auto bitmap = MUST(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { RENDER_WIDTH, RENDER_HEIGHT }));
+    auto context = GL::create_context(*bitmap);
+
+    GL::make_context_current(context);
+
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Two quads covering the whole viewport, which share their middle edge.
+    GLfloat const vertices[] = { -1, -1, 0, -1, 1, -1, -1, 1, 0, 1, 1, 1 };
+    GLubyte const indices[] = { 0, 1, 4, 3, 1, 2, 5, 4 };
+
+    GLuint buffers[2];
+    glGenBuffers(2, buffers);
+    glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), nullptr, GL_STATIC_DRAW);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, sizeof(indices), indices);
+    EXPECT(glIsBuffer(buffers[0]));
+
+    GLint binding = 0;
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &binding);
+    EXPECT_EQ(static_cast<GLuint>(binding), buffers[1]);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, nullptr);
+    // The pointer keeps referring to the buffer that was bound when it was set.
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glColor3f(1, 1, 1);
+    glDrawElements(GL_QUADS, 8, GL_UNSIGNED_BYTE, nullptr);
+
+    context->present();
+
+    EXPECT_EQ(glGetError(), 0u);
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x)
+            EXPECT_EQ(bitmap->get_pixel(x, y), Gfx::Color(Gfx::Color::White));
+    }
+
+    glDeleteBuffers(2, buffers);
+    glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &binding);
+    EXPECT_EQ(binding, 0);
+    EXPECT(!glIsBuffer(buffers[0]));
+}
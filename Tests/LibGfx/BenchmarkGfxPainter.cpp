@@ -61,3 +61,47 @@ BENCHMARK_CASE(fill_with_gradient)
         painter.fill_rect_with_gradient(bitmap->rect(), Color::Blue, Color::Red);
     }
 }
+
+BENCHMARK_CASE(fill_translucent)
+{
+    const int run_count = 100;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    painter.clear_rect(bitmap->rect(), Color::White);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.fill_rect(bitmap->rect(), Color(0, 0, 255, 100));
+    }
+}
+
+BENCHMARK_CASE(blit_with_opacity)
+{
+    const int run_count = 50;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    Gfx::Painter(source).fill_rect_with_gradient(source->rect(), Color::Blue, Color::Red);
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect(), 0.5f);
+    }
+}
+
+BENCHMARK_CASE(blit_with_alpha)
+{
+    const int run_count = 50;
+    const int bitmap_size = 2000;
+
+    auto bitmap = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    auto source = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { bitmap_size, bitmap_size }).release_value_but_fixme_should_propagate_errors();
+    Gfx::Painter painter(bitmap);
+    Gfx::Painter(source).fill_rect_with_gradient(source->rect(), Color(0, 0, 255, 50), Color(255, 0, 0, 200));
+
+    for (int run = 0; run < run_count; run++) {
+        painter.blit({ 0, 0 }, source, source->rect());
+    }
+}
@@ -7,6 +7,8 @@
 
 #include <LibGfx/BitmapFont.h>
 #include <LibGfx/FontDatabase.h>
+#include <LibGfx/TrueTypeFont/Font.h>
+#include <LibGfx/TrueTypeFont/GlyphBitmapCache.h>
 #include <LibTest/TestCase.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -134,3 +136,32 @@ TEST_CASE(test_write_to_file)
     EXPECT(font->write_to_file(path));
     unlink(path);
 }
+
+TEST_CASE(test_ttf_glyph_bitmap_cache)
+{
+    auto ttf_font = MUST(TTF::Font::try_load_from_file("/res/fonts/LiberationSerif-Regular.ttf"));
+    auto glyph_id = ttf_font->glyph_id_for_code_point('A');
+    auto& cache = TTF::GlyphBitmapCache::the();
+    auto rasterize = [&](float size) {
+        return adopt_ref(*new TTF::ScaledFont(ttf_font, size, size))->rasterize_glyph(glyph_id);
+    };
+
+    // Every ScaledFont of the same size gets the same glyphs.
+    auto bitmap = rasterize(14);
+    EXPECT(bitmap);
+    EXPECT_EQ(rasterize(14), bitmap);
+    EXPECT_NE(rasterize(15), bitmap);
+    EXPECT(cache.size_in_bytes() >= bitmap->size_in_bytes());
+
+    // Glyphs that don't fit into the budget anymore are rasterized again the next time they're needed.
+    auto budget = cache.budget();
+    cache.set_budget(0);
+    EXPECT_EQ(cache.size_in_bytes(), 0u);
+    cache.set_budget(budget);
+    EXPECT_NE(rasterize(14), bitmap);
+
+    // The glyphs of a font go away with the font.
+    EXPECT(cache.size_in_bytes() > 0);
+    ttf_font = MUST(TTF::Font::try_load_from_file("/res/fonts/LiberationSerif-Bold.ttf"));
+    EXPECT_EQ(cache.size_in_bytes(), 0u);
+}
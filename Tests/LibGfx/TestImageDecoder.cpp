@@ -7,6 +7,7 @@
 
 #include <AK/String.h>
 #include <LibCore/MappedFile.h>
+#include <LibGfx/Bitmap.h>
 #include <LibGfx/BMPLoader.h>
 #include <LibGfx/GIFLoader.h>
 #include <LibGfx/ICOLoader.h>
@@ -77,6 +78,36 @@ TEST_CASE(test_jpg)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_jpg_restart_intervals)
+{
+    // A 512x256 gradient with a restart interval every 64 MCUs, which is big enough to be decoded on two threads.
+    auto file = Core::MappedFile::map("/res/html/misc/jpgsuite_files/restart-intervals.jpg").release_value();
+    RefPtr<Gfx::Bitmap> single_threaded_bitmap;
+    for (size_t thread_count : { 1, 4 }) {
+        Gfx::JPGImageDecoderPlugin::set_decoding_thread_count(thread_count);
+        auto jpg = Gfx::JPGImageDecoderPlugin((u8 const*)file->data(), file->size());
+        auto frame_or_error = jpg.frame(0);
+        EXPECT(!frame_or_error.is_error());
+        if (frame_or_error.is_error())
+            break;
+        auto bitmap = frame_or_error.value().image;
+        EXPECT_EQ(bitmap->size(), Gfx::IntSize(512, 256));
+
+        for (int y = 0; y < bitmap->height(); y += 7) {
+            for (int x = 0; x < bitmap->width(); x += 7) {
+                auto color = bitmap->get_pixel(x, y);
+                EXPECT(abs(color.red() - x * 255 / 511) <= 8);
+                EXPECT(abs(color.green() - y * 255 / 255) <= 8);
+                EXPECT(abs(color.blue() - (x + y) * 255 / 766) <= 8);
+                if (single_threaded_bitmap)
+                    EXPECT_EQ(color, single_threaded_bitmap->get_pixel(x, y));
+            }
+        }
+        single_threaded_bitmap = bitmap;
+    }
+    Gfx::JPGImageDecoderPlugin::set_decoding_thread_count(1);
+}
+
 TEST_CASE(test_pbm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/pbmsuite_files/buggie-raw.pbm").release_value();
@@ -119,6 +150,76 @@ TEST_CASE(test_png)
     EXPECT(frame.duration == 0);
 }
 
+TEST_CASE(test_png_incremental)
+{
+    auto file = Core::MappedFile::map("/res/graphics/buggie.png").release_value();
+    auto bytes = file->bytes();
+    auto png = Gfx::PNGImageDecoderPlugin();
+    EXPECT(png.supports_incremental_decoding());
+
+    size_t offset = 0;
+    size_t previous_row_count = 0;
+    while (offset < bytes.size()) {
+        auto size = min<size_t>(512, bytes.size() - offset);
+        EXPECT(!png.append_data(bytes.slice(offset, size)).is_error());
+        offset += size;
+        EXPECT(png.decoded_row_count() >= previous_row_count);
+        previous_row_count = png.decoded_row_count();
+    }
+    EXPECT(png.sniff());
+    EXPECT(png.frame(0).is_error());
+    EXPECT(!png.finish_data().is_error());
+
+    auto frame = png.frame(0).release_value_but_fixme_should_propagate_errors();
+    EXPECT_EQ(png.decoded_row_count(), static_cast<size_t>(frame.image->height()));
+
+    auto whole_png = Gfx::PNGImageDecoderPlugin((u8 const*)file->data(), file->size());
+    auto whole_frame = whole_png.frame(0).release_value_but_fixme_should_propagate_errors();
+    for (int y = 0; y < frame.image->height(); ++y) {
+        for (int x = 0; x < frame.image->width(); ++x)
+            EXPECT_EQ(frame.image->get_pixel(x, y), whole_frame.image->get_pixel(x, y));
+    }
+}
+
+TEST_CASE(test_png_interlaced_palette_with_filters)
+{
+    // A 7x5 Adam7-interlaced image with a 4-bit palette and transparency, and filtered palette indices.
+    static constexpr u8 png_data[] = {
+        0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d,
+        0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x05,
+        0x04, 0x03, 0x00, 0x00, 0x01, 0x0c, 0xb3, 0xdb, 0x7d, 0x00, 0x00, 0x00,
+        0x30, 0x50, 0x4c, 0x54, 0x45, 0x39, 0x0c, 0x8c, 0x7d, 0x72, 0x47, 0x34,
+        0x2c, 0xd8, 0x10, 0x0f, 0x2f, 0x6f, 0x77, 0x0d, 0x65, 0xd6, 0x70, 0xe5,
+        0x8e, 0x03, 0x51, 0xd8, 0xae, 0x8e, 0x4f, 0x6e, 0xac, 0x34, 0x2f, 0xc2,
+        0x31, 0xb7, 0xb0, 0x87, 0x16, 0xeb, 0x3f, 0xc1, 0x28, 0x96, 0xb9, 0x62,
+        0x23, 0x17, 0x74, 0x94, 0x28, 0x9b, 0x5d, 0x2e, 0xb7, 0x00, 0x00, 0x00,
+        0x08, 0x74, 0x52, 0x4e, 0x53, 0x77, 0x33, 0xc2, 0x8e, 0xe8, 0xba, 0x53,
+        0xbd, 0x25, 0x4b, 0x17, 0x1c, 0x00, 0x00, 0x00, 0x29, 0x49, 0x44, 0x41,
+        0x54, 0x78, 0x9c, 0x63, 0xd9, 0xc0, 0x1c, 0xc0, 0x50, 0xcd, 0xd0, 0xca,
+        0x70, 0x85, 0x51, 0x86, 0x8f, 0x31, 0x89, 0x8f, 0xb9, 0xfc, 0x0a, 0xcb,
+        0x13, 0x01, 0x86, 0x37, 0xed, 0x0b, 0x0b, 0x98, 0x7f, 0x06, 0x4f, 0x7c,
+        0x02, 0x00, 0x90, 0x8d, 0x0b, 0x06, 0x9d, 0x83, 0xb8, 0xa0, 0x00, 0x00,
+        0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+    };
+    static constexpr Gfx::ARGB32 expected_pixels[] = {
+        0xffb08716, 0x53e58e03, 0xff8e4f6e, 0xc2342cd8, 0xba65d670, 0xbd51d8ae, 0xba65d670,
+        0xff622317, 0xffeb3fc1, 0xff8e4f6e, 0xbd51d8ae, 0xffc231b7, 0x337d7247, 0xbd51d8ae,
+        0x337d7247, 0xffc231b7, 0xffeb3fc1, 0xff8e4f6e, 0xc2342cd8, 0x53e58e03, 0xffc231b7,
+        0x53e58e03, 0xff749428, 0xffeb3fc1, 0xff622317, 0xe86f770d, 0xff8e4f6e, 0xe86f770d,
+        0xbd51d8ae, 0xff8e4f6e, 0xff2896b9, 0xffeb3fc1, 0xffb08716, 0xbd51d8ae, 0xe86f770d,
+    };
+
+    auto png = Gfx::PNGImageDecoderPlugin(png_data, sizeof(png_data));
+    auto frame = png.frame(0);
+    EXPECT(!frame.is_error());
+    auto& bitmap = *frame.value().image;
+    EXPECT_EQ(bitmap.size(), Gfx::IntSize(7, 5));
+    for (int y = 0; y < 5; ++y) {
+        for (int x = 0; x < 7; ++x)
+            EXPECT_EQ(bitmap.get_pixel(x, y).value(), expected_pixels[y * 7 + x]);
+    }
+}
+
 TEST_CASE(test_ppm)
 {
     auto file = Core::MappedFile::map("/res/html/misc/ppmsuite_files/buggie-raw.ppm").release_value();
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/Random.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/PNGLoader.h>
+#include <LibGfx/PNGWriter.h>
+#include <LibTest/TestCase.h>
+
+// Flat areas, gradients and noise, so that every filter type gets picked for some of the scanlines.
+static NonnullRefPtr<Gfx::Bitmap> make_bitmap(Gfx::BitmapFormat format)
+{
+    auto bitmap = MUST(Gfx::Bitmap::try_create(format, { 67, 45 }));
+    fill_with_random(bitmap->scanline_u8(0), bitmap->size_in_bytes());
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x) {
+            u32 noise = bitmap->scanline(y)[x];
+            u32 pixel;
+            if (y < 15)
+                pixel = 0xff000000 | (x * 3) << 16 | (y * 17) << 8 | (x + y);
+            else if (y < 30)
+                pixel = x < 30 ? 0xffd4d0c8 : noise;
+            else
+                pixel = (noise & 0xff0f0f0f) | (x * 2) << 16 | (y * 2) << 8;
+            if (format == Gfx::BitmapFormat::BGRx8888)
+                pixel |= 0xff000000;
+            bitmap->scanline(y)[x] = pixel;
+        }
+    }
+    return bitmap;
+}
+
+static void expect_round_trip(Gfx::BitmapFormat format)
+{
+    auto bitmap = make_bitmap(format);
+    for (auto compression_level : Array { Gfx::PNGWriter::CompressionLevel::None, Gfx::PNGWriter::CompressionLevel::Fast, Gfx::PNGWriter::CompressionLevel::Default, Gfx::PNGWriter::CompressionLevel::Best }) {
+        auto encoded = Gfx::PNGWriter::encode(*bitmap, compression_level);
+        EXPECT(!encoded.is_empty());
+
+        Gfx::PNGImageDecoderPlugin decoder(encoded.data(), encoded.size());
+        auto frame = MUST(decoder.frame(0));
+        EXPECT_EQ(frame.image->size(), bitmap->size());
+        for (int y = 0; y < bitmap->height(); ++y) {
+            for (int x = 0; x < bitmap->width(); ++x)
+                EXPECT_EQ(frame.image->scanline(y)[x], bitmap->scanline(y)[x]);
+        }
+    }
+}
+
+TEST_CASE(test_png_writer_rgb)
+{
+    expect_round_trip(Gfx::BitmapFormat::BGRx8888);
+}
+
+TEST_CASE(test_png_writer_rgba)
+{
+    expect_round_trip(Gfx::BitmapFormat::BGRA8888);
+}
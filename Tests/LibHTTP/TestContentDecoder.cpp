@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <AK/Random.h>
+#include <LibCompress/Deflate.h>
+#include <LibCompress/Gzip.h>
+#include <LibCrypto/Checksum/Adler32.h>
+#include <LibHTTP/ContentDecoder.h>
+
+// Some text that compresses well, followed by random bytes that end up in stored blocks.
+static ByteBuffer make_body()
+{
+    ByteBuffer body;
+    for (size_t i = 0; body.size() < 64 * KiB; ++i)
+        body.append(String::formatted("Line {} of the body, which says the same thing every time.\n", i).bytes());
+    auto text_size = body.size();
+    body.resize(256 * KiB);
+    fill_with_random(body.data() + text_size, body.size() - text_size);
+    return body;
+}
+
+struct DecodedBody {
+    ByteBuffer decoded_early;
+    ByteBuffer rest;
+};
+
+// Hands the decoder the input bit by bit, and returns what it decoded before the end of the input and after it.
+static DecodedBody decode_in_pieces(HTTP::ContentDecoder& decoder, ReadonlyBytes input, size_t piece_size)
+{
+    ByteBuffer decoded_early;
+    for (size_t offset = 0; offset < input.size(); offset += piece_size) {
+        auto decoded = decoder.decode(input.slice(offset, min(piece_size, input.size() - offset)));
+        EXPECT(!decoded.is_error());
+        decoded_early.append(decoded.value());
+    }
+    auto rest = decoder.finish();
+    EXPECT(!rest.is_error());
+    return { move(decoded_early), rest.release_value() };
+}
+
+static void expect_streamed_decoding(StringView content_encoding, ReadonlyBytes encoded, ReadonlyBytes body)
+{
+    for (size_t piece_size : Array<size_t, 3> { 1, 1000, 64 * KiB }) {
+        auto decoder = HTTP::ContentDecoder::create(content_encoding);
+        EXPECT(decoder);
+        auto [decoded_early, rest] = decode_in_pieces(*decoder, encoded, piece_size);
+        // Most of the body has to come out before all of it has been received.
+        EXPECT(decoded_early.size() > body.size() / 2);
+        decoded_early.append(rest);
+        EXPECT(decoded_early.bytes() == body);
+    }
+}
+
+TEST_CASE(gzip)
+{
+    auto body = make_body();
+    auto encoded = Compress::GzipCompressor::compress_all(body);
+    expect_streamed_decoding("gzip"sv, encoded.value(), body);
+}
+
+TEST_CASE(deflate_with_zlib_wrapper)
+{
+    auto body = make_body();
+    ByteBuffer encoded;
+    encoded.append(0x78);
+    encoded.append(0x9c);
+    encoded.append(Compress::DeflateCompressor::compress_all(body).value());
+    auto checksum = Crypto::Checksum::Adler32(body).digest();
+    for (auto shift : { 24, 16, 8, 0 })
+        encoded.append(static_cast<u8>(checksum >> shift));
+    expect_streamed_decoding("deflate"sv, encoded, body);
+}
+
+TEST_CASE(deflate_without_zlib_wrapper)
+{
+    auto body = make_body();
+    auto encoded = Compress::DeflateCompressor::compress_all(body);
+    expect_streamed_decoding("deflate"sv, encoded.value(), body);
+}
+
+TEST_CASE(empty_body)
+{
+    auto decoder = HTTP::ContentDecoder::create("gzip"sv);
+    auto rest = decoder->finish();
+    EXPECT(!rest.is_error());
+    EXPECT(rest.value().is_empty());
+}
+
+TEST_CASE(truncated_body)
+{
+    auto body = make_body();
+    auto encoded = Compress::GzipCompressor::compress_all(body).value();
+    auto decoder = HTTP::ContentDecoder::create("gzip"sv);
+    EXPECT(!decoder->decode(encoded.bytes().trim(encoded.size() / 2)).is_error());
+    EXPECT(decoder->finish().is_error());
+}
+
+TEST_CASE(not_gzip)
+{
+    auto decoder = HTTP::ContentDecoder::create("gzip"sv);
+    EXPECT(decoder->decode("<!DOCTYPE html>"sv.bytes()).is_error());
+}
+
+TEST_CASE(unknown_content_encoding)
+{
+    EXPECT(!HTTP::ContentDecoder::create("br"sv));
+    EXPECT(!HTTP::ContentDecoder::create("identity"sv));
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Array.h>
+#include <LibHTTP/HPACK.h>
+
+using HTTP::HPACK::Header;
+
+template<size_t N>
+static void expect_decoded_block(HTTP::HPACK::Decoder& decoder, Array<u8, N> const& block, Vector<Header> const& expected_headers, size_t expected_table_size)
+{
+    auto headers = decoder.decode(block);
+    EXPECT(!headers.is_error());
+    EXPECT_EQ(headers.value(), expected_headers);
+    EXPECT_EQ(decoder.table().size(), expected_table_size);
+}
+
+// RFC 7541 Appendix C.2.1
+TEST_CASE(literal_header_field_with_indexing)
+{
+    Array<u8, 26> const block {
+        0x40, 0x0a, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x6b, 0x65, 0x79, 0x0d,
+        0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x68, 0x65, 0x61, 0x64, 0x65, 0x72
+    };
+    HTTP::HPACK::Decoder decoder;
+    expect_decoded_block(decoder, block, { { "custom-key", "custom-header" } }, 55);
+}
+
+// RFC 7541 Appendix C.3
+TEST_CASE(requests_without_huffman_coding)
+{
+    HTTP::HPACK::Decoder decoder;
+
+    Array<u8, 20> const first {
+        0x82, 0x86, 0x84, 0x41, 0x0f, 0x77, 0x77, 0x77, 0x2e, 0x65,
+        0x78, 0x61, 0x6d, 0x70, 0x6c, 0x65, 0x2e, 0x63, 0x6f, 0x6d
+    };
+    expect_decoded_block(decoder, first, { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" } }, 57);
+
+    Array<u8, 14> const second {
+        0x82, 0x86, 0x84, 0xbe, 0x58, 0x08, 0x6e, 0x6f, 0x2d, 0x63, 0x61, 0x63, 0x68, 0x65
+    };
+    expect_decoded_block(decoder, second, { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" }, { "cache-control", "no-cache" } }, 110);
+
+    Array<u8, 29> const third {
+        0x82, 0x87, 0x85, 0xbf, 0x40, 0x0a, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x6b, 0x65,
+        0x79, 0x0c, 0x63, 0x75, 0x73, 0x74, 0x6f, 0x6d, 0x2d, 0x76, 0x61, 0x6c, 0x75, 0x65
+    };
+    expect_decoded_block(decoder, third, { { ":method", "GET" }, { ":scheme", "https" }, { ":path", "/index.html" }, { ":authority", "www.example.com" }, { "custom-key", "custom-value" } }, 164);
+}
+
+// RFC 7541 Appendix C.4
+TEST_CASE(requests_with_huffman_coding)
+{
+    HTTP::HPACK::Decoder decoder;
+
+    Array<u8, 17> const first {
+        0x82, 0x86, 0x84, 0x41, 0x8c, 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff
+    };
+    expect_decoded_block(decoder, first, { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" } }, 57);
+
+    Array<u8, 12> const second {
+        0x82, 0x86, 0x84, 0xbe, 0x58, 0x86, 0xa8, 0xeb, 0x10, 0x64, 0x9c, 0xbf
+    };
+    expect_decoded_block(decoder, second, { { ":method", "GET" }, { ":scheme", "http" }, { ":path", "/" }, { ":authority", "www.example.com" }, { "cache-control", "no-cache" } }, 110);
+
+    Array<u8, 24> const third {
+        0x82, 0x87, 0x85, 0xbf, 0x40, 0x88, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xa9,
+        0x7d, 0x7f, 0x89, 0x25, 0xa8, 0x49, 0xe9, 0x5b, 0xb8, 0xe8, 0xb4, 0xbf
+    };
+    expect_decoded_block(decoder, third, { { ":method", "GET" }, { ":scheme", "https" }, { ":path", "/index.html" }, { ":authority", "www.example.com" }, { "custom-key", "custom-value" } }, 164);
+}
+
+// RFC 7541 Appendix C.6, which also evicts entries from a small table.
+TEST_CASE(responses_with_huffman_coding)
+{
+    HTTP::HPACK::Decoder decoder(256);
+
+    Array<u8, 54> const first {
+        0x48, 0x82, 0x64, 0x02, 0x58, 0x85, 0xae, 0xc3, 0x77, 0x1a, 0x4b, 0x61, 0x96, 0xd0,
+        0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20, 0x05, 0x95, 0x04, 0x0b, 0x81,
+        0x66, 0xe0, 0x82, 0xa6, 0x2d, 0x1b, 0xff, 0x6e, 0x91, 0x9d, 0x29, 0xad, 0x17, 0x18,
+        0x63, 0xc7, 0x8f, 0x0b, 0x97, 0xc8, 0xe9, 0xae, 0x82, 0xae, 0x43, 0xd3
+    };
+    expect_decoded_block(decoder, first, { { ":status", "302" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:21 GMT" }, { "location", "https://www.example.com" } }, 222);
+
+    Array<u8, 8> const second {
+        0x48, 0x83, 0x64, 0x0e, 0xff, 0xc1, 0xc0, 0xbf
+    };
+    expect_decoded_block(decoder, second, { { ":status", "307" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:21 GMT" }, { "location", "https://www.example.com" } }, 222);
+
+    Array<u8, 79> const third {
+        0x88, 0xc1, 0x61, 0x96, 0xd0, 0x7a, 0xbe, 0x94, 0x10, 0x54, 0xd4, 0x44, 0xa8, 0x20,
+        0x05, 0x95, 0x04, 0x0b, 0x81, 0x66, 0xe0, 0x84, 0xa6, 0x2d, 0x1b, 0xff, 0xc0, 0x5a,
+        0x83, 0x9b, 0xd9, 0xab, 0x77, 0xad, 0x94, 0xe7, 0x82, 0x1d, 0xd7, 0xf2, 0xe6, 0xc7,
+        0xb3, 0x35, 0xdf, 0xdf, 0xcd, 0x5b, 0x39, 0x60, 0xd5, 0xaf, 0x27, 0x08, 0x7f, 0x36,
+        0x72, 0xc1, 0xab, 0x27, 0x0f, 0xb5, 0x29, 0x1f, 0x95, 0x87, 0x31, 0x60, 0x65, 0xc0,
+        0x03, 0xed, 0x4e, 0xe5, 0xb1, 0x06, 0x3d, 0x50, 0x07
+    };
+    expect_decoded_block(decoder, third, { { ":status", "200" }, { "cache-control", "private" }, { "date", "Mon, 21 Oct 2013 20:13:22 GMT" }, { "location", "https://www.example.com" }, { "content-encoding", "gzip" }, { "set-cookie", "foo=ASDJKHQKBZXOQWEOPIUAXQWEOIU; max-age=3600; version=1" } }, 215);
+}
+
+TEST_CASE(huffman_round_trip)
+{
+    ByteBuffer encoded;
+    EXPECT(!HTTP::HPACK::encode_huffman("www.example.com"sv, encoded).is_error());
+    Array<u8, 12> const expected { 0xf1, 0xe3, 0xc2, 0xe5, 0xf2, 0x3a, 0x6b, 0xa0, 0xab, 0x90, 0xf4, 0xff };
+    EXPECT_EQ(encoded.bytes(), expected.span());
+    EXPECT_EQ(HTTP::HPACK::huffman_encoded_length("www.example.com"sv), 12u);
+
+    String all_bytes;
+    {
+        Array<char, 256> bytes;
+        for (size_t i = 0; i < bytes.size(); ++i)
+            bytes[i] = static_cast<char>(i);
+        all_bytes = String { bytes.data(), bytes.size() };
+    }
+    encoded.clear();
+    EXPECT(!HTTP::HPACK::encode_huffman(all_bytes, encoded).is_error());
+    auto decoded = HTTP::HPACK::decode_huffman(encoded);
+    EXPECT(!decoded.is_error());
+    EXPECT_EQ(decoded.value(), all_bytes);
+}
+
+TEST_CASE(invalid_huffman_padding)
+{
+    // A full byte of padding isn't allowed, and neither is padding with zero bits.
+    Array<u8, 2> const too_much_padding { 0x1f, 0xff };
+    EXPECT(HTTP::HPACK::decode_huffman(too_much_padding).is_error());
+    Array<u8, 1> const zero_padding { 0x00 };
+    EXPECT(HTTP::HPACK::decode_huffman(zero_padding).is_error());
+}
+
+TEST_CASE(invalid_index)
+{
+    HTTP::HPACK::Decoder decoder;
+    Array<u8, 1> const past_the_end { 0xbe };
+    EXPECT(decoder.decode(past_the_end).is_error());
+}
+
+TEST_CASE(encoder_round_trip)
+{
+    HTTP::HPACK::Encoder encoder;
+    HTTP::HPACK::Decoder decoder;
+
+    Vector<Header> const requests[] {
+        { { ":method", "GET" }, { ":scheme", "https" }, { ":path", "/" }, { ":authority", "serenityos.org" }, { "user-agent", "Mozilla/5.0 (SerenityOS)" } },
+        { { ":method", "GET" }, { ":scheme", "https" }, { ":path", "/style.css" }, { ":authority", "serenityos.org" }, { "user-agent", "Mozilla/5.0 (SerenityOS)" }, { "authorization", "Basic c2VyZW5pdHk6b3M=" } },
+        { { ":method", "POST" }, { ":scheme", "https" }, { ":path", "/" }, { ":authority", "serenityos.org" }, { "content-length", "12345" } },
+    };
+
+    size_t first_block_size = 0;
+    for (size_t i = 0; i < array_size(requests); ++i) {
+        ByteBuffer block;
+        EXPECT(!encoder.encode(requests[i], block).is_error());
+        if (i == 0)
+            first_block_size = block.size();
+        auto decoded = decoder.decode(block);
+        EXPECT(!decoded.is_error());
+        EXPECT_EQ(decoded.value(), requests[i]);
+        EXPECT_EQ(decoder.table().size(), encoder.table().size());
+    }
+
+    // Repeating a request only takes a byte per header once everything is in the table.
+    ByteBuffer repeated_block;
+    EXPECT(!encoder.encode(requests[0], repeated_block).is_error());
+    EXPECT_EQ(repeated_block.size(), requests[0].size());
+    EXPECT(repeated_block.size() < first_block_size);
+
+    // Credentials never end up in the table.
+    for (size_t i = 0; i < encoder.table().entry_count(); ++i)
+        EXPECT_NE(encoder.table().at(i).name, "authorization");
+}
+
+TEST_CASE(table_size_update)
+{
+    HTTP::HPACK::Encoder encoder;
+    HTTP::HPACK::Decoder decoder;
+
+    Vector<Header> const headers { { "custom-key", "custom-header" } };
+    ByteBuffer block;
+    EXPECT(!encoder.encode(headers, block).is_error());
+    EXPECT(!decoder.decode(block).is_error());
+    EXPECT_EQ(decoder.table().entry_count(), 1u);
+
+    encoder.set_max_table_size(0);
+    block.clear();
+    EXPECT(!encoder.encode(headers, block).is_error());
+    EXPECT_EQ(block[0], 0x20);
+    auto decoded = decoder.decode(block);
+    EXPECT(!decoded.is_error());
+    EXPECT_EQ(decoded.value(), headers);
+    EXPECT_EQ(decoder.table().entry_count(), 0u);
+    EXPECT_EQ(decoder.table().max_size(), 0u);
+}
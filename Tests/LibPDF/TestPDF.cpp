@@ -35,6 +35,17 @@ TEST_CASE(complex_pdf)
     EXPECT_EQ(document.value()->get_page_count(), 3U);
 }
 
+TEST_CASE(complex_pdf_pages)
+{
+    auto file = Core::MappedFile::map("complex.pdf").release_value();
+    auto document = PDF::Document::create(file->bytes()).release_value();
+    // Pages are looked up in the page tree on demand, in any order.
+    for (auto index : { 2u, 0u, 1u }) {
+        auto page = document->get_page(index);
+        EXPECT(!page.is_error());
+    }
+}
+
 TEST_CASE(empty_file_issue_10702)
 {
     AK::ReadonlyBytes empty;
@@ -1034,3 +1034,70 @@ TEST_CASE(single_match_flag)
         EXPECT_EQ(result.matches.first().view.to_string(), "A"sv);
     }
 }
+
+TEST_CASE(lazy_dfa)
+{
+    {
+        // The DFA has to find the same match as the VM, which isn't necessarily the longest one.
+        Regex<ECMA262> re("a|ab"sv, ECMAScriptFlags::Global);
+        auto result = re.match("xab");
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_string(), "a"sv);
+    }
+    {
+        Regex<ECMA262> re("a+?b??"sv, ECMAScriptFlags::Global);
+        auto result = re.match("xaab");
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_string(), "a"sv);
+    }
+    {
+        // Assertions depend on the characters around the match.
+        Regex<ECMA262> re("\\bcat\\b|^dog$"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Multiline);
+        auto result = re.match("concat cat\ndog\nhotdog");
+        EXPECT_EQ(result.count, 2u);
+        EXPECT_EQ(result.matches[0].global_offset, 7u);
+        EXPECT_EQ(result.matches[1].view.to_string(), "dog"sv);
+    }
+    {
+        // Capture groups are still filled in.
+        Regex<PosixExtended> re("(foo|bar)+baz"sv);
+        auto result = re.match("xxbarfoobaz", PosixFlags::Global);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_string(), "barfoobaz"sv);
+        EXPECT_EQ(result.capture_group_matches.first().first().view.to_string(), "foo"sv);
+    }
+    {
+        // Without the DFA, every position would take the VM exponential time to rule out.
+        Regex<ECMA262> re("(?:a|a)*b"sv, ECMAScriptFlags::Global);
+        auto result = re.match(String::repeated('a', 100));
+        EXPECT_EQ(result.success, false);
+    }
+}
+
+TEST_CASE(required_prefix)
+{
+    {
+        // b+ is b followed by b*, so the b is required too.
+        Regex<ECMA262> re("ab+c"sv);
+        EXPECT_EQ(re.parser_result.optimization_data.required_prefix.span(), "ab"sv.bytes());
+    }
+    {
+        Regex<ECMA262> re("(foo)bar|baz"sv);
+        EXPECT(re.parser_result.optimization_data.required_prefix.is_empty());
+    }
+    {
+        // Occurrences of the prefix can overlap, and be the beginning of a match only some of the time.
+        Regex<PosixExtended> re("aab(c|d)"sv);
+        auto result = re.match("aaabaaabdaab aabc", PosixFlags::Global);
+        EXPECT_EQ(result.count, 2u);
+        EXPECT_EQ(result.matches[0].view.to_string(), "aabd"sv);
+        EXPECT_EQ(result.matches[1].view.to_string(), "aabc"sv);
+        EXPECT_EQ(result.capture_group_matches[1][0].view.to_string(), "c"sv);
+    }
+    {
+        Regex<ECMA262> re("ERROR: (\\w+)"sv, ECMAScriptFlags::Global | ECMAScriptFlags::Insensitive);
+        auto result = re.match("warning: disk\nerror: network");
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_string(), "error: network"sv);
+    }
+}
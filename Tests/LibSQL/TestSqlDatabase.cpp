@@ -7,6 +7,7 @@
 #include <unistd.h>
 
 #include <AK/ScopeGuard.h>
+#include <LibCore/File.h>
 #include <LibSQL/BTree.h>
 #include <LibSQL/Database.h>
 #include <LibSQL/Heap.h>
@@ -119,6 +120,97 @@ TEST_CASE(create_heap)
     EXPECT_EQ(heap->version(), 0x00000001u);
 }
 
+static void write_blocks(SQL::Heap& heap, u32 first_block, u32 count, u8 generation)
+{
+    for (auto block = first_block; block < first_block + count; ++block) {
+        auto buffer = ByteBuffer::create_zeroed(SQL::BLOCKSIZE).release_value();
+        buffer[0] = generation;
+        memcpy(buffer.offset_pointer(1), &block, sizeof(block));
+        heap.add_to_wal(block, buffer);
+    }
+}
+
+static void expect_blocks(SQL::Heap& heap, u32 first_block, u32 count, u8 generation)
+{
+    for (auto block = first_block; block < first_block + count; ++block) {
+        auto buffer = heap.read_block(block);
+        EXPECT(!buffer.is_error());
+        u32 block_in_buffer;
+        memcpy(&block_in_buffer, buffer.value().offset_pointer(1), sizeof(block_in_buffer));
+        EXPECT_EQ(buffer.value()[0], generation);
+        EXPECT_EQ(block_in_buffer, block);
+    }
+}
+
+static void copy_file(String const& from, String const& to, ReadonlyBytes extra_bytes = {})
+{
+    auto contents = MUST(Core::File::open(from, Core::OpenMode::ReadOnly))->read_all();
+    auto file = MUST(Core::File::open(to, Core::OpenMode::WriteOnly));
+    EXPECT(file->write(contents.data(), contents.size()));
+    EXPECT(file->write(extra_bytes.data(), extra_bytes.size()));
+}
+
+TEST_CASE(read_blocks_after_flushing)
+{
+    ScopeGuard guard([]() { unlink("/tmp/test.db"); });
+    auto heap = SQL::Heap::construct("/tmp/test.db");
+    EXPECT(!heap->open().is_error());
+
+    // More blocks than the heap keeps in memory, written twice, so that stale copies of them would show.
+    auto block_count = 2 * SQL::BLOCK_CACHE_SIZE;
+    for (auto i = 0u; i < block_count; ++i)
+        EXPECT_EQ(heap->new_record_pointer(), i + 1);
+    write_blocks(*heap, 1, block_count, 1);
+    EXPECT(!heap->flush().is_error());
+    EXPECT(!heap->checkpoint().is_error());
+    expect_blocks(*heap, 1, block_count, 1);
+    expect_blocks(*heap, 1, 10, 1);
+
+    write_blocks(*heap, 1, block_count / 2, 2);
+    expect_blocks(*heap, 1, block_count / 2, 2);
+    EXPECT(!heap->flush().is_error());
+    expect_blocks(*heap, 1, block_count / 2, 2);
+    EXPECT(!heap->checkpoint().is_error());
+    expect_blocks(*heap, 1, block_count / 2, 2);
+    expect_blocks(*heap, block_count / 2 + 1, block_count / 2, 1);
+}
+
+TEST_CASE(recover_committed_blocks_from_log)
+{
+    ScopeGuard guard([]() {
+        unlink("/tmp/test.db");
+        unlink("/tmp/crashed.db");
+        unlink("/tmp/crashed.db-wal");
+    });
+    {
+        auto heap = SQL::Heap::construct("/tmp/test.db");
+        EXPECT(!heap->open().is_error());
+        for (auto i = 0u; i < 3; ++i)
+            EXPECT_EQ(heap->new_record_pointer(), i + 1);
+        write_blocks(*heap, 1, 3, 1);
+        EXPECT(!heap->flush().is_error());
+
+        // Pretend that the process crashed before the blocks made it to the heap file, and halfway through committing
+        // another transaction.
+        u8 partial_transaction[SQL::BLOCKSIZE / 2] = { 1 };
+        copy_file("/tmp/test.db", "/tmp/crashed.db");
+        copy_file("/tmp/test.db-wal", "/tmp/crashed.db-wal", { partial_transaction, sizeof(partial_transaction) });
+    }
+    {
+        auto heap = SQL::Heap::construct("/tmp/crashed.db");
+        EXPECT(!heap->open().is_error());
+        EXPECT_EQ(heap->size(), 4u);
+        expect_blocks(*heap, 1, 3, 1);
+    }
+    {
+        // Everything has been written to the heap file when it was closed.
+        auto heap = SQL::Heap::construct("/tmp/crashed.db");
+        EXPECT(!heap->open().is_error());
+        EXPECT_EQ(heap->size(), 4u);
+        expect_blocks(*heap, 1, 3, 1);
+    }
+}
+
 TEST_CASE(create_from_dev_random)
 {
     auto heap = SQL::Heap::construct("/dev/random");
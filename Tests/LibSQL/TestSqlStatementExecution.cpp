@@ -334,6 +334,70 @@ TEST_CASE(select_inner_join)
     EXPECT_EQ(result[0].row[2].to_string(), "Test_12");
 }
 
+void insert_into_two_tables(NonnullRefPtr<SQL::Database> database)
+{
+    auto result = execute(database,
+        "INSERT INTO TestSchema.TestTable1 ( TextColumn1, IntColumn ) VALUES "
+        "( 'Test_1', 42 ), "
+        "( 'Test_2', 43 ), "
+        "( 'Test_3', 44 ), "
+        "( 'Test_4', 45 ), "
+        "( 'Test_5', 46 );");
+    EXPECT(result.size() == 5);
+    result = execute(database,
+        "INSERT INTO TestSchema.TestTable2 ( TextColumn2, IntColumn ) VALUES "
+        "( 'Test_10', 40 ), "
+        "( 'Test_11', 41 ), "
+        "( 'Test_12', 42 ), "
+        "( 'Test_13', 43 ), "
+        "( 'Test_14', 48 );");
+    EXPECT(result.size() == 5);
+}
+
+TEST_CASE(select_inner_join_with_filters)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_two_tables(database);
+    insert_into_two_tables(database);
+    auto result = execute(database,
+        "SELECT TestTable1.IntColumn, TextColumn1, TextColumn2 "
+        "FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE (TextColumn1 <> 'Test_1') AND (TestTable1.IntColumn = TestTable2.IntColumn) AND (TextColumn2 <> 'Test_10');");
+    EXPECT_EQ(result.size(), 1u);
+    EXPECT_EQ(result[0].row.size(), 3u);
+    EXPECT_EQ(result[0].row[0].to_int().value(), 43);
+    EXPECT_EQ(result[0].row[1].to_string(), "Test_2");
+    EXPECT_EQ(result[0].row[2].to_string(), "Test_13");
+
+    // An unqualified column that both tables have stays ambiguous.
+    auto error = try_execute(database,
+        "SELECT TextColumn1 FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE (TextColumn1 = 'Test_1') AND (IntColumn = 42);");
+    EXPECT(error.is_error());
+    EXPECT_EQ(error.error().error(), SQL::SQLErrorCode::AmbiguousColumnName);
+}
+
+TEST_CASE(explain_select)
+{
+    ScopeGuard guard([]() { unlink(db_name); });
+    auto database = SQL::Database::construct(db_name);
+    EXPECT(!database->open().is_error());
+    create_two_tables(database);
+    auto result = execute(database,
+        "EXPLAIN SELECT TextColumn1, TextColumn2 "
+        "FROM TestSchema.TestTable1, TestSchema.TestTable2 "
+        "WHERE (TextColumn1 = 'Test_1') AND (TestTable1.IntColumn = TestTable2.IntColumn) AND (TextColumn2 = 'Test_12') "
+        "ORDER BY TextColumn2;");
+    EXPECT_EQ(result.size(), 5u);
+    EXPECT_EQ(result[0].row[0].to_string(), "SCAN TABLE TESTSCHEMA.TESTTABLE1");
+    EXPECT_EQ(result[1].row[0].to_string(), "    FILTER ON 1 TERM OF THE WHERE CLAUSE");
+    EXPECT_EQ(result[2].row[0].to_string(), "SCAN TABLE TESTSCHEMA.TESTTABLE2");
+    EXPECT_EQ(result[3].row[0].to_string(), "    FILTER ON 2 TERMS OF THE WHERE CLAUSE");
+    EXPECT_EQ(result[4].row[0].to_string(), "SORT");
+}
+
 TEST_CASE(select_with_like)
 {
     ScopeGuard guard([]() { unlink(db_name); });
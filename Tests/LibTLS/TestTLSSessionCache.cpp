@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTLS/SessionCache.h>
+#include <LibTest/TestCase.h>
+
+static TLS::Session make_session(u8 id_byte, time_t lifetime_in_seconds = 60)
+{
+    TLS::Session session;
+    session.id = ByteBuffer::create_zeroed(32).release_value();
+    session.id.bytes().fill(id_byte);
+    session.cipher = TLS::CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256;
+    session.master_key = ByteBuffer::create_zeroed(48).release_value();
+    session.expiry_time = time(nullptr) + lifetime_in_seconds;
+    return session;
+}
+
+TEST_CASE(store_and_find)
+{
+    auto cache = TLS::SessionCache::create();
+    EXPECT(!cache->find("serenityos.org").has_value());
+
+    cache->store("serenityos.org", make_session(1));
+    auto session = cache->find("serenityos.org");
+    EXPECT(session.has_value());
+    EXPECT_EQ(session->id[0], 1);
+    EXPECT_EQ(session->cipher, TLS::CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256);
+    EXPECT(!cache->find("github.com").has_value());
+}
+
+TEST_CASE(newer_session_replaces_older_one)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("serenityos.org", make_session(1));
+    cache->store("serenityos.org", make_session(2));
+    EXPECT_EQ(cache->size(), 1u);
+    EXPECT_EQ(cache->find("serenityos.org")->id[0], 2);
+}
+
+TEST_CASE(remove)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("serenityos.org", make_session(1));
+    cache->remove("serenityos.org");
+    EXPECT(!cache->find("serenityos.org").has_value());
+    EXPECT_EQ(cache->size(), 0u);
+}
+
+TEST_CASE(expired_sessions_are_not_found)
+{
+    auto cache = TLS::SessionCache::create();
+    cache->store("serenityos.org", make_session(1, -1));
+    EXPECT(!cache->find("serenityos.org").has_value());
+    EXPECT_EQ(cache->size(), 0u);
+}
+
+TEST_CASE(full_cache_drops_the_session_that_expires_first)
+{
+    auto cache = TLS::SessionCache::create(2);
+    cache->store("a.example", make_session(1, 300));
+    cache->store("b.example", make_session(2, 100));
+    cache->store("c.example", make_session(3, 200));
+    EXPECT_EQ(cache->size(), 2u);
+    EXPECT(cache->find("a.example").has_value());
+    EXPECT(!cache->find("b.example").has_value());
+    EXPECT(cache->find("c.example").has_value());
+
+    // Replacing a session doesn't need any room.
+    cache->store("a.example", make_session(4, 300));
+    EXPECT(cache->find("c.example").has_value());
+}
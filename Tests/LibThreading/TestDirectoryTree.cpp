@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/QuickSort.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibThreading/DirectoryTree.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static String create_test_tree()
+{
+    char root_template[] = "/tmp/test-directory-tree-XXXXXX";
+    VERIFY(mkdtemp(root_template));
+    String root = root_template;
+
+    for (int i = 0; i < 5; ++i) {
+        auto directory = String::formatted("{}/dir{}", root, i);
+        VERIFY(mkdir(directory.characters(), 0755) == 0);
+        for (int j = 0; j < 3; ++j) {
+            auto subdirectory = String::formatted("{}/sub{}", directory, j);
+            VERIFY(mkdir(subdirectory.characters(), 0755) == 0);
+            auto file = String::formatted("{}/file", subdirectory);
+            int fd = creat(file.characters(), 0644);
+            VERIFY(fd >= 0);
+            VERIFY(write(fd, "hello", 5) == 5);
+            close(fd);
+        }
+    }
+    return root;
+}
+
+static void collect_paths(Threading::DirectoryTreeNode const& node, String const& path, Vector<String>& paths)
+{
+    for (auto const& child : node.children) {
+        auto child_path = String::formatted("{}/{}", path, child.name);
+        paths.append(child_path);
+        collect_paths(child, child_path, paths);
+    }
+}
+
+TEST_CASE(read_directory_tree_finds_every_entry)
+{
+    auto root = create_test_tree();
+    auto tree = Threading::read_directory_tree(root, { .stat_entries = true });
+    EXPECT_EQ(tree.error, 0);
+
+    Vector<String> paths;
+    collect_paths(tree, "", paths);
+    quick_sort(paths);
+    EXPECT_EQ(paths.size(), 5u * (1 + 3 * 2));
+    EXPECT_EQ(paths.first(), "/dir0");
+    EXPECT_EQ(paths.last(), "/dir4/sub2/file");
+
+    auto const& file = tree.children.first().children.first().children.first();
+    EXPECT_EQ(file.name, "file");
+    EXPECT_EQ(file.type, DT_REG);
+    EXPECT_EQ(file.stat.st_size, 5);
+
+    EXPECT_EQ(system(String::formatted("rm -rf {}", root).characters()), 0);
+}
+
+TEST_CASE(read_directory_tree_respects_max_depth)
+{
+    auto root = create_test_tree();
+    auto tree = Threading::read_directory_tree(root, { .max_depth = 0 });
+
+    EXPECT_EQ(tree.children.size(), 5u);
+    for (auto const& child : tree.children) {
+        EXPECT(child.is_directory());
+        EXPECT(child.children.is_empty());
+    }
+
+    EXPECT_EQ(system(String::formatted("rm -rf {}", root).characters()), 0);
+}
+
+TEST_CASE(read_directory_tree_reports_unreadable_root)
+{
+    auto tree = Threading::read_directory_tree("/this/does/not/exist");
+    EXPECT_EQ(tree.error, ENOENT);
+    EXPECT(tree.children.is_empty());
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibTest/TestCase.h>
+
+#include <AK/Atomic.h>
+#include <AK/QuickSort.h>
+#include <AK/Random.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibThreading/Parallel.h>
+
+TEST_CASE(parallel_for_visits_every_index_once)
+{
+    Vector<u32> visits;
+    visits.resize(100'000);
+    Threading::parallel_for(0, visits.size(), [&](size_t index) {
+        AK::atomic_fetch_add(&visits[index], 1u);
+    });
+    for (auto count : visits)
+        EXPECT_EQ(count, 1u);
+}
+
+TEST_CASE(parallel_for_empty_and_offset_ranges)
+{
+    Atomic<size_t> calls { 0 };
+    Threading::parallel_for(5, 5, [&](size_t) { calls.fetch_add(1); });
+    EXPECT_EQ(calls.load(), 0u);
+
+    Atomic<size_t> sum { 0 };
+    Threading::parallel_for(10, 20, [&](size_t index) { sum.fetch_add(index); }, 3);
+    EXPECT_EQ(sum.load(), 145u);
+}
+
+TEST_CASE(nested_parallel_for)
+{
+    Atomic<size_t> calls { 0 };
+    Threading::parallel_for(0, 64, [&](size_t) {
+        Threading::parallel_for(0, 64, [&](size_t) { calls.fetch_add(1); });
+    });
+    EXPECT_EQ(calls.load(), 64u * 64u);
+}
+
+TEST_CASE(parallel_reduce)
+{
+    auto sum = Threading::parallel_reduce(
+        0, 1'000'000, static_cast<u64>(0),
+        [](size_t index) { return static_cast<u64>(index); },
+        [](u64 a, u64 b) { return a + b; });
+    EXPECT_EQ(sum, 999'999ull * 1'000'000ull / 2);
+
+    // Chunks have to be combined in order for non-commutative reductions.
+    auto string = Threading::parallel_reduce(
+        0, 1000, String::empty(),
+        [](size_t index) { return String::number(index % 10); },
+        [](String a, String b) { return String::formatted("{}{}", a, b); }, 16);
+    EXPECT_EQ(string.length(), 1000u);
+    for (size_t i = 0; i < string.length(); ++i)
+        EXPECT_EQ(string[i], static_cast<char>('0' + i % 10));
+}
+
+TEST_CASE(parallel_sort)
+{
+    for (size_t size : { 0, 1, 2, 17, 1000, 100'000 }) {
+        Vector<u32> values;
+        for (size_t i = 0; i < size; ++i)
+            values.append(get_random<u32>() % 1000);
+        auto expected = values;
+        quick_sort(expected);
+
+        Threading::parallel_sort(values);
+        EXPECT_EQ(values, expected);
+    }
+}
+
+TEST_CASE(parallel_sort_is_stable)
+{
+    struct Entry {
+        u32 key;
+        u32 original_index;
+    };
+    Vector<Entry> entries;
+    for (u32 i = 0; i < 50'000; ++i)
+        entries.append({ get_random<u32>() % 100, i });
+
+    Threading::parallel_sort(entries, [](auto& a, auto& b) { return a.key < b.key; });
+    for (size_t i = 1; i < entries.size(); ++i) {
+        EXPECT(entries[i - 1].key <= entries[i].key);
+        if (entries[i - 1].key == entries[i].key)
+            EXPECT(entries[i - 1].original_index < entries[i].original_index);
+    }
+}
+
+TEST_CASE(parallel_sort_strings)
+{
+    Vector<String> strings;
+    for (size_t i = 0; i < 20'000; ++i)
+        strings.append(String::number(get_random<u32>()));
+    auto expected = strings;
+    quick_sort(expected);
+
+    Threading::parallel_sort(strings);
+    EXPECT_EQ(strings, expected);
+}
+
+BENCHMARK_CASE(quick_sort_million)
+{
+    Vector<u32> values;
+    for (size_t i = 0; i < 1'000'000; ++i)
+        values.append(get_random<u32>());
+    quick_sort(values);
+}
+
+BENCHMARK_CASE(parallel_sort_million)
+{
+    Vector<u32> values;
+    for (size_t i = 0; i < 1'000'000; ++i)
+        values.append(get_random<u32>());
+    Threading::parallel_sort(values);
+}
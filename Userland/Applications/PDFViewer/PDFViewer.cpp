@@ -14,6 +14,9 @@
 
 static constexpr int PAGE_PADDING = 25;
 
+// How long the viewer has to be left alone before we render the pages next to the current one.
+static constexpr int PRERENDER_DELAY_MS = 150;
+
 static constexpr Array zoom_levels = {
     17,
     21,
@@ -41,6 +44,8 @@ PDFViewer::PDFViewer()
     set_scrollbars_enabled(true);
 
     start_timer(30'000);
+
+    m_prerender_timer = Core::Timer::create_single_shot(PRERENDER_DELAY_MS, [this] { prerender_neighboring_page(); }, this);
 }
 
 void PDFViewer::set_document(RefPtr<PDF::Document> document)
@@ -57,6 +62,28 @@ void PDFViewer::set_document(RefPtr<PDF::Document> document)
     update();
 }
 
+bool PDFViewer::is_page_rendered(u32 index) const
+{
+    auto existing_rendered_page = m_rendered_page_list[index].get(m_zoom_level);
+    return existing_rendered_page.has_value() && existing_rendered_page.value().rotation == m_rotations;
+}
+
+void PDFViewer::prerender_neighboring_page()
+{
+    if (!m_document)
+        return;
+
+    // One page at a time, so we get back to the event loop in between.
+    for (auto index : { m_current_page_index + 1, m_current_page_index - 1 }) {
+        if (index >= m_document->get_page_count() || is_page_rendered(index))
+            continue;
+        // Errors are reported once the page is actually shown.
+        (void)get_rendered_page(index);
+        m_prerender_timer->restart();
+        return;
+    }
+}
+
 PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> PDFViewer::get_rendered_page(u32 index)
 {
     auto& rendered_page_map = m_rendered_page_list[index];
@@ -92,6 +119,9 @@ void PDFViewer::paint_event(GUI::PaintEvent& event)
     auto page = maybe_page.release_value();
     set_content_size(page->size());
 
+    // Have the next and previous pages ready by the time the user turns to them.
+    m_prerender_timer->restart();
+
     painter.translate(frame_thickness(), frame_thickness());
     painter.translate(-horizontal_scrollbar().value(), -vertical_scrollbar().value());
 
@@ -169,9 +199,9 @@ void PDFViewer::mousemove_event(GUI::MouseEvent& event)
 
 void PDFViewer::timer_event(Core::TimerEvent&)
 {
-    // Clear the bitmap vector of all pages except the current page
+    // Clear the bitmap vector of all pages except the current page and its prerendered neighbors
     for (size_t i = 0; i < m_rendered_page_list.size(); i++) {
-        if (i != m_current_page_index)
+        if (i + 1 < m_current_page_index || i > m_current_page_index + 1)
             m_rendered_page_list[i].clear();
     }
 }
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/HashMap.h>
+#include <LibCore/Timer.h>
 #include <LibGUI/AbstractScrollableWidget.h>
 #include <LibGfx/Bitmap.h>
 #include <LibPDF/Document.h>
@@ -51,10 +52,13 @@ private:
 
     PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> get_rendered_page(u32 index);
     PDF::PDFErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_page(const PDF::Page&);
+    bool is_page_rendered(u32 index) const;
+    void prerender_neighboring_page();
 
     RefPtr<PDF::Document> m_document;
     u32 m_current_page_index { 0 };
     Vector<HashMap<u32, RenderedPage>> m_rendered_page_list;
+    RefPtr<Core::Timer> m_prerender_timer;
 
     u8 m_zoom_level { initial_zoom_level };
 
@@ -36,7 +36,7 @@ AudioPlayerLoop::AudioPlayerLoop(TrackManager& track_manager, bool& need_to_writ
     auto target_sample_rate = m_audio_client->get_sample_rate();
     if (target_sample_rate == 0)
         target_sample_rate = Music::sample_rate;
-    m_resampler = Audio::ResampleHelper<double>(Music::sample_rate, target_sample_rate);
+    m_resampler.emplace(Music::sample_rate, target_sample_rate);
 }
 
 void AudioPlayerLoop::enqueue_audio()
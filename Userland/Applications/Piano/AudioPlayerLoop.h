@@ -30,7 +30,7 @@ private:
 
     TrackManager& m_track_manager;
     Array<Sample, sample_count> m_buffer;
-    Optional<Audio::ResampleHelper<double>> m_resampler;
+    Optional<Audio::PolyphaseResampler> m_resampler;
     RefPtr<Audio::ConnectionFromClient> m_audio_client;
 
     bool m_should_play_audio = true;
@@ -36,7 +36,7 @@ void PlaybackManager::set_loader(NonnullRefPtr<Audio::Loader>&& loader)
         m_device_samples_per_buffer = PlaybackManager::buffer_size_ms / 1000.0f * m_device_sample_rate;
         u32 source_samples_per_buffer = PlaybackManager::buffer_size_ms / 1000.0f * m_loader->sample_rate();
         m_source_buffer_size_bytes = source_samples_per_buffer * m_loader->num_channels() * m_loader->bits_per_sample() / 8;
-        m_resampler = Audio::ResampleHelper<double>(m_loader->sample_rate(), m_device_sample_rate);
+        m_resampler.emplace(m_loader->sample_rate(), m_device_sample_rate);
         m_timer->start();
     } else {
         m_timer->stop();
@@ -49,6 +49,8 @@ void PlaybackManager::stop()
     m_connection->clear_buffer(true);
     m_last_seek = 0;
     m_current_buffer = nullptr;
+    if (m_resampler.has_value())
+        m_resampler->reset();
 
     if (m_loader)
         (void)m_loader->reset();
@@ -75,6 +77,7 @@ void PlaybackManager::seek(const int position)
 
     m_connection->clear_buffer(true);
     m_current_buffer = nullptr;
+    m_resampler->reset();
 
     [[maybe_unused]] auto result = m_loader->seek(position);
 
@@ -127,7 +130,6 @@ void PlaybackManager::next_buffer()
         if (!maybe_buffer.is_error()) {
             m_current_buffer = maybe_buffer.release_value();
             VERIFY(m_resampler.has_value());
-            m_resampler->reset();
             // FIXME: Handle OOM better.
             m_current_buffer = MUST(Audio::resample_buffer(m_resampler.value(), *m_current_buffer));
             m_connection->enqueue(*m_current_buffer);
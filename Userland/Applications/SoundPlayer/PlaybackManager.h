@@ -58,7 +58,7 @@ private:
     NonnullRefPtr<Audio::ConnectionFromClient> m_connection;
     RefPtr<Audio::Buffer> m_current_buffer;
     Queue<i32, always_enqueued_buffer_count + 1> m_enqueued_buffers;
-    Optional<Audio::ResampleHelper<double>> m_resampler;
+    Optional<Audio::PolyphaseResampler> m_resampler;
     RefPtr<Core::Timer> m_timer;
 
     // Controls the GUI update rate. A smaller value makes the visualizations nicer.
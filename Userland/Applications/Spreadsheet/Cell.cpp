@@ -32,6 +32,7 @@ void Cell::set_data(String new_data)
     m_data = move(new_data);
     m_dirty = true;
     m_evaluated_externally = false;
+    m_compiled_formula = nullptr;
 }
 
 void Cell::set_data(JS::Value new_data)
@@ -43,6 +44,7 @@ void Cell::set_data(JS::Value new_data)
 
     builder.append(new_data.to_string_without_side_effects());
     m_data = builder.build();
+    m_compiled_formula = nullptr;
 
     m_evaluated_data = move(new_data);
 }
@@ -98,9 +100,17 @@ void Cell::update_data(Badge<Sheet>)
 
     if (m_dirty) {
         m_dirty = false;
+        // Values written into this cell by other formulas are not evaluated, so the cells that wrote them stay referenced.
+        if (!m_evaluated_externally)
+            clear_references();
+
         if (m_kind == Formula) {
             if (!m_evaluated_externally) {
-                auto value_or_error = m_sheet->evaluate(m_data, this);
+                auto value_or_error = [&]() -> JS::ThrowCompletionOr<JS::Value> {
+                    if (!m_compiled_formula)
+                        m_compiled_formula = TRY(m_sheet->parse(m_data));
+                    return m_sheet->evaluate(*m_compiled_formula, this);
+                }();
                 if (value_or_error.is_error()) {
                     m_evaluated_data = JS::js_undefined();
                     m_thrown_value = *value_or_error.release_error().release_value();
@@ -110,13 +120,6 @@ void Cell::update_data(Badge<Sheet>)
                 }
             }
         }
-
-        for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
-            }
-        }
     }
 
     m_evaluated_formats.background_color.clear();
@@ -175,6 +178,17 @@ void Cell::reference_from(Cell* other)
         return;
 
     m_referencing_cells.append(other->make_weak_ptr());
+    other->m_referenced_cells.append(make_weak_ptr());
+}
+
+void Cell::clear_references()
+{
+    // The next evaluation will record whatever this cell still reads, so stale dependencies don't cause needless updates.
+    for (auto& referenced : m_referenced_cells) {
+        if (referenced)
+            referenced->m_referencing_cells.remove_first_matching([this](auto& ptr) { return ptr.ptr() == this; });
+    }
+    m_referenced_cells.clear();
 }
 
 void Cell::copy_from(const Cell& other)
@@ -182,6 +196,7 @@ void Cell::copy_from(const Cell& other)
     m_dirty = true;
     m_evaluated_externally = other.m_evaluated_externally;
     m_data = other.m_data;
+    m_compiled_formula = nullptr;
     m_evaluated_data = other.m_evaluated_data;
     m_kind = other.m_kind;
     m_type = other.m_type;
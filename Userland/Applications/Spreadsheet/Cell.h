@@ -15,6 +15,7 @@
 #include <AK/Types.h>
 #include <AK/WeakPtr.h>
 #include <LibGUI/Command.h>
+#include <LibJS/Script.h>
 
 namespace Spreadsheet {
 
@@ -48,6 +49,7 @@ struct Cell : public Weakable<Cell> {
     void set_data(String new_data);
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
+    void mark_dirty() { m_dirty = true; }
     void clear_dirty() { m_dirty = false; }
 
     void set_thrown_value(JS::Value value) { m_thrown_value = value; }
@@ -62,6 +64,7 @@ struct Cell : public Weakable<Cell> {
     const JS::Value& evaluated_data() const { return m_evaluated_data; }
     Kind kind() const { return m_kind; }
     const Vector<WeakPtr<Cell>>& referencing_cells() const { return m_referencing_cells; }
+    const Vector<WeakPtr<Cell>>& referenced_cells() const { return m_referenced_cells; }
 
     void set_type(StringView name);
     void set_type(const CellType*);
@@ -105,6 +108,8 @@ struct Cell : public Weakable<Cell> {
     void copy_from(const Cell&);
 
 private:
+    void clear_references();
+
     bool m_dirty { false };
     bool m_evaluated_externally { false };
     String m_data;
@@ -112,7 +117,11 @@ private:
     JS::Value m_thrown_value;
     Kind m_kind { LiteralString };
     WeakPtr<Sheet> m_sheet;
+    // The cells that have to be updated after this one (i.e. that read this cell), and the cells this one read in its last evaluation.
     Vector<WeakPtr<Cell>> m_referencing_cells;
+    Vector<WeakPtr<Cell>> m_referenced_cells;
+    // The parsed formula, kept around so that re-evaluating an unchanged formula doesn't have to parse it again.
+    RefPtr<JS::Script> m_compiled_formula;
     const CellType* m_type { nullptr };
     CellTypeMetadata m_type_metadata;
     Position m_position;
@@ -95,6 +95,7 @@ Optional<FunctionAndArgumentIndex> get_function_and_argument_index(StringView so
 SheetGlobalObject::SheetGlobalObject(Sheet& sheet)
     : m_sheet(sheet)
 {
+    set_may_interfere_with_property_lookup_caching();
 }
 
 JS::ThrowCompletionOr<bool> SheetGlobalObject::internal_has_property(JS::PropertyKey const& name) const
@@ -128,22 +128,95 @@ void Sheet::update()
         return;
     }
     m_visited_cells_in_update.clear();
-    Vector<Cell&> cells_copy;
 
-    // Grab a copy as updates might insert cells into the table.
-    for (auto& it : m_cells) {
-        if (it.value->dirty()) {
-            cells_copy.append(*it.value);
-            m_workbook.set_dirty(true);
+    // Formulas may write to other cells while they're evaluated, so keep going until nothing is dirty anymore.
+    // Every cell is evaluated at most once per update, which also guarantees that this terminates.
+    for (;;) {
+        Vector<Cell&> dirty_cells;
+
+        // Grab a copy as updates might insert cells into the table.
+        for (auto& it : m_cells) {
+            if (it.value->dirty()) {
+                dirty_cells.append(*it.value);
+                m_workbook.set_dirty(true);
+            }
         }
-    }
 
-    for (auto& cell : cells_copy)
-        update(cell);
+        if (dirty_cells.is_empty())
+            break;
+
+        for (auto& cell : cells_in_evaluation_order(move(dirty_cells)))
+            update(cell);
+    }
 
     m_visited_cells_in_update.clear();
 }
 
+// Returns the changed cells and every cell that (transitively) reads them, ordered such that each cell comes after
+// all the cells it reads, so every cell only has to be evaluated once. Cells in a reference cycle come last, in no particular order.
+Vector<Cell&> Sheet::cells_in_evaluation_order(Vector<Cell&> changed_cells)
+{
+    // Maps each affected cell to the number of affected cells it reads that have not been ordered yet.
+    HashMap<Cell*, size_t> unordered_dependencies;
+    Vector<Cell*> worklist;
+
+    for (auto& cell : changed_cells) {
+        if (unordered_dependencies.set(&cell, 0) == AK::HashSetResult::InsertedNewEntry)
+            worklist.append(&cell);
+    }
+
+    auto for_each_affected_dependent = [&](Cell& cell, auto callback) {
+        for (auto& dependent : cell.referencing_cells()) {
+            // FIXME: Cells on other sheets don't tell us when they read from this one, so they can't show up here.
+            if (dependent && &dependent->sheet() == this)
+                callback(*dependent.ptr());
+        }
+    };
+
+    while (!worklist.is_empty()) {
+        auto& cell = *worklist.take_last();
+        for_each_affected_dependent(cell, [&](Cell& dependent) {
+            if (unordered_dependencies.set(&dependent, 0) == AK::HashSetResult::InsertedNewEntry)
+                worklist.append(&dependent);
+        });
+    }
+
+    for (auto& it : unordered_dependencies) {
+        for_each_affected_dependent(*it.key, [&](Cell& dependent) {
+            ++unordered_dependencies.find(&dependent)->value;
+        });
+    }
+
+    Vector<Cell&> order;
+    order.ensure_capacity(unordered_dependencies.size());
+    for (auto& it : unordered_dependencies) {
+        if (it.value == 0)
+            worklist.append(it.key);
+    }
+
+    while (!worklist.is_empty()) {
+        auto& cell = *worklist.take_last();
+        order.unchecked_append(cell);
+        for_each_affected_dependent(cell, [&](Cell& dependent) {
+            if (--unordered_dependencies.find(&dependent)->value == 0)
+                worklist.append(&dependent);
+        });
+    }
+
+    if (order.size() != unordered_dependencies.size()) {
+        for (auto& it : unordered_dependencies) {
+            if (it.value != 0)
+                order.unchecked_append(*it.key);
+        }
+    }
+
+    // Everything that reads a changed cell is out of date too.
+    for (auto& cell : order)
+        cell.mark_dirty();
+
+    return order;
+}
+
 void Sheet::update(Cell& cell)
 {
     if (m_should_ignore_updates) {
@@ -162,15 +235,25 @@ void Sheet::update(Cell& cell)
     }
 }
 
-JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_behalf_of)
+JS::ThrowCompletionOr<NonnullRefPtr<JS::Script>> Sheet::parse(StringView source)
 {
-    TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
-
     auto script_or_error = JS::Script::parse(source, interpreter().realm());
     if (script_or_error.is_error())
         return interpreter().vm().throw_completion<JS::SyntaxError>(interpreter().global_object(), script_or_error.error().first().to_string());
 
-    return interpreter().run(script_or_error.value());
+    return script_or_error.release_value();
+}
+
+JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(StringView source, Cell* on_behalf_of)
+{
+    auto script = TRY(parse(source));
+    return evaluate(*script, on_behalf_of);
+}
+
+JS::ThrowCompletionOr<JS::Value> Sheet::evaluate(JS::Script& script, Cell* on_behalf_of)
+{
+    TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
+    return interpreter().run(script);
 }
 
 Cell* Sheet::at(StringView name)
@@ -669,10 +752,10 @@ JsonObject Sheet::gather_documentation() const
             dbgln("Sheet::gather_documentation(): Failed to parse the documentation for '{}'!", it.key.to_display_string());
     };
 
-    for (auto& it : interpreter().global_object().shape().property_table())
+    for (auto& it : interpreter().global_object().shape().property_table_ordered())
         add_docs_from(it, interpreter().global_object());
 
-    for (auto& it : global_object().shape().property_table())
+    for (auto& it : global_object().shape().property_table_ordered())
         add_docs_from(it, global_object());
 
     m_cached_documentation = move(object);
@@ -107,7 +107,9 @@ public:
         }
     }
 
+    JS::ThrowCompletionOr<NonnullRefPtr<JS::Script>> parse(StringView);
     JS::ThrowCompletionOr<JS::Value> evaluate(StringView, Cell* = nullptr);
+    JS::ThrowCompletionOr<JS::Value> evaluate(JS::Script&, Cell* = nullptr);
     JS::Interpreter& interpreter() const;
     SheetGlobalObject& global_object() const { return *m_global_object; }
 
@@ -134,6 +136,8 @@ private:
     explicit Sheet(Workbook&);
     explicit Sheet(StringView name, Workbook&);
 
+    Vector<Cell&> cells_in_evaluation_order(Vector<Cell&> changed_cells);
+
     String m_name;
     Vector<String> m_columns;
     size_t m_rows { 0 };
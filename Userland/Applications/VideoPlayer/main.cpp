@@ -26,18 +26,21 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     auto const& track = optional_track.value();
     auto const video_track = track.video_track().value();
 
-    auto image = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, Gfx::IntSize(video_track.pixel_height, video_track.pixel_width)).release_value_but_fixme_should_propagate_errors();
+    auto image = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, Gfx::IntSize(video_track.pixel_width, video_track.pixel_height)).release_value_but_fixme_should_propagate_errors();
     auto main_widget = TRY(window->try_set_main_widget<GUI::Widget>());
     main_widget->set_fill_with_background_color(true);
     main_widget->set_layout<GUI::VerticalBoxLayout>();
     auto& image_widget = main_widget->add<GUI::ImageWidget>();
     image_widget.set_bitmap(image);
-    image_widget.set_fixed_size(video_track.pixel_height, video_track.pixel_width);
+    image_widget.set_fixed_size(video_track.pixel_width, video_track.pixel_height);
     TRY(main_widget->try_add_child(image_widget));
 
     Video::VP9::Decoder vp9_decoder;
-    for (auto const& cluster : document->clusters()) {
-        for (auto const& block : cluster.blocks()) {
+    for (size_t cluster_index = 0; cluster_index < document->cluster_count(); ++cluster_index) {
+        auto cluster = Video::MatroskaReader::parse_cluster(*document, cluster_index);
+        if (!cluster)
+            return 1;
+        for (auto const& block : cluster->blocks()) {
             if (block.track_number() != track.track_number())
                 continue;
 
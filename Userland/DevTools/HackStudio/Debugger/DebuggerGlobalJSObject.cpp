@@ -15,6 +15,8 @@ namespace HackStudio {
 
 DebuggerGlobalJSObject::DebuggerGlobalJSObject()
 {
+    set_may_interfere_with_property_lookup_caching();
+
     auto regs = Debugger::the().session()->get_registers();
     auto lib = Debugger::the().session()->library_at(regs.ip());
     if (!lib)
@@ -24,6 +24,7 @@ DebuggerVariableJSObject::DebuggerVariableJSObject(const Debug::DebugInfo::Varia
     : JS::Object(prototype)
     , m_variable_info(variable_info)
 {
+    set_may_interfere_with_property_lookup_caching();
 }
 
 JS::ThrowCompletionOr<bool> DebuggerVariableJSObject::internal_set(const JS::PropertyKey& property_key, JS::Value value, JS::Value)
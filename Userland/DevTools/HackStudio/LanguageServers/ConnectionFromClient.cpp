@@ -15,10 +15,27 @@ namespace LanguageServers {
 
 static HashMap<int, RefPtr<ConnectionFromClient>> s_connections;
 
+static constexpr int pending_edits_delay_ms = 250;
+
 ConnectionFromClient::ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket> socket)
     : IPC::ConnectionFromClient<LanguageClientEndpoint, LanguageServerEndpoint>(*this, move(socket), 1)
 {
     s_connections.set(1, *this);
+    m_pending_edits_timer = Core::Timer::create_single_shot(pending_edits_delay_ms, [this] { flush_pending_edits(); }, this);
+}
+
+void ConnectionFromClient::did_edit_file(String const& filename)
+{
+    m_files_with_pending_edits.set(filename);
+    m_pending_edits_timer->restart();
+}
+
+void ConnectionFromClient::flush_pending_edits()
+{
+    m_pending_edits_timer->stop();
+    auto filenames = move(m_files_with_pending_edits);
+    for (auto& filename : filenames)
+        m_autocomplete_engine->on_edit(filename);
 }
 
 void ConnectionFromClient::die()
@@ -46,6 +63,7 @@ void ConnectionFromClient::file_opened(String const& filename, IPC::File const&
         return;
     }
     m_filedb.add(filename, file.take_fd());
+    flush_pending_edits();
     m_autocomplete_engine->file_opened(filename);
 }
 
@@ -55,7 +73,7 @@ void ConnectionFromClient::file_edit_insert_text(String const& filename, String
     dbgln_if(LANGUAGE_SERVER_DEBUG, "Text: {}", text);
     dbgln_if(LANGUAGE_SERVER_DEBUG, "[{}:{}]", start_line, start_column);
     m_filedb.on_file_edit_insert_text(filename, text, start_line, start_column);
-    m_autocomplete_engine->on_edit(filename);
+    did_edit_file(filename);
 }
 
 void ConnectionFromClient::file_edit_remove_text(String const& filename, i32 start_line, i32 start_column, i32 end_line, i32 end_column)
@@ -63,7 +81,7 @@ void ConnectionFromClient::file_edit_remove_text(String const& filename, i32 sta
     dbgln_if(LANGUAGE_SERVER_DEBUG, "RemoveText for file: {}", filename);
     dbgln_if(LANGUAGE_SERVER_DEBUG, "[{}:{} - {}:{}]", start_line, start_column, end_line, end_column);
     m_filedb.on_file_edit_remove_text(filename, start_line, start_column, end_line, end_column);
-    m_autocomplete_engine->on_edit(filename);
+    did_edit_file(filename);
 }
 
 void ConnectionFromClient::auto_complete_suggestions(GUI::AutocompleteProvider::ProjectLocation const& location)
@@ -76,6 +94,7 @@ void ConnectionFromClient::auto_complete_suggestions(GUI::AutocompleteProvider::
         return;
     }
 
+    flush_pending_edits();
     GUI::TextPosition autocomplete_position = { (size_t)location.line, (size_t)max(location.column, location.column - 1) };
     Vector<GUI::AutocompleteProvider::Entry> suggestions = m_autocomplete_engine->get_suggestions(location.file, autocomplete_position);
     async_auto_complete_suggestions(move(suggestions));
@@ -92,7 +111,7 @@ void ConnectionFromClient::set_file_content(String const& filename, String const
         document->set_text(content.view());
     }
     VERIFY(m_filedb.is_open(filename));
-    m_autocomplete_engine->on_edit(filename);
+    did_edit_file(filename);
 }
 
 void ConnectionFromClient::find_declaration(GUI::AutocompleteProvider::ProjectLocation const& location)
@@ -104,6 +123,7 @@ void ConnectionFromClient::find_declaration(GUI::AutocompleteProvider::ProjectLo
         return;
     }
 
+    flush_pending_edits();
     GUI::TextPosition identifier_position = { (size_t)location.line, (size_t)location.column };
     auto decl_location = m_autocomplete_engine->find_declaration_of(location.file, identifier_position);
     if (!decl_location.has_value()) {
@@ -124,6 +144,7 @@ void ConnectionFromClient::get_parameters_hint(GUI::AutocompleteProvider::Projec
         return;
     }
 
+    flush_pending_edits();
     GUI::TextPosition identifier_position = { (size_t)location.line, (size_t)location.column };
     auto params = m_autocomplete_engine->get_function_params_hint(location.file, identifier_position);
     if (!params.has_value()) {
@@ -149,6 +170,7 @@ void ConnectionFromClient::get_tokens_info(String const& filename)
         return;
     }
 
+    flush_pending_edits();
     auto token_info = m_autocomplete_engine->get_tokens_info(filename);
     async_tokens_info_result(move(token_info));
 }
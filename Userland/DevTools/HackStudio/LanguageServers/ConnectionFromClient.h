@@ -11,7 +11,9 @@
 #include "CodeComprehensionEngine.h"
 #include "FileDB.h"
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/LexicalPath.h>
+#include <LibCore/Timer.h>
 #include <LibIPC/ConnectionFromClient.h>
 
 #include <Userland/DevTools/HackStudio/LanguageServers/LanguageClientEndpoint.h>
@@ -39,6 +41,15 @@ protected:
 
     FileDB m_filedb;
     OwnPtr<CodeComprehensionEngine> m_autocomplete_engine;
+
+private:
+    // Edits arrive a few characters at a time while the user types, so the engine is only told about them
+    // once the typing pauses, or right before it has to answer something about the files.
+    void did_edit_file(String const& filename);
+    void flush_pending_edits();
+
+    HashTable<String> m_files_with_pending_edits;
+    RefPtr<Core::Timer> m_pending_edits_timer;
 };
 
 }
@@ -393,6 +393,11 @@ String CppComprehensionEngine::document_path_from_include_path(StringView includ
 
 void CppComprehensionEngine::on_edit(const String& file)
 {
+    // Edits that cancel each other out leave nothing to reparse.
+    if (auto* document_data = get_document_data(file)) {
+        if (auto document = filedb().get(file); document && document->text() == document_data->text())
+            return;
+    }
     set_document_data(file, create_document_data_for(file));
 }
 
@@ -103,7 +103,7 @@ void LibraryMetadata::handle_mmap(FlatPtr base, size_t size, String const& name)
             if (!mapped_object)
                 return;
         }
-        m_libraries.set(path_string, adopt_own(*new Library { base, size, path_string, mapped_object, {} }));
+        m_libraries.set(path_string, adopt_own(*new Library { base, size, path_string, mapped_object, {}, {} }));
     }
 }
 
@@ -119,7 +119,19 @@ String LibraryMetadata::Library::symbolicate(FlatPtr ptr, u32* offset) const
     if (!object)
         return String::formatted("?? <{:p}>", ptr);
 
-    return object->elf.symbolicate(ptr - base, offset);
+    auto address = ptr - base;
+    if (auto cached = symbol_cache.get(address); cached.has_value()) {
+        if (offset)
+            *offset = cached->offset;
+        return cached->symbol;
+    }
+
+    u32 symbol_offset = 0;
+    auto symbol = object->elf.symbolicate(address, &symbol_offset);
+    symbol_cache.set(address, { symbol, symbol_offset });
+    if (offset)
+        *offset = symbol_offset;
+    return symbol;
 }
 
 LibraryMetadata::Library const* LibraryMetadata::library_containing(FlatPtr ptr) const
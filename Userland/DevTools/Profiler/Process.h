@@ -33,6 +33,14 @@ public:
         // This is loaded lazily because we only need it in disassembly view
         mutable OwnPtr<Debug::DebugInfo> debug_info;
 
+        struct CachedSymbol {
+            String symbol;
+            u32 offset { 0 };
+        };
+        // Samples hit the same few addresses over and over, so remember what they symbolicated to.
+        // This also lets all frames for an address share one symbol string.
+        mutable HashMap<FlatPtr, CachedSymbol> symbol_cache;
+
         String symbolicate(FlatPtr, u32* offset) const;
         Debug::DebugInfo const& load_debug_info(FlatPtr base_address) const;
     };
@@ -273,6 +273,7 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
     HashMap<pid_t, Process*> current_processes;
     Vector<Event> events;
     EventSerialNumber next_serial;
+    HashMap<FlatPtr, LibraryMetadata::Library::CachedSymbol> kernel_symbol_cache;
 
     for (auto const& perf_event_value : perf_events.values()) {
         auto const& perf_event = perf_event_value.as_object();
@@ -396,6 +397,16 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
                 .start_timestamp = perf_event.get("start_timestamp"sv).to_number<size_t>(),
                 .success = perf_event.get("success"sv).to_bool()
             };
+        } else if (type_string == "tracepoint"sv) {
+            event.data = Event::SignpostData {
+                .string = String::formatted("{}:{}", perf_event.get("subsystem"sv).to_string(), perf_event.get("name"sv).to_string()),
+                .arg = perf_event.get("arg1"sv).to_number<FlatPtr>(),
+            };
+        } else if (type_string.is_one_of("cycles"sv, "instructions"sv, "cache_misses"sv, "branch_misses"sv)) {
+            event.data = Event::HardwareCounterData {
+                .counter = type_string,
+                .period = perf_event.get("period"sv).to_number<u32>(),
+            };
         } else {
             dbgln("Unknown event type '{}'", type_string);
             VERIFY_NOT_REACHED();
@@ -406,6 +417,7 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
         auto const* stack = perf_event.get_ptr("stack");
         VERIFY(stack);
         auto const& stack_array = stack->as_array();
+        event.frames.ensure_capacity(stack_array.size());
         for (ssize_t i = stack_array.values().size() - 1; i >= 0; --i) {
             auto const& frame = stack_array.at(i);
             auto ptr = frame.to_number<u64>();
@@ -414,8 +426,12 @@ ErrorOr<NonnullOwnPtr<Profile>> Profile::load_from_perfcore_file(StringView path
             String symbol;
 
             if (maybe_kernel_base.has_value() && ptr >= maybe_kernel_base.value()) {
-                if (g_kernel_debuginfo_object.has_value()) {
+                if (auto cached = kernel_symbol_cache.get(ptr); cached.has_value()) {
+                    symbol = cached->symbol;
+                    offset = cached->offset;
+                } else if (g_kernel_debuginfo_object.has_value()) {
                     symbol = g_kernel_debuginfo_object->elf.symbolicate(ptr - maybe_kernel_base.value(), &offset);
+                    kernel_symbol_cache.set(ptr, { symbol, offset });
                 } else {
                     symbol = String::formatted("?? <{:p}>", ptr);
                 }
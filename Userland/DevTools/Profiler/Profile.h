@@ -72,16 +72,13 @@ public:
         VERIFY(!child.m_parent);
         child.m_parent = this;
         m_children.append(child);
+        m_children_by_symbol.set(child.symbol(), &child);
     }
 
     ProfileNode& find_or_create_child(FlyString const& object_name, String symbol, FlatPtr address, u32 offset, u64 timestamp, pid_t pid)
     {
-        for (size_t i = 0; i < m_children.size(); ++i) {
-            auto& child = m_children[i];
-            if (child->symbol() == symbol) {
-                return child;
-            }
-        }
+        if (auto child = m_children_by_symbol.get(symbol); child.has_value())
+            return *child.value();
         auto new_child = ProfileNode::create(m_process, object_name, move(symbol), address, offset, timestamp, pid);
         add_child(new_child);
         return new_child;
@@ -126,6 +123,7 @@ private:
     u32 m_self_count { 0 };
     u64 m_timestamp { 0 };
     Vector<NonnullRefPtr<ProfileNode>> m_children;
+    HashMap<String, ProfileNode*> m_children_by_symbol;
     HashMap<FlatPtr, size_t> m_events_per_address;
     Bitmap m_seen_events;
 };
@@ -231,7 +229,12 @@ public:
             bool success;
         };
 
-        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData> data { nullptr };
+        struct HardwareCounterData {
+            String counter;
+            u32 period { 0 };
+        };
+
+        Variant<std::nullptr_t, SampleData, MallocData, FreeData, SignpostData, MmapData, MunmapData, ProcessCreateData, ProcessExecData, ThreadCreateData, ReadData, HardwareCounterData> data { nullptr };
     };
 
     Vector<Event> const& events() const { return m_events; }
@@ -47,6 +47,8 @@ String SamplesModel::column_name(int column) const
         return "Innermost Frame";
     case Column::Path:
         return "Path";
+    case Column::Counter:
+        return "Counter";
     default:
         VERIFY_NOT_REACHED();
     }
@@ -95,6 +97,12 @@ GUI::Variant SamplesModel::data(GUI::ModelIndex const& index, GUI::ModelRole rol
             return event.data.get<Profile::Event::ReadData>().path;
         }
 
+        if (index.column() == Column::Counter) {
+            if (!event.data.has<Profile::Event::HardwareCounterData>())
+                return "";
+            return event.data.get<Profile::Event::HardwareCounterData>().counter;
+        }
+
         return {};
     }
     return {};
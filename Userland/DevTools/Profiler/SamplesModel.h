@@ -29,6 +29,7 @@ public:
         LostSamples,
         InnermostStackFrame,
         Path,
+        Counter,
         __Count
     };
 
@@ -72,6 +72,11 @@ Emulator::Emulator(String const& executable_path, Vector<StringView> const& argu
     setup_signal_trampoline();
 }
 
+SoftCPU& Emulator::cpu()
+{
+    return *m_cpu;
+}
+
 Vector<ELF::AuxiliaryValue> Emulator::generate_auxiliary_vector(FlatPtr load_base, FlatPtr entry_eip, String const& executable_path, int executable_fd) const
 {
     // FIXME: This is not fully compatible with the auxiliary vector the kernel generates, this is just the bare
@@ -234,7 +239,7 @@ int Emulator::exec()
     while (!m_shutdown) {
         if (m_steps_til_pause) [[likely]] {
             m_cpu->save_base_eip();
-            auto insn = X86::Instruction::from_stream(*m_cpu, true, true);
+            auto insn = m_cpu->fetch_instruction();
             // Exec cycle
             if constexpr (trace) {
                 outln("{:p}  \033[33;1m{}\033[0m", m_cpu->base_eip(), insn.to_string(m_cpu->base_eip(), symbol_provider));
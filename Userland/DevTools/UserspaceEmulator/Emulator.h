@@ -66,6 +66,7 @@ public:
     u32 virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3);
 
     SoftMMU& mmu() { return m_mmu; }
+    SoftCPU& cpu();
 
     MallocTracer* malloc_tracer() { return m_malloc_tracer; }
 
@@ -162,6 +163,9 @@ private:
     int virt$disown(pid_t);
     int virt$dup2(int, int);
     int virt$emuctl(FlatPtr, FlatPtr, FlatPtr);
+    int virt$epoll_create(int flags);
+    int virt$epoll_ctl(FlatPtr);
+    int virt$epoll_wait(FlatPtr);
     int virt$execve(FlatPtr);
     void virt$exit(int);
     int virt$fchmod(int, mode_t);
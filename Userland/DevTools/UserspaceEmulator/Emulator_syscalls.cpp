@@ -18,6 +18,7 @@
 #include <serenity.h>
 #include <strings.h>
 #include <sys/ioctl.h>
+#include <sys/epoll.h>
 #include <sys/mman.h>
 #include <sys/poll.h>
 #include <sys/socket.h>
@@ -77,6 +78,12 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$dup2(arg1, arg2);
     case SC_emuctl:
         return virt$emuctl(arg1, arg2, arg3);
+    case SC_epoll_create:
+        return virt$epoll_create(arg1);
+    case SC_epoll_ctl:
+        return virt$epoll_ctl(arg1);
+    case SC_epoll_wait:
+        return virt$epoll_wait(arg1);
     case SC_execve:
         return virt$execve(arg1);
     case SC_exit:
@@ -1005,6 +1012,8 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
                 return IterationDecision::Break;
             }
             auto& mmap_region = *(MmapRegion*)region;
+            if (mmap_region.is_executable())
+                m_cpu->invalidate_code_caches();
             mmap_region.set_prot(prot);
         }
         return IterationDecision::Continue;
@@ -1235,6 +1244,50 @@ int Emulator::virt$fork()
     return rc;
 }
 
+int Emulator::virt$epoll_create(int flags)
+{
+    return syscall(SC_epoll_create, flags);
+}
+
+int Emulator::virt$epoll_ctl(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_ctl_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    epoll_event event {};
+    if (params.event)
+        mmu().copy_from_vm(&event, (FlatPtr)params.event, sizeof(event));
+
+    Syscall::SC_epoll_ctl_params host_params = params;
+    host_params.event = params.event ? &event : nullptr;
+    return syscall(SC_epoll_ctl, &host_params);
+}
+
+int Emulator::virt$epoll_wait(FlatPtr params_addr)
+{
+    Syscall::SC_epoll_wait_params params;
+    mmu().copy_from_vm(&params, params_addr, sizeof(params));
+
+    if (params.maxevents <= 0 || params.maxevents > FD_SETSIZE)
+        return -EINVAL;
+
+    Vector<epoll_event, FD_SETSIZE> events;
+    events.resize(params.maxevents);
+    struct timespec timeout;
+    u32 sigmask;
+
+    if (params.timeout)
+        mmu().copy_from_vm(&timeout, (FlatPtr)params.timeout, sizeof(timeout));
+    if (params.sigmask)
+        mmu().copy_from_vm(&sigmask, (FlatPtr)params.sigmask, sizeof(sigmask));
+
+    Syscall::SC_epoll_wait_params host_params { params.epfd, events.data(), params.maxevents, params.timeout ? &timeout : nullptr, params.sigmask ? &sigmask : nullptr };
+    int rc = syscall(SC_epoll_wait, &host_params);
+    if (rc > 0)
+        mmu().copy_to_vm((FlatPtr)params.events, events.data(), sizeof(epoll_event) * rc);
+    return rc;
+}
+
 int Emulator::virt$execve(FlatPtr params_addr)
 {
     Syscall::SC_execve_params params;
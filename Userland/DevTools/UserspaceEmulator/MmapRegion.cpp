@@ -26,11 +26,22 @@ static void free_pages(void* ptr, size_t bytes)
     VERIFY(rc == 0);
 }
 
+static size_t shadow_bits_size_for(u32 size)
+{
+    // Pad the bitmap so that a 64-bit window can be loaded starting at any byte of it.
+    return ceil_div(size, 8u) + sizeof(u64);
+}
+
+static u8* allocate_shadow_bits(u32 size)
+{
+    // Everything starts out initialized.
+    return (u8*)mmap_initialized(shadow_bits_size_for(size), (char)0xff, "MmapRegion ShadowData");
+}
+
 NonnullOwnPtr<MmapRegion> MmapRegion::create_anonymous(u32 base, u32 size, u32 prot, String name)
 {
     auto* data = (u8*)mmap_initialized(size, 0, String::formatted("(UE) {}", name).characters());
-    auto* shadow_data = (u8*)mmap_initialized(size, 1, "MmapRegion ShadowData");
-    auto region = adopt_own(*new MmapRegion(base, size, prot, data, shadow_data));
+    auto region = adopt_own(*new MmapRegion(base, size, prot, data, allocate_shadow_bits(size), shadow_bits_size_for(size)));
     region->m_name = move(name);
     return region;
 }
@@ -41,17 +52,17 @@ NonnullOwnPtr<MmapRegion> MmapRegion::create_file_backed(u32 base, u32 size, u32
     auto real_flags = flags & ~(MAP_FIXED | MAP_FIXED_NOREPLACE);
     auto* data = (u8*)mmap_with_name(nullptr, size, prot, real_flags, fd, offset, name.is_empty() ? nullptr : String::formatted("(UE) {}", name).characters());
     VERIFY(data != MAP_FAILED);
-    auto* shadow_data = (u8*)mmap_initialized(size, 1, "MmapRegion ShadowData");
-    auto region = adopt_own(*new MmapRegion(base, size, prot, data, shadow_data));
+    auto region = adopt_own(*new MmapRegion(base, size, prot, data, allocate_shadow_bits(size), shadow_bits_size_for(size)));
     region->m_file_backed = true;
     region->m_name = move(name);
     return region;
 }
 
-MmapRegion::MmapRegion(u32 base, u32 size, int prot, u8* data, u8* shadow_data)
+MmapRegion::MmapRegion(u32 base, u32 size, int prot, u8* data, u8* shadow_bits, size_t shadow_bits_size)
     : Region(base, size, true)
     , m_data(data)
-    , m_shadow_data(shadow_data)
+    , m_shadow_bits(shadow_bits)
+    , m_shadow_bits_size(shadow_bits_size)
 {
     set_prot(prot);
 }
@@ -59,7 +70,60 @@ MmapRegion::MmapRegion(u32 base, u32 size, int prot, u8* data, u8* shadow_data)
 MmapRegion::~MmapRegion()
 {
     free_pages(m_data, size());
-    free_pages(m_shadow_data, size());
+    free_pages(m_shadow_bits, m_shadow_bits_size);
+}
+
+template<size_t count>
+ALWAYS_INLINE Array<u8, count> MmapRegion::read_shadow(u32 offset) const
+{
+    static_assert(count <= 32);
+    u64 window;
+    ByteReader::load(m_shadow_bits + offset / 8, window);
+    u64 mask = ((1ull << count) - 1) << (offset % 8);
+
+    Array<u8, count> shadow;
+    if ((window & mask) == mask) [[likely]] {
+        shadow.fill(0x01);
+        return shadow;
+    }
+    for (size_t i = 0; i < count; ++i)
+        shadow[i] = (window >> (offset % 8 + i)) & 1;
+    return shadow;
+}
+
+template<size_t count>
+ALWAYS_INLINE void MmapRegion::write_shadow(u32 offset, Array<u8, count> const& shadow)
+{
+    static_assert(count <= 32);
+    u64 bits = 0;
+    for (size_t i = 0; i < count; ++i)
+        bits |= u64(shadow[i] & 1) << i;
+
+    u64 window;
+    ByteReader::load(m_shadow_bits + offset / 8, window);
+    u64 mask = ((1ull << count) - 1) << (offset % 8);
+    window = (window & ~mask) | (bits << (offset % 8));
+    ByteReader::store(m_shadow_bits + offset / 8, window);
+}
+
+void MmapRegion::fill_shadow(u32 offset, size_t size, u8 shadow)
+{
+    VERIFY(offset + size <= this->size());
+    bool initialized = shadow & 0x01;
+    auto set_bit = [&](u32 bit) {
+        if (initialized)
+            m_shadow_bits[bit / 8] |= 1 << (bit % 8);
+        else
+            m_shadow_bits[bit / 8] &= ~(1 << (bit % 8));
+    };
+
+    // Go bit by bit up to the first whole byte of the bitmap, then fill whole bytes at once.
+    for (; size && offset % 8; ++offset, --size)
+        set_bit(offset);
+    memset(m_shadow_bits + offset / 8, initialized ? 0xff : 0x00, size / 8);
+    offset += size / 8 * 8;
+    for (size %= 8; size; ++offset, --size)
+        set_bit(offset);
 }
 
 ValueWithShadow<u8> MmapRegion::read8(FlatPtr offset)
@@ -76,7 +140,7 @@ ValueWithShadow<u8> MmapRegion::read8(FlatPtr offset)
     }
 
     VERIFY(offset < size());
-    return { m_data[offset], m_shadow_data[offset] };
+    return { m_data[offset], read_shadow<1>(offset) };
 }
 
 ValueWithShadow<u16> MmapRegion::read16(u32 offset)
@@ -93,11 +157,10 @@ ValueWithShadow<u16> MmapRegion::read16(u32 offset)
     }
 
     VERIFY(offset + 1 < size());
-    u16 value, shadow;
+    u16 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, read_shadow<2>(offset) };
 }
 
 ValueWithShadow<u32> MmapRegion::read32(u32 offset)
@@ -114,11 +177,10 @@ ValueWithShadow<u32> MmapRegion::read32(u32 offset)
     }
 
     VERIFY(offset + 3 < size());
-    u32 value, shadow;
+    u32 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, read_shadow<4>(offset) };
 }
 
 ValueWithShadow<u64> MmapRegion::read64(u32 offset)
@@ -135,11 +197,10 @@ ValueWithShadow<u64> MmapRegion::read64(u32 offset)
     }
 
     VERIFY(offset + 7 < size());
-    u64 value, shadow;
+    u64 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
 
-    return { value, shadow };
+    return { value, read_shadow<8>(offset) };
 }
 
 ValueWithShadow<u128> MmapRegion::read128(u32 offset)
@@ -156,10 +217,9 @@ ValueWithShadow<u128> MmapRegion::read128(u32 offset)
     }
 
     VERIFY(offset + 15 < size());
-    u128 value, shadow;
+    u128 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
-    return { value, shadow };
+    return { value, read_shadow<16>(offset) };
 }
 
 ValueWithShadow<u256> MmapRegion::read256(u32 offset)
@@ -176,10 +236,9 @@ ValueWithShadow<u256> MmapRegion::read256(u32 offset)
     }
 
     VERIFY(offset + 31 < size());
-    u256 value, shadow;
+    u256 value;
     ByteReader::load(m_data + offset, value);
-    ByteReader::load(m_shadow_data + offset, shadow);
-    return { value, shadow };
+    return { value, read_shadow<32>(offset) };
 }
 
 void MmapRegion::write8(u32 offset, ValueWithShadow<u8> value)
@@ -197,7 +256,7 @@ void MmapRegion::write8(u32 offset, ValueWithShadow<u8> value)
 
     VERIFY(offset < size());
     m_data[offset] = value.value();
-    m_shadow_data[offset] = value.shadow()[0];
+    write_shadow<1>(offset, value.shadow());
 }
 
 void MmapRegion::write16(u32 offset, ValueWithShadow<u16> value)
@@ -215,7 +274,7 @@ void MmapRegion::write16(u32 offset, ValueWithShadow<u16> value)
 
     VERIFY(offset + 1 < size());
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    write_shadow<2>(offset, value.shadow());
 }
 
 void MmapRegion::write32(u32 offset, ValueWithShadow<u32> value)
@@ -232,9 +291,8 @@ void MmapRegion::write32(u32 offset, ValueWithShadow<u32> value)
     }
 
     VERIFY(offset + 3 < size());
-    VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    write_shadow<4>(offset, value.shadow());
 }
 
 void MmapRegion::write64(u32 offset, ValueWithShadow<u64> value)
@@ -251,9 +309,8 @@ void MmapRegion::write64(u32 offset, ValueWithShadow<u64> value)
     }
 
     VERIFY(offset + 7 < size());
-    VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    write_shadow<8>(offset, value.shadow());
 }
 
 void MmapRegion::write128(u32 offset, ValueWithShadow<u128> value)
@@ -269,9 +326,8 @@ void MmapRegion::write128(u32 offset, ValueWithShadow<u128> value)
             tracer->audit_write(*this, base() + offset, 16);
     }
     VERIFY(offset + 15 < size());
-    VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    write_shadow<16>(offset, value.shadow());
 }
 
 void MmapRegion::write256(u32 offset, ValueWithShadow<u256> value)
@@ -287,9 +343,8 @@ void MmapRegion::write256(u32 offset, ValueWithShadow<u256> value)
             tracer->audit_write(*this, base() + offset, 32);
     }
     VERIFY(offset + 31 < size());
-    VERIFY(m_data != m_shadow_data);
     ByteReader::store(m_data + offset, value.value());
-    ByteReader::store(m_shadow_data + offset, value.shadow());
+    write_shadow<32>(offset, value.shadow());
 }
 
 NonnullOwnPtr<MmapRegion> MmapRegion::split_at(VirtualAddress offset)
@@ -298,7 +353,10 @@ NonnullOwnPtr<MmapRegion> MmapRegion::split_at(VirtualAddress offset)
     VERIFY(!m_malloc_metadata);
     Range new_range = range();
     Range other_range = new_range.split_at(offset);
-    auto other_region = adopt_own(*new MmapRegion(other_range.base().get(), other_range.size(), prot(), data() + new_range.size(), shadow_data() + new_range.size()));
+    auto* other_shadow_bits = allocate_shadow_bits(other_range.size());
+    // The split is page-aligned, so the other region's bits start on a byte boundary of our bitmap.
+    memcpy(other_shadow_bits, m_shadow_bits + new_range.size() / 8, ceil_div(other_range.size(), 8u));
+    auto other_region = adopt_own(*new MmapRegion(other_range.base().get(), other_range.size(), prot(), data() + new_range.size(), other_shadow_bits, shadow_bits_size_for(other_range.size())));
     other_region->m_file_backed = m_file_backed;
     other_region->m_name = m_name;
     set_range(new_range);
@@ -35,7 +35,7 @@ public:
     virtual void write256(u32 offset, ValueWithShadow<u256>) override;
 
     virtual u8* data() override { return m_data; }
-    virtual u8* shadow_data() override { return m_shadow_data; }
+    virtual void fill_shadow(u32 offset, size_t size, u8 shadow) override;
 
     bool is_malloc_block() const { return m_malloc; }
     void set_malloc(bool b) { m_malloc = b; }
@@ -64,10 +64,18 @@ public:
     void set_name(String name);
 
 private:
-    MmapRegion(u32 base, u32 size, int prot, u8* data, u8* shadow_data);
+    MmapRegion(u32 base, u32 size, int prot, u8* data, u8* shadow_bits, size_t shadow_bits_size);
+
+    template<size_t count>
+    Array<u8, count> read_shadow(u32 offset) const;
+    template<size_t count>
+    void write_shadow(u32 offset, Array<u8, count> const&);
 
     u8* m_data { nullptr };
-    u8* m_shadow_data { nullptr };
+
+    // The shadow memory is a bitmap with one bit per byte of data, set if that byte is initialized.
+    u8* m_shadow_bits { nullptr };
+    size_t m_shadow_bits_size { 0 };
     bool m_file_backed { false };
     bool m_malloc { false };
 
@@ -60,7 +60,9 @@ public:
     void set_executable(bool b) { m_executable = b; }
 
     virtual u8* data() = 0;
-    virtual u8* shadow_data() = 0;
+
+    // Marks `size` bytes starting at `offset` as initialized or not, according to bit 0 of `shadow`.
+    virtual void fill_shadow(u32 offset, size_t size, u8 shadow) = 0;
 
     Emulator& emulator() { return m_emulator; }
     const Emulator& emulator() const { return m_emulator; }
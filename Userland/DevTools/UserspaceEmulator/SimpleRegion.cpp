@@ -121,6 +121,12 @@ void SimpleRegion::write256(u32 offset, ValueWithShadow<u256> value)
     ByteReader::store(m_shadow_data + offset, value.shadow());
 }
 
+void SimpleRegion::fill_shadow(u32 offset, size_t size, u8 shadow)
+{
+    VERIFY(offset + size <= this->size());
+    memset(m_shadow_data + offset, shadow, size);
+}
+
 u8* SimpleRegion::cacheable_ptr(u32 offset)
 {
     return m_data + offset;
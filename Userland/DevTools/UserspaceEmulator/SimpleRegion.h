@@ -30,7 +30,9 @@ public:
     virtual void write256(u32 offset, ValueWithShadow<u256>) override;
 
     virtual u8* data() override { return m_data; }
-    virtual u8* shadow_data() override { return m_shadow_data; }
+    u8* shadow_data() { return m_shadow_data; }
+
+    virtual void fill_shadow(u32 offset, size_t size, u8 shadow) override;
 
     virtual u8* cacheable_ptr(u32 offset) override;
 
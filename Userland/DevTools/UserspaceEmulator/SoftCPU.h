@@ -11,7 +11,9 @@
 #include "Region.h"
 #include "SoftFPU.h"
 #include "ValueWithShadow.h"
+#include <AK/Array.h>
 #include <AK/ByteReader.h>
+#include <AK/Optional.h>
 #include <LibX86/Instruction.h>
 #include <LibX86/Interpreter.h>
 
@@ -60,6 +62,9 @@ public:
         m_eip = eip;
     }
 
+    X86::Instruction fetch_instruction();
+    void invalidate_code_caches();
+
     struct Flags {
         enum Flag {
             CF = 0x0001, // 0b0000'0000'0000'0001
@@ -1260,8 +1265,34 @@ private:
 
     Region* m_cached_code_region { nullptr };
     u8* m_cached_code_base_ptr { nullptr };
+
+    // Decoded instructions, direct-mapped by address. Only instructions from non-writable code
+    // regions are cached, so the cache only has to be flushed when the memory map changes.
+    struct CachedInstruction {
+        u32 address { 0 };
+        Optional<X86::Instruction> instruction;
+    };
+    static constexpr size_t instruction_cache_size = 4096;
+    Array<CachedInstruction, instruction_cache_size> m_instruction_cache;
 };
 
+ALWAYS_INLINE X86::Instruction SoftCPU::fetch_instruction()
+{
+    auto& entry = m_instruction_cache[m_eip & (instruction_cache_size - 1)];
+    if (entry.instruction.has_value() && entry.address == m_eip) [[likely]] {
+        m_eip += entry.instruction->length();
+        return *entry.instruction;
+    }
+
+    u32 address = m_eip;
+    auto insn = X86::Instruction::from_stream(*this, true, true);
+    if (!m_cached_code_region->is_writable() && m_cached_code_region->contains(address)) {
+        entry.address = address;
+        entry.instruction = insn;
+    }
+    return insn;
+}
+
 ALWAYS_INLINE u8 SoftCPU::read8()
 {
     if (!m_cached_code_region || !m_cached_code_region->contains(m_eip))
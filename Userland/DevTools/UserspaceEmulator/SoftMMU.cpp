@@ -8,6 +8,8 @@
 #include "Emulator.h"
 #include "MmapRegion.h"
 #include "Report.h"
+#include "SoftCPU.h"
+#include <AK/AnyOf.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Memory.h>
 #include <AK/QuickSort.h>
@@ -35,6 +37,9 @@ void SoftMMU::add_region(NonnullOwnPtr<Region> region)
 
 void SoftMMU::remove_region(Region& region)
 {
+    if (region.is_executable())
+        m_emulator.cpu().invalidate_code_caches();
+
     size_t first_page_in_region = region.base() / PAGE_SIZE;
     for (size_t i = 0; i < ceil_div(region.size(), PAGE_SIZE); ++i) {
         m_page_to_region_map[first_page_in_region + i] = nullptr;
@@ -347,7 +352,7 @@ bool SoftMMU::fast_fill_memory8(X86::LogicalAddress address, size_t size, ValueW
 
     size_t offset_in_region = address.offset() - region->base();
     memset(region->data() + offset_in_region, value.value(), size);
-    memset(region->shadow_data() + offset_in_region, value.shadow()[0], size);
+    region->fill_shadow(offset_in_region, size, value.shadow()[0]);
     return true;
 }
 
@@ -361,6 +366,12 @@ bool SoftMMU::fast_fill_memory32(X86::LogicalAddress address, size_t count, Valu
     if (!region->contains(address.offset() + (count * sizeof(u32)) - 1))
         return false;
 
+    // Regions only track shadow state per byte, so a fill pattern mixing initialized and
+    // uninitialized bytes has to take the slow path.
+    auto shadow = value.shadow();
+    if (any_of(shadow, [&](u8 byte) { return (byte & 0x01) != (shadow[0] & 0x01); }))
+        return false;
+
     if (is<MmapRegion>(*region) && static_cast<const MmapRegion&>(*region).is_malloc_block()) {
         if (auto* tracer = m_emulator.malloc_tracer()) {
             // FIXME: Add a way to audit an entire range of memory instead of looping here!
@@ -372,7 +383,7 @@ bool SoftMMU::fast_fill_memory32(X86::LogicalAddress address, size_t count, Valu
 
     size_t offset_in_region = address.offset() - region->base();
     fast_u32_fill((u32*)(region->data() + offset_in_region), value.value(), count);
-    fast_u32_fill((u32*)(region->shadow_data() + offset_in_region), value.shadow_as_value(), count);
+    region->fill_shadow(offset_in_region, count * sizeof(u32), shadow[0]);
     return true;
 }
 
@@ -5,10 +5,17 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
 #include <LibArchive/Zip.h>
+#include <LibCompress/Deflate.h>
+#include <LibCrypto/Checksum/CRC32.h>
 
 namespace Archive {
 
+// How much of a member's contents is read, decompressed or compressed at a time.
+static constexpr size_t member_chunk_size = 64 * KiB;
+
 bool Zip::find_end_of_central_directory_offset(ReadonlyBytes buffer, size_t& offset)
 {
     for (size_t backwards_offset = 0; backwards_offset <= UINT16_MAX; backwards_offset++) // the file may have a trailing comment of an arbitrary 16 bit length
@@ -46,10 +53,8 @@ Optional<Zip> Zip::try_create(ReadonlyBytes buffer)
             return {};
         if (!central_directory_record.read(buffer.slice(member_offset)))
             return {};
-        if (central_directory_record.general_purpose_flags & 1)
+        if (central_directory_record.general_purpose_flags & zip_encrypted_flag)
             return {}; // TODO: support encrypted zip members
-        if (central_directory_record.general_purpose_flags & 3)
-            return {}; // TODO: support zip data descriptors
         if (central_directory_record.compression_method != ZipCompressionMethod::Store && central_directory_record.compression_method != ZipCompressionMethod::Deflate)
             return {}; // TODO: support obsolete zip compression methods
         if (central_directory_record.compression_method == ZipCompressionMethod::Store && central_directory_record.uncompressed_size != central_directory_record.compressed_size)
@@ -103,6 +108,81 @@ bool Zip::for_each_member(Function<IterationDecision(const ZipMember&)> callback
     return true;
 }
 
+ErrorOr<void> ZipMember::decompress(Function<ErrorOr<void>(ReadonlyBytes)> const& callback) const
+{
+    Crypto::Checksum::CRC32 checksum;
+    size_t decompressed_size = 0;
+    auto hand_over = [&](ReadonlyBytes bytes) -> ErrorOr<void> {
+        checksum.update(bytes);
+        decompressed_size += bytes.size();
+        return callback(bytes);
+    };
+
+    switch (compression_method) {
+    case ZipCompressionMethod::Store:
+        for (size_t offset = 0; offset < compressed_data.size(); offset += member_chunk_size)
+            TRY(hand_over(compressed_data.slice(offset, min(member_chunk_size, compressed_data.size() - offset))));
+        break;
+    case ZipCompressionMethod::Deflate: {
+        InputMemoryStream compressed_stream { compressed_data };
+        // NOTE: This is too big to comfortably live on the stack of a secondary thread.
+        auto deflate_stream = make<Compress::DeflateDecompressor>(compressed_stream);
+        auto buffer = TRY(ByteBuffer::create_uninitialized(member_chunk_size));
+        for (;;) {
+            auto nread = deflate_stream->read(buffer);
+            // Both streams have to have their errors handled, even if the first one has failed already.
+            bool failed = deflate_stream->handle_any_error();
+            failed |= compressed_stream.handle_any_error();
+            if (failed)
+                return Error::from_string_literal("Failed to decompress zip member"sv);
+            if (nread == 0)
+                break;
+            TRY(hand_over(buffer.bytes().trim(nread)));
+        }
+        break;
+    }
+    default:
+        // Zip::try_create() doesn't let anything else through.
+        VERIFY_NOT_REACHED();
+    }
+
+    if (decompressed_size != uncompressed_size)
+        return Error::from_string_literal("Zip member doesn't have the size it claims to have"sv);
+    if (checksum.digest() != crc32)
+        return Error::from_string_literal("Zip member doesn't match its CRC32"sv);
+    return {};
+}
+
+// Passes everything it's given on to another stream, keeping count of how much that was.
+class CountingOutputStream final : public OutputStream {
+public:
+    explicit CountingOutputStream(OutputStream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    size_t count() const { return m_count; }
+
+    size_t write(ReadonlyBytes bytes) override
+    {
+        auto nwritten = m_stream.write(bytes);
+        m_count += nwritten;
+        return nwritten;
+    }
+
+    bool write_or_error(ReadonlyBytes bytes) override
+    {
+        if (!m_stream.write_or_error(bytes))
+            return false;
+        m_count += bytes.size();
+        return true;
+    }
+
+private:
+    OutputStream& m_stream;
+    size_t m_count { 0 };
+};
+
 ZipOutputStream::ZipOutputStream(OutputStream& stream)
     : m_stream(stream)
 {
@@ -119,7 +199,17 @@ void ZipOutputStream::add_member(const ZipMember& member)
     VERIFY(!m_finished);
     VERIFY(member.name.length() <= UINT16_MAX);
     VERIFY(member.compressed_data.size() <= UINT32_MAX);
-    m_members.append(member);
+    VERIFY(m_offset <= UINT32_MAX);
+    m_members.append({
+        .name = member.name,
+        .compression_method = member.compression_method,
+        .general_purpose_flags = 0,
+        .compressed_size = static_cast<u32>(member.compressed_data.size()),
+        .uncompressed_size = member.uncompressed_size,
+        .crc32 = member.crc32,
+        .is_directory = member.is_directory,
+        .local_file_header_offset = static_cast<u32>(m_offset),
+    });
 
     LocalFileHeader local_file_header {
         .minimum_version = minimum_version_needed(member.compression_method),
@@ -137,26 +227,103 @@ void ZipOutputStream::add_member(const ZipMember& member)
         .compressed_data = member.compressed_data.data(),
     };
     local_file_header.write(m_stream);
+    m_offset += local_file_header.size();
+}
+
+ErrorOr<size_t> ZipOutputStream::add_member_from_stream(String const& name, InputStream& stream, ZipCompressionMethod compression_method)
+{
+    VERIFY(!m_finished);
+    VERIFY(name.length() <= UINT16_MAX);
+    VERIFY(compression_method == ZipCompressionMethod::Store || compression_method == ZipCompressionMethod::Deflate);
+    if (m_offset > UINT32_MAX)
+        return Error::from_string_literal("Zip archive is too large"sv); // TODO: support Zip64
+
+    auto local_file_header_offset = static_cast<u32>(m_offset);
+    LocalFileHeader local_file_header {
+        .minimum_version = minimum_version_needed(compression_method),
+        .general_purpose_flags = zip_data_descriptor_flag,
+        .compression_method = static_cast<u16>(compression_method),
+        .modification_time = 0, // TODO: support modification time
+        .modification_date = 0,
+        .crc32 = 0,
+        .compressed_size = 0,
+        .uncompressed_size = 0,
+        .name_length = static_cast<u16>(name.length()),
+        .extra_data_length = 0,
+        .name = reinterpret_cast<u8 const*>(name.characters()),
+        .extra_data = nullptr,
+        .compressed_data = nullptr,
+    };
+    local_file_header.write(m_stream);
+    m_offset += local_file_header.size();
+
+    CountingOutputStream compressed_stream { m_stream };
+    OwnPtr<Compress::DeflateCompressor> deflate_stream;
+    if (compression_method == ZipCompressionMethod::Deflate)
+        deflate_stream = make<Compress::DeflateCompressor>(compressed_stream);
+    OutputStream& data_stream = deflate_stream ? static_cast<OutputStream&>(*deflate_stream) : compressed_stream;
+
+    Crypto::Checksum::CRC32 checksum;
+    size_t uncompressed_size = 0;
+    auto buffer = TRY(ByteBuffer::create_uninitialized(member_chunk_size));
+    for (;;) {
+        auto nread = stream.read(buffer);
+        if (stream.handle_any_error()) {
+            if (deflate_stream)
+                deflate_stream->final_flush();
+            return Error::from_string_literal("Failed to read zip member contents"sv);
+        }
+        if (nread == 0)
+            break;
+        checksum.update(buffer.bytes().trim(nread));
+        uncompressed_size += nread;
+        data_stream.write_or_error(buffer.bytes().trim(nread));
+    }
+    if (deflate_stream)
+        deflate_stream->final_flush();
+
+    if (uncompressed_size > UINT32_MAX || compressed_stream.count() > UINT32_MAX)
+        return Error::from_string_literal("Zip member is too large"sv); // TODO: support Zip64
+
+    DataDescriptor data_descriptor {
+        .crc32 = checksum.digest(),
+        .compressed_size = static_cast<u32>(compressed_stream.count()),
+        .uncompressed_size = static_cast<u32>(uncompressed_size),
+    };
+    data_descriptor.write(m_stream);
+    m_offset += compressed_stream.count() + DataDescriptor::size();
+
+    m_members.append({
+        .name = name,
+        .compression_method = compression_method,
+        .general_purpose_flags = zip_data_descriptor_flag,
+        .compressed_size = data_descriptor.compressed_size,
+        .uncompressed_size = data_descriptor.uncompressed_size,
+        .crc32 = data_descriptor.crc32,
+        .is_directory = false,
+        .local_file_header_offset = local_file_header_offset,
+    });
+    return compressed_stream.count();
 }
 
 void ZipOutputStream::finish()
 {
     VERIFY(!m_finished);
+    VERIFY(m_offset <= UINT32_MAX);
     m_finished = true;
 
-    auto file_header_offset = 0u;
     auto central_directory_size = 0u;
-    for (const ZipMember& member : m_members) {
+    for (auto const& member : m_members) {
         auto zip_version = minimum_version_needed(member.compression_method);
         CentralDirectoryRecord central_directory_record {
             .made_by_version = zip_version,
             .minimum_version = zip_version,
-            .general_purpose_flags = 0,
+            .general_purpose_flags = member.general_purpose_flags,
             .compression_method = member.compression_method,
             .modification_time = 0, // TODO: support modification time
             .modification_date = 0,
             .crc32 = member.crc32,
-            .compressed_size = static_cast<u32>(member.compressed_data.size()),
+            .compressed_size = member.compressed_size,
             .uncompressed_size = member.uncompressed_size,
             .name_length = static_cast<u16>(member.name.length()),
             .extra_data_length = 0,
@@ -164,12 +331,11 @@ void ZipOutputStream::finish()
             .start_disk = 0,
             .internal_attributes = 0,
             .external_attributes = member.is_directory ? zip_directory_external_attribute : 0,
-            .local_file_header_offset = file_header_offset, // FIXME: we assume the wrapped output stream was never written to before us
+            .local_file_header_offset = member.local_file_header_offset,
             .name = reinterpret_cast<u8 const*>(member.name.characters()),
             .extra_data = nullptr,
             .comment = nullptr,
         };
-        file_header_offset += sizeof(LocalFileHeader::signature) + (sizeof(LocalFileHeader) - (sizeof(u8*) * 3)) + member.name.length() + member.compressed_data.size();
         central_directory_record.write(m_stream);
         central_directory_size += central_directory_record.size();
     }
@@ -180,7 +346,7 @@ void ZipOutputStream::finish()
         .disk_records_count = static_cast<u16>(m_members.size()),
         .total_records_count = static_cast<u16>(m_members.size()),
         .central_directory_size = central_directory_size,
-        .central_directory_offset = file_header_offset,
+        .central_directory_offset = static_cast<u32>(m_offset),
         .comment_length = 0,
         .comment = nullptr,
     };
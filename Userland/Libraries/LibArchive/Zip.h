@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Array.h>
+#include <AK/Error.h>
 #include <AK/Function.h>
 #include <AK/IterationDecision.h>
 #include <AK/Stream.h>
@@ -29,6 +30,7 @@ static bool read_helper(ReadonlyBytes buffer, T* self)
 }
 
 // NOTE: Due to the format of zip files compression is streamed and decompression is random access.
+//       Member contents are streamed in both directions though, and never have to be in memory all at once.
 
 static constexpr auto signature_length = 4;
 
@@ -140,6 +142,10 @@ struct [[gnu::packed]] CentralDirectoryRecord {
 };
 static constexpr u32 zip_directory_external_attribute = 1 << 4;
 
+static constexpr u16 zip_encrypted_flag = 1 << 0;
+// The CRC32 and sizes in the local file header are zero, and follow the member's data in a DataDescriptor instead.
+static constexpr u16 zip_data_descriptor_flag = 1 << 3;
+
 struct [[gnu::packed]] LocalFileHeader {
     static constexpr Array<u8, signature_length> signature = { 0x50, 0x4b, 0x03, 0x04 }; // 'PK\x03\x04'
 
@@ -190,6 +196,32 @@ struct [[gnu::packed]] LocalFileHeader {
         if (compressed_size > 0)
             stream.write_or_error({ compressed_data, compressed_size });
     }
+
+    [[nodiscard]] size_t size() const
+    {
+        return signature.size() + (sizeof(LocalFileHeader) - (sizeof(u8*) * 3)) + name_length + extra_data_length + compressed_size;
+    }
+};
+
+struct [[gnu::packed]] DataDescriptor {
+    static constexpr Array<u8, signature_length> signature = { 0x50, 0x4b, 0x07, 0x08 }; // 'PK\x07\x08'
+
+    u32 crc32;
+    u32 compressed_size;
+    u32 uncompressed_size;
+
+    void write(OutputStream& stream) const
+    {
+        stream.write_or_error(signature);
+        stream << crc32;
+        stream << compressed_size;
+        stream << uncompressed_size;
+    }
+
+    [[nodiscard]] static constexpr size_t size()
+    {
+        return signature.size() + sizeof(DataDescriptor);
+    }
 };
 
 enum ZipCompressionMethod : u16 {
@@ -206,11 +238,15 @@ enum ZipCompressionMethod : u16 {
 
 struct ZipMember {
     String name;
-    ReadonlyBytes compressed_data; // TODO: maybe the decompression/compression should be handled by LibArchive instead of the user?
+    ReadonlyBytes compressed_data;
     ZipCompressionMethod compression_method;
     u32 uncompressed_size;
     u32 crc32;
     bool is_directory;
+
+    // Hands the decompressed contents to `callback` a piece at a time, and fails if they don't match the size and CRC32
+    // the archive claims they have. Stored members are handed over straight out of the archive, without being copied.
+    ErrorOr<void> decompress(Function<ErrorOr<void>(ReadonlyBytes)> const& callback) const;
 };
 
 class Zip {
@@ -236,11 +272,28 @@ class ZipOutputStream {
 public:
     ZipOutputStream(OutputStream&);
     void add_member(const ZipMember&);
+    // Adds a member whose contents are read from `stream` and compressed bit by bit, rather than all at once.
+    // Since its CRC32 and sizes aren't known until the end, they go into a data descriptor after the data.
+    // Returns the compressed size.
+    ErrorOr<size_t> add_member_from_stream(String const& name, InputStream& stream, ZipCompressionMethod);
     void finish();
 
 private:
+    struct MemberRecord {
+        String name;
+        ZipCompressionMethod compression_method;
+        u16 general_purpose_flags;
+        u32 compressed_size;
+        u32 uncompressed_size;
+        u32 crc32;
+        bool is_directory;
+        u32 local_file_header_offset;
+    };
+
     OutputStream& m_stream;
-    Vector<ZipMember> m_members;
+    Vector<MemberRecord> m_members;
+    // FIXME: We assume the wrapped output stream was never written to before us.
+    size_t m_offset { 0 };
 
     bool m_finished { false };
 };
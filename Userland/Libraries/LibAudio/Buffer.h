@@ -89,7 +89,6 @@ private:
     const int m_sample_count { 0 };
 };
 
-// This only works for double resamplers, and therefore cannot be part of the class
-ErrorOr<NonnullRefPtr<Buffer>> resample_buffer(ResampleHelper<double>& resampler, Buffer const& to_resample);
+ErrorOr<NonnullRefPtr<Buffer>> resample_buffer(PolyphaseResampler& resampler, Buffer const& to_resample);
 
 }
@@ -39,6 +39,27 @@ bool ConnectionFromClient::try_enqueue(Buffer const& buffer)
     return enqueue_buffer(buffer.anonymous_buffer(), buffer.id(), buffer.sample_count());
 }
 
+ErrorOr<void> ConnectionFromClient::create_ring_buffer(size_t sample_capacity)
+{
+    auto ring_buffer = TRY(SharedRingBuffer::create(sample_capacity));
+    if (!set_ring_buffer(ring_buffer.anonymous_buffer()))
+        return Error::from_string_literal("AudioServer didn't accept the ring buffer");
+    m_ring_buffer = move(ring_buffer);
+    return {};
+}
+
+size_t ConnectionFromClient::write_to_ring_buffer(Span<Sample const> samples)
+{
+    VERIFY(m_ring_buffer.has_value());
+    return m_ring_buffer->write(samples);
+}
+
+size_t ConnectionFromClient::ring_buffer_free_space() const
+{
+    VERIFY(m_ring_buffer.has_value());
+    return m_ring_buffer->available_to_write();
+}
+
 void ConnectionFromClient::finished_playing_buffer(i32 buffer_id)
 {
     if (on_finish_playing_buffer)
@@ -8,6 +8,7 @@
 
 #include <AudioServer/AudioClientEndpoint.h>
 #include <AudioServer/AudioServerEndpoint.h>
+#include <LibAudio/SharedRingBuffer.h>
 #include <LibIPC/ConnectionToServer.h>
 
 namespace Audio {
@@ -23,6 +24,13 @@ public:
     bool try_enqueue(Buffer const&);
     void async_enqueue(Buffer const&);
 
+    // Instead of enqueueing buffers, samples can be written into a ring buffer that is shared with the server.
+    // This needs no IPC at all, and the server plays the samples as soon as the mixer gets to them.
+    ErrorOr<void> create_ring_buffer(size_t sample_capacity);
+    // Returns how many of the samples fit into the ring buffer; the rest have to be written again later.
+    size_t write_to_ring_buffer(Span<Sample const>);
+    size_t ring_buffer_free_space() const;
+
     Function<void(i32 buffer_id)> on_finish_playing_buffer;
     Function<void(bool muted)> on_main_mix_muted_state_change;
     Function<void(double volume)> on_main_mix_volume_change;
@@ -35,6 +43,8 @@ private:
     virtual void main_mix_muted_state_changed(bool) override;
     virtual void main_mix_volume_changed(double) override;
     virtual void client_volume_changed(double) override;
+
+    Optional<SharedRingBuffer> m_ring_buffer;
 };
 
 }
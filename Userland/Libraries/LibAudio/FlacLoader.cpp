@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Debug.h>
 #include <AK/FixedArray.h>
 #include <AK/FlyString.h>
@@ -118,14 +119,17 @@ MaybeLoaderError FlacLoaderPlugin::parse_header()
     md5_checksum.bytes().copy_to({ m_md5_checksum, sizeof(m_md5_checksum) });
 
     // Parse other blocks
-    // TODO: For a simple first implementation, all other blocks are skipped as allowed by the FLAC specification.
-    // Especially the SEEKTABLE block may become useful in a more sophisticated version.
+    // Apart from the SEEKTABLE, all other blocks are skipped as allowed by the FLAC specification.
     [[maybe_unused]] u16 meta_blocks_parsed = 1;
     [[maybe_unused]] u16 total_meta_blocks = meta_blocks_parsed;
     FlacRawMetadataBlock block = streaminfo;
     while (!block.is_last_block) {
         block = TRY(next_meta_block(*bit_input));
         ++total_meta_blocks;
+        if (block.type == FlacMetadataBlockType::SEEKTABLE) {
+            TRY(parse_seektable(block));
+            ++meta_blocks_parsed;
+        }
     }
 
     dbgln_if(AFLACLOADER_DEBUG, "Parsed FLAC header: blocksize {}-{}{}, framesize {}-{}, {}Hz, {}bit, {} channels, {} samples total ({:.2f}s), MD5 {}, data start at {:x} bytes, {} headers total (skipped {})", m_min_block_size, m_max_block_size, is_fixed_blocksize_stream() ? " (constant)" : "", m_min_frame_size, m_max_frame_size, m_sample_rate, pcm_bits_per_sample(m_sample_format), m_num_channels, m_total_samples, static_cast<double>(m_total_samples) / static_cast<double>(m_sample_rate), md5_checksum, m_data_start_location, total_meta_blocks, total_meta_blocks - meta_blocks_parsed);
@@ -157,19 +161,93 @@ ErrorOr<FlacRawMetadataBlock, LoaderError> FlacLoaderPlugin::next_meta_block(Big
         block_data,
     };
 }
+
+MaybeLoaderError FlacLoaderPlugin::parse_seektable(FlacRawMetadataBlock& block)
+{
+    constexpr size_t seek_point_size = 18;
+    FLAC_VERIFY(block.data.size() % seek_point_size == 0, LoaderError::Category::Format, "Seektable size");
+
+    auto seektable_memory = LOADER_TRY(Core::Stream::MemoryStream::construct(block.data.bytes()));
+    auto seektable_data = LOADER_TRY(BigEndianInputBitStream::construct(*seektable_memory));
+    m_seektable.clear();
+    LOADER_TRY(m_seektable.try_ensure_capacity(block.data.size() / seek_point_size));
+    for (size_t i = 0; i < block.data.size() / seek_point_size; ++i) {
+        FlacSeekPoint seek_point {
+            LOADER_TRY(seektable_data->read_bits<u64>(64)),
+            LOADER_TRY(seektable_data->read_bits<u64>(64)),
+            LOADER_TRY(seektable_data->read_bits<u16>(16)),
+        };
+        // Placeholders (which have all bits of the sample index set) come last and don't point anywhere.
+        if (seek_point.sample_index == NumericLimits<u64>::max())
+            break;
+        // Seek points have to be in ascending order; if they aren't, we can't trust them for seeking.
+        FLAC_VERIFY(m_seektable.is_empty() || seek_point.sample_index > m_seektable.last().sample_index, LoaderError::Category::Format, "Seek points out of order");
+        m_seektable.unchecked_append(seek_point);
+    }
+    dbgln_if(AFLACLOADER_DEBUG, "Parsed seektable with {} seek points", m_seektable.size());
+    return {};
+}
 #undef FLAC_VERIFY
 
 MaybeLoaderError FlacLoaderPlugin::reset()
 {
-    TRY(seek(m_data_start_location));
+    if (m_stream->seek(m_data_start_location, Core::Stream::SeekMode::SetPosition).is_error())
+        return LoaderError { LoaderError::IO, m_loaded_samples, "Couldn't seek to the start of the audio data" };
+    m_loaded_samples = 0;
+    m_unread_data.clear_with_capacity();
     m_current_frame.clear();
     return {};
 }
 
-MaybeLoaderError FlacLoaderPlugin::seek(const int position)
+MaybeLoaderError FlacLoaderPlugin::seek(const int sample_index)
 {
-    if (m_stream->seek(position, Core::Stream::SeekMode::SetPosition).is_error())
-        return LoaderError { LoaderError::IO, m_loaded_samples, String::formatted("Invalid seek position {}", position) };
+    if (sample_index < 0 || (!sample_count_unknown() && static_cast<u64>(sample_index) > m_total_samples))
+        return LoaderError { LoaderError::IO, m_loaded_samples, String::formatted("Invalid seek position {}", sample_index) };
+    u64 target = sample_index;
+
+    // The target may still be in the rest of the current frame.
+    u64 next_frame_start = m_loaded_samples + m_unread_data.size();
+    if (target >= m_loaded_samples && target < next_frame_start) {
+        m_unread_data.remove(0, target - m_loaded_samples);
+        m_loaded_samples = target;
+        return {};
+    }
+
+    // Otherwise, we continue from the closest frame before the target that we know about:
+    // the closest seek point, the next frame, or the start of the stream.
+    Optional<FlacSeekPoint> seek_point;
+    for (auto const& point : m_seektable) {
+        if (point.sample_index > target)
+            break;
+        seek_point = point;
+    }
+    bool can_continue_from_next_frame = target >= next_frame_start;
+    if (seek_point.has_value() && (!can_continue_from_next_frame || seek_point->sample_index > next_frame_start)) {
+        if (m_stream->seek(m_data_start_location + seek_point->byte_offset, Core::Stream::SeekMode::SetPosition).is_error())
+            return LoaderError { LoaderError::IO, m_loaded_samples, String::formatted("Invalid seek point for sample {}", seek_point->sample_index) };
+        m_loaded_samples = seek_point->sample_index;
+        m_unread_data.clear_with_capacity();
+        m_current_frame.clear();
+    } else if (!can_continue_from_next_frame) {
+        TRY(reset());
+    } else {
+        m_loaded_samples = next_frame_start;
+        m_unread_data.clear_with_capacity();
+    }
+
+    // Decode and drop whole frames until we reach the one with the target in it.
+    while (m_loaded_samples < target) {
+        TRY(next_frame({}));
+        auto frame_sample_count = m_unread_data.size();
+        if (m_loaded_samples + frame_sample_count > target) {
+            m_unread_data.remove(0, target - m_loaded_samples);
+            m_loaded_samples = target;
+            break;
+        }
+        m_loaded_samples += frame_sample_count;
+        m_unread_data.clear_with_capacity();
+    }
+    dbgln_if(AFLACLOADER_DEBUG, "Seeked to sample {}", target);
     return {};
 }
 
@@ -197,7 +275,8 @@ LoaderSamples FlacLoaderPlugin::get_more_samples(size_t max_bytes_to_read_from_i
 
     while (sample_index < samples_to_read) {
         TRY(next_frame(samples.span().slice(sample_index)));
-        sample_index += m_current_frame->sample_count;
+        // Whatever didn't fit anymore went to m_unread_data, and doesn't count as loaded yet.
+        sample_index += min<size_t>(m_current_frame->sample_count, samples_to_read - sample_index);
     }
 
     m_loaded_samples += sample_index;
@@ -271,13 +350,12 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
     };
 
     u8 subframe_count = frame_channel_type_to_channel_count(channel_type);
-    Vector<Vector<i32>> current_subframes;
-    current_subframes.ensure_capacity(subframe_count);
+    if (m_subframe_samples.size() < subframe_count)
+        LOADER_TRY(m_subframe_samples.try_resize(subframe_count));
 
     for (u8 i = 0; i < subframe_count; ++i) {
         FlacSubframeHeader new_subframe = TRY(next_subframe_header(*bit_stream, i));
-        Vector<i32> subframe_samples = TRY(parse_subframe(new_subframe, *bit_stream));
-        current_subframes.unchecked_append(move(subframe_samples));
+        TRY(parse_subframe(m_subframe_samples[i], new_subframe, *bit_stream));
     }
 
     bit_stream->align_to_byte_boundary();
@@ -286,75 +364,58 @@ MaybeLoaderError FlacLoaderPlugin::next_frame(Span<Sample> target_vector)
     [[maybe_unused]] u16 footer_checksum = LOADER_TRY(bit_stream->read_bits<u16>(16));
     dbgln_if(AFLACLOADER_DEBUG, "Subframe footer checksum: {}", footer_checksum);
 
-    Vector<i32> left;
-    Vector<i32> right;
+    // The channels are decorrelated in place, the subframe buffers are overwritten by the next frame anyway.
+    Span<i32> left = m_subframe_samples[0].span();
+    Span<i32> right = subframe_count > 1 ? m_subframe_samples[1].span() : left;
+    VERIFY(left.size() == right.size() && left.size() == m_current_frame->sample_count);
 
     switch (channel_type) {
-    case FlacFrameChannelType::Mono:
-        left = right = current_subframes[0];
-        break;
-    case FlacFrameChannelType::Stereo:
-    // TODO mix together surround channels on each side?
-    case FlacFrameChannelType::StereoCenter:
-    case FlacFrameChannelType::Surround4p0:
-    case FlacFrameChannelType::Surround5p0:
-    case FlacFrameChannelType::Surround5p1:
-    case FlacFrameChannelType::Surround6p1:
-    case FlacFrameChannelType::Surround7p1:
-        left = current_subframes[0];
-        right = current_subframes[1];
-        break;
     case FlacFrameChannelType::LeftSideStereo:
         // channels are left (0) and side (1)
-        left = current_subframes[0];
-        right.ensure_capacity(left.size());
         for (size_t i = 0; i < left.size(); ++i) {
             // right = left - side
-            right.unchecked_append(left[i] - current_subframes[1][i]);
+            right[i] = left[i] - right[i];
         }
         break;
     case FlacFrameChannelType::RightSideStereo:
         // channels are side (0) and right (1)
-        right = current_subframes[1];
-        left.ensure_capacity(right.size());
         for (size_t i = 0; i < right.size(); ++i) {
             // left = right + side
-            left.unchecked_append(right[i] + current_subframes[0][i]);
+            left[i] = right[i] + left[i];
         }
         break;
     case FlacFrameChannelType::MidSideStereo:
         // channels are mid (0) and side (1)
-        left.ensure_capacity(current_subframes[0].size());
-        right.ensure_capacity(current_subframes[0].size());
-        for (size_t i = 0; i < current_subframes[0].size(); ++i) {
-            i64 mid = current_subframes[0][i];
-            i64 side = current_subframes[1][i];
-            mid *= 2;
-            // prevent integer division errors
-            left.unchecked_append(static_cast<i32>((mid + side) / 2));
-            right.unchecked_append(static_cast<i32>((mid - side) / 2));
+        for (size_t i = 0; i < left.size(); ++i) {
+            i64 mid = left[i];
+            i64 side = right[i];
+            // The lowest bit of mid was dropped when encoding, but it's the same as the lowest bit of side.
+            mid = (mid * 2) | (side & 1);
+            left[i] = static_cast<i32>((mid + side) >> 1);
+            right[i] = static_cast<i32>((mid - side) >> 1);
         }
         break;
+    // TODO mix together surround channels on each side?
+    default:
+        break;
     }
 
-    VERIFY(left.size() == right.size() && left.size() == m_current_frame->sample_count);
-
-    double sample_rescale = static_cast<double>(1 << (pcm_bits_per_sample(m_current_frame->bit_depth) - 1));
-    dbgln_if(AFLACLOADER_DEBUG, "Sample rescaled from {} bits: factor {:.1f}", pcm_bits_per_sample(m_current_frame->bit_depth), sample_rescale);
+    double sample_rescale = 1.0 / static_cast<double>(1 << (pcm_bits_per_sample(m_current_frame->bit_depth) - 1));
+    dbgln_if(AFLACLOADER_DEBUG, "Sample rescaled from {} bits: factor {:.1f}", pcm_bits_per_sample(m_current_frame->bit_depth), 1.0 / sample_rescale);
 
     // zip together channels
     auto samples_to_directly_copy = min(target_vector.size(), m_current_frame->sample_count);
     for (size_t i = 0; i < samples_to_directly_copy; ++i) {
-        Sample frame = { left[i] / sample_rescale, right[i] / sample_rescale };
+        Sample frame = { left[i] * sample_rescale, right[i] * sample_rescale };
         target_vector[i] = frame;
     }
     // move superfluous data into the class buffer instead
-    auto result = m_unread_data.try_grow_capacity(m_current_frame->sample_count - samples_to_directly_copy);
+    auto result = m_unread_data.try_grow_capacity(m_unread_data.size() + m_current_frame->sample_count - samples_to_directly_copy);
     if (result.is_error())
         return LoaderError { LoaderError::Category::Internal, static_cast<size_t>(samples_to_directly_copy + m_current_sample_or_frame), "Couldn't allocate sample buffer for superfluous data" };
 
     for (size_t i = samples_to_directly_copy; i < m_current_frame->sample_count; ++i) {
-        Sample frame = { left[i] / sample_rescale, right[i] / sample_rescale };
+        Sample frame = { left[i] * sample_rescale, right[i] * sample_rescale };
         m_unread_data.unchecked_append(frame);
     }
 
@@ -509,16 +570,18 @@ ErrorOr<FlacSubframeHeader, LoaderError> FlacLoaderPlugin::next_subframe_header(
     };
 }
 
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::parse_subframe(Vector<i32>& samples, FlacSubframeHeader& subframe_header, BigEndianInputBitStream& bit_input)
 {
-    Vector<i32> samples;
+    // After the first few frames, this doesn't allocate anymore.
+    samples.clear_with_capacity();
+    if (samples.try_ensure_capacity(m_current_frame->sample_count).is_error())
+        return LoaderError { LoaderError::Category::Internal, static_cast<size_t>(m_current_sample_or_frame), "Couldn't allocate subframe buffer" };
 
     switch (subframe_header.type) {
     case FlacSubframeType::Constant: {
         u64 constant_value = LOADER_TRY(bit_input.read_bits<u64>(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample));
         dbgln_if(AFLACLOADER_DEBUG, "Constant subframe: {}", constant_value);
 
-        samples.ensure_capacity(m_current_frame->sample_count);
         VERIFY(subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample != 0);
         i32 constant = sign_extend(static_cast<u32>(constant_value), subframe_header.bits_per_sample - subframe_header.wasted_bits_per_sample);
         for (u32 i = 0; i < m_current_frame->sample_count; ++i) {
@@ -528,37 +591,39 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::parse_subframe(FlacSubframeH
     }
     case FlacSubframeType::Fixed: {
         dbgln_if(AFLACLOADER_DEBUG, "Fixed LPC subframe order {}", subframe_header.order);
-        samples = TRY(decode_fixed_lpc(subframe_header, bit_input));
+        TRY(decode_fixed_lpc(samples, subframe_header, bit_input));
         break;
     }
     case FlacSubframeType::Verbatim: {
         dbgln_if(AFLACLOADER_DEBUG, "Verbatim subframe");
-        samples = TRY(decode_verbatim(subframe_header, bit_input));
+        TRY(decode_verbatim(samples, subframe_header, bit_input));
         break;
     }
     case FlacSubframeType::LPC: {
         dbgln_if(AFLACLOADER_DEBUG, "Custom LPC subframe order {}", subframe_header.order);
-        samples = TRY(decode_custom_lpc(subframe_header, bit_input));
+        TRY(decode_custom_lpc(samples, subframe_header, bit_input));
         break;
     }
     default:
         return LoaderError { LoaderError::Category::Unimplemented, static_cast<size_t>(m_current_sample_or_frame), "Unhandled FLAC subframe type" };
     }
 
-    for (size_t i = 0; i < samples.size(); ++i) {
-        samples[i] <<= subframe_header.wasted_bits_per_sample;
+    if (subframe_header.wasted_bits_per_sample != 0) {
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] <<= subframe_header.wasted_bits_per_sample;
+        }
     }
 
-    ResampleHelper<i32> resampler(m_current_frame->sample_rate, m_sample_rate);
-    return resampler.resample(samples);
+    if (m_current_frame->sample_rate != m_sample_rate) {
+        ResampleHelper<i32> resampler(m_current_frame->sample_rate, m_sample_rate);
+        samples = resampler.resample(samples);
+    }
+    return {};
 }
 
 // Decode a subframe that isn't actually encoded, usually seen in random data
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_verbatim(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_verbatim(Vector<i32>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
-
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
     for (size_t i = 0; i < m_current_frame->sample_count; ++i) {
         decoded.unchecked_append(sign_extend(
@@ -566,22 +631,80 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_verbatim(FlacSubframe
             subframe.bits_per_sample - subframe.wasted_bits_per_sample));
     }
 
-    return decoded;
+    return {};
 }
 
-// Decode a subframe encoded with a custom linear predictor coding, i.e. the subframe provides the polynomial order and coefficients
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_warm_up_samples(Vector<i32>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
+    if (subframe.order > m_current_frame->sample_count)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Predictor order larger than the block size" };
 
     VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
-    // warm-up samples
     for (auto i = 0; i < subframe.order; ++i) {
         decoded.unchecked_append(sign_extend(
             LOADER_TRY(bit_input.read_bits<u32>(subframe.bits_per_sample - subframe.wasted_bits_per_sample)),
             subframe.bits_per_sample - subframe.wasted_bits_per_sample));
     }
+    return {};
+}
+
+// Adds the prediction (the dot product of the coefficients with the preceding samples) to the residual of every sample after the warm-up.
+// With the order known at compile time, the inner loop is unrolled completely, which is what makes the difference for the common orders.
+// Accumulator is u32 when the prediction is known to fit into 32 bits, as it wraps around instead of overflowing on broken streams.
+template<typename Accumulator, size_t order>
+static void restore_lpc_signal(Span<i32> decoded, Span<i32 const> coefficients, u8 shift)
+{
+    for (size_t i = order; i < decoded.size(); ++i) {
+        Accumulator prediction = 0;
+        for (size_t t = 0; t < order; ++t)
+            prediction += static_cast<Accumulator>(coefficients[t]) * static_cast<Accumulator>(decoded[i - t - 1]);
+        decoded[i] += static_cast<i32>(static_cast<MakeSigned<Accumulator>>(prediction) >> shift);
+    }
+}
+
+template<typename Accumulator>
+static void restore_lpc_signal(Span<i32> decoded, Span<i32 const> coefficients, u8 shift)
+{
+    switch (coefficients.size()) {
+    case 1:
+        return restore_lpc_signal<Accumulator, 1>(decoded, coefficients, shift);
+    case 2:
+        return restore_lpc_signal<Accumulator, 2>(decoded, coefficients, shift);
+    case 3:
+        return restore_lpc_signal<Accumulator, 3>(decoded, coefficients, shift);
+    case 4:
+        return restore_lpc_signal<Accumulator, 4>(decoded, coefficients, shift);
+    case 5:
+        return restore_lpc_signal<Accumulator, 5>(decoded, coefficients, shift);
+    case 6:
+        return restore_lpc_signal<Accumulator, 6>(decoded, coefficients, shift);
+    case 7:
+        return restore_lpc_signal<Accumulator, 7>(decoded, coefficients, shift);
+    case 8:
+        return restore_lpc_signal<Accumulator, 8>(decoded, coefficients, shift);
+    case 9:
+        return restore_lpc_signal<Accumulator, 9>(decoded, coefficients, shift);
+    case 10:
+        return restore_lpc_signal<Accumulator, 10>(decoded, coefficients, shift);
+    case 11:
+        return restore_lpc_signal<Accumulator, 11>(decoded, coefficients, shift);
+    case 12:
+        return restore_lpc_signal<Accumulator, 12>(decoded, coefficients, shift);
+    }
+
+    // Higher orders than the reference encoder uses in any of its presets.
+    for (size_t i = coefficients.size(); i < decoded.size(); ++i) {
+        Accumulator prediction = 0;
+        for (size_t t = 0; t < coefficients.size(); ++t)
+            prediction += static_cast<Accumulator>(coefficients[t]) * static_cast<Accumulator>(decoded[i - t - 1]);
+        decoded[i] += static_cast<i32>(static_cast<MakeSigned<Accumulator>>(prediction) >> shift);
+    }
+}
+
+// Decode a subframe encoded with a custom linear predictor coding, i.e. the subframe provides the polynomial order and coefficients
+MaybeLoaderError FlacLoaderPlugin::decode_custom_lpc(Vector<i32>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+{
+    TRY(decode_warm_up_samples(decoded, subframe, bit_input));
 
     // precision of the coefficients
     u8 lpc_precision = LOADER_TRY(bit_input.read_bits<u8>(4));
@@ -591,14 +714,16 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubfra
 
     // shift needed on the data (signed!)
     i8 lpc_shift = sign_extend(LOADER_TRY(bit_input.read_bits<u8>(5)), 5);
+    if (lpc_shift < 0)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Negative linear predictor shift" };
 
-    Vector<i32> coefficients;
-    coefficients.ensure_capacity(subframe.order);
+    // The order is at most 32.
+    Array<i32, 32> coefficient_storage;
+    auto coefficients = coefficient_storage.span().trim(subframe.order);
     // read coefficients
     for (auto i = 0; i < subframe.order; ++i) {
         u32 raw_coefficient = LOADER_TRY(bit_input.read_bits<u32>(lpc_precision));
-        i32 coefficient = static_cast<i32>(sign_extend(raw_coefficient, lpc_precision));
-        coefficients.unchecked_append(coefficient);
+        coefficients[i] = static_cast<i32>(sign_extend(raw_coefficient, lpc_precision));
     }
 
     dbgln_if(AFLACLOADER_DEBUG, "{}-bit {} shift coefficients: {}", lpc_precision, lpc_shift, coefficients);
@@ -606,35 +731,23 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_custom_lpc(FlacSubfra
     TRY(decode_residual(decoded, subframe, bit_input));
 
     // approximate the waveform with the predictor
-    for (size_t i = subframe.order; i < m_current_frame->sample_count; ++i) {
-        // (see below)
-        i64 sample = 0;
-        for (size_t t = 0; t < subframe.order; ++t) {
-            // It's really important that we compute in 64-bit land here.
-            // Even though FLAC operates at a maximum bit depth of 32 bits, modern encoders use super-large coefficients for maximum compression.
-            // These will easily overflow 32 bits and cause strange white noise that abruptly stops intermittently (at the end of a frame).
-            // The simple fix of course is to do intermediate computations in 64 bits.
-            sample += static_cast<i64>(coefficients[t]) * static_cast<i64>(decoded[i - t - 1]);
-        }
-        decoded[i] += sample >> lpc_shift;
-    }
+    // It's really important that we compute in 64-bit land here, unless we know that the prediction fits into 32 bits.
+    // Even though FLAC operates at a maximum bit depth of 32 bits, modern encoders use super-large coefficients for maximum compression.
+    // These will easily overflow 32 bits and cause strange white noise that abruptly stops intermittently (at the end of a frame).
+    // Each product has at most bits_per_sample + lpc_precision bits, and adding up `order` of them takes another log2(order) bits.
+    size_t sum_bits = subframe.order > 1 ? AK::log2(static_cast<u32>(subframe.order - 1)) + 1 : 0;
+    if (subframe.bits_per_sample + lpc_precision + sum_bits <= 32)
+        restore_lpc_signal<u32>(decoded.span(), coefficients, lpc_shift);
+    else
+        restore_lpc_signal<i64>(decoded.span(), coefficients, lpc_shift);
 
-    return decoded;
+    return {};
 }
 
 // Decode a subframe encoded with one of the fixed linear predictor codings
-ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+MaybeLoaderError FlacLoaderPlugin::decode_fixed_lpc(Vector<i32>& decoded, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
 {
-    Vector<i32> decoded;
-    decoded.ensure_capacity(m_current_frame->sample_count);
-
-    VERIFY(subframe.bits_per_sample - subframe.wasted_bits_per_sample != 0);
-    // warm-up samples
-    for (auto i = 0; i < subframe.order; ++i) {
-        decoded.unchecked_append(sign_extend(
-            LOADER_TRY(bit_input.read_bits<u32>(subframe.bits_per_sample - subframe.wasted_bits_per_sample)),
-            subframe.bits_per_sample - subframe.wasted_bits_per_sample));
-    }
+    TRY(decode_warm_up_samples(decoded, subframe, bit_input));
 
     TRY(decode_residual(decoded, subframe, bit_input));
 
@@ -643,8 +756,6 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubfram
     switch (subframe.order) {
     case 0:
         // s_0(t) = 0
-        for (u32 i = subframe.order; i < m_current_frame->sample_count; ++i)
-            decoded[i] += 0;
         break;
     case 1:
         // s_1(t) = s(t-1)
@@ -669,7 +780,7 @@ ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_fixed_lpc(FlacSubfram
     default:
         return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), String::formatted("Unrecognized predictor order {}", subframe.order) };
     }
-    return decoded;
+    return {};
 }
 
 // Decode the residual, the "error" between the function approximation and the actual audio data
@@ -679,18 +790,18 @@ MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSub
     u8 partition_order = LOADER_TRY(bit_input.read_bits<u8>(4));
     size_t partitions = 1 << partition_order;
 
+    // The partitions have to divide up the block evenly, and the first one has to have room for the warm-up samples.
+    if (m_current_frame->sample_count % partitions != 0 || m_current_frame->sample_count / partitions < subframe.order)
+        return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Invalid residual partition order" };
+
     if (residual_mode == FlacResidualMode::Rice4Bit) {
         // decode a single Rice partition with four bits for the order k
-        for (size_t i = 0; i < partitions; ++i) {
-            auto rice_partition = TRY(decode_rice_partition(4, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(decoded, 4, partitions, i, subframe, bit_input));
     } else if (residual_mode == FlacResidualMode::Rice5Bit) {
         // five bits equivalent
-        for (size_t i = 0; i < partitions; ++i) {
-            auto rice_partition = TRY(decode_rice_partition(5, partitions, i, subframe, bit_input));
-            decoded.extend(move(rice_partition));
-        }
+        for (size_t i = 0; i < partitions; ++i)
+            TRY(decode_rice_partition(decoded, 5, partitions, i, subframe, bit_input));
     } else
         return LoaderError { LoaderError::Category::Format, static_cast<size_t>(m_current_sample_or_frame), "Reserved residual coding method" };
 
@@ -698,35 +809,29 @@ MaybeLoaderError FlacLoaderPlugin::decode_residual(Vector<i32>& decoded, FlacSub
 }
 
 // Decode a single Rice partition as part of the residual, every partition can have its own Rice parameter k
-ALWAYS_INLINE ErrorOr<Vector<i32>, LoaderError> FlacLoaderPlugin::decode_rice_partition(u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
+ALWAYS_INLINE MaybeLoaderError FlacLoaderPlugin::decode_rice_partition(Vector<i32>& decoded, u8 partition_type, u32 partitions, u32 partition_index, FlacSubframeHeader& subframe, BigEndianInputBitStream& bit_input)
 {
     // Rice parameter / Exp-Golomb order
     u8 k = LOADER_TRY(bit_input.read_bits<u8>(partition_type));
 
-    u32 residual_sample_count;
-    if (partitions == 0)
-        residual_sample_count = m_current_frame->sample_count - subframe.order;
-    else
-        residual_sample_count = m_current_frame->sample_count / partitions;
+    u32 residual_sample_count = m_current_frame->sample_count / partitions;
     if (partition_index == 0)
         residual_sample_count -= subframe.order;
 
-    Vector<i32> rice_partition;
-    rice_partition.resize(residual_sample_count);
-
     // escape code for unencoded binary partition
     if (k == (1 << partition_type) - 1) {
         u8 unencoded_bps = LOADER_TRY(bit_input.read_bits<u8>(5));
         for (size_t r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = LOADER_TRY(bit_input.read_bits<u8>(unencoded_bps));
+            i32 residual = unencoded_bps == 0 ? 0 : static_cast<i32>(sign_extend(LOADER_TRY(bit_input.read_bits<u32>(unencoded_bps)), unencoded_bps));
+            decoded.unchecked_append(residual);
         }
     } else {
         for (size_t r = 0; r < residual_sample_count; ++r) {
-            rice_partition[r] = LOADER_TRY(decode_unsigned_exp_golomb(k, bit_input));
+            decoded.unchecked_append(LOADER_TRY(decode_unsigned_exp_golomb(k, bit_input)));
         }
     }
 
-    return rice_partition;
+    return {};
 }
 
 // Decode a single number encoded with Rice/Exponential-Golomb encoding (the unsigned variant)
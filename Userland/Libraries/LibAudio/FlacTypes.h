@@ -25,7 +25,7 @@ enum FlacMetadataBlockType : u8 {
     STREAMINFO = 0,     // Important data about the audio format
     PADDING = 1,        // Non-data block to be ignored
     APPLICATION = 2,    // Ignored
-    SEEKTABLE = 3,      // Seeking info, maybe to be used later
+    SEEKTABLE = 3,      // Sample positions of some frames, for seeking
     VORBIS_COMMENT = 4, // Ignored
     CUESHEET = 5,       // Ignored
     PICTURE = 6,        // Ignored
@@ -79,6 +79,13 @@ struct FlacFrameHeader {
     PcmSampleFormat bit_depth;
 };
 
+// A SEEKTABLE entry: where the frame starting with the given sample is.
+struct FlacSeekPoint {
+    u64 sample_index;
+    u64 byte_offset; // relative to the first frame header
+    u16 sample_count;
+};
+
 struct FlacSubframeHeader {
     FlacSubframeType type;
     // order for fixed and LPC subframes
@@ -7,6 +7,7 @@
 #include "MP3Loader.h"
 #include "MP3HuffmanTables.h"
 #include "MP3Tables.h"
+#include <AK/SIMD.h>
 #include <LibCore/File.h>
 #include <LibCore/FileStream.h>
 
@@ -14,6 +15,7 @@ namespace Audio {
 
 LibDSP::MDCT<12> MP3LoaderPlugin::s_mdct_12;
 LibDSP::MDCT<36> MP3LoaderPlugin::s_mdct_36;
+LibDSP::DCT<32> MP3LoaderPlugin::s_dct_32;
 
 MP3LoaderPlugin::MP3LoaderPlugin(StringView path)
     : m_file(Core::File::construct(path))
@@ -90,6 +92,7 @@ MaybeLoaderError MP3LoaderPlugin::reset()
     m_current_frame = {};
     m_current_frame_read = 0;
     m_synthesis_buffer = {};
+    m_synthesis_buffer_offset = {};
     m_loaded_samples = 0;
     m_bit_reservoir.discard_or_error(m_bit_reservoir.size());
     return {};
@@ -107,6 +110,7 @@ MaybeLoaderError MP3LoaderPlugin::seek(int const position)
     m_current_frame = {};
     m_current_frame_read = 0;
     m_synthesis_buffer = {};
+    m_synthesis_buffer_offset = {};
     m_bit_reservoir.discard_or_error(m_bit_reservoir.size());
     m_input_stream->handle_any_error();
     m_bitstream->handle_any_error();
@@ -344,7 +348,7 @@ ErrorOr<MP3::MP3Frame, LoaderError> MP3LoaderPlugin::read_frame_data(MP3::Header
                 for (size_t band_index = 0; band_index < 32; band_index++) {
                     in_samples[band_index] = granule.filter_bank_input[band_index][sample_index];
                 }
-                synthesis(m_synthesis_buffer[channel_index], in_samples, granule.pcm[sample_index]);
+                synthesis(m_synthesis_buffer[channel_index], m_synthesis_buffer_offset[channel_index], in_samples, granule.pcm[sample_index]);
             }
         }
     }
@@ -848,39 +852,42 @@ void MP3LoaderPlugin::transform_samples_to_time(Array<double, 576> const& input,
 }
 
 // ISO/IEC 11172-3 (Figure A.2)
-void MP3LoaderPlugin::synthesis(Array<double, 1024>& V, Array<double, 32>& samples, Array<double, 32>& result)
+// Instead of shifting V by 64 values every time, V is a ring buffer, and the newest 64 values start at V_offset.
+// The samples are used as scratch space.
+void MP3LoaderPlugin::synthesis(Array<double, 1024>& V, size_t& V_offset, Array<double, 32>& samples, Array<double, 32>& result)
 {
-    for (size_t i = 1023; i >= 64; i--) {
-        V[i] = V[i - 64];
-    }
-
-    for (size_t i = 0; i < 64; i++) {
-        V[i] = 0;
-        for (size_t k = 0; k < 32; k++) {
-            double const N = MP3::Tables::SynthesisSubbandFilterCoefficients[i][k];
-            V[i] += N * samples[k];
-        }
-    }
-
-    Array<double, 512> U;
+    V_offset = (V_offset + 1024 - 64) % 1024;
+
+    // The matrixing, V[i] = sum over k of cos((16 + i) * (2 * k + 1) * pi / 64) * samples[k] (ISO/IEC 11172-3 2.4.3.2.2),
+    // is a DCT-II of the samples in disguise: with X = DCT-II(samples), V[i] = X[i + 16], which is mirrored and negated beyond X[31].
+    s_dct_32.transform(samples);
+    auto* new_values = &V[V_offset];
+    for (size_t i = 0; i < 16; i++)
+        new_values[i] = samples[i + 16];
+    new_values[16] = 0;
+    for (size_t i = 17; i < 48; i++)
+        new_values[i] = -samples[48 - i];
+    for (size_t i = 48; i < 64; i++)
+        new_values[i] = -samples[i - 48];
+
+    // Building U, windowing it into W and adding up every 32nd value of W amounts to this, two output samples at a time:
+    // result[j] = sum over i of V[i * 128 + j] * D[i * 64 + j] + V[i * 128 + 96 + j] * D[i * 64 + 32 + j].
+    // Each run of 32 values in V is contiguous, since the offset is a multiple of 64.
+    auto load = [](double const* values) {
+        AK::SIMD::f64x2 vector;
+        __builtin_memcpy(&vector, values, sizeof(vector));
+        return vector;
+    };
+    Array<AK::SIMD::f64x2, 16> sums {};
     for (size_t i = 0; i < 8; i++) {
-        for (size_t j = 0; j < 32; j++) {
-            U[i * 64 + j] = V[i * 128 + j];
-            U[i * 64 + 32 + j] = V[i * 128 + 96 + j];
-        }
-    }
-
-    Array<double, 512> W;
-    for (size_t i = 0; i < 512; i++) {
-        W[i] = U[i] * MP3::Tables::WindowSynthesis[i];
-    }
-
-    for (size_t j = 0; j < 32; j++) {
-        result[j] = 0;
-        for (size_t k = 0; k < 16; k++) {
-            result[j] += W[j + 32 * k];
-        }
-    }
+        double const* first_values = &V[(V_offset + i * 128) % 1024];
+        double const* second_values = &V[(V_offset + i * 128 + 96) % 1024];
+        double const* first_window = &MP3::Tables::WindowSynthesis[i * 64];
+        double const* second_window = &MP3::Tables::WindowSynthesis[i * 64 + 32];
+        for (size_t j = 0; j < 16; j++)
+            sums[j] += load(first_values + 2 * j) * load(first_window + 2 * j) + load(second_values + 2 * j) * load(second_window + 2 * j);
+    }
+    __builtin_memcpy(result.data(), sums.data(), sizeof(result));
 }
 
 Span<MP3::Tables::ScaleFactorBand const> MP3LoaderPlugin::get_scalefactor_bands(MP3::Granule const& granule, int samplerate)
@@ -11,6 +11,7 @@
 #include "MP3Types.h"
 #include <AK/Tuple.h>
 #include <LibCore/FileStream.h>
+#include <LibDSP/DCT.h>
 #include <LibDSP/MDCT.h>
 
 namespace Audio {
@@ -52,14 +53,17 @@ private:
     static void reduce_alias(MP3::Granule&, size_t max_subband_index = 576);
     static void process_stereo(MP3::MP3Frame&, size_t granule_index);
     static void transform_samples_to_time(Array<double, 576> const& input, size_t input_offset, Array<double, 36>& output, MP3::BlockType block_type);
-    static void synthesis(Array<double, 1024>& V, Array<double, 32>& samples, Array<double, 32>& result);
+    static void synthesis(Array<double, 1024>& V, size_t& V_offset, Array<double, 32>& samples, Array<double, 32>& result);
     static Span<MP3::Tables::ScaleFactorBand const> get_scalefactor_bands(MP3::Granule const&, int samplerate);
 
     AK::Vector<AK::Tuple<size_t, int>> m_seek_table;
     AK::Array<AK::Array<AK::Array<double, 18>, 32>, 2> m_last_values {};
     AK::Array<AK::Array<double, 1024>, 2> m_synthesis_buffer {};
+    // Where the newest 64 values of each synthesis buffer start, as they're used as ring buffers.
+    AK::Array<size_t, 2> m_synthesis_buffer_offset {};
     static LibDSP::MDCT<36> s_mdct_36;
     static LibDSP::MDCT<12> s_mdct_12;
+    static LibDSP::DCT<32> s_dct_32;
 
     u32 m_sample_rate { 0 };
     u8 m_num_channels { 0 };
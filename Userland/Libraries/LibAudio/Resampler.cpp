@@ -7,21 +7,148 @@
 #include "Resampler.h"
 #include "Buffer.h"
 #include "Sample.h"
+#include <AK/Math.h>
+#include <AK/SIMD.h>
 
 namespace Audio {
 
-ErrorOr<NonnullRefPtr<Buffer>> resample_buffer(ResampleHelper<double>& resampler, Buffer const& to_resample)
+static u32 greatest_common_divisor(u32 a, u32 b)
 {
-    Vector<Sample> resampled;
-    resampled.ensure_capacity(to_resample.sample_count() * ceil_div(resampler.source(), resampler.target()));
-    for (size_t i = 0; i < static_cast<size_t>(to_resample.sample_count()); ++i) {
-        auto sample = to_resample.samples()[i];
-        resampler.process_sample(sample.left, sample.right);
+    while (b != 0) {
+        auto remainder = a % b;
+        a = b;
+        b = remainder;
+    }
+    return a;
+}
+
+static double sinc(double x)
+{
+    if (x == 0)
+        return 1;
+    return AK::sin(AK::Pi<double> * x) / (AK::Pi<double> * x);
+}
+
+// Blackman window, for x in [-1, 1].
+static double blackman_window(double x)
+{
+    if (x <= -1 || x >= 1)
+        return 0;
+    return 0.42 + 0.5 * AK::cos(AK::Pi<double> * x) + 0.08 * AK::cos(2 * AK::Pi<double> * x);
+}
 
-        while (resampler.read_sample(sample.left, sample.right))
-            resampled.append(sample);
+PolyphaseResampler::PolyphaseResampler(u32 source, u32 target)
+    : m_source(source)
+    , m_target(target)
+{
+    VERIFY(source > 0);
+    VERIFY(target > 0);
+    auto divisor = greatest_common_divisor(source, target);
+    m_interpolation = target / divisor;
+    m_step = source / divisor;
+    m_phase_count = min(m_interpolation, max_phase_count);
+    compute_filter();
+    reset();
+}
+
+void PolyphaseResampler::compute_filter()
+{
+    // Below the lower of the two Nyquist frequencies, with a little room for the filter to roll off.
+    double cutoff = min(1.0, static_cast<double>(m_target) / m_source) * 0.95;
+    // Lower cutoffs need longer filters for the same steepness; the filters are padded for the dot product.
+    m_tap_count = clamp(static_cast<size_t>(min_tap_count / cutoff), min_tap_count, max_tap_count);
+    m_tap_count = (m_tap_count + 3) & ~static_cast<size_t>(3);
+
+    m_filter.resize(m_phase_count * m_tap_count);
+    double half_length = m_tap_count / 2.0;
+    for (u32 phase = 0; phase < m_phase_count; ++phase) {
+        // The output sample lies this far past the middle tap, in input samples.
+        double offset = static_cast<double>(phase) / m_phase_count;
+        auto* coefficients = &m_filter[phase * m_tap_count];
+        double sum = 0;
+        for (size_t tap = 0; tap < m_tap_count; ++tap) {
+            double distance = static_cast<double>(tap) - (half_length - 1) - offset;
+            double coefficient = cutoff * sinc(cutoff * distance) * blackman_window(distance / half_length);
+            coefficients[tap] = static_cast<float>(coefficient);
+            sum += coefficient;
+        }
+        // Every phase has to pass a constant signal through as it is, or the output would buzz at the phase rate.
+        for (size_t tap = 0; tap < m_tap_count; ++tap)
+            coefficients[tap] = static_cast<float>(coefficients[tap] / sum);
     }
+}
 
+void PolyphaseResampler::reset()
+{
+    // Silence before the first input sample, so that the first output sample is centered on it.
+    m_left_history.clear_with_capacity();
+    m_right_history.clear_with_capacity();
+    m_left_history.resize(m_tap_count / 2 - 1);
+    m_right_history.resize(m_tap_count / 2 - 1);
+    m_position = 0;
+    m_position_fraction = 0;
+}
+
+ErrorOr<void> PolyphaseResampler::resample(Span<Sample const> input, Vector<Sample>& output)
+{
+    if (m_source == m_target) {
+        TRY(output.try_append(input.data(), input.size()));
+        return {};
+    }
+
+    TRY(m_left_history.try_ensure_capacity(m_left_history.size() + input.size()));
+    TRY(m_right_history.try_ensure_capacity(m_right_history.size() + input.size()));
+    for (auto const& sample : input) {
+        m_left_history.unchecked_append(static_cast<float>(sample.left));
+        m_right_history.unchecked_append(static_cast<float>(sample.right));
+    }
+
+    if (m_left_history.size() >= m_position + m_tap_count) {
+        auto remaining = static_cast<u64>(m_left_history.size() - m_tap_count + 1 - m_position) * m_interpolation - m_position_fraction;
+        auto output_count = ceil_div(remaining, static_cast<u64>(m_step));
+        TRY(output.try_ensure_capacity(output.size() + output_count));
+    }
+
+    while (m_position + m_tap_count <= m_left_history.size()) {
+        u32 phase = static_cast<u64>(m_position_fraction) * m_phase_count / m_interpolation;
+        auto const* coefficients = &m_filter[phase * m_tap_count];
+        auto const* left = &m_left_history[m_position];
+        auto const* right = &m_right_history[m_position];
+
+        AK::SIMD::f32x4 left_sum {};
+        AK::SIMD::f32x4 right_sum {};
+        for (size_t tap = 0; tap < m_tap_count; tap += 4) {
+            AK::SIMD::f32x4 coefficient_vector;
+            AK::SIMD::f32x4 left_vector;
+            AK::SIMD::f32x4 right_vector;
+            __builtin_memcpy(&coefficient_vector, coefficients + tap, sizeof(coefficient_vector));
+            __builtin_memcpy(&left_vector, left + tap, sizeof(left_vector));
+            __builtin_memcpy(&right_vector, right + tap, sizeof(right_vector));
+            left_sum += left_vector * coefficient_vector;
+            right_sum += right_vector * coefficient_vector;
+        }
+        output.unchecked_append(Sample {
+            left_sum[0] + left_sum[1] + left_sum[2] + left_sum[3],
+            right_sum[0] + right_sum[1] + right_sum[2] + right_sum[3],
+        });
+
+        m_position_fraction += m_step;
+        m_position += m_position_fraction / m_interpolation;
+        m_position_fraction %= m_interpolation;
+    }
+
+    // Drop the input that no output sample needs anymore.
+    auto consumed = min(m_position, m_left_history.size());
+    m_left_history.remove(0, consumed);
+    m_right_history.remove(0, consumed);
+    m_position -= consumed;
+    return {};
+}
+
+ErrorOr<NonnullRefPtr<Buffer>> resample_buffer(PolyphaseResampler& resampler, Buffer const& to_resample)
+{
+    Vector<Sample> resampled;
+    TRY(resampler.resample({ to_resample.samples(), static_cast<size_t>(to_resample.sample_count()) }, resampled));
     return Buffer::create_with_samples(move(resampled));
 }
 
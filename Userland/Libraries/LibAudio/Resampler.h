@@ -7,14 +7,17 @@
 #pragma once
 
 #include <AK/Concepts.h>
+#include <AK/Error.h>
+#include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
+#include <LibAudio/Sample.h>
 
 namespace Audio {
 
 // Small helper to resample from one playback rate to another
 // This isn't really "smart", in that we just insert (or drop) samples.
-// Should do better...
+// Good enough for the loaders' internal use, but use PolyphaseResampler for anything that's played back.
 template<typename SampleType>
 class ResampleHelper {
 public:
@@ -84,7 +87,49 @@ private:
     SampleType m_last_sample_r;
 };
 
+// Resamples stereo audio with a windowed-sinc low-pass filter. The filter is precomputed for a fixed number of
+// phases (fractional positions between two input samples), so every output sample is a single short dot product.
+// It keeps the end of the input around for the filter, so a stream has to be passed to it in order, buffer by buffer;
+// that also means the output lags behind the input by about half the filter length.
+class PolyphaseResampler {
+public:
+    PolyphaseResampler(u32 source, u32 target);
+
+    // Appends the samples that the input (and whatever was left over from the previous call) resamples to.
+    ErrorOr<void> resample(Span<Sample const> input, Vector<Sample>& output);
+    // Forgets the previous input, e.g. after seeking.
+    void reset();
+
+    u32 source() const { return m_source; }
+    u32 target() const { return m_target; }
+    size_t tap_count() const { return m_tap_count; }
+
+private:
+    static constexpr u32 max_phase_count = 256;
+    static constexpr size_t min_tap_count = 32;
+    static constexpr size_t max_tap_count = 256;
+
+    void compute_filter();
+
+    u32 const m_source;
+    u32 const m_target;
+    // The input advances by m_step / m_interpolation samples per output sample.
+    u32 m_interpolation { 1 };
+    u32 m_step { 1 };
+    u32 m_phase_count { 1 };
+    size_t m_tap_count { min_tap_count };
+    // m_phase_count filters of m_tap_count coefficients each.
+    Vector<float> m_filter;
+
+    // The input that the filter still needs, one channel at a time.
+    Vector<float> m_left_history;
+    Vector<float> m_right_history;
+    // Where the next output sample is, as the index in the history plus m_position_fraction / m_interpolation.
+    size_t m_position { 0 };
+    u32 m_position_fraction { 0 };
+};
+
 class Buffer;
-ErrorOr<NonnullRefPtr<Buffer>> resample_buffer(ResampleHelper<double>& resampler, Buffer const& to_resample);
+ErrorOr<NonnullRefPtr<Buffer>> resample_buffer(PolyphaseResampler& resampler, Buffer const& to_resample);
 
 }
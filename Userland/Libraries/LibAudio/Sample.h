@@ -64,13 +64,13 @@ struct Sample {
     // - Linear:        0.0 to 1.0
     // - Logarithmic:   0.0 to 1.0
 
-    ALWAYS_INLINE double linear_to_log(double const change) const
+    static ALWAYS_INLINE double linear_to_log(double const change)
     {
         // TODO: Add linear slope around 0
         return VOLUME_A * exp(VOLUME_B * change);
     }
 
-    ALWAYS_INLINE double log_to_linear(double const val) const
+    static ALWAYS_INLINE double log_to_linear(double const val)
     {
         // TODO: Add linear slope around 0
         return log(val / VOLUME_A) / VOLUME_B;
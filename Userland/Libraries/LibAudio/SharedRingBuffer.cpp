@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TypedTransfer.h>
+#include <LibAudio/SharedRingBuffer.h>
+
+namespace Audio {
+
+// Enough for a few seconds of audio; anything larger would just add latency.
+static constexpr size_t max_capacity = 1 << 18;
+
+ErrorOr<SharedRingBuffer> SharedRingBuffer::create(size_t capacity)
+{
+    if (capacity == 0 || capacity > max_capacity || !is_power_of_two(capacity))
+        return Error::from_string_literal("Ring buffer capacity has to be a power of two");
+
+    auto buffer = TRY(Core::AnonymousBuffer::create_with_size(sizeof(Header) + capacity * sizeof(Sample)));
+    auto* header = new (buffer.data<void>()) Header;
+    header->capacity = capacity;
+    return SharedRingBuffer { move(buffer), capacity };
+}
+
+ErrorOr<SharedRingBuffer> SharedRingBuffer::create_from_anonymous_buffer(Core::AnonymousBuffer buffer)
+{
+    if (!buffer.is_valid() || buffer.size() < sizeof(Header))
+        return Error::from_string_literal("Ring buffer is too small");
+
+    size_t capacity = reinterpret_cast<Header const*>(buffer.data<void>())->capacity;
+    if (capacity == 0 || capacity > max_capacity || !is_power_of_two(capacity) || buffer.size() < sizeof(Header) + capacity * sizeof(Sample))
+        return Error::from_string_literal("Ring buffer has an invalid capacity");
+
+    return SharedRingBuffer { move(buffer), capacity };
+}
+
+size_t SharedRingBuffer::available_to_read() const
+{
+    u32 available = header().write_position.load(AK::memory_order_acquire) - header().read_position.load(AK::memory_order_relaxed);
+    // A misbehaving producer might claim to have written more than could possibly fit.
+    return min<size_t>(available, m_capacity);
+}
+
+size_t SharedRingBuffer::available_to_write() const
+{
+    u32 used = header().write_position.load(AK::memory_order_relaxed) - header().read_position.load(AK::memory_order_acquire);
+    return m_capacity - min<size_t>(used, m_capacity);
+}
+
+size_t SharedRingBuffer::write(Span<Sample const> input)
+{
+    size_t count = min(input.size(), available_to_write());
+    u32 position = header().write_position.load(AK::memory_order_relaxed);
+    size_t offset = position & (m_capacity - 1);
+    size_t first_part = min(count, m_capacity - offset);
+    AK::TypedTransfer<Sample>::copy(samples() + offset, input.data(), first_part);
+    AK::TypedTransfer<Sample>::copy(samples(), input.data() + first_part, count - first_part);
+    header().write_position.store(position + count, AK::memory_order_release);
+    return count;
+}
+
+size_t SharedRingBuffer::read(Span<Sample> output)
+{
+    size_t count = min(output.size(), available_to_read());
+    u32 position = header().read_position.load(AK::memory_order_relaxed);
+    size_t offset = position & (m_capacity - 1);
+    size_t first_part = min(count, m_capacity - offset);
+    AK::TypedTransfer<Sample>::copy(output.data(), samples() + offset, first_part);
+    AK::TypedTransfer<Sample>::copy(output.data() + first_part, samples(), count - first_part);
+    header().read_position.store(position + count, AK::memory_order_release);
+    return count;
+}
+
+void SharedRingBuffer::discard_all()
+{
+    header().read_position.store(header().write_position.load(AK::memory_order_acquire), AK::memory_order_release);
+}
+
+}
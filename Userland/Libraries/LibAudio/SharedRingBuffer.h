@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/Span.h>
+#include <LibAudio/Sample.h>
+#include <LibCore/AnonymousBuffer.h>
+
+namespace Audio {
+
+// A queue of samples in shared memory with a single producer (the client) and a single consumer (AudioServer's mixer),
+// so that audio can be handed over without an IPC message and a new anonymous buffer for every chunk of it.
+// Both sides only ever move their own position forward, so neither of them has to take a lock.
+class SharedRingBuffer {
+public:
+    // The capacity (in samples) has to be a power of two.
+    static ErrorOr<SharedRingBuffer> create(size_t capacity);
+    // Checks the layout of a ring buffer somebody else created, since the other side can't be trusted to get it right.
+    static ErrorOr<SharedRingBuffer> create_from_anonymous_buffer(Core::AnonymousBuffer);
+
+    size_t capacity() const { return m_capacity; }
+    size_t available_to_read() const;
+    size_t available_to_write() const;
+
+    // These return how many samples were actually written or read, which is less than asked for if there isn't enough
+    // room or data. Only the producer may write, and only the consumer may read or discard.
+    size_t write(Span<Sample const>);
+    size_t read(Span<Sample>);
+    void discard_all();
+
+    Core::AnonymousBuffer const& anonymous_buffer() const { return m_buffer; }
+
+private:
+    // The positions count samples from the start and wrap around at 2^32, which is a multiple of the capacity.
+    struct alignas(Sample) Header {
+        Atomic<u32> write_position;
+        Atomic<u32> read_position;
+        u32 capacity;
+    };
+
+    SharedRingBuffer(Core::AnonymousBuffer buffer, size_t capacity)
+        : m_buffer(move(buffer))
+        , m_capacity(capacity)
+    {
+    }
+
+    Header& header() const { return *reinterpret_cast<Header*>(const_cast<void*>(m_buffer.data<void>())); }
+    Sample* samples() const { return reinterpret_cast<Sample*>(&header() + 1); }
+
+    Core::AnonymousBuffer m_buffer;
+    // Our own copy, as the one in the header could be changed under our feet.
+    size_t m_capacity { 0 };
+};
+
+}
@@ -105,6 +105,7 @@ struct MallocStats {
     size_t number_of_cold_empty_block_purge_hits;
     size_t number_of_block_allocs;
     size_t number_of_blocks_full;
+    size_t number_of_thread_cache_refills;
 
     size_t number_of_free_calls;
 
@@ -115,6 +116,7 @@ struct MallocStats {
     size_t number_of_hot_keeps;
     size_t number_of_cold_keeps;
     size_t number_of_frees;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -165,6 +167,11 @@ static Allocator* allocator_for_size(size_t size, size_t& good_size)
     return nullptr;
 }
 
+static size_t size_class_index(Allocator const& allocator)
+{
+    return &allocator - &allocators()[0];
+}
+
 #ifdef RECYCLE_BIG_ALLOCATIONS
 static BigAllocator* big_allocator_for_size(size_t size)
 {
@@ -206,8 +213,32 @@ enum class CallerWillInitializeMemory {
 // HACK: This is a __thread - marked thread-local variable. If we initialize it globally here, VERY weird errors happen.
 // The initialization happens in __malloc_init() and pthread_create_helper().
 __thread bool s_allocation_enabled;
+
+// Every thread keeps a few free chunks of each size class around, so that most
+// malloc() and free() calls don't have to take the global malloc mutex at all.
+// A thread cache is refilled from (and flushed back to) the ChunkedBlocks in
+// batches of half its capacity, which keeps the lock traffic low even for
+// threads that only allocate or only free.
+static constexpr size_t max_thread_cache_capacity = 32;
+static constexpr size_t thread_cache_bytes_per_size_class = 16 * KiB;
+
+static constexpr size_t thread_cache_capacity(size_t size_class)
+{
+    return clamp(thread_cache_bytes_per_size_class / size_class, static_cast<size_t>(2), max_thread_cache_capacity);
+}
+
+struct ThreadCache {
+    size_t chunk_count;
+    void* chunks[max_thread_cache_capacity];
+};
+
+static __thread ThreadCache s_thread_caches[num_size_classes];
+static bool s_thread_caches_enabled = true;
 #endif
 
+static void* allocate_chunk(Allocator&, size_t good_size);
+static void free_chunk(ChunkedBlock*, void* ptr);
+
 static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_initialize_memory)
 {
 #ifndef NO_TLS
@@ -228,6 +259,31 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
     size_t good_size;
     auto* allocator = allocator_for_size(size, good_size);
 
+#ifndef NO_TLS
+    if (allocator && s_thread_caches_enabled) {
+        auto& cache = s_thread_caches[size_class_index(*allocator)];
+        if (!cache.chunk_count) {
+            PthreadMutexLocker locker(s_malloc_mutex);
+            g_malloc_stats.number_of_thread_cache_refills++;
+            while (cache.chunk_count < thread_cache_capacity(good_size) / 2) {
+                auto* chunk = allocate_chunk(*allocator, good_size);
+                if (!chunk)
+                    break;
+                cache.chunks[cache.chunk_count++] = chunk;
+            }
+            if (!cache.chunk_count)
+                return nullptr;
+        }
+
+        void* ptr = cache.chunks[--cache.chunk_count];
+        if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+            memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+
+        ue_notify_malloc(ptr, size);
+        return ptr;
+    }
+#endif
+
     PthreadMutexLocker locker(s_malloc_mutex);
 
     if (!allocator) {
@@ -273,8 +329,22 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
         return &block->m_slot[0];
     }
 
+    auto* ptr = allocate_chunk(*allocator, good_size);
+    if (!ptr)
+        return nullptr;
+
+    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+
+    ue_notify_malloc(ptr, size);
+    return ptr;
+}
+
+// NOTE: The caller must hold s_malloc_mutex.
+static void* allocate_chunk(Allocator& allocator, size_t good_size)
+{
     ChunkedBlock* block = nullptr;
-    for (auto& current : allocator->usable_blocks) {
+    for (auto& current : allocator.usable_blocks) {
         if (current.free_chunks()) {
             block = &current;
             break;
@@ -291,7 +361,7 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
             set_mmap_name(block, ChunkedBlock::block_size, buffer);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block && s_cold_empty_block_count) {
@@ -314,7 +384,7 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             new (block) ChunkedBlock(good_size);
             ue_notify_chunk_size_changed(block, good_size);
         }
-        allocator->usable_blocks.append(*block);
+        allocator.usable_blocks.append(*block);
     }
 
     if (!block) {
@@ -326,8 +396,8 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             return nullptr;
         }
         new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(*block);
-        ++allocator->block_count;
+        allocator.usable_blocks.append(*block);
+        ++allocator.block_count;
     }
 
     --block->m_free_chunks;
@@ -342,15 +412,10 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
     if (block->is_full()) {
         g_malloc_stats.number_of_blocks_full++;
         dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(*block);
-        allocator->full_blocks.append(*block);
+        allocator.usable_blocks.remove(*block);
+        allocator.full_blocks.append(*block);
     }
     dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
-
-    if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
-
-    ue_notify_malloc(ptr, size);
     return ptr;
 }
 
@@ -370,9 +435,8 @@ static void free_impl(void* ptr)
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
-    PthreadMutexLocker locker(s_malloc_mutex);
-
     if (magic == MAGIC_BIGALLOC_HEADER) {
+        PthreadMutexLocker locker(s_malloc_mutex);
         auto* block = (BigAllocationBlock*)block_base;
 #ifdef RECYCLE_BIG_ALLOCATIONS
         if (auto* allocator = big_allocator_for_size(block->m_size)) {
@@ -400,11 +464,36 @@ static void free_impl(void* ptr)
     assert(magic == MAGIC_PAGE_HEADER);
     auto* block = (ChunkedBlock*)block_base;
 
-    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
-
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
+#ifndef NO_TLS
+    if (s_thread_caches_enabled) {
+        size_t good_size;
+        auto& cache = s_thread_caches[size_class_index(*allocator_for_size(block->m_size, good_size))];
+        auto capacity = thread_cache_capacity(good_size);
+        if (cache.chunk_count == capacity) {
+            PthreadMutexLocker locker(s_malloc_mutex);
+            g_malloc_stats.number_of_thread_cache_flushes++;
+            while (cache.chunk_count > capacity / 2) {
+                auto* chunk = cache.chunks[--cache.chunk_count];
+                free_chunk((ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+            }
+        }
+        cache.chunks[cache.chunk_count++] = ptr;
+        return;
+    }
+#endif
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+    free_chunk(block, ptr);
+}
+
+// NOTE: The caller must hold s_malloc_mutex.
+static void free_chunk(ChunkedBlock* block, void* ptr)
+{
+    dbgln_if(MALLOC_DEBUG, "LibC: freeing {:p} in allocator {:p} (size={}, used={})", ptr, block, block->bytes_per_chunk(), block->used_chunks());
+
     auto* entry = (FreelistEntry*)ptr;
     entry->next = block->m_freelist;
     block->m_freelist = entry;
@@ -565,6 +654,22 @@ void* realloc(void* ptr, size_t size)
     return new_ptr;
 }
 
+void __malloc_flush_thread_cache()
+{
+#ifndef NO_TLS
+    if (!s_thread_caches_enabled)
+        return;
+
+    PthreadMutexLocker locker(s_malloc_mutex);
+    for (auto& cache : s_thread_caches) {
+        while (cache.chunk_count) {
+            auto* chunk = cache.chunks[--cache.chunk_count];
+            free_chunk((ChunkedBlock*)((FlatPtr)chunk & ChunkedBlock::block_mask), chunk);
+        }
+    }
+#endif
+}
+
 void __malloc_init()
 {
 #ifndef NO_TLS
@@ -579,6 +684,10 @@ void __malloc_init()
         // keeps track of heap memory anyway.
         s_scrub_malloc = false;
         s_scrub_free = false;
+#ifndef NO_TLS
+        // Chunks sitting in a thread cache would look like leaks to UE.
+        s_thread_caches_enabled = false;
+#endif
     }
 
     if (secure_getenv("LIBC_NOSCRUB_MALLOC"))
@@ -611,6 +720,7 @@ void serenity_dump_malloc_stats()
     dbgln("empty cold block hits that were purged: {}", g_malloc_stats.number_of_cold_empty_block_purge_hits);
     dbgln("block allocs: {}", g_malloc_stats.number_of_block_allocs);
     dbgln("filled blocks: {}", g_malloc_stats.number_of_blocks_full);
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
     dbgln();
     dbgln("# free() calls: {}", g_malloc_stats.number_of_free_calls);
     dbgln();
@@ -621,5 +731,6 @@ void serenity_dump_malloc_stats()
     dbgln("number of hot keeps: {}", g_malloc_stats.number_of_hot_keeps);
     dbgln("number of cold keeps: {}", g_malloc_stats.number_of_cold_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
 }
 }
@@ -22,6 +22,9 @@ static constexpr size_t num_size_classes = (sizeof(size_classes) / sizeof(unsign
 #ifndef NO_TLS
 extern "C" {
 extern __thread bool s_allocation_enabled;
+
+// Returns the chunks cached by the calling thread to the global heap, this is called when a thread exits.
+void __malloc_flush_thread_cache();
 }
 #endif
 
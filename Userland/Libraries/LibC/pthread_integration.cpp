@@ -103,15 +103,47 @@ int __pthread_mutex_init(pthread_mutex_t* mutex, const pthread_mutexattr_t* attr
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
+// Priority inheritance mutexes hold the tid of their owner, so the kernel knows whom to lend a waiter's priority to.
+// See FUTEX_LOCK_PI.
+static bool try_lock_priority_inheritance_mutex(pthread_mutex_t* mutex)
+{
+    u32 expected = MUTEX_UNLOCKED;
+    return AK::atomic_compare_exchange_strong(&mutex->lock, expected, (u32)__pthread_self(), AK::memory_order_acquire);
+}
+
+static void lock_priority_inheritance_mutex(pthread_mutex_t* mutex)
+{
+    if (try_lock_priority_inheritance_mutex(mutex)) [[likely]]
+        return;
+    while (futex(&mutex->lock, FUTEX_LOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0) < 0)
+        VERIFY(errno == EINTR);
+}
+
+static void unlock_priority_inheritance_mutex(pthread_mutex_t* mutex)
+{
+    // Waiters set FUTEX_WAITERS, in which case the kernel has to hand the lock over.
+    u32 expected = (u32)__pthread_self();
+    if (AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_UNLOCKED, AK::memory_order_release)) [[likely]]
+        return;
+    int rc = futex(&mutex->lock, FUTEX_UNLOCK_PI | FUTEX_PRIVATE_FLAG, 0, nullptr, nullptr, 0);
+    VERIFY(rc >= 0);
+}
+
 int pthread_mutex_init(pthread_mutex_t*, const pthread_mutexattr_t*) __attribute__((weak, alias("__pthread_mutex_init")));
 
 int __pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
-    u32 expected = MUTEX_UNLOCKED;
-    bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+    bool exchanged;
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        exchanged = try_lock_priority_inheritance_mutex(mutex);
+    } else {
+        u32 expected = MUTEX_UNLOCKED;
+        exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, expected, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+    }
 
     if (exchanged) [[likely]] {
         if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
@@ -131,8 +163,24 @@ int __pthread_mutex_trylock(pthread_mutex_t* mutex)
 
 int pthread_mutex_trylock(pthread_mutex_t* mutex) __attribute__((weak, alias("__pthread_mutex_trylock")));
 
+static int lock_priority_inheritance_mutex_maybe_recursively(pthread_mutex_t* mutex)
+{
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && AK::atomic_load(&mutex->owner, AK::memory_order_relaxed) == __pthread_self()) {
+        mutex->level++;
+        return 0;
+    }
+    lock_priority_inheritance_mutex(mutex);
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
+        AK::atomic_store(&mutex->owner, __pthread_self(), AK::memory_order_relaxed);
+    mutex->level = 0;
+    return 0;
+}
+
 int __pthread_mutex_lock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return lock_priority_inheritance_mutex_maybe_recursively(mutex);
+
     // Fast path: attempt to claim the mutex without waiting.
     u32 value = MUTEX_UNLOCKED;
     bool exchanged = AK::atomic_compare_exchange_strong(&mutex->lock, value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
@@ -173,6 +221,9 @@ int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
     // Same as pthread_mutex_lock(), but always set MUTEX_LOCKED_NEED_TO_WAKE,
     // and also don't bother checking for already owning the mutex recursively,
     // because we know we don't. Used in the condition variable implementation.
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return lock_priority_inheritance_mutex_maybe_recursively(mutex);
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire);
     while (value != MUTEX_UNLOCKED) {
         futex_wait(&mutex->lock, value, nullptr, 0);
@@ -195,6 +246,11 @@ int __pthread_mutex_unlock(pthread_mutex_t* mutex)
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE)
         AK::atomic_store(&mutex->owner, 0, AK::memory_order_relaxed);
 
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT) {
+        unlock_priority_inheritance_mutex(mutex);
+        return 0;
+    }
+
     u32 value = AK::atomic_exchange(&mutex->lock, MUTEX_UNLOCKED, AK::memory_order_release);
     if (value == MUTEX_LOCKED_NEED_TO_WAKE) [[unlikely]] {
         int rc = futex_wake(&mutex->lock, 1);
@@ -18,14 +18,18 @@ int sched_yield()
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/sched_get_priority_min.html
-int sched_get_priority_min([[maybe_unused]] int policy)
+int sched_get_priority_min(int policy)
 {
+    if (policy == SCHED_FIFO || policy == SCHED_RR)
+        return 1;
     return 0; // Idle
 }
 
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/sched_get_priority_max.html
-int sched_get_priority_max([[maybe_unused]] int policy)
+int sched_get_priority_max(int policy)
 {
+    if (policy == SCHED_FIFO || policy == SCHED_RR)
+        return 99;
     return 3; // High
 }
 
@@ -42,4 +46,32 @@ int sched_getparam(pid_t pid, struct sched_param* param)
     int rc = syscall(SC_sched_getparam, pid, param);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
+
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/sched_setscheduler.html
+int sched_setscheduler(pid_t pid, int policy, const struct sched_param* param)
+{
+    int rc = syscall(SC_sched_setscheduler, pid, policy, param);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/sched_getscheduler.html
+int sched_getscheduler(pid_t pid)
+{
+    int rc = syscall(SC_sched_getscheduler, pid);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+// https://man7.org/linux/man-pages/man2/sched_setaffinity.2.html
+int sched_setaffinity(pid_t pid, size_t cpusetsize, cpu_set_t const* mask)
+{
+    int rc = syscall(SC_sched_setaffinity, pid, cpusetsize, mask);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+// https://man7.org/linux/man-pages/man2/sched_getaffinity.2.html
+int sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask)
+{
+    int rc = syscall(SC_sched_getaffinity, pid, cpusetsize, mask);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <Kernel/API/POSIX/sched.h>
 #include <sys/cdefs.h>
 #include <sys/types.h>
 
@@ -13,18 +14,21 @@ __BEGIN_DECLS
 
 int sched_yield(void);
 
-struct sched_param {
-    int sched_priority;
-};
-
-#define SCHED_FIFO 0
-#define SCHED_RR 1
-#define SCHED_OTHER 2
-#define SCHED_BATCH 3
-
 int sched_get_priority_min(int policy);
 int sched_get_priority_max(int policy);
 int sched_setparam(pid_t pid, const struct sched_param* param);
 int sched_getparam(pid_t pid, struct sched_param* param);
+int sched_setscheduler(pid_t pid, int policy, const struct sched_param* param);
+int sched_getscheduler(pid_t pid);
+
+#define CPU_ZERO(set) ((set)->__bits = 0)
+#define CPU_SET(cpu, set) ((cpu) < CPU_SETSIZE ? (void)((set)->__bits |= (1u << (cpu))) : (void)0)
+#define CPU_CLR(cpu, set) ((cpu) < CPU_SETSIZE ? (void)((set)->__bits &= ~(1u << (cpu))) : (void)0)
+#define CPU_ISSET(cpu, set) ((cpu) < CPU_SETSIZE ? (((set)->__bits >> (cpu)) & 1) : 0)
+#define CPU_COUNT(set) __builtin_popcount((set)->__bits)
+#define CPU_EQUAL(set1, set2) ((set1)->__bits == (set2)->__bits)
+
+int sched_setaffinity(pid_t pid, size_t cpusetsize, cpu_set_t const* mask);
+int sched_getaffinity(pid_t pid, size_t cpusetsize, cpu_set_t* mask);
 
 __END_DECLS
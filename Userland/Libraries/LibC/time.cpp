@@ -421,6 +421,41 @@ static Kernel::TimePage* get_kernel_time_page()
     return s_kernel_time_page;
 }
 
+static bool extrapolate_time_from_kernel_time_page(Kernel::TimePage& kernel_time_page, clockid_t clock_id, struct timespec& ts)
+{
+#if ARCH(I386) || ARCH(X86_64)
+    auto coarse_clock_id = clock_id == CLOCK_MONOTONIC ? CLOCK_MONOTONIC_COARSE : CLOCK_REALTIME_COARSE;
+    u32 update_iteration;
+    u64 elapsed_ns;
+    do {
+        update_iteration = AK::atomic_load(&kernel_time_page.update1, AK::memory_order_acquire);
+        if (kernel_time_page.tsc_multiplier == 0)
+            return false;
+        ts = kernel_time_page.clocks[coarse_clock_id];
+        u32 tsc_low, tsc_high;
+        asm volatile("rdtsc"
+                     : "=a"(tsc_low), "=d"(tsc_high));
+        // NOTE: The TSC of this processor may be slightly behind the one the kernel read.
+        auto elapsed_tsc = max<i64>(static_cast<i64>(((u64)tsc_high << 32 | tsc_low) - kernel_time_page.tsc_at_update), 0);
+        elapsed_ns = (min<u64>(elapsed_tsc, NumericLimits<u32>::max()) * kernel_time_page.tsc_multiplier) >> kernel_time_page.tsc_shift;
+        elapsed_ns = min<u64>(elapsed_ns, kernel_time_page.max_extrapolation_ns);
+    } while (update_iteration != AK::atomic_load(&kernel_time_page.update2, AK::memory_order_acquire));
+
+    ts.tv_sec += elapsed_ns / 1'000'000'000;
+    ts.tv_nsec += elapsed_ns % 1'000'000'000;
+    if (ts.tv_nsec >= 1'000'000'000) {
+        ++ts.tv_sec;
+        ts.tv_nsec -= 1'000'000'000;
+    }
+    return true;
+#else
+    (void)kernel_time_page;
+    (void)clock_id;
+    (void)ts;
+    return false;
+#endif
+}
+
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
     if (Kernel::time_page_supports(clock_id)) {
@@ -437,6 +472,11 @@ int clock_gettime(clockid_t clock_id, struct timespec* ts)
             } while (update_iteration != AK::atomic_load(&kernel_time_page->update2, AK::memory_order_acquire));
             return 0;
         }
+    } else if (Kernel::time_page_can_extrapolate(clock_id) && ts) {
+        if (auto* kernel_time_page = get_kernel_time_page()) {
+            if (extrapolate_time_from_kernel_time_page(*kernel_time_page, clock_id, *ts))
+                return 0;
+        }
     }
 
     int rc = syscall(SC_clock_gettime, clock_id, ts);
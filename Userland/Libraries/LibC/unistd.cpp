@@ -398,6 +398,13 @@ ssize_t pwrite(int fd, const void* buf, size_t count, off_t offset)
     return nwritten;
 }
 
+ssize_t copy_file_range(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t count, unsigned flags)
+{
+    Syscall::SC_copy_file_range_params params { fd_in, off_in, fd_out, off_out, count, flags };
+    int rc = syscall(SC_copy_file_range, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 // https://pubs.opengroup.org/onlinepubs/9699919799/functions/ttyname_r.html
 int ttyname_r(int fd, char* buffer, size_t size)
 {
@@ -77,6 +77,7 @@ ssize_t read(int fd, void* buf, size_t count);
 ssize_t pread(int fd, void* buf, size_t count, off_t);
 ssize_t write(int fd, const void* buf, size_t count);
 ssize_t pwrite(int fd, const void* buf, size_t count, off_t);
+ssize_t copy_file_range(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t count, unsigned flags);
 int close(int fd);
 int chdir(const char* path);
 int fchdir(int fd);
@@ -8,14 +8,19 @@
 #include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
+#include <AK/Atomic.h>
 #include <AK/BinarySearch.h>
 #include <AK/MemoryStream.h>
+#include <LibThreading/ThreadPool.h>
 #include <string.h>
 
 #include <LibCompress/Deflate.h>
 
 namespace Compress {
 
+// How much output a compressed block decodes at a time.
+static constexpr size_t output_batch_size = 4 * KiB;
+
 const CanonicalCode& CanonicalCode::fixed_literal_codes()
 {
     static CanonicalCode code;
@@ -59,14 +64,14 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
-        code.m_symbol_values.append(last_non_zero);
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
+        code.build_lookup_tables(1);
         return code;
     }
 
     auto next_code = 0;
+    size_t max_code_length = 0;
     for (size_t code_length = 1; code_length <= 15; ++code_length) {
         next_code <<= 1;
         auto start_bit = 1 << code_length;
@@ -78,10 +83,9 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
-            code.m_symbol_values.append(symbol);
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
+            max_code_length = code_length;
 
             next_code++;
         }
@@ -91,23 +95,61 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         return {};
     }
 
+    code.build_lookup_tables(max_code_length);
     return code;
 }
 
-u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+void CanonicalCode::build_lookup_tables(size_t max_code_length)
 {
-    u32 code_bits = 1;
+    m_second_level_bits = max_code_length > lookup_bits ? max_code_length - lookup_bits : 0;
+
+    for (size_t symbol = 0; symbol < m_bit_codes.size(); ++symbol) {
+        size_t code_length = m_bit_code_lengths[symbol];
+        if (code_length == 0)
+            continue;
+        u16 entry = (code_length << code_length_shift) | symbol;
+        size_t code = m_bit_codes[symbol];
+
+        // The bits after a code belong to the next one, so each code fills every entry that starts with it.
+        if (code_length <= lookup_bits) {
+            for (size_t index = code; index < m_lookup_table.size(); index += 1 << code_length)
+                m_lookup_table[index] = entry;
+            continue;
+        }
 
+        auto& first_level_entry = m_lookup_table[code & (m_lookup_table.size() - 1)];
+        if (first_level_entry == 0) {
+            first_level_entry = second_level_flag | (m_second_level_tables.size() >> m_second_level_bits);
+            m_second_level_tables.resize(m_second_level_tables.size() + (1 << m_second_level_bits));
+        }
+        auto* table = m_second_level_tables.data() + ((first_level_entry & symbol_mask) << m_second_level_bits);
+        for (size_t index = code >> lookup_bits; index < (1u << m_second_level_bits); index += 1 << (code_length - lookup_bits))
+            table[index] = entry;
+    }
+}
+
+u32 CanonicalCode::read_symbol(InputBitStream& stream) const
+{
+    // Only as many bytes are read as the code needs, so nothing past the end of the compressed data is ever consumed.
+    // Until then, the bits that haven't been read yet are zero; but once the entry for what's been read so far is a code
+    // that's no longer than that, it must be the right one.
     for (;;) {
-        code_bits = code_bits << 1 | stream.read_bits(1);
-        if (code_bits >= (1 << 16))
+        auto bits = stream.peek_bits();
+        auto entry = m_lookup_table[bits & (m_lookup_table.size() - 1)];
+        if (entry & second_level_flag)
+            entry = m_second_level_tables[((entry & symbol_mask) << m_second_level_bits) | ((bits >> lookup_bits) & ((1u << m_second_level_bits) - 1))];
+
+        size_t code_length = entry >> code_length_shift;
+        if (code_length == 0)
             return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
 
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+        if (code_length <= stream.peekable_bit_count()) {
+            stream.discard_bits(code_length);
+            return entry & symbol_mask;
+        }
+
+        if (!stream.read_ahead())
+            return UINT32_MAX;
     }
 }
 
@@ -128,20 +170,27 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
-    const auto symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
+    // Decoding a good amount at once saves going back and forth for every symbol; each of them adds at most 258 bytes to the output.
+    auto& output_stream = m_decompressor.m_output_stream;
+    while (output_stream.size() < output_batch_size) {
+        const auto symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
 
-    if (symbol >= 286) { // invalid deflate literal/length symbol
-        m_decompressor.set_fatal_error();
-        return false;
-    }
+        if (symbol >= 286) { // invalid deflate literal/length symbol
+            m_decompressor.set_fatal_error();
+            return false;
+        }
+
+        if (symbol < 256) {
+            u8 byte = symbol;
+            output_stream.write({ &byte, sizeof(byte) });
+            continue;
+        }
+
+        if (symbol == 256) {
+            m_eof = true;
+            return !output_stream.eof();
+        }
 
-    if (symbol < 256) {
-        m_decompressor.m_output_stream << static_cast<u8>(symbol);
-        return true;
-    } else if (symbol == 256) {
-        m_eof = true;
-        return false;
-    } else {
         if (!m_distance_codes.has_value()) {
             m_decompressor.set_fatal_error();
             return false;
@@ -155,18 +204,14 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
         }
         const auto distance = m_decompressor.decode_distance(distance_symbol);
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
-            if (m_decompressor.m_output_stream.handle_any_error()) {
-                m_decompressor.set_fatal_error();
-                return false; // a back reference was requested that was too far back (outside our current sliding window)
-            }
-            m_decompressor.m_output_stream << byte;
+        if (!output_stream.write_from_seekback(distance, length)) {
+            output_stream.handle_any_error();
+            m_decompressor.set_fatal_error();
+            return false; // a back reference was requested that was too far back (outside our current sliding window)
         }
-
-        return true;
     }
+
+    return true;
 }
 
 DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
@@ -517,6 +562,13 @@ DeflateCompressor::~DeflateCompressor()
     VERIFY(m_finished);
 }
 
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(m_pending_block_size == 0 && m_history_size == 0);
+    m_history_size = min(dictionary.size(), block_size);
+    dictionary.slice(dictionary.size() - m_history_size).copy_to({ m_rolling_window + block_size - m_history_size, m_history_size });
+}
+
 size_t DeflateCompressor::write(ReadonlyBytes bytes)
 {
     VERIFY(!m_finished);
@@ -590,7 +642,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_back_reference_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -724,6 +776,10 @@ void DeflateCompressor::lz77_compress_block()
 
     // our block starts at block_size and is m_pending_block_size in length
     auto block_end = block_size + m_pending_block_size;
+
+    // the block can refer back to what came before it, so that goes into the hash table as well
+    for (auto position = block_size - m_history_size; position < block_size && position + min_match_length <= block_end; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
     size_t current_position;
     for (current_position = block_size; current_position < block_end - min_match_length + 1; current_position++) {
         auto hash = hash_sequence(&m_rolling_window[current_position]);
@@ -954,14 +1010,24 @@ void DeflateCompressor::flush()
         return;
     }
 
-    m_output_stream.write_bit(m_finished);
+    auto is_final_block = m_finished && m_mark_final_block == MarkFinalBlock::Yes;
+    m_output_stream.write_bit(is_final_block);
 
-    // if this is just an empty block to signify the end of the deflate stream use the smallest block possible (10 bits total)
     if (m_pending_block_size == 0) {
-        VERIFY(m_finished);                       // we shouldn't be writing empty blocks unless this is the final one
-        m_output_stream.write_bits(0b01, 2);      // fixed huffman codes
-        m_output_stream.write_bits(0b0000000, 7); // end of block symbol
-        m_output_stream.align_to_byte_boundary();
+        VERIFY(m_finished); // we shouldn't be writing empty blocks unless this is the final one
+        if (is_final_block) {
+            // if this is just an empty block to signify the end of the deflate stream use the smallest block possible (10 bits total)
+            m_output_stream.write_bits(0b01, 2);      // fixed huffman codes
+            m_output_stream.write_bits(0b0000000, 7); // end of block symbol
+            m_output_stream.align_to_byte_boundary();
+        } else {
+            // otherwise, an empty stored block gets us to a byte boundary
+            m_output_stream.write_bits(0b00, 2); // no compression
+            m_output_stream.align_to_byte_boundary();
+            LittleEndian<u16> len = 0;
+            LittleEndian<u16> nlen = 0xffff;
+            m_output_stream << len << nlen;
+        }
         return;
     }
 
@@ -1033,22 +1099,29 @@ void DeflateCompressor::flush()
         auto distance_code = CanonicalCode::from_bytes(dynamic_distance_bit_lengths);
         write_dynamic_huffman(literal_code.value(), literal_code_count, distance_code, distance_code_count, code_lengths_bit_lengths, code_lengths_count, encoded_lengths, encoded_lengths_count);
     }
-    if (m_finished)
+    if (is_final_block)
         m_output_stream.align_to_byte_boundary();
 
+    // keep the end of what has been compressed so far around for the next block to refer back to
+    auto history_size = min(m_history_size + m_pending_block_size, block_size);
+    memmove(m_rolling_window + block_size - history_size, m_rolling_window + block_size + m_pending_block_size - history_size, history_size);
+    m_history_size = history_size;
+
     // reset all block specific members
     m_pending_block_size = 0;
     m_pending_symbol_size = 0;
     m_symbol_frequencies.fill(0);
     m_distance_frequencies.fill(0);
-    // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
-    pending_block().copy_trimmed_to({ m_rolling_window, block_size });
 }
 
-void DeflateCompressor::final_flush()
+void DeflateCompressor::final_flush(MarkFinalBlock mark_final_block)
 {
     VERIFY(!m_finished);
     m_finished = true;
+    m_mark_final_block = mark_final_block;
+    // the last block with data isn't aligned to a byte boundary then, so it's followed by an empty one that is
+    if (mark_final_block == MarkFinalBlock::No && m_pending_block_size != 0)
+        flush();
     flush();
 }
 
@@ -1067,4 +1140,54 @@ Optional<ByteBuffer> DeflateCompressor::compress_all(ReadonlyBytes bytes, Compre
     return output_stream.copy_into_contiguous_buffer();
 }
 
+Optional<ByteBuffer> DeflateCompressor::compress_chunk(ReadonlyBytes dictionary, ReadonlyBytes chunk, MarkFinalBlock mark_final_block, CompressionLevel compression_level)
+{
+    DuplexMemoryStream output_stream;
+    // NOTE: This is too big for the stack of a pool worker.
+    auto deflate_stream = make<DeflateCompressor>(output_stream, compression_level);
+    deflate_stream->set_dictionary(dictionary);
+    deflate_stream->write_or_error(chunk);
+    deflate_stream->final_flush(mark_final_block);
+    if (deflate_stream->handle_any_error())
+        return {};
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+Optional<ByteBuffer> DeflateCompressor::parallel_compress_all(ReadonlyBytes bytes, size_t thread_count, CompressionLevel compression_level)
+{
+    auto chunk_count = ceil_div(bytes.size(), parallel_chunk_size);
+    if (thread_count <= 1 || chunk_count <= 1)
+        return compress_all(bytes, compression_level);
+
+    Vector<Optional<ByteBuffer>> compressed_chunks;
+    compressed_chunks.resize(chunk_count);
+
+    Atomic<size_t> next_chunk { 0 };
+    auto compress_remaining_chunks = [&] {
+        for (;;) {
+            auto chunk = next_chunk.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (chunk >= chunk_count)
+                return;
+            auto chunk_start = chunk * parallel_chunk_size;
+            auto mark_final_block = chunk == chunk_count - 1 ? MarkFinalBlock::Yes : MarkFinalBlock::No;
+            compressed_chunks[chunk] = compress_chunk(bytes.trim(chunk_start), bytes.slice(chunk_start, min(parallel_chunk_size, bytes.size() - chunk_start)), mark_final_block, compression_level);
+        }
+    };
+
+    auto& pool = Threading::ThreadPool::the();
+    Threading::TaskGroup group(pool);
+    auto helper_count = min(min(thread_count - 1, pool.worker_count()), chunk_count - 1);
+    for (size_t i = 0; i < helper_count; ++i)
+        group.spawn([&] { compress_remaining_chunks(); });
+    compress_remaining_chunks();
+    group.wait();
+
+    ByteBuffer output;
+    for (auto& compressed_chunk : compressed_chunks) {
+        if (!compressed_chunk.has_value() || output.try_append(compressed_chunk->bytes()).is_error())
+            return {};
+    }
+    return output;
+}
+
 }
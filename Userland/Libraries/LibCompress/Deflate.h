@@ -28,9 +28,18 @@ public:
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
-    Vector<u16> m_symbol_values;
+    void build_lookup_tables(size_t max_code_length);
+
+    // Decompression - indexed by the next `lookup_bits` bits of the input, in the order they're read (so the codes are bit-reversed).
+    // Entries hold a symbol and the length of its code, or for the prefixes of longer codes, which of the second-level tables
+    // (of 2^m_second_level_bits entries each) to look up the bits that follow in. Zero entries are for invalid codes.
+    static constexpr size_t lookup_bits = 9;
+    static constexpr u16 symbol_mask = 0x7ff;
+    static constexpr u16 second_level_flag = 0x800;
+    static constexpr size_t code_length_shift = 12;
+    Array<u16, 1 << lookup_bits> m_lookup_table {};
+    Vector<u16> m_second_level_tables;
+    size_t m_second_level_bits { 0 };
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -118,6 +127,8 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_back_reference_distance = 32 * KiB;
+    static constexpr size_t parallel_chunk_size = 128 * KiB;
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -144,14 +155,30 @@ public:
         BEST // WARNING: this one can take an unreasonable amount of time!
     };
 
+    enum class MarkFinalBlock {
+        Yes,
+        No,
+    };
+
     DeflateCompressor(OutputStream&, CompressionLevel = CompressionLevel::GOOD);
     ~DeflateCompressor();
 
+    // Lets the compressed data refer back to the end of `dictionary`, as if that had been compressed just before it.
+    // Has to be called before anything is written, and the decompressor has to have seen the same bytes right before.
+    void set_dictionary(ReadonlyBytes dictionary);
+
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
-    void final_flush();
+    // Without marking the final block, the output is padded to a byte boundary with an empty stored block instead,
+    // so that the blocks of another deflate stream can follow it.
+    void final_flush(MarkFinalBlock = MarkFinalBlock::Yes);
 
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes, CompressionLevel = CompressionLevel::GOOD);
+    // Compresses chunks of `parallel_chunk_size` bytes on up to `thread_count` threads, each one with the data before it
+    // as its dictionary, and strings them together into a single deflate stream.
+    static Optional<ByteBuffer> parallel_compress_all(ReadonlyBytes bytes, size_t thread_count, CompressionLevel = CompressionLevel::GOOD);
+    // Compresses one of those chunks, with `dictionary` holding the data before it.
+    static Optional<ByteBuffer> compress_chunk(ReadonlyBytes dictionary, ReadonlyBytes chunk, MarkFinalBlock, CompressionLevel = CompressionLevel::GOOD);
 
 private:
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
@@ -182,12 +209,15 @@ private:
     void flush();
 
     bool m_finished { false };
+    MarkFinalBlock m_mark_final_block { MarkFinalBlock::Yes };
     CompressionLevel m_compression_level;
     CompressionConstants m_compression_constants;
     OutputBitStream m_output_stream;
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    // How much of what came before the pending block (right before it, in the rolling window) it may refer back to.
+    size_t m_history_size { 0 };
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
@@ -7,9 +7,11 @@
 
 #include <LibCompress/Gzip.h>
 
+#include <AK/IntegralMath.h>
 #include <AK/MemoryStream.h>
 #include <AK/String.h>
 #include <LibCore/DateTime.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace Compress {
 
@@ -225,7 +227,7 @@ GzipCompressor::GzipCompressor(OutputStream& stream)
 {
 }
 
-size_t GzipCompressor::write(ReadonlyBytes bytes)
+static void write_member_header(OutputStream& stream)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -235,15 +237,25 @@ size_t GzipCompressor::write(ReadonlyBytes bytes)
     header.modification_time = 0;
     header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
     header.operating_system = 3; // unix
-    m_output_stream << Bytes { &header, sizeof(header) };
+    stream << Bytes { &header, sizeof(header) };
+}
+
+static void write_member_trailer(OutputStream& stream, ReadonlyBytes uncompressed_bytes)
+{
+    Crypto::Checksum::CRC32 crc32;
+    crc32.update(uncompressed_bytes);
+    LittleEndian<u32> digest = crc32.digest();
+    LittleEndian<u32> size = uncompressed_bytes.size();
+    stream << digest << size;
+}
+
+size_t GzipCompressor::write(ReadonlyBytes bytes)
+{
+    write_member_header(m_output_stream);
     DeflateCompressor compressed_stream { m_output_stream };
     VERIFY(compressed_stream.write_or_error(bytes));
     compressed_stream.final_flush();
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    LittleEndian<u32> digest = crc32.digest();
-    LittleEndian<u32> size = bytes.size();
-    m_output_stream << digest << size;
+    write_member_trailer(m_output_stream, bytes);
     return bytes.size();
 }
 
@@ -270,4 +282,127 @@ Optional<ByteBuffer> GzipCompressor::compress_all(ReadonlyBytes bytes)
     return output_stream.copy_into_contiguous_buffer();
 }
 
+Optional<ByteBuffer> GzipCompressor::parallel_compress_all(ReadonlyBytes bytes, size_t thread_count)
+{
+    auto compressed_bytes = DeflateCompressor::parallel_compress_all(bytes, thread_count);
+    if (!compressed_bytes.has_value())
+        return {};
+
+    DuplexMemoryStream output_stream;
+    write_member_header(output_stream);
+    output_stream.write_or_error(compressed_bytes.value());
+    write_member_trailer(output_stream, bytes);
+    return output_stream.copy_into_contiguous_buffer();
+}
+
+struct ParallelGzipCompressor::CompressingBatch {
+    ByteBuffer input;
+    ByteBuffer dictionary;
+    Vector<Optional<ByteBuffer>> compressed_chunks;
+    Threading::TaskGroup group;
+};
+
+ParallelGzipCompressor::ParallelGzipCompressor(OutputStream& stream)
+    : m_output_stream(stream)
+    , m_batch_size(DeflateCompressor::parallel_chunk_size * Threading::ThreadPool::the().concurrency())
+{
+    write_member_header(m_output_stream);
+}
+
+ParallelGzipCompressor::~ParallelGzipCompressor() = default;
+
+size_t ParallelGzipCompressor::write(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+    m_checksum.update(bytes);
+    m_total_size += bytes.size();
+
+    auto remaining_bytes = bytes;
+    while (!remaining_bytes.is_empty()) {
+        auto size = min(remaining_bytes.size(), m_batch_size - m_batch.size());
+        if (m_batch.try_append(remaining_bytes.trim(size)).is_error()) {
+            set_fatal_error();
+            return bytes.size() - remaining_bytes.size();
+        }
+        remaining_bytes = remaining_bytes.slice(size);
+        if (m_batch.size() == m_batch_size) {
+            write_compressed_batch();
+            start_compressing_batch();
+        }
+    }
+    return bytes.size();
+}
+
+bool ParallelGzipCompressor::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+void ParallelGzipCompressor::start_compressing_batch()
+{
+    auto batch = make<CompressingBatch>();
+    batch->input = move(m_batch);
+    batch->dictionary = move(m_dictionary);
+
+    auto input = batch->input.bytes();
+    auto dictionary_size = min(input.size(), DeflateCompressor::max_back_reference_distance);
+    if (auto dictionary = ByteBuffer::copy(input.slice(input.size() - dictionary_size)); !dictionary.is_error())
+        m_dictionary = dictionary.release_value();
+    else
+        set_fatal_error();
+
+    // NOTE: None of the chunks end the deflate stream, as we don't know yet whether more input is coming.
+    auto chunk_count = ceil_div(input.size(), DeflateCompressor::parallel_chunk_size);
+    batch->compressed_chunks.resize(chunk_count);
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        batch->group.spawn([batch = batch.ptr(), chunk] {
+            auto input = batch->input.bytes();
+            auto chunk_start = chunk * DeflateCompressor::parallel_chunk_size;
+            auto dictionary = chunk == 0 ? batch->dictionary.bytes() : input.trim(chunk_start);
+            auto chunk_bytes = input.slice(chunk_start, min(DeflateCompressor::parallel_chunk_size, input.size() - chunk_start));
+            batch->compressed_chunks[chunk] = DeflateCompressor::compress_chunk(dictionary, chunk_bytes, DeflateCompressor::MarkFinalBlock::No);
+        });
+    }
+    m_compressing_batch = move(batch);
+}
+
+void ParallelGzipCompressor::write_compressed_batch()
+{
+    if (!m_compressing_batch)
+        return;
+
+    m_compressing_batch->group.wait();
+    for (auto& compressed_chunk : m_compressing_batch->compressed_chunks) {
+        if (!compressed_chunk.has_value() || !m_output_stream.write_or_error(compressed_chunk->bytes()))
+            set_fatal_error();
+    }
+    m_compressing_batch = nullptr;
+}
+
+void ParallelGzipCompressor::finish()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+
+    if (!m_batch.is_empty()) {
+        write_compressed_batch();
+        start_compressing_batch();
+    }
+    write_compressed_batch();
+
+    // All the chunks were byte-aligned and not final, so end the deflate stream with an empty final block
+    // (using the fixed Huffman codes, where it's just the end-of-block symbol).
+    constexpr u8 empty_final_block[] = { 0x03, 0x00 };
+    m_output_stream << ReadonlyBytes { empty_final_block, sizeof(empty_final_block) };
+
+    LittleEndian<u32> digest = m_checksum.digest();
+    LittleEndian<u32> size = m_total_size;
+    m_output_stream << digest << size;
+}
+
 }
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/OwnPtr.h>
 #include <LibCompress/Deflate.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
@@ -88,9 +89,40 @@ public:
     bool write_or_error(ReadonlyBytes) override;
 
     static Optional<ByteBuffer> compress_all(ReadonlyBytes bytes);
+    // Produces a single gzip member just like compress_all(), but compresses it on up to `thread_count` threads.
+    static Optional<ByteBuffer> parallel_compress_all(ReadonlyBytes bytes, size_t thread_count);
 
 private:
     OutputStream& m_output_stream;
 };
 
+// Compresses everything written to it into a single gzip member. The input is collected into batches, which are
+// deflated in chunks on the thread pool (just like DeflateCompressor::parallel_compress_all() does) while the next
+// batch is being collected. finish() has to be called after the last write.
+class ParallelGzipCompressor final : public OutputStream {
+public:
+    explicit ParallelGzipCompressor(OutputStream&);
+    ~ParallelGzipCompressor();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+    void finish();
+
+private:
+    struct CompressingBatch;
+
+    void start_compressing_batch();
+    void write_compressed_batch();
+
+    OutputStream& m_output_stream;
+    size_t m_batch_size { 0 };
+    ByteBuffer m_batch;
+    // The end of the data before the collected batch, which the batch may refer back to.
+    ByteBuffer m_dictionary;
+    OwnPtr<CompressingBatch> m_compressing_batch;
+    Crypto::Checksum::CRC32 m_checksum;
+    u32 m_total_size { 0 };
+    bool m_finished { false };
+};
+
 }
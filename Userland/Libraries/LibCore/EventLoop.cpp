@@ -14,6 +14,8 @@
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
 #include <AK/NeverDestroyed.h>
+#include <AK/NumericLimits.h>
+#include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Time.h>
@@ -35,6 +37,11 @@
 #include <time.h>
 #include <unistd.h>
 
+#if defined(__serenity__) || defined(__linux__)
+#    define EVENTLOOP_USE_EPOLL
+#    include <sys/epoll.h>
+#endif
+
 #ifdef __serenity__
 extern bool s_global_initializers_ran;
 #endif
@@ -46,17 +53,104 @@ class InspectorServerConnection;
 [[maybe_unused]] static bool connect_to_inspector_server();
 
 struct EventLoopTimer {
+    static constexpr size_t not_in_heap = NumericLimits<size_t>::max();
+
     int timer_id { 0 };
     Time interval;
+    // Fire times are rounded up to a multiple of this, so that timers with the same slack expire together.
+    Time slack;
     Time fire_time;
     bool should_reload { false };
     TimerShouldFireWhenNotVisible fire_when_not_visible { TimerShouldFireWhenNotVisible::No };
     WeakPtr<Object> owner;
+    // The timer's position in the TimerHeap, or not_in_heap while it waits for its owner to become visible.
+    size_t heap_index { not_in_heap };
 
     void reload(const Time& now);
     bool has_expired(const Time& now) const;
 };
 
+// The timers of a thread, ordered by fire time, so that finding the next timer to fire is O(1),
+// and adding, removing or reloading one is O(log n).
+class TimerHeap {
+public:
+    bool is_empty() const { return m_timers.is_empty(); }
+    EventLoopTimer& peek_min() { return *m_timers.first(); }
+
+    void insert(EventLoopTimer& timer)
+    {
+        VERIFY(timer.heap_index == EventLoopTimer::not_in_heap);
+        timer.heap_index = m_timers.size();
+        m_timers.append(&timer);
+        sift_up(timer.heap_index);
+    }
+
+    void remove(EventLoopTimer& timer)
+    {
+        auto index = timer.heap_index;
+        VERIFY(index < m_timers.size() && m_timers[index] == &timer);
+        swap_timers(index, m_timers.size() - 1);
+        m_timers.take_last();
+        timer.heap_index = EventLoopTimer::not_in_heap;
+        if (index < m_timers.size()) {
+            sift_up(index);
+            sift_down(index);
+        }
+    }
+
+    void clear()
+    {
+        for (auto* timer : m_timers)
+            timer->heap_index = EventLoopTimer::not_in_heap;
+        m_timers.clear();
+    }
+
+private:
+    void swap_timers(size_t a, size_t b)
+    {
+        swap(m_timers[a], m_timers[b]);
+        m_timers[a]->heap_index = a;
+        m_timers[b]->heap_index = b;
+    }
+
+    void sift_up(size_t index)
+    {
+        while (index > 0) {
+            auto parent = (index - 1) / 2;
+            if (m_timers[parent]->fire_time <= m_timers[index]->fire_time)
+                break;
+            swap_timers(index, parent);
+            index = parent;
+        }
+    }
+
+    void sift_down(size_t index)
+    {
+        while (index * 2 + 1 < m_timers.size()) {
+            auto child = index * 2 + 1;
+            if (child + 1 < m_timers.size() && m_timers[child + 1]->fire_time < m_timers[child]->fire_time)
+                ++child;
+            if (m_timers[index]->fire_time <= m_timers[child]->fire_time)
+                break;
+            swap_timers(index, child);
+            index = child;
+        }
+    }
+
+    Vector<EventLoopTimer*> m_timers;
+};
+
+struct EventLoopNotifiers {
+    Vector<Notifier*, 1> notifiers;
+#ifdef EVENTLOOP_USE_EPOLL
+    // The Notifier::Event mask the epoll instance currently watches the fd for.
+    unsigned watched_event_mask { 0 };
+    // Some fds (e.g. regular files on Linux) can't be added to an epoll instance,
+    // those are treated as always being ready, just like select() does.
+    bool is_always_ready { false };
+#endif
+};
+
 struct EventLoop::Private {
     Threading::Mutex lock;
 };
@@ -69,7 +163,15 @@ static Threading::MutexProtected<RefPtr<InspectorServerConnection>> s_inspector_
 // Each thread has its own event loop stack, its own timers, notifiers and a wake pipe.
 static thread_local Vector<EventLoop&>* s_event_loop_stack;
 static thread_local HashMap<int, NonnullOwnPtr<EventLoopTimer>>* s_timers;
-static thread_local HashTable<Notifier*>* s_notifiers;
+static thread_local TimerHeap* s_timer_heap;
+// Expired timers that don't fire while their owner is invisible. They fire once it becomes visible again.
+static thread_local Vector<EventLoopTimer*>* s_timers_waiting_for_visibility;
+// Notifiers are grouped by fd, so that handling a ready fd only has to look at the notifiers watching it.
+static thread_local HashMap<int, EventLoopNotifiers>* s_notifiers;
+#ifdef EVENTLOOP_USE_EPOLL
+static thread_local int s_epoll_fd { -1 };
+static thread_local size_t s_always_ready_fd_count { 0 };
+#endif
 thread_local int EventLoop::s_wake_pipe_fds[2];
 thread_local bool EventLoop::s_wake_pipe_initialized { false };
 
@@ -85,6 +187,19 @@ void EventLoop::initialize_wake_pipes()
 
 #endif
         VERIFY(rc == 0);
+#ifdef EVENTLOOP_USE_EPOLL
+        // The epoll instance is created along with the wake pipe, since it's the first fd it watches.
+        if (s_epoll_fd >= 0)
+            close(s_epoll_fd);
+        s_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        VERIFY(s_epoll_fd >= 0);
+        epoll_event wake_event {};
+        wake_event.events = EPOLLIN;
+        wake_event.data.fd = s_wake_pipe_fds[0];
+        rc = epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, s_wake_pipe_fds[0], &wake_event);
+        VERIFY(rc == 0);
+        s_always_ready_fd_count = 0;
+#endif
         s_wake_pipe_initialized = true;
     }
 }
@@ -321,7 +436,9 @@ EventLoop::EventLoop([[maybe_unused]] MakeInspectable make_inspectable)
     if (!s_event_loop_stack) {
         s_event_loop_stack = new Vector<EventLoop&>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
-        s_notifiers = new HashTable<Notifier*>;
+        s_timer_heap = new TimerHeap;
+        s_timers_waiting_for_visibility = new Vector<EventLoopTimer*>;
+        s_notifiers = new HashMap<int, EventLoopNotifiers>;
     }
     s_main_event_loop.with_locked([&, this](auto*& main_event_loop) {
         if (main_event_loop == nullptr) {
@@ -457,6 +574,11 @@ size_t EventLoop::pump(WaitMode mode)
         events = move(m_queued_events);
     }
 
+    auto pump_start_time = Time::now_monotonic_coarse();
+    ScopeGuard record_pump_duration = [&] {
+        m_statistics.max_pump_duration = max(m_statistics.max_pump_duration, Time::now_monotonic_coarse() - pump_start_time);
+    };
+
     size_t processed_events = 0;
     for (size_t i = 0; i < events.size(); ++i) {
         auto& queued_event = events.at(i);
@@ -642,6 +764,8 @@ void EventLoop::notify_forked(ForkEvent event)
     case ForkEvent::Child:
         s_main_event_loop.with_locked([]([[maybe_unused]] auto*& main_event_loop) { main_event_loop = nullptr; });
         s_event_loop_stack->clear();
+        s_timer_heap->clear();
+        s_timers_waiting_for_visibility->clear();
         s_timers->clear();
         s_notifiers->clear();
         s_wake_pipe_initialized = false;
@@ -662,6 +786,10 @@ void EventLoop::notify_forked(ForkEvent event)
 
 void EventLoop::wait_for_event(WaitMode mode)
 {
+#ifdef EVENTLOOP_USE_EPOLL
+    epoll_event ready_events[32];
+retry:
+#else
     fd_set rfds;
     fd_set wfds;
 retry:
@@ -679,14 +807,17 @@ retry:
     add_fd_to_set(s_wake_pipe_fds[0], rfds);
     max_fd = max(max_fd, max_fd_added);
 
-    for (auto& notifier : *s_notifiers) {
-        if (notifier->event_mask() & Notifier::Read)
-            add_fd_to_set(notifier->fd(), rfds);
-        if (notifier->event_mask() & Notifier::Write)
-            add_fd_to_set(notifier->fd(), wfds);
-        if (notifier->event_mask() & Notifier::Exceptional)
-            VERIFY_NOT_REACHED();
+    for (auto& it : *s_notifiers) {
+        for (auto* notifier : it.value.notifiers) {
+            if (notifier->event_mask() & Notifier::Read)
+                add_fd_to_set(notifier->fd(), rfds);
+            if (notifier->event_mask() & Notifier::Write)
+                add_fd_to_set(notifier->fd(), wfds);
+            if (notifier->event_mask() & Notifier::Exceptional)
+                VERIFY_NOT_REACHED();
+        }
     }
+#endif
 
     bool queued_events_is_empty;
     {
@@ -695,23 +826,36 @@ retry:
     }
 
     Time now;
-    struct timeval timeout = { 0, 0 };
+    Time timeout = Time::zero();
     bool should_wait_forever = false;
     if (mode == WaitMode::WaitForEvents && queued_events_is_empty) {
         auto next_timer_expiration = get_next_timer_expiration();
         if (next_timer_expiration.has_value()) {
             now = Time::now_monotonic_coarse();
-            auto computed_timeout = next_timer_expiration.value() - now;
-            if (computed_timeout.is_negative())
-                computed_timeout = Time::zero();
-            timeout = computed_timeout.to_timeval();
+            timeout = next_timer_expiration.value() - now;
+            if (timeout.is_negative())
+                timeout = Time::zero();
         } else {
             should_wait_forever = true;
         }
     }
 
+#ifdef EVENTLOOP_USE_EPOLL
+    if (s_always_ready_fd_count > 0) {
+        timeout = Time::zero();
+        should_wait_forever = false;
+    }
+#else
+    struct timeval timeout_timeval = timeout.to_timeval();
+#endif
+
 try_select_again:
-    int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+#ifdef EVENTLOOP_USE_EPOLL
+    int timeout_ms = should_wait_forever ? -1 : static_cast<int>(min(timeout.to_milliseconds(), static_cast<i64>(NumericLimits<int>::max())));
+    int marked_fd_count = epoll_wait(s_epoll_fd, ready_events, array_size(ready_events), timeout_ms);
+#else
+    int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout_timeval);
+#endif
     if (marked_fd_count < 0) {
         int saved_errno = errno;
         if (saved_errno == EINTR) {
@@ -722,7 +866,17 @@ try_select_again:
         dbgln("Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
         VERIFY_NOT_REACHED();
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+
+#ifdef EVENTLOOP_USE_EPOLL
+    bool wake_pipe_is_readable = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (ready_events[i].data.fd == s_wake_pipe_fds[0])
+            wake_pipe_is_readable = true;
+    }
+#else
+    bool wake_pipe_is_readable = FD_ISSET(s_wake_pipe_fds[0], &rfds);
+#endif
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -751,45 +905,91 @@ try_select_again:
             goto retry;
     }
 
-    if (!s_timers->is_empty()) {
-        now = Time::now_monotonic_coarse();
-    }
+    ++m_statistics.wakeups;
 
-    for (auto& it : *s_timers) {
-        auto& timer = *it.value;
-        if (!timer.has_expired(now))
-            continue;
-        auto owner = timer.owner.strong_ref();
-        if (timer.fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
-            continue;
-        }
+    if (!s_timers->is_empty())
+        now = Time::now_monotonic_coarse();
 
+    auto fire_timer = [&](EventLoopTimer& timer, Object* owner) {
         dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Timer {} has expired, sending Core::TimerEvent to {}", timer.timer_id, *owner);
 
+        auto latency = now - timer.fire_time;
+        ++m_statistics.fired_timers;
+        m_statistics.total_timer_latency += latency;
+        m_statistics.max_timer_latency = max(m_statistics.max_timer_latency, latency);
+
         if (owner)
             post_event(*owner, make<TimerEvent>(timer.timer_id));
         if (timer.should_reload) {
             timer.reload(now);
+            s_timer_heap->insert(timer);
         } else {
             // FIXME: Support removing expired timers that don't want to reload.
             VERIFY_NOT_REACHED();
         }
+    };
+
+    for (size_t i = 0; i < s_timers_waiting_for_visibility->size();) {
+        auto& timer = *s_timers_waiting_for_visibility->at(i);
+        auto owner = timer.owner.strong_ref();
+        if (owner && !owner->is_visible_for_timer_purposes()) {
+            ++i;
+            continue;
+        }
+        s_timers_waiting_for_visibility->remove(i);
+        fire_timer(timer, owner.ptr());
     }
 
-    if (!marked_fd_count)
-        return;
+    while (!s_timer_heap->is_empty() && s_timer_heap->peek_min().has_expired(now)) {
+        auto& timer = s_timer_heap->peek_min();
+        s_timer_heap->remove(timer);
+        auto owner = timer.owner.strong_ref();
+        if (timer.fire_when_not_visible == TimerShouldFireWhenNotVisible::No
+            && owner && !owner->is_visible_for_timer_purposes()) {
+            s_timers_waiting_for_visibility->append(&timer);
+            continue;
+        }
+        fire_timer(timer, owner.ptr());
+    }
 
-    for (auto& notifier : *s_notifiers) {
-        if (FD_ISSET(notifier->fd(), &rfds)) {
-            if (notifier->event_mask() & Notifier::Event::Read)
+    auto post_notifier_events = [this](EventLoopNotifiers const& fd_notifiers, bool is_readable, bool is_writable) {
+        for (auto* notifier : fd_notifiers.notifiers) {
+            if (is_readable && (notifier->event_mask() & Notifier::Event::Read))
                 post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
-        }
-        if (FD_ISSET(notifier->fd(), &wfds)) {
-            if (notifier->event_mask() & Notifier::Event::Write)
+            if (is_writable && (notifier->event_mask() & Notifier::Event::Write))
                 post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
         }
+    };
+
+#ifdef EVENTLOOP_USE_EPOLL
+    if (s_always_ready_fd_count > 0) {
+        for (auto& it : *s_notifiers) {
+            if (it.value.is_always_ready)
+                post_notifier_events(it.value, true, true);
+        }
     }
+
+    for (int i = 0; i < marked_fd_count; ++i) {
+        auto& ready_event = ready_events[i];
+        auto it = s_notifiers->find(ready_event.data.fd);
+        if (it == s_notifiers->end())
+            continue;
+        // NOTE: select() reports errors and hang-ups as the fd being ready, so we do the same.
+        bool is_readable = ready_event.events & (EPOLLIN | EPOLLHUP | EPOLLERR);
+        bool is_writable = ready_event.events & (EPOLLOUT | EPOLLERR);
+        post_notifier_events(it->value, is_readable, is_writable);
+    }
+#else
+    if (!marked_fd_count)
+        return;
+
+    for (auto& it : *s_notifiers) {
+        bool is_readable = FD_ISSET(it.key, &rfds);
+        bool is_writable = FD_ISSET(it.key, &wfds);
+        if (is_readable || is_writable)
+            post_notifier_events(it.value, is_readable, is_writable);
+    }
+#endif
 }
 
 bool EventLoopTimer::has_expired(const Time& now) const
@@ -800,41 +1000,41 @@ bool EventLoopTimer::has_expired(const Time& now) const
 void EventLoopTimer::reload(const Time& now)
 {
     fire_time = now + interval;
+    if (!slack.is_zero()) {
+        auto slack_ns = slack.to_nanoseconds();
+        if (auto remainder = fire_time.to_nanoseconds() % slack_ns; remainder != 0)
+            fire_time += Time::from_nanoseconds(slack_ns - remainder);
+    }
 }
 
 Optional<Time> EventLoop::get_next_timer_expiration()
 {
-    auto now = Time::now_monotonic_coarse();
-    Optional<Time> soonest {};
-    for (auto& it : *s_timers) {
-        auto& fire_time = it.value->fire_time;
-        auto owner = it.value->owner.strong_ref();
-        if (it.value->fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
-            continue;
-        }
-        // OPTIMIZATION: If we have a timer that needs to fire right away, we can stop looking here.
-        // FIXME: This whole operation could be O(1) with a better data structure.
-        if (fire_time < now)
-            return now;
-        if (!soonest.has_value() || fire_time < soonest.value())
-            soonest = fire_time;
+    for (auto* timer : *s_timers_waiting_for_visibility) {
+        auto owner = timer->owner.strong_ref();
+        if (!owner || owner->is_visible_for_timer_purposes())
+            return Time::now_monotonic_coarse();
     }
-    return soonest;
+    // NOTE: The soonest timer's owner may be invisible, in which case we wake up only to move it aside.
+    if (s_timer_heap->is_empty())
+        return {};
+    return s_timer_heap->peek_min().fire_time;
 }
 
-int EventLoop::register_timer(Object& object, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible fire_when_not_visible)
+int EventLoop::register_timer(Object& object, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible fire_when_not_visible, int slack_milliseconds)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
     VERIFY(milliseconds >= 0);
+    VERIFY(slack_milliseconds >= 0);
     auto timer = make<EventLoopTimer>();
     timer->owner = object;
     timer->interval = Time::from_milliseconds(milliseconds);
+    timer->slack = Time::from_milliseconds(slack_milliseconds);
     timer->reload(Time::now_monotonic_coarse());
     timer->should_reload = should_reload;
     timer->fire_when_not_visible = fire_when_not_visible;
     int timer_id = s_id_allocator.with_locked([](auto& allocator) { return allocator->allocate(); });
     timer->timer_id = timer_id;
+    s_timer_heap->insert(*timer);
     s_timers->set(timer_id, move(timer));
     return timer_id;
 }
@@ -846,20 +1046,105 @@ bool EventLoop::unregister_timer(int timer_id)
     auto it = s_timers->find(timer_id);
     if (it == s_timers->end())
         return false;
+    auto& timer = *it->value;
+    if (timer.heap_index != EventLoopTimer::not_in_heap)
+        s_timer_heap->remove(timer);
+    else
+        s_timers_waiting_for_visibility->remove_first_matching([&](auto* other_timer) { return other_timer == &timer; });
     s_timers->remove(it);
     return true;
 }
 
+#ifdef EVENTLOOP_USE_EPOLL
+static void update_watched_events(int fd, EventLoopNotifiers& fd_notifiers)
+{
+    unsigned event_mask = 0;
+    for (auto* notifier : fd_notifiers.notifiers)
+        event_mask |= notifier->event_mask();
+    VERIFY(!(event_mask & Notifier::Exceptional));
+
+    if (fd_notifiers.is_always_ready) {
+        if (fd_notifiers.notifiers.is_empty()) {
+            fd_notifiers.is_always_ready = false;
+            --s_always_ready_fd_count;
+        }
+        return;
+    }
+
+    if (event_mask == fd_notifiers.watched_event_mask)
+        return;
+
+    if (event_mask == 0) {
+        // NOTE: The fd may have been closed already, in which case there's nothing left to remove.
+        (void)epoll_ctl(s_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        fd_notifiers.watched_event_mask = 0;
+        return;
+    }
+
+    epoll_event event {};
+    if (event_mask & Notifier::Read)
+        event.events |= EPOLLIN;
+    if (event_mask & Notifier::Write)
+        event.events |= EPOLLOUT;
+    event.data.fd = fd;
+
+    int op = fd_notifiers.watched_event_mask == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    int rc = epoll_ctl(s_epoll_fd, op, fd, &event);
+    if (rc < 0 && op == EPOLL_CTL_ADD && errno == EEXIST) {
+        // Someone closed this fd while it was still being watched, and the number got reused. Replace the stale entry.
+        (void)epoll_ctl(s_epoll_fd, EPOLL_CTL_DEL, fd, nullptr);
+        rc = epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    } else if (rc < 0 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+        rc = epoll_ctl(s_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    if (rc < 0 && errno == EPERM) {
+        fd_notifiers.is_always_ready = true;
+        ++s_always_ready_fd_count;
+        return;
+    }
+    if (rc < 0) {
+        perror("Core::EventLoop: epoll_ctl");
+        VERIFY_NOT_REACHED();
+    }
+    fd_notifiers.watched_event_mask = event_mask;
+}
+#endif
+
 void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
-    s_notifiers->set(&notifier);
+    auto& fd_notifiers = s_notifiers->ensure(notifier.fd());
+    if (!fd_notifiers.notifiers.contains_slow(&notifier))
+        fd_notifiers.notifiers.append(&notifier);
+#ifdef EVENTLOOP_USE_EPOLL
+    update_watched_events(notifier.fd(), fd_notifiers);
+#endif
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
     VERIFY_EVENT_LOOP_INITIALIZED();
-    s_notifiers->remove(&notifier);
+    auto it = s_notifiers->find(notifier.fd());
+    if (it == s_notifiers->end())
+        return;
+    it->value.notifiers.remove_first_matching([&](auto* other) { return other == &notifier; });
+#ifdef EVENTLOOP_USE_EPOLL
+    update_watched_events(it->key, it->value);
+#endif
+    if (it->value.notifiers.is_empty())
+        s_notifiers->remove(it);
+}
+
+void EventLoop::notifier_event_mask_did_change(Badge<Notifier>, [[maybe_unused]] Notifier& notifier)
+{
+    VERIFY_EVENT_LOOP_INITIALIZED();
+#ifdef EVENTLOOP_USE_EPOLL
+    auto it = s_notifiers->find(notifier.fd());
+    if (it == s_notifiers->end() || !it->value.notifiers.contains_slow(&notifier))
+        return;
+    update_watched_events(it->key, it->value);
+#endif
 }
 
 void EventLoop::wake_current()
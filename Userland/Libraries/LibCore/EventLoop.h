@@ -71,11 +71,25 @@ public:
 
     bool was_exit_requested() const { return m_exit_requested; }
 
-    static int register_timer(Object&, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible);
+    // How quickly this event loop gets around to its work, e.g. to find out why an application feels sluggish.
+    struct Statistics {
+        u64 wakeups { 0 };
+        u64 fired_timers { 0 };
+        // How much later than scheduled the timers fired.
+        Time total_timer_latency;
+        Time max_timer_latency;
+        // The longest time a single pump() took to handle its events.
+        Time max_pump_duration;
+    };
+    Statistics const& statistics() const { return m_statistics; }
+    void reset_statistics() { m_statistics = {}; }
+
+    static int register_timer(Object&, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible, int slack_milliseconds = 0);
     static bool unregister_timer(int timer_id);
 
     static void register_notifier(Badge<Notifier>, Notifier&);
     static void unregister_notifier(Badge<Notifier>, Notifier&);
+    static void notifier_event_mask_did_change(Badge<Notifier>, Notifier&);
 
     void quit(int);
     void unquit();
@@ -130,6 +144,8 @@ private:
     bool m_exit_requested { false };
     int m_exit_code { 0 };
 
+    Statistics m_statistics;
+
     static thread_local int s_wake_pipe_fds[2];
     static thread_local bool s_wake_pipe_initialized;
 
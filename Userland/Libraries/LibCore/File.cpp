@@ -395,6 +395,10 @@ ErrorOr<void, File::CopyError> File::copy_file_or_directory(String const& dst_pa
     return copy_file(dst_path, src_stat, source, preserve_mode);
 }
 
+#if defined(__serenity__) || defined(__linux__)
+static constexpr size_t copy_file_range_chunk_size = 1 * MiB;
+#endif
+
 ErrorOr<void, File::CopyError> File::copy_file(String const& dst_path, struct stat const& src_stat, File& source, PreserveMode preserve_mode)
 {
     int dst_fd = creat(dst_path.characters(), 0666);
@@ -415,7 +419,26 @@ ErrorOr<void, File::CopyError> File::copy_file(String const& dst_path, struct st
             return CopyError { errno, false };
     }
 
-    for (;;) {
+    bool should_copy_in_userspace = true;
+#if defined(__serenity__) || defined(__linux__)
+    // Let the kernel move the data from file to file, so it doesn't have to be copied through a userspace buffer.
+    for (bool is_first_chunk = true;; is_first_chunk = false) {
+        ssize_t ncopied = ::copy_file_range(source.fd(), nullptr, dst_fd, nullptr, copy_file_range_chunk_size, 0);
+        if (ncopied < 0) {
+            // These files can't be copied in the kernel (e.g. the source is a device); copy whatever is left below.
+            if (errno == EINVAL || errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP)
+                break;
+            return CopyError { errno, false };
+        }
+        if (ncopied == 0) {
+            // NOTE: Some synthetic files report a size of 0 and can only be read with read(), so don't trust an immediate end of file for those.
+            should_copy_in_userspace = is_first_chunk && src_stat.st_size == 0;
+            break;
+        }
+    }
+#endif
+
+    while (should_copy_in_userspace) {
         char buffer[32768];
         ssize_t nread = ::read(source.fd(), buffer, sizeof(buffer));
         if (nread < 0) {
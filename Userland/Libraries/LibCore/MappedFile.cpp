@@ -14,13 +14,32 @@
 
 namespace Core {
 
-ErrorOr<NonnullRefPtr<MappedFile>> MappedFile::map(String const& path)
+static size_t page_size()
+{
+    static size_t const s_page_size = sysconf(_SC_PAGESIZE);
+    return s_page_size;
+}
+
+static int madvise_advice_for(MappedFile::AccessPattern access_pattern)
+{
+    switch (access_pattern) {
+    case MappedFile::AccessPattern::Normal:
+        return MADV_NORMAL;
+    case MappedFile::AccessPattern::Sequential:
+        return MADV_SEQUENTIAL;
+    case MappedFile::AccessPattern::Random:
+        return MADV_RANDOM;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+ErrorOr<NonnullRefPtr<MappedFile>> MappedFile::map(String const& path, AccessPattern access_pattern)
 {
     auto fd = TRY(Core::System::open(path, O_RDONLY | O_CLOEXEC, 0));
-    return map_from_fd_and_close(fd, path);
+    return map_from_fd_and_close(fd, path, access_pattern);
 }
 
-ErrorOr<NonnullRefPtr<MappedFile>> MappedFile::map_from_fd_and_close(int fd, [[maybe_unused]] String const& path)
+ErrorOr<NonnullRefPtr<MappedFile>> MappedFile::map_from_fd_and_close(int fd, [[maybe_unused]] String const& path, AccessPattern access_pattern)
 {
     TRY(Core::System::fcntl(fd, F_SETFD, FD_CLOEXEC));
 
@@ -33,7 +52,13 @@ ErrorOr<NonnullRefPtr<MappedFile>> MappedFile::map_from_fd_and_close(int fd, [[m
 
     auto* ptr = TRY(Core::System::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0, 0, path));
 
-    return adopt_ref(*new MappedFile(ptr, size));
+    auto file = adopt_ref(*new MappedFile(ptr, size));
+    if (access_pattern != AccessPattern::Normal) {
+        // NOTE: This is only a hint, so the file is perfectly usable without it.
+        if (auto result = file->set_access_pattern(access_pattern); result.is_error())
+            dbgln("MappedFile: Unable to set the access pattern for {}: {}", path, result.error());
+    }
+    return file;
 }
 
 MappedFile::MappedFile(void* ptr, size_t size)
@@ -47,4 +72,103 @@ MappedFile::~MappedFile()
     MUST(Core::System::munmap(m_data, m_size));
 }
 
+ErrorOr<void> MappedFile::set_access_pattern(AccessPattern access_pattern)
+{
+    return Core::System::madvise(m_data, m_size, madvise_advice_for(access_pattern));
+}
+
+static ErrorOr<void> madvise_range(void* data, size_t mapping_size, size_t offset, size_t size, int advice)
+{
+    if (offset > mapping_size || size > mapping_size - offset)
+        return Error::from_errno(EINVAL);
+    if (size == 0)
+        return {};
+
+    // madvise() wants a page-aligned address, so extend the range back to the start of its first page.
+    auto misalignment = offset % page_size();
+    return Core::System::madvise(static_cast<u8*>(data) + offset - misalignment, size + misalignment, advice);
+}
+
+ErrorOr<void> MappedFile::will_need(size_t offset, size_t size)
+{
+    return madvise_range(m_data, m_size, offset, size, MADV_WILLNEED);
+}
+
+ErrorOr<void> MappedFile::dont_need(size_t offset, size_t size)
+{
+    return madvise_range(m_data, m_size, offset, size, MADV_DONTNEED);
+}
+
+ErrorOr<NonnullOwnPtr<MappedFileWindow>> MappedFileWindow::open(String const& path, size_t window_size)
+{
+    auto fd = TRY(Core::System::open(path, O_RDONLY | O_CLOEXEC, 0));
+    auto file_or_error = adopt_fd(fd, path, window_size);
+    if (file_or_error.is_error())
+        close(fd);
+    return file_or_error;
+}
+
+ErrorOr<NonnullOwnPtr<MappedFileWindow>> MappedFileWindow::adopt_fd(int fd, String const& path, size_t window_size)
+{
+    if (window_size == 0)
+        return Error::from_errno(EINVAL);
+    // Windows have to start on a page boundary, since that's where mappings of a file can start.
+    window_size = round_up_to_power_of_two(window_size, page_size());
+
+    TRY(Core::System::fcntl(fd, F_SETFD, FD_CLOEXEC));
+    auto stat = TRY(Core::System::fstat(fd));
+    return adopt_nonnull_own_or_enomem(new (nothrow) MappedFileWindow(fd, path, stat.st_size, window_size));
+}
+
+MappedFileWindow::MappedFileWindow(int fd, String path, size_t size, size_t window_size)
+    : m_fd(fd)
+    , m_path(move(path))
+    , m_size(size)
+    , m_window_size(window_size)
+{
+}
+
+MappedFileWindow::~MappedFileWindow()
+{
+    unmap_window();
+    close(m_fd);
+}
+
+void MappedFileWindow::unmap_window()
+{
+    if (!m_window_data)
+        return;
+
+    // NOTE: Unmapping alone would leave the pages cached for the file, so we explicitly give them up first.
+    //       Whether that works or not, the window is gone either way.
+    (void)Core::System::madvise(m_window_data, m_window_data_size, MADV_DONTNEED);
+    MUST(Core::System::munmap(m_window_data, m_window_data_size));
+    m_window_data = nullptr;
+    m_window_data_size = 0;
+}
+
+ErrorOr<ReadonlyBytes> MappedFileWindow::bytes_at(size_t offset)
+{
+    if (offset > m_size)
+        return Error::from_errno(EINVAL);
+    if (offset == m_size)
+        return ReadonlyBytes {};
+
+    if (!m_window_data || offset < m_window_offset || offset >= m_window_offset + m_window_data_size) {
+        unmap_window();
+
+        auto window_offset = offset - offset % m_window_size;
+        auto window_data_size = min(m_window_size, m_size - window_offset);
+        auto* data = TRY(Core::System::mmap(nullptr, window_data_size, PROT_READ, MAP_SHARED, m_fd, window_offset, 0, m_path));
+        m_window_data = static_cast<u8*>(data);
+        m_window_offset = window_offset;
+        m_window_data_size = window_data_size;
+
+        // Windows are mostly read from start to end, so let page faults read ahead as far as they can.
+        (void)Core::System::madvise(m_window_data, m_window_data_size, MADV_SEQUENTIAL);
+    }
+
+    return ReadonlyBytes { m_window_data + (offset - m_window_offset), m_window_data_size - (offset - m_window_offset) };
+}
+
 }
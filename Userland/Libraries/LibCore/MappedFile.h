@@ -9,8 +9,10 @@
 #include <AK/Error.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Result.h>
+#include <AK/String.h>
 
 namespace Core {
 
@@ -19,8 +21,15 @@ class MappedFile : public RefCounted<MappedFile> {
     AK_MAKE_NONMOVABLE(MappedFile);
 
 public:
-    static ErrorOr<NonnullRefPtr<MappedFile>> map(String const& path);
-    static ErrorOr<NonnullRefPtr<MappedFile>> map_from_fd_and_close(int fd, String const& path);
+    // Tells the kernel how the mapping is going to be read, which decides how far ahead page faults read from the file.
+    enum class AccessPattern {
+        Normal,
+        Sequential,
+        Random,
+    };
+
+    static ErrorOr<NonnullRefPtr<MappedFile>> map(String const& path, AccessPattern = AccessPattern::Normal);
+    static ErrorOr<NonnullRefPtr<MappedFile>> map_from_fd_and_close(int fd, String const& path, AccessPattern = AccessPattern::Normal);
     ~MappedFile();
 
     void* data() { return m_data; }
@@ -30,6 +39,14 @@ public:
 
     ReadonlyBytes bytes() const { return { m_data, m_size }; }
 
+    ErrorOr<void> set_access_pattern(AccessPattern);
+
+    // Reads the given part of the file in right away, so that accessing it later doesn't have to wait for the disk.
+    ErrorOr<void> will_need(size_t offset, size_t size);
+
+    // Lets the kernel drop the given part of the file from memory; it's read in again if it's accessed later.
+    ErrorOr<void> dont_need(size_t offset, size_t size);
+
 private:
     explicit MappedFile(void*, size_t);
 
@@ -37,4 +54,47 @@ private:
     size_t m_size { 0 };
 };
 
+// Maps a file one window at a time, for files that are too big to map all at once.
+// Mapping a window unmaps the previous one and lets the kernel drop its pages, so reading through a big file
+// only ever keeps about a window's worth of it in memory.
+//
+// Usage:
+//     auto file = TRY(Core::MappedFileWindow::open(path));
+//     for (size_t offset = 0; offset < file->size();) {
+//         auto bytes = TRY(file->bytes_at(offset));
+//         ...
+//         offset += bytes.size();
+//     }
+class MappedFileWindow {
+    AK_MAKE_NONCOPYABLE(MappedFileWindow);
+    AK_MAKE_NONMOVABLE(MappedFileWindow);
+
+public:
+    static constexpr size_t default_window_size = 16 * MiB;
+
+    static ErrorOr<NonnullOwnPtr<MappedFileWindow>> open(String const& path, size_t window_size = default_window_size);
+    static ErrorOr<NonnullOwnPtr<MappedFileWindow>> adopt_fd(int fd, String const& path, size_t window_size = default_window_size);
+    ~MappedFileWindow();
+
+    size_t size() const { return m_size; }
+
+    // Returns the contents of the file from the given offset up to the end of the window it's in, mapping that window if needed.
+    // The returned bytes stay valid until a different window is mapped.
+    ErrorOr<ReadonlyBytes> bytes_at(size_t offset);
+
+private:
+    MappedFileWindow(int fd, String path, size_t size, size_t window_size);
+
+    void unmap_window();
+
+    int m_fd { -1 };
+    String m_path;
+    size_t m_size { 0 };
+    size_t m_window_size { 0 };
+
+    u8* m_window_data { nullptr };
+    size_t m_window_offset { 0 };
+    size_t m_window_data_size { 0 };
+};
+
 }
@@ -33,6 +33,13 @@ void Notifier::set_enabled(bool enabled)
         Core::EventLoop::unregister_notifier({}, *this);
 }
 
+void Notifier::set_event_mask(unsigned event_mask)
+{
+    m_event_mask = event_mask;
+    if (m_fd >= 0)
+        Core::EventLoop::notifier_event_mask_did_change({}, *this);
+}
+
 void Notifier::close()
 {
     if (m_fd < 0)
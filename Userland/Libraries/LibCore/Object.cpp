@@ -11,6 +11,7 @@
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
+#include <LibThreading/Mutex.h>
 #include <stdio.h>
 
 namespace Core {
@@ -21,10 +22,20 @@ IntrusiveList<&Object::m_all_objects_list_node>& Object::all_objects()
     return objects;
 }
 
+// Objects may be created and destroyed on any thread that runs an event loop, so the list of all objects needs a lock.
+static Threading::Mutex& all_objects_lock()
+{
+    static Threading::Mutex lock;
+    return lock;
+}
+
 Object::Object(Object* parent)
     : m_parent(parent)
 {
-    all_objects().append(*this);
+    {
+        Threading::MutexLocker locker(all_objects_lock());
+        all_objects().append(*this);
+    }
     if (m_parent)
         m_parent->add_child(*this);
 
@@ -50,7 +61,10 @@ Object::~Object()
     for (auto& child : children)
         child.m_parent = nullptr;
 
-    all_objects().remove(*this);
+    {
+        Threading::MutexLocker locker(all_objects_lock());
+        all_objects().remove(*this);
+    }
     stop_timer();
     if (m_parent)
         m_parent->remove_child(*this);
@@ -134,14 +148,14 @@ void Object::custom_event(CustomEvent&)
 {
 }
 
-void Object::start_timer(int ms, TimerShouldFireWhenNotVisible fire_when_not_visible)
+void Object::start_timer(int ms, TimerShouldFireWhenNotVisible fire_when_not_visible, int slack_ms)
 {
     if (m_timer_id) {
         dbgln("{} {:p} already has a timer!", class_name(), this);
         VERIFY_NOT_REACHED();
     }
 
-    m_timer_id = Core::EventLoop::register_timer(*this, ms, true, fire_when_not_visible);
+    m_timer_id = Core::EventLoop::register_timer(*this, ms, true, fire_when_not_visible, slack_ms);
 }
 
 void Object::stop_timer()
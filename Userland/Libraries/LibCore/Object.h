@@ -126,7 +126,8 @@ public:
     Object* parent() { return m_parent; }
     const Object* parent() const { return m_parent; }
 
-    void start_timer(int ms, TimerShouldFireWhenNotVisible = TimerShouldFireWhenNotVisible::No);
+    // A non-zero slack lets the timer fire up to that much later, so that it can share a wakeup with other timers.
+    void start_timer(int ms, TimerShouldFireWhenNotVisible = TimerShouldFireWhenNotVisible::No, int slack_ms = 0);
     void stop_timer();
     bool has_timer() const { return m_timer_id; }
 
@@ -5,12 +5,11 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
+#include <string.h>
 
 namespace Core {
 
@@ -20,85 +19,129 @@ Optional<AllProcessesStatistics> ProcessStatisticsReader::get_all(RefPtr<Core::F
 {
     if (proc_all_file) {
         if (!proc_all_file->seek(0, Core::SeekMode::SetPosition)) {
-            warnln("ProcessStatisticsReader: Failed to refresh /proc/all: {}", proc_all_file->error_string());
+            warnln("ProcessStatisticsReader: Failed to refresh /proc/all_binary: {}", proc_all_file->error_string());
             return {};
         }
     } else {
-        proc_all_file = Core::File::construct("/proc/all");
+        proc_all_file = Core::File::construct("/proc/all_binary");
         if (!proc_all_file->open(Core::OpenMode::ReadOnly)) {
-            warnln("ProcessStatisticsReader: Failed to open /proc/all: {}", proc_all_file->error_string());
+            warnln("ProcessStatisticsReader: Failed to open /proc/all_binary: {}", proc_all_file->error_string());
             return {};
         }
     }
 
-    AllProcessesStatistics all_processes_statistics;
-
     auto file_contents = proc_all_file->read_all();
-    auto json = JsonValue::from_string(file_contents);
-    if (json.is_error())
+    ReadonlyBytes data = file_contents.bytes();
+
+    ProcessStatisticsHeader header;
+    if (data.size() < sizeof(header))
         return {};
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.version != PROCESS_STATISTICS_VERSION) {
+        warnln("ProcessStatisticsReader: Unsupported /proc/all_binary version {}", header.version);
+        return {};
+    }
+    data = data.slice(sizeof(header));
+
+    AllProcessesStatistics all_processes_statistics;
+    all_processes_statistics.total_time_scheduled = header.total_time;
+    all_processes_statistics.total_time_scheduled_kernel = header.total_time_kernel;
+
+    // Takes the next string of the given length off the end of a record.
+    auto take_string = [](ReadonlyBytes& strings, size_t length) -> Optional<String> {
+        if (strings.size() < length)
+            return {};
+        auto string = String { StringView { strings.data(), length } };
+        strings = strings.slice(length);
+        return string;
+    };
+
+    while (!data.is_empty()) {
+        ProcessStatisticsRecordHeader record_header;
+        if (data.size() < sizeof(record_header))
+            return {};
+        memcpy(&record_header, data.data(), sizeof(record_header));
+        if (record_header.size < sizeof(record_header) || record_header.size > data.size())
+            return {};
+        auto record_data = data.slice(0, record_header.size);
+        data = data.slice(record_header.size);
+
+        if (record_header.type == ProcessStatisticsRecordType::Process) {
+            ProcessStatisticsProcessRecord record;
+            if (record_data.size() < sizeof(record))
+                return {};
+            memcpy(&record, record_data.data(), sizeof(record));
+            auto strings = record_data.slice(sizeof(record));
+
+            Core::ProcessStatistics process;
+
+            // kernel data first
+            process.pid = record.pid;
+            process.pgid = record.pgid;
+            process.pgp = record.pgp;
+            process.sid = record.sid;
+            process.uid = record.uid;
+            process.gid = record.gid;
+            process.ppid = record.ppid;
+            process.nfds = record.nfds;
+            process.kernel = record.kernel;
+            auto name = take_string(strings, record.name_length);
+            auto executable = take_string(strings, record.executable_length);
+            auto tty = take_string(strings, record.tty_length);
+            auto pledge = take_string(strings, record.pledge_length);
+            auto veil = take_string(strings, record.veil_length);
+            if (!name.has_value() || !executable.has_value() || !tty.has_value() || !pledge.has_value() || !veil.has_value())
+                return {};
+            process.name = name.release_value();
+            process.executable = executable.release_value();
+            process.tty = tty.release_value();
+            process.pledge = pledge.release_value();
+            process.veil = veil.release_value();
+            process.amount_virtual = record.amount_virtual;
+            process.amount_resident = record.amount_resident;
+            process.amount_shared = record.amount_shared;
+            process.amount_dirty_private = record.amount_dirty_private;
+            process.amount_clean_inode = record.amount_clean_inode;
+            process.amount_purgeable_volatile = record.amount_purgeable_volatile;
+            process.amount_purgeable_nonvolatile = record.amount_purgeable_nonvolatile;
+
+            // and synthetic data last
+            process.username = username_from_uid(process.uid);
+            all_processes_statistics.processes.append(move(process));
+        } else if (record_header.type == ProcessStatisticsRecordType::Thread) {
+            ProcessStatisticsThreadRecord record;
+            if (record_data.size() < sizeof(record) || all_processes_statistics.processes.is_empty())
+                return {};
+            memcpy(&record, record_data.data(), sizeof(record));
+            auto strings = record_data.slice(sizeof(record));
 
-    auto& json_obj = json.value().as_object();
-    json_obj.get("processes").as_array().for_each([&](auto& value) {
-        const JsonObject& process_object = value.as_object();
-        Core::ProcessStatistics process;
-
-        // kernel data first
-        process.pid = process_object.get("pid").to_u32();
-        process.pgid = process_object.get("pgid").to_u32();
-        process.pgp = process_object.get("pgp").to_u32();
-        process.sid = process_object.get("sid").to_u32();
-        process.uid = process_object.get("uid").to_u32();
-        process.gid = process_object.get("gid").to_u32();
-        process.ppid = process_object.get("ppid").to_u32();
-        process.nfds = process_object.get("nfds").to_u32();
-        process.kernel = process_object.get("kernel").to_bool();
-        process.name = process_object.get("name").to_string();
-        process.executable = process_object.get("executable").to_string();
-        process.tty = process_object.get("tty").to_string();
-        process.pledge = process_object.get("pledge").to_string();
-        process.veil = process_object.get("veil").to_string();
-        process.amount_virtual = process_object.get("amount_virtual").to_u32();
-        process.amount_resident = process_object.get("amount_resident").to_u32();
-        process.amount_shared = process_object.get("amount_shared").to_u32();
-        process.amount_dirty_private = process_object.get("amount_dirty_private").to_u32();
-        process.amount_clean_inode = process_object.get("amount_clean_inode").to_u32();
-        process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile").to_u32();
-        process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile").to_u32();
-
-        auto& thread_array = process_object.get_ptr("threads")->as_array();
-        process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
             Core::ThreadStatistics thread;
-            thread.tid = thread_object.get("tid").to_u32();
-            thread.times_scheduled = thread_object.get("times_scheduled").to_u32();
-            thread.name = thread_object.get("name").to_string();
-            thread.state = thread_object.get("state").to_string();
-            thread.time_user = thread_object.get("time_user").to_u64();
-            thread.time_kernel = thread_object.get("time_kernel").to_u64();
-            thread.cpu = thread_object.get("cpu").to_u32();
-            thread.priority = thread_object.get("priority").to_u32();
-            thread.syscall_count = thread_object.get("syscall_count").to_u32();
-            thread.inode_faults = thread_object.get("inode_faults").to_u32();
-            thread.zero_faults = thread_object.get("zero_faults").to_u32();
-            thread.cow_faults = thread_object.get("cow_faults").to_u32();
-            thread.unix_socket_read_bytes = thread_object.get("unix_socket_read_bytes").to_u32();
-            thread.unix_socket_write_bytes = thread_object.get("unix_socket_write_bytes").to_u32();
-            thread.ipv4_socket_read_bytes = thread_object.get("ipv4_socket_read_bytes").to_u32();
-            thread.ipv4_socket_write_bytes = thread_object.get("ipv4_socket_write_bytes").to_u32();
-            thread.file_read_bytes = thread_object.get("file_read_bytes").to_u32();
-            thread.file_write_bytes = thread_object.get("file_write_bytes").to_u32();
-            process.threads.append(move(thread));
-        });
-
-        // and synthetic data last
-        process.username = username_from_uid(process.uid);
-        all_processes_statistics.processes.append(move(process));
-    });
-
-    all_processes_statistics.total_time_scheduled = json_obj.get("total_time").to_u64();
-    all_processes_statistics.total_time_scheduled_kernel = json_obj.get("total_time_kernel").to_u64();
+            thread.tid = record.tid;
+            thread.times_scheduled = record.times_scheduled;
+            auto name = take_string(strings, record.name_length);
+            auto state = take_string(strings, record.state_length);
+            if (!name.has_value() || !state.has_value())
+                return {};
+            thread.name = name.release_value();
+            thread.state = state.release_value();
+            thread.time_user = record.time_user;
+            thread.time_kernel = record.time_kernel;
+            thread.cpu = record.cpu;
+            thread.priority = record.priority;
+            thread.syscall_count = record.syscall_count;
+            thread.inode_faults = record.inode_faults;
+            thread.zero_faults = record.zero_faults;
+            thread.cow_faults = record.cow_faults;
+            thread.unix_socket_read_bytes = record.unix_socket_read_bytes;
+            thread.unix_socket_write_bytes = record.unix_socket_write_bytes;
+            thread.ipv4_socket_read_bytes = record.ipv4_socket_read_bytes;
+            thread.ipv4_socket_write_bytes = record.ipv4_socket_write_bytes;
+            thread.file_read_bytes = record.file_read_bytes;
+            thread.file_write_bytes = record.file_write_bytes;
+            all_processes_statistics.processes.last().threads.append(move(thread));
+        }
+    }
+
     return all_processes_statistics;
 }
 
@@ -13,6 +13,7 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #ifdef __serenity__
 #    include <serenity.h>
@@ -68,6 +69,74 @@ bool Stream::write_or_error(ReadonlyBytes buffer)
     return true;
 }
 
+ErrorOr<size_t> Stream::write_vectored(Span<ReadonlyBytes const> buffers)
+{
+    for (auto& buffer : buffers) {
+        if (!buffer.is_empty())
+            return write(buffer);
+    }
+    return 0;
+}
+
+ErrorOr<void> Stream::write_entire_buffer(ReadonlyBytes buffer)
+{
+    return write_entire_buffers(Array { buffer });
+}
+
+ErrorOr<void> Stream::write_entire_buffers(Span<ReadonlyBytes const> buffers)
+{
+    // NOTE: Only the list of buffers is copied here, so that short writes can
+    //       be handled by trimming it from the front.
+    Vector<ReadonlyBytes, 8> remaining;
+    TRY(remaining.try_ensure_capacity(buffers.size()));
+    for (auto& buffer : buffers) {
+        if (!buffer.is_empty())
+            remaining.unchecked_append(buffer);
+    }
+
+    size_t first_remaining = 0;
+    while (first_remaining < remaining.size()) {
+        auto result = write_vectored(remaining.span().slice(first_remaining));
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            return result.release_error();
+        }
+
+        auto nwritten = result.value();
+        if (nwritten == 0)
+            return Error::from_errno(EIO);
+
+        while (nwritten > 0) {
+            auto& buffer = remaining[first_remaining];
+            if (nwritten < buffer.size()) {
+                buffer = buffer.slice(nwritten);
+                break;
+            }
+            nwritten -= buffer.size();
+            ++first_remaining;
+        }
+    }
+
+    return {};
+}
+
+static constexpr size_t max_iovec_count = 64;
+
+// Fills in up to max_iovec_count iovecs for the given buffers, skipping empty ones.
+static size_t fill_iovecs(Array<iovec, max_iovec_count>& iovecs, Span<ReadonlyBytes const> buffers)
+{
+    size_t count = 0;
+    for (auto& buffer : buffers) {
+        if (buffer.is_empty())
+            continue;
+        if (count == max_iovec_count)
+            break;
+        iovecs[count++] = { const_cast<u8*>(buffer.data()), buffer.size() };
+    }
+    return count;
+}
+
 ErrorOr<off_t> SeekableStream::tell() const
 {
     // Seek with 0 and SEEK_CUR does not modify anything despite the const_cast,
@@ -175,6 +244,20 @@ ErrorOr<size_t> File::write(ReadonlyBytes buffer)
     return TRY(System::write(m_fd, buffer));
 }
 
+ErrorOr<size_t> File::write_vectored(Span<ReadonlyBytes const> buffers)
+{
+    if (!has_flag(m_mode, OpenMode::Write)) {
+        // NOTE: Same deal as Read.
+        return Error::from_errno(EBADF);
+    }
+
+    Array<iovec, max_iovec_count> iovecs;
+    auto iovec_count = fill_iovecs(iovecs, buffers);
+    if (iovec_count == 0)
+        return 0;
+    return TRY(System::writev(m_fd, iovecs.data(), iovec_count));
+}
+
 bool File::is_eof() const { return m_last_read_was_eof; }
 bool File::is_open() const { return m_fd >= 0; }
 
@@ -344,6 +427,20 @@ ErrorOr<size_t> PosixSocketHelper::write(ReadonlyBytes buffer)
     return TRY(System::send(m_fd, buffer.data(), buffer.size(), 0));
 }
 
+ErrorOr<size_t> PosixSocketHelper::write_vectored(Span<ReadonlyBytes const> buffers)
+{
+    if (!is_open()) {
+        return Error::from_errno(ENOTCONN);
+    }
+
+    Array<iovec, max_iovec_count> iovecs;
+    auto iovec_count = fill_iovecs(iovecs, buffers);
+    if (iovec_count == 0)
+        return 0;
+    // NOTE: write() uses send() without any flags, so writev() is equivalent to sending the buffers one after another.
+    return TRY(System::writev(m_fd, iovecs.data(), iovec_count));
+}
+
 void PosixSocketHelper::close()
 {
     if (!is_open()) {
@@ -441,6 +538,21 @@ ErrorOr<NonnullOwnPtr<TCPSocket>> TCPSocket::adopt_fd(int fd)
     return socket;
 }
 
+ErrorOr<size_t> TCPSocket::send_file(int fd, off_t& offset, size_t count)
+{
+    if (!is_open())
+        return Error::from_errno(ENOTCONN);
+
+#if defined(__serenity__) || defined(__linux__)
+    return TRY(System::sendfile(m_helper.fd(), fd, &offset, count));
+#else
+    (void)fd;
+    (void)offset;
+    (void)count;
+    return Error::from_string_literal("Sending files directly is not supported on this platform");
+#endif
+}
+
 ErrorOr<size_t> PosixSocketHelper::pending_bytes() const
 {
     if (!is_open()) {
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IPv4Address.h>
@@ -17,6 +18,7 @@
 #include <AK/String.h>
 #include <AK/Time.h>
 #include <AK/Variant.h>
+#include <AK/Vector.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/SocketAddress.h>
 #include <errno.h>
@@ -47,6 +49,20 @@ public:
     /// contents are written or an error occurs. Returns whether the entire
     /// contents were written without an error.
     virtual bool write_or_error(ReadonlyBytes);
+    /// Writes the contents of several buffers, in order, as if they were one
+    /// contiguous buffer. Like write, this can write less than the full
+    /// contents; returns either the amount of bytes written, or an errno in
+    /// the case of failure. Streams backed by a file descriptor do this with a
+    /// single writev() call; the default implementation writes the first
+    /// non-empty buffer.
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const>);
+    /// Writes the entire contents of the buffer, retrying short writes and
+    /// interruptions, and returns the first error that occurs otherwise.
+    ErrorOr<void> write_entire_buffer(ReadonlyBytes);
+    /// Same as write_entire_buffer, but for several buffers at once. The
+    /// buffers are handed to write_vectored as they are, without being copied
+    /// into a single buffer first.
+    ErrorOr<void> write_entire_buffers(Span<ReadonlyBytes const>);
 
     /// Returns whether the stream has reached the end of file. For sockets,
     /// this most likely means that the protocol has disconnected (in the case
@@ -197,12 +213,15 @@ public:
     virtual ErrorOr<size_t> read(Bytes) override;
     virtual bool is_writable() const override;
     virtual ErrorOr<size_t> write(ReadonlyBytes) override;
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const>) override;
     virtual bool is_eof() const override;
     virtual bool is_open() const override;
     virtual void close() override;
     virtual ErrorOr<off_t> seek(i64 offset, SeekMode) override;
     virtual ErrorOr<void> truncate(off_t length) override;
 
+    int fd() const { return m_fd; }
+
     virtual ~File() override { close(); }
 
 private:
@@ -243,6 +262,7 @@ public:
 
     ErrorOr<size_t> read(Bytes, int flags = 0);
     ErrorOr<size_t> write(ReadonlyBytes);
+    ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const>);
 
     bool is_eof() const { return !is_open() || m_last_read_was_eof; }
     bool is_open() const { return m_fd != -1; }
@@ -292,6 +312,7 @@ public:
     virtual bool is_writable() const override { return is_open(); }
     virtual ErrorOr<size_t> read(Bytes buffer) override { return m_helper.read(buffer); }
     virtual ErrorOr<size_t> write(ReadonlyBytes buffer) override { return m_helper.write(buffer); }
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const> buffers) override { return m_helper.write_vectored(buffers); }
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.is_open(); };
     virtual void close() override { m_helper.close(); };
@@ -305,6 +326,11 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    /// Sends up to `count` bytes of the file referred to by `fd`, starting at
+    /// `offset`, without copying them through userspace. `offset` is advanced
+    /// by the number of bytes sent, and 0 is returned at the end of the file.
+    ErrorOr<size_t> send_file(int fd, off_t& offset, size_t count);
+
     virtual ~TCPSocket() override { close(); }
 
 private:
@@ -367,6 +393,7 @@ public:
     virtual bool is_readable() const override { return is_open(); }
     virtual bool is_writable() const override { return is_open(); }
     virtual ErrorOr<size_t> write(ReadonlyBytes buffer) override { return m_helper.write(buffer); }
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const> buffers) override { return m_helper.write_vectored(buffers); }
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.is_open(); }
     virtual void close() override { m_helper.close(); }
@@ -426,6 +453,7 @@ public:
     virtual bool is_writable() const override { return is_open(); }
     virtual ErrorOr<size_t> read(Bytes buffer) override { return m_helper.read(buffer); }
     virtual ErrorOr<size_t> write(ReadonlyBytes buffer) override { return m_helper.write(buffer); }
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const> buffers) override { return m_helper.write_vectored(buffers); }
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.is_open(); }
     virtual void close() override { m_helper.close(); }
@@ -753,6 +781,7 @@ public:
     virtual ErrorOr<size_t> read(Bytes buffer) override { return m_helper.read(move(buffer)); }
     virtual bool is_writable() const override { return m_helper.stream().is_writable(); }
     virtual ErrorOr<size_t> write(ReadonlyBytes buffer) override { return m_helper.stream().write(buffer); }
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const> buffers) override { return m_helper.stream().write_vectored(buffers); }
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.stream().is_open(); }
     virtual void close() override { m_helper.stream().close(); }
@@ -824,6 +853,7 @@ public:
     virtual ErrorOr<size_t> read(Bytes buffer) override { return m_helper.read(move(buffer)); }
     virtual bool is_writable() const override { return m_helper.stream().is_writable(); }
     virtual ErrorOr<size_t> write(ReadonlyBytes buffer) override { return m_helper.stream().write(buffer); }
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const> buffers) override { return m_helper.stream().write_vectored(buffers); }
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.stream().is_open(); }
     virtual void close() override { m_helper.stream().close(); }
@@ -844,6 +874,9 @@ public:
 
     virtual size_t buffer_size() const override { return m_helper.buffer_size(); }
 
+    // NOTE: Writes aren't buffered, so this can go straight to the underlying socket.
+    ErrorOr<size_t> send_file(int fd, off_t& offset, size_t count) { return m_helper.stream().send_file(fd, offset, count); }
+
     virtual ~BufferedSocket() override = default;
 
 private:
@@ -869,6 +902,160 @@ using BufferedTCPSocket = BufferedSocket<TCPSocket>;
 using BufferedUDPSocket = BufferedSocket<UDPSocket>;
 using BufferedLocalSocket = BufferedSocket<LocalSocket>;
 
+/// Collects small writes in a buffer and hands them to the underlying stream
+/// in large chunks. When a write doesn't fit into the buffer, the buffered
+/// data and the new data are written together with a single write_vectored
+/// call, so large writes are never copied. Reads go straight to the
+/// underlying stream, after flushing whatever has been written so far.
+///
+/// Buffered data is written out by flush() and when the stream is closed or
+/// destroyed; errors can only be reported by flush().
+template<StreamLike T>
+class BufferedWriter final : public Stream {
+    AK_MAKE_NONCOPYABLE(BufferedWriter);
+    AK_MAKE_NONMOVABLE(BufferedWriter);
+
+public:
+    static ErrorOr<NonnullOwnPtr<BufferedWriter<T>>> create(NonnullOwnPtr<T> stream, size_t buffer_size = 16384)
+    {
+        if (!buffer_size)
+            return Error::from_errno(EINVAL);
+        if (!stream->is_open())
+            return Error::from_errno(ENOTCONN);
+
+        auto buffer = TRY(ByteBuffer::create_uninitialized(buffer_size));
+
+        return adopt_nonnull_own_or_enomem(new (nothrow) BufferedWriter<T>(move(stream), move(buffer)));
+    }
+
+    T& stream() { return *m_stream; }
+    T const& stream() const { return *m_stream; }
+
+    virtual bool is_readable() const override { return m_stream->is_readable(); }
+    virtual ErrorOr<size_t> read(Bytes buffer) override
+    {
+        TRY(flush());
+        return m_stream->read(buffer);
+    }
+    virtual bool is_writable() const override { return m_stream->is_writable(); }
+    virtual ErrorOr<size_t> write(ReadonlyBytes buffer) override { return write_vectored(Array { buffer }); }
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const> buffers) override
+    {
+        if (!m_stream->is_open())
+            return Error::from_errno(ENOTCONN);
+
+        size_t total_size = 0;
+        for (auto& buffer : buffers)
+            total_size += buffer.size();
+
+        size_t nwritten = 0;
+        while (true) {
+            if (m_buffered_size + total_size - nwritten <= m_buffer.size()) {
+                append_to_buffer(buffers, nwritten);
+                return total_size;
+            }
+
+            // We've made room in the buffer, but the rest still doesn't fit. Let the caller retry with what's left.
+            if (nwritten > 0 && m_buffered_size == 0)
+                return nwritten;
+
+            Vector<ReadonlyBytes, 8> chunks;
+            TRY(chunks.try_ensure_capacity(buffers.size() + 1));
+            chunks.unchecked_append(m_buffer.span().trim(m_buffered_size));
+            skip_written_bytes(buffers, nwritten, [&](ReadonlyBytes chunk) { chunks.unchecked_append(chunk); });
+
+            auto result = m_stream->write_vectored(chunks);
+            if (result.is_error()) {
+                if (result.error().is_errno() && result.error().code() == EINTR)
+                    continue;
+                if (nwritten > 0)
+                    return nwritten;
+                return result.release_error();
+            }
+            if (result.value() == 0)
+                return Error::from_errno(EIO);
+
+            auto nwritten_from_buffer = min(result.value(), m_buffered_size);
+            drop_from_buffer(nwritten_from_buffer);
+            nwritten += result.value() - nwritten_from_buffer;
+        }
+    }
+    virtual bool is_eof() const override { return m_stream->is_eof(); }
+    virtual bool is_open() const override { return m_stream->is_open(); }
+    virtual void close() override
+    {
+        if (auto result = flush(); result.is_error())
+            dbgln("Core::Stream::BufferedWriter::close: Couldn't write out buffered data: {}", result.error());
+        m_stream->close();
+    }
+
+    // Writes out everything that has been buffered so far.
+    ErrorOr<void> flush()
+    {
+        while (m_buffered_size > 0) {
+            auto result = m_stream->write(m_buffer.span().trim(m_buffered_size));
+            if (result.is_error()) {
+                if (result.error().is_errno() && result.error().code() == EINTR)
+                    continue;
+                return result.release_error();
+            }
+            if (result.value() == 0)
+                return Error::from_errno(EIO);
+            drop_from_buffer(result.value());
+        }
+        return {};
+    }
+
+    size_t buffer_size() const { return m_buffer.size(); }
+    size_t buffered_data_size() const { return m_buffered_size; }
+
+    virtual ~BufferedWriter() override
+    {
+        if (m_stream->is_open())
+            close();
+    }
+
+private:
+    BufferedWriter(NonnullOwnPtr<T> stream, ByteBuffer buffer)
+        : m_stream(move(stream))
+        , m_buffer(move(buffer))
+    {
+    }
+
+    // Calls callback with every non-empty part of buffers that comes after the first `skip` bytes.
+    template<typename Callback>
+    static void skip_written_bytes(Span<ReadonlyBytes const> buffers, size_t skip, Callback callback)
+    {
+        for (auto& buffer : buffers) {
+            if (skip >= buffer.size()) {
+                skip -= buffer.size();
+                continue;
+            }
+            callback(buffer.slice(skip));
+            skip = 0;
+        }
+    }
+
+    void append_to_buffer(Span<ReadonlyBytes const> buffers, size_t skip)
+    {
+        skip_written_bytes(buffers, skip, [&](ReadonlyBytes chunk) {
+            chunk.copy_to(m_buffer.span().slice(m_buffered_size));
+            m_buffered_size += chunk.size();
+        });
+    }
+
+    void drop_from_buffer(size_t count)
+    {
+        // FIXME: Like BufferedHelper, this would benefit from a circular buffer.
+        m_buffer.span().slice(count, m_buffered_size - count).copy_to(m_buffer.span());
+        m_buffered_size -= count;
+    }
+
+    NonnullOwnPtr<T> m_stream;
+    ByteBuffer m_buffer;
+    size_t m_buffered_size { 0 };
+};
+
 /// A BasicReusableSocket allows one to use one of the base Core::Stream classes
 /// as a ReusableSocket. It does not preserve any connection state or options,
 /// and instead just recreates the stream when reconnecting.
@@ -912,6 +1099,7 @@ public:
     virtual ErrorOr<size_t> read(Bytes buffer) override { return m_socket.read(move(buffer)); }
     virtual bool is_writable() const override { return m_socket.is_writable(); }
     virtual ErrorOr<size_t> write(ReadonlyBytes buffer) override { return m_socket.write(buffer); }
+    virtual ErrorOr<size_t> write_vectored(Span<ReadonlyBytes const> buffers) override { return m_socket.write_vectored(buffers); }
     virtual bool is_eof() const override { return m_socket.is_eof(); }
     virtual bool is_open() const override { return m_socket.is_open(); }
     virtual void close() override { m_socket.close(); }
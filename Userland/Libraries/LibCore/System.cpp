@@ -26,6 +26,10 @@
 #    include <serenity.h>
 #endif
 
+#if defined(__serenity__) || defined(__linux__)
+#    include <sys/sendfile.h>
+#endif
+
 #if defined(__linux__) && !defined(MFD_CLOEXEC)
 #    include <linux/memfd.h>
 #    include <sys/syscall.h>
@@ -178,6 +182,14 @@ ErrorOr<void> profiling_free_buffer(pid_t pid)
     int rc = ::profiling_free_buffer(pid);
     HANDLE_SYSCALL_RETURN_VALUE("profiling_free_buffer", rc, {});
 }
+
+ErrorOr<size_t> io_submit(Span<struct io_request> requests)
+{
+    int rc = ::io_submit(requests.data(), requests.size());
+    if (rc < 0)
+        return Error::from_syscall("io_submit"sv, -errno);
+    return static_cast<size_t>(rc);
+}
 #endif
 
 #ifndef AK_OS_BSD_GENERIC
@@ -279,6 +291,13 @@ ErrorOr<void> munmap(void* address, size_t size)
     return {};
 }
 
+ErrorOr<void> madvise(void* address, size_t size, int advice)
+{
+    if (::madvise(address, size, advice) < 0)
+        return Error::from_syscall("madvise"sv, -errno);
+    return {};
+}
+
 ErrorOr<int> anon_create([[maybe_unused]] size_t size, [[maybe_unused]] int options)
 {
     int fd = -1;
@@ -416,6 +435,24 @@ ErrorOr<ssize_t> write(int fd, ReadonlyBytes buffer)
     return rc;
 }
 
+#if defined(__serenity__) || defined(__linux__)
+ErrorOr<ssize_t> copy_file_range(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t count)
+{
+    auto copied = ::copy_file_range(in_fd, in_offset, out_fd, out_offset, count, 0);
+    if (copied < 0)
+        return Error::from_syscall("copy_file_range"sv, -errno);
+    return copied;
+}
+#endif
+
+ErrorOr<ssize_t> writev(int fd, struct iovec const* iov, int iov_count)
+{
+    ssize_t rc = ::writev(fd, iov, iov_count);
+    if (rc < 0)
+        return Error::from_syscall("writev"sv, -errno);
+    return rc;
+}
+
 ErrorOr<void> kill(pid_t pid, int signal)
 {
     if (::kill(pid, signal) < 0)
@@ -954,6 +991,16 @@ ErrorOr<ssize_t> sendmsg(int sockfd, const struct msghdr* message, int flags)
     return sent;
 }
 
+#if defined(__serenity__) || defined(__linux__)
+ErrorOr<ssize_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    auto sent = ::sendfile(out_fd, in_fd, offset, count);
+    if (sent < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return sent;
+}
+#endif
+
 ErrorOr<ssize_t> sendto(int sockfd, void const* source, size_t source_length, int flags, struct sockaddr const* destination, socklen_t destination_length)
 {
     auto sent = ::sendto(sockfd, source, source_length, flags, destination, destination_length);
@@ -19,6 +19,7 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <sys/utsname.h>
 #include <sys/wait.h>
 #include <termios.h>
@@ -46,6 +47,7 @@ ErrorOr<void> disown(pid_t pid);
 ErrorOr<void> profiling_enable(pid_t, u64 event_mask);
 ErrorOr<void> profiling_disable(pid_t);
 ErrorOr<void> profiling_free_buffer(pid_t);
+ErrorOr<size_t> io_submit(Span<struct io_request>);
 #endif
 
 #ifndef AK_OS_BSD_GENERIC
@@ -67,6 +69,7 @@ ErrorOr<struct stat> fstat(int fd);
 ErrorOr<int> fcntl(int fd, int command, ...);
 ErrorOr<void*> mmap(void* address, size_t, int protection, int flags, int fd, off_t, size_t alignment = 0, StringView name = {});
 ErrorOr<void> munmap(void* address, size_t);
+ErrorOr<void> madvise(void* address, size_t, int advice);
 ErrorOr<int> anon_create(size_t size, int options);
 ErrorOr<int> open(StringView path, int options, ...);
 ErrorOr<void> close(int fd);
@@ -75,6 +78,10 @@ ErrorOr<struct stat> stat(StringView path);
 ErrorOr<struct stat> lstat(StringView path);
 ErrorOr<ssize_t> read(int fd, Bytes buffer);
 ErrorOr<ssize_t> write(int fd, ReadonlyBytes buffer);
+#if defined(__serenity__) || defined(__linux__)
+ErrorOr<ssize_t> copy_file_range(int in_fd, off_t* in_offset, int out_fd, off_t* out_offset, size_t count);
+#endif
+ErrorOr<ssize_t> writev(int fd, struct iovec const*, int iov_count);
 ErrorOr<void> kill(pid_t, int signal);
 ErrorOr<void> killpg(int pgrp, int signal);
 ErrorOr<int> dup(int source_fd);
@@ -133,6 +140,9 @@ ErrorOr<void> connect(int sockfd, struct sockaddr const*, socklen_t);
 ErrorOr<void> shutdown(int sockfd, int how);
 ErrorOr<ssize_t> send(int sockfd, void const*, size_t, int flags);
 ErrorOr<ssize_t> sendmsg(int sockfd, const struct msghdr*, int flags);
+#if defined(__serenity__) || defined(__linux__)
+ErrorOr<ssize_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+#endif
 ErrorOr<ssize_t> sendto(int sockfd, void const*, size_t, int flags, struct sockaddr const*, socklen_t);
 ErrorOr<ssize_t> recv(int sockfd, void*, size_t, int flags);
 ErrorOr<ssize_t> recvmsg(int sockfd, struct msghdr*, int flags);
@@ -69,6 +69,11 @@ ErrorOr<void> TCPServer::set_blocking(bool blocking)
 }
 
 ErrorOr<NonnullOwnPtr<Stream::TCPSocket>> TCPServer::accept()
+{
+    return Stream::TCPSocket::adopt_fd(TRY(accept_fd()));
+}
+
+ErrorOr<int> TCPServer::accept_fd()
 {
     VERIFY(m_listening);
     sockaddr_in in;
@@ -77,19 +82,23 @@ ErrorOr<NonnullOwnPtr<Stream::TCPSocket>> TCPServer::accept()
     int accepted_fd = TRY(Core::System::accept4(m_fd, (sockaddr*)&in, &in_size, SOCK_NONBLOCK | SOCK_CLOEXEC));
 #else
     int accepted_fd = TRY(Core::System::accept(m_fd, (sockaddr*)&in, &in_size));
-#endif
-
-    auto socket = TRY(Stream::TCPSocket::adopt_fd(accepted_fd));
 
-#ifdef AK_OS_MACOS
     // FIXME: Ideally, we should let the caller decide whether it wants the
     //        socket to be nonblocking or not, but there are currently places
     //        which depend on this.
-    TRY(socket->set_blocking(false));
-    TRY(socket->set_close_on_exec(true));
+    auto result = [&]() -> ErrorOr<void> {
+        int flags = TRY(Core::System::fcntl(accepted_fd, F_GETFL, 0));
+        TRY(Core::System::fcntl(accepted_fd, F_SETFL, flags | O_NONBLOCK));
+        TRY(Core::System::fcntl(accepted_fd, F_SETFD, FD_CLOEXEC));
+        return {};
+    }();
+    if (result.is_error()) {
+        (void)Core::System::close(accepted_fd);
+        return result.release_error();
+    }
 #endif
 
-    return socket;
+    return accepted_fd;
 }
 
 Optional<IPv4Address> TCPServer::local_address() const
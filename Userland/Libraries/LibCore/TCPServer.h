@@ -25,6 +25,9 @@ public:
     ErrorOr<void> set_blocking(bool blocking);
 
     ErrorOr<NonnullOwnPtr<Stream::TCPSocket>> accept();
+    // Accepts a connection without wrapping it in a socket, e.g. so that another thread's event loop can adopt it.
+    // The returned fd is non-blocking and close-on-exec.
+    ErrorOr<int> accept_fd();
 
     Optional<IPv4Address> local_address() const;
     Optional<u16> local_port() const;
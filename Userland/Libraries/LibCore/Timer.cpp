@@ -31,7 +31,7 @@ void Timer::start(int interval_ms)
     if (m_active)
         return;
     m_interval_ms = interval_ms;
-    start_timer(interval_ms);
+    start_timer(interval_ms, TimerShouldFireWhenNotVisible::No, m_slack_ms);
     m_active = true;
 }
 
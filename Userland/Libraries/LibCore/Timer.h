@@ -53,6 +53,11 @@ public:
     bool is_single_shot() const { return m_single_shot; }
     void set_single_shot(bool single_shot) { m_single_shot = single_shot; }
 
+    // How much later than its interval the timer may fire, so that the event loop can wake up for several timers at once.
+    // Takes effect the next time the timer is started.
+    int slack() const { return m_slack_ms; }
+    void set_slack(int slack_ms) { m_slack_ms = slack_ms; }
+
     Function<void()> on_timeout;
 
 private:
@@ -65,6 +70,7 @@ private:
     bool m_single_shot { false };
     bool m_interval_dirty { false };
     int m_interval_ms { 0 };
+    int m_slack_ms { 0 };
 };
 
 }
@@ -138,10 +138,23 @@ Optional<FlatPtr> Reader::peek_memory(FlatPtr address) const
     if (!region.has_value())
         return {};
 
-    FlatPtr offset_in_region = address - region->region_start;
-    auto* region_data = bit_cast<const u8*>(image().program_header(region->program_header_index).raw_data());
+    // The kernel leaves out pages that were never touched or only contain zeroes, so a region is stored as any number
+    // of segments (starting at program_header_index), and everything in between them reads as zeroes.
+    u8 bytes[sizeof(FlatPtr)] {};
+    for (unsigned i = region->program_header_index; i < m_coredump_image.program_header_count(); ++i) {
+        auto segment = m_coredump_image.program_header(i);
+        if (segment.type() != PT_LOAD || segment.vaddr().get() >= region->region_end)
+            break;
+        FlatPtr segment_start = segment.vaddr().get();
+        FlatPtr segment_end = segment_start + segment.size_in_image();
+        auto copy_start = max(address, segment_start);
+        auto copy_end = min(address + sizeof(FlatPtr), segment_end);
+        if (copy_start < copy_end)
+            memcpy(bytes + (copy_start - address), segment.raw_data() + (copy_start - segment_start), copy_end - copy_start);
+    }
+
     FlatPtr value { 0 };
-    ByteReader::load(region_data + offset_in_region, value);
+    ByteReader::load(bytes, value);
     return value;
 }
 
@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteReader.h>
+#include <AK/Endian.h>
+#include <AK/Memory.h>
+#include <LibCrypto/Authentication/Poly1305.h>
+
+namespace Crypto {
+namespace Authentication {
+
+static constexpr u32 limb_mask = 0x3ffffff;
+
+static u32 load_little_endian(u8 const* data)
+{
+    u32 value;
+    ByteReader::load(data, value);
+    return AK::convert_between_host_and_little_endian(value);
+}
+
+Poly1305::Poly1305(ReadonlyBytes key)
+{
+    VERIFY(key.size() == key_size);
+
+    // r is "clamped" (RFC 8439 section 2.5) while it's being split into limbs.
+    m_r[0] = load_little_endian(key.offset(0)) & 0x3ffffff;
+    m_r[1] = (load_little_endian(key.offset(3)) >> 2) & 0x3ffff03;
+    m_r[2] = (load_little_endian(key.offset(6)) >> 4) & 0x3ffc0ff;
+    m_r[3] = (load_little_endian(key.offset(9)) >> 6) & 0x3f03fff;
+    m_r[4] = (load_little_endian(key.offset(12)) >> 8) & 0x00fffff;
+    // Whatever ends up above 2^130 comes back in multiplied by 5, as 2^130 = 5 (mod 2^130 - 5).
+    for (size_t i = 0; i < 4; ++i)
+        m_s[i] = m_r[i + 1] * 5;
+    for (size_t i = 0; i < 4; ++i)
+        m_pad[i] = load_little_endian(key.offset(16 + i * 4));
+}
+
+Poly1305::~Poly1305()
+{
+    secure_zero(m_h, sizeof(m_h));
+    secure_zero(m_r, sizeof(m_r));
+    secure_zero(m_s, sizeof(m_s));
+    secure_zero(m_pad, sizeof(m_pad));
+    secure_zero(m_buffer, sizeof(m_buffer));
+}
+
+// h = (h + block) * r (mod 2^130 - 5), where `high_bit` is the bit above the 16 bytes of the block.
+void Poly1305::process_block(u8 const* block, u32 high_bit)
+{
+    auto [r0, r1, r2, r3, r4] = m_r;
+    auto [s1, s2, s3, s4] = m_s;
+
+    u32 h0 = m_h[0] + (load_little_endian(block + 0) & limb_mask);
+    u32 h1 = m_h[1] + ((load_little_endian(block + 3) >> 2) & limb_mask);
+    u32 h2 = m_h[2] + ((load_little_endian(block + 6) >> 4) & limb_mask);
+    u32 h3 = m_h[3] + ((load_little_endian(block + 9) >> 6) & limb_mask);
+    u32 h4 = m_h[4] + ((load_little_endian(block + 12) >> 8) | high_bit);
+
+    u64 d0 = (u64)h0 * r0 + (u64)h1 * s4 + (u64)h2 * s3 + (u64)h3 * s2 + (u64)h4 * s1;
+    u64 d1 = (u64)h0 * r1 + (u64)h1 * r0 + (u64)h2 * s4 + (u64)h3 * s3 + (u64)h4 * s2;
+    u64 d2 = (u64)h0 * r2 + (u64)h1 * r1 + (u64)h2 * r0 + (u64)h3 * s4 + (u64)h4 * s3;
+    u64 d3 = (u64)h0 * r3 + (u64)h1 * r2 + (u64)h2 * r1 + (u64)h3 * r0 + (u64)h4 * s4;
+    u64 d4 = (u64)h0 * r4 + (u64)h1 * r3 + (u64)h2 * r2 + (u64)h3 * r1 + (u64)h4 * r0;
+
+    // Carry, leaving h only partially reduced.
+    u32 carry = (u32)(d0 >> 26);
+    h0 = (u32)d0 & limb_mask;
+    d1 += carry;
+    carry = (u32)(d1 >> 26);
+    h1 = (u32)d1 & limb_mask;
+    d2 += carry;
+    carry = (u32)(d2 >> 26);
+    h2 = (u32)d2 & limb_mask;
+    d3 += carry;
+    carry = (u32)(d3 >> 26);
+    h3 = (u32)d3 & limb_mask;
+    d4 += carry;
+    carry = (u32)(d4 >> 26);
+    h4 = (u32)d4 & limb_mask;
+    h0 += carry * 5;
+    carry = h0 >> 26;
+    h0 &= limb_mask;
+    h1 += carry;
+
+    m_h[0] = h0;
+    m_h[1] = h1;
+    m_h[2] = h2;
+    m_h[3] = h3;
+    m_h[4] = h4;
+}
+
+void Poly1305::update(ReadonlyBytes data)
+{
+    if (m_buffer_length != 0) {
+        auto size = min(data.size(), sizeof(m_buffer) - m_buffer_length);
+        __builtin_memcpy(m_buffer + m_buffer_length, data.data(), size);
+        m_buffer_length += size;
+        data = data.slice(size);
+        if (m_buffer_length < sizeof(m_buffer))
+            return;
+        process_block(m_buffer, 1 << 24);
+        m_buffer_length = 0;
+    }
+
+    while (data.size() >= 16) {
+        process_block(data.data(), 1 << 24);
+        data = data.slice(16);
+    }
+
+    if (!data.is_empty()) {
+        __builtin_memcpy(m_buffer, data.data(), data.size());
+        m_buffer_length = data.size();
+    }
+}
+
+Poly1305::TagType Poly1305::digest()
+{
+    // A partial block gets its 1 bit right after its last byte, instead of above all 16 bytes.
+    if (m_buffer_length != 0) {
+        m_buffer[m_buffer_length] = 1;
+        __builtin_memset(m_buffer + m_buffer_length + 1, 0, sizeof(m_buffer) - m_buffer_length - 1);
+        process_block(m_buffer, 0);
+        m_buffer_length = 0;
+    }
+
+    auto [h0, h1, h2, h3, h4] = m_h;
+
+    // Carry all the way through.
+    u32 carry = h1 >> 26;
+    h1 &= limb_mask;
+    h2 += carry;
+    carry = h2 >> 26;
+    h2 &= limb_mask;
+    h3 += carry;
+    carry = h3 >> 26;
+    h3 &= limb_mask;
+    h4 += carry;
+    carry = h4 >> 26;
+    h4 &= limb_mask;
+    h0 += carry * 5;
+    carry = h0 >> 26;
+    h0 &= limb_mask;
+    h1 += carry;
+
+    // g = h - p = h + 5 - 2^130, which is the fully reduced value if it doesn't come out negative.
+    u32 g0 = h0 + 5;
+    carry = g0 >> 26;
+    g0 &= limb_mask;
+    u32 g1 = h1 + carry;
+    carry = g1 >> 26;
+    g1 &= limb_mask;
+    u32 g2 = h2 + carry;
+    carry = g2 >> 26;
+    g2 &= limb_mask;
+    u32 g3 = h3 + carry;
+    carry = g3 >> 26;
+    g3 &= limb_mask;
+    u32 g4 = h4 + carry - (1 << 26);
+
+    // Pick one without branching on the secret.
+    u32 use_g = (g4 >> 31) - 1;
+    u32 use_h = ~use_g;
+    h0 = (h0 & use_h) | (g0 & use_g);
+    h1 = (h1 & use_h) | (g1 & use_g);
+    h2 = (h2 & use_h) | (g2 & use_g);
+    h3 = (h3 & use_h) | (g3 & use_g);
+    h4 = (h4 & use_h) | (g4 & use_g);
+
+    // tag = (h + s) mod 2^128
+    u32 words[4] {
+        h0 | (h1 << 26),
+        (h1 >> 6) | (h2 << 20),
+        (h2 >> 12) | (h3 << 14),
+        (h3 >> 18) | (h4 << 8),
+    };
+    TagType tag;
+    u64 sum = 0;
+    for (size_t i = 0; i < 4; ++i) {
+        sum = (u64)words[i] + m_pad[i] + (sum >> 32);
+        auto word = AK::convert_between_host_and_little_endian((u32)sum);
+        __builtin_memcpy(tag.data() + i * 4, &word, sizeof(word));
+    }
+    return tag;
+}
+
+}
+}
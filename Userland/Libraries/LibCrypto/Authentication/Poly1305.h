@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Span.h>
+#include <AK/Types.h>
+
+namespace Crypto {
+namespace Authentication {
+
+// The Poly1305 one-time authenticator from RFC 8439 section 2.5. A key must never be used for more than one message.
+class Poly1305 {
+public:
+    static constexpr size_t key_size = 32;
+    static constexpr size_t tag_size = 16;
+    using TagType = Array<u8, tag_size>;
+
+    explicit Poly1305(ReadonlyBytes key);
+    ~Poly1305();
+
+    void update(ReadonlyBytes);
+    TagType digest();
+
+private:
+    void process_block(u8 const*, u32 high_bit);
+
+    // The accumulator and r in radix 2^26, so that their products fit into 64 bits.
+    u32 m_h[5] {};
+    u32 m_r[5];
+    u32 m_s[4];
+    // The second half of the key, which is added at the end.
+    u32 m_pad[4];
+
+    u8 m_buffer[16];
+    size_t m_buffer_length { 0 };
+};
+
+}
+}
@@ -6,42 +6,141 @@
  */
 
 #include "UnsignedBigIntegerAlgorithms.h"
+#include <AK/BuiltinWrappers.h>
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+using SignedDoubleWord = i64;
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N * M) where N and M are the number of words in the numerator and denominator
  * Division method:
- * We loop over the bits of the divisor, attempting to subtract divisor<<i from the dividend.
- * If the result is non-negative, it means that divisor*2^i "fits" in the dividend,
- * so we set the ith bit in the quotient and reduce divisor<<i from the dividend.
- * When we're done, what's left from the dividend is the remainder.
+ * Knuth's algorithm D (The Art of Computer Programming, volume 2, section 4.3.1), as laid out in "Hacker's Delight".
+ * Both numbers are shifted so that the top bit of the denominator is set, which makes it possible to guess each
+ * word of the quotient from the top two words of what's left of the numerator and the top word of the denominator,
+ * with the guess being at most two too large. Then the denominator times that word is subtracted from the numerator,
+ * and once all words of the quotient are known, what's left of the numerator (shifted back) is the remainder.
+ * temp_shift_result and temp_shift_plus hold the shifted denominator and numerator; the other temporaries aren't needed anymore.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::divide_without_allocation(
     UnsignedBigInteger const& numerator,
     UnsignedBigInteger const& denominator,
     UnsignedBigInteger& temp_shift_result,
     UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
-    UnsignedBigInteger& temp_minus,
+    UnsignedBigInteger&,
+    UnsignedBigInteger&,
     UnsignedBigInteger& quotient,
     UnsignedBigInteger& remainder)
 {
+    constexpr size_t bits_in_word = UnsignedBigInteger::BITS_IN_WORD;
+    auto numerator_length = numerator.trimmed_length();
+    auto denominator_length = denominator.trimmed_length();
+    VERIFY(denominator_length > 0);
+
+    if (numerator_length < denominator_length) {
+        remainder.set_to(numerator);
+        quotient.set_to_0();
+        return;
+    }
+
+    if (denominator_length == 1) {
+        DoubleWord divisor = denominator.m_words[0];
+        DoubleWord remainder_word = 0;
+        // The numerator may be the same object as either of the results, so it's read from before being written over.
+        remainder.set_to(numerator);
+        quotient.set_to_0();
+        quotient.m_words.resize_and_keep_capacity(numerator_length);
+        for (size_t i = numerator_length; i-- > 0;) {
+            DoubleWord dividend = (remainder_word << bits_in_word) | remainder.m_words[i];
+            quotient.m_words[i] = static_cast<Word>(dividend / divisor);
+            remainder_word = dividend % divisor;
+        }
+        quotient.clamp_to_trimmed_length();
+        remainder.set_to(static_cast<Word>(remainder_word));
+        return;
+    }
+
+    // Normalize, so that the top bit of the denominator is set.
+    size_t shift = count_leading_zeroes(denominator.m_words[denominator_length - 1]);
+    auto shift_words_left = [shift](Word const* words, size_t length, Word* output) {
+        if (shift == 0) {
+            __builtin_memcpy(output, words, length * sizeof(Word));
+            output[length] = 0;
+            return;
+        }
+        output[length] = words[length - 1] >> (bits_in_word - shift);
+        for (size_t i = length - 1; i > 0; --i)
+            output[i] = (words[i] << shift) | (words[i - 1] >> (bits_in_word - shift));
+        output[0] = words[0] << shift;
+    };
+
+    auto& shifted_denominator = temp_shift_result;
+    auto& shifted_numerator = temp_shift_plus;
+    shifted_denominator.set_to_0();
+    shifted_denominator.m_words.resize_and_keep_capacity(denominator_length + 1);
+    shifted_numerator.set_to_0();
+    shifted_numerator.m_words.resize_and_keep_capacity(numerator_length + 1);
+    shift_words_left(denominator.m_words.data(), denominator_length, shifted_denominator.m_words.data());
+    shift_words_left(numerator.m_words.data(), numerator_length, shifted_numerator.m_words.data());
+
+    Word* const divisor = shifted_denominator.m_words.data();
+    Word* const dividend = shifted_numerator.m_words.data();
+    DoubleWord const divisor_top = divisor[denominator_length - 1];
+    DoubleWord const divisor_next = divisor[denominator_length - 2];
+
+    size_t quotient_length = numerator_length - denominator_length + 1;
     quotient.set_to_0();
-    remainder.set_to(numerator);
-
-    // iterate all bits
-    for (int word_index = numerator.trimmed_length() - 1; word_index >= 0; --word_index) {
-        for (int bit_index = UnsignedBigInteger::BITS_IN_WORD - 1; bit_index >= 0; --bit_index) {
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-            shift_left_without_allocation(denominator, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-
-            subtract_without_allocation(remainder, temp_shift, temp_minus);
-            if (!temp_minus.is_invalid()) {
-                remainder.set_to(temp_minus);
-                quotient.set_bit_inplace(shift_amount);
+    quotient.m_words.resize_and_keep_capacity(quotient_length);
+
+    for (size_t j = quotient_length; j-- > 0;) {
+        // Guess the next word of the quotient, and correct the guess if it's obviously too large.
+        DoubleWord top = (static_cast<DoubleWord>(dividend[j + denominator_length]) << bits_in_word) | dividend[j + denominator_length - 1];
+        DoubleWord guess = top / divisor_top;
+        DoubleWord guess_remainder = top % divisor_top;
+        while ((guess >> bits_in_word) != 0 || guess * divisor_next > ((guess_remainder << bits_in_word) | dividend[j + denominator_length - 2])) {
+            --guess;
+            guess_remainder += divisor_top;
+            if ((guess_remainder >> bits_in_word) != 0)
+                break;
+        }
+
+        // Multiply and subtract.
+        SignedDoubleWord borrow = 0;
+        SignedDoubleWord difference = 0;
+        for (size_t i = 0; i < denominator_length; ++i) {
+            DoubleWord product = guess * divisor[i];
+            difference = static_cast<SignedDoubleWord>(dividend[i + j]) - borrow - static_cast<SignedDoubleWord>(product & 0xffffffff);
+            dividend[i + j] = static_cast<Word>(difference);
+            borrow = static_cast<SignedDoubleWord>(product >> bits_in_word) - (difference >> bits_in_word);
+        }
+        difference = static_cast<SignedDoubleWord>(dividend[j + denominator_length]) - borrow;
+        dividend[j + denominator_length] = static_cast<Word>(difference);
+
+        // If that went negative, the guess was still one too large, so add the denominator back.
+        if (difference < 0) {
+            --guess;
+            DoubleWord carry = 0;
+            for (size_t i = 0; i < denominator_length; ++i) {
+                carry += static_cast<DoubleWord>(dividend[i + j]) + divisor[i];
+                dividend[i + j] = static_cast<Word>(carry);
+                carry >>= bits_in_word;
             }
+            dividend[j + denominator_length] += static_cast<Word>(carry);
         }
+        quotient.m_words[j] = static_cast<Word>(guess);
+    }
+    quotient.clamp_to_trimmed_length();
+
+    // Shift what's left of the numerator back to get the remainder.
+    remainder.set_to_0();
+    remainder.m_words.resize_and_keep_capacity(denominator_length);
+    for (size_t i = 0; i < denominator_length; ++i) {
+        if (shift == 0)
+            remainder.m_words[i] = dividend[i];
+        else
+            remainder.m_words[i] = (dividend[i] >> shift) | (dividend[i + 1] << (bits_in_word - shift));
     }
 }
 
@@ -70,52 +70,16 @@ ALWAYS_INLINE static u32 inverse_wrapped(u32 value)
     return static_cast<u32>(-k0);
 }
 
-/**
- * Computes z = x * y + c. z_carry contains the top bits, z contains the bottom bits.
- */
-ALWAYS_INLINE static void linear_multiplication_with_carry(u32 x, u32 y, u32 c, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(x) * static_cast<u64>(y) + static_cast<u64>(c);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
-/**
- * Computes z = a + b. z_carry contains the top bit (1 or 0), z contains the bottom bits.
- */
-ALWAYS_INLINE static void addition_with_carry(u32 a, u32 b, u32& z_carry, u32& z)
-{
-    u64 result = static_cast<u64>(a) + static_cast<u64>(b);
-    z_carry = static_cast<u32>(result >> 32);
-    z = static_cast<u32>(result);
-}
-
-/**
- * Computes a montgomery "fragment" for y_i. This computes "z[i] += x[i] * y_i" for all words while rippling the carry, and returns the carry.
- * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
- */
-UnsignedBigInteger::Word UnsignedBigIntegerAlgorithms::montgomery_fragment(UnsignedBigInteger& z, size_t offset_in_z, UnsignedBigInteger const& x, UnsignedBigInteger::Word y_digit, size_t num_words)
-{
-    UnsignedBigInteger::Word carry { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word a_carry;
-        UnsignedBigInteger::Word a;
-        linear_multiplication_with_carry(x.m_words[i], y_digit, z.m_words[offset_in_z + i], a_carry, a);
-        UnsignedBigInteger::Word b_carry;
-        UnsignedBigInteger::Word b;
-        addition_with_carry(a, carry, b_carry, b);
-        z.m_words[offset_in_z + i] = b;
-        carry = a_carry + b_carry;
-    }
-    return carry;
-}
-
 /**
  * Computes the "almost montgomery" product : x * y * 2 ^ (-num_words * BITS_IN_WORD) % modulo
  * [Note : that means that the result z satisfies z * 2^(num_words * BITS_IN_WORD) % modulo = x * y % modulo]
  * assuming :
  *  - x, y and modulo are all already padded to num_words
  *  - k = inverse_wrapped(modulo) (optimization to not recompute K each time)
+ * For each word y_i of y, this adds x * y_i to the intermediate result, then adds the multiple of the modulo
+ * that makes its lowest word zero, and drops that word; the rest fits into num_words + 2 words of z.
+ * The multiplication and the reduction are interleaved like that so that z stays small (this is "CIOS" in
+ * Koç, Acar, Kaliski, "Analyzing and Comparing Montgomery Multiplication Algorithms").
  * Algorithm from: Gueron, "Efficient Software Implementations of Modular Exponentiation". (https://eprint.iacr.org/2011/239.pdf)
  */
 void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allocation(
@@ -127,55 +91,63 @@ void UnsignedBigIntegerAlgorithms::almost_montgomery_multiplication_without_allo
     size_t num_words,
     UnsignedBigInteger& result)
 {
+    using Word = UnsignedBigInteger::Word;
+    using DoubleWord = u64;
+    constexpr size_t bits_in_word = UnsignedBigInteger::BITS_IN_WORD;
+
     VERIFY(x.length() >= num_words);
     VERIFY(y.length() >= num_words);
     VERIFY(modulo.length() >= num_words);
 
-    z.set_to(0);
-    z.resize_with_leading_zeros(num_words * 2);
+    z.set_to_0();
+    z.m_words.resize_and_keep_capacity(num_words + 2);
+    Word* t = z.m_words.data();
+    __builtin_memset(t, 0, (num_words + 2) * sizeof(Word));
 
-    UnsignedBigInteger::Word previous_double_carry { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        // z[i->num_words+i] += x * y_i
-        UnsignedBigInteger::Word carry_1 = montgomery_fragment(z, i, x, y.m_words[i], num_words);
-        // z[i->num_words+i] += modulo * (z_i * k)
-        UnsignedBigInteger::Word t = z.m_words[i] * k;
-        UnsignedBigInteger::Word carry_2 = montgomery_fragment(z, i, modulo, t, num_words);
-
-        // Compute the carry by combining all of the carries of the previous computations
-        // Put it "right after" the range that we computed above
-        UnsignedBigInteger::Word temp_carry = previous_double_carry + carry_1;
-        UnsignedBigInteger::Word overall_carry = temp_carry + carry_2;
-        z.m_words[num_words + i] = overall_carry;
-
-        // Detect if there was a "double carry" for this word by checking if our carry results are smaller than their components
-        previous_double_carry = (temp_carry < carry_1 || overall_carry < carry_2) ? 1 : 0;
-    }
+    Word const* x_words = x.m_words.data();
+    Word const* modulo_words = modulo.m_words.data();
 
-    if (previous_double_carry == 0) {
-        // Return the top num_words bytes of Z, which contains our result.
-        shift_right_by_n_words(z, num_words, result);
-        result.resize_with_leading_zeros(num_words);
-        return;
+    for (size_t i = 0; i < num_words; ++i) {
+        // t += x * y_i
+        DoubleWord y_digit = y.m_words[i];
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < num_words; ++j) {
+            DoubleWord sum = x_words[j] * y_digit + t[j] + carry;
+            t[j] = static_cast<Word>(sum);
+            carry = sum >> bits_in_word;
+        }
+        DoubleWord top = static_cast<DoubleWord>(t[num_words]) + carry;
+        t[num_words] = static_cast<Word>(top);
+        t[num_words + 1] = static_cast<Word>(top >> bits_in_word);
+
+        // t = (t + modulo * (t_0 * k)) / 2^BITS_IN_WORD, the addition making the lowest word zero.
+        DoubleWord factor = static_cast<Word>(t[0] * k);
+        carry = (modulo_words[0] * factor + t[0]) >> bits_in_word;
+        for (size_t j = 1; j < num_words; ++j) {
+            DoubleWord sum = modulo_words[j] * factor + t[j] + carry;
+            t[j - 1] = static_cast<Word>(sum);
+            carry = sum >> bits_in_word;
+        }
+        top = static_cast<DoubleWord>(t[num_words]) + carry;
+        t[num_words - 1] = static_cast<Word>(top);
+        t[num_words] = t[num_words + 1] + static_cast<Word>(top >> bits_in_word);
     }
 
-    // We have a carry, so we're "one bigger" than we need to be.
-    // Subtract the modulo from the result (the top half of z), and write it to the bottom half of Z since we have space.
-    // (With carry, of course.)
-    UnsignedBigInteger::Word c { 0 };
-    for (size_t i = 0; i < num_words; ++i) {
-        UnsignedBigInteger::Word z_digit = z.m_words[num_words + i];
-        UnsignedBigInteger::Word modulo_digit = modulo.m_words[i];
-        UnsignedBigInteger::Word new_z_digit = z_digit - modulo_digit - c;
-        z.m_words[i] = new_z_digit;
-        // Detect if the subtraction underflowed - from "Hacker's Delight"
-        c = ((modulo_digit & ~z_digit) | ((modulo_digit | ~z_digit) & new_z_digit)) >> (UnsignedBigInteger::BITS_IN_WORD - 1);
+    if (t[num_words] != 0) {
+        // We have a carry, so we're "one bigger" than we need to be.
+        // Subtract the modulo from the result; the borrow out of the top word cancels the carry.
+        Word borrow = 0;
+        for (size_t i = 0; i < num_words; ++i) {
+            DoubleWord difference = static_cast<DoubleWord>(t[i]) - modulo_words[i] - borrow;
+            t[i] = static_cast<Word>(difference);
+            borrow = (difference >> bits_in_word) ? 1 : 0;
+        }
     }
 
-    // Return the bottom num_words bytes of Z (with the carry bit handled)
-    z.m_words.resize(num_words);
-    result.set_to(z);
-    result.resize_with_leading_zeros(num_words);
+    // Return the bottom num_words words of z.
+    result.set_to_0();
+    result.m_words.resize_and_keep_capacity(num_words);
+    __builtin_memcpy(result.m_words.data(), t, num_words * sizeof(Word));
 }
 
 /**
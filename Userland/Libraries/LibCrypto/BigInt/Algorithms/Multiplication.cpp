@@ -1,6 +1,7 @@
 /*
  * Copyright (c) 2020, Itamar S. <itamar8910@gmail.com>
  * Copyright (c) 2020-2021, Dex♪ <dexes.ttp@gmail.com>
+ * Copyright (c) 2022, the SerenityOS developers.
  *
  * SPDX-License-Identifier: BSD-2-Clause
  */
@@ -9,38 +10,197 @@
 
 namespace Crypto {
 
+using Word = UnsignedBigInteger::Word;
+using DoubleWord = u64;
+
+// Below this many words, splitting the operands up costs more than it saves.
+static constexpr size_t karatsuba_threshold = 32;
+
+/**
+ * Complexity: O(N * M) where N and M are the number of words in each number
+ * Computes output[0, left_length + right_length) = left * right, one word of the left number at a time.
+ */
+static void schoolbook_multiply(Word const* left, size_t left_length, Word const* right, size_t right_length, Word* output)
+{
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    for (size_t i = 0; i < left_length; ++i) {
+        DoubleWord left_word = left[i];
+        if (left_word == 0)
+            continue;
+        DoubleWord carry = 0;
+        for (size_t j = 0; j < right_length; ++j) {
+            // This can't overflow: (2^32 - 1)^2 + 2 * (2^32 - 1) = 2^64 - 1.
+            DoubleWord result = left_word * right[j] + output[i + j] + carry;
+            output[i + j] = static_cast<Word>(result);
+            carry = result >> UnsignedBigInteger::BITS_IN_WORD;
+        }
+        output[i + right_length] = static_cast<Word>(carry);
+    }
+}
+
+// Adds value[0, value_length) into accumulator[0, accumulator_length), and returns the carry that didn't fit.
+static Word add_words(Word* accumulator, size_t accumulator_length, Word const* value, size_t value_length)
+{
+    VERIFY(accumulator_length >= value_length);
+    DoubleWord carry = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        carry += static_cast<DoubleWord>(accumulator[i]) + value[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    for (; carry && i < accumulator_length; ++i) {
+        carry += accumulator[i];
+        accumulator[i] = static_cast<Word>(carry);
+        carry >>= UnsignedBigInteger::BITS_IN_WORD;
+    }
+    return static_cast<Word>(carry);
+}
+
+// Subtracts value[0, value_length) from accumulator[0, accumulator_length), which has to be at least as large.
+static void subtract_words(Word* accumulator, size_t accumulator_length, Word const* value, size_t value_length)
+{
+    VERIFY(accumulator_length >= value_length);
+    Word borrow = 0;
+    size_t i = 0;
+    for (; i < value_length; ++i) {
+        DoubleWord result = static_cast<DoubleWord>(accumulator[i]) - value[i] - borrow;
+        accumulator[i] = static_cast<Word>(result);
+        borrow = (result >> UnsignedBigInteger::BITS_IN_WORD) ? 1 : 0;
+    }
+    for (; borrow && i < accumulator_length; ++i) {
+        borrow = accumulator[i] == 0 ? 1 : 0;
+        --accumulator[i];
+    }
+    VERIFY(borrow == 0);
+}
+
+static size_t karatsuba_scratch_size(size_t length)
+{
+    if (length < karatsuba_threshold)
+        return 0;
+    size_t high_length = length - length / 2;
+    return 4 * (high_length + 1) + karatsuba_scratch_size(high_length + 1);
+}
+
+/**
+ * Complexity: O(N^log2(3)) where N is the number of words in both numbers
+ * Karatsuba multiplication, for numbers of the same length: with left = l1 * B + l0 and right = r1 * B + r0,
+ * left * right = z2 * B^2 + (z1 - z2 - z0) * B + z0, where z2 = l1 * r1, z0 = l0 * r0 and z1 = (l1 + l0) * (r1 + r0).
+ * So it takes three multiplications of half the size, instead of four.
+ */
+static void karatsuba_multiply(Word const* left, Word const* right, size_t length, Word* output, Word* scratch)
+{
+    if (length < karatsuba_threshold) {
+        schoolbook_multiply(left, length, right, length, output);
+        return;
+    }
+
+    size_t low_length = length / 2;
+    size_t high_length = length - low_length;
+    size_t sum_length = high_length + 1;
+
+    // z0 and z2 go straight to where they end up.
+    karatsuba_multiply(left, right, low_length, output, scratch);
+    if (high_length == low_length) {
+        karatsuba_multiply(left + low_length, right + low_length, high_length, output + 2 * low_length, scratch);
+    } else {
+        // The high halves are a word longer (for odd lengths), but so is the space left for z2.
+        schoolbook_multiply(left + low_length, high_length, right + low_length, high_length, output + 2 * low_length);
+    }
+
+    Word* left_sum = scratch;
+    Word* right_sum = left_sum + sum_length;
+    Word* middle = right_sum + sum_length;
+    Word* next_scratch = middle + 2 * sum_length;
+
+    __builtin_memcpy(left_sum, left + low_length, high_length * sizeof(Word));
+    left_sum[high_length] = add_words(left_sum, high_length, left, low_length);
+    __builtin_memcpy(right_sum, right + low_length, high_length * sizeof(Word));
+    right_sum[high_length] = add_words(right_sum, high_length, right, low_length);
+
+    karatsuba_multiply(left_sum, right_sum, sum_length, middle, next_scratch);
+    subtract_words(middle, 2 * sum_length, output, 2 * low_length);
+    subtract_words(middle, 2 * sum_length, output + 2 * low_length, 2 * high_length);
+
+    // z1 - z2 - z0 is less than B^2 times as large as the result, so any words of it that don't fit are zero.
+    size_t middle_length = min(2 * sum_length, 2 * length - low_length);
+    for (size_t i = middle_length; i < 2 * sum_length; ++i)
+        VERIFY(middle[i] == 0);
+    auto carry = add_words(output + low_length, 2 * length - low_length, middle, middle_length);
+    VERIFY(carry == 0);
+}
+
+static size_t multiplication_scratch_size(size_t left_length, size_t right_length)
+{
+    if (left_length < right_length)
+        swap(left_length, right_length);
+    if (right_length < karatsuba_threshold)
+        return 0;
+    if (left_length == right_length)
+        return karatsuba_scratch_size(right_length);
+    size_t last_chunk_length = left_length % right_length;
+    return 2 * right_length + max(karatsuba_scratch_size(right_length), last_chunk_length ? multiplication_scratch_size(right_length, last_chunk_length) : 0);
+}
+
+// Computes output[0, left_length + right_length) = left * right, with whichever algorithm suits the sizes.
+static void multiply_words(Word const* left, size_t left_length, Word const* right, size_t right_length, Word* output, Word* scratch)
+{
+    if (left_length < right_length) {
+        swap(left, right);
+        swap(left_length, right_length);
+    }
+
+    if (right_length < karatsuba_threshold) {
+        schoolbook_multiply(left, left_length, right, right_length, output);
+        return;
+    }
+
+    if (left_length == right_length) {
+        karatsuba_multiply(left, right, right_length, output, scratch);
+        return;
+    }
+
+    // Multiply the longer number in pieces of the shorter one's length, and add them up.
+    __builtin_memset(output, 0, (left_length + right_length) * sizeof(Word));
+    Word* product = scratch;
+    Word* next_scratch = scratch + 2 * right_length;
+    for (size_t offset = 0; offset < left_length; offset += right_length) {
+        size_t chunk_length = min(right_length, left_length - offset);
+        multiply_words(left + offset, chunk_length, right, right_length, product, next_scratch);
+        auto carry = add_words(output + offset, left_length + right_length - offset, product, chunk_length + right_length);
+        VERIFY(carry == 0);
+    }
+}
+
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N^log2(3)) for numbers of about the same size, where N is the number of words in the larger number
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indices of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Small numbers are multiplied a word at a time, the way it's done on paper. Once both numbers have
+ * at least `karatsuba_threshold` words, Karatsuba's algorithm takes over (see karatsuba_multiply()).
+ * temp_shift is used as scratch space for the latter; the other temporaries aren't needed anymore.
  */
 FLATTEN void UnsignedBigIntegerAlgorithms::multiply_without_allocation(
     UnsignedBigInteger const& left,
     UnsignedBigInteger const& right,
-    UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
+    UnsignedBigInteger&,
+    UnsignedBigInteger&,
     UnsignedBigInteger& temp_shift,
     UnsignedBigInteger& output)
 {
-    output.set_to_0();
+    auto left_length = left.trimmed_length();
+    auto right_length = right.trimmed_length();
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    output.set_to_0();
+    if (left_length == 0 || right_length == 0)
+        return;
 
-            size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    temp_shift.set_to_0();
+    temp_shift.m_words.resize_and_keep_capacity(multiplication_scratch_size(left_length, right_length));
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_into_accumulator_without_allocation(output, temp_shift);
-        }
-    }
+    output.m_words.resize_and_keep_capacity(left_length + right_length);
+    multiply_words(left.m_words.data(), left_length, right.m_words.data(), right_length, output.m_words.data(), temp_shift.m_words.data());
+    output.clamp_to_trimmed_length();
 }
 
 }
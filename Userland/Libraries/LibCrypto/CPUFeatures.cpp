@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/CPUFeatures.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <cpuid.h>
+#endif
+
+namespace Crypto {
+
+#if CRYPTO_HAS_X86_ACCELERATION
+struct FeatureFlags {
+    unsigned leaf1_ecx { 0 };
+    unsigned leaf7_ebx { 0 };
+    bool os_saves_avx_state { false };
+};
+
+static FeatureFlags const& feature_flags()
+{
+    static FeatureFlags const flags = [] {
+        FeatureFlags flags;
+        unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+            return flags;
+        flags.leaf1_ecx = ecx;
+        if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            flags.leaf7_ebx = ebx;
+        if ((flags.leaf1_ecx & bit_OSXSAVE) && (flags.leaf1_ecx & bit_AVX)) {
+            // XCR0 has to have both the SSE and the AVX state enabled.
+            unsigned xcr0_low = 0, xcr0_high = 0;
+            asm volatile("xgetbv"
+                         : "=a"(xcr0_low), "=d"(xcr0_high)
+                         : "c"(0));
+            flags.os_saves_avx_state = (xcr0_low & 0x6) == 0x6;
+        }
+        return flags;
+    }();
+    return flags;
+}
+
+bool has_aes_ni()
+{
+    return feature_flags().leaf1_ecx & bit_AES;
+}
+
+bool has_ssse3()
+{
+    return feature_flags().leaf1_ecx & bit_SSSE3;
+}
+
+bool has_pclmul()
+{
+    return (feature_flags().leaf1_ecx & bit_PCLMUL) && (feature_flags().leaf1_ecx & bit_SSSE3);
+}
+
+bool has_sha_ni()
+{
+    return (feature_flags().leaf7_ebx & bit_SHA) && (feature_flags().leaf1_ecx & bit_SSE4_1);
+}
+
+bool has_avx2()
+{
+    return (feature_flags().leaf7_ebx & bit_AVX2) && feature_flags().os_saves_avx_state;
+}
+#endif
+
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+
+// The accelerated code paths use SSE, which the kernel is built without.
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    define CRYPTO_HAS_X86_ACCELERATION 1
+#else
+#    define CRYPTO_HAS_X86_ACCELERATION 0
+#endif
+
+namespace Crypto {
+
+#if CRYPTO_HAS_X86_ACCELERATION
+// Whether the CPU has the AES-NI instructions.
+bool has_aes_ni();
+// Whether the CPU has SSSE3.
+bool has_ssse3();
+// Whether the CPU has PCLMULQDQ (carry-less multiplication) and SSSE3.
+bool has_pclmul();
+// Whether the CPU has the SHA extensions and SSE4.1.
+bool has_sha_ni();
+// Whether the CPU has AVX2, and the OS saves the AVX registers.
+bool has_avx2();
+#else
+constexpr bool has_aes_ni() { return false; }
+constexpr bool has_ssse3() { return false; }
+constexpr bool has_pclmul() { return false; }
+constexpr bool has_sha_ni() { return false; }
+constexpr bool has_avx2() { return false; }
+#endif
+
+}
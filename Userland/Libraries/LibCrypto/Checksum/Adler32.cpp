@@ -6,15 +6,98 @@
 
 #include <AK/Span.h>
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Checksum/Adler32.h>
 
+#if CRYPTO_HAS_X86_ACCELERATION
+#    include <emmintrin.h>
+#    include <tmmintrin.h>
+#endif
+
 namespace Crypto::Checksum {
 
+static constexpr u32 modulus = 65521;
+
+// The most bytes that can be summed up before the second sum might overflow 32 bits, and has to be reduced again:
+// the largest n with 255 * n * (n + 1) / 2 + (n + 1) * (modulus - 1) < 2^32.
+static constexpr size_t max_bytes_between_reductions = 5552;
+
+#if CRYPTO_HAS_X86_ACCELERATION
+#    define SSSE3_FUNCTION [[gnu::target("ssse3")]]
+
+static constexpr size_t vector_block_size = 32;
+
+SSSE3_FUNCTION static u32 horizontal_sum(__m128i value)
+{
+    value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+    value = _mm_add_epi32(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+    return static_cast<u32>(_mm_cvtsi128_si32(value));
+}
+
+// Sums up whole blocks of 32 bytes, and leaves the rest of the input to the caller.
+// Within a block, the first sum is the plain sum of the bytes, and each byte adds to the second sum as many times as
+// there are bytes from it to the end of the block (32 for the first one, 1 for the last one); on top of that, the
+// second sum gets 32 times the first sum as it was before the block.
+SSSE3_FUNCTION static size_t ssse3_update(u32& a, u32& b, u8 const* data, size_t size)
+{
+    auto const first_weights = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    auto const second_weights = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    auto const ones = _mm_set1_epi16(1);
+    auto const zero = _mm_setzero_si128();
+
+    size_t block_count = size / vector_block_size;
+    auto remaining_blocks = block_count;
+    while (remaining_blocks > 0) {
+        auto blocks = min(remaining_blocks, max_bytes_between_reductions / vector_block_size);
+        remaining_blocks -= blocks;
+
+        // The first sum from before each block, which all end up multiplied by 32 in the second sum.
+        auto previous_sums = _mm_cvtsi32_si128(static_cast<int>(a * blocks));
+        auto sum_a = _mm_setzero_si128();
+        auto sum_b = _mm_cvtsi32_si128(static_cast<int>(b));
+        for (; blocks > 0; --blocks, data += vector_block_size) {
+            auto first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+            auto second = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + 16));
+            previous_sums = _mm_add_epi32(previous_sums, sum_a);
+
+            sum_a = _mm_add_epi32(sum_a, _mm_sad_epu8(first, zero));
+            sum_b = _mm_add_epi32(sum_b, _mm_madd_epi16(_mm_maddubs_epi16(first, first_weights), ones));
+            sum_a = _mm_add_epi32(sum_a, _mm_sad_epu8(second, zero));
+            sum_b = _mm_add_epi32(sum_b, _mm_madd_epi16(_mm_maddubs_epi16(second, second_weights), ones));
+        }
+        sum_b = _mm_add_epi32(sum_b, _mm_slli_epi32(previous_sums, 5));
+
+        a = (a + horizontal_sum(sum_a)) % modulus;
+        b = horizontal_sum(sum_b) % modulus;
+    }
+    return block_count * vector_block_size;
+}
+#endif
+
 void Adler32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state_a = (m_state_a + data.at(i)) % 65521;
-        m_state_b = (m_state_b + m_state_a) % 65521;
+    auto const* bytes = data.data();
+    auto size = data.size();
+
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (size >= vector_block_size && has_ssse3()) {
+        auto processed = ssse3_update(m_state_a, m_state_b, bytes, size);
+        bytes += processed;
+        size -= processed;
+    }
+#endif
+
+    // Taking the sums modulo 65521 only every so often gives the same result as doing it after every byte.
+    while (size > 0) {
+        auto chunk_size = min(size, max_bytes_between_reductions);
+        for (size_t i = 0; i < chunk_size; i++) {
+            m_state_a += bytes[i];
+            m_state_b += m_state_a;
+        }
+        m_state_a %= modulus;
+        m_state_b %= modulus;
+        bytes += chunk_size;
+        size -= chunk_size;
     }
 };
 
@@ -6,6 +6,7 @@
 
 #include <AK/StringBuilder.h>
 #include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Cipher/AESNI.h>
 #include <LibCrypto/Cipher/AESTables.h>
 
 namespace Crypto {
@@ -199,12 +200,17 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
 
 void AESCipher::encrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
-    u32 s0, s1, s2, s3, t0, t1, t2, t3;
-    size_t r { 0 };
-
     const auto& dec_key = key();
     const auto* round_keys = dec_key.round_keys();
 
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_aes_ni())
+        return AESNI::encrypt_block(round_keys, dec_key.rounds(), in.bytes().data(), out.bytes().data());
+#endif
+
+    u32 s0, s1, s2, s3, t0, t1, t2, t3;
+    size_t r { 0 };
+
     s0 = get_key(in.bytes().offset_pointer(0)) ^ round_keys[0];
     s1 = get_key(in.bytes().offset_pointer(4)) ^ round_keys[1];
     s2 = get_key(in.bytes().offset_pointer(8)) ^ round_keys[2];
@@ -291,12 +297,17 @@ void AESCipher::encrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
-    u32 s0, s1, s2, s3, t0, t1, t2, t3;
-    size_t r { 0 };
-
     const auto& dec_key = key();
     const auto* round_keys = dec_key.round_keys();
 
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_aes_ni())
+        return AESNI::decrypt_block(round_keys, dec_key.rounds(), in.bytes().data(), out.bytes().data());
+#endif
+
+    u32 s0, s1, s2, s3, t0, t1, t2, t3;
+    size_t r { 0 };
+
     s0 = get_key(in.bytes().offset_pointer(0)) ^ round_keys[0];
     s1 = get_key(in.bytes().offset_pointer(4)) ^ round_keys[1];
     s2 = get_key(in.bytes().offset_pointer(8)) ^ round_keys[2];
@@ -378,6 +389,35 @@ void AESCipher::decrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
     // clang-format on
 }
 
+size_t AESCipher::encrypt_in_counter_mode([[maybe_unused]] const ReadonlyBytes* in, [[maybe_unused]] Bytes out, [[maybe_unused]] Bytes counter)
+{
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_aes_ni()) {
+        const AESCipherKey& aes_key = m_key;
+        VERIFY(counter.size() == block_size());
+        auto length = in ? min(in->size(), out.size()) : out.size();
+        auto block_count = length / block_size();
+        AESNI::encrypt_in_counter_mode(aes_key.round_keys(), aes_key.rounds(), in ? in->data() : nullptr, out.data(), block_count, counter.data());
+        return block_count * block_size();
+    }
+#endif
+    return 0;
+}
+
+size_t AESCipher::decrypt_in_cbc_mode([[maybe_unused]] ReadonlyBytes in, [[maybe_unused]] Bytes out, [[maybe_unused]] ReadonlyBytes iv)
+{
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_aes_ni()) {
+        const AESCipherKey& aes_key = m_key;
+        VERIFY(iv.size() >= block_size());
+        auto block_count = min(in.size(), out.size()) / block_size();
+        AESNI::decrypt_in_cbc_mode(aes_key.round_keys(), aes_key.rounds(), in.data(), out.data(), block_count, iv.data());
+        return block_count * block_size();
+    }
+#endif
+    return 0;
+}
+
 void AESCipherBlock::overwrite(ReadonlyBytes bytes)
 {
     auto data = bytes.data();
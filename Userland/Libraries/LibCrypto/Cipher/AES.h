@@ -120,6 +120,11 @@ public:
     virtual void encrypt_block(const BlockType& in, BlockType& out) override;
     virtual void decrypt_block(const BlockType& in, BlockType& out) override;
 
+    // Used by the modes to process many blocks at once where that's faster than one at a time (i.e. with AES-NI).
+    // They return how many bytes they've processed, which may be none, and leave the rest to be done block by block.
+    size_t encrypt_in_counter_mode(const ReadonlyBytes* in, Bytes out, Bytes counter);
+    size_t decrypt_in_cbc_mode(ReadonlyBytes in, Bytes out, ReadonlyBytes iv);
+
 #ifndef KERNEL
     virtual String class_name() const override
     {
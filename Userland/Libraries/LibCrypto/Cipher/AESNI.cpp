@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/Cipher/AESNI.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+
+#    include <AK/ByteReader.h>
+#    include <AK/Endian.h>
+#    include <emmintrin.h>
+#    include <wmmintrin.h>
+
+#    define AESNI_FUNCTION [[gnu::target("aes,sse2")]]
+
+namespace Crypto {
+namespace Cipher {
+namespace AESNI {
+
+static constexpr size_t max_round_count = 14;
+
+// How many blocks are in flight at once; the instructions have a latency of several cycles, but can be issued every cycle.
+static constexpr size_t parallel_blocks = 4;
+
+struct RoundKeys {
+    __m128i keys[max_round_count + 1];
+    size_t rounds;
+};
+
+AESNI_FUNCTION static RoundKeys load_round_keys(u32 const* round_keys, size_t rounds)
+{
+    RoundKeys result;
+    result.rounds = rounds;
+    // AESCipherKey keeps every column of a round key as a big endian word.
+    for (size_t i = 0; i <= rounds; ++i) {
+        auto const* words = round_keys + i * 4;
+        result.keys[i] = _mm_set_epi32(
+            AK::convert_between_host_and_big_endian(words[3]),
+            AK::convert_between_host_and_big_endian(words[2]),
+            AK::convert_between_host_and_big_endian(words[1]),
+            AK::convert_between_host_and_big_endian(words[0]));
+    }
+    return result;
+}
+
+AESNI_FUNCTION static __m128i encrypt(RoundKeys const& keys, __m128i block)
+{
+    block = _mm_xor_si128(block, keys.keys[0]);
+    for (size_t i = 1; i < keys.rounds; ++i)
+        block = _mm_aesenc_si128(block, keys.keys[i]);
+    return _mm_aesenclast_si128(block, keys.keys[keys.rounds]);
+}
+
+AESNI_FUNCTION static __m128i decrypt(RoundKeys const& keys, __m128i block)
+{
+    block = _mm_xor_si128(block, keys.keys[0]);
+    for (size_t i = 1; i < keys.rounds; ++i)
+        block = _mm_aesdec_si128(block, keys.keys[i]);
+    return _mm_aesdeclast_si128(block, keys.keys[keys.rounds]);
+}
+
+AESNI_FUNCTION static void encrypt_parallel(RoundKeys const& keys, __m128i (&blocks)[parallel_blocks])
+{
+    for (auto& block : blocks)
+        block = _mm_xor_si128(block, keys.keys[0]);
+    for (size_t i = 1; i < keys.rounds; ++i) {
+        for (auto& block : blocks)
+            block = _mm_aesenc_si128(block, keys.keys[i]);
+    }
+    for (auto& block : blocks)
+        block = _mm_aesenclast_si128(block, keys.keys[keys.rounds]);
+}
+
+AESNI_FUNCTION static void decrypt_parallel(RoundKeys const& keys, __m128i (&blocks)[parallel_blocks])
+{
+    for (auto& block : blocks)
+        block = _mm_xor_si128(block, keys.keys[0]);
+    for (size_t i = 1; i < keys.rounds; ++i) {
+        for (auto& block : blocks)
+            block = _mm_aesdec_si128(block, keys.keys[i]);
+    }
+    for (auto& block : blocks)
+        block = _mm_aesdeclast_si128(block, keys.keys[keys.rounds]);
+}
+
+AESNI_FUNCTION void encrypt_block(u32 const* round_keys, size_t rounds, u8 const* in, u8* out)
+{
+    auto keys = load_round_keys(round_keys, rounds);
+    auto block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encrypt(keys, block));
+}
+
+AESNI_FUNCTION void decrypt_block(u32 const* round_keys, size_t rounds, u8 const* in, u8* out)
+{
+    auto keys = load_round_keys(round_keys, rounds);
+    auto block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), decrypt(keys, block));
+}
+
+struct Counter {
+    u64 high;
+    u64 low;
+};
+
+AESNI_FUNCTION static __m128i next_counter_block(Counter& counter)
+{
+    auto block = _mm_set_epi64x(AK::convert_between_host_and_big_endian(counter.low), AK::convert_between_host_and_big_endian(counter.high));
+    if (++counter.low == 0)
+        ++counter.high;
+    return block;
+}
+
+AESNI_FUNCTION static void output_key_stream_block(__m128i block, u8 const* in, u8* out)
+{
+    if (in)
+        block = _mm_xor_si128(block, _mm_loadu_si128(reinterpret_cast<__m128i const*>(in)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), block);
+}
+
+AESNI_FUNCTION void encrypt_in_counter_mode(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count, u8* counter_bytes)
+{
+    auto keys = load_round_keys(round_keys, rounds);
+    Counter counter {
+        AK::convert_between_host_and_big_endian(ByteReader::load64(counter_bytes)),
+        AK::convert_between_host_and_big_endian(ByteReader::load64(counter_bytes + 8)),
+    };
+
+    for (; block_count >= parallel_blocks; block_count -= parallel_blocks) {
+        __m128i blocks[parallel_blocks];
+        for (auto& block : blocks)
+            block = next_counter_block(counter);
+        encrypt_parallel(keys, blocks);
+        for (size_t i = 0; i < parallel_blocks; ++i)
+            output_key_stream_block(blocks[i], in ? in + i * 16 : nullptr, out + i * 16);
+        if (in)
+            in += parallel_blocks * 16;
+        out += parallel_blocks * 16;
+    }
+    for (; block_count > 0; --block_count) {
+        output_key_stream_block(encrypt(keys, next_counter_block(counter)), in, out);
+        if (in)
+            in += 16;
+        out += 16;
+    }
+
+    ByteReader::store(counter_bytes, AK::convert_between_host_and_big_endian(counter.high));
+    ByteReader::store(counter_bytes + 8, AK::convert_between_host_and_big_endian(counter.low));
+}
+
+AESNI_FUNCTION void decrypt_in_cbc_mode(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count, u8 const* iv)
+{
+    auto keys = load_round_keys(round_keys, rounds);
+    auto previous = _mm_loadu_si128(reinterpret_cast<__m128i const*>(iv));
+
+    // Unlike encryption, decryption doesn't depend on the previous block, only the XOR afterwards does.
+    for (; block_count >= parallel_blocks; block_count -= parallel_blocks) {
+        __m128i ciphertext[parallel_blocks];
+        __m128i blocks[parallel_blocks];
+        for (size_t i = 0; i < parallel_blocks; ++i)
+            blocks[i] = ciphertext[i] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i * 16));
+        decrypt_parallel(keys, blocks);
+        for (size_t i = 0; i < parallel_blocks; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 16), _mm_xor_si128(blocks[i], previous));
+            previous = ciphertext[i];
+        }
+        in += parallel_blocks * 16;
+        out += parallel_blocks * 16;
+    }
+    for (; block_count > 0; --block_count) {
+        auto ciphertext = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_xor_si128(decrypt(keys, ciphertext), previous));
+        previous = ciphertext;
+        in += 16;
+        out += 16;
+    }
+}
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+
+// AES using the AES-NI instructions, which must only be called if has_aes_ni().
+// The round keys are the ones from AESCipherKey, which already has them the way the instructions want them
+// (decryption uses the "equivalent inverse cipher" of FIPS 197 section 5.3.5).
+namespace Crypto {
+namespace Cipher {
+namespace AESNI {
+
+void encrypt_block(u32 const* round_keys, size_t rounds, u8 const* in, u8* out);
+void decrypt_block(u32 const* round_keys, size_t rounds, u8 const* in, u8* out);
+
+// Encrypts `block_count` counter blocks, starting at `counter` (a 128-bit big endian number) and counting up,
+// and XORs them into `in`, or just outputs them if `in` is null. `counter` is left at the one after the last.
+void encrypt_in_counter_mode(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count, u8* counter);
+// May decrypt in place.
+void decrypt_in_cbc_mode(u32 const* round_keys, size_t rounds, u8 const* in, u8* out, size_t block_count, u8 const* iv);
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+
+namespace Crypto {
+namespace Cipher {
+
+// The ChaCha20 stream cipher as specified in RFC 8439, with a 96-bit nonce and a 32-bit block counter.
+class ChaCha20 {
+public:
+    static constexpr size_t key_size = 32;
+    static constexpr size_t nonce_size = 12;
+    static constexpr size_t block_size = 64;
+
+    ChaCha20(ReadonlyBytes key, ReadonlyBytes nonce, u32 initial_counter = 0);
+    ~ChaCha20();
+
+    // XORs the key stream into `in`, picking up where the previous call left off. Encryption and decryption are the same.
+    void process(ReadonlyBytes in, Bytes out);
+    // Outputs the key stream itself.
+    void generate_key_stream(Bytes out);
+
+private:
+    void generate_block();
+
+    u32 m_state[16];
+    u8 m_block[block_size];
+    size_t m_block_offset { block_size };
+};
+
+}
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Endian.h>
+#include <AK/Memory.h>
+#include <LibCrypto/Authentication/Poly1305.h>
+#include <LibCrypto/Cipher/ChaCha20.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
+
+namespace Crypto {
+namespace Cipher {
+
+ChaCha20Poly1305::ChaCha20Poly1305(ReadonlyBytes key)
+{
+    VERIFY(key.size() == key_size);
+    __builtin_memcpy(m_key, key.data(), key_size);
+}
+
+ChaCha20Poly1305::~ChaCha20Poly1305()
+{
+    secure_zero(m_key, sizeof(m_key));
+}
+
+void ChaCha20Poly1305::compute_tag(ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes ciphertext, Bytes tag) const
+{
+    VERIFY(tag.size() >= tag_size);
+
+    // The one-time Poly1305 key is the start of the key stream for block 0 (section 2.6).
+    u8 one_time_key[Authentication::Poly1305::key_size];
+    ChaCha20(ReadonlyBytes { m_key, key_size }, nonce, 0).generate_key_stream({ one_time_key, sizeof(one_time_key) });
+    Authentication::Poly1305 poly1305({ one_time_key, sizeof(one_time_key) });
+    secure_zero(one_time_key, sizeof(one_time_key));
+
+    static constexpr u8 zeros[16] {};
+    auto update_padded = [&](ReadonlyBytes data) {
+        poly1305.update(data);
+        if (data.size() % 16 != 0)
+            poly1305.update({ zeros, 16 - data.size() % 16 });
+    };
+    update_padded(aad);
+    update_padded(ciphertext);
+
+    u64 lengths[2] {
+        AK::convert_between_host_and_little_endian((u64)aad.size()),
+        AK::convert_between_host_and_little_endian((u64)ciphertext.size()),
+    };
+    poly1305.update({ lengths, sizeof(lengths) });
+
+    auto digest = poly1305.digest();
+    __builtin_memcpy(tag.data(), digest.data(), tag_size);
+}
+
+void ChaCha20Poly1305::encrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const
+{
+    // The data itself is encrypted starting with block 1.
+    ChaCha20(ReadonlyBytes { m_key, key_size }, nonce, 1).process(in, out);
+    compute_tag(nonce, aad, out.trim(in.size()), tag);
+}
+
+VerificationConsistency ChaCha20Poly1305::decrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes tag) const
+{
+    u8 expected_tag[tag_size];
+    compute_tag(nonce, aad, in, { expected_tag, sizeof(expected_tag) });
+    if (tag.size() != tag_size || !timing_safe_compare(expected_tag, tag.data(), tag_size))
+        return VerificationConsistency::Inconsistent;
+
+    ChaCha20(ReadonlyBytes { m_key, key_size }, nonce, 1).process(in, out);
+    return VerificationConsistency::Consistent;
+}
+
+}
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Span.h>
+#include <AK/Types.h>
+#include <LibCrypto/Verification.h>
+
+namespace Crypto {
+namespace Cipher {
+
+// The ChaCha20-Poly1305 AEAD construction from RFC 8439 section 2.8.
+class ChaCha20Poly1305 {
+public:
+    static constexpr size_t key_size = 32;
+    static constexpr size_t nonce_size = 12;
+    static constexpr size_t tag_size = 16;
+
+    explicit ChaCha20Poly1305(ReadonlyBytes key);
+    ~ChaCha20Poly1305();
+
+    void encrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, Bytes tag) const;
+    // `out` is only written to if the tag matches.
+    VerificationConsistency decrypt(ReadonlyBytes in, Bytes out, ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes tag) const;
+
+private:
+    void compute_tag(ReadonlyBytes nonce, ReadonlyBytes aad, ReadonlyBytes ciphertext, Bytes tag) const;
+
+    u8 m_key[key_size];
+};
+
+}
+}
@@ -105,6 +105,14 @@ public:
         m_cipher_block.set_padding_mode(cipher.padding_mode());
         size_t offset { 0 };
 
+        if constexpr (requires { cipher.decrypt_in_cbc_mode(in, out, iv); }) {
+            VERIFY(length <= out.size());
+            offset = cipher.decrypt_in_cbc_mode(in, out, iv);
+            length -= offset;
+            if (offset != 0)
+                iv = in.slice(offset - block_size, block_size);
+        }
+
         while (length > 0) {
             auto slice = in.slice(offset);
             m_cipher_block.overwrite(slice.data(), block_size);
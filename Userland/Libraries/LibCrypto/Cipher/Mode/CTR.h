@@ -171,6 +171,12 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        if constexpr (IsSame<IncrementFunctionType, IncrementInplace> && requires { cipher.encrypt_in_counter_mode(in, out, iv); }) {
+            // This leaves at most a partial block for us.
+            offset = cipher.encrypt_in_counter_mode(in, out.trim(length), iv);
+            length -= offset;
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
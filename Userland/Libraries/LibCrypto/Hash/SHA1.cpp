@@ -8,6 +8,7 @@
 #include <AK/Memory.h>
 #include <AK/Types.h>
 #include <LibCrypto/Hash/SHA1.h>
+#include <LibCrypto/Hash/SHANI.h>
 
 namespace Crypto {
 namespace Hash {
@@ -19,6 +20,11 @@ static constexpr auto ROTATE_LEFT(u32 value, size_t bits)
 
 inline void SHA1::transform(const u8* data)
 {
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_sha_ni())
+        return SHANI::sha1_transform(m_state, data, 1);
+#endif
+
     u32 blocks[80];
     for (size_t i = 0; i < 16; ++i)
         blocks[i] = AK::convert_between_host_and_network_endian(((const u32*)data)[i]);
@@ -67,15 +73,38 @@ inline void SHA1::transform(const u8* data)
     secure_zero(blocks, 16 * sizeof(u32));
 }
 
+void SHA1::transform_blocks(const u8* data, size_t block_count)
+{
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_sha_ni())
+        return SHANI::sha1_transform(m_state, data, block_count);
+#endif
+
+    for (size_t i = 0; i < block_count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA1::update(const u8* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
+    while (length > 0) {
         if (m_data_length == BlockSize) {
             transform(m_data_buffer);
             m_bit_length += 512;
             m_data_length = 0;
         }
-        m_data_buffer[m_data_length++] = message[i];
+        // Whole blocks don't have to go through the buffer, except for the last one (see SHA256::update()).
+        if (m_data_length == 0 && length > BlockSize) {
+            auto block_count = (length - 1) / BlockSize;
+            transform_blocks(message, block_count);
+            m_bit_length += block_count * BlockSize * 8;
+            message += block_count * BlockSize;
+            length -= block_count * BlockSize;
+        }
+        auto size = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, size);
+        m_data_length += size;
+        message += size;
+        length -= size;
     }
 }
 
@@ -5,7 +5,9 @@
  */
 
 #include <AK/Types.h>
+#include <LibCrypto/Hash/SHA256AVX2.h>
 #include <LibCrypto/Hash/SHA2.h>
+#include <LibCrypto/Hash/SHANI.h>
 
 namespace Crypto {
 namespace Hash {
@@ -27,6 +29,11 @@ constexpr static auto SIGN1(u64 x) { return ROTRIGHT(x, 19) ^ ROTRIGHT(x, 61) ^
 
 inline void SHA256::transform(const u8* data)
 {
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_sha_ni())
+        return SHANI::sha256_transform(m_state, data, 1);
+#endif
+
     u32 m[64];
 
     size_t i = 0;
@@ -66,17 +73,154 @@ inline void SHA256::transform(const u8* data)
     m_state[7] += h;
 }
 
+void SHA256::transform_blocks(const u8* data, size_t block_count)
+{
+#if CRYPTO_HAS_X86_ACCELERATION
+    if (has_sha_ni())
+        return SHANI::sha256_transform(m_state, data, block_count);
+#endif
+
+    for (size_t i = 0; i < block_count; ++i)
+        transform(data + i * BlockSize);
+}
+
 void SHA256::update(const u8* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
+    while (length > 0) {
         if (m_data_length == BlockSize) {
             transform(m_data_buffer);
             m_bit_length += 512;
             m_data_length = 0;
         }
-        m_data_buffer[m_data_length++] = message[i];
+        // Whole blocks don't have to go through the buffer, except for the last one: the buffer is only
+        // transformed once more data comes in, as peek() wants to find it full if that's all there is.
+        if (m_data_length == 0 && length > BlockSize) {
+            auto block_count = (length - 1) / BlockSize;
+            transform_blocks(message, block_count);
+            m_bit_length += block_count * BlockSize * 8;
+            message += block_count * BlockSize;
+            length -= block_count * BlockSize;
+        }
+        auto size = min(length, BlockSize - m_data_length);
+        __builtin_memcpy(m_data_buffer + m_data_length, message, size);
+        m_data_length += size;
+        message += size;
+        length -= size;
+    }
+}
+
+#if CRYPTO_HAS_X86_ACCELERATION
+namespace {
+
+// A message that is being hashed in one of the lanes.
+struct SHA256Lane {
+    size_t message_index { 0 };
+    const u8* data { nullptr };
+    size_t data_blocks_left { 0 };
+    // The part of the message that doesn't fill a whole block, with the padding and the length after it.
+    u8 tail[2 * SHA256::BlockSize];
+    const u8* tail_block { nullptr };
+    size_t tail_blocks_left { 0 };
+};
+
+}
+
+static void hash_many_in_lanes(Span<ReadonlyBytes const> messages, Span<SHA256::DigestType> digests)
+{
+    constexpr auto lane_count = AVX2::sha256_lane_count;
+    constexpr auto block_size = SHA256::BlockSize;
+
+    u32 states[8][lane_count];
+    SHA256Lane lanes[lane_count];
+    bool is_lane_active[lane_count] {};
+    // Lanes that have run out of messages still go through the motions.
+    const u8 idle_block[block_size] {};
+    size_t next_message_index = 0;
+
+    auto start_next_message = [&](size_t lane_index) {
+        if (next_message_index == messages.size()) {
+            is_lane_active[lane_index] = false;
+            return;
+        }
+        auto& lane = lanes[lane_index];
+        auto message = messages[next_message_index];
+        lane.message_index = next_message_index++;
+        lane.data = message.data();
+        lane.data_blocks_left = message.size() / block_size;
+
+        auto rest = message.size() % block_size;
+        __builtin_memset(lane.tail, 0, sizeof(lane.tail));
+        if (rest != 0)
+            __builtin_memcpy(lane.tail, message.data() + message.size() - rest, rest);
+        lane.tail[rest] = 0x80;
+        lane.tail_blocks_left = rest < block_size - 8 ? 1 : 2;
+        u64 bit_length = message.size() * 8;
+        auto* length_end = lane.tail + lane.tail_blocks_left * block_size;
+        for (size_t i = 1; i <= 8; ++i, bit_length >>= 8)
+            length_end[-i] = static_cast<u8>(bit_length);
+        lane.tail_block = lane.tail;
+
+        for (size_t i = 0; i < 8; ++i)
+            states[i][lane_index] = SHA256Constants::InitializationHashes[i];
+        is_lane_active[lane_index] = true;
+    };
+
+    for (size_t lane = 0; lane < lane_count; ++lane)
+        start_next_message(lane);
+
+    for (;;) {
+        const u8* blocks[lane_count];
+        bool has_active_lanes = false;
+        for (size_t i = 0; i < lane_count; ++i) {
+            auto& lane = lanes[i];
+            if (!is_lane_active[i])
+                blocks[i] = idle_block;
+            else
+                blocks[i] = lane.data_blocks_left != 0 ? lane.data : lane.tail_block;
+            has_active_lanes |= is_lane_active[i];
+        }
+        if (!has_active_lanes)
+            break;
+
+        AVX2::sha256_transform_lanes(states, blocks);
+
+        for (size_t i = 0; i < lane_count; ++i) {
+            auto& lane = lanes[i];
+            if (!is_lane_active[i])
+                continue;
+            if (lane.data_blocks_left != 0) {
+                lane.data += block_size;
+                --lane.data_blocks_left;
+                continue;
+            }
+            lane.tail_block += block_size;
+            if (--lane.tail_blocks_left != 0)
+                continue;
+
+            auto& digest = digests[lane.message_index];
+            for (size_t word = 0; word < 8; ++word) {
+                for (size_t byte = 0; byte < 4; ++byte)
+                    digest.data[word * 4 + byte] = (states[word][i] >> (24 - byte * 8)) & 0x000000ff;
+            }
+            start_next_message(i);
+        }
     }
 }
+#endif
+
+void SHA256::hash_many(Span<ReadonlyBytes const> messages, Span<DigestType> digests)
+{
+    VERIFY(messages.size() == digests.size());
+
+#if CRYPTO_HAS_X86_ACCELERATION
+    // A single message at a time with the SHA extensions beats eight of them at a time with AVX2.
+    if (!has_sha_ni() && has_avx2() && messages.size() > 1)
+        return hash_many_in_lanes(messages, digests);
+#endif
+
+    for (size_t i = 0; i < messages.size(); ++i)
+        digests[i] = hash(messages[i].data(), messages[i].size());
+}
 
 SHA256::DigestType SHA256::digest()
 {
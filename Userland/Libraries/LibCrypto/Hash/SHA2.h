@@ -100,6 +100,9 @@ public:
     inline static DigestType hash(const ByteBuffer& buffer) { return hash(buffer.data(), buffer.size()); }
     inline static DigestType hash(StringView buffer) { return hash((const u8*)buffer.characters_without_null_termination(), buffer.length()); }
 
+    // Hashes a number of independent messages, several of them at once if the CPU can.
+    static void hash_many(Span<ReadonlyBytes const> messages, Span<DigestType> digests);
+
 #ifndef KERNEL
     virtual String class_name() const override
     {
@@ -117,6 +120,7 @@ public:
 
 private:
     inline void transform(const u8*);
+    void transform_blocks(const u8*, size_t block_count);
 
     u8 m_data_buffer[BlockSize] {};
     size_t m_data_length { 0 };
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/Hash/SHA256AVX2.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+
+#    include <AK/Endian.h>
+#    include <LibCrypto/Hash/SHA2.h>
+#    include <immintrin.h>
+
+#    define AVX2_FUNCTION [[gnu::target("avx2")]]
+
+namespace Crypto {
+namespace Hash {
+namespace AVX2 {
+
+template<int Bits>
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i rotate_right(__m256i value)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(value, Bits), _mm256_slli_epi32(value, 32 - Bits));
+}
+
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i exclusive_or(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i choose(__m256i x, __m256i y, __m256i z) { return exclusive_or(_mm256_and_si256(x, y), _mm256_andnot_si256(x, z)); }
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i majority(__m256i x, __m256i y, __m256i z) { return _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y))); }
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i big_sigma0(__m256i x) { return exclusive_or(exclusive_or(rotate_right<2>(x), rotate_right<13>(x)), rotate_right<22>(x)); }
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i big_sigma1(__m256i x) { return exclusive_or(exclusive_or(rotate_right<6>(x), rotate_right<11>(x)), rotate_right<25>(x)); }
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i small_sigma0(__m256i x) { return exclusive_or(exclusive_or(rotate_right<7>(x), rotate_right<18>(x)), _mm256_srli_epi32(x, 3)); }
+AVX2_FUNCTION [[gnu::always_inline]] static inline __m256i small_sigma1(__m256i x) { return exclusive_or(exclusive_or(rotate_right<17>(x), rotate_right<19>(x)), _mm256_srli_epi32(x, 10)); }
+
+// Word `index` of every lane's block.
+AVX2_FUNCTION static __m256i load_message_words(u8 const* const (&blocks)[sha256_lane_count], size_t index)
+{
+    auto word = [&](size_t lane) {
+        u32 value;
+        __builtin_memcpy(&value, blocks[lane] + index * 4, sizeof(value));
+        return static_cast<int>(AK::convert_between_host_and_big_endian(value));
+    };
+    return _mm256_setr_epi32(word(0), word(1), word(2), word(3), word(4), word(5), word(6), word(7));
+}
+
+AVX2_FUNCTION void sha256_transform_lanes(u32 (&states)[8][sha256_lane_count], u8 const* const (&blocks)[sha256_lane_count])
+{
+    __m256i state[8];
+    for (size_t i = 0; i < 8; ++i)
+        state[i] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(states[i]));
+
+    // Only the last 16 message words are needed at any point.
+    __m256i message[16];
+    for (size_t i = 0; i < 16; ++i)
+        message[i] = load_message_words(blocks, i);
+
+    auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+    for (size_t i = 0; i < 64; ++i) {
+        if (i >= 16)
+            message[i % 16] = add(add(small_sigma1(message[(i - 2) % 16]), message[(i - 7) % 16]), add(small_sigma0(message[(i - 15) % 16]), message[i % 16]));
+        auto temp0 = add(add(h, big_sigma1(e)), add(choose(e, f, g), add(_mm256_set1_epi32(static_cast<int>(SHA256Constants::RoundConstants[i])), message[i % 16])));
+        auto temp1 = add(big_sigma0(a), majority(a, b, c));
+        h = g;
+        g = f;
+        f = e;
+        e = add(d, temp0);
+        d = c;
+        c = b;
+        b = a;
+        a = add(temp0, temp1);
+    }
+
+    state[0] = add(state[0], a);
+    state[1] = add(state[1], b);
+    state[2] = add(state[2], c);
+    state[3] = add(state[3], d);
+    state[4] = add(state[4], e);
+    state[5] = add(state[5], f);
+    state[6] = add(state[6], g);
+    state[7] = add(state[7], h);
+    for (size_t i = 0; i < 8; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(states[i]), state[i]);
+}
+
+}
+}
+}
+
+#endif
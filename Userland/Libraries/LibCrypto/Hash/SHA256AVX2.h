@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+
+// The SHA-256 compression function for eight independent messages at once, one in each 32-bit lane of the AVX2 registers.
+// It must only be called if has_avx2().
+namespace Crypto {
+namespace Hash {
+namespace AVX2 {
+
+static constexpr size_t sha256_lane_count = 8;
+
+// `states[i][lane]` is word i of the state of the message in that lane, and `blocks[lane]` is the block to run it over.
+void sha256_transform_lanes(u32 (&states)[8][sha256_lane_count], u8 const* const (&blocks)[sha256_lane_count]);
+
+}
+}
+}
+
+#endif
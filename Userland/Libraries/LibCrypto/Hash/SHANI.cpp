@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/Hash/SHANI.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+
+#    include <LibCrypto/Hash/SHA2.h>
+#    include <immintrin.h>
+
+#    define SHANI_FUNCTION [[gnu::target("sha,sse4.1")]]
+
+namespace Crypto {
+namespace Hash {
+namespace SHANI {
+
+// The message words are big endian.
+SHANI_FUNCTION static __m128i load_message(u8 const* data, __m128i byte_swap_mask)
+{
+    return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data)), byte_swap_mask);
+}
+
+// Rounds 4 * Group to 4 * Group + 3 of SHA-1. `current` holds the message words for these rounds, and the other three
+// are the following ones, whose computation is interleaved with the rounds (Intel's "SHA Extensions" paper, figure 4).
+template<size_t Group>
+SHANI_FUNCTION [[gnu::always_inline]] static inline void sha1_four_rounds(__m128i& abcd, __m128i& e, __m128i& next_e, __m128i& current, __m128i& next, __m128i& after_next, __m128i& previous)
+{
+    if constexpr (Group == 0)
+        e = _mm_add_epi32(e, current);
+    else
+        e = _mm_sha1nexte_epu32(e, current);
+    next_e = abcd;
+    if constexpr (Group >= 3 && Group <= 18)
+        next = _mm_sha1msg2_epu32(next, current);
+    abcd = _mm_sha1rnds4_epu32(abcd, e, Group / 5);
+    if constexpr (Group >= 1 && Group <= 16)
+        previous = _mm_sha1msg1_epu32(previous, current);
+    if constexpr (Group >= 2 && Group <= 17)
+        after_next = _mm_xor_si128(after_next, current);
+}
+
+SHANI_FUNCTION void sha1_transform(u32 (&state)[5], u8 const* data, size_t block_count)
+{
+    auto const byte_swap_mask = _mm_set_epi64x(0x0001020304050607ull, 0x08090a0b0c0d0e0full);
+
+    // The instructions want A in the highest word, and E on its own in the highest word of another register.
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<__m128i const*>(state)), 0x1b);
+    auto e0 = _mm_set_epi32(static_cast<int>(state[4]), 0, 0, 0);
+    __m128i e1;
+
+    for (size_t block = 0; block < block_count; ++block, data += 64) {
+        auto saved_abcd = abcd;
+        auto saved_e = e0;
+
+        auto m0 = load_message(data, byte_swap_mask);
+        auto m1 = load_message(data + 16, byte_swap_mask);
+        auto m2 = load_message(data + 32, byte_swap_mask);
+        auto m3 = load_message(data + 48, byte_swap_mask);
+
+        sha1_four_rounds<0>(abcd, e0, e1, m0, m1, m2, m3);
+        sha1_four_rounds<1>(abcd, e1, e0, m1, m2, m3, m0);
+        sha1_four_rounds<2>(abcd, e0, e1, m2, m3, m0, m1);
+        sha1_four_rounds<3>(abcd, e1, e0, m3, m0, m1, m2);
+        sha1_four_rounds<4>(abcd, e0, e1, m0, m1, m2, m3);
+        sha1_four_rounds<5>(abcd, e1, e0, m1, m2, m3, m0);
+        sha1_four_rounds<6>(abcd, e0, e1, m2, m3, m0, m1);
+        sha1_four_rounds<7>(abcd, e1, e0, m3, m0, m1, m2);
+        sha1_four_rounds<8>(abcd, e0, e1, m0, m1, m2, m3);
+        sha1_four_rounds<9>(abcd, e1, e0, m1, m2, m3, m0);
+        sha1_four_rounds<10>(abcd, e0, e1, m2, m3, m0, m1);
+        sha1_four_rounds<11>(abcd, e1, e0, m3, m0, m1, m2);
+        sha1_four_rounds<12>(abcd, e0, e1, m0, m1, m2, m3);
+        sha1_four_rounds<13>(abcd, e1, e0, m1, m2, m3, m0);
+        sha1_four_rounds<14>(abcd, e0, e1, m2, m3, m0, m1);
+        sha1_four_rounds<15>(abcd, e1, e0, m3, m0, m1, m2);
+        sha1_four_rounds<16>(abcd, e0, e1, m0, m1, m2, m3);
+        sha1_four_rounds<17>(abcd, e1, e0, m1, m2, m3, m0);
+        sha1_four_rounds<18>(abcd, e0, e1, m2, m3, m0, m1);
+        sha1_four_rounds<19>(abcd, e1, e0, m3, m0, m1, m2);
+
+        // E is only rotated into place by the next SHA1NEXTE, which takes care of adding the saved one as well.
+        e0 = _mm_sha1nexte_epu32(e0, saved_e);
+        abcd = _mm_add_epi32(abcd, saved_abcd);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = static_cast<u32>(_mm_extract_epi32(e0, 3));
+}
+
+// Rounds 4 * Group to 4 * Group + 3 of SHA-256, computing the message words of later rounds along the way
+// (Intel's "SHA Extensions" paper, figure 5).
+template<size_t Group>
+SHANI_FUNCTION [[gnu::always_inline]] static inline void sha256_four_rounds(__m128i& abef, __m128i& cdgh, __m128i& current, __m128i& next, __m128i& previous)
+{
+    auto message = _mm_add_epi32(current, _mm_loadu_si128(reinterpret_cast<__m128i const*>(&SHA256Constants::RoundConstants[Group * 4])));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+    if constexpr (Group >= 3 && Group <= 14) {
+        next = _mm_add_epi32(next, _mm_alignr_epi8(current, previous, 4));
+        next = _mm_sha256msg2_epu32(next, current);
+    }
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(message, 0x0e));
+    if constexpr (Group >= 1 && Group <= 12)
+        previous = _mm_sha256msg1_epu32(previous, current);
+}
+
+SHANI_FUNCTION void sha256_transform(u32 (&state)[8], u8 const* data, size_t block_count)
+{
+    auto const byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+    // The instructions keep the state as ABEF and CDGH, from the highest word to the lowest.
+    auto dcba = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state));
+    auto hgfe = _mm_loadu_si128(reinterpret_cast<__m128i const*>(state + 4));
+    auto cdab = _mm_shuffle_epi32(dcba, 0xb1);
+    auto efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+    auto abef = _mm_alignr_epi8(cdab, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for (size_t block = 0; block < block_count; ++block, data += 64) {
+        auto saved_abef = abef;
+        auto saved_cdgh = cdgh;
+
+        auto m0 = load_message(data, byte_swap_mask);
+        auto m1 = load_message(data + 16, byte_swap_mask);
+        auto m2 = load_message(data + 32, byte_swap_mask);
+        auto m3 = load_message(data + 48, byte_swap_mask);
+
+        sha256_four_rounds<0>(abef, cdgh, m0, m1, m3);
+        sha256_four_rounds<1>(abef, cdgh, m1, m2, m0);
+        sha256_four_rounds<2>(abef, cdgh, m2, m3, m1);
+        sha256_four_rounds<3>(abef, cdgh, m3, m0, m2);
+        sha256_four_rounds<4>(abef, cdgh, m0, m1, m3);
+        sha256_four_rounds<5>(abef, cdgh, m1, m2, m0);
+        sha256_four_rounds<6>(abef, cdgh, m2, m3, m1);
+        sha256_four_rounds<7>(abef, cdgh, m3, m0, m2);
+        sha256_four_rounds<8>(abef, cdgh, m0, m1, m3);
+        sha256_four_rounds<9>(abef, cdgh, m1, m2, m0);
+        sha256_four_rounds<10>(abef, cdgh, m2, m3, m1);
+        sha256_four_rounds<11>(abef, cdgh, m3, m0, m2);
+        sha256_four_rounds<12>(abef, cdgh, m0, m1, m3);
+        sha256_four_rounds<13>(abef, cdgh, m1, m2, m0);
+        sha256_four_rounds<14>(abef, cdgh, m2, m3, m1);
+        sha256_four_rounds<15>(abef, cdgh, m3, m0, m2);
+
+        abef = _mm_add_epi32(abef, saved_abef);
+        cdgh = _mm_add_epi32(cdgh, saved_cdgh);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if CRYPTO_HAS_X86_ACCELERATION
+
+// The SHA-1 and SHA-256 compression functions using the SHA extensions, which must only be called if has_sha_ni().
+// Both take the state the way SHA1 and SHA256 keep it, and run it over `block_count` consecutive blocks.
+namespace Crypto {
+namespace Hash {
+namespace SHANI {
+
+void sha1_transform(u32 (&state)[5], u8 const* data, size_t block_count);
+void sha256_transform(u32 (&state)[8], u8 const* data, size_t block_count);
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Math.h>
+#include <AK/Span.h>
+
+namespace LibDSP {
+
+// The (unnormalized) DCT-II: X[k] = sum over n of x[n] * cos(pi / N * (n + 1/2) * k).
+// Even sizes are split into two transforms of half the size (Byeong Gi Lee's algorithm), which is O(N log N) for
+// powers of two. Odd sizes are computed directly.
+template<size_t N>
+class DCT;
+
+template<size_t N>
+requires(N % 2 == 1) class DCT<N> {
+public:
+    DCT()
+    {
+        for (size_t k = 0; k < N; k++) {
+            for (size_t n = 0; n < N; n++)
+                m_phi[k][n] = AK::cos(AK::Pi<double> / N * (n + 0.5) * k);
+        }
+    }
+
+    void transform(Span<double> data) const
+    {
+        VERIFY(data.size() == N);
+        Array<double, N> input;
+        for (size_t n = 0; n < N; n++)
+            input[n] = data[n];
+        for (size_t k = 0; k < N; k++) {
+            double sum = 0;
+            for (size_t n = 0; n < N; n++)
+                sum += input[n] * m_phi[k][n];
+            data[k] = sum;
+        }
+    }
+
+private:
+    Array<Array<double, N>, N> m_phi;
+};
+
+template<size_t N>
+requires(N % 2 == 0) class DCT<N> {
+public:
+    DCT()
+    {
+        for (size_t n = 0; n < N / 2; n++)
+            m_inverse_cosines[n] = 1 / (2 * AK::cos(AK::Pi<double> / N * (n + 0.5)));
+    }
+
+    void transform(Span<double> data) const
+    {
+        VERIFY(data.size() == N);
+        // The even outputs are the half-size transform of the sums of mirrored inputs, and the odd outputs come
+        // from the half-size transform of their (scaled) differences.
+        Array<double, N / 2> sums;
+        Array<double, N / 2> differences;
+        for (size_t n = 0; n < N / 2; n++) {
+            sums[n] = data[n] + data[N - 1 - n];
+            differences[n] = (data[n] - data[N - 1 - n]) * m_inverse_cosines[n];
+        }
+        m_half.transform(sums);
+        m_half.transform(differences);
+        for (size_t k = 0; k < N / 2 - 1; k++) {
+            data[2 * k] = sums[k];
+            data[2 * k + 1] = differences[k] + differences[k + 1];
+        }
+        data[N - 2] = sums[N / 2 - 1];
+        data[N - 1] = differences[N / 2 - 1];
+    }
+
+private:
+    Array<double, N / 2> m_inverse_cosines;
+    DCT<N / 2> m_half;
+};
+
+}
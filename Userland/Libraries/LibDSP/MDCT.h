@@ -9,35 +9,50 @@
 #include <AK/Array.h>
 #include <AK/Math.h>
 #include <AK/Span.h>
+#include <LibDSP/DCT.h>
 
 namespace LibDSP {
 
+// The inverse MDCT: output[n] = sum over k of data[k] * cos(pi / (2 * N) * (2 * n + 1 + N / 2) * (2 * k + 1)).
+// The N outputs are all (mirrored and negated) values of a DCT-IV of the N / 2 inputs, and that DCT-IV is
+// computed with a DCT-II of the same size.
 template<size_t N>
-requires(N % 2 == 0) class MDCT {
+requires(N % 4 == 0) class MDCT {
 public:
-    constexpr MDCT()
+    MDCT()
     {
-        for (size_t n = 0; n < N; n++) {
-            for (size_t k = 0; k < N / 2; k++) {
-                m_phi[n][k] = AK::cos(AK::Pi<double> / (2 * N) * (2 * n + 1 + N / 2.0) * (2 * k + 1));
-            }
-        }
+        for (size_t n = 0; n < M; n++)
+            m_twiddles[n] = 2 * AK::cos(AK::Pi<double> / (2 * M) * (n + 0.5));
     }
 
-    void transform(Span<double const> data, Span<double> output)
+    void transform(Span<double const> data, Span<double> output) const
     {
-        assert(N == 2 * data.size());
-        assert(N == output.size());
-        for (size_t n = 0; n < N; n++) {
-            output[n] = 0;
-            for (size_t k = 0; k < N / 2; k++) {
-                output[n] += data[k] * m_phi[n][k];
-            }
-        }
+        VERIFY(N == 2 * data.size());
+        VERIFY(N == output.size());
+
+        // 2 * cos(a) * cos(b) = cos(b + a) + cos(b - a) turns the DCT-II of the twiddled input into the sum of two
+        // neighboring DCT-IV outputs, that is dct_ii[k] = dct_iv[k] + dct_iv[k - 1] (where dct_iv[-1] = dct_iv[0]).
+        Array<double, M> dct_iv;
+        for (size_t n = 0; n < M; n++)
+            dct_iv[n] = data[n] * m_twiddles[n];
+        m_dct.transform(dct_iv);
+        dct_iv[0] /= 2;
+        for (size_t k = 1; k < M; k++)
+            dct_iv[k] -= dct_iv[k - 1];
+
+        for (size_t n = 0; n < M / 2; n++)
+            output[n] = dct_iv[n + M / 2];
+        for (size_t n = M / 2; n < 3 * M / 2; n++)
+            output[n] = -dct_iv[3 * M / 2 - 1 - n];
+        for (size_t n = 3 * M / 2; n < N; n++)
+            output[n] = -dct_iv[n - 3 * M / 2];
     }
 
 private:
-    Array<Array<double, N / 2>, N> m_phi;
+    static constexpr size_t M = N / 2;
+
+    Array<double, M> m_twiddles;
+    DCT<M> m_dct;
 };
 
 }
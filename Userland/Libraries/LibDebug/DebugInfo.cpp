@@ -120,13 +120,19 @@ Optional<DebugInfo::SourcePosition> DebugInfo::get_source_position(FlatPtr targe
     if (target_address < m_sorted_lines[0].address)
         return {};
 
-    // TODO: We can do a binary search here
-    for (size_t i = 0; i < m_sorted_lines.size() - 1; ++i) {
-        if (m_sorted_lines[i + 1].address > target_address) {
-            return SourcePosition::from_line_info(m_sorted_lines[i]);
-        }
+    // Find the first line past the target address; the line before it is the one containing it.
+    size_t begin = 0;
+    size_t end = m_sorted_lines.size();
+    while (begin < end) {
+        size_t middle = begin + (end - begin) / 2;
+        if (m_sorted_lines[middle].address > target_address)
+            end = middle;
+        else
+            begin = middle + 1;
     }
-    return {};
+    if (begin == m_sorted_lines.size())
+        return {};
+    return SourcePosition::from_line_info(m_sorted_lines[begin - 1]);
 }
 
 Optional<DebugInfo::SourcePositionAndAddress> DebugInfo::get_address_from_source_position(String const& file, size_t line) const
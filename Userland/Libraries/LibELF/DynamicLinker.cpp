@@ -60,7 +60,13 @@ static Result<void*, DlErrorMessage> __dlopen(const char* filename, int flags);
 static Result<void*, DlErrorMessage> __dlsym(void* handle, const char* symbol_name);
 static Result<void, DlErrorMessage> __dladdr(void* addr, Dl_info* info);
 
-Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(StringView name)
+// Relocating a set of libraries looks up the same symbols (malloc, strlen, ...) over and over, and every lookup walks all the global objects.
+// While the libraries are being linked, the global objects don't change, so the results are remembered until linking is done.
+// NOTE: The keys point into the string tables of loaded objects, which stay mapped.
+static HashMap<StringView, Optional<DynamicObject::SymbolLookupResult>> s_global_symbol_cache;
+static bool s_global_symbol_cache_enabled { false };
+
+static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol_uncached(StringView name)
 {
     Optional<DynamicObject::SymbolLookupResult> weak_result;
 
@@ -79,6 +85,25 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return weak_result;
 }
 
+static void disable_global_symbol_cache()
+{
+    s_global_symbol_cache_enabled = false;
+    s_global_symbol_cache.clear();
+}
+
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(StringView name)
+{
+    if (!s_global_symbol_cache_enabled)
+        return lookup_global_symbol_uncached(name);
+
+    if (auto cached_result = s_global_symbol_cache.get(name); cached_result.has_value())
+        return cached_result.release_value();
+
+    auto result = lookup_global_symbol_uncached(name);
+    s_global_symbol_cache.set(name, result);
+    return result;
+}
+
 static String get_library_name(String path)
 {
     return LexicalPath::basename(move(path));
@@ -319,6 +344,10 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> load_main_library(co
             s_global_objects.set(dynamic_object->filename(), *dynamic_object);
     }
 
+    // Nothing is added to the global objects until we're done relocating, see s_global_symbol_cache.
+    s_global_symbol_cache_enabled = true;
+    ScopeGuard disable_cache_guard = [] { disable_global_symbol_cache(); };
+
     for (auto& loader : loaders) {
         bool success = loader.link(flags);
         if (!success) {
@@ -345,6 +374,9 @@ static Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> load_main_library(co
         }
     }
 
+    // Initializers may dlopen() more libraries, which adds global objects.
+    disable_global_symbol_cache();
+
     for (auto& loader : loaders) {
         loader.load_stage_4();
     }
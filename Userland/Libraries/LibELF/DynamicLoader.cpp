@@ -53,6 +53,9 @@ Result<NonnullRefPtr<DynamicLoader>, DlErrorMessage> DynamicLoader::try_create(i
     if (data == MAP_FAILED) {
         return DlErrorMessage { "DynamicLoader::try_create mmap" };
     }
+    // NOTE: This mapping is only used to look at the headers, the segments get mapped separately.
+    //       Don't let the first fault read ahead into the rest of the file.
+    (void)madvise(data, size, MADV_RANDOM);
 
     auto loader = adopt_ref(*new DynamicLoader(fd, move(filename), data, size));
     if (!loader->is_valid())
@@ -199,7 +202,16 @@ void DynamicLoader::do_main_relocations()
         }
     };
 
-    m_dynamic_object->relocation_section().for_each_relocation(do_single_relocation);
+    auto relocation_section = m_dynamic_object->relocation_section();
+    size_t relative_relocation_count = min(m_dynamic_object->relative_relocation_count(), static_cast<size_t>(relocation_section.relocation_count()));
+    do_relative_relocations(relocation_section, relative_relocation_count);
+    for (size_t i = relative_relocation_count; i < relocation_section.relocation_count(); ++i) {
+        auto relocation = relocation_section.relocation(i);
+        if (relocation.type() == 0)
+            continue;
+        do_single_relocation(relocation);
+    }
+
     m_dynamic_object->plt_relocation_section().for_each_relocation(do_single_relocation);
     do_relr_relocations();
 }
@@ -375,20 +387,44 @@ void DynamicLoader::load_program_headers()
 
         auto* data_segment_address = (u8*)reservation + ph_data_base - ph_load_base;
         size_t data_segment_size = ph_data_end - ph_data_base;
+        auto data_segment_name = String::formatted("{}: .data", m_filename);
+
+        // The part of the segment that's in the file is mapped privately instead of being copied, so that pages
+        // nobody touches (or only reads) aren't dirtied in every process. Only the rest, the .bss, is anonymous memory.
+        size_t file_backed_size = 0;
+        if (region.size_in_image() != 0)
+            file_backed_size = min(data_segment_size, round_up_to_power_of_two(region.desired_load_address().get() - ph_data_base + region.size_in_image(), PAGE_SIZE));
+
+        if (file_backed_size != 0) {
+            auto* file_backed_data = (u8*)mmap_with_name(
+                data_segment_address,
+                file_backed_size,
+                PROT_READ | PROT_WRITE,
+                MAP_FILE | MAP_PRIVATE | MAP_FIXED,
+                m_image_fd,
+                VirtualAddress { region.offset() }.page_base().get(),
+                data_segment_name.characters());
+
+            if (MAP_FAILED == file_backed_data) {
+                perror("mmap writable");
+                VERIFY_NOT_REACHED();
+            }
+        }
 
-        // Finally, we make an anonymous mapping for the data segment. Contents are then copied from the file.
-        auto* data_segment = (u8*)mmap_with_name(
-            data_segment_address,
-            data_segment_size,
-            PROT_READ | PROT_WRITE,
-            MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED,
-            0,
-            0,
-            String::formatted("{}: .data", m_filename).characters());
-
-        if (MAP_FAILED == data_segment) {
-            perror("mmap writable");
-            VERIFY_NOT_REACHED();
+        if (data_segment_size > file_backed_size) {
+            auto* anonymous_data = (u8*)mmap_with_name(
+                data_segment_address + file_backed_size,
+                data_segment_size - file_backed_size,
+                PROT_READ | PROT_WRITE,
+                MAP_ANONYMOUS | MAP_PRIVATE | MAP_FIXED,
+                0,
+                0,
+                data_segment_name.characters());
+
+            if (MAP_FAILED == anonymous_data) {
+                perror("mmap writable");
+                VERIFY_NOT_REACHED();
+            }
         }
 
         VirtualAddress data_segment_start;
@@ -397,9 +433,13 @@ void DynamicLoader::load_program_headers()
         else
             data_segment_start = region.desired_load_address();
 
-        VERIFY(data_segment_start.as_ptr() + region.size_in_memory() <= data_segment + data_segment_size);
+        VERIFY(data_segment_start.as_ptr() + region.size_in_memory() <= data_segment_address + data_segment_size);
 
-        memcpy(data_segment_start.as_ptr(), (u8*)m_file_data + region.offset(), region.size_in_image());
+        // Whatever follows the segment in the last file-backed page isn't part of it, and is either .bss or nothing at all.
+        auto* file_backed_end = data_segment_address + file_backed_size;
+        auto* data_in_image_end = data_segment_start.as_ptr() + region.size_in_image();
+        if (data_in_image_end < file_backed_end)
+            memset(data_in_image_end, 0, file_backed_end - data_in_image_end);
     }
 
     // FIXME: Initialize the values in the TLS section. Currently, it is zeroed.
@@ -480,9 +520,7 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
 #else
     case R_X86_64_RELATIVE: {
 #endif
-        // FIXME: According to the spec, R_386_relative ones must be done first.
-        //     We could explicitly do them first using m_number_of_relocations from DT_RELCOUNT
-        //     However, our compiler is nice enough to put them at the front of the relocations for us :)
+        // NOTE: The ones counted by DT_RELCOUNT are done up front by do_relative_relocations(), these are only the stragglers.
         if (relocation.addend_used())
             *patch_ptr = m_dynamic_object->base_address().offset(relocation.addend()).get();
         else
@@ -539,6 +577,28 @@ DynamicLoader::RelocationResult DynamicLoader::do_relocation(const ELF::DynamicO
     return RelocationResult::Success;
 }
 
+void DynamicLoader::do_relative_relocations(DynamicObject::RelocationSection const& section, size_t count)
+{
+    // These make up most of the relocations of a library, and they never need a symbol lookup, so skip the generic path for them.
+    auto base_address = m_dynamic_object->base_address().get();
+    auto* relocations = section.address().as_ptr();
+    auto entry_size = section.entry_size();
+    auto patch_base_address = is_dynamic() ? base_address : 0;
+    for (size_t i = 0; i < count; ++i) {
+        auto const& relocation = *reinterpret_cast<ElfW(Rela) const*>(relocations + i * entry_size);
+#if ARCH(I386)
+        VERIFY(ELF32_R_TYPE(relocation.r_info) == R_386_RELATIVE);
+#else
+        VERIFY(ELF64_R_TYPE(relocation.r_info) == R_X86_64_RELATIVE);
+#endif
+        auto* patch_ptr = reinterpret_cast<FlatPtr*>(patch_base_address + relocation.r_offset);
+        if (section.addend_used())
+            *patch_ptr = base_address + relocation.r_addend;
+        else
+            *patch_ptr += base_address;
+    }
+}
+
 void DynamicLoader::do_relr_relocations()
 {
     auto base_address = m_dynamic_object->base_address().get();
@@ -141,6 +141,7 @@ public:
         {
         }
         unsigned relocation_count() const { return entry_count(); }
+        bool addend_used() const { return m_addend_used; }
         Relocation relocation(unsigned index) const;
         Relocation relocation_at_offset(unsigned offset) const;
 
@@ -275,6 +276,9 @@ public:
     RelocationSection plt_relocation_section() const;
     Section relr_relocation_section() const;
 
+    // The number of relative relocations at the start of the relocation section, from DT_RELCOUNT/DT_RELACOUNT.
+    size_t relative_relocation_count() const { return m_number_of_relocations; }
+
     bool should_process_origin() const { return m_dt_flags & DF_ORIGIN; }
     bool requires_symbolic_symbol_resolution() const { return m_dt_flags & DF_SYMBOLIC; }
     // Text relocations meaning: we need to edit the .text section which is normally mapped PROT_READ
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibGL/Buffer/Buffer.h>
+
+namespace GL {
+
+ErrorOr<void> Buffer::set_data(void const* data, size_t size, GLenum usage)
+{
+    auto buffer = TRY(ByteBuffer::create_zeroed(size));
+    if (data)
+        buffer.overwrite(0, data, size);
+    m_data = move(buffer);
+    m_usage = usage;
+    return {};
+}
+
+void Buffer::replace_data(void const* data, size_t offset, size_t size)
+{
+    VERIFY(offset + size <= m_data.size());
+    m_data.overwrite(offset, data, size);
+}
+
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/RefCounted.h>
+#include <LibGL/GL/gl.h>
+
+namespace GL {
+
+// A buffer object (OpenGL 1.5 section 2.9), which keeps vertex data or indices on the GL's side so that an application
+// doesn't have to hand it over anew for every draw call.
+class Buffer : public RefCounted<Buffer> {
+public:
+    ErrorOr<void> set_data(void const* data, size_t size, GLenum usage);
+    void replace_data(void const* data, size_t offset, size_t size);
+
+    size_t size() const { return m_data.size(); }
+    GLenum usage() const { return m_usage; }
+
+    // Attribute pointers and index arrays point into a bound buffer by offset.
+    void const* offset_data(size_t offset) const { return m_data.data() + offset; }
+
+private:
+    ByteBuffer m_data;
+    GLenum m_usage { GL_STATIC_DRAW };
+};
+
+}
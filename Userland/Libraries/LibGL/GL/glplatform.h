@@ -40,3 +40,5 @@ typedef float GLclampf;
 typedef double GLdouble;
 typedef unsigned int GLenum;
 typedef unsigned int GLbitfield;
+typedef long GLintptr;
+typedef long GLsizeiptr;
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "GLContext.h"
+#include <LibGL/GL/gl.h>
+
+extern GL::GLContext* g_gl_context;
+
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    g_gl_context->gl_gen_buffers(n, buffers);
+}
+
+void glDeleteBuffers(GLsizei n, GLuint const* buffers)
+{
+    g_gl_context->gl_delete_buffers(n, buffers);
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    g_gl_context->gl_bind_buffer(target, buffer);
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, void const* data, GLenum usage)
+{
+    g_gl_context->gl_buffer_data(target, size, data, usage);
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, void const* data)
+{
+    g_gl_context->gl_buffer_sub_data(target, offset, size, data);
+}
+
+GLboolean glIsBuffer(GLuint buffer)
+{
+    return g_gl_context->gl_is_buffer(buffer);
+}
+
+void glGetBufferParameteriv(GLenum target, GLenum value, GLint* data)
+{
+    g_gl_context->gl_get_buffer_parameter(target, value, data);
+}
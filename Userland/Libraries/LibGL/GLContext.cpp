@@ -126,6 +126,8 @@ Optional<ContextParameter> GLContext::get_context_parameter(GLenum name)
         return ContextParameter { .type = GL_INT, .value = { .integer_value = sizeof(float) * 8 } };
     case GL_ALPHA_TEST:
         return ContextParameter { .type = GL_BOOL, .is_capability = true, .value = { .boolean_value = m_alpha_test_enabled } };
+    case GL_ARRAY_BUFFER_BINDING:
+        return ContextParameter { .type = GL_INT, .value = { .integer_value = static_cast<GLint>(buffer_name(m_array_buffer)) } };
     case GL_BLEND:
         return ContextParameter { .type = GL_BOOL, .is_capability = true, .value = { .boolean_value = m_blend_enabled } };
     case GL_BLEND_DST_ALPHA:
@@ -150,6 +152,8 @@ Optional<ContextParameter> GLContext::get_context_parameter(GLenum name)
         return ContextParameter { .type = GL_BOOL, .is_capability = true, .value = { .boolean_value = m_dither_enabled } };
     case GL_DOUBLEBUFFER:
         return ContextParameter { .type = GL_BOOL, .value = { .boolean_value = true } };
+    case GL_ELEMENT_ARRAY_BUFFER_BINDING:
+        return ContextParameter { .type = GL_INT, .value = { .integer_value = static_cast<GLint>(buffer_name(m_element_array_buffer)) } };
     case GL_FOG: {
         auto fog_enabled = m_rasterizer.options().fog_enabled;
         return ContextParameter { .type = GL_BOOL, .is_capability = true, .value = { .boolean_value = fog_enabled } };
@@ -351,6 +355,11 @@ void GLContext::gl_end()
         RETURN_WITH_ERROR_IF(true, GL_INVALID_ENUM);
     }
 
+    draw_vertex_list(m_current_draw_mode, nullptr);
+}
+
+void GLContext::draw_vertex_list(GLenum mode, Vector<u32> const* indices)
+{
     Vector<size_t, 32> enabled_texture_units;
     for (size_t i = 0; i < m_texture_units.size(); ++i) {
         if (m_texture_units[i].texture_2d_enabled())
@@ -360,7 +369,7 @@ void GLContext::gl_end()
     sync_device_config();
 
     SoftGPU::PrimitiveType primitive_type;
-    switch (m_current_draw_mode) {
+    switch (mode) {
     case GL_TRIANGLES:
         primitive_type = SoftGPU::PrimitiveType::Triangles;
         break;
@@ -388,7 +397,10 @@ void GLContext::gl_end()
         mv_elements[0][2], mv_elements[1][2], mv_elements[2][2]);
     auto const& normal_transform = model_view_transposed.inverse();
 
-    m_rasterizer.draw_primitives(primitive_type, m_model_view_matrix, normal_transform, m_projection_matrix, m_texture_matrix, m_vertex_list, enabled_texture_units);
+    if (indices)
+        m_rasterizer.draw_primitives(primitive_type, m_model_view_matrix, normal_transform, m_projection_matrix, m_texture_matrix, m_vertex_list, *indices, enabled_texture_units);
+    else
+        m_rasterizer.draw_primitives(primitive_type, m_model_view_matrix, normal_transform, m_projection_matrix, m_texture_matrix, m_vertex_list, enabled_texture_units);
 
     m_vertex_list.clear_with_capacity();
 }
@@ -2003,7 +2015,7 @@ void GLContext::gl_vertex_pointer(GLint size, GLenum type, GLsizei stride, const
     RETURN_WITH_ERROR_IF(!(type == GL_SHORT || type == GL_INT || type == GL_FLOAT || type == GL_DOUBLE), GL_INVALID_ENUM);
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
-    m_client_vertex_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer };
+    m_client_vertex_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 void GLContext::gl_color_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer)
@@ -2021,7 +2033,7 @@ void GLContext::gl_color_pointer(GLint size, GLenum type, GLsizei stride, const
         GL_INVALID_ENUM);
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
-    m_client_color_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer };
+    m_client_color_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 void GLContext::gl_tex_coord_pointer(GLint size, GLenum type, GLsizei stride, const void* pointer)
@@ -2032,7 +2044,7 @@ void GLContext::gl_tex_coord_pointer(GLint size, GLenum type, GLsizei stride, co
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
     auto& tex_coord_pointer = m_client_tex_coord_pointer[m_client_active_texture];
-    tex_coord_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer };
+    tex_coord_pointer = { .size = size, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 void GLContext::gl_normal_pointer(GLenum type, GLsizei stride, void const* pointer)
@@ -2046,7 +2058,7 @@ void GLContext::gl_normal_pointer(GLenum type, GLsizei stride, void const* point
         GL_INVALID_ENUM);
     RETURN_WITH_ERROR_IF(stride < 0, GL_INVALID_VALUE);
 
-    m_client_normal_pointer = { .size = 3, .type = type, .stride = stride, .pointer = pointer };
+    m_client_normal_pointer = { .size = 3, .type = type, .stride = stride, .pointer = pointer, .buffer = m_array_buffer };
 }
 
 void GLContext::gl_tex_env(GLenum target, GLenum pname, GLfloat param)
@@ -2098,31 +2110,8 @@ void GLContext::gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
 
     auto last = first + count;
     gl_begin(mode);
-    for (int i = first; i < last; i++) {
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0, 0, 0, 1 };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color, true);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
-
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0, 0, 0, 0 };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords, false);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
-
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal, false);
-            gl_normal(normal[0], normal[1], normal[2]);
-        }
-
-        float vertex[4] { 0, 0, 0, 1 };
-        read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex, false);
-        gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
-    }
+    for (int i = first; i < last; i++)
+        append_vertex_from_client_arrays(i);
     gl_end();
 }
 
@@ -2151,9 +2140,31 @@ void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, const
     if (!m_client_side_vertex_array_enabled)
         return;
 
-    gl_begin(mode);
+    size_t index_size = 0;
+    switch (type) {
+    case GL_UNSIGNED_BYTE:
+        index_size = sizeof(GLubyte);
+        break;
+    case GL_UNSIGNED_SHORT:
+        index_size = sizeof(GLushort);
+        break;
+    case GL_UNSIGNED_INT:
+        index_size = sizeof(GLuint);
+        break;
+    }
+
+    // With a buffer object bound to GL_ELEMENT_ARRAY_BUFFER, `indices` is an offset into it
+    if (m_element_array_buffer) {
+        auto offset = reinterpret_cast<FlatPtr>(indices);
+        RETURN_WITH_ERROR_IF(offset + count * index_size > m_element_array_buffer->size(), GL_INVALID_OPERATION);
+        indices = m_element_array_buffer->offset_data(offset);
+    }
+
+    m_vertex_indices.clear_with_capacity();
+    u32 min_index = NumericLimits<u32>::max();
+    u32 max_index = 0;
     for (int index = 0; index < count; index++) {
-        int i = 0;
+        u32 i = 0;
         switch (type) {
         case GL_UNSIGNED_BYTE:
             i = reinterpret_cast<const GLubyte*>(indices)[index];
@@ -2165,32 +2176,50 @@ void GLContext::gl_draw_elements(GLenum mode, GLsizei count, GLenum type, const
             i = reinterpret_cast<const GLuint*>(indices)[index];
             break;
         }
+        m_vertex_indices.append(i);
+        min_index = min(min_index, i);
+        max_index = max(max_index, i);
+    }
 
-        if (m_client_side_color_array_enabled) {
-            float color[4] { 0, 0, 0, 1 };
-            read_from_vertex_attribute_pointer(m_client_color_pointer, i, color, true);
-            gl_color(color[0], color[1], color[2], color[3]);
-        }
+    if (m_vertex_indices.is_empty())
+        return;
 
-        for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
-            if (m_client_side_texture_coord_array_enabled[t]) {
-                float tex_coords[4] { 0, 0, 0, 0 };
-                read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], i, tex_coords, false);
-                gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
-            }
-        }
+    // Read every vertex between the lowest and the highest index only once, so that the device also only has to
+    // transform it once, however many primitives share it.
+    m_vertex_list.clear_with_capacity();
+    for (u32 i = min_index; i <= max_index; i++)
+        append_vertex_from_client_arrays(i);
+    for (auto& index : m_vertex_indices)
+        index -= min_index;
+
+    draw_vertex_list(mode, &m_vertex_indices);
+}
+
+void GLContext::append_vertex_from_client_arrays(int index)
+{
+    if (m_client_side_color_array_enabled) {
+        float color[4] { 0, 0, 0, 1 };
+        read_from_vertex_attribute_pointer(m_client_color_pointer, index, color, true);
+        gl_color(color[0], color[1], color[2], color[3]);
+    }
 
-        if (m_client_side_normal_array_enabled) {
-            float normal[3];
-            read_from_vertex_attribute_pointer(m_client_normal_pointer, i, normal, false);
-            gl_normal(normal[0], normal[1], normal[2]);
+    for (size_t t = 0; t < m_client_tex_coord_pointer.size(); ++t) {
+        if (m_client_side_texture_coord_array_enabled[t]) {
+            float tex_coords[4] { 0, 0, 0, 0 };
+            read_from_vertex_attribute_pointer(m_client_tex_coord_pointer[t], index, tex_coords, false);
+            gl_multi_tex_coord(GL_TEXTURE0 + t, tex_coords[0], tex_coords[1], tex_coords[2], tex_coords[3]);
         }
+    }
 
-        float vertex[4] { 0, 0, 0, 1 };
-        read_from_vertex_attribute_pointer(m_client_vertex_pointer, i, vertex, false);
-        gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
+    if (m_client_side_normal_array_enabled) {
+        float normal[3];
+        read_from_vertex_attribute_pointer(m_client_normal_pointer, index, normal, false);
+        gl_normal(normal[0], normal[1], normal[2]);
     }
-    gl_end();
+
+    float vertex[4] { 0, 0, 0, 1 };
+    read_from_vertex_attribute_pointer(m_client_vertex_pointer, index, vertex, false);
+    gl_vertex(vertex[0], vertex[1], vertex[2], vertex[3]);
 }
 
 void GLContext::gl_draw_pixels(GLsizei width, GLsizei height, GLenum format, GLenum type, const void* data)
@@ -2344,7 +2373,7 @@ void GLContext::gl_depth_func(GLenum func)
 // General helper function to read arbitrary vertex attribute data into a float array
 void GLContext::read_from_vertex_attribute_pointer(VertexAttribPointer const& attrib, int index, float* elements, bool normalize)
 {
-    auto byte_ptr = reinterpret_cast<const char*>(attrib.pointer);
+    auto byte_ptr = reinterpret_cast<const char*>(attrib.buffer ? attrib.buffer->offset_data(reinterpret_cast<FlatPtr>(attrib.pointer)) : attrib.pointer);
     size_t stride = attrib.stride;
 
     switch (attrib.type) {
@@ -3650,6 +3679,149 @@ void GLContext::get_material_param(Face face, GLenum pname, T* params)
     }
 }
 
+RefPtr<Buffer>* GLContext::buffer_binding(GLenum target)
+{
+    switch (target) {
+    case GL_ARRAY_BUFFER:
+        return &m_array_buffer;
+    case GL_ELEMENT_ARRAY_BUFFER:
+        return &m_element_array_buffer;
+    default:
+        return nullptr;
+    }
+}
+
+GLuint GLContext::buffer_name(RefPtr<Buffer> const& buffer) const
+{
+    if (!buffer)
+        return 0;
+    for (auto& it : m_allocated_buffers) {
+        if (it.value == buffer)
+            return it.key;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void GLContext::gl_gen_buffers(GLsizei n, GLuint* buffers)
+{
+    RETURN_WITH_ERROR_IF(n < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    m_buffer_name_allocator.allocate(n, buffers);
+
+    // Buffer objects are only created once their names are bound
+    for (auto i = 0; i < n; ++i)
+        m_allocated_buffers.set(buffers[i], nullptr);
+}
+
+void GLContext::gl_delete_buffers(GLsizei n, GLuint const* buffers)
+{
+    RETURN_WITH_ERROR_IF(n < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    for (auto i = 0; i < n; ++i) {
+        GLuint name = buffers[i];
+        auto it = m_allocated_buffers.find(name);
+        if (name == 0 || it == m_allocated_buffers.end())
+            continue;
+
+        // If a buffer object that is currently bound is deleted, the binding reverts to 0
+        auto buffer = it->value;
+        if (buffer && m_array_buffer == buffer)
+            m_array_buffer = nullptr;
+        if (buffer && m_element_array_buffer == buffer)
+            m_element_array_buffer = nullptr;
+
+        m_allocated_buffers.remove(it);
+        m_buffer_name_allocator.free(name);
+    }
+}
+
+void GLContext::gl_bind_buffer(GLenum target, GLuint buffer)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    auto* binding = buffer_binding(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+
+    if (buffer == 0) {
+        *binding = nullptr;
+        return;
+    }
+
+    // Like textures, buffer objects are created by binding a name that isn't in use yet
+    auto& buffer_object = m_allocated_buffers.ensure(buffer);
+    if (!buffer_object)
+        buffer_object = adopt_ref(*new Buffer());
+    *binding = buffer_object;
+}
+
+void GLContext::gl_buffer_data(GLenum target, GLsizeiptr size, void const* data, GLenum usage)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    auto* binding = buffer_binding(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(usage != GL_STREAM_DRAW
+            && usage != GL_STREAM_READ
+            && usage != GL_STREAM_COPY
+            && usage != GL_STATIC_DRAW
+            && usage != GL_STATIC_READ
+            && usage != GL_STATIC_COPY
+            && usage != GL_DYNAMIC_DRAW
+            && usage != GL_DYNAMIC_READ
+            && usage != GL_DYNAMIC_COPY,
+        GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(size < 0, GL_INVALID_VALUE);
+    RETURN_WITH_ERROR_IF(!*binding, GL_INVALID_OPERATION);
+
+    auto result = (*binding)->set_data(data, size, usage);
+    RETURN_WITH_ERROR_IF(result.is_error(), GL_OUT_OF_MEMORY);
+}
+
+void GLContext::gl_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, void const* data)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    auto* binding = buffer_binding(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(!*binding, GL_INVALID_OPERATION);
+    RETURN_WITH_ERROR_IF(offset < 0 || size < 0 || static_cast<size_t>(offset + size) > (*binding)->size(), GL_INVALID_VALUE);
+
+    (*binding)->replace_data(data, offset, size);
+}
+
+GLboolean GLContext::gl_is_buffer(GLuint buffer)
+{
+    RETURN_VALUE_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION, GL_FALSE);
+
+    auto it = m_allocated_buffers.find(buffer);
+    if (buffer == 0 || it == m_allocated_buffers.end())
+        return GL_FALSE;
+
+    return it->value.is_null() ? GL_FALSE : GL_TRUE;
+}
+
+void GLContext::gl_get_buffer_parameter(GLenum target, GLenum value, GLint* data)
+{
+    RETURN_WITH_ERROR_IF(m_in_draw_state, GL_INVALID_OPERATION);
+
+    auto* binding = buffer_binding(target);
+    RETURN_WITH_ERROR_IF(!binding, GL_INVALID_ENUM);
+    RETURN_WITH_ERROR_IF(!*binding, GL_INVALID_OPERATION);
+
+    switch (value) {
+    case GL_BUFFER_SIZE:
+        *data = static_cast<GLint>((*binding)->size());
+        break;
+    case GL_BUFFER_USAGE:
+        *data = static_cast<GLint>((*binding)->usage());
+        break;
+    default:
+        RETURN_WITH_ERROR_IF(true, GL_INVALID_ENUM);
+    }
+}
+
 NonnullOwnPtr<GLContext> create_context(Gfx::Bitmap& bitmap)
 {
     auto context = make<GLContext>(bitmap);
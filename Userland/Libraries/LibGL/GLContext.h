@@ -14,6 +14,7 @@
 #include <AK/Tuple.h>
 #include <AK/Variant.h>
 #include <AK/Vector.h>
+#include <LibGL/Buffer/Buffer.h>
 #include <LibGL/Tex/NameAllocator.h>
 #include <LibGL/Tex/Texture.h>
 #include <LibGL/Tex/TextureUnit.h>
@@ -155,6 +156,13 @@ public:
     void gl_color_material(GLenum face, GLenum mode);
     void gl_get_light(GLenum light, GLenum pname, void* params, GLenum type);
     void gl_get_material(GLenum face, GLenum pname, void* params, GLenum type);
+    void gl_gen_buffers(GLsizei n, GLuint* buffers);
+    void gl_delete_buffers(GLsizei n, GLuint const* buffers);
+    void gl_bind_buffer(GLenum target, GLuint buffer);
+    void gl_buffer_data(GLenum target, GLsizeiptr size, void const* data, GLenum usage);
+    void gl_buffer_sub_data(GLenum target, GLintptr offset, GLsizeiptr size, void const* data);
+    GLboolean gl_is_buffer(GLuint buffer);
+    void gl_get_buffer_parameter(GLenum target, GLenum value, GLint* data);
     void present();
 
 private:
@@ -166,6 +174,13 @@ private:
 
     void build_extension_string();
 
+    // Hands the vertex list to the device; with `indices`, each vertex is only transformed once however often it's used.
+    void draw_vertex_list(GLenum mode, Vector<u32> const* indices);
+    // Appends a vertex to the vertex list with the attributes at `index` in the enabled client side arrays.
+    void append_vertex_from_client_arrays(int index);
+    RefPtr<Buffer>* buffer_binding(GLenum target);
+    GLuint buffer_name(RefPtr<Buffer> const&) const;
+
     template<typename T>
     T* store_in_listing(T value)
     {
@@ -418,7 +433,9 @@ private:
         GLint size { 4 };
         GLenum type { GL_FLOAT };
         GLsizei stride { 0 };
+        // An offset into `buffer` if the pointer was set while a buffer object was bound to GL_ARRAY_BUFFER.
         const void* pointer { 0 };
+        RefPtr<Buffer> buffer;
     };
 
     static void read_from_vertex_attribute_pointer(VertexAttribPointer const&, int index, float* elements, bool normalize);
@@ -428,6 +445,13 @@ private:
     Vector<VertexAttribPointer> m_client_tex_coord_pointer;
     VertexAttribPointer m_client_normal_pointer;
 
+    // Buffer objects
+    TextureNameAllocator m_buffer_name_allocator;
+    HashMap<GLuint, RefPtr<Buffer>> m_allocated_buffers;
+    RefPtr<Buffer> m_array_buffer;
+    RefPtr<Buffer> m_element_array_buffer;
+    Vector<u32> m_vertex_indices;
+
     u8 m_pack_alignment { 4 };
     GLsizei m_unpack_row_length { 0 };
     u8 m_unpack_alignment { 4 };
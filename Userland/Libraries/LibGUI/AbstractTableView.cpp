@@ -38,10 +38,12 @@ AbstractTableView::AbstractTableView()
 void AbstractTableView::select_all()
 {
     selection().clear();
-    for (int item_index = 0; item_index < item_count(); ++item_index) {
-        auto index = model()->index(item_index);
-        selection().add(index);
-    }
+
+    Vector<ModelIndex> indices;
+    indices.ensure_capacity(item_count());
+    for (int item_index = 0; item_index < item_count(); ++item_index)
+        indices.unchecked_append(model()->index(item_index));
+    selection().add_all(indices);
 }
 
 void AbstractTableView::auto_resize_column(int column)
@@ -89,7 +91,9 @@ void AbstractTableView::update_column_sizes()
 
     auto& model = *this->model();
     int column_count = model.column_count();
-    int row_count = model.row_count();
+    // Fetching and measuring every cell of a huge model would stall the view, so only the first rows are measured.
+    // auto_resize_column() still looks at all of them.
+    int row_count = min(model.row_count(), max_rows_to_measure_for_column_sizes);
 
     for (int column = 0; column < column_count; ++column) {
         if (!column_header().is_section_visible(column))
@@ -95,6 +95,9 @@ protected:
 
     virtual void toggle_index(const ModelIndex&) { }
 
+    // update_column_sizes() only measures this many rows of the model.
+    static constexpr int max_rows_to_measure_for_column_sizes = 1000;
+
     void update_content_size();
     virtual void auto_resize_column(int column);
     virtual void update_column_sizes();
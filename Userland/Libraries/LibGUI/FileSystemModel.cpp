@@ -9,16 +9,23 @@
 #include <AK/LexicalPath.h>
 #include <AK/NumberFormat.h>
 #include <AK/QuickSort.h>
+#include <AK/Random.h>
 #include <AK/StringBuilder.h>
-#include <LibCore/DirIterator.h>
+#include <AK/StringHash.h>
+#include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
 #include <LibGUI/AbstractView.h>
 #include <LibGUI/FileIconProvider.h>
 #include <LibGUI/FileSystemModel.h>
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/PNGWriter.h>
 #include <LibThreading/BackgroundAction.h>
+#include <LibThreading/DirectoryTree.h>
+#include <LibThreading/ThreadPool.h>
+#include <fcntl.h>
 #include <grp.h>
 #include <pwd.h>
 #include <stdio.h>
@@ -39,6 +46,26 @@ ModelIndex FileSystemModel::Node::index(int column) const
     VERIFY_NOT_REACHED();
 }
 
+static mode_t mode_from_directory_entry_type(unsigned char type)
+{
+    switch (type) {
+    case DT_DIR:
+        return S_IFDIR;
+    case DT_LNK:
+        return S_IFLNK;
+    case DT_CHR:
+        return S_IFCHR;
+    case DT_BLK:
+        return S_IFBLK;
+    case DT_FIFO:
+        return S_IFIFO;
+    case DT_SOCK:
+        return S_IFSOCK;
+    default:
+        return S_IFREG;
+    }
+}
+
 bool FileSystemModel::Node::fetch_data(String const& full_path, bool is_root)
 {
     struct stat st;
@@ -92,24 +119,48 @@ void FileSystemModel::Node::traverse_if_needed()
     total_size = 0;
 
     auto full_path = this->full_path();
-    Core::DirIterator di(full_path, m_model.should_show_dotfiles() ? Core::DirIterator::SkipParentAndBaseDir : Core::DirIterator::SkipDots);
-    if (di.has_error()) {
-        m_error = di.error();
-        warnln("DirIterator: {}", di.error_string());
+    // Reading the directory itself is cheap, and gives us every entry's type.
+    auto listing = Threading::read_directory_tree(full_path, { .max_depth = 0 });
+    if (listing.error != 0) {
+        m_error = listing.error;
+        warnln("Unable to read directory {}: {}", full_path, strerror(m_error));
         return;
     }
 
-    Vector<String> child_names;
-    while (di.has_next()) {
-        child_names.append(di.next_path());
+    struct Entry {
+        String name;
+        unsigned char type;
+    };
+    Vector<Entry> entries;
+    entries.ensure_capacity(listing.children.size());
+    for (auto& child : listing.children) {
+        if (child.error != 0)
+            continue;
+        if (!m_model.should_show_dotfiles() && child.name.starts_with('.'))
+            continue;
+        if (m_model.m_mode == DirectoriesOnly && child.type != DT_DIR)
+            continue;
+        entries.unchecked_append({ move(child.name), child.type });
     }
-    quick_sort(child_names);
+    quick_sort(entries, [](auto& a, auto& b) { return a.name < b.name; });
+
+    // Stat'ing every entry of a big directory takes a while, so those are listed right away and filled in later.
+    bool read_metadata_in_background = entries.size() >= FileSystemModel::background_metadata_threshold;
 
     NonnullOwnPtrVector<Node> directory_children;
     NonnullOwnPtrVector<Node> file_children;
 
-    for (auto& child_name : child_names) {
-        auto maybe_child = create_child(child_name);
+    for (auto& entry : entries) {
+        OwnPtr<Node> maybe_child;
+        if (read_metadata_in_background) {
+            maybe_child = adopt_own(*new Node(m_model));
+            maybe_child->name = move(entry.name);
+            maybe_child->mode = mode_from_directory_entry_type(entry.type);
+            maybe_child->m_parent = this;
+            maybe_child->m_is_waiting_for_metadata = true;
+        } else {
+            maybe_child = create_child(entry.name);
+        }
         if (!maybe_child)
             continue;
 
@@ -124,6 +175,9 @@ void FileSystemModel::Node::traverse_if_needed()
     m_children.extend(move(directory_children));
     m_children.extend(move(file_children));
 
+    if (read_metadata_in_background)
+        m_model.read_metadata_in_background(*this);
+
     if (!m_model.m_file_watcher->is_watching(full_path)) {
         // We are not already watching this file, watch it
         auto result = m_model.m_file_watcher->add_watch(full_path,
@@ -192,6 +246,74 @@ String FileSystemModel::Node::full_path() const
     return LexicalPath::canonicalized_path(builder.to_string());
 }
 
+void FileSystemModel::read_metadata_in_background(Node& directory)
+{
+    auto request_id = ++m_last_metadata_request_id;
+    directory.m_metadata_request_id = request_id;
+    auto directory_path = directory.full_path();
+
+    Vector<String> names;
+    for (auto& child : directory.m_children) {
+        if (child.m_is_waiting_for_metadata)
+            names.append(child.name.isolated_copy());
+    }
+
+    // The entries are read in batches, so the view fills in while we're still stat'ing the rest.
+    for (size_t batch_start = 0; batch_start < names.size(); batch_start += metadata_batch_size) {
+        Vector<String> batch;
+        for (size_t i = batch_start; i < min(batch_start + metadata_batch_size, names.size()); ++i)
+            batch.append(move(names[i]));
+
+        (void)Threading::BackgroundAction<NonnullOwnPtrVector<Node>>::construct(
+            [this, directory_path = directory_path.isolated_copy(), batch = move(batch)](auto&) {
+                // NOTE: These nodes are only used to carry the metadata back to the UI thread.
+                NonnullOwnPtrVector<Node> nodes;
+                nodes.ensure_capacity(batch.size());
+                for (auto& name : batch) {
+                    auto node = adopt_own(*new Node(*this));
+                    node->fetch_data(LexicalPath::join(directory_path, name).string(), false);
+                    node->name = name;
+                    nodes.unchecked_append(move(node));
+                }
+                return nodes;
+            },
+            [this, weak_this = make_weak_ptr(), directory_path, request_id](NonnullOwnPtrVector<Node> nodes) {
+                if (weak_this.is_null())
+                    return;
+                // The directory may have been reread or removed in the meantime.
+                auto* directory = const_cast<Node*>(node_for_path(directory_path));
+                if (!directory || directory->m_metadata_request_id != request_id)
+                    return;
+
+                HashMap<StringView, Node*> children_by_name;
+                for (auto& child : directory->m_children) {
+                    if (child.m_is_waiting_for_metadata)
+                        children_by_name.set(child.name, &child);
+                }
+
+                for (auto& node : nodes) {
+                    auto it = children_by_name.find(node.name);
+                    if (it == children_by_name.end())
+                        continue;
+                    auto& child = *it->value;
+                    child.size = node.size;
+                    child.mode = node.mode;
+                    child.uid = node.uid;
+                    child.gid = node.gid;
+                    child.inode = node.inode;
+                    child.mtime = node.mtime;
+                    child.symlink_target = move(node.symlink_target);
+                    child.is_accessible_directory = node.is_accessible_directory;
+                    child.m_error = node.m_error;
+                    child.m_is_waiting_for_metadata = false;
+                    directory->total_size += child.size;
+                }
+
+                did_update(UpdateFlag::DontInvalidateIndices);
+            });
+    }
+}
+
 ModelIndex FileSystemModel::index(String path, int column) const
 {
     Node const* node = node_for_path(move(path));
@@ -612,8 +734,59 @@ Icon FileSystemModel::icon_for(Node const& node) const
 
 static HashMap<String, RefPtr<Gfx::Bitmap>> s_thumbnail_cache;
 
-static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
+static String const& thumbnail_cache_directory()
+{
+    static Optional<String> s_directory;
+    if (!s_directory.has_value()) {
+        auto directory = String::formatted("{}/.cache/thumbnails", Core::StandardPaths::home_directory());
+        s_directory = directory;
+        for (auto& path : { LexicalPath::dirname(directory), directory }) {
+            if (auto result = Core::System::mkdir(path, 0700); result.is_error() && result.error().code() != EEXIST) {
+                dbgln("Unable to create {}, not caching thumbnails on disk: {}", path, result.error());
+                s_directory = String {};
+                break;
+            }
+        }
+    }
+    return *s_directory;
+}
+
+// Thumbnails on disk are keyed by the image's path, size and modification time, so they go stale with the image.
+static String thumbnail_cache_path_for(FileSystemModel::Node const& node)
+{
+    auto& directory = thumbnail_cache_directory();
+    if (directory.is_empty())
+        return {};
+    auto key = String::formatted("{}:{}:{}", node.full_path(), node.size, node.mtime);
+    return String::formatted("{}/{:08x}{:08x}.png", directory, string_hash(key.characters(), key.length()), string_hash(key.characters(), key.length(), 0x9e3779b9));
+}
+
+static ErrorOr<void> store_thumbnail(Gfx::Bitmap const& thumbnail, String const& cache_path)
 {
+    auto data = Gfx::PNGWriter::encode(thumbnail);
+    // Written next to its final place first, so nobody ever reads a partial thumbnail.
+    auto temporary_path = String::formatted("{}.{}", cache_path, get_random<u32>());
+    auto fd = TRY(Core::System::open(temporary_path, O_WRONLY | O_CREAT | O_TRUNC, 0600));
+    auto result = [&]() -> ErrorOr<void> {
+        for (size_t offset = 0; offset < data.size();)
+            offset += TRY(Core::System::write(fd, data.bytes().slice(offset)));
+        return {};
+    }();
+    TRY(Core::System::close(fd));
+    if (!result.is_error())
+        result = Core::System::rename(temporary_path, cache_path);
+    if (result.is_error())
+        (void)Core::System::unlink(temporary_path);
+    return result;
+}
+
+static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(String const& path, String const& cache_path)
+{
+    if (!cache_path.is_empty()) {
+        if (auto thumbnail_or_error = Gfx::Bitmap::try_load_from_file(cache_path); !thumbnail_or_error.is_error())
+            return thumbnail_or_error.release_value();
+    }
+
     auto bitmap = TRY(Gfx::Bitmap::try_load_from_file(path));
     auto thumbnail = TRY(Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, { 32, 32 }));
 
@@ -622,6 +795,11 @@ static ErrorOr<NonnullRefPtr<Gfx::Bitmap>> render_thumbnail(StringView path)
 
     Painter painter(thumbnail);
     painter.draw_scaled_bitmap(destination, *bitmap, bitmap->rect());
+
+    if (!cache_path.is_empty()) {
+        if (auto result = store_thumbnail(thumbnail, cache_path); result.is_error())
+            dbgln("Failed to store thumbnail for {} in {}: {}", path, cache_path, result.error());
+    }
     return thumbnail;
 }
 
@@ -638,33 +816,78 @@ bool FileSystemModel::fetch_thumbnail_for(Node const& node)
         return true;
     }
 
+    // We'll be asked again once we know the size and modification time of the image, which its cached thumbnail depends on.
+    if (node.m_is_waiting_for_metadata)
+        return false;
+
     // Otherwise, arrange to render the thumbnail
     // in background and make it available later.
 
     s_thumbnail_cache.set(path, nullptr);
     m_thumbnail_progress_total++;
 
+    m_queued_thumbnail_requests.append({ path.isolated_copy(), thumbnail_cache_path_for(node).isolated_copy() });
+    if (!m_is_rendering_thumbnails) {
+        // Wait for the rest of this paint's requests, so they end up in the same batch.
+        m_is_rendering_thumbnails = true;
+        Core::deferred_invoke([this, weak_this = make_weak_ptr()] {
+            if (!weak_this.is_null())
+                render_queued_thumbnails();
+        });
+    }
+
+    return false;
+}
+
+void FileSystemModel::render_queued_thumbnails()
+{
+    if (m_queued_thumbnail_requests.is_empty()) {
+        m_is_rendering_thumbnails = false;
+        return;
+    }
+    m_is_rendering_thumbnails = true;
+
+    auto batch_size = min(m_queued_thumbnail_requests.size(), max_thumbnails_per_batch);
+    Vector<ThumbnailRequest> batch;
+    Vector<String> paths;
+    batch.ensure_capacity(batch_size);
+    paths.ensure_capacity(batch_size);
+    for (size_t i = 0; i < batch_size; ++i) {
+        paths.unchecked_append(m_queued_thumbnail_requests[i].path.isolated_copy());
+        batch.unchecked_append(move(m_queued_thumbnail_requests[i]));
+    }
+    m_queued_thumbnail_requests.remove(0, batch_size);
+
     auto weak_this = make_weak_ptr();
 
-    (void)Threading::BackgroundAction<ErrorOr<NonnullRefPtr<Gfx::Bitmap>>>::construct(
-        [path](auto&) {
-            return render_thumbnail(path);
+    (void)Threading::BackgroundAction<Vector<RefPtr<Gfx::Bitmap>>>::construct(
+        [batch = move(batch)](auto&) {
+            Vector<RefPtr<Gfx::Bitmap>> thumbnails;
+            thumbnails.resize(batch.size());
+            Threading::TaskGroup group;
+            for (size_t i = 0; i < batch.size(); ++i) {
+                group.spawn([&batch, &thumbnails, i] {
+                    auto thumbnail_or_error = render_thumbnail(batch[i].path, batch[i].cache_path);
+                    if (thumbnail_or_error.is_error())
+                        dbgln("Failed to load thumbnail for {}: {}", batch[i].path, thumbnail_or_error.error());
+                    else
+                        thumbnails[i] = thumbnail_or_error.release_value();
+                });
+            }
+            group.wait();
+            return thumbnails;
         },
 
-        [this, path, weak_this](auto thumbnail_or_error) {
-            if (thumbnail_or_error.is_error()) {
-                s_thumbnail_cache.set(path, nullptr);
-                dbgln("Failed to load thumbnail for {}: {}", path, thumbnail_or_error.error());
-            } else {
-                s_thumbnail_cache.set(path, thumbnail_or_error.release_value());
-            }
+        [this, paths = move(paths), weak_this](auto thumbnails) {
+            for (size_t i = 0; i < paths.size(); ++i)
+                s_thumbnail_cache.set(paths[i], move(thumbnails[i]));
 
             // The model was destroyed, no need to update
             // progress or call any event handlers.
             if (weak_this.is_null())
                 return;
 
-            m_thumbnail_progress++;
+            m_thumbnail_progress += paths.size();
             if (on_thumbnail_progress)
                 on_thumbnail_progress(m_thumbnail_progress, m_thumbnail_progress_total);
             if (m_thumbnail_progress == m_thumbnail_progress_total) {
@@ -673,9 +896,8 @@ bool FileSystemModel::fetch_thumbnail_for(Node const& node)
             }
 
             did_update(UpdateFlag::DontInvalidateIndices);
+            render_queued_thumbnails();
         });
-
-    return false;
 }
 
 int FileSystemModel::column_count(ModelIndex const&) const
@@ -85,6 +85,10 @@ public:
         Node* m_parent { nullptr };
         NonnullOwnPtrVector<Node> m_children;
         bool m_has_traversed { false };
+        // Only the name and the type of the entry are known so far, the rest is being read in the background.
+        bool m_is_waiting_for_metadata { false };
+        // Identifies the latest background read of the children's metadata, see FileSystemModel::read_metadata_in_background().
+        u64 m_metadata_request_id { 0 };
 
         bool m_selected { false };
 
@@ -156,7 +160,13 @@ private:
     HashMap<uid_t, String> m_user_names;
     HashMap<gid_t, String> m_group_names;
 
+    // Directories with at least this many entries only get their entries' names and types on the UI thread.
+    static constexpr size_t background_metadata_threshold = 256;
+    static constexpr size_t metadata_batch_size = 512;
+    void read_metadata_in_background(Node& directory);
+
     bool fetch_thumbnail_for(Node const& node);
+    void render_queued_thumbnails();
     GUI::Icon icon_for(Node const& node) const;
 
     void handle_file_event(Core::FileWatcherEvent const& event);
@@ -168,6 +178,17 @@ private:
     unsigned m_thumbnail_progress { 0 };
     unsigned m_thumbnail_progress_total { 0 };
 
+    // Thumbnails are rendered a batch at a time, and the images of a batch are decoded on the thread pool.
+    static constexpr size_t max_thumbnails_per_batch = 32;
+    struct ThumbnailRequest {
+        String path;
+        String cache_path;
+    };
+    Vector<ThumbnailRequest> m_queued_thumbnail_requests;
+    bool m_is_rendering_thumbnails { false };
+
+    u64 m_last_metadata_request_id { 0 };
+
     bool m_should_show_dotfiles { false };
 
     RefPtr<Core::FileWatcher> m_file_watcher;
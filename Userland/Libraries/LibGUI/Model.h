@@ -81,6 +81,12 @@ public:
     virtual bool is_column_sortable([[maybe_unused]] int column_index) const { return true; }
     virtual void sort([[maybe_unused]] int column, SortOrder) { }
 
+    // Models whose rows are expensive to produce can hand them out a batch at a time: row_count() only covers the rows
+    // fetched so far, and views call fetch_more() when they're about to show the last of them. fetch_more() should add
+    // the next batch with begin_insert_rows()/end_insert_rows() or did_update().
+    virtual bool can_fetch_more([[maybe_unused]] ModelIndex const& parent = ModelIndex()) const { return false; }
+    virtual void fetch_more([[maybe_unused]] ModelIndex const& parent = ModelIndex()) { }
+
     bool is_within_range(ModelIndex const& index) const
     {
         auto parent_index = this->parent_index(index);
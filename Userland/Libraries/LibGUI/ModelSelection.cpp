@@ -10,6 +10,26 @@
 
 namespace GUI {
 
+bool ModelSelection::contains_row(int row) const
+{
+    // Views ask this for every row they paint, so large selections (like after select all) get a set of their rows.
+    if (m_indices.size() < 16) {
+        for (auto& index : m_indices) {
+            if (index.row() == row)
+                return true;
+        }
+        return false;
+    }
+
+    if (!m_selected_rows.has_value()) {
+        m_selected_rows = HashTable<int> {};
+        m_selected_rows->ensure_capacity(m_indices.size());
+        for (auto& index : m_indices)
+            m_selected_rows->set(index.row());
+    }
+    return m_selected_rows->contains(row);
+}
+
 void ModelSelection::remove_all_matching(Function<bool(ModelIndex const&)> filter)
 {
     if (m_indices.remove_all_matching([&](ModelIndex const& index) { return filter(index); }))
@@ -75,6 +95,7 @@ void ModelSelection::clear()
 
 void ModelSelection::notify_selection_changed()
 {
+    m_selected_rows.clear();
     if (!m_disable_notify) {
         m_view.notify_selection_changed({});
         m_notify_pending = false;
@@ -9,6 +9,7 @@
 #include <AK/Badge.h>
 #include <AK/HashTable.h>
 #include <AK/Noncopyable.h>
+#include <AK/Optional.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Vector.h>
 #include <LibGUI/ModelIndex.h>
@@ -28,14 +29,7 @@ public:
     int size() const { return m_indices.size(); }
     bool is_empty() const { return m_indices.is_empty(); }
     bool contains(const ModelIndex& index) const { return m_indices.contains(index); }
-    bool contains_row(int row) const
-    {
-        for (auto& index : m_indices) {
-            if (index.row() == row)
-                return true;
-        }
-        return false;
-    }
+    bool contains_row(int row) const;
 
     void set(const ModelIndex&);
     void add(const ModelIndex&);
@@ -95,6 +89,8 @@ private:
 
     AbstractView& m_view;
     HashTable<ModelIndex> m_indices;
+    // Rows of the selected indices, built on demand for contains_row() and dropped whenever the selection changes.
+    mutable Optional<HashTable<int>> m_selected_rows;
     bool m_disable_notify { false };
     bool m_notify_pending { false };
 };
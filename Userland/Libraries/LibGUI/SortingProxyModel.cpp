@@ -7,6 +7,8 @@
 #include <AK/QuickSort.h>
 #include <LibGUI/AbstractView.h>
 #include <LibGUI/SortingProxyModel.h>
+#include <LibThreading/BackgroundAction.h>
+#include <LibThreading/Parallel.h>
 
 namespace GUI {
 
@@ -121,15 +123,6 @@ StringView SortingProxyModel::drag_data_type() const
     return source().drag_data_type();
 }
 
-bool SortingProxyModel::less_than(ModelIndex const& index1, ModelIndex const& index2) const
-{
-    auto data1 = index1.data(m_sort_role);
-    auto data2 = index2.data(m_sort_role);
-    if (data1.is_string() && data2.is_string())
-        return data1.as_string().to_lowercase() < data2.as_string().to_lowercase();
-    return data1 < data2;
-}
-
 ModelIndex SortingProxyModel::index(int row, int column, ModelIndex const& parent) const
 {
     if (row < 0 || column < 0)
@@ -161,31 +154,139 @@ ModelIndex SortingProxyModel::parent_index(ModelIndex const& proxy_index) const
     return map_to_proxy(it->value->source_parent);
 }
 
+template<typename Key>
+static Vector<int> sorted_rows(Vector<Key> const& keys, SortOrder sort_order)
+{
+    Vector<int> rows;
+    rows.resize(keys.size());
+    for (size_t i = 0; i < rows.size(); ++i)
+        rows[i] = i;
+
+    Threading::parallel_sort(rows, [&](int row1, int row2) {
+        if (sort_order == SortOrder::Ascending)
+            return keys[row1] < keys[row2];
+        return keys[row2] < keys[row1];
+    });
+    return rows;
+}
+
 void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sort_order)
 {
-    auto old_source_rows = mapping.source_rows;
+    mapping.sort_generation = ++m_sort_generation;
 
     int row_count = source().row_count(mapping.source_parent);
-    mapping.source_rows.resize(row_count);
-    mapping.proxy_rows.resize(row_count);
-
-    if (column == -1) {
+    if (static_cast<int>(mapping.source_rows.size()) != row_count || column == -1) {
+        mapping.source_rows.resize(row_count);
+        mapping.proxy_rows.resize(row_count);
         for (int i = 0; i < row_count; ++i) {
             mapping.source_rows[i] = i;
             mapping.proxy_rows[i] = i;
         }
+    }
+
+    if (column == -1)
         return;
+
+    // Every row's sort key is fetched once up front, instead of twice for every comparison. Once we have them, the
+    // keys can be sorted on any thread, as long as they compare without the model or any shared reference counts.
+    // That's the case for strings, and for numbers of the same type.
+    auto sort_by_keys = [&]<typename Key>(auto to_key) -> bool {
+        Vector<Key> keys;
+        keys.ensure_capacity(row_count);
+        for (int row = 0; row < row_count; ++row) {
+            auto key = to_key(source().index(row, column, mapping.source_parent).data(m_sort_role));
+            if (!key.has_value())
+                return false;
+            keys.unchecked_append(key.release_value());
+        }
+
+        if (row_count >= background_sort_threshold)
+            sort_mapping_in_background(mapping, [keys = move(keys), sort_order] { return sorted_rows(keys, sort_order); });
+        else
+            apply_sorted_rows(mapping, sorted_rows(keys, sort_order));
+        return true;
+    };
+
+    auto first_key = row_count > 0 ? source().index(0, column, mapping.source_parent).data(m_sort_role) : Variant {};
+    if (first_key.is_string()) {
+        if (sort_by_keys.operator()<String>([](Variant const& data) -> Optional<String> {
+                if (!data.is_string())
+                    return {};
+                return data.as_string().to_lowercase();
+            }))
+            return;
+    } else if (first_key.is_bool() || first_key.is_i32() || first_key.is_i64()) {
+        if (sort_by_keys.operator()<i64>([](Variant const& data) -> Optional<i64> {
+                if (data.is_bool())
+                    return data.as_bool();
+                if (data.is_i32())
+                    return data.as_i32();
+                if (data.is_i64())
+                    return data.as_i64();
+                return {};
+            }))
+            return;
+    } else if (first_key.is_u32() || first_key.is_u64()) {
+        if (sort_by_keys.operator()<u64>([](Variant const& data) -> Optional<u64> {
+                if (data.is_u32())
+                    return data.as_u32();
+                if (data.is_u64())
+                    return data.as_u64();
+                return {};
+            }))
+            return;
+    } else if (first_key.is_float()) {
+        if (sort_by_keys.operator()<float>([](Variant const& data) -> Optional<float> {
+                if (!data.is_float())
+                    return {};
+                return data.as_float();
+            }))
+            return;
     }
 
+    // Anything else is compared by asking the model for every comparison, on this thread.
+    Vector<int> source_rows;
+    source_rows.resize(row_count);
     for (int i = 0; i < row_count; ++i)
-        mapping.source_rows[i] = i;
-
-    quick_sort(mapping.source_rows, [&](auto row1, auto row2) -> bool {
-        bool is_less_than = less_than(source().index(row1, column, mapping.source_parent), source().index(row2, column, mapping.source_parent));
+        source_rows[i] = i;
+
+    quick_sort(source_rows, [&](auto row1, auto row2) -> bool {
+        auto data1 = source().index(row1, column, mapping.source_parent).data(m_sort_role);
+        auto data2 = source().index(row2, column, mapping.source_parent).data(m_sort_role);
+        bool is_less_than;
+        if (data1.is_string() && data2.is_string())
+            is_less_than = data1.as_string().to_lowercase() < data2.as_string().to_lowercase();
+        else
+            is_less_than = data1 < data2;
         return sort_order == SortOrder::Ascending ? is_less_than : !is_less_than;
     });
 
-    for (int i = 0; i < row_count; ++i)
+    apply_sorted_rows(mapping, move(source_rows));
+}
+
+void SortingProxyModel::sort_mapping_in_background(Mapping& mapping, Function<Vector<int>()> sort_rows)
+{
+    // Until the sort is done, the rows stay in their previous order.
+    (void)Threading::BackgroundAction<Vector<int>>::construct(
+        [sort_rows = move(sort_rows)](auto&) {
+            return sort_rows();
+        },
+        [this, protector = NonnullRefPtr(*this), source_parent = mapping.source_parent, generation = mapping.sort_generation, row_count = mapping.source_rows.size()](Vector<int> source_rows) {
+            auto it = m_mappings.find(source_parent);
+            if (it == m_mappings.end() || it->value->sort_generation != generation || it->value->source_rows.size() != row_count)
+                return;
+            apply_sorted_rows(*it->value, move(source_rows));
+            did_update(UpdateFlag::DontInvalidateIndices);
+        });
+}
+
+void SortingProxyModel::apply_sorted_rows(Mapping& mapping, Vector<int> source_rows)
+{
+    VERIFY(source_rows.size() == mapping.source_rows.size());
+    auto old_source_rows = move(mapping.source_rows);
+    mapping.source_rows = move(source_rows);
+
+    for (size_t i = 0; i < mapping.source_rows.size(); ++i)
         mapping.proxy_rows[mapping.source_rows[i]] = i;
 
     // FIXME: I really feel like this should be done at the view layer somehow.
@@ -206,17 +307,12 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
             }
 
             for (auto& index : selected_indices_in_source) {
-                for (size_t i = 0; i < mapping.source_rows.size(); ++i) {
-                    if (mapping.source_rows[i] == index.row()) {
-                        auto new_source_index = this->index(i, index.column(), mapping.source_parent);
-                        selection.add(new_source_index);
-                        // Update the view's cursor.
-                        auto cursor = view.cursor_index();
-                        if (cursor.is_valid() && cursor.parent() == mapping.source_parent)
-                            view.set_cursor(new_source_index, AbstractView::SelectionUpdate::None, false);
-                        break;
-                    }
-                }
+                auto new_source_index = this->index(mapping.proxy_rows[index.row()], index.column(), mapping.source_parent);
+                selection.add(new_source_index);
+                // Update the view's cursor.
+                auto cursor = view.cursor_index();
+                if (cursor.is_valid() && cursor.parent() == mapping.source_parent)
+                    view.set_cursor(new_source_index, AbstractView::SelectionUpdate::None, false);
             }
         });
     });
@@ -245,10 +341,6 @@ SortingProxyModel::InternalMapIterator SortingProxyModel::build_mapping(ModelInd
 
     mapping->source_parent = source_parent;
 
-    int row_count = source().row_count(source_parent);
-    mapping->source_rows.resize(row_count);
-    mapping->proxy_rows.resize(row_count);
-
     sort_mapping(*mapping, m_last_key_column, m_last_sort_order);
 
     if (source_parent.is_valid()) {
@@ -265,6 +357,16 @@ bool SortingProxyModel::is_column_sortable(int column_index) const
     return source().is_column_sortable(column_index);
 }
 
+bool SortingProxyModel::can_fetch_more(ModelIndex const& proxy_parent) const
+{
+    return source().can_fetch_more(map_to_source(proxy_parent));
+}
+
+void SortingProxyModel::fetch_more(ModelIndex const& proxy_parent)
+{
+    source().fetch_more(map_to_source(proxy_parent));
+}
+
 bool SortingProxyModel::is_editable(ModelIndex const& proxy_index) const
 {
     return source().is_editable(map_to_source(proxy_index));
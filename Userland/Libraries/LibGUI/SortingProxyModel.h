@@ -36,8 +36,8 @@ public:
     virtual bool accepts_drag(ModelIndex const&, Vector<String> const& mime_types) const override;
 
     virtual bool is_column_sortable(int column_index) const override;
-
-    virtual bool less_than(ModelIndex const&, ModelIndex const&) const;
+    virtual bool can_fetch_more(ModelIndex const& parent = ModelIndex()) const override;
+    virtual void fetch_more(ModelIndex const& parent = ModelIndex()) override;
 
     ModelIndex map_to_source(ModelIndex const&) const;
     ModelIndex map_to_proxy(ModelIndex const&) const;
@@ -55,11 +55,18 @@ private:
         Vector<int> source_rows;
         Vector<int> proxy_rows;
         ModelIndex source_parent;
+        // Tells a sort that finishes on the background thread whether it's still wanted.
+        u64 sort_generation { 0 };
     };
 
     using InternalMapIterator = HashMap<ModelIndex, NonnullOwnPtr<Mapping>>::IteratorType;
 
+    // Mappings with at least this many rows are sorted on the background thread, if their sort keys allow it.
+    static constexpr int background_sort_threshold = 10000;
+
     void sort_mapping(Mapping&, int column, SortOrder);
+    void sort_mapping_in_background(Mapping&, Function<Vector<int>()> sort_rows);
+    void apply_sorted_rows(Mapping&, Vector<int> source_rows);
 
     // ^ModelClient
     virtual void model_did_update(unsigned) override;
@@ -76,6 +83,7 @@ private:
     ModelRole m_sort_role { ModelRole::Sort };
     int m_last_key_column { -1 };
     SortOrder m_last_sort_order { SortOrder::Ascending };
+    u64 m_sort_generation { 0 };
 };
 
 }
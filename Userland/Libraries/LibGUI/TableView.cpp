@@ -59,6 +59,14 @@ void TableView::paint_event(PaintEvent& event)
     if (last_visible_row == -1)
         last_visible_row = model()->row_count() - 1;
 
+    // Models that load their rows in batches are asked for the next batch once their last row comes into view.
+    if (last_visible_row >= model()->row_count() - 1 && model()->can_fetch_more()) {
+        deferred_invoke([this] {
+            if (model() && model()->can_fetch_more())
+                model()->fetch_more();
+        });
+    }
+
     int painted_item_index = first_visible_row;
 
     for (int row_index = first_visible_row; row_index <= last_visible_row; ++row_index) {
@@ -19,6 +19,8 @@ namespace GUI {
 
 struct TreeView::MetadataForIndex {
     bool open { false };
+    // Width of the index's text, which every traversal needs for its rect.
+    Optional<int> text_width;
 };
 
 TreeView::MetadataForIndex& TreeView::ensure_metadata_for_index(const ModelIndex& index) const
@@ -151,6 +153,8 @@ void TreeView::toggle_index(const ModelIndex& index)
 
     if (on_toggle)
         on_toggle(index, metadata.open);
+    if (metadata.open && model()->can_fetch_more(index))
+        model()->fetch_more(index);
     update_column_sizes();
     update_content_size();
     update();
@@ -171,10 +175,11 @@ void TreeView::traverse_in_paint_order(Callback callback) const
         if (index.is_valid()) {
             auto& metadata = ensure_metadata_for_index(index);
             int x_offset = tree_column_x_offset + horizontal_padding() + indent_level * indent_width_in_pixels();
-            auto node_text = index.data().to_string();
+            if (!metadata.text_width.has_value())
+                metadata.text_width = font_for_index(index)->width(index.data().to_string());
             Gfx::IntRect rect = {
                 x_offset, y_offset,
-                icon_size() + icon_spacing() + text_padding() + font_for_index(index)->width(node_text) + text_padding(), row_height()
+                icon_size() + icon_spacing() + text_padding() + *metadata.text_width + text_padding(), row_height()
             };
             Gfx::IntRect toggle_rect;
             if (row_count_at_index > 0) {
@@ -233,8 +238,13 @@ void TreeView::paint_event(PaintEvent& event)
     int y_offset = column_header().height();
 
     int painted_row_index = 0;
+    bool reached_end_of_content = true;
 
     traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect& a_rect, const Gfx::IntRect& a_toggle_rect, int indent_level) {
+        if (a_rect.top() > visible_content_rect.bottom()) {
+            reached_end_of_content = false;
+            return IterationDecision::Break;
+        }
         if (!a_rect.intersects_vertically(visible_content_rect))
             return IterationDecision::Continue;
 
@@ -378,6 +388,14 @@ void TreeView::paint_event(PaintEvent& event)
 
         return IterationDecision::Continue;
     });
+
+    // Models that load their top-level rows in batches are asked for the next batch once their last row comes into view.
+    if (reached_end_of_content && model.can_fetch_more()) {
+        deferred_invoke([this] {
+            if (this->model() && this->model()->can_fetch_more())
+                this->model()->fetch_more();
+        });
+    }
 }
 
 void TreeView::scroll_into_view(const ModelIndex& a_index, bool, bool scroll_vertically)
@@ -675,7 +693,10 @@ void TreeView::update_column_sizes()
         if (column == m_key_column && model.is_column_sortable(column))
             header_width += font().width(" \xE2\xAC\x86");
         int column_width = header_width;
+        int measured_rows = 0;
         traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect&, const Gfx::IntRect&, int) {
+            if (measured_rows++ == max_rows_to_measure_for_column_sizes)
+                return IterationDecision::Break;
             auto cell_data = model.index(index.row(), column, index.parent()).data();
             int cell_width = 0;
             if (cell_data.is_icon()) {
@@ -696,7 +717,10 @@ void TreeView::update_column_sizes()
     if (tree_column == m_key_column && model.is_column_sortable(tree_column))
         tree_column_header_width += font().width(" \xE2\xAC\x86");
     int tree_column_width = tree_column_header_width;
+    int measured_rows = 0;
     traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect&, const Gfx::IntRect&, int indent_level) {
+        if (measured_rows++ == max_rows_to_measure_for_column_sizes)
+            return IterationDecision::Break;
         auto cell_data = model.index(index.row(), tree_column, index.parent()).data();
         int cell_width = 0;
         if (cell_data.is_valid()) {
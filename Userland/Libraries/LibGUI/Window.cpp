@@ -424,6 +424,9 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
             // The backing store bitmap was cleared, but it does have memory.
             // Act as if it's a new backing store so the entire window gets repainted.
             created_new_backing_store = true;
+        } else if (!m_back_store_stale_rects.is_empty() && (!m_front_store || m_front_store->size() != m_back_store->size())) {
+            // The only up to date copy of some parts of the window is gone, so they have to be painted again.
+            created_new_backing_store = true;
         }
     }
 
@@ -433,6 +436,11 @@ void Window::handle_multi_paint_event(MultiPaintEvent& event)
         rects.append({ {}, event.window_size() });
     }
 
+    if (created_new_backing_store)
+        m_back_store_stale_rects.clear();
+    else if (m_double_buffering_enabled)
+        update_back_store(rects);
+
     for (auto& rect : rects) {
         PaintEvent paint_event(rect);
         m_main_widget->dispatch_event(paint_event, this);
@@ -858,17 +866,39 @@ void Window::flip(const Vector<Gfx::IntRect, 32>& dirty_rects)
         VERIFY(m_back_store);
         memcpy(m_back_store->bitmap().scanline(0), m_front_store->bitmap().scanline(0), m_front_store->bitmap().size_in_bytes());
         m_back_store->bitmap().set_volatile();
+        m_back_store_stale_rects.clear();
         return;
     }
 
-    // Copy whatever was painted from the front to the back.
-    Painter painter(m_back_store->bitmap());
-    for (auto& dirty_rect : dirty_rects)
-        painter.blit(dirty_rect.location(), m_front_store->bitmap(), dirty_rect, 1.0f, false);
+    // Whatever was painted is now missing from the back store. It only gets copied over once we know what the next paint
+    // is going to cover, since windows that keep repainting the same parts (like animations and videos) don't need it at all.
+    m_back_store_stale_rects.clear();
+    m_back_store_stale_rects.add_many(dirty_rects);
 
     m_back_store->bitmap().set_volatile();
 }
 
+void Window::update_back_store(const Vector<Gfx::IntRect, 32>& rects_to_paint)
+{
+    if (m_back_store_stale_rects.is_empty())
+        return;
+    if (!m_front_store || m_front_store->size() != m_back_store->size()) {
+        // This only happens when the entire window is painted anyway.
+        m_back_store_stale_rects.clear();
+        return;
+    }
+
+    // Painting into a window with an alpha channel may blend with what's already there, so that has to be up to date.
+    Gfx::DisjointRectSet painted_rects;
+    if (!m_has_alpha_channel)
+        painted_rects.add_many(rects_to_paint);
+
+    Painter painter(m_back_store->bitmap());
+    for (auto& stale_rect : m_back_store_stale_rects.shatter(painted_rects).rects())
+        painter.blit(stale_rect.location(), m_front_store->bitmap(), stale_rect, 1.0f, false);
+    m_back_store_stale_rects.clear();
+}
+
 OwnPtr<WindowBackingStore> Window::create_backing_store(const Gfx::IntSize& size)
 {
     auto format = m_has_alpha_channel ? Gfx::BitmapFormat::BGRA8888 : Gfx::BitmapFormat::BGRx8888;
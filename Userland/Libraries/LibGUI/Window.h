@@ -15,6 +15,7 @@
 #include <LibGUI/FocusSource.h>
 #include <LibGUI/Forward.h>
 #include <LibGUI/WindowType.h>
+#include <LibGfx/DisjointRectSet.h>
 #include <LibGfx/Forward.h>
 #include <LibGfx/Rect.h>
 #include <LibGfx/StandardCursor.h>
@@ -252,6 +253,7 @@ private:
     OwnPtr<WindowBackingStore> create_backing_store(const Gfx::IntSize&);
     void set_current_backing_store(WindowBackingStore&, bool flush_immediately = false);
     void flip(const Vector<Gfx::IntRect, 32>& dirty_rects);
+    void update_back_store(const Vector<Gfx::IntRect, 32>& rects_to_paint);
     void force_update();
 
     bool are_cursors_the_same(AK::Variant<Gfx::StandardCursor, NonnullRefPtr<Gfx::Bitmap>> const&, AK::Variant<Gfx::StandardCursor, NonnullRefPtr<Gfx::Bitmap>> const&) const;
@@ -260,6 +262,8 @@ private:
 
     OwnPtr<WindowBackingStore> m_front_store;
     OwnPtr<WindowBackingStore> m_back_store;
+    // Where the back store is older than the front store, i.e. what was painted into the front store when it was the back store.
+    Gfx::DisjointRectSet m_back_store_stale_rects;
 
     NonnullRefPtr<Menubar> m_menubar;
 
@@ -131,7 +131,8 @@ ErrorOr<NonnullRefPtr<Bitmap>> Bitmap::try_load_from_file(String const& path, in
 
 ErrorOr<NonnullRefPtr<Bitmap>> Bitmap::try_load_from_fd_and_close(int fd, String const& path)
 {
-    auto file = TRY(Core::MappedFile::map_from_fd_and_close(fd, path));
+    // Image decoders go through the file from start to end.
+    auto file = TRY(Core::MappedFile::map_from_fd_and_close(fd, path, Core::MappedFile::AccessPattern::Sequential));
     if (auto decoder = ImageDecoder::try_create(file->bytes())) {
         auto frame = TRY(decoder->frame(0));
         if (auto& bitmap = frame.image)
@@ -74,6 +74,15 @@ RefPtr<ImageDecoder> ImageDecoder::try_create(ReadonlyBytes bytes)
     return adopt_ref_if_nonnull(new (nothrow) ImageDecoder(plugin.release_nonnull()));
 }
 
+RefPtr<ImageDecoder> ImageDecoder::try_create_incremental(ReadonlyBytes initial_bytes)
+{
+    // FIXME: Teach more of the plugins how to decode incrementally.
+    auto plugin = make<PNGImageDecoderPlugin>();
+    if (plugin->append_data(initial_bytes).is_error() || !plugin->sniff())
+        return {};
+    return adopt_ref_if_nonnull(new (nothrow) ImageDecoder(move(plugin)));
+}
+
 ImageDecoder::ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin> plugin)
     : m_plugin(move(plugin))
 {
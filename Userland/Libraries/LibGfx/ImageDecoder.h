@@ -41,6 +41,18 @@ public:
     virtual size_t frame_count() = 0;
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) = 0;
 
+    // Plugins that support incremental decoding can be created before the whole file has
+    // arrived, and are then handed the rest of it piece by piece with append_data().
+    // frame() only succeeds once finish_data() has been called, but partial_frame() can be
+    // painted in the meantime.
+    virtual bool supports_incremental_decoding() const { return false; }
+    virtual ErrorOr<void> append_data(ReadonlyBytes) { return Error::from_string_literal("ImageDecoderPlugin: Incremental decoding is not supported"sv); }
+    virtual ErrorOr<void> finish_data() { return Error::from_string_literal("ImageDecoderPlugin: Incremental decoding is not supported"sv); }
+
+    // The number of rows at the top of partial_frame() that have been decoded so far.
+    virtual size_t decoded_row_count() { return 0; }
+    virtual ErrorOr<ImageFrameDescriptor> partial_frame() { return Error::from_string_literal("ImageDecoderPlugin: Incremental decoding is not supported"sv); }
+
 protected:
     ImageDecoderPlugin() { }
 };
@@ -48,6 +60,10 @@ protected:
 class ImageDecoder : public RefCounted<ImageDecoder> {
 public:
     static RefPtr<ImageDecoder> try_create(ReadonlyBytes);
+
+    // Returns a decoder that will be fed the rest of the file with append_data(), or null if
+    // the format isn't recognized from the initial bytes or doesn't support incremental decoding.
+    static RefPtr<ImageDecoder> try_create_incremental(ReadonlyBytes initial_bytes);
     ~ImageDecoder();
 
     IntSize size() const { return m_plugin->size(); }
@@ -61,6 +77,12 @@ public:
     size_t frame_count() const { return m_plugin->frame_count(); }
     ErrorOr<ImageFrameDescriptor> frame(size_t index) const { return m_plugin->frame(index); }
 
+    bool supports_incremental_decoding() const { return m_plugin->supports_incremental_decoding(); }
+    ErrorOr<void> append_data(ReadonlyBytes bytes) { return m_plugin->append_data(bytes); }
+    ErrorOr<void> finish_data() { return m_plugin->finish_data(); }
+    size_t decoded_row_count() const { return m_plugin->decoded_row_count(); }
+    ErrorOr<ImageFrameDescriptor> partial_frame() const { return m_plugin->partial_frame(); }
+
 private:
     explicit ImageDecoder(NonnullOwnPtr<ImageDecoderPlugin>);
 
@@ -8,8 +8,12 @@
 #include <AK/HashMap.h>
 #include <AK/Math.h>
 #include <AK/MemoryStream.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/Vector.h>
 #include <LibGfx/JPGLoader.h>
+#include <LibThreading/Thread.h>
 
 #define JPG_INVALID 0X0000
 
@@ -158,7 +162,7 @@ struct HuffmanTableSpec {
 };
 
 struct HuffmanStreamState {
-    Vector<u8> stream;
+    ReadonlyBytes stream;
     u8 bit_offset { 0 };
     size_t byte_offset { 0 };
 };
@@ -185,8 +189,10 @@ struct JPGLoadingContext {
     u16 dc_reset_interval { 0 };
     HashMap<u8, HuffmanTableSpec> dc_tables;
     HashMap<u8, HuffmanTableSpec> ac_tables;
-    HuffmanStreamState huffman_stream;
-    i32 previous_dc_values[3] = { 0 };
+    // The entropy-coded data of the scan, with stuffed bytes and restart markers taken out.
+    Vector<u8> huffman_stream;
+    // Where each restart interval after the first one begins in the huffman stream.
+    Vector<size_t> restart_offsets;
     MacroblockMeta mblock_meta;
 };
 
@@ -271,7 +277,7 @@ static inline i32* get_component(Macroblock& block, unsigned component)
  * macroblocks that share the chrominance data. Next two iterations (assuming that
  * we are dealing with three components) will fill up the blocks with chroma data.
  */
-static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& macroblocks, u32 hcursor, u32 vcursor)
+static bool build_macroblocks(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks, HuffmanStreamState& huffman_stream, i32 (&previous_dc_values)[3], u32 hcursor, u32 vcursor)
 {
     for (unsigned component_i = 0; component_i < context.component_count; component_i++) {
         auto& component = context.components[component_i];
@@ -289,7 +295,7 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                 auto& dc_table = context.dc_tables.find(component.dc_destination_id)->value;
                 auto& ac_table = context.ac_tables.find(component.ac_destination_id)->value;
 
-                auto symbol_or_error = get_next_symbol(context.huffman_stream, dc_table);
+                auto symbol_or_error = get_next_symbol(huffman_stream, dc_table);
                 if (!symbol_or_error.has_value())
                     return false;
 
@@ -300,7 +306,7 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                     return false;
                 }
 
-                auto coeff_or_error = read_huffman_bits(context.huffman_stream, dc_length);
+                auto coeff_or_error = read_huffman_bits(huffman_stream, dc_length);
                 if (!coeff_or_error.has_value())
                     return false;
 
@@ -312,12 +318,12 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                     dc_diff -= (1 << dc_length) - 1;
 
                 auto select_component = get_component(block, component_i);
-                auto& previous_dc = context.previous_dc_values[component_i];
+                auto& previous_dc = previous_dc_values[component_i];
                 select_component[0] = previous_dc += dc_diff;
 
                 // Compute the AC coefficients.
                 for (int j = 1; j < 64;) {
-                    symbol_or_error = get_next_symbol(context.huffman_stream, ac_table);
+                    symbol_or_error = get_next_symbol(huffman_stream, ac_table);
                     if (!symbol_or_error.has_value())
                         return false;
 
@@ -344,7 +350,7 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
                     }
 
                     if (coeff_length != 0) {
-                        coeff_or_error = read_huffman_bits(context.huffman_stream, coeff_length);
+                        coeff_or_error = read_huffman_bits(huffman_stream, coeff_length);
                         if (!coeff_or_error.has_value())
                             return false;
                         i32 ac_coefficient = coeff_or_error.release_value();
@@ -361,6 +367,32 @@ static bool build_macroblocks(JPGLoadingContext& context, Vector<Macroblock>& ma
     return true;
 }
 
+// Used by decode_huffman_stream() to spread the restart intervals of large images over several threads.
+static u32 s_decoding_thread_count = 1;
+static constexpr u32 minimum_mcus_per_decoding_thread = 1024;
+
+// Decodes the MCUs in [first_mcu, end_mcu), which have to start at the beginning of a restart interval
+// (or the scan) and be all there is in huffman_stream.
+static bool decode_huffman_segment(JPGLoadingContext const& context, Vector<Macroblock>& macroblocks, HuffmanStreamState huffman_stream, u32 first_mcu, u32 end_mcu)
+{
+    u32 mcus_per_row = ceil_div(context.mblock_meta.hcount, static_cast<u32>(context.hsample_factor));
+    i32 previous_dc_values[3] = { 0 };
+
+    for (u32 mcu = first_mcu; mcu < end_mcu; ++mcu) {
+        u32 vcursor = (mcu / mcus_per_row) * context.vsample_factor;
+        u32 hcursor = (mcu % mcus_per_row) * context.hsample_factor;
+        if (!build_macroblocks(context, macroblocks, huffman_stream, previous_dc_values, hcursor, vcursor)) {
+            if constexpr (JPG_DEBUG) {
+                dbgln("Failed to build MCU {}", mcu);
+                dbgln("Huffman stream byte offset {}", huffman_stream.byte_offset);
+                dbgln("Huffman stream bit offset {}", huffman_stream.bit_offset);
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
 static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& context)
 {
     Vector<Macroblock> macroblocks;
@@ -381,40 +413,63 @@ static Optional<Vector<Macroblock>> decode_huffman_stream(JPGLoadingContext& con
     for (auto it = context.ac_tables.begin(); it != context.ac_tables.end(); ++it)
         generate_huffman_codes(it->value);
 
-    for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
-        for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
-            u32 i = vcursor * context.mblock_meta.hpadded_count + hcursor;
-            if (context.dc_reset_interval > 0) {
-                if (i % context.dc_reset_interval == 0) {
-                    context.previous_dc_values[0] = 0;
-                    context.previous_dc_values[1] = 0;
-                    context.previous_dc_values[2] = 0;
-
-                    // Restart markers are stored in byte boundaries. Advance the huffman stream cursor to
-                    //  the 0th bit of the next byte.
-                    if (context.huffman_stream.byte_offset < context.huffman_stream.stream.size()) {
-                        if (context.huffman_stream.bit_offset > 0) {
-                            context.huffman_stream.bit_offset = 0;
-                            context.huffman_stream.byte_offset++;
-                        }
+    if (context.hsample_factor == 0 || context.vsample_factor == 0) {
+        dbgln_if(JPG_DEBUG, "No sampling factors, was there no frame?");
+        return {};
+    }
 
-                        // Skip the restart marker (RSTn).
-                        context.huffman_stream.byte_offset++;
-                    }
-                }
-            }
+    u32 mcu_count = ceil_div(context.mblock_meta.hcount, static_cast<u32>(context.hsample_factor))
+        * ceil_div(context.mblock_meta.vcount, static_cast<u32>(context.vsample_factor));
 
-            if (!build_macroblocks(context, macroblocks, hcursor, vcursor)) {
-                if constexpr (JPG_DEBUG) {
-                    dbgln("Failed to build Macroblock {}", i);
-                    dbgln("Huffman stream byte offset {}", context.huffman_stream.byte_offset);
-                    dbgln("Huffman stream bit offset {}", context.huffman_stream.bit_offset);
-                }
-                return {};
-            }
+    // Every restart interval starts out with fresh DC predictions on a byte boundary of its own,
+    // so each one can be decoded without knowing anything about the ones before it.
+    u32 mcus_per_segment = context.dc_reset_interval > 0 ? context.dc_reset_interval : mcu_count;
+    u32 segment_count = ceil_div(mcu_count, mcus_per_segment);
+    if (segment_count > context.restart_offsets.size() + 1) {
+        dbgln_if(JPG_DEBUG, "Expected {} restart intervals, but only found {}!", segment_count, context.restart_offsets.size() + 1);
+        return {};
+    }
+
+    auto decode_segments = [&](u32 first_segment, u32 end_segment) {
+        for (u32 segment = first_segment; segment < end_segment; ++segment) {
+            size_t start_offset = segment == 0 ? 0 : context.restart_offsets[segment - 1];
+            size_t end_offset = segment < context.restart_offsets.size() ? context.restart_offsets[segment] : context.huffman_stream.size();
+            HuffmanStreamState huffman_stream { context.huffman_stream.span().slice(start_offset, end_offset - start_offset) };
+            u32 first_mcu = segment * mcus_per_segment;
+            if (!decode_huffman_segment(context, macroblocks, huffman_stream, first_mcu, min(first_mcu + mcus_per_segment, mcu_count)))
+                return false;
         }
+        return true;
+    };
+
+    // NOTE: The segments only ever touch the macroblocks of their own MCUs, so the threads don't need to synchronize.
+    u32 thread_count = min(min(s_decoding_thread_count, segment_count), max(mcu_count / minimum_mcus_per_decoding_thread, 1u));
+    if (thread_count <= 1) {
+        if (!decode_segments(0, segment_count))
+            return {};
+        return macroblocks;
+    }
+
+    auto segments_per_thread = ceil_div(segment_count, thread_count);
+    Vector<bool> thread_succeeded;
+    thread_succeeded.resize(thread_count);
+    NonnullRefPtrVector<Threading::Thread> threads;
+    for (u32 i = 1; i < thread_count; ++i) {
+        auto thread = Threading::Thread::construct([&, i] {
+            thread_succeeded[i] = decode_segments(i * segments_per_thread, min((i + 1) * segments_per_thread, segment_count));
+            return 0;
+        },
+            "JPG decoder"sv);
+        thread->start();
+        threads.append(move(thread));
     }
 
+    thread_succeeded[0] = decode_segments(0, segments_per_thread);
+    for (auto& thread : threads)
+        (void)thread.join();
+
+    if (thread_succeeded.contains_slow(false))
+        return {};
     return macroblocks;
 }
 
@@ -862,7 +917,25 @@ static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macrobloc
     }
 }
 
-static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+// NOTE: These helpers never leave this file, so we don't care about vectors being passed differently without SSE.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+ALWAYS_INLINE static AK::SIMD::i32x4 load_i32x4(i32 const* data)
+{
+    AK::SIMD::i32x4 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+ALWAYS_INLINE static void store_i32x4(i32* data, AK::SIMD::i32x4 value)
+{
+    __builtin_memcpy(data, &value, sizeof(value));
+}
+
+// One-dimensional 8-point IDCT of `in`, with T being either float or a vector of them.
+template<typename T>
+ALWAYS_INLINE static void inverse_dct_8(T const (&in)[8], T (&out)[8])
 {
     static const float m0 = 2.0 * AK::cos(1.0 / 16.0 * 2.0 * AK::Pi<double>);
     static const float m1 = 2.0 * AK::cos(2.0 / 16.0 * 2.0 * AK::Pi<double>);
@@ -879,6 +952,98 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
     static const float s6 = AK::cos(6.0 / 16.0 * AK::Pi<double>) / 2.0;
     static const float s7 = AK::cos(7.0 / 16.0 * AK::Pi<double>) / 2.0;
 
+    const T g0 = in[0] * s0;
+    const T g1 = in[4] * s4;
+    const T g2 = in[2] * s2;
+    const T g3 = in[6] * s6;
+    const T g4 = in[5] * s5;
+    const T g5 = in[1] * s1;
+    const T g6 = in[7] * s7;
+    const T g7 = in[3] * s3;
+
+    const T f0 = g0;
+    const T f1 = g1;
+    const T f2 = g2;
+    const T f3 = g3;
+    const T f4 = g4 - g7;
+    const T f5 = g5 + g6;
+    const T f6 = g5 - g6;
+    const T f7 = g4 + g7;
+
+    const T e0 = f0;
+    const T e1 = f1;
+    const T e2 = f2 - f3;
+    const T e3 = f2 + f3;
+    const T e4 = f4;
+    const T e5 = f5 - f7;
+    const T e6 = f6;
+    const T e7 = f5 + f7;
+    const T e8 = f4 + f6;
+
+    const T d0 = e0;
+    const T d1 = e1;
+    const T d2 = e2 * m1;
+    const T d3 = e3;
+    const T d4 = e4 * m2;
+    const T d5 = e5 * m3;
+    const T d6 = e6 * m4;
+    const T d7 = e7;
+    const T d8 = e8 * m5;
+
+    const T c0 = d0 + d1;
+    const T c1 = d0 - d1;
+    const T c2 = d2 - d3;
+    const T c3 = d3;
+    const T c4 = d4 + d8;
+    const T c5 = d5 + d7;
+    const T c6 = d6 - d8;
+    const T c7 = d7;
+    const T c8 = c5 - c6;
+
+    const T b0 = c0 + c3;
+    const T b1 = c1 + c2;
+    const T b2 = c1 - c2;
+    const T b3 = c0 - c3;
+    const T b4 = c4 - c8;
+    const T b5 = c8;
+    const T b6 = c6 - c7;
+    const T b7 = c7;
+
+    out[0] = b0 + b7;
+    out[1] = b1 + b6;
+    out[2] = b2 + b5;
+    out[3] = b3 + b4;
+    out[4] = b3 - b4;
+    out[5] = b2 - b5;
+    out[6] = b1 - b6;
+    out[7] = b0 - b7;
+}
+
+// Transforms the columns of the 8x8 block, four of them at a time.
+static void inverse_dct_columns(i32* block_component)
+{
+    using namespace AK::SIMD;
+    for (u32 k = 0; k < 8; k += 4) {
+        f32x4 in[8];
+        f32x4 out[8];
+        for (u32 row = 0; row < 8; ++row)
+            in[row] = to_f32x4(load_i32x4(&block_component[row * 8 + k]));
+        inverse_dct_8(in, out);
+        for (u32 row = 0; row < 8; ++row)
+            store_i32x4(&block_component[row * 8 + k], to_i32x4(out[row]));
+    }
+}
+
+static void transpose_block(i32* block_component)
+{
+    for (u32 row = 0; row < 8; ++row) {
+        for (u32 column = row + 1; column < 8; ++column)
+            swap(block_component[row * 8 + column], block_component[column * 8 + row]);
+    }
+}
+
+static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (u32 component_i = 0; component_i < context.component_count; component_i++) {
@@ -888,140 +1053,11 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
                         u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[mb_index];
                         i32* block_component = get_component(block, component_i);
-                        for (u32 k = 0; k < 8; ++k) {
-                            const float g0 = block_component[0 * 8 + k] * s0;
-                            const float g1 = block_component[4 * 8 + k] * s4;
-                            const float g2 = block_component[2 * 8 + k] * s2;
-                            const float g3 = block_component[6 * 8 + k] * s6;
-                            const float g4 = block_component[5 * 8 + k] * s5;
-                            const float g5 = block_component[1 * 8 + k] * s1;
-                            const float g6 = block_component[7 * 8 + k] * s7;
-                            const float g7 = block_component[3 * 8 + k] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            const float g0 = block_component[l * 8 + 0] * s0;
-                            const float g1 = block_component[l * 8 + 4] * s4;
-                            const float g2 = block_component[l * 8 + 2] * s2;
-                            const float g3 = block_component[l * 8 + 6] * s6;
-                            const float g4 = block_component[l * 8 + 5] * s5;
-                            const float g5 = block_component[l * 8 + 1] * s1;
-                            const float g6 = block_component[l * 8 + 7] * s7;
-                            const float g7 = block_component[l * 8 + 3] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
+                        // The rows are done as columns of the transposed block, so that they can be vectorized the same way.
+                        inverse_dct_columns(block_component);
+                        transpose_block(block_component);
+                        inverse_dct_columns(block_component);
+                        transpose_block(block_component);
                     }
                 }
             }
@@ -1029,8 +1065,16 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
     }
 }
 
+ALWAYS_INLINE static AK::SIMD::i32x4 clamp_to_u8_range(AK::SIMD::i32x4 value)
+{
+    using namespace AK::SIMD;
+    value = value < expand4(0) ? expand4(0) : value;
+    return value > expand4(255) ? expand4(255) : value;
+}
+
 static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
 {
+    using namespace AK::SIMD;
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
@@ -1042,18 +1086,29 @@ static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& m
                     i32* y = macroblocks[mb_index].y;
                     i32* cb = macroblocks[mb_index].cb;
                     i32* cr = macroblocks[mb_index].cr;
+                    // NOTE: The chroma block may be the one we're writing to, but going backwards (four pixels
+                    //       at a time) means we never read chroma values we've already overwritten.
                     for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
+                        for (u8 j = 4; j < 8; j -= 4) {
                             const u8 pixel = i * 8 + j;
                             const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
-                            const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
-                            const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
-                            int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
-                            int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
-                            int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+                            i32x4 chroma_cb;
+                            i32x4 chroma_cr;
+                            for (u8 lane = 0; lane < 4; ++lane) {
+                                const u32 chroma_pxcol = ((j + lane) / context.hsample_factor) + 4 * hfactor_i;
+                                const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
+                                chroma_cb[lane] = chroma.cb[chroma_pixel];
+                                chroma_cr[lane] = chroma.cr[chroma_pixel];
+                            }
+                            const f32x4 luma = to_f32x4(load_i32x4(&y[pixel]));
+                            const f32x4 blue_difference = to_f32x4(chroma_cb);
+                            const f32x4 red_difference = to_f32x4(chroma_cr);
+                            i32x4 r = to_i32x4(luma + 1.402f * red_difference + 128.0f);
+                            i32x4 g = to_i32x4(luma - 0.344f * blue_difference - 0.714f * red_difference + 128.0f);
+                            i32x4 b = to_i32x4(luma + 1.772f * blue_difference + 128.0f);
+                            store_i32x4(&y[pixel], clamp_to_u8_range(r));
+                            store_i32x4(&cb[pixel], clamp_to_u8_range(g));
+                            store_i32x4(&cr[pixel], clamp_to_u8_range(b));
                         }
                     }
                 }
@@ -1062,6 +1117,8 @@ static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& m
     }
 }
 
+#pragma GCC diagnostic pop
+
 static bool compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks)
 {
     auto bitmap_or_error = Bitmap::try_create(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
@@ -1177,14 +1234,14 @@ static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& co
                 stream >> current_byte;
                 if (stream.handle_any_error())
                     return false;
-                context.huffman_stream.stream.append(last_byte);
+                context.huffman_stream.append(last_byte);
                 continue;
             }
             Marker marker = 0xFF00 | current_byte;
             if (marker == JPG_EOI)
                 return true;
             if (marker >= JPG_RST0 && marker <= JPG_RST7) {
-                context.huffman_stream.stream.append(marker);
+                context.restart_offsets.append(context.huffman_stream.size());
                 stream >> current_byte;
                 if (stream.handle_any_error())
                     return false;
@@ -1193,7 +1250,7 @@ static bool scan_huffman_stream(InputMemoryStream& stream, JPGLoadingContext& co
             dbgln_if(JPG_DEBUG, "{}: Invalid marker: {:x}!", stream.offset(), marker);
             return false;
         } else {
-            context.huffman_stream.stream.append(last_byte);
+            context.huffman_stream.append(last_byte);
         }
     }
 
@@ -1229,7 +1286,12 @@ JPGImageDecoderPlugin::JPGImageDecoderPlugin(const u8* data, size_t size)
     m_context = make<JPGLoadingContext>();
     m_context->data = data;
     m_context->data_size = size;
-    m_context->huffman_stream.stream.ensure_capacity(50 * KiB);
+    m_context->huffman_stream.ensure_capacity(50 * KiB);
+}
+
+void JPGImageDecoderPlugin::set_decoding_thread_count(size_t thread_count)
+{
+    s_decoding_thread_count = static_cast<u32>(clamp(thread_count, 1, 16));
 }
 
 JPGImageDecoderPlugin::~JPGImageDecoderPlugin()
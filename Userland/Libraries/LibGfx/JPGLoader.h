@@ -16,6 +16,11 @@ class JPGImageDecoderPlugin : public ImageDecoderPlugin {
 public:
     virtual ~JPGImageDecoderPlugin() override;
     JPGImageDecoderPlugin(const u8*, size_t);
+
+    // Images with restart intervals may be decoded on up to this many threads (1 by default).
+    // NOTE: Anything above 1 requires the "thread" pledge.
+    static void set_decoding_thread_count(size_t);
+
     virtual IntSize size() override;
     virtual void set_volatile() override;
     [[nodiscard]] virtual bool set_nonvolatile(bool& was_purged) override;
@@ -6,17 +6,22 @@
 
 #include <AK/Debug.h>
 #include <AK/Endian.h>
+#include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/Vector.h>
+#include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
 #include <LibGfx/PNGLoader.h>
 #include <string.h>
 
-#ifdef __serenity__
-#    include <LibCompress/Deflate.h>
-#endif
-
 namespace Gfx {
 
+using AK::SIMD::i16x4;
+using AK::SIMD::i16x8;
+using AK::SIMD::u8x16;
+using AK::SIMD::u8x4;
+using AK::SIMD::u8x8;
+
 static const u8 png_header[8] = { 0x89, 'P', 'N', 'G', 13, 10, 26, 10 };
 
 struct PNG_IHDR {
@@ -31,11 +36,6 @@ struct PNG_IHDR {
 
 static_assert(AssertSize<PNG_IHDR, 13>());
 
-struct Scanline {
-    u8 filter { 0 };
-    ReadonlyBytes data {};
-};
-
 struct [[gnu::packed]] PaletteEntry {
     u8 r;
     u8 g;
@@ -43,29 +43,6 @@ struct [[gnu::packed]] PaletteEntry {
     // u8 a;
 };
 
-template<typename T>
-struct [[gnu::packed]] Tuple {
-    T gray;
-    T a;
-};
-
-template<typename T>
-struct [[gnu::packed]] Triplet {
-    T r;
-    T g;
-    T b;
-
-    bool operator==(Triplet const& other) const = default;
-};
-
-template<typename T>
-struct [[gnu::packed]] Quad {
-    T r;
-    T g;
-    T b;
-    T a;
-};
-
 enum PngInterlaceMethod {
     Null = 0,
     Adam7 = 1
@@ -93,13 +70,19 @@ struct PNGLoadingContext {
     u8 channels { 0 };
     bool has_seen_zlib_header { false };
     bool has_alpha() const { return color_type & 4 || palette_transparency_data.size() > 0; }
-    Vector<Scanline> scanlines;
     RefPtr<Gfx::Bitmap> bitmap;
     ByteBuffer* decompression_buffer { nullptr };
     Vector<u8> compressed_data;
     Vector<PaletteEntry> palette_data;
     Vector<u8> palette_transparency_data;
 
+    // Incremental decoding: bytes that don't make up a complete chunk yet, and how far
+    // the partially decoded bitmap has gotten.
+    bool is_incremental { false };
+    Vector<u8> pending_data;
+    size_t compressed_size_at_last_partial_decode { 0 };
+    size_t partially_decoded_row_count { 0 };
+
     Checked<int> compute_row_size_for_width(int width)
     {
         Checked<int> row_size = width;
@@ -176,333 +159,239 @@ ALWAYS_INLINE static u8 paeth_predictor(int a, int b, int c)
     return c;
 }
 
-union [[gnu::packed]] Pixel {
-    ARGB32 rgba { 0 };
-    u8 v[4];
-    struct {
-        u8 r;
-        u8 g;
-        u8 b;
-        u8 a;
+// Every filter predicts a byte from the same byte of the pixel to the left (a), of the pixel above (b), and of the pixel above
+// and to the left of it (c). So only the pixels of a scanline have to be unfiltered one after another, the bytes of each pixel
+// can be unfiltered all at once. VectorType has to be exactly one pixel large.
+template<typename VectorType, typename WideVectorType>
+ALWAYS_INLINE static void unfilter_scanline_by_pixel(u8 filter, Bytes scanline, ReadonlyBytes previous_scanline)
+{
+    auto load = [](u8 const* data) {
+        VectorType vector;
+        __builtin_memcpy(&vector, data, sizeof(vector));
+        return vector;
+    };
+    auto absolute = [](WideVectorType vector) {
+        auto sign = vector >> 15;
+        return (vector ^ sign) - sign;
     };
-};
-static_assert(AssertSize<Pixel, 4>());
 
-template<bool has_alpha, u8 filter_type>
-ALWAYS_INLINE static void unfilter_impl(Gfx::Bitmap& bitmap, int y, const void* dummy_scanline_data)
-{
-    auto* dummy_scanline = (const Pixel*)dummy_scanline_data;
-    if constexpr (filter_type == 0) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
+    u8* data = scanline.data();
+    u8 const* previous_data = previous_scanline.data();
+    VectorType a {};
+    VectorType c {};
+    for (size_t i = 0; i < scanline.size(); i += sizeof(VectorType)) {
+        auto x = load(data + i);
+        if (filter == 1) {
+            a = x + a;
+        } else if (filter == 3) {
+            auto b = load(previous_data + i);
+            // The average of a and b, without it overflowing a byte.
+            a = x + ((a & b) + ((a ^ b) >> 1));
+        } else if (filter == 4) {
+            auto b = load(previous_data + i);
+            auto wide_a = __builtin_convertvector(a, WideVectorType);
+            auto wide_b = __builtin_convertvector(b, WideVectorType);
+            auto wide_c = __builtin_convertvector(c, WideVectorType);
+            // The distances of a + b - c to a, b and c, see paeth_predictor().
+            auto pa = absolute(wide_b - wide_c);
+            auto pb = absolute(wide_a - wide_c);
+            auto pc = absolute(wide_a + wide_b - 2 * wide_c);
+            auto use_a = (pa <= pb) & (pa <= pc);
+            auto use_b = pb <= pc;
+            auto prediction = (use_a & wide_a) | (~use_a & ((use_b & wide_b) | (~use_b & wide_c)));
+            a = x + __builtin_convertvector(prediction, VectorType);
+            c = b;
         }
+        __builtin_memcpy(data + i, &a, sizeof(a));
     }
+}
 
-    if constexpr (filter_type == 1) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        swap(pixels[0].r, pixels[0].b);
-        for (int i = 1; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            auto& a = (const Pixel&)pixels[i - 1];
-            x.v[0] += a.v[0];
-            x.v[1] += a.v[1];
-            x.v[2] += a.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += a.v[3];
-        }
-        return;
-    }
-    if constexpr (filter_type == 2) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (const Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            const Pixel& b = pixels_y_minus_1[i];
-            x.v[0] += b.v[0];
-            x.v[1] += b.v[1];
-            x.v[2] += b.v[2];
-            if constexpr (has_alpha)
-                x.v[3] += b.v[3];
-        }
-        return;
-    }
-    if constexpr (filter_type == 3) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (const Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            if (i != 0)
-                a = pixels[i - 1];
-            const Pixel& b = pixels_y_minus_1[i];
-            x.v[0] = x.v[0] + ((a.v[0] + b.v[0]) / 2);
-            x.v[1] = x.v[1] + ((a.v[1] + b.v[1]) / 2);
-            x.v[2] = x.v[2] + ((a.v[2] + b.v[2]) / 2);
-            if constexpr (has_alpha)
-                x.v[3] = x.v[3] + ((a.v[3] + b.v[3]) / 2);
-        }
-        return;
-    }
-    if constexpr (filter_type == 4) {
-        auto* pixels = (Pixel*)bitmap.scanline(y);
-        auto* pixels_y_minus_1 = y == 0 ? dummy_scanline : (Pixel*)bitmap.scanline(y - 1);
-        for (int i = 0; i < bitmap.width(); ++i) {
-            auto& x = pixels[i];
-            swap(x.r, x.b);
-            Pixel a;
-            const Pixel& b = pixels_y_minus_1[i];
-            Pixel c;
-            if (i != 0) {
-                a = pixels[i - 1];
-                c = pixels_y_minus_1[i - 1];
-            }
-            x.v[0] += paeth_predictor(a.v[0], b.v[0], c.v[0]);
-            x.v[1] += paeth_predictor(a.v[1], b.v[1], c.v[1]);
-            x.v[2] += paeth_predictor(a.v[2], b.v[2], c.v[2]);
-            if constexpr (has_alpha)
-                x.v[3] += paeth_predictor(a.v[3], b.v[3], c.v[3]);
-        }
+// Pixels that don't fit a vector nicely are better off unfiltered a byte at a time.
+template<size_t bytes_per_complete_pixel>
+ALWAYS_INLINE static void unfilter_scanline_by_byte(u8 filter, Bytes scanline, ReadonlyBytes previous_scanline)
+{
+    u8* data = scanline.data();
+    u8 const* previous_data = previous_scanline.data();
+    for (size_t i = 0; i < scanline.size(); ++i) {
+        u8 a = i >= bytes_per_complete_pixel ? data[i - bytes_per_complete_pixel] : 0;
+        u8 b = previous_data[i];
+        u8 c = i >= bytes_per_complete_pixel ? previous_data[i - bytes_per_complete_pixel] : 0;
+        if (filter == 1)
+            data[i] += a;
+        else if (filter == 3)
+            data[i] += (a + b) / 2;
+        else if (filter == 4)
+            data[i] += paeth_predictor(a, b, c);
     }
 }
 
-template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_without_alpha(PNGLoadingContext& context)
+static void unfilter_up(Bytes scanline, ReadonlyBytes previous_scanline)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* gray_values = reinterpret_cast<const T*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = gray_values[i];
-            pixel.g = gray_values[i];
-            pixel.b = gray_values[i];
-            pixel.a = 0xff;
-        }
+    u8* data = scanline.data();
+    u8 const* previous_data = previous_scanline.data();
+    size_t i = 0;
+    for (; i + sizeof(u8x16) <= scanline.size(); i += sizeof(u8x16)) {
+        u8x16 x;
+        u8x16 b;
+        __builtin_memcpy(&x, data + i, sizeof(x));
+        __builtin_memcpy(&b, previous_data + i, sizeof(b));
+        x += b;
+        __builtin_memcpy(data + i, &x, sizeof(x));
     }
+    for (; i < scanline.size(); ++i)
+        data[i] += previous_data[i];
 }
 
-template<typename T>
-ALWAYS_INLINE static void unpack_grayscale_with_alpha(PNGLoadingContext& context)
+// Undoes the filter of a scanline in place. The previous scanline has to be there even for the first one, as zeroes.
+static void unfilter_scanline(u8 filter, Bytes scanline, ReadonlyBytes previous_scanline, size_t bytes_per_complete_pixel)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* tuples = reinterpret_cast<const Tuple<T>*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = tuples[i].gray;
-            pixel.g = tuples[i].gray;
-            pixel.b = tuples[i].gray;
-            pixel.a = tuples[i].a;
-        }
+    VERIFY(previous_scanline.size() >= scanline.size());
+    if (filter == 0)
+        return;
+    if (filter == 2) {
+        unfilter_up(scanline, previous_scanline);
+        return;
+    }
+
+    switch (bytes_per_complete_pixel) {
+    case 1:
+        unfilter_scanline_by_byte<1>(filter, scanline, previous_scanline);
+        break;
+    case 2:
+        unfilter_scanline_by_byte<2>(filter, scanline, previous_scanline);
+        break;
+    case 3:
+        unfilter_scanline_by_byte<3>(filter, scanline, previous_scanline);
+        break;
+    case 4:
+        unfilter_scanline_by_pixel<u8x4, i16x4>(filter, scanline, previous_scanline);
+        break;
+    case 6:
+        unfilter_scanline_by_byte<6>(filter, scanline, previous_scanline);
+        break;
+    case 8:
+        unfilter_scanline_by_pixel<u8x8, i16x8>(filter, scanline, previous_scanline);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
     }
 }
 
-template<typename T>
-ALWAYS_INLINE static void unpack_triplets_without_alpha(PNGLoadingContext& context)
+ALWAYS_INLINE static ARGB32 make_argb(u8 r, u8 g, u8 b, u8 a)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<const Triplet<T>*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            pixel.a = 0xff;
-        }
+    return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Samples are stored most significant bit (or byte) first. Only the most significant byte of 16-bit samples ends up in the bitmap.
+template<u8 bit_depth>
+ALWAYS_INLINE static u16 sample_at(ReadonlyBytes scanline, size_t index)
+{
+    if constexpr (bit_depth == 16) {
+        return (scanline[index * 2] << 8) | scanline[index * 2 + 1];
+    } else if constexpr (bit_depth == 8) {
+        return scanline[index];
+    } else {
+        constexpr size_t samples_per_byte = 8 / bit_depth;
+        auto bit_offset = (8 - bit_depth) - (bit_depth * (index % samples_per_byte));
+        return (scanline[index / samples_per_byte] >> bit_offset) & ((1 << bit_depth) - 1);
     }
 }
 
-template<typename T>
-ALWAYS_INLINE static void unpack_triplets_with_transparency_value(PNGLoadingContext& context, Triplet<T> transparency_value)
+template<u8 bit_depth>
+ALWAYS_INLINE static u8 sample_to_byte(u16 sample)
 {
-    for (int y = 0; y < context.height; ++y) {
-        auto* triplets = reinterpret_cast<const Triplet<T>*>(context.scanlines[y].data.data());
-        for (int i = 0; i < context.width; ++i) {
-            auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-            pixel.r = triplets[i].r;
-            pixel.g = triplets[i].g;
-            pixel.b = triplets[i].b;
-            if (triplets[i] == transparency_value)
-                pixel.a = 0x00;
-            else
-                pixel.a = 0xff;
-        }
+    if constexpr (bit_depth == 16) {
+        return sample >> 8;
+    } else {
+        // Scale the sample up to the full range of a byte, e.g. 0b11 becomes 0xff at a bit depth of 2.
+        return sample * (0xff / ((1 << bit_depth) - 1));
     }
 }
 
-NEVER_INLINE FLATTEN static ErrorOr<void> unfilter(PNGLoadingContext& context)
+template<u8 bit_depth>
+static ErrorOr<void> unpack_scanline(PNGLoadingContext const& context, ReadonlyBytes scanline, int width, ARGB32* destination, int step)
 {
-    // First unpack the scanlines to RGBA:
+    auto const& transparency_data = context.palette_transparency_data;
+
     switch (context.color_type) {
-    case 0:
-        if (context.bit_depth == 8) {
-            unpack_grayscale_without_alpha<u8>(context);
-        } else if (context.bit_depth == 16) {
-            unpack_grayscale_without_alpha<u16>(context);
-        } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
-            auto bit_depth_squared = context.bit_depth * context.bit_depth;
-            auto pixels_per_byte = 8 / context.bit_depth;
-            auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* gray_values = context.scanlines[y].data.data();
-                for (int x = 0; x < context.width; ++x) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (x % pixels_per_byte));
-                    auto value = (gray_values[x / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[x];
-                    pixel.r = value * (0xff / bit_depth_squared);
-                    pixel.g = value * (0xff / bit_depth_squared);
-                    pixel.b = value * (0xff / bit_depth_squared);
-                    pixel.a = 0xff;
-                }
-            }
-        } else {
-            VERIFY_NOT_REACHED();
+    case 0: {
+        Optional<u16> transparent_gray;
+        if (transparency_data.size() == 2)
+            transparent_gray = (transparency_data[0] << 8) | transparency_data[1];
+        for (int i = 0; i < width; ++i) {
+            auto gray = sample_at<bit_depth>(scanline, i);
+            auto value = sample_to_byte<bit_depth>(gray);
+            destination[i * step] = make_argb(value, value, value, transparent_gray.has_value() && gray == transparent_gray.value() ? 0x00 : 0xff);
         }
         break;
-    case 4:
-        if (context.bit_depth == 8) {
-            unpack_grayscale_with_alpha<u8>(context);
-        } else if (context.bit_depth == 16) {
-            unpack_grayscale_with_alpha<u16>(context);
-        } else {
-            VERIFY_NOT_REACHED();
+    }
+    case 2: {
+        Optional<Array<u16, 3>> transparent_color;
+        if (transparency_data.size() == 6) {
+            transparent_color = Array<u16, 3> {
+                static_cast<u16>((transparency_data[0] << 8) | transparency_data[1]),
+                static_cast<u16>((transparency_data[2] << 8) | transparency_data[3]),
+                static_cast<u16>((transparency_data[4] << 8) | transparency_data[5]),
+            };
+        }
+        for (int i = 0; i < width; ++i) {
+            auto r = sample_at<bit_depth>(scanline, i * 3);
+            auto g = sample_at<bit_depth>(scanline, i * 3 + 1);
+            auto b = sample_at<bit_depth>(scanline, i * 3 + 2);
+            bool is_transparent = transparent_color.has_value() && transparent_color.value() == Array<u16, 3> { r, g, b };
+            destination[i * step] = make_argb(sample_to_byte<bit_depth>(r), sample_to_byte<bit_depth>(g), sample_to_byte<bit_depth>(b), is_transparent ? 0x00 : 0xff);
         }
         break;
-    case 2:
-        if (context.palette_transparency_data.size() == 6) {
-            if (context.bit_depth == 8) {
-                unpack_triplets_with_transparency_value<u8>(context, Triplet<u8> { context.palette_transparency_data[0], context.palette_transparency_data[2], context.palette_transparency_data[4] });
-            } else if (context.bit_depth == 16) {
-                u16 tr = context.palette_transparency_data[0] | context.palette_transparency_data[1] << 8;
-                u16 tg = context.palette_transparency_data[2] | context.palette_transparency_data[3] << 8;
-                u16 tb = context.palette_transparency_data[4] | context.palette_transparency_data[5] << 8;
-                unpack_triplets_with_transparency_value<u16>(context, Triplet<u16> { tr, tg, tb });
-            } else {
-                VERIFY_NOT_REACHED();
-            }
-        } else {
-            if (context.bit_depth == 8)
-                unpack_triplets_without_alpha<u8>(context);
-            else if (context.bit_depth == 16)
-                unpack_triplets_without_alpha<u16>(context);
-            else
-                VERIFY_NOT_REACHED();
+    }
+    case 3:
+        for (int i = 0; i < width; ++i) {
+            auto palette_index = sample_at<bit_depth>(scanline, i);
+            if (palette_index >= context.palette_data.size())
+                return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range"sv);
+            auto& color = context.palette_data[palette_index];
+            u8 alpha = palette_index < transparency_data.size() ? transparency_data[palette_index] : 0xff;
+            destination[i * step] = make_argb(color.r, color.g, color.b, alpha);
         }
         break;
-    case 6:
-        if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                memcpy(context.bitmap->scanline(y), context.scanlines[y].data.data(), context.scanlines[y].data.size());
-            }
-        } else if (context.bit_depth == 16) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* triplets = reinterpret_cast<const Quad<u16>*>(context.scanlines[y].data.data());
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    pixel.r = triplets[i].r & 0xFF;
-                    pixel.g = triplets[i].g & 0xFF;
-                    pixel.b = triplets[i].b & 0xFF;
-                    pixel.a = triplets[i].a & 0xFF;
-                }
-            }
-        } else {
-            VERIFY_NOT_REACHED();
+    case 4:
+        for (int i = 0; i < width; ++i) {
+            auto gray = sample_to_byte<bit_depth>(sample_at<bit_depth>(scanline, i * 2));
+            auto alpha = sample_to_byte<bit_depth>(sample_at<bit_depth>(scanline, i * 2 + 1));
+            destination[i * step] = make_argb(gray, gray, gray, alpha);
         }
         break;
-    case 3:
-        if (context.bit_depth == 8) {
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_index = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if (palette_index[i] >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range"sv);
-                    auto& color = context.palette_data.at((int)palette_index[i]);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index[i] + 1u
-                        ? context.palette_transparency_data.data()[palette_index[i]]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
-            }
-        } else if (context.bit_depth == 1 || context.bit_depth == 2 || context.bit_depth == 4) {
-            auto pixels_per_byte = 8 / context.bit_depth;
-            auto mask = (1 << context.bit_depth) - 1;
-            for (int y = 0; y < context.height; ++y) {
-                auto* palette_indices = context.scanlines[y].data.data();
-                for (int i = 0; i < context.width; ++i) {
-                    auto bit_offset = (8 - context.bit_depth) - (context.bit_depth * (i % pixels_per_byte));
-                    auto palette_index = (palette_indices[i / pixels_per_byte] >> bit_offset) & mask;
-                    auto& pixel = (Pixel&)context.bitmap->scanline(y)[i];
-                    if ((size_t)palette_index >= context.palette_data.size())
-                        return Error::from_string_literal("PNGImageDecoderPlugin: Palette index out of range"sv);
-                    auto& color = context.palette_data.at(palette_index);
-                    auto transparency = context.palette_transparency_data.size() >= palette_index + 1u
-                        ? context.palette_transparency_data.data()[palette_index]
-                        : 0xff;
-                    pixel.r = color.r;
-                    pixel.g = color.g;
-                    pixel.b = color.b;
-                    pixel.a = transparency;
-                }
-            }
-        } else {
-            VERIFY_NOT_REACHED();
+    case 6:
+        for (int i = 0; i < width; ++i) {
+            auto r = sample_to_byte<bit_depth>(sample_at<bit_depth>(scanline, i * 4));
+            auto g = sample_to_byte<bit_depth>(sample_at<bit_depth>(scanline, i * 4 + 1));
+            auto b = sample_to_byte<bit_depth>(sample_at<bit_depth>(scanline, i * 4 + 2));
+            auto a = sample_to_byte<bit_depth>(sample_at<bit_depth>(scanline, i * 4 + 3));
+            destination[i * step] = make_argb(r, g, b, a);
         }
         break;
     default:
         VERIFY_NOT_REACHED();
-        break;
     }
+    return {};
+}
 
-    u8 dummy_scanline[context.width * sizeof(ARGB32)];
-    memset(dummy_scanline, 0, sizeof(dummy_scanline));
-
-    for (int y = 0; y < context.height; ++y) {
-        auto filter = context.scanlines[y].filter;
-        if (filter == 0) {
-            if (context.has_alpha())
-                unfilter_impl<true, 0>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 0>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 1) {
-            if (context.has_alpha())
-                unfilter_impl<true, 1>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 1>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 2) {
-            if (context.has_alpha())
-                unfilter_impl<true, 2>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 2>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 3) {
-            if (context.has_alpha())
-                unfilter_impl<true, 3>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 3>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
-        if (filter == 4) {
-            if (context.has_alpha())
-                unfilter_impl<true, 4>(*context.bitmap, y, dummy_scanline);
-            else
-                unfilter_impl<false, 4>(*context.bitmap, y, dummy_scanline);
-            continue;
-        }
+// Unpacks an unfiltered scanline of the given width to every `step`th pixel starting at `destination`.
+static ErrorOr<void> unpack_scanline(PNGLoadingContext const& context, ReadonlyBytes scanline, int width, ARGB32* destination, int step)
+{
+    switch (context.bit_depth) {
+    case 1:
+        return unpack_scanline<1>(context, scanline, width, destination, step);
+    case 2:
+        return unpack_scanline<2>(context, scanline, width, destination, step);
+    case 4:
+        return unpack_scanline<4>(context, scanline, width, destination, step);
+    case 8:
+        return unpack_scanline<8>(context, scanline, width, destination, step);
+    case 16:
+        return unpack_scanline<16>(context, scanline, width, destination, step);
+    default:
+        VERIFY_NOT_REACHED();
     }
-
-    return {};
 }
 
 static bool decode_png_header(PNGLoadingContext& context)
@@ -531,6 +420,10 @@ static bool decode_png_size(PNGLoadingContext& context)
     if (context.state >= PNGLoadingContext::SizeDecoded)
         return true;
 
+    // The incremental path gets here on its own once the IHDR chunk has arrived.
+    if (context.is_incremental)
+        return false;
+
     if (context.state < PNGLoadingContext::HeaderDecoded) {
         if (!decode_png_header(context))
             return false;
@@ -559,6 +452,10 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     if (context.state >= PNGLoadingContext::State::ChunksDecoded)
         return true;
 
+    // The incremental path only gets here once finish_data() has been called.
+    if (context.is_incremental)
+        return false;
+
     if (context.state < PNGLoadingContext::HeaderDecoded) {
         if (!decode_png_header(context))
             return false;
@@ -582,38 +479,6 @@ static bool decode_png_chunks(PNGLoadingContext& context)
     return true;
 }
 
-static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
-{
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
-
-    for (int y = 0; y < context.height; ++y) {
-        u8 filter;
-        if (!streamer.read(filter)) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
-        }
-
-        if (filter > 4) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter"sv);
-        }
-
-        context.scanlines.append({ filter });
-        auto& scanline_buffer = context.scanlines.last().data;
-        auto row_size = context.compute_row_size_for_width(context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow"sv);
-
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
-        }
-    }
-
-    context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    return unfilter(context);
-}
-
 static int adam7_height(PNGLoadingContext& context, int pass)
 {
     switch (pass) {
@@ -664,65 +529,62 @@ static int adam7_startx[8] = { 0, 0, 4, 0, 2, 0, 1, 0 };
 static int adam7_stepy[8] = { 1, 8, 8, 8, 4, 4, 2, 2 };
 static int adam7_stepx[8] = { 1, 8, 8, 4, 4, 2, 2, 1 };
 
-static ErrorOr<void> decode_adam7_pass(PNGLoadingContext& context, Streamer& streamer, int pass)
+// Unfilters the scanlines of the image (or of an Adam7 pass, which is laid out like an image of its own) in place, and unpacks
+// them straight into the bitmap, to the pixels that the pass covers.
+static ErrorOr<void> decode_scanlines(PNGLoadingContext& context, Bytes& data, int pass, int width, int height)
 {
-    PNGLoadingContext subimage_context;
-    subimage_context.width = adam7_width(context, pass);
-    subimage_context.height = adam7_height(context, pass);
-    subimage_context.channels = context.channels;
-    subimage_context.color_type = context.color_type;
-    subimage_context.palette_data = context.palette_data;
-    subimage_context.palette_transparency_data = context.palette_transparency_data;
-    subimage_context.bit_depth = context.bit_depth;
-    subimage_context.filter_method = context.filter_method;
+    auto row_size = context.compute_row_size_for_width(width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow"sv);
+    size_t scanline_size = row_size.value();
+    size_t bytes_per_complete_pixel = max(1, context.channels * context.bit_depth / 8);
 
-    // For small images, some passes might be empty
-    if (!subimage_context.width || !subimage_context.height)
-        return {};
-
-    subimage_context.scanlines.clear_with_capacity();
-    for (int y = 0; y < subimage_context.height; ++y) {
-        u8 filter;
-        if (!streamer.read(filter)) {
+    auto zeroes = TRY(ByteBuffer::create_zeroed(scanline_size));
+    ReadonlyBytes previous_scanline = zeroes;
+    for (int y = 0; y < height; ++y) {
+        if (data.size() < scanline_size + 1) {
             context.state = PNGLoadingContext::State::Error;
             return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
         }
 
+        u8 filter = data[0];
         if (filter > 4) {
             context.state = PNGLoadingContext::State::Error;
             return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG filter"sv);
         }
 
-        subimage_context.scanlines.append({ filter });
-        auto& scanline_buffer = subimage_context.scanlines.last().data;
-
-        auto row_size = context.compute_row_size_for_width(subimage_context.width);
-        if (row_size.has_overflow())
-            return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow"sv);
-        if (!streamer.wrap_bytes(scanline_buffer, row_size.value())) {
-            context.state = PNGLoadingContext::State::Error;
-            return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
-        }
-    }
-
-    subimage_context.bitmap = TRY(Bitmap::try_create(context.bitmap->format(), { subimage_context.width, subimage_context.height }));
-    TRY(unfilter(subimage_context));
+        auto scanline = data.slice(1, scanline_size);
+        data = data.slice(scanline_size + 1);
+        unfilter_scanline(filter, scanline, previous_scanline, bytes_per_complete_pixel);
 
-    // Copy the subimage data into the main image according to the pass pattern
-    for (int y = 0, dy = adam7_starty[pass]; y < subimage_context.height && dy < context.height; ++y, dy += adam7_stepy[pass]) {
-        for (int x = 0, dx = adam7_startx[pass]; x < subimage_context.width && dy < context.width; ++x, dx += adam7_stepx[pass]) {
-            context.bitmap->set_pixel(dx, dy, subimage_context.bitmap->get_pixel(x, y));
-        }
+        auto* destination = reinterpret_cast<ARGB32*>(context.bitmap->scanline(adam7_starty[pass] + y * adam7_stepy[pass])) + adam7_startx[pass];
+        TRY(unpack_scanline(context, scanline, width, destination, adam7_stepx[pass]));
+        previous_scanline = scanline;
     }
     return {};
 }
 
+static ErrorOr<void> decode_png_bitmap_simple(PNGLoadingContext& context)
+{
+    // NOTE: The bitmap may already be there from incremental decoding, every row gets overwritten.
+    if (!context.bitmap)
+        context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
+    auto data = context.decompression_buffer->bytes();
+    return decode_scanlines(context, data, 0, context.width, context.height);
+}
+
 static ErrorOr<void> decode_png_adam7(PNGLoadingContext& context)
 {
-    Streamer streamer(context.decompression_buffer->data(), context.decompression_buffer->size());
     context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
-    for (int pass = 1; pass <= 7; ++pass)
-        TRY(decode_adam7_pass(context, streamer, pass));
+    auto data = context.decompression_buffer->bytes();
+    for (int pass = 1; pass <= 7; ++pass) {
+        auto width = adam7_width(context, pass);
+        auto height = adam7_height(context, pass);
+        // For small images, some passes might be empty
+        if (!width || !height)
+            continue;
+        TRY(decode_scanlines(context, data, pass, width, height));
+    }
     return {};
 }
 
@@ -750,7 +612,6 @@ static ErrorOr<void> decode_png_bitmap(PNGLoadingContext& context)
     context.decompression_buffer = &result.value();
     context.compressed_data.clear();
 
-    context.scanlines.ensure_capacity(context.height);
     switch (context.interlace_method) {
     case PngInterlaceMethod::Null:
         TRY(decode_png_bitmap_simple(context));
@@ -911,6 +772,107 @@ static bool process_chunk(Streamer& streamer, PNGLoadingContext& context)
     return true;
 }
 
+static ErrorOr<void> process_pending_chunks(PNGLoadingContext& context)
+{
+    auto& pending_data = context.pending_data;
+    size_t offset = 0;
+
+    if (context.state < PNGLoadingContext::HeaderDecoded) {
+        if (pending_data.size() < sizeof(png_header))
+            return {};
+        if (memcmp(pending_data.data(), png_header, sizeof(png_header)) != 0) {
+            context.state = PNGLoadingContext::State::Error;
+            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid PNG header"sv);
+        }
+        offset = sizeof(png_header);
+        context.state = PNGLoadingContext::HeaderDecoded;
+    }
+
+    // Every chunk is its 4-byte length, 4-byte type, data and 4-byte CRC.
+    static constexpr size_t chunk_overhead = 12;
+    while (pending_data.size() - offset >= chunk_overhead) {
+        u32 chunk_size = *reinterpret_cast<NetworkOrdered<u32> const*>(pending_data.data() + offset);
+        if (chunk_size > pending_data.size() - offset - chunk_overhead)
+            break;
+
+        Streamer streamer(pending_data.data() + offset, chunk_size + chunk_overhead);
+        if (!process_chunk(streamer, context)) {
+            context.state = PNGLoadingContext::State::Error;
+            return Error::from_string_literal("PNGImageDecoderPlugin: Invalid chunk"sv);
+        }
+        offset += chunk_size + chunk_overhead;
+
+        if (context.state < PNGLoadingContext::State::SizeDecoded && context.width > 0 && context.height > 0)
+            context.state = PNGLoadingContext::State::SizeDecoded;
+    }
+
+    pending_data.remove(0, offset);
+    return {};
+}
+
+static ErrorOr<void> decode_png_partial_rows(PNGLoadingContext& context)
+{
+    // NOTE: Adam7 spreads every pass over the whole image, so there are no finished rows to show early.
+    if (context.state < PNGLoadingContext::State::SizeDecoded || context.interlace_method != PngInterlaceMethod::Null)
+        return {};
+    if (context.color_type == 3 && context.palette_data.is_empty())
+        return {};
+
+    // The deflate stream can't be resumed once it runs out of input, so each partial decode
+    // starts over from the beginning. Waiting until the compressed data has grown by half
+    // keeps the total work within a small multiple of decoding the image once.
+    static constexpr size_t zlib_header_size = 2;
+    auto compressed_size = context.compressed_data.size();
+    if (compressed_size <= zlib_header_size)
+        return {};
+    if (compressed_size < context.compressed_size_at_last_partial_decode + context.compressed_size_at_last_partial_decode / 2)
+        return {};
+    context.compressed_size_at_last_partial_decode = compressed_size;
+
+    auto row_size = context.compute_row_size_for_width(context.width);
+    if (row_size.has_overflow())
+        return Error::from_string_literal("PNGImageDecoderPlugin: Row size overflow"sv);
+    size_t scanline_size = row_size.value() + 1;
+    size_t total_size = scanline_size * context.height;
+
+    ByteBuffer decompressed;
+    {
+        InputMemoryStream memory_stream { context.compressed_data.span().slice(zlib_header_size) };
+        Compress::DeflateDecompressor deflate_stream { memory_stream };
+        u8 buffer[4096];
+        while (!deflate_stream.has_any_error() && !deflate_stream.unreliable_eof() && decompressed.size() < total_size) {
+            auto nread = deflate_stream.read({ buffer, sizeof(buffer) });
+            if (decompressed.try_append(buffer, nread).is_error())
+                break;
+        }
+        // Running out of input is expected here, the rest of the stream just hasn't arrived yet.
+        (void)deflate_stream.handle_any_error();
+    }
+
+    auto row_count = min(decompressed.size() / scanline_size, static_cast<size_t>(context.height));
+    if (row_count <= context.partially_decoded_row_count)
+        return {};
+
+    if (!context.bitmap)
+        context.bitmap = TRY(Bitmap::try_create(context.has_alpha() ? BitmapFormat::BGRA8888 : BitmapFormat::BGRx8888, { context.width, context.height }));
+
+    PNGLoadingContext partial_context;
+    partial_context.width = context.width;
+    partial_context.height = row_count;
+    partial_context.channels = context.channels;
+    partial_context.color_type = context.color_type;
+    partial_context.palette_data = context.palette_data;
+    partial_context.palette_transparency_data = context.palette_transparency_data;
+    partial_context.bit_depth = context.bit_depth;
+    partial_context.filter_method = context.filter_method;
+    partial_context.bitmap = context.bitmap;
+    partial_context.decompression_buffer = &decompressed;
+    TRY(decode_png_bitmap_simple(partial_context));
+
+    context.partially_decoded_row_count = row_count;
+    return {};
+}
+
 PNGImageDecoderPlugin::PNGImageDecoderPlugin(const u8* data, size_t size)
 {
     m_context = make<PNGLoadingContext>();
@@ -918,6 +880,12 @@ PNGImageDecoderPlugin::PNGImageDecoderPlugin(const u8* data, size_t size)
     m_context->data_size = size;
 }
 
+PNGImageDecoderPlugin::PNGImageDecoderPlugin()
+{
+    m_context = make<PNGLoadingContext>();
+    m_context->is_incremental = true;
+}
+
 PNGImageDecoderPlugin::~PNGImageDecoderPlugin()
 {
 }
@@ -951,6 +919,8 @@ bool PNGImageDecoderPlugin::set_nonvolatile(bool& was_purged)
 
 bool PNGImageDecoderPlugin::sniff()
 {
+    if (m_context->is_incremental)
+        return m_context->state >= PNGLoadingContext::HeaderDecoded;
     return decode_png_header(*m_context);
 }
 
@@ -986,4 +956,57 @@ ErrorOr<ImageFrameDescriptor> PNGImageDecoderPlugin::frame(size_t index)
     return ImageFrameDescriptor { m_context->bitmap, 0 };
 }
 
+bool PNGImageDecoderPlugin::supports_incremental_decoding() const
+{
+    return m_context->is_incremental;
+}
+
+ErrorOr<void> PNGImageDecoderPlugin::append_data(ReadonlyBytes bytes)
+{
+    if (!m_context->is_incremental)
+        return ImageDecoderPlugin::append_data(bytes);
+    if (m_context->state == PNGLoadingContext::State::Error)
+        return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
+    if (m_context->state >= PNGLoadingContext::State::ChunksDecoded)
+        return Error::from_string_literal("PNGImageDecoderPlugin: Data was already finished"sv);
+
+    TRY(m_context->pending_data.try_append(bytes.data(), bytes.size()));
+    TRY(process_pending_chunks(*m_context));
+    return decode_png_partial_rows(*m_context);
+}
+
+ErrorOr<void> PNGImageDecoderPlugin::finish_data()
+{
+    if (!m_context->is_incremental)
+        return ImageDecoderPlugin::finish_data();
+    if (m_context->state == PNGLoadingContext::State::Error)
+        return Error::from_string_literal("PNGImageDecoderPlugin: Decoding failed"sv);
+    if (m_context->state >= PNGLoadingContext::State::ChunksDecoded)
+        return {};
+
+    if (m_context->state < PNGLoadingContext::State::SizeDecoded) {
+        m_context->state = PNGLoadingContext::State::Error;
+        return Error::from_string_literal("PNGImageDecoderPlugin: Didn't see an IHDR chunk."sv);
+    }
+
+    // Like decode_png_chunks(), a truncated trailing chunk is simply ignored.
+    m_context->pending_data.clear();
+    m_context->state = PNGLoadingContext::State::ChunksDecoded;
+    return {};
+}
+
+size_t PNGImageDecoderPlugin::decoded_row_count()
+{
+    if (m_context->state == PNGLoadingContext::State::BitmapDecoded)
+        return m_context->height;
+    return m_context->partially_decoded_row_count;
+}
+
+ErrorOr<ImageFrameDescriptor> PNGImageDecoderPlugin::partial_frame()
+{
+    if (!m_context->bitmap)
+        return Error::from_string_literal("PNGImageDecoderPlugin: No rows have been decoded yet"sv);
+    return ImageFrameDescriptor { m_context->bitmap, 0 };
+}
+
 }
@@ -17,6 +17,9 @@ public:
     virtual ~PNGImageDecoderPlugin() override;
     PNGImageDecoderPlugin(const u8*, size_t);
 
+    // Creates a plugin for incremental decoding, see append_data().
+    PNGImageDecoderPlugin();
+
     virtual IntSize size() override;
     virtual void set_volatile() override;
     [[nodiscard]] virtual bool set_nonvolatile(bool& was_purged) override;
@@ -26,6 +29,12 @@ public:
     virtual size_t frame_count() override;
     virtual ErrorOr<ImageFrameDescriptor> frame(size_t index) override;
 
+    virtual bool supports_incremental_decoding() const override;
+    virtual ErrorOr<void> append_data(ReadonlyBytes) override;
+    virtual ErrorOr<void> finish_data() override;
+    virtual size_t decoded_row_count() override;
+    virtual ErrorOr<ImageFrameDescriptor> partial_frame() override;
+
 private:
     OwnPtr<PNGLoadingContext> m_context;
 };
@@ -6,14 +6,22 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Concepts.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
+#include <LibCompress/Deflate.h>
+#include <LibCrypto/Checksum/Adler32.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/PNGWriter.h>
 
 namespace Gfx {
 
+using AK::SIMD::i16x16;
+using AK::SIMD::u16x16;
+using AK::SIMD::u8x16;
+
 class PNGChunk {
     using data_length_type = u32;
 
@@ -46,23 +54,6 @@ private:
     String m_type;
 };
 
-class NonCompressibleBlock {
-public:
-    void finalize(PNGChunk&);
-    void add_byte_to_block(u8 data, PNGChunk&);
-
-    u16 adler_s1() const { return m_adler_s1; }
-    u16 adler_s2() const { return m_adler_s2; }
-
-private:
-    void add_block_to_chunk(PNGChunk&, bool);
-    void update_adler(u8);
-    bool full() { return m_non_compressible_data.size() == 65535; }
-    Vector<u8> m_non_compressible_data;
-    u16 m_adler_s1 { 1 };
-    u16 m_adler_s2 { 0 };
-};
-
 PNGChunk::PNGChunk(String type)
     : m_type(move(type))
 {
@@ -118,40 +109,6 @@ void PNGChunk::add_u8(u8 data)
     add(data);
 }
 
-void NonCompressibleBlock::add_byte_to_block(u8 data, PNGChunk& chunk)
-{
-    m_non_compressible_data.append(data);
-    update_adler(data);
-    if (full()) {
-        add_block_to_chunk(chunk, false);
-        m_non_compressible_data.clear_with_capacity();
-    }
-}
-
-void NonCompressibleBlock::add_block_to_chunk(PNGChunk& png_chunk, bool last)
-{
-    png_chunk.add_u8(last);
-
-    u16 len = m_non_compressible_data.size();
-    u16 nlen = ~len;
-
-    png_chunk.add_as_little_endian(len);
-    png_chunk.add_as_little_endian(nlen);
-
-    png_chunk.add(m_non_compressible_data.data(), m_non_compressible_data.size());
-}
-
-void NonCompressibleBlock::finalize(PNGChunk& chunk)
-{
-    add_block_to_chunk(chunk, true);
-}
-
-void NonCompressibleBlock::update_adler(u8 data)
-{
-    m_adler_s1 = (m_adler_s1 + data) % 65521;
-    m_adler_s2 = (m_adler_s2 + m_adler_s1) % 65521;
-}
-
 void PNGWriter::add_chunk(PNGChunk& png_chunk)
 {
     png_chunk.store_data_length();
@@ -185,41 +142,252 @@ void PNGWriter::add_IEND_chunk()
     add_chunk(png_chunk);
 }
 
-void PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
+enum class PNGFilterType : u8 {
+    None,
+    Sub,
+    Up,
+    Average,
+    Paeth,
+};
+
+ALWAYS_INLINE static u8 paeth_predictor(int a, int b, int c)
 {
-    PNGChunk png_chunk { "IDAT" };
-    png_chunk.reserve(bitmap.size_in_bytes());
+    int p = a + b - c;
+    int pa = abs(p - a);
+    int pb = abs(p - b);
+    int pc = abs(p - c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    if (pb <= pc)
+        return b;
+    return c;
+}
 
-    u16 CMF_FLG = 0x81d;
-    png_chunk.add_as_big_endian(CMF_FLG);
+// Filters a single byte, given the same byte of the pixel to the left (a), of the pixel above (b), and of the pixel above
+// and to the left of it (c).
+template<PNGFilterType filter_type>
+ALWAYS_INLINE static u8 filter_byte(u8 x, u8 a, u8 b, u8 c)
+{
+    if constexpr (filter_type == PNGFilterType::None)
+        return x;
+    if constexpr (filter_type == PNGFilterType::Sub)
+        return x - a;
+    if constexpr (filter_type == PNGFilterType::Up)
+        return x - b;
+    if constexpr (filter_type == PNGFilterType::Average)
+        return x - (a + b) / 2;
+    if constexpr (filter_type == PNGFilterType::Paeth)
+        return x - paeth_predictor(a, b, c);
+}
 
-    NonCompressibleBlock non_compressible_block;
+// The same as filter_byte(), for 16 bytes at once. Unlike unfiltering, filtering only looks at unfiltered bytes, so the
+// bytes of a scanline don't depend on each other.
+template<PNGFilterType filter_type>
+ALWAYS_INLINE static u8x16 filter_bytes(u8x16 x, u8x16 a, u8x16 b, u8x16 c)
+{
+    if constexpr (filter_type == PNGFilterType::None)
+        return x;
+    if constexpr (filter_type == PNGFilterType::Sub)
+        return x - a;
+    if constexpr (filter_type == PNGFilterType::Up)
+        return x - b;
+    if constexpr (filter_type == PNGFilterType::Average)
+        return x - ((a & b) + ((a ^ b) >> 1));
+    if constexpr (filter_type == PNGFilterType::Paeth) {
+        auto wide_a = __builtin_convertvector(a, i16x16);
+        auto wide_b = __builtin_convertvector(b, i16x16);
+        auto wide_c = __builtin_convertvector(c, i16x16);
+        // The distances of p = a + b - c to a, b and c.
+        auto pa = wide_b - wide_c;
+        auto pb = wide_a - wide_c;
+        auto pc = pa + pb;
+        pa = pa < 0 ? -pa : pa;
+        pb = pb < 0 ? -pb : pb;
+        pc = pc < 0 ? -pc : pc;
+        auto use_a = (pa <= pb) & (pa <= pc);
+        auto use_b = pb <= pc;
+        auto prediction = (use_a & wide_a) | (~use_a & ((use_b & wide_b) | (~use_b & wide_c)));
+        return x - __builtin_convertvector(prediction, u8x16);
+    }
+}
 
-    for (int y = 0; y < bitmap.height(); ++y) {
-        non_compressible_block.add_byte_to_block(0, png_chunk);
+// Filters a scanline into `output`, and returns the sum of the filtered bytes taken as signed values. The filter that makes
+// for the smallest sum tends to make the scanline compress the best.
+// Both scanlines have to be preceded by a pixel's worth of zeroes, which is what the first pixel is predicted from.
+template<PNGFilterType filter_type>
+static u32 filter_scanline(u8* output, u8 const* scanline, u8 const* previous_scanline, size_t size, size_t bytes_per_pixel)
+{
+    auto load = [](u8 const* data) {
+        u8x16 vector;
+        __builtin_memcpy(&vector, data, sizeof(vector));
+        return vector;
+    };
+
+    u32 sum = 0;
+    size_t i = 0;
+    while (i + sizeof(u8x16) <= size) {
+        // Every lane gets at most 128 added per vector, flushing them often enough keeps them from overflowing.
+        u16x16 sums {};
+        for (size_t vectors = 0; vectors < 256 && i + sizeof(u8x16) <= size; ++vectors, i += sizeof(u8x16)) {
+            auto x = load(scanline + i);
+            auto a = load(scanline + i - bytes_per_pixel);
+            auto b = load(previous_scanline + i);
+            auto c = load(previous_scanline + i - bytes_per_pixel);
+            auto filtered = filter_bytes<filter_type>(x, a, b, c);
+            __builtin_memcpy(output + i, &filtered, sizeof(filtered));
+            auto negated = -filtered;
+            sums += __builtin_convertvector(filtered < negated ? filtered : negated, u16x16);
+        }
+        for (size_t lane = 0; lane < 16; ++lane)
+            sum += sums[lane];
+    }
+    for (; i < size; ++i) {
+        auto filtered = filter_byte<filter_type>(scanline[i], scanline[i - bytes_per_pixel], previous_scanline[i], previous_scanline[i - bytes_per_pixel]);
+        output[i] = filtered;
+        sum += min<u8>(filtered, -filtered);
+    }
+    return sum;
+}
 
+// Writes the pixels of a row as RGB(A) bytes.
+static void unpack_row(Gfx::Bitmap const& bitmap, int y, bool has_alpha, u8* output)
+{
+    auto format = bitmap.format();
+    if (format == BitmapFormat::BGRx8888 || format == BitmapFormat::BGRA8888) {
+        auto const* pixels = bitmap.scanline(y);
         for (int x = 0; x < bitmap.width(); ++x) {
-            auto pixel = bitmap.get_pixel(x, y);
-            non_compressible_block.add_byte_to_block(pixel.red(), png_chunk);
-            non_compressible_block.add_byte_to_block(pixel.green(), png_chunk);
-            non_compressible_block.add_byte_to_block(pixel.blue(), png_chunk);
-            non_compressible_block.add_byte_to_block(pixel.alpha(), png_chunk);
+            auto pixel = pixels[x];
+            *output++ = pixel >> 16;
+            *output++ = pixel >> 8;
+            *output++ = pixel;
+            if (has_alpha)
+                *output++ = pixel >> 24;
+        }
+        return;
+    }
+
+    for (int x = 0; x < bitmap.width(); ++x) {
+        auto pixel = bitmap.get_pixel(x, y);
+        *output++ = pixel.red();
+        *output++ = pixel.green();
+        *output++ = pixel.blue();
+        if (has_alpha)
+            *output++ = pixel.alpha();
+    }
+}
+
+ErrorOr<void> PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap, bool has_alpha, CompressionLevel compression_level)
+{
+    size_t bytes_per_pixel = has_alpha ? 4 : 3;
+    size_t scanline_size = bitmap.width() * bytes_per_pixel;
+
+    // The scanlines as they are (with a pixel's worth of zeroes in front), and in the output they are also preceded by the filter type.
+    auto scanline_buffer = TRY(ByteBuffer::create_zeroed(bytes_per_pixel + scanline_size));
+    auto previous_scanline_buffer = TRY(ByteBuffer::create_zeroed(bytes_per_pixel + scanline_size));
+    auto filtered_data = TRY(ByteBuffer::create_uninitialized((1 + scanline_size) * bitmap.height()));
+
+    // Trying every filter on every scanline costs a bit more time than deflating it does, so the fast level only tries the cheap ones.
+    Vector<PNGFilterType, 5> filter_types;
+    if (compression_level == CompressionLevel::None)
+        filter_types = { PNGFilterType::None };
+    else if (compression_level == CompressionLevel::Fast)
+        filter_types = { PNGFilterType::None, PNGFilterType::Sub, PNGFilterType::Up };
+    else
+        filter_types = { PNGFilterType::None, PNGFilterType::Sub, PNGFilterType::Up, PNGFilterType::Average, PNGFilterType::Paeth };
+
+    Array<ByteBuffer, 5> filtered_scanlines;
+    for (auto filter_type : filter_types)
+        filtered_scanlines[to_underlying(filter_type)] = TRY(ByteBuffer::create_uninitialized(scanline_size));
+
+    for (int y = 0; y < bitmap.height(); ++y) {
+        u8* scanline = scanline_buffer.data() + bytes_per_pixel;
+        u8 const* previous_scanline = previous_scanline_buffer.data() + bytes_per_pixel;
+        unpack_row(bitmap, y, has_alpha, scanline);
+
+        auto* output = filtered_data.offset_pointer((1 + scanline_size) * y);
+        if (filter_types.size() == 1) {
+            output[0] = to_underlying(PNGFilterType::None);
+            __builtin_memcpy(output + 1, scanline, scanline_size);
+        } else {
+            PNGFilterType best_filter_type = PNGFilterType::None;
+            u32 best_sum = NumericLimits<u32>::max();
+            for (auto filter_type : filter_types) {
+                auto* filtered_scanline = filtered_scanlines[to_underlying(filter_type)].data();
+                u32 sum = 0;
+                switch (filter_type) {
+                case PNGFilterType::None:
+                    sum = filter_scanline<PNGFilterType::None>(filtered_scanline, scanline, previous_scanline, scanline_size, bytes_per_pixel);
+                    break;
+                case PNGFilterType::Sub:
+                    sum = filter_scanline<PNGFilterType::Sub>(filtered_scanline, scanline, previous_scanline, scanline_size, bytes_per_pixel);
+                    break;
+                case PNGFilterType::Up:
+                    sum = filter_scanline<PNGFilterType::Up>(filtered_scanline, scanline, previous_scanline, scanline_size, bytes_per_pixel);
+                    break;
+                case PNGFilterType::Average:
+                    sum = filter_scanline<PNGFilterType::Average>(filtered_scanline, scanline, previous_scanline, scanline_size, bytes_per_pixel);
+                    break;
+                case PNGFilterType::Paeth:
+                    sum = filter_scanline<PNGFilterType::Paeth>(filtered_scanline, scanline, previous_scanline, scanline_size, bytes_per_pixel);
+                    break;
+                }
+                if (sum < best_sum) {
+                    best_sum = sum;
+                    best_filter_type = filter_type;
+                }
+            }
+            output[0] = to_underlying(best_filter_type);
+            __builtin_memcpy(output + 1, filtered_scanlines[to_underlying(best_filter_type)].data(), scanline_size);
         }
+
+        swap(scanline_buffer, previous_scanline_buffer);
+    }
+
+    using DeflateLevel = Compress::DeflateCompressor::CompressionLevel;
+    DeflateLevel deflate_level = DeflateLevel::GOOD;
+    // The zlib header: deflate with a 32 KiB window, with the level in the flags (which also make the header a multiple of 31).
+    u8 zlib_flags = 0x9c;
+    switch (compression_level) {
+    case CompressionLevel::None:
+        deflate_level = DeflateLevel::STORE;
+        zlib_flags = 0x01;
+        break;
+    case CompressionLevel::Fast:
+        deflate_level = DeflateLevel::FAST;
+        zlib_flags = 0x01;
+        break;
+    case CompressionLevel::Default:
+        break;
+    case CompressionLevel::Best:
+        deflate_level = DeflateLevel::GREAT;
+        zlib_flags = 0xda;
+        break;
     }
-    non_compressible_block.finalize(png_chunk);
 
-    png_chunk.add_as_big_endian(non_compressible_block.adler_s2());
-    png_chunk.add_as_big_endian(non_compressible_block.adler_s1());
+    auto compressed_data = Compress::DeflateCompressor::compress_all(filtered_data, deflate_level);
+    if (!compressed_data.has_value())
+        return Error::from_string_literal("PNGWriter: Failed to compress the image data"sv);
 
+    PNGChunk png_chunk { "IDAT" };
+    png_chunk.reserve(2 + compressed_data->size() + 4);
+    png_chunk.add_u8(0x78);
+    png_chunk.add_u8(zlib_flags);
+    png_chunk.add(compressed_data->data(), compressed_data->size());
+    png_chunk.add_as_big_endian(Crypto::Checksum::Adler32(filtered_data).digest());
     add_chunk(png_chunk);
+    return {};
 }
 
-ByteBuffer PNGWriter::encode(Gfx::Bitmap const& bitmap)
+ByteBuffer PNGWriter::encode(Gfx::Bitmap const& bitmap, CompressionLevel compression_level)
 {
+    // Bitmaps without an alpha channel are written without one, which saves a quarter of the data.
+    bool has_alpha = bitmap.format() != BitmapFormat::BGRx8888;
+
     PNGWriter writer;
     writer.add_png_header();
-    writer.add_IHDR_chunk(bitmap.width(), bitmap.height(), 8, 6, 0, 0, 0);
-    writer.add_IDAT_chunk(bitmap);
+    writer.add_IHDR_chunk(bitmap.width(), bitmap.height(), 8, has_alpha ? 6 : 2, 0, 0, 0);
+    if (writer.add_IDAT_chunk(bitmap, has_alpha, compression_level).is_error())
+        return {};
     writer.add_IEND_chunk();
     // FIXME: Handle OOM failure.
     return ByteBuffer::copy(writer.m_data).release_value_but_fixme_should_propagate_errors();
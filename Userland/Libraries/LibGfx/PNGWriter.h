@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Error.h>
 #include <AK/Vector.h>
 #include <LibGfx/Forward.h>
 
@@ -16,7 +17,15 @@ class PNGChunk;
 
 class PNGWriter {
 public:
-    static ByteBuffer encode(Gfx::Bitmap const&);
+    enum class CompressionLevel {
+        // Takes the least time, but the pixels aren't compressed at all.
+        None,
+        Fast,
+        Default,
+        Best,
+    };
+
+    static ByteBuffer encode(Gfx::Bitmap const&, CompressionLevel = CompressionLevel::Default);
 
 private:
     PNGWriter() { }
@@ -25,7 +34,7 @@ private:
     void add_chunk(PNGChunk&);
     void add_png_header();
     void add_IHDR_chunk(u32 width, u32 height, u8 bit_depth, u8 color_type, u8 compression_method, u8 filter_method, u8 interlace_method);
-    void add_IDAT_chunk(Gfx::Bitmap const&);
+    ErrorOr<void> add_IDAT_chunk(Gfx::Bitmap const&, bool has_alpha, CompressionLevel);
     void add_IEND_chunk();
 };
 
@@ -22,6 +22,8 @@
 #include <AK/Memory.h>
 #include <AK/Queue.h>
 #include <AK/QuickSort.h>
+#include <AK/SIMD.h>
+#include <AK/SIMDExtras.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf32View.h>
@@ -76,6 +78,45 @@ Painter::~Painter()
 {
 }
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+using AK::SIMD::u16x16;
+using AK::SIMD::u32x4;
+using AK::SIMD::u8x16;
+
+ALWAYS_INLINE static u32x4 load_u32x4(ARGB32 const* data)
+{
+    u32x4 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+ALWAYS_INLINE static void store_u32x4(ARGB32* data, u32x4 value)
+{
+    __builtin_memcpy(data, &value, sizeof(value));
+}
+
+ALWAYS_INLINE static bool are_all_opaque(u32x4 pixels)
+{
+    return AK::SIMD::all((pixels >> 24) == 0xff);
+}
+
+// Blends four source pixels over four opaque destination pixels, with one alpha value per pixel.
+// Over an opaque destination, Color::blend() comes down to (dst * (255 - alpha) + src * alpha) / 255
+// for each channel, and for every value of x that can show up here, x / 255 == (x + 1 + (x >> 8)) >> 8.
+ALWAYS_INLINE static u32x4 blend_over_opaque(u32x4 dst, u32x4 src, u32x4 alpha)
+{
+    auto alpha16 = __builtin_convertvector(bit_cast<u8x16>(alpha | (alpha << 8) | (alpha << 16)), u16x16);
+    auto dst16 = __builtin_convertvector(bit_cast<u8x16>(dst), u16x16);
+    auto src16 = __builtin_convertvector(bit_cast<u8x16>(src), u16x16);
+    u16x16 blended = dst16 * (255 - alpha16) + src16 * alpha16;
+    blended = (blended + 1 + (blended >> 8)) >> 8;
+    return bit_cast<u32x4>(__builtin_convertvector(blended, u8x16)) | 0xff000000;
+}
+
+#pragma GCC diagnostic pop
+
 void Painter::fill_rect_with_draw_op(IntRect const& a_rect, Color color)
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
@@ -118,8 +159,22 @@ void Painter::fill_physical_rect(IntRect const& physical_rect, Color color)
     ARGB32* dst = m_target->scanline(physical_rect.top()) + physical_rect.left();
     size_t const dst_skip = m_target->pitch() / sizeof(ARGB32);
 
+    auto source = AK::SIMD::expand4(color.value());
+    auto alpha = AK::SIMD::expand4(static_cast<u32>(color.alpha()));
+    int const width = physical_rect.width();
+
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
+        int j = 0;
+        for (; j + 4 <= width; j += 4) {
+            auto pixels = load_u32x4(&dst[j]);
+            if (!are_all_opaque(pixels)) {
+                for (int k = j; k < j + 4; ++k)
+                    dst[k] = Color::from_argb(dst[k]).blend(color).value();
+                continue;
+            }
+            store_u32x4(&dst[j], blend_over_opaque(pixels, source, alpha));
+        }
+        for (; j < width; ++j)
             dst[j] = Color::from_argb(dst[j]).blend(color).value();
         dst += dst_skip;
     }
@@ -783,28 +838,59 @@ static void swap_red_and_blue_channels(Color& color)
     color = Color::from_argb(bgra);
 }
 
-// FIXME: This function is very unoptimized.
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    auto blit_pixel = [&](int x) {
+        Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
+        if constexpr (has_alpha & BlitState::SrcAlpha) {
+            Color src_color_with_alpha = Color::from_argb(state.src[x]);
+            if (state.src_format == BitmapFormat::RGBA8888)
+                swap_red_and_blue_channels(src_color_with_alpha);
+            float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
+            src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
+            state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+        } else {
+            Color src_color_with_alpha = Color::from_rgb(state.src[x]);
+            if (state.src_format == BitmapFormat::RGBA8888)
+                swap_red_and_blue_channels(src_color_with_alpha);
+            src_color_with_alpha.set_alpha(state.opacity * 255);
+            state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+        }
+    };
+
+    // NOTE: The alpha values are computed exactly like blit_pixel() does it, so both paths agree on every pixel.
+    auto scaled_alpha = [&](u32 pixel) -> u32 {
+        float pixel_opacity = (pixel >> 24) / 255.0;
+        return static_cast<u8>(255 * (state.opacity * pixel_opacity));
+    };
+    auto constant_alpha = AK::SIMD::expand4(static_cast<u32>(static_cast<u8>(state.opacity * 255)));
+
     for (int row = 0; row < state.row_count; ++row) {
-        for (int x = 0; x < state.column_count; ++x) {
-            Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_argb(state.dst[x]) : Color::from_rgb(state.dst[x]);
+        int x = 0;
+        for (; x + 4 <= state.column_count; x += 4) {
+            auto dst = load_u32x4(&state.dst[x]);
+            if constexpr (has_alpha & BlitState::DstAlpha) {
+                if (!are_all_opaque(dst)) {
+                    for (int i = x; i < x + 4; ++i)
+                        blit_pixel(i);
+                    continue;
+                }
+            }
+
+            auto src = load_u32x4(&state.src[x]);
+            if (state.src_format == BitmapFormat::RGBA8888)
+                src = (src & 0xff00ff00) | ((src & 0xff) << 16) | ((src >> 16) & 0xff);
+
             if constexpr (has_alpha & BlitState::SrcAlpha) {
-                Color src_color_with_alpha = Color::from_argb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                float pixel_opacity = src_color_with_alpha.alpha() / 255.0;
-                src_color_with_alpha.set_alpha(255 * (state.opacity * pixel_opacity));
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+                u32x4 alpha { scaled_alpha(src[0]), scaled_alpha(src[1]), scaled_alpha(src[2]), scaled_alpha(src[3]) };
+                store_u32x4(&state.dst[x], blend_over_opaque(dst, src, alpha));
             } else {
-                Color src_color_with_alpha = Color::from_rgb(state.src[x]);
-                if (state.src_format == BitmapFormat::RGBA8888)
-                    swap_red_and_blue_channels(src_color_with_alpha);
-                src_color_with_alpha.set_alpha(state.opacity * 255);
-                state.dst[x] = dest_color.blend(src_color_with_alpha).value();
+                store_u32x4(&state.dst[x], blend_over_opaque(dst, src, constant_alpha));
             }
         }
+        for (; x < state.column_count; ++x)
+            blit_pixel(x);
         state.dst += state.dst_pitch;
         state.src += state.src_pitch;
     }
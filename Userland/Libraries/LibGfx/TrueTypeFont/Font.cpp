@@ -14,6 +14,7 @@
 #include <LibGfx/TrueTypeFont/Cmap.h>
 #include <LibGfx/TrueTypeFont/Font.h>
 #include <LibGfx/TrueTypeFont/Glyf.h>
+#include <LibGfx/TrueTypeFont/GlyphBitmapCache.h>
 #include <LibGfx/TrueTypeFont/Tables.h>
 #include <LibTextCodec/Decoder.h>
 #include <math.h>
@@ -227,7 +228,8 @@ GlyphHorizontalMetrics Hmtx::get_glyph_horizontal_metrics(u32 glyph_id) const
 
 ErrorOr<NonnullRefPtr<Font>> Font::try_load_from_file(String path, unsigned index)
 {
-    auto file = TRY(Core::MappedFile::map(path));
+    // Glyph lookups jump all over the file, so reading ahead would mostly bring in glyphs that are never used.
+    auto file = TRY(Core::MappedFile::map(path, Core::MappedFile::AccessPattern::Random));
     auto font = TRY(try_load_from_externally_owned_memory(file->bytes(), index));
     font->m_mapped_file = move(file);
     return font;
@@ -421,6 +423,11 @@ ScaledGlyphMetrics Font::glyph_metrics(u32 glyph_id, float x_scale, float y_scal
 }
 
 // FIXME: "loca" and "glyf" are not available for CFF fonts.
+Font::~Font()
+{
+    GlyphBitmapCache::the().remove_glyphs_of(*this);
+}
+
 RefPtr<Gfx::Bitmap> Font::rasterize_glyph(u32 glyph_id, float x_scale, float y_scale) const
 {
     if (glyph_id >= glyph_count()) {
@@ -516,9 +523,7 @@ ALWAYS_INLINE int ScaledFont::unicode_view_width(T const& view) const
             width = 0;
             continue;
         }
-        u32 glyph_id = glyph_id_for_code_point(code_point);
-        auto metrics = glyph_metrics(glyph_id);
-        width += metrics.advance_width;
+        width += advance_width(code_point);
     }
     longest_width = max(width, longest_width);
     return longest_width;
@@ -526,12 +531,13 @@ ALWAYS_INLINE int ScaledFont::unicode_view_width(T const& view) const
 
 RefPtr<Gfx::Bitmap> ScaledFont::rasterize_glyph(u32 glyph_id) const
 {
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(glyph_id);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
+    GlyphBitmapCacheKey key { m_font.ptr(), m_x_scale, m_y_scale, glyph_id };
+    auto& cache = GlyphBitmapCache::the();
+    if (auto cached_bitmap = cache.get(key); cached_bitmap.has_value())
+        return cached_bitmap.release_value();
 
     auto glyph_bitmap = m_font->rasterize_glyph(glyph_id, m_x_scale, m_y_scale);
-    m_cached_glyph_bitmaps.set(glyph_id, glyph_bitmap);
+    cache.set(key, glyph_bitmap);
     return glyph_bitmap;
 }
 
@@ -543,23 +549,29 @@ Gfx::Glyph ScaledFont::glyph(u32 code_point) const
     return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
 }
 
+int ScaledFont::advance_width(u32 code_point) const
+{
+    if (auto it = m_cached_advance_widths.find(code_point); it != m_cached_advance_widths.end())
+        return it->value;
+    // NOTE: Looking up the glyph means searching the cmap, and its metrics come partly from its outline.
+    int advance_width = glyph_metrics(glyph_id_for_code_point(code_point)).advance_width;
+    m_cached_advance_widths.set(code_point, advance_width);
+    return advance_width;
+}
+
 u8 ScaledFont::glyph_width(u32 code_point) const
 {
-    auto id = glyph_id_for_code_point(code_point);
-    auto metrics = glyph_metrics(id);
-    return metrics.advance_width;
+    return advance_width(code_point);
 }
 
 int ScaledFont::glyph_or_emoji_width(u32 code_point) const
 {
-    auto id = glyph_id_for_code_point(code_point);
-    auto metrics = glyph_metrics(id);
-    return metrics.advance_width;
+    return advance_width(code_point);
 }
 
 u8 ScaledFont::glyph_fixed_width() const
 {
-    return glyph_metrics(glyph_id_for_code_point(' ')).advance_width;
+    return advance_width(' ');
 }
 
 u16 OS2::weight_class() const
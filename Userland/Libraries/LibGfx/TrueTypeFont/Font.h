@@ -48,6 +48,8 @@ public:
     static ErrorOr<NonnullRefPtr<Font>> try_load_from_file(String path, unsigned index = 0);
     static ErrorOr<NonnullRefPtr<Font>> try_load_from_externally_owned_memory(ReadonlyBytes bytes, unsigned index = 0);
 
+    ~Font();
+
     ScaledFontMetrics metrics(float x_scale, float y_scale) const;
     ScaledGlyphMetrics glyph_metrics(u32 glyph_id, float x_scale, float y_scale) const;
     RefPtr<Gfx::Bitmap> rasterize_glyph(u32 glyph_id, float x_scale, float y_scale) const;
@@ -155,7 +157,9 @@ private:
     float m_y_scale { 0.0f };
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
-    mutable HashMap<u32, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
+    mutable HashMap<u32, int> m_cached_advance_widths;
+
+    int advance_width(u32 code_point) const;
 
     template<typename T>
     int unicode_view_width(T const& view) const;
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <LibGfx/TrueTypeFont/GlyphBitmapCache.h>
+
+namespace TTF {
+
+// NOTE: This is never destroyed, since fonts (which may outlive any other static object) tell it when they go away.
+static Singleton<GlyphBitmapCache> s_the;
+
+GlyphBitmapCache& GlyphBitmapCache::the()
+{
+    return *s_the;
+}
+
+Optional<RefPtr<Gfx::Bitmap>> GlyphBitmapCache::get(GlyphBitmapCacheKey const& key)
+{
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return {};
+    auto& entry = *it->value;
+    m_lru_list.prepend(entry);
+    return entry.bitmap;
+}
+
+void GlyphBitmapCache::set(GlyphBitmapCacheKey const& key, RefPtr<Gfx::Bitmap> bitmap)
+{
+    auto entry = make<Entry>();
+    entry->key = key;
+    // Glyphs without a bitmap still have to pay for their entry, or there'd be no limit to how many of them there can be.
+    entry->size_in_bytes = sizeof(Entry) + (bitmap ? bitmap->size_in_bytes() : 0);
+    entry->bitmap = move(bitmap);
+
+    if (auto it = m_entries.find(key); it != m_entries.end())
+        remove(*it->value);
+
+    m_size_in_bytes += entry->size_in_bytes;
+    m_lru_list.prepend(*entry);
+    m_entries.set(key, move(entry));
+    evict_if_needed();
+}
+
+void GlyphBitmapCache::remove_glyphs_of(Font const& font)
+{
+    Vector<Entry&> entries_to_remove;
+    for (auto& entry : m_lru_list) {
+        if (entry.key.font == &font)
+            entries_to_remove.append(entry);
+    }
+    for (auto& entry : entries_to_remove)
+        remove(entry);
+}
+
+void GlyphBitmapCache::set_budget(size_t budget)
+{
+    m_budget = budget;
+    evict_if_needed();
+}
+
+void GlyphBitmapCache::remove(Entry& entry)
+{
+    m_size_in_bytes -= entry.size_in_bytes;
+    m_lru_list.remove(entry);
+    // NOTE: This destroys the entry, so the key can't be one of its members.
+    auto key = entry.key;
+    m_entries.remove(key);
+}
+
+void GlyphBitmapCache::evict_if_needed()
+{
+    while (m_size_in_bytes > m_budget && !m_lru_list.is_empty())
+        remove(*m_lru_list.last());
+}
+
+}
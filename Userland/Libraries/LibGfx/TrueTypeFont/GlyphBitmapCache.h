@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/BitCast.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <LibGfx/Bitmap.h>
+
+namespace TTF {
+
+class Font;
+
+struct GlyphBitmapCacheKey {
+    Font const* font { nullptr };
+    float x_scale { 0 };
+    float y_scale { 0 };
+    u32 glyph_id { 0 };
+
+    bool operator==(GlyphBitmapCacheKey const&) const = default;
+};
+
+// The glyphs that have been rasterized in this process, for every font and size. Since ScaledFonts are cheap
+// to create and Typeface::get_font() makes a new one every time, they all put their glyphs here to share them.
+// Once the glyphs take up more than the budget, the ones that haven't been used for the longest are evicted.
+// Like the fonts themselves, this is only meant to be used from one thread.
+class GlyphBitmapCache {
+public:
+    static GlyphBitmapCache& the();
+
+    // Returns the glyph if it's in the cache, which may be a null bitmap for glyphs that have no outline.
+    Optional<RefPtr<Gfx::Bitmap>> get(GlyphBitmapCacheKey const&);
+    void set(GlyphBitmapCacheKey const&, RefPtr<Gfx::Bitmap>);
+
+    // Drops all glyphs of a font; a font that gets the same address later mustn't find them.
+    void remove_glyphs_of(Font const&);
+
+    size_t size_in_bytes() const { return m_size_in_bytes; }
+    size_t budget() const { return m_budget; }
+    void set_budget(size_t);
+
+private:
+    struct Entry {
+        GlyphBitmapCacheKey key;
+        RefPtr<Gfx::Bitmap> bitmap;
+        size_t size_in_bytes { 0 };
+        IntrusiveListNode<Entry> lru_list_node;
+    };
+
+    void remove(Entry&);
+    void evict_if_needed();
+
+    HashMap<GlyphBitmapCacheKey, NonnullOwnPtr<Entry>> m_entries;
+    // The most recently used glyphs are at the front.
+    IntrusiveList<&Entry::lru_list_node> m_lru_list;
+    size_t m_size_in_bytes { 0 };
+    size_t m_budget { 8 * MiB };
+};
+
+}
+
+template<>
+struct AK::Traits<TTF::GlyphBitmapCacheKey> : public GenericTraits<TTF::GlyphBitmapCacheKey> {
+    static unsigned hash(TTF::GlyphBitmapCacheKey const& key)
+    {
+        auto scale_hash = pair_int_hash(bit_cast<u32>(key.x_scale), bit_cast<u32>(key.y_scale));
+        return pair_int_hash(ptr_hash(key.font), pair_int_hash(scale_hash, key.glyph_id));
+    }
+};
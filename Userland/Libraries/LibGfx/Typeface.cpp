@@ -46,6 +46,7 @@ void Typeface::add_bitmap_font(RefPtr<BitmapFont> font)
 void Typeface::set_ttf_font(RefPtr<TTF::Font> font)
 {
     m_ttf_font = move(font);
+    m_scaled_fonts.clear();
 }
 
 RefPtr<Font> Typeface::get_font(unsigned size, Font::AllowInexactSizeMatch allow_inexact_size_match) const
@@ -70,8 +71,11 @@ RefPtr<Font> Typeface::get_font(unsigned size, Font::AllowInexactSizeMatch allow
     if (allow_inexact_size_match == Font::AllowInexactSizeMatch::Yes && best_match)
         return best_match;
 
-    if (m_ttf_font)
-        return adopt_ref(*new TTF::ScaledFont(*m_ttf_font, size, size));
+    if (m_ttf_font) {
+        return m_scaled_fonts.ensure(size, [&] {
+            return adopt_ref(*new TTF::ScaledFont(*m_ttf_font, size, size));
+        });
+    }
 
     return {};
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/RefCounted.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
@@ -44,6 +45,8 @@ private:
 
     Vector<RefPtr<BitmapFont>> m_bitmap_fonts;
     RefPtr<TTF::Font> m_ttf_font;
+    // The sizes of the TrueType font that have been asked for, so they (and the metrics they've cached) get reused.
+    mutable HashMap<unsigned, NonnullRefPtr<TTF::ScaledFont>> m_scaled_fonts;
 };
 
 }
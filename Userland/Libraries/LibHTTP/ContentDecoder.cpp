@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibCompress/Deflate.h>
+#include <LibCompress/Gzip.h>
+#include <LibHTTP/ContentDecoder.h>
+
+namespace HTTP {
+
+// How much decoded output is asked for at a time.
+static constexpr size_t read_size = 4 * KiB;
+
+// The most input a single read of `read_size` bytes can use up: stored blocks are copied up to 32 KiB at a time,
+// compressed blocks take at most 2 bytes of input per byte of output, and block headers are well under 1 KiB.
+// (Only a long run of empty blocks can take more than that, which no encoder produces.)
+static constexpr size_t max_input_per_read = 64 * KiB;
+
+OwnPtr<ContentDecoder> ContentDecoder::create(StringView content_encoding)
+{
+    if (content_encoding.equals_ignoring_case("gzip"sv) || content_encoding.equals_ignoring_case("x-gzip"sv))
+        return adopt_own(*new ContentDecoder(Coding::Gzip));
+    if (content_encoding.equals_ignoring_case("deflate"sv))
+        return adopt_own(*new ContentDecoder(Coding::Deflate));
+    dbgln_if(JOB_DEBUG, "ContentDecoder: Unsupported content encoding '{}', passing the body on as it is", content_encoding);
+    return {};
+}
+
+ContentDecoder::~ContentDecoder()
+{
+    // Streams mustn't be destroyed with errors that haven't been handled, which they may have if we gave up midway.
+    if (m_decompressor)
+        m_decompressor->handle_any_error();
+    m_input.handle_any_error();
+}
+
+ErrorOr<ByteBuffer> ContentDecoder::decode(ReadonlyBytes bytes)
+{
+    ByteBuffer output;
+    // Anything after the end of the compressed data (like the zlib checksum) is of no interest.
+    if (m_is_finished || bytes.is_empty())
+        return output;
+
+    m_has_received_input = true;
+    m_input.write(bytes);
+    TRY(create_decompressor_if_needed(false));
+    if (m_decompressor)
+        TRY(decompress(output, false));
+    return output;
+}
+
+ErrorOr<ByteBuffer> ContentDecoder::finish()
+{
+    ByteBuffer output;
+    // Responses without a body may still claim to have a content coding.
+    if (m_is_finished || !m_has_received_input)
+        return output;
+
+    TRY(create_decompressor_if_needed(true));
+    TRY(decompress(output, true));
+    return output;
+}
+
+ErrorOr<void> ContentDecoder::create_decompressor_if_needed(bool has_received_everything)
+{
+    if (m_decompressor)
+        return {};
+
+    if (m_coding == Coding::Gzip) {
+        if (m_input.size() >= 2) {
+            u8 magic[2];
+            m_input.read_without_consuming({ magic, sizeof(magic) });
+            if (!Compress::GzipDecompressor::is_likely_compressed({ magic, sizeof(magic) }))
+                return Error::from_string_literal("Body is not gzip compressed"sv);
+        }
+        m_decompressor = make<Compress::GzipDecompressor>(m_input);
+        return {};
+    }
+
+    // Even though the content encoding is "deflate", it's actually deflate with the zlib wrapper (RFC 9110 section 8.4.1.2).
+    // But "some non-conformant implementations send the "deflate" compressed data without the zlib wrapper", so we look at
+    // whether the body starts with a zlib header first.
+    if (m_input.size() < 2 && !has_received_everything)
+        return {};
+
+    u8 header[2] {};
+    auto header_size = m_input.read_without_consuming({ header, sizeof(header) });
+    u8 compression_method = header[0] & 0xf;
+    u8 compression_info = header[0] >> 4;
+    bool has_dictionary = header[1] & 0x20;
+    bool is_zlib = header_size == 2 && compression_method == 8 && compression_info <= 7 && !has_dictionary && (header[0] * 256 + header[1]) % 31 == 0;
+    dbgln_if(JOB_DEBUG, "ContentDecoder: Deflate {} the zlib wrapper", is_zlib ? "with" : "without");
+    if (is_zlib)
+        m_input.discard_or_error(2);
+    m_decompressor = make<Compress::DeflateDecompressor>(m_input);
+    return {};
+}
+
+ErrorOr<void> ContentDecoder::decompress(ByteBuffer& output, bool has_received_everything)
+{
+    u8 buffer[read_size];
+    while (!m_is_finished && (has_received_everything || m_input.size() > max_input_per_read)) {
+        auto nread = m_decompressor->read({ buffer, sizeof(buffer) });
+        if (m_decompressor->handle_any_error())
+            return Error::from_string_literal("Failed to decompress body"sv);
+        TRY(output.try_append(buffer, nread));
+        // The decompressors only come up short once they've reached the end of the compressed data.
+        if (nread < sizeof(buffer))
+            m_is_finished = true;
+    }
+
+    if (m_is_finished)
+        m_input.discard_or_error(m_input.size());
+    return {};
+}
+
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/MemoryStream.h>
+#include <AK/OwnPtr.h>
+#include <AK/StringView.h>
+
+namespace HTTP {
+
+// Decodes a response body that has a Content-Encoding of gzip or deflate (RFC 9110 section 8.4.1) as it comes in.
+class ContentDecoder {
+public:
+    // Null if the content coding isn't one we know, in which case the body has to be passed on as it is.
+    static OwnPtr<ContentDecoder> create(StringView content_encoding);
+
+    ~ContentDecoder();
+
+    // Returns as much of the body as can be decoded from what has been received so far, which may be nothing at all.
+    ErrorOr<ByteBuffer> decode(ReadonlyBytes);
+    // Returns the rest of the body, once everything has been received.
+    ErrorOr<ByteBuffer> finish();
+
+private:
+    enum class Coding {
+        Gzip,
+        Deflate,
+    };
+
+    explicit ContentDecoder(Coding coding)
+        : m_coding(coding)
+    {
+    }
+
+    ErrorOr<void> create_decompressor_if_needed(bool has_received_everything);
+    ErrorOr<void> decompress(ByteBuffer& output, bool has_received_everything);
+
+    Coding m_coding;
+    bool m_has_received_input { false };
+    bool m_is_finished { false };
+
+    // LibCompress pulls its input from a stream, and can't pick up where it left off if that one runs dry.
+    // So the input that has been received is queued up here, and only handed to the decompressor while there is more of it
+    // than a single read from the decompressor could possibly use, until the end of the body has been received.
+    DuplexMemoryStream m_input;
+    OwnPtr<InputStream> m_decompressor;
+};
+
+}
@@ -0,0 +1,463 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/StringBuilder.h>
+#include <LibHTTP/HPACK.h>
+
+namespace HTTP::HPACK {
+
+struct StaticTableEntry {
+    StringView name;
+    StringView value;
+};
+
+// RFC 7541 Appendix A, whose indices start at 1.
+static constexpr Array<StaticTableEntry, 61> s_static_table { {
+    { ":authority"sv, ""sv },
+    { ":method"sv, "GET"sv },
+    { ":method"sv, "POST"sv },
+    { ":path"sv, "/"sv },
+    { ":path"sv, "/index.html"sv },
+    { ":scheme"sv, "http"sv },
+    { ":scheme"sv, "https"sv },
+    { ":status"sv, "200"sv },
+    { ":status"sv, "204"sv },
+    { ":status"sv, "206"sv },
+    { ":status"sv, "304"sv },
+    { ":status"sv, "400"sv },
+    { ":status"sv, "404"sv },
+    { ":status"sv, "500"sv },
+    { "accept-charset"sv, ""sv },
+    { "accept-encoding"sv, "gzip, deflate"sv },
+    { "accept-language"sv, ""sv },
+    { "accept-ranges"sv, ""sv },
+    { "accept"sv, ""sv },
+    { "access-control-allow-origin"sv, ""sv },
+    { "age"sv, ""sv },
+    { "allow"sv, ""sv },
+    { "authorization"sv, ""sv },
+    { "cache-control"sv, ""sv },
+    { "content-disposition"sv, ""sv },
+    { "content-encoding"sv, ""sv },
+    { "content-language"sv, ""sv },
+    { "content-length"sv, ""sv },
+    { "content-location"sv, ""sv },
+    { "content-range"sv, ""sv },
+    { "content-type"sv, ""sv },
+    { "cookie"sv, ""sv },
+    { "date"sv, ""sv },
+    { "etag"sv, ""sv },
+    { "expect"sv, ""sv },
+    { "expires"sv, ""sv },
+    { "from"sv, ""sv },
+    { "host"sv, ""sv },
+    { "if-match"sv, ""sv },
+    { "if-modified-since"sv, ""sv },
+    { "if-none-match"sv, ""sv },
+    { "if-range"sv, ""sv },
+    { "if-unmodified-since"sv, ""sv },
+    { "last-modified"sv, ""sv },
+    { "link"sv, ""sv },
+    { "location"sv, ""sv },
+    { "max-forwards"sv, ""sv },
+    { "proxy-authenticate"sv, ""sv },
+    { "proxy-authorization"sv, ""sv },
+    { "range"sv, ""sv },
+    { "referer"sv, ""sv },
+    { "refresh"sv, ""sv },
+    { "retry-after"sv, ""sv },
+    { "server"sv, ""sv },
+    { "set-cookie"sv, ""sv },
+    { "strict-transport-security"sv, ""sv },
+    { "transfer-encoding"sv, ""sv },
+    { "user-agent"sv, ""sv },
+    { "vary"sv, ""sv },
+    { "via"sv, ""sv },
+    { "www-authenticate"sv, ""sv },
+} };
+
+struct HuffmanCode {
+    u32 code;
+    u8 length;
+};
+
+// RFC 7541 Appendix B, without EOS (which is 30 one bits).
+static constexpr Array<HuffmanCode, 256> s_huffman_codes { {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+} };
+
+static constexpr u32 huffman_eos_code = 0x3fffffff;
+static constexpr u8 huffman_max_code_length = 30;
+static constexpr u16 huffman_eos_symbol = 256;
+
+// The code is canonical, so every code length covers a contiguous range of codes, and decoding only has to
+// check which range the bits read so far fall into.
+struct HuffmanDecodingTable {
+    HuffmanDecodingTable()
+    {
+        auto length_of = [](size_t symbol) { return symbol == huffman_eos_symbol ? huffman_max_code_length : s_huffman_codes[symbol].length; };
+        auto code_of = [](size_t symbol) { return symbol == huffman_eos_symbol ? huffman_eos_code : s_huffman_codes[symbol].code; };
+
+        size_t index = 0;
+        for (u8 length = 1; length <= huffman_max_code_length; ++length) {
+            first_index[length] = index;
+            for (size_t symbol = 0; symbol <= huffman_eos_symbol; ++symbol) {
+                if (length_of(symbol) != length)
+                    continue;
+                if (count[length] == 0)
+                    first_code[length] = code_of(symbol);
+                ++count[length];
+                symbols[index++] = symbol;
+            }
+        }
+    }
+
+    Array<u32, huffman_max_code_length + 1> first_code {};
+    Array<u16, huffman_max_code_length + 1> first_index {};
+    Array<u16, huffman_max_code_length + 1> count {};
+    Array<u16, 257> symbols {};
+};
+
+static HuffmanDecodingTable const& huffman_decoding_table()
+{
+    static HuffmanDecodingTable const table;
+    return table;
+}
+
+ErrorOr<String> decode_huffman(ReadonlyBytes bytes)
+{
+    auto& table = huffman_decoding_table();
+    StringBuilder builder(bytes.size() * 8 / 5);
+
+    u32 code = 0;
+    u8 code_length = 0;
+    for (auto byte : bytes) {
+        for (int bit = 7; bit >= 0; --bit) {
+            code = (code << 1) | ((byte >> bit) & 1);
+            ++code_length;
+            if (code - table.first_code[code_length] < table.count[code_length]) {
+                auto symbol = table.symbols[table.first_index[code_length] + code - table.first_code[code_length]];
+                if (symbol == huffman_eos_symbol)
+                    return Error::from_string_literal("HPACK: EOS in Huffman-coded string"sv);
+                builder.append(static_cast<char>(symbol));
+                code = 0;
+                code_length = 0;
+            } else if (code_length == huffman_max_code_length) {
+                return Error::from_string_literal("HPACK: Invalid Huffman code"sv);
+            }
+        }
+    }
+
+    // What's left has to be padding: fewer than 8 bits, all of them set (i.e. a prefix of EOS).
+    if (code_length >= 8 || code != (1u << code_length) - 1)
+        return Error::from_string_literal("HPACK: Invalid Huffman padding"sv);
+
+    return builder.build();
+}
+
+size_t huffman_encoded_length(StringView string)
+{
+    size_t bit_count = 0;
+    for (auto ch : string)
+        bit_count += s_huffman_codes[static_cast<u8>(ch)].length;
+    return (bit_count + 7) / 8;
+}
+
+ErrorOr<void> encode_huffman(StringView string, ByteBuffer& output)
+{
+    u64 bits = 0;
+    u8 bit_count = 0;
+    for (auto ch : string) {
+        auto& code = s_huffman_codes[static_cast<u8>(ch)];
+        bits = (bits << code.length) | code.code;
+        bit_count += code.length;
+        while (bit_count >= 8) {
+            bit_count -= 8;
+            TRY(output.try_append(static_cast<u8>(bits >> bit_count)));
+        }
+    }
+    if (bit_count > 0) {
+        // Pad with the most significant bits of EOS.
+        auto padding = 8 - bit_count;
+        TRY(output.try_append(static_cast<u8>((bits << padding) | ((1u << padding) - 1))));
+    }
+    return {};
+}
+
+static ErrorOr<u64> decode_integer(ReadonlyBytes bytes, size_t& offset, u8 prefix_bits)
+{
+    if (offset >= bytes.size())
+        return Error::from_string_literal("HPACK: Truncated integer"sv);
+
+    u8 prefix_mask = (1u << prefix_bits) - 1;
+    u64 value = bytes[offset++] & prefix_mask;
+    if (value < prefix_mask)
+        return value;
+
+    for (u8 shift = 0;; shift += 7) {
+        if (offset >= bytes.size())
+            return Error::from_string_literal("HPACK: Truncated integer"sv);
+        // Nothing we deal with comes anywhere close to this, so anything longer is garbage.
+        if (shift > 28)
+            return Error::from_string_literal("HPACK: Integer too large"sv);
+        auto byte = bytes[offset++];
+        value += static_cast<u64>(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+static ErrorOr<void> encode_integer(u64 value, u8 prefix_bits, u8 flags, ByteBuffer& output)
+{
+    u8 prefix_mask = (1u << prefix_bits) - 1;
+    if (value < prefix_mask)
+        return output.try_append(static_cast<u8>(flags | value));
+
+    TRY(output.try_append(static_cast<u8>(flags | prefix_mask)));
+    value -= prefix_mask;
+    while (value >= 0x80) {
+        TRY(output.try_append(static_cast<u8>((value & 0x7f) | 0x80)));
+        value >>= 7;
+    }
+    return output.try_append(static_cast<u8>(value));
+}
+
+static ErrorOr<String> decode_string(ReadonlyBytes bytes, size_t& offset)
+{
+    if (offset >= bytes.size())
+        return Error::from_string_literal("HPACK: Truncated string"sv);
+
+    bool is_huffman_coded = bytes[offset] & 0x80;
+    auto length = TRY(decode_integer(bytes, offset, 7));
+    if (length > bytes.size() - offset)
+        return Error::from_string_literal("HPACK: Truncated string"sv);
+
+    auto string_bytes = bytes.slice(offset, length);
+    offset += length;
+    if (is_huffman_coded)
+        return decode_huffman(string_bytes);
+    return String { string_bytes };
+}
+
+static ErrorOr<void> encode_string(StringView string, ByteBuffer& output)
+{
+    auto huffman_length = huffman_encoded_length(string);
+    if (huffman_length < string.length()) {
+        TRY(encode_integer(huffman_length, 7, 0x80, output));
+        return encode_huffman(string, output);
+    }
+    TRY(encode_integer(string.length(), 7, 0, output));
+    return output.try_append(string.bytes());
+}
+
+void DynamicTable::add(Header header)
+{
+    auto size = entry_size(header);
+    // An entry that's too big for the table empties it, and isn't added itself (RFC 7541 section 4.4).
+    if (size > m_max_size) {
+        evict_until_size_is_at_most(0);
+        return;
+    }
+    evict_until_size_is_at_most(m_max_size - size);
+    m_size += size;
+    m_entries.append(move(header));
+}
+
+void DynamicTable::set_max_size(size_t max_size)
+{
+    m_max_size = max_size;
+    evict_until_size_is_at_most(max_size);
+}
+
+void DynamicTable::evict_until_size_is_at_most(size_t size)
+{
+    size_t evicted_count = 0;
+    while (m_size > size) {
+        m_size -= entry_size(m_entries[evicted_count]);
+        ++evicted_count;
+    }
+    m_entries.remove(0, evicted_count);
+}
+
+ErrorOr<Header> Decoder::header_at(size_t index) const
+{
+    if (index == 0)
+        return Error::from_string_literal("HPACK: Index 0 is invalid"sv);
+    if (index <= s_static_table.size()) {
+        auto& entry = s_static_table[index - 1];
+        return Header { entry.name, entry.value };
+    }
+    index -= s_static_table.size() + 1;
+    if (index >= m_table.entry_count())
+        return Error::from_string_literal("HPACK: Index is past the end of the dynamic table"sv);
+    return m_table.at(index);
+}
+
+ErrorOr<String> Decoder::name_at(size_t index) const
+{
+    return TRY(header_at(index)).name;
+}
+
+ErrorOr<Vector<Header>> Decoder::decode(ReadonlyBytes bytes)
+{
+    Vector<Header> headers;
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        auto byte = bytes[offset];
+        if (byte & 0x80) {
+            // Indexed Header Field Representation (RFC 7541 section 6.1)
+            auto index = TRY(decode_integer(bytes, offset, 7));
+            TRY(headers.try_append(TRY(header_at(index))));
+        } else if ((byte & 0xc0) == 0x40) {
+            // Literal Header Field with Incremental Indexing (RFC 7541 section 6.2.1)
+            auto index = TRY(decode_integer(bytes, offset, 6));
+            auto name = index != 0 ? TRY(name_at(index)) : TRY(decode_string(bytes, offset));
+            auto value = TRY(decode_string(bytes, offset));
+            Header header { move(name), move(value) };
+            m_table.add(header);
+            TRY(headers.try_append(move(header)));
+        } else if ((byte & 0xe0) == 0x20) {
+            // Dynamic Table Size Update (RFC 7541 section 6.3), which is only allowed at the start of a block.
+            if (!headers.is_empty())
+                return Error::from_string_literal("HPACK: Table size update after a header"sv);
+            auto max_size = TRY(decode_integer(bytes, offset, 5));
+            if (max_size > m_max_table_size_limit)
+                return Error::from_string_literal("HPACK: Table size update exceeds our limit"sv);
+            m_table.set_max_size(max_size);
+        } else {
+            // Literal Header Field without Indexing / Never Indexed (RFC 7541 sections 6.2.2 and 6.2.3)
+            auto index = TRY(decode_integer(bytes, offset, 4));
+            auto name = index != 0 ? TRY(name_at(index)) : TRY(decode_string(bytes, offset));
+            auto value = TRY(decode_string(bytes, offset));
+            TRY(headers.try_append(Header { move(name), move(value) }));
+        }
+    }
+    return headers;
+}
+
+void Encoder::set_max_table_size(size_t max_size)
+{
+    // We don't need more than the default, even if the peer would let us have it.
+    max_size = min(max_size, Decoder::default_max_table_size);
+    if (max_size == m_table.max_size() && !m_pending_table_size_update.has_value())
+        return;
+    m_table.set_max_size(max_size);
+    m_pending_table_size_update = max_size;
+}
+
+ErrorOr<void> Encoder::encode(Vector<Header> const& headers, ByteBuffer& output)
+{
+    if (m_pending_table_size_update.has_value()) {
+        TRY(encode_integer(m_pending_table_size_update.release_value(), 5, 0x20, output));
+    }
+    for (auto& header : headers)
+        TRY(encode_header(header, output));
+    return {};
+}
+
+ErrorOr<void> Encoder::encode_header(Header const& header, ByteBuffer& output)
+{
+    size_t name_index = 0;
+    for (size_t i = 0; i < s_static_table.size(); ++i) {
+        auto& entry = s_static_table[i];
+        if (entry.name != header.name)
+            continue;
+        if (entry.value == header.value)
+            return encode_integer(i + 1, 7, 0x80, output);
+        if (name_index == 0)
+            name_index = i + 1;
+    }
+    for (size_t i = 0; i < m_table.entry_count(); ++i) {
+        auto& entry = m_table.at(i);
+        if (entry.name != header.name)
+            continue;
+        if (entry.value == header.value)
+            return encode_integer(s_static_table.size() + i + 1, 7, 0x80, output);
+        if (name_index == 0)
+            name_index = s_static_table.size() + i + 1;
+    }
+
+    // Credentials are never put in a table, so they can't be guessed at by an intermediary that sees the compressed size (RFC 7541 section 7.1.3).
+    bool is_sensitive = header.name == "authorization"sv || header.name == "proxy-authorization"sv;
+    bool should_index = !is_sensitive && DynamicTable::entry_size(header) <= m_table.max_size() / 2;
+    if (should_index)
+        TRY(encode_integer(name_index, 6, 0x40, output));
+    else
+        TRY(encode_integer(name_index, 4, is_sensitive ? 0x10 : 0x00, output));
+    if (name_index == 0)
+        TRY(encode_string(header.name, output));
+    TRY(encode_string(header.value, output));
+
+    if (should_index)
+        m_table.add(header);
+    return {};
+}
+
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Error.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+// HPACK, the header compression of HTTP/2 (RFC 7541).
+namespace HTTP::HPACK {
+
+struct Header {
+    String name;
+    String value;
+
+    bool operator==(Header const&) const = default;
+};
+
+// The dynamic table that both ends of a connection keep in sync (RFC 7541 section 2.3.2).
+class DynamicTable {
+public:
+    explicit DynamicTable(size_t max_size)
+        : m_max_size(max_size)
+    {
+    }
+
+    size_t size() const { return m_size; }
+    size_t max_size() const { return m_max_size; }
+    size_t entry_count() const { return m_entries.size(); }
+
+    // Index 0 is the most recently added entry.
+    Header const& at(size_t index) const { return m_entries[m_entries.size() - index - 1]; }
+
+    void add(Header);
+    void set_max_size(size_t);
+
+    static size_t entry_size(Header const& header) { return header.name.length() + header.value.length() + 32; }
+
+private:
+    void evict_until_size_is_at_most(size_t);
+
+    // Oldest entries first, so that adding and evicting are cheap.
+    Vector<Header> m_entries;
+    size_t m_size { 0 };
+    size_t m_max_size { 0 };
+};
+
+class Decoder {
+public:
+    static constexpr size_t default_max_table_size = 4096;
+
+    explicit Decoder(size_t max_table_size = default_max_table_size)
+        : m_table(max_table_size)
+        , m_max_table_size_limit(max_table_size)
+    {
+    }
+
+    // Decodes a complete header block, updating the dynamic table as it goes. Errors are fatal to the connection.
+    ErrorOr<Vector<Header>> decode(ReadonlyBytes);
+
+    DynamicTable const& table() const { return m_table; }
+
+private:
+    ErrorOr<Header> header_at(size_t index) const;
+    ErrorOr<String> name_at(size_t index) const;
+
+    DynamicTable m_table;
+    // The most the peer is allowed to grow our table to, i.e. our SETTINGS_HEADER_TABLE_SIZE.
+    size_t m_max_table_size_limit { 0 };
+};
+
+class Encoder {
+public:
+    explicit Encoder(size_t max_table_size = Decoder::default_max_table_size)
+        : m_table(max_table_size)
+    {
+    }
+
+    // Called with the peer's SETTINGS_HEADER_TABLE_SIZE; the change is announced at the start of the next header block.
+    void set_max_table_size(size_t);
+
+    ErrorOr<void> encode(Vector<Header> const&, ByteBuffer& output);
+
+    DynamicTable const& table() const { return m_table; }
+
+private:
+    ErrorOr<void> encode_header(Header const&, ByteBuffer& output);
+
+    DynamicTable m_table;
+    Optional<size_t> m_pending_table_size_update;
+};
+
+// Exposed for testing; the encoder only uses Huffman coding when it makes a string shorter.
+ErrorOr<String> decode_huffman(ReadonlyBytes);
+ErrorOr<void> encode_huffman(StringView, ByteBuffer& output);
+size_t huffman_encoded_length(StringView);
+
+}
@@ -0,0 +1,661 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <LibHTTP/Http2Connection.h>
+
+namespace HTTP {
+
+static constexpr StringView connection_preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"sv;
+static constexpr size_t frame_header_size = 9;
+// We never raise SETTINGS_MAX_FRAME_SIZE, so this is the most the server may send us at once.
+static constexpr u32 max_receive_frame_size = 16384;
+static constexpr u32 max_window_size = 0x7fffffff;
+
+// How much the server may send before we have to acknowledge it; big enough to not hold back a fast connection.
+static constexpr u32 stream_receive_window = 1 * MiB;
+static constexpr u32 connection_receive_window = 4 * MiB;
+static constexpr u32 default_window_size = 65535;
+
+enum class Setting : u16 {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+enum Flags : u8 {
+    EndStream = 0x1,
+    Ack = 0x1,
+    EndHeaders = 0x4,
+    Padded = 0x8,
+    Priority = 0x20,
+};
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return (static_cast<u32>(bytes[0]) << 24) | (static_cast<u32>(bytes[1]) << 16) | (static_cast<u32>(bytes[2]) << 8) | bytes[3];
+}
+
+static void append_u32(ByteBuffer& buffer, u32 value)
+{
+    u8 bytes[4] = { static_cast<u8>(value >> 24), static_cast<u8>(value >> 16), static_cast<u8>(value >> 8), static_cast<u8>(value) };
+    buffer.append(bytes, sizeof(bytes));
+}
+
+static void append_setting(ByteBuffer& buffer, Setting setting, u32 value)
+{
+    buffer.append(static_cast<u8>(to_underlying(setting) >> 8));
+    buffer.append(static_cast<u8>(to_underlying(setting)));
+    append_u32(buffer, value);
+}
+
+// Removes the padding from DATA and HEADERS frames (RFC 9113 section 6.1), or returns false if it doesn't fit.
+static bool remove_padding(u8 flags, ReadonlyBytes& payload)
+{
+    if (!(flags & Flags::Padded))
+        return true;
+    if (payload.is_empty())
+        return false;
+    size_t padding = payload[0];
+    if (padding >= payload.size())
+        return false;
+    payload = payload.slice(1, payload.size() - 1 - padding);
+    return true;
+}
+
+Http2Connection::Http2Connection(Core::Stream::BufferedSocketBase& socket)
+    : m_socket(&socket)
+{
+    m_socket->on_ready_to_read = [this] { read_from_socket(); };
+    send_connection_preface();
+    // Nothing may come of a connection that was opened ahead of time.
+    did_become_idle_if_needed();
+}
+
+Http2Connection::~Http2Connection()
+{
+    detach();
+}
+
+bool Http2Connection::is_usable() const
+{
+    return m_socket && !m_is_closed && !m_is_going_away && m_socket->is_open() && !m_socket->is_eof();
+}
+
+void Http2Connection::detach()
+{
+    if (!m_socket)
+        return;
+    m_socket->on_ready_to_read = nullptr;
+    m_socket = nullptr;
+    m_is_closed = true;
+    fail_all_streams(Core::NetworkJob::Error::ConnectionFailed);
+}
+
+void Http2Connection::send_connection_preface()
+{
+    // The preface is followed by our SETTINGS (RFC 9113 section 3.4); the connection window can only be raised by a WINDOW_UPDATE.
+    if (!m_socket->write_or_error(connection_preface.bytes())) {
+        did_close();
+        return;
+    }
+
+    ByteBuffer settings;
+    append_setting(settings, Setting::EnablePush, 0);
+    append_setting(settings, Setting::InitialWindowSize, stream_receive_window);
+    send_frame(FrameType::Settings, 0, 0, settings);
+    send_window_update(0, connection_receive_window - default_window_size);
+}
+
+void Http2Connection::send_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (!m_socket)
+        return;
+    VERIFY(payload.size() <= m_max_send_frame_size);
+
+    ByteBuffer frame;
+    frame.ensure_capacity(frame_header_size + payload.size());
+    frame.append(static_cast<u8>(payload.size() >> 16));
+    frame.append(static_cast<u8>(payload.size() >> 8));
+    frame.append(static_cast<u8>(payload.size()));
+    frame.append(to_underlying(type));
+    frame.append(flags);
+    append_u32(frame, stream_id & max_window_size);
+    frame.append(payload);
+
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Sending frame type={} flags={:#x} stream={} length={}", to_underlying(type), flags, stream_id, payload.size());
+    if (!m_socket->write_or_error(frame))
+        deferred_invoke([this] { fail_all_streams(Core::NetworkJob::Error::TransmissionFailed); did_close(); });
+}
+
+void Http2Connection::send_settings_ack()
+{
+    send_frame(FrameType::Settings, Flags::Ack, 0, {});
+}
+
+void Http2Connection::send_window_update(u32 stream_id, u32 increment)
+{
+    ByteBuffer payload;
+    append_u32(payload, increment);
+    send_frame(FrameType::WindowUpdate, 0, stream_id, payload);
+}
+
+void Http2Connection::send_reset_stream(u32 stream_id, ErrorCode error_code)
+{
+    ByteBuffer payload;
+    append_u32(payload, to_underlying(error_code));
+    send_frame(FrameType::ResetStream, 0, stream_id, payload);
+}
+
+void Http2Connection::send_go_away(ErrorCode error_code)
+{
+    ByteBuffer payload;
+    // We never accept streams from the server, so the last one we processed is always 0.
+    append_u32(payload, 0);
+    append_u32(payload, to_underlying(error_code));
+    send_frame(FrameType::GoAway, 0, 0, payload);
+}
+
+void Http2Connection::start_stream(StreamClient& client, Vector<HPACK::Header> headers, ByteBuffer body)
+{
+    m_pending_streams.append({ &client, move(headers), move(body) });
+    if (!is_usable()) {
+        deferred_invoke([this] { fail_all_streams(Core::NetworkJob::Error::ConnectionFailed); });
+        return;
+    }
+    start_pending_streams();
+}
+
+void Http2Connection::close_stream(StreamClient& client)
+{
+    m_pending_streams.remove_first_matching([&](auto& stream) { return stream.client == &client; });
+
+    Optional<u32> stream_id;
+    for (auto& it : m_streams) {
+        if (it.value.client == &client) {
+            stream_id = it.key;
+            break;
+        }
+    }
+    if (!stream_id.has_value())
+        return;
+
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Cancelling stream {}", *stream_id);
+    m_streams.remove(*stream_id);
+    send_reset_stream(*stream_id, ErrorCode::Cancel);
+    start_pending_streams();
+    did_become_idle_if_needed();
+}
+
+void Http2Connection::start_pending_streams()
+{
+    while (!m_pending_streams.is_empty() && m_streams.size() < m_max_concurrent_streams && is_usable())
+        open_stream(m_pending_streams.take_first());
+}
+
+void Http2Connection::open_stream(PendingStream pending_stream)
+{
+    auto stream_id = m_next_stream_id;
+    m_next_stream_id += 2;
+
+    ByteBuffer header_block;
+    if (auto result = m_encoder.encode(pending_stream.headers, header_block); result.is_error()) {
+        dbgln("Http2Connection: Failed to encode headers: {}", result.error());
+        pending_stream.client->http2_did_fail(Core::NetworkJob::Error::TransmissionFailed);
+        return;
+    }
+
+    bool has_body = !pending_stream.body.is_empty();
+    m_streams.set(stream_id, Stream { pending_stream.client, m_initial_send_window, 0, move(pending_stream.body), 0, false });
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Opened stream {}", stream_id);
+
+    // Header blocks larger than a frame continue in CONTINUATION frames, which must follow immediately.
+    auto remaining = header_block.bytes();
+    auto type = FrameType::Headers;
+    do {
+        auto fragment = remaining.trim(m_max_send_frame_size);
+        remaining = remaining.slice(fragment.size());
+        u8 flags = remaining.is_empty() ? Flags::EndHeaders : 0;
+        if (type == FrameType::Headers && !has_body)
+            flags |= Flags::EndStream;
+        send_frame(type, flags, stream_id, fragment);
+        type = FrameType::Continuation;
+    } while (!remaining.is_empty());
+
+    if (has_body)
+        send_pending_data(stream_id, m_streams.find(stream_id)->value);
+}
+
+void Http2Connection::send_pending_data()
+{
+    for (auto& it : m_streams) {
+        if (m_connection_send_window <= 0)
+            return;
+        send_pending_data(it.key, it.value);
+    }
+}
+
+void Http2Connection::send_pending_data(u32 stream_id, Stream& stream)
+{
+    while (stream.body_offset < stream.body_to_send.size()) {
+        auto window = min(stream.send_window, m_connection_send_window);
+        if (window <= 0)
+            return;
+        auto remaining = stream.body_to_send.size() - stream.body_offset;
+        auto chunk_size = min(min(remaining, static_cast<size_t>(window)), static_cast<size_t>(m_max_send_frame_size));
+        bool is_last_chunk = chunk_size == remaining;
+        send_frame(FrameType::Data, is_last_chunk ? Flags::EndStream : 0, stream_id, stream.body_to_send.bytes().slice(stream.body_offset, chunk_size));
+        stream.body_offset += chunk_size;
+        stream.send_window -= chunk_size;
+        m_connection_send_window -= chunk_size;
+    }
+    stream.body_to_send.clear();
+    stream.body_offset = 0;
+}
+
+void Http2Connection::read_from_socket()
+{
+    // NOTE: Our clients may let go of us while we're telling them about what we received.
+    NonnullRefPtr protector(*this);
+
+    while (m_socket) {
+        auto can_read_without_blocking = m_socket->can_read_without_blocking();
+        if (can_read_without_blocking.is_error()) {
+            fail_all_streams(Core::NetworkJob::Error::TransmissionFailed);
+            return did_close();
+        }
+        if (!can_read_without_blocking.value())
+            break;
+
+        u8 buffer[16 * KiB];
+        auto result = m_socket->read({ buffer, sizeof(buffer) });
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            dbgln_if(HTTP2_DEBUG, "Http2Connection: Failed to read: {}", result.error());
+            fail_all_streams(Core::NetworkJob::Error::TransmissionFailed);
+            return did_close();
+        }
+        auto nread = result.release_value();
+        if (nread == 0)
+            break;
+        m_input_buffer.append(buffer, nread);
+    }
+
+    size_t offset = 0;
+    while (!m_is_closed && m_input_buffer.size() - offset >= frame_header_size) {
+        auto header = m_input_buffer.bytes().slice(offset, frame_header_size);
+        u32 length = (static_cast<u32>(header[0]) << 16) | (static_cast<u32>(header[1]) << 8) | header[2];
+        if (length > max_receive_frame_size) {
+            connection_error(ErrorCode::FrameSizeError);
+            return;
+        }
+        if (m_input_buffer.size() - offset - frame_header_size < length)
+            break;
+
+        auto type = static_cast<FrameType>(header[3]);
+        auto flags = header[4];
+        auto stream_id = read_u32(header.slice(5)) & max_window_size;
+        auto payload = m_input_buffer.bytes().slice(offset + frame_header_size, length);
+        offset += frame_header_size + length;
+
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Received frame type={} flags={:#x} stream={} length={}", to_underlying(type), flags, stream_id, length);
+        if (!process_frame(type, flags, stream_id, payload))
+            return;
+    }
+    if (offset != 0)
+        m_input_buffer = m_input_buffer.slice(offset, m_input_buffer.size() - offset);
+
+    if (m_socket && (m_socket->is_eof() || !m_socket->is_open())) {
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Server closed the connection");
+        fail_all_streams(Core::NetworkJob::Error::TransmissionFailed);
+        did_close();
+    }
+}
+
+bool Http2Connection::process_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (m_header_block_stream_id != 0 && type != FrameType::Continuation) {
+        connection_error(ErrorCode::ProtocolError);
+        return false;
+    }
+
+    switch (type) {
+    case FrameType::Data:
+        return process_data(flags, stream_id, payload);
+    case FrameType::Headers:
+        return process_headers(flags, stream_id, payload);
+    case FrameType::Continuation:
+        return process_continuation(flags, stream_id, payload);
+    case FrameType::Settings:
+        return process_settings(flags, stream_id, payload);
+    case FrameType::WindowUpdate:
+        return process_window_update(stream_id, payload);
+    case FrameType::GoAway:
+        return process_go_away(payload);
+    case FrameType::Ping:
+        if (stream_id != 0 || payload.size() != 8) {
+            connection_error(stream_id != 0 ? ErrorCode::ProtocolError : ErrorCode::FrameSizeError);
+            return false;
+        }
+        if (!(flags & Flags::Ack))
+            send_frame(FrameType::Ping, Flags::Ack, 0, payload);
+        return true;
+    case FrameType::ResetStream:
+        if (stream_id == 0 || payload.size() != 4) {
+            connection_error(stream_id == 0 ? ErrorCode::ProtocolError : ErrorCode::FrameSizeError);
+            return false;
+        }
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Server reset stream {} with error {}", stream_id, read_u32(payload));
+        fail_stream(stream_id, Core::NetworkJob::Error::ProtocolFailed);
+        return !m_is_closed;
+    case FrameType::PushPromise:
+        // We told the server not to push anything.
+        connection_error(ErrorCode::ProtocolError);
+        return false;
+    case FrameType::Priority:
+    default:
+        // Unknown frame types must be ignored (RFC 9113 section 4.1).
+        return true;
+    }
+}
+
+bool Http2Connection::process_data(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0) {
+        connection_error(ErrorCode::ProtocolError);
+        return false;
+    }
+
+    // Padding counts towards flow control as well.
+    auto flow_controlled_size = payload.size();
+    m_connection_received_since_window_update += flow_controlled_size;
+    if (m_connection_received_since_window_update >= connection_receive_window / 2) {
+        send_window_update(0, m_connection_received_since_window_update);
+        m_connection_received_since_window_update = 0;
+    }
+
+    if (!remove_padding(flags, payload)) {
+        connection_error(ErrorCode::ProtocolError);
+        return false;
+    }
+
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end()) {
+        // The stream may have been cancelled while this was on its way.
+        if (stream_id >= m_next_stream_id) {
+            connection_error(ErrorCode::ProtocolError);
+            return false;
+        }
+        return true;
+    }
+
+    auto& stream = it->value;
+    if (!stream.has_received_headers) {
+        send_reset_stream(stream_id, ErrorCode::ProtocolError);
+        fail_stream(stream_id, Core::NetworkJob::Error::ProtocolFailed);
+        return !m_is_closed;
+    }
+
+    bool ends_stream = flags & Flags::EndStream;
+    if (!ends_stream) {
+        stream.received_since_window_update += flow_controlled_size;
+        if (stream.received_since_window_update >= stream_receive_window / 2) {
+            send_window_update(stream_id, stream.received_since_window_update);
+            stream.received_since_window_update = 0;
+        }
+    }
+
+    auto* client = stream.client;
+    if (ends_stream)
+        end_stream(stream_id);
+    client->http2_did_receive_data(payload, ends_stream);
+    return !m_is_closed;
+}
+
+bool Http2Connection::process_headers(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0 || !remove_padding(flags, payload)) {
+        connection_error(ErrorCode::ProtocolError);
+        return false;
+    }
+    if (flags & Flags::Priority) {
+        // Stream dependency and weight, which we have no use for.
+        if (payload.size() < 5) {
+            connection_error(ErrorCode::FrameSizeError);
+            return false;
+        }
+        payload = payload.slice(5);
+    }
+
+    m_header_block.clear();
+    m_header_block.append(payload);
+    m_header_block_ends_stream = flags & Flags::EndStream;
+    if (!(flags & Flags::EndHeaders)) {
+        m_header_block_stream_id = stream_id;
+        return true;
+    }
+    return process_header_block(stream_id, m_header_block_ends_stream);
+}
+
+bool Http2Connection::process_continuation(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (m_header_block_stream_id == 0 || stream_id != m_header_block_stream_id) {
+        connection_error(ErrorCode::ProtocolError);
+        return false;
+    }
+    m_header_block.append(payload);
+    if (!(flags & Flags::EndHeaders))
+        return true;
+    m_header_block_stream_id = 0;
+    return process_header_block(stream_id, m_header_block_ends_stream);
+}
+
+bool Http2Connection::process_header_block(u32 stream_id, bool ends_stream)
+{
+    // The block has to be decoded even if nobody's interested in it anymore, to keep the dynamic table in sync.
+    auto headers = m_decoder.decode(m_header_block);
+    m_header_block.clear();
+    if (headers.is_error()) {
+        dbgln("Http2Connection: Failed to decode headers: {}", headers.error());
+        connection_error(ErrorCode::CompressionError);
+        return false;
+    }
+
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return true;
+
+    auto* client = it->value.client;
+    it->value.has_received_headers = true;
+    if (ends_stream)
+        end_stream(stream_id);
+    client->http2_did_receive_headers(headers.release_value(), ends_stream);
+    return !m_is_closed;
+}
+
+bool Http2Connection::process_settings(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0) {
+        connection_error(ErrorCode::ProtocolError);
+        return false;
+    }
+    if (flags & Flags::Ack)
+        return true;
+    if (payload.size() % 6 != 0) {
+        connection_error(ErrorCode::FrameSizeError);
+        return false;
+    }
+
+    for (size_t offset = 0; offset < payload.size(); offset += 6) {
+        auto setting = static_cast<Setting>((payload[offset] << 8) | payload[offset + 1]);
+        auto value = read_u32(payload.slice(offset + 2));
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Server setting {} = {}", to_underlying(setting), value);
+        switch (setting) {
+        case Setting::HeaderTableSize:
+            m_encoder.set_max_table_size(value);
+            break;
+        case Setting::MaxConcurrentStreams:
+            m_max_concurrent_streams = value;
+            break;
+        case Setting::InitialWindowSize: {
+            if (value > max_window_size) {
+                connection_error(ErrorCode::FlowControlError);
+                return false;
+            }
+            // The change applies to the windows of all open streams as well (RFC 9113 section 6.9.2).
+            i64 delta = static_cast<i64>(value) - m_initial_send_window;
+            for (auto& it : m_streams)
+                it.value.send_window += delta;
+            m_initial_send_window = value;
+            break;
+        }
+        case Setting::MaxFrameSize:
+            if (value < 16384 || value > 16777215) {
+                connection_error(ErrorCode::ProtocolError);
+                return false;
+            }
+            m_max_send_frame_size = value;
+            break;
+        default:
+            break;
+        }
+    }
+    send_settings_ack();
+    start_pending_streams();
+    send_pending_data();
+    return true;
+}
+
+bool Http2Connection::process_window_update(u32 stream_id, ReadonlyBytes payload)
+{
+    if (payload.size() != 4) {
+        connection_error(ErrorCode::FrameSizeError);
+        return false;
+    }
+    auto increment = read_u32(payload) & max_window_size;
+
+    if (stream_id == 0) {
+        if (increment == 0 || m_connection_send_window + increment > max_window_size) {
+            connection_error(increment == 0 ? ErrorCode::ProtocolError : ErrorCode::FlowControlError);
+            return false;
+        }
+        m_connection_send_window += increment;
+        send_pending_data();
+        return true;
+    }
+
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return true;
+    if (increment == 0 || it->value.send_window + increment > max_window_size) {
+        send_reset_stream(stream_id, increment == 0 ? ErrorCode::ProtocolError : ErrorCode::FlowControlError);
+        fail_stream(stream_id, Core::NetworkJob::Error::ProtocolFailed);
+        return !m_is_closed;
+    }
+    it->value.send_window += increment;
+    send_pending_data(stream_id, it->value);
+    return true;
+}
+
+bool Http2Connection::process_go_away(ReadonlyBytes payload)
+{
+    if (payload.size() < 8) {
+        connection_error(ErrorCode::FrameSizeError);
+        return false;
+    }
+    auto last_stream_id = read_u32(payload) & max_window_size;
+    dbgln_if(HTTP2_DEBUG, "Http2Connection: Server is going away, last stream {}, error {}", last_stream_id, read_u32(payload.slice(4)));
+    m_is_going_away = true;
+
+    // Streams the server never got around to can't be started anywhere else from here, so they fail like refused connections do.
+    Vector<u32> unprocessed_streams;
+    for (auto& it : m_streams) {
+        if (it.key > last_stream_id)
+            unprocessed_streams.append(it.key);
+    }
+    for (auto stream_id : unprocessed_streams)
+        fail_stream(stream_id, Core::NetworkJob::Error::ConnectionFailed);
+    for (auto& pending_stream : exchange(m_pending_streams, {}))
+        pending_stream.client->http2_did_fail(Core::NetworkJob::Error::ConnectionFailed);
+
+    // The streams the server did get to are still answered, so we only close once they're done.
+    did_become_idle_if_needed();
+    return !m_is_closed;
+}
+
+void Http2Connection::end_stream(u32 stream_id)
+{
+    m_streams.remove(stream_id);
+    start_pending_streams();
+    did_become_idle_if_needed();
+}
+
+void Http2Connection::fail_stream(u32 stream_id, Core::NetworkJob::Error error)
+{
+    auto it = m_streams.find(stream_id);
+    if (it == m_streams.end())
+        return;
+    auto* client = it->value.client;
+    end_stream(stream_id);
+    client->http2_did_fail(error);
+}
+
+void Http2Connection::connection_error(ErrorCode error_code)
+{
+    dbgln("Http2Connection: Connection error {}", to_underlying(error_code));
+    send_go_away(error_code);
+    fail_all_streams(Core::NetworkJob::Error::ProtocolFailed);
+    did_close();
+}
+
+void Http2Connection::fail_all_streams(Core::NetworkJob::Error error)
+{
+    auto streams = move(m_streams);
+    auto pending_streams = move(m_pending_streams);
+    for (auto& it : streams)
+        it.value.client->http2_did_fail(error);
+    for (auto& pending_stream : pending_streams)
+        pending_stream.client->http2_did_fail(error);
+}
+
+void Http2Connection::did_become_idle_if_needed()
+{
+    if (has_active_streams())
+        return;
+    deferred_invoke([this] {
+        if (has_active_streams())
+            return;
+        if (m_is_going_away)
+            return did_close();
+        if (on_idle)
+            on_idle();
+    });
+}
+
+void Http2Connection::did_close()
+{
+    if (m_is_closed)
+        return;
+    m_is_closed = true;
+    deferred_invoke([this] {
+        if (on_close)
+            on_close();
+    });
+}
+
+void Http2Connection::dump_streams() const
+{
+    dbgln("    HTTP/2: usable={}, {} active streams, {} waiting (server allows {})", is_usable(), m_streams.size(), m_pending_streams.size(), m_max_concurrent_streams);
+    for (auto& it : m_streams)
+        dbgln("    - Stream {} for {}, send window {}", it.key, it.value.client, it.value.send_window);
+}
+
+}
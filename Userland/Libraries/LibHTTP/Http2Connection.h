@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Vector.h>
+#include <LibCore/NetworkJob.h>
+#include <LibCore/Object.h>
+#include <LibCore/Stream.h>
+#include <LibHTTP/HPACK.h>
+
+namespace HTTP {
+
+// The client side of an HTTP/2 connection (RFC 9113), which multiplexes any number of requests over one socket.
+// The socket belongs to whoever created the connection, and has to outlive it or be detach()ed from it first.
+class Http2Connection final : public Core::Object {
+    C_OBJECT(Http2Connection);
+
+public:
+    // The receiving end of a stream, i.e. of a single request. Callbacks for a stream stop once it has
+    // ended (with end_stream set, or by failing), or once the client has been passed to close_stream().
+    class StreamClient {
+    public:
+        virtual ~StreamClient() = default;
+
+        virtual void http2_did_receive_headers(Vector<HPACK::Header>, bool end_stream) = 0;
+        virtual void http2_did_receive_data(ReadonlyBytes, bool end_stream) = 0;
+        virtual void http2_did_fail(Core::NetworkJob::Error) = 0;
+    };
+
+    virtual ~Http2Connection() override;
+
+    // Whether new streams can be started; false once either side has started shutting the connection down.
+    bool is_usable() const;
+    bool has_active_streams() const { return !m_streams.is_empty() || !m_pending_streams.is_empty(); }
+
+    // Starts a request. Streams beyond what the server allows at once wait until others have ended.
+    void start_stream(StreamClient&, Vector<HPACK::Header>, ByteBuffer body);
+    // Cancels a stream; does nothing if the stream has already ended.
+    void close_stream(StreamClient&);
+
+    // Stops using the socket, failing any streams that are still active.
+    void detach();
+
+    // Called (deferred) whenever no streams are left active, and when the connection can't be used anymore.
+    Function<void()> on_idle;
+    Function<void()> on_close;
+
+    void dump_streams() const;
+
+private:
+    explicit Http2Connection(Core::Stream::BufferedSocketBase&);
+
+    enum class FrameType : u8 {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        ResetStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9,
+    };
+
+    enum class ErrorCode : u32 {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        StreamClosed = 0x5,
+        FrameSizeError = 0x6,
+        RefusedStream = 0x7,
+        Cancel = 0x8,
+        CompressionError = 0x9,
+    };
+
+    struct Stream {
+        StreamClient* client { nullptr };
+        // How much we may still send, and how much the server has sent since we last gave it more room.
+        i64 send_window { 0 };
+        u32 received_since_window_update { 0 };
+        ByteBuffer body_to_send;
+        size_t body_offset { 0 };
+        bool has_received_headers { false };
+    };
+
+    struct PendingStream {
+        StreamClient* client { nullptr };
+        Vector<HPACK::Header> headers;
+        ByteBuffer body;
+    };
+
+    void send_connection_preface();
+    void send_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void send_settings_ack();
+    void send_window_update(u32 stream_id, u32 increment);
+    void send_reset_stream(u32 stream_id, ErrorCode);
+    void send_go_away(ErrorCode);
+
+    void start_pending_streams();
+    void open_stream(PendingStream);
+    // Sends as much of the request bodies as flow control allows.
+    void send_pending_data();
+    void send_pending_data(u32 stream_id, Stream&);
+
+    void read_from_socket();
+    // Returns false once the connection has failed.
+    bool process_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    bool process_data(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    bool process_headers(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    bool process_continuation(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    bool process_header_block(u32 stream_id, bool end_stream);
+    bool process_settings(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    bool process_window_update(u32 stream_id, ReadonlyBytes payload);
+    bool process_go_away(ReadonlyBytes payload);
+
+    // Removes the stream before telling its client, so the client is free to start or close other streams.
+    void end_stream(u32 stream_id);
+    void fail_stream(u32 stream_id, Core::NetworkJob::Error);
+    void connection_error(ErrorCode);
+    void fail_all_streams(Core::NetworkJob::Error);
+    void did_become_idle_if_needed();
+    void did_close();
+
+    Core::Stream::BufferedSocketBase* m_socket { nullptr };
+
+    HPACK::Encoder m_encoder;
+    HPACK::Decoder m_decoder;
+
+    HashMap<u32, Stream> m_streams;
+    Vector<PendingStream> m_pending_streams;
+    u32 m_next_stream_id { 1 };
+
+    // The parts of a header block that have been received so far; no other frames may arrive in between.
+    ByteBuffer m_header_block;
+    u32 m_header_block_stream_id { 0 };
+    bool m_header_block_ends_stream { false };
+
+    ByteBuffer m_input_buffer;
+
+    // The server's settings (RFC 9113 section 6.5.2).
+    u32 m_max_concurrent_streams { NumericLimits<u32>::max() };
+    u32 m_initial_send_window { 65535 };
+    u32 m_max_send_frame_size { 16384 };
+
+    i64 m_connection_send_window { 65535 };
+    u32 m_connection_received_since_window_update { 0 };
+
+    bool m_is_going_away { false };
+    bool m_is_closed { false };
+};
+
+}
@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
+#include <AK/Array.h>
 #include <AK/Base64.h>
 #include <AK/StringBuilder.h>
 #include <LibHTTP/HttpRequest.h>
@@ -56,6 +58,39 @@ ByteBuffer HttpRequest::to_raw_request() const
     return builder.to_byte_buffer();
 }
 
+Vector<HPACK::Header> HttpRequest::to_http2_headers() const
+{
+    StringBuilder path_builder;
+    // NOTE: The percent_encode is so that e.g. spaces are properly encoded.
+    VERIFY(!m_url.path().is_empty());
+    path_builder.append(URL::percent_encode(m_url.path(), URL::PercentEncodeSet::EncodeURI));
+    if (!m_url.query().is_empty()) {
+        path_builder.append('?');
+        path_builder.append(URL::percent_encode(m_url.query(), URL::PercentEncodeSet::EncodeURI));
+    }
+
+    auto authority = m_url.port().has_value() ? String::formatted("{}:{}", m_url.host(), *m_url.port()) : m_url.host();
+
+    Vector<HPACK::Header> headers;
+    headers.ensure_capacity(m_headers.size() + 5);
+    headers.append({ ":method", method_name() });
+    headers.append({ ":scheme", m_url.scheme() });
+    headers.append({ ":authority", move(authority) });
+    headers.append({ ":path", path_builder.to_string() });
+    for (auto& header : m_headers) {
+        // HTTP/2 has no use for connection-specific headers, and forbids them (RFC 9113 section 8.2.2).
+        // The Host header is replaced by :authority.
+        static constexpr Array connection_specific_headers { "Connection"sv, "Keep-Alive"sv, "Proxy-Connection"sv, "Transfer-Encoding"sv, "Upgrade"sv, "Host"sv };
+        if (any_of(connection_specific_headers, [&](auto name) { return header.name.equals_ignoring_case(name); }))
+            continue;
+        // Header names have to be lowercase (RFC 9113 section 8.2.1).
+        headers.append({ header.name.to_lowercase(), header.value });
+    }
+    if (!m_body.is_empty())
+        headers.append({ "content-length", String::number(m_body.size()) });
+    return headers;
+}
+
 Optional<HttpRequest> HttpRequest::from_raw_request(ReadonlyBytes raw_request)
 {
     enum class State {
@@ -157,6 +192,7 @@ Optional<HttpRequest> HttpRequest::from_raw_request(ReadonlyBytes raw_request)
         return {};
 
     request.m_resource = URL::percent_decode(resource);
+    request.m_protocol = move(protocol);
     request.m_headers = move(headers);
 
     return request;
@@ -13,6 +13,7 @@
 #include <AK/URL.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
+#include <LibHTTP/HPACK.h>
 
 namespace HTTP {
 
@@ -39,6 +40,8 @@ public:
     ~HttpRequest() = default;
 
     String const& resource() const { return m_resource; }
+    // The protocol from the request line of a parsed request, e.g. "HTTP/1.1".
+    String const& protocol() const { return m_protocol; }
     Vector<Header> const& headers() const { return m_headers; }
 
     URL const& url() const { return m_url; }
@@ -52,6 +55,8 @@ public:
 
     String method_name() const;
     ByteBuffer to_raw_request() const;
+    // The request line and headers as an HTTP/2 header list (RFC 9113 section 8.3.1), without the body.
+    Vector<HPACK::Header> to_http2_headers() const;
 
     void set_headers(HashMap<String, String> const&);
 
@@ -62,6 +67,7 @@ public:
 private:
     URL m_url;
     String m_resource;
+    String m_protocol;
     Method m_method { GET };
     Vector<Header> m_headers;
     ByteBuffer m_body;
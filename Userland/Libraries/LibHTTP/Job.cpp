@@ -7,8 +7,6 @@
 
 #include <AK/Debug.h>
 #include <AK/JsonArray.h>
-#include <LibCompress/Gzip.h>
-#include <LibCompress/Zlib.h>
 #include <LibCore/Event.h>
 #include <LibHTTP/HttpResponse.h>
 #include <LibHTTP/Job.h>
@@ -17,67 +15,18 @@
 
 namespace HTTP {
 
-static Optional<ByteBuffer> handle_content_encoding(const ByteBuffer& buf, const String& content_encoding)
-{
-    dbgln_if(JOB_DEBUG, "Job::handle_content_encoding: buf has content_encoding={}", content_encoding);
-
-    if (content_encoding == "gzip") {
-        if (!Compress::GzipDecompressor::is_likely_compressed(buf)) {
-            dbgln("Job::handle_content_encoding: buf is not gzip compressed!");
-        }
-
-        dbgln_if(JOB_DEBUG, "Job::handle_content_encoding: buf is gzip compressed!");
-
-        auto uncompressed = Compress::GzipDecompressor::decompress_all(buf);
-        if (!uncompressed.has_value()) {
-            dbgln("Job::handle_content_encoding: Gzip::decompress() failed.");
-            return {};
-        }
-
-        if constexpr (JOB_DEBUG) {
-            dbgln("Job::handle_content_encoding: Gzip::decompress() successful.");
-            dbgln("  Input size: {}", buf.size());
-            dbgln("  Output size: {}", uncompressed.value().size());
-        }
-
-        return uncompressed.release_value();
-    } else if (content_encoding == "deflate") {
-        dbgln_if(JOB_DEBUG, "Job::handle_content_encoding: buf is deflate compressed!");
-
-        // Even though the content encoding is "deflate", it's actually deflate with the zlib wrapper.
-        // https://tools.ietf.org/html/rfc7230#section-4.2.2
-        auto uncompressed = Compress::Zlib::decompress_all(buf);
-        if (!uncompressed.has_value()) {
-            // From the RFC:
-            // "Note: Some non-conformant implementations send the "deflate"
-            //        compressed data without the zlib wrapper."
-            dbgln_if(JOB_DEBUG, "Job::handle_content_encoding: Zlib::decompress_all() failed. Trying DeflateDecompressor::decompress_all()");
-            uncompressed = Compress::DeflateDecompressor::decompress_all(buf);
-
-            if (!uncompressed.has_value()) {
-                dbgln("Job::handle_content_encoding: DeflateDecompressor::decompress_all() failed.");
-                return {};
-            }
-        }
-
-        if constexpr (JOB_DEBUG) {
-            dbgln("Job::handle_content_encoding: Deflate decompression successful.");
-            dbgln("  Input size: {}", buf.size());
-            dbgln("  Output size: {}", uncompressed.value().size());
-        }
-
-        return uncompressed.release_value();
-    }
-
-    return buf;
-}
-
 Job::Job(HttpRequest&& request, Core::Stream::Stream& output_stream)
     : Core::NetworkJob(output_stream)
     , m_request(move(request))
 {
 }
 
+Job::~Job()
+{
+    if (m_http2_connection)
+        m_http2_connection->close_stream(*this);
+}
+
 void Job::start(Core::Stream::Socket& socket)
 {
     VERIFY(!m_socket);
@@ -89,8 +38,27 @@ void Job::start(Core::Stream::Socket& socket)
     });
 }
 
+void Job::start(Http2Connection& connection)
+{
+    VERIFY(!m_socket && !m_http2_connection);
+    m_http2_connection = connection;
+    dbgln_if(HTTPJOB_DEBUG, "Starting an HTTP/2 stream for {}", url());
+    deferred_invoke([this] {
+        // We may have been shut down in the meantime.
+        if (!m_http2_connection)
+            return;
+        m_http2_connection->start_stream(*this, m_request.to_http2_headers(), m_request.body());
+    });
+}
+
 void Job::shutdown(ShutdownMode mode)
 {
+    if (m_http2_connection) {
+        // The connection is shared with other jobs, so closing it is never up to us.
+        m_http2_connection->close_stream(*this);
+        m_http2_connection = nullptr;
+        return;
+    }
     if (!m_socket)
         return;
     if (mode == ShutdownMode::CloseSocket) {
@@ -103,7 +71,7 @@ void Job::shutdown(ShutdownMode mode)
 
 void Job::flush_received_buffers()
 {
-    if (!m_can_stream_response || m_buffered_size == 0)
+    if (m_buffered_size == 0)
         return;
     dbgln_if(JOB_DEBUG, "Job: Flushing received buffers: have {} bytes in {} buffers for {}", m_buffered_size, m_received_buffers.size(), m_request.url());
     for (size_t i = 0; i < m_received_buffers.size(); ++i) {
@@ -135,6 +103,30 @@ void Job::flush_received_buffers()
     dbgln_if(JOB_DEBUG, "Job: Flushing received buffers done: have {} bytes in {} buffers for {}", m_buffered_size, m_received_buffers.size(), m_request.url());
 }
 
+bool Job::did_receive_body_data(ByteBuffer data)
+{
+    m_received_size += data.size();
+    if (m_content_decoder) {
+        auto decoded = m_content_decoder->decode(data);
+        if (decoded.is_error()) {
+            dbgln("Job: Failed to decode the body of {}: {}", m_request.url(), decoded.error());
+            // Ignore whatever else comes in.
+            m_state = State::Finished;
+            deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+            return false;
+        }
+        data = decoded.release_value();
+    }
+
+    if (!data.is_empty()) {
+        m_buffered_size += data.size();
+        m_received_buffers.append(make<ReceivedBuffer>(move(data)));
+        flush_received_buffers();
+    }
+    deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+    return true;
+}
+
 void Job::register_on_ready_to_read(Function<void()> callback)
 {
     m_socket->on_ready_to_read = [this, callback = move(callback)] {
@@ -310,7 +302,8 @@ void Job::on_socket_connected()
                 // There's also the possibility that the server responds with 204 (No Content),
                 // and manages to set a Content-Length anyway, in such cases ignore Content-Length and quit early;
                 // As the HTTP spec explicitly prohibits presence of Content-Length when the response code is 204.
-                if (m_code == 204)
+                // Responses to conditional requests (304 Not Modified) don't have a body either, whatever their headers say.
+                if (m_code == 204 || m_code == 304)
                     return finish_up();
 
                 break;
@@ -357,9 +350,7 @@ void Job::on_socket_connected()
                 m_headers.set(name, value);
             }
             if (name.equals_ignoring_case("Content-Encoding")) {
-                // Assume that any content-encoding means that we can't decode it as a stream :(
-                dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
-                m_can_stream_response = false;
+                m_content_decoder = ContentDecoder::create(value);
             } else if (name.equals_ignoring_case("Content-Length")) {
                 auto length = value.to_uint();
                 if (length.has_value())
@@ -491,12 +482,8 @@ void Job::on_socket_connected()
                 }
             }
 
-            m_received_buffers.append(make<ReceivedBuffer>(payload));
-            m_buffered_size += payload.size();
-            m_received_size += payload.size();
-            flush_received_buffers();
-
-            deferred_invoke([this] { did_progress(m_content_length, m_received_size); });
+            if (!did_receive_body_data(payload))
+                return;
 
             if (read_everything) {
                 VERIFY(m_received_size <= m_content_length.value());
@@ -544,6 +531,79 @@ void Job::on_socket_connected()
     });
 }
 
+void Job::http2_did_receive_headers(Vector<HPACK::Header> headers, bool end_stream)
+{
+    if (m_state != State::InStatus) {
+        // Trailers, which we don't do anything with.
+        if (end_stream)
+            finish_up();
+        return;
+    }
+
+    auto status = headers.first_matching([](auto& header) { return header.name == ":status"sv; });
+    auto code = status.has_value() ? status->value.to_uint() : Optional<u32> {};
+    if (!code.has_value()) {
+        dbgln("Job: Expected an HTTP/2 :status pseudo-header");
+        return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
+    }
+    // Informational responses are followed by the real one.
+    if (code.value() < 200 && !end_stream)
+        return;
+    m_code = code.value();
+
+    for (auto& header : headers) {
+        if (header.name.starts_with(':'))
+            continue;
+        dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", header.name, header.value);
+        if (header.name == "set-cookie"sv) {
+            m_set_cookie_headers.append(move(header.value));
+            continue;
+        }
+        if (header.name == "content-encoding"sv) {
+            m_content_decoder = ContentDecoder::create(header.value);
+        } else if (header.name == "content-length"sv) {
+            if (auto length = header.value.to_uint(); length.has_value())
+                m_content_length = length.value();
+        }
+        if (auto existing_value = m_headers.get(header.name); existing_value.has_value())
+            m_headers.set(header.name, String::formatted("{},{}", existing_value.value(), header.value));
+        else
+            m_headers.set(header.name, move(header.value));
+    }
+
+    if (on_headers_received) {
+        if (!m_set_cookie_headers.is_empty())
+            m_headers.set("Set-Cookie", JsonArray { m_set_cookie_headers }.to_string());
+        on_headers_received(m_headers, m_code);
+    }
+    m_state = State::InBody;
+
+    if (end_stream)
+        finish_up();
+}
+
+void Job::http2_did_receive_data(ReadonlyBytes data, bool end_stream)
+{
+    if (m_state == State::Finished || is_cancelled())
+        return;
+
+    if (!data.is_empty()) {
+        auto buffer = ByteBuffer::copy(data);
+        if (buffer.is_error())
+            return deferred_invoke([this] { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
+        if (!did_receive_body_data(buffer.release_value()))
+            return;
+    }
+
+    if (end_stream)
+        finish_up();
+}
+
+void Job::http2_did_fail(Core::NetworkJob::Error error)
+{
+    deferred_invoke([this, error] { did_fail(error); });
+}
+
 void Job::timer_event(Core::TimerEvent& event)
 {
     event.accept();
@@ -556,32 +616,17 @@ void Job::finish_up()
 {
     VERIFY(!m_has_scheduled_finish);
     m_state = State::Finished;
-    if (!m_can_stream_response) {
-        auto maybe_flattened_buffer = ByteBuffer::create_uninitialized(m_buffered_size);
-        if (maybe_flattened_buffer.is_error())
+    if (m_content_decoder) {
+        // We may get here again while waiting for the client to consume the data, but the decoder is done with after this.
+        auto rest = m_content_decoder.release_nonnull()->finish();
+        if (rest.is_error()) {
+            dbgln("Job: Failed to decode the body of {}: {}", m_request.url(), rest.error());
             return did_fail(Core::NetworkJob::Error::TransmissionFailed);
-        auto flattened_buffer = maybe_flattened_buffer.release_value();
-
-        u8* flat_ptr = flattened_buffer.data();
-        for (auto& received_buffer : m_received_buffers) {
-            memcpy(flat_ptr, received_buffer.pending_flush.data(), received_buffer.pending_flush.size());
-            flat_ptr += received_buffer.pending_flush.size();
         }
-        m_received_buffers.clear();
-
-        // For the time being, we cannot stream stuff with content-encoding set to _anything_.
-        // FIXME: LibCompress exposes a streaming interface, so this can be resolved
-        auto content_encoding = m_headers.get("Content-Encoding");
-        if (content_encoding.has_value()) {
-            if (auto result = handle_content_encoding(flattened_buffer, content_encoding.value()); result.has_value())
-                flattened_buffer = result.release_value();
-            else
-                return did_fail(Core::NetworkJob::Error::TransmissionFailed);
+        if (!rest.value().is_empty()) {
+            m_buffered_size += rest.value().size();
+            m_received_buffers.append(make<ReceivedBuffer>(rest.release_value()));
         }
-
-        m_buffered_size = flattened_buffer.size();
-        m_received_buffers.append(make<ReceivedBuffer>(move(flattened_buffer)));
-        m_can_stream_response = true;
     }
 
     flush_received_buffers();
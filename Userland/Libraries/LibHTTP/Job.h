@@ -11,21 +11,28 @@
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Optional.h>
 #include <LibCore/NetworkJob.h>
+#include <LibHTTP/ContentDecoder.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 
 namespace HTTP {
 
-class Job : public Core::NetworkJob {
+class Job : public Core::NetworkJob
+    , public Http2Connection::StreamClient {
     C_OBJECT(Job);
 
 public:
     explicit Job(HttpRequest&&, Core::Stream::Stream&);
-    virtual ~Job() override = default;
+    virtual ~Job() override;
 
     virtual void start(Core::Stream::Socket&) override;
+    // Sends the request as a stream of an HTTP/2 connection, instead of over a socket of its own.
+    void start(Http2Connection&);
     virtual void shutdown(ShutdownMode) override;
 
+    bool is_using_http2() const { return m_http2_connection; }
+
     Core::Stream::Socket const* socket() const { return m_socket; }
     URL url() const { return m_request.url(); }
 
@@ -36,11 +43,17 @@ protected:
     void finish_up();
     void on_socket_connected();
     void flush_received_buffers();
+    // Decodes the data if needed and passes it on. Returns false if it couldn't be decoded, in which case the job fails.
+    bool did_receive_body_data(ByteBuffer);
     void register_on_ready_to_read(Function<void()>);
     ErrorOr<String> read_line(size_t);
     ErrorOr<ByteBuffer> receive(size_t);
     void timer_event(Core::TimerEvent&) override;
 
+    virtual void http2_did_receive_headers(Vector<HPACK::Header>, bool end_stream) override;
+    virtual void http2_did_receive_data(ReadonlyBytes, bool end_stream) override;
+    virtual void http2_did_fail(Core::NetworkJob::Error) override;
+
     enum class State {
         InStatus,
         InHeaders,
@@ -52,6 +65,7 @@ protected:
     HttpRequest m_request;
     State m_state { State::InStatus };
     Core::Stream::BufferedSocketBase* m_socket { nullptr };
+    RefPtr<Http2Connection> m_http2_connection;
     int m_code { -1 };
     HashMap<String, String, CaseInsensitiveStringTraits> m_headers;
     Vector<String> m_set_cookie_headers;
@@ -77,7 +91,7 @@ protected:
     Optional<u32> m_content_length;
     Optional<ssize_t> m_current_chunk_remaining_size;
     Optional<size_t> m_current_chunk_total_size;
-    bool m_can_stream_response { true };
+    OwnPtr<ContentDecoder> m_content_decoder;
     bool m_should_read_chunk_ending_line { false };
     bool m_has_scheduled_finish { false };
 };
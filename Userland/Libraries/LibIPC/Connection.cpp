@@ -12,6 +12,9 @@
 
 namespace IPC {
 
+// Once this much has been posted in one event loop turn, it's written out without waiting for the turn to end.
+static constexpr size_t outgoing_bytes_flush_threshold = 64 * KiB;
+
 ConnectionBase::ConnectionBase(IPC::Stub& local_stub, NonnullOwnPtr<Core::Stream::LocalSocket> socket, u32 local_endpoint_magic)
     : m_local_stub(local_stub)
     , m_socket(move(socket))
@@ -20,6 +23,12 @@ ConnectionBase::ConnectionBase(IPC::Stub& local_stub, NonnullOwnPtr<Core::Stream
     m_responsiveness_timer = Core::Timer::create_single_shot(3000, [this] { may_have_become_unresponsive(); });
 }
 
+ConnectionBase::~ConnectionBase()
+{
+    if (m_socket->is_open())
+        (void)write_outgoing_bytes();
+}
+
 ErrorOr<void> ConnectionBase::post_message(Message const& message)
 {
     return post_message(message.encode());
@@ -32,11 +41,9 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
     if (!m_socket->is_open())
         return Error::from_string_literal("Trying to post_message during IPC shutdown"sv);
 
-    // Prepend the message size.
-    uint32_t message_size = buffer.data.size();
-    TRY(buffer.data.try_prepend(reinterpret_cast<const u8*>(&message_size), sizeof(message_size)));
-
 #ifdef __serenity__
+    // NOTE: File descriptors travel separately from the bytes, and are picked up
+    //       in order while decoding. So it's fine to send them ahead of the message.
     for (auto& fd : buffer.fds) {
         if (auto result = m_socket->send_fd(fd.value()); result.is_error()) {
             dbgln("{}", result.error());
@@ -49,29 +56,65 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
         warnln("fd passing is not supported on this platform, sorry :(");
 #endif
 
-    ReadonlyBytes bytes_to_write { buffer.data.span() };
+    // Prepend the message size.
+    uint32_t message_size = buffer.data.size();
+    TRY(m_outgoing_bytes.try_append(reinterpret_cast<const u8*>(&message_size), sizeof(message_size)));
+    TRY(m_outgoing_bytes.try_append(buffer.data.data(), buffer.data.size()));
+
+    // Without an event loop nobody would ever flush, so just write the message out right away.
+    if (m_outgoing_bytes.size() >= outgoing_bytes_flush_threshold || !Core::EventLoop::has_been_instantiated())
+        return flush_outgoing_messages();
+
+    if (!m_flush_is_scheduled) {
+        m_flush_is_scheduled = true;
+        deferred_invoke([this] {
+            m_flush_is_scheduled = false;
+            if (auto result = flush_outgoing_messages(); result.is_error())
+                dbgln("IPC::ConnectionBase::post_message: {}", result.error());
+        });
+    }
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::write_outgoing_bytes()
+{
+    auto bytes = move(m_outgoing_bytes);
+
+    ReadonlyBytes bytes_to_write { bytes.span() };
     while (!bytes_to_write.is_empty()) {
-        auto maybe_nwritten = m_socket->write(bytes_to_write);
-        if (maybe_nwritten.is_error()) {
-            auto error = maybe_nwritten.release_error();
-            if (error.is_errno()) {
-                switch (error.code()) {
-                case EPIPE:
-                    shutdown();
-                    return Error::from_string_literal("IPC::Connection::post_message: Disconnected from peer"sv);
-                case EAGAIN:
-                    shutdown();
-                    return Error::from_string_literal("IPC::Connection::post_message: Peer buffer overflowed"sv);
-                default:
-                    shutdown();
-                    return Error::from_syscall("IPC::Connection::post_message write"sv, -error.code());
-                }
-            } else {
-                return error;
+        auto nwritten = TRY(m_socket->write(bytes_to_write));
+        bytes_to_write = bytes_to_write.slice(nwritten);
+    }
+    return {};
+}
+
+ErrorOr<void> ConnectionBase::flush_outgoing_messages()
+{
+    if (m_outgoing_bytes.is_empty())
+        return {};
+
+    if (!m_socket->is_open()) {
+        m_outgoing_bytes.clear();
+        return Error::from_string_literal("Trying to flush_outgoing_messages during IPC shutdown"sv);
+    }
+
+    if (auto result = write_outgoing_bytes(); result.is_error()) {
+        auto error = result.release_error();
+        if (error.is_errno()) {
+            switch (error.code()) {
+            case EPIPE:
+                shutdown();
+                return Error::from_string_literal("IPC::Connection::flush_outgoing_messages: Disconnected from peer"sv);
+            case EAGAIN:
+                shutdown();
+                return Error::from_string_literal("IPC::Connection::flush_outgoing_messages: Peer buffer overflowed"sv);
+            default:
+                shutdown();
+                return Error::from_syscall("IPC::Connection::flush_outgoing_messages write"sv, -error.code());
             }
+        } else {
+            return error;
         }
-
-        bytes_to_write = bytes_to_write.slice(maybe_nwritten.value());
     }
 
     m_responsiveness_timer->start();
@@ -80,21 +123,55 @@ ErrorOr<void> ConnectionBase::post_message(MessageBuffer buffer)
 
 void ConnectionBase::shutdown()
 {
+    // Give the peer whatever we still had queued up for it.
+    if (m_socket->is_open())
+        (void)write_outgoing_bytes();
+    m_outgoing_bytes.clear();
     m_socket->close();
     die();
 }
 
+void ConnectionBase::expect_reply(u32 endpoint_magic, int message_id, ReplyHandler handler)
+{
+    m_pending_replies.append({ endpoint_magic, message_id, move(handler) });
+}
+
+ConnectionBase::ReplyHandler ConnectionBase::take_pending_reply_handler(u32 endpoint_magic, int message_id)
+{
+    for (size_t i = 0; i < m_pending_replies.size(); ++i) {
+        auto& pending_reply = m_pending_replies[i];
+        if (pending_reply.endpoint_magic == endpoint_magic && pending_reply.message_id == message_id)
+            return m_pending_replies.take(i).handler;
+    }
+    return {};
+}
+
+size_t ConnectionBase::pending_reply_count(u32 endpoint_magic, int message_id) const
+{
+    size_t count = 0;
+    for (auto& pending_reply : m_pending_replies) {
+        if (pending_reply.endpoint_magic == endpoint_magic && pending_reply.message_id == message_id)
+            ++count;
+    }
+    return count;
+}
+
 void ConnectionBase::handle_messages()
 {
     auto messages = move(m_unprocessed_messages);
-    for (auto& message : messages) {
+    for (size_t i = 0; i < messages.size(); ++i) {
+        auto& message = messages[i];
         if (message.endpoint_magic() == m_local_endpoint_magic) {
             if (auto response = m_local_stub.handle(message)) {
                 if (auto result = post_message(*response); result.is_error()) {
                     dbgln("IPC::ConnectionBase::handle_messages: {}", result.error());
                 }
             }
+            continue;
         }
+
+        if (auto handler = take_pending_reply_handler(message.endpoint_magic(), message.message_id()))
+            handler(move(messages.ptr_at(i)));
     }
 }
 
@@ -179,15 +256,28 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
 
 OwnPtr<IPC::Message> ConnectionBase::wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id)
 {
+    // The peer can't answer a request that's still sitting in our outgoing buffer.
+    if (flush_outgoing_messages().is_error())
+        return {};
+
     for (;;) {
+        // The first few matching messages may be replies to requests that were posted
+        // with post_message_with_reply() before ours, so leave those alone.
+        auto replies_to_skip = pending_reply_count(endpoint_magic, message_id);
+
         // Double check we don't already have the event waiting for us.
         // Otherwise we might end up blocked for a while for no reason.
         for (size_t i = 0; i < m_unprocessed_messages.size(); ++i) {
             auto& message = m_unprocessed_messages[i];
             if (message.endpoint_magic() != endpoint_magic)
                 continue;
-            if (message.message_id() == message_id)
-                return m_unprocessed_messages.take(i);
+            if (message.message_id() != message_id)
+                continue;
+            if (replies_to_skip > 0) {
+                --replies_to_skip;
+                continue;
+            }
+            return m_unprocessed_messages.take(i);
         }
 
         if (!m_socket->is_open())
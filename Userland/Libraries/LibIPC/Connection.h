@@ -8,11 +8,13 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/Function.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/Try.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Notifier.h>
+#include <LibCore/Promise.h>
 #include <LibCore/Stream.h>
 #include <LibCore/Timer.h>
 #include <LibIPC/Forward.h>
@@ -31,11 +33,15 @@ class ConnectionBase : public Core::Object {
     C_OBJECT_ABSTRACT(ConnectionBase);
 
 public:
-    virtual ~ConnectionBase() override = default;
+    virtual ~ConnectionBase() override;
 
     bool is_open() const { return m_socket->is_open(); }
     ErrorOr<void> post_message(Message const&);
 
+    // Posted messages are collected and written out together once per event loop turn.
+    // This writes out everything that has been posted so far right away.
+    ErrorOr<void> flush_outgoing_messages();
+
     void shutdown();
     virtual void die() { }
 
@@ -56,6 +62,9 @@ protected:
     ErrorOr<void> post_message(MessageBuffer);
     void handle_messages();
 
+    using ReplyHandler = Function<void(NonnullOwnPtr<Message>)>;
+    void expect_reply(u32 endpoint_magic, int message_id, ReplyHandler);
+
     IPC::Stub& m_local_stub;
 
     NonnullOwnPtr<Core::Stream::LocalSocket> m_socket;
@@ -65,6 +74,22 @@ protected:
     ByteBuffer m_unprocessed_bytes;
 
     u32 m_local_endpoint_magic { 0 };
+
+private:
+    ErrorOr<void> write_outgoing_bytes();
+    ReplyHandler take_pending_reply_handler(u32 endpoint_magic, int message_id);
+    size_t pending_reply_count(u32 endpoint_magic, int message_id) const;
+
+    Vector<u8> m_outgoing_bytes;
+    bool m_flush_is_scheduled { false };
+
+    struct PendingReply {
+        u32 endpoint_magic { 0 };
+        int message_id { 0 };
+        ReplyHandler handler;
+    };
+    // Replies arrive in the order their requests were sent, so these are kept in that order as well.
+    Vector<PendingReply> m_pending_replies;
 };
 
 template<typename LocalEndpoint, typename PeerEndpoint>
@@ -104,6 +129,21 @@ public:
         return wait_for_specific_endpoint_message<typename RequestType::ResponseType, PeerEndpoint>();
     }
 
+    // Sends the request without waiting for the response. The promise is resolved with it once it arrives,
+    // or never, if the connection goes away first.
+    template<typename RequestType, typename... Args>
+    NonnullRefPtr<Core::Promise<NonnullOwnPtr<typename RequestType::ResponseType>>> post_message_with_reply(Args&&... args)
+    {
+        using ResponseType = typename RequestType::ResponseType;
+        auto promise = Core::Promise<NonnullOwnPtr<ResponseType>>::construct();
+        if (post_message(RequestType(forward<Args>(args)...)).is_error())
+            return promise;
+        expect_reply(PeerEndpoint::static_magic(), ResponseType::static_message_id(), [promise](NonnullOwnPtr<Message> message) mutable {
+            promise->resolve(message.template release_nonnull<ResponseType>());
+        });
+        return promise;
+    }
+
 protected:
     template<typename MessageType, typename Endpoint>
     OwnPtr<MessageType> wait_for_specific_endpoint_message()
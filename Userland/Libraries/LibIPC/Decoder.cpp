@@ -87,11 +87,25 @@ ErrorOr<void> Decoder::decode(double& value)
     return m_stream.try_handle_any_error();
 }
 
+static ErrorOr<Core::AnonymousBuffer> decode_shared_payload(Decoder& decoder)
+{
+    Core::AnonymousBuffer buffer;
+    TRY(decode(decoder, buffer));
+    if (!buffer.is_valid() || buffer.size() < shared_payload_threshold)
+        return Error::from_string_literal("IPC: Invalid shared payload"sv);
+    return buffer;
+}
+
 ErrorOr<void> Decoder::decode(String& value)
 {
     i32 length;
     TRY(decode(length));
 
+    if (length == shared_payload_length_marker) {
+        auto buffer = TRY(decode_shared_payload(*this));
+        value = String(ReadonlyBytes { buffer.data<u8>(), buffer.size() });
+        return {};
+    }
     if (length < 0) {
         value = {};
         return {};
@@ -112,6 +126,11 @@ ErrorOr<void> Decoder::decode(ByteBuffer& value)
     i32 length;
     TRY(decode(length));
 
+    if (length == shared_payload_length_marker) {
+        auto buffer = TRY(decode_shared_payload(*this));
+        value = TRY(ByteBuffer::copy(buffer.data<u8>(), buffer.size()));
+        return {};
+    }
     if (length < 0) {
         value = {};
         return {};
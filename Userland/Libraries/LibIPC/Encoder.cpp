@@ -143,16 +143,39 @@ Encoder& Encoder::operator<<(StringView value)
     return *this;
 }
 
+static bool encode_as_shared_payload([[maybe_unused]] Encoder& encoder, [[maybe_unused]] ReadonlyBytes bytes)
+{
+#ifndef __serenity__
+    // NOTE: File descriptors can't be passed over the socket on other platforms.
+    return false;
+#else
+    if (bytes.size() < shared_payload_threshold)
+        return false;
+    // NOTE: If we can't get a buffer, the payload is simply sent inline.
+    auto buffer_or_error = Core::AnonymousBuffer::create_with_size(bytes.size());
+    if (buffer_or_error.is_error())
+        return false;
+    auto buffer = buffer_or_error.release_value();
+    memcpy(buffer.data<void>(), bytes.data(), bytes.size());
+    encoder << shared_payload_length_marker << buffer;
+    return true;
+#endif
+}
+
 Encoder& Encoder::operator<<(String const& value)
 {
     if (value.is_null())
         return *this << (i32)-1;
+    if (encode_as_shared_payload(*this, value.bytes()))
+        return *this;
     *this << static_cast<i32>(value.length());
     return *this << value.view();
 }
 
 Encoder& Encoder::operator<<(ByteBuffer const& value)
 {
+    if (encode_as_shared_payload(*this, value.bytes()))
+        return *this;
     *this << static_cast<i32>(value.size());
     m_buffer.data.append(value.data(), value.size());
     return *this;
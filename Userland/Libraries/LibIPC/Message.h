@@ -33,6 +33,13 @@ private:
     int m_fd;
 };
 
+// Strings and ByteBuffers at least this big are handed over in a transient AnonymousBuffer, so that their contents
+// don't have to grow the message buffer and be pushed through the socket in both directions.
+constexpr size_t shared_payload_threshold = 64 * KiB;
+
+// Sent in place of the length of a String or ByteBuffer whose contents follow in an AnonymousBuffer.
+constexpr i32 shared_payload_length_marker = -2;
+
 struct MessageBuffer {
     Vector<u8, 1024> data;
     NonnullRefPtrVector<AutoCloseFileDescriptor, 1> fds;
@@ -16,15 +16,16 @@ Client::Client(NonnullOwnPtr<Core::Stream::LocalSocket> socket)
 
 void Client::die()
 {
+    auto pending_decodes = move(m_pending_decodes);
+    for (auto& it : pending_decodes)
+        it.value({});
+
     if (on_death)
         on_death();
 }
 
-Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data)
+static Optional<Core::AnonymousBuffer> copy_to_anonymous_buffer(ReadonlyBytes encoded_data)
 {
-    if (encoded_data.is_empty())
-        return {};
-
     auto encoded_buffer_or_error = Core::AnonymousBuffer::create_with_size(encoded_data.size());
     if (encoded_buffer_or_error.is_error()) {
         dbgln("Could not allocate encoded buffer");
@@ -33,7 +34,36 @@ Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data)
     auto encoded_buffer = encoded_buffer_or_error.release_value();
 
     memcpy(encoded_buffer.data<void>(), encoded_data.data(), encoded_data.size());
-    auto response_or_error = try_decode_image(move(encoded_buffer));
+    return encoded_buffer;
+}
+
+static Optional<DecodedImage> make_decoded_image(bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations)
+{
+    if (bitmaps.is_empty())
+        return {};
+
+    DecodedImage image;
+    image.is_animated = is_animated;
+    image.loop_count = loop_count;
+    image.frames.resize(bitmaps.size());
+    for (size_t i = 0; i < image.frames.size(); ++i) {
+        auto& frame = image.frames[i];
+        frame.bitmap = bitmaps[i].bitmap();
+        frame.duration = durations[i];
+    }
+    return image;
+}
+
+Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size)
+{
+    if (encoded_data.is_empty())
+        return {};
+
+    auto encoded_buffer = copy_to_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value())
+        return {};
+
+    auto response_or_error = try_decode_image(encoded_buffer.release_value(), ideal_size);
 
     if (response_or_error.is_error()) {
         dbgln("ImageDecoder died heroically");
@@ -41,20 +71,38 @@ Optional<DecodedImage> Client::decode_image(ReadonlyBytes encoded_data)
     }
 
     auto& response = response_or_error.value();
+    return make_decoded_image(response.is_animated(), response.loop_count(), response.bitmaps(), response.durations());
+}
 
-    if (response.bitmaps().is_empty())
-        return {};
+void Client::decode_image_async(ReadonlyBytes encoded_data, Function<void(Optional<DecodedImage>)> on_decoded, Optional<Gfx::IntSize> ideal_size)
+{
+    if (encoded_data.is_empty()) {
+        on_decoded({});
+        return;
+    }
 
-    DecodedImage image;
-    image.is_animated = response.is_animated();
-    image.loop_count = response.loop_count();
-    image.frames.resize(response.bitmaps().size());
-    for (size_t i = 0; i < image.frames.size(); ++i) {
-        auto& frame = image.frames[i];
-        frame.bitmap = response.bitmaps()[i].bitmap();
-        frame.duration = response.durations()[i];
+    auto encoded_buffer = copy_to_anonymous_buffer(encoded_data);
+    if (!encoded_buffer.has_value()) {
+        on_decoded({});
+        return;
     }
-    return image;
+
+    auto request_id = m_next_request_id++;
+    m_pending_decodes.set(request_id, move(on_decoded));
+    async_start_decoding_image(request_id, encoded_buffer.release_value(), ideal_size);
+}
+
+void Client::did_decode_image(i32 request_id, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations)
+{
+    auto it = m_pending_decodes.find(request_id);
+    if (it == m_pending_decodes.end()) {
+        dbgln("ImageDecoder sent an image for unknown request {}", request_id);
+        return;
+    }
+
+    auto on_decoded = move(it->value);
+    m_pending_decodes.remove(it);
+    on_decoded(make_decoded_image(is_animated, loop_count, bitmaps, durations));
 }
 
 }
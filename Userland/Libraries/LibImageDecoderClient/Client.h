@@ -30,7 +30,12 @@ class Client final
     IPC_CLIENT_CONNECTION(Client, "/tmp/portal/image");
 
 public:
-    Optional<DecodedImage> decode_image(ReadonlyBytes);
+    // Frames bigger than the ideal size are scaled down to fit into it.
+    Optional<DecodedImage> decode_image(ReadonlyBytes, Optional<Gfx::IntSize> ideal_size = {});
+
+    // Decodes the image without waiting for it, so that many images can be decoded at once.
+    // The callback is invoked on this thread, with an empty Optional if decoding failed.
+    void decode_image_async(ReadonlyBytes, Function<void(Optional<DecodedImage>)> on_decoded, Optional<Gfx::IntSize> ideal_size = {});
 
     Function<void()> on_death;
 
@@ -38,6 +43,11 @@ private:
     Client(NonnullOwnPtr<Core::Stream::LocalSocket>);
 
     virtual void die() override;
+
+    virtual void did_decode_image(i32 request_id, bool is_animated, u32 loop_count, Vector<Gfx::ShareableBitmap> const& bitmaps, Vector<u32> const& durations) override;
+
+    i32 m_next_request_id { 0 };
+    HashMap<i32, Function<void(Optional<DecodedImage>)>> m_pending_decodes;
 };
 
 }
@@ -15,6 +15,7 @@
 #include <AK/TemporaryChange.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Heap/MarkedVector.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/AbstractOperations.h>
@@ -61,6 +62,21 @@ private:
     ExecutingASTNodeChain m_chain_node;
 };
 
+ASTNode::ASTNode(SourceRange source_range)
+    : m_source_range(source_range)
+{
+}
+
+ASTNode::~ASTNode()
+{
+}
+
+void ASTNode::set_bytecode_executable(NonnullOwnPtr<Bytecode::Executable> executable) const
+{
+    VERIFY(!m_bytecode_executable);
+    m_bytecode_executable = move(executable);
+}
+
 String ASTNode::class_name() const
 {
     // NOTE: We strip the "JS::" prefix.
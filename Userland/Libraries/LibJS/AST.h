@@ -25,6 +25,7 @@
 #include <LibJS/Runtime/PropertyKey.h>
 #include <LibJS/Runtime/Reference.h>
 #include <LibJS/Runtime/Value.h>
+#include <LibJS/SourceCode.h>
 #include <LibJS/SourceRange.h>
 #include <LibRegex/Regex.h>
 
@@ -46,7 +47,7 @@ create_ast_node(SourceRange range, Args&&... args)
 
 class ASTNode : public RefCounted<ASTNode> {
 public:
-    virtual ~ASTNode() { }
+    virtual ~ASTNode();
     virtual Completion execute(Interpreter&, GlobalObject&) const = 0;
     virtual Bytecode::CodeGenerationErrorOr<void> generate_bytecode(Bytecode::Generator&) const;
     virtual void dump(int indent) const;
@@ -56,6 +57,11 @@ public:
 
     String class_name() const;
 
+    // NOTE: Function bodies (and default parameter values) are compiled to bytecode only once,
+    //       no matter how many function objects get created from them.
+    Bytecode::Executable* bytecode_executable() const { return m_bytecode_executable; }
+    void set_bytecode_executable(NonnullOwnPtr<Bytecode::Executable>) const;
+
     template<typename T>
     bool fast_is() const = delete;
 
@@ -83,13 +89,11 @@ public:
     virtual bool is_class_method() const { return false; }
 
 protected:
-    explicit ASTNode(SourceRange source_range)
-        : m_source_range(source_range)
-    {
-    }
+    explicit ASTNode(SourceRange);
 
 private:
     SourceRange m_source_range;
+    mutable OwnPtr<Bytecode::Executable> m_bytecode_executable;
 };
 
 class Statement : public ASTNode {
@@ -604,7 +608,7 @@ public:
     };
 
     FlyString const& name() const { return m_name; }
-    String const& source_text() const { return m_source_text; }
+    SourceText const& source_text() const { return m_source_text; }
     Statement const& body() const { return *m_body; }
     Vector<Parameter> const& parameters() const { return m_parameters; };
     i32 function_length() const { return m_function_length; }
@@ -615,7 +619,7 @@ public:
     FunctionKind kind() const { return m_kind; }
 
 protected:
-    FunctionNode(FlyString name, String source_text, NonnullRefPtr<Statement> body, Vector<Parameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function)
+    FunctionNode(FlyString name, SourceText source_text, NonnullRefPtr<Statement> body, Vector<Parameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function)
         : m_name(move(name))
         , m_source_text(move(source_text))
         , m_body(move(body))
@@ -635,7 +639,7 @@ protected:
 
 private:
     FlyString m_name;
-    String m_source_text;
+    SourceText m_source_text;
     NonnullRefPtr<Statement> m_body;
     Vector<Parameter> const m_parameters;
     const i32 m_function_length;
@@ -652,7 +656,7 @@ class FunctionDeclaration final
 public:
     static bool must_have_name() { return true; }
 
-    FunctionDeclaration(SourceRange source_range, FlyString const& name, String source_text, NonnullRefPtr<Statement> body, Vector<Parameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval)
+    FunctionDeclaration(SourceRange source_range, FlyString const& name, SourceText source_text, NonnullRefPtr<Statement> body, Vector<Parameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval)
         : Declaration(source_range)
         , FunctionNode(name, move(source_text), move(body), move(parameters), function_length, kind, is_strict_mode, might_need_arguments_object, contains_direct_call_to_eval, false)
     {
@@ -678,7 +682,7 @@ class FunctionExpression final
 public:
     static bool must_have_name() { return false; }
 
-    FunctionExpression(SourceRange source_range, FlyString const& name, String source_text, NonnullRefPtr<Statement> body, Vector<Parameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function = false)
+    FunctionExpression(SourceRange source_range, FlyString const& name, SourceText source_text, NonnullRefPtr<Statement> body, Vector<Parameter> parameters, i32 function_length, FunctionKind kind, bool is_strict_mode, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function = false)
         : Expression(source_range)
         , FunctionNode(name, move(source_text), move(body), move(parameters), function_length, kind, is_strict_mode, might_need_arguments_object, contains_direct_call_to_eval, is_arrow_function)
     {
@@ -1354,7 +1358,7 @@ public:
 
 class ClassExpression final : public Expression {
 public:
-    ClassExpression(SourceRange source_range, String name, String source_text, RefPtr<FunctionExpression> constructor, RefPtr<Expression> super_class, NonnullRefPtrVector<ClassElement> elements)
+    ClassExpression(SourceRange source_range, String name, SourceText source_text, RefPtr<FunctionExpression> constructor, RefPtr<Expression> super_class, NonnullRefPtrVector<ClassElement> elements)
         : Expression(source_range)
         , m_name(move(name))
         , m_source_text(move(source_text))
@@ -1365,7 +1369,7 @@ public:
     }
 
     StringView name() const { return m_name; }
-    String const& source_text() const { return m_source_text; }
+    SourceText const& source_text() const { return m_source_text; }
     RefPtr<FunctionExpression> constructor() const { return m_constructor; }
 
     virtual Completion execute(Interpreter&, GlobalObject&) const override;
@@ -1380,7 +1384,7 @@ private:
     virtual bool is_class_expression() const override { return true; }
 
     String m_name;
-    String m_source_text;
+    SourceText m_source_text;
     RefPtr<FunctionExpression> m_constructor;
     RefPtr<Expression> m_super_class;
     NonnullRefPtrVector<ClassElement> m_elements;
@@ -0,0 +1,13 @@
+// Chains of Array.prototype builtins with callbacks.
+const input = Array.from({ length: 20000 }, (_, i) => i);
+
+let total = 0;
+for (let round = 0; round < 5; ++round) {
+    total += input
+        .map(x => x * 3)
+        .filter(x => x % 2 === 0)
+        .reduce((accumulator, x) => accumulator + x, 0);
+}
+
+if (input.indexOf(19999) !== 19999 || !input.includes(1234)) throw new Error("Unexpected result");
+if (total !== 1499850000) throw new Error("Unexpected result");
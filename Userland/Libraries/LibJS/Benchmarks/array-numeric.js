@@ -0,0 +1,12 @@
+// Fill, read back and sort a numeric array.
+const values = [];
+for (let i = 0; i < 50000; ++i) values.push((i * 7919) % 10007);
+
+let sum = 0;
+for (let i = 0; i < values.length; ++i) sum += values[i];
+
+for (let i = 0; i < values.length; ++i) values[i] = values[i] * 2;
+
+values.sort((a, b) => a - b);
+
+if (sum !== 250160470 || values[0] !== 0) throw new Error("Unexpected result");
@@ -0,0 +1,14 @@
+// Recursive and closure-heavy function calls.
+function fibonacci(n) {
+    return n < 2 ? n : fibonacci(n - 1) + fibonacci(n - 2);
+}
+
+function makeCounter() {
+    let count = 0;
+    return () => ++count;
+}
+
+const counter = makeCounter();
+for (let i = 0; i < 100000; ++i) counter();
+
+if (fibonacci(22) !== 17711 || counter() !== 100001) throw new Error("Unexpected result");
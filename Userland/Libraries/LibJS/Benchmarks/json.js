@@ -0,0 +1,8 @@
+// Round-tripping a nested structure through JSON.
+const data = [];
+for (let i = 0; i < 2000; ++i) data.push({ id: i, name: "entry " + i, tags: ["a", "b", "c"], nested: { value: i / 2, flag: i % 2 === 0 } });
+
+let text;
+for (let i = 0; i < 5; ++i) text = JSON.stringify(JSON.parse(JSON.stringify(data)));
+
+if (JSON.parse(text).length !== 2000) throw new Error("Unexpected result");
@@ -0,0 +1,20 @@
+// Insertion, lookup and deletion in Map and Set.
+const map = new Map();
+const set = new Set();
+for (let i = 0; i < 5000; ++i) {
+    map.set("key" + i, i);
+    set.add(i);
+}
+
+let hits = 0;
+for (let i = 0; i < 10000; ++i) {
+    if (map.has("key" + i)) ++hits;
+    if (set.has(i)) ++hits;
+}
+
+for (let i = 0; i < 5000; i += 2) {
+    map.delete("key" + i);
+    set.delete(i);
+}
+
+if (hits !== 10000 || map.size !== 2500 || set.size !== 2500) throw new Error("Unexpected result");
@@ -0,0 +1,23 @@
+// Property reads and writes on objects of the same shape, plus dictionary-style objects.
+class Point {
+    constructor(x, y) {
+        this.x = x;
+        this.y = y;
+    }
+}
+
+let sum = 0;
+const points = [];
+for (let i = 0; i < 20000; ++i) points.push(new Point(i, -i));
+for (let i = 0; i < points.length; ++i) {
+    const point = points[i];
+    point.x += 1;
+    sum += point.x + point.y;
+}
+
+const dictionary = {};
+for (let i = 0; i < 10000; ++i) dictionary["key" + i] = i;
+const keys = Object.keys(dictionary);
+for (let i = 0; i < keys.length; ++i) sum += dictionary[keys[i]];
+
+if (sum !== 49995000 + 20000) throw new Error("Unexpected result");
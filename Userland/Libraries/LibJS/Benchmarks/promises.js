@@ -0,0 +1,13 @@
+// Long promise chains and async functions.
+let result = 0;
+
+let chain = Promise.resolve(0);
+for (let i = 0; i < 5000; ++i) chain = chain.then(value => value + 1);
+chain.then(value => (result += value));
+
+async function sum(n) {
+    let total = 0;
+    for (let i = 0; i < n; ++i) total += await i;
+    return total;
+}
+sum(5000).then(value => (result += value));
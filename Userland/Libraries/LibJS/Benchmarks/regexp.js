@@ -0,0 +1,11 @@
+// Matching and replacing with regular expressions.
+const line = "2022-03-14 12:34:56 [info] user=anon action=login status=ok duration=42ms";
+const pattern = /(\d{4})-(\d{2})-(\d{2}) (\d{2}):(\d{2}):(\d{2}) \[(\w+)\] (.*)/;
+
+let matches = 0;
+for (let i = 0; i < 3000; ++i) {
+    if (pattern.exec(line)) ++matches;
+    line.replace(/=(\w+)/g, ": $1");
+}
+
+if (matches !== 3000) throw new Error("Unexpected result");
@@ -0,0 +1,11 @@
+// Building strings by concatenation, then taking them apart again.
+let string = "";
+for (let i = 0; i < 20000; ++i) string += "item " + i + ",";
+
+const parts = string.split(",");
+const joined = parts.join(";");
+
+let length = 0;
+for (let i = 0; i < 5000; ++i) length += `${i}:${i * 2}`.length;
+
+if (parts.length !== 20001 || joined.length !== string.length || length <= 0) throw new Error("Unexpected result");
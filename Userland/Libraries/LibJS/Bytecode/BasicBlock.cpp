@@ -64,4 +64,63 @@ void BasicBlock::grow(size_t additional_size)
     VERIFY(m_buffer_size <= m_buffer_capacity);
 }
 
+template<typename OpType>
+static ThrowCompletionOr<void> execute_instruction(Instruction const& instruction, Interpreter& interpreter)
+{
+    return static_cast<OpType const&>(instruction).execute_impl(interpreter);
+}
+
+Vector<ThreadedInstruction> const* BasicBlock::threaded_code() const
+{
+    if (m_threaded_code)
+        return m_threaded_code.ptr();
+    if (++m_entry_count < threaded_code_threshold)
+        return nullptr;
+
+    auto threaded_code = make<Vector<ThreadedInstruction>>();
+    InstructionStreamIterator it(instruction_stream());
+    while (!it.at_end()) {
+        auto& instruction = *it;
+        ++it;
+
+#define __BYTECODE_OP(op)                                                     \
+    case Instruction::Type::op:                                               \
+        threaded_code->append({ execute_instruction<Op::op>, &instruction }); \
+        break;
+
+        switch (instruction.type()) {
+            ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+        default:
+            VERIFY_NOT_REACHED();
+        }
+
+#undef __BYTECODE_OP
+    }
+
+    m_threaded_code = move(threaded_code);
+    return m_threaded_code.ptr();
+}
+
+void BasicBlock::remove_instructions_if(Function<bool(Instruction const&)> const& predicate)
+{
+    VERIFY(!m_threaded_code);
+
+    size_t read_offset = 0;
+    size_t write_offset = 0;
+    while (read_offset < m_buffer_size) {
+        auto& instruction = *reinterpret_cast<Instruction*>(m_buffer + read_offset);
+        auto length = instruction.length();
+        if (predicate(instruction)) {
+            Instruction::destroy(instruction);
+        } else {
+            // NOTE: Instructions are moved around bytewise here, just like MergeBlocks does when it concatenates blocks.
+            if (write_offset != read_offset)
+                __builtin_memmove(m_buffer + write_offset, m_buffer + read_offset, length);
+            write_offset += length;
+        }
+        read_offset += length;
+    }
+    m_buffer_size = write_offset;
+}
+
 }
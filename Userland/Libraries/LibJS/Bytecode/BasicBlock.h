@@ -7,9 +7,12 @@
 #pragma once
 
 #include <AK/Badge.h>
+#include <AK/Function.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Runtime/Completion.h>
 
 namespace JS::Bytecode {
 
@@ -19,10 +22,20 @@ struct UnwindInfo {
     BasicBlock const* finalizer;
 };
 
+// A block's instructions with the dispatch on their type already resolved, so that running them is just a
+// sequence of direct calls to each instruction's handler.
+struct ThreadedInstruction {
+    ThrowCompletionOr<void> (*execute)(Instruction const&, Interpreter&);
+    Instruction const* instruction;
+};
+
 class BasicBlock {
     AK_MAKE_NONCOPYABLE(BasicBlock);
 
 public:
+    // How often a block has to be entered before it's translated to threaded code.
+    static constexpr u32 threaded_code_threshold = 16;
+
     static NonnullOwnPtr<BasicBlock> create(String name, size_t size = 4 * KiB);
     ~BasicBlock();
 
@@ -36,11 +49,18 @@ public:
     bool can_grow(size_t additional_size) const { return m_buffer_size + additional_size <= m_buffer_capacity; }
     void grow(size_t additional_size);
 
+    // Destroys the instructions the predicate returns true for, and closes the gaps they leave behind.
+    void remove_instructions_if(Function<bool(Instruction const&)> const& predicate);
+
     void terminate(Badge<Generator>) { m_is_terminated = true; }
     bool is_terminated() const { return m_is_terminated; }
 
     String const& name() const { return m_name; }
 
+    // Returns the threaded code for this block once it counts as hot, and null until then.
+    // NOTE: This must only be used once the block won't change anymore, i.e. after all optimization passes ran.
+    Vector<ThreadedInstruction> const* threaded_code() const;
+
 private:
     BasicBlock(String name, size_t size);
 
@@ -49,6 +69,9 @@ private:
     size_t m_buffer_size { 0 };
     bool m_is_terminated { false };
     String m_name;
+
+    mutable u32 m_entry_count { 0 };
+    mutable OwnPtr<Vector<ThreadedInstruction>> m_threaded_code;
 };
 
 }
@@ -84,6 +84,16 @@
 
 namespace JS::Bytecode {
 
+enum class RegisterAccess {
+    Read,
+    Write,
+    ReadWrite,
+    // The register is one end of an inclusive range of registers that are all read.
+    ReadRange,
+};
+
+using RegisterVisitor = Function<void(Register&, RegisterAccess)>;
+
 class Instruction {
 public:
     constexpr static bool IsTerminator = false;
@@ -101,6 +111,8 @@ public:
     String to_string(Bytecode::Executable const&) const;
     ThrowCompletionOr<void> execute(Bytecode::Interpreter&) const;
     void replace_references(BasicBlock const&, BasicBlock const&);
+    // Calls the visitor for every register operand, apart from the implicitly used accumulator.
+    void visit_registers(RegisterVisitor const&);
     static void destroy(Instruction&);
 
 protected:
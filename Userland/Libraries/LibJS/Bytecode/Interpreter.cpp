@@ -19,6 +19,7 @@ namespace JS::Bytecode {
 
 static Interpreter* s_current;
 bool g_dump_bytecode = false;
+bool g_use_threaded_code = false;
 
 Interpreter* Interpreter::current()
 {
@@ -74,60 +75,85 @@ Interpreter::ValueAndFrame Interpreter::run_and_return_frame(Executable const& e
     registers()[Register::global_object_index] = Value(&global_object());
     m_manually_entered_frames.append(false);
 
+    // Returns true if the current unwind context has a handler or finalizer we can continue in.
+    auto handle_exception = [&](Value exception_value) {
+        m_saved_exception = make_handle(exception_value);
+        if (m_unwind_contexts.is_empty())
+            return false;
+        auto& unwind_context = m_unwind_contexts.last();
+        if (unwind_context.executable != m_current_executable)
+            return false;
+        if (unwind_context.handler) {
+            block = unwind_context.handler;
+            unwind_context.handler = nullptr;
+
+            // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
+            if (!unwind_context.finalizer)
+                m_unwind_contexts.take_last();
+
+            accumulator() = exception_value;
+            m_saved_exception = {};
+            return true;
+        }
+        if (unwind_context.finalizer) {
+            block = unwind_context.finalizer;
+            m_unwind_contexts.take_last();
+            return true;
+        }
+        // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
+        // If you run into this, you probably forgot to remove the current unwind_context somewhere.
+        VERIFY_NOT_REACHED();
+    };
+
     for (;;) {
-        Bytecode::InstructionStreamIterator pc(block->instruction_stream());
         bool will_jump = false;
         bool will_return = false;
-        while (!pc.at_end()) {
-            auto& instruction = *pc;
-            auto ran_or_error = instruction.execute(*this);
-            if (ran_or_error.is_error()) {
-                auto exception_value = *ran_or_error.throw_completion().value();
-                m_saved_exception = make_handle(exception_value);
-                if (m_unwind_contexts.is_empty())
+        if (auto const* threaded_code = g_use_threaded_code ? block->threaded_code() : nullptr) {
+            bool did_throw = false;
+            for (auto const& entry : *threaded_code) {
+                auto ran_or_error = entry.execute(*entry.instruction, *this);
+                if (ran_or_error.is_error()) {
+                    will_jump = handle_exception(*ran_or_error.throw_completion().value());
+                    did_throw = true;
                     break;
-                auto& unwind_context = m_unwind_contexts.last();
-                if (unwind_context.executable != m_current_executable)
-                    break;
-                if (unwind_context.handler) {
-                    block = unwind_context.handler;
-                    unwind_context.handler = nullptr;
-
-                    // If there's no finalizer, there's nowhere for the handler block to unwind to, so the unwind context is no longer needed.
-                    if (!unwind_context.finalizer)
-                        m_unwind_contexts.take_last();
-
-                    accumulator() = exception_value;
-                    m_saved_exception = {};
+                }
+            }
+            // NOTE: Only terminators jump or return, and those always come last, so there's no need to check after every instruction.
+            if (!did_throw) {
+                if (m_pending_jump.has_value()) {
+                    block = m_pending_jump.release_value();
                     will_jump = true;
+                } else if (!m_return_value.is_empty()) {
+                    will_return = true;
+                }
+            }
+        } else {
+            Bytecode::InstructionStreamIterator pc(block->instruction_stream());
+            while (!pc.at_end()) {
+                auto& instruction = *pc;
+                auto ran_or_error = instruction.execute(*this);
+                if (ran_or_error.is_error()) {
+                    will_jump = handle_exception(*ran_or_error.throw_completion().value());
                     break;
                 }
-                if (unwind_context.finalizer) {
-                    block = unwind_context.finalizer;
-                    m_unwind_contexts.take_last();
+                if (m_pending_jump.has_value()) {
+                    block = m_pending_jump.release_value();
                     will_jump = true;
                     break;
                 }
-                // An unwind context with no handler or finalizer? We have nowhere to jump, and continuing on will make us crash on the next `Call` to a non-native function if there's an exception! So let's crash here instead.
-                // If you run into this, you probably forgot to remove the current unwind_context somewhere.
-                VERIFY_NOT_REACHED();
-            }
-            if (m_pending_jump.has_value()) {
-                block = m_pending_jump.release_value();
-                will_jump = true;
-                break;
-            }
-            if (!m_return_value.is_empty()) {
-                will_return = true;
-                break;
+                if (!m_return_value.is_empty()) {
+                    will_return = true;
+                    break;
+                }
+                ++pc;
             }
-            ++pc;
         }
 
         if (will_return)
             break;
 
-        if (pc.at_end() && !will_jump)
+        // NOTE: Without a jump we either ran off the end of the block or hit an exception that nobody handles.
+        if (!will_jump)
             break;
 
         if (!m_saved_exception.is_null())
@@ -233,6 +259,8 @@ Bytecode::PassManager& Interpreter::optimization_pipeline(Interpreter::Optimizat
         pm->add<Passes::MergeBlocks>();
         pm->add<Passes::GenerateCFG>();
         pm->add<Passes::PlaceBlocks>();
+        pm->add<Passes::EliminateDeadStores>();
+        pm->add<Passes::AllocateRegisters>();
     } else {
         VERIFY_NOT_REACHED();
     }
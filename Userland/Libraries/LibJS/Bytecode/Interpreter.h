@@ -9,6 +9,7 @@
 #include "Generator.h"
 #include "PassManager.h"
 #include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Cell.h>
@@ -88,6 +89,9 @@ public:
 
     VM::InterpreterExecutionScope ast_interpreter_scope();
 
+    // Totals across all GetById and PutById instructions executed by this interpreter.
+    PropertyLookupCacheStatistics& property_lookup_cache_statistics() { return m_property_lookup_cache_statistics; }
+
 private:
     MarkedVector<Value>& registers() { return m_register_windows.last().registers; }
 
@@ -104,8 +108,10 @@ private:
     Vector<UnwindInfo> m_unwind_contexts;
     Handle<Value> m_saved_exception;
     OwnPtr<JS::Interpreter> m_ast_interpreter;
+    PropertyLookupCacheStatistics m_property_lookup_cache_statistics;
 };
 
 extern bool g_dump_bytecode;
+extern bool g_use_threaded_code;
 
 }
@@ -334,14 +334,33 @@ ThrowCompletionOr<void> SetVariable::execute_impl(Bytecode::Interpreter& interpr
 ThrowCompletionOr<void> GetById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto* object = TRY(interpreter.accumulator().to_object(interpreter.global_object()));
-    interpreter.accumulator() = TRY(object->get(interpreter.current_executable().get_identifier(m_property)));
+    auto& statistics = interpreter.property_lookup_cache_statistics();
+    if (auto value = m_cache.get(*object); value.has_value()) {
+        ++statistics.hit_count;
+        interpreter.accumulator() = *value;
+        return {};
+    }
+    ++statistics.miss_count;
+
+    auto const& property_name = interpreter.current_executable().get_identifier(m_property);
+    interpreter.accumulator() = TRY(object->get(property_name));
+    m_cache.update_after_get(*object, property_name);
     return {};
 }
 
 ThrowCompletionOr<void> PutById::execute_impl(Bytecode::Interpreter& interpreter) const
 {
     auto* object = TRY(interpreter.reg(m_base).to_object(interpreter.global_object()));
-    TRY(object->set(interpreter.current_executable().get_identifier(m_property), interpreter.accumulator(), Object::ShouldThrowExceptions::Yes));
+    auto& statistics = interpreter.property_lookup_cache_statistics();
+    if (m_cache.put(*object, interpreter.accumulator())) {
+        ++statistics.hit_count;
+        return {};
+    }
+    ++statistics.miss_count;
+
+    auto const& property_name = interpreter.current_executable().get_identifier(m_property);
+    TRY(object->set(property_name, interpreter.accumulator(), Object::ShouldThrowExceptions::Yes));
+    m_cache.update_after_put(*object, property_name);
     return {};
 }
 
@@ -720,14 +739,22 @@ String SetVariable::to_string_impl(Bytecode::Executable const& executable) const
     return String::formatted("SetVariable env:{} init:{} {} ({})", mode_string, initialization_mode_name, m_identifier, executable.identifier_table->get(m_identifier));
 }
 
+static String format_property_lookup_cache_statistics(PropertyLookupCache const& cache)
+{
+    auto const& statistics = cache.statistics();
+    if (statistics.hit_count == 0 && statistics.miss_count == 0)
+        return {};
+    return String::formatted(", cache hits:{}, misses:{}", statistics.hit_count, statistics.miss_count);
+}
+
 String PutById::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("PutById base:{}, property:{} ({})", m_base, m_property, executable.identifier_table->get(m_property));
+    return String::formatted("PutById base:{}, property:{} ({}){}", m_base, m_property, executable.identifier_table->get(m_property), format_property_lookup_cache_statistics(m_cache));
 }
 
 String GetById::to_string_impl(Bytecode::Executable const& executable) const
 {
-    return String::formatted("GetById {} ({})", m_property, executable.identifier_table->get(m_property));
+    return String::formatted("GetById {} ({}){}", m_property, executable.identifier_table->get(m_property), format_property_lookup_cache_statistics(m_cache));
 }
 
 String Jump::to_string_impl(Bytecode::Executable const&) const
@@ -12,6 +12,7 @@
 #include <LibJS/Bytecode/IdentifierTable.h>
 #include <LibJS/Bytecode/Instruction.h>
 #include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/PropertyLookupCache.h>
 #include <LibJS/Bytecode/Register.h>
 #include <LibJS/Bytecode/StringTable.h>
 #include <LibJS/Heap/Cell.h>
@@ -33,6 +34,10 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_src, RegisterAccess::Read);
+    }
 
 private:
     Register m_src;
@@ -49,6 +54,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     Value m_value;
@@ -65,6 +71,10 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_dst, RegisterAccess::Write);
+    }
 
 private:
     Register m_dst;
@@ -106,6 +116,10 @@ private:
         ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;    \
         String to_string_impl(Bytecode::Executable const&) const;              \
         void replace_references_impl(BasicBlock const&, BasicBlock const&) { } \
+        void visit_registers_impl(RegisterVisitor const& visitor)              \
+        {                                                                      \
+            visitor(m_lhs_reg, RegisterAccess::Read);                          \
+        }                                                                      \
                                                                                \
     private:                                                                   \
         Register m_lhs_reg;                                                    \
@@ -132,6 +146,7 @@ JS_ENUMERATE_COMMON_BINARY_OPS(JS_DECLARE_COMMON_BINARY_OP)
         ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;    \
         String to_string_impl(Bytecode::Executable const&) const;              \
         void replace_references_impl(BasicBlock const&, BasicBlock const&) { } \
+        void visit_registers_impl(RegisterVisitor const&) { }                  \
     };
 
 JS_ENUMERATE_COMMON_UNARY_OPS(JS_DECLARE_COMMON_UNARY_OP)
@@ -148,6 +163,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     StringTableIndex m_string;
@@ -163,6 +179,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class NewRegExp final : public Instruction {
@@ -177,6 +194,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     StringTableIndex m_source_index;
@@ -198,6 +216,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_from_object, RegisterAccess::Read);
+        for (size_t i = 0; i < m_excluded_names_count; ++i)
+            visitor(m_excluded_names[i], RegisterAccess::Read);
+    }
 
     size_t length_impl() const { return sizeof(*this) + sizeof(Register) * m_excluded_names_count; }
 
@@ -218,6 +242,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     Crypto::SignedBigInteger m_bigint;
@@ -243,6 +268,14 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        // NOTE: Only the ends of the (inclusive) range are stored, every register in between is read as well.
+        if (m_element_count != 0) {
+            visitor(m_elements[0], RegisterAccess::ReadRange);
+            visitor(m_elements[1], RegisterAccess::ReadRange);
+        }
+    }
 
     size_t length_impl() const
     {
@@ -264,6 +297,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class ConcatString final : public Instruction {
@@ -277,6 +311,10 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_lhs, RegisterAccess::ReadWrite);
+    }
 
 private:
     Register m_lhs;
@@ -298,6 +336,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     EnvironmentMode m_mode { EnvironmentMode::Lexical };
@@ -313,6 +352,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class CreateVariable final : public Instruction {
@@ -328,6 +368,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -353,6 +394,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -371,6 +413,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     IdentifierTableIndex m_identifier;
@@ -389,9 +432,12 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     IdentifierTableIndex m_property;
+
+    PropertyLookupCache mutable m_cache;
 };
 
 class PutById final : public Instruction {
@@ -406,10 +452,16 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_base, RegisterAccess::Read);
+    }
 
 private:
     Register m_base;
     IdentifierTableIndex m_property;
+
+    PropertyLookupCache mutable m_cache;
 };
 
 class GetByValue final : public Instruction {
@@ -423,6 +475,10 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_base, RegisterAccess::Read);
+    }
 
 private:
     Register m_base;
@@ -440,6 +496,11 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_base, RegisterAccess::Read);
+        visitor(m_property, RegisterAccess::Read);
+    }
 
 private:
     Register m_base;
@@ -473,6 +534,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
+    void visit_registers_impl(RegisterVisitor const&) { }
 
     auto& true_target() const { return m_true_target; }
     auto& false_target() const { return m_false_target; }
@@ -537,6 +599,13 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const& visitor)
+    {
+        visitor(m_callee, RegisterAccess::Read);
+        visitor(m_this_value, RegisterAccess::Read);
+        for (size_t i = 0; i < m_argument_count; ++i)
+            visitor(m_arguments[i], RegisterAccess::Read);
+    }
 
     size_t length_impl() const
     {
@@ -562,6 +631,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     ClassExpression const& m_class_expression;
@@ -578,6 +648,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     FunctionNode const& m_function_node;
@@ -595,6 +666,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class Increment final : public Instruction {
@@ -607,6 +679,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class Decrement final : public Instruction {
@@ -619,6 +692,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class Throw final : public Instruction {
@@ -633,6 +707,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class EnterUnwindContext final : public Instruction {
@@ -650,6 +725,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
+    void visit_registers_impl(RegisterVisitor const&) { }
 
     auto& entry_point() const { return m_entry_point; }
     auto& handler_target() const { return m_handler_target; }
@@ -672,6 +748,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     EnvironmentMode m_mode { EnvironmentMode::Lexical };
@@ -687,6 +764,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class FinishUnwind final : public Instruction {
@@ -700,6 +778,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     Label m_next_target;
@@ -718,6 +797,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
+    void visit_registers_impl(RegisterVisitor const&) { }
 
     auto& resume_target() const { return m_resume_target; }
 
@@ -743,6 +823,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&);
+    void visit_registers_impl(RegisterVisitor const&) { }
 
     auto& continuation() const { return m_continuation_label; }
 
@@ -761,6 +842,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 
 private:
     HashMap<u32, Variable> m_variables;
@@ -776,6 +858,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class IteratorNext final : public Instruction {
@@ -788,6 +871,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class IteratorResultDone final : public Instruction {
@@ -800,6 +884,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class IteratorResultValue final : public Instruction {
@@ -812,6 +897,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 class ResolveThisBinding final : public Instruction {
@@ -824,6 +910,7 @@ public:
     ThrowCompletionOr<void> execute_impl(Bytecode::Interpreter&) const;
     String to_string_impl(Bytecode::Executable const&) const;
     void replace_references_impl(BasicBlock const&, BasicBlock const&) { }
+    void visit_registers_impl(RegisterVisitor const&) { }
 };
 
 }
@@ -860,6 +947,21 @@ ALWAYS_INLINE void Instruction::replace_references(BasicBlock const& from, Basic
 #undef __BYTECODE_OP
 }
 
+ALWAYS_INLINE void Instruction::visit_registers(RegisterVisitor const& visitor)
+{
+#define __BYTECODE_OP(op)       \
+    case Instruction::Type::op: \
+        return static_cast<Bytecode::Op::op&>(*this).visit_registers_impl(visitor);
+
+    switch (type()) {
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+#undef __BYTECODE_OP
+}
+
 ALWAYS_INLINE size_t Instruction::length() const
 {
     if (type() == Type::Call)
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+// The generator hands out a fresh register for every temporary value, but almost all of those are written once and
+// read right after, without ever leaving the basic block they were created in. Such block-local registers are dead
+// at every block boundary, so their slots are shared between all blocks, and reused inside a block as soon as the
+// previous occupant has been read for the last time.
+//
+// NOTE: Registers that are used in more than one block keep a slot of their own. Any instruction inside an unwind
+//       context may transfer control to its handler, which the CFG doesn't model, so we can't tell whether their
+//       lifetimes overlap.
+void AllocateRegisters::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    struct RegisterInfo {
+        BasicBlock const* block { nullptr };
+        size_t last_use { 0 };
+        bool is_block_local { false };
+        // Registers that are part of a range have to stay next to each other.
+        bool is_in_range { false };
+    };
+    auto register_count = executable.executable.number_of_registers;
+    Vector<RegisterInfo> infos;
+    infos.resize(register_count);
+
+    for (auto& block : executable.executable.basic_blocks) {
+        size_t instruction_index = 0;
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            Optional<u32> range_start;
+            instruction.visit_registers([&](Register& reg, RegisterAccess access) {
+                if (access == RegisterAccess::ReadRange) {
+                    if (!range_start.has_value()) {
+                        range_start = reg.index();
+                        return;
+                    }
+                    for (auto index = *range_start; index <= reg.index(); ++index)
+                        infos[index].is_in_range = true;
+                    return;
+                }
+
+                auto& info = infos[reg.index()];
+                if (!info.block) {
+                    // A register is only local to its block if the block doesn't see any value it had before.
+                    info.block = &block;
+                    info.is_block_local = access == RegisterAccess::Write;
+                } else if (info.block != &block) {
+                    info.is_block_local = false;
+                }
+                info.last_use = instruction_index;
+            });
+            ++instruction_index;
+        }
+    }
+
+    // Registers that can't be shared keep their relative order, which also keeps ranges contiguous.
+    Vector<Optional<u32>> new_indices;
+    new_indices.resize(register_count);
+    u32 next_index = 0;
+    for (u32 index = 0; index < register_count; ++index) {
+        auto& info = infos[index];
+        if (index <= Register::global_object_index || info.is_in_range || (info.block && !info.is_block_local)) {
+            new_indices[index] = next_index++;
+            info.is_block_local = false;
+        }
+    }
+    auto first_shared_index = next_index;
+
+    size_t shared_slot_count = 0;
+    for (auto& block : executable.executable.basic_blocks) {
+        Vector<u32> free_slots;
+        size_t used_slot_count = 0;
+        size_t instruction_index = 0;
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            Vector<u32, 4> slots_to_free;
+            instruction.visit_registers([&](Register& reg, RegisterAccess) {
+                auto& info = infos[reg.index()];
+                auto& new_index = new_indices[reg.index()];
+                if (!new_index.has_value()) {
+                    VERIFY(info.is_block_local && info.block == &block);
+                    u32 slot;
+                    if (free_slots.is_empty())
+                        slot = used_slot_count++;
+                    else
+                        slot = free_slots.take_last();
+                    new_index = first_shared_index + slot;
+                }
+                if (info.is_block_local && info.last_use == instruction_index) {
+                    auto slot = *new_index - first_shared_index;
+                    if (!slots_to_free.contains_slow(slot))
+                        slots_to_free.append(slot);
+                }
+                reg = Register(*new_index);
+            });
+            // NOTE: Slots only become free after the instruction, as it may write to a register after reading another.
+            free_slots.extend(move(slots_to_free));
+            ++instruction_index;
+        }
+        shared_slot_count = max(shared_slot_count, used_slot_count);
+    }
+
+    executable.executable.number_of_registers = first_shared_index + shared_slot_count;
+
+    finished();
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashTable.h>
+#include <LibJS/Bytecode/PassManager.h>
+
+namespace JS::Bytecode::Passes {
+
+void EliminateDeadStores::perform(PassPipelineExecutable& executable)
+{
+    started();
+
+    struct RegisterUsage {
+        bool is_read { false };
+        BasicBlock const* first_block { nullptr };
+        bool is_used_in_multiple_blocks { false };
+    };
+    Vector<RegisterUsage> usages;
+    usages.resize(executable.executable.number_of_registers);
+
+    // Calls the callback for every register an instruction refers to, resolving register ranges to their members.
+    auto for_each_register = [](Instruction& instruction, auto callback) {
+        Optional<u32> range_start;
+        instruction.visit_registers([&](Register& reg, RegisterAccess access) {
+            if (access != RegisterAccess::ReadRange) {
+                callback(reg.index(), access);
+                return;
+            }
+            if (!range_start.has_value()) {
+                range_start = reg.index();
+                return;
+            }
+            for (auto index = *range_start; index <= reg.index(); ++index)
+                callback(index, RegisterAccess::Read);
+        });
+    };
+
+    for (auto& block : executable.executable.basic_blocks) {
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            for_each_register(instruction, [&](u32 index, RegisterAccess access) {
+                auto& usage = usages[index];
+                if (access != RegisterAccess::Write)
+                    usage.is_read = true;
+                if (!usage.first_block)
+                    usage.first_block = &block;
+                else if (usage.first_block != &block)
+                    usage.is_used_in_multiple_blocks = true;
+            });
+        }
+    }
+
+    for (auto& block : executable.executable.basic_blocks) {
+        HashTable<Instruction const*> dead_stores;
+        HashMap<u32, Instruction const*> unread_stores;
+
+        InstructionStreamIterator it { block.instruction_stream() };
+        while (!it.at_end()) {
+            auto& instruction = const_cast<Instruction&>(*it);
+            ++it;
+            for_each_register(instruction, [&](u32 index, RegisterAccess access) {
+                // The accumulator and the global object register are used implicitly all over the place.
+                if (index <= Register::global_object_index)
+                    return;
+                auto& usage = usages[index];
+                if (access != RegisterAccess::Write) {
+                    unread_stores.remove(index);
+                    return;
+                }
+
+                // Only Store writes to a register on its own.
+                VERIFY(instruction.type() == Instruction::Type::Store);
+                if (!usage.is_read) {
+                    dead_stores.set(&instruction);
+                    return;
+                }
+
+                // NOTE: If the register is used anywhere else, an exception handler may want to see the first value.
+                if (!usage.is_used_in_multiple_blocks) {
+                    if (auto previous_store = unread_stores.get(index); previous_store.has_value())
+                        dead_stores.set(*previous_store);
+                }
+                unread_stores.set(index, &instruction);
+            });
+        }
+
+        if (!dead_stores.is_empty())
+            block.remove_instructions_if([&](Instruction const& instruction) { return dead_stores.contains(&instruction); });
+    }
+
+    finished();
+}
+
+}
@@ -121,6 +121,27 @@ private:
     virtual void perform(PassPipelineExecutable&) override;
 };
 
+// Removes stores to registers that are never read, and stores that are overwritten within the same block
+// before anything has read them.
+class EliminateDeadStores : public Pass {
+public:
+    EliminateDeadStores() = default;
+    ~EliminateDeadStores() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
+// Renumbers the registers of an executable, so that registers whose lifetime doesn't overlap share a slot.
+class AllocateRegisters : public Pass {
+public:
+    AllocateRegisters() = default;
+    ~AllocateRegisters() override = default;
+
+private:
+    virtual void perform(PassPipelineExecutable&) override;
+};
+
 class DumpCFG : public Pass {
 public:
     DumpCFG(FILE* file)
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/PropertyLookupCache.h>
+#include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/Shape.h>
+
+namespace JS::Bytecode {
+
+static bool is_cacheable(Object const& object)
+{
+    return !object.may_interfere_with_property_lookup_caching() && !object.shape().is_unique();
+}
+
+PropertyLookupCache::Entry const* PropertyLookupCache::find_entry(Object const& object) const
+{
+    if (object.may_interfere_with_property_lookup_caching())
+        return nullptr;
+
+    auto const& shape = object.shape();
+    for (auto const& entry : m_entries) {
+        if (entry.shape.ptr() != &shape)
+            continue;
+        if (!entry.prototype_shape)
+            return &entry;
+        auto const* prototype = shape.prototype();
+        if (prototype && !prototype->may_interfere_with_property_lookup_caching() && &prototype->shape() == entry.prototype_shape.ptr())
+            return &entry;
+        return nullptr;
+    }
+    return nullptr;
+}
+
+void PropertyLookupCache::add_entry(Shape const& shape, Shape const* prototype_shape, u32 property_offset)
+{
+    Entry* entry_to_replace = nullptr;
+    for (auto& entry : m_entries) {
+        if (entry.shape.ptr() == &shape || !entry.shape) {
+            entry_to_replace = &entry;
+            break;
+        }
+    }
+    if (!entry_to_replace) {
+        entry_to_replace = &m_entries[m_next_entry_to_replace];
+        m_next_entry_to_replace = (m_next_entry_to_replace + 1) % entry_count;
+    }
+
+    entry_to_replace->shape = shape;
+    entry_to_replace->prototype_shape = prototype_shape;
+    entry_to_replace->property_offset = property_offset;
+}
+
+Optional<Value> PropertyLookupCache::get(Object const& object)
+{
+    if (auto const* entry = find_entry(object)) {
+        auto const& holder = entry->prototype_shape ? *object.shape().prototype() : object;
+        auto value = holder.get_direct(entry->property_offset);
+        // NOTE: Getters have to be called with the right receiver, leave that to the slow path.
+        if (!value.is_accessor()) {
+            ++m_statistics.hit_count;
+            return value;
+        }
+    }
+    ++m_statistics.miss_count;
+    return {};
+}
+
+void PropertyLookupCache::update_after_get(Object const& object, FlyString const& property_name)
+{
+    if (!is_cacheable(object))
+        return;
+
+    auto const& shape = object.shape();
+    if (auto metadata = shape.lookup(property_name); metadata.has_value()) {
+        if (!object.get_direct(metadata->offset).is_accessor())
+            add_entry(shape, nullptr, metadata->offset);
+        return;
+    }
+
+    // NOTE: We only look one step up the prototype chain, that already covers methods called on class instances.
+    auto const* prototype = shape.prototype();
+    if (!prototype || !is_cacheable(*prototype))
+        return;
+    auto metadata = prototype->shape().lookup(property_name);
+    if (metadata.has_value() && !prototype->get_direct(metadata->offset).is_accessor())
+        add_entry(shape, &prototype->shape(), metadata->offset);
+}
+
+bool PropertyLookupCache::put(Object& object, Value value)
+{
+    if (auto const* entry = find_entry(object); entry && !entry->prototype_shape) {
+        if (!object.get_direct(entry->property_offset).is_accessor()) {
+            object.put_direct(entry->property_offset, value);
+            ++m_statistics.hit_count;
+            return true;
+        }
+    }
+    ++m_statistics.miss_count;
+    return false;
+}
+
+void PropertyLookupCache::update_after_put(Object const& object, FlyString const& property_name)
+{
+    if (!is_cacheable(object))
+        return;
+
+    // NOTE: Only existing writable data properties of the object itself can be updated in place, anything else
+    //       (setters, read-only or inherited properties) needs the full [[Set]] semantics.
+    auto const& shape = object.shape();
+    auto metadata = shape.lookup(property_name);
+    if (!metadata.has_value() || !metadata->attributes.is_writable() || object.get_direct(metadata->offset).is_accessor())
+        return;
+    add_entry(shape, nullptr, metadata->offset);
+}
+
+}
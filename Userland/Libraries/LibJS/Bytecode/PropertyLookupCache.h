@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/FlyString.h>
+#include <AK/Optional.h>
+#include <AK/WeakPtr.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::Bytecode {
+
+struct PropertyLookupCacheStatistics {
+    u64 hit_count { 0 };
+    u64 miss_count { 0 };
+};
+
+// A small polymorphic inline cache for the named property accesses done by GetById and PutById.
+// Every entry remembers the storage offset a property was found at for one shape. Only non-unique shapes are cached,
+// as those never change: adding, deleting or reconfiguring a property or changing the prototype moves an object
+// to another shape instead. A hit can therefore skip the property lookup entirely.
+class PropertyLookupCache {
+public:
+    static constexpr size_t entry_count = 4;
+
+    Optional<Value> get(Object const&);
+    void update_after_get(Object const&, FlyString const& property_name);
+
+    bool put(Object&, Value);
+    void update_after_put(Object const&, FlyString const& property_name);
+
+    PropertyLookupCacheStatistics const& statistics() const { return m_statistics; }
+
+private:
+    struct Entry {
+        WeakPtr<Shape> shape;
+        // Only set if the property was found on the prototype of the object, whose shape then has to match too.
+        WeakPtr<Shape> prototype_shape;
+        u32 property_offset { 0 };
+    };
+
+    Entry const* find_entry(Object const&) const;
+    void add_entry(Shape const&, Shape const* prototype_shape, u32 property_offset);
+
+    AK::Array<Entry, entry_count> m_entries;
+    size_t m_next_entry_to_replace { 0 };
+    PropertyLookupCacheStatistics m_statistics;
+};
+
+}
@@ -62,6 +62,12 @@ private:
     State m_state : 7 { State::Live };
 };
 
+// Dead cells of these types are only destroyed once the heap needs their memory again, instead of
+// during the collection itself. Only opt in types (and not their subclasses!) whose destructors have
+// no effects outside of the cell itself, e.g. revoking WeakPtrs or removing themselves from a cache.
+template<typename T>
+inline constexpr bool can_be_swept_lazily = false;
+
 }
 
 template<>
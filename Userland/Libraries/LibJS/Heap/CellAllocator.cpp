@@ -12,15 +12,21 @@
 
 namespace JS {
 
-CellAllocator::CellAllocator(size_t cell_size)
+CellAllocator::CellAllocator(size_t cell_size, HeapBlock::Sweeping sweeping)
     : m_cell_size(cell_size)
+    , m_sweeping(sweeping)
 {
 }
 
 Cell* CellAllocator::allocate_cell(Heap& heap)
 {
+    // NOTE: Blocks are swept one at a time, only until we find one with a free cell.
+    //       A block without any surviving cells is simply reused instead of being released.
+    while (m_usable_blocks.is_empty() && !m_blocks_needing_lazy_sweep.is_empty())
+        sweep_lazily(*m_blocks_needing_lazy_sweep.first());
+
     if (m_usable_blocks.is_empty()) {
-        auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
+        auto block = HeapBlock::create_with_cell_size(heap, m_cell_size, m_sweeping);
         m_usable_blocks.append(*block.leak_ptr());
     }
 
@@ -33,6 +39,11 @@ Cell* CellAllocator::allocate_cell(Heap& heap)
 }
 
 void CellAllocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
+{
+    release_block(block);
+}
+
+void CellAllocator::release_block(HeapBlock& block)
 {
     auto& heap = block.heap();
     block.m_list_node.remove();
@@ -47,4 +58,53 @@ void CellAllocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
     m_usable_blocks.append(block);
 }
 
+size_t CellAllocator::defer_sweeping_of_all_blocks(Badge<Heap>)
+{
+    VERIFY(m_sweeping == HeapBlock::Sweeping::Lazy);
+    size_t block_count = 0;
+    auto defer_sweeping = [&](BlockList& list) {
+        while (!list.is_empty()) {
+            auto& block = *list.take_first();
+            block.set_needs_lazy_sweep(true);
+            m_blocks_needing_lazy_sweep.append(block);
+            ++block_count;
+        }
+    };
+    defer_sweeping(m_full_blocks);
+    defer_sweeping(m_usable_blocks);
+    return block_count;
+}
+
+void CellAllocator::finish_lazy_sweeping(Badge<Heap>)
+{
+    while (!m_blocks_needing_lazy_sweep.is_empty()) {
+        auto& block = *m_blocks_needing_lazy_sweep.first();
+        if (!sweep_lazily(block))
+            release_block(block);
+    }
+}
+
+bool CellAllocator::sweep_lazily(HeapBlock& block)
+{
+    VERIFY(block.needs_lazy_sweep());
+    block.set_needs_lazy_sweep(false);
+
+    bool block_has_live_cells = false;
+    block.for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
+        if (!cell->is_marked()) {
+            block.deallocate(cell);
+        } else {
+            cell->set_marked(false);
+            block_has_live_cells = true;
+        }
+    });
+
+    block.m_list_node.remove();
+    if (block.is_full())
+        m_full_blocks.append(block);
+    else
+        m_usable_blocks.append(block);
+    return block_has_live_cells;
+}
+
 }
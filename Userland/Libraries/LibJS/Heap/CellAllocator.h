@@ -15,10 +15,11 @@ namespace JS {
 
 class CellAllocator {
 public:
-    explicit CellAllocator(size_t cell_size);
+    CellAllocator(size_t cell_size, HeapBlock::Sweeping);
     ~CellAllocator() = default;
 
     size_t cell_size() const { return m_cell_size; }
+    HeapBlock::Sweeping sweeping() const { return m_sweeping; }
 
     Cell* allocate_cell(Heap&);
 
@@ -33,18 +34,32 @@ public:
             if (callback(block) == IterationDecision::Break)
                 return IterationDecision::Break;
         }
+        for (auto& block : m_blocks_needing_lazy_sweep) {
+            if (callback(block) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
         return IterationDecision::Continue;
     }
 
     void block_did_become_empty(Badge<Heap>, HeapBlock&);
     void block_did_become_usable(Badge<Heap>, HeapBlock&);
 
+    // Hands all blocks over to be swept later on, when allocate_cell() runs out of usable blocks. Returns the number of blocks.
+    size_t defer_sweeping_of_all_blocks(Badge<Heap>);
+    void finish_lazy_sweeping(Badge<Heap>);
+
 private:
+    // Returns whether any cells in the block survived.
+    bool sweep_lazily(HeapBlock&);
+    void release_block(HeapBlock&);
+
     const size_t m_cell_size;
+    const HeapBlock::Sweeping m_sweeping;
 
     using BlockList = IntrusiveList<&HeapBlock::m_list_node>;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+    BlockList m_blocks_needing_lazy_sweep;
 };
 
 }
@@ -37,18 +37,21 @@ Heap::Heap(VM& vm)
     gc_perf_string_id = perf_register_string(gc_signpost_string.characters_without_null_termination(), gc_signpost_string.length());
 #endif
 
-    if constexpr (HeapBlock::min_possible_cell_size <= 16) {
-        m_allocators.append(make<CellAllocator>(16));
+    // NOTE: Lazily swept cells get blocks of their own, so that sweeping them never has to wait for the rest.
+    for (auto sweeping : { HeapBlock::Sweeping::Eager, HeapBlock::Sweeping::Lazy }) {
+        if constexpr (HeapBlock::min_possible_cell_size <= 16) {
+            m_allocators.append(make<CellAllocator>(16, sweeping));
+        }
+        static_assert(HeapBlock::min_possible_cell_size <= 24, "Heap Cell tracking uses too much data!");
+        m_allocators.append(make<CellAllocator>(32, sweeping));
+        m_allocators.append(make<CellAllocator>(64, sweeping));
+        m_allocators.append(make<CellAllocator>(96, sweeping));
+        m_allocators.append(make<CellAllocator>(128, sweeping));
+        m_allocators.append(make<CellAllocator>(256, sweeping));
+        m_allocators.append(make<CellAllocator>(512, sweeping));
+        m_allocators.append(make<CellAllocator>(1024, sweeping));
+        m_allocators.append(make<CellAllocator>(3072, sweeping));
     }
-    static_assert(HeapBlock::min_possible_cell_size <= 24, "Heap Cell tracking uses too much data!");
-    m_allocators.append(make<CellAllocator>(32));
-    m_allocators.append(make<CellAllocator>(64));
-    m_allocators.append(make<CellAllocator>(96));
-    m_allocators.append(make<CellAllocator>(128));
-    m_allocators.append(make<CellAllocator>(256));
-    m_allocators.append(make<CellAllocator>(512));
-    m_allocators.append(make<CellAllocator>(1024));
-    m_allocators.append(make<CellAllocator>(3072));
 }
 
 Heap::~Heap()
@@ -57,17 +60,17 @@ Heap::~Heap()
     collect_garbage(CollectionType::CollectEverything);
 }
 
-ALWAYS_INLINE CellAllocator& Heap::allocator_for_size(size_t cell_size)
+ALWAYS_INLINE CellAllocator& Heap::allocator_for_size(size_t cell_size, HeapBlock::Sweeping sweeping)
 {
     for (auto& allocator : m_allocators) {
-        if (allocator->cell_size() >= cell_size)
+        if (allocator->sweeping() == sweeping && allocator->cell_size() >= cell_size)
             return *allocator;
     }
     dbgln("Cannot get CellAllocator for cell size {}, largest available is {}!", cell_size, m_allocators.last()->cell_size());
     VERIFY_NOT_REACHED();
 }
 
-Cell* Heap::allocate_cell(size_t size)
+Cell* Heap::allocate_cell(size_t size, HeapBlock::Sweeping sweeping)
 {
     if (should_collect_on_every_allocation()) {
         collect_garbage();
@@ -78,7 +81,7 @@ Cell* Heap::allocate_cell(size_t size)
         ++m_allocations_since_last_gc;
     }
 
-    auto& allocator = allocator_for_size(size);
+    auto& allocator = allocator_for_size(size, sweeping);
     return allocator.allocate_cell(*this);
 }
 
@@ -92,17 +95,40 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     perf_event(PERF_EVENT_SIGNPOST, gc_perf_string_id, global_gc_counter++);
 #endif
 
-    auto collection_measurement_timer = Core::ElapsedTimer::start_new();
+    Core::ElapsedTimer collection_measurement_timer(true);
+    collection_measurement_timer.start();
+    m_root_gathering_time = {};
+    m_marking_time = {};
+    if (collection_type == CollectionType::CollectGarbage && m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    // NOTE: Marking (and conservative root scanning in particular) assumes that every Live cell is
+    //       either unmarked or actually alive, so everything left over from the last collection
+    //       has to be swept first.
+    finish_lazy_sweeping();
+
     if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
-        }
+        Core::ElapsedTimer phase_measurement_timer(true);
+        phase_measurement_timer.start();
         HashTable<Cell*> roots;
         gather_roots(roots);
+        m_root_gathering_time = phase_measurement_timer.elapsed_time();
+
+        phase_measurement_timer.start();
         mark_live_cells(roots);
+        m_marking_time = phase_measurement_timer.elapsed_time();
+    }
+    sweep_dead_cells(collection_type, print_report, collection_measurement_timer);
+}
+
+void Heap::finish_lazy_sweeping()
+{
+    for (auto& allocator : m_allocators) {
+        if (allocator->sweeping() == HeapBlock::Sweeping::Lazy)
+            allocator->finish_lazy_sweeping({});
     }
-    sweep_dead_cells(print_report, collection_measurement_timer);
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -173,7 +199,10 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    MarkingVisitor() { }
+    explicit MarkingVisitor(Vector<Cell*>& mark_stack)
+        : m_mark_stack(mark_stack)
+    {
+    }
 
     virtual void visit_impl(Cell& cell) override
     {
@@ -181,18 +210,30 @@ public:
             return;
         dbgln_if(HEAP_DEBUG, "  ! {}", &cell);
 
+        // NOTE: Instead of recursing into the edges of the cell right away, we put it
+        //       on the mark stack, so that deep object graphs don't exhaust the C++ stack.
         cell.set_marked(true);
-        cell.visit_edges(*this);
+        m_mark_stack.append(&cell);
+    }
+
+    void visit_edges_of_marked_cells()
+    {
+        while (!m_mark_stack.is_empty())
+            m_mark_stack.take_last()->visit_edges(*this);
     }
+
+private:
+    Vector<Cell*>& m_mark_stack;
 };
 
 void Heap::mark_live_cells(const HashTable<Cell*>& roots)
 {
     dbgln_if(HEAP_DEBUG, "mark_live_cells:");
 
-    MarkingVisitor visitor;
+    MarkingVisitor visitor(m_mark_stack);
     for (auto* root : roots)
         visitor.visit(root);
+    visitor.visit_edges_of_marked_cells();
 
     for (auto& inverse_root : m_uprooted_cells)
         inverse_root->set_marked(false);
@@ -200,7 +241,7 @@ void Heap::mark_live_cells(const HashTable<Cell*>& roots)
     m_uprooted_cells.clear();
 }
 
-void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
+void Heap::sweep_dead_cells(CollectionType collection_type, bool print_report, const Core::ElapsedTimer& measurement_timer)
 {
     dbgln_if(HEAP_DEBUG, "sweep_dead_cells:");
     Vector<HeapBlock*, 32> empty_blocks;
@@ -210,8 +251,18 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
     size_t live_cells = 0;
     size_t collected_cell_bytes = 0;
     size_t live_cell_bytes = 0;
+    size_t lazily_swept_blocks = 0;
+
+    for (auto& allocator : m_allocators) {
+        // NOTE: When collecting everything, nothing is going to be allocated again, so there's no point in waiting.
+        if (allocator->sweeping() == HeapBlock::Sweeping::Lazy && collection_type == CollectionType::CollectGarbage)
+            lazily_swept_blocks += allocator->defer_sweeping_of_all_blocks({});
+    }
 
     for_each_block([&](auto& block) {
+        if (block.needs_lazy_sweep())
+            return IterationDecision::Continue;
+
         bool block_has_live_cells = false;
         bool block_was_full = block.is_full();
         block.template for_each_cell_in_state<Cell::State::Live>([&](Cell* cell) {
@@ -239,12 +290,12 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
 
     for (auto* block : empty_blocks) {
         dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_empty({}, *block);
+        allocator_for_size(block->cell_size(), block->sweeping()).block_did_become_empty({}, *block);
     }
 
     for (auto* block : full_blocks_that_became_usable) {
         dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
-        allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
+        allocator_for_size(block->cell_size(), block->sweeping()).block_did_become_usable({}, *block);
     }
 
     if constexpr (HEAP_DEBUG) {
@@ -254,7 +305,9 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
         });
     }
 
-    int time_spent = measurement_timer.elapsed();
+    auto time_spent = measurement_timer.elapsed_time();
+    auto sweeping_time = time_spent - m_root_gathering_time - m_marking_time;
+    update_statistics_after_collection(time_spent);
 
     if (print_report) {
         size_t live_block_count = 0;
@@ -265,15 +318,31 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
 
         dbgln("Garbage collection report");
         dbgln("=============================================");
-        dbgln("     Time spent: {} ms", time_spent);
+        dbgln("     Time spent: {} ms", time_spent.to_milliseconds());
+        dbgln(" Root gathering: {} us", m_root_gathering_time.to_microseconds());
+        dbgln("        Marking: {} us", m_marking_time.to_microseconds());
+        dbgln("       Sweeping: {} us", sweeping_time.to_microseconds());
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
         dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
         dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
         dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
+        dbgln(" Unswept blocks: {} ({} bytes)", lazily_swept_blocks, lazily_swept_blocks * HeapBlock::block_size);
+        dbgln("    Collections: {}", m_collection_count);
+        dbgln("   Total paused: {} ms", m_total_collection_time.to_milliseconds());
+        dbgln("  Longest pause: {} ms", m_longest_collection_time.to_milliseconds());
+        dbgln("  Average pause: {} us", m_total_collection_time.to_microseconds() / static_cast<i64>(m_collection_count));
         dbgln("=============================================");
     }
 }
 
+void Heap::update_statistics_after_collection(Time collection_time)
+{
+    ++m_collection_count;
+    m_total_collection_time += collection_time;
+    if (collection_time > m_longest_collection_time)
+        m_longest_collection_time = collection_time;
+}
+
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
 {
     VERIFY(!m_handles.contains(impl));
@@ -11,6 +11,7 @@
 #include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -36,7 +37,7 @@ public:
     template<typename T, typename... Args>
     T* allocate_without_global_object(Args&&... args)
     {
-        auto* memory = allocate_cell(sizeof(T));
+        auto* memory = allocate_cell(sizeof(T), sweeping_for<T>);
         new (memory) T(forward<Args>(args)...);
         return static_cast<T*>(memory);
     }
@@ -44,7 +45,7 @@ public:
     template<typename T, typename... Args>
     T* allocate(GlobalObject& global_object, Args&&... args)
     {
-        auto* memory = allocate_cell(sizeof(T));
+        auto* memory = allocate_cell(sizeof(T), sweeping_for<T>);
         new (memory) T(forward<Args>(args)...);
         auto* cell = static_cast<T*>(memory);
         cell->initialize(global_object);
@@ -80,14 +81,19 @@ public:
     void uproot_cell(Cell* cell);
 
 private:
-    Cell* allocate_cell(size_t);
+    template<typename T>
+    static constexpr HeapBlock::Sweeping sweeping_for = can_be_swept_lazily<T> ? HeapBlock::Sweeping::Lazy : HeapBlock::Sweeping::Eager;
 
+    Cell* allocate_cell(size_t, HeapBlock::Sweeping);
+
+    void finish_lazy_sweeping();
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
     void mark_live_cells(const HashTable<Cell*>& live_cells);
-    void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&);
+    void sweep_dead_cells(CollectionType, bool print_report, const Core::ElapsedTimer&);
+    void update_statistics_after_collection(Time collection_time);
 
-    CellAllocator& allocator_for_size(size_t);
+    CellAllocator& allocator_for_size(size_t, HeapBlock::Sweeping);
 
     template<typename Callback>
     void for_each_block(Callback callback)
@@ -113,12 +119,25 @@ private:
 
     Vector<Cell*> m_uprooted_cells;
 
+    // Cells that have been marked, but whose edges haven't been visited yet.
+    // This is kept around between collections so that its capacity can be reused.
+    Vector<Cell*> m_mark_stack;
+
     BlockAllocator m_block_allocator;
 
     size_t m_gc_deferrals { 0 };
     bool m_should_gc_when_deferral_ends { false };
 
     bool m_collecting_garbage { false };
+
+    // Pause times of the current collection, broken down by phase.
+    Time m_root_gathering_time;
+    Time m_marking_time;
+
+    // Pause time statistics over all collections done by this heap.
+    size_t m_collection_count { 0 };
+    Time m_total_collection_time;
+    Time m_longest_collection_time;
 };
 
 }
@@ -18,7 +18,7 @@
 
 namespace JS {
 
-NonnullOwnPtr<HeapBlock> HeapBlock::create_with_cell_size(Heap& heap, size_t cell_size)
+NonnullOwnPtr<HeapBlock> HeapBlock::create_with_cell_size(Heap& heap, size_t cell_size, Sweeping sweeping)
 {
 #ifdef __serenity__
     char name[64];
@@ -27,13 +27,14 @@ NonnullOwnPtr<HeapBlock> HeapBlock::create_with_cell_size(Heap& heap, size_t cel
     char const* name = nullptr;
 #endif
     auto* block = static_cast<HeapBlock*>(heap.block_allocator().allocate_block(name));
-    new (block) HeapBlock(heap, cell_size);
+    new (block) HeapBlock(heap, cell_size, sweeping);
     return NonnullOwnPtr<HeapBlock>(NonnullOwnPtr<HeapBlock>::Adopt, *block);
 }
 
-HeapBlock::HeapBlock(Heap& heap, size_t cell_size)
+HeapBlock::HeapBlock(Heap& heap, size_t cell_size, Sweeping sweeping)
     : m_heap(heap)
     , m_cell_size(cell_size)
+    , m_sweeping(sweeping)
 {
     VERIFY(cell_size >= sizeof(FreelistEntry));
     ASAN_POISON_MEMORY_REGION(m_storage, block_size - sizeof(HeapBlock));
@@ -24,12 +24,25 @@ class HeapBlock {
 
 public:
     static constexpr size_t block_size = 16 * KiB;
-    static NonnullOwnPtr<HeapBlock> create_with_cell_size(Heap&, size_t);
+
+    enum class Sweeping {
+        Eager,
+        Lazy,
+    };
+
+    static NonnullOwnPtr<HeapBlock> create_with_cell_size(Heap&, size_t, Sweeping);
 
     size_t cell_size() const { return m_cell_size; }
     size_t cell_count() const { return (block_size - sizeof(HeapBlock)) / m_cell_size; }
     bool is_full() const { return !has_lazy_freelist() && !m_freelist; }
 
+    Sweeping sweeping() const { return m_sweeping; }
+
+    // Set from the end of a collection until the block has been swept by its CellAllocator.
+    // Until then, unmarked cells in the block are dead, even though they are still in the Live state.
+    bool needs_lazy_sweep() const { return m_needs_lazy_sweep; }
+    void set_needs_lazy_sweep(bool b) { m_needs_lazy_sweep = b; }
+
     ALWAYS_INLINE Cell* allocate()
     {
         Cell* allocated_cell = nullptr;
@@ -91,7 +104,7 @@ public:
     IntrusiveListNode<HeapBlock> m_list_node;
 
 private:
-    HeapBlock(Heap&, size_t cell_size);
+    HeapBlock(Heap&, size_t cell_size, Sweeping);
 
     bool has_lazy_freelist() const { return m_next_lazy_freelist_index < cell_count(); }
 
@@ -110,6 +123,8 @@ private:
     size_t m_cell_size { 0 };
     size_t m_next_lazy_freelist_index { 0 };
     FreelistEntry* m_freelist { nullptr };
+    Sweeping m_sweeping { Sweeping::Eager };
+    bool m_needs_lazy_sweep { false };
     alignas(Cell) u8 m_storage[];
 
 public:
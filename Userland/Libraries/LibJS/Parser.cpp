@@ -832,9 +832,7 @@ RefPtr<FunctionExpression> Parser::try_parse_arrow_function_expression(bool expe
         }
     }
 
-    auto function_start_offset = rule_start.position().offset;
-    auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = String { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = source_text_since(rule_start.position());
     return create_ast_node<FunctionExpression>(
         { m_state.current_token.filename(), rule_start.position(), position() }, "", move(source_text),
         move(body), move(parameters), function_length, function_kind, body->in_strict_mode(),
@@ -1316,12 +1314,12 @@ NonnullRefPtr<ClassExpression> Parser::parse_class_expression(bool expect_class_
             constructor_body->append(create_ast_node<ReturnStatement>({ m_state.current_token.filename(), rule_start.position(), position() }, move(super_call)));
 
             constructor = create_ast_node<FunctionExpression>(
-                { m_state.current_token.filename(), rule_start.position(), position() }, class_name, "",
+                { m_state.current_token.filename(), rule_start.position(), position() }, class_name, SourceText {},
                 move(constructor_body), Vector { FunctionNode::Parameter { FlyString { "args" }, nullptr, true } }, 0, FunctionKind::Normal,
                 /* is_strict_mode */ true, /* might_need_arguments_object */ false, /* contains_direct_call_to_eval */ false);
         } else {
             constructor = create_ast_node<FunctionExpression>(
-                { m_state.current_token.filename(), rule_start.position(), position() }, class_name, "",
+                { m_state.current_token.filename(), rule_start.position(), position() }, class_name, SourceText {},
                 move(constructor_body), Vector<FunctionNode::Parameter> {}, 0, FunctionKind::Normal,
                 /* is_strict_mode */ true, /* might_need_arguments_object */ false, /* contains_direct_call_to_eval */ false);
         }
@@ -1337,9 +1335,7 @@ NonnullRefPtr<ClassExpression> Parser::parse_class_expression(bool expect_class_
             syntax_error(String::formatted("Reference to undeclared private field or method '{}'", private_name));
     }
 
-    auto function_start_offset = rule_start.position().offset;
-    auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = String { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = source_text_since(rule_start.position());
 
     return create_ast_node<ClassExpression>({ m_state.current_token.filename(), rule_start.position(), position() }, move(class_name), move(source_text), move(constructor), move(super_class), move(elements));
 }
@@ -2409,6 +2405,11 @@ void Parser::parse_statement_list(ScopeNode& output_node, AllowLabelledFunction
 }
 
 // FunctionBody, https://tc39.es/ecma262/#prod-FunctionBody
+// NOTE: Function bodies are always parsed in full, even if the function never runs. All early errors have to be
+//       reported before the script starts running, and we only find them while building the AST (scopes, duplicate
+//       declarations, private names, ...), so skipping over a body would need a separate validating pre-parser.
+//       What we can do lazily already is: bytecode is generated on the first call, and [[SourceText]] is only
+//       copied out of the SourceCode when someone asks for it.
 NonnullRefPtr<FunctionBody> Parser::parse_function_body(Vector<FunctionDeclaration::Parameter> const& parameters, FunctionKind function_kind, bool& contains_direct_call_to_eval)
 {
     auto rule_start = push_start();
@@ -2571,9 +2572,7 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options, Op
     if (has_strict_directive)
         check_identifier_name_for_assignment_validity(name, true);
 
-    auto function_start_offset = rule_start.position().offset;
-    auto function_end_offset = position().offset - m_state.current_token.trivia().length();
-    auto source_text = String { m_state.lexer.source().substring_view(function_start_offset, function_end_offset - function_start_offset) };
+    auto source_text = source_text_since(rule_start.position());
     return create_ast_node<FunctionNodeType>(
         { m_state.current_token.filename(), rule_start.position(), position() },
         name, move(source_text), move(body), move(parameters), function_length,
@@ -3814,6 +3813,16 @@ void Parser::consume_or_insert_semicolon()
     expected("Semicolon");
 }
 
+SourceText Parser::source_text_since(Position const& start)
+{
+    // NOTE: All functions and classes share a single copy of the source code, instead of all of
+    //       them copying out their own source text (which includes that of all nested functions).
+    if (!m_source_code)
+        m_source_code = SourceCode::create(m_state.lexer.source());
+    auto end_offset = position().offset - m_state.current_token.trivia().length();
+    return { *m_source_code, start.offset, end_offset };
+}
+
 Token Parser::consume_identifier()
 {
     if (match(TokenType::Identifier))
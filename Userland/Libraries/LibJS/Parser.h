@@ -237,6 +237,7 @@ private:
     Token consume(TokenType type);
     Token consume_and_validate_numeric_literal();
     void consume_or_insert_semicolon();
+    SourceText source_text_since(Position const& start);
     void save_state();
     void load_state();
     void discard_saved_state();
@@ -331,6 +332,7 @@ private:
     ParserState m_state;
     FlyString m_filename;
     Vector<ParserState> m_saved_state;
+    RefPtr<SourceCode> m_source_code;
     HashMap<Position, TokenMemoization, PositionKeyTraits> m_token_memoizations;
     Program::Type m_program_type;
 };
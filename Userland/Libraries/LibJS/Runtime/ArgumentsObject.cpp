@@ -14,6 +14,7 @@ ArgumentsObject::ArgumentsObject(GlobalObject& global_object, Environment& envir
     : Object(*global_object.object_prototype())
     , m_environment(environment)
 {
+    set_may_interfere_with_property_lookup_caching();
 }
 
 void ArgumentsObject::initialize(GlobalObject& global_object)
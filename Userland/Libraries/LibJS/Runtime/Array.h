@@ -50,4 +50,7 @@ private:
     bool m_length_writable { true };
 };
 
+template<>
+inline constexpr bool can_be_swept_lazily<Array> = true;
+
 }
@@ -38,6 +38,18 @@ ThrowCompletionOr<Value> await(GlobalObject& global_object, Value value)
 
     // 2. Let promise be ? PromiseResolve(%Promise%, value).
     auto* promise_object = TRY(promise_resolve(global_object, *global_object.promise_constructor(), value));
+    auto* promise = verify_cast<Promise>(promise_object);
+
+    // NOTE: If the promise has already settled, the reaction we'd set up below would only record its result once
+    //       the queued promise jobs run, which we do synchronously anyway. So skip creating the closures, builtin
+    //       functions and reactions, and take the result directly. A rejected promise that isn't handled yet still
+    //       goes the long way, as PerformPromiseThen has to inform the host that it is now being handled.
+    if (promise->state() == Promise::State::Fulfilled || (promise->state() == Promise::State::Rejected && promise->is_handled())) {
+        vm.run_queued_promise_jobs();
+        if (promise->state() == Promise::State::Fulfilled)
+            return promise->result();
+        return throw_completion(promise->result());
+    }
 
     Optional<bool> success;
     Value result;
@@ -90,7 +102,6 @@ ThrowCompletionOr<Value> await(GlobalObject& global_object, Value value)
     auto* on_rejected = NativeFunction::create(global_object, move(rejected_closure), 1, "");
 
     // 7. Perform ! PerformPromiseThen(promise, onFulfilled, onRejected).
-    auto* promise = verify_cast<Promise>(promise_object);
     promise->perform_then(on_fulfilled, on_rejected, {});
 
     // FIXME: Since we don't support context suspension, we attempt to "wait" for the promise to resolve
@@ -84,4 +84,7 @@ private:
 template<>
 inline bool Environment::fast_is<DeclarativeEnvironment>() const { return is_declarative_environment(); }
 
+template<>
+inline constexpr bool can_be_swept_lazily<DeclarativeEnvironment> = true;
+
 }
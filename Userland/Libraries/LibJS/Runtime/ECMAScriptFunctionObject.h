@@ -32,10 +32,10 @@ public:
         Global,
     };
 
-    static ECMAScriptFunctionObject* create(GlobalObject&, FlyString name, String source_text, Statement const& ecmascript_code, Vector<FunctionNode::Parameter> parameters, i32 m_function_length, Environment* parent_scope, PrivateEnvironment* private_scope, FunctionKind, bool is_strict, bool might_need_arguments_object = true, bool contains_direct_call_to_eval = true, bool is_arrow_function = false);
-    static ECMAScriptFunctionObject* create(GlobalObject&, FlyString name, Object& prototype, String source_text, Statement const& ecmascript_code, Vector<FunctionNode::Parameter> parameters, i32 m_function_length, Environment* parent_scope, PrivateEnvironment* private_scope, FunctionKind, bool is_strict, bool might_need_arguments_object = true, bool contains_direct_call_to_eval = true, bool is_arrow_function = false);
+    static ECMAScriptFunctionObject* create(GlobalObject&, FlyString name, SourceText source_text, Statement const& ecmascript_code, Vector<FunctionNode::Parameter> parameters, i32 m_function_length, Environment* parent_scope, PrivateEnvironment* private_scope, FunctionKind, bool is_strict, bool might_need_arguments_object = true, bool contains_direct_call_to_eval = true, bool is_arrow_function = false);
+    static ECMAScriptFunctionObject* create(GlobalObject&, FlyString name, Object& prototype, SourceText source_text, Statement const& ecmascript_code, Vector<FunctionNode::Parameter> parameters, i32 m_function_length, Environment* parent_scope, PrivateEnvironment* private_scope, FunctionKind, bool is_strict, bool might_need_arguments_object = true, bool contains_direct_call_to_eval = true, bool is_arrow_function = false);
 
-    ECMAScriptFunctionObject(FlyString name, String source_text, Statement const& ecmascript_code, Vector<FunctionNode::Parameter> parameters, i32 m_function_length, Environment* parent_scope, PrivateEnvironment* private_scope, Object& prototype, FunctionKind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function);
+    ECMAScriptFunctionObject(FlyString name, SourceText source_text, Statement const& ecmascript_code, Vector<FunctionNode::Parameter> parameters, i32 m_function_length, Environment* parent_scope, PrivateEnvironment* private_scope, Object& prototype, FunctionKind, bool is_strict, bool might_need_arguments_object, bool contains_direct_call_to_eval, bool is_arrow_function);
     virtual void initialize(GlobalObject&) override;
     virtual ~ECMAScriptFunctionObject();
 
@@ -65,8 +65,8 @@ public:
     Object* home_object() const { return m_home_object; }
     void set_home_object(Object* home_object) { m_home_object = home_object; }
 
-    String const& source_text() const { return m_source_text; }
-    void set_source_text(String source_text) { m_source_text = move(source_text); }
+    String const& source_text() const { return m_source_text.string(); }
+    void set_source_text(SourceText source_text) { m_source_text = move(source_text); }
 
     struct InstanceField {
         Variant<PropertyKey, PrivateName> name;
@@ -108,8 +108,8 @@ private:
     ThrowCompletionOr<void> function_declaration_instantiation(Interpreter*);
 
     FlyString m_name;
-    OwnPtr<Bytecode::Executable> m_bytecode_executable;
-    Vector<OwnPtr<Bytecode::Executable>> m_default_parameter_bytecode_executables;
+    Bytecode::Executable* m_bytecode_executable { nullptr };
+    Vector<Bytecode::Executable*> m_default_parameter_bytecode_executables;
     i32 m_function_length { 0 };
 
     // Internal Slots of ECMAScript Function Objects, https://tc39.es/ecma262/#table-internal-slots-of-ecmascript-function-objects
@@ -120,7 +120,7 @@ private:
     Realm* m_realm { nullptr };                                       // [[Realm]]
     ScriptOrModule m_script_or_module;                                // [[ScriptOrModule]]
     Object* m_home_object { nullptr };                                // [[HomeObject]]
-    String m_source_text;                                             // [[SourceText]]
+    SourceText m_source_text;                                         // [[SourceText]]
     Vector<InstanceField> m_fields;                                   // [[Fields]]
     Vector<PrivateElement> m_private_methods;                         // [[PrivateMethods]]
     ConstructorKind m_constructor_kind : 1 { ConstructorKind::Base }; // [[ConstructorKind]]
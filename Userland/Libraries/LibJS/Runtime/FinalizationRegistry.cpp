@@ -43,7 +43,7 @@ void FinalizationRegistry::remove_dead_cells(Badge<Heap>)
 {
     auto any_cells_were_removed = false;
     for (auto& record : m_records) {
-        if (!record.target || record.target->state() == Cell::State::Live)
+        if (!record.target || !is_dead(*record.target))
             continue;
         record.target = nullptr;
         any_cells_were_removed = true;
@@ -59,4 +59,7 @@ private:
 template<>
 inline bool Environment::fast_is<FunctionEnvironment>() const { return is_function_environment(); }
 
+template<>
+inline constexpr bool can_be_swept_lazily<FunctionEnvironment> = true;
+
 }
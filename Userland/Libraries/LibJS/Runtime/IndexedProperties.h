@@ -60,6 +60,8 @@ public:
     virtual bool is_simple_storage() const override { return true; }
     const Vector<Value>& elements() const { return m_packed_elements; }
 
+    Value* element_if_present(u32 index) { return has_index(index) ? &m_packed_elements[index] : nullptr; }
+
 private:
     friend GenericIndexedPropertyStorage;
 
@@ -124,6 +126,16 @@ public:
 
     bool has_index(u32 index) const { return m_storage ? m_storage->has_index(index) : false; }
     Optional<ValueAndAttributes> get(u32 index) const;
+
+    // Elements in simple storage are always data properties with default attributes, so they can be
+    // read and overwritten in place without going through property descriptors.
+    Value* simple_element(u32 index)
+    {
+        if (!m_storage || !m_storage->is_simple_storage())
+            return nullptr;
+        return static_cast<SimpleIndexedPropertyStorage&>(*m_storage).element_if_present(index);
+    }
+    Value const* simple_element(u32 index) const { return const_cast<IndexedProperties*>(this)->simple_element(index); }
     void put(u32 index, Value value, PropertyAttributes attributes = default_attributes);
     void remove(u32 index);
 
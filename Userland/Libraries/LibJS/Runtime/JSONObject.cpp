@@ -399,10 +399,10 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
     auto string = TRY(vm.argument(0).to_string(global_object));
     auto reviver = vm.argument(1);
 
-    auto json = JsonValue::from_string(string);
+    auto json = parse_json(global_object, string);
     if (json.is_error())
         return vm.throw_completion<SyntaxError>(global_object, ErrorType::JsonMalformed);
-    Value unfiltered = parse_json_value(global_object, json.value());
+    Value unfiltered = json.release_value();
     if (reviver.is_function()) {
         auto* root = Object::create(global_object, global_object.object_prototype());
         auto root_name = String::empty();
@@ -450,6 +450,71 @@ Array* JSONObject::parse_json_array(GlobalObject& global_object, const JsonArray
     return array;
 }
 
+// NOTE: This builds the JS values straight from the tokens, without going through a JsonValue tree first.
+ErrorOr<Value> JSONObject::parse_json(GlobalObject& global_object, StringView text)
+{
+    JsonPullParser parser(text);
+    auto value = TRY(parse_json_value(global_object, parser, TRY(parser.next())));
+    // This fails if there's anything but whitespace after the value.
+    TRY(parser.next());
+    return value;
+}
+
+ErrorOr<Value> JSONObject::parse_json_value(GlobalObject& global_object, JsonPullParser& parser, JsonPullParser::Token token)
+{
+    switch (token) {
+    case JsonPullParser::Token::ObjectStart:
+        return Value(TRY(parse_json_object(global_object, parser)));
+    case JsonPullParser::Token::ArrayStart:
+        return Value(TRY(parse_json_array(global_object, parser)));
+    case JsonPullParser::Token::String:
+        return js_string(global_object.heap(), String(parser.string()));
+    case JsonPullParser::Token::Number:
+        return parse_json_value(global_object, parser.number());
+    case JsonPullParser::Token::True:
+        return Value(true);
+    case JsonPullParser::Token::False:
+        return Value(false);
+    case JsonPullParser::Token::Null:
+        return js_null();
+    case JsonPullParser::Token::ObjectEnd:
+    case JsonPullParser::Token::ArrayEnd:
+    case JsonPullParser::Token::Key:
+    case JsonPullParser::Token::End:
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+ErrorOr<Object*> JSONObject::parse_json_object(GlobalObject& global_object, JsonPullParser& parser)
+{
+    auto* object = Object::create(global_object, global_object.object_prototype());
+    for (;;) {
+        auto token = TRY(parser.next());
+        if (token == JsonPullParser::Token::ObjectEnd)
+            break;
+        VERIFY(token == JsonPullParser::Token::Key);
+        auto key = String(parser.string());
+        auto value = TRY(parse_json_value(global_object, parser, TRY(parser.next())));
+        object->define_direct_property(key, value, JS::default_attributes);
+    }
+    return object;
+}
+
+ErrorOr<Array*> JSONObject::parse_json_array(GlobalObject& global_object, JsonPullParser& parser)
+{
+    auto* array = MUST(Array::create(global_object, 0));
+    size_t index = 0;
+    for (;;) {
+        auto token = TRY(parser.next());
+        if (token == JsonPullParser::Token::ArrayEnd)
+            break;
+        auto value = TRY(parse_json_value(global_object, parser, token));
+        array->define_direct_property(index++, value, JS::default_attributes);
+    }
+    return array;
+}
+
 // 25.5.1.1 InternalizeJSONProperty ( holder, name, reviver ), https://tc39.es/ecma262/#sec-internalizejsonproperty
 ThrowCompletionOr<Value> JSONObject::internalize_json_property(GlobalObject& global_object, Object* holder, PropertyKey const& name, FunctionObject& reviver)
 {
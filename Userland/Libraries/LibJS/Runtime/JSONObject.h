@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/JsonPullParser.h>
 #include <LibJS/Runtime/Object.h>
 
 namespace JS {
@@ -42,6 +43,10 @@ private:
     // Parse helpers
     static Object* parse_json_object(GlobalObject&, const JsonObject&);
     static Array* parse_json_array(GlobalObject&, const JsonArray&);
+    static ErrorOr<Value> parse_json(GlobalObject&, StringView);
+    static ErrorOr<Value> parse_json_value(GlobalObject&, JsonPullParser&, JsonPullParser::Token);
+    static ErrorOr<Object*> parse_json_object(GlobalObject&, JsonPullParser&);
+    static ErrorOr<Array*> parse_json_array(GlobalObject&, JsonPullParser&);
     static ThrowCompletionOr<Value> internalize_json_property(GlobalObject&, Object* holder, PropertyKey const& name, FunctionObject& reviver);
 
     JS_DECLARE_NATIVE_FUNCTION(stringify);
@@ -740,6 +740,12 @@ ThrowCompletionOr<Value> Object::internal_get(PropertyKey const& property_key, V
     // 1. Assert: IsPropertyKey(P) is true.
     VERIFY(property_key.is_valid());
 
+    // NOTE: Fast path for elements in simple storage, which are always plain data properties.
+    if (property_key.is_number() && !may_interfere_with_property_lookup_caching()) {
+        if (auto const* element = m_indexed_properties.simple_element(property_key.as_number()))
+            return *element;
+    }
+
     // 2. Let desc be ? O.[[GetOwnProperty]](P).
     auto descriptor = TRY(internal_get_own_property(property_key));
 
@@ -783,6 +789,15 @@ ThrowCompletionOr<bool> Object::internal_set(PropertyKey const& property_key, Va
     // 1. Assert: IsPropertyKey(P) is true.
     VERIFY(property_key.is_valid());
 
+    // NOTE: Fast path for overwriting an existing element in simple storage. Such an element is a writable data
+    //       property, so OrdinarySetWithOwnDescriptor would end up replacing its value in place as well.
+    if (property_key.is_number() && receiver.is_object() && &receiver.as_object() == this && !may_interfere_with_property_lookup_caching()) {
+        if (auto* element = m_indexed_properties.simple_element(property_key.as_number())) {
+            *element = value;
+            return true;
+        }
+    }
+
     // 2. Let ownDesc be ? O.[[GetOwnProperty]](P).
     auto own_descriptor = TRY(internal_get_own_property(property_key));
 
@@ -166,10 +166,16 @@ public:
     bool has_parameter_map() const { return m_has_parameter_map; }
     void set_has_parameter_map() { m_has_parameter_map = true; }
 
+    // Objects with exotic property access (proxies, typed arrays, host objects, ...) set this flag so that
+    // the bytecode interpreter's property lookup caches never bypass their [[Get]] and [[Set]] overrides.
+    bool may_interfere_with_property_lookup_caching() const { return m_may_interfere_with_property_lookup_caching; }
+    void set_may_interfere_with_property_lookup_caching() { m_may_interfere_with_property_lookup_caching = true; }
+
     virtual const char* class_name() const override { return "Object"; }
     virtual void visit_edges(Cell::Visitor&) override;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value) { m_storage[index] = value; }
 
     const IndexedProperties& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
@@ -209,6 +215,11 @@ private:
     Vector<Value> m_storage;
     IndexedProperties m_indexed_properties;
     OwnPtr<Vector<PrivateElement>> m_private_elements; // [[PrivateElements]]
+
+    bool m_may_interfere_with_property_lookup_caching { false };
 };
 
+template<>
+inline constexpr bool can_be_swept_lazily<Object> = true;
+
 }
@@ -5,7 +5,9 @@
  */
 
 #include <AK/CharacterTypes.h>
+#include <AK/StringBuilder.h>
 #include <AK/Utf16View.h>
+#include <AK/Utf8View.h>
 #include <LibJS/Runtime/AbstractOperations.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/PrimitiveString.h>
@@ -27,13 +29,116 @@ PrimitiveString::PrimitiveString(Utf16String string)
 {
 }
 
+PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
+    : m_is_rope(true)
+    , m_lhs(&lhs)
+    , m_rhs(&rhs)
+{
+}
+
 PrimitiveString::~PrimitiveString()
 {
-    vm().string_cache().remove(m_utf8_string);
+    if (!m_has_utf8_string)
+        return;
+    // Only strings created through js_string(String) are in the cache, so make sure we don't evict someone else.
+    auto& string_cache = vm().string_cache();
+    if (auto it = string_cache.find(m_utf8_string); it != string_cache.end() && it->value == this)
+        string_cache.remove(it);
+}
+
+void PrimitiveString::visit_edges(Cell::Visitor& visitor)
+{
+    Cell::visit_edges(visitor);
+    visitor.visit(m_lhs);
+    visitor.visit(m_rhs);
+}
+
+bool PrimitiveString::is_empty() const
+{
+    // Ropes are never built from empty strings, see js_rope_string().
+    if (m_is_rope)
+        return false;
+    if (m_has_utf16_string)
+        return m_utf16_string.is_empty();
+    return m_utf8_string.is_empty();
+}
+
+// Appends a piece of a string, combining a high surrogate at the end of the builder and a low surrogate
+// at the start of the piece into one code point, as they would be if the strings were joined in UTF-16.
+static void append_joining_surrogates(StringBuilder& builder, StringView piece)
+{
+    auto current = builder.string_view();
+
+    // Surrogates encoded as UTF-8 are 3 bytes.
+    if (current.length() >= 3 && piece.length() >= 3
+        && (static_cast<u8>(current[current.length() - 3]) & 0xf0) == 0xe0
+        && (static_cast<u8>(piece[0]) & 0xf0) == 0xe0) {
+        auto high_surrogate = *Utf8View(current.substring_view(current.length() - 3)).begin();
+        auto low_surrogate = *Utf8View(piece).begin();
+
+        if (Utf16View::is_high_surrogate(high_surrogate) && Utf16View::is_low_surrogate(low_surrogate)) {
+            builder.trim(3);
+            builder.append_code_point(Utf16View::decode_surrogate_pair(high_surrogate, low_surrogate));
+            builder.append(piece.substring_view(3));
+            return;
+        }
+    }
+
+    builder.append(piece);
+}
+
+void PrimitiveString::resolve_rope_if_needed() const
+{
+    if (!m_is_rope)
+        return;
+
+    // NOTE: The rope is walked without recursion, since a long chain of concatenations
+    //       makes for a very deep tree.
+    Vector<PrimitiveString const*> pieces;
+    Vector<PrimitiveString const*> stack;
+    stack.append(m_rhs);
+    stack.append(m_lhs);
+    bool all_pieces_have_utf16_string = true;
+    while (!stack.is_empty()) {
+        auto const* current = stack.take_last();
+        if (current->m_is_rope) {
+            stack.append(current->m_rhs);
+            stack.append(current->m_lhs);
+            continue;
+        }
+        all_pieces_have_utf16_string &= current->m_has_utf16_string;
+        pieces.append(current);
+    }
+
+    if (all_pieces_have_utf16_string) {
+        size_t length = 0;
+        for (auto const* piece : pieces)
+            length += piece->m_utf16_string.length_in_code_units();
+
+        Vector<u16, 1> combined;
+        combined.ensure_capacity(length);
+        for (auto const* piece : pieces)
+            combined.extend(piece->m_utf16_string.string());
+
+        m_utf16_string = Utf16String(move(combined));
+        m_has_utf16_string = true;
+    } else {
+        StringBuilder builder;
+        for (auto const* piece : pieces)
+            append_joining_surrogates(builder, piece->string());
+
+        m_utf8_string = builder.to_string();
+        m_has_utf8_string = true;
+    }
+
+    m_is_rope = false;
+    m_lhs = nullptr;
+    m_rhs = nullptr;
 }
 
 String const& PrimitiveString::string() const
 {
+    resolve_rope_if_needed();
     if (!m_has_utf8_string) {
         m_utf8_string = m_utf16_string.to_utf8();
         m_has_utf8_string = true;
@@ -43,6 +148,7 @@ String const& PrimitiveString::string() const
 
 Utf16String const& PrimitiveString::utf16_string() const
 {
+    resolve_rope_if_needed();
     if (!m_has_utf16_string) {
         m_utf16_string = Utf16String(m_utf8_string);
         m_has_utf16_string = true;
@@ -130,4 +236,13 @@ PrimitiveString* js_string(VM& vm, String string)
     return js_string(vm.heap(), move(string));
 }
 
+PrimitiveString* js_rope_string(VM& vm, PrimitiveString& lhs, PrimitiveString& rhs)
+{
+    if (lhs.is_empty())
+        return &rhs;
+    if (rhs.is_empty())
+        return &lhs;
+    return vm.heap().allocate_without_global_object<PrimitiveString>(lhs, rhs);
+}
+
 }
@@ -25,6 +25,7 @@ ProxyObject::ProxyObject(Object& target, Object& handler, Object& prototype)
     , m_target(target)
     , m_handler(handler)
 {
+    set_may_interfere_with_property_lookup_caching();
 }
 
 ProxyObject::~ProxyObject()
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
 #include <LibJS/Heap/DeferGC.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/Shape.h>
@@ -16,10 +17,8 @@ Shape* Shape::create_unique_clone() const
     auto* new_shape = heap().allocate_without_global_object<Shape>(*m_global_object);
     new_shape->m_unique = true;
     new_shape->m_prototype = m_prototype;
-    ensure_property_table();
-    new_shape->ensure_property_table();
-    (*new_shape->m_property_table) = *m_property_table;
-    new_shape->m_property_count = new_shape->m_property_table->size();
+    new_shape->m_property_table = copy_of_property_table();
+    new_shape->m_property_count = new_shape->m_property_table->entries.size();
     return new_shape;
 }
 
@@ -129,7 +128,7 @@ void Shape::visit_edges(Cell::Visitor& visitor)
     visitor.visit(m_previous);
     m_property_key.visit_edges(visitor);
     if (m_property_table) {
-        for (auto& it : *m_property_table)
+        for (auto& it : m_property_table->entries)
             it.key.visit_edges(visitor);
     }
 }
@@ -138,25 +137,22 @@ Optional<PropertyMetadata> Shape::lookup(const StringOrSymbol& property_key) con
 {
     if (m_property_count == 0)
         return {};
-    auto property = property_table().get(property_key);
-    if (!property.has_value())
+    ensure_property_table();
+    auto property = m_property_table->entries.get(property_key);
+    if (!property.has_value() || property->offset >= m_property_count)
         return {};
     return property;
 }
 
-FLATTEN HashMap<StringOrSymbol, PropertyMetadata> const& Shape::property_table() const
-{
-    ensure_property_table();
-    return *m_property_table;
-}
-
 Vector<Shape::Property> Shape::property_table_ordered() const
 {
     auto vec = Vector<Shape::Property>();
     vec.resize(property_count());
 
-    for (auto& it : property_table()) {
-        vec[it.value.offset] = { it.key, it.value };
+    ensure_property_table();
+    for (auto& it : m_property_table->entries) {
+        if (it.value.offset < m_property_count)
+            vec[it.value.offset] = { it.key, it.value };
     }
 
     return vec;
@@ -166,21 +162,36 @@ void Shape::ensure_property_table() const
 {
     if (m_property_table)
         return;
-    m_property_table = make<HashMap<StringOrSymbol, PropertyMetadata>>();
-
-    u32 next_offset = 0;
 
+    Shape const* shape_with_property_table = nullptr;
     Vector<const Shape*, 64> transition_chain;
     for (auto* shape = m_previous; shape; shape = shape->m_previous) {
         if (shape->m_property_table) {
-            *m_property_table = *shape->m_property_table;
-            next_offset = shape->m_property_count;
+            shape_with_property_table = shape;
             break;
         }
         transition_chain.append(shape);
     }
     transition_chain.append(this);
 
+    u32 next_offset = 0;
+    if (shape_with_property_table) {
+        next_offset = shape_with_property_table->m_property_count;
+
+        // We can keep appending to the previous table, unless someone else already did (i.e. we're on a
+        // different branch of the transition tree), or we'd have to change one of its existing entries.
+        bool can_share_property_table = !shape_with_property_table->m_unique
+            && shape_with_property_table->m_property_table->entries.size() == next_offset
+            && all_of(transition_chain, [](auto* shape) { return shape->m_transition_type != TransitionType::Configure; });
+
+        if (can_share_property_table)
+            m_property_table = shape_with_property_table->m_property_table;
+        else
+            m_property_table = shape_with_property_table->copy_of_property_table();
+    } else {
+        m_property_table = adopt_ref(*new PropertyTable);
+    }
+
     for (ssize_t i = transition_chain.size() - 1; i >= 0; --i) {
         auto* shape = transition_chain[i];
         if (!shape->m_property_key.is_valid()) {
@@ -188,21 +199,41 @@ void Shape::ensure_property_table() const
             continue;
         }
         if (shape->m_transition_type == TransitionType::Put) {
-            m_property_table->set(shape->m_property_key, { next_offset++, shape->m_attributes });
+            m_property_table->entries.set(shape->m_property_key, { next_offset++, shape->m_attributes });
         } else if (shape->m_transition_type == TransitionType::Configure) {
-            auto it = m_property_table->find(shape->m_property_key);
-            VERIFY(it != m_property_table->end());
+            auto it = m_property_table->entries.find(shape->m_property_key);
+            VERIFY(it != m_property_table->entries.end());
             it->value.attributes = shape->m_attributes;
         }
     }
 }
 
+void Shape::ensure_property_table_is_exclusive()
+{
+    ensure_property_table();
+    if (m_property_table->ref_count() == 1 && m_property_table->entries.size() == m_property_count)
+        return;
+    m_property_table = copy_of_property_table();
+}
+
+NonnullRefPtr<Shape::PropertyTable> Shape::copy_of_property_table() const
+{
+    ensure_property_table();
+    auto property_table = adopt_ref(*new PropertyTable);
+    property_table->entries.ensure_capacity(m_property_count);
+    for (auto& it : m_property_table->entries) {
+        if (it.value.offset < m_property_count)
+            property_table->entries.set(it.key, it.value);
+    }
+    return property_table;
+}
+
 void Shape::add_property_to_unique_shape(const StringOrSymbol& property_key, PropertyAttributes attributes)
 {
     VERIFY(is_unique());
     VERIFY(m_property_table);
-    VERIFY(!m_property_table->contains(property_key));
-    m_property_table->set(property_key, { static_cast<u32>(m_property_table->size()), attributes });
+    VERIFY(!m_property_table->entries.contains(property_key));
+    m_property_table->entries.set(property_key, { static_cast<u32>(m_property_table->entries.size()), attributes });
 
     VERIFY(m_property_count < NumericLimits<u32>::max());
     ++m_property_count;
@@ -212,19 +243,19 @@ void Shape::reconfigure_property_in_unique_shape(const StringOrSymbol& property_
 {
     VERIFY(is_unique());
     VERIFY(m_property_table);
-    auto it = m_property_table->find(property_key);
-    VERIFY(it != m_property_table->end());
+    auto it = m_property_table->entries.find(property_key);
+    VERIFY(it != m_property_table->entries.end());
     it->value.attributes = attributes;
-    m_property_table->set(property_key, it->value);
+    m_property_table->entries.set(property_key, it->value);
 }
 
 void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_key, size_t offset)
 {
     VERIFY(is_unique());
     VERIFY(m_property_table);
-    if (m_property_table->remove(property_key))
+    if (m_property_table->entries.remove(property_key))
         --m_property_count;
-    for (auto& it : *m_property_table) {
+    for (auto& it : m_property_table->entries) {
         VERIFY(it.value.offset != offset);
         if (it.value.offset > offset)
             --it.value.offset;
@@ -234,8 +265,8 @@ void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_key
 void Shape::add_property_without_transition(StringOrSymbol const& property_key, PropertyAttributes attributes)
 {
     VERIFY(property_key.is_valid());
-    ensure_property_table();
-    if (m_property_table->set(property_key, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry) {
+    ensure_property_table_is_exclusive();
+    if (m_property_table->entries.set(property_key, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry) {
         VERIFY(m_property_count < NumericLimits<u32>::max());
         ++m_property_count;
     }
@@ -8,6 +8,8 @@
 
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
 #include <LibJS/Forward.h>
@@ -69,7 +71,6 @@ public:
     const Object* prototype() const { return m_prototype; }
 
     Optional<PropertyMetadata> lookup(const StringOrSymbol&) const;
-    const HashMap<StringOrSymbol, PropertyMetadata>& property_table() const;
     u32 property_count() const { return m_property_count; }
 
     struct Property {
@@ -92,11 +93,19 @@ private:
     Shape* get_or_prune_cached_forward_transition(TransitionKey const&);
     Shape* get_or_prune_cached_prototype_transition(Object* prototype);
 
+    // NOTE: Shapes along a chain of put transitions share a single property table, which only ever grows at the end.
+    //       Each shape only sees the entries whose offset is below its own property count.
+    struct PropertyTable : public RefCounted<PropertyTable> {
+        HashMap<StringOrSymbol, PropertyMetadata> entries;
+    };
+
     void ensure_property_table() const;
+    void ensure_property_table_is_exclusive();
+    NonnullRefPtr<PropertyTable> copy_of_property_table() const;
 
     Object* m_global_object { nullptr };
 
-    mutable OwnPtr<HashMap<StringOrSymbol, PropertyMetadata>> m_property_table;
+    mutable RefPtr<PropertyTable> m_property_table;
 
     OwnPtr<HashMap<TransitionKey, WeakPtr<Shape>>> m_forward_transitions;
     OwnPtr<HashMap<Object*, WeakPtr<Shape>>> m_prototype_transitions;
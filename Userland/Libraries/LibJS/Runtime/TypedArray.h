@@ -61,6 +61,7 @@ protected:
     explicit TypedArrayBase(Object& prototype)
         : Object(prototype)
     {
+        set_may_interfere_with_property_lookup_caching();
     }
 
     u32 m_array_length { 0 };
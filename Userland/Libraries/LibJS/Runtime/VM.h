@@ -11,6 +11,7 @@
 #include <AK/FlyString.h>
 #include <AK/Function.h>
 #include <AK/HashMap.h>
+#include <AK/Queue.h>
 #include <AK/RefCounted.h>
 #include <AK/StackInfo.h>
 #include <AK/Variant.h>
@@ -255,7 +256,7 @@ private:
 
     HashMap<String, Symbol*> m_global_symbol_map;
 
-    Vector<Function<ThrowCompletionOr<Value>()>> m_promise_jobs;
+    Queue<Function<ThrowCompletionOr<Value>()>> m_promise_jobs;
 
     Vector<FinalizationRegistry*> m_finalization_registry_cleanup_jobs;
 
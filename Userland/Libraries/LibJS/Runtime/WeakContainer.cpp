@@ -5,6 +5,7 @@
  */
 
 #include <LibJS/Heap/Heap.h>
+#include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Runtime/WeakContainer.h>
 
 namespace JS {
@@ -28,4 +29,11 @@ void WeakContainer::deregister()
     m_registered = false;
 }
 
+bool WeakContainer::is_dead(Cell const& cell)
+{
+    if (cell.state() != Cell::State::Live)
+        return true;
+    return HeapBlock::from_cell(&cell)->needs_lazy_sweep() && !cell.is_marked();
+}
+
 }
@@ -21,6 +21,9 @@ public:
 protected:
     void deregister();
 
+    // NOTE: Cells that are waiting to be swept lazily are still in the Live state, so use this instead of looking at Cell::state().
+    static bool is_dead(Cell const&);
+
 private:
     bool m_registered { true };
     Heap& m_heap;
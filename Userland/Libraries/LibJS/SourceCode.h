@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/String.h>
+
+namespace JS {
+
+// The complete source code that was handed to a Parser, kept alive by whatever still needs to refer back to parts of it.
+class SourceCode : public RefCounted<SourceCode> {
+public:
+    static NonnullRefPtr<SourceCode> create(String code)
+    {
+        return adopt_ref(*new SourceCode(move(code)));
+    }
+
+    String const& code() const { return m_code; }
+
+private:
+    explicit SourceCode(String code)
+        : m_code(move(code))
+    {
+    }
+
+    String m_code;
+};
+
+// The source text of a function or class. Most of them never have their source text looked at,
+// so it's only copied out of the SourceCode the first time someone asks for it.
+class SourceText {
+public:
+    SourceText() = default;
+
+    SourceText(String string)
+        : m_string(move(string))
+    {
+    }
+
+    SourceText(NonnullRefPtr<SourceCode> source_code, size_t start_offset, size_t end_offset)
+        : m_source_code(move(source_code))
+        , m_start_offset(start_offset)
+        , m_end_offset(end_offset)
+    {
+        VERIFY(m_start_offset <= m_end_offset);
+    }
+
+    String const& string() const
+    {
+        if (m_source_code) {
+            m_string = m_source_code->code().substring(m_start_offset, m_end_offset - m_start_offset);
+            m_source_code = nullptr;
+        }
+        return m_string;
+    }
+
+private:
+    mutable RefPtr<SourceCode> m_source_code;
+    size_t m_start_offset { 0 };
+    size_t m_end_offset { 0 };
+    mutable String m_string { String::empty() };
+};
+
+}
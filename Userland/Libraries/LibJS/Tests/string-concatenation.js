@@ -28,3 +28,21 @@ test("adding strings with dangling surrogates", () => {
     expect("\ud834a" + "\udf06").toBe("\ud834a\udf06");
     expect("\ud834" + "a\udf06").toBe("\ud834a\udf06");
 });
+
+test("adding many strings", () => {
+    let string = "";
+    for (let i = 0; i < 10000; ++i) string += "ab";
+    expect(string).toHaveLength(20000);
+    expect(string.substring(0, 4)).toBe("abab");
+
+    let prepended = "";
+    for (let i = 0; i < 3; ++i) prepended = i + prepended;
+    expect(prepended).toBe("210");
+});
+
+test("adding strings with dangling surrogates across several concatenations", () => {
+    expect("a" + "\ud834" + "\udf06" + "b").toBe("a𝌆b");
+    expect("a" + ("\ud834" + ("\udf06" + "b"))).toBe("a𝌆b");
+    expect("\ud834" + "\udf06" + "\udf06").toBe("𝌆\udf06");
+    expect("\ud834".padEnd(2, "\ud834") + "\udf06").toBe("\ud834𝌆");
+});
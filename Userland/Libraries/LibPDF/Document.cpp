@@ -74,18 +74,18 @@ u32 Document::get_first_page_index() const
 
 u32 Document::get_page_count() const
 {
-    return m_page_object_indices.size();
+    return m_page_count;
 }
 
 PDFErrorOr<Page> Document::get_page(u32 index)
 {
-    VERIFY(index < m_page_object_indices.size());
+    VERIFY(index < m_page_count);
 
     auto cached_page = m_pages.get(index);
     if (cached_page.has_value())
         return cached_page.value();
 
-    auto page_object_index = m_page_object_indices[index];
+    auto page_object_index = TRY(find_page_object_index(index));
     auto page_object = TRY(get_or_load_value(page_object_index));
     auto raw_page_object = TRY(resolve_to<DictObject>(page_object));
 
@@ -153,35 +153,73 @@ PDFErrorOr<Value> Document::resolve(Value const& value)
 
 PDFErrorOr<void> Document::build_page_tree()
 {
-    auto page_tree = TRY(m_catalog->get_dict(this, CommonNames::Pages));
-    return add_page_tree_node_to_page_tree(page_tree);
+    m_page_tree = TRY(m_catalog->get_dict(this, CommonNames::Pages));
+    auto page_count = m_page_tree->get(CommonNames::Count).value().get<int>();
+    if (page_count < 0)
+        return Error { Error::Type::MalformedPDF, "Negative page count" };
+    m_page_count = page_count;
+    return {};
 }
 
-PDFErrorOr<void> Document::add_page_tree_node_to_page_tree(NonnullRefPtr<DictObject> const& page_tree)
+PDFErrorOr<u32> Document::find_page_object_index(u32 page_index)
 {
-    auto kids_array = TRY(page_tree->get_array(this, CommonNames::Kids));
-    auto page_count = page_tree->get(CommonNames::Count).value().get<int>();
-
-    if (static_cast<size_t>(page_count) != kids_array->elements().size()) {
-        // This page tree contains child page trees, so we recursively add
-        // these pages to the overall page tree
+    if (auto object_index = m_page_object_indices.get(page_index); object_index.has_value())
+        return object_index.value();
+
+    NonnullRefPtr<DictObject> page_tree = *m_page_tree;
+    u32 index_in_page_tree = page_index;
+
+    while (true) {
+        auto kids_array = TRY(page_tree->get_array(this, CommonNames::Kids));
+        auto page_count = page_tree->get(CommonNames::Count).value().get<int>();
+
+        if (static_cast<size_t>(page_count) == kids_array->elements().size()) {
+            // We know all of the kids are leaf nodes
+            if (index_in_page_tree >= kids_array->elements().size())
+                break;
+            auto object_index = kids_array->at(index_in_page_tree).as_ref_index();
+            m_page_object_indices.set(page_index, object_index);
+            return object_index;
+        }
 
+        // This page tree contains child page trees, so we skip over the ones before the page
+        RefPtr<DictObject> child_page_tree;
         for (auto& value : *kids_array) {
             auto reference_index = value.as_ref_index();
-            auto maybe_page_tree_node = TRY(m_parser->conditionally_parse_page_tree_node(reference_index));
-            if (maybe_page_tree_node) {
-                TRY(add_page_tree_node_to_page_tree(maybe_page_tree_node.release_nonnull()));
-            } else {
-                m_page_object_indices.append(reference_index);
+            auto maybe_page_tree_node = TRY(get_or_load_page_tree_node(reference_index));
+            if (!maybe_page_tree_node) {
+                if (index_in_page_tree == 0) {
+                    m_page_object_indices.set(page_index, reference_index);
+                    return reference_index;
+                }
+                --index_in_page_tree;
+                continue;
+            }
+
+            auto child_page_count = static_cast<u32>(maybe_page_tree_node->get(CommonNames::Count).value().get<int>());
+            if (index_in_page_tree < child_page_count) {
+                child_page_tree = move(maybe_page_tree_node);
+                break;
             }
+            index_in_page_tree -= child_page_count;
         }
-    } else {
-        // We know all of the kids are leaf nodes
-        for (auto& value : *kids_array)
-            m_page_object_indices.append(value.as_ref_index());
+
+        if (!child_page_tree)
+            break;
+        page_tree = child_page_tree.release_nonnull();
     }
 
-    return {};
+    return Error { Error::Type::MalformedPDF, String::formatted("Page {} is missing from the page tree", page_index) };
+}
+
+PDFErrorOr<RefPtr<DictObject>> Document::get_or_load_page_tree_node(u32 object_index)
+{
+    if (auto page_tree_node = m_page_tree_nodes.get(object_index); page_tree_node.has_value())
+        return page_tree_node.value();
+
+    auto page_tree_node = TRY(m_parser->conditionally_parse_page_tree_node(object_index));
+    m_page_tree_nodes.set(object_index, page_tree_node);
+    return page_tree_node;
 }
 
 PDFErrorOr<void> Document::build_outline()
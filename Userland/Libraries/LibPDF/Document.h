@@ -122,14 +122,13 @@ public:
 private:
     explicit Document(NonnullRefPtr<Parser> const& parser);
 
-    // FIXME: Currently, to improve performance, we don't load any pages at Document
-    // construction, rather we just load the page structure and populate
-    // m_page_object_indices. However, we can be even lazier and defer page tree node
-    // parsing, as good PDF writers will layout the page tree in a balanced tree to
-    // improve lookup time. This would reduce the initial overhead by not loading
-    // every page tree node of, say, a 1000+ page PDF file.
+    // Only the root of the page tree is loaded at Document construction. The page tree nodes leading to
+    // a page are loaded when the page is first asked for, skipping over the subtrees before it by their
+    // /Count, so opening a large PDF file doesn't have to touch every one of its page tree nodes.
     PDFErrorOr<void> build_page_tree();
-    PDFErrorOr<void> add_page_tree_node_to_page_tree(NonnullRefPtr<DictObject> const& page_tree);
+    PDFErrorOr<u32> find_page_object_index(u32 page_index);
+    // Returns null if the object is a page rather than a page tree node.
+    PDFErrorOr<RefPtr<DictObject>> get_or_load_page_tree_node(u32 object_index);
 
     PDFErrorOr<void> build_outline();
     PDFErrorOr<NonnullRefPtr<OutlineItem>> build_outline_item(NonnullRefPtr<DictObject> const& outline_item_dict);
@@ -139,7 +138,10 @@ private:
 
     NonnullRefPtr<Parser> m_parser;
     RefPtr<DictObject> m_catalog;
-    Vector<u32> m_page_object_indices;
+    RefPtr<DictObject> m_page_tree;
+    u32 m_page_count { 0 };
+    HashMap<u32, u32> m_page_object_indices;
+    HashMap<u32, RefPtr<DictObject>> m_page_tree_nodes;
     HashMap<u32, Page> m_pages;
     HashMap<u32, Value> m_values;
     RefPtr<OutlineDict> m_outline;
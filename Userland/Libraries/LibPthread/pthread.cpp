@@ -94,6 +94,7 @@ static int create_thread(pthread_t* thread, void* (*entry)(void*), void* argumen
 [[noreturn]] static void exit_thread(void* code, void* stack_location, size_t stack_size)
 {
     __pthread_key_destroy_for_current_thread();
+    __malloc_flush_thread_cache();
     syscall(SC_exit_thread, code, stack_location, stack_size);
     VERIFY_NOT_REACHED();
 }
@@ -217,6 +218,7 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
 int pthread_mutexattr_init(pthread_mutexattr_t* attr)
 {
     attr->type = PTHREAD_MUTEX_NORMAL;
+    attr->protocol = PTHREAD_PRIO_NONE;
     return 0;
 }
 
@@ -243,6 +245,25 @@ int pthread_mutexattr_gettype(pthread_mutexattr_t* attr, int* type)
     return 0;
 }
 
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_mutexattr_setprotocol.html
+int pthread_mutexattr_setprotocol(pthread_mutexattr_t* attr, int protocol)
+{
+    if (!attr)
+        return EINVAL;
+    // NOTE: PTHREAD_PRIO_PROTECT is not supported.
+    if (protocol != PTHREAD_PRIO_NONE && protocol != PTHREAD_PRIO_INHERIT)
+        return ENOTSUP;
+    attr->protocol = protocol;
+    return 0;
+}
+
+// https://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_mutexattr_getprotocol.html
+int pthread_mutexattr_getprotocol(pthread_mutexattr_t const* attr, int* protocol)
+{
+    *protocol = attr->protocol;
+    return 0;
+}
+
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_attr_init.html
 int pthread_attr_init(pthread_attr_t* attributes)
 {
@@ -477,14 +498,22 @@ int pthread_attr_setscope([[maybe_unused]] pthread_attr_t* attributes, [[maybe_u
 }
 
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_getschedparam.html
-int pthread_getschedparam([[maybe_unused]] pthread_t thread, [[maybe_unused]] int* policy, [[maybe_unused]] struct sched_param* param)
+int pthread_getschedparam(pthread_t thread, int* policy, struct sched_param* param)
 {
+    int rc = sched_getscheduler(thread);
+    if (rc < 0)
+        return errno;
+    *policy = rc;
+    if (sched_getparam(thread, param) < 0)
+        return errno;
     return 0;
 }
 
 // https://pubs.opengroup.org/onlinepubs/009695399/functions/pthread_setschedparam.html
-int pthread_setschedparam([[maybe_unused]] pthread_t thread, [[maybe_unused]] int policy, [[maybe_unused]] const struct sched_param* param)
+int pthread_setschedparam(pthread_t thread, int policy, const struct sched_param* param)
 {
+    if (sched_setscheduler(thread, policy, param) < 0)
+        return errno;
     return 0;
 }
 
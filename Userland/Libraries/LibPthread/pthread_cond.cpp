@@ -152,6 +152,13 @@ int pthread_cond_broadcast(pthread_cond_t* cond)
     pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
     VERIFY(mutex);
 
+    // Threads waiting on a priority inheritance mutex have to go through FUTEX_LOCK_PI, so they can't be requeued onto it.
+    if (mutex->protocol == PTHREAD_PRIO_INHERIT) {
+        int rc = futex_wake(&cond->value, INT_MAX);
+        VERIFY(rc >= 0);
+        return 0;
+    }
+
     int rc = futex(&cond->value, FUTEX_REQUEUE, 1, nullptr, &mutex->lock, INT_MAX);
     VERIFY(rc >= 0);
     return 0;
@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RegexDFA.h"
+#include <AK/CharacterTypes.h>
+
+namespace regex {
+
+static bool is_word_character(u32 ch)
+{
+    return is_ascii_alphanumeric(ch) || ch == '_';
+}
+
+// The comparisons look at a character in two ways: as the first code unit of a one character substring, and as the
+// code point at its code unit offset. Both halves of a symbol are the same, except for a Utf8View or a Utf16View
+// outside of Unicode mode, where a code unit might be half a code point.
+static u64 make_symbol(u32 code_unit, u32 code_point)
+{
+    return (static_cast<u64>(code_unit) << 32) | code_point;
+}
+
+static u64 symbol_at(RegexStringView const& view, MatchState const& position, size_t& code_units)
+{
+    if (view.unicode()) {
+        auto code_point = view[position.string_position_in_code_units];
+        code_units = view.length_of_code_point(code_point);
+        return make_symbol(code_point, code_point);
+    }
+
+    code_units = 1;
+    auto code_point = view[position.string_position_in_code_units];
+    if (view.is_string_view())
+        return make_symbol(code_point, code_point);
+    return make_symbol(view.substring_view(position.string_position, 1)[0], code_point);
+}
+
+OwnPtr<LazyDFA> LazyDFA::try_create(ByteCode const& bytecode)
+{
+    auto dfa = adopt_own(*new LazyDFA);
+
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare:
+            if (!dfa->add_comparison(bytecode, state.instruction_position))
+                return {};
+            break;
+        case OpCodeId::Checkpoint:
+            if (dfa->m_checkpoint_bits.size() == 32)
+                return {};
+            dfa->m_checkpoint_bits.set(state.instruction_position, 1u << dfa->m_checkpoint_bits.size());
+            break;
+        case OpCodeId::CheckBegin:
+        case OpCodeId::CheckEnd:
+        case OpCodeId::CheckBoundary:
+            dfa->m_uses_context = true;
+            break;
+        case OpCodeId::Jump:
+        case OpCodeId::JumpNonEmpty:
+        case OpCodeId::ForkJump:
+        case OpCodeId::ForkStay:
+        // The optimizer only turns forks into these where it doesn't change what matches.
+        case OpCodeId::ForkReplaceJump:
+        case OpCodeId::ForkReplaceStay:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            break;
+        // Lookaround and counted repetition need the state of the VM, and Exit is never emitted.
+        case OpCodeId::FailForks:
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+        case OpCodeId::Repeat:
+        case OpCodeId::ResetRepeat:
+        case OpCodeId::Exit:
+            return {};
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    return dfa;
+}
+
+bool LazyDFA::add_comparison(ByteCode const& bytecode, size_t instruction_position)
+{
+    auto arguments_count = bytecode.at(instruction_position + 1);
+    auto offset = instruction_position + 3;
+
+    for (size_t i = 0; i < arguments_count; ++i) {
+        switch (static_cast<CharacterCompareType>(bytecode.at(offset++))) {
+        case CharacterCompareType::Inverse:
+        case CharacterCompareType::TemporaryInverse:
+        case CharacterCompareType::AnyChar:
+            break;
+        case CharacterCompareType::Char:
+        case CharacterCompareType::CharClass:
+        case CharacterCompareType::CharRange:
+        case CharacterCompareType::Property:
+        case CharacterCompareType::GeneralCategory:
+        case CharacterCompareType::Script:
+        case CharacterCompareType::ScriptExtension:
+            ++offset;
+            break;
+        case CharacterCompareType::LookupTable:
+            offset += bytecode.at(offset) + 1;
+            break;
+        case CharacterCompareType::String: {
+            // Strings are only ever compared on their own, see ByteCode::insert_bytecode_compare_string().
+            if (arguments_count != 1)
+                return false;
+            auto length = bytecode.at(offset++);
+            Vector<u8> string;
+            string.ensure_capacity(length);
+            for (size_t j = 0; j < length; ++j)
+                string.unchecked_append(static_cast<u8>(bytecode.at(offset++)));
+            m_strings.set(instruction_position, move(string));
+            break;
+        }
+        case CharacterCompareType::Reference:
+        case CharacterCompareType::Undefined:
+        case CharacterCompareType::RangeExpressionDummy:
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool LazyDFA::can_match(MatchInput const& input) const
+{
+    // In Unicode mode, the input is indexed by code point, which would make looking at a UTF-8 string quadratic.
+    if (input.view.unicode() && (input.view.is_string_view() || input.view.is_u8_view()))
+        return false;
+
+    // The characters of String comparisons are bytes.
+    if (!m_strings.is_empty() && (input.view.unicode() || !input.view.is_string_view()))
+        return false;
+
+    return true;
+}
+
+void LazyDFA::reset()
+{
+    m_state_set.clear();
+    m_states.clear();
+    m_initial_states.fill(nullptr);
+    ++m_generation;
+}
+
+LazyDFA::State* LazyDFA::find_or_create_state(Vector<Thread>&& threads, u8 context, u32 passed_checkpoints)
+{
+    auto state = make<State>();
+    state->threads = move(threads);
+    state->context = context;
+    state->passed_checkpoints = passed_checkpoints;
+    state->hash = pair_int_hash(context, passed_checkpoints);
+    for (auto& thread : state->threads)
+        state->hash = pair_int_hash(state->hash, pair_int_hash(thread.instruction_position, thread.string_index));
+
+    if (auto it = m_state_set.find(state.ptr()); it != m_state_set.end())
+        return *it;
+
+    if (m_states.size() >= c_max_dfa_states)
+        reset();
+
+    auto* result = state.ptr();
+    m_states.append(move(state));
+    m_state_set.set(result);
+    return result;
+}
+
+LazyDFA::State* LazyDFA::initial_state(MatchInput const& input, MatchState const& position)
+{
+    u8 context = 0;
+    if (m_uses_context) {
+        if (position.string_position == 0) {
+            context = AtStart;
+        } else {
+            auto previous = input.view[position.string_position_in_code_units - 1];
+            if (previous == '\n')
+                context |= AfterNewline;
+            if (is_word_character(previous))
+                context |= AfterWordCharacter;
+        }
+    }
+
+    if (!m_initial_states[context]) {
+        // Nothing has been consumed yet, so none of the Checkpoints have been passed.
+        m_initial_states[context] = find_or_create_state({ Thread {} }, context, 0);
+    }
+    return m_initial_states[context];
+}
+
+bool LazyDFA::follow_threads(ByteCode const& bytecode, MatchInput const& input, State const& state, MatchState const& position, Vector<ConsumingThread>& consuming_threads)
+{
+    struct PendingThread {
+        u32 instruction_position;
+        u32 passed_checkpoints;
+    };
+    Vector<PendingThread> pending_threads;
+    HashTable<u64> visited;
+
+    MatchState opcode_state;
+    opcode_state.string_position = position.string_position;
+    opcode_state.string_position_in_code_units = position.string_position_in_code_units;
+
+    auto follow = [&](size_t instruction_position, u32 passed_checkpoints) {
+        pending_threads.append({ static_cast<u32>(instruction_position), passed_checkpoints });
+    };
+
+    for (auto& thread : state.threads) {
+        if (thread.string_index != 0) {
+            // This one is in the middle of a String comparison, and there's nothing to follow.
+            opcode_state.instruction_position = thread.instruction_position;
+            auto& opcode = bytecode.get_opcode(opcode_state);
+            Thread next { static_cast<u32>(thread.instruction_position + opcode.size()), 0 };
+            if (thread.string_index + 1 < m_strings.find(thread.instruction_position)->value.size())
+                next = { thread.instruction_position, thread.string_index + 1 };
+            consuming_threads.append({ thread, next });
+            continue;
+        }
+
+        // The threads are followed depth-first, the way the VM would try them: the pending thread with the highest
+        // priority is always the last one.
+        follow(thread.instruction_position, state.passed_checkpoints);
+        while (!pending_threads.is_empty()) {
+            auto [instruction_position, passed_checkpoints] = pending_threads.take_last();
+            if (visited.set((static_cast<u64>(instruction_position) << 32) | passed_checkpoints) != AK::HashSetResult::InsertedNewEntry)
+                continue;
+
+            // Running off the end of the bytecode is a match, and everything that has lower priority can be dropped.
+            if (instruction_position >= bytecode.size())
+                return true;
+
+            opcode_state.instruction_position = instruction_position;
+            auto& opcode = bytecode.get_opcode(opcode_state);
+            auto next_instruction_position = instruction_position + opcode.size();
+
+            switch (opcode.opcode_id()) {
+            case OpCodeId::Compare: {
+                Thread next { static_cast<u32>(next_instruction_position), 0 };
+                if (auto string = m_strings.find(instruction_position); string != m_strings.end()) {
+                    if (string->value.is_empty()) {
+                        follow(next_instruction_position, passed_checkpoints);
+                        break;
+                    }
+                    if (string->value.size() > 1)
+                        next = { instruction_position, 1 };
+                }
+                consuming_threads.append({ { instruction_position, 0 }, next });
+                break;
+            }
+            case OpCodeId::Jump:
+                follow(next_instruction_position + static_cast<OpCode_Jump const&>(opcode).offset(), passed_checkpoints);
+                break;
+            case OpCodeId::ForkJump:
+            case OpCodeId::ForkReplaceJump:
+                follow(next_instruction_position, passed_checkpoints);
+                follow(next_instruction_position + static_cast<OpCode_ForkJump const&>(opcode).offset(), passed_checkpoints);
+                break;
+            case OpCodeId::ForkStay:
+            case OpCodeId::ForkReplaceStay:
+                follow(next_instruction_position + static_cast<OpCode_ForkStay const&>(opcode).offset(), passed_checkpoints);
+                follow(next_instruction_position, passed_checkpoints);
+                break;
+            case OpCodeId::JumpNonEmpty: {
+                auto const& jump = static_cast<OpCode_JumpNonEmpty const&>(opcode);
+                auto checkpoint_bit = m_checkpoint_bits.get(next_instruction_position + jump.checkpoint()).value_or(0);
+                if (!(passed_checkpoints & checkpoint_bit)) {
+                    follow(next_instruction_position, passed_checkpoints);
+                    break;
+                }
+                auto target = next_instruction_position + jump.offset();
+                switch (jump.form()) {
+                case OpCodeId::Jump:
+                    follow(target, passed_checkpoints);
+                    break;
+                case OpCodeId::ForkJump:
+                case OpCodeId::ForkReplaceJump:
+                    follow(next_instruction_position, passed_checkpoints);
+                    follow(target, passed_checkpoints);
+                    break;
+                case OpCodeId::ForkStay:
+                case OpCodeId::ForkReplaceStay:
+                    follow(target, passed_checkpoints);
+                    follow(next_instruction_position, passed_checkpoints);
+                    break;
+                default:
+                    follow(next_instruction_position, passed_checkpoints);
+                    break;
+                }
+                break;
+            }
+            case OpCodeId::Checkpoint:
+                follow(next_instruction_position, passed_checkpoints & ~m_checkpoint_bits.get(instruction_position).value());
+                break;
+            case OpCodeId::CheckBegin:
+            case OpCodeId::CheckEnd:
+            case OpCodeId::CheckBoundary:
+                if (opcode.execute(input, opcode_state) == ExecutionResult::Continue)
+                    follow(next_instruction_position, passed_checkpoints);
+                break;
+            case OpCodeId::SaveLeftCaptureGroup:
+            case OpCodeId::SaveRightCaptureGroup:
+            case OpCodeId::SaveRightNamedCaptureGroup:
+            case OpCodeId::ClearCaptureGroup:
+                follow(next_instruction_position, passed_checkpoints);
+                break;
+            default:
+                VERIFY_NOT_REACHED();
+            }
+        }
+    }
+
+    return false;
+}
+
+bool LazyDFA::consumes(ByteCode const& bytecode, MatchInput const& input, ConsumingThread const& thread, MatchState const& position, u64 symbol) const
+{
+    auto instruction_position = thread.thread.instruction_position;
+    if (auto string = m_strings.find(instruction_position); string != m_strings.end()) {
+        u32 ch = symbol >> 32;
+        u32 expected = string->value[thread.thread.string_index];
+        if (input.regex_options & AllFlags::Insensitive)
+            return to_ascii_lowercase(ch) == to_ascii_lowercase(expected);
+        return ch == expected;
+    }
+
+    // Whether a comparison matches only depends on the character, so it's simply run on the input.
+    MatchState state;
+    state.string_position = position.string_position;
+    state.string_position_in_code_units = position.string_position_in_code_units;
+    state.instruction_position = instruction_position;
+    auto& opcode = bytecode.get_opcode(state);
+    return opcode.execute(input, state) == ExecutionResult::Continue;
+}
+
+LazyDFA::Transition LazyDFA::transition(ByteCode const& bytecode, MatchInput const& input, State& state, MatchState const& position, u64 symbol)
+{
+    u32 code_unit = symbol >> 32;
+    u32 code_point = symbol & 0xffffffff;
+    bool is_ascii = code_unit == code_point && code_point < state.ascii_transitions.size();
+
+    if (is_ascii) {
+        if (auto* next = state.ascii_transitions[code_point])
+            return { next, ((state.ascii_accepts[code_point / 64] >> (code_point % 64)) & 1) != 0 };
+    } else if (auto it = state.other_transitions.find(symbol); it != state.other_transitions.end()) {
+        return it->value;
+    }
+
+    Vector<ConsumingThread> consuming_threads;
+    bool accepts = follow_threads(bytecode, input, state, position, consuming_threads);
+
+    Vector<Thread> next_threads;
+    for (auto& thread : consuming_threads) {
+        if (consumes(bytecode, input, thread, position, symbol) && !next_threads.contains_slow(thread.next))
+            next_threads.append(thread.next);
+    }
+
+    u8 context = 0;
+    if (m_uses_context) {
+        if (code_unit == '\n')
+            context |= AfterNewline;
+        if (is_word_character(code_point))
+            context |= AfterWordCharacter;
+    }
+
+    auto generation = m_generation;
+    Transition transition { find_or_create_state(move(next_threads), context, NumericLimits<u32>::max()), accepts };
+
+    // Making room for the new state took all the others with it, including this one.
+    if (generation != m_generation)
+        return transition;
+
+    if (is_ascii) {
+        state.ascii_transitions[code_point] = transition.next;
+        if (accepts)
+            state.ascii_accepts[code_point / 64] |= 1ull << (code_point % 64);
+    } else {
+        state.other_transitions.set(symbol, transition);
+    }
+    return transition;
+}
+
+bool LazyDFA::accepts_at_end(ByteCode const& bytecode, MatchInput const& input, State& state, MatchState const& position)
+{
+    if (!state.accepts_at_end.has_value()) {
+        Vector<ConsumingThread> consuming_threads;
+        state.accepts_at_end = follow_threads(bytecode, input, state, position, consuming_threads);
+    }
+    return *state.accepts_at_end;
+}
+
+bool LazyDFA::match(ByteCode const& bytecode, MatchInput const& input, MatchState& state, size_t& operations)
+{
+    // The transitions depend on the options, since they are taken by running the comparisons.
+    auto options = static_cast<FlagsUnderlyingType>(input.regex_options.value());
+    if (m_options != options) {
+        reset();
+        m_options = options;
+    }
+
+    MatchState position;
+    position.string_position = state.string_position;
+    position.string_position_in_code_units = state.string_position_in_code_units;
+
+    Optional<size_t> match_end;
+    size_t match_end_in_code_units = 0;
+    auto length = input.view.length();
+    auto* current_state = initial_state(input, position);
+
+    for (;;) {
+        ++operations;
+
+        if (position.string_position >= length) {
+            if (accepts_at_end(bytecode, input, *current_state, position)) {
+                match_end = position.string_position;
+                match_end_in_code_units = position.string_position_in_code_units;
+            }
+            break;
+        }
+
+        size_t code_units = 0;
+        auto symbol = symbol_at(input.view, position, code_units);
+        auto transition = this->transition(bytecode, input, *current_state, position, symbol);
+        if (transition.accepts) {
+            match_end = position.string_position;
+            match_end_in_code_units = position.string_position_in_code_units;
+        }
+
+        current_state = transition.next;
+        if (current_state->threads.is_empty())
+            break;
+
+        ++position.string_position;
+        position.string_position_in_code_units += code_units;
+    }
+
+    if (!match_end.has_value())
+        return false;
+
+    state.string_position = *match_end;
+    state.string_position_in_code_units = match_end_in_code_units;
+    return true;
+}
+
+}
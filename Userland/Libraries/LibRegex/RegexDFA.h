@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "RegexByteCode.h"
+#include "RegexMatch.h"
+
+#include <AK/Array.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/OwnPtr.h>
+#include <AK/Types.h>
+#include <AK/Vector.h>
+
+namespace regex {
+
+// The number of states a LazyDFA keeps around; once there are more, it starts over.
+static constexpr size_t c_max_dfa_states = 2048;
+
+// A DFA for the patterns that don't need to backtrack, that is, the ones without backreferences, lookaround and
+// counted repetition. Its states are built from the bytecode while matching, so it only ever has the ones the
+// input actually gets it into.
+//
+// A state stands for the VM threads that are still alive at a position in the input, ordered by the priority the
+// VM would try them in. Threads that come after one that has reached the end of the pattern are dropped, so this
+// finds the same match as the VM does (rather than the longest one), in time linear in the length of the input.
+// It only finds where the match ends though; filling in capture groups is left to the VM.
+class LazyDFA {
+public:
+    // Returns nothing if the pattern needs the VM.
+    static OwnPtr<LazyDFA> try_create(ByteCode const&);
+
+    bool can_match(MatchInput const&) const;
+
+    // Like Matcher::execute(), this matches from state.string_position on, and moves it to the end of the match.
+    bool match(ByteCode const&, MatchInput const&, MatchState&, size_t& operations);
+
+private:
+    LazyDFA() = default;
+
+    bool add_comparison(ByteCode const&, size_t instruction_position);
+
+    struct Thread {
+        u32 instruction_position { 0 };
+        // How many characters of a String comparison have been matched already.
+        u32 string_index { 0 };
+
+        bool operator==(Thread const&) const = default;
+    };
+
+    enum Context : u8 {
+        AtStart = 1 << 0,
+        AfterNewline = 1 << 1,
+        AfterWordCharacter = 1 << 2,
+    };
+
+    struct State;
+
+    struct Transition {
+        State* next { nullptr };
+        // Whether a thread reached the end of the pattern before the character was consumed.
+        bool accepts { false };
+    };
+
+    struct State {
+        Vector<Thread> threads;
+        u8 context { 0 };
+        // The Checkpoints that the input has moved past; all of them, unless this is the state the match starts in.
+        u32 passed_checkpoints { 0 };
+        unsigned hash { 0 };
+
+        Array<State*, 128> ascii_transitions {};
+        u64 ascii_accepts[2] {};
+        HashMap<u64, Transition> other_transitions;
+        Optional<bool> accepts_at_end;
+    };
+
+    struct StateTraits : public GenericTraits<State*> {
+        static unsigned hash(State* state) { return state->hash; }
+        static bool equals(State* a, State* b)
+        {
+            return a->context == b->context && a->passed_checkpoints == b->passed_checkpoints && a->threads == b->threads;
+        }
+    };
+
+    struct ConsumingThread {
+        Thread thread;
+        // Where the thread goes once the comparison has consumed a character.
+        Thread next;
+    };
+
+    State* initial_state(MatchInput const&, MatchState const&);
+    State* find_or_create_state(Vector<Thread>&&, u8 context, u32 passed_checkpoints);
+    void reset();
+
+    Transition transition(ByteCode const&, MatchInput const&, State&, MatchState const&, u64 symbol);
+    bool accepts_at_end(ByteCode const&, MatchInput const&, State&, MatchState const&);
+    bool follow_threads(ByteCode const&, MatchInput const&, State const&, MatchState const&, Vector<ConsumingThread>&);
+    bool consumes(ByteCode const&, MatchInput const&, ConsumingThread const&, MatchState const&, u64 symbol) const;
+
+    // The String comparisons, which are matched a character at a time, by their instruction position.
+    HashMap<u32, Vector<u8>> m_strings;
+    // The bit each Checkpoint has in State::passed_checkpoints, by its instruction position.
+    HashMap<u32, u32> m_checkpoint_bits;
+
+    NonnullOwnPtrVector<State> m_states;
+    HashTable<State*, StateTraits> m_state_set;
+    Array<State*, 8> m_initial_states {};
+    size_t m_generation { 0 };
+    Optional<FlagsUnderlyingType> m_options;
+    // Without assertions, the threads don't care what comes before them, and there's no need to tell states apart by it.
+    bool m_uses_context { false };
+};
+
+}
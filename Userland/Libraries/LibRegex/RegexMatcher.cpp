@@ -6,6 +6,7 @@
 
 #include <AK/BumpAllocator.h>
 #include <AK/Debug.h>
+#include <AK/MemMem.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <LibRegex/RegexMatcher.h>
@@ -185,6 +186,10 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
 
     auto single_match_only = input.regex_options.has_flag_set(AllFlags::SingleMatch);
 
+    auto& bytecode = m_pattern->parser_result.bytecode;
+    auto has_capture_groups = m_pattern->parser_result.capture_groups_count != 0 || m_pattern->parser_result.named_capture_groups_count != 0;
+    auto& required_prefix = m_pattern->parser_result.optimization_data.required_prefix;
+
     for (auto const& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -193,6 +198,9 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
         }
         input.view = view;
         dbgln_if(REGEX_DEBUG, "[match] Starting match with view ({}): _{}_", view.length(), view);
+        bool use_dfa = m_dfa && m_dfa->can_match(input);
+        // Case insensitivity and indexing by code point would both get in the way of looking for the bytes directly.
+        bool can_skip_to_prefix = continue_search && !required_prefix.is_empty() && view.is_string_view() && !view.unicode() && !input.regex_options.has_flag_set(AllFlags::Insensitive);
 
         auto view_length = view.length();
         size_t view_index = m_pattern->start_offset;
@@ -230,6 +238,15 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             if (view_index == view_length && input.regex_options.has_flag_set(AllFlags::Multiline))
                 break;
 
+            if (can_skip_to_prefix) {
+                // No match can start before the next place the prefix is at.
+                auto remaining = view.string_view().substring_view(view_index);
+                auto offset = AK::memmem_optional(remaining.characters_without_null_termination(), remaining.length(), required_prefix.data(), required_prefix.size());
+                if (!offset.has_value())
+                    break;
+                view_index += *offset;
+            }
+
             auto& match_length_minimum = m_pattern->parser_result.match_length_minimum;
             // FIXME: More performant would be to know the remaining minimum string
             //        length needed to match from the current position onwards within
@@ -248,7 +265,18 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
             state.instruction_position = 0;
             state.repetition_marks.clear();
 
-            auto success = execute(input, state, operations);
+            bool success;
+            if (use_dfa) {
+                // The DFA rules out the positions where nothing matches a lot faster, but only the VM fills in capture groups.
+                success = m_dfa->match(bytecode, input, state, operations);
+                if (success && has_capture_groups) {
+                    state.string_position = view_index;
+                    state.string_position_in_code_units = view_index;
+                    success = execute(input, state, operations);
+                }
+            } else {
+                success = execute(input, state, operations);
+            }
             if (success) {
                 succeeded = true;
 
@@ -315,8 +343,7 @@ RegexResult Matcher<Parser>::match(Vector<RegexStringView> const& views, Optiona
 
     if (match_count) {
         // Make sure there are as many capture matches as there are actual matches.
-        if (result.capture_group_matches.size() < match_count)
-            result.capture_group_matches.resize(match_count);
+        result.capture_group_matches.resize(match_count);
         for (auto& matches : result.capture_group_matches)
             matches.resize(m_pattern->parser_result.capture_groups_count + 1);
         if (!input.regex_options.has_flag_set(AllFlags::SkipTrimEmptyMatches)) {
@@ -7,6 +7,7 @@
 #pragma once
 
 #include "RegexByteCode.h"
+#include "RegexDFA.h"
 #include "RegexMatch.h"
 #include "RegexOptions.h"
 #include "RegexParser.h"
@@ -56,6 +57,7 @@ public:
     Matcher(Regex<Parser> const* pattern, Optional<typename ParserTraits<Parser>::OptionsType> regex_options = {})
         : m_pattern(pattern)
         , m_regex_options(regex_options.value_or({}))
+        , m_dfa(LazyDFA::try_create(pattern->parser_result.bytecode))
     {
     }
     ~Matcher() = default;
@@ -78,6 +80,7 @@ private:
 
     Regex<Parser> const* m_pattern;
     typename ParserTraits<Parser>::OptionsType const m_regex_options;
+    mutable OwnPtr<LazyDFA> m_dfa;
 };
 
 template<class Parser>
@@ -233,6 +236,7 @@ public:
 private:
     void run_optimization_passes();
     void attempt_rewrite_loops_as_atomic_groups(BasicBlockList const&);
+    void fill_optimization_data();
 };
 
 // free standing functions for match, search and has_match
@@ -28,6 +28,54 @@ void Regex<Parser>::run_optimization_passes()
     attempt_rewrite_loops_as_atomic_groups(split_basic_blocks(parser_result.bytecode));
 
     parser_result.bytecode.flatten();
+
+    fill_optimization_data();
+}
+
+template<typename Parser>
+void Regex<Parser>::fill_optimization_data()
+{
+    auto& bytecode = parser_result.bytecode;
+    auto& prefix = parser_result.optimization_data.required_prefix;
+    prefix.clear();
+
+    // Collect the literal characters the pattern starts with, up to the first thing that could branch or doesn't
+    // match a single ASCII character (or a run of bytes, for a String).
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<OpCode_Compare const&>(opcode);
+            if (compare.arguments_count() != 1)
+                return;
+            auto offset = state.instruction_position + 3;
+            auto compare_type = static_cast<CharacterCompareType>(bytecode.at(offset++));
+            if (compare_type == CharacterCompareType::Char) {
+                auto ch = bytecode.at(offset);
+                if (ch >= 0x80)
+                    return;
+                prefix.append(static_cast<u8>(ch));
+            } else if (compare_type == CharacterCompareType::String) {
+                auto length = bytecode.at(offset++);
+                for (size_t i = 0; i < length; ++i)
+                    prefix.append(static_cast<u8>(bytecode.at(offset + i)));
+            } else {
+                return;
+            }
+            break;
+        }
+        case OpCodeId::Checkpoint:
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+        case OpCodeId::SaveRightNamedCaptureGroup:
+        case OpCodeId::ClearCaptureGroup:
+            break;
+        default:
+            return;
+        }
+        state.instruction_position += opcode.size();
+    }
 }
 
 template<typename Parser>
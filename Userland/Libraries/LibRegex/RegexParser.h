@@ -55,6 +55,11 @@ public:
         Token error_token;
         Vector<FlyString> capture_groups;
         AllOptions options;
+
+        struct {
+            // The bytes that every match starts with, if there are any; filled in by the optimizer.
+            Vector<u8> required_prefix;
+        } optimization_data {};
     };
 
     explicit Parser(Lexer& lexer)
@@ -1073,4 +1073,18 @@ private:
     NonnullRefPtr<QualifiedTableName> m_qualified_table_name;
 };
 
+class Explain : public Statement {
+public:
+    Explain(NonnullRefPtr<Select> select)
+        : m_select(move(select))
+    {
+    }
+
+    NonnullRefPtr<Select> const& select() const { return m_select; }
+    ResultOr<ResultSet> execute(ExecutionContext&) const override;
+
+private:
+    NonnullRefPtr<Select> m_select;
+};
+
 }
@@ -49,6 +49,8 @@ NonnullRefPtr<Statement> Parser::parse_statement()
         return parse_drop_table_statement();
     case TokenType::Describe:
         return parse_describe_table_statement();
+    case TokenType::Explain:
+        return parse_explain_statement();
     case TokenType::Insert:
         return parse_insert_statement({});
     case TokenType::Update:
@@ -58,7 +60,7 @@ NonnullRefPtr<Statement> Parser::parse_statement()
     case TokenType::Select:
         return parse_select_statement({});
     default:
-        expected("CREATE, ALTER, DROP, DESCRIBE, INSERT, UPDATE, DELETE, or SELECT");
+        expected("CREATE, ALTER, DROP, DESCRIBE, EXPLAIN, INSERT, UPDATE, DELETE, or SELECT");
         return create_ast_node<ErrorStatement>();
     }
 }
@@ -194,6 +196,19 @@ NonnullRefPtr<DescribeTable> Parser::parse_describe_table_statement()
     return create_ast_node<DescribeTable>(move(table_name));
 }
 
+NonnullRefPtr<Statement> Parser::parse_explain_statement()
+{
+    consume(TokenType::Explain);
+
+    // FIXME: Only SELECT statements have a plan to explain so far.
+    if (!match(TokenType::Select)) {
+        expected("SELECT");
+        return create_ast_node<ErrorStatement>();
+    }
+
+    return create_ast_node<Explain>(parse_select_statement({}));
+}
+
 NonnullRefPtr<Insert> Parser::parse_insert_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
 {
     // https://sqlite.org/lang_insert.html
@@ -12,6 +12,168 @@
 
 namespace SQL::AST {
 
+// Calls `callback` for every column the expression refers to. Returns false if it contains expressions (like sub-selects)
+// whose columns aren't known before the expression gets evaluated.
+template<typename Callback>
+static bool for_each_column_name_in(Expression const& expression, Callback callback)
+{
+    if (is<ColumnNameExpression>(expression)) {
+        callback(static_cast<ColumnNameExpression const&>(expression));
+        return true;
+    }
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<BlobLiteral>(expression) || is<NullLiteral>(expression))
+        return true;
+    if (is<ExistsExpression>(expression) || is<InSelectionExpression>(expression) || is<InTableExpression>(expression))
+        return false;
+
+    if (is<ChainedExpression>(expression)) {
+        for (auto& element : static_cast<ChainedExpression const&>(expression).expressions()) {
+            if (!for_each_column_name_in(element, callback))
+                return false;
+        }
+        return true;
+    }
+    if (is<CaseExpression>(expression)) {
+        auto& case_expression = static_cast<CaseExpression const&>(expression);
+        if (case_expression.case_expression() && !for_each_column_name_in(*case_expression.case_expression(), callback))
+            return false;
+        for (auto& clause : case_expression.when_then_clauses()) {
+            if (!for_each_column_name_in(clause.when, callback) || !for_each_column_name_in(clause.then, callback))
+                return false;
+        }
+        return !case_expression.else_expression() || for_each_column_name_in(*case_expression.else_expression(), callback);
+    }
+    if (is<MatchExpression>(expression)) {
+        auto& escape = static_cast<MatchExpression const&>(expression).escape();
+        if (escape && !for_each_column_name_in(*escape, callback))
+            return false;
+    }
+    if (is<BetweenExpression>(expression)) {
+        if (!for_each_column_name_in(static_cast<BetweenExpression const&>(expression).expression(), callback))
+            return false;
+    }
+    if (is<InChainedExpression>(expression)) {
+        if (!for_each_column_name_in(static_cast<InChainedExpression const&>(expression).expression_chain(), callback))
+            return false;
+    }
+    if (is<NestedDoubleExpression>(expression)) {
+        auto& nested_double_expression = static_cast<NestedDoubleExpression const&>(expression);
+        return for_each_column_name_in(nested_double_expression.lhs(), callback) && for_each_column_name_in(nested_double_expression.rhs(), callback);
+    }
+    if (is<NestedExpression>(expression))
+        return for_each_column_name_in(static_cast<NestedExpression const&>(expression).expression(), callback);
+
+    return false;
+}
+
+// Splits the WHERE clause up into the terms that are AND-ed together. A parenthesized list of expressions is only true if
+// all of them are, so they count as terms as well.
+static void collect_where_terms(Expression const& expression, Vector<Expression const*>& terms)
+{
+    if (is<ChainedExpression>(expression)) {
+        for (auto& element : static_cast<ChainedExpression const&>(expression).expressions())
+            collect_where_terms(element, terms);
+        return;
+    }
+    if (is<BinaryOperatorExpression>(expression)) {
+        auto& binary_expression = static_cast<BinaryOperatorExpression const&>(expression);
+        if (binary_expression.type() == BinaryOperator::And) {
+            collect_where_terms(binary_expression.lhs(), terms);
+            collect_where_terms(binary_expression.rhs(), terms);
+            return;
+        }
+    }
+    terms.append(&expression);
+}
+
+// The tables of a SELECT are joined one after the other, and every term of the WHERE clause is evaluated as soon as the
+// rows have the columns it refers to. That way, rows that don't match are dropped before they get joined with the rows
+// of the tables that come after it.
+struct JoinStep {
+    NonnullRefPtr<TableDef> table;
+    Vector<Expression const*> where_terms;
+};
+
+struct SelectPlan {
+    Vector<JoinStep> steps;
+    // The terms that can only be evaluated once all tables have been joined, because it's unknown which columns they use.
+    Vector<Expression const*> where_terms;
+    // A WHERE clause that isn't split up is evaluated the way it always has been, without looking at its type.
+    bool has_single_where_term { false };
+};
+
+static ResultOr<SelectPlan> plan_select(Select const& select, ExecutionContext& context)
+{
+    SelectPlan plan;
+    for (auto& table_descriptor : select.table_or_subquery_list()) {
+        if (!table_descriptor.is_table())
+            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
+
+        auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
+        if (!table_def)
+            return Result { SQLCommand::Select, SQLErrorCode::TableDoesNotExist, table_descriptor.table_name() };
+        if (table_def->num_columns() == 0)
+            continue;
+        plan.steps.append({ table_def.release_nonnull(), {} });
+    }
+
+    if (!select.where_clause())
+        return plan;
+
+    Vector<Expression const*> where_terms;
+    collect_where_terms(*select.where_clause(), where_terms);
+    plan.has_single_where_term = where_terms.size() == 1;
+
+    for (auto* term : where_terms) {
+        Optional<size_t> last_step;
+        bool can_be_evaluated_early = for_each_column_name_in(*term, [&](ColumnNameExpression const& column) {
+            // Columns that don't exist or are ambiguous leave it to the complete row to report that.
+            Optional<size_t> column_step;
+            size_t matches = 0;
+            for (size_t step_index = 0; step_index < plan.steps.size(); ++step_index) {
+                auto& table = *plan.steps[step_index].table;
+                if (!column.table_name().is_empty() && table.name() != column.table_name())
+                    continue;
+                for (auto& table_column : table.columns()) {
+                    if (table_column.name() != column.column_name())
+                        continue;
+                    column_step = step_index;
+                    ++matches;
+                }
+            }
+            if (matches != 1) {
+                last_step = plan.steps.size();
+                return;
+            }
+            last_step = max(last_step.value_or(0), *column_step);
+        });
+
+        auto step_index = last_step.value_or(0);
+        if (!can_be_evaluated_early || step_index >= plan.steps.size())
+            plan.where_terms.append(term);
+        else
+            plan.steps[step_index].where_terms.append(term);
+    }
+    return plan;
+}
+
+static ResultOr<bool> matches_where_terms(ExecutionContext& context, Vector<Expression const*> const& terms, bool is_single_term)
+{
+    for (auto* term : terms) {
+        auto result = TRY(term->evaluate(context));
+        if (is_single_term)
+            return static_cast<bool>(result);
+
+        // The terms are AND-ed together, so they have to be booleans.
+        auto result_bool = result.to_bool();
+        if (!result_bool.has_value())
+            return Result { SQLCommand::Unknown, SQLErrorCode::BooleanOperatorTypeMismatch, BinaryOperator_name(BinaryOperator::And) };
+        if (!result_bool.value())
+            return false;
+    }
+    return true;
+}
+
 ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
 {
     NonnullRefPtrVector<ResultColumn> columns;
@@ -50,6 +212,8 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
 
     ResultSet result { SQLCommand::Select };
 
+    auto plan = TRY(plan_select(*this, context));
+
     auto descriptor = adopt_ref(*new TupleDescriptor);
     Tuple tuple(descriptor);
     Vector<Tuple> rows;
@@ -57,27 +221,22 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     tuple.append(Value(SQLType::Boolean, true));
     rows.append(tuple);
 
-    for (auto& table_descriptor : table_or_subquery_list()) {
-        if (!table_descriptor.is_table())
-            return Result { SQLCommand::Select, SQLErrorCode::NotYetImplemented, "Sub-selects are not yet implemented"sv };
-
-        auto table_def = TRY(context.database->get_table(table_descriptor.schema_name(), table_descriptor.table_name()));
-        if (table_def->num_columns() == 0)
-            continue;
-
-        auto old_descriptor_size = descriptor->size();
-        descriptor->extend(table_def->to_tuple_descriptor());
-
-        while (!rows.is_empty() && (rows.first().size() == old_descriptor_size)) {
-            auto cartesian_row = rows.take_first();
-            auto table_rows = TRY(context.database->select_all(*table_def));
+    for (auto& step : plan.steps) {
+        descriptor->extend(step.table->to_tuple_descriptor());
+        auto table_rows = TRY(context.database->select_all(*step.table));
 
+        Vector<Tuple> joined_rows;
+        for (auto& row : rows) {
             for (auto& table_row : table_rows) {
-                auto new_row = cartesian_row;
+                auto new_row = row;
                 new_row.extend(table_row);
-                rows.append(new_row);
+                context.current_row = &new_row;
+                if (!TRY(matches_where_terms(context, step.where_terms, plan.has_single_where_term)))
+                    continue;
+                joined_rows.append(move(new_row));
             }
         }
+        rows = move(joined_rows);
     }
 
     bool has_ordering { false };
@@ -91,11 +250,8 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     for (auto& row : rows) {
         context.current_row = &row;
 
-        if (where_clause()) {
-            auto where_result = TRY(where_clause()->evaluate(context));
-            if (!where_result)
-                continue;
-        }
+        if (!TRY(matches_where_terms(context, plan.where_terms, plan.has_single_where_term)))
+            continue;
 
         tuple.clear();
 
@@ -112,9 +268,12 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
             }
         }
 
-        result.insert_row(tuple, sort_key);
+        result.append_row(move(tuple), move(sort_key));
     }
 
+    if (has_ordering)
+        result.sort_rows();
+
     if (m_limit_clause != nullptr) {
         size_t limit_value = NumericLimits<size_t>::max();
         size_t offset_value = 0;
@@ -145,4 +304,34 @@ ResultOr<ResultSet> Select::execute(ExecutionContext& context) const
     return result;
 }
 
+ResultOr<ResultSet> Explain::execute(ExecutionContext& context) const
+{
+    auto plan = TRY(plan_select(*m_select, context));
+
+    auto descriptor = adopt_ref(*new TupleDescriptor);
+    descriptor->empend(""sv, ""sv, "plan"sv, SQLType::Text);
+    ResultSet result { SQLCommand::Select };
+    auto add_line = [&](String line) {
+        Tuple tuple(descriptor);
+        tuple[0] = move(line);
+        result.insert_row(tuple, Tuple {});
+    };
+    auto describe_terms = [](size_t count) {
+        return String::formatted("FILTER ON {} {} OF THE WHERE CLAUSE", count, count == 1 ? "TERM"sv : "TERMS"sv);
+    };
+
+    for (auto& step : plan.steps) {
+        add_line(String::formatted("SCAN TABLE {}.{}", step.table->parent()->name(), step.table->name()));
+        if (!step.where_terms.is_empty())
+            add_line(String::formatted("    {}", describe_terms(step.where_terms.size())));
+    }
+    if (!plan.where_terms.is_empty())
+        add_line(describe_terms(plan.where_terms.size()));
+    if (!m_select->ordering_term_list().is_empty())
+        add_line("SORT"sv);
+    if (m_select->limit_clause())
+        add_line("LIMIT"sv);
+    return result;
+}
+
 }
@@ -8,10 +8,12 @@
 #include <AK/QuickSort.h>
 #include <AK/String.h>
 #include <LibCore/IODevice.h>
+#include <LibCrypto/Checksum/CRC32.h>
 #include <LibSQL/Heap.h>
 #include <LibSQL/Serializer.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
 
 namespace SQL {
 
@@ -20,12 +22,30 @@ Heap::Heap(String file_name)
     set_name(move(file_name));
 }
 
+// The log consists of transactions, each of which is the blocks that were changed (as the block number followed by its
+// contents), and a commit record: LOG_COMMIT_MARKER, the number of blocks in the transaction, and the CRC32 of the blocks.
+// A transaction without a commit record, or with one that doesn't match, was cut short; it and everything after it is
+// ignored.
+constexpr static u32 LOG_COMMIT_MARKER = 0xffffffff;
+constexpr static size_t LOG_BLOCK_RECORD_SIZE = sizeof(u32) + BLOCKSIZE;
+constexpr static size_t LOG_COMMIT_RECORD_SIZE = 3 * sizeof(u32);
+
 Heap::~Heap()
 {
-    if (m_file && !m_write_ahead_log.is_empty()) {
-        if (auto maybe_error = flush(); maybe_error.is_error())
+    if (!m_file)
+        return;
+    if (!m_write_ahead_log.is_empty()) {
+        if (auto maybe_error = flush(); maybe_error.is_error()) {
             warnln("~Heap({}): {}", name(), maybe_error.error());
+            return;
+        }
     }
+    if (auto maybe_error = checkpoint(); maybe_error.is_error()) {
+        warnln("~Heap({}): {}", name(), maybe_error.error());
+        return;
+    }
+    // Everything is in the heap file now, so the log has done its job.
+    unlink(log_file_name().characters());
 }
 
 ErrorOr<void> Heap::open()
@@ -52,7 +72,21 @@ ErrorOr<void> Heap::open()
         return Error::from_string_literal("Heap::open(): could not open file"sv);
     }
     m_file = file_or_error.value();
-    if (file_size > 0) {
+
+    auto log_file_or_error = Core::File::open(log_file_name(), Core::OpenMode::ReadWrite);
+    if (log_file_or_error.is_error()) {
+        warnln("Heap::open({}): could not open log: {}"sv, name(), log_file_or_error.error());
+        m_file = nullptr;
+        return Error::from_string_literal("Heap::open(): could not open log file"sv);
+    }
+    m_log_file = log_file_or_error.value();
+    auto recovered_or_error = recover_from_log();
+    if (recovered_or_error.is_error()) {
+        m_file = nullptr;
+        return recovered_or_error.release_error();
+    }
+
+    if (file_size > 0 || recovered_or_error.value()) {
         if (auto error_maybe = read_zero_block(); error_maybe.is_error()) {
             m_file = nullptr;
             return error_maybe.error();
@@ -78,6 +112,11 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
         warnln("Heap({})::read_block({}): block # out of range (>= {})"sv, name(), block, m_next_block);
         return Error::from_string_literal("Heap()::read_block(): block # out of range"sv);
     }
+    if (auto committed_buffer = m_committed_blocks.get(block); committed_buffer.has_value())
+        return committed_buffer.release_value();
+    if (auto cached = cached_block(block); cached.has_value())
+        return ByteBuffer::copy(*cached);
+
     dbgln_if(SQL_DEBUG, "Read heap block {}", block);
     TRY(seek_block(block));
     auto ret = m_file->read(BLOCKSIZE);
@@ -85,6 +124,8 @@ ErrorOr<ByteBuffer> Heap::read_block(u32 block)
         warnln("Heap({})::read_block({}): Could not read block"sv, name(), block);
         return Error::from_string_literal("Heap()::read_block(): Could not read block"sv);
     }
+    if (ret.size() == BLOCKSIZE)
+        cache_block(block, ret);
     dbgln_if(SQL_DEBUG, "{:02x} {:02x} {:02x} {:02x} {:02x} {:02x} {:02x} {:02x}",
         *ret.offset_pointer(0), *ret.offset_pointer(1),
         *ret.offset_pointer(2), *ret.offset_pointer(3),
@@ -125,6 +166,8 @@ ErrorOr<void> Heap::write_block(u32 block, ByteBuffer& buffer)
     if (m_file->write(buffer.data(), (int)buffer.size())) {
         if (block == m_end_of_file)
             m_end_of_file++;
+        // Blocks that were just written are likely to be read again soon, and the cache mustn't keep an older version around.
+        cache_block(block, buffer);
         return {};
     }
     warnln("Heap({})::write_block({}): Could not full write block"sv, name(), block);
@@ -155,6 +198,48 @@ ErrorOr<void> Heap::seek_block(u32 block)
     return {};
 }
 
+Optional<ReadonlyBytes> Heap::cached_block(u32 block)
+{
+    auto slot = m_block_cache_slots.get(block);
+    if (!slot.has_value())
+        return {};
+    m_cached_blocks[*slot].was_referenced = true;
+    return m_block_cache.bytes().slice(*slot * BLOCKSIZE, BLOCKSIZE);
+}
+
+void Heap::cache_block(u32 block, ReadonlyBytes data)
+{
+    VERIFY(data.size() == BLOCKSIZE);
+    if (m_block_cache.is_empty()) {
+        // Without a cache, blocks simply get read from the file every time.
+        if (m_block_cache.try_resize(BLOCK_CACHE_SIZE * BLOCKSIZE).is_error() || m_cached_blocks.try_resize(BLOCK_CACHE_SIZE).is_error()) {
+            m_block_cache.clear();
+            return;
+        }
+    }
+
+    auto slot = m_block_cache_slots.get(block);
+    if (!slot.has_value()) {
+        // Look for a block that hasn't been referenced since the hand last passed it, and give the others another chance.
+        while (m_cached_blocks[m_block_cache_hand].was_referenced) {
+            m_cached_blocks[m_block_cache_hand].was_referenced = false;
+            m_block_cache_hand = (m_block_cache_hand + 1) % BLOCK_CACHE_SIZE;
+        }
+        auto& evicted = m_cached_blocks[m_block_cache_hand];
+        if (evicted.is_used)
+            m_block_cache_slots.remove(evicted.block);
+        evicted = { block, true, false };
+        if (m_block_cache_slots.try_set(block, m_block_cache_hand).is_error()) {
+            evicted.is_used = false;
+            return;
+        }
+        slot = m_block_cache_hand;
+        m_block_cache_hand = (m_block_cache_hand + 1) % BLOCK_CACHE_SIZE;
+    }
+    m_cached_blocks[*slot].was_referenced = true;
+    data.copy_to(m_block_cache.bytes().slice(*slot * BLOCKSIZE, BLOCKSIZE));
+}
+
 u32 Heap::new_record_pointer()
 {
     VERIFY(!m_file.is_null());
@@ -175,22 +260,132 @@ u32 Heap::new_record_pointer()
 ErrorOr<void> Heap::flush()
 {
     VERIFY(!m_file.is_null());
+    if (m_write_ahead_log.is_empty())
+        return {};
+
     Vector<u32> blocks;
     for (auto& wal_entry : m_write_ahead_log) {
         blocks.append(wal_entry.key);
     }
     quick_sort(blocks);
+
+    // The whole transaction goes to the log in one go, so committing costs a single write, however many blocks changed.
+    ByteBuffer transaction;
+    TRY(transaction.try_ensure_capacity(blocks.size() * LOG_BLOCK_RECORD_SIZE + LOG_COMMIT_RECORD_SIZE));
     for (auto& block : blocks) {
-        auto buffer_it = m_write_ahead_log.find(block);
-        VERIFY(buffer_it != m_write_ahead_log.end());
-        dbgln_if(SQL_DEBUG, "Flushing block {} to {}", block, name());
-        TRY(write_block(block, buffer_it->value));
+        auto& buffer = m_write_ahead_log.find(block)->value;
+        if (buffer.size() > BLOCKSIZE) {
+            warnln("Heap({})::flush(): Oversized block {} ({} > {})"sv, name(), block, buffer.size(), BLOCKSIZE);
+            return Error::from_string_literal("Heap()::flush(): Oversized block"sv);
+        }
+        dbgln_if(SQL_DEBUG, "Committing block {} to {}", block, log_file_name());
+        TRY(buffer.try_resize(BLOCKSIZE));
+        TRY(transaction.try_append(&block, sizeof(block)));
+        TRY(transaction.try_append(buffer.bytes()));
     }
+    u32 commit_record[] = { LOG_COMMIT_MARKER, static_cast<u32>(blocks.size()), Crypto::Checksum::CRC32(transaction).digest() };
+    TRY(transaction.try_append(commit_record, sizeof(commit_record)));
+
+    if (!m_log_file->write(transaction.data(), transaction.size())) {
+        warnln("Heap({})::flush(): Could not write to log: {}"sv, name(), m_log_file->error_string());
+        return Error::from_string_literal("Heap()::flush(): Could not write to log"sv);
+    }
+    if (fsync(m_log_file->fd()) < 0)
+        return Error::from_errno(errno);
+    m_log_size += transaction.size();
+
+    for (auto& block : blocks)
+        TRY(m_committed_blocks.try_set(block, move(m_write_ahead_log.find(block)->value)));
+    m_end_of_committed_blocks = max(m_end_of_committed_blocks, blocks.last() + 1);
     m_write_ahead_log.clear();
-    dbgln_if(SQL_DEBUG, "WAL flushed. Heap size = {}", size());
+    dbgln_if(SQL_DEBUG, "WAL committed. Log size = {}", m_log_size);
+
+    if (m_log_size >= LOG_CHECKPOINT_SIZE)
+        TRY(checkpoint());
     return {};
 }
 
+ErrorOr<void> Heap::checkpoint()
+{
+    VERIFY(!m_file.is_null());
+    if (m_committed_blocks.is_empty() && m_log_size == 0)
+        return {};
+
+    Vector<u32> blocks;
+    for (auto& committed_entry : m_committed_blocks) {
+        blocks.append(committed_entry.key);
+    }
+    quick_sort(blocks);
+    for (auto& block : blocks) {
+        dbgln_if(SQL_DEBUG, "Checkpointing block {} to {}", block, name());
+        TRY(write_block(block, m_committed_blocks.find(block)->value));
+    }
+    // The log can only go once the blocks are safely in the heap file.
+    if (fsync(m_file->fd()) < 0)
+        return Error::from_errno(errno);
+
+    if (!m_log_file->truncate(0) || !m_log_file->seek(0)) {
+        warnln("Heap({})::checkpoint(): Could not truncate log: {}"sv, name(), m_log_file->error_string());
+        return Error::from_string_literal("Heap()::checkpoint(): Could not truncate log"sv);
+    }
+    m_committed_blocks.clear();
+    m_log_size = 0;
+    dbgln_if(SQL_DEBUG, "Checkpoint done. Heap size = {}", size());
+    return {};
+}
+
+ErrorOr<bool> Heap::recover_from_log()
+{
+    auto log = m_log_file->read_all();
+    if (log.is_empty())
+        return false;
+
+    auto read_u32 = [&](size_t offset) {
+        u32 value;
+        memcpy(&value, log.offset_pointer(offset), sizeof(value));
+        return value;
+    };
+
+    size_t transaction_start = 0;
+    size_t offset = 0;
+    size_t recovered_transactions = 0;
+    Vector<u32> blocks;
+    while (offset + sizeof(u32) <= log.size()) {
+        auto block = read_u32(offset);
+        if (block != LOG_COMMIT_MARKER) {
+            if (offset + LOG_BLOCK_RECORD_SIZE > log.size())
+                break;
+            blocks.append(block);
+            offset += LOG_BLOCK_RECORD_SIZE;
+            continue;
+        }
+
+        if (offset + LOG_COMMIT_RECORD_SIZE > log.size())
+            break;
+        auto block_count = read_u32(offset + sizeof(u32));
+        auto checksum = read_u32(offset + 2 * sizeof(u32));
+        if (block_count != blocks.size() || checksum != Crypto::Checksum::CRC32(log.bytes().slice(transaction_start, offset - transaction_start)).digest())
+            break;
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            auto buffer = TRY(ByteBuffer::copy(log.bytes().slice(transaction_start + i * LOG_BLOCK_RECORD_SIZE + sizeof(u32), BLOCKSIZE)));
+            TRY(m_committed_blocks.try_set(blocks[i], move(buffer)));
+            m_next_block = max(m_next_block, blocks[i] + 1);
+        }
+        ++recovered_transactions;
+        offset += LOG_COMMIT_RECORD_SIZE;
+        transaction_start = offset;
+        blocks.clear();
+    }
+
+    if (transaction_start < log.size())
+        warnln("Heap({}): Ignoring {} bytes at the end of the log, which were never committed"sv, name(), log.size() - transaction_start);
+    dbgln_if(SQL_DEBUG, "Recovered {} transactions from {}", recovered_transactions, log_file_name());
+
+    m_log_size = log.size();
+    TRY(checkpoint());
+    return recovered_transactions > 0;
+}
+
 constexpr static StringView FILE_ID = "SerenitySQL "sv;
 constexpr static int VERSION_OFFSET = 12;
 constexpr static int SCHEMAS_ROOT_OFFSET = 16;
@@ -18,6 +18,12 @@ namespace SQL {
 
 constexpr static u32 BLOCKSIZE = 1024;
 
+// The number of blocks the Heap keeps around after reading or writing them, so 256 KiB worth of them.
+constexpr static size_t BLOCK_CACHE_SIZE = 256;
+
+// Once the log has grown this large, the blocks in it are written to the heap file itself.
+constexpr static size_t LOG_CHECKPOINT_SIZE = 1 * MiB;
+
 /**
  * A Heap is a logical container for database (SQL) data. Conceptually a
  * Heap can be a database file, or a memory block, or another storage medium.
@@ -28,6 +34,12 @@ constexpr static u32 BLOCKSIZE = 1024;
  * assumed that a single SQL database is backed by a single Heap.
  *
  * Currently only B-Trees and tuple stores are implemented.
+ *
+ * Changed blocks are committed by appending them to a log file next to the
+ * heap file, which only takes a single sequential write. They are written to
+ * their place in the heap file (checkpointed) once the log gets large, and
+ * when the Heap is closed. If the process didn't get that far, the blocks are
+ * recovered from the log the next time the Heap is opened.
  */
 class Heap : public Core::Object {
     C_OBJECT(Heap);
@@ -36,7 +48,7 @@ public:
     virtual ~Heap() override;
 
     ErrorOr<void> open();
-    u32 size() const { return m_end_of_file; }
+    u32 size() const { return max(m_end_of_file, m_end_of_committed_blocks); }
     ErrorOr<ByteBuffer> read_block(u32);
     [[nodiscard]] u32 new_record_pointer();
     [[nodiscard]] bool has_block(u32 block) const { return block < size(); }
@@ -91,17 +103,25 @@ public:
         m_write_ahead_log.set(block, buffer);
     }
 
+    // Commits the blocks that were added to the WAL.
     ErrorOr<void> flush();
+    ErrorOr<void> checkpoint();
 
 private:
     explicit Heap(String);
 
+    String log_file_name() const { return String::formatted("{}-wal", name()); }
+    ErrorOr<bool> recover_from_log();
+
     ErrorOr<void> write_block(u32, ByteBuffer&);
     ErrorOr<void> seek_block(u32);
     ErrorOr<void> read_zero_block();
     void initialize_zero_block();
     void update_zero_block();
 
+    Optional<ReadonlyBytes> cached_block(u32);
+    void cache_block(u32, ReadonlyBytes);
+
     RefPtr<Core::File> m_file { nullptr };
     u32 m_free_list { 0 };
     u32 m_next_block { 1 };
@@ -112,6 +132,25 @@ private:
     u32 m_version { 0x00000001 };
     Array<u32, 16> m_user_values { 0 };
     HashMap<u32, ByteBuffer> m_write_ahead_log;
+
+    RefPtr<Core::File> m_log_file { nullptr };
+    size_t m_log_size { 0 };
+    // The blocks that have been committed to the log, but not written to the heap file yet.
+    HashMap<u32, ByteBuffer> m_committed_blocks;
+    u32 m_end_of_committed_blocks { 0 };
+
+    // The interior nodes of the trees are read over and over again, so the blocks that were used last stay in memory.
+    // Callers get a copy of the block, so nothing ever points into the cache, and the blocks that haven't been written
+    // yet live in the write-ahead log instead; so any block can be evicted, and they are with the clock algorithm.
+    struct CachedBlock {
+        u32 block { 0 };
+        bool is_used { false };
+        bool was_referenced { false };
+    };
+    ByteBuffer m_block_cache;
+    Vector<CachedBlock> m_cached_blocks;
+    HashMap<u32, size_t> m_block_cache_slots;
+    size_t m_block_cache_hand { 0 };
 };
 
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/QuickSort.h>
 #include <LibSQL/ResultSet.h>
 
 namespace SQL {
@@ -35,6 +36,31 @@ void ResultSet::insert_row(Tuple const& row, Tuple const& sort_key)
     insert(ix, ResultRow { row, sort_key });
 }
 
+void ResultSet::sort_rows()
+{
+    // Rows with equal sort keys keep the order they were added in, so the indices break the ties.
+    Vector<size_t> order;
+    order.ensure_capacity(size());
+    for (size_t i = 0; i < size(); ++i)
+        order.unchecked_append(i);
+
+    quick_sort(order, [&](size_t left, size_t right) {
+        auto compare = at(left).sort_key.compare(at(right).sort_key);
+        if (compare != 0)
+            return compare < 0;
+        return left < right;
+    });
+
+    Vector<ResultRow> sorted_rows;
+    sorted_rows.ensure_capacity(size());
+    for (auto index : order)
+        sorted_rows.unchecked_append(move(at(index)));
+
+    clear_with_capacity();
+    for (auto& row : sorted_rows)
+        unchecked_append(move(row));
+}
+
 void ResultSet::limit(size_t offset, size_t limit)
 {
     if (offset > 0) {
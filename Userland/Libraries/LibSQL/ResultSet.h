@@ -28,6 +28,12 @@ public:
     SQLCommand command() const { return m_command; }
 
     void insert_row(Tuple const& row, Tuple const& sort_key);
+
+    // Adds a row at the end, whatever its sort key. Once all rows are in, sort_rows() puts them in order in one go,
+    // which is a lot cheaper than inserting each of them at its place.
+    void append_row(Tuple row, Tuple sort_key) { empend(move(row), move(sort_key)); }
+    void sort_rows();
+
     void limit(size_t offset, size_t limit);
 
 private:
@@ -31,6 +31,7 @@ public:
     explicit Row(RefPtr<TableDef>, u32 pointer = 0);
     Row(RefPtr<TableDef>, u32, Serializer&);
     Row(Row const&) = default;
+    Row(Row&&) = default;
     virtual ~Row() override = default;
 
     [[nodiscard]] u32 next_pointer() const { return m_next_pointer; }
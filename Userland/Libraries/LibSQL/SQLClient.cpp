@@ -45,20 +45,25 @@ void SQLClient::execution_success(int statement_id, bool has_results, int create
         outln("{} row(s) created, {} updated, {} deleted", created, updated, deleted);
 }
 
-void SQLClient::next_result(int statement_id, Vector<String> const& row)
+void SQLClient::next_results(int statement_id, Vector<Vector<String>> const& rows)
 {
-    if (on_next_result) {
-        on_next_result(statement_id, row);
-        return;
-    }
-    bool first = true;
-    for (auto& column : row) {
-        if (!first)
-            out(", ");
-        out("\"{}\"", column);
-        first = false;
+    // Ask for the next batch right away, so it's on its way while these rows are taken care of.
+    async_statement_fetch(statement_id);
+
+    for (auto& row : rows) {
+        if (on_next_result) {
+            on_next_result(statement_id, row);
+            continue;
+        }
+        bool first = true;
+        for (auto& column : row) {
+            if (!first)
+                out(", ");
+            out("\"{}\"", column);
+            first = false;
+        }
+        outln();
     }
-    outln();
 }
 
 void SQLClient::results_exhausted(int statement_id, int total_rows)
@@ -36,7 +36,7 @@ private:
     virtual void connected(int connection_id, String const& connected_to_database) override;
     virtual void connection_error(int connection_id, int code, String const& message) override;
     virtual void execution_success(int statement_id, bool has_results, int created, int updated, int deleted) override;
-    virtual void next_result(int statement_id, Vector<String> const&) override;
+    virtual void next_results(int statement_id, Vector<Vector<String>> const&) override;
     virtual void results_exhausted(int statement_id, int total_rows) override;
     virtual void execution_error(int statement_id, int code, String const& message) override;
     virtual void disconnected(int connection_id) override;
@@ -79,6 +79,29 @@ Tuple& Tuple::operator=(Tuple const& other)
     return *this;
 }
 
+// Moving leaves the descriptor alone, since other tuples may share it.
+Tuple::Tuple(Tuple&& other)
+    : m_descriptor(other.m_descriptor)
+    , m_data(move(other.m_data))
+    , m_pointer(other.m_pointer)
+{
+}
+
+Tuple& Tuple::operator=(Tuple&& other)
+{
+    if (this != &other) {
+        if (m_descriptor.ptr() != other.m_descriptor.ptr() && *m_descriptor != *other.m_descriptor) {
+            m_descriptor->clear();
+            for (TupleElementDescriptor const& part : *other.m_descriptor) {
+                m_descriptor->append(part);
+            }
+        }
+        m_data = move(other.m_data);
+        m_pointer = other.m_pointer;
+    }
+    return *this;
+}
+
 Optional<size_t> Tuple::index_of(String name) const
 {
     auto n = move(name);
@@ -31,9 +31,11 @@ public:
     explicit Tuple(NonnullRefPtr<TupleDescriptor> const&, u32 pointer = 0);
     Tuple(NonnullRefPtr<TupleDescriptor> const&, Serializer&);
     Tuple(Tuple const&);
+    Tuple(Tuple&&);
     virtual ~Tuple() = default;
 
     Tuple& operator=(Tuple const&);
+    Tuple& operator=(Tuple&&);
 
     [[nodiscard]] String to_string() const;
     explicit operator String() const { return to_string(); }
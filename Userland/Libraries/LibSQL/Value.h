@@ -29,6 +29,7 @@ class Value {
 public:
     Value(Value&) = default;
     Value(Value const&) = default;
+    Value(Value&&) = default;
 
     explicit Value(SQLType sql_type = SQLType::Null);
 
@@ -19,6 +19,11 @@ static constexpr int NUM_SAMPLERS = 2;
 static constexpr int MILLISECONDS_PER_STATISTICS_PERIOD = 500;
 static constexpr int NUM_LIGHTS = 8;
 
+// Draw calls that cover enough pixels are rasterized in parallel, with the framebuffer split up into square tiles of this many
+// pixels on each side. This has to be a multiple of 2, so that pixel quads never cross tiles.
+static constexpr int RASTERIZER_TILE_SIZE = 64;
+static constexpr int MIN_PIXELS_FOR_PARALLEL_RASTERIZATION = 4 * RASTERIZER_TILE_SIZE * RASTERIZER_TILE_SIZE;
+
 // See: https://www.khronos.org/opengl/wiki/Common_Mistakes#Texture_edge_color_problem
 // FIXME: make this dynamically configurable through ConfigServer
 static constexpr bool CLAMP_DEPRECATED_BEHAVIOR = false;
@@ -6,6 +6,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/Math.h>
 #include <AK/NumericLimits.h>
 #include <AK/SIMDExtras.h>
@@ -18,6 +19,7 @@
 #include <LibSoftGPU/Device.h>
 #include <LibSoftGPU/PixelQuad.h>
 #include <LibSoftGPU/SIMD.h>
+#include <LibThreading/ThreadPool.h>
 #include <math.h>
 
 namespace SoftGPU {
@@ -81,17 +83,6 @@ ALWAYS_INLINE static u32x4 to_bgra32(Vector4<f32x4> const& v)
     return a << 24 | r << 16 | g << 8 | b;
 }
 
-static Vector4<f32x4> to_vec4(u32x4 bgra)
-{
-    auto constexpr one_over_255 = expand4(1.0f / 255);
-    return {
-        to_f32x4((bgra >> 16) & 0xff) * one_over_255,
-        to_f32x4((bgra >> 8) & 0xff) * one_over_255,
-        to_f32x4(bgra & 0xff) * one_over_255,
-        to_f32x4((bgra >> 24) & 0xff) * one_over_255,
-    };
-}
-
 void Device::setup_blend_factors()
 {
     m_alpha_blend_factors = {};
@@ -175,14 +166,110 @@ void Device::setup_blend_factors()
     }
 }
 
-void Device::rasterize_triangle(const Triangle& triangle)
+void Device::rasterize_triangles(Vector<Triangle> const& triangles)
 {
-    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, 1);
+    INCREASE_STATISTICS_COUNTER(g_num_rasterized_triangles, triangles.size());
 
     // Return if alpha testing is a no-op
     if (m_options.enable_alpha_test && m_options.alpha_test_func == AlphaTestFunction::Never)
         return;
 
+    auto render_bounds = m_frame_buffer->rect();
+    if (m_options.scissor_enabled)
+        render_bounds.intersect(m_options.scissor_box);
+    if (render_bounds.is_empty() || triangles.is_empty())
+        return;
+
+    // The pixels of the render bounds that a triangle may cover, if any.
+    auto bounds_of = [&](Triangle const& triangle) -> Optional<Gfx::IntRect> {
+        auto const& v0 = triangle.vertices[0].window_coordinates;
+        auto const& v1 = triangle.vertices[1].window_coordinates;
+        auto const& v2 = triangle.vertices[2].window_coordinates;
+        int const x0 = max(render_bounds.left(), static_cast<int>(floorf(min(min(v0.x(), v1.x()), v2.x()))));
+        int const x1 = min(render_bounds.right(), static_cast<int>(ceilf(max(max(v0.x(), v1.x()), v2.x()))));
+        int const y0 = max(render_bounds.top(), static_cast<int>(floorf(min(min(v0.y(), v1.y()), v2.y()))));
+        int const y1 = min(render_bounds.bottom(), static_cast<int>(ceilf(max(max(v0.y(), v1.y()), v2.y()))));
+        if (x1 < x0 || y1 < y0)
+            return {};
+        return Gfx::IntRect { x0, y0, x1 - x0 + 1, y1 - y0 + 1 };
+    };
+
+    auto& pool = Threading::ThreadPool::the();
+    bool rasterize_in_parallel = false;
+    if (pool.worker_count() > 0) {
+        int pixel_count = 0;
+        for (auto const& triangle : triangles) {
+            if (auto bounds = bounds_of(triangle); bounds.has_value())
+                pixel_count += bounds->width() * bounds->height();
+            if (pixel_count >= MIN_PIXELS_FOR_PARALLEL_RASTERIZATION) {
+                rasterize_in_parallel = true;
+                break;
+            }
+        }
+    }
+
+    if (!rasterize_in_parallel) {
+        for (auto const& triangle : triangles)
+            rasterize_triangle(triangle, render_bounds);
+        return;
+    }
+
+    // Sort the triangles into tiles. Every tile only ever gets its pixels touched by one thread, and by its triangles in the
+    // order they were drawn, so the result is exactly the same as rasterizing all triangles one after another.
+    // The tiles start at an even position, just like the pixel quads do.
+    int const tile_origin_x = render_bounds.left() & ~1;
+    int const tile_origin_y = render_bounds.top() & ~1;
+    int const tile_columns = (render_bounds.right() - tile_origin_x) / RASTERIZER_TILE_SIZE + 1;
+    int const tile_rows = (render_bounds.bottom() - tile_origin_y) / RASTERIZER_TILE_SIZE + 1;
+    size_t const tile_count = tile_columns * tile_rows;
+
+    if (m_tile_triangle_indices.size() < tile_count)
+        m_tile_triangle_indices.resize(tile_count);
+    for (size_t i = 0; i < tile_count; ++i)
+        m_tile_triangle_indices[i].clear_with_capacity();
+
+    for (size_t i = 0; i < triangles.size(); ++i) {
+        auto bounds = bounds_of(triangles[i]);
+        if (!bounds.has_value())
+            continue;
+        int const first_column = (bounds->left() - tile_origin_x) / RASTERIZER_TILE_SIZE;
+        int const last_column = (bounds->right() - tile_origin_x) / RASTERIZER_TILE_SIZE;
+        int const first_row = (bounds->top() - tile_origin_y) / RASTERIZER_TILE_SIZE;
+        int const last_row = (bounds->bottom() - tile_origin_y) / RASTERIZER_TILE_SIZE;
+        for (int row = first_row; row <= last_row; ++row) {
+            for (int column = first_column; column <= last_column; ++column)
+                m_tile_triangle_indices[row * tile_columns + column].append(i);
+        }
+    }
+
+    Atomic<size_t> next_tile { 0 };
+    auto rasterize_remaining_tiles = [&] {
+        for (size_t tile = next_tile.fetch_add(1); tile < tile_count; tile = next_tile.fetch_add(1)) {
+            auto const& tile_triangle_indices = m_tile_triangle_indices[tile];
+            if (tile_triangle_indices.is_empty())
+                continue;
+            Gfx::IntRect tile_rect {
+                tile_origin_x + static_cast<int>(tile % tile_columns) * RASTERIZER_TILE_SIZE,
+                tile_origin_y + static_cast<int>(tile / tile_columns) * RASTERIZER_TILE_SIZE,
+                RASTERIZER_TILE_SIZE,
+                RASTERIZER_TILE_SIZE,
+            };
+            auto tile_bounds = render_bounds.intersected(tile_rect);
+            for (auto index : tile_triangle_indices)
+                rasterize_triangle(triangles[index], tile_bounds);
+        }
+    };
+
+    Threading::TaskGroup group(pool);
+    auto helper_count = min(pool.worker_count(), tile_count - 1);
+    for (size_t i = 0; i < helper_count; ++i)
+        group.spawn([&] { rasterize_remaining_tiles(); });
+    rasterize_remaining_tiles();
+    group.wait();
+}
+
+void Device::rasterize_triangle(Triangle const& triangle, Gfx::IntRect const& render_bounds)
+{
     // Vertices
     Vertex const vertex0 = triangle.vertices[0];
     Vertex const vertex1 = triangle.vertices[1];
@@ -196,10 +283,6 @@ void Device::rasterize_triangle(const Triangle& triangle)
     auto const area = edge_function(v0, v1, v2);
     auto const one_over_area = 1.0f / area;
 
-    auto render_bounds = m_frame_buffer->rect();
-    if (m_options.scissor_enabled)
-        render_bounds.intersect(m_options.scissor_box);
-
     // This function calculates the 3 edge values for the pixel relative to the triangle.
     auto calculate_edge_values4 = [v0, v1, v2](Vector2<f32x4> const& p) -> Vector3<f32x4> {
         return {
@@ -639,9 +722,150 @@ static void generate_texture_coordinates(Vertex& vertex, RasterizerOptions const
     }
 }
 
+void Device::transform_and_light_vertex(Vertex& vertex, FloatMatrix4x4 const& model_view_transform, FloatMatrix4x4 const& projection_transform)
+{
+    // Transform the vertex into eye coordinates using the model-view transform
+    vertex.eye_coordinates = model_view_transform * vertex.position;
+
+    // Transform the vertex normal into eye-space
+    vertex.normal = transform_direction(model_view_transform, vertex.normal);
+
+    // Calculate per-vertex lighting
+    if (m_options.lighting_enabled) {
+        auto const& material = m_materials.at(0);
+        auto ambient = material.ambient;
+        auto diffuse = material.diffuse;
+        auto emissive = material.emissive;
+        auto specular = material.specular;
+
+        if (m_options.color_material_enabled
+            && (m_options.color_material_face == ColorMaterialFace::Front || m_options.color_material_face == ColorMaterialFace::FrontAndBack)) {
+            switch (m_options.color_material_mode) {
+            case ColorMaterialMode::Ambient:
+                ambient = vertex.color;
+                break;
+            case ColorMaterialMode::AmbientAndDiffuse:
+                ambient = vertex.color;
+                diffuse = vertex.color;
+                break;
+            case ColorMaterialMode::Diffuse:
+                diffuse = vertex.color;
+                break;
+            case ColorMaterialMode::Emissive:
+                emissive = vertex.color;
+                break;
+            case ColorMaterialMode::Specular:
+                specular = vertex.color;
+                break;
+            }
+        }
+
+        FloatVector4 result_color = emissive + (ambient * m_lighting_model.scene_ambient_color);
+
+        for (auto const& light : m_lights) {
+            if (!light.is_enabled)
+                continue;
+
+            // We need to save the length here because the attenuation factor requires a non-normalized vector!
+            auto sgi_arrow_operator = [](FloatVector4 const& p1, FloatVector4 const& p2, float& output_length) {
+                FloatVector3 light_vector;
+                if ((p1.w() != 0.f) && (p2.w() == 0.f))
+                    light_vector = p2.xyz();
+                else if ((p1.w() == 0.f) && (p2.w() != 0.f))
+                    light_vector = -p1.xyz();
+                else
+                    light_vector = p2.xyz() - p1.xyz();
+
+                output_length = light_vector.length();
+                if (output_length == 0.f)
+                    return light_vector;
+                return light_vector / output_length;
+            };
+
+            auto sgi_dot_operator = [](FloatVector3 const& d1, FloatVector3 const& d2) {
+                return AK::max(d1.dot(d2), 0.0f);
+            };
+
+            float vertex_to_light_length = 0.f;
+            FloatVector3 vertex_to_light = sgi_arrow_operator(vertex.eye_coordinates, light.position, vertex_to_light_length);
+
+            // Light attenuation value.
+            float light_attenuation_factor = 1.0f;
+            if (light.position.w() != 0.0f)
+                light_attenuation_factor = 1.0f / (light.constant_attenuation + (light.linear_attenuation * vertex_to_light_length) + (light.quadratic_attenuation * vertex_to_light_length * vertex_to_light_length));
+
+            // Spotlight factor
+            float spotlight_factor = 1.0f;
+            if (light.spotlight_cutoff_angle != 180.0f) {
+                auto const vertex_to_light_dot_spotlight_direction = sgi_dot_operator(vertex_to_light, light.spotlight_direction.normalized());
+                auto const cos_spotlight_cutoff = AK::cos<float>(light.spotlight_cutoff_angle * AK::Pi<float> / 180.f);
+
+                if (vertex_to_light_dot_spotlight_direction >= cos_spotlight_cutoff)
+                    spotlight_factor = AK::pow<float>(vertex_to_light_dot_spotlight_direction, light.spotlight_exponent);
+                else
+                    spotlight_factor = 0.0f;
+            }
+
+            // FIXME: The spec allows for splitting the colors calculated here into multiple different colors (primary/secondary color). Investigate what this means.
+            (void)m_lighting_model.single_color;
+
+            // FIXME: Two sided lighting should be implemented eventually (I believe this is where the normals are -ve and then lighting is calculated with the BACK material)
+            (void)m_lighting_model.two_sided_lighting;
+
+            // Ambient
+            auto const ambient_component = ambient * light.ambient_intensity;
+
+            // Diffuse
+            auto const normal_dot_vertex_to_light = sgi_dot_operator(vertex.normal, vertex_to_light);
+            auto const diffuse_component = ((diffuse * light.diffuse_intensity) * normal_dot_vertex_to_light);
+
+            // Specular
+            FloatVector4 specular_component = { 0.0f, 0.0f, 0.0f, 0.0f };
+            if (normal_dot_vertex_to_light > 0.0f) {
+                FloatVector3 half_vector_normalized;
+                if (!m_lighting_model.viewer_at_infinity) {
+                    half_vector_normalized = (vertex_to_light + FloatVector3(0.0f, 0.0f, 1.0f)).normalized();
+                } else {
+                    auto const vertex_to_eye_point = sgi_arrow_operator(vertex.eye_coordinates.normalized(), { 0.f, 0.f, 0.f, 1.f }, vertex_to_light_length);
+                    half_vector_normalized = vertex_to_light + vertex_to_eye_point;
+                }
+
+                auto const normal_dot_half_vector = sgi_dot_operator(vertex.normal.normalized(), half_vector_normalized);
+                auto const specular_coefficient = AK::pow(normal_dot_half_vector, material.shininess);
+                specular_component = (specular * light.specular_intensity) * specular_coefficient;
+            }
+
+            auto color = ambient_component + diffuse_component + specular_component;
+            color = color * light_attenuation_factor * spotlight_factor;
+            result_color += color;
+        }
+
+        vertex.color = result_color;
+        vertex.color.set_w(diffuse.w()); // OpenGL 1.5 spec, page 59: "The A produced by lighting is the alpha value associated with diffuse color material"
+        vertex.color.clamp(0.0f, 1.0f);
+    }
+
+    // Transform eye coordinates into clip coordinates using the projection transform
+    vertex.clip_coordinates = projection_transform * vertex.eye_coordinates;
+}
+
 void Device::draw_primitives(PrimitiveType primitive_type, FloatMatrix4x4 const& model_view_transform, FloatMatrix3x3 const& normal_transform,
     FloatMatrix4x4 const& projection_transform, FloatMatrix4x4 const& texture_transform, Vector<Vertex> const& vertices,
     Vector<size_t> const& enabled_texture_units)
+{
+    draw_primitives(primitive_type, model_view_transform, normal_transform, projection_transform, texture_transform, vertices, nullptr, enabled_texture_units);
+}
+
+void Device::draw_primitives(PrimitiveType primitive_type, FloatMatrix4x4 const& model_view_transform, FloatMatrix3x3 const& normal_transform,
+    FloatMatrix4x4 const& projection_transform, FloatMatrix4x4 const& texture_transform, Vector<Vertex> const& vertices,
+    Vector<u32> const& indices, Vector<size_t> const& enabled_texture_units)
+{
+    draw_primitives(primitive_type, model_view_transform, normal_transform, projection_transform, texture_transform, vertices, &indices, enabled_texture_units);
+}
+
+void Device::draw_primitives(PrimitiveType primitive_type, FloatMatrix4x4 const& model_view_transform, FloatMatrix3x3 const& normal_transform,
+    FloatMatrix4x4 const& projection_transform, FloatMatrix4x4 const& texture_transform, Vector<Vertex> const& vertices,
+    Vector<u32> const* indices, Vector<size_t> const& enabled_texture_units)
 {
     // At this point, the user has effectively specified that they are done with defining the geometry
     // of what they want to draw. We now need to do a few things (https://www.khronos.org/opengl/wiki/Rendering_Pipeline_Overview):
@@ -658,65 +882,79 @@ void Device::draw_primitives(PrimitiveType primitive_type, FloatMatrix4x4 const&
     m_triangle_list.clear_with_capacity();
     m_processed_triangles.clear_with_capacity();
 
+    // Strips, fans and quads share most of their vertices between triangles, and indexed draws may use a vertex any
+    // number of times; so every vertex is transformed and lit once, before it is assembled into triangles.
+    m_transformed_vertices.clear_with_capacity();
+    m_transformed_vertices.extend(vertices);
+    for (auto& vertex : m_transformed_vertices)
+        transform_and_light_vertex(vertex, model_view_transform, projection_transform);
+
+    size_t const vertex_count = indices ? indices->size() : vertices.size();
+    auto vertex_at = [&](size_t i) -> Vertex const& {
+        return m_transformed_vertices[indices ? indices->at(i) : i];
+    };
+
     // Let's construct some triangles
     if (primitive_type == PrimitiveType::Triangles) {
         Triangle triangle;
-        if (vertices.size() < 3)
+        if (vertex_count < 3)
             return;
-        for (size_t i = 0; i < vertices.size() - 2; i += 3) {
-            triangle.vertices[0] = vertices.at(i);
-            triangle.vertices[1] = vertices.at(i + 1);
-            triangle.vertices[2] = vertices.at(i + 2);
+        for (size_t i = 0; i < vertex_count - 2; i += 3) {
+            triangle.vertices[0] = vertex_at(i);
+            triangle.vertices[1] = vertex_at(i + 1);
+            triangle.vertices[2] = vertex_at(i + 2);
 
             m_triangle_list.append(triangle);
         }
     } else if (primitive_type == PrimitiveType::Quads) {
         // We need to construct two triangles to form the quad
         Triangle triangle;
-        if (vertices.size() < 4)
+        if (vertex_count < 4)
             return;
-        for (size_t i = 0; i < vertices.size() - 3; i += 4) {
+        for (size_t i = 0; i < vertex_count - 3; i += 4) {
             // Triangle 1
-            triangle.vertices[0] = vertices.at(i);
-            triangle.vertices[1] = vertices.at(i + 1);
-            triangle.vertices[2] = vertices.at(i + 2);
+            triangle.vertices[0] = vertex_at(i);
+            triangle.vertices[1] = vertex_at(i + 1);
+            triangle.vertices[2] = vertex_at(i + 2);
             m_triangle_list.append(triangle);
 
             // Triangle 2
-            triangle.vertices[0] = vertices.at(i + 2);
-            triangle.vertices[1] = vertices.at(i + 3);
-            triangle.vertices[2] = vertices.at(i);
+            triangle.vertices[0] = vertex_at(i + 2);
+            triangle.vertices[1] = vertex_at(i + 3);
+            triangle.vertices[2] = vertex_at(i);
             m_triangle_list.append(triangle);
         }
     } else if (primitive_type == PrimitiveType::TriangleFan) {
         Triangle triangle;
-        triangle.vertices[0] = vertices.at(0); // Root vertex is always the vertex defined first
+        if (vertex_count < 3)
+            return;
+        triangle.vertices[0] = vertex_at(0); // Root vertex is always the vertex defined first
 
         // This is technically `n-2` triangles. We start at index 1
-        for (size_t i = 1; i < vertices.size() - 1; i++) {
-            triangle.vertices[1] = vertices.at(i);
-            triangle.vertices[2] = vertices.at(i + 1);
+        for (size_t i = 1; i < vertex_count - 1; i++) {
+            triangle.vertices[1] = vertex_at(i);
+            triangle.vertices[2] = vertex_at(i + 1);
             m_triangle_list.append(triangle);
         }
     } else if (primitive_type == PrimitiveType::TriangleStrip) {
         Triangle triangle;
-        if (vertices.size() < 3)
+        if (vertex_count < 3)
             return;
-        for (size_t i = 0; i < vertices.size() - 2; i++) {
+        for (size_t i = 0; i < vertex_count - 2; i++) {
             if (i % 2 == 0) {
-                triangle.vertices[0] = vertices.at(i);
-                triangle.vertices[1] = vertices.at(i + 1);
-                triangle.vertices[2] = vertices.at(i + 2);
+                triangle.vertices[0] = vertex_at(i);
+                triangle.vertices[1] = vertex_at(i + 1);
+                triangle.vertices[2] = vertex_at(i + 2);
             } else {
-                triangle.vertices[0] = vertices.at(i + 1);
-                triangle.vertices[1] = vertices.at(i);
-                triangle.vertices[2] = vertices.at(i + 2);
+                triangle.vertices[0] = vertex_at(i + 1);
+                triangle.vertices[1] = vertex_at(i);
+                triangle.vertices[2] = vertex_at(i + 2);
             }
             m_triangle_list.append(triangle);
         }
     }
 
-    // Now let's transform each triangle and send that to the GPU
+    // Now let's clip each triangle and send that to the GPU
     auto const viewport = m_options.viewport;
     auto const viewport_half_width = viewport.width() / 2.0f;
     auto const viewport_half_height = viewport.height() / 2.0f;
@@ -725,138 +963,6 @@ void Device::draw_primitives(PrimitiveType primitive_type, FloatMatrix4x4 const&
     auto const depth_half_range = (m_options.depth_max - m_options.depth_min) / 2;
     auto const depth_halfway = (m_options.depth_min + m_options.depth_max) / 2;
     for (auto& triangle : m_triangle_list) {
-        // Transform vertices into eye coordinates using the model-view transform
-        triangle.vertices[0].eye_coordinates = model_view_transform * triangle.vertices[0].position;
-        triangle.vertices[1].eye_coordinates = model_view_transform * triangle.vertices[1].position;
-        triangle.vertices[2].eye_coordinates = model_view_transform * triangle.vertices[2].position;
-
-        // Transform the vertex normals into eye-space
-        triangle.vertices[0].normal = transform_direction(model_view_transform, triangle.vertices[0].normal);
-        triangle.vertices[1].normal = transform_direction(model_view_transform, triangle.vertices[1].normal);
-        triangle.vertices[2].normal = transform_direction(model_view_transform, triangle.vertices[2].normal);
-
-        // Calculate per-vertex lighting
-        if (m_options.lighting_enabled) {
-            auto const& material = m_materials.at(0);
-            for (auto& vertex : triangle.vertices) {
-                auto ambient = material.ambient;
-                auto diffuse = material.diffuse;
-                auto emissive = material.emissive;
-                auto specular = material.specular;
-
-                if (m_options.color_material_enabled
-                    && (m_options.color_material_face == ColorMaterialFace::Front || m_options.color_material_face == ColorMaterialFace::FrontAndBack)) {
-                    switch (m_options.color_material_mode) {
-                    case ColorMaterialMode::Ambient:
-                        ambient = vertex.color;
-                        break;
-                    case ColorMaterialMode::AmbientAndDiffuse:
-                        ambient = vertex.color;
-                        diffuse = vertex.color;
-                        break;
-                    case ColorMaterialMode::Diffuse:
-                        diffuse = vertex.color;
-                        break;
-                    case ColorMaterialMode::Emissive:
-                        emissive = vertex.color;
-                        break;
-                    case ColorMaterialMode::Specular:
-                        specular = vertex.color;
-                        break;
-                    }
-                }
-
-                FloatVector4 result_color = emissive + (ambient * m_lighting_model.scene_ambient_color);
-
-                for (auto const& light : m_lights) {
-                    if (!light.is_enabled)
-                        continue;
-
-                    // We need to save the length here because the attenuation factor requires a non-normalized vector!
-                    auto sgi_arrow_operator = [](FloatVector4 const& p1, FloatVector4 const& p2, float& output_length) {
-                        FloatVector3 light_vector;
-                        if ((p1.w() != 0.f) && (p2.w() == 0.f))
-                            light_vector = p2.xyz();
-                        else if ((p1.w() == 0.f) && (p2.w() != 0.f))
-                            light_vector = -p1.xyz();
-                        else
-                            light_vector = p2.xyz() - p1.xyz();
-
-                        output_length = light_vector.length();
-                        if (output_length == 0.f)
-                            return light_vector;
-                        return light_vector / output_length;
-                    };
-
-                    auto sgi_dot_operator = [](FloatVector3 const& d1, FloatVector3 const& d2) {
-                        return AK::max(d1.dot(d2), 0.0f);
-                    };
-
-                    float vertex_to_light_length = 0.f;
-                    FloatVector3 vertex_to_light = sgi_arrow_operator(vertex.eye_coordinates, light.position, vertex_to_light_length);
-
-                    // Light attenuation value.
-                    float light_attenuation_factor = 1.0f;
-                    if (light.position.w() != 0.0f)
-                        light_attenuation_factor = 1.0f / (light.constant_attenuation + (light.linear_attenuation * vertex_to_light_length) + (light.quadratic_attenuation * vertex_to_light_length * vertex_to_light_length));
-
-                    // Spotlight factor
-                    float spotlight_factor = 1.0f;
-                    if (light.spotlight_cutoff_angle != 180.0f) {
-                        auto const vertex_to_light_dot_spotlight_direction = sgi_dot_operator(vertex_to_light, light.spotlight_direction.normalized());
-                        auto const cos_spotlight_cutoff = AK::cos<float>(light.spotlight_cutoff_angle * AK::Pi<float> / 180.f);
-
-                        if (vertex_to_light_dot_spotlight_direction >= cos_spotlight_cutoff)
-                            spotlight_factor = AK::pow<float>(vertex_to_light_dot_spotlight_direction, light.spotlight_exponent);
-                        else
-                            spotlight_factor = 0.0f;
-                    }
-
-                    // FIXME: The spec allows for splitting the colors calculated here into multiple different colors (primary/secondary color). Investigate what this means.
-                    (void)m_lighting_model.single_color;
-
-                    // FIXME: Two sided lighting should be implemented eventually (I believe this is where the normals are -ve and then lighting is calculated with the BACK material)
-                    (void)m_lighting_model.two_sided_lighting;
-
-                    // Ambient
-                    auto const ambient_component = ambient * light.ambient_intensity;
-
-                    // Diffuse
-                    auto const normal_dot_vertex_to_light = sgi_dot_operator(vertex.normal, vertex_to_light);
-                    auto const diffuse_component = ((diffuse * light.diffuse_intensity) * normal_dot_vertex_to_light);
-
-                    // Specular
-                    FloatVector4 specular_component = { 0.0f, 0.0f, 0.0f, 0.0f };
-                    if (normal_dot_vertex_to_light > 0.0f) {
-                        FloatVector3 half_vector_normalized;
-                        if (!m_lighting_model.viewer_at_infinity) {
-                            half_vector_normalized = (vertex_to_light + FloatVector3(0.0f, 0.0f, 1.0f)).normalized();
-                        } else {
-                            auto const vertex_to_eye_point = sgi_arrow_operator(vertex.eye_coordinates.normalized(), { 0.f, 0.f, 0.f, 1.f }, vertex_to_light_length);
-                            half_vector_normalized = vertex_to_light + vertex_to_eye_point;
-                        }
-
-                        auto const normal_dot_half_vector = sgi_dot_operator(vertex.normal.normalized(), half_vector_normalized);
-                        auto const specular_coefficient = AK::pow(normal_dot_half_vector, material.shininess);
-                        specular_component = (specular * light.specular_intensity) * specular_coefficient;
-                    }
-
-                    auto color = ambient_component + diffuse_component + specular_component;
-                    color = color * light_attenuation_factor * spotlight_factor;
-                    result_color += color;
-                }
-
-                vertex.color = result_color;
-                vertex.color.set_w(diffuse.w()); // OpenGL 1.5 spec, page 59: "The A produced by lighting is the alpha value associated with diffuse color material"
-                vertex.color.clamp(0.0f, 1.0f);
-            }
-        }
-
-        // Transform eye coordinates into clip coordinates using the projection transform
-        triangle.vertices[0].clip_coordinates = projection_transform * triangle.vertices[0].eye_coordinates;
-        triangle.vertices[1].clip_coordinates = projection_transform * triangle.vertices[1].eye_coordinates;
-        triangle.vertices[2].clip_coordinates = projection_transform * triangle.vertices[2].eye_coordinates;
-
         // At this point, we're in clip space
         // Here's where we do the clipping. This is a really crude implementation of the
         // https://learnopengl.com/Getting-started/Coordinate-Systems
@@ -913,6 +1019,7 @@ void Device::draw_primitives(PrimitiveType primitive_type, FloatMatrix4x4 const&
         }
     }
 
+    size_t visible_triangle_count = 0;
     for (auto& triangle : m_processed_triangles) {
         // Let's calculate the (signed) area of the triangle
         // https://cp-algorithms.com/geometry/oriented-triangle-area.html
@@ -961,8 +1068,11 @@ void Device::draw_primitives(PrimitiveType primitive_type, FloatMatrix4x4 const&
             triangle.vertices[2].tex_coords[i] = texture_transform * triangle.vertices[2].tex_coords[i];
         }
 
-        rasterize_triangle(triangle);
+        m_processed_triangles[visible_triangle_count++] = triangle;
     }
+    m_processed_triangles.shrink(visible_triangle_count);
+
+    rasterize_triangles(m_processed_triangles);
 }
 
 ALWAYS_INLINE void Device::shade_fragments(PixelQuad& quad)
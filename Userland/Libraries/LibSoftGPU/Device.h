@@ -116,6 +116,8 @@ public:
     DeviceInfo info() const;
 
     void draw_primitives(PrimitiveType, FloatMatrix4x4 const& model_view_transform, FloatMatrix3x3 const& normal_transform, FloatMatrix4x4 const& projection_transform, FloatMatrix4x4 const& texture_transform, Vector<Vertex> const& vertices, Vector<size_t> const& enabled_texture_units);
+    // Draws the vertices in the order given by `indices`, transforming each of them only once however often it's used.
+    void draw_primitives(PrimitiveType, FloatMatrix4x4 const& model_view_transform, FloatMatrix3x3 const& normal_transform, FloatMatrix4x4 const& projection_transform, FloatMatrix4x4 const& texture_transform, Vector<Vertex> const& vertices, Vector<u32> const& indices, Vector<size_t> const& enabled_texture_units);
     void resize(Gfx::IntSize const& min_size);
     void clear_color(FloatVector4 const&);
     void clear_depth(DepthType);
@@ -145,7 +147,11 @@ private:
     void draw_statistics_overlay(Gfx::Bitmap&);
     Gfx::IntRect get_rasterization_rect_of_size(Gfx::IntSize size);
 
-    void rasterize_triangle(const Triangle& triangle);
+    void draw_primitives(PrimitiveType, FloatMatrix4x4 const& model_view_transform, FloatMatrix3x3 const& normal_transform, FloatMatrix4x4 const& projection_transform, FloatMatrix4x4 const& texture_transform, Vector<Vertex> const& vertices, Vector<u32> const* indices, Vector<size_t> const& enabled_texture_units);
+    void transform_and_light_vertex(Vertex&, FloatMatrix4x4 const& model_view_transform, FloatMatrix4x4 const& projection_transform);
+
+    void rasterize_triangles(Vector<Triangle> const&);
+    void rasterize_triangle(Triangle const&, Gfx::IntRect const& render_bounds);
     void setup_blend_factors();
     void shade_fragments(PixelQuad&);
     bool test_alpha(PixelQuad&);
@@ -154,8 +160,11 @@ private:
     RasterizerOptions m_options;
     LightModelParameters m_lighting_model;
     Clipper m_clipper;
+    Vector<Vertex> m_transformed_vertices;
     Vector<Triangle> m_triangle_list;
     Vector<Triangle> m_processed_triangles;
+    // For every tile, the triangles (indices into m_processed_triangles) whose bounding box touches it, in the order they were drawn.
+    Vector<Vector<u32>> m_tile_triangle_indices;
     Vector<Vertex> m_clipped_vertices;
     Array<Sampler, NUM_SAMPLERS> m_samplers;
     Vector<size_t> m_enabled_texture_units;
@@ -10,6 +10,7 @@
 #include <AK/FixedArray.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
+#include <AK/SIMDExtras.h>
 #include <LibGfx/Vector3.h>
 #include <LibGfx/Vector4.h>
 #include <LibSoftGPU/Buffer/Typed3DBuffer.h>
@@ -37,6 +38,23 @@ public:
         return unpack_color(texel_pointer(layer, level, x, y, z), ImageFormat::BGRA8888);
     }
 
+    // Fetches four texels at once, in their packed BGRA8888 form. All coordinates have to be within their level.
+    ALWAYS_INLINE AK::SIMD::u32x4 texels(unsigned layer, AK::SIMD::u32x4 level, AK::SIMD::u32x4 x, AK::SIMD::u32x4 y, AK::SIMD::u32x4 z) const
+    {
+        if (level[0] == level[1] && level[0] == level[2] && level[0] == level[3]) {
+            // All four texels come from the same level (which they nearly always do), so their offsets can be calculated at once.
+            auto const& buffer = *m_mipmap_buffers[layer * m_num_layers + level[0]];
+            auto const* data = buffer.buffer_pointer(0, 0, 0);
+            AK::SIMD::u32x4 offsets = (z * static_cast<u32>(buffer.height()) + y) * static_cast<u32>(buffer.width()) + x;
+            return AK::SIMD::load4(&data[offsets[0]], &data[offsets[1]], &data[offsets[2]], &data[offsets[3]]);
+        }
+        return AK::SIMD::load4(
+            static_cast<ColorType const*>(texel_pointer(layer, level[0], x[0], y[0], z[0])),
+            static_cast<ColorType const*>(texel_pointer(layer, level[1], x[1], y[1], z[1])),
+            static_cast<ColorType const*>(texel_pointer(layer, level[2], x[2], y[2], z[2])),
+            static_cast<ColorType const*>(texel_pointer(layer, level[3], x[3], y[3], z[3])));
+    }
+
     void set_texel(unsigned layer, unsigned level, int x, int y, int z, FloatVector4 const& color)
     {
         pack_color(color, texel_pointer(layer, level, x, y, z), ImageFormat::BGRA8888);
@@ -103,6 +103,18 @@ ALWAYS_INLINE static Vector2<AK::SIMD::f32x4> ddy(Vector2<AK::SIMD::f32x4> const
     };
 }
 
+// Unpacks four BGRA8888 colors into their (normalized) red, green, blue and alpha components.
+ALWAYS_INLINE static Vector4<AK::SIMD::f32x4> to_vec4(AK::SIMD::u32x4 bgra)
+{
+    auto constexpr one_over_255 = AK::SIMD::expand4(1.0f / 255);
+    return {
+        AK::SIMD::to_f32x4((bgra >> 16) & 0xff) * one_over_255,
+        AK::SIMD::to_f32x4((bgra >> 8) & 0xff) * one_over_255,
+        AK::SIMD::to_f32x4(bgra & 0xff) * one_over_255,
+        AK::SIMD::to_f32x4((bgra >> 24) & 0xff) * one_over_255,
+    };
+}
+
 // Calculates a quadratic approximation of log2, exploiting the fact that IEEE754 floats are represented as mantissa * 2^exponent.
 // See https://stackoverflow.com/questions/9411823/fast-log2float-x-implementation-c
 ALWAYS_INLINE static AK::SIMD::f32x4 log2_approximate(AK::SIMD::f32x4 v)
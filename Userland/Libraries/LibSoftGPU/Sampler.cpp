@@ -22,7 +22,7 @@ using AK::SIMD::clamp;
 using AK::SIMD::expand4;
 using AK::SIMD::floor_int_range;
 using AK::SIMD::frac_int_range;
-using AK::SIMD::maskbits;
+using AK::SIMD::none;
 using AK::SIMD::to_f32x4;
 using AK::SIMD::to_i32x4;
 using AK::SIMD::to_u32x4;
@@ -74,33 +74,28 @@ static f32x4 wrap(f32x4 value, TextureWrapMode mode, u32x4 num_texels)
 
 ALWAYS_INLINE static Vector4<f32x4> texel4(Image const& image, u32x4 layer, u32x4 level, u32x4 x, u32x4 y, u32x4 z)
 {
-    auto t0 = image.texel(layer[0], level[0], x[0], y[0], z[0]);
-    auto t1 = image.texel(layer[1], level[1], x[1], y[1], z[1]);
-    auto t2 = image.texel(layer[2], level[2], x[2], y[2], z[2]);
-    auto t3 = image.texel(layer[3], level[3], x[3], y[3], z[3]);
-
-    return Vector4<f32x4> {
-        f32x4 { t0.x(), t1.x(), t2.x(), t3.x() },
-        f32x4 { t0.y(), t1.y(), t2.y(), t3.y() },
-        f32x4 { t0.z(), t1.z(), t2.z(), t3.z() },
-        f32x4 { t0.w(), t1.w(), t2.w(), t3.w() },
-    };
+    return to_vec4(image.texels(layer[0], level, x, y, z));
 }
 
 ALWAYS_INLINE static Vector4<f32x4> texel4border(Image const& image, u32x4 layer, u32x4 level, u32x4 x, u32x4 y, u32x4 z, FloatVector4 const& border, u32x4 w, u32x4 h)
 {
-    auto border_mask = maskbits(x < 0 || x >= w || y < 0 || y >= h);
-
-    auto t0 = border_mask & 1 ? border : image.texel(layer[0], level[0], x[0], y[0], z[0]);
-    auto t1 = border_mask & 2 ? border : image.texel(layer[1], level[1], x[1], y[1], z[1]);
-    auto t2 = border_mask & 4 ? border : image.texel(layer[2], level[2], x[2], y[2], z[2]);
-    auto t3 = border_mask & 8 ? border : image.texel(layer[3], level[3], x[3], y[3], z[3]);
-
-    return Vector4<f32x4> {
-        f32x4 { t0.x(), t1.x(), t2.x(), t3.x() },
-        f32x4 { t0.y(), t1.y(), t2.y(), t3.y() },
-        f32x4 { t0.z(), t1.z(), t2.z(), t3.z() },
-        f32x4 { t0.w(), t1.w(), t2.w(), t3.w() },
+    // Coordinates that are out of bounds (where negative ones have wrapped around) get the border color instead.
+    // They're replaced by zero first, so that fetching the texels doesn't go out of bounds.
+    auto border_mask = x >= w || y >= h;
+    if (none(border_mask))
+        return texel4(image, layer, level, x, y, z);
+
+    auto const in_bounds_mask = bit_cast<u32x4>(~border_mask);
+    auto texels = texel4(image, layer, level, x & in_bounds_mask, y & in_bounds_mask, z & in_bounds_mask);
+
+    auto select_border = [&](f32x4 value, float border_value) {
+        return bit_cast<f32x4>((bit_cast<u32x4>(value) & in_bounds_mask) | (bit_cast<u32x4>(expand4(border_value)) & ~in_bounds_mask));
+    };
+    return {
+        select_border(texels.x(), border.x()),
+        select_border(texels.y(), border.y()),
+        select_border(texels.z(), border.z()),
+        select_border(texels.w(), border.w()),
     };
 }
 
@@ -155,18 +150,25 @@ Vector4<AK::SIMD::f32x4> Sampler::sample_2d_lod(Vector2<AK::SIMD::f32x4> const&
     auto const& image = *m_config.bound_image;
     u32x4 const layer = expand4(0u);
 
-    u32x4 const width = {
-        image.level_width(level[0]),
-        image.level_width(level[1]),
-        image.level_width(level[2]),
-        image.level_width(level[3]),
-    };
-    u32x4 const height = {
-        image.level_height(level[0]),
-        image.level_height(level[1]),
-        image.level_height(level[2]),
-        image.level_height(level[3]),
-    };
+    u32x4 width;
+    u32x4 height;
+    if (level[0] == level[1] && level[0] == level[2] && level[0] == level[3]) {
+        width = expand4(image.level_width(level[0]));
+        height = expand4(image.level_height(level[0]));
+    } else {
+        width = u32x4 {
+            image.level_width(level[0]),
+            image.level_width(level[1]),
+            image.level_width(level[2]),
+            image.level_width(level[3]),
+        };
+        height = u32x4 {
+            image.level_height(level[0]),
+            image.level_height(level[1]),
+            image.level_height(level[2]),
+            image.level_height(level[3]),
+        };
+    }
 
     u32x4 width_mask = width - 1;
     u32x4 height_mask = height - 1;
@@ -19,8 +19,9 @@ namespace Symbolication {
 
 struct CachedELF {
     NonnullRefPtr<Core::MappedFile> mapped_file;
-    NonnullOwnPtr<Debug::DebugInfo> debug_info;
     NonnullOwnPtr<ELF::Image> image;
+    // Parsing the DWARF data is expensive, so only do it once someone asks for source positions.
+    OwnPtr<Debug::DebugInfo> debug_info;
 };
 
 static HashMap<String, OwnPtr<CachedELF>> s_cache;
@@ -65,6 +66,8 @@ Optional<Symbol> symbolicate(String const& path, FlatPtr address, IncludeSourceP
 {
     String full_path = path;
     if (!path.starts_with('/')) {
+        if (auto it = s_cache.find(path); it != s_cache.end() && !it->value)
+            return {};
         Array<StringView, 2> search_paths { "/usr/lib"sv, "/usr/local/lib"sv };
         bool found = false;
         for (auto& search_path : search_paths) {
@@ -93,7 +96,7 @@ Optional<Symbol> symbolicate(String const& path, FlatPtr address, IncludeSourceP
             s_cache.set(full_path, {});
             return {};
         }
-        auto cached_elf = make<CachedELF>(mapped_file.release_value(), make<Debug::DebugInfo>(*elf), move(elf));
+        auto cached_elf = make<CachedELF>(mapped_file.release_value(), move(elf));
         s_cache.set(full_path, move(cached_elf));
     }
 
@@ -105,10 +108,12 @@ Optional<Symbol> symbolicate(String const& path, FlatPtr address, IncludeSourceP
         return {};
 
     u32 offset = 0;
-    auto symbol = cached_elf->debug_info->elf().symbolicate(address, &offset);
+    auto symbol = cached_elf->image->symbolicate(address, &offset);
 
     Vector<Debug::DebugInfo::SourcePosition> positions;
     if (include_source_positions == IncludeSourcePosition::Yes) {
+        if (!cached_elf->debug_info)
+            cached_elf->debug_info = make<Debug::DebugInfo>(*cached_elf->image);
         auto source_position_with_inlines = cached_elf->debug_info->get_source_position_with_inlines(address);
 
         for (auto& position : source_position_with_inlines.inline_chain) {
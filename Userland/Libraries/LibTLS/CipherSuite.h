@@ -35,6 +35,10 @@ enum class CipherSuite {
     ECDHE_RSA_WITH_AES_128_GCM_SHA256 = 0xC02F,
     ECDHE_RSA_WITH_AES_256_GCM_SHA384 = 0xC030,
 
+    // RFC 7905 - ChaCha20-Poly1305 Cipher Suites
+    ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256 = 0xCCA8,
+    DHE_RSA_WITH_CHACHA20_POLY1305_SHA256 = 0xCCAA,
+
     // All recommended cipher suites (according to https://ciphersuite.info/cs/)
 
     // RFC 5288 - DH, DHE and RSA for AES-GCM
@@ -170,6 +174,7 @@ enum class CipherAlgorithm {
     AES_128_CCM_8,
     AES_256_CBC,
     AES_256_GCM,
+    CHACHA20_POLY1305,
 };
 
 constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
@@ -182,6 +187,7 @@ constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
         return 128;
     case CipherAlgorithm::AES_256_CBC:
     case CipherAlgorithm::AES_256_GCM:
+    case CipherAlgorithm::CHACHA20_POLY1305:
         return 256;
     case CipherAlgorithm::Invalid:
     default:
@@ -189,6 +195,23 @@ constexpr size_t cipher_key_size(CipherAlgorithm algorithm)
     }
 }
 
+// The part of the AEAD nonce that is derived from the master secret. AES-GCM sends the rest of it along with every
+// record (RFC 5288 section 3), ChaCha20-Poly1305 doesn't send any of it and mixes in the sequence number instead (RFC 7905 section 2).
+constexpr size_t aead_fixed_iv_length(CipherAlgorithm algorithm)
+{
+    switch (algorithm) {
+    case CipherAlgorithm::AES_128_GCM:
+    case CipherAlgorithm::AES_256_GCM:
+    case CipherAlgorithm::AES_128_CCM:
+    case CipherAlgorithm::AES_128_CCM_8:
+        return 4;
+    case CipherAlgorithm::CHACHA20_POLY1305:
+        return 12;
+    default:
+        return 0;
+    }
+}
+
 enum class NamedCurve : u16 {
     secp256r1 = 23,
     secp384r1 = 24,
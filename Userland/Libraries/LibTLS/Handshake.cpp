@@ -35,6 +35,26 @@ ByteBuffer TLSv12::build_hello()
     builder.append(version);
     builder.append(m_context.local_random, sizeof(m_context.local_random));
 
+    auto& session_cache = m_context.options.session_cache;
+    bool can_resume_session = session_cache && m_context.options.use_sni && !m_context.extensions.SNI.is_null();
+    if (can_resume_session && m_context.connection_status == ConnectionStatus::Disconnected) {
+        m_context.session_to_resume = session_cache->find(m_context.extensions.SNI);
+        if (m_context.session_to_resume.has_value()) {
+            auto& session = *m_context.session_to_resume;
+            dbgln_if(TLS_DEBUG, "Offering to resume a session with {}", m_context.extensions.SNI);
+            if (!session.id.is_empty()) {
+                m_context.session_id_size = session.id.size();
+                session.id.bytes().copy_to({ m_context.session_id, sizeof(m_context.session_id) });
+            } else {
+                // RFC 5077 section 3.4: "When presenting a ticket, the client MAY generate and include a Session ID in the TLS ClientHello.
+                //                        If the server accepts the ticket and the Session ID is not empty, then it MUST respond with
+                //                        the same Session ID present in the ClientHello."
+                m_context.session_id_size = sizeof(m_context.session_id);
+                fill_with_random(m_context.session_id, sizeof(m_context.session_id));
+            }
+        }
+    }
+
     builder.append(m_context.session_id_size);
     if (m_context.session_id_size)
         builder.append(m_context.session_id, m_context.session_id_size);
@@ -82,6 +102,14 @@ ByteBuffer TLSv12::build_hello()
     if (sni_length)
         extension_length += sni_length + 9;
 
+    // session_ticket: empty if we have no ticket, to let the server know that we'd like one.
+    ReadonlyBytes session_ticket;
+    if (can_resume_session) {
+        if (m_context.session_to_resume.has_value())
+            session_ticket = m_context.session_to_resume->ticket;
+        extension_length += 4 + session_ticket.size();
+    }
+
     // Only send elliptic_curves and ec_point_formats extensions if both are supported
     if (supports_elliptic_curves)
         extension_length += 6 + elliptic_curves_length + 5 + supported_ec_point_formats_length;
@@ -102,6 +130,13 @@ ByteBuffer TLSv12::build_hello()
         builder.append((const u8*)m_context.extensions.SNI.characters(), sni_length);
     }
 
+    if (can_resume_session) {
+        // SessionTicket extension (RFC 5077)
+        builder.append((u16)HandshakeExtension::SessionTicket);
+        builder.append((u16)session_ticket.size());
+        builder.append(session_ticket);
+    }
+
     // signature_algorithms extension
     builder.append((u16)HandshakeExtension::SignatureAlgorithms);
     // Extension length
@@ -131,8 +166,20 @@ ByteBuffer TLSv12::build_hello()
     }
 
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // ALPN extension (RFC 7301)
+        builder.append((u16)HandshakeExtension::ApplicationLayerProtocolNegotiation);
+        builder.append((u16)(alpn_length + 2));
+        // ProtocolNameList length
+        builder.append((u16)alpn_length);
+        if (alpn_negotiated_length) {
+            builder.append((u8)alpn_negotiated_length);
+            builder.append(m_context.negotiated_alpn.bytes());
+        } else {
+            for (auto& alpn : m_context.alpn) {
+                builder.append((u8)alpn.length());
+                builder.append(alpn.bytes());
+            }
+        }
     }
 
     // set the "length" field of the packet
@@ -218,6 +265,18 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
 
     // TODO: Compare Hashes
     dbgln_if(TLS_DEBUG, "FIXME: handle_handshake_finished :: Check message validity");
+
+    // In an abbreviated handshake the server finishes first, and ours has to go out before any application data does.
+    if (m_context.is_resumed_session)
+        write_packets = WritePacketStage::Finished;
+    else
+        did_establish_connection();
+
+    return index + size;
+}
+
+void TLSv12::did_establish_connection()
+{
     m_context.connection_status = ConnectionStatus::Established;
 
     if (m_handshake_timeout_timer) {
@@ -227,10 +286,41 @@ ssize_t TLSv12::handle_handshake_finished(ReadonlyBytes buffer, WritePacketStage
         m_handshake_timeout_timer = nullptr;
     }
 
+    store_session();
+
     if (on_connected)
         on_connected();
+}
 
-    return index + size;
+void TLSv12::store_session()
+{
+    auto& session_cache = m_context.options.session_cache;
+    if (!session_cache || m_context.extensions.SNI.is_null())
+        return;
+
+    Session session;
+    if (m_context.is_resumed_session) {
+        // A resumed session doesn't live any longer than it would have otherwise, but the server may have given us a new ticket for it.
+        session = m_context.session_to_resume.release_value();
+    } else {
+        session.cipher = m_context.cipher;
+        session.master_key = m_context.master_key;
+        session.expiry_time = time(nullptr) + SessionCache::max_lifetime_in_seconds;
+    }
+
+    session.id = ByteBuffer::copy(m_context.session_id, m_context.session_id_size).release_value_but_fixme_should_propagate_errors();
+    if (!m_context.session_ticket.is_empty()) {
+        session.ticket = m_context.session_ticket;
+        if (m_context.session_ticket_lifetime_hint)
+            session.expiry_time = min(session.expiry_time, time(nullptr) + m_context.session_ticket_lifetime_hint);
+    }
+
+    if (session.id.is_empty() && session.ticket.is_empty()) {
+        dbgln_if(TLS_DEBUG, "{} doesn't support session resumption", m_context.extensions.SNI);
+        session_cache->remove(m_context.extensions.SNI);
+        return;
+    }
+    session_cache->store(m_context.extensions.SNI, move(session));
 }
 
 ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
@@ -299,6 +389,20 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
             dbgln("unsupported: DTLS");
             payload_res = (i8)Error::UnexpectedMessage;
             break;
+        case NewSessionTicket:
+            if (m_context.handshake_messages[11] >= 1) {
+                dbgln("unexpected new session ticket message");
+                payload_res = (i8)Error::UnexpectedMessage;
+                break;
+            }
+            ++m_context.handshake_messages[11];
+            dbgln_if(TLS_DEBUG, "new session ticket");
+            if (m_context.is_server) {
+                dbgln("unsupported: server mode");
+                VERIFY_NOT_REACHED();
+            }
+            payload_res = handle_new_session_ticket(buffer.slice(1, payload_size));
+            break;
         case CertificateMessage:
             if (m_context.handshake_messages[4] >= 1) {
                 dbgln("unexpected certificate message");
@@ -553,7 +657,7 @@ ssize_t TLSv12::handle_handshake_payload(ReadonlyBytes vbuffer)
                 auto packet = build_handshake_finished();
                 write_packet(packet);
             }
-            m_context.connection_status = ConnectionStatus::Established;
+            did_establish_connection();
             break;
         }
         payload_size++;
@@ -44,7 +44,7 @@ bool TLSv12::expand_key()
 
     size_t offset = 0;
     if (is_aead) {
-        iv_size = 4; // Explicit IV size.
+        iv_size = aead_fixed_iv_length(get_cipher_algorithm(m_context.cipher));
     } else {
         memcpy(m_context.crypto.local_mac, key + offset, mac_size);
         offset += mac_size;
@@ -99,6 +99,15 @@ bool TLSv12::expand_key()
         m_cipher_remote = Crypto::Cipher::AESCipher::GCMMode(ReadonlyBytes { server_key, key_size }, key_size * 8, Crypto::Cipher::Intent::Decryption, Crypto::Cipher::PaddingMode::RFC5246);
         break;
     }
+    case CipherAlgorithm::CHACHA20_POLY1305: {
+        VERIFY(is_aead);
+        memcpy(m_context.crypto.local_aead_iv, client_iv, iv_size);
+        memcpy(m_context.crypto.remote_aead_iv, server_iv, iv_size);
+
+        m_cipher_local = Crypto::Cipher::ChaCha20Poly1305(ReadonlyBytes { client_key, key_size });
+        m_cipher_remote = Crypto::Cipher::ChaCha20Poly1305(ReadonlyBytes { server_key, key_size });
+        break;
+    }
     case CipherAlgorithm::AES_128_CCM:
         dbgln("Requested unimplemented AES CCM cipher");
         TODO();
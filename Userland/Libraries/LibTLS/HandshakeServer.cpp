@@ -57,6 +57,14 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         return (i8)Error::NeedMoreData;
     }
 
+    // RFC 5246 section 7.4.1.3: "If the ClientHello.session_id was non-empty, the server will look in its session cache for a match.
+    //                            If a match is found and the server is willing to establish the new connection using the specified
+    //                            session state, the server will respond with the same value as was supplied by the client."
+    m_context.is_resumed_session = m_context.session_to_resume.has_value()
+        && session_length
+        && session_length == m_context.session_id_size
+        && memcmp(m_context.session_id, buffer.offset_pointer(res), session_length) == 0;
+
     if (session_length && session_length <= 32) {
         memcpy(m_context.session_id, buffer.offset_pointer(res), session_length);
         m_context.session_id_size = session_length;
@@ -80,6 +88,10 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         dbgln("No supported cipher could be agreed upon");
         return (i8)Error::NoCommonCipher;
     }
+    if (m_context.is_resumed_session && cipher != m_context.session_to_resume->cipher) {
+        dbgln("Server resumed a session with a different cipher suite");
+        return (i8)Error::NotSafe;
+    }
     m_context.cipher = cipher;
     dbgln_if(TLS_DEBUG, "Cipher: {}", (u16)cipher);
 
@@ -148,26 +160,29 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         } else if (extension_type == HandshakeExtension::ApplicationLayerProtocolNegotiation && m_context.alpn.size()) {
             if (buffer.size() - res > 2) {
                 auto alpn_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(res)));
-                if (alpn_length && alpn_length <= extension_length - 2) {
+                if (alpn_length && alpn_length <= extension_length - 2 && buffer.size() - res - 2 >= alpn_length) {
                     const u8* alpn = buffer.offset_pointer(res + 2);
                     size_t alpn_position = 0;
                     while (alpn_position < alpn_length) {
                         u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
+                        if (alpn_size + alpn_position > alpn_length)
                             break;
-                        String alpn_str { (const char*)alpn + alpn_position, alpn_length };
+                        String alpn_str { (const char*)alpn + alpn_position, alpn_size };
                         if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
                             m_context.negotiated_alpn = alpn_str;
-                            dbgln("negotiated alpn: {}", alpn_str);
+                            dbgln_if(TLS_DEBUG, "negotiated alpn: {}", alpn_str);
                             break;
                         }
-                        alpn_position += alpn_length;
+                        alpn_position += alpn_size;
                         if (!m_context.is_server) // server hello must contain one ALPN
                             break;
                     }
                 }
             }
             res += extension_length;
+        } else if (extension_type == HandshakeExtension::SessionTicket) {
+            // RFC 5077 section 3.2: The server sends an empty extension to let us know that a NewSessionTicket message follows.
+            res += extension_length;
         } else if (extension_type == HandshakeExtension::SignatureAlgorithms) {
             dbgln("supported signatures: ");
             print_buffer(buffer.slice(res, extension_length));
@@ -189,6 +204,18 @@ ssize_t TLSv12::handle_server_hello(ReadonlyBytes buffer, WritePacketStage& writ
         }
     }
 
+    if (m_context.is_resumed_session) {
+        // The server skips straight to ChangeCipherSpec and Finished, using the keys of the session we're resuming.
+        dbgln_if(TLS_DEBUG, "Resuming the session with {}", m_context.extensions.SNI);
+        auto master_key = ByteBuffer::copy(m_context.session_to_resume->master_key);
+        if (master_key.is_error())
+            return (i8)Error::OutOfMemory;
+        m_context.master_key = master_key.release_value();
+        if (!expand_key())
+            return (i8)Error::NotSafe;
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+    }
+
     return res;
 }
 
@@ -205,6 +232,38 @@ ssize_t TLSv12::handle_server_hello_done(ReadonlyBytes buffer)
     return size + 3;
 }
 
+ssize_t TLSv12::handle_new_session_ticket(ReadonlyBytes buffer)
+{
+    if (m_context.connection_status != ConnectionStatus::KeyExchange) {
+        dbgln("unexpected new session ticket message");
+        return (i8)Error::UnexpectedMessage;
+    }
+
+    if (buffer.size() < 3)
+        return (i8)Error::NeedMoreData;
+
+    size_t size = buffer[0] * 0x10000 + buffer[1] * 0x100 + buffer[2];
+    if (buffer.size() - 3 < size)
+        return (i8)Error::NeedMoreData;
+    if (size < 6)
+        return (i8)Error::BrokenPacket;
+
+    m_context.session_ticket_lifetime_hint = AK::convert_between_host_and_network_endian(ByteReader::load32(buffer.offset_pointer(3)));
+    size_t ticket_length = AK::convert_between_host_and_network_endian(ByteReader::load16(buffer.offset_pointer(7)));
+    if (ticket_length != size - 6)
+        return (i8)Error::BrokenPacket;
+
+    // RFC 5077 section 3.3: "If the server determines that it does not want to include a ticket after it has included the SessionTicket
+    //                        extension in the ServerHello, then it sends a zero-length ticket in the NewSessionTicket handshake message."
+    auto ticket = ByteBuffer::copy(buffer.slice(9, ticket_length));
+    if (ticket.is_error())
+        return (i8)Error::OutOfMemory;
+    m_context.session_ticket = ticket.release_value();
+    dbgln_if(TLS_DEBUG, "Received a session ticket of {} bytes, to be used for up to {} seconds", ticket_length, m_context.session_ticket_lifetime_hint);
+
+    return size + 3;
+}
+
 ByteBuffer TLSv12::build_server_key_exchange()
 {
     dbgln("FIXME: build_server_key_exchange");
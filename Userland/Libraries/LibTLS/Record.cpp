@@ -14,6 +14,14 @@
 
 namespace TLS {
 
+// The record nonce is the fixed IV, with the sequence number XORed into its last 8 bytes (RFC 7905 section 2).
+static void build_chacha20_poly1305_nonce(u8 (&nonce)[12], u8 const (&fixed_iv)[12], u64 sequence_number)
+{
+    __builtin_memcpy(nonce, fixed_iv, sizeof(nonce));
+    for (size_t i = 0; i < 8; ++i)
+        nonce[11 - i] ^= static_cast<u8>(sequence_number >> (i * 8));
+}
+
 ByteBuffer TLSv12::build_alert(bool critical, u8 code)
 {
     PacketBuilder builder(MessageType::Alert, (u16)m_context.options.version);
@@ -90,6 +98,11 @@ void TLSv12::update_packet(ByteBuffer& packet)
                     padding = 0;
                     mac_size = 0; // AEAD provides its own authentication scheme.
                 },
+                [&](Crypto::Cipher::ChaCha20Poly1305&) {
+                    VERIFY(is_aead());
+                    padding = 0;
+                    mac_size = 0;
+                },
                 [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                     VERIFY(!is_aead());
                     block_size = cbc.cipher().block_size();
@@ -175,6 +188,44 @@ void TLSv12::update_packet(ByteBuffer& packet)
 
                         VERIFY(header_size + 8 + length + 16 == ct.size());
                     },
+                    [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+                        VERIFY(is_aead());
+                        // We need enough space for a header, the data and a tag, the nonce isn't sent at all
+                        auto ct_buffer_result = ByteBuffer::create_uninitialized(length + header_size + 16);
+                        if (ct_buffer_result.is_error()) {
+                            dbgln("LibTLS: Failed to allocate enough memory for the ciphertext");
+                            VERIFY_NOT_REACHED();
+                        }
+                        ct = ct_buffer_result.release_value();
+
+                        // copy the header over
+                        ct.overwrite(0, packet.data(), header_size - 2);
+
+                        // AEAD AAD (13), the same as for GCM
+                        u8 aad[13];
+                        Bytes aad_bytes { aad, 13 };
+                        OutputMemoryStream aad_stream { aad_bytes };
+
+                        u64 seq_no = AK::convert_between_host_and_network_endian(m_context.local_sequence_number);
+                        u16 len = AK::convert_between_host_and_network_endian((u16)(packet.size() - header_size));
+
+                        aad_stream.write({ &seq_no, sizeof(seq_no) });
+                        aad_stream.write(packet.bytes().slice(0, 3)); // content-type + version
+                        aad_stream.write({ &len, sizeof(len) });      // length
+                        VERIFY(aad_stream.is_end());
+
+                        u8 nonce[12];
+                        build_chacha20_poly1305_nonce(nonce, m_context.crypto.local_aead_iv, m_context.local_sequence_number);
+
+                        chacha.encrypt(
+                            packet.bytes().slice(header_size, length),
+                            ct.bytes().slice(header_size, length),
+                            { nonce, sizeof(nonce) },
+                            aad_bytes,
+                            ct.bytes().slice(header_size + length, 16));
+
+                        VERIFY(header_size + length + 16 == ct.size());
+                    },
                     [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                         VERIFY(!is_aead());
                         // We need enough space for a header, iv_length bytes of IV and whatever the packet contains
@@ -427,6 +478,56 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
                 plain = decrypted;
             },
+            [&](Crypto::Cipher::ChaCha20Poly1305& chacha) {
+                VERIFY(is_aead());
+                if (length < 16) {
+                    dbgln("Invalid packet length");
+                    auto packet = build_alert(true, (u8)AlertDescription::DecryptError);
+                    write_packet(packet);
+                    return_value = Error::BrokenPacket;
+                    return;
+                }
+
+                auto packet_length = length - 16;
+                auto decrypted_result = ByteBuffer::create_uninitialized(packet_length);
+                if (decrypted_result.is_error()) {
+                    dbgln("Failed to allocate memory for the packet");
+                    return_value = Error::DecryptionFailed;
+                    return;
+                }
+                decrypted = decrypted_result.release_value();
+
+                // AEAD AAD (13), the same as for GCM
+                u8 aad[13];
+                Bytes aad_bytes { aad, 13 };
+                OutputMemoryStream aad_stream { aad_bytes };
+
+                u64 seq_no = AK::convert_between_host_and_network_endian(m_context.remote_sequence_number);
+                u16 len = AK::convert_between_host_and_network_endian((u16)packet_length);
+
+                aad_stream.write({ &seq_no, sizeof(seq_no) });      // Sequence number
+                aad_stream.write(buffer.slice(0, header_size - 2)); // content-type + version
+                aad_stream.write({ &len, sizeof(u16) });
+                VERIFY(aad_stream.is_end());
+
+                u8 nonce[12];
+                build_chacha20_poly1305_nonce(nonce, m_context.crypto.remote_aead_iv, m_context.remote_sequence_number);
+
+                auto ciphertext = plain.slice(0, packet_length);
+                auto tag = plain.slice(packet_length, 16);
+
+                auto consistency = chacha.decrypt(ciphertext, decrypted, { nonce, sizeof(nonce) }, aad_bytes, tag);
+                if (consistency != Crypto::VerificationConsistency::Consistent) {
+                    dbgln("integrity check failed (tag length {})", tag.size());
+                    auto packet = build_alert(true, (u8)AlertDescription::BadRecordMAC);
+                    write_packet(packet);
+
+                    return_value = Error::IntegrityCheckFailed;
+                    return;
+                }
+
+                plain = decrypted;
+            },
             [&](Crypto::Cipher::AESCipher::CBCMode& cbc) {
                 VERIFY(!is_aead());
                 auto iv_size = iv_length();
@@ -540,7 +641,7 @@ ssize_t TLSv12::handle_message(ReadonlyBytes buffer)
 
             if (code == (u8)AlertDescription::CloseNotify) {
                 res += 2;
-                alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+                alert(AlertLevel::Warning, AlertDescription::CloseNotify);
                 if (!m_context.cipher_spec_set) {
                     // AWS CloudFront hits this.
                     dbgln("Server sent a close notify and we haven't agreed on a cipher suite. Treating it as a handshake failure.");
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibTLS/SessionCache.h>
+
+namespace TLS {
+
+Optional<Session> SessionCache::find(String const& host)
+{
+    auto it = m_sessions.find(host);
+    if (it == m_sessions.end())
+        return {};
+
+    if (it->value.expiry_time <= time(nullptr)) {
+        dbgln_if(TLS_DEBUG, "Session with {} has expired", host);
+        m_sessions.remove(it);
+        return {};
+    }
+    return it->value;
+}
+
+void SessionCache::store(String const& host, Session session)
+{
+    if (m_capacity == 0)
+        return;
+
+    if (!m_sessions.contains(host) && m_sessions.size() >= m_capacity) {
+        auto first_to_expire = m_sessions.begin();
+        for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+            if (it->value.expiry_time < first_to_expire->value.expiry_time)
+                first_to_expire = it;
+        }
+        m_sessions.remove(first_to_expire);
+    }
+    m_sessions.set(host, move(session));
+}
+
+void SessionCache::remove(String const& host)
+{
+    m_sessions.remove(host);
+}
+
+}
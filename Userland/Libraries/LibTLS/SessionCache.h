@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/RefCounted.h>
+#include <AK/String.h>
+#include <LibTLS/CipherSuite.h>
+#include <time.h>
+
+namespace TLS {
+
+// What it takes to resume a session with an abbreviated handshake, either by its ID (RFC 5246 section 7.3)
+// or with a ticket the server gave us (RFC 5077).
+struct Session {
+    // Empty if the server only gave us a ticket.
+    ByteBuffer id;
+    ByteBuffer ticket;
+    CipherSuite cipher { CipherSuite::Invalid };
+    ByteBuffer master_key;
+    time_t expiry_time { 0 };
+};
+
+// Remembers the most recent session with each host, so that any number of connections can share them.
+class SessionCache : public RefCounted<SessionCache> {
+public:
+    // Sessions are only kept for an hour, even if the server would have them for longer.
+    static constexpr time_t max_lifetime_in_seconds = 60 * 60;
+    static constexpr size_t default_capacity = 256;
+
+    static NonnullRefPtr<SessionCache> create(size_t capacity = default_capacity) { return adopt_ref(*new SessionCache(capacity)); }
+
+    // Returns nothing if there's no session with the host that hasn't expired yet.
+    Optional<Session> find(String const& host);
+    // Replaces any earlier session with the host, making room by dropping the one that expires first if the cache is full.
+    void store(String const& host, Session);
+    void remove(String const& host);
+
+    size_t size() const { return m_sessions.size(); }
+
+private:
+    explicit SessionCache(size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    HashMap<String, Session> m_sessions;
+    size_t m_capacity { default_capacity };
+};
+
+}
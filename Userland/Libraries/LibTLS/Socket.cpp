@@ -247,6 +247,10 @@ bool TLSv12::check_connection_state(bool read)
     if (m_context.critical_error) {
         dbgln_if(TLS_DEBUG, "CRITICAL ERROR {} :(", m_context.critical_error);
 
+        // Don't offer the same session again, in case it's what made the handshake fail.
+        if (m_context.session_to_resume.has_value() && m_context.connection_status != ConnectionStatus::Established && m_context.options.session_cache)
+            m_context.options.session_cache->remove(m_context.extensions.SNI);
+
         m_context.has_invoked_finish_or_error_callback = true;
         if (on_tls_error)
             on_tls_error((AlertDescription)m_context.critical_error);
@@ -316,7 +320,8 @@ ErrorOr<bool> TLSv12::flush()
 
 void TLSv12::close()
 {
-    alert(AlertLevel::Critical, AlertDescription::CloseNotify);
+    // Servers forget about a session when it's closed with a fatal alert, so close_notify has to be a warning (RFC 5246 section 7.2.1).
+    alert(AlertLevel::Warning, AlertDescription::CloseNotify);
     // bye bye.
     m_context.connection_status = ConnectionStatus::Disconnected;
 }
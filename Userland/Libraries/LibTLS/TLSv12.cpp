@@ -306,6 +306,7 @@ TLSv12::TLSv12(StreamVariantType stream, Options options)
     : m_stream(move(stream))
 {
     m_context.options = move(options);
+    m_context.alpn = m_context.options.alpn_protocols;
     m_context.is_server = false;
     m_context.tls_buffer = {};
 
@@ -14,10 +14,13 @@
 #include <LibCore/Timer.h>
 #include <LibCrypto/Authentication/HMAC.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Cipher/AES.h>
+#include <LibCrypto/Cipher/ChaCha20Poly1305.h>
 #include <LibCrypto/Hash/HashManager.h>
 #include <LibCrypto/PK/RSA.h>
 #include <LibTLS/CipherSuite.h>
+#include <LibTLS/SessionCache.h>
 #include <LibTLS/TLSPacketBuilder.h>
 
 namespace TLS {
@@ -122,6 +125,7 @@ enum HandshakeType {
     ClientHello = 0x01,
     ServerHello = 0x02,
     HelloVerifyRequest = 0x03,
+    NewSessionTicket = 0x04,
     CertificateMessage = 0x0b,
     ServerKeyExchange = 0x0c,
     CertificateRequest = 0x0d,
@@ -137,6 +141,7 @@ enum class HandshakeExtension : u16 {
     ECPointFormats = 0x0b,
     SignatureAlgorithms = 0x0d,
     ApplicationLayerProtocolNegotiation = 0x10,
+    SessionTicket = 0x23,
 };
 
 enum class NameType : u8 {
@@ -171,17 +176,21 @@ enum class ECCurveType : u8 {
 // 4 bytes of fixed IV, 8 random (nonce) bytes, 4 bytes for counter
 // GCM specifically asks us to transmit only the nonce, the counter is zero
 // and the fixed IV is derived from the premaster key.
-#define ENUMERATE_CIPHERS(C)                                                                                                                              \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)                \
-    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)           \
-    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)           \
-    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)             \
-    C(true, CipherSuite::RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)             \
-    C(true, CipherSuite::DHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)     \
-    C(true, CipherSuite::DHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)     \
-    C(true, CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true) \
-    C(true, CipherSuite::ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)
+// ChaCha20-Poly1305 doesn't transmit any of its nonce.
+// The suites are listed in the order we prefer them: forward secrecy first, with the cheaper ECDHE ahead of DHE.
+#define ENUMERATE_CIPHERS(C)                                                                                                                                          \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)             \
+    C(true, CipherSuite::ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 0, true) \
+    C(true, CipherSuite::ECDHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::ECDHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)             \
+    C(true, CipherSuite::DHE_RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                 \
+    C(true, CipherSuite::DHE_RSA_WITH_CHACHA20_POLY1305_SHA256, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::CHACHA20_POLY1305, Crypto::Hash::SHA256, 0, true)     \
+    C(true, CipherSuite::DHE_RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::DHE_RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                 \
+    C(true, CipherSuite::RSA_WITH_AES_128_GCM_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_GCM, Crypto::Hash::SHA256, 8, true)                         \
+    C(true, CipherSuite::RSA_WITH_AES_256_GCM_SHA384, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_GCM, Crypto::Hash::SHA384, 8, true)                         \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA256, 16, false)                       \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA256, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA256, 16, false)                       \
+    C(true, CipherSuite::RSA_WITH_AES_128_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_128_CBC, Crypto::Hash::SHA1, 16, false)                            \
+    C(true, CipherSuite::RSA_WITH_AES_256_CBC_SHA, KeyExchangeAlgorithm::RSA, CipherAlgorithm::AES_256_CBC, Crypto::Hash::SHA1, 16, false)
 
 constexpr KeyExchangeAlgorithm get_key_exchange_algorithm(CipherSuite suite)
 {
@@ -218,6 +227,17 @@ struct Options {
         cipher_suites.empend(suite);
         ENUMERATE_CIPHERS(C)
 #undef C
+        // AES-GCM is only faster than ChaCha20-Poly1305 with AES-NI, without it ChaCha20-Poly1305 goes first for every key exchange.
+        if (!Crypto::has_aes_ni()) {
+            for (size_t i = 0; i < cipher_suites.size(); ++i) {
+                if (get_cipher_algorithm(cipher_suites[i]) != CipherAlgorithm::CHACHA20_POLY1305)
+                    continue;
+                size_t first_with_same_key_exchange = 0;
+                while (get_key_exchange_algorithm(cipher_suites[first_with_same_key_exchange]) != get_key_exchange_algorithm(cipher_suites[i]))
+                    ++first_with_same_key_exchange;
+                cipher_suites.insert(first_with_same_key_exchange, cipher_suites.take(i));
+            }
+        }
         return cipher_suites;
     }
     Vector<CipherSuite> usable_cipher_suites = default_usable_cipher_suites();
@@ -247,6 +267,12 @@ struct Options {
         NamedCurve::x448)
     OPTION_WITH_DEFAULTS(Vector<ECPointFormat>, supported_ec_point_formats, ECPointFormat::Uncompressed)
 
+    // Protocols offered through ALPN (RFC 7301), most preferred first; the one the server picked is available as TLSv12::alpn().
+    OPTION_WITH_DEFAULTS(Vector<String>, alpn_protocols, )
+
+    // Where sessions are looked up to be resumed, and stored once a handshake has finished; resumption needs SNI to be used.
+    OPTION_WITH_DEFAULTS(RefPtr<SessionCache>, session_cache, )
+
     OPTION_WITH_DEFAULTS(bool, use_sni, true)
     OPTION_WITH_DEFAULTS(bool, use_compression, false)
     OPTION_WITH_DEFAULTS(bool, validate_certificates, true)
@@ -267,6 +293,12 @@ struct Context {
     u8 local_random[32];
     u8 session_id[32];
     u8 session_id_size { 0 };
+    // The session offered in the client hello, and whether the server agreed to resume it.
+    Optional<Session> session_to_resume;
+    bool is_resumed_session { false };
+    // From the server's NewSessionTicket message, if it sent one (RFC 5077 section 3.3).
+    ByteBuffer session_ticket;
+    u32 session_ticket_lifetime_hint { 0 };
     CipherSuite cipher;
     bool is_server { false };
     Vector<Certificate> certificates;
@@ -281,8 +313,8 @@ struct Context {
         u8 local_mac[32];
         u8 local_iv[16];
         u8 remote_iv[16];
-        u8 local_aead_iv[4];
-        u8 remote_aead_iv[4];
+        u8 local_aead_iv[12];
+        u8 remote_aead_iv[12];
     } crypto;
 
     Crypto::Hash::Manager handshake_hash;
@@ -317,12 +349,12 @@ struct Context {
     bool has_invoked_finish_or_error_callback { false };
 
     // message flags
-    u8 handshake_messages[11] { 0 };
+    u8 handshake_messages[12] { 0 };
     ByteBuffer user_data;
     Vector<Certificate> root_certificates;
 
     Vector<String> alpn;
-    StringView negotiated_alpn;
+    String negotiated_alpn;
 
     size_t send_retries { 0 };
 
@@ -482,6 +514,7 @@ private:
     ssize_t handle_dhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_ecdhe_rsa_server_key_exchange(ReadonlyBytes);
     ssize_t handle_server_hello_done(ReadonlyBytes);
+    ssize_t handle_new_session_ticket(ReadonlyBytes);
     ssize_t handle_certificate_verify(ReadonlyBytes);
     ssize_t handle_handshake_payload(ReadonlyBytes);
     ssize_t handle_message(ReadonlyBytes);
@@ -559,6 +592,9 @@ private:
 
     bool expand_key();
 
+    void did_establish_connection();
+    void store_session();
+
     bool compute_master_secret_from_pre_master_secret(size_t length);
 
     Optional<size_t> verify_chain_and_get_matching_certificate(StringView host) const;
@@ -575,7 +611,8 @@ private:
     using CipherVariant = Variant<
         Empty,
         Crypto::Cipher::AESCipher::CBCMode,
-        Crypto::Cipher::AESCipher::GCMMode>;
+        Crypto::Cipher::AESCipher::GCMMode,
+        Crypto::Cipher::ChaCha20Poly1305>;
     CipherVariant m_cipher_local {};
     CipherVariant m_cipher_remote {};
 
@@ -40,6 +40,16 @@ private:
 // Helper to hide implementation of TestSuite from users
 void add_test_case_to_suite(const NonnullRefPtr<TestCase>& test_case);
 void set_suite_setup_function(Function<void()> setup);
+
+// Makes the compiler assume that the value is read, so a benchmark's computation isn't optimized away.
+template<typename T>
+ALWAYS_INLINE void do_not_optimize(T const& value)
+{
+    asm volatile(""
+                 :
+                 : "r"(&value)
+                 : "memory");
+}
 }
 
 #define TEST_SETUP                                                  \
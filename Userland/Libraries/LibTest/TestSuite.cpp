@@ -8,10 +8,16 @@
 #include <LibTest/Macros.h> // intentionally first -- we redefine VERIFY and friends in here
 
 #include <AK/Function.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/QuickSort.h>
 #include <LibCore/ArgsParser.h>
 #include <LibTest/TestSuite.h>
+#include <errno.h>
+#include <stdio.h>
 #include <stdlib.h>
-#include <sys/time.h>
+#include <string.h>
+#include <time.h>
 
 namespace Test {
 
@@ -21,23 +27,29 @@ class TestElapsedTimer {
 public:
     TestElapsedTimer() { restart(); }
 
-    void restart() { gettimeofday(&m_started, nullptr); }
+    void restart() { clock_gettime(CLOCK_MONOTONIC, &m_started); }
 
-    u64 elapsed_milliseconds()
+    u64 elapsed_nanoseconds()
     {
-        struct timeval now = {};
-        gettimeofday(&now, nullptr);
-
-        struct timeval delta = {};
-        timersub(&now, &m_started, &delta);
-
-        return delta.tv_sec * 1000 + delta.tv_usec / 1000;
+        struct timespec now = {};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (now.tv_sec - m_started.tv_sec) * 1'000'000'000ull + now.tv_nsec - m_started.tv_nsec;
     }
 
+    u64 elapsed_milliseconds() { return elapsed_nanoseconds() / 1'000'000; }
+
 private:
-    struct timeval m_started = {};
+    struct timespec m_started = {};
 };
 
+// Nearest-rank percentile of a sorted, non-empty list.
+static u64 percentile(Vector<u64> const& sorted_values, size_t percent)
+{
+    VERIFY(!sorted_values.is_empty());
+    auto rank = (sorted_values.size() * percent + 99) / 100;
+    return sorted_values[max<size_t>(rank, 1) - 1];
+}
+
 // Declared in Macros.h
 void current_test_case_did_fail()
 {
@@ -70,6 +82,10 @@ int TestSuite::main(const String& suite_name, int argc, char** argv)
     args_parser.add_option(do_tests_only, "Only run tests.", "tests", 0);
     args_parser.add_option(do_benchmarks_only, "Only run benchmarks.", "bench", 0);
     args_parser.add_option(do_list_cases, "List available test cases.", "list", 0);
+    args_parser.add_option(m_benchmark_warmup_runs, "Run each benchmark this many times before measuring.", "bench-warmup", 0, "runs");
+    args_parser.add_option(m_benchmark_samples, "Measure each benchmark this many times, and report percentiles.", "bench-samples", 0, "samples");
+    args_parser.add_option(m_benchmark_min_sample_time_ms, "Repeat benchmarks within a sample until it takes at least this long.", "bench-min-time", 0, "ms");
+    args_parser.add_option(m_benchmark_json_path, "Write benchmark results to this file as JSON.", "bench-json", 0, "path");
     args_parser.add_positional_argument(search_string, "Only run matching cases.", "pattern", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -86,9 +102,17 @@ int TestSuite::main(const String& suite_name, int argc, char** argv)
         return 0;
     }
 
+    if (m_benchmark_samples == 0) {
+        warnln("Need at least one benchmark sample");
+        return 1;
+    }
+
     outln("Running {} cases out of {}.", matching_tests.size(), m_cases.size());
 
-    return run(matching_tests);
+    auto failed_count = run(matching_tests);
+    if (!m_benchmark_json_path.is_empty())
+        write_benchmark_results();
+    return failed_count;
 }
 
 NonnullRefPtrVector<TestCase> TestSuite::find_cases(const String& search, bool find_tests, bool find_benchmarks)
@@ -124,8 +148,13 @@ int TestSuite::run(const NonnullRefPtrVector<TestCase>& tests)
         warnln("Running {} '{}'.", test_type, t.name());
         m_current_test_case_passed = true;
 
+        bool should_measure_benchmark = m_benchmark_warmup_runs > 0 || m_benchmark_samples > 1 || m_benchmark_min_sample_time_ms > 0 || !m_benchmark_json_path.is_empty();
+
         TestElapsedTimer timer;
-        t.func()();
+        if (t.is_benchmark() && should_measure_benchmark)
+            run_benchmark(t);
+        else
+            t.func()();
         const auto time = timer.elapsed_milliseconds();
 
         dbgln("{} {} '{}' in {}ms", m_current_test_case_passed ? "Completed" : "Failed", test_type, t.name(), time);
@@ -155,4 +184,78 @@ int TestSuite::run(const NonnullRefPtrVector<TestCase>& tests)
     return (int)test_failed_count;
 }
 
+void TestSuite::run_benchmark(TestCase const& test_case)
+{
+    auto run_iterations = [&](u64 iterations) {
+        TestElapsedTimer timer;
+        for (u64 i = 0; i < iterations && m_current_test_case_passed; ++i)
+            test_case.func()();
+        return timer.elapsed_nanoseconds();
+    };
+
+    for (unsigned i = 0; i < m_benchmark_warmup_runs && m_current_test_case_passed; ++i)
+        run_iterations(1);
+
+    // A single run of a short benchmark is dominated by timer resolution and noise, so find out how often the
+    // case has to be repeated within a sample for the sample to take at least the requested time.
+    u64 iterations = 1;
+    u64 min_sample_time_ns = m_benchmark_min_sample_time_ms * 1'000'000ull;
+    while (min_sample_time_ns > 0 && m_current_test_case_passed) {
+        auto elapsed = run_iterations(iterations);
+        if (elapsed >= min_sample_time_ns)
+            break;
+        auto estimate = elapsed > 0 ? static_cast<u64>(iterations * (min_sample_time_ns * 1.2 / elapsed)) : iterations * 10;
+        iterations = clamp(estimate, iterations + 1, iterations * 10);
+    }
+
+    BenchmarkResult result { test_case.name(), iterations, {} };
+    for (unsigned sample = 0; sample < m_benchmark_samples && m_current_test_case_passed; ++sample)
+        result.sorted_sample_ns.append(run_iterations(iterations) / iterations);
+
+    if (!m_current_test_case_passed)
+        return;
+
+    quick_sort(result.sorted_sample_ns);
+    auto const& samples = result.sorted_sample_ns;
+    outln("{}: {} samples x {} iterations, ns/iteration: min {}, p50 {}, p90 {}, p99 {}, max {}",
+        result.name, samples.size(), iterations, samples.first(), percentile(samples, 50), percentile(samples, 90), percentile(samples, 99), samples.last());
+    m_benchmark_results.append(move(result));
+}
+
+void TestSuite::write_benchmark_results() const
+{
+    JsonArray benchmarks;
+    for (auto const& result : m_benchmark_results) {
+        auto const& samples = result.sorted_sample_ns;
+        u64 sum = 0;
+        for (auto sample : samples)
+            sum += sample;
+
+        JsonObject benchmark;
+        benchmark.set("name", result.name);
+        benchmark.set("samples", samples.size());
+        benchmark.set("iterations_per_sample", result.iterations_per_sample);
+        benchmark.set("min_ns", samples.first());
+        benchmark.set("mean_ns", sum / samples.size());
+        benchmark.set("p50_ns", percentile(samples, 50));
+        benchmark.set("p90_ns", percentile(samples, 90));
+        benchmark.set("p99_ns", percentile(samples, 99));
+        benchmark.set("max_ns", samples.last());
+        benchmarks.append(move(benchmark));
+    }
+
+    JsonObject results;
+    results.set("suite", m_suite_name);
+    results.set("benchmarks", move(benchmarks));
+
+    auto* file = fopen(m_benchmark_json_path.characters(), "w");
+    if (!file) {
+        warnln("Failed to open {}: {}", m_benchmark_json_path, strerror(errno));
+        return;
+    }
+    auto json = results.to_string();
+    fwrite(json.characters(), 1, json.length(), file);
+    fclose(file);
+}
+
 }
@@ -13,6 +13,7 @@
 #include <AK/Function.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 #include <LibTest/TestCase.h>
 
 namespace Test {
@@ -46,6 +47,15 @@ public:
     void set_suite_setup(Function<void()> setup) { m_setup = move(setup); }
 
 private:
+    struct BenchmarkResult {
+        String name;
+        u64 iterations_per_sample { 0 };
+        Vector<u64> sorted_sample_ns; // Time per iteration of each sample.
+    };
+
+    void run_benchmark(TestCase const&);
+    void write_benchmark_results() const;
+
     static TestSuite* s_global;
     NonnullRefPtrVector<TestCase> m_cases;
     u64 m_testtime = 0;
@@ -53,6 +63,12 @@ private:
     String m_suite_name;
     bool m_current_test_case_passed = true;
     Function<void()> m_setup;
+
+    unsigned m_benchmark_warmup_runs = 0;
+    unsigned m_benchmark_samples = 1;
+    unsigned m_benchmark_min_sample_time_ms = 0;
+    String m_benchmark_json_path;
+    Vector<BenchmarkResult> m_benchmark_results;
 };
 
 }
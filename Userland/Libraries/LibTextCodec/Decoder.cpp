@@ -7,6 +7,7 @@
 
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <AK/Utf8View.h>
 #include <LibTextCodec/Decoder.h>
 
 namespace TextCodec {
@@ -215,9 +216,8 @@ String Decoder::to_utf8(StringView input)
 
 void UTF8Decoder::process(StringView input, Function<void(u32)> on_code_point)
 {
-    for (auto c : input) {
-        on_code_point(c);
-    }
+    for (auto code_point : Utf8View(input))
+        on_code_point(code_point);
 }
 
 String UTF8Decoder::to_utf8(StringView input)
@@ -282,6 +282,26 @@ void Latin1Decoder::process(StringView input, Function<void(u32)> on_code_point)
     }
 }
 
+String Latin1Decoder::to_utf8(StringView input)
+{
+    // Latin1 agrees with ASCII on the first 128 bytes, so ASCII runs can be copied over verbatim.
+    auto ascii_length = Utf8View(input).ascii_prefix_length();
+    if (ascii_length == input.length())
+        return input;
+
+    StringBuilder builder(input.length());
+    while (!input.is_empty()) {
+        builder.append(input.substring_view(0, ascii_length));
+        input = input.substring_view(ascii_length);
+        if (input.is_empty())
+            break;
+        builder.append_code_point(static_cast<u8>(input[0]));
+        input = input.substring_view(1);
+        ascii_length = Utf8View(input).ascii_prefix_length();
+    }
+    return builder.to_string();
+}
+
 namespace {
 u32 convert_latin2_to_utf8(u8 in)
 {
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <LibThreading/DirectoryTree.h>
+#include <errno.h>
+#include <fcntl.h>
+
+namespace Threading {
+
+static unsigned char directory_entry_type_from_mode(mode_t mode)
+{
+    switch (mode & S_IFMT) {
+    case S_IFREG:
+        return DT_REG;
+    case S_IFDIR:
+        return DT_DIR;
+    case S_IFCHR:
+        return DT_CHR;
+    case S_IFBLK:
+        return DT_BLK;
+    case S_IFIFO:
+        return DT_FIFO;
+    case S_IFLNK:
+        return DT_LNK;
+    case S_IFSOCK:
+        return DT_SOCK;
+    default:
+        return DT_UNKNOWN;
+    }
+}
+
+static String join_path(String const& directory, String const& name)
+{
+    if (directory.ends_with('/'))
+        return String::formatted("{}{}", directory, name);
+    return String::formatted("{}/{}", directory, name);
+}
+
+static void read_children(DirectoryTreeNode& node, String const& path, int remaining_depth, DirectoryTreeOptions const& options, TaskGroup& group)
+{
+    auto* dir = opendir(path.characters());
+    if (!dir) {
+        node.error = errno;
+        return;
+    }
+    ScopeGuard close_dir = [&] { closedir(dir); };
+    auto dir_fd = dirfd(dir);
+
+    for (;;) {
+        errno = 0;
+        auto* entry = readdir(dir);
+        if (!entry) {
+            node.error = errno;
+            break;
+        }
+        if (entry->d_name[0] == '.' && (entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0')))
+            continue;
+
+        auto child = make<DirectoryTreeNode>();
+        child->name = entry->d_name;
+        child->type = entry->d_type;
+        if (options.stat_entries || child->type == DT_UNKNOWN) {
+            // Relative to the directory we're reading, so the kernel doesn't have to resolve the whole path again.
+            if (fstatat(dir_fd, entry->d_name, &child->stat, AT_SYMLINK_NOFOLLOW) < 0)
+                child->error = errno;
+            else
+                child->type = directory_entry_type_from_mode(child->stat.st_mode);
+        }
+        node.children.append(move(child));
+    }
+
+    if (remaining_depth <= 0)
+        return;
+
+    for (auto& child : node.children) {
+        if (!child.is_directory() || child.error != 0)
+            continue;
+        group.spawn([&child, child_path = join_path(path, child.name), remaining_depth, &options, &group] {
+            read_children(child, child_path, remaining_depth - 1, options, group);
+        });
+    }
+}
+
+DirectoryTreeNode read_directory_tree(String const& root_path, DirectoryTreeOptions const& options, ThreadPool& pool)
+{
+    DirectoryTreeNode root;
+    root.name = root_path;
+    root.type = DT_DIR;
+
+    TaskGroup group(pool);
+    read_children(root, root_path, options.max_depth, options, group);
+    group.wait();
+    return root;
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/NumericLimits.h>
+#include <AK/String.h>
+#include <LibThreading/ThreadPool.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace Threading {
+
+struct DirectoryTreeNode {
+    String name;
+    unsigned char type { DT_UNKNOWN }; // One of the DT_* values from <dirent.h>.
+    // Only filled in if the entries were stat'ed, see DirectoryTreeOptions.
+    struct stat stat {};
+    // Entries of a directory, in the order the directory listed them. Empty for directories below the maximum depth.
+    NonnullOwnPtrVector<DirectoryTreeNode> children;
+    // Set if this entry couldn't be stat'ed or, for a directory, read.
+    int error { 0 };
+
+    bool is_directory() const { return type == DT_DIR; }
+};
+
+struct DirectoryTreeOptions {
+    // How many levels of directories below the root to read; 0 only reads the root's own entries.
+    int max_depth { NumericLimits<int>::max() };
+    // lstat() every entry. Otherwise, entry types come from the directory listing, and entries are only
+    // stat'ed when the file system doesn't report a type.
+    bool stat_entries { false };
+};
+
+// Reads the tree below a directory, reading different directories on different threads of the pool.
+// The result is the same as that of a serial depth-first walk; symlinks are not followed.
+DirectoryTreeNode read_directory_tree(String const& root_path, DirectoryTreeOptions const& = {}, ThreadPool& = ThreadPool::the());
+
+}
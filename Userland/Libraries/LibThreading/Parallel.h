@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/IntegralMath.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+#include <AK/kmalloc.h>
+#include <LibThreading/ThreadPool.h>
+
+namespace Threading {
+
+namespace Detail {
+
+struct ChunkPlan {
+    size_t chunk_count { 0 };
+    size_t chunk_size { 0 };
+};
+
+inline ChunkPlan plan_chunks(size_t count, size_t minimum_chunk_size, ThreadPool& pool)
+{
+    if (count == 0)
+        return {};
+    // A few chunks per thread keep everyone busy when some chunks take longer than others.
+    size_t chunk_count = min(ceil_div(count, max<size_t>(minimum_chunk_size, 1)), pool.concurrency() * 4);
+    size_t chunk_size = ceil_div(count, chunk_count);
+    return { ceil_div(count, chunk_size), chunk_size };
+}
+
+// Calls callback(chunk_index, chunk_begin, chunk_end) for every chunk, on the calling thread and as many pool workers as are useful.
+template<typename Callback>
+void run_chunks(ChunkPlan const& plan, size_t count, ThreadPool& pool, Callback& callback)
+{
+    if (plan.chunk_count <= 1) {
+        if (count != 0)
+            callback(0, 0, count);
+        return;
+    }
+
+    Atomic<size_t> next_chunk { 0 };
+    auto run_remaining_chunks = [&] {
+        for (;;) {
+            auto chunk = next_chunk.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (chunk >= plan.chunk_count)
+                return;
+            auto chunk_begin = chunk * plan.chunk_size;
+            callback(chunk, chunk_begin, min(chunk_begin + plan.chunk_size, count));
+        }
+    };
+
+    TaskGroup group(pool);
+    auto helper_count = min(pool.worker_count(), plan.chunk_count - 1);
+    for (size_t i = 0; i < helper_count; ++i)
+        group.spawn([&] { run_remaining_chunks(); });
+    run_remaining_chunks();
+    group.wait();
+}
+
+template<typename T, typename LessThan>
+void insertion_sort(Span<T> values, LessThan& less_than)
+{
+    for (size_t i = 1; i < values.size(); ++i) {
+        for (size_t j = i; j > 0 && less_than(values[j], values[j - 1]); --j)
+            swap(values[j], values[j - 1]);
+    }
+}
+
+// Sorts `values` stably, using `scratch` (which must have room for values.size() elements) while merging.
+template<typename T, typename LessThan>
+void merge_sort(Span<T> values, T* scratch, LessThan& less_than, ThreadPool& pool)
+{
+    static constexpr size_t insertion_sort_threshold = 16;
+    // Below this, handing half of the work to another thread costs more than it saves.
+    static constexpr size_t parallel_threshold = 4096;
+
+    if (values.size() <= insertion_sort_threshold) {
+        insertion_sort(values, less_than);
+        return;
+    }
+
+    auto middle = values.size() / 2;
+    auto left = values.slice(0, middle);
+    auto right = values.slice(middle);
+    if (values.size() >= parallel_threshold && pool.worker_count() != 0) {
+        TaskGroup group(pool);
+        group.spawn([&] { merge_sort(right, scratch + middle, less_than, pool); });
+        merge_sort(left, scratch, less_than, pool);
+        group.wait();
+    } else {
+        merge_sort(left, scratch, less_than, pool);
+        merge_sort(right, scratch + middle, less_than, pool);
+    }
+
+    if (!less_than(right[0], left[middle - 1]))
+        return;
+
+    size_t left_index = 0;
+    size_t right_index = 0;
+    size_t output_index = 0;
+    while (left_index < left.size() && right_index < right.size()) {
+        // NOTE: Taking from the left on ties is what keeps the sort stable.
+        if (less_than(right[right_index], left[left_index]))
+            new (&scratch[output_index++]) T(move(right[right_index++]));
+        else
+            new (&scratch[output_index++]) T(move(left[left_index++]));
+    }
+    while (left_index < left.size())
+        new (&scratch[output_index++]) T(move(left[left_index++]));
+    // Whatever is left on the right is already in its place.
+
+    for (size_t i = 0; i < output_index; ++i) {
+        values[i] = move(scratch[i]);
+        scratch[i].~T();
+    }
+}
+
+}
+
+// Calls callback(index) for every index in [begin, end), spread over the thread pool.
+// Indices are handed out in chunks of at least `minimum_chunk_size`, which should be large enough to make up for the cost of a task.
+template<typename Callback>
+void parallel_for(size_t begin, size_t end, Callback callback, size_t minimum_chunk_size = 1)
+{
+    VERIFY(begin <= end);
+    auto& pool = ThreadPool::the();
+    auto count = end - begin;
+    auto plan = Detail::plan_chunks(count, minimum_chunk_size, pool);
+    auto run_chunk = [&](size_t, size_t chunk_begin, size_t chunk_end) {
+        for (size_t i = chunk_begin; i < chunk_end; ++i)
+            callback(begin + i);
+    };
+    Detail::run_chunks(plan, count, pool, run_chunk);
+}
+
+// Returns reduce(...reduce(reduce(identity, map(begin)), map(begin + 1))..., map(end - 1)), computed in parallel.
+// Every chunk is reduced on its own starting from `identity`, and the chunk results are then reduced in order,
+// so `reduce` has to be associative and `identity` has to be its identity element.
+template<typename T, typename Map, typename Reduce>
+T parallel_reduce(size_t begin, size_t end, T identity, Map map, Reduce reduce, size_t minimum_chunk_size = 1)
+{
+    VERIFY(begin <= end);
+    auto& pool = ThreadPool::the();
+    auto count = end - begin;
+    auto plan = Detail::plan_chunks(count, minimum_chunk_size, pool);
+
+    Vector<T> chunk_results;
+    chunk_results.ensure_capacity(plan.chunk_count);
+    for (size_t i = 0; i < plan.chunk_count; ++i)
+        chunk_results.unchecked_append(identity);
+
+    auto run_chunk = [&](size_t chunk, size_t chunk_begin, size_t chunk_end) {
+        T result = identity;
+        for (size_t i = chunk_begin; i < chunk_end; ++i)
+            result = reduce(move(result), map(begin + i));
+        chunk_results[chunk] = move(result);
+    };
+    Detail::run_chunks(plan, count, pool, run_chunk);
+
+    T result = move(identity);
+    for (auto& chunk_result : chunk_results)
+        result = reduce(move(result), move(chunk_result));
+    return result;
+}
+
+// A stable merge sort that sorts both halves of big ranges on different threads.
+template<typename T, typename LessThan>
+void parallel_sort(Span<T> values, LessThan less_than)
+{
+    if (values.size() <= 1)
+        return;
+    auto* scratch = static_cast<T*>(kmalloc_array(values.size(), sizeof(T)));
+    VERIFY(scratch);
+    Detail::merge_sort(values, scratch, less_than, ThreadPool::the());
+    kfree_sized(scratch, values.size() * sizeof(T));
+}
+
+template<typename T>
+void parallel_sort(Span<T> values)
+{
+    parallel_sort(values, [](auto& a, auto& b) { return a < b; });
+}
+
+template<typename T, size_t inline_capacity, typename LessThan>
+void parallel_sort(Vector<T, inline_capacity>& values, LessThan less_than)
+{
+    parallel_sort(values.span(), move(less_than));
+}
+
+template<typename T, size_t inline_capacity>
+void parallel_sort(Vector<T, inline_capacity>& values)
+{
+    parallel_sort(values.span());
+}
+
+}
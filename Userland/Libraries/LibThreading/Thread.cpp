@@ -15,13 +15,14 @@ Threading::Thread::Thread(Function<intptr_t()> action, StringView thread_name)
     , m_thread_name(thread_name.is_null() ? "" : thread_name)
 {
     register_property("thread_name", [&] { return JsonValue { m_thread_name }; });
-    register_property("tid", [&] { return JsonValue { m_tid }; });
+    register_property("tid", [&] { return JsonValue { m_tid.load() }; });
 }
 
 Threading::Thread::~Thread()
 {
-    if (m_tid && !m_detached) {
-        dbgln("Destroying thread \"{}\"({}) while it is still running!", m_thread_name, m_tid);
+    if (m_handle && !m_detached) {
+        if (m_tid)
+            dbgln("Destroying thread \"{}\"({}) while it is still running!", m_thread_name, m_handle);
         [[maybe_unused]] auto res = join();
     }
 }
@@ -29,10 +30,12 @@ Threading::Thread::~Thread()
 void Threading::Thread::start()
 {
     int rc = pthread_create(
-        &m_tid,
+        &m_handle,
         nullptr,
         [](void* arg) -> void* {
             Thread* self = static_cast<Thread*>(arg);
+            // NOTE: m_tid is set here rather than by pthread_create(), which may only return after we're done already.
+            self->m_tid = pthread_self();
             auto exit_code = self->m_action();
             self->m_tid = 0;
             return reinterpret_cast<void*>(exit_code);
@@ -41,17 +44,17 @@ void Threading::Thread::start()
 
     VERIFY(rc == 0);
     if (!m_thread_name.is_empty()) {
-        rc = pthread_setname_np(m_tid, m_thread_name.characters());
-        VERIFY(rc == 0);
+        // NOTE: This fails if the thread is already done running, which is fine.
+        (void)pthread_setname_np(m_handle, m_thread_name.characters());
     }
-    dbgln("Started thread \"{}\", tid = {}", m_thread_name, m_tid);
+    dbgln("Started thread \"{}\", tid = {}", m_thread_name, m_handle);
 }
 
 void Threading::Thread::detach()
 {
     VERIFY(!m_detached);
 
-    int rc = pthread_detach(m_tid);
+    int rc = pthread_detach(m_handle);
     VERIFY(rc == 0);
 
     m_detached = true;
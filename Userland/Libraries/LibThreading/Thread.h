@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/DistinctNumeric.h>
 #include <AK/Function.h>
 #include <AK/Result.h>
@@ -36,7 +37,10 @@ public:
 private:
     explicit Thread(Function<intptr_t()> action, StringView thread_name = nullptr);
     Function<intptr_t()> m_action;
-    pthread_t m_tid { 0 };
+    // What join() and detach() refer to the thread by. Unlike m_tid, this stays around after the thread is done running.
+    pthread_t m_handle { 0 };
+    // Only set while the thread is running, the thread resets it itself when it's done.
+    Atomic<pthread_t> m_tid { 0 };
     String m_thread_name;
     bool m_detached { false };
 };
@@ -45,11 +49,12 @@ template<typename T>
 Result<T, ThreadError> Thread::join()
 {
     void* thread_return = nullptr;
-    int rc = pthread_join(m_tid, &thread_return);
+    int rc = pthread_join(m_handle, &thread_return);
     if (rc != 0) {
         return ThreadError { rc };
     }
 
+    m_handle = 0;
     m_tid = 0;
     if constexpr (IsVoid<T>)
         return {};
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/String.h>
+#include <LibThreading/Thread.h>
+#include <LibThreading/ThreadPool.h>
+#include <sched.h>
+#include <unistd.h>
+
+namespace Threading {
+
+static constexpr size_t max_worker_count = 64;
+
+// The index of the pool worker running on this thread, if any.
+static thread_local Optional<size_t> s_worker_index;
+
+ThreadPool& ThreadPool::the()
+{
+    static ThreadPool* s_the;
+    static pthread_once_t s_once = PTHREAD_ONCE_INIT;
+    pthread_once(&s_once, [] {
+        auto processor_count = sysconf(_SC_NPROCESSORS_ONLN);
+        size_t worker_count = processor_count > 1 ? min(static_cast<size_t>(processor_count) - 1, max_worker_count) : 0;
+        // NOTE: The pool lives for as long as the process does, just like its threads.
+        s_the = new ThreadPool(worker_count);
+    });
+    return *s_the;
+}
+
+ThreadPool::ThreadPool(size_t worker_count)
+    : m_worker_count(worker_count)
+{
+    for (size_t i = 0; i < worker_count + 1; ++i)
+        m_queues.append(make<TaskQueue>());
+
+    for (size_t i = 0; i < worker_count; ++i) {
+        auto thread = Thread::construct([this, i]() -> intptr_t { worker_loop(i); }, String::formatted("Pool worker {}", i));
+        thread->start();
+        thread->detach();
+        // NOTE: Like the pool itself, the workers are never destroyed.
+        (void)thread.leak_ref();
+    }
+}
+
+void ThreadPool::submit(Function<void()> task)
+{
+    auto& queue = *m_queues[s_worker_index.value_or(m_worker_count)];
+    {
+        MutexLocker locker(queue.mutex);
+        queue.tasks.append(move(task));
+        m_queued_task_count.fetch_add(1, AK::MemoryOrder::memory_order_release);
+    }
+
+    // Taking the lock means sleeping workers are either waiting on the condition already or will see the new task before they do.
+    MutexLocker locker(m_sleep_mutex);
+    m_wake_condition.signal();
+}
+
+Optional<Function<void()>> ThreadPool::take_task(size_t preferred_queue)
+{
+    if (m_queued_task_count.load(AK::MemoryOrder::memory_order_acquire) == 0)
+        return {};
+
+    // Our own queue is worked from the back, which is where its most recent (and most likely cached) tasks are.
+    {
+        auto& queue = *m_queues[preferred_queue];
+        MutexLocker locker(queue.mutex);
+        if (!queue.tasks.is_empty()) {
+            m_queued_task_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+            return queue.tasks.take_last();
+        }
+    }
+
+    // Everyone else's is worked from the front, which is where the oldest and usually biggest tasks are.
+    for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+        auto& queue = *m_queues[(preferred_queue + offset) % m_queues.size()];
+        MutexLocker locker(queue.mutex);
+        if (!queue.tasks.is_empty()) {
+            m_queued_task_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+            return queue.tasks.take_first();
+        }
+    }
+    return {};
+}
+
+bool ThreadPool::try_run_one_task()
+{
+    auto task = take_task(s_worker_index.value_or(m_worker_count));
+    if (!task.has_value())
+        return false;
+    (*task)();
+    return true;
+}
+
+void ThreadPool::worker_loop(size_t worker_index)
+{
+    s_worker_index = worker_index;
+    for (;;) {
+        if (auto task = take_task(worker_index); task.has_value()) {
+            (*task)();
+            continue;
+        }
+
+        MutexLocker locker(m_sleep_mutex);
+        while (m_queued_task_count.load(AK::MemoryOrder::memory_order_acquire) == 0)
+            m_wake_condition.wait();
+    }
+}
+
+void TaskGroup::spawn(Function<void()> task)
+{
+    m_pending_task_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    m_pool.submit([this, task = move(task)] {
+        task();
+        m_pending_task_count.fetch_sub(1, AK::MemoryOrder::memory_order_acq_rel);
+    });
+}
+
+void TaskGroup::wait()
+{
+    while (m_pending_task_count.load(AK::MemoryOrder::memory_order_acquire) != 0) {
+        // Our tasks might still be queued, or be waiting on tasks of their own, so lend a hand instead of going to sleep.
+        if (!m_pool.try_run_one_task())
+            sched_yield();
+    }
+}
+
+}
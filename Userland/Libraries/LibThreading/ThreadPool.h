@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <LibThreading/ConditionVariable.h>
+#include <LibThreading/Mutex.h>
+
+namespace Threading {
+
+// A pool of worker threads, one per CPU besides the thread that hands out the work.
+// Every worker has its own queue of tasks; tasks submitted from a worker go to the back of its own queue,
+// and workers that run out of tasks steal from the front of the other queues.
+//
+// Threads waiting for a TaskGroup run queued tasks in the meantime, so tasks can use the pool themselves
+// and it's safe to use from any thread, including ones running a Core::EventLoop.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    static ThreadPool& the();
+
+    size_t worker_count() const { return m_worker_count; }
+
+    // The number of threads that work is spread over, including the one waiting for it.
+    size_t concurrency() const { return m_worker_count + 1; }
+
+    void submit(Function<void()>);
+
+    // Runs one queued task on the calling thread. Returns false if there was nothing to do.
+    bool try_run_one_task();
+
+private:
+    explicit ThreadPool(size_t worker_count);
+
+    struct TaskQueue {
+        Mutex mutex;
+        Vector<Function<void()>> tasks;
+    };
+
+    Optional<Function<void()>> take_task(size_t preferred_queue);
+    [[noreturn]] void worker_loop(size_t worker_index);
+
+    size_t m_worker_count { 0 };
+    // One queue per worker, followed by the queue for tasks that are submitted from other threads.
+    Vector<NonnullOwnPtr<TaskQueue>> m_queues;
+    Atomic<size_t> m_queued_task_count { 0 };
+    Mutex m_sleep_mutex;
+    ConditionVariable m_wake_condition { m_sleep_mutex };
+};
+
+// Runs tasks on a ThreadPool and waits for them to finish, running other queued tasks while it waits.
+class TaskGroup {
+    AK_MAKE_NONCOPYABLE(TaskGroup);
+    AK_MAKE_NONMOVABLE(TaskGroup);
+
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::the())
+        : m_pool(pool)
+    {
+    }
+
+    ~TaskGroup() { wait(); }
+
+    void spawn(Function<void()>);
+    void wait();
+
+private:
+    ThreadPool& m_pool;
+    Atomic<size_t> m_pending_task_count { 0 };
+};
+
+}
@@ -16,6 +16,26 @@ EscapeSequenceParser::EscapeSequenceParser(EscapeSequenceExecutor& executor)
 {
 }
 
+void EscapeSequenceParser::on_input(ReadonlyBytes bytes)
+{
+    auto is_printable_ascii = [](u8 byte) { return byte >= 0x20 && byte < 0x7f; };
+
+    size_t index = 0;
+    while (index < bytes.size()) {
+        // NOTE: In the ground state, printable characters are printed without changing the state.
+        if (m_state_machine.is_in_initial_state() && is_printable_ascii(bytes[index])) {
+            auto run_end = index + 1;
+            while (run_end < bytes.size() && is_printable_ascii(bytes[run_end]))
+                ++run_end;
+            dbgln_if(ESCAPE_SEQUENCE_DEBUG, "on_input: {} printable characters", run_end - index);
+            m_executor.emit_printable_ascii(bytes.slice(index, run_end - index));
+            index = run_end;
+            continue;
+        }
+        on_input(bytes[index++]);
+    }
+}
+
 Vector<EscapeSequenceParser::OscParameter> EscapeSequenceParser::osc_parameters() const
 {
     VERIFY(m_osc_raw.size() >= m_osc_parameter_indexes.last());
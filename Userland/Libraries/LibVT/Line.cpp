@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <LibVT/Line.h>
 
 namespace VT {
@@ -20,6 +21,10 @@ void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bo
     if (old_length == new_length)
         return;
 
+    expand();
+    if (next_line)
+        next_line->expand();
+
     // Drop the empty cells
     if (m_terminated_at.has_value() && m_cells.size() > m_terminated_at.value())
         m_cells.remove(m_terminated_at.value(), m_cells.size() - m_terminated_at.value());
@@ -35,6 +40,7 @@ void Line::rewrap(size_t new_length, Line* next_line, CursorPosition* cursor, bo
 
 void Line::set_length(size_t new_length)
 {
+    expand();
     m_cells.resize(new_length);
     if (m_terminated_at.has_value())
         m_terminated_at = min(*m_terminated_at, new_length);
@@ -117,8 +123,24 @@ void Line::take_cells_from_next_line(size_t new_length, Line* next_line, bool cu
         next_line->m_cells.clear();
 }
 
+void Line::clear(Attribute const& attribute)
+{
+    if (m_is_compact) {
+        // There's no point in expanding cells that are about to be overwritten.
+        auto length = this->length();
+        m_compact_code_points.clear();
+        m_attribute_runs.clear();
+        m_is_compact = false;
+        m_cells.resize(length);
+        m_dirty = true;
+    }
+    m_terminated_at.clear();
+    clear_range(0, m_cells.size() - 1, attribute);
+}
+
 void Line::clear_range(size_t first_column, size_t last_column, const Attribute& attribute)
 {
+    expand();
     VERIFY(first_column <= last_column);
     VERIFY(last_column < m_cells.size());
     for (size_t i = first_column; i <= last_column; ++i) {
@@ -129,6 +151,20 @@ void Line::clear_range(size_t first_column, size_t last_column, const Attribute&
     }
 }
 
+bool Line::is_empty() const
+{
+    if (m_is_compact) {
+        if (any_of(m_attribute_runs, [](auto& run) { return run.attribute != Attribute(); }))
+            return false;
+        for (size_t column = 0; column < length(); ++column) {
+            if (compact_code_point_at(column) != ' ')
+                return false;
+        }
+        return true;
+    }
+    return !any_of(m_cells, [](auto& cell) { return cell != Cell(); });
+}
+
 bool Line::has_only_one_background_color() const
 {
     if (!length())
@@ -142,4 +178,80 @@ bool Line::has_only_one_background_color() const
     return true;
 }
 
+static bool has_same_hyperlink(Attribute const& a, Attribute const& b)
+{
+    // Cells written with the same attribute share their strings, so this is usually just a pointer comparison.
+    return (a.href.impl() == b.href.impl() || a.href == b.href) && (a.href_id.impl() == b.href_id.impl() || a.href_id == b.href_id);
+}
+
+void Line::compact()
+{
+    if (m_is_compact)
+        return;
+
+    bool is_ascii = all_of(m_cells, [](auto& cell) { return cell.code_point < 0x80; });
+    m_compact_code_point_size = is_ascii ? 1 : sizeof(u32);
+    m_compact_code_points.resize(m_cells.size() * m_compact_code_point_size);
+    auto* code_points = m_compact_code_points.data();
+    for (size_t column = 0; column < m_cells.size(); ++column) {
+        auto& cell = m_cells[column];
+        if (is_ascii)
+            code_points[column] = static_cast<u8>(cell.code_point);
+        else
+            __builtin_memcpy(code_points + column * sizeof(u32), &cell.code_point, sizeof(u32));
+
+        // NOTE: Attribute's comparison ignores the hyperlink, but that has to be kept as well.
+        if (!m_attribute_runs.is_empty()) {
+            auto& previous_attribute = m_attribute_runs.last().attribute;
+            if (previous_attribute == cell.attribute && has_same_hyperlink(previous_attribute, cell.attribute))
+                continue;
+        }
+        m_attribute_runs.append({ static_cast<u16>(column), cell.attribute });
+    }
+
+    m_cells.clear();
+    m_is_compact = true;
+}
+
+void Line::expand_compact_cells()
+{
+    VERIFY(m_is_compact);
+    auto length = this->length();
+    m_cells.ensure_capacity(length);
+    size_t run_index = 0;
+    for (size_t column = 0; column < length; ++column) {
+        if (run_index + 1 < m_attribute_runs.size() && m_attribute_runs[run_index + 1].first_column == column)
+            ++run_index;
+        m_cells.unchecked_append({ compact_code_point_at(column), m_attribute_runs[run_index].attribute });
+    }
+
+    m_compact_code_points.clear();
+    m_attribute_runs.clear();
+    m_is_compact = false;
+}
+
+u32 Line::compact_code_point_at(size_t index) const
+{
+    if (m_compact_code_point_size == 1)
+        return m_compact_code_points[index];
+    u32 code_point;
+    __builtin_memcpy(&code_point, m_compact_code_points.data() + index * sizeof(u32), sizeof(u32));
+    return code_point;
+}
+
+Attribute const& Line::compact_attribute_at(size_t index) const
+{
+    // Find the last run that starts at or before the column.
+    size_t low = 0;
+    size_t high = m_attribute_runs.size();
+    while (high - low > 1) {
+        auto middle = low + (high - low) / 2;
+        if (m_attribute_runs[middle].first_column <= index)
+            low = middle;
+        else
+            high = middle;
+    }
+    return m_attribute_runs[low].attribute;
+}
+
 }
@@ -7,7 +7,6 @@
 
 #pragma once
 
-#include <AK/AnyOf.h>
 #include <AK/Noncopyable.h>
 #include <AK/Vector.h>
 #include <LibVT/Attribute.h>
@@ -31,27 +30,29 @@ public:
         bool operator!=(Cell const& other) const { return code_point != other.code_point || attribute != other.attribute; }
     };
 
-    const Attribute& attribute_at(size_t index) const { return m_cells[index].attribute; }
-    Attribute& attribute_at(size_t index) { return m_cells[index].attribute; }
-
-    Cell& cell_at(size_t index) { return m_cells[index]; }
-    const Cell& cell_at(size_t index) const { return m_cells[index]; }
+    Attribute const& attribute_at(size_t index) const
+    {
+        if (m_is_compact)
+            return compact_attribute_at(index);
+        return m_cells[index].attribute;
+    }
 
-    void clear(const Attribute& attribute = Attribute())
+    Cell& cell_at(size_t index)
     {
-        m_terminated_at.clear();
-        clear_range(0, m_cells.size() - 1, attribute);
+        expand();
+        return m_cells[index];
     }
+
+    void clear(const Attribute& attribute = Attribute());
     void clear_range(size_t first_column, size_t last_column, const Attribute& attribute = Attribute());
     bool has_only_one_background_color() const;
 
-    bool is_empty() const
-    {
-        return !any_of(m_cells, [](auto& cell) { return cell != Cell(); });
-    }
+    bool is_empty() const;
 
     size_t length() const
     {
+        if (m_is_compact)
+            return m_compact_code_points.size() / m_compact_code_point_size;
         return m_cells.size();
     }
     void set_length(size_t);
@@ -59,11 +60,14 @@ public:
 
     u32 code_point(size_t index) const
     {
+        if (m_is_compact)
+            return compact_code_point_at(index);
         return m_cells[index].code_point;
     }
 
     void set_code_point(size_t index, u32 code_point)
     {
+        expand();
         if (m_terminated_at.has_value()) {
             if (index > *m_terminated_at) {
                 m_terminated_at = index + 1;
@@ -73,6 +77,11 @@ public:
         m_cells[index].code_point = code_point;
     }
 
+    // Lines in the scrollback are stored compactly: code points take a single byte if they are all ASCII,
+    // and attributes are stored once per run of cells sharing them. Modifying the line expands it again.
+    void compact();
+    bool is_compact() const { return m_is_compact; }
+
     bool is_dirty() const { return m_dirty; }
     void set_dirty(bool b) { m_dirty = b; }
 
@@ -80,11 +89,30 @@ public:
     void set_terminated(u16 column) { m_terminated_at = column; }
 
 private:
+    struct AttributeRun {
+        u16 first_column { 0 };
+        Attribute attribute;
+    };
+
+    void expand()
+    {
+        if (m_is_compact)
+            expand_compact_cells();
+    }
+    void expand_compact_cells();
+    u32 compact_code_point_at(size_t index) const;
+    Attribute const& compact_attribute_at(size_t index) const;
+
     void take_cells_from_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
     void push_cells_into_next_line(size_t new_length, Line* next_line, bool cursor_is_on_next_line, CursorPosition* cursor);
 
     Vector<Cell> m_cells;
+    // The cells of a compacted line, see compact().
+    Vector<u8> m_compact_code_points;
+    Vector<AttributeRun> m_attribute_runs;
     bool m_dirty { false };
+    bool m_is_compact { false };
+    u8 m_compact_code_point_size { 1 };
     // Note: The alignment is 8, so this member lives in the padding (that already existed before it was introduced)
     [[no_unique_address]] Optional<u16> m_terminated_at;
 };
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibVT/Scrollback.h>
+
+namespace VT {
+
+void Scrollback::set_capacity(size_t capacity)
+{
+    linearize();
+    if (m_lines.size() > capacity)
+        m_lines.remove(0, m_lines.size() - capacity);
+    m_capacity = capacity;
+}
+
+OwnPtr<Line> Scrollback::append(NonnullOwnPtr<Line> line)
+{
+    if (m_capacity == 0)
+        return line;
+
+    line->compact();
+    if (m_lines.size() < m_capacity) {
+        VERIFY(m_start == 0);
+        m_lines.append(move(line));
+        return {};
+    }
+
+    swap(m_lines[m_start], line);
+    if (++m_start == m_lines.size())
+        m_start = 0;
+    return line;
+}
+
+NonnullOwnPtr<Line> Scrollback::take_last()
+{
+    linearize();
+    return m_lines.take_last();
+}
+
+void Scrollback::clear()
+{
+    m_lines.clear();
+    m_start = 0;
+}
+
+NonnullOwnPtrVector<Line> Scrollback::take_lines()
+{
+    linearize();
+    return NonnullOwnPtrVector<Line> { move(m_lines) };
+}
+
+void Scrollback::set_lines(NonnullOwnPtrVector<Line>&& lines)
+{
+    m_lines = move(static_cast<Vector<NonnullOwnPtr<Line>>&>(lines));
+    m_start = 0;
+    if (m_lines.size() > m_capacity)
+        m_lines.remove(0, m_lines.size() - m_capacity);
+    for (auto& line : m_lines)
+        line->compact();
+}
+
+void Scrollback::linearize()
+{
+    if (m_start == 0)
+        return;
+
+    Vector<NonnullOwnPtr<Line>> lines;
+    lines.ensure_capacity(m_lines.size());
+    for (size_t i = m_start; i < m_lines.size(); ++i)
+        lines.unchecked_append(move(m_lines[i]));
+    for (size_t i = 0; i < m_start; ++i)
+        lines.unchecked_append(move(m_lines[i]));
+    m_lines = move(lines);
+    m_start = 0;
+}
+
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/OwnPtr.h>
+#include <LibVT/Line.h>
+
+namespace VT {
+
+// The lines that have scrolled off the top of the screen, oldest first. Once the scrollback holds as many
+// lines as it may, it turns into a ring buffer, and each added line replaces the oldest one in constant time.
+// Lines are compacted when they are added, see Line::compact().
+class Scrollback {
+    AK_MAKE_NONCOPYABLE(Scrollback);
+    AK_MAKE_NONMOVABLE(Scrollback);
+
+public:
+    explicit Scrollback(size_t capacity)
+        : m_capacity(capacity)
+    {
+    }
+
+    size_t size() const { return m_lines.size(); }
+    bool is_empty() const { return m_lines.is_empty(); }
+    size_t capacity() const { return m_capacity; }
+
+    // Drops the oldest lines if there are more than the new capacity.
+    void set_capacity(size_t);
+
+    Line& operator[](size_t index) { return *m_lines[physical_index(index)]; }
+    Line const& operator[](size_t index) const { return *m_lines[physical_index(index)]; }
+    Line& last() { return (*this)[size() - 1]; }
+
+    // Returns the line that had to make room for the new one, if any, so that it can be reused.
+    OwnPtr<Line> append(NonnullOwnPtr<Line>);
+    NonnullOwnPtr<Line> take_last();
+    void clear();
+
+    // Moves all the lines out (oldest first), e.g. for rewrapping them, and back in. Moving them back in drops
+    // the oldest lines if there are more than the capacity.
+    NonnullOwnPtrVector<Line> take_lines();
+    void set_lines(NonnullOwnPtrVector<Line>&&);
+
+private:
+    size_t physical_index(size_t index) const
+    {
+        auto physical_index = m_start + index;
+        return physical_index < m_lines.size() ? physical_index : physical_index - m_lines.size();
+    }
+
+    // Moves the oldest line to the front of m_lines.
+    void linearize();
+
+    size_t m_capacity { 0 };
+    // The index of the oldest line in m_lines. This is only ever non-zero when the scrollback is full.
+    size_t m_start { 0 };
+    Vector<NonnullOwnPtr<Line>> m_lines;
+};
+
+}
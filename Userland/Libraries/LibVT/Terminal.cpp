@@ -42,7 +42,6 @@ void Terminal::clear_history()
     dbgln_if(TERMINAL_DEBUG, "Clear history");
     auto previous_history_size = m_history.size();
     m_history.clear();
-    m_history_start = 0;
     m_client.terminal_history_changed(-previous_history_size);
 }
 #endif
@@ -784,11 +783,15 @@ void Terminal::scroll_up(u16 region_top, u16 region_bottom, size_t count)
 
     int history_delta = -count;
     bool should_move_to_scrollback = !m_use_alternate_screen_buffer && max_history_size() != 0;
+    // Lines that were pushed out of the scrollback, to be reused for the new lines at the bottom.
+    Vector<NonnullOwnPtr<Line>, 4> evicted_lines;
     if (should_move_to_scrollback) {
         auto remaining_lines = max_history_size() - history_size();
         history_delta = (count > remaining_lines) ? remaining_lines - count : 0;
-        for (size_t i = 0; i < count; ++i)
-            add_line_to_history(move(active_buffer().ptr_at(region_top + i)));
+        for (size_t i = 0; i < count; ++i) {
+            if (auto evicted_line = m_history.append(move(active_buffer().ptr_at(region_top + i))))
+                evicted_lines.append(evicted_line.release_nonnull());
+        }
     }
 
     // Move lines into their new place.
@@ -797,8 +800,16 @@ void Terminal::scroll_up(u16 region_top, u16 region_bottom, size_t count)
     // Clear 'new' lines at the bottom.
     if (should_move_to_scrollback) {
         // Since we moved the previous lines into history, we can't just clear them.
-        for (u16 row = region_bottom + 1 - count; row <= region_bottom; ++row)
-            active_buffer().ptr_at(row) = make<Line>(columns());
+        for (u16 row = region_bottom + 1 - count; row <= region_bottom; ++row) {
+            if (evicted_lines.is_empty()) {
+                active_buffer().ptr_at(row) = make<Line>(columns());
+                continue;
+            }
+            auto line = evicted_lines.take_last();
+            line->clear();
+            line->set_length(columns());
+            active_buffer().ptr_at(row) = move(line);
+        }
     } else {
         // The new lines haven't been moved and we don't want to leak memory.
         for (u16 row = region_bottom + 1 - count; row <= region_bottom; ++row)
@@ -871,8 +882,9 @@ void Terminal::put_character_at(unsigned row, unsigned column, u32 code_point)
     VERIFY(column < columns());
     auto& line = active_buffer()[row];
     line.set_code_point(column, code_point);
-    line.attribute_at(column) = m_current_state.attribute;
-    line.attribute_at(column).flags |= Attribute::Touched;
+    auto& attribute = line.cell_at(column).attribute;
+    attribute = m_current_state.attribute;
+    attribute.flags |= Attribute::Touched;
     line.set_dirty(true);
 
     m_last_code_point = code_point;
@@ -1006,6 +1018,11 @@ void Terminal::on_input(u8 byte)
     m_parser.on_input(byte);
 }
 
+void Terminal::on_input(ReadonlyBytes bytes)
+{
+    m_parser.on_input(bytes);
+}
+
 void Terminal::emit_code_point(u32 code_point)
 {
     auto working_set = m_working_sets[m_active_working_set_index];
@@ -1031,6 +1048,43 @@ void Terminal::emit_code_point(u32 code_point)
     }
 }
 
+void Terminal::emit_printable_ascii(ReadonlyBytes bytes)
+{
+    // The VT100 character set replaces some ASCII characters, so leave that to emit_code_point().
+    if (m_working_sets[m_active_working_set_index] == CharacterSet::VT100) {
+        EscapeSequenceExecutor::emit_printable_ascii(bytes);
+        return;
+    }
+
+    while (!bytes.is_empty()) {
+        // Characters before the last column never wrap, so those can be put into the line directly.
+        unsigned column = cursor_column();
+        if (m_stomp || column + 1 >= columns()) {
+            emit_code_point(bytes[0]);
+            bytes = bytes.slice(1);
+            continue;
+        }
+
+        auto count = min<size_t>(bytes.size(), columns() - 1 - column);
+#ifndef KERNEL
+        auto& line = active_buffer()[cursor_row()];
+        auto attribute = m_current_state.attribute;
+        attribute.flags |= Attribute::Touched;
+        for (size_t i = 0; i < count; ++i) {
+            line.set_code_point(column + i, bytes[i]);
+            line.cell_at(column + i).attribute = attribute;
+        }
+        line.set_dirty(true);
+        m_last_code_point = bytes[count - 1];
+#else
+        for (size_t i = 0; i < count; ++i)
+            put_character_at(cursor_row(), column + i, bytes[i]);
+#endif
+        set_cursor(cursor_row(), column + count, true);
+        bytes = bytes.slice(count);
+    }
+}
+
 void Terminal::execute_control_code(u8 code)
 {
     ArmedScopeGuard clear_position_before_cr {
@@ -1341,8 +1395,7 @@ void Terminal::execute_dcs_sequence()
 
 void Terminal::inject_string(StringView str)
 {
-    for (size_t i = 0; i < str.length(); ++i)
-        on_input(str[i]);
+    on_input(str.bytes());
 }
 
 void Terminal::emit_string(StringView string)
@@ -1575,35 +1628,38 @@ void Terminal::set_size(u16 columns, u16 rows)
     };
 
     auto old_history_size = m_history.size();
-    m_history.extend(move(m_normal_screen_buffer));
+    auto lines = m_history.take_lines();
+    lines.extend(move(m_normal_screen_buffer));
     CursorPosition cursor_tracker { cursor_row() + old_history_size, cursor_column() };
-    resize_and_rewrap(m_history, cursor_tracker);
-    if (auto extra_lines = m_history.size() - rows) {
+    resize_and_rewrap(lines, cursor_tracker);
+    if (auto extra_lines = lines.size() - rows) {
         while (extra_lines > 0) {
-            if (m_history.size() <= cursor_tracker.row)
+            if (lines.size() <= cursor_tracker.row)
                 break;
-            if (m_history.last().is_empty()) {
-                if (m_history.size() >= 2 && m_history[m_history.size() - 2].termination_column().has_value())
+            if (lines.last().is_empty()) {
+                if (lines.size() >= 2 && lines[lines.size() - 2].termination_column().has_value())
                     break;
                 --extra_lines;
-                (void)m_history.take_last();
+                (void)lines.take_last();
                 continue;
             }
             break;
         }
     }
 
-    // FIXME: This can use a more performant way to move the last N entries
-    //        from the history into the normal buffer
+    // The last rows lines go to the screen, the rest back into the scrollback.
+    auto screen_line_count = min<size_t>(rows, lines.size());
+    auto first_screen_line = lines.size() - screen_line_count;
+    m_normal_screen_buffer.clear();
     m_normal_screen_buffer.ensure_capacity(rows);
-    while (m_normal_screen_buffer.size() < rows) {
-        if (!m_history.is_empty())
-            m_normal_screen_buffer.prepend(m_history.take_last());
-        else
-            m_normal_screen_buffer.unchecked_append(make<Line>(columns));
-    }
-
-    cursor_tracker.row -= m_history.size();
+    for (size_t i = first_screen_line; i < lines.size(); ++i)
+        m_normal_screen_buffer.unchecked_append(move(lines.ptr_at(i)));
+    lines.shrink(first_screen_line);
+    while (m_normal_screen_buffer.size() < rows)
+        m_normal_screen_buffer.unchecked_append(make<Line>(columns));
+
+    cursor_tracker.row -= lines.size();
+    m_history.set_lines(move(lines));
 
     if (m_history.size() != old_history_size) {
         m_client.terminal_history_changed(-old_history_size);
@@ -20,6 +20,7 @@
 #    include <AK/String.h>
 #    include <LibVT/Attribute.h>
 #    include <LibVT/Line.h>
+#    include <LibVT/Scrollback.h>
 #else
 namespace Kernel {
 class VirtualConsole;
@@ -78,6 +79,7 @@ public:
 #endif
 
     void on_input(u8);
+    void on_input(ReadonlyBytes);
 
     void set_cursor(unsigned row, unsigned column, bool skip_debug = false);
 
@@ -125,7 +127,7 @@ public:
             return m_alternate_screen_buffer[index];
         } else {
             if (index < m_history.size())
-                return m_history[(m_history_start + index) % m_history.size()];
+                return m_history[index];
             return m_normal_screen_buffer[index - m_history.size()];
         }
     }
@@ -144,31 +146,13 @@ public:
         return active_buffer()[index];
     }
 
-    size_t max_history_size() const { return m_max_history_lines; }
+    size_t max_history_size() const { return m_history.capacity(); }
     void set_max_history_size(size_t value)
     {
-        if (value == 0) {
-            auto previous_size = m_history.size();
-            m_max_history_lines = 0;
-            m_history_start = 0;
-            m_history.clear();
-            m_client.terminal_history_changed(-previous_size);
-            return;
-        }
-
-        if (m_max_history_lines > value) {
-            NonnullOwnPtrVector<Line> new_history;
-            new_history.ensure_capacity(value);
-            auto existing_line_count = min(m_history.size(), value);
-            for (size_t i = m_history.size() - existing_line_count; i < m_history.size(); ++i) {
-                auto j = (m_history_start + i) % m_history.size();
-                new_history.unchecked_append(move(static_cast<Vector<NonnullOwnPtr<Line>>&>(m_history).at(j)));
-            }
-            m_history = move(new_history);
-            m_history_start = 0;
-            m_client.terminal_history_changed(value - existing_line_count);
-        }
-        m_max_history_lines = value;
+        auto previous_size = m_history.size();
+        m_history.set_capacity(value);
+        if (m_history.size() != previous_size)
+            m_client.terminal_history_changed(static_cast<int>(m_history.size()) - static_cast<int>(previous_size));
     }
     size_t history_size() const { return m_use_alternate_screen_buffer ? 0 : m_history.size(); }
 #endif
@@ -193,6 +177,7 @@ public:
 protected:
     // ^EscapeSequenceExecutor
     virtual void emit_code_point(u32) override;
+    virtual void emit_printable_ascii(ReadonlyBytes) override;
     virtual void execute_control_code(u8) override;
     virtual void execute_escape_sequence(Intermediates intermediates, bool ignore, u8 last_byte) override;
     virtual void execute_csi_sequence(Parameters parameters, Intermediates intermediates, bool ignore, u8 last_byte) override;
@@ -382,26 +367,7 @@ protected:
 
     EscapeSequenceParser m_parser;
 #ifndef KERNEL
-    size_t m_history_start = 0;
-    NonnullOwnPtrVector<Line> m_history;
-    void add_line_to_history(NonnullOwnPtr<Line>&& line)
-    {
-        if (max_history_size() == 0)
-            return;
-
-        // If m_history can expand, add the new line to the end of the list.
-        // If there is an overflow wrap, the end is at the index before the start.
-        if (m_history.size() < max_history_size()) {
-            if (m_history_start == 0)
-                m_history.append(move(line));
-            else
-                m_history.insert(m_history_start - 1, move(line));
-
-            return;
-        }
-        m_history.ptr_at(m_history_start) = move(line);
-        m_history_start = (m_history_start + 1) % m_history.size();
-    }
+    Scrollback m_history { 1024 };
 
     NonnullOwnPtrVector<Line>& active_buffer() { return m_use_alternate_screen_buffer ? m_alternate_screen_buffer : m_normal_screen_buffer; };
     const NonnullOwnPtrVector<Line>& active_buffer() const { return m_use_alternate_screen_buffer ? m_alternate_screen_buffer : m_normal_screen_buffer; };
@@ -450,7 +416,6 @@ protected:
 
     Vector<bool> m_horizontal_tabs;
     u32 m_last_code_point { 0 };
-    size_t m_max_history_lines { 1024 };
 
     Optional<u16> m_column_before_carriage_return;
     bool m_controls_are_logically_generated { false };
@@ -50,7 +50,7 @@ void TerminalWidget::set_pty_master_fd(int fd)
     }
     m_notifier = Core::Notifier::construct(m_ptm_fd, Core::Notifier::Read);
     m_notifier->on_ready_to_read = [this] {
-        u8 buffer[BUFSIZ];
+        u8 buffer[16 * KiB];
         ssize_t nread = read(m_ptm_fd, buffer, sizeof(buffer));
         if (nread < 0) {
             dbgln("Terminal read error: {}", strerror(errno));
@@ -69,9 +69,8 @@ void TerminalWidget::set_pty_master_fd(int fd)
             set_pty_master_fd(-1);
             return;
         }
-        for (ssize_t i = 0; i < nread; ++i)
-            m_terminal.on_input(buffer[i]);
-        flush_dirty_lines();
+        m_terminal.on_input({ buffer, static_cast<size_t>(nread) });
+        schedule_flush_dirty_lines();
     };
 }
 
@@ -89,6 +88,7 @@ TerminalWidget::TerminalWidget(int ptm_fd, bool automatic_size_policy)
     m_cursor_blink_timer = add<Core::Timer>();
     m_visual_beep_timer = add<Core::Timer>();
     m_auto_scroll_timer = add<Core::Timer>();
+    m_flush_timer = add<Core::Timer>();
 
     m_scrollbar = add<GUI::Scrollbar>(Orientation::Vertical);
     m_scrollbar->set_scroll_animation(GUI::Scrollbar::Animation::CoarseScroll);
@@ -114,6 +114,11 @@ TerminalWidget::TerminalWidget(int ptm_fd, bool automatic_size_policy)
     };
     m_auto_scroll_timer->start();
 
+    m_flush_timer->set_single_shot(true);
+    m_flush_timer->on_timeout = [this] {
+        flush_dirty_lines();
+    };
+
     auto font_entry = Config::read_string("Terminal", "Text", "Font", "default");
     if (font_entry == "default")
         set_font(Gfx::FontDatabase::default_fixed_width_font());
@@ -469,8 +474,34 @@ void TerminalWidget::invalidate_cursor()
     m_terminal.invalidate_cursor();
 }
 
+void TerminalWidget::schedule_flush_dirty_lines()
+{
+    // Output can arrive a lot faster than it can be painted, so don't repaint more often than once per frame.
+    static constexpr int frame_interval_ms = 1000 / 60;
+
+    if (m_flush_timer->is_active())
+        return;
+    auto time_since_flush_ms = m_time_since_flush.is_valid() ? m_time_since_flush.elapsed() : frame_interval_ms;
+    if (time_since_flush_ms >= frame_interval_ms) {
+        flush_dirty_lines();
+        return;
+    }
+    m_flush_timer->start(frame_interval_ms - time_since_flush_ms);
+}
+
 void TerminalWidget::flush_dirty_lines()
 {
+    m_flush_timer->stop();
+    m_time_since_flush.start();
+
+    if (m_history_changed_since_flush) {
+        m_history_changed_since_flush = false;
+        m_scrollbar->set_max(m_terminal.history_size());
+        if (m_was_scrolled_to_bottom_before_history_change)
+            m_scrollbar->set_value(m_scrollbar->max());
+        m_scrollbar->update();
+    }
+
     // FIXME: Update smarter when scrolled
     if (m_terminal.m_need_full_flush || m_scrollbar->value() != m_scrollbar->max()) {
         update();
@@ -974,11 +1005,11 @@ int TerminalWidget::last_selection_column_on_row(int row) const
 
 void TerminalWidget::terminal_history_changed(int delta)
 {
-    bool was_max = m_scrollbar->value() == m_scrollbar->max();
-    m_scrollbar->set_max(m_terminal.history_size());
-    if (was_max)
-        m_scrollbar->set_value(m_scrollbar->max());
-    m_scrollbar->update();
+    if (!m_history_changed_since_flush) {
+        m_history_changed_since_flush = true;
+        m_was_scrolled_to_bottom_before_history_change = m_scrollbar->value() == m_scrollbar->max();
+    }
+    schedule_flush_dirty_lines();
     // If the history buffer wrapped around, the selection needs to be offset accordingly.
     if (m_selection.is_valid() && delta < 0)
         m_selection.offset_row(delta);
@@ -38,6 +38,8 @@ public:
     }
 
     void flush_dirty_lines();
+    // Flushes the dirty lines now or, if that was done less than a frame ago, as soon as a frame has passed.
+    void schedule_flush_dirty_lines();
 
     void apply_size_increments_to_window(GUI::Window&);
 
@@ -211,6 +213,12 @@ private:
     RefPtr<Core::Timer> m_cursor_blink_timer;
     RefPtr<Core::Timer> m_visual_beep_timer;
     RefPtr<Core::Timer> m_auto_scroll_timer;
+    RefPtr<Core::Timer> m_flush_timer;
+
+    Core::ElapsedTimer m_time_since_flush;
+    // The scrollbar is only brought up to date when flushing, as the history changes with every line of output.
+    bool m_history_changed_since_flush { false };
+    bool m_was_scrolled_to_bottom_before_history_change { false };
 
     RefPtr<GUI::Scrollbar> m_scrollbar;
 
@@ -6,13 +6,14 @@
 
 #pragma once
 
-#include <AK/ByteBuffer.h>
+#include <AK/BinarySearch.h>
 #include <AK/FlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <AK/Utf8View.h>
+#include <LibCore/MappedFile.h>
 
 namespace Video {
 
@@ -122,8 +123,9 @@ public:
     bool discardable() const { return m_discardable; }
     void set_discardable(bool discardable) { m_discardable = discardable; }
     u64 frame_count() const { return m_frames.size(); }
-    ByteBuffer const& frame(size_t index) const { return m_frames.at(index); }
-    void add_frame(ByteBuffer frame) { m_frames.append(move(frame)); }
+    // Frames point into the data the document was parsed from, which has to outlive them.
+    ReadonlyBytes frame(size_t index) const { return m_frames.at(index); }
+    void add_frame(ReadonlyBytes frame) { m_frames.append(frame); }
 
 private:
     u64 m_track_number { 0 };
@@ -132,7 +134,7 @@ private:
     bool m_invisible { false };
     Lacing m_lacing { None };
     bool m_discardable { true };
-    Vector<ByteBuffer> m_frames;
+    Vector<ReadonlyBytes> m_frames;
 };
 
 class Cluster {
@@ -147,6 +149,20 @@ private:
     NonnullOwnPtrVector<Block> m_blocks;
 };
 
+// Where a cluster starts, relative to the beginning of the segment's data, as in the Cues.
+struct ClusterPosition {
+    u64 position;
+    // Only known if the cluster's first element was its timestamp, which is where muxers put it.
+    Optional<u64> timestamp;
+};
+
+// A point the Cues say playback of a track can start from.
+struct CuePoint {
+    u64 timestamp;
+    u64 track_number;
+    u64 cluster_position;
+};
+
 class MatroskaDocument {
 public:
     explicit MatroskaDocument(EBMLHeader m_header)
@@ -183,13 +199,65 @@ public:
     {
         m_tracks.set(track_number, move(track));
     }
-    NonnullOwnPtrVector<Cluster>& clusters() { return m_clusters; }
+
+    // Clusters aren't parsed along with the rest of the document, see MatroskaReader::parse_cluster() for that.
+    size_t cluster_count() const { return m_cluster_positions.size(); }
+    Vector<ClusterPosition> const& cluster_positions() const { return m_cluster_positions; }
+    void add_cluster_position(ClusterPosition position) { m_cluster_positions.append(position); }
+    Vector<CuePoint> const& cue_points() const { return m_cue_points; }
+    void add_cue_point(CuePoint cue_point) { m_cue_points.append(cue_point); }
+
+    // The index of the cluster to start reading the track from to get to the given timestamp (in units of the timestamp scale).
+    Optional<size_t> cluster_index_for_timestamp(u64 track_number, u64 timestamp) const
+    {
+        if (m_cluster_positions.is_empty())
+            return {};
+
+        Optional<u64> cue_position;
+        u64 cue_timestamp = 0;
+        for (auto const& cue_point : m_cue_points) {
+            if (cue_point.track_number != track_number || cue_point.timestamp > timestamp)
+                continue;
+            if (!cue_position.has_value() || cue_point.timestamp >= cue_timestamp) {
+                cue_position = cue_point.cluster_position;
+                cue_timestamp = cue_point.timestamp;
+            }
+        }
+        if (cue_position.has_value()) {
+            size_t index = 0;
+            auto* found = binary_search(m_cluster_positions, cue_position.value(), &index, [](u64 position, ClusterPosition const& cluster) {
+                return static_cast<int>(position > cluster.position) - static_cast<int>(position < cluster.position);
+            });
+            if (found)
+                return index;
+        }
+
+        // Without a usable cue, settle for the last cluster that starts at or before the timestamp.
+        size_t index = 0;
+        for (size_t i = 0; i < m_cluster_positions.size(); ++i) {
+            auto cluster_timestamp = m_cluster_positions[i].timestamp;
+            if (cluster_timestamp.has_value() && cluster_timestamp.value() > timestamp)
+                break;
+            index = i;
+        }
+        return index;
+    }
+
+    // The segment's data, which the clusters (and the frames in them) are read from.
+    ReadonlyBytes segment_data() const { return m_segment_data; }
+    void set_segment_data(ReadonlyBytes segment_data) { m_segment_data = segment_data; }
+
+    // Keeps the file mapped for as long as the frames that point into it are around.
+    void set_mapped_file(NonnullRefPtr<Core::MappedFile> mapped_file) { m_mapped_file = move(mapped_file); }
 
 private:
     EBMLHeader m_header;
     OwnPtr<SegmentInformation> m_segment_information;
     HashMap<u64, NonnullOwnPtr<TrackEntry>> m_tracks;
-    NonnullOwnPtrVector<Cluster> m_clusters;
+    Vector<ClusterPosition> m_cluster_positions;
+    Vector<CuePoint> m_cue_points;
+    ReadonlyBytes m_segment_data;
+    RefPtr<Core::MappedFile> m_mapped_file;
 };
 
 }
@@ -40,6 +40,12 @@ constexpr u32 CHANNELS_ID = 0x9F;
 constexpr u32 BIT_DEPTH_ID = 0x6264;
 constexpr u32 SIMPLE_BLOCK_ID = 0xA3;
 constexpr u32 TIMESTAMP_ID = 0xE7;
+constexpr u32 CUES_ID = 0x1C53BB6B;
+constexpr u32 CUE_POINT_ID = 0xBB;
+constexpr u32 CUE_TIME_ID = 0xB3;
+constexpr u32 CUE_TRACK_POSITIONS_ID = 0xB7;
+constexpr u32 CUE_TRACK_ID = 0xF7;
+constexpr u32 CUE_CLUSTER_POSITION_ID = 0xF1;
 
 OwnPtr<MatroskaDocument> MatroskaReader::parse_matroska_from_file(StringView path)
 {
@@ -48,7 +54,10 @@ OwnPtr<MatroskaDocument> MatroskaReader::parse_matroska_from_file(StringView pat
         return {};
 
     auto mapped_file = mapped_file_result.release_value();
-    return parse_matroska_from_data((u8*)mapped_file->data(), mapped_file->size());
+    auto matroska_document = parse_matroska_from_data((u8*)mapped_file->data(), mapped_file->size());
+    if (matroska_document)
+        matroska_document->set_mapped_file(move(mapped_file));
+    return matroska_document;
 }
 
 OwnPtr<MatroskaDocument> MatroskaReader::parse_matroska_from_data(u8 const* data, size_t size)
@@ -57,6 +66,20 @@ OwnPtr<MatroskaDocument> MatroskaReader::parse_matroska_from_data(u8 const* data
     return reader.parse();
 }
 
+OwnPtr<Cluster> MatroskaReader::parse_cluster(MatroskaDocument const& matroska_document, size_t cluster_index)
+{
+    auto segment_data = matroska_document.segment_data();
+    auto position = matroska_document.cluster_positions()[cluster_index].position;
+    if (position >= segment_data.size())
+        return {};
+
+    MatroskaReader reader(segment_data.data() + position, segment_data.size() - position);
+    auto element_id = reader.m_streamer.read_variable_size_integer(false);
+    if (!element_id.has_value() || element_id.value() != CLUSTER_ELEMENT_ID)
+        return {};
+    return reader.parse_cluster();
+}
+
 OwnPtr<MatroskaDocument> MatroskaReader::parse()
 {
     auto first_element_id = m_streamer.read_variable_size_integer(false);
@@ -139,6 +162,14 @@ Optional<EBMLHeader> MatroskaReader::parse_ebml_header()
 bool MatroskaReader::parse_segment_elements(MatroskaDocument& matroska_document)
 {
     dbgln_if(MATROSKA_DEBUG, "Parsing segment elements");
+    // Positions in the segment (like the ones in the Cues) are relative to the start of its data, which comes after its size.
+    auto size_streamer = m_streamer;
+    auto segment_size = size_streamer.read_variable_size_integer();
+    if (!segment_size.has_value())
+        return false;
+    m_segment_data_start = size_streamer.data();
+    matroska_document.set_segment_data({ m_segment_data_start, min(segment_size.value(), size_streamer.remaining()) });
+
     auto success = parse_master_element("Segment", [&](u64 element_id) {
         if (element_id == SEGMENT_INFORMATION_ELEMENT_ID) {
             auto segment_information = parse_information();
@@ -148,10 +179,12 @@ bool MatroskaReader::parse_segment_elements(MatroskaDocument& matroska_document)
         } else if (element_id == TRACK_ELEMENT_ID) {
             return parse_tracks(matroska_document);
         } else if (element_id == CLUSTER_ELEMENT_ID) {
-            auto cluster = parse_cluster();
-            if (!cluster)
-                return false;
-            matroska_document.clusters().append(cluster.release_nonnull());
+            // Clusters make up almost all of the file, so they are only located here (the ID that was just read is 4 octets long).
+            auto position = static_cast<u64>(m_streamer.data() - m_segment_data_start) - 4;
+            matroska_document.add_cluster_position({ position, peek_cluster_timestamp() });
+            return read_unknown_element();
+        } else if (element_id == CUES_ID) {
+            return parse_cues(matroska_document);
         } else {
             return read_unknown_element();
         }
@@ -318,6 +351,17 @@ Optional<TrackEntry::AudioTrack> MatroskaReader::parse_audio_track_information()
     return audio_track;
 }
 
+Optional<u64> MatroskaReader::peek_cluster_timestamp()
+{
+    MatroskaReader reader(m_streamer.data(), m_streamer.remaining());
+    if (!reader.m_streamer.read_variable_size_integer().has_value() || !reader.m_streamer.has_octet())
+        return {};
+    auto element_id = reader.m_streamer.read_variable_size_integer(false);
+    if (!element_id.has_value() || element_id.value() != TIMESTAMP_ID || !reader.m_streamer.has_octet())
+        return {};
+    return reader.read_u64_element();
+}
+
 OwnPtr<Cluster> MatroskaReader::parse_cluster()
 {
     auto cluster = make<Cluster>();
@@ -404,32 +448,75 @@ OwnPtr<Block> MatroskaReader::parse_simple_block()
 
         for (int i = 0; i < frame_count; i++) {
             auto current_frame_size = frame_sizes.at(i);
-            auto frame_result = ByteBuffer::copy(m_streamer.data(), current_frame_size);
-            if (frame_result.is_error())
-                return {};
-            block->add_frame(frame_result.release_value());
+            block->add_frame({ m_streamer.data(), current_frame_size });
             m_streamer.drop_octets(current_frame_size);
         }
     } else if (block->lacing() == Block::Lacing::FixedSize) {
         auto frame_count = m_streamer.read_octet() + 1;
         auto individual_frame_size = total_frame_content_size / frame_count;
         for (int i = 0; i < frame_count; i++) {
-            auto frame_result = ByteBuffer::copy(m_streamer.data(), individual_frame_size);
-            if (frame_result.is_error())
-                return {};
-            block->add_frame(frame_result.release_value());
+            block->add_frame({ m_streamer.data(), individual_frame_size });
             m_streamer.drop_octets(individual_frame_size);
         }
     } else {
-        auto frame_result = ByteBuffer::copy(m_streamer.data(), total_frame_content_size);
-        if (frame_result.is_error())
-            return {};
-        block->add_frame(frame_result.release_value());
+        block->add_frame({ m_streamer.data(), total_frame_content_size });
         m_streamer.drop_octets(total_frame_content_size);
     }
     return block;
 }
 
+bool MatroskaReader::parse_cues(MatroskaDocument& matroska_document)
+{
+    return parse_master_element("Cues", [&](u64 element_id) {
+        if (element_id == CUE_POINT_ID)
+            return parse_cue_point(matroska_document);
+        return read_unknown_element();
+    });
+}
+
+bool MatroskaReader::parse_cue_point(MatroskaDocument& matroska_document)
+{
+    Optional<u64> timestamp;
+    Vector<CuePoint> cue_points;
+    auto success = parse_master_element("CuePoint", [&](u64 element_id) {
+        if (element_id == CUE_TIME_ID) {
+            timestamp = read_u64_element();
+            CHECK_HAS_VALUE(timestamp);
+        } else if (element_id == CUE_TRACK_POSITIONS_ID) {
+            Optional<u64> track_number;
+            Optional<u64> cluster_position;
+            auto success = parse_master_element("CueTrackPositions", [&](u64 element_id) {
+                if (element_id == CUE_TRACK_ID) {
+                    track_number = read_u64_element();
+                    CHECK_HAS_VALUE(track_number);
+                } else if (element_id == CUE_CLUSTER_POSITION_ID) {
+                    cluster_position = read_u64_element();
+                    CHECK_HAS_VALUE(cluster_position);
+                } else {
+                    return read_unknown_element();
+                }
+
+                return true;
+            });
+            if (!success || !track_number.has_value() || !cluster_position.has_value())
+                return false;
+            cue_points.append({ 0, track_number.value(), cluster_position.value() });
+        } else {
+            return read_unknown_element();
+        }
+
+        return true;
+    });
+
+    if (!success || !timestamp.has_value())
+        return false;
+    for (auto& cue_point : cue_points) {
+        cue_point.timestamp = timestamp.value();
+        matroska_document.add_cue_point(cue_point);
+    }
+    return true;
+}
+
 Optional<String> MatroskaReader::read_string_element()
 {
     auto string_length = m_streamer.read_variable_size_integer();
@@ -24,6 +24,8 @@ public:
 
     static OwnPtr<MatroskaDocument> parse_matroska_from_file(StringView path);
     static OwnPtr<MatroskaDocument> parse_matroska_from_data(u8 const*, size_t);
+    // Clusters are only located when the document is parsed, this parses one of them when it's needed.
+    static OwnPtr<Cluster> parse_cluster(MatroskaDocument const&, size_t cluster_index);
 
     OwnPtr<MatroskaDocument> parse();
 
@@ -156,7 +158,10 @@ private:
     OwnPtr<TrackEntry> parse_track_entry();
     Optional<TrackEntry::VideoTrack> parse_video_track_information();
     Optional<TrackEntry::AudioTrack> parse_audio_track_information();
+    Optional<u64> peek_cluster_timestamp();
     OwnPtr<Cluster> parse_cluster();
+    bool parse_cues(MatroskaDocument&);
+    bool parse_cue_point(MatroskaDocument&);
     OwnPtr<Block> parse_simple_block();
 
     Optional<String> read_string_element();
@@ -164,6 +169,7 @@ private:
     bool read_unknown_element();
 
     Streamer m_streamer;
+    u8 const* m_segment_data_start { nullptr };
 };
 
 }
@@ -14,7 +14,7 @@ Decoder::Decoder()
 {
 }
 
-bool Decoder::decode_frame(ByteBuffer const& frame_data)
+bool Decoder::decode_frame(ReadonlyBytes frame_data)
 {
     SAFE_CALL(m_parser->parse_frame(frame_data));
     // TODO:
@@ -7,7 +7,7 @@
 #pragma once
 
 #include "Parser.h"
-#include <AK/ByteBuffer.h>
+#include <AK/Span.h>
 
 namespace Video::VP9 {
 
@@ -16,7 +16,7 @@ class Decoder {
 
 public:
     Decoder();
-    bool decode_frame(ByteBuffer const&);
+    bool decode_frame(ReadonlyBytes);
     void dump_frame_info();
 
 private:
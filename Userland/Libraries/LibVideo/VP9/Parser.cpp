@@ -42,7 +42,7 @@ void Parser::cleanup_tile_allocations()
 }
 
 /* (6.1) */
-bool Parser::parse_frame(ByteBuffer const& frame_data)
+bool Parser::parse_frame(ReadonlyBytes frame_data)
 {
     m_bit_stream = make<BitStream>(frame_data.data(), frame_data.size());
     m_syntax_element_counter = make<SyntaxElementCounter>();
@@ -1249,10 +1249,14 @@ bool Parser::residual()
                         SAFE_CALL(m_decoder.reconstruct(plane, start_x, start_y, tx_size));
                     }
                 }
-                auto above_sub_context = m_above_nonzero_context[plane];
-                auto left_sub_context = m_left_nonzero_context[plane];
-                above_sub_context.resize_and_keep_capacity((start_x >> 2) + step);
-                left_sub_context.resize_and_keep_capacity((start_y >> 2) + step);
+                // These are updated in place: copying them here would allocate for every transform block, and the
+                // writes wouldn't reach the contexts that calculate_more_coefs_probability() reads.
+                auto& above_sub_context = m_above_nonzero_context[plane];
+                auto& left_sub_context = m_left_nonzero_context[plane];
+                if (above_sub_context.size() < (start_x >> 2) + step)
+                    above_sub_context.resize_and_keep_capacity((start_x >> 2) + step);
+                if (left_sub_context.size() < (start_y >> 2) + step)
+                    left_sub_context.resize_and_keep_capacity((start_y >> 2) + step);
                 for (auto i = 0; i < step; i++) {
                     above_sub_context[(start_x >> 2) + i] = non_zero;
                     left_sub_context[(start_y >> 2) + i] = non_zero;
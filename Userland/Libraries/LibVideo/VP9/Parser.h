@@ -12,8 +12,8 @@
 #include "ProbabilityTables.h"
 #include "SyntaxElementCounter.h"
 #include "TreeParser.h"
-#include <AK/ByteBuffer.h>
 #include <AK/OwnPtr.h>
+#include <AK/Span.h>
 
 namespace Video::VP9 {
 
@@ -26,7 +26,7 @@ class Parser {
 public:
     explicit Parser(Decoder&);
     ~Parser();
-    bool parse_frame(ByteBuffer const&);
+    bool parse_frame(ReadonlyBytes);
     void dump_info();
 
 private:
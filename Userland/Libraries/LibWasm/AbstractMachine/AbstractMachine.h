@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Badge.h>
 #include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/HashTable.h>
@@ -351,14 +352,16 @@ public:
         if (size_to_grow == 0)
             return true;
         u64 new_size = m_data.size() + size_to_grow;
-        // Can't grow past 2^16 pages.
-        if (new_size >= Constants::page_size * 65536)
+        if (new_size > maximum_size())
             return false;
-        if (auto max = m_type.limits().max(); max.has_value()) {
-            if (max.value() * Constants::page_size < new_size)
+        auto previous_size = m_size;
+        // Modules tend to grow their memory a few pages at a time, so reserve ahead to avoid copying the whole memory on every grow.
+        if (new_size > m_data.capacity()) {
+            u64 new_capacity = max(new_size, static_cast<u64>(m_data.capacity()) * 2);
+            new_capacity = min(new_capacity, maximum_size());
+            if (m_data.try_ensure_capacity(new_capacity).is_error() && m_data.try_ensure_capacity(new_size).is_error())
                 return false;
         }
-        auto previous_size = m_size;
         if (m_data.try_resize(new_size).is_error())
             return false;
         m_size = new_size;
@@ -368,6 +371,15 @@ public:
     }
 
 private:
+    u64 maximum_size() const
+    {
+        // Can't grow past 2^16 pages.
+        u64 maximum = Constants::page_size * 65535ull;
+        if (auto max = m_type.limits().max(); max.has_value())
+            maximum = min(maximum, max.value() * static_cast<u64>(Constants::page_size));
+        return maximum;
+    }
+
     explicit MemoryInstance(MemoryType const& type)
         : m_type(type)
     {
@@ -492,23 +504,35 @@ public:
     auto& expression() const { return m_expression; }
     auto arity() const { return m_arity; }
 
+    // Where the label of the frame is on the stack; everything above it belongs to the frame.
+    auto label_index() const { return m_label_index; }
+    void set_label_index(Badge<Configuration>, size_t index) { m_label_index = index; }
+
 private:
     ModuleInstance const& m_module;
     Vector<Value> m_locals;
     Expression const& m_expression;
     size_t m_arity { 0 };
+    size_t m_label_index { 0 };
 };
 
 class Stack {
 public:
-    using EntryType = Variant<Value, Label, Frame>;
+    // The frames are kept apart, see Configuration, so that the entries stay small and cheap to move.
+    using EntryType = Variant<Value, Label>;
     Stack() = default;
 
     [[nodiscard]] ALWAYS_INLINE bool is_empty() const { return m_data.is_empty(); }
-    ALWAYS_INLINE void push(EntryType entry) { m_data.append(move(entry)); }
+    ALWAYS_INLINE void push(EntryType entry)
+    {
+        // Nearly every instruction pushes something, so only growing the stack is left out of line.
+        if (m_data.size() == m_data.capacity()) [[unlikely]]
+            m_data.grow_capacity(m_data.size() + 1);
+        m_data.unchecked_append(move(entry));
+    }
     ALWAYS_INLINE auto pop() { return m_data.take_last(); }
-    ALWAYS_INLINE auto& peek() const { return m_data.last(); }
-    ALWAYS_INLINE auto& peek() { return m_data.last(); }
+    ALWAYS_INLINE auto& peek() const { return m_data[m_data.size() - 1]; }
+    ALWAYS_INLINE auto& peek() { return m_data[m_data.size() - 1]; }
 
     ALWAYS_INLINE auto size() const { return m_data.size(); }
     ALWAYS_INLINE auto& entries() const { return m_data; }
@@ -22,13 +22,6 @@ namespace Wasm {
         }                                                                                      \
     } while (false)
 
-#define TRAP_IF_NOT_NORETURN(x)                                                                \
-    do {                                                                                       \
-        if (trap_if_not(x, #x##sv)) {                                                          \
-            dbgln_if(WASM_TRACE_DEBUG, "Trapped because {} failed, at line {}", #x, __LINE__); \
-        }                                                                                      \
-    } while (false)
-
 void BytecodeInterpreter::interpret(Configuration& configuration)
 {
     m_trap.clear();
@@ -58,24 +51,21 @@ void BytecodeInterpreter::interpret(Configuration& configuration)
 void BytecodeInterpreter::branch_to_label(Configuration& configuration, LabelIndex index)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Branch to label with index {}...", index.value());
-    auto label = configuration.nth_label(index.value());
-    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label->continuation().value(), label->arity());
-    auto results = pop_values(configuration, label->arity());
+    auto label_index = configuration.nth_label_index(index.value());
+    auto& entries = configuration.stack().entries();
+    auto label = entries[*label_index].get<Label>();
+    dbgln_if(WASM_TRACE_DEBUG, "...which is actually IP {}, and has {} result(s)", label.continuation().value(), label.arity());
 
-    size_t drop_count = index.value() + 1;
-    for (; !configuration.stack().is_empty();) {
-        auto& entry = configuration.stack().peek();
-        if (entry.has<Label>()) {
-            if (--drop_count == 0)
-                break;
-        }
-        configuration.stack().pop();
+    // The label stays, and the results take the place of whatever was above it.
+    auto results_index = entries.size() - label.arity();
+    auto target_index = *label_index + 1;
+    if (results_index != target_index) {
+        for (size_t i = 0; i < label.arity(); ++i)
+            entries[target_index + i] = entries[results_index + i];
+        entries.shrink(target_index + label.arity(), true);
     }
 
-    for (auto& result : results)
-        configuration.stack().push(move(result));
-
-    configuration.ip() = label->continuation();
+    configuration.ip() = label.continuation();
 }
 
 template<typename ReadType, typename PushType>
@@ -103,7 +93,8 @@ void BytecodeInterpreter::load_and_push(Configuration& configuration, Instructio
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "load({} : {}) -> stack", instance_address, sizeof(ReadType));
-    auto slice = memory->data().bytes().slice(instance_address, sizeof(ReadType));
+    // The access was checked above, so skip the bounds checks of slice().
+    ReadonlyBytes slice { memory->data().data() + instance_address, sizeof(ReadType) };
     configuration.stack().peek() = Value(static_cast<PushType>(read_value<ReadType>(slice)));
 }
 
@@ -246,7 +237,7 @@ void BytecodeInterpreter::store_to_memory(Configuration& configuration, Instruct
         return;
     }
     dbgln_if(WASM_TRACE_DEBUG, "temporary({}b) -> store({})", data.size(), instance_address);
-    data.copy_to(memory->data().bytes().slice(instance_address, data.size()));
+    __builtin_memcpy(memory->data().data() + instance_address, data.data(), data.size());
 }
 
 template<typename T>
@@ -329,21 +320,6 @@ MakeUnsigned<T> BytecodeInterpreter::checked_unsigned_truncate(V value)
     return true;
 }
 
-Vector<Value> BytecodeInterpreter::pop_values(Configuration& configuration, size_t count)
-{
-    Vector<Value> results;
-    results.resize(count);
-
-    for (size_t i = 0; i < count; ++i) {
-        auto top_of_stack = configuration.stack().pop();
-        if (auto value = top_of_stack.get_pointer<Value>())
-            results[i] = move(*value);
-        else
-            TRAP_IF_NOT_NORETURN(value);
-    }
-    return results;
-}
-
 void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPointer& ip, Instruction const& instruction)
 {
     dbgln_if(WASM_TRACE_DEBUG, "Executing instruction {} at ip {}", instruction_name(instruction.opcode()), ip.value());
@@ -462,15 +438,8 @@ void BytecodeInterpreter::interpret(Configuration& configuration, InstructionPoi
     case Instructions::return_.value(): {
         auto& frame = configuration.frame();
         size_t end = configuration.stack().size() - frame.arity();
-        size_t start = end;
-        for (; start + 1 > 0 && start < configuration.stack().size(); --start) {
-            auto& entry = configuration.stack().entries()[start];
-            if (entry.has<Frame>()) {
-                // Leave the frame, _and_ its label.
-                start += 2;
-                break;
-            }
-        }
+        // Leave the label of the frame.
+        size_t start = frame.label_index() + 1;
 
         configuration.stack().entries().remove(start, end - start);
 
@@ -25,12 +25,13 @@ Optional<size_t> Configuration::nth_label_index(size_t i)
 
 void Configuration::unwind(Badge<CallFrameHandle>, CallFrameHandle const& frame_handle)
 {
-    if (m_stack.size() == frame_handle.stack_size && frame_handle.frame_index == m_current_frame_index)
+    if (m_stack.size() == frame_handle.stack_size && m_frames.size() == frame_handle.frame_count)
         return;
 
-    VERIFY(m_stack.size() > frame_handle.stack_size);
-    m_stack.entries().remove(frame_handle.stack_size, m_stack.size() - frame_handle.stack_size);
-    m_current_frame_index = frame_handle.frame_index;
+    VERIFY(m_stack.size() >= frame_handle.stack_size);
+    VERIFY(m_frames.size() >= frame_handle.frame_count);
+    m_stack.entries().shrink(frame_handle.stack_size, true);
+    m_frames.shrink(frame_handle.frame_count, true);
     m_depth--;
     m_ip = frame_handle.ip;
     VERIFY(m_stack.size() == frame_handle.stack_size);
@@ -68,7 +69,7 @@ Result Configuration::execute(Interpreter& interpreter)
     if (interpreter.did_trap())
         return Trap { interpreter.trap_reason() };
 
-    if (stack().size() <= frame().arity() + 1)
+    if (stack().size() <= frame().label_index() + frame().arity())
         return Trap { "Not enough values to return from call" };
 
     Vector<Value> results;
@@ -91,17 +92,19 @@ void Configuration::dump_stack()
         ByteBuffer buffer = memory_stream.copy_into_contiguous_buffer();
         dbgln(format.view(), StringView(buffer).trim_whitespace());
     };
-    for (auto const& entry : stack().entries()) {
-        entry.visit(
+    size_t frame_index = 0;
+    for (size_t i = 0; i < stack().size(); ++i) {
+        for (; frame_index < m_frames.size() && m_frames[frame_index].label_index() == i; ++frame_index) {
+            auto& frame = m_frames[frame_index];
+            dbgln("    frame({})", frame.arity());
+            for (auto& local : frame.locals()) {
+                print_value("        {}", local);
+            }
+        }
+        stack().entries()[i].visit(
             [&](Value const& v) {
                 print_value("    {}", v);
             },
-            [&](Frame const& f) {
-                dbgln("    frame({})", f.arity());
-                for (auto& local : f.locals()) {
-                    print_value("        {}", local);
-                }
-            },
             [](Label const& l) {
                 dbgln("    label({}) -> {}", l.arity(), l.continuation());
             });
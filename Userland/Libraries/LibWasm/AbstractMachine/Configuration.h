@@ -27,13 +27,13 @@ public:
     Optional<size_t> nth_label_index(size_t);
     void set_frame(Frame&& frame)
     {
-        m_current_frame_index = m_stack.size();
+        frame.set_label_index({}, m_stack.size());
         Label label(frame.arity(), frame.expression().instructions().size());
-        m_stack.push(move(frame));
+        m_frames.append(move(frame));
         m_stack.push(label);
     }
-    ALWAYS_INLINE auto& frame() const { return m_stack.entries()[m_current_frame_index].get<Frame>(); }
-    ALWAYS_INLINE auto& frame() { return m_stack.entries()[m_current_frame_index].get<Frame>(); }
+    ALWAYS_INLINE auto& frame() const { return m_frames.last(); }
+    ALWAYS_INLINE auto& frame() { return m_frames.last(); }
     ALWAYS_INLINE auto& ip() const { return m_ip; }
     ALWAYS_INLINE auto& ip() { return m_ip; }
     ALWAYS_INLINE auto& depth() const { return m_depth; }
@@ -45,7 +45,7 @@ public:
 
     struct CallFrameHandle {
         explicit CallFrameHandle(Configuration& configuration)
-            : frame_index(configuration.m_current_frame_index)
+            : frame_count(configuration.m_frames.size())
             , stack_size(configuration.m_stack.size())
             , ip(configuration.ip())
             , configuration(configuration)
@@ -58,7 +58,7 @@ public:
             configuration.unwind({}, *this);
         }
 
-        size_t frame_index { 0 };
+        size_t frame_count { 0 };
         size_t stack_size { 0 };
         InstructionPointer ip { 0 };
         Configuration& configuration;
@@ -75,7 +75,7 @@ public:
 
 private:
     Store& m_store;
-    size_t m_current_frame_index { 0 };
+    Vector<Frame, 32> m_frames;
     Stack m_stack;
     size_t m_depth { 0 };
     InstructionPointer m_ip;
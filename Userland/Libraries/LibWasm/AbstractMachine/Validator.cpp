@@ -8,11 +8,15 @@
 #include <AK/Result.h>
 #include <AK/SourceLocation.h>
 #include <AK/Try.h>
+#include <LibThreading/Parallel.h>
 #include <LibWasm/AbstractMachine/Validator.h>
 #include <LibWasm/Printer/Printer.h>
 
 namespace Wasm {
 
+// Most function bodies are small, so hand them out in batches to make up for the cost of a task.
+static constexpr size_t minimum_functions_per_validation_task = 8;
+
 ErrorOr<void, ValidationError> Validator::validate(Module& module)
 {
     ErrorOr<void, ValidationError> result {};
@@ -248,25 +252,40 @@ ErrorOr<void, ValidationError> Validator::validate(TableSection const& section)
 
 ErrorOr<void, ValidationError> Validator::validate(CodeSection const& section)
 {
-    size_t index = m_context.imported_function_count;
-    for (auto& entry : section.functions()) {
-        auto function_index = index++;
-        TRY(validate(FunctionIndex { function_index }));
-        auto& function_type = m_context.functions[function_index];
-        auto& function = entry.func();
-
-        auto function_validator = fork();
-        function_validator.m_context.locals = {};
-        function_validator.m_context.locals.extend(function_type.parameters());
-        for (auto& local : function.locals()) {
-            for (size_t i = 0; i < local.n(); ++i)
-                function_validator.m_context.locals.append(local.type());
-        }
+    auto& functions = section.functions();
+    for (size_t i = 0; i < functions.size(); ++i)
+        TRY(validate(FunctionIndex { m_context.imported_function_count + i }));
+
+    // Function bodies only read the module context, so they can be validated independently of each other.
+    // Every body records its own error, so that the one reported is the first in the section regardless of scheduling.
+    Vector<Optional<ValidationError>> errors;
+    errors.resize(functions.size());
+
+    Threading::parallel_for(
+        0, functions.size(), [&](size_t i) {
+            auto& function_type = m_context.functions[m_context.imported_function_count + i];
+            auto& function = functions[i].func();
+
+            auto function_validator = fork();
+            function_validator.m_context.locals = {};
+            function_validator.m_context.locals.extend(function_type.parameters());
+            for (auto& local : function.locals()) {
+                for (size_t j = 0; j < local.n(); ++j)
+                    function_validator.m_context.locals.append(local.type());
+            }
+
+            function_validator.m_context.labels = { ResultType { function_type.results() } };
+            function_validator.m_context.return_ = ResultType { function_type.results() };
 
-        function_validator.m_context.labels = { ResultType { function_type.results() } };
-        function_validator.m_context.return_ = ResultType { function_type.results() };
+            auto result = function_validator.validate(function.body(), function_type.results());
+            if (result.is_error())
+                errors[i] = result.release_error();
+        },
+        minimum_functions_per_validation_task);
 
-        TRY(function_validator.validate(function.body(), function_type.results()));
+    for (auto& error : errors) {
+        if (error.has_value())
+            return error.release_value();
     }
 
     return {};
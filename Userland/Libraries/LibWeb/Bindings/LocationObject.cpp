@@ -26,6 +26,7 @@ LocationObject::LocationObject(JS::GlobalObject& global_object)
     : Object(*global_object.object_prototype())
     , m_default_properties(heap())
 {
+    set_may_interfere_with_property_lookup_caching();
 }
 
 void LocationObject::initialize(JS::GlobalObject& global_object)
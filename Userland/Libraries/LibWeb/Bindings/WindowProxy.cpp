@@ -26,6 +26,7 @@ WindowProxy::WindowProxy(JS::GlobalObject& global_object, WindowObject& window)
     : JS::Object(global_object, nullptr)
     , m_window(&window)
 {
+    set_may_interfere_with_property_lookup_caching();
 }
 
 // 7.4.1 [[GetPrototypeOf]] ( ), https://html.spec.whatwg.org/multipage/window-object.html#windowproxy-getprototypeof
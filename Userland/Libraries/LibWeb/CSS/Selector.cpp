@@ -23,12 +23,103 @@ Selector::Selector(Vector<CompoundSelector>&& compound_selectors)
             }
         }
     }
+
+    collect_ancestor_hashes();
+    m_can_depend_on_siblings_or_state = compute_can_depend_on_siblings_or_state();
 }
 
 Selector::~Selector()
 {
 }
 
+void Selector::collect_ancestor_hashes()
+{
+    if (m_compound_selectors.is_empty())
+        return;
+
+    size_t next_hash_index = 0;
+    auto append_hash = [&](u32 hash) {
+        // NOTE: 0 marks the unused entries.
+        if (hash == 0)
+            return;
+        for (size_t i = 0; i < next_hash_index; ++i) {
+            if (m_ancestor_hashes[i] == hash)
+                return;
+        }
+        m_ancestor_hashes[next_hash_index++] = hash;
+    };
+
+    // Only compound selectors to the left of a child or descendant combinator have to match an ancestor of the element.
+    // We go from right to left, since the nearest ancestors are the ones most likely to tell selectors apart.
+    for (size_t i = m_compound_selectors.size() - 1; i > 0; --i) {
+        auto combinator = m_compound_selectors[i].combinator;
+        if (combinator != Combinator::Descendant && combinator != Combinator::ImmediateChild)
+            continue;
+        for (auto const& simple_selector : m_compound_selectors[i - 1].simple_selectors) {
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::Id:
+            case SimpleSelector::Type::Class:
+            case SimpleSelector::Type::TagName:
+                append_hash(ancestor_hash(simple_selector.type, simple_selector.value.hash()));
+                break;
+            default:
+                break;
+            }
+            if (next_hash_index == max_ancestor_hash_count)
+                return;
+        }
+    }
+}
+
+bool Selector::compute_can_depend_on_siblings_or_state() const
+{
+    // NOTE: Once a child or descendant combinator moves us on to the ancestors, nothing can tell two siblings apart anymore.
+    for (size_t i = m_compound_selectors.size(); i-- > 0;) {
+        for (auto const& simple_selector : m_compound_selectors[i].simple_selectors) {
+            if (simple_selector.type != SimpleSelector::Type::PseudoClass)
+                continue;
+            switch (simple_selector.pseudo_class.type) {
+            case SimpleSelector::PseudoClass::Type::Hover:
+            case SimpleSelector::PseudoClass::Type::Focus:
+            case SimpleSelector::PseudoClass::Type::Active:
+            case SimpleSelector::PseudoClass::Type::Checked:
+            case SimpleSelector::PseudoClass::Type::Empty:
+            case SimpleSelector::PseudoClass::Type::FirstChild:
+            case SimpleSelector::PseudoClass::Type::LastChild:
+            case SimpleSelector::PseudoClass::Type::OnlyChild:
+            case SimpleSelector::PseudoClass::Type::NthChild:
+            case SimpleSelector::PseudoClass::Type::NthLastChild:
+            case SimpleSelector::PseudoClass::Type::FirstOfType:
+            case SimpleSelector::PseudoClass::Type::LastOfType:
+            case SimpleSelector::PseudoClass::Type::OnlyOfType:
+            case SimpleSelector::PseudoClass::Type::NthOfType:
+            case SimpleSelector::PseudoClass::Type::NthLastOfType:
+                return true;
+            case SimpleSelector::PseudoClass::Type::Not:
+                for (auto const& not_selector : simple_selector.pseudo_class.not_selector) {
+                    if (not_selector.can_depend_on_siblings_or_state())
+                        return true;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        switch (m_compound_selectors[i].combinator) {
+        case Combinator::None:
+        case Combinator::ImmediateChild:
+        case Combinator::Descendant:
+            return false;
+        case Combinator::NextSibling:
+        case Combinator::SubsequentSibling:
+        case Combinator::Column:
+            return true;
+        }
+    }
+    return false;
+}
+
 // https://www.w3.org/TR/selectors-4/#specificity-rules
 u32 Selector::specificity() const
 {
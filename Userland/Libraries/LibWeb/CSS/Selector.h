@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/FlyString.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/RefCounted.h>
@@ -139,12 +140,41 @@ public:
     u32 specificity() const;
     String serialize() const;
 
+    // Whether matching this selector can depend on more than an element's tag name, attributes and ancestors,
+    // like its position among its siblings or whether it's hovered. Siblings that look alike can't share a style then.
+    bool can_depend_on_siblings_or_state() const { return m_can_depend_on_siblings_or_state; }
+
+    // The hashes of ids, classes and tag names that an element's ancestors need to have for this selector to match it,
+    // as used by StyleComputer's ancestor filter. Unused entries are 0.
+    static constexpr size_t max_ancestor_hash_count = 8;
+    Array<u32, max_ancestor_hash_count> const& ancestor_hashes() const { return m_ancestor_hashes; }
+
+    // NOTE: Each kind of name is salted differently, so that e.g. `#foo` and `.foo` don't end up with the same hash.
+    static constexpr u32 ancestor_hash(SimpleSelector::Type type, u32 name_hash)
+    {
+        switch (type) {
+        case SimpleSelector::Type::Id:
+            return name_hash * 3 + 0x9e3779b9;
+        case SimpleSelector::Type::Class:
+            return name_hash * 5 + 0x7f4a7c15;
+        case SimpleSelector::Type::TagName:
+            return name_hash * 7 + 0x3c6ef372;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }
+
 private:
     explicit Selector(Vector<CompoundSelector>&&);
 
+    void collect_ancestor_hashes();
+    bool compute_can_depend_on_siblings_or_state() const;
+
     Vector<CompoundSelector> m_compound_selectors;
     mutable Optional<u32> m_specificity;
     Optional<Selector::PseudoElement> m_pseudo_element;
+    Array<u32, max_ancestor_hash_count> m_ancestor_hashes {};
+    bool m_can_depend_on_siblings_or_state { false };
 };
 
 constexpr StringView pseudo_element_name(Selector::PseudoElement pseudo_element)
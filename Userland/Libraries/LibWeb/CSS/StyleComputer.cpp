@@ -55,6 +55,12 @@ static StyleSheet& quirks_mode_stylesheet()
     return *sheet;
 }
 
+void StyleComputer::load_user_agent_style_sheets()
+{
+    (void)default_stylesheet();
+    (void)quirks_mode_stylesheet();
+}
+
 template<typename Callback>
 void StyleComputer::for_each_stylesheet(CascadeOrigin cascade_origin, Callback callback) const
 {
@@ -70,58 +76,109 @@ void StyleComputer::for_each_stylesheet(CascadeOrigin cascade_origin, Callback c
     }
 }
 
+StyleComputer::RuleCache const& StyleComputer::rule_cache_for_cascade_origin(CascadeOrigin cascade_origin) const
+{
+    switch (cascade_origin) {
+    case CascadeOrigin::Author:
+        return *m_author_rule_cache;
+    case CascadeOrigin::UserAgent:
+        return *m_user_agent_rule_cache;
+    default:
+        TODO();
+    }
+}
+
 Vector<MatchingRule> StyleComputer::collect_matching_rules(DOM::Element const& element, CascadeOrigin cascade_origin, Optional<CSS::Selector::PseudoElement> pseudo_element) const
 {
-    if (cascade_origin == CascadeOrigin::Author) {
-        Vector<MatchingRule> rules_to_run;
-        if (pseudo_element.has_value()) {
-            if (auto it = m_rule_cache->rules_by_pseudo_element.find(pseudo_element.value()); it != m_rule_cache->rules_by_pseudo_element.end())
-                rules_to_run.extend(it->value);
-        } else {
-            for (auto const& class_name : element.class_names()) {
-                if (auto it = m_rule_cache->rules_by_class.find(class_name); it != m_rule_cache->rules_by_class.end())
-                    rules_to_run.extend(it->value);
-            }
-            if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_null()) {
-                if (auto it = m_rule_cache->rules_by_id.find(id); it != m_rule_cache->rules_by_id.end())
-                    rules_to_run.extend(it->value);
-            }
-            if (auto it = m_rule_cache->rules_by_tag_name.find(element.local_name()); it != m_rule_cache->rules_by_tag_name.end())
-                rules_to_run.extend(it->value);
-            rules_to_run.extend(m_rule_cache->other_rules);
-        }
+    // NOTE: There are no style sheets for the other cascade origins yet.
+    if (cascade_origin != CascadeOrigin::Author && cascade_origin != CascadeOrigin::UserAgent)
+        return {};
+
+    auto const& rule_cache = rule_cache_for_cascade_origin(cascade_origin);
 
-        Vector<MatchingRule> matching_rules;
-        matching_rules.ensure_capacity(rules_to_run.size());
-        for (auto const& rule_to_run : rules_to_run) {
-            auto const& selector = rule_to_run.rule->selectors()[rule_to_run.selector_index];
-            if (SelectorEngine::matches(selector, element, pseudo_element))
-                matching_rules.append(rule_to_run);
+    // Only the rules whose rightmost compound selector could apply to the element are worth running the selector engine for.
+    Vector<MatchingRule const&, 512> rules_to_run;
+    auto add_rules_to_run = [&](Vector<MatchingRule> const& rules) {
+        rules_to_run.ensure_capacity(rules_to_run.size() + rules.size());
+        for (auto const& rule : rules)
+            rules_to_run.unchecked_append(rule);
+    };
+
+    if (pseudo_element.has_value()) {
+        if (auto it = rule_cache.rules_by_pseudo_element.find(pseudo_element.value()); it != rule_cache.rules_by_pseudo_element.end())
+            add_rules_to_run(it->value);
+    } else {
+        for (auto const& class_name : element.class_names()) {
+            if (auto it = rule_cache.rules_by_class.find(class_name); it != rule_cache.rules_by_class.end())
+                add_rules_to_run(it->value);
         }
-        return matching_rules;
+        if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_null()) {
+            if (auto it = rule_cache.rules_by_id.find(id); it != rule_cache.rules_by_id.end())
+                add_rules_to_run(it->value);
+        }
+        if (auto it = rule_cache.rules_by_tag_name.find(element.local_name()); it != rule_cache.rules_by_tag_name.end())
+            add_rules_to_run(it->value);
+        add_rules_to_run(rule_cache.other_rules);
     }
 
-    Vector<MatchingRule> matching_rules;
-    size_t style_sheet_index = 0;
-    for_each_stylesheet(cascade_origin, [&](auto& sheet) {
-        size_t rule_index = 0;
-        static_cast<CSSStyleSheet const&>(sheet).for_each_effective_style_rule([&](auto const& rule) {
-            size_t selector_index = 0;
-            for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element, pseudo_element)) {
-                    matching_rules.append({ rule, style_sheet_index, rule_index, selector_index, selector.specificity() });
-                    break;
-                }
-                ++selector_index;
-            }
-            ++rule_index;
-        });
-        ++style_sheet_index;
-    });
+    bool use_ancestor_filter = can_use_ancestor_filter(element);
 
+    Vector<MatchingRule> matching_rules;
+    for (auto const& rule_to_run : rules_to_run) {
+        auto const& selector = rule_to_run.rule->selectors()[rule_to_run.selector_index];
+        if (use_ancestor_filter && should_reject_with_ancestor_filter(selector))
+            continue;
+        if (SelectorEngine::matches(selector, element, pseudo_element))
+            matching_rules.append(rule_to_run);
+    }
     return matching_rules;
 }
 
+template<typename Callback>
+static void for_each_ancestor_hash(DOM::Element const& element, Callback callback)
+{
+    callback(Selector::ancestor_hash(Selector::SimpleSelector::Type::TagName, element.local_name().hash()));
+    for (auto const& class_name : element.class_names())
+        callback(Selector::ancestor_hash(Selector::SimpleSelector::Type::Class, class_name.hash()));
+    if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_null())
+        callback(Selector::ancestor_hash(Selector::SimpleSelector::Type::Id, id.hash()));
+}
+
+void StyleComputer::push_ancestor(DOM::Node const& node)
+{
+    m_ancestor_stack.append(&node);
+    if (is<DOM::Element>(node))
+        for_each_ancestor_hash(static_cast<DOM::Element const&>(node), [&](u32 hash) { m_ancestor_filter.increment(hash); });
+}
+
+void StyleComputer::pop_ancestor(DOM::Node const& node)
+{
+    VERIFY(!m_ancestor_stack.is_empty() && m_ancestor_stack.last() == &node);
+    m_ancestor_stack.take_last();
+    if (is<DOM::Element>(node))
+        for_each_ancestor_hash(static_cast<DOM::Element const&>(node), [&](u32 hash) { m_ancestor_filter.decrement(hash); });
+}
+
+bool StyleComputer::can_use_ancestor_filter(DOM::Element const& element) const
+{
+    // NOTE: The filter only knows about all of an element's ancestors while the style update walk is visiting its children.
+    //       Style computed from anywhere else has to do without it.
+    if (m_ancestor_stack.is_empty() || m_ancestor_stack.first() != &m_document)
+        return false;
+    return element.parent() == m_ancestor_stack.last();
+}
+
+bool StyleComputer::should_reject_with_ancestor_filter(Selector const& selector) const
+{
+    for (u32 hash : selector.ancestor_hashes()) {
+        if (hash == 0)
+            break;
+        if (!m_ancestor_filter.may_contain(hash))
+            return true;
+    }
+    return false;
+}
+
 static void sort_matching_rules(Vector<MatchingRule>& matching_rules)
 {
     quick_sort(matching_rules, [&](MatchingRule& a, MatchingRule& b) {
@@ -1016,10 +1073,71 @@ NonnullRefPtr<StyleProperties> StyleComputer::create_document_style() const
     return style;
 }
 
+bool StyleComputer::rules_can_depend_on_siblings_or_state(DOM::Element const& element) const
+{
+    for (auto const* rule_cache : { m_user_agent_rule_cache.ptr(), m_author_rule_cache.ptr() }) {
+        if (rule_cache->other_rules_can_depend_on_siblings_or_state)
+            return true;
+        if (rule_cache->tag_names_with_sibling_or_state_dependent_rules.contains(element.local_name()))
+            return true;
+        for (auto const& class_name : element.class_names()) {
+            if (rule_cache->classes_with_sibling_or_state_dependent_rules.contains(class_name))
+                return true;
+        }
+        if (auto id = element.get_attribute(HTML::AttributeNames::id); !id.is_null() && rule_cache->ids_with_sibling_or_state_dependent_rules.contains(id))
+            return true;
+    }
+    return false;
+}
+
+static bool have_same_attributes(DOM::Element const& a, DOM::Element const& b)
+{
+    if (a.attribute_list_size() != b.attribute_list_size())
+        return false;
+    for (size_t i = 0; i < a.attribute_list_size(); ++i) {
+        auto const* attribute = a.attributes()->item(i);
+        auto other_value = b.get_attribute(attribute->name());
+        if (other_value.is_null() || other_value != attribute->value())
+            return false;
+    }
+    return true;
+}
+
+// Siblings that have the same tag name and attributes are matched by the same rules, and since they also inherit from the same parent,
+// they end up with the same style unless one of those rules looks at something that's different between them (see Selector::can_depend_on_siblings_or_state()).
+// Lists and tables are full of such siblings, so we look a few siblings back for one whose style we can just use as well.
+RefPtr<StyleProperties> StyleComputer::find_shareable_style(DOM::Element& element) const
+{
+    static constexpr size_t max_style_sharing_candidates = 8;
+
+    // NOTE: Inline style that was set through CSSOM doesn't show up in the attributes.
+    if (element.inline_style())
+        return {};
+    if (rules_can_depend_on_siblings_or_state(element))
+        return {};
+
+    size_t candidate_count = 0;
+    for (auto* sibling = element.previous_element_sibling(); sibling && candidate_count < max_style_sharing_candidates; sibling = sibling->previous_element_sibling(), ++candidate_count) {
+        if (sibling->needs_style_update() || !sibling->computed_css_values() || sibling->inline_style())
+            continue;
+        if (sibling->local_name() != element.local_name() || sibling->namespace_() != element.namespace_())
+            continue;
+        if (!have_same_attributes(*sibling, element))
+            continue;
+        return sibling->computed_css_values();
+    }
+    return {};
+}
+
 NonnullRefPtr<StyleProperties> StyleComputer::compute_style(DOM::Element& element, Optional<CSS::Selector::PseudoElement> pseudo_element) const
 {
     build_rule_cache_if_needed();
 
+    if (!pseudo_element.has_value()) {
+        if (auto shared_style = find_shareable_style(element))
+            return shared_style.release_nonnull();
+    }
+
     auto style = StyleProperties::create();
     // 1. Perform the cascade. This produces the "specified style"
     compute_cascaded_values(style, element, pseudo_element);
@@ -1071,35 +1189,33 @@ bool PropertyDependencyNode::has_cycles()
 
 void StyleComputer::build_rule_cache_if_needed() const
 {
-    if (m_rule_cache)
+    if (m_author_rule_cache && m_user_agent_rule_cache)
         return;
     const_cast<StyleComputer&>(*this).build_rule_cache();
 }
 
-void StyleComputer::build_rule_cache()
+NonnullOwnPtr<StyleComputer::RuleCache> StyleComputer::make_rule_cache_for_cascade_origin(CascadeOrigin cascade_origin)
 {
-    // FIXME: Make a rule cache for UA style as well.
-
-    m_rule_cache = make<RuleCache>();
+    auto rule_cache = make<RuleCache>();
 
     size_t num_class_rules = 0;
     size_t num_id_rules = 0;
     size_t num_tag_name_rules = 0;
     size_t num_pseudo_element_rules = 0;
 
-    Vector<MatchingRule> matching_rules;
     size_t style_sheet_index = 0;
-    for_each_stylesheet(CascadeOrigin::Author, [&](auto& sheet) {
+    for_each_stylesheet(cascade_origin, [&](auto& sheet) {
         size_t rule_index = 0;
         static_cast<CSSStyleSheet const&>(sheet).for_each_effective_style_rule([&](auto const& rule) {
             size_t selector_index = 0;
             for (CSS::Selector const& selector : rule.selectors()) {
                 MatchingRule matching_rule { rule, style_sheet_index, rule_index, selector_index, selector.specificity() };
+                collect_invalidation_scopes(rule_cache->invalidation_scopes, selector);
 
                 bool added_to_bucket = false;
                 for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
                     if (simple_selector.type == CSS::Selector::SimpleSelector::Type::PseudoElement) {
-                        m_rule_cache->rules_by_pseudo_element.ensure(simple_selector.pseudo_element).append(move(matching_rule));
+                        rule_cache->rules_by_pseudo_element.ensure(simple_selector.pseudo_element).append(move(matching_rule));
                         ++num_pseudo_element_rules;
                         added_to_bucket = true;
                         break;
@@ -1108,27 +1224,36 @@ void StyleComputer::build_rule_cache()
                 if (!added_to_bucket) {
                     for (auto const& simple_selector : selector.compound_selectors().last().simple_selectors) {
                         if (simple_selector.type == CSS::Selector::SimpleSelector::Type::Id) {
-                            m_rule_cache->rules_by_id.ensure(simple_selector.value).append(move(matching_rule));
+                            rule_cache->rules_by_id.ensure(simple_selector.value).append(move(matching_rule));
+                            if (selector.can_depend_on_siblings_or_state())
+                                rule_cache->ids_with_sibling_or_state_dependent_rules.set(simple_selector.value);
                             ++num_id_rules;
                             added_to_bucket = true;
                             break;
                         }
                         if (simple_selector.type == CSS::Selector::SimpleSelector::Type::Class) {
-                            m_rule_cache->rules_by_class.ensure(simple_selector.value).append(move(matching_rule));
+                            rule_cache->rules_by_class.ensure(simple_selector.value).append(move(matching_rule));
+                            if (selector.can_depend_on_siblings_or_state())
+                                rule_cache->classes_with_sibling_or_state_dependent_rules.set(simple_selector.value);
                             ++num_class_rules;
                             added_to_bucket = true;
                             break;
                         }
                         if (simple_selector.type == CSS::Selector::SimpleSelector::Type::TagName) {
-                            m_rule_cache->rules_by_tag_name.ensure(simple_selector.value).append(move(matching_rule));
+                            rule_cache->rules_by_tag_name.ensure(simple_selector.value).append(move(matching_rule));
+                            if (selector.can_depend_on_siblings_or_state())
+                                rule_cache->tag_names_with_sibling_or_state_dependent_rules.set(simple_selector.value);
                             ++num_tag_name_rules;
                             added_to_bucket = true;
                             break;
                         }
                     }
                 }
-                if (!added_to_bucket)
-                    m_rule_cache->other_rules.append(move(matching_rule));
+                if (!added_to_bucket) {
+                    if (selector.can_depend_on_siblings_or_state())
+                        rule_cache->other_rules_can_depend_on_siblings_or_state = true;
+                    rule_cache->other_rules.append(move(matching_rule));
+                }
 
                 ++selector_index;
             }
@@ -1143,14 +1268,124 @@ void StyleComputer::build_rule_cache()
         dbgln("        Class: {}", num_class_rules);
         dbgln("      TagName: {}", num_tag_name_rules);
         dbgln("PseudoElement: {}", num_pseudo_element_rules);
-        dbgln("        Other: {}", m_rule_cache->other_rules.size());
-        dbgln("        Total: {}", num_class_rules + num_id_rules + num_tag_name_rules + m_rule_cache->other_rules.size());
+        dbgln("        Other: {}", rule_cache->other_rules.size());
+        dbgln("        Total: {}", num_class_rules + num_id_rules + num_tag_name_rules + rule_cache->other_rules.size());
+    }
+    return rule_cache;
+}
+
+void StyleComputer::collect_invalidation_scopes(InvalidationScopes& scopes, Selector const& selector, StyleInvalidationScope enclosing_scope)
+{
+    // The rightmost compound selector is matched against the element itself, and every combinator to its left
+    // moves on to an ancestor or a previous sibling, whose changes then affect the elements after it.
+    auto scope = StyleInvalidationScope::Element;
+    auto const& compound_selectors = selector.compound_selectors();
+    for (size_t i = compound_selectors.size(); i-- > 0;) {
+        auto compound_scope = scope | enclosing_scope;
+        for (auto const& simple_selector : compound_selectors[i].simple_selectors) {
+            switch (simple_selector.type) {
+            case Selector::SimpleSelector::Type::Id:
+                scopes.by_id.ensure(simple_selector.value) |= compound_scope;
+                break;
+            case Selector::SimpleSelector::Type::Class:
+                scopes.by_class.ensure(simple_selector.value) |= compound_scope;
+                break;
+            case Selector::SimpleSelector::Type::Attribute:
+                scopes.by_attribute_name.ensure(simple_selector.attribute.name.to_lowercase()) |= compound_scope;
+                break;
+            case Selector::SimpleSelector::Type::PseudoClass:
+                switch (simple_selector.pseudo_class.type) {
+                case Selector::SimpleSelector::PseudoClass::Type::Link:
+                case Selector::SimpleSelector::PseudoClass::Type::Visited:
+                    // NOTE: Everything inside a link with an href is a link too.
+                    scopes.by_attribute_name.ensure(HTML::AttributeNames::href) |= compound_scope | StyleInvalidationScope::Descendants;
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Disabled:
+                case Selector::SimpleSelector::PseudoClass::Type::Enabled:
+                    scopes.by_attribute_name.ensure(HTML::AttributeNames::disabled) |= compound_scope;
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Checked:
+                    scopes.by_attribute_name.ensure(HTML::AttributeNames::checked) |= compound_scope;
+                    break;
+                case Selector::SimpleSelector::PseudoClass::Type::Not:
+                    for (auto const& not_selector : simple_selector.pseudo_class.not_selector)
+                        collect_invalidation_scopes(scopes, not_selector, compound_scope);
+                    break;
+                default:
+                    break;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        switch (compound_selectors[i].combinator) {
+        case Selector::Combinator::None:
+            break;
+        case Selector::Combinator::ImmediateChild:
+        case Selector::Combinator::Descendant:
+            scope |= StyleInvalidationScope::Descendants;
+            break;
+        case Selector::Combinator::NextSibling:
+        case Selector::Combinator::SubsequentSibling:
+            scope |= StyleInvalidationScope::FollowingSiblings;
+            break;
+        case Selector::Combinator::Column:
+            scope |= StyleInvalidationScope::Descendants | StyleInvalidationScope::FollowingSiblings;
+            break;
+        }
     }
 }
 
+template<typename GetScopes>
+StyleInvalidationScope StyleComputer::invalidation_scope_in_rule_caches(FlyString const& name, GetScopes get_scopes) const
+{
+    build_rule_cache_if_needed();
+    auto scope = StyleInvalidationScope::None;
+    for (auto const* rule_cache : { m_user_agent_rule_cache.ptr(), m_author_rule_cache.ptr() })
+        scope |= get_scopes(rule_cache->invalidation_scopes).get(name).value_or(StyleInvalidationScope::None);
+    return scope;
+}
+
+bool StyleComputer::has_rules_for_generated_content() const
+{
+    build_rule_cache_if_needed();
+    for (auto const* rule_cache : { m_user_agent_rule_cache.ptr(), m_author_rule_cache.ptr() }) {
+        if (rule_cache->rules_by_pseudo_element.contains(Selector::PseudoElement::Before) || rule_cache->rules_by_pseudo_element.contains(Selector::PseudoElement::After))
+            return true;
+    }
+    return false;
+}
+
+StyleInvalidationScope StyleComputer::invalidation_scope_for_id(FlyString const& id) const
+{
+    return invalidation_scope_in_rule_caches(id, [](auto& scopes) -> auto& { return scopes.by_id; });
+}
+
+StyleInvalidationScope StyleComputer::invalidation_scope_for_class(FlyString const& class_name) const
+{
+    return invalidation_scope_in_rule_caches(class_name, [](auto& scopes) -> auto& { return scopes.by_class; });
+}
+
+StyleInvalidationScope StyleComputer::invalidation_scope_for_attribute(FlyString const& attribute_name) const
+{
+    return invalidation_scope_in_rule_caches(attribute_name.to_lowercase(), [](auto& scopes) -> auto& { return scopes.by_attribute_name; });
+}
+
+void StyleComputer::build_rule_cache()
+{
+    m_author_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::Author);
+    m_user_agent_rule_cache = make_rule_cache_for_cascade_origin(CascadeOrigin::UserAgent);
+}
+
 void StyleComputer::invalidate_rule_cache()
 {
-    m_rule_cache = nullptr;
+    m_author_rule_cache = nullptr;
+
+    // NOTE: It might not be necessary to throw away the UA rule cache.
+    //       If we are sure that it's safe, we could keep it as an optimization.
+    m_user_agent_rule_cache = nullptr;
 }
 
 }
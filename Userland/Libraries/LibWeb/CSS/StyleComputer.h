@@ -7,7 +7,10 @@
 
 #pragma once
 
+#include <AK/CountingBloomFilter.h>
+#include <AK/EnumBits.h>
 #include <AK/HashMap.h>
+#include <AK/HashTable.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
 #include <AK/OwnPtr.h>
@@ -27,6 +30,18 @@ struct MatchingRule {
     u32 specificity { 0 };
 };
 
+// The elements whose style can change when an element gains or loses an id, class or attribute that selectors look at.
+enum class StyleInvalidationScope : u8 {
+    None = 0,
+    Element = 1 << 0,
+    // The element's descendants.
+    Descendants = 1 << 1,
+    // The element's following siblings and their descendants.
+    FollowingSiblings = 1 << 2,
+};
+
+AK_ENUM_BITWISE_OPERATORS(StyleInvalidationScope);
+
 class PropertyDependencyNode : public RefCounted<PropertyDependencyNode> {
 public:
     static NonnullRefPtr<PropertyDependencyNode> create(String name)
@@ -50,6 +65,9 @@ public:
     explicit StyleComputer(DOM::Document&);
     ~StyleComputer();
 
+    // Parses the user agent style sheets ahead of time, e.g. so that processes forked afterwards all share them.
+    static void load_user_agent_style_sheets();
+
     DOM::Document& document() { return m_document; }
     DOM::Document const& document() const { return m_document; }
 
@@ -69,6 +87,18 @@ public:
 
     void invalidate_rule_cache();
 
+    // Whether any style sheet has rules for ::before or ::after.
+    bool has_rules_for_generated_content() const;
+
+    StyleInvalidationScope invalidation_scope_for_id(FlyString const&) const;
+    StyleInvalidationScope invalidation_scope_for_class(FlyString const&) const;
+    StyleInvalidationScope invalidation_scope_for_attribute(FlyString const& attribute_name) const;
+
+    // The style update walk tells us which nodes it descends into, so that selectors whose ancestors
+    // aren't there can be rejected without walking up the DOM for every element.
+    void push_ancestor(DOM::Node const&);
+    void pop_ancestor(DOM::Node const&);
+
     Gfx::Font const& initial_font() const;
 
 private:
@@ -96,16 +126,49 @@ private:
     void build_rule_cache();
     void build_rule_cache_if_needed() const;
 
+    RefPtr<StyleProperties> find_shareable_style(DOM::Element&) const;
+    bool rules_can_depend_on_siblings_or_state(DOM::Element const&) const;
+
+    bool can_use_ancestor_filter(DOM::Element const&) const;
+    bool should_reject_with_ancestor_filter(Selector const&) const;
+
     DOM::Document& m_document;
 
+    struct InvalidationScopes {
+        HashMap<FlyString, StyleInvalidationScope> by_id;
+        HashMap<FlyString, StyleInvalidationScope> by_class;
+        // NOTE: The attribute names are lowercased.
+        HashMap<FlyString, StyleInvalidationScope> by_attribute_name;
+    };
+
     struct RuleCache {
         HashMap<FlyString, Vector<MatchingRule>> rules_by_id;
         HashMap<FlyString, Vector<MatchingRule>> rules_by_class;
         HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
         HashMap<Selector::PseudoElement, Vector<MatchingRule>> rules_by_pseudo_element;
         Vector<MatchingRule> other_rules;
+        InvalidationScopes invalidation_scopes;
+
+        // The buckets holding rules that can match one of two otherwise identical siblings but not the other.
+        HashTable<FlyString> ids_with_sibling_or_state_dependent_rules;
+        HashTable<FlyString> classes_with_sibling_or_state_dependent_rules;
+        HashTable<FlyString> tag_names_with_sibling_or_state_dependent_rules;
+        bool other_rules_can_depend_on_siblings_or_state { false };
     };
-    OwnPtr<RuleCache> m_rule_cache;
+
+    static void collect_invalidation_scopes(InvalidationScopes&, Selector const&, StyleInvalidationScope enclosing_scope = StyleInvalidationScope::None);
+    template<typename GetScopes>
+    StyleInvalidationScope invalidation_scope_in_rule_caches(FlyString const&, GetScopes) const;
+
+    NonnullOwnPtr<RuleCache> make_rule_cache_for_cascade_origin(CascadeOrigin);
+    RuleCache const& rule_cache_for_cascade_origin(CascadeOrigin) const;
+
+    OwnPtr<RuleCache> m_author_rule_cache;
+    OwnPtr<RuleCache> m_user_agent_rule_cache;
+
+    // Holds the id, class and tag name hashes of every element in m_ancestor_stack.
+    CountingBloomFilter<u8> m_ancestor_filter;
+    Vector<DOM::Node const*> m_ancestor_stack;
 };
 
 }
@@ -438,6 +438,15 @@ String Document::title() const
     return builder.to_string();
 }
 
+void Document::set_quirks_mode(QuirksMode mode)
+{
+    if (m_quirks_mode == mode)
+        return;
+    m_quirks_mode = mode;
+    // The user agent style depends on whether we're in quirks mode.
+    style_computer().invalidate_rule_cache();
+}
+
 void Document::set_title(const String& title)
 {
     auto* head_element = const_cast<HTML::HTMLHeadElement*>(head());
@@ -582,6 +591,11 @@ void Document::update_layout()
     root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Default);
     formatting_state.commit();
 
+    m_layout_root->for_each_in_inclusive_subtree([](auto& layout_node) {
+        layout_node.clear_needs_layout();
+        return IterationDecision::Continue;
+    });
+
     m_layout_root->build_stacking_context_tree();
 
     browsing_context()->set_needs_display();
@@ -597,11 +611,18 @@ void Document::update_layout()
 
 static void update_style_recursively(DOM::Node& node)
 {
-    if (is<Element>(node))
+    if (is<Element>(node)) {
         static_cast<Element&>(node).recompute_style();
+    } else if (node.needs_style_update()) {
+        // NOTE: Text nodes ask for a style update when their data changes, which needs a new layout.
+        if (auto* layout_node = node.layout_node())
+            layout_node->set_needs_layout();
+    }
     node.set_needs_style_update(false);
 
     if (node.child_needs_style_update()) {
+        auto& style_computer = node.document().style_computer();
+        style_computer.push_ancestor(node);
         if (node.is_element()) {
             if (auto* shadow_root = static_cast<DOM::Element&>(node).shadow_root()) {
                 if (shadow_root->needs_style_update() || shadow_root->child_needs_style_update())
@@ -613,6 +634,7 @@ static void update_style_recursively(DOM::Node& node)
                 update_style_recursively(child);
             return IterationDecision::Continue;
         });
+        style_computer.pop_ancestor(node);
     }
 
     node.set_child_needs_style_update(false);
@@ -631,17 +653,21 @@ void Document::update_style()
 
 void Document::set_link_color(Color color)
 {
+    // NOTE: Links take their color from the document, so they all need a new style.
     m_link_color = color;
+    invalidate_style();
 }
 
 void Document::set_active_link_color(Color color)
 {
     m_active_link_color = color;
+    invalidate_style();
 }
 
 void Document::set_visited_link_color(Color color)
 {
     m_visited_link_color = color;
+    invalidate_style();
 }
 
 const Layout::InitialContainingBlock* Document::layout_node() const
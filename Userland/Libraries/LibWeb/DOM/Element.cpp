@@ -79,6 +79,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
 
     // 3. Let attribute be the first attribute in this’s attribute list whose qualified name is qualifiedName, and null otherwise.
     auto* attribute = m_attributes->get_attribute(name);
+    String old_value;
 
     // 4. If attribute is null, create an attribute whose local name is qualifiedName, value is value, and node document is this’s node document, then append this attribute to this, and then return.
     if (!attribute) {
@@ -90,13 +91,13 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
 
     // 5. Change attribute to value.
     else {
+        old_value = attribute->value();
         attribute->set_value(value);
     }
 
     parse_attribute(attribute->local_name(), value);
 
-    // FIXME: Invalidate less.
-    document().invalidate_style();
+    invalidate_style_after_attribute_change(attribute->local_name(), old_value, value);
 
     return {};
 }
@@ -162,12 +163,50 @@ ExceptionOr<void> Element::set_attribute_ns(FlyString const& namespace_, FlyStri
 // https://dom.spec.whatwg.org/#dom-element-removeattribute
 void Element::remove_attribute(const FlyString& name)
 {
+    auto old_value = get_attribute(name);
     m_attributes->remove_attribute(name);
 
     did_remove_attribute(name);
 
-    // FIXME: Invalidate less.
-    document().invalidate_style();
+    invalidate_style_after_attribute_change(name, old_value, {});
+}
+
+void Element::invalidate_style_after_attribute_change(FlyString const& attribute_name, String const& old_value, String const& new_value)
+{
+    if (old_value.is_null() == new_value.is_null() && old_value == new_value)
+        return;
+
+    // Presentational hints and inline style only apply to the element itself, so it always needs a new style.
+    set_needs_style_update(true);
+
+    // Anything else depends on which selectors look at the attribute.
+    auto const& style_computer = document().style_computer();
+    auto scope = style_computer.invalidation_scope_for_attribute(attribute_name);
+    if (attribute_name == HTML::AttributeNames::id) {
+        if (!old_value.is_null())
+            scope |= style_computer.invalidation_scope_for_id(old_value);
+        if (!new_value.is_null())
+            scope |= style_computer.invalidation_scope_for_id(new_value);
+    } else if (attribute_name == HTML::AttributeNames::class_) {
+        // Only the classes that were added or removed matter.
+        auto old_classes = old_value.split_view(is_ascii_space);
+        auto new_classes = new_value.split_view(is_ascii_space);
+        for (auto const& class_name : old_classes) {
+            if (!new_classes.contains_slow(class_name))
+                scope |= style_computer.invalidation_scope_for_class(class_name);
+        }
+        for (auto const& class_name : new_classes) {
+            if (!old_classes.contains_slow(class_name))
+                scope |= style_computer.invalidation_scope_for_class(class_name);
+        }
+    }
+
+    if (has_flag(scope, CSS::StyleInvalidationScope::Descendants))
+        invalidate_style();
+    if (has_flag(scope, CSS::StyleInvalidationScope::FollowingSiblings)) {
+        for (auto* sibling = next_sibling(); sibling; sibling = sibling->next_sibling())
+            sibling->invalidate_style();
+    }
 }
 
 // https://dom.spec.whatwg.org/#dom-element-hasattribute
@@ -273,14 +312,59 @@ void Element::recompute_style()
     VERIFY(parent());
     auto new_computed_css_values = document().style_computer().compute_style(*this);
 
-    if (m_computed_css_values && *m_computed_css_values == *new_computed_css_values)
+    if (m_computed_css_values && *m_computed_css_values == *new_computed_css_values) {
+        // NOTE: Elements also ask for a style update when something else about them changes, like an image that finished loading.
+        if (auto* layout_node = this->layout_node())
+            layout_node->set_needs_layout();
         return;
+    }
 
+    auto old_computed_css_values = move(m_computed_css_values);
     m_computed_css_values = move(new_computed_css_values);
 
+    // Our children inherit from us, so they need a new style as well.
+    auto mark_for_style_update = [](Node& child) {
+        child.set_needs_style_update(true);
+        return IterationDecision::Continue;
+    };
+    for_each_child(mark_for_style_update);
+    if (auto* shadow_root = this->shadow_root())
+        shadow_root->for_each_child(mark_for_style_update);
+
+    if (old_computed_css_values && can_keep_layout_tree_after_style_change(*old_computed_css_values)) {
+        if (auto* layout_node = this->layout_node())
+            layout_node->reapply_style(*m_computed_css_values);
+        return;
+    }
+
     document().invalidate_layout();
 }
 
+// Whether the layout tree that was built for the old style still has the right shape for the new one.
+bool Element::can_keep_layout_tree_after_style_change(CSS::StyleProperties const& old_style) const
+{
+    auto const& new_style = *m_computed_css_values;
+    auto old_display = old_style.display();
+    auto new_display = new_style.display();
+    if (old_display != new_display)
+        return false;
+    if (old_display.is_none())
+        return true;
+    if (!layout_node())
+        return false;
+
+    // These decide which kind of box gets created, and how boxes get wrapped and nested.
+    if (old_style.position() != new_style.position() || old_style.float_() != new_style.float_())
+        return false;
+
+    // NOTE: List item markers and pseudo-elements are generated from the style when building the layout tree.
+    if (old_display.is_list_item())
+        return false;
+    if (any_of(m_pseudo_element_nodes, [](auto const& pseudo_element_node) { return pseudo_element_node; }))
+        return false;
+    return !document().style_computer().has_rules_for_generated_content();
+}
+
 NonnullRefPtr<CSS::StyleProperties> Element::resolved_css_values()
 {
     auto element_computed_style = CSS::ResolvedCSSStyleDeclaration::create(*this);
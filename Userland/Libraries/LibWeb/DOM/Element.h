@@ -87,6 +87,9 @@ public:
     virtual void parse_attribute(const FlyString& name, const String& value);
     virtual void did_remove_attribute(FlyString const&) { }
 
+    // Marks the elements whose style can depend on this attribute as needing a style update.
+    void invalidate_style_after_attribute_change(FlyString const& attribute_name, String const& old_value, String const& new_value);
+
     void recompute_style();
 
     Layout::NodeWithStyle* layout_node() { return static_cast<Layout::NodeWithStyle*>(Node::layout_node()); }
@@ -94,6 +97,7 @@ public:
 
     String name() const { return attribute(HTML::AttributeNames::name); }
 
+    CSS::StyleProperties* computed_css_values() { return m_computed_css_values.ptr(); }
     CSS::StyleProperties const* computed_css_values() const { return m_computed_css_values.ptr(); }
     void set_computed_css_values(RefPtr<CSS::StyleProperties> style) { m_computed_css_values = move(style); }
     NonnullRefPtr<CSS::StyleProperties> resolved_css_values();
@@ -142,6 +146,7 @@ protected:
 
 private:
     void make_html_uppercased_qualified_name();
+    bool can_keep_layout_tree_after_style_change(CSS::StyleProperties const& old_style) const;
 
     QualifiedName m_qualified_name;
     String m_html_uppercased_qualified_name;
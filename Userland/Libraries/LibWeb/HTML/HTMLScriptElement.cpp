@@ -294,26 +294,15 @@ void HTMLScriptElement::prepare_script()
             //    Fetch a classic script given url, settings object, options, classic script CORS setting, and encoding.
             auto request = LoadRequest::create_for_url_on_page(url, document().page());
 
-            ResourceLoader::the().load(
-                request,
-                [this, url](auto data, auto&, auto) {
-                    if (data.is_null()) {
-                        dbgln("HTMLScriptElement: Failed to load {}", url);
-                        return;
-                    }
-
-                    // FIXME: This is all ad-hoc and needs work.
-                    auto script = ClassicScript::create(url.to_string(), data, document().relevant_settings_object(), AK::URL());
-
-                    // When the chosen algorithm asynchronously completes, set the script's script to the result. At that time, the script is ready.
-                    m_script = script;
-                    script_became_ready();
-                },
-                [this](auto&, auto) {
-                    m_failed_to_load = true;
-                    dbgln("HONK! Failed to load script, but ready nonetheless.");
-                    script_became_ready();
-                });
+            // NOTE: This goes through the resource cache, so that a load the preload scanner has already started gets picked up.
+            //       If the script has been loaded already, set_resource() calls resource_did_load() right away.
+            auto resource = ResourceLoader::the().load_resource(Resource::Type::Generic, request);
+            if (!resource) {
+                m_failed_to_load = true;
+                script_became_ready();
+            } else {
+                set_resource(resource);
+            }
         } else if (m_script_type == ScriptType::Module) {
             // FIXME: -> "module"
             //        Fetch an external module script graph given url, settings object, and options.
@@ -438,6 +427,25 @@ void HTMLScriptElement::prepare_script()
     }
 }
 
+void HTMLScriptElement::resource_did_load()
+{
+    VERIFY(resource());
+
+    // FIXME: This is all ad-hoc and needs work.
+    auto script = ClassicScript::create(resource()->url().to_string(), resource()->encoded_data().bytes(), document().relevant_settings_object(), AK::URL());
+
+    // When the chosen algorithm asynchronously completes, set the script's script to the result. At that time, the script is ready.
+    m_script = script;
+    script_became_ready();
+}
+
+void HTMLScriptElement::resource_did_fail()
+{
+    m_failed_to_load = true;
+    dbgln("HONK! Failed to load script, but ready nonetheless.");
+    script_became_ready();
+}
+
 void HTMLScriptElement::script_became_ready()
 {
     m_script_ready = true;
@@ -4,6 +4,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/CharacterTypes.h>
 #include <AK/StringView.h>
 #include <LibWeb/HTML/Parser/Entities.h>
 
@@ -12,7 +14,7 @@ namespace HTML {
 
 Optional<EntityMatch> code_points_from_entity(StringView entity)
 {
-    constexpr struct {
+    static constexpr struct {
         StringView entity;
         u32 code_point;
     } single_code_point_entities[] = {
@@ -2156,7 +2158,7 @@ Optional<EntityMatch> code_points_from_entity(StringView entity)
         { "zwnj;", 0x0200C }
     };
 
-    constexpr struct {
+    static constexpr struct {
         StringView entity;
         u32 code_point1;
         u32 code_point2;
@@ -2256,16 +2258,35 @@ Optional<EntityMatch> code_points_from_entity(StringView entity)
         { "vsupne;", 0x0228B, 0x0FE00 },
     };
 
+    // NOTE: Every entity starts with an ASCII letter, so only the few dozen that start with the same one as the input have to be compared.
+    struct EntityIndices {
+        Array<Vector<u16>, 128> single_code_point;
+        Array<Vector<u16>, 128> double_code_point;
+    };
+    static auto const indices_by_first_character = [] {
+        EntityIndices indices;
+        for (size_t i = 0; i < array_size(single_code_point_entities); ++i)
+            indices.single_code_point[single_code_point_entities[i].entity[0]].append(i);
+        for (size_t i = 0; i < array_size(double_code_point_entities); ++i)
+            indices.double_code_point[double_code_point_entities[i].entity[0]].append(i);
+        return indices;
+    }();
+
+    if (entity.is_empty() || !is_ascii(entity[0]))
+        return {};
+
     EntityMatch match;
 
-    for (auto& single_code_point_entity : single_code_point_entities) {
+    for (auto index : indices_by_first_character.single_code_point[entity[0]]) {
+        auto& single_code_point_entity = single_code_point_entities[index];
         if (entity.starts_with(single_code_point_entity.entity)) {
             if (match.entity.is_null() || single_code_point_entity.entity.length() > match.entity.length())
                 match = { { single_code_point_entity.code_point }, single_code_point_entity.entity };
         }
     }
 
-    for (auto& double_code_point_entity : double_code_point_entities) {
+    for (auto index : indices_by_first_character.double_code_point[entity[0]]) {
+        auto& double_code_point_entity = double_code_point_entities[index];
         if (entity.starts_with(double_code_point_entity.entity)) {
             if (match.entity.is_null() || double_code_point_entity.entity.length() > match.entity.length())
                 match = EntityMatch { { double_code_point_entity.code_point1, double_code_point_entity.code_point2 }, StringView(double_code_point_entity.entity) };
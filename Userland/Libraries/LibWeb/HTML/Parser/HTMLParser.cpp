@@ -2125,6 +2125,11 @@ void HTMLParser::handle_text(HTMLToken& token)
                 // that is blocking scripts and the script's "ready to be parser-executed"
                 // flag is set.
                 if (m_document->has_a_style_sheet_that_is_blocking_scripts() || !script->is_ready_to_be_parser_executed()) {
+                    // NOTE: While we wait, start loading whatever else the rest of the input is going to need.
+                    if (!m_preload_scanner)
+                        m_preload_scanner = make<HTMLPreloadScanner>(*m_document);
+                    m_preload_scanner->scan(m_tokenizer);
+
                     main_thread_event_loop().spin_until([&] {
                         return !m_document->has_a_style_sheet_that_is_blocking_scripts() && script->is_ready_to_be_parser_executed();
                     });
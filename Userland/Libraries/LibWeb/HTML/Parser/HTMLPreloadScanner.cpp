@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+#include <LibWeb/Loader/LoadRequest.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+
+namespace Web::HTML {
+
+HTMLPreloadScanner::HTMLPreloadScanner(DOM::Document& document)
+    : m_document(document)
+{
+}
+
+void HTMLPreloadScanner::scan(HTMLTokenizer const& parser_tokenizer)
+{
+    // NOTE: A scan always goes all the way to the end of the input, so there's only something new to find after document.write().
+    auto source = parser_tokenizer.source();
+    if (source.impl() == m_scanned_source.impl())
+        return;
+    m_scanned_source = source;
+
+    HTMLTokenizer tokenizer { parser_tokenizer.unconsumed_source(), "utf-8" };
+    for (;;) {
+        auto token = tokenizer.next_token();
+        if (!token.has_value() || token->is_end_of_file())
+            break;
+        if (!token->is_start_tag())
+            continue;
+
+        auto const& tag_name = token->tag_name();
+
+        // The tree builder would switch the tokenizer to these states, and their contents aren't markup.
+        if (tag_name == "script"sv)
+            tokenizer.switch_to(HTMLTokenizer::State::ScriptData);
+        else if (tag_name.is_one_of("style"sv, "xmp"sv, "iframe"sv, "noembed"sv, "noframes"sv, "noscript"sv))
+            tokenizer.switch_to(HTMLTokenizer::State::RAWTEXT);
+        else if (tag_name.is_one_of("textarea"sv, "title"sv))
+            tokenizer.switch_to(HTMLTokenizer::State::RCDATA);
+        else if (tag_name == "plaintext"sv)
+            break;
+
+        if (tag_name == "base"sv) {
+            auto href = token->attribute(AttributeNames::href);
+            if (!href.is_null() && !m_base_url.has_value())
+                m_base_url = m_document.parse_url(href);
+        } else if (tag_name == "script"sv) {
+            // FIXME: Preload module scripts too, once we can run them.
+            if (token->attribute(AttributeNames::type) != "module"sv)
+                preload(Resource::Type::Generic, token->attribute(AttributeNames::src));
+        } else if (tag_name == "link"sv) {
+            bool is_stylesheet = false;
+            bool is_alternate = false;
+            bool is_preload = false;
+            bool is_preconnect = false;
+            bool is_dns_prefetch = false;
+            for (auto part : token->attribute(AttributeNames::rel).split_view(' ')) {
+                if (part.equals_ignoring_case("stylesheet"sv))
+                    is_stylesheet = true;
+                else if (part.equals_ignoring_case("alternate"sv))
+                    is_alternate = true;
+                else if (part.equals_ignoring_case("preload"sv))
+                    is_preload = true;
+                else if (part.equals_ignoring_case("preconnect"sv))
+                    is_preconnect = true;
+                else if (part.equals_ignoring_case("dns-prefetch"sv))
+                    is_dns_prefetch = true;
+            }
+            auto href = token->attribute(AttributeNames::href);
+            if ((is_stylesheet && !is_alternate) || is_preload)
+                preload(Resource::Type::Generic, href);
+            if (is_preconnect)
+                preconnect(href, ConnectionHint::Preconnect);
+            else if (is_dns_prefetch)
+                preconnect(href, ConnectionHint::DNSPrefetch);
+        } else if (tag_name == "img"sv) {
+            preload(Resource::Type::Image, token->attribute(AttributeNames::src));
+        }
+    }
+}
+
+Optional<AK::URL> HTMLPreloadScanner::resolve_url(StringView url_string) const
+{
+    if (url_string.is_empty())
+        return {};
+
+    auto url = m_base_url.has_value() ? m_base_url->complete_url(url_string) : m_document.parse_url(url_string);
+    if (!url.is_valid())
+        return {};
+    return url;
+}
+
+void HTMLPreloadScanner::preload(Resource::Type type, StringView url_string)
+{
+    auto maybe_url = resolve_url(url_string);
+    if (!maybe_url.has_value())
+        return;
+    auto& url = *maybe_url;
+
+    // NOTE: Resources that are loaded from files aren't cached, so loading them early would only mean loading them twice.
+    if (url.protocol() == "file"sv)
+        return;
+
+    if (m_preloaded_urls.set(url.to_string()) != AK::HashSetResult::InsertedNewEntry)
+        return;
+
+    dbgln_if(PARSER_DEBUG, "HTMLPreloadScanner: Preloading {}", url);
+    auto request = LoadRequest::create_for_url_on_page(url, m_document.page());
+    (void)ResourceLoader::the().load_resource(type, request);
+}
+
+void HTMLPreloadScanner::preconnect(StringView url_string, ConnectionHint hint)
+{
+    auto url = resolve_url(url_string);
+    if (!url.has_value() || !url->protocol().is_one_of("http"sv, "https"sv))
+        return;
+
+    // NOTE: Connections are per origin, so there's no point in asking again for another URL on the same one.
+    auto origin = String::formatted("{}://{}:{}", url->protocol(), url->host(), url->port_or_default());
+    if (m_preconnected_origins.set(origin) != AK::HashSetResult::InsertedNewEntry)
+        return;
+
+    dbgln_if(PARSER_DEBUG, "HTMLPreloadScanner: {} for {}", hint == ConnectionHint::Preconnect ? "Preconnecting" : "Prefetching DNS", origin);
+    if (hint == ConnectionHint::Preconnect)
+        ResourceLoader::the().preconnect(*url);
+    else
+        ResourceLoader::the().prefetch_dns(*url);
+}
+
+}
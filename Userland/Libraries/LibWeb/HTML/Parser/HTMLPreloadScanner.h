@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <LibWeb/Forward.h>
+#include <LibWeb/Loader/Resource.h>
+
+namespace Web::HTML {
+
+class HTMLTokenizer;
+
+// Looks ahead through the input that the parser hasn't gotten to yet (because it's waiting for a script),
+// and starts loading the scripts, style sheets and images it finds there.
+// Those loads go into the resource cache, where the elements pick them up once the parser creates them.
+// <link rel=preconnect> and <link rel=dns-prefetch> hints are acted upon right away as well.
+class HTMLPreloadScanner {
+public:
+    explicit HTMLPreloadScanner(DOM::Document&);
+
+    void scan(HTMLTokenizer const& parser_tokenizer);
+
+private:
+    enum class ConnectionHint {
+        Preconnect,
+        DNSPrefetch,
+    };
+
+    Optional<AK::URL> resolve_url(StringView) const;
+    void preload(Resource::Type, StringView url);
+    void preconnect(StringView url, ConnectionHint);
+
+    DOM::Document& m_document;
+    Optional<AK::URL> m_base_url;
+
+    // The parser's input as of the last scan. It only changes when scripts insert more input with document.write().
+    String m_scanned_source;
+    HashTable<String> m_preloaded_urls;
+    HashTable<String> m_preconnected_origins;
+};
+
+}
@@ -5,8 +5,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/CharacterTypes.h>
 #include <AK/Debug.h>
+#include <AK/FlyString.h>
 #include <AK/SourceLocation.h>
 #include <LibTextCodec/Decoder.h>
 #include <LibWeb/HTML/Parser/Entities.h>
@@ -16,6 +18,10 @@
 #include <LibWeb/Namespace.h>
 #include <string.h>
 
+#ifdef __SSE2__
+#    include <AK/SIMD.h>
+#endif
+
 namespace Web::HTML {
 
 #pragma GCC diagnostic ignored "-Wunused-label"
@@ -155,6 +161,15 @@ namespace Web::HTML {
 #define EMIT_CURRENT_CHARACTER \
     EMIT_CHARACTER(current_input_character.value());
 
+#define EMIT_CURRENT_CHARACTER_AND_FOLLOWING_PLAIN_TEXT                                          \
+    do {                                                                                         \
+        create_new_token(HTMLToken::Type::Character);                                            \
+        m_current_token.set_code_point(current_input_character.value());                         \
+        m_queued_tokens.enqueue(move(m_current_token));                                          \
+        queue_plain_text_characters();                                                           \
+        return m_queued_tokens.dequeue();                                                        \
+    } while (0)
+
 #define SWITCH_TO_AND_EMIT_CHARACTER(code_point, new_state) \
     do {                                                    \
         will_switch_to(State::new_state);                   \
@@ -188,26 +203,96 @@ Optional<u32> HTMLTokenizer::next_code_point()
     if (m_utf8_iterator == m_utf8_view.end())
         return {};
 
-    u32 code_point;
+    u32 code_point = *m_utf8_iterator;
     // https://html.spec.whatwg.org/multipage/parsing.html#preprocessing-the-input-stream:tokenization
     // https://infra.spec.whatwg.org/#normalize-newlines
-    if (peek_code_point(0).value_or(0) == '\r' && peek_code_point(1).value_or(0) == '\n') {
+    if (code_point == '\r') {
         // replace every U+000D CR U+000A LF code point pair with a single U+000A LF code point,
-        skip(2);
-        code_point = '\n';
-    } else if (peek_code_point(0).value_or(0) == '\r') {
-        // replace every remaining U+000D CR code point with a U+000A LF code point.
-        skip(1);
+        // and then replace every remaining U+000D CR code point with a U+000A LF code point.
+        skip(peek_code_point(1).value_or(0) == '\n' ? 2 : 1);
         code_point = '\n';
     } else {
         skip(1);
-        code_point = *m_prev_utf8_iterator;
     }
 
     dbgln_if(TOKENIZER_TRACE_DEBUG, "(Tokenizer) Next code_point: {}", code_point);
     return code_point;
 }
 
+// Returns the offset of the first '&', '<', U+0000 or U+000D CR in bytes[start..end), or `end` if there is none.
+// Those are the only characters that text states have to look at one by one (the CR because it has to be normalized).
+static size_t find_special_text_character(u8 const* bytes, size_t start, size_t end)
+{
+    size_t index = start;
+#ifdef __SSE2__
+    auto const ampersand = AK::SIMD::u8x16 {} + '&';
+    auto const less_than = AK::SIMD::u8x16 {} + '<';
+    auto const null = AK::SIMD::u8x16 {};
+    auto const carriage_return = AK::SIMD::u8x16 {} + '\r';
+    for (; end - index >= 16; index += 16) {
+        AK::SIMD::u8x16 block;
+        __builtin_memcpy(&block, bytes + index, sizeof(block));
+        auto special = (block == ampersand) | (block == less_than) | (block == null) | (block == carriage_return);
+        if (auto mask = static_cast<u32>(__builtin_ia32_pmovmskb128(bit_cast<AK::SIMD::c8x16>(special))))
+            return index + count_trailing_zeroes(mask);
+    }
+#endif
+
+    for (; index < end; ++index) {
+        auto byte = bytes[index];
+        if (byte == '&' || byte == '<' || byte == 0 || byte == '\r')
+            break;
+    }
+    return index;
+}
+
+void HTMLTokenizer::queue_plain_text_characters()
+{
+    // NOTE: Keeping the batches small keeps the token queue from growing, they're only there to save trips through the state machine.
+    static constexpr size_t max_batch_length = 256;
+
+    auto start = m_utf8_view.byte_offset_of(m_utf8_iterator);
+    auto end = min(m_utf8_view.byte_length(), start + max_batch_length);
+    // Input that is inserted at the insertion point (by document.write()) has to come before whatever follows it.
+    if (m_insertion_point.defined && m_insertion_point.position >= start)
+        end = min(end, m_insertion_point.position);
+
+    auto const* bytes = m_utf8_view.bytes();
+    end = find_special_text_character(bytes, start, end);
+    // Don't stop in the middle of a multi-byte sequence.
+    if (end != m_utf8_view.byte_length()) {
+        while (end > start && (bytes[end] & 0xc0) == 0x80)
+            --end;
+    }
+    if (end == start)
+        return;
+
+    auto& position = m_source_positions.last();
+    while (m_utf8_view.byte_offset_of(m_utf8_iterator) < end) {
+        auto code_point = *m_utf8_iterator;
+        if (code_point == '\n') {
+            position.column = 0;
+            position.line++;
+        } else {
+            position.column++;
+        }
+        auto token = HTMLToken::make_character(code_point);
+        token.set_start_position({}, position);
+        m_queued_tokens.enqueue(move(token));
+        m_prev_utf8_iterator = m_utf8_iterator;
+        ++m_utf8_iterator;
+    }
+}
+
+String HTMLTokenizer::consume_current_builder_as_name()
+{
+    // NOTE: Tag and attribute names come from a small vocabulary, so interning them spares us allocating the same few strings
+    //       over and over, and makes turning them into the FlyStrings that the DOM wants free.
+    String name = FlyString(m_current_builder.string_view());
+    m_current_builder.clear();
+    return name;
+}
+
 void HTMLTokenizer::skip(size_t count)
 {
     m_source_positions.append(m_source_positions.last());
@@ -280,7 +365,7 @@ _StartOfFunction:
                 }
                 ANYTHING_ELSE
                 {
-                    EMIT_CURRENT_CHARACTER;
+                    EMIT_CURRENT_CHARACTER_AND_FOLLOWING_PLAIN_TEXT;
                 }
             }
             END_STATE
@@ -327,19 +412,19 @@ _StartOfFunction:
             {
                 ON_WHITESPACE
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     m_current_token.set_end_position({}, nth_last_position(1));
                     SWITCH_TO(BeforeAttributeName);
                 }
                 ON('/')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     m_current_token.set_end_position({}, nth_last_position(0));
                     SWITCH_TO(SelfClosingStartTag);
                 }
                 ON('>')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     m_current_token.set_end_position({}, nth_last_position(1));
                     SWITCH_TO_AND_EMIT_CURRENT_TOKEN(Data);
                 }
@@ -1103,28 +1188,28 @@ _StartOfFunction:
             {
                 ON_WHITESPACE
                 {
-                    m_current_token.last_attribute().local_name = consume_current_builder();
+                    m_current_token.last_attribute().local_name = consume_current_builder_as_name();
                     RECONSUME_IN(AfterAttributeName);
                 }
                 ON('/')
                 {
-                    m_current_token.last_attribute().local_name = consume_current_builder();
+                    m_current_token.last_attribute().local_name = consume_current_builder_as_name();
                     RECONSUME_IN(AfterAttributeName);
                 }
                 ON('>')
                 {
-                    m_current_token.last_attribute().local_name = consume_current_builder();
+                    m_current_token.last_attribute().local_name = consume_current_builder_as_name();
                     RECONSUME_IN(AfterAttributeName);
                 }
                 ON_EOF
                 {
-                    m_current_token.last_attribute().local_name = consume_current_builder();
+                    m_current_token.last_attribute().local_name = consume_current_builder_as_name();
                     RECONSUME_IN(AfterAttributeName);
                 }
                 ON('=')
                 {
                     m_current_token.last_attribute().name_end_position = nth_last_position(1);
-                    m_current_token.last_attribute().local_name = consume_current_builder();
+                    m_current_token.last_attribute().local_name = consume_current_builder_as_name();
                     SWITCH_TO(BeforeAttributeValue);
                 }
                 ON_ASCII_UPPER_ALPHA
@@ -1889,7 +1974,7 @@ _StartOfFunction:
                 }
                 ANYTHING_ELSE
                 {
-                    EMIT_CURRENT_CHARACTER;
+                    EMIT_CURRENT_CHARACTER_AND_FOLLOWING_PLAIN_TEXT;
                 }
             }
             END_STATE
@@ -1931,7 +2016,7 @@ _StartOfFunction:
             {
                 ON_WHITESPACE
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (!current_end_tag_token_is_appropriate()) {
                         m_queued_tokens.enqueue(HTMLToken::make_character('<'));
                         m_queued_tokens.enqueue(HTMLToken::make_character('/'));
@@ -1943,7 +2028,7 @@ _StartOfFunction:
                 }
                 ON('/')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (!current_end_tag_token_is_appropriate()) {
                         m_queued_tokens.enqueue(HTMLToken::make_character('<'));
                         m_queued_tokens.enqueue(HTMLToken::make_character('/'));
@@ -1955,7 +2040,7 @@ _StartOfFunction:
                 }
                 ON('>')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (!current_end_tag_token_is_appropriate()) {
                         m_queued_tokens.enqueue(HTMLToken::make_character('<'));
                         m_queued_tokens.enqueue(HTMLToken::make_character('/'));
@@ -2008,7 +2093,7 @@ _StartOfFunction:
                 }
                 ANYTHING_ELSE
                 {
-                    EMIT_CURRENT_CHARACTER;
+                    EMIT_CURRENT_CHARACTER_AND_FOLLOWING_PLAIN_TEXT;
                 }
             }
             END_STATE
@@ -2050,7 +2135,7 @@ _StartOfFunction:
             {
                 ON_WHITESPACE
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (!current_end_tag_token_is_appropriate()) {
                         m_queued_tokens.enqueue(HTMLToken::make_character('<'));
                         m_queued_tokens.enqueue(HTMLToken::make_character('/'));
@@ -2062,7 +2147,7 @@ _StartOfFunction:
                 }
                 ON('/')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (!current_end_tag_token_is_appropriate()) {
                         m_queued_tokens.enqueue(HTMLToken::make_character('<'));
                         m_queued_tokens.enqueue(HTMLToken::make_character('/'));
@@ -2074,7 +2159,7 @@ _StartOfFunction:
                 }
                 ON('>')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (!current_end_tag_token_is_appropriate()) {
                         m_queued_tokens.enqueue(HTMLToken::make_character('<'));
                         m_queued_tokens.enqueue(HTMLToken::make_character('/'));
@@ -2127,7 +2212,7 @@ _StartOfFunction:
                 }
                 ANYTHING_ELSE
                 {
-                    EMIT_CURRENT_CHARACTER;
+                    EMIT_CURRENT_CHARACTER_AND_FOLLOWING_PLAIN_TEXT;
                 }
             }
             END_STATE
@@ -2146,7 +2231,7 @@ _StartOfFunction:
                 }
                 ANYTHING_ELSE
                 {
-                    EMIT_CURRENT_CHARACTER;
+                    EMIT_CURRENT_CHARACTER_AND_FOLLOWING_PLAIN_TEXT;
                 }
             }
             END_STATE
@@ -2274,7 +2359,7 @@ _StartOfFunction:
             {
                 ON_WHITESPACE
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (current_end_tag_token_is_appropriate())
                         SWITCH_TO(BeforeAttributeName);
 
@@ -2289,7 +2374,7 @@ _StartOfFunction:
                 }
                 ON('/')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (current_end_tag_token_is_appropriate())
                         SWITCH_TO(SelfClosingStartTag);
 
@@ -2304,7 +2389,7 @@ _StartOfFunction:
                 }
                 ON('>')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (current_end_tag_token_is_appropriate())
                         SWITCH_TO_AND_EMIT_CURRENT_TOKEN(Data);
 
@@ -2620,7 +2705,7 @@ _StartOfFunction:
             {
                 ON_WHITESPACE
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (current_end_tag_token_is_appropriate())
                         SWITCH_TO(BeforeAttributeName);
                     m_queued_tokens.enqueue(HTMLToken::make_character('<'));
@@ -2633,7 +2718,7 @@ _StartOfFunction:
                 }
                 ON('/')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (current_end_tag_token_is_appropriate())
                         SWITCH_TO(SelfClosingStartTag);
                     m_queued_tokens.enqueue(HTMLToken::make_character('<'));
@@ -2646,7 +2731,7 @@ _StartOfFunction:
                 }
                 ON('>')
                 {
-                    m_current_token.set_tag_name(consume_current_builder());
+                    m_current_token.set_tag_name(consume_current_builder_as_name());
                     if (current_end_tag_token_is_appropriate())
                         SWITCH_TO_AND_EMIT_CURRENT_TOKEN(Data);
                     m_queued_tokens.enqueue(HTMLToken::make_character('<'));
@@ -125,6 +125,9 @@ public:
 
     String source() const { return m_decoded_input; }
 
+    // The part of the input that hasn't been tokenized yet.
+    StringView unconsumed_source() const { return m_decoded_input.substring_view(m_utf8_view.byte_offset_of(m_utf8_iterator)); }
+
     void insert_input_at_insertion_point(String const& input);
     void insert_eof();
     bool is_eof_inserted();
@@ -151,6 +154,10 @@ private:
     void create_new_token(HTMLToken::Type);
     bool current_end_tag_token_is_appropriate() const;
     String consume_current_builder();
+    String consume_current_builder_as_name();
+
+    // Queues character tokens for the plain text that follows the current input character.
+    void queue_plain_text_characters();
 
     static char const* state_name(State state)
     {
@@ -390,7 +390,7 @@ void BlockFormattingContext::layout_block_level_children(BlockContainer const& b
         }
 
         OwnPtr<FormattingContext> independent_formatting_context;
-        if (child_box.can_have_children()) {
+        if (child_box.can_have_children() && !try_reuse_previous_layout(child_box, layout_mode)) {
             independent_formatting_context = create_independent_formatting_context_if_needed(m_state, child_box);
             if (independent_formatting_context)
                 independent_formatting_context->run(child_box, layout_mode);
@@ -427,6 +427,81 @@ void BlockFormattingContext::layout_block_level_children(BlockContainer const& b
     }
 }
 
+static void restore_box_model_metrics(FormattingState::NodeState& state, BoxModelMetrics const& box_model)
+{
+    state.margin_top = box_model.margin.top;
+    state.margin_right = box_model.margin.right;
+    state.margin_bottom = box_model.margin.bottom;
+    state.margin_left = box_model.margin.left;
+    state.border_top = box_model.border.top;
+    state.border_right = box_model.border.right;
+    state.border_bottom = box_model.border.bottom;
+    state.border_left = box_model.border.left;
+    state.padding_top = box_model.padding.top;
+    state.padding_right = box_model.padding.right;
+    state.padding_bottom = box_model.padding.bottom;
+    state.padding_left = box_model.padding.left;
+    state.offset_top = box_model.offset.top;
+    state.offset_right = box_model.offset.right;
+    state.offset_bottom = box_model.offset.bottom;
+    state.offset_left = box_model.offset.left;
+}
+
+static void restore_lines_and_overflow(FormattingState::NodeState& state, Box const& box)
+{
+    auto const& paint_box = *box.paint_box();
+    state.overflow_data = paint_box.overflow_data();
+    if (is<BlockContainer>(box))
+        state.line_boxes = static_cast<Painting::PaintableWithLines const&>(paint_box).line_boxes();
+}
+
+// A box that establishes a new block formatting context is laid out independently of everything around it, except for the size it's given.
+// If nothing inside it has changed since the last layout, and it's given the same size again, the results of that layout still hold.
+bool BlockFormattingContext::try_reuse_previous_layout(Box const& box, LayoutMode layout_mode)
+{
+    // NOTE: Throwaway states for intrinsic sizing never get committed, so there's nothing to gain there.
+    if (layout_mode != LayoutMode::Default || m_state.m_parent)
+        return false;
+    if (box.needs_layout() || !box.paint_box() || !creates_block_formatting_context(box))
+        return false;
+
+    auto const& box_state = m_state.get(box);
+    if (box_state.content_width != box.paint_box()->content_width())
+        return false;
+    if (box.has_definite_height() && box_state.content_height != box.paint_box()->content_height())
+        return false;
+
+    // Absolutely positioned boxes can be positioned relative to a containing block outside of the box, whose size may have changed.
+    bool can_reuse = true;
+    box.for_each_in_subtree_of_type<Box>([&](auto& descendant) {
+        if (!descendant.paint_box() || descendant.is_absolutely_positioned()) {
+            can_reuse = false;
+            return IterationDecision::Break;
+        }
+        return IterationDecision::Continue;
+    });
+    if (!can_reuse)
+        return false;
+
+    // NOTE: The box's own position and size have been taken care of by the code laying it out, only what's inside of it is restored.
+    restore_lines_and_overflow(m_state.get_mutable(box), box);
+    box.for_each_in_subtree_of_type<NodeWithStyleAndBoxModelMetrics>([&](auto& descendant) {
+        auto& descendant_state = m_state.get_mutable(descendant);
+        restore_box_model_metrics(descendant_state, descendant.box_model());
+        if (is<Box>(descendant)) {
+            auto const& descendant_box = static_cast<Box const&>(descendant);
+            auto const& paint_box = *descendant_box.paint_box();
+            descendant_state.offset = paint_box.offset();
+            descendant_state.content_width = paint_box.content_width();
+            descendant_state.content_height = paint_box.content_height();
+            descendant_state.containing_line_box_fragment = paint_box.containing_line_box_fragment();
+            restore_lines_and_overflow(descendant_state, descendant_box);
+        }
+        return IterationDecision::Continue;
+    });
+    return true;
+}
+
 void BlockFormattingContext::compute_vertical_box_model_metrics(Box const& box, BlockContainer const& containing_block)
 {
     auto& box_state = m_state.get_mutable(box);
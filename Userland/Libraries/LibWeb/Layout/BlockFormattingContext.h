@@ -48,6 +48,7 @@ private:
     void layout_initial_containing_block(LayoutMode);
 
     void layout_block_level_children(BlockContainer const&, LayoutMode);
+    bool try_reuse_previous_layout(Box const&, LayoutMode);
     void layout_inline_children(BlockContainer const&, LayoutMode);
 
     void compute_vertical_box_model_metrics(Box const& box, BlockContainer const& containing_block);
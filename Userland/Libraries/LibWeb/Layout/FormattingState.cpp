@@ -17,14 +17,21 @@ FormattingState::NodeState& FormattingState::get_mutable(NodeWithStyleAndBoxMode
 
     for (auto* ancestor = m_parent; ancestor; ancestor = ancestor->m_parent) {
         if (auto it = ancestor->nodes.find(&box); it != ancestor->nodes.end()) {
-            auto cow_node_state = adopt_own(*new NodeState(*it->value));
-            auto* cow_node_state_ptr = cow_node_state.ptr();
-            nodes.set(&box, move(cow_node_state));
-            return *cow_node_state_ptr;
+            auto* cow_node_state = node_state_arena.allocate<NodeState>(*it->value);
+            VERIFY(cow_node_state);
+            nodes.set(&box, cow_node_state);
+            return *cow_node_state;
         }
     }
 
-    return *nodes.ensure(&box, [] { return adopt_own(*new NodeState); });
+    return *nodes.ensure(&box, [&] { return allocate_node_state(); });
+}
+
+FormattingState::NodeState* FormattingState::allocate_node_state()
+{
+    auto* node_state = node_state_arena.allocate<NodeState>();
+    VERIFY(node_state);
+    return node_state;
 }
 
 FormattingState::NodeState const& FormattingState::get(NodeWithStyleAndBoxModelMetrics const& box) const
@@ -37,7 +44,8 @@ FormattingState::NodeState const& FormattingState::get(NodeWithStyleAndBoxModelM
             return *it->value;
     }
 
-    return *const_cast<FormattingState&>(*this).nodes.ensure(&box, [] { return adopt_own(*new NodeState); });
+    auto& mutable_this = const_cast<FormattingState&>(*this);
+    return *mutable_this.nodes.ensure(&box, [&] { return mutable_this.allocate_node_state(); });
 }
 
 void FormattingState::commit()
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/BumpAllocator.h>
 #include <AK/HashMap.h>
 #include <LibGfx/Point.h>
 #include <LibWeb/Layout/Box.h>
@@ -81,7 +82,9 @@ struct FormattingState {
     // NOTE: get() will not CoW the NodeState.
     NodeState const& get(NodeWithStyleAndBoxModelMetrics const&) const;
 
-    HashMap<NodeWithStyleAndBoxModelMetrics const*, NonnullOwnPtr<NodeState>> nodes;
+    // NOTE: The NodeStates live in an arena, and are all freed together with the FormattingState.
+    ArenaAllocator<false, 64 * KiB> node_state_arena;
+    HashMap<NodeWithStyleAndBoxModelMetrics const*, NodeState*> nodes;
 
     // We cache intrinsic sizes once determined, as they will not change over the course of a full layout.
     // This avoids computing them several times while performing flex layout.
@@ -92,6 +95,9 @@ struct FormattingState {
     HashMap<NodeWithStyleAndBoxModelMetrics const*, IntrinsicSizes> mutable intrinsic_sizes;
 
     FormattingState const* m_parent { nullptr };
+
+private:
+    NodeState* allocate_node_state();
 };
 
 Gfx::FloatRect absolute_content_rect(Box const&, FormattingState const&);
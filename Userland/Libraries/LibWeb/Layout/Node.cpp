@@ -148,6 +148,13 @@ bool Node::is_positioned() const
     return has_style() && computed_values().position() != CSS::Position::Static;
 }
 
+void Node::set_needs_layout()
+{
+    for (auto* node = this; node && !node->m_needs_layout; node = node->parent())
+        node->m_needs_layout = true;
+    document().set_needs_layout();
+}
+
 bool Node::is_absolutely_positioned() const
 {
     if (!has_style())
@@ -564,6 +571,23 @@ bool Node::is_inline_block() const
     return is_inline() && is<BlockContainer>(*this);
 }
 
+void NodeWithStyle::reapply_style(CSS::StyleProperties const& specified_style)
+{
+    m_computed_values = {};
+    m_visible = true;
+    apply_style(specified_style);
+    did_insert_into_layout_tree(specified_style);
+
+    // Anonymous boxes inherit from us, just like they did when they were created.
+    for_each_child_of_type<NodeWithStyle>([&](auto& child) {
+        if (child.is_anonymous())
+            child.m_computed_values = m_computed_values.clone_inherited_values();
+        return IterationDecision::Continue;
+    });
+
+    set_needs_layout();
+}
+
 NonnullRefPtr<NodeWithStyle> NodeWithStyle::create_anonymous_wrapper() const
 {
     auto wrapper = adopt_ref(*new BlockContainer(const_cast<DOM::Document&>(document()), nullptr, m_computed_values.clone_inherited_values()));
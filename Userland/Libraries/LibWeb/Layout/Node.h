@@ -110,6 +110,12 @@ public:
 
     virtual void set_needs_display();
 
+    // Whether anything this node's layout depends on has changed since the last layout. Marking a node also marks its ancestors,
+    // so clean subtrees can keep their previous layout (see BlockFormattingContext::try_reuse_previous_layout()).
+    bool needs_layout() const { return m_needs_layout; }
+    void set_needs_layout();
+    void clear_needs_layout() { m_needs_layout = false; }
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -143,6 +149,7 @@ private:
     SelectionState m_selection_state { SelectionState::None };
 
     bool m_is_flex_item { false };
+    bool m_needs_layout { true };
 };
 
 class NodeWithStyle : public Node {
@@ -168,6 +175,9 @@ public:
 
     void did_insert_into_layout_tree(CSS::StyleProperties const&);
 
+    // Called when the DOM node's style changed in a way that this layout node (and the rest of the layout tree) can live with.
+    void reapply_style(CSS::StyleProperties const&);
+
 protected:
     NodeWithStyle(DOM::Document&, DOM::Node*, NonnullRefPtr<CSS::StyleProperties>);
     NodeWithStyle(DOM::Document&, DOM::Node*, CSS::ComputedValues);
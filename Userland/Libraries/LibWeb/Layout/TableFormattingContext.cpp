@@ -82,6 +82,7 @@ void TableFormattingContext::calculate_column_widths(Box const& row, Vector<floa
     row.for_each_child_of_type<TableCellBox>([&](auto& cell) {
         auto& cell_state = m_state.get_mutable(cell);
         compute_width(cell);
+        m_cell_layout_widths.set(&cell, cell_state.content_width);
         if (use_auto_layout) {
             (void)layout_inside(cell, LayoutMode::OnlyRequiredLineBreaks);
         } else {
@@ -106,10 +107,16 @@ void TableFormattingContext::layout_row(Box const& row, Vector<float>& column_wi
         cell_state.offset = row_state.offset.translated(content_width, 0);
 
         // Layout the cell contents a second time, now that we know its final width.
-        if (use_auto_layout) {
-            (void)layout_inside(cell, LayoutMode::OnlyRequiredLineBreaks);
-        } else {
-            (void)layout_inside(cell, LayoutMode::Default);
+        // NOTE: A cell's contents don't depend on anything outside of it but its width, so if that didn't change,
+        //       the layout from calculate_column_widths() still holds (and is much cheaper than doing it all over).
+        auto laid_out_width = m_cell_layout_widths.get(&cell);
+        if (!laid_out_width.has_value() || *laid_out_width != cell_state.content_width) {
+            m_cell_layout_widths.set(&cell, cell_state.content_width);
+            if (use_auto_layout) {
+                (void)layout_inside(cell, LayoutMode::OnlyRequiredLineBreaks);
+            } else {
+                (void)layout_inside(cell, LayoutMode::Default);
+            }
         }
 
         BlockFormattingContext::compute_height(cell, m_state);
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Forward.h>
+#include <AK/HashMap.h>
 #include <LibWeb/Layout/BlockFormattingContext.h>
 
 namespace Web::Layout {
@@ -21,6 +22,9 @@ public:
 private:
     void calculate_column_widths(Box const& row, Vector<float>& column_widths);
     void layout_row(Box const& row, Vector<float>& column_widths);
+
+    // The content width that each cell's contents were last laid out for.
+    HashMap<Box const*, float> m_cell_layout_widths;
 };
 
 }
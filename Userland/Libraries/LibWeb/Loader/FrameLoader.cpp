@@ -5,6 +5,7 @@
  */
 
 #include <AK/Debug.h>
+#include <AK/GenericLexer.h>
 #include <AK/JsonArray.h>
 #include <AK/LexicalPath.h>
 #include <AK/SourceGenerator.h>
@@ -20,6 +21,7 @@
 #include <LibWeb/HTML/Parser/HTMLParser.h>
 #include <LibWeb/ImageDecoding.h>
 #include <LibWeb/Loader/FrameLoader.h>
+#include <LibWeb/Loader/LoadRequest.h>
 #include <LibWeb/Loader/ResourceLoader.h>
 #include <LibWeb/Page/Page.h>
 
@@ -286,6 +288,61 @@ void FrameLoader::store_response_cookies(AK::URL const& url, String const& cooki
     }
 }
 
+// Acts on the preload, preconnect and dns-prefetch hints in a Link header (RFC 8288), so that they don't have to wait for the
+// parser to get to the <link> elements, e.g. `Link: <https://cdn.example/>; rel=preconnect, </app.js>; rel="preload"; as=script`
+static void process_link_header_hints(AK::URL const& document_url, StringView header, Page* page)
+{
+    GenericLexer lexer { header };
+    while (!lexer.is_eof()) {
+        lexer.ignore_while(is_ascii_space);
+        if (!lexer.consume_specific('<')) {
+            // Not something we understand; skip to the next link.
+            lexer.ignore_until(',');
+            continue;
+        }
+        auto target = lexer.consume_until('>');
+        lexer.ignore();
+
+        StringView relations;
+        while (!lexer.is_eof() && !lexer.next_is(',')) {
+            lexer.ignore_while([](char c) { return is_ascii_space(c) || c == ';'; });
+            auto name = lexer.consume_until([](char c) { return c == '=' || c == ';' || c == ','; }).trim_whitespace();
+            StringView value;
+            if (lexer.consume_specific('=')) {
+                lexer.ignore_while(is_ascii_space);
+                if (lexer.consume_specific('"')) {
+                    // FIXME: Handle quoted-pairs.
+                    value = lexer.consume_until('"');
+                    lexer.ignore();
+                } else {
+                    value = lexer.consume_until([](char c) { return c == ';' || c == ','; }).trim_whitespace();
+                }
+            }
+            // Only the first rel parameter counts.
+            if (name.equals_ignoring_case("rel"sv) && relations.is_null())
+                relations = value;
+        }
+        lexer.ignore();
+
+        auto url = document_url.complete_url(target);
+        if (!url.is_valid())
+            continue;
+
+        for (auto relation : relations.split_view(' ')) {
+            if (relation.equals_ignoring_case("preload"sv)) {
+                dbgln_if(RESOURCE_DEBUG, "FrameLoader: Preloading {} (from a Link header)", url);
+                // FIXME: Respect the "as" parameter.
+                auto request = LoadRequest::create_for_url_on_page(url, page);
+                (void)ResourceLoader::the().load_resource(Resource::Type::Generic, request);
+            } else if (relation.equals_ignoring_case("preconnect"sv)) {
+                ResourceLoader::the().preconnect(url);
+            } else if (relation.equals_ignoring_case("dns-prefetch"sv)) {
+                ResourceLoader::the().prefetch_dns(url);
+            }
+        }
+    }
+}
+
 void FrameLoader::resource_did_load()
 {
     auto url = resource()->url();
@@ -321,6 +378,9 @@ void FrameLoader::resource_did_load()
         dbgln_if(RESOURCE_DEBUG, "This content has MIME type '{}', encoding unknown", resource()->mime_type());
     }
 
+    if (auto link = resource()->response_headers().get("Link"); link.has_value())
+        process_link_header_hints(url, *link, browsing_context().page());
+
     auto document = DOM::Document::create();
     document->set_url(url);
     document->set_encoding(resource()->encoding());
@@ -112,14 +112,11 @@ void EditEventHandler::handle_insert(DOM::Position position, u32 code_point)
         builder.append_code_point(code_point);
         builder.append(node.data().substring_view(position.offset()));
         node.set_data(builder.to_string());
-
-        node.invalidate_style();
     }
 
-    // FIXME: When nodes are removed from the DOM, the associated layout nodes become stale and still
-    //        remain in the layout tree. This has to be fixed, this just causes everything to be recomputed
-    //        which really hurts performance.
-    m_browsing_context.active_document()->force_layout();
+    // NOTE: Unlike deleting, inserting text doesn't remove any nodes, so the layout tree stays valid
+    //       and only the boxes around the text node have to be laid out again.
+    m_browsing_context.active_document()->update_layout();
 
     m_browsing_context.did_edit({});
 }
@@ -148,14 +148,30 @@ void StackingContext::paint(PaintContext& context) const
         return;
 
     if (opacity < 1.0f) {
-        auto bitmap_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, context.painter().target()->size());
+        // The layer only has to cover the part of the box that is in the viewport.
+        // NOTE: Fixed position boxes (and everything inside them) are positioned relative to the viewport, not the content.
+        auto visible_rect = context.viewport_rect();
+        for (Layout::Node const* node = &m_box; node; node = node->parent()) {
+            if (node->is_fixed_position()) {
+                visible_rect.translate_by(-context.scroll_offset());
+                break;
+            }
+        }
+        auto layer_rect = enclosing_int_rect(m_box.paint_box()->absolute_rect()).intersected(visible_rect);
+        if (layer_rect.is_empty())
+            return;
+        auto bitmap_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRA8888, layer_rect.size());
         if (bitmap_or_error.is_error())
             return;
         auto bitmap = bitmap_or_error.release_value_but_fixme_should_propagate_errors();
         Gfx::Painter painter(bitmap);
+        painter.translate(-layer_rect.location());
         PaintContext paint_context(painter, context.palette(), context.scroll_offset());
+        paint_context.set_viewport_rect(context.viewport_rect());
+        paint_context.set_has_focus(context.has_focus());
+        paint_context.set_should_show_line_box_borders(context.should_show_line_box_borders());
         paint_internal(paint_context);
-        context.painter().blit(Gfx::IntPoint(m_box.paint_box()->absolute_position()), bitmap, Gfx::IntRect(m_box.paint_box()->absolute_rect()), opacity);
+        context.painter().blit(layer_rect.location(), bitmap, bitmap->rect(), opacity);
     } else {
         paint_internal(context);
     }
@@ -8,6 +8,7 @@
 #include "Mixer.h"
 #include <AudioServer/AudioClientEndpoint.h>
 #include <LibAudio/Buffer.h>
+#include <LibAudio/SharedRingBuffer.h>
 
 namespace AudioServer {
 
@@ -102,6 +103,20 @@ Messages::AudioServer::EnqueueBufferResponse ConnectionFromClient::enqueue_buffe
     return true;
 }
 
+Messages::AudioServer::SetRingBufferResponse ConnectionFromClient::set_ring_buffer(Core::AnonymousBuffer const& buffer)
+{
+    auto ring_buffer = Audio::SharedRingBuffer::create_from_anonymous_buffer(buffer);
+    if (ring_buffer.is_error()) {
+        dbgln("AudioServer: Client {} sent an unusable ring buffer: {}", client_id(), ring_buffer.error());
+        return false;
+    }
+
+    if (!m_queue)
+        m_queue = m_mixer.create_queue(*this);
+
+    return m_queue->set_ring_buffer(ring_buffer.release_value());
+}
+
 Messages::AudioServer::GetRemainingSamplesResponse ConnectionFromClient::get_remaining_samples()
 {
     int remaining = 0;
@@ -42,6 +42,7 @@ private:
     virtual Messages::AudioServer::GetSelfVolumeResponse get_self_volume() override;
     virtual void set_self_volume(double) override;
     virtual Messages::AudioServer::EnqueueBufferResponse enqueue_buffer(Core::AnonymousBuffer const&, i32, int) override;
+    virtual Messages::AudioServer::SetRingBufferResponse set_ring_buffer(Core::AnonymousBuffer const&) override;
     virtual Messages::AudioServer::GetRemainingSamplesResponse get_remaining_samples() override;
     virtual Messages::AudioServer::GetPlayedSamplesResponse get_played_samples() override;
     virtual void set_paused(bool) override;
@@ -7,9 +7,9 @@
 
 #include "Mixer.h"
 #include "AK/Format.h"
-#include <AK/Array.h>
-#include <AK/MemoryStream.h>
+#include <AK/Endian.h>
 #include <AK/NumericLimits.h>
+#include <AK/SIMD.h>
 #include <AudioServer/ConnectionFromClient.h>
 #include <AudioServer/Mixer.h>
 #include <LibCore/ConfigFile.h>
@@ -20,8 +20,6 @@
 
 namespace AudioServer {
 
-u8 Mixer::m_zero_filled_buffer[4096];
-
 Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
     // FIXME: Allow AudioServer to use other audio channels as well
     : m_device(Core::File::construct("/dev/audio/0", this))
@@ -40,6 +38,7 @@ Mixer::Mixer(NonnullRefPtr<Core::ConfigFile> config)
 
     m_muted = m_config->read_bool_entry("Master", "Mute", false);
     m_main_volume = static_cast<double>(m_config->read_num_entry("Master", "Volume", 100)) / 100.0;
+    m_period_size = clamp<size_t>(m_config->read_num_entry("Mixer", "PeriodSize", DEFAULT_PERIOD_SIZE), MIN_PERIOD_SIZE, MAX_PERIOD_SIZE);
 
     m_sound_thread->start();
 }
@@ -62,10 +61,55 @@ NonnullRefPtr<ClientAudioStream> Mixer::create_queue(ConnectionFromClient& clien
     return queue;
 }
 
+// An Audio::Sample is exactly one vector of two doubles: its left and right channel.
+static_assert(sizeof(Audio::Sample) == sizeof(AK::SIMD::f64x2));
+
+static ALWAYS_INLINE AK::SIMD::f64x2 load_sample(Audio::Sample const& sample)
+{
+    AK::SIMD::f64x2 value;
+    __builtin_memcpy(&value, &sample, sizeof(value));
+    return value;
+}
+
+// output[i] += input[i] * gain
+static void mix_scaled(Span<Audio::Sample> output, Span<Audio::Sample const> input, double gain)
+{
+    VERIFY(output.size() == input.size());
+    AK::SIMD::f64x2 gain_vector { gain, gain };
+    for (size_t i = 0; i < input.size(); ++i) {
+        auto mixed = load_sample(output[i]) + load_sample(input[i]) * gain_vector;
+        __builtin_memcpy(&output[i], &mixed, sizeof(mixed));
+    }
+}
+
+// Scales the mixed samples by the gain, clips them and writes them out as interleaved little-endian 16-bit PCM.
+static void convert_to_i16(Bytes output, Span<Audio::Sample const> input, double gain)
+{
+    VERIFY(output.size() == input.size() * 2 * sizeof(i16));
+    AK::SIMD::f64x2 gain_vector { gain, gain };
+    AK::SIMD::f64x2 minimum { -1, -1 };
+    AK::SIMD::f64x2 maximum { 1, 1 };
+    AK::SIMD::f64x2 scale { NumericLimits<i16>::max(), NumericLimits<i16>::max() };
+    auto* output_samples = reinterpret_cast<LittleEndian<i16>*>(output.data());
+    for (size_t i = 0; i < input.size(); ++i) {
+        auto value = load_sample(input[i]) * gain_vector;
+        value = value < minimum ? minimum : value;
+        value = value > maximum ? maximum : value;
+        auto converted = __builtin_convertvector(value * scale, AK::SIMD::i64x2);
+        output_samples[i * 2] = static_cast<i16>(converted[0]);
+        output_samples[i * 2 + 1] = static_cast<i16>(converted[1]);
+    }
+}
+
 void Mixer::mix()
 {
     decltype(m_pending_mixing) active_mix_queues;
 
+    // Everything a period needs is allocated up front, so that mixing doesn't have to allocate at all.
+    auto mixed_buffer = MUST(FixedArray<Audio::Sample>::try_create(m_period_size));
+    auto queue_buffer = MUST(FixedArray<Audio::Sample>::try_create(m_period_size));
+    auto output_buffer = MUST(ByteBuffer::create_zeroed(m_period_size * 2 * sizeof(i16)));
+
     for (;;) {
         m_pending_mutex.lock();
         // While we have nothing to mix, wait on the condition.
@@ -78,8 +122,8 @@ void Mixer::mix()
 
         active_mix_queues.remove_all_matching([&](auto& entry) { return !entry->client(); });
 
-        Audio::Sample mixed_buffer[1024];
-        auto mixed_buffer_length = (int)(sizeof(mixed_buffer) / sizeof(Audio::Sample));
+        for (auto& mixed_sample : mixed_buffer)
+            mixed_sample = {};
 
         m_main_volume.advance_time();
 
@@ -93,47 +137,22 @@ void Mixer::mix()
             ++active_queues;
             queue->volume().advance_time();
 
-            for (int i = 0; i < mixed_buffer_length; ++i) {
-                auto& mixed_sample = mixed_buffer[i];
-                Audio::Sample sample;
-                if (!queue->get_next_sample(sample))
-                    break;
-                if (queue->is_muted())
-                    continue;
-                sample.log_multiply(SAMPLE_HEADROOM);
-                sample.log_multiply(queue->volume());
-                mixed_sample += sample;
-            }
+            auto sample_count = queue->read_samples(queue_buffer.span());
+            if (queue->is_muted())
+                continue;
+            // The volume only changes from one period to the next, so scale by the combined factor.
+            double gain = Audio::Sample::linear_to_log(SAMPLE_HEADROOM) * Audio::Sample::linear_to_log(queue->volume());
+            mix_scaled(mixed_buffer.span().trim(sample_count), queue_buffer.span().trim(sample_count), gain);
         }
 
         if (m_muted) {
-            m_device->write(m_zero_filled_buffer, sizeof(m_zero_filled_buffer));
+            output_buffer.zero_fill();
         } else {
-            Array<u8, 4096> buffer;
-            OutputMemoryStream stream { buffer };
-
-            for (int i = 0; i < mixed_buffer_length; ++i) {
-                auto& mixed_sample = mixed_buffer[i];
-
-                // Even though it's not realistic, the user expects no sound at 0%.
-                if (m_main_volume < 0.01)
-                    mixed_sample = Audio::Sample { 0 };
-                else
-                    mixed_sample.log_multiply(m_main_volume);
-                mixed_sample.clip();
-
-                LittleEndian<i16> out_sample;
-                out_sample = mixed_sample.left * NumericLimits<i16>::max();
-                stream << out_sample;
-
-                out_sample = mixed_sample.right * NumericLimits<i16>::max();
-                stream << out_sample;
-            }
-
-            VERIFY(stream.is_end());
-            VERIFY(!stream.has_any_error());
-            m_device->write(stream.data(), stream.size());
+            // Even though it's not realistic, the user expects no sound at 0%.
+            double gain = m_main_volume < 0.01 ? 0 : Audio::Sample::linear_to_log(m_main_volume);
+            convert_to_i16(output_buffer.bytes(), mixed_buffer.span(), gain);
         }
+        m_device->write(output_buffer.data(), output_buffer.size());
     }
 }
 
@@ -209,4 +228,35 @@ void ClientAudioStream::enqueue(NonnullRefPtr<Audio::Buffer>&& buffer)
     m_remaining_samples += buffer->sample_count();
     m_queue.enqueue(move(buffer));
 }
+
+bool ClientAudioStream::set_ring_buffer(Audio::SharedRingBuffer ring_buffer)
+{
+    // The mixer thread may be reading from the current one at any time, so it can't be replaced.
+    if (m_ring_buffer_storage)
+        return false;
+    m_ring_buffer_storage = make<Audio::SharedRingBuffer>(move(ring_buffer));
+    m_ring_buffer.store(m_ring_buffer_storage.ptr(), AK::memory_order_release);
+    return true;
+}
+
+size_t ClientAudioStream::read_samples(Span<Audio::Sample> samples)
+{
+    auto* ring_buffer = m_ring_buffer.load(AK::memory_order_acquire);
+    if (ring_buffer && m_should_discard_ring_buffer.exchange(false))
+        ring_buffer->discard_all();
+
+    if (m_paused)
+        return 0;
+
+    if (ring_buffer) {
+        auto sample_count = ring_buffer->read(samples);
+        m_played_samples += sample_count;
+        return sample_count;
+    }
+
+    size_t sample_count = 0;
+    while (sample_count < samples.size() && get_next_sample(samples[sample_count]))
+        ++sample_count;
+    return sample_count;
+}
 }
@@ -12,11 +12,14 @@
 #include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/ByteBuffer.h>
+#include <AK/FixedArray.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <AK/Queue.h>
 #include <AK/RefCounted.h>
 #include <AK/WeakPtr.h>
 #include <LibAudio/Buffer.h>
+#include <LibAudio/SharedRingBuffer.h>
 #include <LibCore/File.h>
 #include <LibCore/Timer.h>
 #include <LibThreading/ConditionVariable.h>
@@ -30,6 +33,12 @@ namespace AudioServer {
 // This is to prevent clipping when two streams with low headroom (e.g. normalized & compressed) are playing.
 constexpr double SAMPLE_HEADROOM = 0.95;
 
+// How many samples are mixed at a time, unless the config says otherwise. Smaller periods mean less latency,
+// but the mixer has to wake up more often; at 44.1 kHz, the minimum is about 1.5 ms.
+constexpr size_t DEFAULT_PERIOD_SIZE = 1024;
+constexpr size_t MIN_PERIOD_SIZE = 64;
+constexpr size_t MAX_PERIOD_SIZE = 4096;
+
 class ConnectionFromClient;
 
 class ClientAudioStream : public RefCounted<ClientAudioStream> {
@@ -40,6 +49,12 @@ public:
     bool is_full() const { return m_queue.size() >= 3; }
     void enqueue(NonnullRefPtr<Audio::Buffer>&&);
 
+    // Can only be done once; from then on, the stream plays what the client writes into the ring buffer.
+    bool set_ring_buffer(Audio::SharedRingBuffer);
+
+    // Returns how many samples were read into `samples`.
+    size_t read_samples(Span<Audio::Sample> samples);
+
     bool get_next_sample(Audio::Sample& sample)
     {
         if (m_paused)
@@ -68,6 +83,9 @@ public:
 
     void clear(bool paused = false)
     {
+        // The ring buffer is only ever read from the mixer thread, which will throw its contents away.
+        if (m_ring_buffer)
+            m_should_discard_ring_buffer = true;
         m_queue.clear();
         m_position = 0;
         m_remaining_samples = 0;
@@ -81,7 +99,12 @@ public:
         m_paused = paused;
     }
 
-    int get_remaining_samples() const { return m_remaining_samples; }
+    int get_remaining_samples() const
+    {
+        if (auto* ring_buffer = m_ring_buffer.load())
+            return ring_buffer->available_to_read();
+        return m_remaining_samples;
+    }
     int get_played_samples() const { return m_played_samples; }
     int get_playing_buffer() const
     {
@@ -105,6 +128,11 @@ private:
     bool m_paused { false };
     bool m_muted { false };
 
+    // Set once, by the connection's thread, and then read by the mixer thread.
+    OwnPtr<Audio::SharedRingBuffer> m_ring_buffer_storage;
+    Atomic<Audio::SharedRingBuffer*> m_ring_buffer { nullptr };
+    Atomic<bool> m_should_discard_ring_buffer { false };
+
     WeakPtr<ConnectionFromClient> m_client;
     FadingProperty<double> m_volume { 1 };
 };
@@ -136,6 +164,7 @@ private:
     Threading::ConditionVariable m_mixing_necessary { m_pending_mutex };
 
     RefPtr<Core::File> m_device;
+    size_t m_period_size { DEFAULT_PERIOD_SIZE };
 
     NonnullRefPtr<Threading::Thread> m_sound_thread;
 
@@ -145,8 +174,6 @@ private:
     NonnullRefPtr<Core::ConfigFile> m_config;
     RefPtr<Core::Timer> m_config_write_timer;
 
-    static u8 m_zero_filled_buffer[4096];
-
     void mix();
 };
 
@@ -6,6 +6,9 @@
 
 #include <AK/LexicalPath.h>
 #include <Kernel/API/InodeWatcherEvent.h>
+#include <LibCompress/Gzip.h>
+#include <LibCore/File.h>
+#include <LibCore/FileStream.h>
 #include <LibCore/FileWatcher.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
@@ -31,6 +34,27 @@ static void wait_until_coredump_is_ready(const String& coredump_path)
     }
 }
 
+// The kernel writes coredumps uncompressed, so we compress them (on all processors) while it's still cheap to do so,
+// and keep the compressed one around instead. LibCoredump can read both.
+static ErrorOr<String> compress_coredump(String const& coredump_path)
+{
+    auto coredump = TRY(Core::MappedFile::map(coredump_path));
+    auto compressed_path = String::formatted("{}.gz", coredump_path);
+    auto compressed_file = TRY(Core::File::open(compressed_path, Core::OpenMode::WriteOnly | Core::OpenMode::MustBeNew, 0600));
+
+    Core::OutputFileStream file_stream(compressed_file);
+    Compress::ParallelGzipCompressor gzip_stream(file_stream);
+    gzip_stream.write_or_error(coredump->bytes());
+    gzip_stream.finish();
+    if (gzip_stream.has_any_error() || file_stream.has_any_error()) {
+        (void)Core::System::unlink(compressed_path);
+        return Error::from_string_literal("Failed to write the compressed coredump"sv);
+    }
+
+    TRY(Core::System::unlink(coredump_path));
+    return compressed_path;
+}
+
 static void launch_crash_reporter(const String& coredump_path, bool unlink_on_exit)
 {
     pid_t child;
@@ -53,7 +77,7 @@ static void launch_crash_reporter(const String& coredump_path, bool unlink_on_ex
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
-    TRY(Core::System::pledge("stdio rpath wpath cpath proc exec"));
+    TRY(Core::System::pledge("stdio rpath wpath cpath proc exec thread"));
 
     Core::BlockingFileWatcher watcher;
     TRY(watcher.add_watch("/tmp/coredump", Core::FileWatcherEvent::Type::ChildCreated));
@@ -64,15 +88,19 @@ ErrorOr<int> serenity_main(Main::Arguments)
         if (event.value().type != Core::FileWatcherEvent::Type::ChildCreated)
             continue;
         auto& coredump_path = event.value().event_path;
+        // These are the ones we compressed ourselves.
+        if (coredump_path.ends_with(".gz"sv))
+            continue;
         dbgln("New coredump file: {}", coredump_path);
         wait_until_coredump_is_ready(coredump_path);
 
-        auto file_or_error = Core::MappedFile::map(coredump_path);
-        if (file_or_error.is_error()) {
-            dbgln("Unable to map coredump {}: {}", coredump_path, file_or_error.error());
+        auto compressed_path_or_error = compress_coredump(coredump_path);
+        if (compressed_path_or_error.is_error()) {
+            dbgln("Unable to compress coredump {}: {}", coredump_path, compressed_path_or_error.error());
+            launch_crash_reporter(coredump_path, true);
             continue;
         }
 
-        launch_crash_reporter(coredump_path, true);
+        launch_crash_reporter(compressed_path_or_error.value(), true);
     }
 }
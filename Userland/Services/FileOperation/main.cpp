@@ -32,6 +32,9 @@ struct WorkItem {
     off_t size;
 };
 
+// How much data to copy in the kernel between two progress reports.
+static constexpr size_t copy_file_range_chunk_size = 1 * MiB;
+
 static void report_warning(StringView message);
 static void report_error(StringView message);
 static ErrorOr<int> perform_copy(Vector<StringView> const& sources, String const& destination);
@@ -233,6 +236,35 @@ ErrorOr<int> execute_work_items(Vector<WorkItem> const& items)
             auto source_file = TRY(Core::Stream::File::open(source, Core::Stream::OpenMode::Read));
             // FIXME: When the file already exists, let the user choose the next action instead of renaming it by default.
             auto destination_file = TRY(open_destination_file(destination));
+
+            // Let the kernel move the data from file to file, so it doesn't have to be copied through our buffer below.
+            // The copy is done in chunks so that we can keep reporting progress.
+            for (bool is_first_chunk = true;; is_first_chunk = false) {
+                print_progress();
+                auto bytes_copied_or_error = Core::System::copy_file_range(source_file->fd(), nullptr, destination_file->fd(), nullptr, copy_file_range_chunk_size);
+                if (bytes_copied_or_error.is_error()) {
+                    auto code = bytes_copied_or_error.error().code();
+                    // These files can't be copied in the kernel; copy whatever is left through the buffer.
+                    if (code == EINVAL || code == EXDEV || code == ENOSYS)
+                        break;
+                    report_warning(String::formatted("Failed to copy to destination file: {}", bytes_copied_or_error.error()));
+                    return bytes_copied_or_error.release_error();
+                }
+                auto bytes_copied = bytes_copied_or_error.value();
+                if (bytes_copied == 0) {
+                    // NOTE: Synthetic files may report a size of 0 but still have contents that only read() returns.
+                    if (is_first_chunk && item.size == 0)
+                        break;
+                    print_progress();
+                    return 0;
+                }
+                item_done += bytes_copied;
+                executed_work_bytes += bytes_copied;
+                // FIXME: Remove this once the kernel is smart enough to schedule other threads
+                //        while we're doing heavy I/O.
+                sched_yield();
+            }
+
             auto buffer = TRY(ByteBuffer::create_zeroed(64 * KiB));
 
             while (true) {
@@ -240,7 +272,7 @@ ErrorOr<int> execute_work_items(Vector<WorkItem> const& items)
                 auto bytes_read = TRY(source_file->read(buffer.bytes()));
                 if (bytes_read == 0)
                     break;
-                if (auto result = destination_file->write(buffer); result.is_error()) {
+                if (auto result = destination_file->write(buffer.bytes().trim(bytes_read)); result.is_error()) {
                     // FIXME: Return the formatted string directly. There is no way to do this right now without the temporary going out of scope and being destroyed.
                     report_warning(String::formatted("Failed to write to destination file: {}", result.error()));
                     return result.error();
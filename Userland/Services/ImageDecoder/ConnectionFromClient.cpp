@@ -6,9 +6,12 @@
 
 #include <AK/Debug.h>
 #include <ImageDecoder/ConnectionFromClient.h>
+#include <ImageDecoder/DecodedImageCache.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
+#include <LibCore/EventLoop.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/ImageDecoder.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace ImageDecoder {
 
@@ -26,40 +29,116 @@ void ConnectionFromClient::die()
     Core::EventLoop::current().quit(0);
 }
 
-Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer)
+// Scales the frame down to fit into the ideal size, keeping its aspect ratio. Frames are never scaled up.
+static RefPtr<Gfx::Bitmap> fit_to_ideal_size(NonnullRefPtr<Gfx::Bitmap> frame, Optional<Gfx::IntSize> const& ideal_size)
+{
+    if (!ideal_size.has_value() || ideal_size->is_empty())
+        return frame;
+
+    auto scale = min(static_cast<float>(ideal_size->width()) / frame->width(), static_cast<float>(ideal_size->height()) / frame->height());
+    if (scale >= 1.0f)
+        return frame;
+
+    auto scaled_frame_or_error = frame->scaled(scale, scale);
+    if (scaled_frame_or_error.is_error())
+        return frame;
+    return scaled_frame_or_error.release_value();
+}
+
+// This runs on the thread pool as well as on the main thread, so it must not touch the connection.
+static DecodedImage decode(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> const& ideal_size)
+{
+    auto cache_key = DecodedImageCache::key_for(encoded_data, ideal_size);
+    if (auto cached_image = DecodedImageCache::the().find(cache_key); cached_image.has_value())
+        return cached_image.release_value();
+
+    bool is_animated = false;
+    u32 loop_count = 0;
+    Vector<RefPtr<Gfx::Bitmap>> frames;
+    Vector<u32> durations;
+
+    {
+        auto decoder = Gfx::ImageDecoder::try_create(encoded_data);
+
+        if (!decoder) {
+            dbgln_if(IMAGE_DECODER_DEBUG, "Could not find suitable image decoder plugin for data");
+            return {};
+        }
+
+        if (!decoder->frame_count()) {
+            dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
+            return {};
+        }
+
+        is_animated = decoder->is_animated();
+        loop_count = static_cast<u32>(decoder->loop_count());
+
+        for (size_t i = 0; i < decoder->frame_count(); ++i) {
+            auto frame_or_error = decoder->frame(i);
+            if (frame_or_error.is_error()) {
+                frames.append(nullptr);
+                durations.append(0);
+            } else {
+                auto frame = frame_or_error.release_value();
+                frames.append(fit_to_ideal_size(frame.image.release_nonnull(), ideal_size));
+                durations.append(frame.duration);
+            }
+        }
+
+        // NOTE: The decoder goes away here, so nothing but us holds on to the frames when they go into the cache.
+    }
+
+    DecodedImage decoded_image { is_animated, loop_count, {}, durations };
+    for (auto const& frame : frames)
+        decoded_image.bitmaps.append(frame ? frame->to_shareable_bitmap() : Gfx::ShareableBitmap {});
+
+    DecodedImageCache::the().add(cache_key, is_animated, loop_count, move(frames), move(durations));
+    return decoded_image;
+}
+
+Messages::ImageDecoderServer::DecodeImageResponse ConnectionFromClient::decode_image(Core::AnonymousBuffer const& encoded_buffer, Optional<Gfx::IntSize> const& ideal_size)
 {
     if (!encoded_buffer.is_valid()) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
         return nullptr;
     }
 
-    auto decoder = Gfx::ImageDecoder::try_create(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() });
+    auto image = decode(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, ideal_size);
+    return { image.is_animated, image.loop_count, move(image.bitmaps), move(image.durations) };
+}
 
-    if (!decoder) {
-        dbgln_if(IMAGE_DECODER_DEBUG, "Could not find suitable image decoder plugin for data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+void ConnectionFromClient::start_decoding_image(i32 request_id, Core::AnonymousBuffer const& encoded_buffer, Optional<Gfx::IntSize> const& ideal_size)
+{
+    if (!encoded_buffer.is_valid()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Encoded data is invalid");
+        async_did_decode_image(request_id, false, 0, {}, {});
+        return;
     }
 
-    if (!decoder->frame_count()) {
-        dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
-        return { false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {} };
+    // Without any pool workers, nobody would ever pick the work up.
+    if (Threading::ThreadPool::the().worker_count() == 0) {
+        auto image = decode(ReadonlyBytes { encoded_buffer.data<u8>(), encoded_buffer.size() }, ideal_size);
+        async_did_decode_image(request_id, image.is_animated, image.loop_count, move(image.bitmaps), move(image.durations));
+        return;
     }
 
-    Vector<Gfx::ShareableBitmap> bitmaps;
-    Vector<u32> durations;
-    for (size_t i = 0; i < decoder->frame_count(); ++i) {
-        auto frame_or_error = decoder->frame(i);
-        if (frame_or_error.is_error()) {
-            bitmaps.append(Gfx::ShareableBitmap {});
-            durations.append(0);
-        } else {
-            auto frame = frame_or_error.release_value();
-            bitmaps.append(frame.image->to_shareable_bitmap());
-            durations.append(frame.duration);
-        }
+    // The encoded data is copied, as the buffer is reference counted and must not be shared with another thread.
+    auto encoded_data_or_error = ByteBuffer::copy(encoded_buffer.data<u8>(), encoded_buffer.size());
+    if (encoded_data_or_error.is_error()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "Could not copy encoded data");
+        async_did_decode_image(request_id, false, 0, {}, {});
+        return;
     }
 
-    return { decoder->is_animated(), static_cast<u32>(decoder->loop_count()), bitmaps, durations };
+    // Requests are decoded concurrently on the thread pool, and answered from the main thread in whatever order they finish.
+    // The weak pointer is only dereferenced back on the main thread, since it isn't safe to share between threads either.
+    Threading::ThreadPool::the().submit([connection = make_weak_ptr<ConnectionFromClient>(), event_loop = &Core::EventLoop::current(), request_id, encoded_data = encoded_data_or_error.release_value(), ideal_size]() mutable {
+        auto image = decode(encoded_data, ideal_size);
+        event_loop->deferred_invoke([connection = move(connection), request_id, image = move(image)]() mutable {
+            if (connection)
+                connection->async_did_decode_image(request_id, image.is_animated, image.loop_count, move(image.bitmaps), move(image.durations));
+        });
+    });
 }
 
 }
@@ -27,7 +27,8 @@ public:
 private:
     explicit ConnectionFromClient(NonnullOwnPtr<Core::Stream::LocalSocket>);
 
-    virtual Messages::ImageDecoderServer::DecodeImageResponse decode_image(Core::AnonymousBuffer const&) override;
+    virtual Messages::ImageDecoderServer::DecodeImageResponse decode_image(Core::AnonymousBuffer const&, Optional<Gfx::IntSize> const& ideal_size) override;
+    virtual void start_decoding_image(i32 request_id, Core::AnonymousBuffer const&, Optional<Gfx::IntSize> const& ideal_size) override;
 };
 
 }
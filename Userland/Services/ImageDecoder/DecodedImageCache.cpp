@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Hex.h>
+#include <ImageDecoder/DecodedImageCache.h>
+#include <LibCrypto/Hash/SHA2.h>
+
+namespace ImageDecoder {
+
+DecodedImageCache& DecodedImageCache::the()
+{
+    static DecodedImageCache s_the;
+    return s_the;
+}
+
+String DecodedImageCache::key_for(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size)
+{
+    auto digest = Crypto::Hash::SHA256::hash(encoded_data.data(), encoded_data.size());
+    if (!ideal_size.has_value())
+        return encode_hex(digest.bytes());
+    return String::formatted("{}@{}", encode_hex(digest.bytes()), *ideal_size);
+}
+
+Optional<DecodedImage> DecodedImageCache::find(String const& key)
+{
+    Threading::MutexLocker locker(m_mutex);
+
+    auto it = m_images.find(key);
+    if (it == m_images.end())
+        return {};
+
+    auto& image = *it->value;
+    image.last_used = ++m_use_counter;
+
+    DecodedImage decoded_image { image.is_animated, image.loop_count, {}, image.durations };
+    for (auto const& frame : image.frames)
+        decoded_image.bitmaps.append(frame ? frame->to_shareable_bitmap() : Gfx::ShareableBitmap {});
+
+    dbgln_if(IMAGE_DECODER_DEBUG, "Serving {} decoded frame(s) from the cache", decoded_image.bitmaps.size());
+    return decoded_image;
+}
+
+void DecodedImageCache::add(String const& key, bool is_animated, u32 loop_count, Vector<RefPtr<Gfx::Bitmap>> frames, Vector<u32> durations)
+{
+    size_t size_in_bytes = 0;
+    for (auto const& frame : frames) {
+        if (frame)
+            size_in_bytes += frame->size_in_bytes();
+    }
+    if (size_in_bytes > max_total_size / 4)
+        return;
+
+    auto image = adopt_own(*new CachedImage {
+        .is_animated = is_animated,
+        .loop_count = loop_count,
+        .frames = move(frames),
+        .durations = move(durations),
+        .size_in_bytes = size_in_bytes,
+    });
+
+    Threading::MutexLocker locker(m_mutex);
+
+    // Another thread may have decoded the same image in the meantime.
+    if (m_images.contains(key))
+        return;
+
+    while (!m_images.is_empty() && m_total_size + size_in_bytes > max_total_size)
+        evict_least_recently_used();
+
+    image->last_used = ++m_use_counter;
+    m_total_size += size_in_bytes;
+    m_images.set(key, move(image));
+}
+
+void DecodedImageCache::evict_least_recently_used()
+{
+    auto least_recently_used = m_images.begin();
+    for (auto it = m_images.begin(); it != m_images.end(); ++it) {
+        if (it->value->last_used < least_recently_used->value->last_used)
+            least_recently_used = it;
+    }
+    m_total_size -= least_recently_used->value->size_in_bytes;
+    m_images.remove(least_recently_used);
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/String.h>
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/ShareableBitmap.h>
+#include <LibThreading/Mutex.h>
+
+namespace ImageDecoder {
+
+struct DecodedImage {
+    bool is_animated { false };
+    u32 loop_count { 0 };
+    Vector<Gfx::ShareableBitmap> bitmaps;
+    Vector<u32> durations;
+};
+
+// Keeps the frames of recently decoded images around, so that decoding the same data again only costs a copy.
+// Clients get their own copy of every frame, as they are free to do what they want with them (like making them volatile).
+// The cache is used by all decoding threads; the cached bitmaps are only ever touched with the lock held.
+class DecodedImageCache {
+public:
+    static DecodedImageCache& the();
+
+    // The key identifies the encoded data and the size it was decoded for.
+    static String key_for(ReadonlyBytes encoded_data, Optional<Gfx::IntSize> ideal_size);
+
+    Optional<DecodedImage> find(String const& key);
+    void add(String const& key, bool is_animated, u32 loop_count, Vector<RefPtr<Gfx::Bitmap>> frames, Vector<u32> durations);
+
+private:
+    static constexpr size_t max_total_size = 32 * MiB;
+
+    struct CachedImage {
+        bool is_animated { false };
+        u32 loop_count { 0 };
+        Vector<RefPtr<Gfx::Bitmap>> frames;
+        Vector<u32> durations;
+        size_t size_in_bytes { 0 };
+        u64 last_used { 0 };
+    };
+
+    void evict_least_recently_used();
+
+    Threading::Mutex m_mutex;
+    HashMap<String, NonnullOwnPtr<CachedImage>> m_images;
+    size_t m_total_size { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
@@ -7,17 +7,22 @@
 #include <ImageDecoder/ConnectionFromClient.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/System.h>
+#include <LibGfx/JPGLoader.h>
 #include <LibIPC/SingleServer.h>
 #include <LibMain/Main.h>
+#include <unistd.h>
 
 ErrorOr<int> serenity_main(Main::Arguments)
 {
     Core::EventLoop event_loop;
-    TRY(Core::System::pledge("stdio recvfd sendfd unix"));
+    TRY(Core::System::pledge("stdio recvfd sendfd thread unix"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
+    if (auto processor_count = sysconf(_SC_NPROCESSORS_ONLN); processor_count > 1)
+        Gfx::JPGImageDecoderPlugin::set_decoding_thread_count(processor_count);
+
     auto client = TRY(IPC::take_over_accepted_client_from_system_server<ImageDecoder::ConnectionFromClient>());
 
-    TRY(Core::System::pledge("stdio recvfd sendfd"));
+    TRY(Core::System::pledge("stdio recvfd sendfd thread"));
     return event_loop.exec();
 }
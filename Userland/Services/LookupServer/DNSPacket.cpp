@@ -115,8 +115,9 @@ Optional<DNSPacket> DNSPacket::from_raw_packet(const u8* raw_data, size_t raw_si
     packet.m_query_or_response = header.is_response();
     packet.m_code = header.response_code();
 
-    // FIXME: Should we parse further in this case?
-    if (packet.code() != Code::NOERROR)
+    // NOTE: NXDOMAIN responses are parsed further, since their authority section tells us how long to cache them.
+    // FIXME: Should we parse further in other cases?
+    if (packet.code() != Code::NOERROR && packet.code() != Code::NXDOMAIN)
         return packet;
 
     size_t offset = sizeof(DNSPacketHeader);
@@ -174,6 +175,29 @@ Optional<DNSPacket> DNSPacket::from_raw_packet(const u8* raw_data, size_t raw_si
         offset += record.data_length();
     }
 
+    for (u16 i = 0; i < header.authority_count(); ++i) {
+        auto name = DNSName::parse(raw_data, offset, raw_size);
+        if (offset + sizeof(DNSRecordWithoutName) > raw_size)
+            break;
+
+        auto& record = *(const DNSRecordWithoutName*)(&raw_data[offset]);
+        offset += sizeof(DNSRecordWithoutName);
+
+        if ((DNSRecordType)record.type() == DNSRecordType::SOA) {
+            // The SOA record data is MNAME and RNAME, followed by SERIAL, REFRESH, RETRY, EXPIRE and MINIMUM.
+            size_t soa_offset = offset;
+            DNSName::parse(raw_data, soa_offset, raw_size);
+            DNSName::parse(raw_data, soa_offset, raw_size);
+            if (soa_offset + 5 * sizeof(u32) <= raw_size) {
+                u32 minimum = *(const NetworkOrdered<u32>*)(&raw_data[soa_offset + 4 * sizeof(u32)]);
+                // RFC 2308, section 5: negative answers are cached for the minimum of the SOA's TTL and its MINIMUM field.
+                packet.m_negative_caching_ttl = min(record.ttl(), minimum);
+                dbgln_if(LOOKUPSERVER_DEBUG, "Authority #{}: SOA for _{}_, negative caching TTL={}", i, name, packet.m_negative_caching_ttl.value());
+            }
+        }
+        offset += record.data_length();
+    }
+
     return packet;
 }
 
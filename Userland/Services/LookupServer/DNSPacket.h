@@ -75,6 +75,9 @@ public:
     Code code() const { return (Code)m_code; }
     void set_code(Code code) { m_code = (u8)code; }
 
+    // How long a negative answer (NXDOMAIN or NODATA) may be cached, if the response carried an SOA record.
+    Optional<u32> negative_caching_ttl() const { return m_negative_caching_ttl; }
+
 private:
     u16 m_id { 0 };
     u8 m_code { 0 };
@@ -84,6 +87,7 @@ private:
     bool m_recursion_available { true };
     Vector<DNSQuestion> m_questions;
     Vector<DNSAnswer> m_answers;
+    Optional<u32> m_negative_caching_ttl;
 };
 
 }
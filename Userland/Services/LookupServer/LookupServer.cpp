@@ -7,15 +7,20 @@
 #include "LookupServer.h"
 #include "ConnectionFromClient.h"
 #include "DNSPacket.h"
+#include <AK/AnyOf.h>
 #include <AK/Debug.h>
 #include <AK/HashMap.h>
 #include <AK/Random.h>
+#include <AK/ScopeGuard.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
-#include <LibCore/Stream.h>
+#include <LibCore/SocketAddress.h>
+#include <LibCore/System.h>
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
 #include <time.h>
 #include <unistd.h>
@@ -25,6 +30,13 @@ namespace LookupServer {
 static LookupServer* s_the;
 // NOTE: This is the TTL we return for the hostname or answers from /etc/hosts.
 static constexpr u32 s_static_ttl = 86400;
+static constexpr size_t s_max_cache_entries = 256;
+// RFC 2308, section 5 recommends capping negative caching at somewhere between one and three hours.
+static constexpr u32 s_max_negative_ttl = 3 * 60 * 60;
+// Answers with shorter TTLs aren't worth refreshing ahead of time.
+static constexpr u32 s_min_prefetch_ttl = 30;
+static constexpr int s_upstream_attempts = 3;
+static constexpr int s_upstream_attempt_timeout_ms = 1000;
 
 LookupServer& LookupServer::the()
 {
@@ -124,6 +136,16 @@ void LookupServer::load_etc_hosts()
     }
 }
 
+// Cached answers that are asked for during the last tenth of their lifetime get refreshed in the background,
+// so that names in frequent use don't drop out of the cache.
+static bool is_about_to_expire(DNSAnswer const& answer)
+{
+    if (answer.ttl() < s_min_prefetch_ttl)
+        return false;
+    auto age = time(nullptr) - answer.received_time();
+    return age * 10 >= (time_t)answer.ttl() * 9;
+}
+
 static String get_hostname()
 {
     char buffer[HOST_NAME_MAX];
@@ -169,16 +191,31 @@ ErrorOr<Vector<DNSAnswer>> LookupServer::lookup(const DNSName& name, DNSRecordTy
     }
 
     // Third, try our cache.
-    if (auto cached_answers = m_lookup_cache.find(name); cached_answers != m_lookup_cache.end()) {
-        for (auto& answer : cached_answers->value) {
-            // TODO: Actually remove expired answers from the cache.
-            if (answer.type() == record_type && !answer.has_expired()) {
+    if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end()) {
+        auto& entry = it->value;
+        entry.remove_expired();
+        if (entry.is_empty()) {
+            m_lookup_cache.remove(it);
+        } else {
+            entry.last_used = ++m_cache_use_counter;
+            bool should_prefetch = false;
+            for (auto& answer : entry.answers) {
+                if (answer.type() != record_type)
+                    continue;
                 dbgln_if(LOOKUPSERVER_DEBUG, "Cache hit: {} -> {}", name.as_string(), answer.record_data());
                 add_answer(answer);
+                should_prefetch |= is_about_to_expire(answer);
+            }
+            if (!answers.is_empty()) {
+                if (should_prefetch)
+                    schedule_prefetch(name, record_type);
+                return answers;
+            }
+            if (entry.is_negative_for(record_type)) {
+                dbgln_if(LOOKUPSERVER_DEBUG, "Negative cache hit: {}", name.as_string());
+                return answers;
             }
         }
-        if (!answers.is_empty())
-            return answers;
     }
 
     // Fourth, look up .local names using mDNS instead of DNS nameservers.
@@ -190,38 +227,34 @@ ErrorOr<Vector<DNSAnswer>> LookupServer::lookup(const DNSName& name, DNSRecordTy
     }
 
     // Fifth, ask the upstream nameservers.
-    for (auto& nameserver : m_nameservers) {
-        dbgln_if(LOOKUPSERVER_DEBUG, "Doing lookup using nameserver '{}'", nameserver);
-        bool did_get_response = false;
-        int retries = 3;
-        Vector<DNSAnswer> upstream_answers;
-        do {
-            upstream_answers = TRY(lookup(name, nameserver, did_get_response, record_type));
-            if (did_get_response)
-                break;
-        } while (--retries);
-        if (!upstream_answers.is_empty()) {
-            for (auto& answer : upstream_answers)
-                add_answer(answer);
-            break;
-        } else {
-            if (!did_get_response)
-                dbgln("Never got a response from '{}', trying next nameserver", nameserver);
-            else
-                dbgln("Received response from '{}' but no result(s), trying next nameserver", nameserver);
-        }
-    }
-
-    // Sixth, fail.
-    if (answers.is_empty()) {
-        dbgln("Tried all nameservers but never got a response :(");
-        return Vector<DNSAnswer> {};
-    }
+    auto upstream_answers = TRY(lookup_upstream(name, record_type));
+    for (auto& answer : upstream_answers)
+        add_answer(answer);
 
     return answers;
 }
 
-ErrorOr<Vector<DNSAnswer>> LookupServer::lookup(const DNSName& name, const String& nameserver, bool& did_get_response, DNSRecordType record_type, ShouldRandomizeCase should_randomize_case)
+namespace {
+
+struct UpstreamQuery {
+    String nameserver;
+    int fd { -1 };
+    DNSPacket request;
+    ShouldRandomizeCase should_randomize_case { ShouldRandomizeCase::Yes };
+    bool is_done { false };
+};
+
+enum class UpstreamResponse {
+    Ignored,
+    Retried,
+    Failed,
+    Answered,
+    Negative,
+};
+
+}
+
+static DNSPacket make_request(const DNSName& name, DNSRecordType record_type, ShouldRandomizeCase should_randomize_case)
 {
     DNSPacket request;
     request.set_is_query();
@@ -230,43 +263,42 @@ ErrorOr<Vector<DNSAnswer>> LookupServer::lookup(const DNSName& name, const Strin
     if (should_randomize_case == ShouldRandomizeCase::Yes)
         name_in_question.randomize_case();
     request.add_question({ name_in_question, record_type, DNSRecordClass::IN, false });
+    return request;
+}
 
-    auto buffer = request.to_byte_buffer();
-
-    auto udp_socket = TRY(Core::Stream::UDPSocket::connect(nameserver, 53, Time::from_seconds(1)));
-    TRY(udp_socket->set_blocking(true));
-
-    TRY(udp_socket->write(buffer));
-
-    u8 response_buffer[4096];
-    int nrecv = TRY(udp_socket->read({ response_buffer, sizeof(response_buffer) }));
-    if (udp_socket->is_eof())
-        return Vector<DNSAnswer> {};
-
-    did_get_response = true;
-
-    auto o_response = DNSPacket::from_raw_packet(response_buffer, nrecv);
-    if (!o_response.has_value())
-        return Vector<DNSAnswer> {};
-
-    auto& response = o_response.value();
+static ErrorOr<void> send_request(UpstreamQuery const& query)
+{
+    auto buffer = query.request.to_byte_buffer();
+    TRY(Core::System::send(query.fd, buffer.data(), buffer.size(), 0));
+    return {};
+}
 
+static UpstreamResponse check_response(UpstreamQuery& query, DNSPacket const& response, const DNSName& name, DNSRecordType record_type)
+{
+    auto& request = query.request;
     if (response.id() != request.id()) {
+        // This may be a late response to a request we have since sent again, so keep waiting.
         dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), request.id());
-        return Vector<DNSAnswer> {};
+        return UpstreamResponse::Ignored;
     }
 
     if (response.code() == DNSPacket::Code::REFUSED) {
-        if (should_randomize_case == ShouldRandomizeCase::Yes) {
+        if (query.should_randomize_case == ShouldRandomizeCase::Yes) {
             // Retry with 0x20 case randomization turned off.
-            return lookup(name, nameserver, did_get_response, record_type, ShouldRandomizeCase::No);
+            query.should_randomize_case = ShouldRandomizeCase::No;
+            query.request = make_request(name, record_type, ShouldRandomizeCase::No);
+            if (!send_request(query).is_error())
+                return UpstreamResponse::Retried;
         }
-        return Vector<DNSAnswer> {};
+        return UpstreamResponse::Failed;
     }
 
+    if (response.code() != DNSPacket::Code::NOERROR && response.code() != DNSPacket::Code::NXDOMAIN)
+        return UpstreamResponse::Failed;
+
     if (response.question_count() != request.question_count()) {
         dbgln("LookupServer: Question count ({} vs {}) :(", response.question_count(), request.question_count());
-        return Vector<DNSAnswer> {};
+        return UpstreamResponse::Failed;
     }
 
     // Verify the questions in our request and in their response match exactly, including case.
@@ -280,24 +312,177 @@ ErrorOr<Vector<DNSAnswer>> LookupServer::lookup(const DNSName& name, const Strin
             dbgln("Request and response questions do not match");
             dbgln("   Request: name=_{}_, type={}, class={}", request_question.name().as_string(), response_question.record_type(), response_question.class_code());
             dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            return Vector<DNSAnswer> {};
+            return UpstreamResponse::Failed;
         }
     }
 
-    if (response.answer_count() < 1) {
-        dbgln("LookupServer: No answers :(");
-        return Vector<DNSAnswer> {};
-    }
+    if (response.code() == DNSPacket::Code::NXDOMAIN || response.answer_count() < 1)
+        return UpstreamResponse::Negative;
+
+    return UpstreamResponse::Answered;
+}
+
+ErrorOr<Vector<DNSAnswer>> LookupServer::lookup_upstream(const DNSName& name, DNSRecordType record_type)
+{
+    // Ask all nameservers at once and go with whichever one answers first,
+    // rather than waiting for each unresponsive one to time out in turn.
+    Vector<UpstreamQuery> queries;
+    ScopeGuard close_sockets = [&] {
+        for (auto& query : queries)
+            (void)Core::System::close(query.fd);
+    };
 
-    Vector<DNSAnswer, 8> answers;
-    for (auto& answer : response.answers()) {
-        put_in_cache(answer);
-        if (answer.type() != record_type)
+    for (auto& nameserver : m_nameservers) {
+        auto address = IPv4Address::from_string(nameserver);
+        if (!address.has_value()) {
+            dbgln("LookupServer: Nameserver '{}' is not an IPv4 address, skipping it", nameserver);
+            continue;
+        }
+        auto fd_or_error = Core::System::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+        if (fd_or_error.is_error()) {
+            dbgln("LookupServer: Failed to create socket for nameserver '{}': {}", nameserver, fd_or_error.error());
             continue;
-        answers.append(answer);
+        }
+        queries.append({ nameserver, fd_or_error.value(), make_request(name, record_type, ShouldRandomizeCase::Yes) });
+
+        auto& query = queries.last();
+        auto socket_address = Core::SocketAddress(address.value(), 53).to_sockaddr_in();
+        auto result = Core::System::connect(query.fd, (sockaddr const*)&socket_address, sizeof(socket_address));
+        if (!result.is_error())
+            result = send_request(query);
+        if (result.is_error()) {
+            dbgln("LookupServer: Failed to send request to nameserver '{}': {}", nameserver, result.error());
+            query.is_done = true;
+        }
     }
 
-    return answers;
+    bool did_get_response = false;
+    u8 response_buffer[4096];
+    for (int attempt = 0; attempt < s_upstream_attempts; ++attempt) {
+        if (attempt > 0) {
+            for (auto& query : queries) {
+                if (!query.is_done && send_request(query).is_error())
+                    query.is_done = true;
+            }
+        }
+
+        auto deadline = Time::now_monotonic() + Time::from_milliseconds(s_upstream_attempt_timeout_ms);
+        while (true) {
+            Vector<pollfd> pollfds;
+            Vector<UpstreamQuery&> polled_queries;
+            for (auto& query : queries) {
+                if (query.is_done)
+                    continue;
+                pollfds.append({ query.fd, POLLIN, 0 });
+                polled_queries.append(query);
+            }
+            if (pollfds.is_empty())
+                break;
+
+            auto timeout = (deadline - Time::now_monotonic()).to_milliseconds();
+            if (timeout <= 0)
+                break;
+            int rc = poll(pollfds.data(), pollfds.size(), timeout);
+            if (rc < 0) {
+                if (errno == EINTR)
+                    continue;
+                return Error::from_syscall("poll", -errno);
+            }
+            if (rc == 0)
+                break;
+
+            for (size_t i = 0; i < pollfds.size(); ++i) {
+                if (pollfds[i].revents == 0)
+                    continue;
+                auto& query = polled_queries[i];
+                auto nrecv_or_error = Core::System::recv(query.fd, response_buffer, sizeof(response_buffer), 0);
+                if (nrecv_or_error.is_error()) {
+                    dbgln("LookupServer: Failed to receive response from '{}': {}", query.nameserver, nrecv_or_error.error());
+                    query.is_done = true;
+                    continue;
+                }
+                did_get_response = true;
+
+                auto o_response = DNSPacket::from_raw_packet(response_buffer, nrecv_or_error.value());
+                if (!o_response.has_value())
+                    continue;
+                auto& response = o_response.value();
+
+                switch (check_response(query, response, name, record_type)) {
+                case UpstreamResponse::Ignored:
+                case UpstreamResponse::Retried:
+                    continue;
+                case UpstreamResponse::Failed:
+                    query.is_done = true;
+                    continue;
+                case UpstreamResponse::Negative:
+                    dbgln_if(LOOKUPSERVER_DEBUG, "Nameserver '{}' says there is no {} record for '{}'", query.nameserver, record_type, name.as_string());
+                    if (response.negative_caching_ttl().has_value())
+                        put_negative_in_cache(name, record_type, response.code(), response.negative_caching_ttl().value());
+                    return Vector<DNSAnswer> {};
+                case UpstreamResponse::Answered:
+                    break;
+                }
+
+                Vector<DNSAnswer> answers;
+                for (auto& answer : response.answers()) {
+                    put_in_cache(answer);
+                    if (answer.type() != record_type)
+                        continue;
+                    answers.append(answer);
+                }
+                if (!answers.is_empty()) {
+                    dbgln_if(LOOKUPSERVER_DEBUG, "Got answer for '{}' from nameserver '{}'", name.as_string(), query.nameserver);
+                    return answers;
+                }
+                dbgln("Received response from '{}' but no result(s)", query.nameserver);
+                query.is_done = true;
+            }
+        }
+    }
+
+    if (!did_get_response)
+        dbgln("Tried all nameservers but never got a response :(");
+    else
+        dbgln("Tried all nameservers but none of them had an answer :(");
+    return Vector<DNSAnswer> {};
+}
+
+void LookupServer::CacheEntry::remove_expired()
+{
+    auto now = time(nullptr);
+    answers.remove_all_matching([](auto& answer) { return answer.has_expired(); });
+    if (nonexistent_until.has_value() && now >= nonexistent_until.value())
+        nonexistent_until.clear();
+    no_data.remove_all_matching([&](auto& negative_answer) { return now >= negative_answer.expiry_time; });
+}
+
+bool LookupServer::CacheEntry::is_negative_for(DNSRecordType record_type) const
+{
+    if (nonexistent_until.has_value())
+        return true;
+    return any_of(no_data, [&](auto& negative_answer) { return negative_answer.type == record_type; });
+}
+
+LookupServer::CacheEntry& LookupServer::ensure_cache_entry(const DNSName& name)
+{
+    if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end())
+        return it->value;
+
+    // Prevent the cache from growing too big by evicting the least recently used name.
+    if (m_lookup_cache.size() >= s_max_cache_entries) {
+        auto least_recently_used = m_lookup_cache.begin();
+        for (auto it = m_lookup_cache.begin(); it != m_lookup_cache.end(); ++it) {
+            if (it->value.last_used < least_recently_used->value.last_used)
+                least_recently_used = it;
+        }
+        dbgln_if(LOOKUPSERVER_DEBUG, "Evicting cache entry: {}", least_recently_used->key.as_string());
+        m_lookup_cache.remove(least_recently_used);
+    }
+
+    auto& entry = m_lookup_cache.ensure(name);
+    entry.last_used = ++m_cache_use_counter;
+    return entry;
 }
 
 void LookupServer::put_in_cache(const DNSAnswer& answer)
@@ -305,31 +490,67 @@ void LookupServer::put_in_cache(const DNSAnswer& answer)
     if (answer.has_expired())
         return;
 
-    // Prevent the cache from growing too big.
-    // TODO: Evict least used entries.
-    if (m_lookup_cache.size() >= 256)
-        m_lookup_cache.remove(m_lookup_cache.begin());
+    auto& entry = ensure_cache_entry(answer.name());
+    if (answer.mdns_cache_flush()) {
+        auto now = time(nullptr);
 
-    auto it = m_lookup_cache.find(answer.name());
-    if (it == m_lookup_cache.end())
-        m_lookup_cache.set(answer.name(), { answer });
-    else {
-        if (answer.mdns_cache_flush()) {
-            auto now = time(nullptr);
+        entry.answers.remove_all_matching([&](DNSAnswer const& other_answer) {
+            if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
+                return false;
 
-            it->value.remove_all_matching([&](DNSAnswer const& other_answer) {
-                if (other_answer.type() != answer.type() || other_answer.class_code() != answer.class_code())
-                    return false;
+            if (other_answer.received_time() >= now - 1)
+                return false;
 
-                if (other_answer.received_time() >= now - 1)
-                    return false;
+            dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
+            return true;
+        });
+    }
 
-                dbgln_if(LOOKUPSERVER_DEBUG, "Removing cache entry: {}", other_answer.name());
-                return true;
-            });
-        }
-        it->value.append(answer);
+    // A fresh copy of an answer (e.g. from a prefetch) replaces the old one, and any positive answer overrides negative ones.
+    entry.answers.remove_all_matching([&](DNSAnswer const& other_answer) {
+        return other_answer.type() == answer.type() && other_answer.record_data() == answer.record_data();
+    });
+    entry.answers.append(answer);
+    entry.nonexistent_until.clear();
+    entry.no_data.remove_all_matching([&](auto& negative_answer) { return negative_answer.type == answer.type(); });
+}
+
+void LookupServer::put_negative_in_cache(const DNSName& name, DNSRecordType record_type, DNSPacket::Code code, u32 ttl)
+{
+    ttl = min(ttl, s_max_negative_ttl);
+    if (ttl == 0)
+        return;
+
+    auto& entry = ensure_cache_entry(name);
+    auto expiry_time = time(nullptr) + ttl;
+    if (code == DNSPacket::Code::NXDOMAIN) {
+        entry.answers.clear();
+        entry.no_data.clear();
+        entry.nonexistent_until = expiry_time;
+        return;
     }
+
+    entry.answers.remove_all_matching([&](DNSAnswer const& answer) { return answer.type() == record_type; });
+    entry.no_data.remove_all_matching([&](auto& negative_answer) { return negative_answer.type == record_type; });
+    entry.no_data.append({ record_type, expiry_time });
+}
+
+void LookupServer::schedule_prefetch(const DNSName& name, DNSRecordType record_type)
+{
+    if (name.as_string().ends_with(".local"))
+        return;
+
+    auto key = String::formatted("{}/{}", name.as_string().to_lowercase(), record_type);
+    if (m_pending_prefetches.set(key) != AK::HashSetResult::InsertedNewEntry)
+        return;
+
+    // This runs after the client got its (still valid) answer, so it doesn't have to wait for the refresh.
+    deferred_invoke([this, name, record_type, key = move(key)] {
+        m_pending_prefetches.remove(key);
+        dbgln_if(LOOKUPSERVER_DEBUG, "Prefetching {} record for '{}'", record_type, name.as_string());
+        if (auto result = lookup_upstream(name, record_type); result.is_error())
+            dbgln("LookupServer: Failed to prefetch '{}': {}", name.as_string(), result.error());
+    });
 }
 
 }
@@ -11,6 +11,7 @@
 #include "DNSPacket.h"
 #include "DNSServer.h"
 #include "MulticastDNS.h"
+#include <AK/HashTable.h>
 #include <LibCore/FileWatcher.h>
 #include <LibCore/Object.h>
 #include <LibIPC/MultiServer.h>
@@ -29,10 +30,30 @@ public:
 private:
     LookupServer();
 
+    struct NegativeAnswer {
+        DNSRecordType type;
+        time_t expiry_time;
+    };
+
+    struct CacheEntry {
+        Vector<DNSAnswer> answers;
+        // RFC 2308 negative answers: NXDOMAIN means the name has no records at all, NODATA that it has none of one type.
+        Optional<time_t> nonexistent_until;
+        Vector<NegativeAnswer> no_data;
+        u64 last_used { 0 };
+
+        void remove_expired();
+        bool is_empty() const { return answers.is_empty() && !nonexistent_until.has_value() && no_data.is_empty(); }
+        bool is_negative_for(DNSRecordType) const;
+    };
+
     void load_etc_hosts();
+    CacheEntry& ensure_cache_entry(const DNSName&);
     void put_in_cache(const DNSAnswer&);
+    void put_negative_in_cache(const DNSName&, DNSRecordType, DNSPacket::Code, u32 ttl);
+    void schedule_prefetch(const DNSName&, DNSRecordType);
 
-    ErrorOr<Vector<DNSAnswer>> lookup(const DNSName& hostname, const String& nameserver, bool& did_get_response, DNSRecordType record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
+    ErrorOr<Vector<DNSAnswer>> lookup_upstream(const DNSName&, DNSRecordType);
 
     OwnPtr<IPC::MultiServer<ConnectionFromClient>> m_server;
     RefPtr<DNSServer> m_dns_server;
@@ -40,7 +61,9 @@ private:
     Vector<String> m_nameservers;
     RefPtr<Core::FileWatcher> m_file_watcher;
     HashMap<DNSName, Vector<DNSAnswer>, DNSName::Traits> m_etc_hosts;
-    HashMap<DNSName, Vector<DNSAnswer>, DNSName::Traits> m_lookup_cache;
+    HashMap<DNSName, CacheEntry, DNSName::Traits> m_lookup_cache;
+    u64 m_cache_use_counter { 0 };
+    HashTable<String> m_pending_prefetches;
 };
 
 }
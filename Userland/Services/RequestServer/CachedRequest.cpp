@@ -0,0 +1,23 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <RequestServer/CachedRequest.h>
+
+namespace RequestServer {
+
+CachedRequest::CachedRequest(ConnectionFromClient& client, DiskCache::Entry entry, NonnullOwnPtr<Core::Stream::File>&& output_stream)
+    : Request(client, move(output_stream))
+    , m_url(entry.url)
+{
+    send_cached_response(move(entry));
+}
+
+NonnullOwnPtr<CachedRequest> CachedRequest::create(ConnectionFromClient& client, DiskCache::Entry entry, NonnullOwnPtr<Core::Stream::File>&& output_stream)
+{
+    return adopt_own(*new CachedRequest(client, move(entry), move(output_stream)));
+}
+
+}
@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <LibCore/Forward.h>
+#include <RequestServer/DiskCache.h>
+#include <RequestServer/Request.h>
+
+namespace RequestServer {
+
+// A request that is answered with a response from the DiskCache, without asking the server.
+class CachedRequest final : public Request {
+public:
+    virtual ~CachedRequest() override = default;
+    static NonnullOwnPtr<CachedRequest> create(ConnectionFromClient&, DiskCache::Entry, NonnullOwnPtr<Core::Stream::File>&&);
+
+    virtual URL url() const override { return m_url; }
+
+private:
+    CachedRequest(ConnectionFromClient&, DiskCache::Entry, NonnullOwnPtr<Core::Stream::File>&&);
+
+    URL m_url;
+};
+
+}
@@ -6,12 +6,39 @@
 
 #include "ConnectionCache.h"
 #include <AK/Debug.h>
+#include <LibCore/ConfigFile.h>
 #include <LibCore/EventLoop.h>
 
 namespace RequestServer::ConnectionCache {
 
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket>>>> g_tcp_connection_cache {};
 HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache {};
+HashMap<ConnectionKey, QueueingStatistics> g_queueing_statistics {};
+NonnullRefPtr<TLS::SessionCache> g_tls_session_cache = TLS::SessionCache::create();
+
+size_t g_max_connections_per_host { 4 };
+size_t g_keep_alive_time_milliseconds { 10'000 };
+
+void read_settings()
+{
+    auto config_or_error = Core::ConfigFile::open_for_system("RequestServer");
+    if (config_or_error.is_error()) {
+        dbgln("ConnectionCache: Failed to read settings: {}", config_or_error.error());
+        return;
+    }
+    auto config = config_or_error.release_value();
+    // At least one connection is needed to get anything done at all.
+    g_max_connections_per_host = max(1, config->read_num_entry("Connections", "MaxPerHost", static_cast<int>(g_max_connections_per_host)));
+    g_keep_alive_time_milliseconds = max(0, config->read_num_entry("Connections", "KeepAliveTimeMilliseconds", static_cast<int>(g_keep_alive_time_milliseconds)));
+    dbgln_if(REQUESTSERVER_DEBUG, "ConnectionCache: Up to {} connections per host, kept alive for {}ms", g_max_connections_per_host, g_keep_alive_time_milliseconds);
+}
+
+void QueueingStatistics::did_start_after_waiting(i64 milliseconds)
+{
+    ++started_after_waiting;
+    total_wait_milliseconds += milliseconds;
+    longest_wait_milliseconds = max(longest_wait_milliseconds, milliseconds);
+}
 
 void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
 {
@@ -64,6 +91,7 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
                 connection->timer.start();
                 connection->current_url = url;
                 connection->job_data = connection->request_queue.take_first();
+                g_queueing_statistics.ensure(ConnectionKey { url.host(), url.port_or_default() }).did_start_after_waiting(connection->job_data.queue_timer.elapsed());
                 connection->socket->set_notifications_enabled(true);
                 connection->job_data.start(*connection->socket);
             });
@@ -80,11 +108,23 @@ void request_did_finish(URL const& url, Core::Stream::Socket const* socket)
 
 void dump_jobs()
 {
+    dbgln("=========== Queueing Delays ==========");
+    for (auto& [key, statistics] : g_queueing_statistics) {
+        auto started = statistics.started_immediately + statistics.started_after_waiting;
+        dbgln(" - {}:{}: {} requests, {} of them waited for a connection (longest queue: {})", key.hostname, key.port, started, statistics.started_after_waiting, statistics.longest_queue);
+        if (statistics.started_after_waiting != 0)
+            dbgln("   Waited {}ms on average, {}ms at most", statistics.total_wait_milliseconds / static_cast<i64>(statistics.started_after_waiting), statistics.longest_wait_milliseconds);
+    }
+
     dbgln("=========== TLS Connection Cache ==========");
     for (auto& connection : g_tls_connection_cache) {
         dbgln(" - {}:{}", connection.key.hostname, connection.key.port);
         for (auto& entry : *connection.value) {
             dbgln("  - Connection {} (started={}) (socket={})", &entry, entry.has_started, entry.socket);
+            if (entry.http2_connection) {
+                entry.http2_connection->dump_streams();
+                continue;
+            }
             dbgln("    Currently loading {} ({} elapsed)", entry.current_url, entry.timer.is_valid() ? entry.timer.elapsed() : 0);
             dbgln("    Request Queue:");
             for (auto& job : entry.request_queue)
@@ -16,6 +16,7 @@
 #include <LibCore/EventLoop.h>
 #include <LibCore/NetworkJob.h>
 #include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibTLS/TLSv12.h>
 
 namespace RequestServer {
@@ -35,6 +36,8 @@ struct Connection {
         Function<void(Core::Stream::Socket&)> start {};
         Function<void(Core::NetworkJob::Error)> fail {};
         Function<Vector<TLS::Certificate>()> provide_client_certificates {};
+        // Started when the job has to wait for the connection to become free.
+        Core::ElapsedTimer queue_timer {};
 
         template<typename T>
         static JobData create(T& job)
@@ -65,6 +68,16 @@ struct Connection {
     using QueueType = Vector<JobData>;
     using SocketType = Socket;
 
+    ~Connection()
+    {
+        // Jobs may keep the HTTP/2 connection alive for a bit longer, but the socket goes away with us.
+        if (http2_connection) {
+            http2_connection->on_idle = nullptr;
+            http2_connection->on_close = nullptr;
+            http2_connection->detach();
+        }
+    }
+
     NonnullOwnPtr<Core::Stream::BufferedSocket<Socket>> socket;
     QueueType request_queue;
     NonnullRefPtr<Core::Timer> removal_timer;
@@ -72,6 +85,8 @@ struct Connection {
     URL current_url {};
     Core::ElapsedTimer timer {};
     JobData job_data {};
+    // Set if the server agreed to speak HTTP/2, in which case all jobs share the connection at once instead of queueing up.
+    RefPtr<HTTP::Http2Connection> http2_connection {};
 };
 
 struct ConnectionKey {
@@ -96,11 +111,33 @@ namespace RequestServer::ConnectionCache {
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<Core::Stream::TCPSocket>>>> g_tcp_connection_cache;
 extern HashMap<ConnectionKey, NonnullOwnPtr<NonnullOwnPtrVector<Connection<TLS::TLSv12>>>> g_tls_connection_cache;
 
+// How long jobs had to wait for a connection to a host, to see whether it's worth allowing more connections.
+struct QueueingStatistics {
+    size_t started_immediately { 0 };
+    size_t started_after_waiting { 0 };
+    i64 total_wait_milliseconds { 0 };
+    i64 longest_wait_milliseconds { 0 };
+    size_t longest_queue { 0 };
+
+    void did_start_immediately() { ++started_immediately; }
+    void did_start_after_waiting(i64 milliseconds);
+    void did_enqueue(size_t queue_size) { longest_queue = max(longest_queue, queue_size); }
+};
+
+extern HashMap<ConnectionKey, QueueingStatistics> g_queueing_statistics;
+
+// TLS sessions are shared by all connections to a host, so that only the first one has to do a full handshake.
+extern NonnullRefPtr<TLS::SessionCache> g_tls_session_cache;
+
 void request_did_finish(URL const&, Core::Stream::Socket const*);
 void dump_jobs();
 
-constexpr static size_t MaxConcurrentConnectionsPerURL = 4;
-constexpr static size_t ConnectionKeepAliveTimeMilliseconds = 10'000;
+// How many HTTP/1.1 connections we keep to a host at most, and how long they're kept around when they're unused.
+// These can be changed in the [Connections] group of /etc/RequestServer.ini.
+extern size_t g_max_connections_per_host;
+extern size_t g_keep_alive_time_milliseconds;
+
+void read_settings();
 
 template<typename T>
 ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
@@ -115,6 +152,7 @@ ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
 
         if constexpr (IsSame<TLS::TLSv12, SocketType>) {
             TLS::Options options;
+            options.set_session_cache(g_tls_session_cache);
             options.set_alert_handler([&connection](TLS::AlertDescription alert) {
                 Core::NetworkJob::Error reason;
                 if (alert == TLS::AlertDescription::HandshakeFailure)
@@ -141,18 +179,85 @@ ErrorOr<void> recreate_socket_if_needed(T& connection, URL const& url)
     return {};
 }
 
+template<typename Cache, typename ConnectionType>
+void remove_connection(Cache& cache, ConnectionKey const& key, ConnectionType* connection)
+{
+    auto it = cache.find(key);
+    if (it == cache.end())
+        return;
+    dbgln_if(REQUESTSERVER_DEBUG, "Removing no-longer-used connection {} (socket {})", connection, connection->socket);
+    it->value->remove_first_matching([&](auto& entry) { return entry == connection; });
+    if (it->value->is_empty())
+        cache.remove(key);
+}
+
+template<typename Cache, typename ConnectionType>
+void set_up_http2_connection(Cache& cache, ConnectionKey const& key, ConnectionType& connection)
+{
+    connection.http2_connection = HTTP::Http2Connection::construct(*connection.socket);
+    connection.has_started = true;
+    connection.socket->set_notifications_enabled(true);
+    connection.http2_connection->on_idle = [&cache, key, ptr = &connection] {
+        ptr->removal_timer->on_timeout = [&cache, key, ptr] {
+            // New streams don't stop the timer if they're started as it fires.
+            if (ptr->http2_connection->has_active_streams())
+                return;
+            Core::deferred_invoke([&cache, key, ptr] { remove_connection(cache, key, ptr); });
+        };
+        ptr->removal_timer->start();
+    };
+    connection.http2_connection->on_close = [&cache, key, ptr = &connection] {
+        Core::deferred_invoke([&cache, key, ptr] { remove_connection(cache, key, ptr); });
+    };
+}
+
 decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job)
 {
     using CacheEntryType = RemoveCVReference<decltype(*cache.begin()->value)>;
-    auto& sockets_for_url = *cache.ensure({ url.host(), url.port_or_default() }, [] { return make<CacheEntryType>(); });
+    using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
+    ConnectionKey key { url.host(), url.port_or_default() };
+    auto& sockets_for_url = *cache.ensure(key, [] { return make<CacheEntryType>(); });
 
     using ReturnType = decltype(&sockets_for_url[0]);
-    auto it = sockets_for_url.find_if([](auto& connection) { return connection->request_queue.is_empty(); });
+
+    // HTTP/2 is only ever negotiated for HTTP jobs over TLS, and then any number of them can share a connection.
+    constexpr bool can_use_http2 = IsSame<typename ConnectionType::SocketType, TLS::TLSv12> && requires { job.start(declval<HTTP::Http2Connection&>()); };
+    if constexpr (can_use_http2) {
+        auto http2_it = sockets_for_url.find_if([](auto& connection) { return connection->http2_connection && connection->http2_connection->is_usable(); });
+        if (!http2_it.is_end()) {
+            auto& connection = sockets_for_url[http2_it.index()];
+            dbgln_if(REQUESTSERVER_DEBUG, "Start HTTP/2 stream for url {} in {} - {}", url, &connection, connection.socket);
+            connection.removal_timer->stop();
+            g_queueing_statistics.ensure(key).did_start_immediately();
+            job.start(*connection.http2_connection);
+            return &connection;
+        }
+    }
+
+    auto it = sockets_for_url.find_if([](auto& connection) { return !connection->http2_connection && connection->request_queue.is_empty(); });
     auto did_add_new_connection = false;
     auto failed_to_find_a_socket = it.is_end();
-    if (failed_to_find_a_socket && sockets_for_url.size() < ConnectionCache::MaxConcurrentConnectionsPerURL) {
-        using ConnectionType = RemoveCVReference<decltype(cache.begin()->value->at(0))>;
-        auto connection_result = ConnectionType::SocketType::connect(url.host(), url.port_or_default());
+    // HTTP/2 connections (including ones that are on their way out) don't count, as they can't take HTTP/1.1 jobs.
+    auto http1_connection_count = sockets_for_url.size();
+    for (auto& connection : sockets_for_url) {
+        if (connection.http2_connection)
+            --http1_connection_count;
+    }
+    if (failed_to_find_a_socket && http1_connection_count < g_max_connections_per_host) {
+        auto connection_result = [&] {
+            if constexpr (can_use_http2) {
+                TLS::Options options;
+                options.set_alpn_protocols({ "h2", "http/1.1" });
+                options.set_session_cache(g_tls_session_cache);
+                return ConnectionType::SocketType::connect(url.host(), url.port_or_default(), move(options));
+            } else if constexpr (IsSame<typename ConnectionType::SocketType, TLS::TLSv12>) {
+                TLS::Options options;
+                options.set_session_cache(g_tls_session_cache);
+                return ConnectionType::SocketType::connect(url.host(), url.port_or_default(), move(options));
+            } else {
+                return ConnectionType::SocketType::connect(url.host(), url.port_or_default());
+            }
+        }();
         if (connection_result.is_error()) {
             dbgln("ConnectionCache: Connection to {} failed: {}", url, connection_result.error());
             Core::deferred_invoke([&job] {
@@ -160,6 +265,9 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job)
             });
             return ReturnType { nullptr };
         }
+        bool did_negotiate_http2 = false;
+        if constexpr (can_use_http2)
+            did_negotiate_http2 = connection_result.value()->alpn() == "h2"sv;
         auto socket_result = Core::Stream::BufferedSocket<typename ConnectionType::SocketType>::create(connection_result.release_value());
         if (socket_result.is_error()) {
             dbgln("ConnectionCache: Failed to make a buffered socket for {}: {}", url, socket_result.error());
@@ -171,7 +279,17 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job)
         sockets_for_url.append(make<ConnectionType>(
             socket_result.release_value(),
             typename ConnectionType::QueueType {},
-            Core::Timer::create_single_shot(ConnectionKeepAliveTimeMilliseconds, nullptr)));
+            Core::Timer::create_single_shot(g_keep_alive_time_milliseconds, nullptr)));
+        if constexpr (can_use_http2) {
+            if (did_negotiate_http2) {
+                auto& connection = sockets_for_url.last();
+                dbgln_if(REQUESTSERVER_DEBUG, "Negotiated HTTP/2 with {}, start stream for url {} in {}", url.host(), url, &connection);
+                set_up_http2_connection(cache, key, connection);
+                g_queueing_statistics.ensure(key).did_start_immediately();
+                job.start(*connection.http2_connection);
+                return &connection;
+            }
+        }
         did_add_new_connection = true;
     }
     size_t index;
@@ -183,6 +301,8 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job)
             index = 0;
             auto min_queue_size = (size_t)-1;
             for (auto it = sockets_for_url.begin(); it != sockets_for_url.end(); ++it) {
+                if (it->http2_connection)
+                    continue;
                 if (auto queue_size = it->request_queue.size(); min_queue_size > queue_size) {
                     index = it.index();
                     min_queue_size = queue_size;
@@ -215,10 +335,14 @@ decltype(auto) get_or_create_connection(auto& cache, URL const& url, auto& job)
         connection.current_url = url;
         connection.job_data = decltype(connection.job_data)::create(job);
         connection.socket->set_notifications_enabled(true);
+        g_queueing_statistics.ensure(key).did_start_immediately();
         connection.job_data.start(*connection.socket);
     } else {
         dbgln_if(REQUESTSERVER_DEBUG, "Enqueue request for URL {} in {} - {}", url, &connection, connection.socket);
-        connection.request_queue.append(decltype(connection.job_data)::create(job));
+        auto job_data = decltype(connection.job_data)::create(job);
+        job_data.queue_timer.start();
+        connection.request_queue.append(move(job_data));
+        g_queueing_statistics.ensure(key).did_enqueue(connection.request_queue.size());
     }
     return &connection;
 }
@@ -125,7 +125,7 @@ void ConnectionFromClient::ensure_connection(URL const& url, ::RequestServer::Ca
         });
     }
 
-    struct {
+    struct PreconnectJob {
         URL m_url;
         void start(Core::Stream::Socket& socket)
         {
@@ -133,17 +133,24 @@ void ConnectionFromClient::ensure_connection(URL const& url, ::RequestServer::Ca
             VERIFY(is_connected);
             ConnectionCache::request_did_finish(m_url, &socket);
         }
+        // An HTTP/2 connection is ready for requests once it's there, and is closed again if none come.
+        void start(HTTP::Http2Connection&) { }
         void fail(Core::NetworkJob::Error error)
         {
             dbgln("Pre-connect to {} failed: {}", m_url, Core::to_string(error));
         }
-    } job { url };
+    };
 
     dbgln("EnsureConnection: Pre-connect to {}", url);
     auto do_preconnect = [&](auto& cache) {
         auto it = cache.find({ url.host(), url.port_or_default() });
-        if (it == cache.end() || it->value->is_empty())
-            ConnectionCache::get_or_create_connection(cache, url, job);
+        if (it != cache.end() && !it->value->is_empty())
+            return;
+        // NOTE: The connection cache calls back into the job from deferred invocations (e.g. when connecting fails),
+        //       so it has to stay around until those have run, which they will have by the time this one runs.
+        auto job = make<PreconnectJob>(url);
+        ConnectionCache::get_or_create_connection(cache, url, *job);
+        Core::deferred_invoke([job = move(job)] {});
     };
 
     if (url.scheme() == "http"sv)
@@ -0,0 +1,453 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/GenericLexer.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <AK/StringHash.h>
+#include <AK/Time.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/StandardPaths.h>
+#include <LibCore/System.h>
+#include <RequestServer/DiskCache.h>
+#include <unistd.h>
+
+namespace RequestServer {
+
+static constexpr StringView entry_magic = "RequestServer cache entry 1"sv;
+
+// Heuristic freshness lifetimes are capped, as a response that hasn't changed for years might still change tomorrow.
+static constexpr i64 max_heuristic_freshness_lifetime = 7 * 24 * 60 * 60;
+
+template<typename Headers>
+static Optional<StringView> find_header(Headers const& headers, StringView name)
+{
+    for (auto& it : headers) {
+        if (it.key.equals_ignoring_case(name))
+            return it.value.view();
+    }
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111.html#section-5.2
+// Returns the value of the directive, which is empty for directives without one.
+static Optional<StringView> cache_control_directive(Optional<StringView> cache_control, StringView name)
+{
+    if (!cache_control.has_value())
+        return {};
+    for (auto directive : cache_control->split_view(',')) {
+        directive = directive.trim_whitespace();
+        auto equals_sign = directive.find('=');
+        auto directive_name = directive.substring_view(0, equals_sign.value_or(directive.length())).trim_whitespace();
+        if (!directive_name.equals_ignoring_case(name))
+            continue;
+        if (!equals_sign.has_value())
+            return ""sv;
+        return directive.substring_view(*equals_sign + 1).trim_whitespace().trim("\""sv);
+    }
+    return {};
+}
+
+// https://www.rfc-editor.org/rfc/rfc9110.html#section-5.6.7
+static Optional<time_t> parse_http_date(StringView date)
+{
+    static constexpr Array month_names { "Jan"sv, "Feb"sv, "Mar"sv, "Apr"sv, "May"sv, "Jun"sv, "Jul"sv, "Aug"sv, "Sep"sv, "Oct"sv, "Nov"sv, "Dec"sv };
+
+    // IMF-fixdate ("Sun, 06 Nov 1994 08:49:37 GMT") is what everyone sends, but the obsolete RFC 850 ("Sunday, 06-Nov-94 08:49:37 GMT")
+    // and asctime ("Sun Nov  6 08:49:37 1994") formats have to be understood as well. They all have the same parts, in different orders.
+    auto parts = date.split_view_if([](char ch) { return ch == ' ' || ch == ',' || ch == '-' || ch == ':'; });
+    if (parts.size() < 7)
+        return {};
+
+    auto month_from_name = [&](StringView name) -> Optional<unsigned> {
+        for (size_t i = 0; i < month_names.size(); ++i) {
+            if (name.equals_ignoring_case(month_names[i]))
+                return i + 1;
+        }
+        return {};
+    };
+
+    Optional<unsigned> year, month, day, hour, minute, second;
+    if (month = month_from_name(parts[1]); month.has_value()) {
+        day = parts[2].to_uint();
+        hour = parts[3].to_uint();
+        minute = parts[4].to_uint();
+        second = parts[5].to_uint();
+        year = parts[6].to_uint();
+    } else {
+        day = parts[1].to_uint();
+        month = month_from_name(parts[2]);
+        year = parts[3].to_uint();
+        hour = parts[4].to_uint();
+        minute = parts[5].to_uint();
+        second = parts[6].to_uint();
+    }
+    if (!year.has_value() || !month.has_value() || !day.has_value() || !hour.has_value() || !minute.has_value() || !second.has_value())
+        return {};
+    if (*day < 1 || *day > 31 || *hour > 23 || *minute > 59 || *second > 60)
+        return {};
+    if (*year < 100)
+        *year += *year < 70 ? 2000 : 1900;
+
+    return static_cast<time_t>(days_since_epoch(*year, *month, *day)) * 86400 + *hour * 3600 + *minute * 60 + *second;
+}
+
+static time_t date_value(ResponseHeaders const& headers, time_t response_time)
+{
+    if (auto date = find_header(headers, "Date"sv); date.has_value())
+        return parse_http_date(*date).value_or(response_time);
+    return response_time;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111.html#section-4.2.2
+static bool is_heuristically_cacheable(u32 status_code)
+{
+    switch (status_code) {
+    case 200:
+    case 203:
+    case 204:
+    case 300:
+    case 301:
+    case 308:
+    case 404:
+    case 405:
+    case 410:
+    case 414:
+    case 501:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111.html#section-4.2.1
+static i64 freshness_lifetime(u32 status_code, ResponseHeaders const& headers, time_t response_time)
+{
+    auto cache_control = find_header(headers, "Cache-Control"sv);
+    // NOTE: s-maxage is only for shared caches, which we aren't.
+    if (auto max_age = cache_control_directive(cache_control, "max-age"sv); max_age.has_value())
+        return max_age->to_uint().value_or(0);
+
+    auto date = date_value(headers, response_time);
+    if (auto expires = find_header(headers, "Expires"sv); expires.has_value()) {
+        // Invalid dates (like "0") mean that the response has expired already.
+        auto expiry_date = parse_http_date(*expires);
+        if (!expiry_date.has_value())
+            return 0;
+        return max<i64>(0, *expiry_date - date);
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc9111.html#section-4.2.2
+    if (!is_heuristically_cacheable(status_code) && !cache_control_directive(cache_control, "public"sv).has_value())
+        return 0;
+    if (auto last_modified = find_header(headers, "Last-Modified"sv); last_modified.has_value()) {
+        if (auto last_modified_date = parse_http_date(*last_modified); last_modified_date.has_value())
+            return clamp<i64>((date - *last_modified_date) / 10, 0, max_heuristic_freshness_lifetime);
+    }
+    return 0;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111.html#section-4.2.3
+static i64 current_age(DiskCache::Entry const& entry, time_t now)
+{
+    i64 age_value = 0;
+    if (auto age = find_header(entry.headers, "Age"sv); age.has_value())
+        age_value = age->to_uint().value_or(0);
+
+    i64 apparent_age = max<i64>(0, entry.response_time - date_value(entry.headers, entry.response_time));
+    i64 response_delay = entry.response_time - entry.request_time;
+    i64 corrected_age_value = age_value + response_delay;
+    i64 corrected_initial_age = max(apparent_age, corrected_age_value);
+    i64 resident_time = now - entry.response_time;
+    return corrected_initial_age + resident_time;
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111.html#section-3
+static bool is_storable(u32 status_code, ResponseHeaders const& headers)
+{
+    // NOTE: Partial responses (206) and most redirects aren't heuristically cacheable, and we don't store them at all for now.
+    if (!is_heuristically_cacheable(status_code))
+        return false;
+
+    auto cache_control = find_header(headers, "Cache-Control"sv);
+    if (cache_control_directive(cache_control, "no-store"sv).has_value())
+        return false;
+
+    // Every request for a URL is answered with the same entry, so responses can't vary with anything but Accept-Encoding,
+    // which is always the same for requests made by LibHTTP.
+    if (auto vary = find_header(headers, "Vary"sv); vary.has_value()) {
+        for (auto field : vary->split_view(',')) {
+            if (!field.trim_whitespace().equals_ignoring_case("Accept-Encoding"sv))
+                return false;
+        }
+    }
+
+    // There's no point in keeping a response around that can neither be used as is nor be revalidated.
+    return freshness_lifetime(status_code, headers, time(nullptr)) > 0
+        || find_header(headers, "ETag"sv).has_value()
+        || find_header(headers, "Last-Modified"sv).has_value();
+}
+
+static bool is_conditional_request(HashMap<String, String> const& request_headers)
+{
+    // If the client revalidates a response of its own, it has to get the server's answer, not ours.
+    for (auto& it : request_headers) {
+        if (it.key.starts_with("If-"sv, CaseSensitivity::CaseInsensitive))
+            return true;
+    }
+    return false;
+}
+
+DiskCache& DiskCache::the()
+{
+    static DiskCache s_the;
+    return s_the;
+}
+
+DiskCache::DiskCache()
+{
+    auto directory = String::formatted("{}/.cache/RequestServer", Core::StandardPaths::home_directory());
+    for (auto& path : { LexicalPath::dirname(directory), directory }) {
+        if (auto result = Core::System::mkdir(path, 0700); result.is_error() && result.error().code() != EEXIST) {
+            dbgln("DiskCache: Unable to create {}, not caching anything: {}", path, result.error());
+            return;
+        }
+    }
+    m_directory = move(directory);
+    trim();
+}
+
+bool DiskCache::may_store_response_to_request(HashMap<String, String> const& request_headers)
+{
+    // https://www.rfc-editor.org/rfc/rfc9111.html#section-3.5
+    if (find_header(request_headers, "Authorization"sv).has_value())
+        return false;
+    if (cache_control_directive(find_header(request_headers, "Cache-Control"sv), "no-store"sv).has_value())
+        return false;
+    return !is_conditional_request(request_headers);
+}
+
+bool DiskCache::may_use_stored_response_for_request(HashMap<String, String> const& request_headers)
+{
+    if (!may_store_response_to_request(request_headers))
+        return false;
+
+    // https://www.rfc-editor.org/rfc/rfc9111.html#section-5.2.1
+    auto cache_control = find_header(request_headers, "Cache-Control"sv);
+    if (cache_control.has_value()) {
+        if (cache_control_directive(cache_control, "no-cache"sv).has_value())
+            return false;
+        auto max_age = cache_control_directive(cache_control, "max-age"sv);
+        return !max_age.has_value() || max_age->to_uint().value_or(0) != 0;
+    }
+
+    // https://www.rfc-editor.org/rfc/rfc9111.html#section-5.4
+    auto pragma = find_header(request_headers, "Pragma"sv);
+    return !pragma.has_value() || !pragma->contains("no-cache"sv, CaseSensitivity::CaseInsensitive);
+}
+
+String DiskCache::path_for(URL const& url) const
+{
+    auto url_string = url.serialize(URL::ExcludeFragment::Yes);
+    // NOTE: Two hashes make collisions unlikely, and entries remember their URL so a collision is only a cache miss anyway.
+    return String::formatted("{}/{:08x}{:08x}", m_directory, string_hash(url_string.characters(), url_string.length()), string_hash(url_string.characters(), url_string.length(), 0x9e3779b9));
+}
+
+static Optional<DiskCache::Entry> parse_entry(URL const& url, NonnullRefPtr<Core::MappedFile> file)
+{
+    GenericLexer lexer { StringView { file->bytes() } };
+    auto failed = false;
+    auto consume_line = [&] {
+        auto line = lexer.consume_until('\n');
+        if (!lexer.consume_specific('\n'))
+            failed = true;
+        return line;
+    };
+
+    if (consume_line() != entry_magic)
+        return {};
+    auto url_string = consume_line();
+    auto status_code = consume_line().to_uint();
+    auto request_time = consume_line().to_int<i64>();
+    auto response_time = consume_line().to_int<i64>();
+    auto header_count = consume_line().to_uint();
+    if (failed || url_string != url.serialize(URL::ExcludeFragment::Yes) || !status_code.has_value() || !request_time.has_value() || !response_time.has_value() || !header_count.has_value())
+        return {};
+
+    ResponseHeaders headers;
+    for (size_t i = 0; i < *header_count; ++i) {
+        auto line = consume_line();
+        auto separator = line.find(": "sv);
+        if (failed || !separator.has_value())
+            return {};
+        headers.set(line.substring_view(0, *separator), line.substring_view(*separator + 2));
+    }
+    if (!consume_line().is_empty() || failed)
+        return {};
+
+    auto body = file->bytes().slice(lexer.tell());
+    return DiskCache::Entry { url, *status_code, move(headers), static_cast<time_t>(*request_time), static_cast<time_t>(*response_time), move(file), body };
+}
+
+Optional<DiskCache::Entry> DiskCache::open_entry(URL const& url)
+{
+    if (m_directory.is_null())
+        return {};
+
+    auto file_or_error = Core::MappedFile::map(path_for(url), Core::MappedFile::AccessPattern::Sequential);
+    if (file_or_error.is_error())
+        return {};
+    return parse_entry(url, file_or_error.release_value());
+}
+
+bool DiskCache::is_fresh(Entry const& entry) const
+{
+    if (cache_control_directive(find_header(entry.headers, "Cache-Control"sv), "no-cache"sv).has_value())
+        return false;
+    return freshness_lifetime(entry.status_code, entry.headers, entry.response_time) > current_age(entry, time(nullptr));
+}
+
+bool DiskCache::can_be_revalidated(Entry const& entry)
+{
+    return find_header(entry.headers, "ETag"sv).has_value() || find_header(entry.headers, "Last-Modified"sv).has_value();
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111.html#section-4.3.1
+void DiskCache::add_revalidation_headers(Entry const& entry, HashMap<String, String>& request_headers)
+{
+    if (auto etag = find_header(entry.headers, "ETag"sv); etag.has_value())
+        request_headers.set("If-None-Match", *etag);
+    if (auto last_modified = find_header(entry.headers, "Last-Modified"sv); last_modified.has_value())
+        request_headers.set("If-Modified-Since", *last_modified);
+}
+
+ErrorOr<void> DiskCache::write_entry(URL const& url, u32 status_code, ResponseHeaders const& headers, time_t request_time, time_t response_time, ReadonlyBytes body)
+{
+    StringBuilder builder;
+    builder.appendff("{}\n{}\n{}\n{}\n{}\n", entry_magic, url.serialize(URL::ExcludeFragment::Yes), status_code, request_time, response_time);
+
+    // The cookies a response sets have been taken care of when it was received, they mustn't be set again whenever it is used.
+    auto should_store_header = [](auto& header) {
+        return !header.key.equals_ignoring_case("Set-Cookie"sv) && !header.key.contains('\n') && !header.value.contains('\n');
+    };
+    size_t header_count = 0;
+    for (auto& it : headers) {
+        if (should_store_header(it))
+            ++header_count;
+    }
+    builder.appendff("{}\n", header_count);
+    for (auto& it : headers) {
+        if (should_store_header(it))
+            builder.appendff("{}: {}\n", it.key, it.value);
+    }
+    builder.append('\n');
+
+    auto path = path_for(url);
+    auto temporary_path = String::formatted("{}.tmp{}", path, getpid());
+    auto result = [&]() -> ErrorOr<void> {
+        auto file = TRY(Core::Stream::File::open(temporary_path, Core::Stream::OpenMode::Write | Core::Stream::OpenMode::Truncate, 0600));
+        Array<ReadonlyBytes, 2> buffers { builder.string_view().bytes(), body };
+        TRY(file->write_entire_buffers(buffers));
+        file->close();
+        return Core::System::rename(temporary_path, path);
+    }();
+    if (result.is_error())
+        (void)Core::System::unlink(temporary_path);
+    else
+        m_estimated_size += builder.length() + body.size();
+    return result;
+}
+
+void DiskCache::store(URL const& url, u32 status_code, ResponseHeaders const& headers, time_t request_time, time_t response_time, ReadonlyBytes body)
+{
+    if (m_directory.is_null() || body.size() > max_entry_size || !is_storable(status_code, headers))
+        return;
+
+    if (auto result = write_entry(url, status_code, headers, request_time, response_time, body); result.is_error()) {
+        dbgln("DiskCache: Unable to store response for {}: {}", url, result.error());
+        return;
+    }
+    if (m_estimated_size > max_size)
+        trim();
+}
+
+// https://www.rfc-editor.org/rfc/rfc9111.html#section-4.3.4
+void DiskCache::update_after_revalidation(Entry& entry, ResponseHeaders const& new_headers, time_t request_time, time_t response_time)
+{
+    for (auto& it : new_headers) {
+        // NOTE: Content-Length describes the empty 304 response, not the stored one.
+        if (it.key.equals_ignoring_case("Content-Length"sv))
+            continue;
+        entry.headers.set(it.key, it.value);
+    }
+    entry.request_time = request_time;
+    entry.response_time = response_time;
+
+    if (!is_storable(entry.status_code, entry.headers)) {
+        (void)Core::System::unlink(path_for(entry.url));
+        return;
+    }
+    // NOTE: The entry's file stays mapped (and unchanged) when the updated one is renamed over it, so its body is still good to use.
+    if (auto result = write_entry(entry.url, entry.status_code, entry.headers, request_time, response_time, entry.body); result.is_error())
+        dbgln("DiskCache: Unable to update response for {}: {}", entry.url, result.error());
+}
+
+void DiskCache::trim()
+{
+    struct EntryFile {
+        String path;
+        time_t modification_time { 0 };
+        size_t size { 0 };
+    };
+    Vector<EntryFile> entry_files;
+    size_t total_size = 0;
+
+    Core::DirIterator iterator(m_directory, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto path = iterator.next_full_path();
+        auto stat_or_error = Core::System::stat(path);
+        if (stat_or_error.is_error())
+            continue;
+        auto stat = stat_or_error.release_value();
+        if (path.contains(".tmp"sv)) {
+            // Temporary files that have been around for a while were left behind by a RequestServer that went away while writing them.
+            if (time(nullptr) - stat.st_mtime > 60)
+                (void)Core::System::unlink(path);
+            continue;
+        }
+        entry_files.append({ move(path), stat.st_mtime, static_cast<size_t>(stat.st_size) });
+        total_size += stat.st_size;
+    }
+
+    m_estimated_size = total_size;
+    if (total_size <= max_size)
+        return;
+
+    // Going down to three quarters of the limit means that we don't have to do this again right away.
+    quick_sort(entry_files, [](auto& a, auto& b) { return a.modification_time < b.modification_time; });
+    for (auto& entry_file : entry_files) {
+        if (m_estimated_size <= max_size / 4 * 3)
+            break;
+        if (!Core::System::unlink(entry_file.path).is_error())
+            m_estimated_size -= entry_file.size;
+    }
+}
+
+ErrorOr<size_t> ResponseRecorder::write(ReadonlyBytes bytes)
+{
+    auto written = TRY(m_stream.write(bytes));
+    if (!m_is_too_large) {
+        if (m_recording.size() + written > DiskCache::max_entry_size || m_recording.try_append(bytes.trim(written)).is_error()) {
+            m_is_too_large = true;
+            m_recording.clear();
+        }
+    }
+    return written;
+}
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/URL.h>
+#include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
+#include <time.h>
+
+namespace RequestServer {
+
+using ResponseHeaders = HashMap<String, String, CaseInsensitiveStringTraits>;
+
+// A private HTTP cache (RFC 9111) that is kept on disk, so that it is shared by all RequestServers (there is one per client)
+// and outlives them. Every response is a file of its own, named after a hash of its URL. New files are written under a temporary
+// name and renamed into place, so other RequestServers never see half-written entries, and entries are mapped into memory
+// when they are used.
+class DiskCache {
+public:
+    static constexpr size_t max_entry_size = 8 * MiB;
+    static constexpr size_t max_size = 128 * MiB;
+
+    static DiskCache& the();
+
+    // Null if the cache couldn't be set up, in which case nothing is cached.
+    String const& directory() const { return m_directory; }
+
+    struct Entry {
+        URL url;
+        u32 status_code { 0 };
+        ResponseHeaders headers;
+        time_t request_time { 0 };
+        time_t response_time { 0 };
+        NonnullRefPtr<Core::MappedFile> file;
+        ReadonlyBytes body;
+    };
+
+    // Whether the response to a GET request with these headers may be stored, and whether it may be answered from the cache.
+    static bool may_store_response_to_request(HashMap<String, String> const& request_headers);
+    static bool may_use_stored_response_for_request(HashMap<String, String> const& request_headers);
+
+    Optional<Entry> open_entry(URL const&);
+    bool is_fresh(Entry const&) const;
+    static bool can_be_revalidated(Entry const&);
+    static void add_revalidation_headers(Entry const&, HashMap<String, String>& request_headers);
+
+    void store(URL const&, u32 status_code, ResponseHeaders const&, time_t request_time, time_t response_time, ReadonlyBytes body);
+    void update_after_revalidation(Entry&, ResponseHeaders const& new_headers, time_t request_time, time_t response_time);
+
+private:
+    DiskCache();
+
+    String path_for(URL const&) const;
+    ErrorOr<void> write_entry(URL const&, u32 status_code, ResponseHeaders const&, time_t request_time, time_t response_time, ReadonlyBytes body);
+    // Removes the oldest entries if the cache has grown too big.
+    void trim();
+
+    String m_directory;
+    // How much we think the cache takes up; other RequestServers add to it as well, so it's only checked against the disk now and then.
+    size_t m_estimated_size { 0 };
+};
+
+// Passes everything that's written to it on to another stream, keeping a copy of it for the cache.
+class ResponseRecorder final : public Core::Stream::Stream {
+public:
+    explicit ResponseRecorder(Core::Stream::Stream& stream)
+        : m_stream(stream)
+    {
+    }
+
+    virtual bool is_readable() const override { return m_stream.is_readable(); }
+    virtual ErrorOr<size_t> read(Bytes bytes) override { return m_stream.read(bytes); }
+    virtual bool is_writable() const override { return m_stream.is_writable(); }
+    virtual ErrorOr<size_t> write(ReadonlyBytes) override;
+    virtual bool is_eof() const override { return m_stream.is_eof(); }
+    virtual bool is_open() const override { return m_stream.is_open(); }
+    virtual void close() override { m_stream.close(); }
+
+    // The recording is given up on once it gets too big for the cache.
+    bool has_complete_recording() const { return !m_is_too_large; }
+    ReadonlyBytes recording() const { return m_recording.bytes(); }
+
+private:
+    Core::Stream::Stream& m_stream;
+    ByteBuffer m_recording;
+    bool m_is_too_large { false };
+};
+
+}
@@ -8,7 +8,9 @@
 
 namespace RequestServer {
 
+class CachedRequest;
 class ConnectionFromClient;
+class DiskCache;
 class Request;
 class GeminiProtocol;
 class HttpRequest;
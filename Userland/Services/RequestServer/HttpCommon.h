@@ -14,9 +14,12 @@
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibHTTP/HttpRequest.h>
+#include <RequestServer/CachedRequest.h>
 #include <RequestServer/ConnectionCache.h>
 #include <RequestServer/ConnectionFromClient.h>
+#include <RequestServer/DiskCache.h>
 #include <RequestServer/Request.h>
+#include <time.h>
 
 namespace RequestServer::Detail {
 
@@ -24,15 +27,22 @@ template<typename TSelf, typename TJob>
 void init(TSelf* self, TJob job)
 {
     job->on_headers_received = [self](auto& headers, auto response_code) {
+        if (self->did_receive_headers_for_revalidation(headers, response_code))
+            return;
         if (response_code.has_value())
             self->set_status_code(response_code.value());
         self->set_response_headers(headers);
     };
 
     job->on_finish = [self](bool success) {
-        Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
-            ConnectionCache::request_did_finish(url, socket);
-        });
+        // HTTP/2 streams don't hold on to their connection, so there's no next job to hand it to.
+        if (!self->job().is_using_http2()) {
+            Core::deferred_invoke([url = self->job().url(), socket = self->job().socket()] {
+                ConnectionCache::request_did_finish(url, socket);
+            });
+        }
+        if (self->has_revalidated_response())
+            return self->finish_with_revalidated_response(success);
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
@@ -76,7 +86,26 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     else
         request.set_method(HTTP::HttpRequest::Method::GET);
     request.set_url(url);
-    request.set_headers(headers);
+
+    auto request_time = time(nullptr);
+    bool may_store_response = request.method() == HTTP::HttpRequest::Method::GET && DiskCache::may_store_response_to_request(headers);
+    Optional<DiskCache::Entry> response_to_revalidate;
+    auto request_headers = headers;
+    if (may_store_response && DiskCache::may_use_stored_response_for_request(headers)) {
+        if (auto entry = DiskCache::the().open_entry(url); entry.has_value()) {
+            if (DiskCache::the().is_fresh(*entry)) {
+                auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
+                auto cached_request = CachedRequest::create(client, entry.release_value(), move(output_stream));
+                cached_request->set_request_fd(pipe_result.value().read_fd);
+                return cached_request;
+            }
+            if (DiskCache::can_be_revalidated(*entry)) {
+                DiskCache::add_revalidation_headers(*entry, request_headers);
+                response_to_revalidate = entry.release_value();
+            }
+        }
+    }
+    request.set_headers(request_headers);
 
     auto allocated_body_result = ByteBuffer::copy(body);
     if (allocated_body_result.is_error())
@@ -84,9 +113,17 @@ OwnPtr<Request> start_request(TBadgedProtocol&& protocol, ConnectionFromClient&
     request.set_body(allocated_body_result.release_value());
 
     auto output_stream = MUST(Core::Stream::File::adopt_fd(pipe_result.value().write_fd, Core::Stream::OpenMode::Write));
-    auto job = TJob::construct(move(request), *output_stream);
+    OwnPtr<ResponseRecorder> response_recorder;
+    if (may_store_response)
+        response_recorder = make<ResponseRecorder>(*output_stream);
+    Core::Stream::Stream& job_output_stream = response_recorder ? static_cast<Core::Stream::Stream&>(*response_recorder) : *output_stream;
+    auto job = TJob::construct(move(request), job_output_stream);
     auto protocol_request = TRequest::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     protocol_request->set_request_fd(pipe_result.value().read_fd);
+    if (response_recorder)
+        protocol_request->set_response_recorder(response_recorder.release_nonnull(), request_time);
+    if (response_to_revalidate.has_value())
+        protocol_request->set_response_to_revalidate(response_to_revalidate.release_value());
 
     if constexpr (IsSame<typename TBadgedProtocol::Type, HttpsProtocol>)
         ConnectionCache::get_or_create_connection(ConnectionCache::g_tls_connection_cache, url, *job);
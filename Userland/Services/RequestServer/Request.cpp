@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/Notifier.h>
 #include <RequestServer/ConnectionFromClient.h>
 #include <RequestServer/Request.h>
 
@@ -40,6 +41,8 @@ void Request::set_certificate(String, String)
 
 void Request::did_finish(bool success)
 {
+    if (success && m_response_recorder && !m_cached_response.has_value() && m_status_code.has_value() && m_response_recorder->has_complete_recording())
+        DiskCache::the().store(url(), *m_status_code, m_response_headers, m_request_time, time(nullptr), m_response_recorder->recording());
     m_client.did_finish_request({}, *this, success);
 }
 
@@ -55,4 +58,91 @@ void Request::did_request_certificates()
     m_client.did_request_certificates({}, *this);
 }
 
+void Request::set_response_recorder(NonnullOwnPtr<ResponseRecorder> recorder, time_t request_time)
+{
+    m_response_recorder = move(recorder);
+    m_request_time = request_time;
+}
+
+void Request::set_response_to_revalidate(DiskCache::Entry entry)
+{
+    m_cached_response = move(entry);
+}
+
+bool Request::did_receive_headers_for_revalidation(ResponseHeaders const& headers, Optional<u32> response_code)
+{
+    if (!m_cached_response.has_value())
+        return false;
+
+    if (response_code.has_value() && *response_code != 304) {
+        // The response has changed, and the new one takes the place of the stored one.
+        m_cached_response.clear();
+        m_has_revalidated_response = false;
+        return false;
+    }
+    if (response_code == 304u)
+        m_has_revalidated_response = true;
+    if (!m_has_revalidated_response)
+        return false;
+
+    for (auto& it : headers)
+        m_revalidation_headers.set(it.key, it.value);
+    return true;
+}
+
+void Request::finish_with_revalidated_response(bool success)
+{
+    VERIFY(m_has_revalidated_response);
+    if (!success)
+        return did_finish(false);
+
+    auto response = m_cached_response.release_value();
+    DiskCache::the().update_after_revalidation(response, m_revalidation_headers, m_request_time, time(nullptr));
+    send_cached_response(move(response));
+}
+
+void Request::send_cached_response(DiskCache::Entry response)
+{
+    m_cached_response = move(response);
+
+    // NOTE: Nothing is sent right away, as the client might not even know about this request yet.
+    m_cached_response_notifier = Core::Notifier::construct(m_output_stream->fd(), Core::Notifier::Event::Write);
+    m_cached_response_notifier->on_ready_to_write = [this] {
+        // Finishing the request destroys the notifier, which mustn't happen while it's calling us.
+        m_cached_response_notifier->set_enabled(false);
+        m_cached_response_notifier->deferred_invoke([this] { send_cached_response_body(); });
+    };
+}
+
+void Request::send_cached_response_body()
+{
+    auto& response = *m_cached_response;
+    if (!m_has_sent_cached_response_headers) {
+        m_has_sent_cached_response_headers = true;
+        set_status_code(response.status_code);
+        set_response_headers(response.headers);
+    }
+
+    while (m_sent_cached_response_size < response.body.size()) {
+        auto result = m_output_stream->write(response.body.slice(m_sent_cached_response_size));
+        if (result.is_error()) {
+            if (result.error().is_errno() && result.error().code() == EINTR)
+                continue;
+            if (result.error().is_errno() && result.error().code() == EAGAIN) {
+                // The client hasn't caught up yet, carry on once the pipe has room again.
+                m_cached_response_notifier->set_enabled(true);
+                return;
+            }
+            dbgln("Request: Failed to send cached response for {}: {}", url(), result.error());
+            return did_finish(false);
+        }
+        m_sent_cached_response_size += result.value();
+    }
+
+    auto size = static_cast<u32>(response.body.size());
+    set_downloaded_size(size);
+    did_progress(size, size);
+    did_finish(true);
+}
+
 }
@@ -12,6 +12,8 @@
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/URL.h>
+#include <LibCore/Forward.h>
+#include <RequestServer/DiskCache.h>
 #include <RequestServer/Forward.h>
 
 namespace RequestServer {
@@ -43,10 +45,24 @@ public:
     void set_downloaded_size(size_t size) { m_downloaded_size = size; }
     const Core::Stream::File& output_stream() const { return *m_output_stream; }
 
+    // The response is recorded as it is received, and stored in the DiskCache once it's complete.
+    void set_response_recorder(NonnullOwnPtr<ResponseRecorder>, time_t request_time);
+
+    // A stored response that's sent instead of the server's if the server says that it hasn't changed.
+    void set_response_to_revalidate(DiskCache::Entry);
+    // Returns whether the headers confirm the response that's being revalidated, in which case they aren't passed on.
+    bool did_receive_headers_for_revalidation(ResponseHeaders const&, Optional<u32> response_code);
+    bool has_revalidated_response() const { return m_has_revalidated_response; }
+    void finish_with_revalidated_response(bool success);
+
 protected:
     explicit Request(ConnectionFromClient&, NonnullOwnPtr<Core::Stream::File>&&);
 
+    void send_cached_response(DiskCache::Entry);
+
 private:
+    void send_cached_response_body();
+
     ConnectionFromClient& m_client;
     i32 m_id { 0 };
     int m_request_fd { -1 }; // Passed to client.
@@ -55,6 +71,15 @@ private:
     size_t m_downloaded_size { 0 };
     NonnullOwnPtr<Core::Stream::File> m_output_stream;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
+
+    OwnPtr<ResponseRecorder> m_response_recorder;
+    time_t m_request_time { 0 };
+    Optional<DiskCache::Entry> m_cached_response;
+    ResponseHeaders m_revalidation_headers;
+    bool m_has_revalidated_response { false };
+    bool m_has_sent_cached_response_headers { false };
+    size_t m_sent_cached_response_size { 0 };
+    RefPtr<Core::Notifier> m_cached_response_notifier;
 };
 
 }
@@ -81,4 +81,14 @@ void ConnectionFromClient::statement_execute(int statement_id)
     }
 }
 
+void ConnectionFromClient::statement_fetch(int statement_id)
+{
+    dbgln_if(SQLSERVER_DEBUG, "ConnectionFromClient::statement_fetch(statement_id: {})", statement_id);
+    auto statement = SQLStatement::statement_for(statement_id);
+    if (statement && statement->connection()->client_id() == client_id())
+        statement->fetch();
+    else
+        dbgln_if(SQLSERVER_DEBUG, "Statement has disappeared");
+}
+
 }
@@ -67,6 +67,22 @@ void DatabaseConnection::disconnect()
     });
 }
 
+// Committing means waiting for the log to hit the disk, so rather than doing that for every statement, all statements
+// that were executed up to the next turn of the event loop are committed together.
+void DatabaseConnection::schedule_commit()
+{
+    if (m_is_commit_scheduled)
+        return;
+    m_is_commit_scheduled = true;
+    deferred_invoke([this]() {
+        m_is_commit_scheduled = false;
+        if (!m_database)
+            return;
+        if (auto maybe_error = m_database->commit(); maybe_error.is_error())
+            warnln("DatabaseConnection({}): Could not commit: {}", m_database_name, maybe_error.error());
+    });
+}
+
 int DatabaseConnection::sql_statement(String const& sql)
 {
     dbgln_if(SQLSERVER_DEBUG, "DatabaseConnection::sql_statement(connection_id {}, database '{}', sql '{}'", connection_id(), m_database_name, sql);
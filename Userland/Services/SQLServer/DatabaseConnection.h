@@ -24,6 +24,7 @@ public:
     RefPtr<SQL::Database> database() { return m_database; }
     void disconnect();
     int sql_statement(String const& sql);
+    void schedule_commit();
 
 private:
     DatabaseConnection(String database_name, int client_id);
@@ -33,6 +34,7 @@ private:
     int m_connection_id;
     int m_client_id;
     bool m_accept_statements { false };
+    bool m_is_commit_scheduled { false };
 };
 
 }
@@ -82,11 +82,15 @@ void SQLStatement::execute()
         }
 
         m_result = execution_result.release_value();
+        if (m_result->command() != SQL::SQLCommand::Select && m_result->command() != SQL::SQLCommand::Describe)
+            connection()->schedule_commit();
 
         if (should_send_result_rows()) {
             client_connection->async_execution_success(statement_id(), true, 0, 0, 0);
             m_index = 0;
-            next();
+            // The client asks for another batch whenever it gets one, so this keeps one batch ahead of it.
+            send_next_batch();
+            send_next_batch();
         } else {
             client_connection->async_execution_success(statement_id(), false, 0, m_result->size(), 0);
         }
@@ -119,22 +123,34 @@ bool SQLStatement::should_send_result_rows() const
     }
 }
 
-void SQLStatement::next()
+void SQLStatement::fetch()
 {
-    VERIFY(!m_result->is_empty());
+    dbgln_if(SQLSERVER_DEBUG, "SQLStatement::fetch(statement_id {})", statement_id());
+    send_next_batch();
+}
+
+void SQLStatement::send_next_batch()
+{
+    // All rows have been sent already, the client asks for more until it knows that.
+    if (!m_result.has_value())
+        return;
+
     auto client_connection = ConnectionFromClient::client_connection_for(connection()->client_id());
     if (!client_connection) {
         warnln("Cannot yield next result. Client disconnected");
         return;
     }
-    if (m_index < m_result->size()) {
-        auto& tuple = m_result->at(m_index++).row;
-        client_connection->async_next_result(statement_id(), tuple.to_string_vector());
-        deferred_invoke([this]() {
-            next();
-        });
-    } else {
+
+    auto batch_end = min(m_index + RESULT_BATCH_SIZE, m_result->size());
+    Vector<Vector<String>> rows;
+    rows.ensure_capacity(batch_end - m_index);
+    for (; m_index < batch_end; ++m_index)
+        rows.unchecked_append(m_result->at(m_index).row.to_string_vector());
+    client_connection->async_next_results(statement_id(), move(rows));
+
+    if (m_index == m_result->size()) {
         client_connection->async_results_exhausted(statement_id(), (int)m_index);
+        m_result = {};
     }
 }
 
@@ -17,6 +17,9 @@
 
 namespace SQLServer {
 
+// Result rows are sent to the client this many at a time.
+constexpr static size_t RESULT_BATCH_SIZE = 64;
+
 class SQLStatement final : public Core::Object {
     C_OBJECT(SQLStatement)
 
@@ -28,12 +31,13 @@ public:
     String const& sql() const { return m_sql; }
     DatabaseConnection* connection() { return dynamic_cast<DatabaseConnection*>(parent()); }
     void execute();
+    void fetch();
 
 private:
     SQLStatement(DatabaseConnection&, String sql);
     SQL::ResultOr<void> parse();
     bool should_send_result_rows() const;
-    void next();
+    void send_next_batch();
     void report_error(SQL::Result);
 
     int m_statement_id;
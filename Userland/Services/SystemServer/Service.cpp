@@ -10,6 +10,7 @@
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
 #include <AK/StringBuilder.h>
+#include <AK/Time.h>
 #include <LibCore/ConfigFile.h>
 #include <LibCore/File.h>
 #include <LibCore/SocketAddress.h>
@@ -146,9 +147,9 @@ void Service::spawn(int socket_fd)
 
         struct sched_param p;
         p.sched_priority = m_priority;
-        int rc = sched_setparam(0, &p);
+        int rc = sched_setscheduler(0, m_scheduling_policy, &p);
         if (rc < 0) {
-            perror("sched_setparam");
+            perror("sched_setscheduler");
             VERIFY_NOT_REACHED();
         }
 
@@ -231,6 +232,8 @@ void Service::spawn(int socket_fd)
         VERIFY_NOT_REACHED();
     } else if (!m_multi_instance) {
         // We are the parent.
+        // NOTE: The monotonic clock starts at boot, so this gives us a boot timeline.
+        dbgln("Spawned {} as PID {}, {}ms after boot", name(), pid, Time::now_monotonic().to_milliseconds());
         m_pid = pid;
         s_service_map.set(pid, this);
     }
@@ -287,7 +290,10 @@ Service::Service(const Core::ConfigFile& config, StringView name)
         m_priority = 30;
     else if (prio == "high")
         m_priority = 50;
-    else
+    else if (prio == "realtime") {
+        m_scheduling_policy = SCHED_RR;
+        m_priority = 50;
+    } else
         VERIFY_NOT_REACHED();
 
     m_keep_alive = config.read_bool_entry(name, "KeepAlive");
@@ -305,6 +311,7 @@ Service::Service(const Core::ConfigFile& config, StringView name)
     m_working_directory = config.read_entry(name, "WorkingDirectory");
     m_environment = config.read_entry(name, "Environment").split(' ');
     m_system_modes = config.read_entry(name, "SystemModes", "graphical").split(',');
+    m_after = config.read_entry(name, "After", "").split(',');
     m_multi_instance = config.read_bool_entry(name, "MultiInstance");
     m_accept_socket_connections = config.read_bool_entry(name, "AcceptSocketConnections");
 
@@ -12,6 +12,7 @@
 #include <LibCore/ElapsedTimer.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
+#include <sched.h>
 
 class Service final : public Core::Object {
     C_OBJECT(Service)
@@ -23,6 +24,8 @@ public:
 
     static Service* find_by_pid(pid_t);
 
+    Vector<String> const& after() const { return m_after; }
+
     // FIXME: Port to Core::Property
     void save_to(JsonObject&);
 
@@ -49,6 +52,7 @@ private:
     // File path to open as stdio fds.
     String m_stdio_file_path;
     int m_priority { 1 };
+    int m_scheduling_policy { SCHED_OTHER };
     // Whether we should re-launch it if it exits.
     bool m_keep_alive { false };
     // Whether we should accept connections on the socket and pass the accepted
@@ -67,6 +71,8 @@ private:
     bool m_multi_instance { false };
     // Environment variables to pass to the service.
     Vector<String> m_environment;
+    // Services that have to be activated before this one.
+    Vector<String> m_after;
     // Socket descriptors for this service.
     Vector<SocketDescriptor> m_sockets;
 
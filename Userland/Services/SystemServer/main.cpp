@@ -9,6 +9,9 @@
 #include <AK/Assertions.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Debug.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtrVector.h>
 #include <Kernel/API/DeviceEvent.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
@@ -466,6 +469,49 @@ static ErrorOr<void> create_tmp_coredump_directory()
     return {};
 }
 
+// Orders the services so that each one comes after the services named in its After= key, and keeps the config order otherwise.
+// Activating a service doesn't wait for it, so everything that doesn't depend on something else still starts right away.
+static NonnullRefPtrVector<Service> order_services_by_dependencies(NonnullRefPtrVector<Service>& services)
+{
+    HashMap<String, Service*> services_by_name;
+    for (auto& service : services)
+        services_by_name.set(service.name(), &service);
+
+    enum class State {
+        Unvisited,
+        Visiting,
+        Done,
+    };
+    HashMap<Service*, State> states;
+    NonnullRefPtrVector<Service> ordered_services;
+    ordered_services.ensure_capacity(services.size());
+
+    Function<void(Service&)> visit = [&](Service& service) {
+        auto state = states.get(&service).value_or(State::Unvisited);
+        if (state == State::Done)
+            return;
+        if (state == State::Visiting) {
+            dbgln("Service {} is part of a dependency cycle, ignoring the rest of it", service.name());
+            return;
+        }
+        states.set(&service, State::Visiting);
+        for (auto& dependency_name : service.after()) {
+            auto dependency = services_by_name.get(dependency_name);
+            if (!dependency.has_value()) {
+                dbgln("Service {} wants to start after {}, which isn't an enabled service", service.name(), dependency_name);
+                continue;
+            }
+            visit(*dependency.value());
+        }
+        states.set(&service, State::Done);
+        ordered_services.append(service);
+    };
+
+    for (auto& service : services)
+        visit(service);
+    return ordered_services;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     bool user = false;
@@ -503,7 +549,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     // After we've set them all up, activate them!
     dbgln("Activating {} services...", services.size());
-    for (auto& service : services)
+    for (auto& service : order_services_by_dependencies(services))
         service.activate();
 
     return event_loop.exec();
@@ -17,6 +17,7 @@ namespace WebContent {
 ConsoleGlobalObject::ConsoleGlobalObject(Web::Bindings::WindowObject& parent_object)
     : m_window_object(&parent_object)
 {
+    set_may_interfere_with_property_lookup_caching();
 }
 
 ConsoleGlobalObject::~ConsoleGlobalObject()
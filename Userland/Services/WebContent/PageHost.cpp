@@ -10,6 +10,7 @@
 #include <LibGfx/ShareableBitmap.h>
 #include <LibGfx/SystemTheme.h>
 #include <LibWeb/Cookie/ParsedCookie.h>
+#include <LibWeb/DOM/Document.h>
 #include <LibWeb/HTML/BrowsingContext.h>
 #include <LibWeb/Layout/InitialContainingBlock.h>
 #include <LibWeb/Painting/PaintableBox.h>
@@ -26,6 +27,9 @@ PageHost::PageHost(ConnectionFromClient& client)
         m_client.async_did_invalidate_content_rect(m_invalidation_rect);
         m_invalidation_rect = {};
     });
+    m_tile_preparation_timer = Core::Timer::create_single_shot(0, [this] {
+        prepare_next_tile();
+    });
 }
 
 PageHost::~PageHost()
@@ -35,6 +39,13 @@ PageHost::~PageHost()
 void PageHost::set_has_focus(bool has_focus)
 {
     m_has_focus = has_focus;
+    m_tiles_are_stale = true;
+}
+
+void PageHost::set_should_show_line_box_borders(bool should_show_line_box_borders)
+{
+    m_should_show_line_box_borders = should_show_line_box_borders;
+    m_tiles_are_stale = true;
 }
 
 void PageHost::setup_palette()
@@ -57,6 +68,7 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(const Gfx::PaletteImpl& impl)
 {
     m_palette_impl = impl;
+    m_tiles_are_stale = true;
 }
 
 void PageHost::set_preferred_color_scheme(Web::CSS::PreferredColorScheme color_scheme)
@@ -74,6 +86,75 @@ Web::Layout::InitialContainingBlock* PageHost::layout_root()
     return document->layout_node();
 }
 
+// Whether anything on the page is painted relative to the viewport instead of the content, and so moves around when scrolling.
+static bool paint_depends_on_scroll_position(Web::Layout::InitialContainingBlock const& layout_root)
+{
+    bool depends_on_scroll_position = false;
+    layout_root.for_each_in_inclusive_subtree_of_type<Web::Layout::Box>([&](auto& box) {
+        if (box.is_fixed_position()) {
+            depends_on_scroll_position = true;
+            return IterationDecision::Break;
+        }
+        // NOTE: The root element's background covers the whole viewport, so only a plain color looks the same everywhere.
+        if (box.is_root_element()) {
+            auto const* document_background_layers = box.document().background_layers();
+            if (!box.computed_values().background_layers().is_empty() || (document_background_layers && !document_background_layers->is_empty())) {
+                depends_on_scroll_position = true;
+                return IterationDecision::Break;
+            }
+        }
+        return IterationDecision::Continue;
+    });
+    return depends_on_scroll_position;
+}
+
+Vector<Gfx::IntPoint> PageHost::tiles_intersecting(Gfx::IntRect const& content_rect)
+{
+    Vector<Gfx::IntPoint> tiles;
+    if (content_rect.is_empty())
+        return tiles;
+    auto first_column = max(content_rect.left(), 0) / tile_size;
+    auto first_row = max(content_rect.top(), 0) / tile_size;
+    for (auto row = first_row; row <= content_rect.bottom() / tile_size; ++row) {
+        for (auto column = first_column; column <= content_rect.right() / tile_size; ++column)
+            tiles.append({ column, row });
+    }
+    return tiles;
+}
+
+void PageHost::paint_into(Gfx::Painter& painter, Gfx::IntRect const& content_rect, Web::Layout::InitialContainingBlock& layout_root)
+{
+    Web::PaintContext context(painter, palette(), m_last_painted_content_rect.top_left());
+    context.set_should_show_line_box_borders(m_should_show_line_box_borders);
+    context.set_viewport_rect(content_rect);
+    context.set_has_focus(m_has_focus);
+    layout_root.paint_all_phases(context);
+}
+
+Gfx::Bitmap* PageHost::ensure_tile(Gfx::IntPoint const& tile_index, Web::Layout::InitialContainingBlock& layout_root)
+{
+    if (auto it = m_tiles.find(tile_index); it != m_tiles.end())
+        return it->value.ptr();
+
+    auto bitmap_or_error = Gfx::Bitmap::try_create(Gfx::BitmapFormat::BGRx8888, { tile_size, tile_size });
+    if (bitmap_or_error.is_error())
+        return nullptr;
+    auto bitmap = bitmap_or_error.release_value();
+
+    Gfx::Painter painter(*bitmap);
+    painter.fill_rect(bitmap->rect(), palette().base());
+    paint_into(painter, rect_for_tile(tile_index), layout_root);
+    m_tiles.set(tile_index, bitmap);
+    return bitmap.ptr();
+}
+
+void PageHost::discard_tiles_outside(Gfx::IntRect const& content_rect)
+{
+    m_tiles.remove_all_matching([&](auto& tile_index, auto&) {
+        return !rect_for_tile(tile_index).intersects(content_rect);
+    });
+}
+
 void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
 {
     Gfx::Painter painter(target);
@@ -85,14 +166,61 @@ void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
     auto* layout_root = this->layout_root();
     if (!layout_root) {
         painter.fill_rect(bitmap_rect, Color::White);
+        m_tiles.clear();
         return;
     }
 
-    Web::PaintContext context(painter, palette(), content_rect.top_left());
-    context.set_should_show_line_box_borders(m_should_show_line_box_borders);
-    context.set_viewport_rect(content_rect);
-    context.set_has_focus(m_has_focus);
-    layout_root->paint_all_phases(context);
+    m_last_painted_content_rect = content_rect;
+    if (m_tiles_are_stale) {
+        m_tiles.clear();
+        m_tiles_are_stale = false;
+    }
+
+    // Tiles are painted for wherever they are in the content, so they can't be used for things that are drawn relative to the viewport.
+    if (paint_depends_on_scroll_position(*layout_root)) {
+        m_tiles.clear();
+        paint_into(painter, content_rect, *layout_root);
+        return;
+    }
+
+    for (auto& tile_index : tiles_intersecting(content_rect)) {
+        auto tile_rect_in_bitmap = rect_for_tile(tile_index).translated(-content_rect.location());
+        if (auto* tile = ensure_tile(tile_index, *layout_root)) {
+            painter.blit(tile_rect_in_bitmap.location(), *tile, tile->rect());
+            continue;
+        }
+        Gfx::PainterStateSaver saver(painter);
+        painter.add_clip_rect(tile_rect_in_bitmap);
+        paint_into(painter, content_rect, *layout_root);
+    }
+
+    // Keep the tiles that are about to be scrolled into view, and throw away the rest.
+    discard_tiles_outside(content_rect.inflated(2 * tile_size, tile_size, 2 * tile_size, tile_size));
+    m_tile_preparation_timer->restart();
+}
+
+void PageHost::prepare_next_tile()
+{
+    if (m_tiles_are_stale)
+        return;
+    auto* document = page().top_level_browsing_context().active_document();
+    auto* layout_root = this->layout_root();
+    if (!document || !layout_root)
+        return;
+
+    // NOTE: Laying out invalidates the display, which makes the tiles stale (and a new paint request will follow).
+    document->update_layout();
+    if (m_tiles_are_stale)
+        return;
+
+    for (auto& tile_index : tiles_intersecting(m_last_painted_content_rect.inflated(tile_size, 0, tile_size, 0))) {
+        if (m_tiles.contains(tile_index))
+            continue;
+        (void)ensure_tile(tile_index, *layout_root);
+        // One tile at a time, so that input events don't have to wait for all of them.
+        m_tile_preparation_timer->restart();
+        return;
+    }
 }
 
 void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
@@ -102,6 +230,10 @@ void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
 
 void PageHost::page_did_invalidate(Gfx::IntRect const& content_rect)
 {
+    // FIXME: Only repaint the tiles that were invalidated. Right now the rects don't always cover everything that is
+    //        painted for a node (box shadows and overlays, for example), so any invalidation means painting everything again.
+    m_tiles_are_stale = true;
+
     m_invalidation_rect = m_invalidation_rect.united(content_rect);
     if (!m_invalidation_coalescing_timer->is_active())
         m_invalidation_coalescing_timer->start();
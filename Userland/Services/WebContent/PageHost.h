@@ -31,7 +31,7 @@ public:
     void set_screen_rects(const Vector<Gfx::IntRect, 4>& rects, size_t main_screen_index) { m_screen_rect = rects[main_screen_index]; };
     void set_preferred_color_scheme(Web::CSS::PreferredColorScheme);
 
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool);
     void set_has_focus(bool);
 
 private:
@@ -71,6 +71,15 @@ private:
     Web::Layout::InitialContainingBlock* layout_root();
     void setup_palette();
 
+    static constexpr int tile_size = 256;
+    static Gfx::IntRect rect_for_tile(Gfx::IntPoint const& tile_index) { return { tile_index.x() * tile_size, tile_index.y() * tile_size, tile_size, tile_size }; }
+    static Vector<Gfx::IntPoint> tiles_intersecting(Gfx::IntRect const& content_rect);
+
+    void paint_into(Gfx::Painter&, Gfx::IntRect const& content_rect, Web::Layout::InitialContainingBlock&);
+    Gfx::Bitmap* ensure_tile(Gfx::IntPoint const& tile_index, Web::Layout::InitialContainingBlock&);
+    void discard_tiles_outside(Gfx::IntRect const& content_rect);
+    void prepare_next_tile();
+
     ConnectionFromClient& m_client;
     NonnullOwnPtr<Web::Page> m_page;
     RefPtr<Gfx::PaletteImpl> m_palette_impl;
@@ -80,6 +89,13 @@ private:
 
     RefPtr<Core::Timer> m_invalidation_coalescing_timer;
     Gfx::IntRect m_invalidation_rect;
+
+    // The page is painted in tiles that are kept around between paints, so that scrolling only has to paint what it
+    // hasn't seen yet. Tiles just outside the viewport are painted ahead of time, whenever the event loop is idle.
+    HashMap<Gfx::IntPoint, NonnullRefPtr<Gfx::Bitmap>> m_tiles;
+    bool m_tiles_are_stale { true };
+    Gfx::IntRect m_last_painted_content_rect;
+    RefPtr<Core::Timer> m_tile_preparation_timer;
     Web::CSS::PreferredColorScheme m_preferred_color_scheme { Web::CSS::PreferredColorScheme::Auto };
 };
 
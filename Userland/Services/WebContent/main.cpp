@@ -5,16 +5,31 @@
  */
 
 #include <LibCore/EventLoop.h>
-#include <LibCore/LocalServer.h>
+#include <LibCore/Stream.h>
 #include <LibCore/System.h>
-#include <LibIPC/SingleServer.h>
+#include <LibCore/SystemServerTakeover.h>
+#include <LibGfx/FontDatabase.h>
+#include <LibIPC/ConnectionFromClient.h>
 #include <LibMain/Main.h>
+#include <LibWeb/CSS/StyleComputer.h>
 #include <WebContent/ConnectionFromClient.h>
+#include <fcntl.h>
+#include <signal.h>
 
-ErrorOr<int> serenity_main(Main::Arguments)
+static ErrorOr<int> serve_client(int client_fd)
 {
-    Core::EventLoop event_loop;
     TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath"));
+
+    Core::EventLoop event_loop;
+    auto socket = TRY(Core::Stream::LocalSocket::adopt_fd(client_fd));
+    TRY(socket->set_close_on_exec(true));
+    auto client = IPC::new_client_connection<WebContent::ConnectionFromClient>(move(socket));
+    return event_loop.exec();
+}
+
+ErrorOr<int> serenity_main(Main::Arguments)
+{
+    TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath proc sigaction"));
     TRY(Core::System::unveil("/res", "r"));
     TRY(Core::System::unveil("/etc/timezone", "r"));
     TRY(Core::System::unveil("/tmp/portal/request", "rw"));
@@ -22,6 +37,41 @@ ErrorOr<int> serenity_main(Main::Arguments)
     TRY(Core::System::unveil("/tmp/portal/websocket", "rw"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
-    auto client = TRY(IPC::take_over_accepted_client_from_system_server<WebContent::ConnectionFromClient>());
-    return event_loop.exec();
+    struct sigaction act = {};
+    act.sa_flags = SA_NOCLDWAIT;
+    act.sa_handler = SIG_IGN;
+    TRY(Core::System::sigaction(SIGCHLD, &act, nullptr));
+    TRY(Core::System::pledge("stdio recvfd sendfd accept unix rpath proc"));
+
+    // We're a zygote: SystemServer hands us the listening socket, and we fork off a process for every client.
+    // Everything set up before the first fork is shared by all the clients, so do the expensive parts of
+    // LibWeb's initialization here, once. NOTE: This must not start any threads or an event loop, as those
+    // don't survive a fork().
+    (void)Gfx::FontDatabase::the();
+    Web::CSS::StyleComputer::load_user_agent_style_sheets();
+
+    auto listening_socket = TRY(Core::take_over_socket_from_system_server());
+    auto listening_fd = TRY(listening_socket->release_fd());
+    // SystemServer made the socket non-blocking for its own event loop, but we want to block in accept().
+    auto flags = TRY(Core::System::fcntl(listening_fd, F_GETFL));
+    TRY(Core::System::fcntl(listening_fd, F_SETFL, flags & ~O_NONBLOCK));
+
+    for (;;) {
+        auto client_fd_or_error = Core::System::accept(listening_fd, nullptr, nullptr);
+        if (client_fd_or_error.is_error()) {
+            dbgln("WebContent: Failed to accept a client: {}", client_fd_or_error.error());
+            continue;
+        }
+        auto client_fd = client_fd_or_error.release_value();
+
+        auto pid_or_error = Core::System::fork();
+        if (pid_or_error.is_error()) {
+            dbgln("WebContent: Failed to fork for a client: {}", pid_or_error.error());
+        } else if (pid_or_error.value() == 0) {
+            TRY(Core::System::close(listening_fd));
+            return serve_client(client_fd);
+        }
+
+        TRY(Core::System::close(client_fd));
+    }
 }
@@ -8,20 +8,20 @@
 #include <AK/Base64.h>
 #include <AK/Debug.h>
 #include <AK/LexicalPath.h>
-#include <AK/MemoryStream.h>
 #include <AK/QuickSort.h>
 #include <AK/StringBuilder.h>
 #include <AK/URL.h>
 #include <LibCore/DateTime.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
-#include <LibCore/FileStream.h>
 #include <LibCore/MappedFile.h>
 #include <LibCore/MimeData.h>
+#include <LibCore/System.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/FileCache.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -34,16 +34,39 @@ Client::Client(NonnullOwnPtr<Core::Stream::BufferedTCPSocket> socket, Core::Obje
 {
 }
 
+ErrorOr<NonnullRefPtr<Client>> Client::try_create_for_socket_fd(int fd, Core::Object* parent)
+{
+    auto socket_or_error = Core::Stream::TCPSocket::adopt_fd(fd);
+    if (socket_or_error.is_error()) {
+        (void)Core::System::close(fd);
+        return socket_or_error.release_error();
+    }
+    auto buffered_socket = TRY(Core::Stream::BufferedTCPSocket::create(socket_or_error.release_value()));
+    TRY(buffered_socket->set_blocking(true));
+    return Client::try_create(move(buffered_socket), parent);
+}
+
 void Client::die()
 {
+    if (m_is_dead)
+        return;
+    m_is_dead = true;
+    m_idle_timer->stop();
     m_socket->close();
     deferred_invoke([this] { remove_from_parent(); });
 }
 
 void Client::start()
 {
+    m_idle_timer = Core::Timer::create_single_shot(keep_alive_timeout_ms, [this] {
+        dbgln_if(WEBSERVER_DEBUG, "Closing idle connection");
+        die();
+    },
+        this);
+    m_idle_timer->start();
+
     m_socket->on_ready_to_read = [this] {
-        StringBuilder builder;
+        m_idle_timer->restart();
 
         auto maybe_buffer = ByteBuffer::create_uninitialized(m_socket->buffer_size());
         if (maybe_buffer.is_error()) {
@@ -53,6 +76,7 @@ void Client::start()
         }
 
         auto buffer = maybe_buffer.release_value();
+        bool is_eof = false;
         for (;;) {
             auto maybe_can_read = m_socket->can_read_without_blocking();
             if (maybe_can_read.is_error()) {
@@ -64,32 +88,104 @@ void Client::start()
             if (!maybe_can_read.value())
                 break;
 
-            auto maybe_nread = m_socket->read_until_any_of(buffer, Array { "\r"sv, "\n"sv, "\r\n"sv });
+            auto maybe_nread = m_socket->read(buffer);
             if (maybe_nread.is_error()) {
-                warnln("Failed to read a line from the request: {}", maybe_nread.error());
+                warnln("Failed to read the request: {}", maybe_nread.error());
                 die();
                 return;
             }
 
-            if (m_socket->is_eof()) {
-                die();
+            if (maybe_nread.value() == 0 || m_socket->is_eof()) {
+                is_eof = true;
                 break;
             }
 
-            builder.append(StringView { buffer.data(), maybe_nread.value() });
-            builder.append("\r\n");
+            if (m_request_buffer.try_append(buffer.data(), maybe_nread.value()).is_error()) {
+                die();
+                return;
+            }
+        }
+
+        handle_buffered_requests();
+        if (is_eof)
+            die();
+    };
+}
+
+// Returns the size of the request line and headers at the start of the buffer, up to and including the
+// empty line that ends them, or nothing if we haven't received all of them yet.
+static Optional<size_t> request_head_size(ReadonlyBytes buffer)
+{
+    size_t line_start = 0;
+    for (size_t i = 0; i < buffer.size(); ++i) {
+        if (buffer[i] != '\n')
+            continue;
+        auto line_length = i - line_start;
+        if (line_length == 0 || (line_length == 1 && buffer[line_start] == '\r'))
+            return i + 1;
+        line_start = i + 1;
+    }
+    return {};
+}
+
+void Client::handle_buffered_requests()
+{
+    // Clients may send further requests without waiting for our responses, those are answered in order.
+    while (!m_is_dead) {
+        // Empty lines between requests are to be ignored (RFC 9112, section 2.2).
+        size_t leading_empty_lines = 0;
+        while (leading_empty_lines < m_request_buffer.size() && (m_request_buffer[leading_empty_lines] == '\r' || m_request_buffer[leading_empty_lines] == '\n'))
+            ++leading_empty_lines;
+
+        auto head = m_request_buffer.bytes().slice(leading_empty_lines);
+        auto head_size = request_head_size(head);
+        if (!head_size.has_value()) {
+            if (head.size() > max_request_head_size) {
+                warnln("Request is too big, closing the connection");
+                die();
+            }
+            break;
         }
 
+        // Lines may end in CR LF, LF or CR, but the request parser only understands CR LF.
+        StringBuilder builder;
+        for (auto line : StringView { head.trim(*head_size) }.lines())
+            builder.appendff("{}\r\n", line);
         auto request = builder.to_byte_buffer();
         dbgln_if(WEBSERVER_DEBUG, "Got raw request: '{}'", String::copy(request));
 
+        auto remaining_bytes = head.slice(*head_size);
+        auto maybe_remaining_buffer = ByteBuffer::copy(remaining_bytes);
+        if (maybe_remaining_buffer.is_error()) {
+            die();
+            return;
+        }
+        m_request_buffer = maybe_remaining_buffer.release_value();
+
+        m_keep_alive = false;
         auto maybe_did_handle = handle_request(request);
         if (maybe_did_handle.is_error()) {
             warnln("Failed to handle the request: {}", maybe_did_handle.error());
+            m_keep_alive = false;
         }
 
-        die();
-    };
+        if (!m_keep_alive)
+            die();
+    }
+}
+
+static bool should_keep_alive(HTTP::HttpRequest const& request)
+{
+    // HTTP/1.1 connections are persistent unless the client says otherwise, HTTP/1.0 ones only if it asks for it.
+    bool keep_alive = request.protocol() == "HTTP/1.1"sv;
+    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_case("Connection"); }); !it.is_end()) {
+        auto value = it->value.trim_whitespace();
+        if (value.equals_ignoring_case("keep-alive"))
+            keep_alive = true;
+        else if (value.equals_ignoring_case("close"))
+            keep_alive = false;
+    }
+    return keep_alive;
 }
 
 ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
@@ -106,10 +202,12 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
         }
     }
 
+    // NOTE: We don't read request bodies, so the connection can't be reused after any other method.
     if (request.method() != HTTP::HttpRequest::Method::GET) {
         TRY(send_error_response(501, request));
         return false;
     }
+    m_keep_alive = should_keep_alive(request);
 
     // Check for credentials if they are required
     if (Configuration::the().credentials().has_value()) {
@@ -157,96 +255,99 @@ ErrorOr<bool> Client::handle_request(ReadonlyBytes raw_request)
         return false;
     }
 
-    if (file->is_device()) {
+    auto st = TRY(Core::System::fstat(file->fd()));
+    if (S_ISCHR(st.st_mode) || S_ISBLK(st.st_mode)) {
         TRY(send_error_response(403, request));
         return false;
     }
 
-    Core::InputFileStream stream { file };
-
-    TRY(send_response(stream, request, Core::guess_mime_type_based_on_filename(real_path)));
+    TRY(send_file_response(real_path, file->fd(), st, request, Core::guess_mime_type_based_on_filename(real_path)));
     return true;
 }
 
-ErrorOr<void> Client::send_response(InputStream& response, HTTP::HttpRequest const& request, String const& content_type)
+ByteBuffer Client::response_header(unsigned code, Vector<String> const& headers, StringView content_type, size_t content_length) const
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 200 OK\r\n");
+    builder.appendff("HTTP/1.1 {} {}\r\n", code, HTTP::HttpResponse::reason_phrase_for_code(code));
     builder.append("Server: WebServer (SerenityOS)\r\n");
-    builder.append("X-Frame-Options: SAMEORIGIN\r\n");
-    builder.append("X-Content-Type-Options: nosniff\r\n");
-    builder.append("Pragma: no-cache\r\n");
-    builder.append("Content-Type: ");
-    builder.append(content_type);
-    builder.append("\r\n");
-    builder.append("\r\n");
-
-    auto builder_contents = builder.to_byte_buffer();
-    TRY(m_socket->write(builder_contents));
-    log_response(200, request);
+    if (code == 200) {
+        builder.append("X-Frame-Options: SAMEORIGIN\r\n");
+        builder.append("X-Content-Type-Options: nosniff\r\n");
+        builder.append("Pragma: no-cache\r\n");
+    }
+    for (auto& header : headers) {
+        builder.append(header);
+        builder.append("\r\n");
+    }
+    if (!content_type.is_empty())
+        builder.appendff("Content-Type: {}\r\n", content_type);
+    // Every response says how long it is, so that the client can tell where the next one starts.
+    builder.appendff("Content-Length: {}\r\n", content_length);
+    return builder.to_byte_buffer();
+}
 
-    char buffer[PAGE_SIZE];
-    do {
-        auto size = response.read({ buffer, sizeof(buffer) });
-        if (response.unreliable_eof() && size == 0)
-            break;
+ErrorOr<void> Client::write_response(ReadonlyBytes header_without_connection, ReadonlyBytes body)
+{
+    auto connection = m_keep_alive ? "Connection: keep-alive\r\n\r\n"sv : "Connection: close\r\n\r\n"sv;
+    Array<ReadonlyBytes, 3> buffers { header_without_connection, connection.bytes(), body };
+    return m_socket->write_entire_buffers(buffers);
+}
 
-        ReadonlyBytes write_buffer { buffer, size };
-        while (!write_buffer.is_empty()) {
-            auto nwritten = TRY(m_socket->write(write_buffer));
+ErrorOr<void> Client::send_response(ReadonlyBytes response, HTTP::HttpRequest const& request, String const& content_type)
+{
+    TRY(write_response(response_header(200, {}, content_type, response.size()), response));
+    log_response(200, request);
+    return {};
+}
 
-            if (nwritten == 0) {
-                dbgln("EEEEEE got 0 bytes written!");
-            }
+ErrorOr<void> Client::send_file_response(String const& path, int fd, struct stat const& st, HTTP::HttpRequest const& request, String const& content_type)
+{
+    auto& cache = FileCache::the();
+    auto const* cached_file = cache.find(path, st);
+    if (!cached_file)
+        cached_file = TRY(cache.add(path, fd, st, response_header(200, {}, content_type, st.st_size)));
+
+    if (cached_file) {
+        TRY(write_response(cached_file->header, cached_file->contents));
+        log_response(200, request);
+        return {};
+    }
 
-            write_buffer = write_buffer.slice(nwritten);
-        }
-    } while (true);
+    TRY(write_response(response_header(200, {}, content_type, st.st_size)));
 
-    auto keep_alive = false;
-    if (auto it = request.headers().find_if([](auto& header) { return header.name.equals_ignoring_case("Connection"); }); !it.is_end()) {
-        if (it->value.trim_whitespace().equals_ignoring_case("keep-alive"))
-            keep_alive = true;
+    // The kernel moves the file contents into the socket for us, so they never get copied through our buffers.
+    off_t offset = 0;
+    while (offset < st.st_size) {
+        auto nsent = TRY(m_socket->send_file(fd, offset, st.st_size - offset));
+        if (nsent == 0)
+            break;
     }
-    if (!keep_alive)
-        m_socket->close();
+    // If the file got shorter while we sent it, the client can't tell where the next response starts.
+    if (offset < st.st_size)
+        m_keep_alive = false;
 
+    log_response(200, request);
     return {};
 }
 
 ErrorOr<void> Client::send_redirect(StringView redirect_path, HTTP::HttpRequest const& request)
 {
-    StringBuilder builder;
-    builder.append("HTTP/1.0 301 Moved Permanently\r\n");
-    builder.append("Location: ");
-    builder.append(redirect_path);
-    builder.append("\r\n");
-    builder.append("\r\n");
-
-    auto builder_contents = builder.to_byte_buffer();
-    TRY(m_socket->write(builder_contents));
-
+    TRY(write_response(response_header(301, { String::formatted("Location: {}", redirect_path) }, {}, 0)));
     log_response(301, request);
     return {};
 }
 
-static String folder_image_data()
+// NOTE: These are shared by all threads handling clients, so they are returned by reference to keep their
+//       (non-atomic) reference count untouched.
+static String const& folder_image_data()
 {
-    static String cache;
-    if (cache.is_empty()) {
-        auto file = Core::MappedFile::map("/res/icons/16x16/filetype-folder.png").release_value_but_fixme_should_propagate_errors();
-        cache = encode_base64(file->bytes());
-    }
+    static String const cache = encode_base64(Core::MappedFile::map("/res/icons/16x16/filetype-folder.png").release_value_but_fixme_should_propagate_errors()->bytes());
     return cache;
 }
 
-static String file_image_data()
+static String const& file_image_data()
 {
-    static String cache;
-    if (cache.is_empty()) {
-        auto file = Core::MappedFile::map("/res/icons/16x16/filetype-unknown.png").release_value_but_fixme_should_propagate_errors();
-        cache = encode_base64(file->bytes());
-    }
+    static String const cache = encode_base64(Core::MappedFile::map("/res/icons/16x16/filetype-unknown.png").release_value_but_fixme_should_propagate_errors()->bytes());
     return cache;
 }
 
@@ -325,32 +426,15 @@ ErrorOr<void> Client::handle_directory_listing(String const& requested_path, Str
     builder.append("</html>\n");
 
     auto response = builder.to_string();
-    InputMemoryStream stream { response.bytes() };
-    return send_response(stream, request, "text/html");
+    return send_response(response.bytes(), request, "text/html");
 }
 
 ErrorOr<void> Client::send_error_response(unsigned code, HTTP::HttpRequest const& request, Vector<String> const& headers)
 {
     auto reason_phrase = HTTP::HttpResponse::reason_phrase_for_code(code);
-    StringBuilder builder;
-    builder.appendff("HTTP/1.0 {} ", code);
-    builder.append(reason_phrase);
-    builder.append("\r\n");
-
-    for (auto& header : headers) {
-        builder.append(header);
-        builder.append("\r\n");
-    }
-    builder.append("Content-Type: text/html; charset=UTF-8\r\n");
-
-    builder.append("\r\n");
-    builder.append("<!DOCTYPE html><html><body><h1>");
-    builder.appendff("{} ", code);
-    builder.append(reason_phrase);
-    builder.append("</h1></body></html>");
+    auto body = String::formatted("<!DOCTYPE html><html><body><h1>{} {}</h1></body></html>", code, reason_phrase);
 
-    auto builder_contents = builder.to_byte_buffer();
-    TRY(m_socket->write(builder_contents));
+    TRY(write_response(response_header(code, headers, "text/html; charset=UTF-8"sv, body.length()), body.bytes()));
 
     log_response(code, request);
     return {};
@@ -6,10 +6,13 @@
 
 #pragma once
 
+#include <AK/ByteBuffer.h>
 #include <LibCore/Object.h>
 #include <LibCore/Stream.h>
+#include <LibCore/Timer.h>
 #include <LibHTTP/Forward.h>
 #include <LibHTTP/HttpRequest.h>
+#include <sys/stat.h>
 
 namespace WebServer {
 
@@ -17,13 +20,25 @@ class Client final : public Core::Object {
     C_OBJECT(Client);
 
 public:
+    // Creates a client for an accepted connection on the current thread's event loop. Takes ownership of the fd.
+    static ErrorOr<NonnullRefPtr<Client>> try_create_for_socket_fd(int fd, Core::Object* parent);
+
     void start();
 
 private:
     Client(NonnullOwnPtr<Core::Stream::BufferedTCPSocket>, Core::Object* parent);
 
+    // How long an idle keep-alive connection stays open.
+    static constexpr int keep_alive_timeout_ms = 10'000;
+    // Requests whose request line and headers don't fit into this are rejected.
+    static constexpr size_t max_request_head_size = 64 * KiB;
+
+    void handle_buffered_requests();
     ErrorOr<bool> handle_request(ReadonlyBytes);
-    ErrorOr<void> send_response(InputStream&, HTTP::HttpRequest const&, String const& content_type);
+    ByteBuffer response_header(unsigned code, Vector<String> const& headers, StringView content_type, size_t content_length) const;
+    ErrorOr<void> write_response(ReadonlyBytes header_without_connection, ReadonlyBytes body = {});
+    ErrorOr<void> send_response(ReadonlyBytes, HTTP::HttpRequest const&, String const& content_type);
+    ErrorOr<void> send_file_response(String const& path, int fd, struct stat const&, HTTP::HttpRequest const&, String const& content_type);
     ErrorOr<void> send_redirect(StringView redirect, HTTP::HttpRequest const&);
     ErrorOr<void> send_error_response(unsigned code, HTTP::HttpRequest const&, Vector<String> const& headers = {});
     void die();
@@ -32,6 +47,12 @@ private:
     bool verify_credentials(Vector<HTTP::HttpRequest::Header> const&);
 
     NonnullOwnPtr<Core::Stream::BufferedTCPSocket> m_socket;
+    // Received bytes that don't make up a complete request yet. Clients may pipeline requests, so this can hold several.
+    ByteBuffer m_request_buffer;
+    // Whether the connection stays open after the response to the current request.
+    bool m_keep_alive { false };
+    bool m_is_dead { false };
+    RefPtr<Core::Timer> m_idle_timer;
 };
 
 }
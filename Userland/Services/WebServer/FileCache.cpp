@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/OwnPtr.h>
+#include <LibCore/System.h>
+#include <WebServer/FileCache.h>
+
+namespace WebServer {
+
+FileCache& FileCache::the()
+{
+    static thread_local FileCache s_the;
+    return s_the;
+}
+
+bool FileCache::CachedFile::matches(struct stat const& st) const
+{
+    return device == st.st_dev
+        && inode == st.st_ino
+        && size == st.st_size
+        && modification_time.tv_sec == st.st_mtim.tv_sec
+        && modification_time.tv_nsec == st.st_mtim.tv_nsec;
+}
+
+FileCache::Entry const* FileCache::find(String const& path, struct stat const& st)
+{
+    auto it = m_files.find(path);
+    if (it == m_files.end())
+        return nullptr;
+
+    auto& file = *it->value;
+    if (!file.matches(st)) {
+        dbgln_if(WEBSERVER_DEBUG, "Cached file '{}' has changed, dropping it", path);
+        m_total_size -= file.entry.contents.size();
+        m_files.remove(it);
+        return nullptr;
+    }
+
+    file.last_used = ++m_use_counter;
+    return &file.entry;
+}
+
+ErrorOr<FileCache::Entry const*> FileCache::add(String const& path, int fd, struct stat const& st, ByteBuffer header)
+{
+    if (st.st_size < 0 || static_cast<size_t>(st.st_size) > max_file_size)
+        return nullptr;
+
+    auto contents = TRY(ByteBuffer::create_uninitialized(st.st_size));
+    size_t nread = 0;
+    while (nread < contents.size()) {
+        auto result = TRY(Core::System::read(fd, contents.bytes().slice(nread)));
+        if (result == 0)
+            break;
+        nread += result;
+    }
+    // The file got shorter while we read it, better not to cache it.
+    if (nread != contents.size())
+        return nullptr;
+
+    while (!m_files.is_empty() && m_total_size + contents.size() > max_total_size)
+        evict_least_recently_used();
+
+    if (auto it = m_files.find(path); it != m_files.end()) {
+        m_total_size -= it->value->entry.contents.size();
+        m_files.remove(it);
+    }
+
+    auto file = TRY(adopt_nonnull_own_or_enomem(new (nothrow) CachedFile {
+        .entry = { move(header), move(contents) },
+        .device = st.st_dev,
+        .inode = st.st_ino,
+        .size = st.st_size,
+        .modification_time = st.st_mtim,
+        .last_used = ++m_use_counter,
+    }));
+    auto* entry = &file->entry;
+    m_total_size += entry->contents.size();
+    m_files.set(path, move(file));
+    return entry;
+}
+
+void FileCache::evict_least_recently_used()
+{
+    auto least_recently_used = m_files.begin();
+    for (auto it = m_files.begin(); it != m_files.end(); ++it) {
+        if (it->value->last_used < least_recently_used->value->last_used)
+            least_recently_used = it;
+    }
+    dbgln_if(WEBSERVER_DEBUG, "Evicting cached file '{}'", least_recently_used->key);
+    m_total_size -= least_recently_used->value->entry.contents.size();
+    m_files.remove(least_recently_used);
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/String.h>
+#include <sys/stat.h>
+
+namespace WebServer {
+
+// Keeps the responses for small static files in memory, so serving them again doesn't have to read the file.
+// Every thread that handles clients has its own cache, so the entries are never shared between threads.
+class FileCache {
+public:
+    static FileCache& the();
+
+    struct Entry {
+        // The response header up to (but not including) the Connection header, which depends on the request.
+        ByteBuffer header;
+        ByteBuffer contents;
+    };
+
+    // Returns the cached response for the file at this path, if it hasn't changed since it was cached.
+    Entry const* find(String const& path, struct stat const&);
+    // Reads the file into the cache, unless it is too big. The returned entry stays valid until the next call to add().
+    ErrorOr<Entry const*> add(String const& path, int fd, struct stat const&, ByteBuffer header);
+
+private:
+    static constexpr size_t max_file_size = 256 * KiB;
+    static constexpr size_t max_total_size = 16 * MiB;
+
+    struct CachedFile {
+        Entry entry;
+        dev_t device;
+        ino_t inode;
+        off_t size;
+        timespec modification_time;
+        u64 last_used { 0 };
+
+        bool matches(struct stat const&) const;
+    };
+
+    void evict_least_recently_used();
+
+    HashMap<String, NonnullOwnPtr<CachedFile>> m_files;
+    size_t m_total_size { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
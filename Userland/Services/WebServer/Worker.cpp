@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/EventLoop.h>
+#include <LibCore/Notifier.h>
+#include <LibCore/System.h>
+#include <WebServer/Client.h>
+#include <WebServer/Worker.h>
+#include <fcntl.h>
+
+namespace WebServer {
+
+ErrorOr<NonnullOwnPtr<Worker>> Worker::try_create(size_t index)
+{
+    auto pipe_fds = TRY(Core::System::pipe2(O_CLOEXEC));
+    int pipe_read_fd = pipe_fds[0];
+
+    auto thread = TRY(Threading::Thread::try_create(
+        [pipe_read_fd]() -> intptr_t {
+            Core::EventLoop loop;
+
+            // The clients are children of the notifier, so that they live on this thread too.
+            auto notifier = Core::Notifier::construct(pipe_read_fd, Core::Notifier::Read);
+            notifier->on_ready_to_read = [&] {
+                int client_fds[16];
+                auto nread_or_error = Core::System::read(pipe_read_fd, { client_fds, sizeof(client_fds) });
+                if (nread_or_error.is_error() || nread_or_error.value() == 0) {
+                    // The main thread is gone.
+                    loop.quit(0);
+                    return;
+                }
+                for (size_t i = 0; i < nread_or_error.value() / sizeof(int); ++i) {
+                    auto client_or_error = Client::try_create_for_socket_fd(client_fds[i], notifier);
+                    if (client_or_error.is_error()) {
+                        warnln("Could not create a client for the connection: {}", client_or_error.error());
+                        continue;
+                    }
+                    client_or_error.value()->start();
+                }
+            };
+
+            auto exit_code = loop.exec();
+            (void)Core::System::close(pipe_read_fd);
+            return exit_code;
+        },
+        String::formatted("WebServer worker {}", index)));
+
+    auto worker = TRY(adopt_nonnull_own_or_enomem(new (nothrow) Worker(thread, pipe_fds[1])));
+    thread->start();
+    thread->detach();
+    return worker;
+}
+
+Worker::Worker(NonnullRefPtr<Threading::Thread> thread, int pipe_write_fd)
+    : m_thread(move(thread))
+    , m_pipe_write_fd(pipe_write_fd)
+{
+}
+
+Worker::~Worker()
+{
+    (void)Core::System::close(m_pipe_write_fd);
+}
+
+ErrorOr<void> Worker::hand_over(int client_fd)
+{
+    // NOTE: Writes of this size to a pipe are atomic, so the fd can't get mixed up with others.
+    TRY(Core::System::write(m_pipe_write_fd, { &client_fd, sizeof(client_fd) }));
+    return {};
+}
+
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullRefPtr.h>
+#include <LibThreading/Thread.h>
+
+namespace WebServer {
+
+// A thread with its own event loop, which serves the connections that the main thread accepts and hands over to it.
+class Worker {
+public:
+    static ErrorOr<NonnullOwnPtr<Worker>> try_create(size_t index);
+    ~Worker();
+
+    // Takes ownership of an accepted connection's fd.
+    ErrorOr<void> hand_over(int client_fd);
+
+private:
+    Worker(NonnullRefPtr<Threading::Thread>, int pipe_write_fd);
+
+    NonnullRefPtr<Threading::Thread> m_thread;
+    // The main thread writes the fds of accepted connections into this pipe, the worker reads them on the other end.
+    int m_pipe_write_fd { -1 };
+};
+
+}
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NonnullOwnPtrVector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
@@ -15,6 +16,7 @@
 #include <LibMain/Main.h>
 #include <WebServer/Client.h>
 #include <WebServer/Configuration.h>
+#include <WebServer/Worker.h>
 #include <stdio.h>
 #include <unistd.h>
 
@@ -26,6 +28,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     String listen_address = default_listen_address;
     int port = default_port;
+    int thread_count = 1;
     String username;
     String password;
 
@@ -34,6 +37,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
     args_parser.add_option(username, "HTTP basic authentication username", "user", 'U', "username");
     args_parser.add_option(password, "HTTP basic authentication password", "pass", 'P', "password");
+    args_parser.add_option(thread_count, "Number of threads serving clients (default: 1, the main thread)", "threads", 't', "count");
     args_parser.add_positional_argument(root_path, "Path to serve the contents of", "path", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
 
@@ -48,6 +52,11 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
+    if (thread_count < 1) {
+        warnln("Invalid thread count: {}", thread_count);
+        return 1;
+    }
+
     if (username.is_empty() != password.is_empty()) {
         warnln("Both username and password are required for HTTP basic authentication.");
         return 1;
@@ -60,7 +69,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 1;
     }
 
-    TRY(Core::System::pledge("stdio accept rpath inet unix"));
+    TRY(Core::System::pledge("stdio accept rpath inet unix thread"));
 
     WebServer::Configuration configuration(real_root_path);
 
@@ -71,23 +80,36 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto server = TRY(Core::TCPServer::try_create());
 
+    // With more than one thread, the main thread only accepts connections and hands them to the workers in turn.
+    NonnullOwnPtrVector<WebServer::Worker> workers;
+    if (thread_count > 1) {
+        for (int i = 0; i < thread_count; ++i)
+            workers.append(TRY(WebServer::Worker::try_create(i)));
+    }
+    size_t next_worker = 0;
+
     server->on_ready_to_accept = [&] {
-        auto maybe_client_socket = server->accept();
-        if (maybe_client_socket.is_error()) {
-            warnln("Failed to accept the client: {}", maybe_client_socket.error());
+        auto maybe_client_fd = server->accept_fd();
+        if (maybe_client_fd.is_error()) {
+            warnln("Failed to accept the client: {}", maybe_client_fd.error());
             return;
         }
 
-        auto maybe_buffered_socket = Core::Stream::BufferedTCPSocket::create(maybe_client_socket.release_value());
-        if (maybe_buffered_socket.is_error()) {
-            warnln("Could not obtain a buffered socket for the client: {}", maybe_buffered_socket.error());
+        if (!workers.is_empty()) {
+            auto& worker = workers[next_worker++ % workers.size()];
+            if (auto result = worker.hand_over(maybe_client_fd.value()); result.is_error()) {
+                warnln("Could not hand the client over to a worker: {}", result.error());
+                (void)Core::System::close(maybe_client_fd.value());
+            }
             return;
         }
 
-        // FIXME: Propagate errors
-        MUST(maybe_buffered_socket.value()->set_blocking(true));
-        auto client = WebServer::Client::construct(maybe_buffered_socket.release_value(), server);
-        client->start();
+        auto maybe_client = WebServer::Client::try_create_for_socket_fd(maybe_client_fd.value(), server);
+        if (maybe_client.is_error()) {
+            warnln("Could not create a client for the connection: {}", maybe_client.error());
+            return;
+        }
+        maybe_client.value()->start();
     };
 
     TRY(server->listen(ipv4_address.value(), port));
@@ -99,6 +121,6 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     TRY(Core::System::unveil(real_root_path.characters(), "r"));
     TRY(Core::System::unveil(nullptr, nullptr));
 
-    TRY(Core::System::pledge("stdio accept rpath"));
+    TRY(Core::System::pledge("stdio accept rpath thread"));
     return loop.exec();
 }
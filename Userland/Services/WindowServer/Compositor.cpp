@@ -16,11 +16,13 @@
 #include <AK/Debug.h>
 #include <AK/Memory.h>
 #include <AK/ScopeGuard.h>
+#include <AK/Time.h>
 #include <LibCore/Timer.h>
 #include <LibGfx/Font.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/StylePainter.h>
 #include <LibThreading/BackgroundAction.h>
+#include <LibThreading/ThreadPool.h>
 
 namespace WindowServer {
 
@@ -174,6 +176,22 @@ void Compositor::compose()
         return;
     }
 
+    auto start_time = Time::now_monotonic();
+    compose_frame();
+    auto frame_time_us = static_cast<u32>(min((Time::now_monotonic() - start_time).to_microseconds(), NumericLimits<u32>::max()));
+
+    ++m_statistics.frame_count;
+    if (frame_time_us > 1'000'000 / 60)
+        ++m_statistics.slow_frame_count;
+    m_statistics.total_frame_time_us += frame_time_us;
+    m_statistics.last_frame_time_us = frame_time_us;
+    m_statistics.longest_frame_time_us = max(m_statistics.longest_frame_time_us, frame_time_us);
+}
+
+void Compositor::compose_frame()
+{
+    auto& wm = WindowManager::the();
+
     if (m_occlusions_dirty) {
         m_occlusions_dirty = false;
         recompute_occlusions();
@@ -569,12 +587,11 @@ void Compositor::compose()
         }
 
         // Copy anything rendered to the temporary buffer to the back buffer
-        Screen::for_each([&](auto& screen) {
+        for_each_screen_in_parallel([&](Screen& screen) {
             auto screen_rect = screen.rect();
             auto& screen_data = screen.compositor_screen_data();
             for (auto& rect : screen_data.m_flush_transparent_rects.rects())
                 screen_data.m_back_painter->blit(rect.location(), *screen_data.m_temp_bitmap, rect.translated(-screen_rect.location()));
-            return IterationDecision::Continue;
         });
     }
 
@@ -600,12 +617,36 @@ void Compositor::compose()
         screen_data.draw_cursor(cursor_screen, cursor_rect);
     }
 
-    Screen::for_each([&](auto& screen) {
+    // Each screen only touches its own bitmaps and device, so they can all be flushed at once.
+    for_each_screen_in_parallel([&](Screen& screen) {
         flush(screen);
-        return IterationDecision::Continue;
     });
 }
 
+void Compositor::for_each_screen_in_parallel(Function<void(Screen&)> const& callback)
+{
+    auto& pool = Threading::ThreadPool::the();
+    if (Screen::count() == 1 || pool.worker_count() == 0) {
+        Screen::for_each([&](auto& screen) {
+            callback(screen);
+            return IterationDecision::Continue;
+        });
+        return;
+    }
+
+    Atomic<size_t> next_screen_index { 0 };
+    auto process_remaining_screens = [&] {
+        while (auto* screen = Screen::find_by_index(next_screen_index.fetch_add(1)))
+            callback(*screen);
+    };
+    Threading::TaskGroup group(pool);
+    auto helper_count = min(pool.worker_count(), Screen::count() - 1);
+    for (size_t i = 0; i < helper_count; ++i)
+        group.spawn([&] { process_remaining_screens(); });
+    process_remaining_screens();
+    group.wait();
+}
+
 void Compositor::flush(Screen& screen)
 {
     auto& screen_data = screen.compositor_screen_data();
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <LibCore/Object.h>
@@ -25,6 +26,16 @@ class Window;
 class WindowManager;
 class WindowStack;
 
+// How long compose() has been taking, which WindowManagerServer clients can ask for.
+struct CompositorStatistics {
+    u64 frame_count { 0 };
+    // Frames that took longer than the compose timer interval, i.e. that made the next one late.
+    u64 slow_frame_count { 0 };
+    u64 total_frame_time_us { 0 };
+    u32 last_frame_time_us { 0 };
+    u32 longest_frame_time_us { 0 };
+};
+
 enum class WallpaperMode {
     Tile,
     Center,
@@ -183,6 +194,8 @@ public:
 
     void set_flash_flush(bool b) { m_flash_flush = b; }
 
+    CompositorStatistics const& statistics() const { return m_statistics; }
+
     static NonnullOwnPtr<CompositorScreenData> create_screen_data(Badge<Screen>)
     {
         return adopt_own(*new CompositorScreenData());
@@ -204,6 +217,9 @@ private:
     void recompute_occlusions();
     void change_cursor(const Cursor*);
     void flush(Screen&);
+    // Runs the callback once for every screen, on the thread pool if there is more than one.
+    void for_each_screen_in_parallel(Function<void(Screen&)> const&);
+    void compose_frame();
     Gfx::IntPoint window_transition_offset(Window&);
     void update_animations(Screen&, Gfx::DisjointRectSet& flush_rects);
     void create_window_stack_switch_overlay(WindowStack&);
@@ -247,6 +263,8 @@ private:
     Optional<Gfx::Color> m_custom_background_color;
 
     HashTable<Animation*> m_animations;
+
+    CompositorStatistics m_statistics;
 };
 
 }
@@ -5,6 +5,7 @@
  */
 
 #include <WindowServer/AppletManager.h>
+#include <WindowServer/Compositor.h>
 #include <WindowServer/ConnectionFromClient.h>
 #include <WindowServer/Screen.h>
 #include <WindowServer/WMConnectionFromClient.h>
@@ -165,6 +166,12 @@ void WMConnectionFromClient::set_workspace(u32 row, u32 col)
     WindowManager::the().switch_to_window_stack(row, col);
 }
 
+Messages::WindowManagerServer::GetCompositorStatisticsResponse WMConnectionFromClient::get_compositor_statistics()
+{
+    auto& statistics = Compositor::the().statistics();
+    return { statistics.frame_count, statistics.slow_frame_count, statistics.total_frame_time_us, statistics.last_frame_time_us, statistics.longest_frame_time_us };
+}
+
 void WMConnectionFromClient::set_window_taskbar_rect(i32 client_id, i32 window_id, Gfx::IntRect const& rect)
 {
     // Because the Taskbar (which should be the only user of this API) does not own the
@@ -18,10 +18,15 @@ namespace Shell {
 class FileDescriptionCollector {
 public:
     FileDescriptionCollector() { }
+    FileDescriptionCollector(FileDescriptionCollector&& other)
+        : m_fds(move(other.m_fds))
+    {
+    }
     ~FileDescriptionCollector();
 
     void collect();
     void add(int fd);
+    Span<int const> fds() const { return m_fds; }
 
 private:
     Vector<int, 32> m_fds;
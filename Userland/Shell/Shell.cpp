@@ -29,6 +29,7 @@
 #include <inttypes.h>
 #include <pwd.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -526,15 +527,6 @@ bool Shell::is_runnable(StringView name)
 
 int Shell::run_command(StringView cmd, Optional<SourcePosition> source_position_override)
 {
-    // The default-constructed mode of the shell
-    // should not be used for execution!
-    VERIFY(!m_default_constructed);
-
-    take_error();
-
-    if (!last_return_code.has_value())
-        last_return_code = 0;
-
     ScopedValueRollback source_position_rollback { m_source_position };
     if (source_position_override.has_value())
         m_source_position = move(source_position_override);
@@ -542,10 +534,23 @@ int Shell::run_command(StringView cmd, Optional<SourcePosition> source_position_
     if (!m_source_position.has_value())
         m_source_position = SourcePosition { .source_file = {}, .literal_source_text = cmd, .position = {} };
 
-    if (cmd.is_empty())
-        return 0;
+    RefPtr<AST::Node> command;
+    if (!cmd.is_empty())
+        command = Parser(cmd, m_is_interactive).parse();
 
-    auto command = Parser(cmd, m_is_interactive).parse();
+    return run_parsed_command(move(command));
+}
+
+int Shell::run_parsed_command(RefPtr<AST::Node> command)
+{
+    // The default-constructed mode of the shell
+    // should not be used for execution!
+    VERIFY(!m_default_constructed);
+
+    take_error();
+
+    if (!last_return_code.has_value())
+        last_return_code = 0;
 
     if (!command)
         return 0;
@@ -580,23 +585,8 @@ int Shell::run_command(StringView cmd, Optional<SourcePosition> source_position_
     return last_return_code.value_or(0);
 }
 
-ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
+ErrorOr<void> Shell::resolve_redirections(const AST::Command& command, NonnullRefPtrVector<AST::Rewiring>& rewirings, FileDescriptionCollector& fds)
 {
-    FileDescriptionCollector fds;
-
-    if (options.verbose)
-        warnln("+ {}", command);
-
-    // If the command is empty, store the redirections and apply them to all later commands.
-    if (command.argv.is_empty() && !command.should_immediately_execute_next) {
-        m_global_redirections.extend(command.redirections);
-        for (auto& next_in_chain : command.next_chain)
-            run_tail(command, next_in_chain, last_return_code.value_or(0));
-        return nullptr;
-    }
-
-    // Resolve redirections.
-    NonnullRefPtrVector<AST::Rewiring> rewirings;
     auto resolve_redirection = [&](auto& redirection) -> ErrorOr<void> {
         auto rewiring = TRY(redirection.apply());
 
@@ -634,6 +624,31 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
         return {};
     };
 
+    for (auto& redirection : m_global_redirections)
+        TRY(resolve_redirection(redirection));
+
+    for (auto& redirection : command.redirections)
+        TRY(resolve_redirection(redirection));
+
+    return {};
+}
+
+ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
+{
+    FileDescriptionCollector fds;
+
+    if (options.verbose)
+        warnln("+ {}", command);
+
+    // If the command is empty, store the redirections and apply them to all later commands.
+    if (command.argv.is_empty() && !command.should_immediately_execute_next) {
+        m_global_redirections.extend(command.redirections);
+        for (auto& next_in_chain : command.next_chain)
+            run_tail(command, next_in_chain, last_return_code.value_or(0));
+        return nullptr;
+    }
+
+    NonnullRefPtrVector<AST::Rewiring> rewirings;
     auto apply_rewirings = [&]() -> ErrorOr<void> {
         for (auto& rewiring : rewirings) {
 
@@ -658,11 +673,8 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
 
     TemporaryChange signal_handler_install { m_should_reinstall_signal_handlers, false };
 
-    for (auto& redirection : m_global_redirections)
-        TRY(resolve_redirection(redirection));
-
-    for (auto& redirection : command.redirections)
-        TRY(resolve_redirection(redirection));
+    // Resolve redirections.
+    TRY(resolve_redirections(command, rewirings, fds));
 
     if (int local_return_code = 0; command.should_wait && run_builtin(command, rewirings, local_return_code)) {
         last_return_code = local_return_code;
@@ -706,8 +718,23 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
 
     argv.append(nullptr);
 
-    auto sync_pipe = TRY(Core::System::pipe2(0));
-    auto child = TRY(Core::System::fork());
+    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
+    bool should_set_process_group = !m_is_subshell || command.pipeline;
+
+    pid_t child = -1;
+    if (can_be_spawned(command)) {
+        Optional<pid_t> process_group;
+        if (should_set_process_group)
+            process_group = is_first ? 0 : command.pipeline->pgid;
+        child = spawn_process(command, rewirings, fds, argv, process_group).value_or(-1);
+    }
+    bool was_spawned = child != -1;
+
+    Array<int, 2> sync_pipe { -1, -1 };
+    if (!was_spawned) {
+        sync_pipe = TRY(Core::System::pipe2(0));
+        child = TRY(Core::System::fork());
+    }
 
     if (child == 0) {
         close(sync_pipe[1]);
@@ -722,6 +749,8 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
         }
 
         fds.collect();
+        // The pipes of deferred builtins belong to the parent, we'd keep their readers from seeing EOF.
+        m_deferred_pipe_source_builtins.clear();
 
         u8 c;
         while (read(sync_pipe[0], &c, 1) < 0) {
@@ -766,10 +795,6 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
         VERIFY_NOT_REACHED();
     }
 
-    close(sync_pipe[0]);
-
-    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
-
     if (command.pipeline) {
         if (is_first) {
             command.pipeline->pgid = child;
@@ -777,7 +802,20 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
     }
 
     pid_t pgid = is_first ? child : (command.pipeline ? command.pipeline->pgid : child);
-    if (!m_is_subshell || command.pipeline) {
+
+    if (was_spawned) {
+        // posix_spawn() has the child join its process group, but the next process in the pipeline
+        // may be started before that happens. Whichever of us gets there first wins, and the other
+        // call fails harmlessly.
+        if (should_set_process_group)
+            (void)Core::System::setpgid(child, pgid);
+        fds.collect();
+        return make_job(command, child, pgid);
+    }
+
+    close(sync_pipe[0]);
+
+    if (should_set_process_group) {
         auto result = Core::System::setpgid(child, pgid);
         if (result.is_error() && m_is_interactive)
             warnln("Shell: {}", result.error());
@@ -802,6 +840,13 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
 
     close(sync_pipe[1]);
 
+    fds.collect();
+
+    return make_job(command, child, pgid);
+}
+
+NonnullRefPtr<Job> Shell::make_job(const AST::Command& command, pid_t child, pid_t pgid)
+{
     StringBuilder cmd;
     cmd.join(" ", command.argv);
 
@@ -834,9 +879,84 @@ ErrorOr<RefPtr<Job>> Shell::run_command(const AST::Command& command)
         run_tail(job);
     };
 
-    fds.collect();
+    return job;
+}
+
+bool Shell::can_be_spawned(const AST::Command& command) const
+{
+    if (command.argv.is_empty() || command.should_immediately_execute_next)
+        return false;
+
+    // Builtins and functions need us to run in the child.
+    auto& name = command.argv.first();
+    if (has_builtin(name) || m_functions.contains(name))
+        return false;
+
+    // So does handing the terminal over to the child, which must be done before it execs.
+    // A subshell leaves that to its parent, and without a terminal there's nothing to hand over.
+    if (!m_is_subshell && (isatty(STDIN_FILENO) || isatty(STDOUT_FILENO)))
+        return false;
+
+    return true;
+}
+
+Optional<pid_t> Shell::spawn_process(const AST::Command& command, const NonnullRefPtrVector<AST::Rewiring>& rewirings, const FileDescriptionCollector& fds, Vector<const char*> const& argv, Optional<pid_t> process_group)
+{
+    // Only spawn programs we know to exist; the fork() path reports everything else nicely.
+    auto& name = command.argv.first();
+    String path = name.contains('/') ? name : Core::find_executable_in_path(name);
+    struct stat st;
+    if (path.is_empty() || access(path.characters(), X_OK) < 0 || stat(path.characters(), &st) < 0 || S_ISDIR(st.st_mode))
+        return {};
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    ScopeGuard destroy_file_actions = [&] { posix_spawn_file_actions_destroy(&file_actions); };
+
+    // These are the same steps as the fork() path takes in the child, see run_command().
+    Vector<int, 32> closed_fds;
+    auto close_in_child = [&](int fd) {
+        if (fd < 0 || closed_fds.contains_slow(fd))
+            return;
+        closed_fds.append(fd);
+        posix_spawn_file_actions_addclose(&file_actions, fd);
+    };
+
+    for (auto& rewiring : rewirings) {
+        posix_spawn_file_actions_adddup2(&file_actions, rewiring.old_fd, rewiring.new_fd);
+        if (rewiring.other_pipe_end) {
+            if (rewiring.fd_action == AST::Rewiring::Close::RefreshNew)
+                close_in_child(rewiring.other_pipe_end->new_fd);
+            else if (rewiring.fd_action == AST::Rewiring::Close::RefreshOld)
+                close_in_child(rewiring.other_pipe_end->old_fd);
+        }
+    }
+
+    for (auto fd : fds.fds())
+        close_in_child(fd);
+
+    for (auto& deferred : m_deferred_pipe_source_builtins) {
+        for (auto fd : deferred.fds.fds())
+            close_in_child(fd);
+    }
+
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    ScopeGuard destroy_attributes = [&] { posix_spawnattr_destroy(&attributes); };
+
+    if (process_group.has_value()) {
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attributes, *process_group);
+    }
 
-    return *job;
+    pid_t child;
+    if (auto rc = posix_spawn(&child, path.characters(), &file_actions, &attributes, const_cast<char* const*>(argv.data()), environ); rc != 0) {
+        dbgln_if(SH_DEBUG, "posix_spawn({}) failed: {}", path, strerror(rc));
+        return {};
+    }
+
+    dbgln_if(SH_DEBUG, "Spawned {} as {}", path, child);
+    return child;
 }
 
 void Shell::execute_process(Vector<const char*>&& argv)
@@ -948,7 +1068,8 @@ NonnullRefPtrVector<Job> Shell::run_commands(Vector<AST::Command>& commands)
 
     NonnullRefPtrVector<Job> spawned_jobs;
 
-    for (auto& command : commands) {
+    for (size_t i = 0; i < commands.size(); ++i) {
+        auto& command = commands[i];
         if constexpr (SH_DEBUG) {
             dbgln("Command");
             for (auto& arg : command.argv)
@@ -968,12 +1089,30 @@ NonnullRefPtrVector<Job> Shell::run_commands(Vector<AST::Command>& commands)
                 }
             }
         }
+        if (i + 1 < commands.size() && can_defer_pipe_source_builtin(command, commands[i + 1])) {
+            if (options.verbose)
+                warnln("+ {}", command);
+
+            NonnullRefPtrVector<AST::Rewiring> rewirings;
+            FileDescriptionCollector fds;
+            if (auto result = resolve_redirections(command, rewirings, fds); result.is_error()) {
+                raise_error(ShellError::LaunchError, String::formatted("{} while running '{}'", result.error(), command.argv.first()), command.position);
+                break;
+            }
+            m_deferred_pipe_source_builtins.append({ command, move(rewirings), move(fds) });
+            continue;
+        }
+
         auto job_result = run_command(command);
         if (job_result.is_error()) {
             raise_error(ShellError::LaunchError, String::formatted("{} while running '{}'", job_result.error(), command.argv.first()), command.position);
             break;
         }
 
+        // Whatever reads from the deferred builtins is running now, so they can't block on a full pipe anymore.
+        if (!command.is_pipe_source)
+            run_deferred_pipe_source_builtins();
+
         auto job = job_result.release_value();
         if (!job)
             continue;
@@ -988,6 +1127,9 @@ NonnullRefPtrVector<Job> Shell::run_commands(Vector<AST::Command>& commands)
         }
     }
 
+    // Anything still deferred here lost its reader to an error, dropping it closes its end of the pipe.
+    m_deferred_pipe_source_builtins.clear();
+
     if (m_error != ShellError::None) {
         possibly_print_error();
         if (!is_control_flow(m_error))
@@ -997,6 +1139,49 @@ NonnullRefPtrVector<Job> Shell::run_commands(Vector<AST::Command>& commands)
     return spawned_jobs;
 }
 
+bool Shell::can_defer_pipe_source_builtin(const AST::Command& source, const AST::Command& sink) const
+{
+    // Builtins that only print something, so it doesn't matter whether they run in a child or in the shell itself.
+    static constexpr Array output_only_builtins { ":"sv, "history"sv, "jobs"sv, "noop"sv, "pwd"sv, "type"sv };
+
+    if (!source.is_pipe_source || source.argv.is_empty() || source.should_immediately_execute_next || !source.next_chain.is_empty())
+        return false;
+    if (!output_only_builtins.span().contains_slow(source.argv.first()))
+        return false;
+
+    // The builtin only runs once whatever reads its output has been started, and that must not be
+    // something that runs in the shell itself, or neither of them would get anywhere.
+    if (sink.argv.is_empty() || sink.should_immediately_execute_next)
+        return false;
+    if (sink.should_wait && has_builtin(sink.argv.first()))
+        return false;
+
+    return true;
+}
+
+void Shell::run_deferred_pipe_source_builtins()
+{
+    if (m_deferred_pipe_source_builtins.is_empty())
+        return;
+
+    // The reader may exit before the builtin is done writing, which must not take the shell down with it.
+    struct sigaction ignore_action { };
+    ignore_action.sa_handler = SIG_IGN;
+    struct sigaction previous_action { };
+    sigaction(SIGPIPE, &ignore_action, &previous_action);
+
+    for (auto& deferred : m_deferred_pipe_source_builtins) {
+        int retval = 0;
+        (void)run_builtin(deferred.command, deferred.rewirings, retval);
+    }
+
+    clearerr(stdout);
+    sigaction(SIGPIPE, &previous_action, nullptr);
+
+    // This closes our end of their pipes, letting the readers see EOF.
+    m_deferred_pipe_source_builtins.clear();
+}
+
 bool Shell::run_file(const String& filename, bool explicitly_invoked)
 {
     TemporaryChange script_change { current_script, filename };
@@ -1013,8 +1198,35 @@ bool Shell::run_file(const String& filename, bool explicitly_invoked)
         return false;
     }
     auto file = file_result.value();
-    auto data = file->read_all();
-    return run_command(data) == 0;
+
+    // A script that's sourced over and over (say, from a loop or a function) is only parsed again if it changed.
+    struct stat st;
+    if (fstat(file->fd(), &st) < 0)
+        return run_command(file->read_all()) == 0;
+
+    auto is_unchanged = [&](ParsedScript const& script) {
+        return script.device == st.st_dev
+            && script.inode == st.st_ino
+            && script.size == st.st_size
+            && script.modification_time.tv_sec == st.st_mtim.tv_sec
+            && script.modification_time.tv_nsec == st.st_mtim.tv_nsec;
+    };
+
+    RefPtr<AST::Node> node;
+    if (auto script = m_parsed_scripts.get(filename); script.has_value() && is_unchanged(*script)) {
+        dbgln_if(SH_DEBUG, "Using the cached parse of {}", filename);
+        node = script->node;
+    } else {
+        auto data = file->read_all();
+        if (!data.is_empty())
+            node = Parser(data, m_is_interactive).parse();
+        if (node && !node->is_syntax_error())
+            m_parsed_scripts.set(filename, { st.st_dev, st.st_ino, st.st_size, st.st_mtim, node });
+        else
+            m_parsed_scripts.remove(filename);
+    }
+
+    return run_parsed_command(move(node)) == 0;
 }
 
 bool Shell::is_allowed_to_modify_termios(const AST::Command& command) const
@@ -20,6 +20,7 @@
 #include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibLine/Editor.h>
+#include <sys/stat.h>
 #include <termios.h>
 
 #define ENUMERATE_SHELL_BUILTINS()     \
@@ -316,6 +317,14 @@ private:
     void run_tail(RefPtr<Job>);
     void run_tail(const AST::Command&, const AST::NodeWithAction&, int head_exit_code);
 
+    int run_parsed_command(RefPtr<AST::Node>);
+    ErrorOr<void> resolve_redirections(const AST::Command&, NonnullRefPtrVector<AST::Rewiring>&, FileDescriptionCollector&);
+    bool can_defer_pipe_source_builtin(const AST::Command& source, const AST::Command& sink) const;
+    void run_deferred_pipe_source_builtins();
+
+    bool can_be_spawned(const AST::Command&) const;
+    Optional<pid_t> spawn_process(const AST::Command&, const NonnullRefPtrVector<AST::Rewiring>&, const FileDescriptionCollector&, Vector<const char*> const& argv, Optional<pid_t> process_group);
+    NonnullRefPtr<Job> make_job(const AST::Command&, pid_t child, pid_t pgid);
     [[noreturn]] void execute_process(Vector<const char*>&& argv);
 
     virtual void custom_event(Core::CustomEvent&) override;
@@ -356,6 +365,27 @@ private:
     };
 
     HashMap<String, ShellFunction> m_functions;
+
+    // Sourced scripts are parsed once, and parsed again only when the file changes.
+    struct ParsedScript {
+        dev_t device { 0 };
+        ino_t inode { 0 };
+        off_t size { 0 };
+        struct timespec modification_time { };
+        RefPtr<AST::Node> node;
+    };
+
+    HashMap<String, ParsedScript> m_parsed_scripts;
+
+    // Builtins at the start of a pipeline that are run in this process once the rest of the pipeline
+    // has been started, instead of in a child of their own. See can_defer_pipe_source_builtin().
+    struct DeferredBuiltin {
+        AST::Command command;
+        NonnullRefPtrVector<AST::Rewiring> rewirings;
+        FileDescriptionCollector fds;
+    };
+
+    Vector<DeferredBuiltin> m_deferred_pipe_source_builtins;
     NonnullOwnPtrVector<LocalFrame> m_local_frames;
     NonnullRefPtrVector<AST::Redirection> m_global_redirections;
 
@@ -5,9 +5,11 @@ source $(dirname "$0")/test-commons.inc
 # `head -n 1` should close stdout of the `Shell -c` command, which means the
 # second echo should exit unsuccessfully and sigpipe.sh.out should not be
 # created.
+# The sleep gives `head` time to exit; otherwise the second echo may well be
+# done before `head` is, as commands start fast enough to win that race.
 rm -f sigpipe.sh.out
 
-{ echo foo && echo bar && echo baz > sigpipe.sh.out } | head -n 1 > /dev/null
+{ echo foo && sleep 0.5 && echo bar && echo baz > sigpipe.sh.out } | head -n 1 > /dev/null
 
 # Failing commands don't make the test fail, just an explicit `exit 1` does.
 # So the test only fails if sigpipe.sh.out exists (since then `exit 1` runs),
@@ -14,10 +14,13 @@
 #include <LibMain/Main.h>
 #include <math.h>
 #include <stdio.h>
+#include <time.h>
 
-// The Kernel has issues with very large anonymous buffers.
-// FIXME: This appears to be fine for now, but it's really a hack.
-constexpr size_t LOAD_CHUNK_SIZE = 128 * KiB;
+constexpr size_t LOAD_CHUNK_SIZE = 16 * KiB;
+// About one and a half seconds at 44.1 kHz, which gives us plenty of time to load the next chunk.
+constexpr size_t RING_BUFFER_SIZE = 64 * KiB;
+// How long to wait for the server to make room in the ring buffer.
+static timespec const s_ring_buffer_wait_time { 0, 10'000'000 };
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -47,6 +50,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     }
     auto loader = maybe_loader.release_value();
 
+    TRY(audio_client->create_ring_buffer(RING_BUFFER_SIZE));
+
     TRY(Core::System::pledge("stdio sendfd"));
 
     outln("\033[34;1m Playing\033[0m: {}", path);
@@ -57,14 +62,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         loader->num_channels() == 1 ? "Mono" : "Stereo");
     out("\033[34;1mProgress\033[0m: \033[s");
 
-    auto resampler = Audio::ResampleHelper<double>(loader->sample_rate(), audio_client->get_sample_rate());
+    Audio::PolyphaseResampler resampler(loader->sample_rate(), audio_client->get_sample_rate());
 
     // If we're downsampling, we need to appropriately load more samples at once.
     size_t const load_size = static_cast<size_t>(LOAD_CHUNK_SIZE * static_cast<double>(loader->sample_rate()) / static_cast<double>(audio_client->get_sample_rate()));
-    // We assume that the loader can load samples at at least 2x speed (testing confirms 9x-12x for FLAC, 14x for WAV).
-    // Therefore, when the server-side buffer can only play as long as the time it takes us to load a chunk,
-    // we give it new data.
-    int const min_buffer_size = load_size / 2;
 
     for (;;) {
         auto samples = loader->get_more_samples(load_size);
@@ -94,9 +95,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                         total_minutes, total_seconds_of_minute);
                 }
                 fflush(stdout);
-                resampler.reset();
                 auto resampled_samples = TRY(Audio::resample_buffer(resampler, *samples.value()));
-                audio_client->async_enqueue(*resampled_samples);
+                Span<Audio::Sample const> remaining_samples { resampled_samples->samples(), static_cast<size_t>(resampled_samples->sample_count()) };
+                for (;;) {
+                    remaining_samples = remaining_samples.slice(audio_client->write_to_ring_buffer(remaining_samples));
+                    if (remaining_samples.is_empty())
+                        break;
+                    // The server has enough data for now
+                    nanosleep(&s_ring_buffer_wait_time, nullptr);
+                }
             } else if (should_loop) {
                 // We're done: now loop
                 auto result = loader->reset();
@@ -107,10 +114,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             } else if (samples.value()->sample_count() == 0 && audio_client->get_remaining_samples() == 0) {
                 // We're done and the server is done
                 break;
-            }
-            while (audio_client->get_remaining_samples() > min_buffer_size) {
-                // The server has enough data for now
-                sleep(1);
+            } else {
+                nanosleep(&s_ring_buffer_wait_time, nullptr);
             }
         } else {
             outln();
@@ -10,10 +10,10 @@
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DateTime.h>
-#include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/DirectoryTree.h>
 #include <limits.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -35,7 +35,7 @@ struct DuOption {
 };
 
 static ErrorOr<void> parse_args(Main::Arguments arguments, Vector<String>& files, DuOption& du_option, int& max_depth);
-static ErrorOr<off_t> print_space_usage(const String& path, const DuOption& du_option, int max_depth, bool inside_dir = false);
+static ErrorOr<off_t> print_space_usage(const String& path, struct stat const& path_stat, Threading::DirectoryTreeNode const* directory, const DuOption& du_option, bool inside_dir = false);
 
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
@@ -45,8 +45,14 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     TRY(parse_args(arguments, files, du_option, max_depth));
 
-    for (const auto& file : files)
-        TRY(print_space_usage(file, du_option, max_depth));
+    for (const auto& file : files) {
+        auto path_stat = TRY(Core::System::lstat(file.characters()));
+        // Reading the tree up front lets us read many directories at once, which matters a lot on slow storage.
+        Optional<Threading::DirectoryTreeNode> tree;
+        if (max_depth > 0 && S_ISDIR(path_stat.st_mode))
+            tree = Threading::read_directory_tree(file, { .max_depth = max_depth - 1, .stat_entries = true });
+        TRY(print_space_usage(file, path_stat, tree.has_value() ? &tree.value() : nullptr, du_option));
+    }
 
     return 0;
 }
@@ -118,21 +124,21 @@ ErrorOr<void> parse_args(Main::Arguments arguments, Vector<String>& files, DuOpt
     return {};
 }
 
-ErrorOr<off_t> print_space_usage(const String& path, const DuOption& du_option, int max_depth, bool inside_dir)
+ErrorOr<off_t> print_space_usage(const String& path, struct stat const& path_stat, Threading::DirectoryTreeNode const* directory, const DuOption& du_option, bool inside_dir)
 {
-    struct stat path_stat = TRY(Core::System::lstat(path.characters()));
     off_t directory_size = 0;
     const bool is_directory = S_ISDIR(path_stat.st_mode);
-    if (--max_depth >= 0 && is_directory) {
-        auto di = Core::DirIterator(path, Core::DirIterator::SkipParentAndBaseDir);
-        if (di.has_error()) {
-            outln("du: cannot read directory '{}': {}", path, di.error_string());
+    if (directory) {
+        if (directory->error != 0) {
+            outln("du: cannot read directory '{}': {}", path, strerror(directory->error));
             return Error::from_string_literal("An error occurred. See previous error."sv);
         }
 
-        while (di.has_next()) {
-            const auto child_path = di.next_full_path();
-            directory_size += TRY(print_space_usage(child_path, du_option, max_depth, true));
+        for (const auto& child : directory->children) {
+            const auto child_path = path.ends_with('/') ? String::formatted("{}{}", path, child.name) : String::formatted("{}/{}", path, child.name);
+            if (child.error != 0)
+                return Error::from_syscall("lstat"sv, -child.error);
+            directory_size += TRY(print_space_usage(child_path, child.stat, child.is_directory() ? &child : nullptr, du_option, true));
         }
     }
 
@@ -4,17 +4,28 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AllOf.h>
+#include <AK/AnyOf.h>
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
+#include <AK/ByteBuffer.h>
+#include <AK/MemMem.h>
 #include <AK/ScopeGuard.h>
 #include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <LibRegex/Regex.h>
+#include <LibThreading/DirectoryTree.h>
+#include <LibThreading/ThreadPool.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 enum class BinaryFileMode {
@@ -32,25 +43,380 @@ void fail(StringView format, Ts... args)
     abort();
 }
 
+struct GrepOptions {
+    BinaryFileMode binary_mode { BinaryFileMode::Binary };
+    bool invert_match { false };
+    bool quiet_mode { false };
+    bool suppress_errors { false };
+    bool line_numbers { false };
+    bool colored_output { false };
+    bool count_lines { false };
+    bool user_specified_multiple_files { false };
+};
+
+struct MatchedRange {
+    size_t offset { 0 };
+    size_t length { 0 };
+};
+
+struct FileResult {
+    String output;
+    String errors;
+    bool opened { true };
+    bool matched { false };
+};
+
+// Patterns without any special characters only match themselves, so we can look for them without the regex engine.
+static bool is_literal_pattern(StringView pattern)
+{
+    return !pattern.is_empty() && !pattern.find_any_of("\\.[]()*+?{}|^$"sv).has_value();
+}
+
+// The contents of a file, mapped into memory if it's a regular file.
+class FileContents {
+public:
+    static ErrorOr<FileContents> read(StringView path)
+    {
+        auto fd = TRY(Core::System::open(path, O_RDONLY | O_CLOEXEC));
+        auto stat_or_error = Core::System::fstat(fd);
+        if (stat_or_error.is_error()) {
+            (void)Core::System::close(fd);
+            return stat_or_error.release_error();
+        }
+
+        FileContents contents;
+        if (S_ISREG(stat_or_error.value().st_mode) && stat_or_error.value().st_size > 0) {
+            contents.m_mapped_file = TRY(Core::MappedFile::map_from_fd_and_close(fd, path, Core::MappedFile::AccessPattern::Sequential));
+            return contents;
+        }
+
+        // Pipes, devices and synthetic files can't be mapped (and may claim to be empty), so read them in full instead.
+        ScopeGuard close_fd_guard = [fd] { (void)Core::System::close(fd); };
+        u8 buffer[64 * KiB];
+        for (;;) {
+            auto nread = TRY(Core::System::read(fd, { buffer, sizeof(buffer) }));
+            if (nread == 0)
+                break;
+            TRY(contents.m_buffer.try_append(buffer, nread));
+        }
+        return contents;
+    }
+
+    ReadonlyBytes bytes() const { return m_mapped_file ? m_mapped_file->bytes() : m_buffer.bytes(); }
+
+private:
+    RefPtr<Core::MappedFile> m_mapped_file;
+    ByteBuffer m_buffer;
+};
+
+static size_t count_newlines(ReadonlyBytes bytes)
+{
+    size_t count = 0;
+    for (size_t offset = 0; offset < bytes.size(); ++count) {
+        auto newline = AK::memchr_optional(bytes.data() + offset, bytes.size() - offset, '\n');
+        if (!newline.has_value())
+            break;
+        offset += *newline + 1;
+    }
+    return count;
+}
+
+// Searches lines for the patterns. Regexes keep state while matching, so every thread needs its own searcher.
+template<typename RegexType>
+class Searcher {
+public:
+    Searcher(GrepOptions const& options, Vector<StringView> const& patterns, PosixOptions regex_options)
+        : m_options(options)
+        , m_patterns(patterns)
+        , m_use_literal_search(!(regex_options & PosixFlags::Insensitive) && all_of(patterns, is_literal_pattern))
+    {
+        if (m_use_literal_search)
+            return;
+        for (auto pattern : patterns)
+            m_regular_expressions.append(RegexType(pattern, regex_options));
+    }
+
+    bool has_parse_error() const
+    {
+        return any_of(m_regular_expressions, [](auto& re) { return re.parser_result.error != regex::Error::NoError; });
+    }
+
+    // Appends what should be printed for the line to `output`, and returns whether it was selected.
+    bool match_line(StringView line, StringView filename, size_t line_number, bool print_filename, bool is_binary, StringBuilder& output)
+    {
+        size_t last_printed_char_pos { 0 };
+        if (is_binary && m_options.binary_mode == BinaryFileMode::Skip)
+            return false;
+
+        for (size_t i = 0; i < m_patterns.size(); ++i) {
+            auto success = match_pattern(i, line);
+            if (!(success ^ m_options.invert_match))
+                continue;
+
+            if (m_options.quiet_mode)
+                return true;
+
+            if (m_options.count_lines) {
+                m_matched_line_count++;
+                return true;
+            }
+
+            auto colored_output = m_options.colored_output;
+            if (is_binary && m_options.binary_mode == BinaryFileMode::Binary) {
+                output.appendff(colored_output ? "binary file \x1B[34m{}\x1B[0m matches\n" : "binary file {} matches\n", filename);
+            } else {
+                if ((m_ranges.size() || m_options.invert_match) && print_filename)
+                    output.appendff(colored_output ? "\x1B[34m{}:\x1B[0m" : "{}:", filename);
+                if ((m_ranges.size() || m_options.invert_match) && m_options.line_numbers)
+                    output.appendff(colored_output ? "\x1B[35m{}:\x1B[0m" : "{}:", line_number);
+
+                for (auto& range : m_ranges) {
+                    output.appendff(colored_output ? "{}\x1B[32m{}\x1B[0m" : "{}{}",
+                        line.substring_view(last_printed_char_pos, range.offset - last_printed_char_pos),
+                        line.substring_view(range.offset, range.length));
+                    last_printed_char_pos = range.offset + range.length;
+                }
+                output.append(line.substring_view(last_printed_char_pos));
+                output.append('\n');
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    FileResult search_file(StringView filename, bool print_filename)
+    {
+        FileResult result;
+        auto contents_or_error = FileContents::read(filename);
+        if (contents_or_error.is_error()) {
+            result.opened = false;
+            if (!m_options.suppress_errors)
+                result.errors = String::formatted("Failed to open {}: {}\n", filename, strerror(contents_or_error.error().code()));
+            return result;
+        }
+        auto bytes = contents_or_error.value().bytes();
+
+        // With a single literal and no inverted matching, only lines containing the literal are of interest,
+        // so we can skip straight to the next occurrence instead of looking at every line.
+        bool can_skip_to_occurrences = m_use_literal_search && m_patterns.size() == 1 && !m_options.invert_match;
+        auto needle = m_patterns.is_empty() ? StringView {} : m_patterns.first();
+
+        StringBuilder output;
+        m_matched_line_count = 0;
+        size_t line_number = 1;
+        for (size_t position = 0; position < bytes.size(); ++line_number) {
+            if (can_skip_to_occurrences) {
+                auto occurrence = AK::memmem_optional(bytes.data() + position, bytes.size() - position, needle.characters_without_null_termination(), needle.length());
+                if (!occurrence.has_value())
+                    break;
+                auto line_start = position + *occurrence;
+                while (line_start > position && bytes[line_start - 1] != '\n')
+                    --line_start;
+                if (m_options.line_numbers)
+                    line_number += count_newlines(bytes.slice(position, line_start - position));
+                position = line_start;
+            }
+
+            auto newline = AK::memchr_optional(bytes.data() + position, bytes.size() - position, '\n');
+            auto line_length = newline.value_or(bytes.size() - position);
+            StringView line { bytes.data() + position, line_length };
+            position += line_length + 1;
+
+            auto is_binary = AK::memchr_optional(line.characters_without_null_termination(), line.length(), 0).has_value();
+            if (!match_line(line, filename, line_number, print_filename, is_binary, output))
+                continue;
+            result.matched = true;
+            if (m_options.quiet_mode || (is_binary && m_options.binary_mode == BinaryFileMode::Binary))
+                break;
+        }
+
+        if (m_options.count_lines && !m_options.quiet_mode) {
+            if (m_options.user_specified_multiple_files)
+                output.appendff("{}:{}\n", filename, m_matched_line_count);
+            else
+                output.appendff("{}\n", m_matched_line_count);
+        }
+
+        result.output = output.to_string();
+        return result;
+    }
+
+    size_t take_matched_line_count() { return exchange(m_matched_line_count, 0); }
+
+private:
+    // Returns whether the pattern matches the line, and leaves the parts of the line that it matched in m_ranges.
+    bool match_pattern(size_t pattern_index, StringView line)
+    {
+        m_ranges.clear_with_capacity();
+        if (m_use_literal_search) {
+            auto needle = m_patterns[pattern_index];
+            for (size_t offset = 0; offset + needle.length() <= line.length();) {
+                auto occurrence = AK::memmem_optional(line.characters_without_null_termination() + offset, line.length() - offset, needle.characters_without_null_termination(), needle.length());
+                if (!occurrence.has_value())
+                    break;
+                m_ranges.append({ offset + *occurrence, needle.length() });
+                offset += *occurrence + needle.length();
+            }
+            return !m_ranges.is_empty();
+        }
+
+        auto result = m_regular_expressions[pattern_index].match(line, PosixFlags::Global);
+        for (auto& match : result.matches)
+            m_ranges.append({ match.global_offset, match.view.length() });
+        return result.success;
+    }
+
+    GrepOptions const& m_options;
+    Vector<StringView> m_patterns;
+    Vector<RegexType> m_regular_expressions;
+    bool m_use_literal_search { false };
+    Vector<MatchedRange> m_ranges;
+    size_t m_matched_line_count { 0 };
+};
+
+// Collects the files below a directory in the order a depth-first walk would find them.
+// Hidden files are skipped, and symlinks to directories are not followed.
+static void collect_files(Threading::DirectoryTreeNode const& directory, String const& path, Vector<String>& files, GrepOptions const& options)
+{
+    if (directory.error != 0 && !options.suppress_errors)
+        warnln("Failed to read {}: {}", path.is_empty() ? "."sv : path.view(), strerror(directory.error));
+
+    for (auto& entry : directory.children) {
+        if (entry.name.starts_with('.'))
+            continue;
+        auto entry_path = path.is_empty() ? entry.name : String::formatted("{}{}{}", path, path.ends_with('/') ? "" : "/", entry.name);
+        if (entry.is_directory())
+            collect_files(entry, entry_path, files, options);
+        else if (entry.type != DT_LNK || !Core::File::is_directory(entry_path))
+            files.append(move(entry_path));
+    }
+}
+
+// Searches the files on all threads, and prints the results in order. Returns false if it stopped at a file that couldn't be read.
+template<typename RegexType>
+static bool search_files(Vector<Searcher<RegexType>>& searchers, Span<String const> paths, bool print_filename, bool stop_at_failure, GrepOptions const& options, bool& did_match_something)
+{
+    // Files are searched in batches, so that the output of earlier files doesn't have to wait for all the others.
+    size_t const batch_size = searchers.size() * 16;
+
+    for (size_t batch_start = 0; batch_start < paths.size(); batch_start += batch_size) {
+        auto batch = paths.slice(batch_start, min(batch_size, paths.size() - batch_start));
+        Vector<FileResult> results;
+        results.resize(batch.size());
+
+        Atomic<size_t> next_index { 0 };
+        auto search_remaining_files = [&](Searcher<RegexType>& searcher) {
+            for (;;) {
+                auto index = next_index.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+                if (index >= batch.size())
+                    return;
+                results[index] = searcher.search_file(batch[index], print_filename);
+            }
+        };
+
+        Threading::TaskGroup group;
+        for (size_t i = 1; i < min(searchers.size(), batch.size()); ++i)
+            group.spawn([&, i] { search_remaining_files(searchers[i]); });
+        search_remaining_files(searchers[0]);
+        group.wait();
+
+        for (auto& result : results) {
+            if (!result.errors.is_empty())
+                warn("{}", result.errors);
+            out("{}", result.output);
+            did_match_something = did_match_something || result.matched;
+            if (!result.opened && stop_at_failure)
+                return false;
+            if (result.matched && options.quiet_mode)
+                return true;
+        }
+    }
+    return true;
+}
+
+template<typename RegexType>
+static int grep(GrepOptions const& options, Vector<StringView> const& patterns, PosixOptions regex_options, Vector<char const*> const& files, bool recursive)
+{
+    auto& pool = Threading::ThreadPool::the();
+    Vector<Searcher<RegexType>> searchers;
+    for (size_t i = 0; i < (files.is_empty() && !recursive ? 1 : pool.concurrency()); ++i)
+        searchers.empend(options, patterns, regex_options);
+    if (searchers.first().has_parse_error())
+        return 1;
+
+    bool did_match_something = false;
+    if (!files.size() && !recursive) {
+        auto& searcher = searchers.first();
+        StringBuilder output;
+        char* line = nullptr;
+        size_t line_len = 0;
+        ssize_t nread = 0;
+        ScopeGuard free_line = [line] { free(line); };
+        size_t line_number = 0;
+        while ((nread = getline(&line, &line_len, stdin)) != -1) {
+            VERIFY(nread > 0);
+            if (line[nread - 1] == '\n')
+                --nread;
+            // Human-readable indexes start at 1, so it's fine to increment already.
+            line_number += 1;
+            StringView line_view(line, nread);
+            bool is_binary = line_view.contains(0);
+
+            if (is_binary && options.binary_mode == BinaryFileMode::Skip)
+                return 1;
+
+            output.clear();
+            auto matched = searcher.match_line(line_view, "stdin", line_number, false, is_binary, output);
+            out("{}", output.string_view());
+            did_match_something = did_match_something || matched;
+            if (matched && is_binary && options.binary_mode == BinaryFileMode::Binary)
+                break;
+        }
+
+        if (options.count_lines && !options.quiet_mode)
+            outln("{}", searcher.take_matched_line_count());
+    } else if (recursive) {
+        Vector<String> paths;
+        auto add_root = [&](String const& root, String const& path_prefix) {
+            if (!Core::File::is_directory(root)) {
+                paths.append(root);
+                return;
+            }
+            auto tree = Threading::read_directory_tree(root);
+            collect_files(tree, path_prefix, paths, options);
+        };
+        if (files.is_empty()) {
+            add_root(".", {});
+        } else {
+            for (auto* filename : files)
+                add_root(filename, filename);
+        }
+        search_files(searchers, paths.span(), true, false, options, did_match_something);
+    } else {
+        Vector<String> paths;
+        for (auto* filename : files)
+            paths.append(filename);
+        if (!search_files(searchers, paths.span(), files.size() > 1, true, options, did_match_something))
+            return 1;
+    }
+
+    return did_match_something ? 0 : 1;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments args)
 {
-    TRY(Core::System::pledge("stdio rpath", nullptr));
+    TRY(Core::System::pledge("stdio rpath thread", nullptr));
 
     Vector<const char*> files;
 
     bool recursive { false };
     bool use_ere { false };
     Vector<const char*> patterns;
-    BinaryFileMode binary_mode { BinaryFileMode::Binary };
     bool case_insensitive = false;
-    bool line_numbers = false;
-    bool invert_match = false;
-    bool quiet_mode = false;
-    bool suppress_errors = false;
-    bool colored_output = isatty(STDOUT_FILENO);
-    bool count_lines = false;
-
-    size_t matched_line_count = 0;
+    GrepOptions options;
+    options.colored_output = isatty(STDOUT_FILENO);
 
     Core::ArgsParser args_parser;
     args_parser.add_option(recursive, "Recursively scan files", "recursive", 'r');
@@ -67,21 +433,21 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         },
     });
     args_parser.add_option(case_insensitive, "Make matches case-insensitive", nullptr, 'i');
-    args_parser.add_option(line_numbers, "Output line-numbers", "line-numbers", 'n');
-    args_parser.add_option(invert_match, "Select non-matching lines", "invert-match", 'v');
-    args_parser.add_option(quiet_mode, "Do not write anything to standard output", "quiet", 'q');
-    args_parser.add_option(suppress_errors, "Suppress error messages for nonexistent or unreadable files", "no-messages", 's');
+    args_parser.add_option(options.line_numbers, "Output line-numbers", "line-numbers", 'n');
+    args_parser.add_option(options.invert_match, "Select non-matching lines", "invert-match", 'v');
+    args_parser.add_option(options.quiet_mode, "Do not write anything to standard output", "quiet", 'q');
+    args_parser.add_option(options.suppress_errors, "Suppress error messages for nonexistent or unreadable files", "no-messages", 's');
     args_parser.add_option(Core::ArgsParser::Option {
         .requires_argument = true,
         .help_string = "Action to take for binary files ([binary], text, skip)",
         .long_name = "binary-mode",
         .accept_value = [&](auto* str) {
             if ("text"sv == str)
-                binary_mode = BinaryFileMode::Text;
+                options.binary_mode = BinaryFileMode::Text;
             else if ("binary"sv == str)
-                binary_mode = BinaryFileMode::Binary;
+                options.binary_mode = BinaryFileMode::Binary;
             else if ("skip"sv == str)
-                binary_mode = BinaryFileMode::Skip;
+                options.binary_mode = BinaryFileMode::Skip;
             else
                 return false;
             return true;
@@ -93,7 +459,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         .long_name = "text",
         .short_name = 'a',
         .accept_value = [&](auto) {
-            binary_mode = BinaryFileMode::Text;
+            options.binary_mode = BinaryFileMode::Text;
             return true;
         },
     });
@@ -103,7 +469,7 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         .long_name = nullptr,
         .short_name = 'I',
         .accept_value = [&](auto) {
-            binary_mode = BinaryFileMode::Skip;
+            options.binary_mode = BinaryFileMode::Skip;
             return true;
         },
     });
@@ -115,15 +481,15 @@ ErrorOr<int> serenity_main(Main::Arguments args)
         .value_name = "WHEN",
         .accept_value = [&](auto* str) {
             if ("never"sv == str)
-                colored_output = false;
+                options.colored_output = false;
             else if ("always"sv == str)
-                colored_output = true;
+                options.colored_output = true;
             else if ("auto"sv != str)
                 return false;
             return true;
         },
     });
-    args_parser.add_option(count_lines, "Output line count instead of line contents", "count", 'c');
+    args_parser.add_option(options.count_lines, "Output line count instead of line contents", "count", 'c');
     args_parser.add_positional_argument(files, "File(s) to process", "file", Core::ArgsParser::Required::No);
     args_parser.parse(args);
 
@@ -131,162 +497,17 @@ ErrorOr<int> serenity_main(Main::Arguments args)
     if (patterns.size() == 0 && files.size())
         patterns.append(files.take_first());
 
-    auto user_has_specified_files = !files.is_empty();
-    auto user_specified_multiple_files = files.size() >= 2;
+    options.user_specified_multiple_files = files.size() >= 2;
 
-    PosixOptions options {};
+    PosixOptions regex_options {};
     if (case_insensitive)
-        options |= PosixFlags::Insensitive;
-
-    auto grep_logic = [&](auto&& regular_expressions) {
-        for (auto& re : regular_expressions) {
-            if (re.parser_result.error != regex::Error::NoError) {
-                return 1;
-            }
-        }
-
-        auto matches = [&](StringView str, StringView filename, size_t line_number, bool print_filename, bool is_binary) {
-            size_t last_printed_char_pos { 0 };
-            if (is_binary && binary_mode == BinaryFileMode::Skip)
-                return false;
-
-            for (auto& re : regular_expressions) {
-                auto result = re.match(str, PosixFlags::Global);
-                if (!(result.success ^ invert_match))
-                    continue;
-
-                if (quiet_mode)
-                    return true;
-
-                if (count_lines) {
-                    matched_line_count++;
-                    return true;
-                }
+        regex_options |= PosixFlags::Insensitive;
 
-                if (is_binary && binary_mode == BinaryFileMode::Binary) {
-                    outln(colored_output ? "binary file \x1B[34m{}\x1B[0m matches" : "binary file {} matches", filename);
-                } else {
-                    if ((result.matches.size() || invert_match) && print_filename)
-                        out(colored_output ? "\x1B[34m{}:\x1B[0m" : "{}:", filename);
-                    if ((result.matches.size() || invert_match) && line_numbers)
-                        out(colored_output ? "\x1B[35m{}:\x1B[0m" : "{}:", line_number);
-
-                    for (auto& match : result.matches) {
-                        out(colored_output ? "{}\x1B[32m{}\x1B[0m" : "{}{}",
-                            StringView(&str[last_printed_char_pos], match.global_offset - last_printed_char_pos),
-                            match.view.to_string());
-                        last_printed_char_pos = match.global_offset + match.view.length();
-                    }
-                    outln("{}", StringView(&str[last_printed_char_pos], str.length() - last_printed_char_pos));
-                }
-
-                return true;
-            }
+    Vector<StringView> pattern_views;
+    for (auto* pattern : patterns)
+        pattern_views.append(pattern);
 
-            return false;
-        };
-
-        auto handle_file = [&matches, binary_mode, suppress_errors, count_lines, quiet_mode,
-                               user_specified_multiple_files, &matched_line_count](StringView filename, bool print_filename) -> bool {
-            auto file = Core::File::construct(filename);
-            if (!file->open(Core::OpenMode::ReadOnly)) {
-                if (!suppress_errors)
-                    warnln("Failed to open {}: {}", filename, file->error_string());
-                return false;
-            }
-
-            for (size_t line_number = 1; file->can_read_line(); ++line_number) {
-                auto line = file->read_line();
-                auto is_binary = memchr(line.characters(), 0, line.length()) != nullptr;
-
-                if (matches(line, filename, line_number, print_filename, is_binary) && is_binary && binary_mode == BinaryFileMode::Binary)
-                    break;
-            }
-
-            if (count_lines && !quiet_mode) {
-                if (user_specified_multiple_files)
-                    outln("{}:{}", filename, matched_line_count);
-                else
-                    outln("{}", matched_line_count);
-                matched_line_count = 0;
-            }
-
-            return true;
-        };
-
-        auto add_directory = [&handle_file, user_has_specified_files](String base, Optional<String> recursive, auto handle_directory) -> void {
-            Core::DirIterator it(recursive.value_or(base), Core::DirIterator::Flags::SkipDots);
-            while (it.has_next()) {
-                auto path = it.next_full_path();
-                if (!Core::File::is_directory(path)) {
-                    auto key = user_has_specified_files ? path.view() : path.substring_view(base.length() + 1, path.length() - base.length() - 1);
-                    handle_file(key, true);
-                } else {
-                    handle_directory(base, path, handle_directory);
-                }
-            }
-        };
-
-        bool did_match_something = false;
-        if (!files.size() && !recursive) {
-            char* line = nullptr;
-            size_t line_len = 0;
-            ssize_t nread = 0;
-            ScopeGuard free_line = [line] { free(line); };
-            size_t line_number = 0;
-            while ((nread = getline(&line, &line_len, stdin)) != -1) {
-                VERIFY(nread > 0);
-                if (line[nread - 1] == '\n')
-                    --nread;
-                // Human-readable indexes start at 1, so it's fine to increment already.
-                line_number += 1;
-                StringView line_view(line, nread);
-                bool is_binary = line_view.contains(0);
-
-                if (is_binary && binary_mode == BinaryFileMode::Skip)
-                    return 1;
-
-                auto matched = matches(line_view, "stdin", line_number, false, is_binary);
-                did_match_something = did_match_something || matched;
-                if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
-                    break;
-            }
-
-            if (count_lines && !quiet_mode)
-                outln("{}", matched_line_count);
-        } else {
-            if (recursive) {
-                if (user_has_specified_files) {
-                    for (auto& filename : files) {
-                        add_directory(filename, {}, add_directory);
-                    }
-                } else {
-                    add_directory(".", {}, add_directory);
-                }
-
-            } else {
-                bool print_filename { files.size() > 1 };
-                for (auto& filename : files) {
-                    if (!handle_file(filename, print_filename))
-                        return 1;
-                }
-            }
-        }
-
-        return did_match_something ? 0 : 1;
-    };
-
-    if (use_ere) {
-        Vector<Regex<PosixExtended>> regular_expressions;
-        for (auto pattern : patterns) {
-            regular_expressions.append(Regex<PosixExtended>(pattern, options));
-        }
-        return grep_logic(regular_expressions);
-    }
-
-    Vector<Regex<PosixBasic>> regular_expressions;
-    for (auto pattern : patterns) {
-        regular_expressions.append(Regex<PosixBasic>(pattern, options));
-    }
-    return grep_logic(regular_expressions);
+    if (use_ere)
+        return grep<Regex<PosixExtended>>(options, pattern_views, regex_options, files, recursive);
+    return grep<Regex<PosixBasic>>(options, pattern_views, regex_options, files, recursive);
 }
@@ -18,11 +18,13 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     bool keep_input_files { false };
     bool write_to_stdout { false };
     bool decompress { false };
+    unsigned thread_count { 1 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
     args_parser.add_option(decompress, "Decompress", "decompress", 'd');
+    args_parser.add_option(thread_count, "Compress on this many threads", "processes", 'p', "N");
     args_parser.add_positional_argument(filenames, "Files", "FILES");
     args_parser.parse(arguments);
 
@@ -46,13 +48,15 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         RefPtr<Core::MappedFile> file;
         ReadonlyBytes input_bytes;
         if (TRY(Core::System::stat(input_filename)).st_size > 0) {
-            file = TRY(Core::MappedFile::map(input_filename));
+            file = TRY(Core::MappedFile::map(input_filename, Core::MappedFile::AccessPattern::Sequential));
             input_bytes = file->bytes();
         }
 
         AK::Optional<ByteBuffer> output_bytes;
         if (decompress)
             output_bytes = Compress::GzipDecompressor::decompress_all(input_bytes);
+        else if (thread_count > 1)
+            output_bytes = Compress::GzipCompressor::parallel_compress_all(input_bytes, thread_count);
         else
             output_bytes = Compress::GzipCompressor::compress_all(input_bytes);
 
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2022, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObject.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <AK/Statistics.h>
+#include <AK/Time.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Script.h>
+#include <LibMain/Main.h>
+
+static bool s_run_bytecode = false;
+
+struct BenchmarkResult {
+    String name;
+    AK::Statistics<u64> run_times_us;
+};
+
+static ErrorOr<void> collect_scripts(String const& path, Vector<String>& script_paths)
+{
+    if (!Core::File::is_directory(path)) {
+        script_paths.append(path);
+        return {};
+    }
+
+    Core::DirIterator iterator(path, Core::DirIterator::SkipDots);
+    if (iterator.has_error())
+        return Error::from_errno(iterator.error());
+    while (iterator.has_next()) {
+        auto entry = iterator.next_full_path();
+        if (Core::File::is_directory(entry))
+            TRY(collect_scripts(entry, script_paths));
+        else if (entry.ends_with(".js"sv))
+            script_paths.append(entry);
+    }
+    return {};
+}
+
+// Runs the script once in a fresh VM, so that no state (including the heap) carries over between runs.
+static ErrorOr<u64, String> run_script_once(StringView source, StringView source_name)
+{
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+
+    auto start_time = Time::now_monotonic();
+
+    auto script_or_error = JS::Script::parse(source, interpreter->realm(), source_name);
+    if (script_or_error.is_error())
+        return script_or_error.error()[0].to_string();
+    auto script = script_or_error.release_value();
+
+    JS::ThrowCompletionOr<JS::Value> result { JS::js_undefined() };
+    if (s_run_bytecode) {
+        auto executable_or_error = JS::Bytecode::Generator::generate(script->parse_node());
+        if (executable_or_error.is_error())
+            return executable_or_error.error().to_string();
+        auto executable = executable_or_error.release_value();
+        JS::Bytecode::Interpreter bytecode_interpreter(interpreter->global_object(), interpreter->realm());
+        result = bytecode_interpreter.run(*executable);
+    } else {
+        result = interpreter->run(*script);
+    }
+    vm->run_queued_promise_jobs();
+
+    auto elapsed_us = static_cast<u64>((Time::now_monotonic() - start_time).to_microseconds());
+
+    if (result.is_error())
+        return String::formatted("Uncaught exception: {}", result.throw_completion().value()->to_string_without_side_effects());
+    return elapsed_us;
+}
+
+static double to_ms(double microseconds)
+{
+    return microseconds / 1000.0;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    Vector<StringView> paths;
+    int iterations = 10;
+    int warmup_iterations = 2;
+    String output_path;
+    String baseline_path;
+    double threshold_percent = 5.0;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Run JavaScript benchmarks and compare them against a stored baseline.");
+    args_parser.add_option(iterations, "Number of measured runs per benchmark (default: 10)", "iterations", 'n', "count");
+    args_parser.add_option(warmup_iterations, "Number of unmeasured runs before measuring (default: 2)", "warmup", 'w', "count");
+    args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
+    args_parser.add_option(output_path, "Write the results to this JSON file, for use as a later baseline", "output", 'o', "path");
+    args_parser.add_option(baseline_path, "Compare the results against this JSON file", "baseline", 'c', "path");
+    args_parser.add_option(threshold_percent, "Median change in percent that counts as a regression (default: 5)", "threshold", 't', "percent");
+    args_parser.add_positional_argument(paths, "Benchmark scripts, or directories containing them", "paths");
+    args_parser.parse(arguments);
+
+    if (iterations <= 0) {
+        warnln("Need at least one measured iteration");
+        return 1;
+    }
+
+    Vector<String> script_paths;
+    for (auto& path : paths)
+        TRY(collect_scripts(path, script_paths));
+    quick_sort(script_paths);
+
+    Optional<JsonObject> baseline;
+    if (!baseline_path.is_empty()) {
+        auto baseline_file = TRY(Core::File::open(baseline_path, Core::OpenMode::ReadOnly));
+        auto baseline_json = TRY(JsonValue::from_string(baseline_file->read_all()));
+        if (!baseline_json.is_object()) {
+            warnln("Baseline {} is not a JSON object", baseline_path);
+            return 1;
+        }
+        baseline = baseline_json.as_object();
+    }
+
+    Vector<BenchmarkResult> results;
+    bool had_errors = false;
+
+    outln("{:<40} {:>10} {:>10} {:>10} {:>10}", "Benchmark", "min (ms)", "median", "mean", "stddev");
+    for (auto& script_path : script_paths) {
+        auto file = TRY(Core::File::open(script_path, Core::OpenMode::ReadOnly));
+        auto source = file->read_all();
+        auto name = LexicalPath::title(script_path);
+
+        BenchmarkResult result { name, {} };
+        Optional<String> error;
+        for (int i = 0; i < warmup_iterations + iterations && !error.has_value(); ++i) {
+            auto elapsed_or_error = run_script_once(source, script_path);
+            if (elapsed_or_error.is_error())
+                error = elapsed_or_error.release_error();
+            else if (i >= warmup_iterations)
+                result.run_times_us.add(elapsed_or_error.value());
+        }
+
+        if (error.has_value()) {
+            warnln("{}: {}", script_path, *error);
+            had_errors = true;
+            continue;
+        }
+
+        auto& statistics = result.run_times_us;
+        outln("{:<40} {:>10.2} {:>10.2} {:>10.2} {:>10.2}", name, to_ms(statistics.min()), to_ms(statistics.median()), to_ms(statistics.average()), to_ms(statistics.standard_deviation()));
+        results.append(move(result));
+    }
+
+    size_t regressions = 0;
+    if (baseline.has_value()) {
+        outln();
+        outln("{:<40} {:>12} {:>12} {:>10}", "Compared to baseline", "before (ms)", "after (ms)", "change");
+        for (auto& result : results) {
+            auto const* entry = baseline->get_ptr(result.name);
+            if (!entry || !entry->is_object()) {
+                outln("{:<40} {:>12} {:>12.2} {:>10}", result.name, "-", to_ms(result.run_times_us.median()), "new");
+                continue;
+            }
+            auto baseline_median = entry->as_object().get("median_us"sv).to_double();
+            auto median = static_cast<double>(result.run_times_us.median());
+            auto change_percent = baseline_median > 0 ? (median - baseline_median) / baseline_median * 100.0 : 0.0;
+
+            StringView verdict;
+            if (change_percent > threshold_percent) {
+                verdict = "REGRESSED"sv;
+                ++regressions;
+            } else if (change_percent < -threshold_percent) {
+                verdict = "improved"sv;
+            }
+            outln("{:<40} {:>12.2} {:>12.2} {:>+9.1}% {}", result.name, to_ms(baseline_median), to_ms(median), change_percent, verdict);
+        }
+    }
+
+    if (!output_path.is_empty()) {
+        JsonObject output;
+        for (auto& result : results) {
+            auto& statistics = result.run_times_us;
+            JsonObject entry;
+            entry.set("iterations", statistics.size());
+            entry.set("min_us", statistics.min());
+            entry.set("max_us", statistics.max());
+            entry.set("median_us", statistics.median());
+            entry.set("mean_us", static_cast<double>(statistics.average()));
+            entry.set("stddev_us", static_cast<double>(statistics.standard_deviation()));
+            output.set(result.name, move(entry));
+        }
+        auto output_file = TRY(Core::File::open(output_path, Core::OpenMode::WriteOnly | Core::OpenMode::Truncate));
+        if (!output_file->write(output.to_string()))
+            return Error::from_string_literal("Failed to write results"sv);
+    }
+
+    if (regressions > 0) {
+        warnln("{} benchmark(s) regressed by more than {}%", regressions, threshold_percent);
+        return 1;
+    }
+    return had_errors ? 1 : 0;
+}
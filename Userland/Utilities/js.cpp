@@ -1051,6 +1051,13 @@ static bool parse_and_run(JS::Interpreter& interpreter, StringView source, Strin
             if (s_run_bytecode) {
                 JS::Bytecode::Interpreter bytecode_interpreter(interpreter.global_object(), interpreter.realm());
                 result = bytecode_interpreter.run(*executable);
+
+                if (JS::Bytecode::g_dump_bytecode) {
+                    // Dump it once more, so the inline cache statistics of the individual instructions show up too.
+                    executable->dump();
+                    auto const& statistics = bytecode_interpreter.property_lookup_cache_statistics();
+                    warnln("Property lookup caches: {} hits, {} misses", statistics.hit_count, statistics.miss_count);
+                }
             } else {
                 return ReturnEarly::Yes;
             }
@@ -1382,6 +1389,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(JS::Bytecode::g_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
     args_parser.add_option(s_opt_bytecode, "Optimize the bytecode", "optimize-bytecode", 'p');
+    args_parser.add_option(JS::Bytecode::g_use_threaded_code, "Run hot bytecode blocks as threaded code", "threaded-bytecode", 0);
     args_parser.add_option(s_as_module, "Treat as module", "as-module", 'm');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(s_strip_ansi, "Disable ANSI colors", "disable-ansi-colors", 'i');
@@ -1574,7 +1582,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             Vector<Line::CompletionSuggestion> results;
 
             Function<void(JS::Shape const&, StringView)> list_all_properties = [&results, &list_all_properties](JS::Shape const& shape, auto property_pattern) {
-                for (auto const& descriptor : shape.property_table()) {
+                for (auto const& descriptor : shape.property_table_ordered()) {
                     if (!descriptor.key.is_string())
                         continue;
                     auto key = descriptor.key.as_string();
@@ -52,6 +52,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 event_mask |= PERF_EVENT_SYSCALL;
             else if (event_type == "read")
                 event_mask |= PERF_EVENT_READ;
+            else if (event_type == "tracepoint")
+                event_mask |= PERF_EVENT_TRACEPOINT;
+            else if (event_type == "cycles")
+                event_mask |= PERF_EVENT_CYCLES;
+            else if (event_type == "instructions")
+                event_mask |= PERF_EVENT_INSTRUCTIONS;
+            else if (event_type == "cache_misses")
+                event_mask |= PERF_EVENT_CACHE_MISSES;
+            else if (event_type == "branch_misses")
+                event_mask |= PERF_EVENT_BRANCH_MISSES;
             else {
                 warnln("Unknown event type '{}' specified.", event_type);
                 exit(1);
@@ -61,7 +71,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     auto print_types = [] {
         outln();
-        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, kmalloc and kfree.");
+        outln("Event type can be one of: sample, context_switch, page_fault, syscall, read, tracepoint, kmalloc and kfree.");
+        outln("Hardware counter event type can be one of: cycles, instructions, cache_misses and branch_misses.");
     };
 
     if (!args_parser.parse(arguments, Core::ArgsParser::FailureBehavior::PrintUsage)) {
@@ -147,7 +147,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         return 0;
     }
 
-    auto encoded_bitmap = Gfx::PNGWriter::encode(*bitmap);
+    auto encoded_bitmap = Gfx::PNGWriter::encode(*bitmap, Gfx::PNGWriter::CompressionLevel::Fast);
     if (encoded_bitmap.is_empty()) {
         warnln("Failed to encode PNG");
         return 1;
@@ -4,43 +4,375 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/QuickSort.h>
+#include <AK/CharacterTypes.h>
+#include <AK/ScopeGuard.h>
 #include <AK/String.h>
+#include <AK/StringImpl.h>
 #include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/Parallel.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-ErrorOr<int> serenity_main([[maybe_unused]] Main::Arguments arguments)
+// Runs are merged at most this many at a time, so that we don't run out of file descriptors.
+static constexpr size_t max_runs_per_merge = 16;
+
+struct SortOptions {
+    // The key spans from the start of this field to the end of `key_end_field` (or the line), both 0-based.
+    Optional<size_t> key_start_field;
+    Optional<size_t> key_end_field;
+    Optional<char> field_separator;
+    bool numeric { false };
+    bool reverse { false };
+};
+
+struct Line {
+    String text;
+    // The parts of the line that are compared, extracted once when the line is read so that comparisons don't have to.
+    StringView key;
+    double numeric_key { 0 };
+};
+
+static size_t skip_field(StringView line, size_t position, Optional<char> separator)
+{
+    if (separator.has_value()) {
+        auto next_separator = line.find(*separator, position);
+        return next_separator.value_or(line.length());
+    }
+    // Without a separator, fields are separated by the empty string between a non-blank and a blank character,
+    // so every field but the first one starts with blanks.
+    while (position < line.length() && is_ascii_blank(line[position]))
+        ++position;
+    while (position < line.length() && !is_ascii_blank(line[position]))
+        ++position;
+    return position;
+}
+
+static StringView extract_key(StringView line, SortOptions const& options)
+{
+    if (!options.key_start_field.has_value())
+        return line;
+
+    size_t start = 0;
+    for (size_t field = 0; field < *options.key_start_field && start < line.length(); ++field) {
+        start = skip_field(line, start, options.field_separator);
+        if (options.field_separator.has_value() && start < line.length())
+            ++start;
+    }
+    if (start >= line.length())
+        return {};
+
+    size_t end = line.length();
+    if (options.key_end_field.has_value()) {
+        end = start;
+        for (size_t field = *options.key_start_field; field <= *options.key_end_field && end < line.length(); ++field) {
+            if (field != *options.key_start_field && options.field_separator.has_value())
+                ++end;
+            end = skip_field(line, end, options.field_separator);
+        }
+    }
+    return line.substring_view(start, end - start);
+}
+
+// Like `sort -n` elsewhere, this reads an optionally negative decimal number from the start of the key, ignoring leading blanks.
+// Keys that don't start with a number count as 0.
+static double parse_numeric_key(StringView key)
 {
-    TRY(Core::System::pledge("stdio"sv));
+    size_t position = 0;
+    while (position < key.length() && is_ascii_blank(key[position]))
+        ++position;
+
+    bool is_negative = position < key.length() && key[position] == '-';
+    if (is_negative)
+        ++position;
+
+    double value = 0;
+    for (; position < key.length() && is_ascii_digit(key[position]); ++position)
+        value = value * 10 + parse_ascii_digit(key[position]);
+    if (position < key.length() && key[position] == '.') {
+        double scale = 0.1;
+        for (++position; position < key.length() && is_ascii_digit(key[position]); ++position) {
+            value += parse_ascii_digit(key[position]) * scale;
+            scale /= 10;
+        }
+    }
+    return is_negative ? -value : value;
+}
 
-    Vector<String> lines;
+static Line make_line(String text, SortOptions const& options)
+{
+    Line line { move(text), {}, 0 };
+    line.key = extract_key(line.text, options);
+    if (options.numeric)
+        line.numeric_key = parse_numeric_key(line.key);
+    return line;
+}
+
+static int compare_bytes(StringView a, StringView b)
+{
+    if (auto result = memcmp(a.characters_without_null_termination(), b.characters_without_null_termination(), min(a.length(), b.length())); result != 0)
+        return result;
+    return (a.length() > b.length()) - (a.length() < b.length());
+}
+
+static int compare_lines(Line const& a, Line const& b, SortOptions const& options)
+{
+    int result = 0;
+    if (options.numeric)
+        result = (a.numeric_key > b.numeric_key) - (a.numeric_key < b.numeric_key);
+    else if (options.key_start_field.has_value())
+        result = compare_bytes(a.key, b.key);
+    // Lines with equal keys are ordered by their whole contents.
+    if (result == 0)
+        result = compare_bytes(a.text, b.text);
+    return options.reverse ? -result : result;
+}
+
+// A sorted run that didn't fit into memory along with the rest of the input, kept in an unlinked temporary file.
+class Run {
+public:
+    static ErrorOr<Run> create()
+    {
+        char path[] = "/tmp/sort.XXXXXX";
+        auto fd = TRY(Core::System::mkstemp(path));
+        TRY(Core::System::unlink({ path, strlen(path) }));
+        auto* file = fdopen(fd, "w+");
+        if (!file) {
+            auto saved_errno = errno;
+            (void)Core::System::close(fd);
+            return Error::from_errno(saved_errno);
+        }
+        return Run { file };
+    }
+
+    Run(Run&& other)
+        : m_file(exchange(other.m_file, nullptr))
+        , m_buffer(exchange(other.m_buffer, nullptr))
+        , m_buffer_size(exchange(other.m_buffer_size, 0))
+    {
+    }
+
+    ~Run()
+    {
+        free(m_buffer);
+        if (m_file)
+            fclose(m_file);
+    }
+
+    ErrorOr<void> write_line(StringView line)
+    {
+        if (fwrite(line.characters_without_null_termination(), 1, line.length(), m_file) != line.length() || fputc('\n', m_file) == EOF)
+            return Error::from_errno(errno);
+        return {};
+    }
+
+    // Switches the run from being written to being read back.
+    ErrorOr<void> rewind()
+    {
+        if (fflush(m_file) != 0 || fseek(m_file, 0, SEEK_SET) != 0)
+            return Error::from_errno(errno);
+        return {};
+    }
 
+    // Returns an empty Optional at the end of the run.
+    ErrorOr<Optional<String>> read_line()
+    {
+        errno = 0;
+        auto nread = getline(&m_buffer, &m_buffer_size, m_file);
+        if (nread == -1) {
+            if (errno != 0)
+                return Error::from_errno(errno);
+            return Optional<String> {};
+        }
+        return Optional<String> { String(m_buffer, AK::ShouldChomp::Chomp) };
+    }
+
+private:
+    explicit Run(FILE* file)
+        : m_file(file)
+    {
+    }
+
+    FILE* m_file { nullptr };
+    char* m_buffer { nullptr };
+    size_t m_buffer_size { 0 };
+};
+
+// Merges the runs, passing their lines to `output` in order. Lines that compare equal are taken from earlier runs first.
+static ErrorOr<void> merge_runs(Span<Run> runs, SortOptions const& options, Function<ErrorOr<void>(StringView)> const& output)
+{
+    Vector<Line> heads;
+    // A binary heap of indices into `runs`, with the run whose head line comes first at the top.
+    Vector<size_t> heap;
+    auto comes_before = [&](size_t a, size_t b) {
+        auto result = compare_lines(heads[a], heads[b], options);
+        return result < 0 || (result == 0 && a < b);
+    };
+    auto sift_down = [&](size_t index) {
+        for (;;) {
+            auto smallest = index;
+            for (auto child : { 2 * index + 1, 2 * index + 2 }) {
+                if (child < heap.size() && comes_before(heap[child], heap[smallest]))
+                    smallest = child;
+            }
+            if (smallest == index)
+                return;
+            swap(heap[index], heap[smallest]);
+            index = smallest;
+        }
+    };
+
+    for (size_t i = 0; i < runs.size(); ++i) {
+        TRY(runs[i].rewind());
+        auto line = TRY(runs[i].read_line());
+        if (line.has_value())
+            heap.append(i);
+        heads.append(line.has_value() ? make_line(line.release_value(), options) : Line {});
+    }
+    for (size_t i = heap.size() / 2; i-- > 0;)
+        sift_down(i);
+
+    while (!heap.is_empty()) {
+        auto run_index = heap.first();
+        TRY(output(heads[run_index].text));
+        auto line = TRY(runs[run_index].read_line());
+        if (line.has_value()) {
+            heads[run_index] = make_line(line.release_value(), options);
+        } else {
+            heap.first() = heap.last();
+            heap.take_last();
+        }
+        sift_down(0);
+    }
+    return {};
+}
+
+static ErrorOr<size_t> parse_buffer_size(StringView size)
+{
+    size_t multiplier = 1;
+    if (size.ends_with('K') || size.ends_with('k'))
+        multiplier = KiB;
+    else if (size.ends_with('M') || size.ends_with('m'))
+        multiplier = MiB;
+    else if (size.ends_with('G') || size.ends_with('g'))
+        multiplier = GiB;
+    if (multiplier != 1)
+        size = size.substring_view(0, size.length() - 1);
+
+    auto value = size.to_uint<size_t>();
+    if (!value.has_value() || *value == 0)
+        return Error::from_string_literal("Invalid buffer size"sv);
+    return *value * multiplier;
+}
+
+ErrorOr<int> serenity_main(Main::Arguments arguments)
+{
+    TRY(Core::System::pledge("stdio rpath wpath cpath thread"sv));
+
+    SortOptions options;
+    StringView key;
+    StringView field_separator;
+    StringView buffer_size_string;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Sort lines from standard input.");
+    args_parser.add_option(key, "Sort by the fields from START to END, or to the end of the line (counting from 1)", "key", 'k', "START[,END]");
+    args_parser.add_option(field_separator, "Separate fields with this character instead of blanks", "field-separator", 't', "char");
+    args_parser.add_option(options.numeric, "Compare keys as numbers", "numeric-sort", 'n');
+    args_parser.add_option(options.reverse, "Reverse the result of comparisons", "reverse", 'r');
+    args_parser.add_option(buffer_size_string, "Hold at most this much input in memory, spilling sorted runs to temporary files beyond that (default: 32M)", "buffer-size", 'S', "size");
+    args_parser.parse(arguments);
+
+    if (!key.is_empty()) {
+        auto fields = key.split_view(',');
+        auto start = fields[0].to_uint<size_t>();
+        auto end = fields.size() > 1 ? fields[1].to_uint<size_t>() : Optional<size_t> {};
+        if (fields.size() > 2 || !start.has_value() || *start == 0 || (fields.size() > 1 && (!end.has_value() || *end < *start))) {
+            warnln("sort: Invalid key '{}'", key);
+            return 1;
+        }
+        options.key_start_field = *start - 1;
+        if (end.has_value())
+            options.key_end_field = *end - 1;
+    }
+    if (!field_separator.is_empty()) {
+        if (field_separator.length() != 1) {
+            warnln("sort: The field separator must be a single character");
+            return 1;
+        }
+        options.field_separator = field_separator[0];
+    }
+
+    size_t buffer_size = 32 * MiB;
+    if (!buffer_size_string.is_empty())
+        buffer_size = TRY(parse_buffer_size(buffer_size_string));
+
+    auto less_than = [&](Line const& a, Line const& b) { return compare_lines(a, b, options) < 0; };
+
+    Vector<Line> lines;
+    size_t buffered_bytes = 0;
+    Vector<Run> runs;
+
+    auto spill_lines_to_run = [&]() -> ErrorOr<void> {
+        Threading::parallel_sort(lines, less_than);
+        auto run = TRY(Run::create());
+        for (auto& line : lines)
+            TRY(run.write_line(line.text));
+        runs.append(move(run));
+        lines.clear();
+        buffered_bytes = 0;
+        return {};
+    };
+
+    char* buffer = nullptr;
+    size_t buffer_capacity = 0;
+    ScopeGuard free_buffer = [&] { free(buffer); };
     for (;;) {
-        char* buffer = nullptr;
-        ssize_t buflen = 0;
-        size_t n;
         errno = 0;
-        buflen = getline(&buffer, &n, stdin);
+        auto buflen = getline(&buffer, &buffer_capacity, stdin);
         if (buflen == -1 && errno != 0) {
             perror("getline");
             exit(1);
         }
         if (buflen == -1)
             break;
-        lines.append({ buffer, AK::ShouldChomp::Chomp });
+        lines.append(make_line({ buffer, AK::ShouldChomp::Chomp }, options));
+        buffered_bytes += buflen + sizeof(Line) + sizeof(StringImpl);
+        if (buffered_bytes >= buffer_size)
+            TRY(spill_lines_to_run());
     }
 
-    quick_sort(lines);
+    // Everything fit into memory, so there's nothing to merge.
+    if (runs.is_empty()) {
+        Threading::parallel_sort(lines, less_than);
+        for (auto& line : lines)
+            outln("{}", line.text);
+        return 0;
+    }
 
-    for (auto& line : lines) {
-        outln("{}", line);
+    if (!lines.is_empty())
+        TRY(spill_lines_to_run());
+
+    // Merge the runs into fewer, longer ones until they can all be merged at once.
+    while (runs.size() > max_runs_per_merge) {
+        Vector<Run> merged_runs;
+        for (size_t start = 0; start < runs.size(); start += max_runs_per_merge) {
+            auto group = runs.span().slice(start, min(max_runs_per_merge, runs.size() - start));
+            auto merged_run = TRY(Run::create());
+            TRY(merge_runs(group, options, [&](StringView line) { return merged_run.write_line(line); }));
+            merged_runs.append(move(merged_run));
+        }
+        runs = move(merged_runs);
     }
 
+    TRY(merge_runs(runs.span(), options, [](StringView line) -> ErrorOr<void> {
+        outln("{}", line);
+        return {};
+    }));
     return 0;
 }
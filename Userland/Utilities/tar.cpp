@@ -6,6 +6,8 @@
 
 #include <AK/Assertions.h>
 #include <AK/LexicalPath.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/ScopeGuard.h>
 #include <AK/Span.h>
 #include <AK/Vector.h>
 #include <LibArchive/TarStream.h>
@@ -16,6 +18,7 @@
 #include <LibCore/FileStream.h>
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
+#include <LibThreading/ThreadPool.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <sys/stat.h>
@@ -23,6 +26,87 @@
 
 constexpr size_t buffer_size = 4096;
 
+// Limits of how much is read ahead of the archive writer at a time.
+constexpr size_t read_ahead_max_files = 64;
+constexpr size_t read_ahead_max_bytes = 16 * MiB;
+
+struct ArchiveEntry {
+    String path;
+    mode_t mode { 0 };
+    off_t size { 0 };
+    bool is_directory { false };
+};
+
+struct ReadAheadBatch {
+    size_t first_entry { 0 };
+    size_t end_entry { 0 };
+    // The contents of the files in [first_entry, end_entry); empty for directories.
+    Vector<ErrorOr<ByteBuffer>> contents;
+    Threading::TaskGroup group;
+};
+
+static ErrorOr<void> collect_archive_entries(String const& path, Vector<ArchiveEntry>& entries)
+{
+    if (!Core::File::is_directory(path)) {
+        auto statbuf_or_error = Core::System::lstat(path);
+        if (statbuf_or_error.is_error()) {
+            warnln("Failed to open {}: {}", path, statbuf_or_error.error());
+            return {};
+        }
+        auto statbuf = statbuf_or_error.release_value();
+        entries.append({ path, statbuf.st_mode, statbuf.st_size, false });
+        return {};
+    }
+
+    auto statbuf = TRY(Core::System::lstat(path));
+    entries.append({ path, statbuf.st_mode, 0, true });
+
+    Core::DirIterator it(path, Core::DirIterator::Flags::SkipParentAndBaseDir);
+    while (it.has_next())
+        TRY(collect_archive_entries(it.next_full_path(), entries));
+    return {};
+}
+
+static ErrorOr<ByteBuffer> read_file_contents(String const& path)
+{
+    auto fd = TRY(Core::System::open(path, O_RDONLY));
+    ScopeGuard close_fd = [fd] { (void)Core::System::close(fd); };
+
+    auto statbuf = TRY(Core::System::fstat(fd));
+    auto contents = TRY(ByteBuffer::create_uninitialized(statbuf.st_size));
+    size_t total_read = 0;
+    while (total_read < contents.size()) {
+        auto nread = TRY(Core::System::read(fd, contents.bytes().slice(total_read)));
+        if (nread == 0)
+            break;
+        total_read += nread;
+    }
+    contents.resize(total_read);
+    return contents;
+}
+
+static NonnullOwnPtr<ReadAheadBatch> start_reading_batch(Vector<ArchiveEntry> const& entries, size_t first_entry)
+{
+    auto batch = make<ReadAheadBatch>();
+    batch->first_entry = first_entry;
+    batch->end_entry = first_entry;
+    size_t batch_bytes = 0;
+    while (batch->end_entry < entries.size() && batch->end_entry - first_entry < read_ahead_max_files && batch_bytes < read_ahead_max_bytes)
+        batch_bytes += entries[batch->end_entry++].size;
+
+    batch->contents.ensure_capacity(batch->end_entry - first_entry);
+    for (size_t i = first_entry; i < batch->end_entry; ++i)
+        batch->contents.unchecked_append(ByteBuffer {});
+    for (size_t i = first_entry; i < batch->end_entry; ++i) {
+        if (entries[i].is_directory)
+            continue;
+        batch->group.spawn([&path = entries[i].path, &contents = batch->contents[i - first_entry]] {
+            contents = read_file_contents(path);
+        });
+    }
+    return batch;
+}
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     bool create = false;
@@ -195,66 +279,49 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         if (directory)
             TRY(Core::System::chdir(directory));
 
+        Vector<ArchiveEntry> entries;
+        for (auto const& path : paths)
+            TRY(collect_archive_entries(path, entries));
+
         Core::OutputFileStream file_stream(file);
-        Compress::GzipCompressor gzip_stream(file_stream);
+        OwnPtr<Compress::ParallelGzipCompressor> gzip_stream;
+        if (gzip)
+            gzip_stream = make<Compress::ParallelGzipCompressor>(file_stream);
 
         OutputStream& file_output_stream = file_stream;
-        OutputStream& gzip_output_stream = gzip_stream;
-        Archive::TarOutputStream tar_stream((gzip) ? gzip_output_stream : file_output_stream);
-
-        auto add_file = [&](String path) -> ErrorOr<void> {
-            auto file = Core::File::construct(path);
-            if (!file->open(Core::OpenMode::ReadOnly)) {
-                warnln("Failed to open {}: {}", path, file->error_string());
-                return {};
-            }
-
-            auto statbuf_or_error = Core::System::lstat(path);
-            if (statbuf_or_error.is_error())
-                return statbuf_or_error.error();
-
-            auto statbuf = statbuf_or_error.value();
-            auto canonicalized_path = LexicalPath::canonicalized_path(path);
-            tar_stream.add_file(canonicalized_path, statbuf.st_mode, file->read_all());
-            if (verbose)
-                outln("{}", canonicalized_path);
-
-            return {};
-        };
-
-        auto add_directory = [&](String path, auto handle_directory) -> ErrorOr<void> {
-            auto statbuf_or_error = Core::System::lstat(path);
-            if (statbuf_or_error.is_error())
-                return statbuf_or_error.error();
-
-            auto statbuf = statbuf_or_error.value();
-            auto canonicalized_path = LexicalPath::canonicalized_path(path);
-            tar_stream.add_directory(canonicalized_path, statbuf.st_mode);
-            if (verbose)
-                outln("{}", canonicalized_path);
-
-            Core::DirIterator it(path, Core::DirIterator::Flags::SkipParentAndBaseDir);
-            while (it.has_next()) {
-                auto child_path = it.next_full_path();
-                if (!Core::File::is_directory(child_path)) {
-                    TRY(add_file(child_path));
+        Archive::TarOutputStream tar_stream(gzip_stream ? *gzip_stream : file_output_stream);
+
+        // Read the files of the next batch on the thread pool while the current one is being written (and compressed).
+        auto batch = start_reading_batch(entries, 0);
+        while (batch->first_entry < entries.size()) {
+            batch->group.wait();
+            auto next_batch = start_reading_batch(entries, batch->end_entry);
+
+            for (size_t i = batch->first_entry; i < batch->end_entry; ++i) {
+                auto const& entry = entries[i];
+                auto canonicalized_path = LexicalPath::canonicalized_path(entry.path);
+                if (entry.is_directory) {
+                    tar_stream.add_directory(canonicalized_path, entry.mode);
                 } else {
-                    TRY(handle_directory(child_path, handle_directory));
+                    auto& contents = batch->contents[i - batch->first_entry];
+                    if (contents.is_error()) {
+                        warnln("Failed to open {}: {}", entry.path, contents.error());
+                        continue;
+                    }
+                    tar_stream.add_file(canonicalized_path, entry.mode, contents.value());
+                    // Let go of the file now, so that at most two batches are in memory.
+                    contents = ByteBuffer {};
                 }
+                if (verbose)
+                    outln("{}", canonicalized_path);
             }
 
-            return {};
-        };
-
-        for (auto const& path : paths) {
-            if (Core::File::is_directory(path)) {
-                TRY(add_directory(path, add_directory));
-            } else {
-                TRY(add_file(path));
-            }
+            batch = move(next_batch);
         }
 
         tar_stream.finish();
+        if (gzip_stream)
+            gzip_stream->finish();
 
         return 0;
     }
@@ -5,68 +5,46 @@
  */
 
 #include <AK/Assertions.h>
+#include <AK/Atomic.h>
 #include <AK/NumberFormat.h>
 #include <AK/StringUtils.h>
 #include <LibArchive/Zip.h>
-#include <LibCompress/Deflate.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/File.h>
 #include <LibCore/MappedFile.h>
+#include <LibCore/Stream.h>
 #include <LibCore/System.h>
+#include <LibThreading/ThreadPool.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
-static bool unpack_zip_member(Archive::ZipMember zip_member, bool quiet)
+static bool unpack_zip_directory(Archive::ZipMember const& zip_member, bool quiet)
 {
-    if (zip_member.is_directory) {
-        if (mkdir(zip_member.name.characters(), 0755) < 0) {
-            perror("mkdir");
-            return false;
-        }
-        if (!quiet)
-            outln(" extracting: {}", zip_member.name);
-        return true;
-    }
-    auto new_file = Core::File::construct(zip_member.name);
-    if (!new_file->open(Core::OpenMode::WriteOnly)) {
-        warnln("Can't write file {}: {}", zip_member.name, new_file->error_string());
+    if (mkdir(zip_member.name.characters(), 0755) < 0) {
+        perror("mkdir");
         return false;
     }
-
     if (!quiet)
         outln(" extracting: {}", zip_member.name);
+    return true;
+}
 
-    // TODO: verify CRC32s match!
-    switch (zip_member.compression_method) {
-    case Archive::ZipCompressionMethod::Store: {
-        if (!new_file->write(zip_member.compressed_data.data(), zip_member.compressed_data.size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
-        break;
-    }
-    case Archive::ZipCompressionMethod::Deflate: {
-        auto decompressed_data = Compress::DeflateDecompressor::decompress_all(zip_member.compressed_data);
-        if (!decompressed_data.has_value()) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (decompressed_data.value().size() != zip_member.uncompressed_size) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (!new_file->write(decompressed_data.value().data(), decompressed_data.value().size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
-        break;
-    }
-    default:
-        VERIFY_NOT_REACHED();
+static bool unpack_zip_file(Archive::ZipMember const& zip_member, bool quiet)
+{
+    auto new_file_or_error = Core::Stream::File::open(zip_member.name, Core::Stream::OpenMode::Write);
+    if (new_file_or_error.is_error()) {
+        warnln("Can't write file {}: {}", zip_member.name, new_file_or_error.error());
+        return false;
     }
+    auto new_file = new_file_or_error.release_value();
+
+    if (!quiet)
+        outln(" extracting: {}", zip_member.name);
 
-    if (!new_file->close()) {
-        warnln("Can't close file {}: {}", zip_member.name, new_file->error_string());
+    auto result = zip_member.decompress([&](ReadonlyBytes bytes) {
+        return new_file->write_entire_buffer(bytes);
+    });
+    if (result.is_error()) {
+        warnln("Failed extracting file {}: {}", zip_member.name, result.error());
         return false;
     }
 
@@ -78,6 +56,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     const char* path;
     int map_size_limit = 32 * MiB;
     bool quiet { false };
+    unsigned thread_count { 1 };
     String output_directory_path;
     Vector<StringView> file_filters;
 
@@ -85,6 +64,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(map_size_limit, "Maximum chunk size to map", "map-size-limit", 0, "size");
     args_parser.add_option(output_directory_path, "Directory to receive the archive content", "output-directory", 'd', "path");
     args_parser.add_option(quiet, "Be less verbose", "quiet", 'q');
+    args_parser.add_option(thread_count, "Extract files on this many threads", "threads", 0, "N");
     args_parser.add_positional_argument(path, "File to unzip", "path", Core::ArgsParser::Required::Yes);
     args_parser.add_positional_argument(file_filters, "Files or filters in the archive to extract", "files", Core::ArgsParser::Required::No);
     args_parser.parse(arguments);
@@ -126,6 +106,7 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         TRY(Core::System::chdir(output_directory_path));
     }
 
+    Vector<Archive::ZipMember> files;
     auto success = zip_file->for_each_member([&](auto zip_member) {
         bool keep_file = false;
 
@@ -142,13 +123,39 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
             keep_file = true;
         }
 
-        if (keep_file) {
-            if (!unpack_zip_member(zip_member, quiet))
-                return IterationDecision::Break;
-        }
+        if (!keep_file)
+            return IterationDecision::Continue;
 
+        // Directories are created right away, so they're there by the time the files in them are extracted.
+        if (zip_member.is_directory)
+            return unpack_zip_directory(zip_member, quiet) ? IterationDecision::Continue : IterationDecision::Break;
+
+        files.append(move(zip_member));
         return IterationDecision::Continue;
     });
+    if (!success)
+        return 1;
+
+    // The members are independent of each other, so they can be extracted in any order, and on as many threads as we like.
+    Atomic<size_t> next_file { 0 };
+    Atomic<bool> has_failed { false };
+    auto unpack_remaining_files = [&] {
+        while (!has_failed.load(AK::MemoryOrder::memory_order_relaxed)) {
+            auto index = next_file.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (index >= files.size())
+                return;
+            if (!unpack_zip_file(files[index], quiet))
+                has_failed = true;
+        }
+    };
+
+    auto& pool = Threading::ThreadPool::the();
+    Threading::TaskGroup group(pool);
+    auto helper_count = thread_count > 1 ? min<size_t>(min<size_t>(thread_count - 1, pool.worker_count()), files.size()) : 0;
+    for (size_t i = 0; i < helper_count; ++i)
+        group.spawn([&] { unpack_remaining_files(); });
+    unpack_remaining_files();
+    group.wait();
 
-    return success ? 0 : 1;
+    return has_failed ? 1 : 0;
 }
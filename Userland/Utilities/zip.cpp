@@ -14,6 +14,9 @@
 #include <LibCore/System.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
+// Files up to this size are compressed in memory, larger ones are streamed into the archive.
+static constexpr off_t max_in_memory_file_size = 1 * MiB;
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     const char* zip_path;
@@ -53,14 +56,31 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
 
     Archive::ZipOutputStream zip_stream { file_stream };
 
-    auto add_file = [&](String path) {
+    auto add_file = [&](String path) -> ErrorOr<void> {
+        auto canonicalized_path = LexicalPath::canonicalized_path(path);
+
+        // Small files are compressed in one go, so they can be stored instead if that doesn't make them any smaller.
+        // Anything larger is deflated as it's read, so it never has to be in memory all at once.
+        auto stat_or_error = Core::System::stat(path);
+        if (!stat_or_error.is_error() && stat_or_error.value().st_size > max_in_memory_file_size) {
+            auto file_stream_or_error = Core::InputFileStream::open(path);
+            if (file_stream_or_error.is_error()) {
+                warnln("Failed to open {}: {}", path, file_stream_or_error.error());
+                return {};
+            }
+            auto file_size = stat_or_error.value().st_size;
+            auto compressed_size = TRY(zip_stream.add_member_from_stream(canonicalized_path, file_stream_or_error.value(), Archive::ZipCompressionMethod::Deflate));
+            auto compression_ratio = (double)compressed_size / file_size;
+            outln("  adding: {} (deflated {}%)", canonicalized_path, (int)(compression_ratio * 100));
+            return {};
+        }
+
         auto file = Core::File::construct(path);
         if (!file->open(Core::OpenMode::ReadOnly)) {
             warnln("Failed to open {}: {}", path, file->error_string());
-            return;
+            return {};
         }
 
-        auto canonicalized_path = LexicalPath::canonicalized_path(path);
         auto file_buffer = file->read_all();
         Archive::ZipMember member {};
         member.name = canonicalized_path;
@@ -81,9 +101,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         member.crc32 = checksum.digest();
         member.is_directory = false;
         zip_stream.add_member(member);
+        return {};
     };
 
-    auto add_directory = [&](String path, auto handle_directory) -> void {
+    auto add_directory = [&](String path, auto handle_directory) -> ErrorOr<void> {
         auto canonicalized_path = String::formatted("{}/", LexicalPath::canonicalized_path(path));
         Archive::ZipMember member {};
         member.name = canonicalized_path;
@@ -96,25 +117,26 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
         outln("  adding: {} (stored 0%)", canonicalized_path);
 
         if (!recurse)
-            return;
+            return {};
 
         Core::DirIterator it(path, Core::DirIterator::Flags::SkipParentAndBaseDir);
         while (it.has_next()) {
             auto child_path = it.next_full_path();
             if (Core::File::is_link(child_path))
-                return;
+                return {};
             if (!Core::File::is_directory(child_path))
-                add_file(child_path);
+                TRY(add_file(child_path));
             else
-                handle_directory(child_path, handle_directory);
+                TRY(handle_directory(child_path, handle_directory));
         }
+        return {};
     };
 
     for (auto const& source_path : source_paths) {
         if (Core::File::is_directory(source_path)) {
-            add_directory(source_path, add_directory);
+            TRY(add_directory(source_path, add_directory));
         } else {
-            add_file(source_path);
+            TRY(add_file(source_path));
         }
     }
 